@@ -24,6 +24,11 @@ namespace mediapipe {
 // The AudioDecoderCalculator decodes an audio stream of the media file. It
 // produces two output streams contain audio packets and the header infomation.
 //
+// The file is decoded incrementally, one audio packet per Process() call. Set
+// output_chunk_samples in the audio stream options to output packets of a
+// fixed size, and seek_to_start_time to decode only a time range of a long
+// file, for example to split the file across several graphs.
+//
 // Output Streams:
 //   AUDIO: Output audio frames (Matrix).
 //   AUDIO_HEADER:
@@ -39,7 +44,7 @@ namespace mediapipe {
 //   output_stream: "AUDIO_HEADER:audio_header"
 //   node_options {
 //     [type.googleapis.com/mediapipe.AudioDecoderOptions]: {
-//        audio_stream { stream_index: 0 }
+//        audio_stream { stream_index: 0 output_chunk_samples: 16000 }
 //        start_time: 0
 //        end_time: 1
 //   }
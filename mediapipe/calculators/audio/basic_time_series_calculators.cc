@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include <memory>
+#include <utility>
 
 #include "Eigen/Core"
 #include "absl/strings/str_cat.h"
@@ -69,7 +70,19 @@ absl::Status BasicTimeSeriesCalculatorBase::Process(CalculatorContext* cc) {
   MP_RETURN_IF_ERROR(time_series_util::IsMatrixShapeConsistentWithHeader(
       input, cc->Inputs().Index(0).Header().Get<TimeSeriesHeader>()));
 
-  std::unique_ptr<Matrix> output(new Matrix(ProcessMatrix(input)));
+  std::unique_ptr<Matrix> output;
+  if (CanProcessMatrixInPlace()) {
+    // Consume() fails if the matrix is shared with other packets, in which
+    // case the input is left untouched and copied by ProcessMatrix() below.
+    auto consumed = cc->Inputs().Index(0).Value().Consume<Matrix>();
+    if (consumed.ok()) {
+      output = std::move(consumed).value();
+      ProcessMatrixInPlace(output.get());
+    }
+  }
+  if (output == nullptr) {
+    output = std::make_unique<Matrix>(ProcessMatrix(input));
+  }
   MP_RETURN_IF_ERROR(time_series_util::IsMatrixShapeConsistentWithHeader(
       *output, cc->Outputs().Index(0).Header().Get<TimeSeriesHeader>()));
 
@@ -153,6 +166,12 @@ class ReverseChannelOrderCalculator : public BasicTimeSeriesCalculatorBase {
   Matrix ProcessMatrix(const Matrix& input_matrix) final {
     return input_matrix.colwise().reverse();
   }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    matrix->colwise().reverseInPlace();
+  }
 };
 REGISTER_CALCULATOR(ReverseChannelOrderCalculator);
 
@@ -201,8 +220,15 @@ REGISTER_CALCULATOR(FlattenPacketCalculator);
 class SubtractMeanCalculator : public BasicTimeSeriesCalculatorBase {
  protected:
   Matrix ProcessMatrix(const Matrix& input_matrix) final {
-    Matrix mean = input_matrix.rowwise().mean();
-    return input_matrix - mean.replicate(1, input_matrix.cols());
+    const Eigen::VectorXf mean = input_matrix.rowwise().mean();
+    return input_matrix.colwise() - mean;
+  }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    const Eigen::VectorXf mean = matrix->rowwise().mean();
+    matrix->colwise() -= mean;
   }
 };
 REGISTER_CALCULATOR(SubtractMeanCalculator);
@@ -218,6 +244,12 @@ class SubtractMeanAcrossChannelsCalculator
     auto mean = input_matrix.mean();
     return (input_matrix.array() - mean).matrix();
   }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    matrix->array() -= matrix->mean();
+  }
 };
 REGISTER_CALCULATOR(SubtractMeanAcrossChannelsCalculator);
 
@@ -248,6 +280,17 @@ class DivideByMeanAcrossChannelsCalculator
       return Matrix::Ones(input_matrix.rows(), input_matrix.cols());
     }
   }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    const float mean = matrix->mean();
+    if (mean != 0) {
+      *matrix /= mean;
+    } else {
+      matrix->setOnes();
+    }
+  }
 };
 REGISTER_CALCULATOR(DivideByMeanAcrossChannelsCalculator);
 
@@ -302,11 +345,12 @@ class CovarianceCalculator : public BasicTimeSeriesCalculatorBase {
   }
 
   Matrix ProcessMatrix(const Matrix& input_matrix) final {
-    auto mean = input_matrix.rowwise().mean();
-    auto zero_mean_input =
-        input_matrix - mean.replicate(1, input_matrix.cols());
-    return (zero_mean_input * zero_mean_input.transpose()) /
-           input_matrix.cols();
+    const Eigen::VectorXf mean = input_matrix.rowwise().mean();
+    const Matrix zero_mean_input = input_matrix.colwise() - mean;
+    Matrix covariance = Matrix::Zero(input_matrix.rows(), input_matrix.rows());
+    covariance.selfadjointView<Eigen::Lower>().rankUpdate(
+        zero_mean_input, 1.0f / input_matrix.cols());
+    return covariance.selfadjointView<Eigen::Lower>();
   }
 };
 REGISTER_CALCULATOR(CovarianceCalculator);
@@ -335,6 +379,12 @@ class L2NormalizeColumnCalculator : public BasicTimeSeriesCalculatorBase {
   Matrix ProcessMatrix(const Matrix& input_matrix) final {
     return input_matrix.colwise().normalized();
   }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    matrix->colwise().normalize();
+  }
 };
 REGISTER_CALCULATOR(L2NormalizeColumnCalculator);
 
@@ -352,6 +402,16 @@ class L2NormalizeCalculator : public BasicTimeSeriesCalculatorBase {
     }
     return input_matrix / rms;
   }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    constexpr double kEpsilon = 1e-8;
+    double rms = std::sqrt(matrix->squaredNorm() / matrix->size());
+    if (rms > kEpsilon) {
+      *matrix /= rms;
+    }
+  }
 };
 REGISTER_CALCULATOR(L2NormalizeCalculator);
 
@@ -369,6 +429,16 @@ class PeakNormalizeCalculator : public BasicTimeSeriesCalculatorBase {
     }
     return input_matrix / max_pcm;
   }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    constexpr double kEpsilon = 1e-8;
+    double max_pcm = matrix->cwiseAbs().maxCoeff();
+    if (max_pcm > kEpsilon) {
+      *matrix /= max_pcm;
+    }
+  }
 };
 REGISTER_CALCULATOR(PeakNormalizeCalculator);
 
@@ -380,6 +450,12 @@ class ElementwiseSquareCalculator : public BasicTimeSeriesCalculatorBase {
   Matrix ProcessMatrix(const Matrix& input_matrix) final {
     return input_matrix.array().square();
   }
+
+  bool CanProcessMatrixInPlace() const final { return true; }
+
+  void ProcessMatrixInPlace(Matrix* matrix) final {
+    matrix->array() = matrix->array().square();
+  }
 };
 REGISTER_CALCULATOR(ElementwiseSquareCalculator);
 
@@ -15,7 +15,9 @@
 // Abstract base class for basic MediaPipe calculators that operate on
 // TimeSeries streams and don't require any Options protos.
 // Subclasses must override ProcessMatrix, and optionally
-// MutateHeader.
+// MutateHeader. Subclasses whose output has the shape of their input may also
+// override CanProcessMatrixInPlace and ProcessMatrixInPlace, to reuse the
+// input matrix of packets that are not shared instead of allocating a new one.
 
 #ifndef MEDIAPIPE_CALCULATORS_AUDIO_BASIC_TIME_SERIES_CALCULATORS_H_
 #define MEDIAPIPE_CALCULATORS_AUDIO_BASIC_TIME_SERIES_CALCULATORS_H_
@@ -41,6 +43,14 @@ class BasicTimeSeriesCalculatorBase : public CalculatorBase {
 
   // Process() calls this method on each packet to compute the output matrix.
   virtual Matrix ProcessMatrix(const Matrix& input_matrix) = 0;
+
+  // Returns true if ProcessMatrixInPlace() is implemented.
+  virtual bool CanProcessMatrixInPlace() const { return false; }
+
+  // Process() calls this method instead of ProcessMatrix() when the input
+  // packet is the only owner of its matrix, to overwrite the matrix with the
+  // output. Must compute the same output as ProcessMatrix().
+  virtual void ProcessMatrixInPlace(Matrix* matrix) {}
 };
 
 }  // namespace mediapipe
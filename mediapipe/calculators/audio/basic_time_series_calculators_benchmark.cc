@@ -0,0 +1,109 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+// Benchmark for BasicTimeSeriesCalculators. Input packets are either moved
+// into the graph, so that calculators may process them in place, or shared
+// with the benchmark, so that calculators must copy them.
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/matrix.h"
+#include "mediapipe/framework/formats/time_series_header.pb.h"
+#include "mediapipe/framework/packet.h"
+
+using ::mediapipe::Matrix;
+
+// Runs a calculator on 64-channel packets of 1024 samples, such as the frames
+// of a filterbank. The second argument selects whether input packets are
+// shared.
+void BM_BasicTimeSeriesCalculator(benchmark::State& state,
+                                  const std::string& calculator) {
+  constexpr float kSampleRate = 16000.0;
+  constexpr int kNumChannels = 64;
+  constexpr int kNumSamples = 1024;
+  constexpr int kNumInputPackets = 100;
+  const bool shared_input = state.range(0);
+  const Matrix samples = Matrix::Random(kNumChannels, kNumSamples);
+
+  mediapipe::CalculatorGraphConfig config;
+  config.add_input_stream("input");
+  config.add_output_stream("output");
+  auto* node = config.add_node();
+  node->set_calculator(calculator);
+  node->add_input_stream("input");
+  node->add_output_stream("output");
+
+  for (auto _ : state) {
+    state.PauseTiming();  // Pause benchmark timing.
+
+    // Prepare input packets, each owning its block of samples.
+    std::vector<mediapipe::Packet> input_packets;
+    input_packets.reserve(kNumInputPackets);
+    for (int i = 0; i < kNumInputPackets; ++i) {
+      input_packets.push_back(mediapipe::MakePacket<Matrix>(samples).At(
+          mediapipe::Timestamp::FromSeconds(i * kNumSamples / kSampleRate)));
+    }
+    // Initialize graph.
+    mediapipe::CalculatorGraph graph;
+    ABSL_CHECK_OK(graph.Initialize(config));
+    // Prepare input header.
+    auto header = std::make_unique<mediapipe::TimeSeriesHeader>();
+    header->set_sample_rate(kSampleRate);
+    header->set_num_channels(kNumChannels);
+    header->set_num_samples(kNumSamples);
+
+    state.ResumeTiming();  // Resume benchmark timing.
+
+    ABSL_CHECK_OK(graph.StartRun({}, {{"input", Adopt(header.release())}}));
+    for (auto& packet : input_packets) {
+      if (shared_input) {
+        ABSL_CHECK_OK(graph.AddPacketToInputStream("input", packet));
+      } else {
+        ABSL_CHECK_OK(graph.AddPacketToInputStream("input", std::move(packet)));
+      }
+    }
+    ABSL_CHECK(!graph.HasError());
+    ABSL_CHECK_OK(graph.CloseAllInputStreams());
+    ABSL_CHECK_OK(graph.WaitUntilDone());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumInputPackets);
+}
+BENCHMARK_CAPTURE(BM_BasicTimeSeriesCalculator, SubtractMean,
+                  "SubtractMeanCalculator")
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK_CAPTURE(BM_BasicTimeSeriesCalculator, DivideByMeanAcrossChannels,
+                  "DivideByMeanAcrossChannelsCalculator")
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK_CAPTURE(BM_BasicTimeSeriesCalculator, L2Normalize,
+                  "L2NormalizeCalculator")
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK_CAPTURE(BM_BasicTimeSeriesCalculator, ElementwiseSquare,
+                  "ElementwiseSquareCalculator")
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK_CAPTURE(BM_BasicTimeSeriesCalculator, AverageTimeSeriesAcrossChannels,
+                  "AverageTimeSeriesAcrossChannelsCalculator")
+    ->Arg(0)
+    ->Arg(1);
+
+BENCHMARK_MAIN();
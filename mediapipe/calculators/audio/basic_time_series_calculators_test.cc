@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Eigen/Core"
@@ -25,6 +26,8 @@
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/sink.h"
 #include "mediapipe/util/time_series_test_util.h"
 
 namespace mediapipe {
@@ -512,4 +515,59 @@ TEST_F(FirstHalfSlicerCalculatorTest, MultiplePackets) {
         output + Matrix::Constant(output.rows(), output.cols(), 3.5f)});
 }
 
+// Runs SubtractMeanCalculator in a graph on an input packet that is moved into
+// the graph when `shared_input` is false, and on a copy of it otherwise.
+void RunSubtractMeanInGraph(bool shared_input, const Matrix& input,
+                            const float** input_data, Packet* output_packet) {
+  auto config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "input"
+    node {
+      calculator: "SubtractMeanCalculator"
+      input_stream: "input"
+      output_stream: "output"
+    }
+  )pb");
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("output", &config, &output_packets);
+  auto header = std::make_unique<TimeSeriesHeader>();
+  header->set_sample_rate(20.0);
+  header->set_num_channels(input.rows());
+  header->set_num_samples(input.cols());
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}, {{"input", Adopt(header.release())}}));
+  Packet input_packet = MakePacket<Matrix>(input).At(Timestamp(0));
+  *input_data = input_packet.Get<Matrix>().data();
+  if (shared_input) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream("input", input_packet));
+  } else {
+    MP_ASSERT_OK(
+        graph.AddPacketToInputStream("input", std::move(input_packet)));
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  ASSERT_EQ(output_packets.size(), 1);
+  *output_packet = output_packets[0];
+  if (shared_input) {
+    EXPECT_TRUE(input_packet.Get<Matrix>().isApprox(input));
+  }
+}
+
+TEST(BasicTimeSeriesCalculatorBaseTest, ProcessesUnsharedInputInPlace) {
+  Matrix input(2, 3);
+  input << 1, 2, 3, -1, 0, 4;
+  Matrix expected(2, 3);
+  expected << -1, 0, 1, -2, -1, 3;
+
+  for (bool shared_input : {false, true}) {
+    const float* input_data = nullptr;
+    Packet output_packet;
+    RunSubtractMeanInGraph(shared_input, input, &input_data, &output_packet);
+    const Matrix& output = output_packet.Get<Matrix>();
+    EXPECT_TRUE(output.isApprox(expected)) << output;
+    EXPECT_EQ(output.data() == input_data, !shared_input);
+  }
+}
+
 }  // namespace mediapipe
@@ -16,9 +16,7 @@
 
 #include "mediapipe/calculators/audio/rational_factor_resample_calculator.h"
 
-#include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
-#include "audio/dsp/resampler_q.h"
 
 using audio_dsp::Resampler;
 
@@ -36,22 +34,31 @@ absl::Status RationalFactorResampleCalculator::Close(CalculatorContext* cc) {
 }
 
 namespace {
-void CopyChannelToVector(const Matrix& matrix, int channel,
-                         std::vector<float>* vec) {
-  vec->resize(matrix.cols());
-  Eigen::Map<Eigen::ArrayXf>(vec->data(), vec->size()) = matrix.row(channel);
-}
-
-void CopyVectorToChannel(const std::vector<float>& vec, Matrix* matrix,
-                         int channel) {
-  if (matrix->cols() == 0) {
-    matrix->resize(matrix->rows(), vec.size());
-  } else {
-    ABSL_CHECK_EQ(vec.size(), matrix->cols());
+// Returns the QResampler settings specified by the
+// RationalFactorResampleCalculatorOptions proto.
+audio_dsp::QResamplerParams QResamplerParamsFromOptions(
+    const double source_sample_rate, const double target_sample_rate,
+    const RationalFactorResampleCalculatorOptions& options) {
+  const auto& rational_factor_options =
+      options.resampler_rational_factor_options();
+  audio_dsp::QResamplerParams params;
+  if (rational_factor_options.has_radius() &&
+      rational_factor_options.has_cutoff() &&
+      rational_factor_options.has_kaiser_beta()) {
+    // Convert RationalFactorResampler kernel parameters to QResampler
+    // settings.
+    params.filter_radius_factor =
+        rational_factor_options.radius() *
+        std::min(1.0, target_sample_rate / source_sample_rate);
+    params.cutoff_proportion = 2 * rational_factor_options.cutoff() /
+                               std::min(source_sample_rate, target_sample_rate);
+    params.kaiser_beta = rational_factor_options.kaiser_beta();
   }
-  ABSL_CHECK_LT(channel, matrix->rows());
-  matrix->row(channel) =
-      Eigen::Map<const Eigen::ArrayXf>(vec.data(), vec.size());
+  // Set large enough so that the resampling factor between common sample
+  // rates (e.g. 8kHz, 16kHz, 22.05kHz, 32kHz, 44.1kHz, 48kHz) is exact, and
+  // that any factor is represented with error less than 0.025%.
+  params.max_denominator = 2000;
+  return params;
 }
 }  // namespace
 
@@ -72,16 +79,15 @@ absl::Status RationalFactorResampleCalculator::Open(CalculatorContext* cc) {
   source_sample_rate_ = input_header.sample_rate();
   num_channels_ = input_header.num_channels();
 
-  // Don't create resamplers for pass-thru (sample rates are equal).
+  // Don't create a resampler for pass-thru (sample rates are equal).
+  resampler_.reset();
   if (source_sample_rate_ != target_sample_rate_) {
-    resampler_.resize(num_channels_);
-    for (auto& r : resampler_) {
-      r = ResamplerFromOptions(source_sample_rate_, target_sample_rate_,
-                               resample_options);
-      if (!r) {
-        ABSL_LOG(ERROR) << "Failed to initialize resampler.";
-        return absl::UnknownError("Failed to initialize resampler.");
-      }
+    resampler_ = MultichannelResamplerFromOptions(
+        source_sample_rate_, target_sample_rate_, num_channels_,
+        resample_options);
+    if (!resampler_) {
+      ABSL_LOG(ERROR) << "Failed to initialize resampler.";
+      return absl::UnknownError("Failed to initialize resampler.");
     }
   }
 
@@ -118,7 +124,7 @@ absl::Status RationalFactorResampleCalculator::ProcessInternal(
 
   cumulative_input_samples_ += input_frame.cols();
   std::unique_ptr<Matrix> output_frame(new Matrix(num_channels_, 0));
-  if (resampler_.empty()) {
+  if (!resampler_) {
     // Sample rates were same for input and output; pass-thru.
     *output_frame = input_frame;
   } else {
@@ -137,16 +143,12 @@ absl::Status RationalFactorResampleCalculator::ProcessInternal(
 bool RationalFactorResampleCalculator::Resample(const Matrix& input_frame,
                                                 Matrix* output_frame,
                                                 bool should_flush) {
-  std::vector<float> input_vector;
-  std::vector<float> output_vector;
-  for (int i = 0; i < input_frame.rows(); ++i) {
-    CopyChannelToVector(input_frame, i, &input_vector);
-    if (should_flush) {
-      resampler_[i]->Flush(&output_vector);
-    } else {
-      resampler_[i]->ProcessSamples(input_vector, &output_vector);
-    }
-    CopyVectorToChannel(output_vector, output_frame, i);
+  // Each column of the Matrix is a frame of interleaved channel samples, so
+  // QResampler filters all the channels together without copying them.
+  if (should_flush) {
+    resampler_->Flush(output_frame);
+  } else {
+    resampler_->ProcessSamples(input_frame, output_frame);
   }
   return true;
 }
@@ -156,33 +158,22 @@ std::unique_ptr<Resampler<float>>
 RationalFactorResampleCalculator::ResamplerFromOptions(
     const double source_sample_rate, const double target_sample_rate,
     const RationalFactorResampleCalculatorOptions& options) {
-  std::unique_ptr<Resampler<float>> resampler;
-  const auto& rational_factor_options =
-      options.resampler_rational_factor_options();
-  audio_dsp::QResamplerParams params;
-  if (rational_factor_options.has_radius() &&
-      rational_factor_options.has_cutoff() &&
-      rational_factor_options.has_kaiser_beta()) {
-    // Convert RationalFactorResampler kernel parameters to QResampler
-    // settings.
-    params.filter_radius_factor =
-        rational_factor_options.radius() *
-        std::min(1.0, target_sample_rate / source_sample_rate);
-    params.cutoff_proportion = 2 * rational_factor_options.cutoff() /
-                               std::min(source_sample_rate, target_sample_rate);
-    params.kaiser_beta = rational_factor_options.kaiser_beta();
-  }
-  // Set large enough so that the resampling factor between common sample
-  // rates (e.g. 8kHz, 16kHz, 22.05kHz, 32kHz, 44.1kHz, 48kHz) is exact, and
-  // that any factor is represented with error less than 0.025%.
-  params.max_denominator = 2000;
+  return MultichannelResamplerFromOptions(source_sample_rate,
+                                          target_sample_rate,
+                                          /*num_channels=*/1, options);
+}
 
-  // NOTE: QResampler supports multichannel resampling, so the code might be
-  // simplified using a single instance rather than one per channel.
-  resampler = absl::make_unique<audio_dsp::QResampler<float>>(
-      source_sample_rate, target_sample_rate, /*num_channels=*/1, params);
-  if (resampler != nullptr && !resampler->Valid()) {
-    resampler = std::unique_ptr<Resampler<float>>();
+// static
+std::unique_ptr<audio_dsp::QResampler<float>>
+RationalFactorResampleCalculator::MultichannelResamplerFromOptions(
+    const double source_sample_rate, const double target_sample_rate,
+    int num_channels, const RationalFactorResampleCalculatorOptions& options) {
+  auto resampler = absl::make_unique<audio_dsp::QResampler<float>>(
+      source_sample_rate, target_sample_rate, num_channels,
+      QResamplerParamsFromOptions(source_sample_rate, target_sample_rate,
+                                  options));
+  if (!resampler->Valid()) {
+    return nullptr;
   }
   return resampler;
 }
@@ -22,6 +22,7 @@
 #include "Eigen/Core"
 #include "absl/strings/str_cat.h"
 #include "audio/dsp/resampler.h"
+#include "audio/dsp/resampler_q.h"
 #include "mediapipe/calculators/audio/rational_factor_resample_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
@@ -37,7 +38,8 @@ namespace mediapipe {
 // a varying number of samples per frame.
 //
 // NOTE: This calculator uses QResampler, despite the name, which supersedes
-// RationalFactorResampler.
+// RationalFactorResampler. A single QResampler resamples all the channels
+// together, directly from and to the column-major Matrix packets.
 class RationalFactorResampleCalculator : public CalculatorBase {
  public:
   struct TestAccess;
@@ -71,14 +73,22 @@ class RationalFactorResampleCalculator : public CalculatorBase {
       const double source_sample_rate, const double target_sample_rate,
       const RationalFactorResampleCalculatorOptions& options);
 
+  // Returns a QResampler of num_channels channels specified by the
+  // RationalFactorResampleCalculatorOptions proto. Returns null if the options
+  // specify an invalid resampler.
+  static std::unique_ptr<audio_dsp::QResampler<float>>
+  MultichannelResamplerFromOptions(
+      const double source_sample_rate, const double target_sample_rate,
+      int num_channels, const RationalFactorResampleCalculatorOptions& options);
+
   // Does Timestamp bookkeeping and resampling common to Process() and
   // Close().  Returns FAIL if the resampler state becomes
   // inconsistent.
   absl::Status ProcessInternal(const Matrix& input_frame, bool should_flush,
                                CalculatorContext* cc);
 
-  // Uses the internal resampler_ objects to actually resample each
-  // row of the input TimeSeries.  Returns false if the resampler
+  // Uses the internal resampler_ object to actually resample all the
+  // rows of the input TimeSeries.  Returns false if the resampler
   // state becomes inconsistent.
   bool Resample(const Matrix& input_frame, Matrix* output_frame,
                 bool should_flush);
@@ -90,7 +100,8 @@ class RationalFactorResampleCalculator : public CalculatorBase {
   Timestamp initial_timestamp_;
   bool check_inconsistent_timestamps_;
   int num_channels_;
-  std::vector<std::unique_ptr<ResamplerType>> resampler_;
+  // Null for pass-thru, when the sample rates are equal.
+  std::unique_ptr<audio_dsp::QResampler<float>> resampler_;
 };
 
 // Test-only access to RationalFactorResampleCalculator methods.
@@ -166,10 +166,14 @@ class SpectrogramCalculator : public CalculatorBase {
   absl::Status ProcessVector(const Matrix& input_stream, CalculatorContext* cc);
 
   // Templated function to process either real- or complex-output spectrogram.
+  // postprocess_output_fn translates all the frames of a channel at once, in
+  // place, from the values returned by the Spectrogram object and applies
+  // the output scale in the same pass.
   template <class OutputMatrixType>
   absl::Status ProcessVectorToOutput(
       const Matrix& input_stream,
-      const OutputMatrixType postprocess_output_fn(const OutputMatrixType&),
+      void postprocess_output_fn(float output_scale,
+                                 OutputMatrixType* output_frames),
       CalculatorContext* cc);
 
   // Use the MediaPipe timestamp instead of the estimated one. Useful when the
@@ -198,6 +202,8 @@ class SpectrogramCalculator : public CalculatorBase {
   bool allow_multichannel_input_;
   // Vector of Spectrogram objects, one for each channel.
   std::vector<std::unique_ptr<audio_dsp::Spectrogram>> spectrogram_generators_;
+  // Samples of one input channel, reused across channels and packets.
+  std::vector<float> input_vector_;
   // Fixed scale factor applied to output values (regardless of type).
   double output_scale_;
 
@@ -361,7 +367,8 @@ absl::Status SpectrogramCalculator::Process(CalculatorContext* cc) {
 template <class OutputMatrixType>
 absl::Status SpectrogramCalculator::ProcessVectorToOutput(
     const Matrix& input_stream,
-    const OutputMatrixType postprocess_output_fn(const OutputMatrixType&),
+    void postprocess_output_fn(float output_scale,
+                               OutputMatrixType* output_frames),
     CalculatorContext* cc) {
   std::unique_ptr<std::vector<OutputMatrixType>> spectrogram_matrices(
       new std::vector<OutputMatrixType>());
@@ -373,12 +380,12 @@ absl::Status SpectrogramCalculator::ProcessVectorToOutput(
     output_vectors.clear();
 
     // Copy one row (channel) of the input matrix into the std::vector.
-    std::vector<float> input_vector(input_stream.cols());
-    Eigen::Map<Matrix>(&input_vector[0], 1, input_vector.size()) =
+    input_vector_.resize(input_stream.cols());
+    Eigen::Map<Matrix>(input_vector_.data(), 1, input_vector_.size()) =
         input_stream.row(channel);
 
     if (!spectrogram_generators_[channel]->ComputeSpectrogram(
-            input_vector, &output_vectors)) {
+            input_vector_, &output_vectors)) {
       return absl::Status(absl::StatusCode::kInternal,
                           "Spectrogram returned failure");
     }
@@ -396,14 +403,13 @@ absl::Status SpectrogramCalculator::ProcessVectorToOutput(
       OutputMatrixType output_frames(num_output_channels_,
                                      output_vectors.size());
       for (int frame = 0; frame < output_vectors.size(); ++frame) {
-        Eigen::Map<const OutputMatrixType> frame_map(
-            &output_vectors[frame][0], output_vectors[frame].size(), 1);
-        // The underlying dsp object returns squared magnitudes; here
-        // we optionally translate to linear magnitude or dB.
-        output_frames.col(frame) =
-            output_scale_ * postprocess_output_fn(frame_map);
+        output_frames.col(frame) = Eigen::Map<const OutputMatrixType>(
+            output_vectors[frame].data(), output_vectors[frame].size(), 1);
       }
-      spectrogram_matrices->push_back(output_frames);
+      // The underlying dsp object returns squared magnitudes; here
+      // we optionally translate to linear magnitude or dB.
+      postprocess_output_fn(output_scale_, &output_frames);
+      spectrogram_matrices->push_back(std::move(output_frames));
     }
   }
   // If the input is very short, there may not be enough accumulated,
@@ -418,7 +424,7 @@ absl::Status SpectrogramCalculator::ProcessVectorToOutput(
                                  CurrentOutputTimestamp(cc));
     } else {
       cc->Outputs().Index(0).Add(
-          new OutputMatrixType(spectrogram_matrices->at(0)),
+          new OutputMatrixType(std::move(spectrogram_matrices->at(0))),
           CurrentOutputTimestamp(cc));
     }
     cumulative_completed_frames_ += output_vectors.size();
@@ -440,31 +446,32 @@ absl::Status SpectrogramCalculator::ProcessVector(const Matrix& input_stream,
       // "silhouette" of the different cases.
       // clang-format off
     case SpectrogramCalculatorOptions::WINDOW_TYPE_COMPLEX: {
-      return ProcessVectorToOutput(
+      return ProcessVectorToOutput<Eigen::MatrixXcf>(
           input_stream,
-          +[](const Eigen::MatrixXcf& col) -> const Eigen::MatrixXcf {
-            return col;
+          +[](float scale, Eigen::MatrixXcf* frames) {
+            *frames *= scale;
           }, cc);
     }
     case SpectrogramCalculatorOptions::WINDOW_TYPE_SQUARED_MAGNITUDE: {
-      return ProcessVectorToOutput(
+      return ProcessVectorToOutput<Matrix>(
           input_stream,
-          +[](const Matrix& col) -> const Matrix {
-            return col;
+          +[](float scale, Matrix* frames) {
+            *frames *= scale;
           }, cc);
     }
     case SpectrogramCalculatorOptions::WINDOW_TYPE_LINEAR_MAGNITUDE: {
-      return ProcessVectorToOutput(
+      return ProcessVectorToOutput<Matrix>(
           input_stream,
-          +[](const Matrix& col) -> const Matrix {
-            return col.array().sqrt().matrix();
+          +[](float scale, Matrix* frames) {
+            frames->array() = scale * frames->array().sqrt();
           }, cc);
     }
     case SpectrogramCalculatorOptions::WINDOW_TYPE_DECIBELS: {
-      return ProcessVectorToOutput(
+      return ProcessVectorToOutput<Matrix>(
           input_stream,
-          +[](const Matrix& col) -> const Matrix {
-            return kLnSquaredMagnitudeToDb * col.array().log().matrix();
+          +[](float scale, Matrix* frames) {
+            frames->array() =
+                scale * (kLnSquaredMagnitudeToDb * frames->array().log());
           }, cc);
     }
     // clang-format on
@@ -15,6 +15,9 @@
 // Defines TimeSeriesFramerCalculator.
 #include <math.h>
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
 #include <vector>
 
 #include "Eigen/Core"
@@ -128,62 +131,75 @@ class TimeSeriesFramerCalculator : public CalculatorBase {
   // The current timestamp is updated along with the incoming packets.
   Timestamp current_timestamp_;
 
-  // Samples are buffered in a vector of sample blocks.
-  class SampleBlockBuffer {
+  // Samples are buffered in a ring buffer of contiguous sample columns, so
+  // that each sample is copied once into the buffer and once into each output
+  // frame containing it.
+  class SampleRingBuffer {
    public:
     // Initializes the buffer.
     void Init(double sample_rate, int num_channels) {
       ts_units_per_sample_ = Timestamp::kTimestampUnitsPerSecond / sample_rate;
       num_channels_ = num_channels;
+      samples_.resize(num_channels, 0);
+      head_ = 0;
       num_samples_ = 0;
-      first_block_offset_ = 0;
+      front_sample_index_ = 0;
+      blocks_.clear();
     }
 
     // Number of channels, equal to the number of rows in each Matrix.
     int num_channels() const { return num_channels_; }
-    // Total number of available samples over all blocks.
+    // Total number of available samples.
     int num_samples() const { return num_samples_; }
 
     // Pushes a new block of samples on the back of the buffer with `timestamp`
     // being the input timestamp of the packet containing the Matrix.
     void Push(const Matrix& samples, Timestamp timestamp);
-    // Copies `count` samples from the front of the buffer. If there are fewer
-    // samples than this, the result is zero padded to have `count` samples.
+    // Copies `count` samples from the front of the buffer, multiplied by
+    // `window` if it is not null. If there are fewer samples than this, the
+    // result is zero padded to have `count` samples.
     // The timestamp of the last copied sample is written to *last_timestamp.
     // This output is used below to update `current_timestamp_`, which is only
     // used when `use_local_timestamp` is true.
-    Matrix CopySamples(int count, Timestamp* last_timestamp) const;
+    Matrix CopySamples(int count, const Eigen::RowVectorXf* window,
+                       Timestamp* last_timestamp) const;
     // Drops `count` samples from the front of the buffer. If `count` exceeds
     // `num_samples()`, the buffer is emptied.  Returns how many samples were
     // dropped.
     int DropSamples(int count);
 
    private:
-    struct Block {
-      // Matrix of num_channels rows by num_samples columns, a block of possibly
-      // multiple samples.
-      Matrix samples;
-      // Timestamp of the first sample in the Block. This comes from the input
-      // packet's timestamp that contains this Matrix.
+    // The timestamp of the first sample pushed in a block.
+    struct BlockStart {
+      // Index of the first sample of the block, counted over all samples ever
+      // pushed.
+      int64_t sample_index;
+      // Timestamp of the first sample in the block. This comes from the input
+      // packet's timestamp that contains the block.
       Timestamp timestamp;
-
-      Block() : timestamp(Timestamp::Unstarted()) {}
-      Block(const Matrix& samples, Timestamp timestamp)
-          : samples(samples), timestamp(timestamp) {}
-      int num_samples() const { return samples.cols(); }
     };
-    std::vector<Block> blocks_;
+
+    int capacity() const { return samples_.cols(); }
+    // Grows the buffer to hold at least `num_samples` samples, moving the
+    // buffered samples to the start of the new buffer.
+    void Reserve(int num_samples);
+
+    // Matrix of num_channels rows by capacity() columns. The buffered samples
+    // are the num_samples_ columns from column head_, wrapping around to
+    // column 0.
+    Matrix samples_;
+    int head_;
     // Number of timestamp units per sample. Used to compute timestamps as
     // nth sample timestamp = base_timestamp + round(ts_units_per_sample_ * n).
     double ts_units_per_sample_;
     // Number of rows in each Matrix.
     int num_channels_;
-    // The total number of samples over all blocks, equal to
-    // (sum_i blocks_[i].num_samples()) - first_block_offset_.
+    // The number of buffered samples.
     int num_samples_;
-    // The number of samples in the first block that have been discarded. This
-    // way we can cheaply represent "partially discarding" a block.
-    int first_block_offset_;
+    // Index of the sample at head_, counted over all samples ever pushed.
+    int64_t front_sample_index_;
+    // The starts of the blocks holding buffered samples, in order.
+    std::deque<BlockStart> blocks_;
   } sample_buffer_;
 
   bool use_window_;
@@ -193,79 +209,95 @@ class TimeSeriesFramerCalculator : public CalculatorBase {
 };
 REGISTER_CALCULATOR(TimeSeriesFramerCalculator);
 
-void TimeSeriesFramerCalculator::SampleBlockBuffer::Push(const Matrix& samples,
-                                                         Timestamp timestamp) {
-  num_samples_ += samples.cols();
-  blocks_.emplace_back(samples, timestamp);
+void TimeSeriesFramerCalculator::SampleRingBuffer::Reserve(int num_samples) {
+  if (num_samples <= capacity()) {
+    return;
+  }
+  Matrix samples(num_channels_, std::max(num_samples, 2 * capacity()));
+  const int first_part = std::min(num_samples_, capacity() - head_);
+  samples.leftCols(first_part) = samples_.middleCols(head_, first_part);
+  samples.middleCols(first_part, num_samples_ - first_part) =
+      samples_.leftCols(num_samples_ - first_part);
+  samples_ = std::move(samples);
+  head_ = 0;
 }
 
-Matrix TimeSeriesFramerCalculator::SampleBlockBuffer::CopySamples(
-    int count, Timestamp* last_timestamp) const {
-  Matrix copied(num_channels_, count);
+void TimeSeriesFramerCalculator::SampleRingBuffer::Push(const Matrix& samples,
+                                                        Timestamp timestamp) {
+  const int count = samples.cols();
+  if (count == 0) {
+    return;
+  }
+  Reserve(num_samples_ + count);
+  blocks_.push_back({front_sample_index_ + num_samples_, timestamp});
+  // Copy to the back of the buffer, in two parts if it wraps around.
+  const int tail = (head_ + num_samples_) % capacity();
+  const int first_part = std::min(count, capacity() - tail);
+  samples_.middleCols(tail, first_part) = samples.leftCols(first_part);
+  samples_.leftCols(count - first_part) = samples.rightCols(count - first_part);
+  num_samples_ += count;
+}
 
-  if (!blocks_.empty()) {
-    int num_copied = 0;
-    // First block has an offset for samples that have been discarded.
-    int offset = first_block_offset_;
-    int n;
-    Timestamp last_block_ts;
-    int last_sample_index;
-
-    for (auto it = blocks_.begin(); it != blocks_.end() && count > 0; ++it) {
-      n = std::min(it->num_samples() - offset, count);
-      // Copy `n` samples from the next block.
-      copied.middleCols(num_copied, n) = it->samples.middleCols(offset, n);
-      count -= n;
-      num_copied += n;
-      last_block_ts = it->timestamp;
-      last_sample_index = offset + n - 1;
-      offset = 0;  // No samples have been discarded in subsequent blocks.
+Matrix TimeSeriesFramerCalculator::SampleRingBuffer::CopySamples(
+    int count, const Eigen::RowVectorXf* window,
+    Timestamp* last_timestamp) const {
+  Matrix copied(num_channels_, count);
+  const int num_copied = std::min(count, num_samples_);
+
+  // Copies `n` buffered columns from column `from` to column `to` of the
+  // output frame, applying the window while copying.
+  auto copy_columns = [&](int from, int to, int n) {
+    if (window == nullptr) {
+      copied.middleCols(to, n) = samples_.middleCols(from, n);
+    } else {
+      copied.middleCols(to, n) = samples_.middleCols(from, n).array().rowwise() *
+                                 window->segment(to, n).array();
+    }
+  };
+
+  if (num_copied > 0) {
+    // Copy from the front of the buffer, in two parts if it wraps around.
+    const int first_part = std::min(num_copied, capacity() - head_);
+    copy_columns(head_, 0, first_part);
+    copy_columns(0, first_part, num_copied - first_part);
+
+    // Compute the timestamp of the last copied sample from the start of the
+    // block that contains it.
+    const int64_t last_sample_index = front_sample_index_ + num_copied - 1;
+    auto block_it = blocks_.begin();
+    while (std::next(block_it) != blocks_.end() &&
+           std::next(block_it)->sample_index <= last_sample_index) {
+      ++block_it;
     }
-
-    // Compute the timestamp of the last copied sample.
     *last_timestamp =
-        last_block_ts + std::round(ts_units_per_sample_ * last_sample_index);
+        block_it->timestamp +
+        std::round(ts_units_per_sample_ *
+                   (last_sample_index - block_it->sample_index));
   }
 
-  if (count > 0) {
-    copied.rightCols(count).setZero();  // Zero pad if needed.
+  if (count > num_copied) {
+    copied.rightCols(count - num_copied).setZero();  // Zero pad if needed.
   }
 
   return copied;
 }
 
-int TimeSeriesFramerCalculator::SampleBlockBuffer::DropSamples(int count) {
-  if (blocks_.empty()) {
+int TimeSeriesFramerCalculator::SampleRingBuffer::DropSamples(int count) {
+  const int num_samples_dropped = std::min(count, num_samples_);
+  if (num_samples_dropped == 0) {
     return 0;
   }
+  head_ = (head_ + num_samples_dropped) % capacity();
+  num_samples_ -= num_samples_dropped;
+  front_sample_index_ += num_samples_dropped;
 
-  auto block_it = blocks_.begin();
-  if (first_block_offset_ + count < block_it->num_samples()) {
-    // `count` is less than the remaining samples in the first block.
-    first_block_offset_ += count;
-    num_samples_ -= count;
-    return count;
-  }
-
-  int num_samples_dropped = block_it->num_samples() - first_block_offset_;
-  count -= num_samples_dropped;
-  first_block_offset_ = 0;
-
-  for (++block_it; block_it != blocks_.end(); ++block_it) {
-    if (block_it->num_samples() > count) {
-      break;
-    }
-    num_samples_dropped += block_it->num_samples();
-    count -= block_it->num_samples();
+  // Drop the starts of blocks whose samples have all been dropped.
+  if (num_samples_ == 0) {
+    blocks_.clear();
   }
-
-  blocks_.erase(blocks_.begin(), block_it);  // Drop whole blocks.
-  if (!blocks_.empty()) {
-    first_block_offset_ = count;  // Drop part of the next block.
-    num_samples_dropped += count;
+  while (blocks_.size() > 1 && blocks_[1].sample_index <= front_sample_index_) {
+    blocks_.pop_front();
   }
-
-  num_samples_ -= num_samples_dropped;
   return num_samples_dropped;
 }
 
@@ -283,16 +315,13 @@ absl::Status TimeSeriesFramerCalculator::Process(CalculatorContext* cc) {
   while (sample_buffer_.num_samples() >=
          frame_duration_samples_ + samples_still_to_drop_) {
     sample_buffer_.DropSamples(samples_still_to_drop_);
-    Matrix output_frame = sample_buffer_.CopySamples(frame_duration_samples_,
-                                                     &current_timestamp_);
+    // Apply the window to each row of output_frame while copying.
+    Matrix output_frame = sample_buffer_.CopySamples(
+        frame_duration_samples_, use_window_ ? &window_ : nullptr,
+        &current_timestamp_);
     const int frame_step_samples = next_frame_step_samples();
     samples_still_to_drop_ = frame_step_samples;
 
-    if (use_window_) {
-      // Apply the window to each row of output_frame.
-      output_frame.array().rowwise() *= window_.array();
-    }
-
     cc->Outputs().Index(0).AddPacket(MakePacket<Matrix>(std::move(output_frame))
                                          .At(CurrentOutputTimestamp()));
     ++cumulative_output_frames_;
@@ -312,8 +341,8 @@ absl::Status TimeSeriesFramerCalculator::Close(CalculatorContext* cc) {
   sample_buffer_.DropSamples(samples_still_to_drop_);
 
   if (sample_buffer_.num_samples() > 0 && pad_final_packet_) {
-    Matrix output_frame = sample_buffer_.CopySamples(frame_duration_samples_,
-                                                     &current_timestamp_);
+    Matrix output_frame = sample_buffer_.CopySamples(
+        frame_duration_samples_, /*window=*/nullptr, &current_timestamp_);
     cc->Outputs().Index(0).AddPacket(MakePacket<Matrix>(std::move(output_frame))
                                          .At(CurrentOutputTimestamp()));
   }
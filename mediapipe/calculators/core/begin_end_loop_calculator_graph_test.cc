@@ -12,10 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "mediapipe/calculators/core/begin_loop_calculator.h"
 #include "mediapipe/calculators/core/end_loop_calculator.h"
 #include "mediapipe/framework/calculator_contract.h"
@@ -163,6 +166,106 @@ TEST_F(BeginEndLoopCalculatorGraphTest, MultipleVectors) {
                   PacketOfIntsEq(input_timestamp2, std::vector<int>{3, 4})));
 }
 
+// Increments the input like IncrementCalculator, but waits for up to a second
+// for another invocation to run at the same time, so that the loop body runs
+// its elements concurrently when max_in_flight allows it.
+class ConcurrentIncrementCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).Set<int>();
+    cc->Outputs().Index(0).Set<int>();
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      ++num_running_;
+      max_num_running_ = std::max(max_num_running_, num_running_);
+      mutex_.AwaitWithTimeout(absl::Condition(
+                                  +[](int* max_num_running) {
+                                    return *max_num_running > 1;
+                                  },
+                                  &max_num_running_),
+                              absl::Seconds(1));
+      --num_running_;
+    }
+    const int& input_int = cc->Inputs().Index(0).Get<int>();
+    auto output_int = absl::make_unique<int>(input_int + 1);
+    cc->Outputs().Index(0).Add(output_int.release(), cc->InputTimestamp());
+    return absl::OkStatus();
+  }
+
+  static int max_num_running() {
+    absl::MutexLock lock(&mutex_);
+    return max_num_running_;
+  }
+
+ private:
+  static absl::Mutex mutex_;
+  static int num_running_ ABSL_GUARDED_BY(mutex_);
+  static int max_num_running_ ABSL_GUARDED_BY(mutex_);
+};
+
+absl::Mutex ConcurrentIncrementCalculator::mutex_(absl::kConstInit);
+int ConcurrentIncrementCalculator::num_running_ = 0;
+int ConcurrentIncrementCalculator::max_num_running_ = 0;
+
+REGISTER_CALCULATOR(ConcurrentIncrementCalculator);
+
+TEST(BeginEndLoopCalculatorGraphWithParallelBodyTest,
+     GathersElementsInOrder) {
+  auto graph_config = ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        num_threads: 4
+        input_stream: "ints"
+        node {
+          calculator: "BeginLoopIntegerCalculator"
+          input_stream: "ITERABLE:ints"
+          output_stream: "ITEM:int"
+          output_stream: "BATCH_END:timestamp"
+        }
+        node {
+          calculator: "ConcurrentIncrementCalculator"
+          input_stream: "int"
+          output_stream: "int_plus_one"
+          max_in_flight: 4
+        }
+        node {
+          calculator: "EndLoopIntegersCalculator"
+          input_stream: "ITEM:int_plus_one"
+          input_stream: "BATCH_END:timestamp"
+          output_stream: "ITERABLE:ints_plus_one"
+        }
+      )pb");
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("ints_plus_one", &graph_config, &output_packets);
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  MP_ASSERT_OK(graph.StartRun({}));
+
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "ints", MakePacket<std::vector<int>>(std::vector<int>{0, 1, 2, 3, 4, 5})
+                  .At(Timestamp(0))));
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "ints",
+      MakePacket<std::vector<int>>(std::vector<int>{6, 7}).At(Timestamp(1))));
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  EXPECT_GT(ConcurrentIncrementCalculator::max_num_running(), 1);
+  EXPECT_THAT(output_packets,
+              testing::ElementsAre(
+                  PacketOfIntsEq(Timestamp(0),
+                                 std::vector<int>{1, 2, 3, 4, 5, 6}),
+                  PacketOfIntsEq(Timestamp(1), std::vector<int>{7, 8})));
+}
+
 // Passes non empty vector through or outputs empty vector in case of timestamp
 // bound update.
 class PassThroughOrEmptyVectorCalculator : public CalculatorBase {
@@ -66,6 +66,13 @@ namespace mediapipe {
 // sub-graph can run multiple times, once per element in the "ITERABLE" for each
 // packet clone of the packets in the "CLONE" input streams. Think of CLONEd
 // inputs as loop-wide constants.
+//
+// The elements of an iterable run through the loop body one at a time by
+// default. Setting "max_in_flight" on the nodes of a stateless loop body, or
+// on a subgraph node used as the loop body, lets up to that many elements run
+// through it at the same time. Since the outputs of such nodes are still
+// delivered in timestamp order, EndLoopCalculator gathers them in the order of
+// the input iterable.
 template <typename IterableT>
 class BeginLoopCalculator : public CalculatorBase {
   using ItemT = typename IterableT::value_type;
@@ -13,11 +13,15 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "absl/time/time.h"
 #include "mediapipe/calculators/core/flow_limiter_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/deps/clock.h"
+#include "mediapipe/framework/deps/monotonic_clock.h"
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/util/header_util.h"
 
@@ -27,6 +31,11 @@ constexpr char kFinishedTag[] = "FINISHED";
 constexpr char kAllowTag[] = "ALLOW";
 constexpr char kMaxInFlightTag[] = "MAX_IN_FLIGHT";
 constexpr char kOptionsTag[] = "OPTIONS";
+constexpr char kClockTag[] = "CLOCK";
+constexpr char kLoadTag[] = "LOAD";
+
+// The number of frame latencies averaged for each max_in_flight adjustment.
+constexpr int kLatencySamples = 8;
 
 // FlowLimiterCalculator is used to limit the number of frames in flight
 // by dropping input frames when necessary.
@@ -64,6 +73,27 @@ constexpr char kOptionsTag[] = "OPTIONS";
 // including the current timestamp, and "ALLOW = false" indicates the start of
 // dropping frames including the current timestamp.
 //
+// If `target_latency` is set, `max_in_flight` is adjusted at runtime from the
+// observed latency between the release of each frame and its "FINISHED"
+// signal.  After each adjustment, the frames released under the previous
+// limit are skipped, and then the latencies of the next few frames are
+// averaged.  The limit is lowered when the average exceeds the target, and
+// raised when the average scaled by one more frame in flight still meets the
+// target.  The optional "MAX_IN_FLIGHT" output stream reports each
+// adjustment, and the optional "CLOCK" input side packet holding a
+// std::shared_ptr<mediapipe::Clock> replaces the monotonic wall clock.
+//
+// The optional "LOAD" output stream requires `target_latency`.  It reports
+// for each released frame the latest average latency divided by the target,
+// or 0 before the first average.  Values above 1 show that the graph misses
+// the target even with a single frame in flight, so that downstream nodes
+// such as the LoadLevelCalculator can switch to cheaper processing.
+//
+// If `cancel_timed_out_frames` is set, the frames abandoned after
+// `in_flight_timeout` are cancelled in the graph, so that the nodes still
+// holding them skip their Process() calls.  The "FINISHED" stream then
+// receives only a timestamp bound for these frames.
+//
 // FlowLimiterCalculator provides limited support for multiple input streams.
 // The first input stream is treated as the main input stream and successive
 // input streams are treated as auxiliary input streams.  The auxiliary input
@@ -85,7 +115,13 @@ class FlowLimiterCalculator : public CalculatorBase {
     }
     cc->Inputs().Get("FINISHED", 0).SetAny();
     cc->InputSidePackets().Tag(kMaxInFlightTag).Set<int>().Optional();
+    cc->InputSidePackets()
+        .Tag(kClockTag)
+        .Set<std::shared_ptr<Clock>>()
+        .Optional();
     cc->Outputs().Tag(kAllowTag).Set<bool>().Optional();
+    cc->Outputs().Tag(kMaxInFlightTag).Set<int>().Optional();
+    cc->Outputs().Tag(kLoadTag).Set<double>().Optional();
     cc->SetInputStreamHandler("ImmediateInputStreamHandler");
     cc->SetProcessTimestampBounds(true);
     return absl::OkStatus();
@@ -98,6 +134,23 @@ class FlowLimiterCalculator : public CalculatorBase {
       options_.set_max_in_flight(
           cc->InputSidePackets().Tag(kMaxInFlightTag).Get<int>());
     }
+    if (options_.target_latency() > 0) {
+      RET_CHECK_GE(options_.max_in_flight_limit(), 1);
+      options_.set_max_in_flight(std::clamp(options_.max_in_flight(), 1,
+                                            options_.max_in_flight_limit()));
+      if (cc->InputSidePackets().HasTag(kClockTag)) {
+        clock_ = cc->InputSidePackets()
+                     .Tag(kClockTag)
+                     .Get<std::shared_ptr<Clock>>();
+      } else {
+        clock_ = std::shared_ptr<Clock>(
+            MonotonicClock::CreateSynchronizedMonotonicClock());
+      }
+      frames_to_skip_ = options_.max_in_flight();
+    } else {
+      RET_CHECK(!cc->Outputs().HasTag(kLoadTag))
+          << "The LOAD output stream requires target_latency.";
+    }
     input_queues_.resize(cc->Inputs().NumEntries(""));
     allowed_[Timestamp::Unset()] = true;
     RET_CHECK_OK(CopyInputHeadersToOutputs(cc->Inputs(), &(cc->Outputs())));
@@ -111,9 +164,13 @@ class FlowLimiterCalculator : public CalculatorBase {
     // Process the FINISHED input stream.
     Packet finished_packet = cc->Inputs().Tag(kFinishedTag).Value();
     if (finished_packet.Timestamp() == cc->InputTimestamp()) {
+      absl::Time release_time = absl::InfinitePast();
       while (!frames_in_flight_.empty() &&
              frames_in_flight_.front() <= finished_packet.Timestamp()) {
-        frames_in_flight_.pop_front();
+        release_time = PopFrameInFlight();
+      }
+      if (clock_ && release_time != absl::InfinitePast()) {
+        UpdateMaxInFlight(clock_->TimeNow() - release_time, cc);
       }
     }
 
@@ -133,7 +190,10 @@ class FlowLimiterCalculator : public CalculatorBase {
         latest_ts < Timestamp::Max()) {
       while (!frames_in_flight_.empty() &&
              (latest_ts - frames_in_flight_.front()) > timeout) {
-        frames_in_flight_.pop_front();
+        if (options_.cancel_timed_out_frames()) {
+          cc->CancelTimestamp(frames_in_flight_.front());
+        }
+        PopFrameInFlight();
       }
     }
 
@@ -144,7 +204,14 @@ class FlowLimiterCalculator : public CalculatorBase {
       input_queue.pop_front();
       cc->Outputs().Get("", 0).AddPacket(packet);
       SendAllow(true, packet.Timestamp(), cc);
+      if (cc->Outputs().HasTag(kLoadTag)) {
+        cc->Outputs().Tag(kLoadTag).AddPacket(
+            MakePacket<double>(load_).At(packet.Timestamp()));
+      }
       frames_in_flight_.push_back(packet.Timestamp());
+      if (clock_) {
+        release_times_.push_back(clock_->TimeNow());
+      }
     }
 
     // Limit the number of queued frames.
@@ -160,6 +227,9 @@ class FlowLimiterCalculator : public CalculatorBase {
     if (!input_queue.empty()) {
       Timestamp bound = input_queue.front().Timestamp();
       SetNextTimestampBound(bound, &cc->Outputs().Get("", 0));
+      if (cc->Outputs().HasTag(kLoadTag)) {
+        SetNextTimestampBound(bound, &cc->Outputs().Tag(kLoadTag));
+      }
     } else {
       Timestamp bound =
           cc->Inputs().Get("", 0).Value().Timestamp().NextAllowedInStream();
@@ -167,6 +237,9 @@ class FlowLimiterCalculator : public CalculatorBase {
       if (cc->Outputs().HasTag(kAllowTag)) {
         SetNextTimestampBound(bound, &cc->Outputs().Tag(kAllowTag));
       }
+      if (cc->Outputs().HasTag(kLoadTag)) {
+        SetNextTimestampBound(bound, &cc->Outputs().Tag(kLoadTag));
+      }
     }
 
     ProcessAuxiliaryInputs(cc);
@@ -193,6 +266,59 @@ class FlowLimiterCalculator : public CalculatorBase {
     return frames_in_flight_.size() < options_.max_in_flight();
   }
 
+  // Removes the oldest frame in flight.  Returns its release time, or
+  // absl::InfinitePast() if latency is not measured.
+  absl::Time PopFrameInFlight() {
+    frames_in_flight_.pop_front();
+    if (release_times_.empty()) {
+      return absl::InfinitePast();
+    }
+    absl::Time result = release_times_.front();
+    release_times_.pop_front();
+    return result;
+  }
+
+  // Records the latency of a finished frame, and adjusts max_in_flight once
+  // enough latencies have been observed since the previous adjustment.
+  void UpdateMaxInFlight(absl::Duration latency, CalculatorContext* cc) {
+    // Frames released before the previous adjustment are not representative.
+    if (frames_to_skip_ > 0) {
+      --frames_to_skip_;
+      return;
+    }
+    latency_sum_ += latency;
+    if (++latency_count_ < kLatencySamples) {
+      return;
+    }
+    const double mean_latency =
+        absl::ToDoubleMicroseconds(latency_sum_ / latency_count_);
+    latency_sum_ = absl::ZeroDuration();
+    latency_count_ = 0;
+    load_ = mean_latency / options_.target_latency();
+
+    // Latency grows at most in proportion to the frames in flight.
+    const int max_in_flight = options_.max_in_flight();
+    const double target = options_.target_latency();
+    int new_max_in_flight = max_in_flight;
+    if (mean_latency > target && max_in_flight > 1) {
+      new_max_in_flight = max_in_flight - 1;
+    } else if (mean_latency * (max_in_flight + 1) / max_in_flight <= target &&
+               max_in_flight < options_.max_in_flight_limit()) {
+      new_max_in_flight = max_in_flight + 1;
+    }
+    if (new_max_in_flight == max_in_flight) {
+      return;
+    }
+    VLOG(1) << "FlowLimiterCalculator mean latency " << mean_latency
+            << " us, adjusting max_in_flight to " << new_max_in_flight;
+    options_.set_max_in_flight(new_max_in_flight);
+    frames_to_skip_ = frames_in_flight_.size();
+    if (cc->Outputs().HasTag(kMaxInFlightTag)) {
+      cc->Outputs().Tag(kMaxInFlightTag).AddPacket(
+          MakePacket<int>(new_max_in_flight).At(cc->InputTimestamp()));
+    }
+  }
+
   // Outputs a packet indicating whether a frame was sent or dropped.
   void SendAllow(bool allow, Timestamp ts, CalculatorContext* cc) {
     if (cc->Outputs().HasTag(kAllowTag)) {
@@ -261,6 +387,18 @@ class FlowLimiterCalculator : public CalculatorBase {
   std::vector<std::deque<Packet>> input_queues_;
   std::deque<Timestamp> frames_in_flight_;
   std::map<Timestamp, bool> allowed_;
+
+  // The clock used to measure latency if target_latency is set.
+  std::shared_ptr<Clock> clock_;
+  // The release time of each frame in frames_in_flight_, if clock_ is set.
+  std::deque<absl::Time> release_times_;
+  // The finished frames to ignore before measuring latency.
+  int frames_to_skip_ = 0;
+  // The latencies measured since the previous adjustment.
+  absl::Duration latency_sum_ = absl::ZeroDuration();
+  int latency_count_ = 0;
+  // The latest mean latency divided by target_latency.
+  double load_ = 0;
 };
 REGISTER_CALCULATOR(FlowLimiterCalculator);
 
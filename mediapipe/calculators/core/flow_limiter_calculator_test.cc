@@ -980,5 +980,168 @@ TEST_F(FlowLimiterCalculatorTest, AuxiliaryInputs) {
               ElementsAreArray(PacketMatchers<bool>(expected_allow)));
 }
 
+// Shows that max_in_flight is adjusted to meet target_latency.
+// SleepCalculator processes one frame every 22 ms, so the latency grows by
+// about 22 ms with each frame in flight.  Starting from 4 frames in flight,
+// FlowLimiterCalculator lowers max_in_flight until the mean latency falls
+// under the 50 ms target, and then keeps it there.
+TEST_F(FlowLimiterCalculatorTest, TargetLatency) {
+  // Configure the test.
+  SetUpInputData();
+  SetUpSimulationClock();
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: 'in_1'
+        node {
+          calculator: 'FlowLimiterCalculator'
+          input_side_packet: 'OPTIONS:limiter_options'
+          input_side_packet: 'CLOCK:shared_clock'
+          input_stream: 'in_1'
+          input_stream: 'FINISHED:out_1'
+          input_stream_info: { tag_index: 'FINISHED' back_edge: true }
+          output_stream: 'in_1_sampled'
+          output_stream: 'MAX_IN_FLIGHT:max_in_flight'
+        }
+        node {
+          calculator: 'SleepCalculator'
+          input_side_packet: 'WARMUP_TIME:warmup_time'
+          input_side_packet: 'SLEEP_TIME:sleep_time'
+          input_side_packet: 'CLOCK:clock'
+          input_stream: 'PACKET:in_1_sampled'
+          output_stream: 'PACKET:out_1'
+        }
+      )pb");
+  auto limiter_options = ParseTextProtoOrDie<FlowLimiterCalculatorOptions>(R"pb(
+    max_in_flight: 4
+    target_latency: 50000  # 50 ms
+  )pb");
+  std::map<std::string, Packet> side_packets = {
+      {"limiter_options",
+       MakePacket<FlowLimiterCalculatorOptions>(limiter_options)},
+      {"warmup_time", MakePacket<int64_t>(22000)},
+      {"sleep_time", MakePacket<int64_t>(22000)},
+      {"clock", MakePacket<mediapipe::Clock*>(clock_)},
+      {"shared_clock",
+       MakePacket<std::shared_ptr<mediapipe::Clock>>(simulation_clock_)},
+  };
+
+  // Start the graph.
+  std::vector<Packet> max_in_flight_packets;
+  MP_ASSERT_OK(graph_.Initialize(graph_config));
+  MP_EXPECT_OK(graph_.ObserveOutputStream(
+      "max_in_flight", [&max_in_flight_packets](Packet p) {
+        max_in_flight_packets.push_back(p);
+        return absl::OkStatus();
+      }));
+  simulation_clock_->ThreadStart();
+  MP_ASSERT_OK(graph_.StartRun(side_packets));
+
+  // Add 100 input packets, one every 10 ms.
+  for (int i = 0; i < 100; ++i) {
+    MP_EXPECT_OK(graph_.AddPacketToInputStream("in_1", input_packets_[i]));
+    clock_->Sleep(absl::Microseconds(10000));
+  }
+
+  // Finish the graph.
+  MP_EXPECT_OK(graph_.CloseAllPacketSources());
+  clock_->Sleep(absl::Microseconds(100000));
+  MP_EXPECT_OK(graph_.WaitUntilDone());
+  simulation_clock_->ThreadFinish();
+
+  // Validate the adjustments.
+  std::vector<int> max_in_flight;
+  for (const Packet& packet : max_in_flight_packets) {
+    max_in_flight.push_back(packet.Get<int>());
+  }
+  EXPECT_THAT(max_in_flight, testing::ElementsAre(3, 2));
+}
+
+// Shows that the LOAD stream reports the mean latency relative to
+// target_latency for each released frame.  The load exceeds 1 while
+// max_in_flight is too high, and settles under 1 once the target is met.
+TEST_F(FlowLimiterCalculatorTest, TargetLatencyLoad) {
+  // Configure the test.
+  SetUpInputData();
+  SetUpSimulationClock();
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: 'in_1'
+        node {
+          calculator: 'FlowLimiterCalculator'
+          input_side_packet: 'OPTIONS:limiter_options'
+          input_side_packet: 'CLOCK:shared_clock'
+          input_stream: 'in_1'
+          input_stream: 'FINISHED:out_1'
+          input_stream_info: { tag_index: 'FINISHED' back_edge: true }
+          output_stream: 'in_1_sampled'
+          output_stream: 'LOAD:load'
+        }
+        node {
+          calculator: 'SleepCalculator'
+          input_side_packet: 'WARMUP_TIME:warmup_time'
+          input_side_packet: 'SLEEP_TIME:sleep_time'
+          input_side_packet: 'CLOCK:clock'
+          input_stream: 'PACKET:in_1_sampled'
+          output_stream: 'PACKET:out_1'
+        }
+      )pb");
+  auto limiter_options = ParseTextProtoOrDie<FlowLimiterCalculatorOptions>(R"pb(
+    max_in_flight: 4
+    target_latency: 50000  # 50 ms
+  )pb");
+  std::map<std::string, Packet> side_packets = {
+      {"limiter_options",
+       MakePacket<FlowLimiterCalculatorOptions>(limiter_options)},
+      {"warmup_time", MakePacket<int64_t>(22000)},
+      {"sleep_time", MakePacket<int64_t>(22000)},
+      {"clock", MakePacket<mediapipe::Clock*>(clock_)},
+      {"shared_clock",
+       MakePacket<std::shared_ptr<mediapipe::Clock>>(simulation_clock_)},
+  };
+
+  // Start the graph.
+  std::vector<Packet> sampled_packets;
+  std::vector<Packet> load_packets;
+  MP_ASSERT_OK(graph_.Initialize(graph_config));
+  MP_EXPECT_OK(graph_.ObserveOutputStream(
+      "in_1_sampled", [&sampled_packets](Packet p) {
+        sampled_packets.push_back(p);
+        return absl::OkStatus();
+      }));
+  MP_EXPECT_OK(
+      graph_.ObserveOutputStream("load", [&load_packets](Packet p) {
+        load_packets.push_back(p);
+        return absl::OkStatus();
+      }));
+  simulation_clock_->ThreadStart();
+  MP_ASSERT_OK(graph_.StartRun(side_packets));
+
+  // Add 100 input packets, one every 10 ms.
+  for (int i = 0; i < 100; ++i) {
+    MP_EXPECT_OK(graph_.AddPacketToInputStream("in_1", input_packets_[i]));
+    clock_->Sleep(absl::Microseconds(10000));
+  }
+
+  // Finish the graph.
+  MP_EXPECT_OK(graph_.CloseAllPacketSources());
+  clock_->Sleep(absl::Microseconds(100000));
+  MP_EXPECT_OK(graph_.WaitUntilDone());
+  simulation_clock_->ThreadFinish();
+
+  // Validate the load for each released frame.
+  ASSERT_EQ(load_packets.size(), sampled_packets.size());
+  for (int i = 0; i < load_packets.size(); ++i) {
+    EXPECT_EQ(load_packets[i].Timestamp(), sampled_packets[i].Timestamp());
+  }
+  EXPECT_EQ(load_packets.front().Get<double>(), 0.0);
+  double max_load = 0;
+  for (const Packet& packet : load_packets) {
+    max_load = std::max(max_load, packet.Get<double>());
+  }
+  EXPECT_GT(max_load, 1.0);
+  EXPECT_GT(load_packets.back().Get<double>(), 0.0);
+  EXPECT_LT(load_packets.back().Get<double>(), 1.0);
+}
+
 }  // anonymous namespace
 }  // namespace mediapipe
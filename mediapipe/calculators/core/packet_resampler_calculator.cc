@@ -612,6 +612,9 @@ absl::Status NoJitterStrategy::Open(CalculatorContext* cc) {
   base_timestamp_ = resampler_options.has_base_timestamp()
                         ? Timestamp(resampler_options.base_timestamp())
                         : Timestamp::Unset();
+  RET_CHECK_GE(resampler_options.early_output_tolerance(), 0);
+  early_output_tolerance_ =
+      TimestampDiff(resampler_options.early_output_tolerance());
 
   period_count_ = 0;
 
@@ -671,10 +674,11 @@ absl::Status NoJitterStrategy::Process(CalculatorContext* cc) {
     }
     // Now, if the received packet has a timestamp larger than the middle of
     // the current period, we can send a packet without waiting. We send the
-    // one closer to the middle.
+    // one closer to the middle. A packet received within the early output
+    // tolerance before the middle is sent without waiting as well.
     Timestamp target_timestamp =
         calculator_->PeriodIndexToTimestamp(period_count_);
-    if (received_timestamp >= target_timestamp) {
+    if (received_timestamp >= target_timestamp - early_output_tolerance_) {
       bool have_last_packet =
           (calculator_->last_packet_.Timestamp() != Timestamp::Unset());
       bool send_current =
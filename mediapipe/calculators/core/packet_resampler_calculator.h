@@ -91,6 +91,9 @@ class PacketReservoir {
 //   - 'Empty' periods happen when there are no packets for a long time
 //     (greater than a period). In this case, we send a copy of the last
 //     packet received before the empty period.
+//   - With early_output_tolerance, a packet that arrives within the
+//     tolerance before a middle point is sent for it right away, so the
+//     output does not wait for the next input packet.
 // The jitter feature is disabled by default. To enable it, you need to
 // implement CreateSecureRandom(const std::string&).
 //
@@ -385,6 +388,10 @@ class NoJitterStrategy : public PacketResamplerStrategy {
   // If specified, output timestamps are aligned with base_timestamp.
   // Otherwise, they are aligned with the first input timestamp.
   Timestamp base_timestamp_;
+
+  // How early a packet may arrive before the output timestamp of the current
+  // period and still be sent for it without waiting for a later packet.
+  TimestampDiff early_output_tolerance_;
 };
 
 }  // namespace mediapipe
@@ -284,6 +284,28 @@ TEST(PacketResamplerCalculatorTest, InputAtExactFrequencyMiddlepoints) {
 
 // When there are several candidates for a period, the one closer to the center
 // should be sent to the output.
+TEST(PacketResamplerCalculatorTest, EarlyOutputTolerance) {
+  // Without a tolerance, the packet closest to 33333 is sent.
+  {
+    SimpleRunner runner(
+        "[mediapipe.PacketResamplerCalculatorOptions.ext]: "
+        "{frame_rate:30}");
+    runner.SetInput({0, 30000, 33000, 66000});
+    MP_ASSERT_OK(runner.Run());
+    runner.CheckOutputTimestamps({0, 33000, 66000}, {0, 33333, 66667});
+  }
+
+  // With a tolerance, the first packet within 5000 of 33333 is sent at once.
+  {
+    SimpleRunner runner(
+        "[mediapipe.PacketResamplerCalculatorOptions.ext]: "
+        "{frame_rate:30 early_output_tolerance:5000}");
+    runner.SetInput({0, 30000, 33000, 66000});
+    MP_ASSERT_OK(runner.Run());
+    runner.CheckOutputTimestamps({0, 30000, 66000}, {0, 33333, 66667});
+  }
+}
+
 TEST(PacketResamplerCalculatorTest, MultiplePacketsForPeriods) {
   SimpleRunner runner(
       "[mediapipe.PacketResamplerCalculatorOptions.ext]: "
@@ -18,6 +18,7 @@
 
 #include "mediapipe/framework/formats/classification.pb.h"
 #include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/flat_landmarks.h"
 #include "mediapipe/framework/formats/image.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/formats/matrix.h"
@@ -56,6 +57,10 @@ typedef SplitVectorCalculator<mediapipe::NormalizedLandmark, false>
     SplitLandmarkVectorCalculator;
 REGISTER_CALCULATOR(SplitLandmarkVectorCalculator);
 
+typedef SplitVectorCalculator<mediapipe::FlatLandmark, false>
+    SplitFlatLandmarkVectorCalculator;
+REGISTER_CALCULATOR(SplitFlatLandmarkVectorCalculator);
+
 typedef SplitVectorCalculator<mediapipe::NormalizedLandmarkList, false>
     SplitNormalizedLandmarkListVectorCalculator;
 REGISTER_CALCULATOR(SplitNormalizedLandmarkListVectorCalculator);
@@ -53,6 +53,9 @@ using IsNotMovable =
 // be of type std::vector<T>. If the option "combine_outputs" is set to true,
 // only one output stream can be specified and all ranges of elements will be
 // combined into one vector.
+// When the ranges don't overlap and the calculator is the sole owner of the
+// input packet, the elements are moved into the outputs instead of copied, even
+// for copyable element types.
 // To use this class for a particular type T, register a calculator using
 // SplitVectorCalculator<T>.
 template <typename T, bool move_elements>
@@ -121,6 +124,7 @@ class SplitVectorCalculator : public CalculatorBase {
       max_range_end_ = std::max(max_range_end_, range.end());
       total_elements_ += range.end() - range.begin();
     }
+    ranges_overlap_ = !checkRangesDontOverlap(options).ok();
 
     return absl::OkStatus();
   }
@@ -139,6 +143,14 @@ class SplitVectorCalculator : public CalculatorBase {
   absl::Status ProcessCopyableElements(CalculatorContext* cc) {
     // static_assert(std::is_copy_constructible<U>::value,
     //              "Cannot copy non-copyable elements");
+    if (!ranges_overlap_) {
+      // Avoid copying the elements if the input vector can be consumed.
+      absl::StatusOr<std::unique_ptr<std::vector<U>>> input_status =
+          cc->Inputs().Index(0).Value().Consume<std::vector<U>>();
+      if (input_status.ok()) {
+        return EmitMovedRanges(std::move(input_status).value(), cc);
+      }
+    }
     const auto& input = cc->Inputs().Index(0).Get<std::vector<U>>();
     RET_CHECK_GE(input.size(), max_range_end_);
     if (combine_outputs_) {
@@ -180,8 +192,20 @@ class SplitVectorCalculator : public CalculatorBase {
     absl::StatusOr<std::unique_ptr<std::vector<U>>> input_status =
         cc->Inputs().Index(0).Value().Consume<std::vector<U>>();
     if (!input_status.ok()) return input_status.status();
-    std::unique_ptr<std::vector<U>> input_vector =
-        std::move(input_status).value();
+    return EmitMovedRanges(std::move(input_status).value(), cc);
+  }
+
+  template <typename U, IsNotMovable<U> = true>
+  absl::Status ProcessMovableElements(CalculatorContext* cc) {
+    return absl::InternalError("Cannot move non-movable elements.");
+  }
+
+ private:
+  // Moves the elements of the ranges of `input_vector` into the outputs. The
+  // ranges must not overlap.
+  template <typename U>
+  absl::Status EmitMovedRanges(std::unique_ptr<std::vector<U>> input_vector,
+                               CalculatorContext* cc) {
     RET_CHECK_GE(input_vector->size(), max_range_end_);
 
     if (combine_outputs_) {
@@ -217,12 +241,6 @@ class SplitVectorCalculator : public CalculatorBase {
     return absl::OkStatus();
   }
 
-  template <typename U, IsNotMovable<U> = true>
-  absl::Status ProcessMovableElements(CalculatorContext* cc) {
-    return absl::InternalError("Cannot move non-movable elements.");
-  }
-
- private:
   static absl::Status checkRangesDontOverlap(
       const ::mediapipe::SplitVectorCalculatorOptions& options) {
     for (int i = 0; i < options.ranges_size() - 1; ++i) {
@@ -247,6 +265,9 @@ class SplitVectorCalculator : public CalculatorBase {
   int32 total_elements_ = 0;
   bool element_only_ = false;
   bool combine_outputs_ = false;
+  // Whether an input element is emitted to several outputs, in which case the
+  // elements are copied.
+  bool ranges_overlap_ = false;
 };
 
 }  // namespace mediapipe
@@ -691,4 +691,80 @@ TEST_F(MovableSplitUniqueIntPtrCalculatorTest, SmokeTestCombiningOutputs) {
                                input_begin_indices, input_end_indices);
 }
 
+typedef SplitVectorCalculator<std::string, false> SplitStringVectorCalculator;
+REGISTER_CALCULATOR(SplitStringVectorCalculator);
+
+CalculatorGraphConfig SplitStringVectorGraphConfig() {
+  return mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        input_stream: "input_vector"
+        node {
+          calculator: "SplitStringVectorCalculator"
+          input_stream: "input_vector"
+          output_stream: "range_0"
+          output_stream: "range_1"
+          options {
+            [mediapipe.SplitVectorCalculatorOptions.ext] {
+              ranges: { begin: 0 end: 1 }
+              ranges: { begin: 1 end: 3 }
+            }
+          }
+        }
+      )pb");
+}
+
+TEST(SplitStringVectorCalculatorTest, SplitsUniquelyOwnedInput) {
+  CalculatorGraphConfig graph_config = SplitStringVectorGraphConfig();
+  std::vector<Packet> range_0_packets;
+  tool::AddVectorSink("range_0", &graph_config, &range_0_packets);
+  std::vector<Packet> range_1_packets;
+  tool::AddVectorSink("range_1", &graph_config, &range_1_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "input_vector",
+      MakePacket<std::vector<std::string>>(
+          std::vector<std::string>{"a", "b", "c", "d"})
+          .At(Timestamp(1))));
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  ASSERT_EQ(range_0_packets.size(), 1);
+  EXPECT_THAT(range_0_packets[0].Get<std::vector<std::string>>(),
+              testing::ElementsAre("a"));
+  ASSERT_EQ(range_1_packets.size(), 1);
+  EXPECT_THAT(range_1_packets[0].Get<std::vector<std::string>>(),
+              testing::ElementsAre("b", "c"));
+}
+
+TEST(SplitStringVectorCalculatorTest, LeavesSharedInputUnchanged) {
+  CalculatorGraphConfig graph_config = SplitStringVectorGraphConfig();
+  std::vector<Packet> range_0_packets;
+  tool::AddVectorSink("range_0", &graph_config, &range_0_packets);
+  std::vector<Packet> range_1_packets;
+  tool::AddVectorSink("range_1", &graph_config, &range_1_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  // The packet kept here prevents the calculator from consuming the input.
+  Packet input_packet = MakePacket<std::vector<std::string>>(
+                            std::vector<std::string>{"a", "b", "c", "d"})
+                            .At(Timestamp(1));
+  MP_ASSERT_OK(graph.AddPacketToInputStream("input_vector", input_packet));
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  EXPECT_THAT(input_packet.Get<std::vector<std::string>>(),
+              testing::ElementsAre("a", "b", "c", "d"));
+  ASSERT_EQ(range_0_packets.size(), 1);
+  EXPECT_THAT(range_0_packets[0].Get<std::vector<std::string>>(),
+              testing::ElementsAre("a"));
+  ASSERT_EQ(range_1_packets.size(), 1);
+  EXPECT_THAT(range_1_packets[0].Get<std::vector<std::string>>(),
+              testing::ElementsAre("b", "c"));
+}
+
 }  // namespace mediapipe
@@ -14,21 +14,28 @@
 
 #include "mediapipe/calculators/image/affine_transformation_runner_opencv.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "mediapipe/calculators/image/affine_transformation.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/threadpool.h"
 
 namespace mediapipe {
 
 namespace {
 
+// The fewest output rows warped by a task, so that small outputs are not
+// split into tasks that cost more to schedule than to run.
+constexpr int kMinRowsPerBand = 32;
+
 cv::BorderTypes GetBorderModeForOpenCv(
     AffineTransformation::BorderMode border_mode) {
   switch (border_mode) {
@@ -52,8 +59,17 @@ int GetInterpolationForOpenCv(
 class OpenCvRunner
     : public AffineTransformation::Runner<ImageFrame, ImageFrame> {
  public:
-  OpenCvRunner(AffineTransformation::Interpolation interpolation)
-      : interpolation_(GetInterpolationForOpenCv(interpolation)) {}
+  OpenCvRunner(AffineTransformation::Interpolation interpolation,
+               int num_threads)
+      : interpolation_(GetInterpolationForOpenCv(interpolation)),
+        num_threads_(std::max(num_threads, 1)) {
+    if (num_threads_ > 1) {
+      // The calling thread warps a band too.
+      thread_pool_ = absl::make_unique<ThreadPool>("warp_affine_opencv",
+                                                   num_threads_ - 1);
+      thread_pool_->StartWorkers();
+    }
+  }
 
   absl::StatusOr<ImageFrame> Run(
       const ImageFrame& input, const std::array<float, 16>& matrix,
@@ -153,16 +169,54 @@ class OpenCvRunner
     ImageFrame out_image(input.Format(), size.width, size.height);
     cv::Mat out_mat = formats::MatView(&out_image);
 
-    cv::warpAffine(in_mat, out_mat, cv_affine_transform,
-                   cv::Size(out_mat.cols, out_mat.rows),
-                   /*flags=*/interpolation_ | cv::WARP_INVERSE_MAP,
-                   GetBorderModeForOpenCv(border_mode));
+    const int num_bands =
+        std::min(num_threads_, std::max(out_mat.rows / kMinRowsPerBand, 1));
+    if (num_bands == 1) {
+      WarpRows(in_mat, cv_affine_transform, border_mode, 0, out_mat.rows,
+               out_mat);
+      return out_image;
+    }
+
+    // Each output pixel depends only on the input, so bands of output rows
+    // are warped independently.
+    absl::BlockingCounter counter(num_bands - 1);
+    auto warp_band = [&, num_bands](int band) {
+      WarpRows(in_mat, cv_affine_transform, border_mode,
+               out_mat.rows * band / num_bands,
+               out_mat.rows * (band + 1) / num_bands, out_mat);
+    };
+    for (int band = 1; band < num_bands; ++band) {
+      thread_pool_->Schedule([&warp_band, &counter, band] {
+        warp_band(band);
+        counter.DecrementCount();
+      });
+    }
+    warp_band(0);
+    counter.Wait();
 
     return out_image;
   }
 
  private:
+  // Warps output rows [begin, end), where 'transform' maps output to input
+  // coordinates.
+  void WarpRows(const cv::Mat& in_mat, const cv::Mat& transform,
+                AffineTransformation::BorderMode border_mode, int begin,
+                int end, cv::Mat& out_mat) {
+    // Offsets the transform so that row 0 of the band maps like row 'begin'.
+    cv::Mat band_transform = transform.clone();
+    band_transform.at<float>(0, 2) += transform.at<float>(0, 1) * begin;
+    band_transform.at<float>(1, 2) += transform.at<float>(1, 1) * begin;
+    cv::Mat band_mat = out_mat.rowRange(begin, end);
+    cv::warpAffine(in_mat, band_mat, band_transform,
+                   cv::Size(band_mat.cols, band_mat.rows),
+                   /*flags=*/interpolation_ | cv::WARP_INVERSE_MAP,
+                   GetBorderModeForOpenCv(border_mode));
+  }
+
   int interpolation_ = cv::INTER_LINEAR;
+  int num_threads_ = 1;
+  std::unique_ptr<ThreadPool> thread_pool_;
 };
 
 }  // namespace
@@ -170,8 +224,8 @@ class OpenCvRunner
 absl::StatusOr<
     std::unique_ptr<AffineTransformation::Runner<ImageFrame, ImageFrame>>>
 CreateAffineTransformationOpenCvRunner(
-    AffineTransformation::Interpolation interpolation) {
-  return absl::make_unique<OpenCvRunner>(interpolation);
+    AffineTransformation::Interpolation interpolation, int num_threads) {
+  return absl::make_unique<OpenCvRunner>(interpolation, num_threads);
 }
 
 }  // namespace mediapipe
@@ -23,10 +23,13 @@
 
 namespace mediapipe {
 
+// Creates a runner that warps with cv::warpAffine. When num_threads > 1, large
+// outputs are split into bands of rows that are warped in parallel on a thread
+// pool owned by the runner, independently of OpenCV's own threading.
 absl::StatusOr<
     std::unique_ptr<AffineTransformation::Runner<ImageFrame, ImageFrame>>>
 CreateAffineTransformationOpenCvRunner(
-    AffineTransformation::Interpolation interpolation);
+    AffineTransformation::Interpolation interpolation, int num_threads = 1);
 
 }  // namespace mediapipe
 
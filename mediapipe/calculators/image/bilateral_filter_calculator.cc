@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_replace.h"
@@ -47,10 +50,67 @@ constexpr char kInputGuideTagGpu[] = "GUIDE_GPU";
 constexpr char kOutputFrameTagGpu[] = "IMAGE_GPU";
 
 enum { ATTRIB_VERTEX, ATTRIB_TEXTURE_POSITION, NUM_ATTRIBUTES };
+
+// Returns the scale that maps pixel values of the depth to [0, 1].
+double NormalizationScale(int depth) {
+  switch (depth) {
+    case CV_8U:
+      return 1.0 / 255.0;
+    case CV_16U:
+      return 1.0 / 65535.0;
+    default:
+      return 1.0;
+  }
+}
+
+// Returns the luminance of an image as floats in [0, 1].
+cv::Mat GrayFloatMat(const cv::Mat& mat) {
+  cv::Mat gray = mat;
+  if (mat.channels() == 3) {
+    cv::cvtColor(mat, gray, cv::COLOR_RGB2GRAY);
+  } else if (mat.channels() == 4) {
+    cv::cvtColor(mat, gray, cv::COLOR_RGBA2GRAY);
+  }
+  cv::Mat result;
+  gray.convertTo(result, CV_32F, NormalizationScale(mat.depth()));
+  return result;
+}
+
+// Applies the guided filter of He et al., "Guided Image Filtering", to each
+// channel of 'input' using the single channel 'guide'. Both are float images
+// of the same size. Every step is either a box filter, which OpenCV computes
+// with running sums, or a per-pixel operation, so the cost per pixel does not
+// depend on the radius.
+cv::Mat GuidedFilter(const cv::Mat& guide, const cv::Mat& input, int radius,
+                     float epsilon) {
+  const cv::Size window(2 * radius + 1, 2 * radius + 1);
+  auto box = [&window](const cv::Mat& mat) {
+    cv::Mat result;
+    cv::boxFilter(mat, result, CV_32F, window);
+    return result;
+  };
+  const cv::Mat mean_guide = box(guide);
+  const cv::Mat var_guide =
+      box(guide.mul(guide)) - mean_guide.mul(mean_guide) + epsilon;
+
+  std::vector<cv::Mat> channels;
+  cv::split(input, channels);
+  for (cv::Mat& channel : channels) {
+    const cv::Mat mean_input = box(channel);
+    const cv::Mat cov_guide_input =
+        box(guide.mul(channel)) - mean_guide.mul(mean_input);
+    const cv::Mat a = cov_guide_input / var_guide;
+    const cv::Mat b = mean_input - a.mul(mean_guide);
+    channel = box(a).mul(guide) + box(b);
+  }
+  cv::Mat output;
+  cv::merge(channels, output);
+  return output;
+}
 }  // namespace
 
 // A calculator for applying a bilateral filter to an image,
-// with an optional guide image (joint blateral).
+// with an optional guide image (joint blateral), or a guided filter.
 //
 // Inputs:
 //   One of the following two IMAGE tags:
@@ -69,6 +129,9 @@ enum { ATTRIB_VERTEX, ATTRIB_TEXTURE_POSITION, NUM_ATTRIBUTES };
 //   sigma_space: Pixel radius: use (sigma_space*2+1)x(sigma_space*2+1) window.
 //                This should be set based on output image pixel space.
 //   sigma_color: Color variance: normalized [0-1] color difference allowed.
+//   filter_type: BILATERAL (default) or GUIDED. The guided filter costs O(1)
+//                per pixel on CPU, regardless of sigma_space, and is meant
+//                for refining masks along the edges of a guide image.
 //
 // Notes:
 //   * When GUIDE is present, the output image is same size as GUIDE image;
@@ -77,6 +140,10 @@ enum { ATTRIB_VERTEX, ATTRIB_TEXTURE_POSITION, NUM_ATTRIBUTES };
 //     i.e. the step size is ~sqrt(sigma_space),
 //     prioritizing performance > quality.
 //   * TODO: Add CPU path for joint filter.
+//   * The guided filter uses the luminance of GUIDE (or of IMAGE, when there
+//     is no guide) as the guide. IMAGE is resized to the size of GUIDE.
+//   * On GPU the guided filter only filters the red channel of IMAGE_GPU,
+//     which holds the mask, and outputs it in the RGB channels.
 //
 class BilateralFilterCalculator : public CalculatorBase {
  public:
@@ -93,8 +160,11 @@ class BilateralFilterCalculator : public CalculatorBase {
  private:
   absl::Status RenderGpu(CalculatorContext* cc);
   absl::Status RenderCpu(CalculatorContext* cc);
+  absl::Status RenderGuidedGpu(CalculatorContext* cc);
+  absl::Status RenderGuidedCpu(CalculatorContext* cc);
 
   absl::Status GlSetup(CalculatorContext* cc);
+  absl::Status GlSetupGuided();
   void GlRender(CalculatorContext* cc);
 
   mediapipe::BilateralFilterCalculatorOptions options_;
@@ -108,7 +178,12 @@ class BilateralFilterCalculator : public CalculatorBase {
   GLuint program_ = 0;
   GLuint vao_;
   GLuint vbo_[2];  // vertex storage
-#endif             // !MEDIAPIPE_DISABLE_GPU
+  // Guided filter passes, see GlSetupGuided().
+  GLuint box_statistics_program_ = 0;
+  GLuint box_coefficients_program_ = 0;
+  GLuint box_vertical_program_ = 0;
+  GLuint guided_output_program_ = 0;
+#endif  // !MEDIAPIPE_DISABLE_GPU
 };
 REGISTER_CALCULATOR(BilateralFilterCalculator);
 
@@ -220,6 +295,12 @@ absl::Status BilateralFilterCalculator::Close(CalculatorContext* cc) {
 #if !MEDIAPIPE_DISABLE_GPU
   gpu_helper_.RunInGlContext([this] {
     if (program_) glDeleteProgram(program_);
+    for (GLuint* program :
+         {&box_statistics_program_, &box_coefficients_program_,
+          &box_vertical_program_, &guided_output_program_}) {
+      if (*program) glDeleteProgram(*program);
+      *program = 0;
+    }
     if (vao_) glDeleteVertexArrays(1, &vao_);
     if (vbo_[0]) glDeleteBuffers(2, vbo_);
     program_ = 0;
@@ -236,6 +317,9 @@ absl::Status BilateralFilterCalculator::RenderCpu(CalculatorContext* cc) {
   if (cc->Inputs().Tag(kInputFrameTag).IsEmpty()) {
     return absl::OkStatus();
   }
+  if (options_.filter_type() == BilateralFilterCalculatorOptions::GUIDED) {
+    return RenderGuidedCpu(cc);
+  }
 
   const auto& input_frame = cc->Inputs().Tag(kInputFrameTag).Get<ImageFrame>();
   auto input_mat = mediapipe::formats::MatView(&input_frame);
@@ -268,11 +352,50 @@ absl::Status BilateralFilterCalculator::RenderCpu(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+absl::Status BilateralFilterCalculator::RenderGuidedCpu(CalculatorContext* cc) {
+  const auto& input_frame = cc->Inputs().Tag(kInputFrameTag).Get<ImageFrame>();
+  const cv::Mat input_mat = mediapipe::formats::MatView(&input_frame);
+
+  const bool has_guide_image = cc->Inputs().HasTag(kInputGuideTag);
+  if (has_guide_image && cc->Inputs().Tag(kInputGuideTag).IsEmpty()) {
+    return absl::OkStatus();
+  }
+  const cv::Mat guide =
+      has_guide_image
+          ? GrayFloatMat(mediapipe::formats::MatView(
+                &cc->Inputs().Tag(kInputGuideTag).Get<ImageFrame>()))
+          : GrayFloatMat(input_mat);
+
+  const double scale = NormalizationScale(input_mat.depth());
+  cv::Mat input;
+  input_mat.convertTo(input, CV_32F, scale);
+  if (input.size() != guide.size()) {
+    cv::resize(input, input, guide.size(), 0, 0, cv::INTER_LINEAR);
+  }
+
+  const int radius = std::max(1, static_cast<int>(std::round(sigma_space_)));
+  const float epsilon = options_.sigma_color() * options_.sigma_color();
+  const cv::Mat filtered = GuidedFilter(guide, input, radius, epsilon);
+
+  auto output_frame = absl::make_unique<ImageFrame>(
+      input_frame.Format(), guide.cols, guide.rows);
+  cv::Mat output_mat = mediapipe::formats::MatView(output_frame.get());
+  filtered.convertTo(output_mat, output_mat.type(), 1.0 / scale);
+
+  cc->Outputs()
+      .Tag(kOutputFrameTag)
+      .Add(output_frame.release(), cc->InputTimestamp());
+  return absl::OkStatus();
+}
+
 absl::Status BilateralFilterCalculator::RenderGpu(CalculatorContext* cc) {
   if (cc->Inputs().Tag(kInputFrameTagGpu).IsEmpty()) {
     return absl::OkStatus();
   }
 #if !MEDIAPIPE_DISABLE_GPU
+  if (options_.filter_type() == BilateralFilterCalculatorOptions::GUIDED) {
+    return RenderGuidedGpu(cc);
+  }
   const auto& input_frame =
       cc->Inputs().Tag(kInputFrameTagGpu).Get<mediapipe::GpuBuffer>();
   auto input_texture = gpu_helper_.CreateSourceTexture(input_frame);
@@ -333,6 +456,79 @@ absl::Status BilateralFilterCalculator::RenderGpu(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+absl::Status BilateralFilterCalculator::RenderGuidedGpu(CalculatorContext* cc) {
+#if !MEDIAPIPE_DISABLE_GPU
+  const bool has_guide_image = cc->Inputs().HasTag(kInputGuideTagGpu);
+  if (has_guide_image && cc->Inputs().Tag(kInputGuideTagGpu).IsEmpty()) {
+    return absl::OkStatus();
+  }
+  const auto& input_frame =
+      cc->Inputs().Tag(kInputFrameTagGpu).Get<mediapipe::GpuBuffer>();
+  const auto& guide_frame =
+      has_guide_image
+          ? cc->Inputs().Tag(kInputGuideTagGpu).Get<mediapipe::GpuBuffer>()
+          : input_frame;
+  auto input_texture = gpu_helper_.CreateSourceTexture(input_frame);
+  auto guide_texture = gpu_helper_.CreateSourceTexture(guide_frame);
+  const int width = guide_frame.width();
+  const int height = guide_frame.height();
+
+  // Renders one pass of the filter from the textures bound to units 1 and 2.
+  auto render_pass = [&](GLuint program, GLuint texture1, GLuint texture2,
+                         mediapipe::GpuBufferFormat format) {
+    auto output = gpu_helper_.CreateDestinationTexture(width, height, format);
+    gpu_helper_.BindFramebuffer(output);
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "texel_size"), 1.0 / width,
+                1.0 / height);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, texture1);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, texture2);
+    GlRender(cc);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return output;
+  };
+
+  // The box filters are separable, hence a horizontal and a vertical pass
+  // for the means of the statistics and for the means of the coefficients.
+  // Intermediate results are kept in half floats.
+  constexpr auto kIntermediateFormat = mediapipe::GpuBufferFormat::kRGBAHalf64;
+  auto statistics_h =
+      render_pass(box_statistics_program_, input_texture.name(),
+                  guide_texture.name(), kIntermediateFormat);
+  auto statistics = render_pass(box_vertical_program_, statistics_h.name(), 0,
+                                kIntermediateFormat);
+  statistics_h.Release();
+  auto coefficients_h = render_pass(box_coefficients_program_,
+                                    statistics.name(), 0, kIntermediateFormat);
+  statistics.Release();
+  auto coefficients = render_pass(box_vertical_program_, coefficients_h.name(),
+                                  0, kIntermediateFormat);
+  coefficients_h.Release();
+  auto output_texture =
+      render_pass(guided_output_program_, coefficients.name(),
+                  guide_texture.name(), mediapipe::GpuBufferFormat::kBGRA32);
+  coefficients.Release();
+  glFlush();
+
+  // Send out image as GPU packet.
+  auto output_frame = output_texture.GetFrame<mediapipe::GpuBuffer>();
+  cc->Outputs()
+      .Tag(kOutputFrameTagGpu)
+      .Add(output_frame.release(), cc->InputTimestamp());
+
+  // Cleanup
+  input_texture.Release();
+  guide_texture.Release();
+  output_texture.Release();
+#endif  // !MEDIAPIPE_DISABLE_GPU
+
+  return absl::OkStatus();
+}
+
 void BilateralFilterCalculator::GlRender(CalculatorContext* cc) {
 #if !MEDIAPIPE_DISABLE_GPU
   // bring back vao and vbo
@@ -471,7 +667,9 @@ absl::Status BilateralFilterCalculator::GlSetup(CalculatorContext* cc) {
   // Only initialize the one shader to be used.
   const bool has_guide_image = cc->Inputs().HasTag(kInputGuideTagGpu);
 
-  if (has_guide_image) {
+  if (options_.filter_type() == BilateralFilterCalculatorOptions::GUIDED) {
+    MP_RETURN_IF_ERROR(GlSetupGuided());
+  } else if (has_guide_image) {
     // Create joint shader program and set parameters.
     mediapipe::GlhCreateProgram(
         mediapipe::kBasicVertexShader, joint_frag_src.c_str(), NUM_ATTRIBUTES,
@@ -516,4 +714,111 @@ absl::Status BilateralFilterCalculator::GlSetup(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+absl::Status BilateralFilterCalculator::GlSetupGuided() {
+#if !MEDIAPIPE_DISABLE_GPU
+  const GLint attr_location[NUM_ATTRIBUTES] = {
+      ATTRIB_VERTEX,
+      ATTRIB_TEXTURE_POSITION,
+  };
+  const GLchar* attr_name[NUM_ATTRIBUTES] = {
+      "position",
+      "texture_coordinate",
+  };
+
+  // Each pass samples 'input_frame' (and 'guide_frame') at texture units 1
+  // (and 2), and box filters along one axis over 2 * kRadius + 1 texels.
+  const std::string common_string = absl::StrReplaceAll(
+      R"(
+    DEFAULT_PRECISION(highp, float)
+
+    in vec2 sample_coordinate;
+    uniform sampler2D input_frame;
+    uniform sampler2D guide_frame;
+    uniform vec2 texel_size;
+
+    const int kRadius = $radius;
+    const float kWeight = 1.0 / float(2 * kRadius + 1);
+    const float kEpsilon = $epsilon;
+
+    float luminance(vec3 color) {
+      return dot(color, vec3(0.299, 0.587, 0.114));
+    }
+  )",
+      {{"$radius", std::to_string(std::max(
+                       1, static_cast<int>(std::round(sigma_space_))))},
+       {"$epsilon", std::to_string(sigma_color_ * sigma_color_)}});
+
+  // Horizontal box filter of the statistics (p, I, I * p, I * I) of the mask
+  // p, taken from the red channel of the input, and the guide luminance I.
+  const std::string statistics_src = R"(
+    void main() {
+      vec4 sum = vec4(0.0);
+      for (int i = -kRadius; i <= kRadius; ++i) {
+        vec2 uv = sample_coordinate + vec2(float(i) * texel_size.x, 0.0);
+        float p = texture2D(input_frame, uv).r;
+        float g = luminance(texture2D(guide_frame, uv).rgb);
+        sum += vec4(p, g, g * p, g * g);
+      }
+      gl_FragColor = sum * kWeight;
+    }
+  )";
+
+  // Horizontal box filter of the linear coefficients (a, b), computed from
+  // the means of the statistics.
+  const std::string coefficients_src = R"(
+    void main() {
+      vec4 sum = vec4(0.0);
+      for (int i = -kRadius; i <= kRadius; ++i) {
+        vec2 uv = sample_coordinate + vec2(float(i) * texel_size.x, 0.0);
+        vec4 mean = texture2D(input_frame, uv);
+        float a = (mean.z - mean.y * mean.x) /
+                  (mean.w - mean.y * mean.y + kEpsilon);
+        sum.xy += vec2(a, mean.x - a * mean.y);
+      }
+      gl_FragColor = sum * kWeight;
+    }
+  )";
+
+  // Vertical box filter, completing either of the above.
+  const std::string vertical_src = R"(
+    void main() {
+      vec4 sum = vec4(0.0);
+      for (int i = -kRadius; i <= kRadius; ++i) {
+        vec2 uv = sample_coordinate + vec2(0.0, float(i) * texel_size.y);
+        sum += texture2D(input_frame, uv);
+      }
+      gl_FragColor = sum * kWeight;
+    }
+  )";
+
+  // Applies the mean coefficients to the guide luminance.
+  const std::string output_src = R"(
+    void main() {
+      vec2 coefficients = texture2D(input_frame, sample_coordinate).xy;
+      float g = luminance(texture2D(guide_frame, sample_coordinate).rgb);
+      gl_FragColor = vec4(vec3(coefficients.x * g + coefficients.y), 1.0);
+    }
+  )";
+
+  for (auto [program, body] :
+       {std::make_pair(&box_statistics_program_, &statistics_src),
+        std::make_pair(&box_coefficients_program_, &coefficients_src),
+        std::make_pair(&box_vertical_program_, &vertical_src),
+        std::make_pair(&guided_output_program_, &output_src)}) {
+    const std::string frag_src =
+        std::string(mediapipe::kMediaPipeFragmentShaderPreamble) +
+        common_string + *body;
+    mediapipe::GlhCreateProgram(mediapipe::kBasicVertexShader, frag_src.c_str(),
+                                NUM_ATTRIBUTES, attr_name, attr_location,
+                                program);
+    RET_CHECK(*program) << "Problem initializing the program.";
+    glUseProgram(*program);
+    glUniform1i(glGetUniformLocation(*program, "input_frame"), 1);
+    glUniform1i(glGetUniformLocation(*program, "guide_frame"), 2);
+  }
+#endif  // !MEDIAPIPE_DISABLE_GPU
+
+  return absl::OkStatus();
+}
+
 }  // namespace mediapipe
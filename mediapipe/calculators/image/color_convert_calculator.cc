@@ -12,8 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+
 #include "absl/log/absl_check.h"
+#include "absl/memory/memory.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/cpu_image_multi_pool.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/port/integral_types.h"
@@ -87,6 +91,7 @@ class ColorConvertCalculator : public CalculatorBase {
 
   absl::Status Open(CalculatorContext* cc) override {
     cc->SetOffset(TimestampDiff(0));
+    image_pool_ = cc->Service(kCpuImageMultiPoolService);
     return absl::OkStatus();
   }
 
@@ -100,6 +105,8 @@ class ColorConvertCalculator : public CalculatorBase {
                                 ImageFormat::Format output_format,
                                 int open_cv_convert_code,
                                 CalculatorContext* cc);
+
+  ServiceBinding<CpuImageMultiPool> image_pool_;
 };
 
 REGISTER_CALCULATOR(ColorConvertCalculator);
@@ -146,6 +153,8 @@ absl::Status ColorConvertCalculator::GetContract(CalculatorContract* cc) {
     cc->Outputs().Tag(kBgraOutTag).Set<ImageFrame>();
   }
 
+  cc->UseService(kCpuImageMultiPoolService).Optional();
+
   return absl::OkStatus();
 }
 
@@ -155,8 +164,13 @@ absl::Status ColorConvertCalculator::ConvertAndOutput(
     CalculatorContext* cc) {
   const cv::Mat& input_mat =
       formats::MatView(&cc->Inputs().Tag(input_tag).Get<ImageFrame>());
-  std::unique_ptr<ImageFrame> output_frame(
-      new ImageFrame(output_format, input_mat.cols, input_mat.rows));
+  std::unique_ptr<ImageFrame> output_frame =
+      image_pool_.IsAvailable()
+          ? image_pool_.GetObject().GetImageFrame(output_format,
+                                                  input_mat.cols,
+                                                  input_mat.rows)
+          : absl::make_unique<ImageFrame>(output_format, input_mat.cols,
+                                          input_mat.rows);
   cv::Mat output_mat = formats::MatView(output_frame.get());
   cv::cvtColor(input_mat, output_mat, open_cv_convert_code);
 
@@ -0,0 +1,187 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "mediapipe/calculators/image/frame_change_gate_calculator.pb.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Passes its input packets through only when the IMAGE at the same timestamp
+// differs enough from the last image that was passed, so that the inference
+// downstream can be skipped for near-static frames. Skipped timestamps
+// advance the output timestamp bounds, so that a PacketClonerCalculator
+// ticked by IMAGE can re-emit the previous inference results for them.
+//
+// Images are compared on a downsampled grayscale grid against the last passed
+// image rather than the previous one, so that slow changes still add up. At
+// most max_skip_count consecutive frames are skipped. Images that are only on
+// the GPU, or that do not have 8-bit channels, always pass, since reading
+// them would cost more than the skipped inference saves.
+//
+// Inputs:
+//   IMAGE: An Image or ImageFrame to compare.
+//   Any number of untagged streams to pass through.
+//
+// Input side packets:
+//   MAX_SKIP_COUNT (optional): Overrides max_skip_count in the options.
+//
+// Outputs:
+//   The untagged input packets of passed frames.
+//   CHANGED (optional): Whether each frame was passed.
+//
+// Example usage:
+// node {
+//   calculator: "FrameChangeGateCalculator"
+//   input_stream: "IMAGE:image"
+//   input_stream: "input_tensors"
+//   output_stream: "gated_input_tensors"
+//   options {
+//     [mediapipe.FrameChangeGateCalculatorOptions.ext] { max_skip_count: 4 }
+//   }
+// }
+// node {
+//   calculator: "InferenceCalculator"
+//   input_stream: "TENSORS:gated_input_tensors"
+//   output_stream: "TENSORS:gated_output_tensors"
+// }
+// node {
+//   calculator: "PacketClonerCalculator"
+//   input_stream: "gated_output_tensors"
+//   input_stream: "TICK:image"
+//   output_stream: "output_tensors"
+// }
+class FrameChangeGateCalculator : public Node {
+ public:
+  static constexpr Input<OneOf<mediapipe::Image, mediapipe::ImageFrame>>
+      kImage{"IMAGE"};
+  static constexpr Input<AnyType>::Multiple kIn{""};
+  static constexpr SideInput<int>::Optional kMaxSkipCount{"MAX_SKIP_COUNT"};
+  static constexpr Output<SameType<kIn>>::Multiple kOut{""};
+  static constexpr Output<bool>::Optional kChanged{"CHANGED"};
+
+  MEDIAPIPE_NODE_CONTRACT(kImage, kIn, kMaxSkipCount, kOut, kChanged);
+
+  static absl::Status UpdateContract(CalculatorContract* cc) {
+    RET_CHECK_EQ(kIn(cc).Count(), kOut(cc).Count());
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    const auto& options = cc->Options<FrameChangeGateCalculatorOptions>();
+    change_threshold_ = options.change_threshold();
+    max_skip_count_ = kMaxSkipCount(cc).GetOr(options.max_skip_count());
+    grid_size_ = options.grid_size();
+    RET_CHECK_GE(max_skip_count_, 0);
+    RET_CHECK_GT(grid_size_, 0);
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    bool changed = true;
+    if (max_skip_count_ > 0 && !kImage(cc).IsEmpty()) {
+      changed = kImage(cc).Visit(
+          [this](const mediapipe::Image& image) {
+            if (image.UsesGpu()) return true;
+            return UpdateGrid(*image.GetImageFrameSharedPtr());
+          },
+          [this](const mediapipe::ImageFrame& frame) {
+            return UpdateGrid(frame);
+          });
+    }
+    if (changed) {
+      skip_count_ = 0;
+      for (int i = 0; i < kIn(cc).Count(); ++i) {
+        if (!kIn(cc)[i].IsEmpty()) {
+          kOut(cc)[i].Send(kIn(cc)[i].packet());
+        }
+      }
+    } else {
+      ++skip_count_;
+    }
+    if (kChanged(cc).IsConnected()) {
+      kChanged(cc).Send(changed);
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  // Downsamples the frame into grid_, and returns whether the frame should be
+  // passed. The grid of the last passed frame is kept for comparison.
+  bool UpdateGrid(const ImageFrame& frame) {
+    if (frame.ByteDepth() != 1 || frame.Width() < grid_size_ ||
+        frame.Height() < grid_size_) {
+      reference_.clear();
+      return true;
+    }
+    const int channels = std::min(frame.NumberOfChannels(), 3);
+    grid_.assign(grid_size_ * grid_size_, 0);
+    for (int gy = 0; gy < grid_size_; ++gy) {
+      const int y_begin = gy * frame.Height() / grid_size_;
+      const int y_end = (gy + 1) * frame.Height() / grid_size_;
+      for (int gx = 0; gx < grid_size_; ++gx) {
+        const int x_begin = gx * frame.Width() / grid_size_;
+        const int x_end = (gx + 1) * frame.Width() / grid_size_;
+        // Averages a sparse subset of each cell, which is enough to detect
+        // changes and keeps the cost independent of the frame size.
+        const int y_step = std::max(1, (y_end - y_begin) / 4);
+        const int x_step = std::max(1, (x_end - x_begin) / 4);
+        int sum = 0;
+        int count = 0;
+        for (int y = y_begin; y < y_end; y += y_step) {
+          const uint8_t* row = frame.PixelData() + y * frame.WidthStep();
+          for (int x = x_begin; x < x_end; x += x_step) {
+            const uint8_t* pixel = row + x * frame.NumberOfChannels();
+            for (int c = 0; c < channels; ++c) sum += pixel[c];
+            count += channels;
+          }
+        }
+        grid_[gy * grid_size_ + gx] = sum / count;
+      }
+    }
+
+    bool changed = true;
+    if (reference_.size() == grid_.size() && skip_count_ < max_skip_count_) {
+      int64_t difference = 0;
+      for (int i = 0; i < grid_.size(); ++i) {
+        difference += std::abs(grid_[i] - reference_[i]);
+      }
+      changed = difference >= change_threshold_ * grid_.size();
+    }
+    if (changed) reference_.swap(grid_);
+    return changed;
+  }
+
+  float change_threshold_ = 0;
+  int max_skip_count_ = 0;
+  int grid_size_ = 0;
+  int skip_count_ = 0;
+  std::vector<int> grid_;
+  std::vector<int> reference_;
+};
+
+MEDIAPIPE_REGISTER_NODE(FrameChangeGateCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
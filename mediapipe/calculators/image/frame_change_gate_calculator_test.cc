@@ -0,0 +1,127 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/sink.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Returns a gray frame with every pixel set to value.
+Packet MakeFrame(int value, Timestamp timestamp) {
+  auto frame = std::make_unique<ImageFrame>(ImageFormat::FORMAT_SRGB, 64, 48);
+  std::fill(frame->MutablePixelData(),
+            frame->MutablePixelData() + frame->PixelDataSize(), value);
+  return Adopt(frame.release()).At(timestamp);
+}
+
+class FrameChangeGateCalculatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+      input_stream: "image"
+      input_stream: "value"
+      input_side_packet: "max_skip_count"
+      node {
+        calculator: "FrameChangeGateCalculator"
+        input_stream: "IMAGE:image"
+        input_stream: "value"
+        input_side_packet: "MAX_SKIP_COUNT:max_skip_count"
+        output_stream: "gated_value"
+        output_stream: "CHANGED:changed"
+        options {
+          [mediapipe.FrameChangeGateCalculatorOptions.ext] {
+            change_threshold: 2
+          }
+        }
+      }
+      node {
+        calculator: "PacketClonerCalculator"
+        input_stream: "gated_value"
+        input_stream: "TICK:image"
+        output_stream: "value_out"
+      }
+    )pb");
+    tool::AddVectorSink("value_out", &config, &values_);
+    tool::AddVectorSink("changed", &config, &changed_);
+    MP_ASSERT_OK(graph_.Initialize(config));
+  }
+
+  // Sends frames with the given pixel values, and the frame index as value.
+  void Run(int max_skip_count, const std::vector<int>& pixel_values) {
+    MP_ASSERT_OK(graph_.StartRun(
+        {{"max_skip_count", MakePacket<int>(max_skip_count)}}));
+    for (int i = 0; i < pixel_values.size(); ++i) {
+      MP_ASSERT_OK(graph_.AddPacketToInputStream(
+          "image", MakeFrame(pixel_values[i], Timestamp(i))));
+      MP_ASSERT_OK(graph_.AddPacketToInputStream(
+          "value", MakePacket<int>(i).At(Timestamp(i))));
+    }
+    MP_ASSERT_OK(graph_.CloseAllInputStreams());
+    MP_ASSERT_OK(graph_.WaitUntilDone());
+  }
+
+  std::vector<int> Values() {
+    std::vector<int> result;
+    for (const Packet& packet : values_) result.push_back(packet.Get<int>());
+    return result;
+  }
+
+  std::vector<bool> Changed() {
+    std::vector<bool> result;
+    for (const Packet& packet : changed_) result.push_back(packet.Get<bool>());
+    return result;
+  }
+
+  CalculatorGraph graph_;
+  std::vector<Packet> values_;
+  std::vector<Packet> changed_;
+};
+
+TEST_F(FrameChangeGateCalculatorTest, ReusesResultsOfStaticFrames) {
+  Run(/*max_skip_count=*/2, {100, 101, 100, 101, 150, 150});
+  EXPECT_THAT(Changed(), ElementsAre(true, false, false, true, true, false));
+  EXPECT_THAT(Values(), ElementsAre(0, 0, 0, 3, 4, 4));
+  for (int i = 0; i < values_.size(); ++i) {
+    EXPECT_EQ(values_[i].Timestamp(), Timestamp(i));
+  }
+}
+
+TEST_F(FrameChangeGateCalculatorTest, ComparesWithLastPassedFrame) {
+  // Each frame differs by 1 from the previous one, but by 2 from the last
+  // passed frame every other frame.
+  Run(/*max_skip_count=*/10, {100, 101, 102, 103, 104});
+  EXPECT_THAT(Changed(), ElementsAre(true, false, true, false, true));
+  EXPECT_THAT(Values(), ElementsAre(0, 0, 2, 2, 4));
+}
+
+TEST_F(FrameChangeGateCalculatorTest, PassesAllFramesWhenDisabled) {
+  Run(/*max_skip_count=*/0, {100, 100, 100});
+  EXPECT_THAT(Changed(), ElementsAre(true, true, true));
+  EXPECT_THAT(Values(), ElementsAre(0, 1, 2));
+}
+
+}  // namespace
+}  // namespace mediapipe
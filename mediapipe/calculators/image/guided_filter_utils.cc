@@ -0,0 +1,173 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/image/guided_filter_utils.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace mediapipe {
+
+namespace {
+
+// Sums of the values of an image over rectangles, from an integral image.
+class BoxSums {
+ public:
+  BoxSums(int width, int height)
+      : width_(width), sums_((width + 1) * (height + 1), 0.0) {}
+
+  // Fills the integral image of f(x, y).
+  template <typename F>
+  void Compute(int height, F f) {
+    const int stride = width_ + 1;
+    for (int y = 0; y < height; ++y) {
+      double row_sum = 0.0;
+      for (int x = 0; x < width_; ++x) {
+        row_sum += f(x, y);
+        sums_[(y + 1) * stride + x + 1] = sums_[y * stride + x + 1] + row_sum;
+      }
+    }
+  }
+
+  // Returns the sum over columns [x0, x1) and rows [y0, y1).
+  double Sum(int x0, int y0, int x1, int y1) const {
+    const int stride = width_ + 1;
+    return sums_[y1 * stride + x1] - sums_[y0 * stride + x1] -
+           sums_[y1 * stride + x0] + sums_[y0 * stride + x0];
+  }
+
+ private:
+  int width_;
+  std::vector<double> sums_;
+};
+
+// Calls f(x0, y0, x1, y1, index) with the box around each pixel.
+template <typename F>
+void ForEachBox(int width, int height, int radius, F f) {
+  for (int y = 0; y < height; ++y) {
+    const int y0 = std::max(y - radius, 0);
+    const int y1 = std::min(y + radius + 1, height);
+    for (int x = 0; x < width; ++x) {
+      const int x0 = std::max(x - radius, 0);
+      const int x1 = std::min(x + radius + 1, width);
+      f(x0, y0, x1, y1, y * width + x);
+    }
+  }
+}
+
+// The source pixels and weight for each bilinearly resampled pixel, with
+// pixel centers aligned.
+struct Sample {
+  int index0;
+  int index1;
+  float weight1;
+};
+
+std::vector<Sample> GetSamples(int size, int source_size) {
+  std::vector<Sample> samples(size);
+  const float scale = static_cast<float>(source_size) / size;
+  for (int i = 0; i < size; ++i) {
+    const float position = std::clamp((i + 0.5f) * scale - 0.5f, 0.0f,
+                                      static_cast<float>(source_size - 1));
+    const int index0 = static_cast<int>(position);
+    samples[i] = {index0, std::min(index0 + 1, source_size - 1),
+                  position - index0};
+  }
+  return samples;
+}
+
+}  // namespace
+
+void ComputeGuidedFilterCoefficients(const float* guide, const float* mask,
+                                     int width, int height, int radius,
+                                     float epsilon, float* a, float* b) {
+  BoxSums guide_sums(width, height);
+  BoxSums mask_sums(width, height);
+  BoxSums guide_mask_sums(width, height);
+  BoxSums guide_guide_sums(width, height);
+  guide_sums.Compute(height,
+                     [&](int x, int y) { return guide[y * width + x]; });
+  mask_sums.Compute(height, [&](int x, int y) { return mask[y * width + x]; });
+  guide_mask_sums.Compute(height, [&](int x, int y) {
+    return guide[y * width + x] * mask[y * width + x];
+  });
+  guide_guide_sums.Compute(height, [&](int x, int y) {
+    return guide[y * width + x] * guide[y * width + x];
+  });
+
+  ForEachBox(width, height, radius,
+             [&](int x0, int y0, int x1, int y1, int index) {
+               const double n = (x1 - x0) * (y1 - y0);
+               const double mean_guide = guide_sums.Sum(x0, y0, x1, y1) / n;
+               const double mean_mask = mask_sums.Sum(x0, y0, x1, y1) / n;
+               const double covariance =
+                   guide_mask_sums.Sum(x0, y0, x1, y1) / n -
+                   mean_guide * mean_mask;
+               const double variance =
+                   guide_guide_sums.Sum(x0, y0, x1, y1) / n -
+                   mean_guide * mean_guide;
+               a[index] = covariance / (variance + epsilon);
+               b[index] = mean_mask - a[index] * mean_guide;
+             });
+
+  // Averages the coefficients of all boxes covering each pixel.
+  BoxSums a_sums(width, height);
+  BoxSums b_sums(width, height);
+  a_sums.Compute(height, [&](int x, int y) { return a[y * width + x]; });
+  b_sums.Compute(height, [&](int x, int y) { return b[y * width + x]; });
+  ForEachBox(width, height, radius,
+             [&](int x0, int y0, int x1, int y1, int index) {
+               const double n = (x1 - x0) * (y1 - y0);
+               a[index] = a_sums.Sum(x0, y0, x1, y1) / n;
+               b[index] = b_sums.Sum(x0, y0, x1, y1) / n;
+             });
+}
+
+void ApplyGuidedFilterCoefficients(const float* a, const float* b, int width,
+                                   int height, const float* guide,
+                                   int guide_width, int guide_height,
+                                   int guide_stride, float* output,
+                                   int output_stride) {
+  const std::vector<Sample> columns = GetSamples(guide_width, width);
+  const std::vector<Sample> rows = GetSamples(guide_height, height);
+  std::vector<float> a_row(width);
+  std::vector<float> b_row(width);
+  for (int y = 0; y < guide_height; ++y) {
+    // Interpolates the coefficient rows first, then each column.
+    const Sample& row = rows[y];
+    const float* a0 = a + row.index0 * width;
+    const float* a1 = a + row.index1 * width;
+    const float* b0 = b + row.index0 * width;
+    const float* b1 = b + row.index1 * width;
+    for (int x = 0; x < width; ++x) {
+      a_row[x] = a0[x] + (a1[x] - a0[x]) * row.weight1;
+      b_row[x] = b0[x] + (b1[x] - b0[x]) * row.weight1;
+    }
+    const float* guide_row = guide + y * guide_stride;
+    float* output_row = output + y * output_stride;
+    for (int x = 0; x < guide_width; ++x) {
+      const Sample& column = columns[x];
+      const float a_value =
+          a_row[column.index0] +
+          (a_row[column.index1] - a_row[column.index0]) * column.weight1;
+      const float b_value =
+          b_row[column.index0] +
+          (b_row[column.index1] - b_row[column.index0]) * column.weight1;
+      output_row[x] =
+          std::clamp(a_value * guide_row[x] + b_value, 0.0f, 1.0f);
+    }
+  }
+}
+
+}  // namespace mediapipe
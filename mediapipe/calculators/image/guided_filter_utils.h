@@ -0,0 +1,46 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_IMAGE_GUIDED_FILTER_UTILS_H_
+#define MEDIAPIPE_CALCULATORS_IMAGE_GUIDED_FILTER_UTILS_H_
+
+namespace mediapipe {
+
+// Computes the coefficients of a guided filter, which locally approximates
+// `mask` as a * guide + b over boxes of (2 * radius + 1)^2 pixels. Boxes are
+// cropped at the image borders. `epsilon` regularizes a in boxes where the
+// guide is nearly flat. The coefficients are averaged over the same boxes.
+//
+// guide, mask, a and b are width x height images with contiguous rows.
+void ComputeGuidedFilterCoefficients(const float* guide, const float* mask,
+                                     int width, int height, int radius,
+                                     float epsilon, float* a, float* b);
+
+// Writes a * guide + b, clamped to [0, 1], for each pixel of a full
+// resolution guide, where a and b are width x height coefficients from
+// ComputeGuidedFilterCoefficients that are bilinearly upsampled to the guide
+// size. This is the upsampling step of the fast guided filter: edges of the
+// output follow the edges of the full resolution guide rather than those of
+// the upsampled coefficients.
+//
+// Strides are in floats.
+void ApplyGuidedFilterCoefficients(const float* a, const float* b, int width,
+                                   int height, const float* guide,
+                                   int guide_width, int guide_height,
+                                   int guide_stride, float* output,
+                                   int output_stride);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_IMAGE_GUIDED_FILTER_UTILS_H_
@@ -0,0 +1,116 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/image/guided_filter_utils.h"
+
+#include <vector>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe {
+namespace {
+
+// Runs the fast guided filter on a mask of width x height pixels with a guide
+// that is `scale` times larger, downsampling the guide by area.
+std::vector<float> GuidedUpsample(const std::vector<float>& guide,
+                                  const std::vector<float>& mask, int width,
+                                  int height, int scale, int radius,
+                                  float epsilon) {
+  const int guide_width = width * scale;
+  std::vector<float> small_guide(width * height, 0.0f);
+  for (int y = 0; y < height * scale; ++y) {
+    for (int x = 0; x < guide_width; ++x) {
+      small_guide[(y / scale) * width + x / scale] +=
+          guide[y * guide_width + x] / (scale * scale);
+    }
+  }
+  std::vector<float> a(width * height);
+  std::vector<float> b(width * height);
+  ComputeGuidedFilterCoefficients(small_guide.data(), mask.data(), width,
+                                  height, radius, epsilon, a.data(), b.data());
+  std::vector<float> output(guide.size());
+  ApplyGuidedFilterCoefficients(a.data(), b.data(), width, height,
+                                guide.data(), guide_width, height * scale,
+                                guide_width, output.data(), guide_width);
+  return output;
+}
+
+TEST(GuidedFilterUtilsTest, ConstantMaskStaysConstant) {
+  constexpr int kWidth = 6, kHeight = 5, kScale = 3;
+  std::vector<float> guide(kWidth * kHeight * kScale * kScale);
+  for (int i = 0; i < guide.size(); ++i) {
+    guide[i] = (i * 37 % 11) / 10.0f;
+  }
+  const std::vector<float> mask(kWidth * kHeight, 0.25f);
+  for (float value : GuidedUpsample(guide, mask, kWidth, kHeight, kScale,
+                                    /*radius=*/2, /*epsilon=*/1e-3f)) {
+    EXPECT_NEAR(value, 0.25f, 1e-5f);
+  }
+}
+
+TEST(GuidedFilterUtilsTest, ReproducesLinearFunctionOfGuide) {
+  constexpr int kWidth = 8, kHeight = 8, kScale = 2;
+  constexpr int kGuideWidth = kWidth * kScale;
+  std::vector<float> guide(kGuideWidth * kHeight * kScale);
+  for (int y = 0; y < kHeight * kScale; ++y) {
+    for (int x = 0; x < kGuideWidth; ++x) {
+      guide[y * kGuideWidth + x] = ((x * 7 + y * 3) % 16) / 15.0f;
+    }
+  }
+  // A mask that is a linear function of the downsampled guide.
+  std::vector<float> mask(kWidth * kHeight, 0.0f);
+  for (int y = 0; y < kHeight * kScale; ++y) {
+    for (int x = 0; x < kGuideWidth; ++x) {
+      mask[(y / kScale) * kWidth + x / kScale] +=
+          (0.5f * guide[y * kGuideWidth + x] + 0.2f) / (kScale * kScale);
+    }
+  }
+  const std::vector<float> output =
+      GuidedUpsample(guide, mask, kWidth, kHeight, kScale, /*radius=*/1,
+                     /*epsilon=*/1e-6f);
+  for (int i = 0; i < guide.size(); ++i) {
+    EXPECT_NEAR(output[i], 0.5f * guide[i] + 0.2f, 1e-3f) << "pixel " << i;
+  }
+}
+
+TEST(GuidedFilterUtilsTest, FollowsGuideEdges) {
+  // A vertical edge at the center of the guide, and the same edge in the
+  // mask at a quarter of the resolution.
+  constexpr int kWidth = 8, kHeight = 4, kScale = 4;
+  constexpr int kGuideWidth = kWidth * kScale;
+  std::vector<float> guide(kGuideWidth * kHeight * kScale);
+  for (int i = 0; i < guide.size(); ++i) {
+    guide[i] = i % kGuideWidth < kGuideWidth / 2 ? 0.0f : 1.0f;
+  }
+  std::vector<float> mask(kWidth * kHeight);
+  for (int i = 0; i < mask.size(); ++i) {
+    mask[i] = i % kWidth < kWidth / 2 ? 0.0f : 1.0f;
+  }
+  const std::vector<float> output =
+      GuidedUpsample(guide, mask, kWidth, kHeight, kScale, /*radius=*/1,
+                     /*epsilon=*/1e-3f);
+  // Bilinear upsampling of the mask would give 0.375 and 0.625 next to the
+  // edge.
+  for (int y = 0; y < kHeight * kScale; ++y) {
+    const float* row = output.data() + y * kGuideWidth;
+    EXPECT_NEAR(row[0], 0.0f, 1e-5f);
+    EXPECT_LT(row[kGuideWidth / 2 - 1], 0.2f);
+    EXPECT_GT(row[kGuideWidth / 2], 0.8f);
+    EXPECT_NEAR(row[kGuideWidth - 1], 1.0f, 1e-5f);
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
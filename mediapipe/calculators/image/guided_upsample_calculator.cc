@@ -0,0 +1,142 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "mediapipe/calculators/image/guided_filter_utils.h"
+#include "mediapipe/calculators/image/guided_upsample_calculator.pb.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_opencv.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/ret_check.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Upsamples a low resolution segmentation mask to the size of the image it
+// was computed from, with edges that follow the edges of the image. This lets
+// segmentation models run at a lower resolution without blurring the mask
+// boundaries as plain bilinear upsampling does.
+//
+// The mask is fit locally as a linear function of the image luminance, which
+// is downsampled to the mask size, and the fit coefficients are then upsampled
+// and applied to the full resolution luminance (the fast guided filter, He and
+// Sun, 2015). Runs on CPU.
+//
+// Inputs:
+//   IMAGE - Image [ImageFormat::SRGB, SRGBA or GRAY8]
+//     The full resolution guide image.
+//   MASK - Image [ImageFormat::VEC32F1]
+//     The low resolution mask, with values in [0, 1].
+//
+// Outputs:
+//   MASK - Image [ImageFormat::VEC32F1]
+//     The mask at the size of IMAGE.
+//
+// Example config:
+// node {
+//   calculator: "GuidedUpsampleCalculator"
+//   input_stream: "IMAGE:image"
+//   input_stream: "MASK:low_resolution_mask"
+//   output_stream: "MASK:mask"
+//   options {
+//     [mediapipe.GuidedUpsampleCalculatorOptions.ext] {
+//       radius: 2
+//       epsilon: 0.001
+//     }
+//   }
+// }
+class GuidedUpsampleCalculator : public Node {
+ public:
+  static constexpr Input<Image> kInImage{"IMAGE"};
+  static constexpr Input<Image> kInMask{"MASK"};
+  static constexpr Output<Image> kOutMask{"MASK"};
+
+  MEDIAPIPE_NODE_CONTRACT(kInImage, kInMask, kOutMask);
+
+  absl::Status Open(CalculatorContext* cc) final {
+    options_ = cc->Options<GuidedUpsampleCalculatorOptions>();
+    RET_CHECK_GE(options_.radius(), 1);
+    RET_CHECK_GT(options_.epsilon(), 0.0f);
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) final {
+    if (kInImage(cc).IsEmpty() || kInMask(cc).IsEmpty()) {
+      return absl::OkStatus();
+    }
+    const Image& image = *kInImage(cc);
+    const Image& mask = *kInMask(cc);
+    RET_CHECK(!image.UsesGpu() && !mask.UsesGpu())
+        << "Only CPU images are supported.";
+    RET_CHECK_EQ(mask.image_format(), ImageFormat::FORMAT_VEC32F1)
+        << "Only 1-channel float masks are supported.";
+
+    // The luminance of the guide in [0, 1].
+    auto image_mat = formats::MatView(&image);
+    cv::Mat guide;
+    switch (image.image_format()) {
+      case ImageFormat::FORMAT_SRGB:
+        cv::cvtColor(*image_mat, guide, cv::COLOR_RGB2GRAY);
+        break;
+      case ImageFormat::FORMAT_SRGBA:
+        cv::cvtColor(*image_mat, guide, cv::COLOR_RGBA2GRAY);
+        break;
+      case ImageFormat::FORMAT_GRAY8:
+        guide = *image_mat;
+        break;
+      default:
+        return absl::InvalidArgumentError(
+            "Only SRGB, SRGBA and GRAY8 images are supported.");
+    }
+    guide.convertTo(guide, CV_32FC1, 1.0 / 255.0);
+
+    // The guide at the mask size, and the mask with contiguous rows.
+    cv::Mat mask_mat = formats::MatView(&mask)->clone();
+    cv::Mat small_guide;
+    cv::resize(guide, small_guide, mask_mat.size(), 0, 0, cv::INTER_AREA);
+
+    cv::Mat a(mask_mat.size(), CV_32FC1);
+    cv::Mat b(mask_mat.size(), CV_32FC1);
+    ComputeGuidedFilterCoefficients(
+        small_guide.ptr<float>(), mask_mat.ptr<float>(), mask_mat.cols,
+        mask_mat.rows, options_.radius(), options_.epsilon(),
+        a.ptr<float>(), b.ptr<float>());
+
+    auto output_frame = std::make_shared<ImageFrame>(
+        ImageFormat::FORMAT_VEC32F1, guide.cols, guide.rows);
+    cv::Mat output_mat = formats::MatView(output_frame.get());
+    ApplyGuidedFilterCoefficients(
+        a.ptr<float>(), b.ptr<float>(), a.cols, a.rows, guide.ptr<float>(),
+        guide.cols, guide.rows, guide.step1(), output_mat.ptr<float>(),
+        output_mat.step1());
+    kOutMask(cc).Send(Image(std::move(output_frame)));
+    return absl::OkStatus();
+  }
+
+ private:
+  GuidedUpsampleCalculatorOptions options_;
+};
+MEDIAPIPE_REGISTER_NODE(GuidedUpsampleCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
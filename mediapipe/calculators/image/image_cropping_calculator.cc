@@ -20,6 +20,7 @@
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -246,6 +247,26 @@ absl::Status ImageCroppingCalculator::RenderCpu(CalculatorContext* cc) {
   output_width *= scale;
   output_height *= scale;
 
+  if (options_.output_view_when_possible() && rotation == 0.f &&
+      scale == 1.0f) {
+    // An axis-aligned crop on whole pixels selects input pixels exactly, so
+    // it is emitted as a view of the input frame.
+    const float left = rect_center_x - target_width / 2.f;
+    const float top = rect_center_y - target_height / 2.f;
+    if (left == std::round(left) && top == std::round(top) && left >= 0 &&
+        top >= 0 && target_width > 0 && target_height > 0 &&
+        left + target_width <= input_img.Width() &&
+        top + target_height <= input_img.Height()) {
+      std::unique_ptr<ImageFrame> output_frame = CreateImageFrameSubRectView(
+          SharedPtrWithPacket<ImageFrame>(cc->Inputs().Tag(kImageTag).Value()),
+          static_cast<int>(left), static_cast<int>(top), target_width,
+          target_height);
+      cc->Outputs().Tag(kImageTag).Add(output_frame.release(),
+                                       cc->InputTimestamp());
+      return absl::OkStatus();
+    }
+  }
+
   float dst_corners[8] = {
       0, output_height, 0, 0, output_width, 0, output_width, output_height};
   const cv::Mat dst_points = cv::Mat(4, 2, CV_32F, dst_corners);
@@ -12,12 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
 #include "absl/status/status.h"
 #include "mediapipe/calculators/image/image_transformation_calculator.pb.h"
 #include "mediapipe/calculators/image/rotation_mode.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_frame_pool.h"
 #include "mediapipe/framework/formats/video_stream_header.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
@@ -103,6 +110,87 @@ mediapipe::ScaleMode_Mode ParseScaleMode(
       return default_mode;
   }
 }
+
+// Copies pixels into dst in a single pass, reading the pixel for dst (x, y)
+// at src + y * src_y_step + x * src_x_step. Tiled so that rotations, which
+// read src across rows, stay cache friendly. kPixelBytes is 0 for pixel sizes
+// only known at runtime.
+template <int kPixelBytes>
+void RemapPixels(const uint8_t* src, ptrdiff_t src_x_step,
+                 ptrdiff_t src_y_step, int pixel_bytes, cv::Mat* dst) {
+  constexpr int kTileSize = 32;
+  const int copy_bytes = kPixelBytes > 0 ? kPixelBytes : pixel_bytes;
+  for (int tile_y = 0; tile_y < dst->rows; tile_y += kTileSize) {
+    const int end_y = std::min(tile_y + kTileSize, dst->rows);
+    for (int tile_x = 0; tile_x < dst->cols; tile_x += kTileSize) {
+      const int end_x = std::min(tile_x + kTileSize, dst->cols);
+      for (int y = tile_y; y < end_y; ++y) {
+        const uint8_t* in = src + y * src_y_step + tile_x * src_x_step;
+        uint8_t* out = dst->ptr<uint8_t>(y) + tile_x * copy_bytes;
+        for (int x = tile_x; x < end_x; ++x) {
+          std::memcpy(out, in, copy_bytes);
+          in += src_x_step;
+          out += copy_bytes;
+        }
+      }
+    }
+  }
+}
+
+// Rotates src counterclockwise by a multiple of 90 degrees and then flips it,
+// writing the result into dst in one pass. dst must already have the rotated
+// size and the type of src.
+void OrientImage(const cv::Mat& src, int angle, bool flip_horizontally,
+                 bool flip_vertically, cv::Mat* dst) {
+  const int pixel_bytes = src.elemSize();
+  // Returns the byte offset in src of the pixel that ends up at dst (x, y).
+  auto source_offset = [&](int x, int y) -> ptrdiff_t {
+    const int64_t rotated_x = flip_horizontally ? dst->cols - 1 - x : x;
+    const int64_t rotated_y = flip_vertically ? dst->rows - 1 - y : y;
+    int64_t col = rotated_x;
+    int64_t row = rotated_y;
+    switch (angle) {
+      case 90:
+        col = src.cols - 1 - rotated_y;
+        row = rotated_x;
+        break;
+      case 180:
+        col = src.cols - 1 - rotated_x;
+        row = src.rows - 1 - rotated_y;
+        break;
+      case 270:
+        col = rotated_y;
+        row = src.rows - 1 - rotated_x;
+        break;
+    }
+    return row * static_cast<int64_t>(src.step[0]) + col * pixel_bytes;
+  };
+  // The mapping is affine, so a start offset and two steps describe it.
+  const ptrdiff_t origin = source_offset(0, 0);
+  const ptrdiff_t x_step = source_offset(1, 0) - origin;
+  const ptrdiff_t y_step = source_offset(0, 1) - origin;
+  const uint8_t* start = src.ptr<uint8_t>() + origin;
+  switch (pixel_bytes) {
+    case 1:
+      RemapPixels<1>(start, x_step, y_step, pixel_bytes, dst);
+      break;
+    case 2:
+      RemapPixels<2>(start, x_step, y_step, pixel_bytes, dst);
+      break;
+    case 3:
+      RemapPixels<3>(start, x_step, y_step, pixel_bytes, dst);
+      break;
+    case 4:
+      RemapPixels<4>(start, x_step, y_step, pixel_bytes, dst);
+      break;
+    case 8:
+      RemapPixels<8>(start, x_step, y_step, pixel_bytes, dst);
+      break;
+    default:
+      RemapPixels<0>(start, x_step, y_step, pixel_bytes, dst);
+      break;
+  }
+}
 }  // namespace
 
 // Scales, rotates, and flips images horizontally or vertically.
@@ -194,6 +282,11 @@ class ImageTransformationCalculator : public CalculatorBase {
   absl::Status RenderGpu(CalculatorContext* cc);
   absl::Status GlSetup();
 
+  // Returns a frame to render the CPU output into, taken from
+  // output_frame_pool_ when output_frame_pool_size is set.
+  std::unique_ptr<ImageFrame> CreateOutputFrame(ImageFormat::Format format,
+                                                int width, int height);
+
   void ComputeOutputDimensions(int input_width, int input_height,
                                int* output_width, int* output_height);
   void ComputeOutputLetterboxPadding(int input_width, int input_height,
@@ -211,6 +304,7 @@ class ImageTransformationCalculator : public CalculatorBase {
   bool use_gpu_ = false;
   cv::Scalar padding_color_;
   ImageTransformationCalculatorOptions::InterpolationMode interpolation_mode_;
+  std::shared_ptr<ImageFramePool> output_frame_pool_;
 
 #if !MEDIAPIPE_DISABLE_GPU
   GlCalculatorHelper gpu_helper_;
@@ -466,9 +560,48 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
   ComputeOutputDimensions(input_width, input_height, &output_width,
                           &output_height);
 
+  const bool scale = output_width_ > 0 && output_height_ > 0;
+  if (scale && scale_mode_ == mediapipe::ScaleMode::SCALE_MODE_FILL_AND_CROP) {
+    const float scale_factor =
+        std::min(static_cast<float>(output_width_) / input_width,
+                 static_cast<float>(output_height_) / input_height);
+    output_width = std::round(input_width * scale_factor);
+    output_height = std::round(input_height * scale_factor);
+  }
+
+  if (cc->Outputs().HasTag("LETTERBOX_PADDING")) {
+    auto padding = absl::make_unique<std::array<float, 4>>();
+    ComputeOutputLetterboxPadding(input_width, input_height, output_width,
+                                  output_height, padding.get());
+    cc->Outputs()
+        .Tag("LETTERBOX_PADDING")
+        .Add(padding.release(), cc->InputTimestamp());
+  }
+
+  // A scaled image always has the output size. Whenever the image has the
+  // output size, a rotation is applied about its center with warpAffine.
+  // Otherwise the image is rotated exactly by a multiple of 90 degrees.
+  const cv::Size output_size(output_width, output_height);
+  const int angle = RotationModeToDegrees(rotation_);
+  const bool warp_rotation =
+      angle != 0 && (scale || input_mat.size() == output_size);
+  const bool flip = flip_horizontally_ || flip_vertically_;
+
+  std::unique_ptr<ImageFrame> output_frame =
+      CreateOutputFrame(format, output_width, output_height);
+  cv::Mat output_mat = formats::MatView(output_frame.get());
+
+  // Without rotation or flipping, the image is scaled directly into the
+  // output frame. OpenCV writes into the preallocated output since it already
+  // has the right size and type.
+  const bool scale_into_output = scale && angle == 0 && !flip;
+
   int opencv_interpolation_mode = cv::INTER_LINEAR;
-  if (output_width_ > 0 && output_height_ > 0) {
+  if (scale) {
     cv::Mat scaled_mat;
+    if (scale_into_output) {
+      scaled_mat = output_mat;
+    }
     if (scale_mode_ == mediapipe::ScaleMode::SCALE_MODE_STRETCH) {
       if (interpolation_mode_ == ImageTransformationCalculatorOptions::INTERPOLATION_MODE_LINEAR) {
         // Use INTER_AREA for downscaling if interpolation mode is set to
@@ -485,16 +618,16 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
       cv::resize(input_mat, scaled_mat, cv::Size(output_width_, output_height_),
                  0, 0, opencv_interpolation_mode);
     } else {
-      const float scale =
+      const float scale_factor =
           std::min(static_cast<float>(output_width_) / input_width,
                    static_cast<float>(output_height_) / input_height);
-      const int target_width = std::round(input_width * scale);
-      const int target_height = std::round(input_height * scale);
+      const int target_width = std::round(input_width * scale_factor);
+      const int target_height = std::round(input_height * scale_factor);
 
       if (interpolation_mode_ == ImageTransformationCalculatorOptions::INTERPOLATION_MODE_LINEAR) {
         // Use INTER_AREA for downscaling if interpolation mode is set to
         // LINEAR.
-        if (scale < 1.0f) {
+        if (scale_factor < 1.0f) {
           opencv_interpolation_mode = cv::INTER_AREA;
         } else {
           opencv_interpolation_mode = cv::INTER_LINEAR;
@@ -520,60 +653,38 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
       } else {
         cv::resize(input_mat, scaled_mat, cv::Size(target_width, target_height),
                    0, 0, opencv_interpolation_mode);
-        output_width = target_width;
-        output_height = target_height;
       }
     }
     input_mat = scaled_mat;
   }
 
-  if (cc->Outputs().HasTag("LETTERBOX_PADDING")) {
-    auto padding = absl::make_unique<std::array<float, 4>>();
-    ComputeOutputLetterboxPadding(input_width, input_height, output_width,
-                                  output_height, padding.get());
-    cc->Outputs()
-        .Tag("LETTERBOX_PADDING")
-        .Add(padding.release(), cc->InputTimestamp());
-  }
-
-  cv::Mat rotated_mat;
-  cv::Size rotated_size(output_width, output_height);
-  if (input_mat.size() == rotated_size) {
-    const int angle = RotationModeToDegrees(rotation_);
+  if (warp_rotation) {
+    cv::Mat rotated_mat;
+    if (!flip) {
+      rotated_mat = output_mat;
+    }
     cv::Point2f src_center(input_mat.cols / 2.0, input_mat.rows / 2.0);
     cv::Mat rotation_mat = cv::getRotationMatrix2D(src_center, angle, 1.0);
-    cv::warpAffine(input_mat, rotated_mat, rotation_mat, rotated_size);
-  } else {
-    switch (rotation_) {
-      case mediapipe::RotationMode::ROTATION_MODE_UNKNOWN:
-      case mediapipe::RotationMode::ROTATION_MODE_ROTATION_0:
-        rotated_mat = input_mat;
-        break;
-      case mediapipe::RotationMode::ROTATION_MODE_ROTATION_90:
-        cv::rotate(input_mat, rotated_mat, cv::ROTATE_90_COUNTERCLOCKWISE);
-        break;
-      case mediapipe::RotationMode::ROTATION_MODE_ROTATION_180:
-        cv::rotate(input_mat, rotated_mat, cv::ROTATE_180);
-        break;
-      case mediapipe::RotationMode::ROTATION_MODE_ROTATION_270:
-        cv::rotate(input_mat, rotated_mat, cv::ROTATE_90_CLOCKWISE);
-        break;
+    cv::warpAffine(input_mat, rotated_mat, rotation_mat, output_size);
+    if (flip) {
+      OrientImage(rotated_mat, /*angle=*/0, flip_horizontally_,
+                  flip_vertically_, &output_mat);
+    }
+  } else if (!scale_into_output) {
+    RET_CHECK(angle == 0 || angle == 90 || angle == 270);
+    RET_CHECK(output_mat.type() == input_mat.type());
+    RET_CHECK(output_size == (angle == 0 ? input_mat.size()
+                                         : cv::Size(input_mat.rows,
+                                                    input_mat.cols)));
+    if (angle == 0 && !flip) {
+      input_mat.copyTo(output_mat);
+    } else {
+      // Rotates and flips in a single pass into the output frame.
+      OrientImage(input_mat, angle, flip_horizontally_, flip_vertically_,
+                  &output_mat);
     }
   }
 
-  cv::Mat flipped_mat;
-  if (flip_horizontally_ || flip_vertically_) {
-    const int flip_code =
-        flip_horizontally_ && flip_vertically_ ? -1 : flip_horizontally_;
-    cv::flip(rotated_mat, flipped_mat, flip_code);
-  } else {
-    flipped_mat = rotated_mat;
-  }
-
-  std::unique_ptr<ImageFrame> output_frame(
-      new ImageFrame(format, output_width, output_height));
-  cv::Mat output_mat = formats::MatView(output_frame.get());
-  flipped_mat.copyTo(output_mat);
   cc->Outputs()
       .Tag(kImageFrameTag)
       .Add(output_frame.release(), cc->InputTimestamp());
@@ -581,6 +692,28 @@ absl::Status ImageTransformationCalculator::RenderCpu(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+std::unique_ptr<ImageFrame> ImageTransformationCalculator::CreateOutputFrame(
+    ImageFormat::Format format, int width, int height) {
+  const int pool_size = options_.output_frame_pool_size();
+  if (pool_size <= 0) {
+    return absl::make_unique<ImageFrame>(format, width, height);
+  }
+  if (!output_frame_pool_ || output_frame_pool_->width() != width ||
+      output_frame_pool_->height() != height ||
+      output_frame_pool_->format() != format) {
+    output_frame_pool_ =
+        ImageFramePool::Create(width, height, format, pool_size);
+  }
+  // The output frame borrows the pixels of a pooled frame, and returns the
+  // pooled frame to the pool when it is destroyed.
+  ImageFrameSharedPtr pooled_frame = output_frame_pool_->GetBuffer();
+  const int width_step = pooled_frame->WidthStep();
+  uint8* pixel_data = pooled_frame->MutablePixelData();
+  return absl::make_unique<ImageFrame>(
+      format, width, height, width_step, pixel_data,
+      [pooled_frame = std::move(pooled_frame)](uint8*) {});
+}
+
 absl::Status ImageTransformationCalculator::RenderGpu(CalculatorContext* cc) {
 #if !MEDIAPIPE_DISABLE_GPU
   const auto& input = cc->Inputs().Tag(kGpuBufferTag).Get<GpuBuffer>();
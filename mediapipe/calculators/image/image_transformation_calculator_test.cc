@@ -311,5 +311,47 @@ TEST(ImageTransformationCalculatorTest,
   }
 }
 
+TEST(ImageTransformationCalculatorTest, RotatesAndFlipsIntoPooledFrames) {
+  cv::Mat input_mat(/*rows=*/4, /*cols=*/6, CV_8UC3);
+  cv::randu(input_mat, cv::Scalar::all(0), cv::Scalar::all(255));
+  Packet input_image_packet = MakePacket<ImageFrame>(
+      ImageFormat::FORMAT_SRGB, input_mat.cols, input_mat.rows);
+  input_mat.copyTo(formats::MatView(&(input_image_packet.Get<ImageFrame>())));
+
+  CalculatorGraphConfig::Node node_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "ImageTransformationCalculator"
+        input_stream: "IMAGE:input_image"
+        output_stream: "IMAGE:output_image"
+        options: {
+          [mediapipe.ImageTransformationCalculatorOptions.ext]: {
+            rotation_mode: ROTATION_90
+            flip_horizontally: true
+            output_frame_pool_size: 1
+          }
+        })pb");
+
+  CalculatorRunner runner(node_config);
+  for (int i = 0; i < 3; ++i) {
+    runner.MutableInputs()->Tag("IMAGE").packets.push_back(
+        input_image_packet.At(Timestamp(i)));
+  }
+  MP_ASSERT_OK(runner.Run());
+  const std::vector<Packet>& packets = runner.Outputs().Tag("IMAGE").packets;
+  ASSERT_EQ(packets.size(), 3);
+
+  cv::Mat expected_mat;
+  cv::rotate(input_mat, expected_mat, cv::ROTATE_90_COUNTERCLOCKWISE);
+  cv::flip(expected_mat, expected_mat, /*flipCode=*/1);
+  for (const Packet& packet : packets) {
+    const auto& result = packet.Get<ImageFrame>();
+    ASSERT_EQ(result.Width(), input_mat.rows);
+    ASSERT_EQ(result.Height(), input_mat.cols);
+    EXPECT_EQ(cv::norm(formats::MatView(&result), expected_mat,
+                       cv::NORM_INF),
+              0);
+  }
+}
+
 }  // namespace
 }  // namespace mediapipe
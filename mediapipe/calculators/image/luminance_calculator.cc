@@ -14,6 +14,7 @@
 
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/tool/shader_fusion.h"
 #include "mediapipe/gpu/gl_simple_calculator.h"
 #include "mediapipe/gpu/gl_simple_shaders.h"
 #include "mediapipe/gpu/shader_util.h"
@@ -35,6 +36,10 @@ class LuminanceCalculator : public GlSimpleCalculator {
   GLint frame_;
 };
 REGISTER_CALCULATOR(LuminanceCalculator);
+REGISTER_FUSABLE_SHADER(LuminanceCalculator, R"(
+  const highp vec3 W = vec3(0.2125, 0.7154, 0.0721);
+  return vec4(vec3(dot(color.rgb, W)), color.a);
+)");
 
 absl::Status LuminanceCalculator::GlSetup() {
   // Load vertex and fragment shaders
@@ -12,9 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
 #include "mediapipe/calculators/image/opencv_encoded_image_to_image_frame_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/image_frame_pool.h"
 #include "mediapipe/framework/port/opencv_imgcodecs_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/status.h"
@@ -22,10 +28,98 @@
 
 namespace mediapipe {
 
+namespace {
+
+// Reads a big-endian 16-bit value.
+int ReadUint16(const uint8_t* data) { return (data[0] << 8) | data[1]; }
+
+// Reads the size and the number of components of a JPEG image from its frame
+// header. Returns false if the data is not a JPEG image or the frame header
+// is not found before the image data.
+bool GetJpegInfo(absl::string_view contents, int* width, int* height,
+                 int* num_components) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(contents.data());
+  const size_t size = contents.size();
+  if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+    return false;
+  }
+  size_t pos = 2;
+  while (pos + 4 <= size) {
+    if (data[pos] != 0xFF) {
+      return false;
+    }
+    const uint8_t marker = data[pos + 1];
+    if (marker == 0xFF) {
+      // Fill byte.
+      ++pos;
+      continue;
+    }
+    pos += 2;
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+      // Markers without a segment.
+      continue;
+    }
+    const int length = ReadUint16(data + pos);
+    if (length < 2) {
+      return false;
+    }
+    // SOFn markers, except DHT, JPG and DAC which share their range.
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+        marker != 0xC8 && marker != 0xCC) {
+      if (pos + 8 > size) {
+        return false;
+      }
+      *height = ReadUint16(data + pos + 3);
+      *width = ReadUint16(data + pos + 5);
+      *num_components = data[pos + 7];
+      return true;
+    }
+    if (marker == 0xDA) {
+      // Start of scan, the frame header is missing.
+      return false;
+    }
+    pos += length;
+  }
+  return false;
+}
+
+// Returns the imdecode flags that decode a JPEG image of the given size at the
+// smallest DCT scale whose size is at least min_size in both dimensions, or 0
+// if the image should be decoded at full scale.
+int GetReducedJpegDecodeFlags(int width, int height, int num_components,
+                              int min_size) {
+  const bool gray = num_components == 1;
+  for (int denominator = 8; denominator > 1; denominator /= 2) {
+    // libjpeg rounds scaled dimensions up.
+    if ((width + denominator - 1) / denominator < min_size ||
+        (height + denominator - 1) / denominator < min_size) {
+      continue;
+    }
+    switch (denominator) {
+      case 8:
+        return gray ? cv::IMREAD_REDUCED_GRAYSCALE_8
+                    : cv::IMREAD_REDUCED_COLOR_8;
+      case 4:
+        return gray ? cv::IMREAD_REDUCED_GRAYSCALE_4
+                    : cv::IMREAD_REDUCED_COLOR_4;
+      default:
+        return gray ? cv::IMREAD_REDUCED_GRAYSCALE_2
+                    : cv::IMREAD_REDUCED_COLOR_2;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
 // Takes in an encoded image string, decodes it by OpenCV, and converts to an
 // ImageFrame. Note that this calculator only supports grayscale and RGB images
 // for now.
 //
+// Set min_decoded_size to have JPEG images decoded at a reduced DCT scale
+// when the graph downscales them anyway, and output_frame_pool_size to reuse
+// output frames.
+//
 // Example config:
 // node {
 //   calculator: "OpenCvEncodedImageToImageFrameCalculator"
@@ -39,7 +133,16 @@ class OpenCvEncodedImageToImageFrameCalculator : public CalculatorBase {
   absl::Status Process(CalculatorContext* cc) override;
 
  private:
+  // Returns an output frame, from output_frame_pool_ when
+  // output_frame_pool_size is set.
+  std::unique_ptr<ImageFrame> CreateOutputFrame(ImageFormat::Format format,
+                                                int width, int height);
+
   mediapipe::OpenCvEncodedImageToImageFrameCalculatorOptions options_;
+  // Reused across images, so that imdecode only allocates when the decoded
+  // size or type changes.
+  cv::Mat decoded_mat_;
+  std::shared_ptr<ImageFramePool> output_frame_pool_;
 };
 
 absl::Status OpenCvEncodedImageToImageFrameCalculator::GetContract(
@@ -59,46 +162,91 @@ absl::Status OpenCvEncodedImageToImageFrameCalculator::Open(
 absl::Status OpenCvEncodedImageToImageFrameCalculator::Process(
     CalculatorContext* cc) {
   const std::string& contents = cc->Inputs().Index(0).Get<std::string>();
-  const std::vector<char> contents_vector(contents.begin(), contents.end());
-  cv::Mat decoded_mat;
+  // Wraps the contents without copying them.
+  const cv::Mat contents_mat(1, contents.size(), CV_8UC1,
+                             const_cast<char*>(contents.data()));
+  int flags;
   if (options_.apply_orientation_from_exif_data()) {
     // We want to respect the orientation from the EXIF data, which
     // IMREAD_UNCHANGED ignores, but otherwise we want to be as permissive as
     // possible with our reading flags. Therefore, we use IMREAD_ANYCOLOR and
     // IMREAD_ANYDEPTH.
-    decoded_mat = cv::imdecode(contents_vector,
-                               cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH);
+    flags = cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH;
   } else {
     // Return the loaded image as-is
-    decoded_mat = cv::imdecode(contents_vector, cv::IMREAD_UNCHANGED);
+    flags = cv::IMREAD_UNCHANGED;
   }
+  int width, height, num_components;
+  if (options_.min_decoded_size() > 0 &&
+      GetJpegInfo(contents, &width, &height, &num_components)) {
+    const int reduced_flags = GetReducedJpegDecodeFlags(
+        width, height, num_components, options_.min_decoded_size());
+    if (reduced_flags != 0) {
+      flags = reduced_flags;
+      if (!options_.apply_orientation_from_exif_data()) {
+        flags |= cv::IMREAD_IGNORE_ORIENTATION;
+      }
+    }
+  }
+  cv::imdecode(contents_mat, flags, &decoded_mat_);
   ImageFormat::Format image_format = ImageFormat::FORMAT_UNKNOWN;
-  cv::Mat output_mat;
-  switch (decoded_mat.channels()) {
+  switch (decoded_mat_.channels()) {
     case 1:
       image_format = ImageFormat::FORMAT_GRAY8;
-      output_mat = decoded_mat;
       break;
     case 3:
       image_format = ImageFormat::FORMAT_SRGB;
-      cv::cvtColor(decoded_mat, output_mat, cv::COLOR_BGR2RGB);
       break;
     case 4:
       image_format = ImageFormat::FORMAT_SRGBA;
-      cv::cvtColor(decoded_mat, output_mat, cv::COLOR_BGR2RGBA);
       break;
     default:
       return mediapipe::FailedPreconditionErrorBuilder(MEDIAPIPE_LOC)
-             << "Unsupported number of channels: " << decoded_mat.channels();
+             << "Unsupported number of channels: " << decoded_mat_.channels();
+  }
+  std::unique_ptr<ImageFrame> output_frame = CreateOutputFrame(
+      image_format, decoded_mat_.size().width, decoded_mat_.size().height);
+  // Converts straight into the output frame.
+  cv::Mat output_mat = formats::MatView(output_frame.get());
+  switch (decoded_mat_.channels()) {
+    case 1:
+      decoded_mat_.copyTo(output_mat);
+      break;
+    case 3:
+      cv::cvtColor(decoded_mat_, output_mat, cv::COLOR_BGR2RGB);
+      break;
+    case 4:
+      cv::cvtColor(decoded_mat_, output_mat, cv::COLOR_BGR2RGBA);
+      break;
   }
-  std::unique_ptr<ImageFrame> output_frame = absl::make_unique<ImageFrame>(
-      image_format, decoded_mat.size().width, decoded_mat.size().height,
-      ImageFrame::kGlDefaultAlignmentBoundary);
-  output_mat.copyTo(formats::MatView(output_frame.get()));
   cc->Outputs().Index(0).Add(output_frame.release(), cc->InputTimestamp());
   return absl::OkStatus();
 }
 
+std::unique_ptr<ImageFrame>
+OpenCvEncodedImageToImageFrameCalculator::CreateOutputFrame(
+    ImageFormat::Format format, int width, int height) {
+  const int pool_size = options_.output_frame_pool_size();
+  if (pool_size <= 0) {
+    return absl::make_unique<ImageFrame>(
+        format, width, height, ImageFrame::kGlDefaultAlignmentBoundary);
+  }
+  if (!output_frame_pool_ || output_frame_pool_->width() != width ||
+      output_frame_pool_->height() != height ||
+      output_frame_pool_->format() != format) {
+    output_frame_pool_ =
+        ImageFramePool::Create(width, height, format, pool_size);
+  }
+  // The output frame borrows the pixels of a pooled frame, and returns the
+  // pooled frame to the pool when it is destroyed.
+  ImageFrameSharedPtr pooled_frame = output_frame_pool_->GetBuffer();
+  const int width_step = pooled_frame->WidthStep();
+  uint8* pixel_data = pooled_frame->MutablePixelData();
+  return absl::make_unique<ImageFrame>(
+      format, width, height, width_step, pixel_data,
+      [pooled_frame = std::move(pooled_frame)](uint8*) {});
+}
+
 REGISTER_CALCULATOR(OpenCvEncodedImageToImageFrameCalculator);
 
 }  // namespace mediapipe
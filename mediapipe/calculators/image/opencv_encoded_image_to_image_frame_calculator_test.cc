@@ -102,5 +102,52 @@ TEST(OpenCvEncodedImageToImageFrameCalculatorTest, TestGrayscaleJpeg) {
   EXPECT_LE(max_val, 10);
 }
 
+TEST(OpenCvEncodedImageToImageFrameCalculatorTest, TestReducedJpeg) {
+  const std::string path =
+      file::JoinPath("./", "/mediapipe/calculators/image/testdata/dino.jpg");
+  std::string contents;
+  MP_ASSERT_OK(file::GetContents(path, &contents));
+
+  CalculatorGraphConfig::Node node_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "OpenCvEncodedImageToImageFrameCalculator"
+        input_stream: "encoded_image"
+        output_stream: "image_frame"
+        options {
+          [mediapipe.OpenCvEncodedImageToImageFrameCalculatorOptions.ext] {
+            min_decoded_size: 256
+            output_frame_pool_size: 2
+          }
+        }
+      )pb");
+  CalculatorRunner runner(node_config);
+  for (int i = 0; i < 2; ++i) {
+    runner.MutableInputs()->Index(0).packets.push_back(
+        MakePacket<std::string>(contents).At(Timestamp(i)));
+  }
+  MP_ASSERT_OK(runner.Run());
+  const std::vector<Packet>& packets = runner.Outputs().Index(0).packets;
+  ASSERT_EQ(2, packets.size());
+
+  // The 2876x1699 image is decoded at 1/4 scale, the smallest scale whose
+  // size is at least 256x256.
+  cv::Mat input_mat = cv::imread(path, cv::IMREAD_REDUCED_COLOR_4);
+  ASSERT_EQ(input_mat.cols, 719);
+  ASSERT_EQ(input_mat.rows, 425);
+  for (const Packet& packet : packets) {
+    const ImageFrame& output_frame = packet.Get<ImageFrame>();
+    ASSERT_EQ(output_frame.Width(), 719);
+    ASSERT_EQ(output_frame.Height(), 425);
+    cv::Mat output_mat;
+    cv::cvtColor(formats::MatView(&output_frame), output_mat,
+                 cv::COLOR_RGB2BGR);
+    cv::Mat diff;
+    cv::absdiff(input_mat, output_mat, diff);
+    double max_val;
+    cv::minMaxLoc(diff, nullptr, &max_val);
+    EXPECT_EQ(max_val, 0);
+  }
+}
+
 }  // namespace
 }  // namespace mediapipe
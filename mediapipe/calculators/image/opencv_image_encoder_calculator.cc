@@ -12,7 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <deque>
+#include <memory>
+#include <vector>
+
 #include "absl/log/absl_check.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
 #include "mediapipe/calculators/image/opencv_image_encoder_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
@@ -20,48 +26,15 @@
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/port/status_builder.h"
+#include "mediapipe/framework/port/threadpool.h"
 
 namespace mediapipe {
 
-// Calculator to encode raw image frames. This will result in considerable space
-// savings if the frames need to be stored on disk.
-//
-// Example config:
-// node {
-//   calculator: "OpenCvImageEncoderCalculator"
-//   input_stream: "image"
-//   output_stream: "encoded_image"
-//   node_options {
-//     [type.googleapis.com/mediapipe.OpenCvImageEncoderCalculatorOptions]: {
-//       quality: 80
-//     }
-//   }
-// }
-class OpenCvImageEncoderCalculator : public CalculatorBase {
- public:
-  static absl::Status GetContract(CalculatorContract* cc);
-  absl::Status Open(CalculatorContext* cc) override;
-  absl::Status Process(CalculatorContext* cc) override;
-  absl::Status Close(CalculatorContext* cc) override;
-
- private:
-  int encoding_quality_;
-};
-
-absl::Status OpenCvImageEncoderCalculator::GetContract(CalculatorContract* cc) {
-  cc->Inputs().Index(0).Set<ImageFrame>();
-  cc->Outputs().Index(0).Set<OpenCvImageEncoderCalculatorResults>();
-  return absl::OkStatus();
-}
-
-absl::Status OpenCvImageEncoderCalculator::Open(CalculatorContext* cc) {
-  auto options = cc->Options<OpenCvImageEncoderCalculatorOptions>();
-  encoding_quality_ = options.quality();
-  return absl::OkStatus();
-}
+namespace {
 
-absl::Status OpenCvImageEncoderCalculator::Process(CalculatorContext* cc) {
-  const ImageFrame& image_frame = cc->Inputs().Index(0).Get<ImageFrame>();
+// Encodes an image frame to JPEG.
+absl::StatusOr<std::unique_ptr<OpenCvImageEncoderCalculatorResults>>
+EncodeImageFrame(const ImageFrame& image_frame, int quality) {
   ABSL_CHECK_EQ(1, image_frame.ByteDepth());
 
   std::unique_ptr<OpenCvImageEncoderCalculatorResults> encoded_result =
@@ -84,8 +57,12 @@ absl::Status OpenCvImageEncoderCalculator::Process(CalculatorContext* cc) {
       encoded_result->set_colorspace(OpenCvImageEncoderCalculatorResults::COLOR_SPACE_RGB);
       break;
     case 4:
-      return mediapipe::UnimplementedErrorBuilder(MEDIAPIPE_LOC)
-             << "4-channel image isn't supported yet";
+      // JPEG has no alpha channel. Drop it in the same pass that reorders
+      // the color channels.
+      cv::cvtColor(original_mat, input_mat, cv::COLOR_RGBA2BGR);
+      encoded_result->set_colorspace(
+          OpenCvImageEncoderCalculatorResults::COLOR_SPACE_RGB);
+      break;
     default:
       return mediapipe::FailedPreconditionErrorBuilder(MEDIAPIPE_LOC)
              << "Unsupported number of channels: " << original_mat.channels();
@@ -93,7 +70,7 @@ absl::Status OpenCvImageEncoderCalculator::Process(CalculatorContext* cc) {
 
   std::vector<int> parameters;
   parameters.push_back(cv::IMWRITE_JPEG_QUALITY);
-  parameters.push_back(encoding_quality_);
+  parameters.push_back(quality);
 
   std::vector<uchar> encode_buffer;
   // Note that imencode() will store the data in RGB order.
@@ -105,12 +82,114 @@ absl::Status OpenCvImageEncoderCalculator::Process(CalculatorContext* cc) {
   }
 
   encoded_result->set_encoded_image(&encode_buffer[0], encode_buffer.size());
+  return encoded_result;
+}
+
+}  // namespace
 
-  cc->Outputs().Index(0).Add(encoded_result.release(), cc->InputTimestamp());
+// Calculator to encode raw image frames. This will result in considerable space
+// savings if the frames need to be stored on disk.
+//
+// With num_threads > 1, images are encoded in parallel on a thread pool, and
+// the encoded images are output in timestamp order as they complete. Up to
+// num_threads images are pending at a time, so each encoded image is output
+// on a later Process() call, or on Close().
+//
+// Example config:
+// node {
+//   calculator: "OpenCvImageEncoderCalculator"
+//   input_stream: "image"
+//   output_stream: "encoded_image"
+//   node_options {
+//     [type.googleapis.com/mediapipe.OpenCvImageEncoderCalculatorOptions]: {
+//       quality: 80
+//     }
+//   }
+// }
+class OpenCvImageEncoderCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc);
+  absl::Status Open(CalculatorContext* cc) override;
+  absl::Status Process(CalculatorContext* cc) override;
+  absl::Status Close(CalculatorContext* cc) override;
+
+ private:
+  // An image being encoded on the thread pool.
+  struct PendingEncode {
+    Packet image;
+    absl::StatusOr<std::unique_ptr<OpenCvImageEncoderCalculatorResults>>
+        result;
+    absl::Notification done;
+  };
+
+  // Outputs the encoded images at the front of pending_ that are done, and
+  // waits for more until at most max_pending images are pending.
+  absl::Status OutputEncodedImages(CalculatorContext* cc, int max_pending);
+
+  int encoding_quality_;
+  int num_threads_ = 1;
+  // Pending images, in timestamp order.
+  std::deque<std::unique_ptr<PendingEncode>> pending_;
+  // Destroyed first, so that its tasks finish before pending_ is destroyed.
+  std::unique_ptr<ThreadPool> thread_pool_;
+};
+
+absl::Status OpenCvImageEncoderCalculator::GetContract(CalculatorContract* cc) {
+  cc->Inputs().Index(0).Set<ImageFrame>();
+  cc->Outputs().Index(0).Set<OpenCvImageEncoderCalculatorResults>();
   return absl::OkStatus();
 }
 
+absl::Status OpenCvImageEncoderCalculator::Open(CalculatorContext* cc) {
+  auto options = cc->Options<OpenCvImageEncoderCalculatorOptions>();
+  encoding_quality_ = options.quality();
+  num_threads_ = options.num_threads();
+  RET_CHECK_GE(num_threads_, 1);
+  if (num_threads_ > 1) {
+    thread_pool_ = absl::make_unique<ThreadPool>("image_encoder", num_threads_);
+    thread_pool_->StartWorkers();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status OpenCvImageEncoderCalculator::Process(CalculatorContext* cc) {
+  if (!thread_pool_) {
+    ASSIGN_OR_RETURN(auto encoded_result,
+                     EncodeImageFrame(cc->Inputs().Index(0).Get<ImageFrame>(),
+                                      encoding_quality_));
+    cc->Outputs().Index(0).Add(encoded_result.release(), cc->InputTimestamp());
+    return absl::OkStatus();
+  }
+
+  auto pending = absl::make_unique<PendingEncode>();
+  pending->image = cc->Inputs().Index(0).Value();
+  PendingEncode* pending_ptr = pending.get();
+  const int quality = encoding_quality_;
+  thread_pool_->Schedule([pending_ptr, quality] {
+    pending_ptr->result =
+        EncodeImageFrame(pending_ptr->image.Get<ImageFrame>(), quality);
+    pending_ptr->done.Notify();
+  });
+  pending_.push_back(std::move(pending));
+  return OutputEncodedImages(cc, num_threads_);
+}
+
 absl::Status OpenCvImageEncoderCalculator::Close(CalculatorContext* cc) {
+  return OutputEncodedImages(cc, /*max_pending=*/0);
+}
+
+absl::Status OpenCvImageEncoderCalculator::OutputEncodedImages(
+    CalculatorContext* cc, int max_pending) {
+  while (!pending_.empty() &&
+         (static_cast<int>(pending_.size()) > max_pending ||
+          pending_.front()->done.HasBeenNotified())) {
+    std::unique_ptr<PendingEncode> pending = std::move(pending_.front());
+    pending_.pop_front();
+    pending->done.WaitForNotification();
+    MP_RETURN_IF_ERROR(pending->result.status());
+    cc->Outputs().Index(0).Add(pending->result->release(),
+                               pending->image.Timestamp());
+  }
   return absl::OkStatus();
 }
 
@@ -83,5 +83,49 @@ TEST(OpenCvImageEncoderCalculatorTest, TestJpegWithQualities) {
   }
 }
 
+TEST(OpenCvImageEncoderCalculatorTest, MultiThreadedOutputsInTimestampOrder) {
+  cv::Mat input_mat;
+  cv::cvtColor(cv::imread(file::JoinPath("./",
+                                         "/mediapipe/calculators/"
+                                         "image/testdata/dino.jpg")),
+               input_mat, cv::COLOR_BGR2RGBA);
+  Packet input_packet =
+      MakePacket<ImageFrame>(ImageFormat::FORMAT_SRGBA, input_mat.size().width,
+                             input_mat.size().height);
+  input_mat.copyTo(formats::MatView(&(input_packet.Get<ImageFrame>())));
+
+  CalculatorGraphConfig::Node node_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "OpenCvImageEncoderCalculator"
+        input_stream: "image_frames"
+        output_stream: "encoded_images"
+        node_options {
+          [type.googleapis.com/mediapipe.OpenCvImageEncoderCalculatorOptions]: {
+            quality: 80
+            num_threads: 4
+          }
+        })pb");
+  CalculatorRunner runner(node_config);
+  constexpr int kNumFrames = 10;
+  for (int i = 0; i < kNumFrames; ++i) {
+    runner.MutableInputs()->Index(0).packets.push_back(
+        input_packet.At(Timestamp(i)));
+  }
+  MP_ASSERT_OK(runner.Run());
+  const std::vector<Packet>& packets = runner.Outputs().Index(0).packets;
+  ASSERT_EQ(kNumFrames, packets.size());
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(Timestamp(i), packets[i].Timestamp());
+    const auto& result = packets[i].Get<OpenCvImageEncoderCalculatorResults>();
+    EXPECT_EQ(input_mat.size().height, result.height());
+    EXPECT_EQ(input_mat.size().width, result.width());
+    EXPECT_EQ(OpenCvImageEncoderCalculatorResults::COLOR_SPACE_RGB,
+              result.colorspace());
+    EXPECT_EQ(packets[0].Get<OpenCvImageEncoderCalculatorResults>()
+                  .encoded_image(),
+              result.encoded_image());
+  }
+}
+
 }  // namespace
 }  // namespace mediapipe
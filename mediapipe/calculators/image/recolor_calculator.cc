@@ -16,6 +16,7 @@
 
 #include "mediapipe/calculators/image/recolor_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/cpu_image_multi_pool.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
@@ -119,6 +120,7 @@ class RecolorCalculator : public CalculatorBase {
   bool use_gpu_ = false;
   bool invert_mask_ = false;
   bool adjust_with_luminance_ = false;
+  ServiceBinding<CpuImageMultiPool> image_pool_;
 #if !MEDIAPIPE_DISABLE_GPU
   mediapipe::GlCalculatorHelper gpu_helper_;
   GLuint program_ = 0;
@@ -161,6 +163,7 @@ absl::Status RecolorCalculator::GetContract(CalculatorContract* cc) {
 #endif  // !MEDIAPIPE_DISABLE_GPU
   if (cc->Outputs().HasTag(kImageFrameTag)) {
     cc->Outputs().Tag(kImageFrameTag).Set<ImageFrame>();
+    cc->UseService(kCpuImageMultiPoolService).Optional();
   }
 
   // Confirm only one of the input streams is present.
@@ -190,6 +193,7 @@ absl::Status RecolorCalculator::Open(CalculatorContext* cc) {
   }
 
   MP_RETURN_IF_ERROR(LoadOptions(cc));
+  image_pool_ = cc->Service(kCpuImageMultiPoolService);
 
   return absl::OkStatus();
 }
@@ -252,8 +256,13 @@ absl::Status RecolorCalculator::RenderCpu(CalculatorContext* cc) {
   cv::resize(mask_mat, mask_full, input_mat.size());
   const cv::Vec3b recolor = {color_[0], color_[1], color_[2]};
 
-  auto output_img = absl::make_unique<ImageFrame>(
-      input_img.Format(), input_mat.cols, input_mat.rows);
+  // Every pixel is written below, so a pooled frame needs no clearing.
+  auto output_img =
+      image_pool_.IsAvailable()
+          ? image_pool_.GetObject().GetImageFrame(
+                input_img.Format(), input_mat.cols, input_mat.rows)
+          : absl::make_unique<ImageFrame>(input_img.Format(), input_mat.cols,
+                                          input_mat.rows);
   cv::Mat output_mat = mediapipe::formats::MatView(output_img.get());
 
   const int invert_mask = invert_mask_ ? 1 : 0;
@@ -26,6 +26,7 @@
 #include "mediapipe/calculators/image/scale_image_calculator.pb.h"
 #include "mediapipe/calculators/image/scale_image_utils.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/cpu_image_multi_pool.h"
 #include "mediapipe/framework/formats/image_format.pb.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
@@ -181,6 +182,7 @@ class ScaleImageCalculator : public CalculatorBase {
       cc->Outputs().Get(output_data_id).Set<YUVImage>();
     } else {
       cc->Outputs().Get(output_data_id).Set<ImageFrame>();
+      cc->UseService(kCpuImageMultiPoolService).Optional();
     }
 
     if (cc->Inputs().HasTag("OVERRIDE_OPTIONS")) {
@@ -215,6 +217,10 @@ class ScaleImageCalculator : public CalculatorBase {
   // on which this function is called is used to initialize.
   absl::Status ValidateYUVImage(CalculatorContext* cc,
                                 const YUVImage& yuv_image);
+  // Returns a frame with alignment_boundary_, from image_pool_ if the graph
+  // provides it.
+  std::unique_ptr<ImageFrame> CreateImageFrame(ImageFormat::Format format,
+                                               int width, int height);
 
   bool has_header_;  // True if the input stream has a header.
   int input_width_;
@@ -245,6 +251,8 @@ class ScaleImageCalculator : public CalculatorBase {
 
   // Efficient image resizer with gamma correction and optional sharpening.
   std::unique_ptr<ImageResizer> downscaler_;
+
+  ServiceBinding<CpuImageMultiPool> image_pool_;
 };
 
 REGISTER_CALCULATOR(ScaleImageCalculator);
@@ -306,6 +314,7 @@ absl::Status ScaleImageCalculator::InitializeFrameInfo(CalculatorContext* cc) {
 
 absl::Status ScaleImageCalculator::Open(CalculatorContext* cc) {
   options_ = cc->Options<ScaleImageCalculatorOptions>();
+  image_pool_ = cc->Service(kCpuImageMultiPoolService);
 
   input_data_id_ = cc->Inputs().GetId("FRAMES", 0);
   if (!input_data_id_.IsValid()) {
@@ -638,8 +647,8 @@ absl::Status ScaleImageCalculator::Process(CalculatorContext* cc) {
   if (crop_width_ < input_width_ || crop_height_ < input_height_) {
     cc->GetCounter("Crops")->Increment();
     // TODO Do the crop as a range restrict inside OpenCV code below.
-    cropped_image.reset(new ImageFrame(image_frame->Format(), crop_width_,
-                                       crop_height_, alignment_boundary_));
+    cropped_image =
+        CreateImageFrame(image_frame->Format(), crop_width_, crop_height_);
     if (image_frame->ByteDepth() == 1 || image_frame->ByteDepth() == 2) {
       CropImageFrame(*image_frame, col_start_, row_start_, crop_width_,
                      crop_height_, cropped_image.get());
@@ -692,19 +701,20 @@ absl::Status ScaleImageCalculator::Process(CalculatorContext* cc) {
   }
 
   // Rescale the image frame.
-  std::unique_ptr<ImageFrame> output_frame(new ImageFrame());
+  std::unique_ptr<ImageFrame> output_frame;
   if (image_frame->Width() >= output_width_ &&
       image_frame->Height() >= output_height_) {
     // Downscale.
     cc->GetCounter("Downscales")->Increment();
     cv::Mat input_mat = ::mediapipe::formats::MatView(image_frame);
-    output_frame->Reset(image_frame->Format(), output_width_, output_height_,
-                        alignment_boundary_);
+    output_frame =
+        CreateImageFrame(image_frame->Format(), output_width_, output_height_);
     cv::Mat output_mat = ::mediapipe::formats::MatView(output_frame.get());
     downscaler_->Resize(input_mat, &output_mat);
   } else {
     // Upscale. If upscaling is disallowed, output_width_ and output_height_ are
     // the same as the input/crop width and height.
+    output_frame = absl::make_unique<ImageFrame>();
     image_frame_util::RescaleImageFrame(
         *image_frame, output_width_, output_height_, alignment_boundary_,
         interpolation_algorithm_, output_frame.get());
@@ -725,4 +735,14 @@ absl::Status ScaleImageCalculator::Process(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+std::unique_ptr<ImageFrame> ScaleImageCalculator::CreateImageFrame(
+    ImageFormat::Format format, int width, int height) {
+  if (image_pool_.IsAvailable()) {
+    return image_pool_.GetObject().GetImageFrame(format, width, height,
+                                                 alignment_boundary_);
+  }
+  return absl::make_unique<ImageFrame>(format, width, height,
+                                       alignment_boundary_);
+}
+
 }  // namespace mediapipe
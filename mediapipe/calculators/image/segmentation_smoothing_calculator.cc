@@ -17,11 +17,13 @@
 
 #include "absl/log/absl_log.h"
 #include "mediapipe/calculators/image/segmentation_smoothing_calculator.pb.h"
+#include "mediapipe/calculators/image/segmentation_smoothing_utils.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/calculator_options.pb.h"
 #include "mediapipe/framework/formats/image.h"
 #include "mediapipe/framework/formats/image_format.pb.h"
 #include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_pool.h"
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/port/vector.h"
 
@@ -66,6 +68,7 @@ enum { ATTRIB_VERTEX, ATTRIB_TEXTURE_POSITION, NUM_ATTRIBUTES };
 //
 // Options:
 //   combine_with_previous_ratio - Amount of previous to blend with current.
+//   output_frame_pool_size - Number of CPU output frames kept for reuse.
 //
 // Example:
 //  node {
@@ -99,6 +102,8 @@ class SegmentationSmoothingCalculator : public CalculatorBase {
   void GlRender(CalculatorContext* cc);
 
   float combine_with_previous_ratio_;
+  int output_frame_pool_size_ = 0;
+  std::shared_ptr<ImageFramePool> output_frame_pool_;
 
   bool gpu_initialized_ = false;
 #if !MEDIAPIPE_DISABLE_GPU
@@ -129,6 +134,7 @@ absl::Status SegmentationSmoothingCalculator::Open(CalculatorContext* cc) {
   auto options =
       cc->Options<mediapipe::SegmentationSmoothingCalculatorOptions>();
   combine_with_previous_ratio_ = options.combine_with_previous_ratio();
+  output_frame_pool_size_ = options.output_frame_pool_size();
 
 #if !MEDIAPIPE_DISABLE_GPU
   MP_RETURN_IF_ERROR(gpu_helper_.Open(cc));
@@ -205,49 +211,30 @@ absl::Status SegmentationSmoothingCalculator::RenderCpu(CalculatorContext* cc) {
   RET_CHECK_EQ(current_mat->cols, previous_mat->cols);
 
   // Setup destination image.
-  auto output_frame = std::make_shared<ImageFrame>(
-      current_frame.image_format(), current_mat->cols, current_mat->rows);
+  std::shared_ptr<ImageFrame> output_frame;
+  if (output_frame_pool_size_ > 0) {
+    if (!output_frame_pool_ ||
+        output_frame_pool_->width() != current_mat->cols ||
+        output_frame_pool_->height() != current_mat->rows ||
+        output_frame_pool_->format() != current_frame.image_format()) {
+      output_frame_pool_ = ImageFramePool::Create(
+          current_mat->cols, current_mat->rows, current_frame.image_format(),
+          output_frame_pool_size_);
+    }
+    output_frame = output_frame_pool_->GetBuffer();
+  } else {
+    output_frame = std::make_shared<ImageFrame>(
+        current_frame.image_format(), current_mat->cols, current_mat->rows);
+  }
   cv::Mat output_mat = mediapipe::formats::MatView(output_frame.get());
-  output_mat.setTo(cv::Scalar(0));
-
-  // Blending function.
-  const auto blending_fn = [&](const float prev_mask_value,
-                               const float new_mask_value) {
-    /*
-     * Assume p := new_mask_value
-     * H(p) := 1 + (p * log(p) + (1-p) * log(1-p)) / log(2)
-     * uncertainty alpha(p) =
-     *   Clamp(1 - (1 - H(p)) * (1 - H(p)), 0, 1) [squaring the uncertainty]
-     *
-     * The following polynomial approximates uncertainty alpha as a function
-     * of (p + 0.5):
-     */
-    const float c1 = 5.68842;
-    const float c2 = -0.748699;
-    const float c3 = -57.8051;
-    const float c4 = 291.309;
-    const float c5 = -624.717;
-    const float t = new_mask_value - 0.5f;
-    const float x = t * t;
-
-    const float uncertainty =
-        1.0f -
-        std::min(1.0f, x * (c1 + x * (c2 + x * (c3 + x * (c4 + x * c5)))));
-
-    return new_mask_value + (prev_mask_value - new_mask_value) *
-                                (uncertainty * combine_with_previous_ratio_);
-  };
 
-  // Write directly to the first channel of output.
+  // Write directly to the first channel of output. Every value is written, so
+  // the output needs no clearing.
   for (int i = 0; i < output_mat.rows; ++i) {
-    float* out_ptr = output_mat.ptr<float>(i);
-    const float* curr_ptr = current_mat->ptr<float>(i);
-    const float* prev_ptr = previous_mat->ptr<float>(i);
-    for (int j = 0; j < output_mat.cols; ++j) {
-      const float new_mask_value = curr_ptr[j];
-      const float prev_mask_value = prev_ptr[j];
-      out_ptr[j] = blending_fn(prev_mask_value, new_mask_value);
-    }
+    SmoothSegmentationMaskRow(previous_mat->ptr<float>(i),
+                              current_mat->ptr<float>(i), output_mat.cols,
+                              combine_with_previous_ratio_,
+                              output_mat.ptr<float>(i));
   }
 
   cc->Outputs()
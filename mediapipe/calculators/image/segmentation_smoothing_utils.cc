@@ -0,0 +1,113 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/calculators/image/segmentation_smoothing_utils.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace mediapipe {
+
+// The vector loops compute SmoothSegmentationMaskValue with the same order of
+// operations as the scalar code, which handles the remaining values.
+void SmoothSegmentationMaskRow(const float* previous, const float* current,
+                               int size, float combine_with_previous_ratio,
+                               float* output) {
+  int i = 0;
+#if defined(__AVX2__)
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 c1 = _mm256_set1_ps(5.68842f);
+  const __m256 c2 = _mm256_set1_ps(-0.748699f);
+  const __m256 c3 = _mm256_set1_ps(-57.8051f);
+  const __m256 c4 = _mm256_set1_ps(291.309f);
+  const __m256 c5 = _mm256_set1_ps(-624.717f);
+  const __m256 ratio = _mm256_set1_ps(combine_with_previous_ratio);
+  for (; i + 8 <= size; i += 8) {
+    const __m256 p = _mm256_loadu_ps(current + i);
+    const __m256 q = _mm256_loadu_ps(previous + i);
+    const __m256 t = _mm256_sub_ps(p, half);
+    const __m256 x = _mm256_mul_ps(t, t);
+    __m256 poly = _mm256_add_ps(c4, _mm256_mul_ps(x, c5));
+    poly = _mm256_add_ps(c3, _mm256_mul_ps(x, poly));
+    poly = _mm256_add_ps(c2, _mm256_mul_ps(x, poly));
+    poly = _mm256_add_ps(c1, _mm256_mul_ps(x, poly));
+    poly = _mm256_mul_ps(x, poly);
+    const __m256 uncertainty = _mm256_sub_ps(one, _mm256_min_ps(poly, one));
+    const __m256 weight = _mm256_mul_ps(uncertainty, ratio);
+    const __m256 delta = _mm256_mul_ps(_mm256_sub_ps(q, p), weight);
+    _mm256_storeu_ps(output + i, _mm256_add_ps(p, delta));
+  }
+#elif defined(__SSE2__)
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 c1 = _mm_set1_ps(5.68842f);
+  const __m128 c2 = _mm_set1_ps(-0.748699f);
+  const __m128 c3 = _mm_set1_ps(-57.8051f);
+  const __m128 c4 = _mm_set1_ps(291.309f);
+  const __m128 c5 = _mm_set1_ps(-624.717f);
+  const __m128 ratio = _mm_set1_ps(combine_with_previous_ratio);
+  for (; i + 4 <= size; i += 4) {
+    const __m128 p = _mm_loadu_ps(current + i);
+    const __m128 q = _mm_loadu_ps(previous + i);
+    const __m128 t = _mm_sub_ps(p, half);
+    const __m128 x = _mm_mul_ps(t, t);
+    __m128 poly = _mm_add_ps(c4, _mm_mul_ps(x, c5));
+    poly = _mm_add_ps(c3, _mm_mul_ps(x, poly));
+    poly = _mm_add_ps(c2, _mm_mul_ps(x, poly));
+    poly = _mm_add_ps(c1, _mm_mul_ps(x, poly));
+    poly = _mm_mul_ps(x, poly);
+    const __m128 uncertainty = _mm_sub_ps(one, _mm_min_ps(poly, one));
+    const __m128 weight = _mm_mul_ps(uncertainty, ratio);
+    const __m128 delta = _mm_mul_ps(_mm_sub_ps(q, p), weight);
+    _mm_storeu_ps(output + i, _mm_add_ps(p, delta));
+  }
+#elif defined(__ARM_NEON)
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t c1 = vdupq_n_f32(5.68842f);
+  const float32x4_t c2 = vdupq_n_f32(-0.748699f);
+  const float32x4_t c3 = vdupq_n_f32(-57.8051f);
+  const float32x4_t c4 = vdupq_n_f32(291.309f);
+  const float32x4_t c5 = vdupq_n_f32(-624.717f);
+  const float32x4_t ratio = vdupq_n_f32(combine_with_previous_ratio);
+  for (; i + 4 <= size; i += 4) {
+    const float32x4_t p = vld1q_f32(current + i);
+    const float32x4_t q = vld1q_f32(previous + i);
+    const float32x4_t t = vsubq_f32(p, half);
+    const float32x4_t x = vmulq_f32(t, t);
+    float32x4_t poly = vaddq_f32(c4, vmulq_f32(x, c5));
+    poly = vaddq_f32(c3, vmulq_f32(x, poly));
+    poly = vaddq_f32(c2, vmulq_f32(x, poly));
+    poly = vaddq_f32(c1, vmulq_f32(x, poly));
+    poly = vmulq_f32(x, poly);
+    const float32x4_t uncertainty = vsubq_f32(one, vminq_f32(poly, one));
+    const float32x4_t weight = vmulq_f32(uncertainty, ratio);
+    const float32x4_t delta = vmulq_f32(vsubq_f32(q, p), weight);
+    vst1q_f32(output + i, vaddq_f32(p, delta));
+  }
+#endif
+  for (; i < size; ++i) {
+    output[i] = SmoothSegmentationMaskValue(previous[i], current[i],
+                                            combine_with_previous_ratio);
+  }
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,59 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_CALCULATORS_IMAGE_SEGMENTATION_SMOOTHING_UTILS_H_
+#define MEDIAPIPE_CALCULATORS_IMAGE_SEGMENTATION_SMOOTHING_UTILS_H_
+
+#include <algorithm>
+
+namespace mediapipe {
+
+// Returns the blend of a previous and a new segmentation mask value, which
+// gives the previous value more weight when the new value is uncertain,
+// i.e. close to 0.5.
+inline float SmoothSegmentationMaskValue(float previous_value, float new_value,
+                                         float combine_with_previous_ratio) {
+  // Assume p := new_value
+  // H(p) := 1 + (p * log(p) + (1-p) * log(1-p)) / log(2)
+  // uncertainty alpha(p) =
+  //   Clamp(1 - (1 - H(p)) * (1 - H(p)), 0, 1) [squaring the uncertainty]
+  //
+  // The following polynomial approximates uncertainty alpha as a function
+  // of (p + 0.5):
+  const float c1 = 5.68842f;
+  const float c2 = -0.748699f;
+  const float c3 = -57.8051f;
+  const float c4 = 291.309f;
+  const float c5 = -624.717f;
+  const float t = new_value - 0.5f;
+  const float x = t * t;
+
+  const float uncertainty =
+      1.0f - std::min(1.0f, x * (c1 + x * (c2 + x * (c3 + x * (c4 + x * c5)))));
+
+  return new_value + (previous_value - new_value) *
+                         (uncertainty * combine_with_previous_ratio);
+}
+
+// Applies SmoothSegmentationMaskValue to `size` values of a row, using SIMD
+// instructions where available (AVX2, SSE2 or NEON). `output` may alias
+// either input.
+void SmoothSegmentationMaskRow(const float* previous, const float* current,
+                               int size, float combine_with_previous_ratio,
+                               float* output);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_IMAGE_SEGMENTATION_SMOOTHING_UTILS_H_
@@ -0,0 +1,74 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+// Benchmarks SmoothSegmentationMaskRow against the per-value loop that
+// SegmentationSmoothingCalculator used before, over whole masks. The argument
+// is the width and height of the mask.
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mediapipe/calculators/image/segmentation_smoothing_utils.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr float kRatio = 0.9f;
+
+std::vector<float> MakeMask(int size, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> value(0.0f, 1.0f);
+  std::vector<float> mask(size);
+  for (float& v : mask) {
+    v = value(rng);
+  }
+  return mask;
+}
+
+void BM_PerValueLoop(benchmark::State& state) {
+  const int size = state.range(0) * state.range(0);
+  const std::vector<float> previous = MakeMask(size, /*seed=*/1);
+  const std::vector<float> current = MakeMask(size, /*seed=*/2);
+  std::vector<float> output(size);
+  for (auto _ : state) {
+    for (int i = 0; i < size; ++i) {
+      output[i] = SmoothSegmentationMaskValue(previous[i], current[i], kRatio);
+    }
+    benchmark::DoNotOptimize(output.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_PerValueLoop)->Arg(256)->Arg(512);
+
+void BM_SmoothSegmentationMaskRow(benchmark::State& state) {
+  const int size = state.range(0) * state.range(0);
+  const std::vector<float> previous = MakeMask(size, /*seed=*/1);
+  const std::vector<float> current = MakeMask(size, /*seed=*/2);
+  std::vector<float> output(size);
+  for (auto _ : state) {
+    SmoothSegmentationMaskRow(previous.data(), current.data(), size, kRatio,
+                              output.data());
+    benchmark::DoNotOptimize(output.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_SmoothSegmentationMaskRow)->Arg(256)->Arg(512);
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/calculators/image/segmentation_smoothing_utils.h"
+
+#include <random>
+#include <vector>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr float kRatio = 0.9f;
+
+std::vector<float> MakeMaskRow(int size, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> value(0.0f, 1.0f);
+  std::vector<float> row(size);
+  for (float& v : row) {
+    v = value(rng);
+  }
+  return row;
+}
+
+TEST(SegmentationSmoothingUtilsTest, RowMatchesScalarValues) {
+  // Covers sizes with and without a remainder after the vector loop.
+  for (int size = 0; size < 40; ++size) {
+    const std::vector<float> previous = MakeMaskRow(size, /*seed=*/1);
+    const std::vector<float> current = MakeMaskRow(size, /*seed=*/2);
+    std::vector<float> output(size);
+    SmoothSegmentationMaskRow(previous.data(), current.data(), size, kRatio,
+                              output.data());
+    for (int i = 0; i < size; ++i) {
+      EXPECT_NEAR(output[i],
+                  SmoothSegmentationMaskValue(previous[i], current[i], kRatio),
+                  1e-6f)
+          << "size " << size << " index " << i;
+    }
+  }
+}
+
+TEST(SegmentationSmoothingUtilsTest, RowCanWriteInPlace) {
+  constexpr int kSize = 37;
+  std::vector<float> previous = MakeMaskRow(kSize, /*seed=*/1);
+  const std::vector<float> current = MakeMaskRow(kSize, /*seed=*/2);
+  std::vector<float> expected(kSize);
+  SmoothSegmentationMaskRow(previous.data(), current.data(), kSize, kRatio,
+                            expected.data());
+  SmoothSegmentationMaskRow(previous.data(), current.data(), kSize, kRatio,
+                            previous.data());
+  EXPECT_THAT(previous, testing::ElementsAreArray(expected));
+}
+
+TEST(SegmentationSmoothingUtilsTest, KeepsCertainValues) {
+  const float previous[] = {0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
+  const float current[] = {0.0f, 1.0f, 0.0f, 1.0f, 0.0f};
+  float output[5];
+  SmoothSegmentationMaskRow(previous, current, 5, kRatio, output);
+  // The uncertainty polynomial is only approximately 0 at 0 and 1.
+  EXPECT_THAT(output, testing::Pointwise(testing::FloatNear(1e-4f), current));
+}
+
+}  // namespace
+}  // namespace mediapipe
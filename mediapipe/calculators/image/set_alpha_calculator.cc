@@ -18,6 +18,7 @@
 #include "mediapipe/calculators/image/set_alpha_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/calculator_options.pb.h"
+#include "mediapipe/framework/formats/cpu_image_multi_pool.h"
 #include "mediapipe/framework/formats/image_format.pb.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
@@ -131,6 +132,7 @@ class SetAlphaCalculator : public CalculatorBase {
 
   mediapipe::SetAlphaCalculatorOptions options_;
   float alpha_value_ = -1.f;
+  ServiceBinding<CpuImageMultiPool> image_pool_;
 
   bool use_gpu_ = false;
   bool gpu_initialized_ = false;
@@ -186,6 +188,7 @@ absl::Status SetAlphaCalculator::GetContract(CalculatorContract* cc) {
 #endif  // !MEDIAPIPE_DISABLE_GPU
   if (cc->Outputs().HasTag(kOutputFrameTag)) {
     cc->Outputs().Tag(kOutputFrameTag).Set<ImageFrame>();
+    cc->UseService(kCpuImageMultiPoolService).Optional();
   }
 
   if (use_gpu) {
@@ -201,6 +204,7 @@ absl::Status SetAlphaCalculator::Open(CalculatorContext* cc) {
   cc->SetOffset(TimestampDiff(0));
 
   options_ = cc->Options<mediapipe::SetAlphaCalculatorOptions>();
+  image_pool_ = cc->Service(kCpuImageMultiPoolService);
 
   if (cc->Inputs().HasTag(kInputFrameTagGpu) &&
       cc->Outputs().HasTag(kOutputFrameTagGpu)) {
@@ -272,8 +276,13 @@ absl::Status SetAlphaCalculator::RenderCpu(CalculatorContext* cc) {
   }
 
   // Setup destination image
-  auto output_frame = absl::make_unique<ImageFrame>(
-      ImageFormat::FORMAT_SRGBA, input_mat.cols, input_mat.rows);
+  // Every pixel is written below, so a pooled frame needs no clearing.
+  auto output_frame =
+      image_pool_.IsAvailable()
+          ? image_pool_.GetObject().GetImageFrame(
+                ImageFormat::FORMAT_SRGBA, input_mat.cols, input_mat.rows)
+          : absl::make_unique<ImageFrame>(ImageFormat::FORMAT_SRGBA,
+                                          input_mat.cols, input_mat.rows);
   cv::Mat output_mat = formats::MatView(output_frame.get());
 
   const bool has_alpha_mask = cc->Inputs().HasTag(kInputAlphaTag) &&
@@ -1,8 +1,11 @@
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "mediapipe/calculators/image/set_alpha_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/cpu_image_multi_pool.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/port/gtest.h"
@@ -121,6 +124,50 @@ TEST(SetAlphaCalculatorTest, CpuRgba) {
   EXPECT_FLOAT_EQ(max_diff, 0);
 }  // TEST
 
+// Test that SetAlphaCalculator takes output frames from the graph's
+// CpuImageMultiPool.
+TEST(SetAlphaCalculatorTest, CpuUsesImagePool) {
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        input_stream: "input_frames"
+        node {
+          calculator: "SetAlphaCalculator"
+          input_stream: "IMAGE:input_frames"
+          output_stream: "IMAGE:output_frames"
+          options {
+            [mediapipe.SetAlphaCalculatorOptions.ext] { alpha_value: 7 }
+          }
+        }
+      )pb")));
+  auto pool = std::make_shared<CpuImageMultiPool>(
+      MultiPoolOptions{.min_requests_before_pool = 1});
+  MP_ASSERT_OK(graph.SetServiceObject(kCpuImageMultiPoolService, pool));
+  std::vector<Packet> output_packets;
+  MP_ASSERT_OK(graph.ObserveOutputStream(
+      "output_frames", [&output_packets](const Packet& packet) {
+        output_packets.clear();  // Releases the previous frame.
+        output_packets.push_back(packet);
+        return absl::OkStatus();
+      }));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 3; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "input_frames",
+        Adopt(GetInputFrame(input_width, input_height, 3).release())
+            .At(Timestamp(i))));
+    MP_ASSERT_OK(graph.WaitUntilIdle());
+    ASSERT_EQ(output_packets.size(), 1);
+    const auto& output_image = output_packets[0].Get<ImageFrame>();
+    EXPECT_EQ(output_image.Format(), ImageFormat::FORMAT_SRGBA);
+    EXPECT_EQ(output_image.PixelData()[3], 7);
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  EXPECT_EQ(pool->GetStats().pool_count, 1);
+  EXPECT_EQ(pool->GetStats().hits, 2);
+}  // TEST
+
 static void BM_SetAlpha3ChannelImage(benchmark::State& state) {
   auto calculator_node = ParseTextProtoOrDie<CalculatorGraphConfig::Node>(
       R"pb(
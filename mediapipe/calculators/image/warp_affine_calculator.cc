@@ -73,14 +73,16 @@ class WarpAffineRunnerHolder<ImageFrame> {
  public:
   using RunnerType = AffineTransformation::Runner<ImageFrame, ImageFrame>;
   absl::Status Open(CalculatorContext* cc) {
-    interpolation_ = GetInterpolation(
-        cc->Options<mediapipe::WarpAffineCalculatorOptions>().interpolation());
+    const auto& options = cc->Options<mediapipe::WarpAffineCalculatorOptions>();
+    interpolation_ = GetInterpolation(options.interpolation());
+    num_threads_ = options.num_threads();
+    RET_CHECK_GE(num_threads_, 1);
     return absl::OkStatus();
   }
   absl::StatusOr<RunnerType*> GetRunner() {
     if (!runner_) {
-      ASSIGN_OR_RETURN(runner_,
-                       CreateAffineTransformationOpenCvRunner(interpolation_));
+      ASSIGN_OR_RETURN(runner_, CreateAffineTransformationOpenCvRunner(
+                                    interpolation_, num_threads_));
     }
     return runner_.get();
   }
@@ -88,6 +90,7 @@ class WarpAffineRunnerHolder<ImageFrame> {
  private:
   std::unique_ptr<RunnerType> runner_;
   AffineTransformation::Interpolation interpolation_;
+  int num_threads_ = 1;
 };
 #endif  // !MEDIAPIPE_DISABLE_OPENCV
 
@@ -0,0 +1,90 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cmath>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/calculators/tensor/audio_activity_calculator.pb.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/ret_check.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Detects activity in audio tensors by their signal level. It is a cheap
+// voice activity detector for skipping the inference on silent windows, e.g.
+// by gating the tensors with a GateCalculator.
+//
+// Inputs:
+//   TENSORS - std::vector<Tensor>
+//     Vector containing a single float Tensor of audio samples, such as the
+//     time domain tensors of AudioToTensorCalculator.
+//
+// Outputs:
+//   ACTIVE - bool
+//     Whether the root mean square level of the samples reaches the
+//     "min_rms_dbfs" option.
+//
+// Example:
+// node {
+//   calculator: "AudioActivityCalculator"
+//   input_stream: "TENSORS:tensors"
+//   output_stream: "ACTIVE:active"
+//   options {
+//     [mediapipe.AudioActivityCalculatorOptions.ext] { min_rms_dbfs: -50 }
+//   }
+// }
+class AudioActivityCalculator : public Node {
+ public:
+  static constexpr Input<std::vector<Tensor>> kTensorsIn{"TENSORS"};
+  static constexpr Output<bool> kActiveOut{"ACTIVE"};
+  MEDIAPIPE_NODE_CONTRACT(kTensorsIn, kActiveOut);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    const auto& options = cc->Options<AudioActivityCalculatorOptions>();
+    // Compares mean squares, which avoids a square root and a logarithm per
+    // tensor.
+    min_mean_square_ = std::pow(10.0, options.min_rms_dbfs() / 10.0);
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    const auto& tensors = *kTensorsIn(cc);
+    RET_CHECK_EQ(tensors.size(), 1);
+    const Tensor& tensor = tensors[0];
+    RET_CHECK(tensor.element_type() == Tensor::ElementType::kFloat32);
+    const int num_samples = tensor.shape().num_elements();
+    RET_CHECK_GT(num_samples, 0);
+    auto view = tensor.GetCpuReadView();
+    const float* samples = view.buffer<float>();
+    double sum_of_squares = 0.0;
+    for (int i = 0; i < num_samples; ++i) {
+      sum_of_squares += samples[i] * samples[i];
+    }
+    kActiveOut(cc).Send(sum_of_squares >= min_mean_square_ * num_samples);
+    return absl::OkStatus();
+  }
+
+ private:
+  double min_mean_square_ = 0.0;
+};
+
+MEDIAPIPE_REGISTER_NODE(AudioActivityCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -0,0 +1,71 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+// Returns a tensor of a sine wave with the given amplitude.
+std::vector<Tensor> SineTensors(float amplitude) {
+  constexpr int kNumSamples = 1600;
+  std::vector<Tensor> tensors;
+  tensors.emplace_back(Tensor::ElementType::kFloat32,
+                       Tensor::Shape{1, kNumSamples});
+  auto view = tensors.back().GetCpuWriteView();
+  float* samples = view.buffer<float>();
+  for (int i = 0; i < kNumSamples; ++i) {
+    samples[i] = amplitude * std::sin(2 * M_PI * i / 16.0);
+  }
+  return tensors;
+}
+
+TEST(AudioActivityCalculatorTest, ComparesRmsLevelWithThreshold) {
+  CalculatorRunner runner(
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "AudioActivityCalculator"
+        input_stream: "TENSORS:tensors"
+        output_stream: "ACTIVE:active"
+        options {
+          [mediapipe.AudioActivityCalculatorOptions.ext] { min_rms_dbfs: -40 }
+        }
+      )pb"));
+  // The RMS level of a sine wave is its amplitude minus 3 dB.
+  const std::vector<float> amplitudes = {0.0f, 0.005f, 0.02f, 1.0f};
+  for (int i = 0; i < amplitudes.size(); ++i) {
+    runner.MutableInputs()->Tag("TENSORS").packets.push_back(
+        MakePacket<std::vector<Tensor>>(SineTensors(amplitudes[i]))
+            .At(Timestamp(i)));
+  }
+  MP_ASSERT_OK(runner.Run());
+  const auto& packets = runner.Outputs().Tag("ACTIVE").packets;
+  ASSERT_EQ(packets.size(), amplitudes.size());
+  EXPECT_FALSE(packets[0].Get<bool>());
+  EXPECT_FALSE(packets[1].Get<bool>());
+  EXPECT_TRUE(packets[2].Get<bool>());
+  EXPECT_TRUE(packets[3].Get<bool>());
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -14,12 +14,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "Eigen/Core"
+#include "Eigen/SparseCore"
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -34,6 +37,7 @@
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
 #include "mediapipe/framework/formats/time_series_header.pb.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/util/time_series_util.h"
@@ -46,6 +50,7 @@ namespace {
 using Options = ::mediapipe::AudioToTensorCalculatorOptions;
 using DftTensorFormat = Options::DftTensorFormat;
 using FlushMode = Options::FlushMode;
+using MelSpectrogramOptions = Options::MelSpectrogramOptions;
 
 std::vector<float> HannWindow(int window_size, bool sqrt_hann) {
   std::vector<float> hann_window(window_size);
@@ -75,6 +80,41 @@ bool IsValidFftSize(int size) {
   return factorization[0] >= 5 && n == 1;
 }
 
+// Returns the mel scale value of a frequency in hertz.
+double HertzToMel(double hertz) { return 1127.0 * std::log1p(hertz / 700.0); }
+
+// Returns the weights of triangular mel bands, spaced evenly on the mel scale
+// and overlapping by half, over the fft_size / 2 + 1 magnitudes of a real fft.
+// Each fft bin contributes to at most two bands, so the matrix is sparse.
+Eigen::SparseMatrix<float, Eigen::RowMajor> MelWeights(
+    const MelSpectrogramOptions& options, double sample_rate) {
+  const int num_mel_bins = options.num_mel_bins();
+  const int num_fft_bins = options.fft_size() / 2 + 1;
+  const double min_mel = HertzToMel(options.min_frequency_hertz());
+  const double mel_step =
+      (HertzToMel(options.max_frequency_hertz()) - min_mel) /
+      (num_mel_bins + 1);
+  std::vector<Eigen::Triplet<float>> weights;
+  for (int bin = 0; bin < num_fft_bins; ++bin) {
+    // Band b spans positions b to b + 2, with its peak at b + 1.
+    const double position =
+        (HertzToMel(bin * sample_rate / options.fft_size()) - min_mel) /
+        mel_step;
+    const int last_band =
+        std::min(num_mel_bins - 1, static_cast<int>(std::floor(position)));
+    for (int band = std::max(0, last_band - 1); band <= last_band; ++band) {
+      const double weight = 1.0 - std::abs(position - (band + 1));
+      if (weight > 0.0) {
+        weights.emplace_back(band, bin, weight);
+      }
+    }
+  }
+  Eigen::SparseMatrix<float, Eigen::RowMajor> mel_weights(num_mel_bins,
+                                                          num_fft_bins);
+  mel_weights.setFromTriplets(weights.begin(), weights.end());
+  return mel_weights;
+}
+
 }  // namespace
 
 // Converts audio buffers into tensors, possibly with resampling, buffering
@@ -90,6 +130,14 @@ bool IsValidFftSize(int size) {
 // fft on the fixed-sized audio frames, the complex DFT results will be
 // converted to and outputted as 2D MediaPipe float Tensors where the first
 // rows are the DFT real parts and the second rows are the DFT imagery parts.
+// When mel_spectrogram is set instead, the calculator computes the log mel
+// spectrogram of each mono audio frame in a single step: it windows
+// overlapping spectrogram frames, applies the fft, sums the fft magnitudes
+// into mel bands and takes their stabilized log. The result is written straight
+// into a 2D float Tensor with one row of num_mel_bins values per spectrogram
+// frame, which can be the input tensor of an audio model. This replaces a
+// SpectrogramCalculator, MelSpectrumCalculator and StabilizedLogCalculator
+// chain, without a Matrix packet between each step.
 //
 // This calculator assumes that the input timestamps refer to the first
 // sample in each Matrix. The output timestamps follow this same convention.
@@ -202,7 +250,18 @@ class AudioToTensorCalculator : public Node {
   audio_dsp::QResamplerParams params_;
   // A QResampler instance to resample an audio stream.
   std::unique_ptr<audio_dsp::QResampler<float>> resampler_;
+  // Buffers the samples of the stream mode. Only the columns in
+  // [sample_buffer_begin_, sample_buffer_end_) are yet to be processed. The
+  // buffer is compacted only when an append would overflow it, and the
+  // buffered samples stay contiguous so that frames are copied into the
+  // tensors directly.
   Matrix sample_buffer_;
+  int sample_buffer_begin_ = 0;
+  int sample_buffer_end_ = 0;
+  // The number of samples removed from the front of the stream so far.
+  int64_t num_consumed_samples_ = 0;
+  // The number of buffer columns that the last ProcessBuffer call is done
+  // with.
   int processed_buffer_cols_ = 0;
   double gain_ = 1.0;
 
@@ -215,20 +274,44 @@ class AudioToTensorCalculator : public Node {
   std::vector<float, Eigen::aligned_allocator<float>> fft_workplace_;
   std::vector<float, Eigen::aligned_allocator<float>> fft_output_;
 
+  // Whether to output log mel spectrogram tensors.
+  bool mel_spectrogram_ = false;
+  MelSpectrogramOptions mel_options_;
+  // The number of spectrogram frames in each audio frame.
+  int num_mel_frames_ = 0;
+  Eigen::SparseMatrix<float, Eigen::RowMajor> mel_weights_;
+  Eigen::VectorXf fft_magnitudes_;
+  // The log mel spectrogram frames of the last output tensor, which are
+  // reused by the next tensor where the two tensors overlap.
+  Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      previous_log_mel_;
+  // The index of the first sample of the last output tensor, or -1 if none.
+  int64_t previous_log_mel_first_sample_ = -1;
+
+  // Provides the CPU buffers of the output tensors, if available.
+  ServiceBinding<TensorPool> tensor_pool_;
+
   absl::Status ProcessStreamingData(CalculatorContext* cc, const Matrix& input);
   absl::Status ProcessNonStreamingData(CalculatorContext* cc,
                                        const Matrix& input);
 
   absl::Status SetupStreamingResampler(double input_sample_rate_);
-  void AppendToSampleBuffer(Matrix buffer_to_append);
+  absl::Status SetupMelSpectrogram(const MelSpectrogramOptions& options);
+  void ReserveSampleBuffer(int num_samples);
+  void AppendToSampleBuffer(const Eigen::Ref<const Matrix>& buffer_to_append);
   void AppendZerosToSampleBuffer(int num_samples);
+  Eigen::Ref<const Matrix> BufferedSamples() const;
 
+  Tensor CreateTensor(const std::vector<int>& tensor_dims);
   absl::StatusOr<std::vector<Tensor>> ConvertToTensor(
-      const Matrix& block, std::vector<int> tensor_dims);
-  absl::Status OutputTensor(const Matrix& block, Timestamp timestamp,
+      const Eigen::Ref<const Matrix>& block, std::vector<int> tensor_dims);
+  absl::StatusOr<std::vector<Tensor>> ConvertToLogMelSpectrogramTensor(
+      const Eigen::Ref<const Matrix>& block, int64_t first_sample_index);
+  absl::Status OutputTensor(const Eigen::Ref<const Matrix>& block,
+                            int64_t first_sample_index, Timestamp timestamp,
                             CalculatorContext* cc);
-  absl::Status ProcessBuffer(const Matrix& buffer, bool should_flush,
-                             CalculatorContext* cc);
+  absl::Status ProcessBuffer(const Eigen::Ref<const Matrix>& buffer,
+                             bool should_flush, CalculatorContext* cc);
 };
 
 absl::Status AudioToTensorCalculator::UpdateContract(CalculatorContract* cc) {
@@ -255,12 +338,14 @@ absl::Status AudioToTensorCalculator::UpdateContract(CalculatorContract* cc) {
       options.flush_mode() != Options::PROCEED_AS_USUAL) {
     return absl::InvalidArgumentError("Unsupported flush mode");
   }
+  cc->UseService(kTensorPoolService).Optional();
   return absl::OkStatus();
 }
 
 absl::Status AudioToTensorCalculator::Open(CalculatorContext* cc) {
   const auto& options =
       cc->Options<mediapipe::AudioToTensorCalculatorOptions>();
+  tensor_pool_ = cc->Service(kTensorPoolService);
   num_channels_ = options.num_channels();
   num_samples_ = options.num_samples();
   if (options.has_num_overlapping_samples()) {
@@ -321,6 +406,11 @@ absl::Status AudioToTensorCalculator::Open(CalculatorContext* cc) {
         << "The DC_AND_NYQUIST output stream can only be connected when the "
            "calculator outputs fft tensors";
   }
+  if (options.has_mel_spectrogram()) {
+    RET_CHECK(!options.has_fft_size())
+        << "fft_size and mel_spectrogram cannot both be set.";
+    MP_RETURN_IF_ERROR(SetupMelSpectrogram(options.mel_spectrogram()));
+  }
   return absl::OkStatus();
 }
 
@@ -362,18 +452,19 @@ absl::Status AudioToTensorCalculator::Process(CalculatorContext* cc) {
 }
 
 absl::Status AudioToTensorCalculator::Close(CalculatorContext* cc) {
-  if (!stream_mode_) {
-    return absl::OkStatus();
-  }
-  if (resampler_) {
-    Matrix resampled_buffer(num_channels_, 0);
-    resampler_->Flush(&resampled_buffer);
-    AppendToSampleBuffer(std::move(resampled_buffer));
+  if (stream_mode_) {
+    if (resampler_) {
+      Matrix resampled_buffer(num_channels_, 0);
+      resampler_->Flush(&resampled_buffer);
+      AppendToSampleBuffer(resampled_buffer);
+    }
+    AppendZerosToSampleBuffer(padding_samples_after_);
+    MP_RETURN_IF_ERROR(
+        ProcessBuffer(BufferedSamples(), /*should_flush=*/true, cc));
   }
-  AppendZerosToSampleBuffer(padding_samples_after_);
-  MP_RETURN_IF_ERROR(ProcessBuffer(sample_buffer_, /*should_flush=*/true, cc));
   if (fft_state_) {
     pffft_destroy_setup(fft_state_);
+    fft_state_ = nullptr;
   }
   return absl::OkStatus();
 }
@@ -403,23 +494,16 @@ absl::Status AudioToTensorCalculator::ProcessStreamingData(
   if (resampler_) {
     Matrix resampled_buffer(num_channels_, 0);
     resampler_->ProcessSamples(input_buffer, &resampled_buffer);
-    AppendToSampleBuffer(std::move(resampled_buffer));
+    AppendToSampleBuffer(resampled_buffer);
   } else {
-    // Tries to consume the input matrix first to avoid extra data copy.
-    auto status_or_matrix = kAudioIn(cc).packet().Consume<Matrix>();
-    if (status_or_matrix.ok()) {
-      Matrix local_matrix(num_channels_, 0);
-      local_matrix.swap(*status_or_matrix.value());
-      AppendToSampleBuffer(std::move(local_matrix));
-    } else {
-      AppendToSampleBuffer(input_buffer);
-    }
+    AppendToSampleBuffer(input_buffer);
   }
 
-  MP_RETURN_IF_ERROR(ProcessBuffer(sample_buffer_, /*should_flush=*/false, cc));
-  // Removes the processed samples from the global sample buffer.
-  sample_buffer_ = Matrix(sample_buffer_.rightCols(sample_buffer_.cols() -
-                                                   processed_buffer_cols_ - 1));
+  MP_RETURN_IF_ERROR(
+      ProcessBuffer(BufferedSamples(), /*should_flush=*/false, cc));
+  // Drops the processed samples without moving the remaining ones.
+  sample_buffer_begin_ += processed_buffer_cols_;
+  num_consumed_samples_ += processed_buffer_cols_;
   return absl::OkStatus();
 }
 
@@ -427,6 +511,8 @@ absl::Status AudioToTensorCalculator::ProcessNonStreamingData(
     CalculatorContext* cc, const Matrix& input) {
   initial_timestamp_ = cc->InputTimestamp();
   next_output_timestamp_ = initial_timestamp_;
+  // Each input is processed on its own, so no spectrogram frames are shared.
+  previous_log_mel_first_sample_ = -1;
   const auto& input_frame = input;
   double source_sample_rate = kAudioSampleRateIn(cc).GetOr(source_sample_rate_);
 
@@ -457,25 +543,101 @@ absl::Status AudioToTensorCalculator::SetupStreamingResampler(
   return absl::OkStatus();
 }
 
+absl::Status AudioToTensorCalculator::SetupMelSpectrogram(
+    const MelSpectrogramOptions& options) {
+  RET_CHECK_EQ(1, num_channels_)
+      << "Currently only support computing mel spectrograms of mono channel.";
+  RET_CHECK_GT(options.frame_length(), 0);
+  RET_CHECK_LE(options.frame_length(), num_samples_);
+  RET_CHECK_GT(options.frame_step(), 0);
+  RET_CHECK(IsValidFftSize(options.fft_size()))
+      << "FFT size must be of the form fft_size = (2^a)*(3^b)*(5^c) where b "
+         ">=0 and c >= 0 and a >= 5, the requested fft size is "
+      << options.fft_size();
+  RET_CHECK_GE(options.fft_size(), options.frame_length());
+  RET_CHECK_GT(options.num_mel_bins(), 0);
+  RET_CHECK_GE(options.min_frequency_hertz(), 0.0f);
+  RET_CHECK_LT(options.min_frequency_hertz(), options.max_frequency_hertz());
+  RET_CHECK_LE(options.max_frequency_hertz(), target_sample_rate_ / 2);
+  mel_spectrogram_ = true;
+  mel_options_ = options;
+  num_mel_frames_ =
+      1 + (num_samples_ - options.frame_length()) / options.frame_step();
+  fft_size_ = options.fft_size();
+  fft_state_ = pffft_new_setup(fft_size_, PFFFT_REAL);
+  fft_window_ = HannWindow(options.frame_length(), /* sqrt_hann = */ false);
+  // The samples after frame_length are the zero padding, and stay zero.
+  fft_input_buffer_.assign(fft_size_, 0.0f);
+  fft_workplace_.resize(fft_size_);
+  fft_output_.resize(fft_size_);
+  fft_magnitudes_.resize(fft_size_ / 2 + 1);
+  mel_weights_ = MelWeights(options, target_sample_rate_);
+  return absl::OkStatus();
+}
+
+void AudioToTensorCalculator::ReserveSampleBuffer(int num_samples) {
+  if (sample_buffer_end_ + num_samples <= sample_buffer_.cols()) {
+    return;
+  }
+  const int num_buffered_samples = sample_buffer_end_ - sample_buffer_begin_;
+  if (sample_buffer_begin_ > 0) {
+    // The columns of a column-major matrix are contiguous, so the buffered
+    // samples are moved to the front at once.
+    std::memmove(sample_buffer_.data(),
+                 sample_buffer_.data() +
+                     static_cast<size_t>(sample_buffer_begin_) *
+                         sample_buffer_.rows(),
+                 static_cast<size_t>(num_buffered_samples) *
+                     sample_buffer_.rows() * sizeof(float));
+    sample_buffer_begin_ = 0;
+    sample_buffer_end_ = num_buffered_samples;
+  }
+  if (sample_buffer_end_ + num_samples > sample_buffer_.cols()) {
+    sample_buffer_.conservativeResize(
+        Eigen::NoChange,
+        std::max<int>(sample_buffer_end_ + num_samples,
+                      2 * sample_buffer_.cols()));
+  }
+}
+
 void AudioToTensorCalculator::AppendZerosToSampleBuffer(int num_samples) {
   ABSL_CHECK_GE(num_samples, 0);  // Ensured by `UpdateContract`.
   if (num_samples == 0) {
     return;
   }
-  sample_buffer_.conservativeResize(Eigen::NoChange,
-                                    sample_buffer_.cols() + num_samples);
-  sample_buffer_.rightCols(num_samples).setZero();
+  ReserveSampleBuffer(num_samples);
+  sample_buffer_.middleCols(sample_buffer_end_, num_samples).setZero();
+  sample_buffer_end_ += num_samples;
+}
+
+void AudioToTensorCalculator::AppendToSampleBuffer(
+    const Eigen::Ref<const Matrix>& buffer_to_append) {
+  const int num_samples = buffer_to_append.cols();
+  ReserveSampleBuffer(num_samples);
+  sample_buffer_.middleCols(sample_buffer_end_, num_samples) =
+      buffer_to_append;
+  sample_buffer_end_ += num_samples;
+}
+
+Eigen::Ref<const Matrix> AudioToTensorCalculator::BufferedSamples() const {
+  return sample_buffer_.middleCols(sample_buffer_begin_,
+                                   sample_buffer_end_ - sample_buffer_begin_);
 }
 
-void AudioToTensorCalculator::AppendToSampleBuffer(Matrix buffer_to_append) {
-  sample_buffer_.conservativeResize(
-      Eigen::NoChange, sample_buffer_.cols() + buffer_to_append.cols());
-  sample_buffer_.rightCols(buffer_to_append.cols()).swap(buffer_to_append);
+Tensor AudioToTensorCalculator::CreateTensor(
+    const std::vector<int>& tensor_dims) {
+  return tensor_pool_.IsAvailable()
+             ? tensor_pool_.GetObject().GetTensor(Tensor::ElementType::kFloat32,
+                                                  Tensor::Shape(tensor_dims))
+             : Tensor(Tensor::ElementType::kFloat32,
+                      Tensor::Shape(tensor_dims));
 }
 
 absl::StatusOr<std::vector<Tensor>> AudioToTensorCalculator::ConvertToTensor(
-    const Matrix& block, std::vector<int> tensor_dims) {
-  Tensor tensor(Tensor::ElementType::kFloat32, Tensor::Shape(tensor_dims));
+    const Eigen::Ref<const Matrix>& block, std::vector<int> tensor_dims) {
+  // The block is copied at once, so its columns must be contiguous.
+  ABSL_DCHECK_EQ(block.outerStride(), block.rows());
+  Tensor tensor = CreateTensor(tensor_dims);
   auto buffer_view = tensor.GetCpuWriteView();
   int total_size = 1;
   for (int dim : tensor_dims) {
@@ -491,17 +653,86 @@ absl::StatusOr<std::vector<Tensor>> AudioToTensorCalculator::ConvertToTensor(
   return tensor_vector;
 }
 
-absl::Status AudioToTensorCalculator::OutputTensor(const Matrix& block,
-                                                   Timestamp timestamp,
-                                                   CalculatorContext* cc) {
+absl::StatusOr<std::vector<Tensor>>
+AudioToTensorCalculator::ConvertToLogMelSpectrogramTensor(
+    const Eigen::Ref<const Matrix>& block, int64_t first_sample_index) {
+  const int frame_length = mel_options_.frame_length();
+  const int frame_step = mel_options_.frame_step();
+  const int num_mel_bins = mel_options_.num_mel_bins();
+  const int nyquist_bin = fft_size_ / 2;
+  Tensor tensor = CreateTensor({num_mel_frames_, num_mel_bins});
+  {
+    auto buffer_view = tensor.GetCpuWriteView();
+    float* output = buffer_view.buffer<float>();
+    for (int frame = 0; frame < num_mel_frames_; ++frame) {
+      Eigen::Map<Eigen::VectorXf> mel_frame(output + frame * num_mel_bins,
+                                            num_mel_bins);
+      const int start = frame * frame_step;
+      // Overlapping tensors share the spectrogram frames at the same stream
+      // positions, which are computed only once.
+      if (previous_log_mel_first_sample_ >= 0) {
+        const int64_t offset =
+            first_sample_index + start - previous_log_mel_first_sample_;
+        if (offset >= 0 && offset % frame_step == 0 &&
+            offset / frame_step < num_mel_frames_) {
+          mel_frame = previous_log_mel_.row(offset / frame_step).transpose();
+          continue;
+        }
+      }
+      // The last block of a flush may be short, so zero pad the frame.
+      const int num_frame_samples =
+          std::clamp(static_cast<int>(block.cols()) - start, 0, frame_length);
+      //  Window on input audio prior to FFT.
+      std::transform(block.data() + start,
+                     block.data() + start + num_frame_samples,
+                     fft_window_.begin(), fft_input_buffer_.begin(),
+                     std::multiplies<float>());
+      std::fill(fft_input_buffer_.begin() + num_frame_samples,
+                fft_input_buffer_.begin() + frame_length, 0.0f);
+      pffft_transform_ordered(fft_state_, fft_input_buffer_.data(),
+                              fft_output_.data(), fft_workplace_.data(),
+                              PFFFT_FORWARD);
+      // The ordered output starts with the real dc and nyquist components,
+      // followed by the interleaved real and imaginary parts of the others.
+      fft_magnitudes_(0) = std::abs(fft_output_[0]);
+      fft_magnitudes_(nyquist_bin) = std::abs(fft_output_[1]);
+      Eigen::Map<const Eigen::ArrayXf, 0, Eigen::InnerStride<2>> real(
+          fft_output_.data() + 2, nyquist_bin - 1);
+      Eigen::Map<const Eigen::ArrayXf, 0, Eigen::InnerStride<2>> imaginary(
+          fft_output_.data() + 3, nyquist_bin - 1);
+      fft_magnitudes_.segment(1, nyquist_bin - 1) =
+          (real.square() + imaginary.square()).sqrt().matrix();
+      mel_frame.noalias() = mel_weights_ * fft_magnitudes_;
+      mel_frame.array() = (mel_frame.array() + mel_options_.stabilizer()).log();
+    }
+    previous_log_mel_ = Eigen::Map<const Eigen::Matrix<
+        float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+        output, num_mel_frames_, num_mel_bins);
+    previous_log_mel_first_sample_ = first_sample_index;
+  }
+  std::vector<Tensor> tensor_vector;
+  tensor_vector.push_back(std::move(tensor));
+  return tensor_vector;
+}
+
+absl::Status AudioToTensorCalculator::OutputTensor(
+    const Eigen::Ref<const Matrix>& block, int64_t first_sample_index,
+    Timestamp timestamp, CalculatorContext* cc) {
   std::vector<Tensor> output_tensor;
-  if (fft_state_) {
-    Eigen::VectorXf time_series_data =
-        Eigen::VectorXf::Map(block.data(), block.size());
-    //  Window on input audio prior to FFT.
-    std::transform(time_series_data.begin(), time_series_data.end(),
+  if (mel_spectrogram_) {
+    ASSIGN_OR_RETURN(
+        output_tensor,
+        ConvertToLogMelSpectrogramTensor(block, first_sample_index));
+  } else if (fft_state_) {
+    //  Window on input audio prior to FFT. A short block of a flush is zero
+    //  padded.
+    const int num_fft_samples =
+        std::min(static_cast<int>(block.size()), fft_size_);
+    std::transform(block.data(), block.data() + num_fft_samples,
                    fft_window_.begin(), fft_input_buffer_.begin(),
                    std::multiplies<float>());
+    std::fill(fft_input_buffer_.begin() + num_fft_samples,
+              fft_input_buffer_.end(), 0.0f);
     pffft_transform_ordered(fft_state_, fft_input_buffer_.data(),
                             fft_output_.data(), fft_workplace_.data(),
                             PFFFT_FORWARD);
@@ -554,9 +785,11 @@ absl::Status AudioToTensorCalculator::OutputTensor(const Matrix& block,
   return absl::OkStatus();
 }
 
-absl::Status AudioToTensorCalculator::ProcessBuffer(const Matrix& buffer,
-                                                    bool should_flush,
-                                                    CalculatorContext* cc) {
+absl::Status AudioToTensorCalculator::ProcessBuffer(
+    const Eigen::Ref<const Matrix>& buffer, bool should_flush,
+    CalculatorContext* cc) {
+  // The stream position of the first buffered sample.
+  const int64_t first_sample_index = stream_mode_ ? num_consumed_samples_ : 0;
   const bool should_flush_at_timestamp_max =
       stream_mode_ && should_flush &&
       flush_mode_ == Options::ENTIRE_TAIL_AT_TIMESTAMP_MAX;
@@ -566,7 +799,8 @@ absl::Status AudioToTensorCalculator::ProcessBuffer(const Matrix& buffer,
     while (next_frame_first_col + num_samples_ <= buffer.cols()) {
       MP_RETURN_IF_ERROR(OutputTensor(
           buffer.block(0, next_frame_first_col, num_channels_, num_samples_),
-          next_output_timestamp_, cc));
+          first_sample_index + next_frame_first_col, next_output_timestamp_,
+          cc));
       timestamps.push_back(next_output_timestamp_);
       next_output_timestamp_ += round(frame_step_ / target_sample_rate_ *
                                       Timestamp::kTimestampUnitsPerSecond);
@@ -584,14 +818,14 @@ absl::Status AudioToTensorCalculator::ProcessBuffer(const Matrix& buffer,
         buffer.block(
             0, next_frame_first_col, num_channels_,
             std::min(num_samples_, (int)buffer.cols() - next_frame_first_col)),
-        timestamp, cc));
+        first_sample_index + next_frame_first_col, timestamp, cc));
     timestamps.push_back(timestamp);
   }
   if (kTimestampsOut(cc).IsConnected()) {
     Timestamp timestamp = timestamps.back();
     kTimestampsOut(cc).Send(std::move(timestamps), timestamp);
   }
-  processed_buffer_cols_ = next_frame_first_col - 1;
+  processed_buffer_cols_ = next_frame_first_col;
   return absl::OkStatus();
 }
 
@@ -12,10 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "Eigen/Core"
 #include "absl/strings/substitute.h"
 #include "audio/dsp/resampler_q.h"
 #include "mediapipe/calculators/tensor/audio_to_tensor_calculator.pb.h"
@@ -664,5 +666,212 @@ TEST_F(AudioToTensorCalculatorFftTest, TestImpulseSignal) {
   CloseGraph();
 }
 
+class AudioToTensorCalculatorMelSpectrogramTest : public ::testing::Test {
+ protected:
+  // Runs a 16 kHz mono signal of 1600 samples through the calculator, which
+  // outputs 8 log mel spectrogram frames of 64 mel bins.
+  void RunGraph(const Matrix& input_data) {
+    CalculatorGraphConfig graph_config =
+        ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+          input_stream: "audio"
+          input_stream: "sample_rate"
+          output_stream: "tensors"
+          node {
+            calculator: "AudioToTensorCalculator"
+            input_stream: "AUDIO:audio"
+            input_stream: "SAMPLE_RATE:sample_rate"
+            output_stream: "TENSORS:tensors"
+            options {
+              [mediapipe.AudioToTensorCalculatorOptions.ext] {
+                num_channels: 1
+                num_samples: 1600
+                target_sample_rate: 16000
+                stream_mode: false
+                mel_spectrogram {
+                  frame_length: 400
+                  frame_step: 160
+                  fft_size: 512
+                  num_mel_bins: 64
+                  min_frequency_hertz: 125
+                  max_frequency_hertz: 7500
+                  stabilizer: 0.001
+                }
+              }
+            }
+          }
+        )pb");
+    tool::AddVectorSink("tensors", &graph_config, &tensors_packets_);
+    MP_ASSERT_OK(graph_.Initialize(graph_config));
+    MP_ASSERT_OK(graph_.StartRun({}));
+    MP_ASSERT_OK(graph_.AddPacketToInputStream(
+        "sample_rate", MakePacket<double>(16000).At(Timestamp(0))));
+    MP_ASSERT_OK(graph_.AddPacketToInputStream(
+        "audio", MakePacket<Matrix>(input_data).At(Timestamp(0))));
+    MP_ASSERT_OK(graph_.CloseAllInputStreams());
+    MP_ASSERT_OK(graph_.WaitUntilIdle());
+    ASSERT_EQ(tensors_packets_.size(), 1);
+  }
+
+  // Returns the output log mel spectrogram as a matrix of one row per frame.
+  Eigen::MatrixXf GetLogMelSpectrogram() {
+    const Tensor& tensor = tensors_packets_[0].Get<std::vector<Tensor>>()[0];
+    EXPECT_EQ(tensor.shape().dims, std::vector<int>({8, 64}));
+    auto view = tensor.GetCpuReadView();
+    return Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic,
+                                          Eigen::RowMajor>>(
+        view.buffer<float>(), 8, 64);
+  }
+
+  // Fully close graph at end, otherwise calculator+tensors are destroyed
+  // after calling WaitUntilDone().
+  void CloseGraph() { MP_EXPECT_OK(graph_.WaitUntilDone()); }
+
+  std::vector<Packet> tensors_packets_;
+  CalculatorGraph graph_;
+};
+
+TEST_F(AudioToTensorCalculatorMelSpectrogramTest, Silence) {
+  RunGraph(Matrix::Zero(1, 1600));
+  Eigen::MatrixXf log_mel_spectrogram = GetLogMelSpectrogram();
+  for (int i = 0; i < log_mel_spectrogram.size(); ++i) {
+    EXPECT_FLOAT_EQ(log_mel_spectrogram(i), std::log(0.001f));
+  }
+  CloseGraph();
+}
+
+TEST_F(AudioToTensorCalculatorMelSpectrogramTest, PureTone) {
+  // A 1 kHz tone, which is between the edges of mel bins 19 and 20.
+  Matrix tone(1, 1600);
+  for (int i = 0; i < tone.cols(); ++i) {
+    tone(0, i) = std::sin(2 * M_PI * 1000 * i / 16000.0);
+  }
+  RunGraph(tone);
+  Eigen::MatrixXf log_mel_spectrogram = GetLogMelSpectrogram();
+  for (int frame = 0; frame < log_mel_spectrogram.rows(); ++frame) {
+    int loudest_bin;
+    log_mel_spectrogram.row(frame).maxCoeff(&loudest_bin);
+    EXPECT_THAT(loudest_bin, ::testing::AnyOf(19, 20));
+    EXPECT_LT(log_mel_spectrogram(frame, 0), log_mel_spectrogram(frame, 19));
+    EXPECT_LT(log_mel_spectrogram(frame, 63), log_mel_spectrogram(frame, 19));
+  }
+  CloseGraph();
+}
+
+TEST_F(AudioToTensorCalculatorMelSpectrogramTest,
+       StreamingOverlappingFramesMatchNonStreaming) {
+  // Every other 100 ms window starts half way into the previous window, which
+  // shares the spectrogram frames of the overlapping 50 ms.
+  Matrix chirp(1, 4000);
+  for (int i = 0; i < chirp.cols(); ++i) {
+    chirp(0, i) = std::sin(2 * M_PI * (200 + 0.5 * i) * i / 16000.0);
+  }
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "audio"
+        output_stream: "tensors"
+        node {
+          calculator: "AudioToTensorCalculator"
+          input_stream: "AUDIO:audio"
+          output_stream: "TENSORS:tensors"
+          options {
+            [mediapipe.AudioToTensorCalculatorOptions.ext] {
+              num_channels: 1
+              num_samples: 1600
+              num_overlapping_samples: 800
+              target_sample_rate: 16000
+              source_sample_rate: 16000
+              stream_mode: true
+              mel_spectrogram {
+                frame_length: 400
+                frame_step: 160
+                fft_size: 512
+              }
+            }
+          }
+        }
+      )pb");
+  // Computes each window on its own as the reference.
+  CalculatorGraphConfig non_streaming_config = graph_config;
+  non_streaming_config.mutable_node(0)
+      ->mutable_options()
+      ->MutableExtension(AudioToTensorCalculatorOptions::ext)
+      ->set_stream_mode(false);
+  tool::AddVectorSink("tensors", &non_streaming_config, &tensors_packets_);
+  MP_ASSERT_OK(graph_.Initialize(non_streaming_config));
+  MP_ASSERT_OK(graph_.StartRun({}));
+  for (int window = 0; window < 4; ++window) {
+    MP_ASSERT_OK(graph_.AddPacketToInputStream(
+        "audio", MakePacket<Matrix>(chirp.middleCols(window * 800, 1600))
+                     .At(Timestamp(window))));
+  }
+  MP_ASSERT_OK(graph_.CloseAllInputStreams());
+  MP_ASSERT_OK(graph_.WaitUntilDone());
+  ASSERT_EQ(tensors_packets_.size(), 4);
+
+  std::vector<Packet> streaming_packets;
+  tool::AddVectorSink("tensors", &graph_config, &streaming_packets);
+  CalculatorGraph streaming_graph;
+  MP_ASSERT_OK(streaming_graph.Initialize(graph_config));
+  MP_ASSERT_OK(streaming_graph.StartRun({}));
+  // Packets that are not multiples of the window step exercise the buffer.
+  for (int i = 0; i < chirp.cols(); i += 250) {
+    MP_ASSERT_OK(streaming_graph.AddPacketToInputStream(
+        "audio", MakePacket<Matrix>(chirp.middleCols(i, 250))
+                     .At(Timestamp(i * Timestamp::kTimestampUnitsPerSecond /
+                                   16000))));
+  }
+  MP_ASSERT_OK(streaming_graph.CloseAllInputStreams());
+  MP_ASSERT_OK(streaming_graph.WaitUntilDone());
+  ASSERT_GE(streaming_packets.size(), 4);
+
+  using RowMajorMatrix =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  for (int window = 0; window < 4; ++window) {
+    auto expected_view = tensors_packets_[window]
+                             .Get<std::vector<Tensor>>()[0]
+                             .GetCpuReadView();
+    auto actual_view = streaming_packets[window]
+                           .Get<std::vector<Tensor>>()[0]
+                           .GetCpuReadView();
+    Eigen::Map<const RowMajorMatrix> expected(
+        expected_view.buffer<float>(), 8, 64);
+    Eigen::Map<const RowMajorMatrix> actual(actual_view.buffer<float>(), 8,
+                                            64);
+    EXPECT_TRUE(actual.isApprox(expected, 1e-5f)) << "window " << window;
+  }
+}
+
+TEST_F(AudioToTensorCalculatorMelSpectrogramTest, FftSizeAlsoSetIsInvalid) {
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "audio"
+        output_stream: "tensors"
+        node {
+          calculator: "AudioToTensorCalculator"
+          input_stream: "AUDIO:audio"
+          output_stream: "TENSORS:tensors"
+          options {
+            [mediapipe.AudioToTensorCalculatorOptions.ext] {
+              num_channels: 1
+              num_samples: 1600
+              target_sample_rate: 16000
+              source_sample_rate: 16000
+              fft_size: 512
+              mel_spectrogram {
+                frame_length: 400
+                frame_step: 160
+                fft_size: 512
+              }
+            }
+          }
+        }
+      )pb");
+  MP_ASSERT_OK(graph_.Initialize(graph_config));
+  MP_ASSERT_OK(graph_.StartRun({}));
+  auto status = graph_.WaitUntilIdle();
+  EXPECT_EQ(status.code(), absl::StatusCode::kInternal);
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("cannot both be set"));
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -0,0 +1,216 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/batching_inference_runner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator_context.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+
+namespace mediapipe {
+
+namespace {
+
+// A Run() call waiting for its batch to complete.
+struct Request {
+  const std::vector<Tensor>* inputs;
+  absl::StatusOr<std::vector<Tensor>> result;
+  // Indicates that the request collects and runs the next batch.
+  bool is_leader = false;
+  // Indicates that the result is set.
+  bool done = false;
+};
+
+// Returns true if the inputs of two requests can be concatenated.
+bool CanBatch(const std::vector<Tensor>& a, const std::vector<Tensor>& b) {
+  if (a.size() != b.size()) return false;
+  for (int i = 0; i < a.size(); ++i) {
+    const std::vector<int>& a_dims = a[i].shape().dims;
+    const std::vector<int>& b_dims = b[i].shape().dims;
+    if (a[i].element_type() != b[i].element_type() || a_dims.empty() ||
+        a_dims.size() != b_dims.size() ||
+        !std::equal(a_dims.begin() + 1, a_dims.end(), b_dims.begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the input tensors of a batch concatenated along the batch
+// dimension.
+absl::StatusOr<std::vector<Tensor>> ConcatenateInputs(
+    const std::vector<Request*>& batch) {
+  const std::vector<Tensor>& first = *batch.front()->inputs;
+  std::vector<Tensor> result;
+  result.reserve(first.size());
+  for (int i = 0; i < first.size(); ++i) {
+    RET_CHECK(first[i].element_type() != Tensor::ElementType::kChar)
+        << "String input tensors cannot be batched.";
+    RET_CHECK(!first[i].shape().dims.empty())
+        << "Input tensor " << i << " has no batch dimension.";
+    Tensor::Shape shape = first[i].shape();
+    shape.dims[0] = 0;
+    for (const Request* request : batch) {
+      shape.dims[0] += (*request->inputs)[i].shape().dims[0];
+    }
+    // Resizes the interpreter to the batch.
+    shape.is_dynamic = true;
+    Tensor& tensor = result.emplace_back(first[i].element_type(), shape,
+                                         first[i].quantization_parameters());
+    auto view = tensor.GetCpuWriteView();
+    char* buffer = view.buffer<char>();
+    for (const Request* request : batch) {
+      const Tensor& input = (*request->inputs)[i];
+      std::memcpy(buffer, input.GetCpuReadView().buffer<char>(),
+                  input.bytes());
+      buffer += input.bytes();
+    }
+  }
+  return result;
+}
+
+// Sets the result of each request of a batch to its rows of the batch outputs.
+absl::Status SplitOutputs(const std::vector<Tensor>& outputs,
+                          const std::vector<Request*>& batch) {
+  int batch_rows = 0;
+  for (const Request* request : batch) {
+    batch_rows += request->inputs->front().shape().dims[0];
+  }
+  std::vector<std::vector<Tensor>> results(batch.size());
+  for (const Tensor& output : outputs) {
+    RET_CHECK(!output.shape().dims.empty() &&
+              output.shape().dims[0] == batch_rows)
+        << "Output tensor has no batch dimension.";
+    auto view = output.GetCpuReadView();
+    const char* buffer = view.buffer<char>();
+    for (int i = 0; i < batch.size(); ++i) {
+      Tensor::Shape shape = output.shape();
+      shape.dims[0] = batch[i]->inputs->front().shape().dims[0];
+      Tensor& tensor = results[i].emplace_back(
+          output.element_type(), shape, output.quantization_parameters());
+      std::memcpy(tensor.GetCpuWriteView().buffer<char>(), buffer,
+                  tensor.bytes());
+      buffer += tensor.bytes();
+    }
+  }
+  for (int i = 0; i < batch.size(); ++i) {
+    batch[i]->result = std::move(results[i]);
+  }
+  return absl::OkStatus();
+}
+
+class BatchingInferenceRunner : public InferenceRunner {
+ public:
+  BatchingInferenceRunner(std::unique_ptr<InferenceRunner> runner,
+                          int max_batch_size, absl::Duration max_wait)
+      : runner_(std::move(runner)),
+        max_batch_size_(max_batch_size),
+        max_wait_(max_wait) {}
+
+  absl::StatusOr<std::vector<Tensor>> Run(
+      CalculatorContext* cc, const std::vector<Tensor>& inputs) override {
+    Request request;
+    request.inputs = &inputs;
+    std::vector<Request*> batch;
+    {
+      absl::MutexLock lock(&mutex_);
+      pending_.push_back(&request);
+      request.is_leader = pending_.size() == 1;
+      mutex_.Await(absl::Condition(
+          +[](Request* request) {
+            return request->is_leader || request->done;
+          },
+          &request));
+      if (request.done) {
+        return std::move(request.result);
+      }
+      mutex_.AwaitWithTimeout(
+          absl::Condition(this, &BatchingInferenceRunner::IsBatchFull),
+          max_wait_);
+      batch = TakeBatch();
+    }
+
+    // The leader runs the batch while the next batch is collected.
+    absl::StatusOr<std::vector<Tensor>> batch_inputs = ConcatenateInputs(batch);
+    absl::Status status = batch_inputs.status();
+    if (status.ok()) {
+      absl::StatusOr<std::vector<Tensor>> batch_outputs =
+          runner_->Run(cc, *batch_inputs);
+      status = batch_outputs.ok() ? SplitOutputs(*batch_outputs, batch)
+                                  : batch_outputs.status();
+    }
+    absl::MutexLock lock(&mutex_);
+    for (Request* member : batch) {
+      if (!status.ok()) member->result = status;
+      member->done = true;
+    }
+    return std::move(request.result);
+  }
+
+ private:
+  bool IsBatchFull() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return static_cast<int>(pending_.size()) >= max_batch_size_;
+  }
+
+  // Removes the leader and the requests that can be batched with it from the
+  // pending requests, and makes the oldest remaining request the next leader.
+  std::vector<Request*> TakeBatch() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    std::vector<Request*> batch = {pending_.front()};
+    std::deque<Request*> remaining;
+    for (auto it = pending_.begin() + 1; it != pending_.end(); ++it) {
+      if (static_cast<int>(batch.size()) < max_batch_size_ &&
+          CanBatch(*batch.front()->inputs, *(*it)->inputs)) {
+        batch.push_back(*it);
+      } else {
+        remaining.push_back(*it);
+      }
+    }
+    pending_ = std::move(remaining);
+    if (!pending_.empty()) {
+      pending_.front()->is_leader = true;
+    }
+    return batch;
+  }
+
+  const std::unique_ptr<InferenceRunner> runner_;
+  const int max_batch_size_;
+  const absl::Duration max_wait_;
+  absl::Mutex mutex_;
+  // The requests that are not yet in a batch, led by the first of them.
+  std::deque<Request*> pending_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+std::unique_ptr<InferenceRunner> CreateBatchingInferenceRunner(
+    std::unique_ptr<InferenceRunner> runner, int max_batch_size,
+    absl::Duration max_wait) {
+  return std::make_unique<BatchingInferenceRunner>(std::move(runner),
+                                                   max_batch_size, max_wait);
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,43 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_BATCHING_INFERENCE_RUNNER_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_BATCHING_INFERENCE_RUNNER_H_
+
+#include <memory>
+
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/inference_runner.h"
+
+namespace mediapipe {
+
+// Creates an inference runner that combines concurrent Run() calls into one
+// batched inference on `runner`. The first call of a batch waits up to
+// `max_wait` for up to `max_batch_size` calls in total, whose input tensors
+// have the same types and the same shapes apart from the first, batch
+// dimension. The input tensors of a batch are concatenated along the batch
+// dimension, and the output tensors are split back along it, so the model
+// must have a dynamic batch dimension.
+//
+// `runner` must allow concurrent Run() calls, as a runner pool does, since a
+// batch can be collected while the previous batch runs. The calls of a node
+// are concurrent only when it sets max_in_flight, which should be at least
+// `max_batch_size`.
+std::unique_ptr<InferenceRunner> CreateBatchingInferenceRunner(
+    std::unique_ptr<InferenceRunner> runner, int max_batch_size,
+    absl::Duration max_wait);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_BATCHING_INFERENCE_RUNNER_H_
@@ -0,0 +1,137 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/batching_inference_runner.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/port/threadpool.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
+
+// Doubles its input tensor, and records the batch size of each run. Runs may
+// be concurrent.
+class DoublingRunner : public InferenceRunner {
+ public:
+  explicit DoublingRunner(std::vector<int>* batch_sizes)
+      : batch_sizes_(batch_sizes) {}
+
+  absl::StatusOr<std::vector<Tensor>> Run(
+      CalculatorContext* cc, const std::vector<Tensor>& inputs) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      batch_sizes_->push_back(inputs[0].shape().dims[0]);
+    }
+    std::vector<Tensor> outputs;
+    outputs.emplace_back(Tensor::ElementType::kFloat32, inputs[0].shape());
+    auto input_view = inputs[0].GetCpuReadView();
+    auto output_view = outputs[0].GetCpuWriteView();
+    for (int i = 0; i < inputs[0].shape().num_elements(); ++i) {
+      output_view.buffer<float>()[i] = 2 * input_view.buffer<float>()[i];
+    }
+    return outputs;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::vector<int>* batch_sizes_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Returns an input with one row of `width` elements of `value`.
+std::vector<Tensor> MakeInput(float value, int width = 2) {
+  std::vector<Tensor> input;
+  input.emplace_back(Tensor::ElementType::kFloat32, Tensor::Shape{1, width});
+  auto view = input[0].GetCpuWriteView();
+  for (int i = 0; i < width; ++i) {
+    view.buffer<float>()[i] = value;
+  }
+  return input;
+}
+
+// Runs `runner` concurrently on each input, and returns the first element of
+// each output.
+std::vector<float> RunConcurrently(
+    InferenceRunner* runner, const std::vector<std::vector<Tensor>>& inputs) {
+  std::vector<float> results(inputs.size());
+  {
+    ThreadPool pool("batching_test", inputs.size());
+    pool.StartWorkers();
+    for (int i = 0; i < inputs.size(); ++i) {
+      pool.Schedule([runner, &inputs, &results, i] {
+        absl::StatusOr<std::vector<Tensor>> output =
+            runner->Run(/*cc=*/nullptr, inputs[i]);
+        ASSERT_TRUE(output.ok());
+        ASSERT_EQ(output->size(), 1);
+        EXPECT_EQ((*output)[0].shape().dims, inputs[i][0].shape().dims);
+        results[i] = (*output)[0].GetCpuReadView().buffer<float>()[0];
+      });
+    }
+  }
+  return results;
+}
+
+TEST(BatchingInferenceRunnerTest, BatchesConcurrentRuns) {
+  std::vector<int> batch_sizes;
+  auto runner = CreateBatchingInferenceRunner(
+      std::make_unique<DoublingRunner>(&batch_sizes), /*max_batch_size=*/4,
+      /*max_wait=*/absl::Seconds(10));
+  std::vector<std::vector<Tensor>> inputs;
+  for (int i = 0; i < 4; ++i) {
+    inputs.push_back(MakeInput(i));
+  }
+  EXPECT_THAT(RunConcurrently(runner.get(), inputs), ElementsAre(0, 2, 4, 6));
+  EXPECT_THAT(batch_sizes, ElementsAre(4));
+}
+
+TEST(BatchingInferenceRunnerTest, RunsPartialBatchAfterMaxWait) {
+  std::vector<int> batch_sizes;
+  auto runner = CreateBatchingInferenceRunner(
+      std::make_unique<DoublingRunner>(&batch_sizes), /*max_batch_size=*/4,
+      /*max_wait=*/absl::Milliseconds(10));
+  std::vector<Tensor> input = MakeInput(3);
+  MP_ASSERT_OK_AND_ASSIGN(std::vector<Tensor> output,
+                          runner->Run(/*cc=*/nullptr, input));
+  EXPECT_EQ(output[0].GetCpuReadView().buffer<float>()[0], 6);
+  EXPECT_THAT(batch_sizes, ElementsAre(1));
+}
+
+TEST(BatchingInferenceRunnerTest, BatchesOnlyMatchingShapes) {
+  std::vector<int> batch_sizes;
+  auto runner = CreateBatchingInferenceRunner(
+      std::make_unique<DoublingRunner>(&batch_sizes), /*max_batch_size=*/3,
+      /*max_wait=*/absl::Milliseconds(100));
+  std::vector<std::vector<Tensor>> inputs;
+  inputs.push_back(MakeInput(1, /*width=*/2));
+  inputs.push_back(MakeInput(2, /*width=*/3));
+  inputs.push_back(MakeInput(3, /*width=*/2));
+  EXPECT_THAT(RunConcurrently(runner.get(), inputs), ElementsAre(2, 4, 6));
+  EXPECT_EQ(batch_sizes.size(), 2);
+  EXPECT_THAT(batch_sizes, UnorderedElementsAre(1, 2));
+}
+
+}  // namespace
+}  // namespace mediapipe
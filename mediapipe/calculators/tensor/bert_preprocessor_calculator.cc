@@ -25,6 +25,7 @@
 #include "absl/strings/ascii.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/bert_preprocessor_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/api2/port.h"
@@ -91,7 +92,8 @@ constexpr absl::string_view kSeparatorToken = "[SEP]";
 //       (3): the input mask ids, which are 1 at each of the input token indices
 //            and 0 elsewhere.
 //     The Tensors will have size equal to the max sequence length for the BERT
-//     model.
+//     model, or if the model's input tensors are dynamic, to the number of
+//     tokens rounded up to a multiple of `seq_len_bucket_size`, if set.
 //
 // Example:
 // node {
@@ -130,16 +132,22 @@ class BertPreprocessorCalculator : public Node {
   int input_masks_tensor_index_ = 2;
   // Whether the model's input tensor shapes are dynamic.
   bool has_dynamic_input_tensors_ = false;
+  // The multiple that the size of dynamic input tensors is rounded up to.
+  int seq_len_bucket_size_ = 0;
 
-  // Applies `tokenizer_` to the `input_text` to generate a vector of tokens.
-  // This util prepends "[CLS]" and appends "[SEP]" to the input tokens and
-  // clips the vector of tokens to have length at most `bert_max_seq_len_` if
-  // the input tensors are static.
-  std::vector<std::string> TokenizeInputText(absl::string_view input_text);
-  // Processes the `input_tokens` to generate the three input tensors of size
-  // `tensor_size` for the BERT model.
-  std::vector<Tensor> GenerateInputTensors(
-      const std::vector<std::string>& input_tokens, int tensor_size);
+  // Ids of the "[CLS]" and "[SEP]" tokens.
+  int32_t classifier_token_id_ = 0;
+  int32_t separator_token_id_ = 0;
+  // Ids of the tokens of the input text if the input tensors are dynamic,
+  // reused across Process calls.
+  std::vector<int32_t> dynamic_input_ids_;
+
+  // Returns the three input tensors of size `tensor_size` for the BERT model,
+  // with the ids of `num_tokens` tokens already written into the ids tensor
+  // after the position of "[CLS]". Adds "[CLS]" and "[SEP]" around the tokens
+  // and fills the masks and segment ids.
+  std::vector<Tensor> CreateInputTensors(int tensor_size);
+  void FinishInputTensors(int num_tokens, std::vector<Tensor>& input_tensors);
 };
 
 absl::Status BertPreprocessorCalculator::UpdateContract(
@@ -164,6 +172,13 @@ absl::Status BertPreprocessorCalculator::Open(CalculatorContext* cc) {
   ASSIGN_OR_RETURN(tokenizer_,
                    tasks::text::tokenizers::CreateTokenizerFromProcessUnit(
                        tokenizer_metadata, metadata_extractor));
+  int id = 0;
+  if (tokenizer_->LookupId(kClassifierToken, &id)) {
+    classifier_token_id_ = id;
+  }
+  if (tokenizer_->LookupId(kSeparatorToken, &id)) {
+    separator_token_id_ = id;
+  }
 
   auto* input_tensors_metadata = metadata_extractor->GetInputTensorMetadata();
   input_ids_tensor_index_ = FindTensorIndexByMetadataName(
@@ -186,59 +201,59 @@ absl::Status BertPreprocessorCalculator::Open(CalculatorContext* cc) {
       cc->Options<mediapipe::BertPreprocessorCalculatorOptions>();
   bert_max_seq_len_ = options.bert_max_seq_len();
   has_dynamic_input_tensors_ = options.has_dynamic_input_tensors();
+  seq_len_bucket_size_ = options.seq_len_bucket_size();
   return absl::OkStatus();
 }
 
 absl::Status BertPreprocessorCalculator::Process(CalculatorContext* cc) {
-  int tensor_size = bert_max_seq_len_;
-  std::vector<std::string> input_tokens = TokenizeInputText(kTextIn(cc).Get());
-  if (has_dynamic_input_tensors_) {
-    tensor_size = input_tokens.size();
-  }
-  kTensorsOut(cc).Send(GenerateInputTensors(input_tokens, tensor_size));
-  return absl::OkStatus();
-}
-
-std::vector<std::string> BertPreprocessorCalculator::TokenizeInputText(
-    absl::string_view input_text) {
-  std::string processed_input = std::string(input_text);
+  std::string processed_input = kTextIn(cc).Get();
   absl::AsciiStrToLower(&processed_input);
 
-  tasks::text::tokenizers::TokenizerResult tokenizer_result =
-      tokenizer_->Tokenize(processed_input);
-
-  // Offset by 2 to account for [CLS] and [SEP]
-  int input_tokens_size =
-      static_cast<int>(tokenizer_result.subwords.size()) + 2;
-  // For static shapes, truncate the input tokens to `bert_max_seq_len_`.
+  // The token ids are written straight into the ids tensor when its size is
+  // known, offset by 1 to account for [CLS] and truncated to leave room for
+  // [SEP].
   if (!has_dynamic_input_tensors_) {
-    input_tokens_size = std::min(bert_max_seq_len_, input_tokens_size);
-  }
-  std::vector<std::string> input_tokens;
-  input_tokens.reserve(input_tokens_size);
-  input_tokens.push_back(std::string(kClassifierToken));
-  for (int i = 0; i < input_tokens_size - 2; ++i) {
-    input_tokens.push_back(std::move(tokenizer_result.subwords[i]));
+    std::vector<Tensor> input_tensors = CreateInputTensors(bert_max_seq_len_);
+    int num_tokens;
+    {
+      auto ids_view = input_tensors[input_ids_tensor_index_].GetCpuWriteView();
+      num_tokens = tokenizer_->TokenizeIntoIds(
+          processed_input, absl::MakeSpan(ids_view.buffer<int32_t>() + 1,
+                                          bert_max_seq_len_ - 2));
+    }
+    FinishInputTensors(std::min(num_tokens, bert_max_seq_len_ - 2),
+                       input_tensors);
+    kTensorsOut(cc).Send(std::move(input_tensors));
+    return absl::OkStatus();
   }
-  input_tokens.push_back(std::string(kSeparatorToken));
-  return input_tokens;
-}
 
-std::vector<Tensor> BertPreprocessorCalculator::GenerateInputTensors(
-    const std::vector<std::string>& input_tokens, int tensor_size) {
-  std::vector<int32_t> input_ids(tensor_size, 0);
-  std::vector<int32_t> segment_ids(tensor_size, 0);
-  std::vector<int32_t> input_masks(tensor_size, 0);
-  // Convert tokens back into ids and set mask
-  for (int i = 0; i < input_tokens.size(); ++i) {
-    tokenizer_->LookupId(input_tokens[i], &input_ids[i]);
-    input_masks[i] = 1;
+  // Every token spans at least one byte, so most inputs need a single pass.
+  dynamic_input_ids_.resize(processed_input.size() + 1);
+  int num_tokens = tokenizer_->TokenizeIntoIds(
+      processed_input, absl::MakeSpan(dynamic_input_ids_));
+  if (num_tokens > dynamic_input_ids_.size()) {
+    dynamic_input_ids_.resize(num_tokens);
+    num_tokens = tokenizer_->TokenizeIntoIds(
+        processed_input, absl::MakeSpan(dynamic_input_ids_));
   }
-  //                           |<-----------tensor_size------------>|
-  // input_ids                 [CLS] s1  s2...  sn [SEP]  0  0...  0
-  // segment_ids                 0    0   0...  0    0    0  0...  0
-  // input_masks                 1    1   1...  1    1    0  0...  0
+  int tensor_size = num_tokens + 2;
+  if (seq_len_bucket_size_ > 0) {
+    tensor_size = (tensor_size + seq_len_bucket_size_ - 1) /
+                  seq_len_bucket_size_ * seq_len_bucket_size_;
+  }
+  std::vector<Tensor> input_tensors = CreateInputTensors(tensor_size);
+  std::memcpy(input_tensors[input_ids_tensor_index_]
+                      .GetCpuWriteView()
+                      .buffer<int32_t>() +
+                  1,
+              dynamic_input_ids_.data(), num_tokens * sizeof(int32_t));
+  FinishInputTensors(num_tokens, input_tensors);
+  kTensorsOut(cc).Send(std::move(input_tensors));
+  return absl::OkStatus();
+}
 
+std::vector<Tensor> BertPreprocessorCalculator::CreateInputTensors(
+    int tensor_size) {
   std::vector<Tensor> input_tensors;
   input_tensors.reserve(kNumInputTensorsForBert);
   for (int i = 0; i < kNumInputTensorsForBert; ++i) {
@@ -246,21 +261,34 @@ std::vector<Tensor> BertPreprocessorCalculator::GenerateInputTensors(
         {Tensor::ElementType::kInt32,
          Tensor::Shape({1, tensor_size}, has_dynamic_input_tensors_)});
   }
-  std::memcpy(input_tensors[input_ids_tensor_index_]
-                  .GetCpuWriteView()
-                  .buffer<int32_t>(),
-              input_ids.data(), input_ids.size() * sizeof(int32_t));
-  std::memcpy(input_tensors[segment_ids_tensor_index_]
-                  .GetCpuWriteView()
-                  .buffer<int32_t>(),
-              segment_ids.data(), segment_ids.size() * sizeof(int32_t));
-  std::memcpy(input_tensors[input_masks_tensor_index_]
-                  .GetCpuWriteView()
-                  .buffer<int32_t>(),
-              input_masks.data(), input_masks.size() * sizeof(int32_t));
   return input_tensors;
 }
 
+void BertPreprocessorCalculator::FinishInputTensors(
+    int num_tokens, std::vector<Tensor>& input_tensors) {
+  //                           |<-----------tensor_size------------>|
+  // input_ids                 [CLS] s1  s2...  sn [SEP]  0  0...  0
+  // segment_ids                 0    0   0...  0    0    0  0...  0
+  // input_masks                 1    1   1...  1    1    0  0...  0
+  const int tensor_size = input_tensors[0].shape().num_elements();
+  auto ids_view = input_tensors[input_ids_tensor_index_].GetCpuWriteView();
+  int32_t* input_ids = ids_view.buffer<int32_t>();
+  input_ids[0] = classifier_token_id_;
+  input_ids[num_tokens + 1] = separator_token_id_;
+  std::fill(input_ids + num_tokens + 2, input_ids + tensor_size, 0);
+
+  auto segment_ids_view =
+      input_tensors[segment_ids_tensor_index_].GetCpuWriteView();
+  int32_t* segment_ids = segment_ids_view.buffer<int32_t>();
+  std::fill(segment_ids, segment_ids + tensor_size, 0);
+
+  auto input_masks_view =
+      input_tensors[input_masks_tensor_index_].GetCpuWriteView();
+  int32_t* input_masks = input_masks_view.buffer<int32_t>();
+  std::fill(input_masks, input_masks + num_tokens + 2, 1);
+  std::fill(input_masks + num_tokens + 2, input_masks + tensor_size, 0);
+}
+
 MEDIAPIPE_REGISTER_NODE(BertPreprocessorCalculator);
 
 }  // namespace api2
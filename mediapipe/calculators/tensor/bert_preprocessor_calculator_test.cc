@@ -44,7 +44,8 @@ constexpr absl::string_view kTestModelPath =
 
 absl::StatusOr<std::vector<std::vector<int>>> RunBertPreprocessorCalculator(
     absl::string_view text, absl::string_view model_path,
-    bool has_dynamic_input_tensors = false, int tensor_size = kBertMaxSeqLen) {
+    bool has_dynamic_input_tensors = false, int tensor_size = kBertMaxSeqLen,
+    int seq_len_bucket_size = 0) {
   auto graph_config = ParseTextProtoOrDie<CalculatorGraphConfig>(
       absl::Substitute(R"(
         input_stream: "text"
@@ -58,11 +59,13 @@ absl::StatusOr<std::vector<std::vector<int>>> RunBertPreprocessorCalculator(
             [mediapipe.BertPreprocessorCalculatorOptions.ext] {
               bert_max_seq_len: $0
               has_dynamic_input_tensors: $1
+              seq_len_bucket_size: $2
             }
           }
         }
       )",
-                       tensor_size, has_dynamic_input_tensors));
+                       tensor_size, has_dynamic_input_tensors,
+                       seq_len_bucket_size));
   std::vector<Packet> output_packets;
   tool::AddVectorSink("tensors", &graph_config, &output_packets);
 
@@ -99,6 +102,11 @@ absl::StatusOr<std::vector<std::vector<int>>> RunBertPreprocessorCalculator(
     if (tensor.element_type() != Tensor::ElementType::kInt32) {
       return absl::InvalidArgumentError("Expected tensor element type kInt32");
     }
+    if (tensor.shape().num_elements() != tensor_size) {
+      return absl::InvalidArgumentError(
+          absl::Substitute("Tensor has $0 elements, expected $1",
+                           tensor.shape().num_elements(), tensor_size));
+    }
     auto* buffer = tensor.GetCpuReadView().buffer<int>();
     std::vector<int> buffer_view(buffer, buffer + tensor_size);
     results.push_back(buffer_view);
@@ -126,6 +134,27 @@ TEST(BertPreprocessorCalculatorTest, TextClassifierWithBertModel) {
   EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
 }
 
+TEST(BertPreprocessorCalculatorTest, DynamicInputTensorsWithBuckets) {
+  constexpr int kBucketSize = 16;
+  std::vector<std::vector<int>> expected_result = {
+      {101, 2009, 1005, 1055, 1037, 11951, 1998, 2411, 12473, 4990, 102}};
+  // segment_ids
+  expected_result.push_back(std::vector(kBucketSize, 0));
+  // input_masks
+  expected_result.push_back(std::vector(expected_result[0].size(), 1));
+  expected_result[2].resize(kBucketSize);
+  // padding input_ids
+  expected_result[0].resize(kBucketSize);
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<int>> processed_tensor_values,
+      RunBertPreprocessorCalculator(
+          "it's a charming and often affecting journey", kTestModelPath,
+          /*has_dynamic_input_tensors=*/true, /*tensor_size=*/kBucketSize,
+          /*seq_len_bucket_size=*/kBucketSize));
+  EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
+}
+
 TEST(BertPreprocessorCalculatorTest, LongInput) {
   std::stringstream long_input;
   long_input
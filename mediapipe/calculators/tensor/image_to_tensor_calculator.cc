@@ -16,9 +16,9 @@
 #include <memory>
 #include <vector>
 
-#include "absl/log/absl_log.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_calculator.pb.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_converter.h"
+#include "mediapipe/calculators/tensor/image_to_tensor_converter_cpu.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -26,6 +26,7 @@
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/canonical_errors.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -33,12 +34,6 @@
 #include "mediapipe/framework/port/statusor.h"
 #include "mediapipe/gpu/gpu_origin.pb.h"
 
-#if !MEDIAPIPE_DISABLE_OPENCV
-#include "mediapipe/calculators/tensor/image_to_tensor_converter_opencv.h"
-#elif MEDIAPIPE_ENABLE_HALIDE
-#include "mediapipe/calculators/tensor/image_to_tensor_converter_frame_buffer.h"
-#endif
-
 #if !MEDIAPIPE_DISABLE_GPU
 #include "mediapipe/gpu/gpu_buffer.h"
 
@@ -73,6 +68,8 @@ namespace api2 {
 //   - One and only one of IMAGE and IMAGE_GPU should be specified.
 //   - IMAGE input of type Image is processed on GPU if the data is already on
 //     GPU (i.e., Image::UsesGpu() returns true), or otherwise processed on CPU.
+//   - IMAGE input of type Image holding a YUV image (NV12, NV21, YV12, I420)
+//     in CPU memory is processed on CPU without a full-frame RGB conversion.
 //   - IMAGE input of type ImageFrame is always processed on CPU.
 //   - IMAGE_GPU input (of type GpuBuffer) is always processed on GPU.
 //
@@ -80,9 +77,18 @@ namespace api2 {
 //     Describes region of image to extract.
 //     @Optional: rect covering the whole image is used if not specified.
 //
+//   NORM_RECTS - std::vector<NormalizedRect> @Optional
+//     Describes several regions of image to extract into a single batched
+//     tensor. The image is converted once for all regions; an empty vector
+//     produces no output. Cannot be used together with NORM_RECT.
+//
 // Outputs:
 //   TENSORS - std::vector<Tensor>
 //     Vector containing a single Tensor populated with an extrated RGB image.
+//     With NORM_RECTS, the Tensor has shape [N, height, width, channels] and
+//     holds the region N of NORM_RECTS in batch entry N. Converters that
+//     cannot write at an offset into the tensor (the GL texture and the
+//     FrameBuffer converters) only support a single region.
 //   MATRIX - std::array<float, 16> @Optional
 //     An std::array<float, 16> representing a 4x4 row-major-order matrix that
 //     maps a point on the input image to a point on the output tensor, and
@@ -99,6 +105,10 @@ namespace api2 {
 //     20x20 and places it in the middle of the output image with an equal
 //     padding of 10 pixels at the top and the bottom. The resulting array is
 //     therefore [0.f, 0.25f, 0.f, 0.25f] (10/40 = 0.25f).
+//   MATRICES - std::vector<std::array<float, 16>> @Optional
+//   LETTERBOX_PADDINGS - std::vector<std::array<float, 4>> @Optional
+//     MATRIX and LETTERBOX_PADDING of each batch entry. With NORM_RECTS, these
+//     replace MATRIX and LETTERBOX_PADDING.
 //
 // Example:
 // node {
@@ -127,13 +137,20 @@ class ImageToTensorCalculator : public Node {
   static constexpr Input<GpuBuffer>::Optional kInGpu{"IMAGE_GPU"};
   static constexpr Input<mediapipe::NormalizedRect>::Optional kInNormRect{
       "NORM_RECT"};
+  static constexpr Input<std::vector<mediapipe::NormalizedRect>>::Optional
+      kInNormRects{"NORM_RECTS"};
   static constexpr Output<std::vector<Tensor>> kOutTensors{"TENSORS"};
   static constexpr Output<std::array<float, 4>>::Optional kOutLetterboxPadding{
       "LETTERBOX_PADDING"};
   static constexpr Output<std::array<float, 16>>::Optional kOutMatrix{"MATRIX"};
+  static constexpr Output<std::vector<std::array<float, 4>>>::Optional
+      kOutLetterboxPaddings{"LETTERBOX_PADDINGS"};
+  static constexpr Output<std::vector<std::array<float, 16>>>::Optional
+      kOutMatrices{"MATRICES"};
 
-  MEDIAPIPE_NODE_CONTRACT(kIn, kInGpu, kInNormRect, kOutTensors,
-                          kOutLetterboxPadding, kOutMatrix);
+  MEDIAPIPE_NODE_CONTRACT(kIn, kInGpu, kInNormRect, kInNormRects, kOutTensors,
+                          kOutLetterboxPadding, kOutMatrix,
+                          kOutLetterboxPaddings, kOutMatrices);
 
   static absl::Status UpdateContract(CalculatorContract* cc) {
     const auto& options =
@@ -142,6 +159,13 @@ class ImageToTensorCalculator : public Node {
     RET_CHECK_OK(ValidateOptionOutputDims(options));
     RET_CHECK(kIn(cc).IsConnected() ^ kInGpu(cc).IsConnected())
         << "One and only one of IMAGE and IMAGE_GPU input is expected.";
+    if (kInNormRects(cc).IsConnected()) {
+      RET_CHECK(!kInNormRect(cc).IsConnected())
+          << "At most one of NORM_RECT and NORM_RECTS input is expected.";
+      RET_CHECK(!kOutLetterboxPadding(cc).IsConnected() &&
+                !kOutMatrix(cc).IsConnected())
+          << "Use LETTERBOX_PADDINGS and MATRICES outputs with NORM_RECTS.";
+    }
 
 #if MEDIAPIPE_DISABLE_GPU
     if (kInGpu(cc).IsConnected()) {
@@ -155,6 +179,7 @@ class ImageToTensorCalculator : public Node {
     cc->UseService(kGpuService).Optional();
 #endif  // MEDIAPIPE_METAL_ENABLED
 #endif  // MEDIAPIPE_DISABLE_GPU
+    cc->UseService(kTensorPoolService).Optional();
 
     return absl::OkStatus();
   }
@@ -162,6 +187,7 @@ class ImageToTensorCalculator : public Node {
   absl::Status Open(CalculatorContext* cc) {
     options_ = cc->Options<mediapipe::ImageToTensorCalculatorOptions>();
     params_ = GetOutputTensorParams(options_);
+    tensor_pool_ = cc->Service(kTensorPoolService);
     return absl::OkStatus();
   }
 
@@ -172,14 +198,22 @@ class ImageToTensorCalculator : public Node {
       return absl::OkStatus();
     }
 
-    absl::optional<mediapipe::NormalizedRect> norm_rect;
-    if (kInNormRect(cc).IsConnected()) {
+    std::vector<absl::optional<mediapipe::NormalizedRect>> norm_rects;
+    if (kInNormRects(cc).IsConnected()) {
+      if (kInNormRects(cc).IsEmpty() || kInNormRects(cc)->empty()) {
+        // Timestamp bound update happens automatically.
+        return absl::OkStatus();
+      }
+      for (const auto& norm_rect : *kInNormRects(cc)) {
+        norm_rects.push_back(norm_rect);
+      }
+    } else if (kInNormRect(cc).IsConnected()) {
       if (kInNormRect(cc).IsEmpty()) {
         // Timestamp bound update happens automatically. (See Open().)
         return absl::OkStatus();
       }
-      norm_rect = *kInNormRect(cc);
-      if (norm_rect->width() == 0 && norm_rect->height() == 0) {
+      const auto& norm_rect = *kInNormRect(cc);
+      if (norm_rect.width() == 0 && norm_rect.height() == 0) {
         // WORKAROUND: some existing graphs may use sentinel rects {width=0,
         // height=0, ...} quite often and calculator has to handle them
         // gracefully by updating timestamp bound instead of returning failure.
@@ -189,6 +223,9 @@ class ImageToTensorCalculator : public Node {
             << "Updating timestamp bound in response to a sentinel rect";
         return absl::OkStatus();
       }
+      norm_rects.push_back(norm_rect);
+    } else {
+      norm_rects.push_back(absl::nullopt);
     }
 
 #if MEDIAPIPE_DISABLE_GPU
@@ -199,33 +236,75 @@ class ImageToTensorCalculator : public Node {
                                               : GetInputImage(kIn(cc)));
 #endif  // MEDIAPIPE_DISABLE_GPU
 
-    RotatedRect roi = GetRoi(image->width(), image->height(), norm_rect);
     const int tensor_width = params_.output_width.value_or(image->width());
     const int tensor_height = params_.output_height.value_or(image->height());
-    ASSIGN_OR_RETURN(auto padding, PadRoi(tensor_width, tensor_height,
-                                          options_.keep_aspect_ratio(), &roi));
-    if (kOutLetterboxPadding(cc).IsConnected()) {
-      kOutLetterboxPadding(cc).Send(padding);
-    }
-    if (kOutMatrix(cc).IsConnected()) {
+    std::vector<RotatedRect> rois;
+    std::vector<std::array<float, 4>> paddings;
+    std::vector<std::array<float, 16>> matrices;
+    for (const auto& norm_rect : norm_rects) {
+      RotatedRect roi = GetRoi(image->width(), image->height(), norm_rect);
+      ASSIGN_OR_RETURN(auto padding,
+                       PadRoi(tensor_width, tensor_height,
+                              options_.keep_aspect_ratio(), &roi));
+      paddings.push_back(padding);
       std::array<float, 16> matrix;
       GetRotatedSubRectToRectTransformMatrix(
           roi, image->width(), image->height(),
           /*flip_horizontaly=*/false, &matrix);
-      kOutMatrix(cc).Send(std::move(matrix));
+      matrices.push_back(matrix);
+      rois.push_back(roi);
+    }
+    if (kOutLetterboxPadding(cc).IsConnected()) {
+      kOutLetterboxPadding(cc).Send(paddings[0]);
     }
+    if (kOutMatrix(cc).IsConnected()) {
+      kOutMatrix(cc).Send(matrices[0]);
+    }
+    if (kOutLetterboxPaddings(cc).IsConnected()) {
+      kOutLetterboxPaddings(cc).Send(std::move(paddings));
+    }
+    if (kOutMatrices(cc).IsConnected()) {
+      kOutMatrices(cc).Send(std::move(matrices));
+    }
+
+    // YUV images in CPU memory are held in a GpuBuffer, but are sampled by
+    // the CPU converter.
+    const bool is_cpu_yuv = IsCpuYuvImage(*image);
+    const bool use_gpu = image->UsesGpu() && !is_cpu_yuv;
 
     // Lazy initialization of the GPU or CPU converter.
-    MP_RETURN_IF_ERROR(InitConverterIfNecessary(cc, *image.get()));
+    MP_RETURN_IF_ERROR(InitConverterIfNecessary(cc, use_gpu));
 
     Tensor::ElementType output_tensor_type =
-        GetOutputTensorType(image->UsesGpu(), params_);
-    Tensor tensor(output_tensor_type, {1, tensor_height, tensor_width,
-                                       GetNumOutputChannels(*image)});
-    MP_RETURN_IF_ERROR((image->UsesGpu() ? gpu_converter_ : cpu_converter_)
-                           ->Convert(*image, roi, params_.range_min,
-                                     params_.range_max,
-                                     /*tensor_buffer_offset=*/0, tensor));
+        GetOutputTensorType(use_gpu, params_);
+    const int batch_size = rois.size();
+    const Tensor::Shape tensor_shape = {batch_size, tensor_height, tensor_width,
+                                        is_cpu_yuv
+                                            ? 3
+                                            : GetNumOutputChannels(*image)};
+    // Tensors for GPU images are written on the GPU, so only CPU tensors take
+    // their buffers from the pool.
+    Tensor tensor =
+        !use_gpu && tensor_pool_.IsAvailable()
+            ? tensor_pool_.GetObject().GetTensor(output_tensor_type,
+                                                 tensor_shape)
+            : Tensor(output_tensor_type, tensor_shape);
+#ifdef MEDIAPIPE_TENSOR_USE_AHWB
+    if (use_gpu && options_.prefer_ahardware_buffer_output()) {
+      tensor.SetPreferAHardwareBuffer();
+    }
+#endif  // MEDIAPIPE_TENSOR_USE_AHWB
+    ImageToTensorConverter* converter =
+        use_gpu ? gpu_converter_.get() : cpu_converter_.get();
+    if (batch_size == 1) {
+      MP_RETURN_IF_ERROR(converter->Convert(*image, rois[0], params_.range_min,
+                                            params_.range_max,
+                                            /*tensor_buffer_offset=*/0,
+                                            tensor));
+    } else {
+      MP_RETURN_IF_ERROR(converter->ConvertBatch(
+          *image, rois, params_.range_min, params_.range_max, tensor));
+    }
 
     auto result = std::make_unique<std::vector<Tensor>>();
     result->push_back(std::move(tensor));
@@ -235,10 +314,9 @@ class ImageToTensorCalculator : public Node {
   }
 
  private:
-  absl::Status InitConverterIfNecessary(CalculatorContext* cc,
-                                        const Image& image) {
+  absl::Status InitConverterIfNecessary(CalculatorContext* cc, bool use_gpu) {
     // Lazy initialization of the GPU or CPU converter.
-    if (image.UsesGpu()) {
+    if (use_gpu) {
       if (!params_.is_float_output) {
         return absl::UnimplementedError(
             "ImageToTensorConverter for the input GPU image currently doesn't "
@@ -271,24 +349,10 @@ class ImageToTensorCalculator : public Node {
       }
     } else {
       if (!cpu_converter_) {
-#if !MEDIAPIPE_DISABLE_OPENCV
-        ASSIGN_OR_RETURN(cpu_converter_,
-                         CreateOpenCvConverter(
-                             cc, GetBorderMode(options_.border_mode()),
-                             GetOutputTensorType(/*uses_gpu=*/false, params_)));
-// TODO: FrameBuffer-based converter needs to call GetGpuBuffer()
-// to get access to a FrameBuffer view. Investigate if GetGpuBuffer() can be
-// made available even with MEDIAPIPE_DISABLE_GPU set.
-#elif MEDIAPIPE_ENABLE_HALIDE
         ASSIGN_OR_RETURN(cpu_converter_,
-                         CreateFrameBufferConverter(
+                         CreateCpuConverter(
                              cc, GetBorderMode(options_.border_mode()),
                              GetOutputTensorType(/*uses_gpu=*/false, params_)));
-#else
-        ABSL_LOG(FATAL) << "Cannot create image to tensor CPU converter since "
-                           "MEDIAPIPE_DISABLE_OPENCV is defined and "
-                           "MEDIAPIPE_ENABLE_HALIDE is not defined.";
-#endif  // !MEDIAPIPE_DISABLE_HALIDE
       }
     }
     return absl::OkStatus();
@@ -298,6 +362,8 @@ class ImageToTensorCalculator : public Node {
   std::unique_ptr<ImageToTensorConverter> cpu_converter_;
   mediapipe::ImageToTensorCalculatorOptions options_;
   OutputTensorParams params_;
+  // Provides the CPU buffers of the output tensors, if available.
+  ServiceBinding<TensorPool> tensor_pool_;
 };
 
 MEDIAPIPE_REGISTER_NODE(ImageToTensorCalculator);
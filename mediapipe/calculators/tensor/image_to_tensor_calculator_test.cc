@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -33,6 +37,7 @@
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/formats/yuv_image.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
@@ -40,6 +45,8 @@
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
 #include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/gpu/gpu_buffer.h"
+#include "mediapipe/gpu/gpu_buffer_storage_yuv_image.h"
 #include "mediapipe/util/image_test_utils.h"
 
 #if !MEDIAPIPE_DISABLE_GPU && !MEDIAPIPE_METAL_ENABLED
@@ -513,6 +520,85 @@ TEST(ImageToTensorCalculatorTest, NoOpExceptRangeAndUseInputImageDims) {
           /*keep_aspect=*/false, BorderMode::kZero, roi);
 }
 
+TEST(ImageToTensorCalculatorTest, BatchesNormRects) {
+  mediapipe::NormalizedRect roi;
+  roi.set_x_center(0.65f);
+  roi.set_y_center(0.4f);
+  roi.set_width(0.5f);
+  roi.set_height(0.5f);
+  roi.set_rotation(0);
+  mediapipe::NormalizedRect rotated_roi = roi;
+  rotated_roi.set_rotation(M_PI * 90.0f / 180.0f);
+  const std::vector<cv::Mat> expected_results = {
+      GetRgb(GetFilePath("medium_sub_rect_keep_aspect.png")),
+      GetRgb(GetFilePath("medium_sub_rect_keep_aspect_with_rotation.png"))};
+
+  auto graph_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input_image"
+        input_stream: "rois"
+        node {
+          calculator: "ImageToTensorCalculator"
+          input_stream: "IMAGE:input_image"
+          input_stream: "NORM_RECTS:rois"
+          output_stream: "TENSORS:tensor"
+          output_stream: "MATRICES:matrices"
+          options {
+            [mediapipe.ImageToTensorCalculatorOptions.ext] {
+              output_tensor_width: 256
+              output_tensor_height: 256
+              keep_aspect_ratio: true
+              output_tensor_float_range { min: 0.0 max: 1.0 }
+              border_mode: BORDER_REPLICATE
+            }
+          }
+        }
+      )pb");
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("tensor", &graph_config, &output_packets);
+  std::vector<Packet> matrices_packets;
+  tool::AddVectorSink("matrices", &graph_config, &matrices_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  cv::Mat input = GetRgb(GetFilePath("input.jpg"));
+  MP_ASSERT_OK(
+      graph.AddPacketToInputStream("input_image", MakeImagePacket(input)));
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "rois", MakePacket<std::vector<mediapipe::NormalizedRect>>(
+                  std::vector<mediapipe::NormalizedRect>{roi, rotated_roi})
+                  .At(Timestamp(0))));
+  MP_ASSERT_OK(graph.WaitUntilIdle());
+  ASSERT_THAT(output_packets, testing::SizeIs(1));
+  ASSERT_THAT(matrices_packets, testing::SizeIs(1));
+  EXPECT_THAT(matrices_packets[0].Get<std::vector<std::array<float, 16>>>(),
+              testing::SizeIs(2));
+
+  const std::vector<Tensor>& tensor_vec =
+      output_packets[0].Get<std::vector<Tensor>>();
+  ASSERT_THAT(tensor_vec, testing::SizeIs(1));
+  const Tensor& tensor = tensor_vec[0];
+  EXPECT_EQ(tensor.shape().dims, std::vector<int>({2, 256, 256, 3}));
+  auto view = tensor.GetCpuReadView();
+  for (int i = 0; i < static_cast<int>(expected_results.size()); ++i) {
+    cv::Mat tensor_mat(256, 256, CV_32FC3,
+                       const_cast<float*>(view.buffer<float>()) +
+                           i * 256 * 256 * 3);
+    cv::Mat result_rgb;
+    tensor_mat.convertTo(result_rgb, CV_8UC3, 255.0f);
+    cv::Mat diff;
+    cv::absdiff(result_rgb, expected_results[i], diff);
+    double max_val;
+    cv::minMaxLoc(diff, nullptr, &max_val);
+    // Expects the maximum absolute pixel-by-pixel difference is less than 5.
+    EXPECT_LE(max_val, 5) << "Batch entry " << i;
+  }
+
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
 TEST(ImageToTensorCalculatorTest, CanBeUsedWithoutGpuServiceSet) {
   auto graph_config =
       mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
@@ -543,6 +629,57 @@ TEST(ImageToTensorCalculatorTest, CanBeUsedWithoutGpuServiceSet) {
   MP_ASSERT_OK(graph.WaitUntilDone());
 }
 
+TEST(ImageToTensorCalculatorTest, ConvertsCpuYuvImageWithoutRgbFrame) {
+  constexpr int kWidth = 64;
+  constexpr int kHeight = 32;
+  constexpr int kChromaWidth = kWidth / 2;
+  constexpr int kChromaHeight = kHeight / 2;
+  // A uniform NV12 image with Y = 100, U = 90 and V = 160.
+  auto y_data = std::make_unique<uint8_t[]>(kWidth * kHeight);
+  std::fill_n(y_data.get(), kWidth * kHeight, 100);
+  auto uv_data = std::make_unique<uint8_t[]>(2 * kChromaWidth * kChromaHeight);
+  for (int i = 0; i < kChromaWidth * kChromaHeight; ++i) {
+    uv_data[2 * i] = 90;
+    uv_data[2 * i + 1] = 160;
+  }
+  auto yuv_image = std::make_shared<YUVImage>(
+      libyuv::FOURCC_NV12, std::move(y_data), kWidth, std::move(uv_data),
+      2 * kChromaWidth, nullptr, 0, kWidth, kHeight);
+  Image image(
+      GpuBuffer(std::make_shared<GpuBufferStorageYuvImage>(yuv_image)));
+
+  CalculatorRunner runner(ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+    calculator: "ImageToTensorCalculator"
+    input_stream: "IMAGE:input_image"
+    output_stream: "TENSORS:tensor"
+    options {
+      [mediapipe.ImageToTensorCalculatorOptions.ext] {
+        output_tensor_width: 16
+        output_tensor_height: 8
+        output_tensor_float_range { min: 0.0f max: 255.0f }
+      }
+    }
+  )pb"));
+  runner.MutableInputs()->Tag("IMAGE").packets.push_back(
+      MakePacket<Image>(std::move(image)).At(Timestamp(0)));
+  MP_ASSERT_OK(runner.Run());
+
+  const std::vector<Packet>& output_packets =
+      runner.Outputs().Tag("TENSORS").packets;
+  ASSERT_EQ(output_packets.size(), 1);
+  const Tensor& tensor = output_packets[0].Get<std::vector<Tensor>>()[0];
+  EXPECT_EQ(tensor.shape().dims, std::vector<int>({1, 8, 16, 3}));
+  auto view = tensor.GetCpuReadView();
+  const float* data = view.buffer<float>();
+  // Full-range JFIF YUV to RGB conversion of the uniform color.
+  for (int i = 0; i < 8 * 16; ++i) {
+    EXPECT_NEAR(data[3 * i], 100 + 1.402f * 32, 0.01f);
+    EXPECT_NEAR(data[3 * i + 1], 100 + 0.344136f * 38 - 0.714136f * 32,
+                0.01f);
+    EXPECT_NEAR(data[3 * i + 2], 100 - 1.772f * 38, 0.01f);
+  }
+}
+
 #if !MEDIAPIPE_DISABLE_GPU && !MEDIAPIPE_METAL_ENABLED
 
 TEST(ImageToTensorCalculatorTest,
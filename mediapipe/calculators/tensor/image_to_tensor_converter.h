@@ -15,9 +15,13 @@
 #ifndef MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CONVERTER_H_
 #define MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CONVERTER_H_
 
+#include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
 #include "mediapipe/framework/formats/image.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/framework/port/statusor.h"
 
 namespace mediapipe {
@@ -46,6 +50,25 @@ class ImageToTensorConverter {
                                const RotatedRect& roi, float range_min,
                                float range_max, int tensor_buffer_offset,
                                Tensor& output_tensor) = 0;
+
+  // Converts several regions of interest of the same image into consecutive
+  // batch entries of @output_tensor, whose first dimension must be
+  // @rois.size(). The default implementation calls Convert for each region;
+  // converters override it to share the per-image work among the regions.
+  virtual absl::Status ConvertBatch(const mediapipe::Image& input,
+                                    absl::Span<const RotatedRect> rois,
+                                    float range_min, float range_max,
+                                    Tensor& output_tensor) {
+    const int batch_size = rois.size();
+    RET_CHECK_GT(batch_size, 0);
+    RET_CHECK_EQ(output_tensor.shape().dims[0], batch_size);
+    const int entry_bytes = output_tensor.bytes() / batch_size;
+    for (int i = 0; i < batch_size; ++i) {
+      MP_RETURN_IF_ERROR(Convert(input, rois[i], range_min, range_max,
+                                 i * entry_bytes, output_tensor));
+    }
+    return absl::OkStatus();
+  }
 };
 
 }  // namespace mediapipe
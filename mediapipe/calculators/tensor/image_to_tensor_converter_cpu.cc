@@ -0,0 +1,474 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/calculators/tensor/image_to_tensor_converter_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/calculators/tensor/image_to_tensor_converter.h"
+#include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/frame_buffer.h"
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/port/statusor.h"
+#include "mediapipe/gpu/frame_buffer_view.h"
+#include "mediapipe/gpu/gpu_buffer_storage_yuv_image.h"
+
+namespace mediapipe {
+
+namespace {
+
+// Maps output pixel (x, y) to the input position
+// (x0 + x * dx_x + y * dx_y, y0 + x * dy_x + y * dy_y), with pixel centers at
+// integer coordinates as in cv::warpAffine.
+struct AffineMap {
+  float x0;
+  float y0;
+  float dx_x;
+  float dy_x;
+  float dx_y;
+  float dy_y;
+};
+
+// Returns the map from the output tensor to @roi, with the top left corner of
+// the tensor at the top left corner of the rotated @roi.
+AffineMap GetAffineMap(const RotatedRect& roi, int output_width,
+                       int output_height) {
+  const float cos_r = std::cos(roi.rotation);
+  const float sin_r = std::sin(roi.rotation);
+  const float scale_x = roi.width / output_width;
+  const float scale_y = roi.height / output_height;
+  const float half_width = roi.width / 2.0f;
+  const float half_height = roi.height / 2.0f;
+  return {/*x0=*/roi.center_x - half_width * cos_r + half_height * sin_r,
+          /*y0=*/roi.center_y - half_width * sin_r - half_height * cos_r,
+          /*dx_x=*/scale_x * cos_r,
+          /*dy_x=*/scale_x * sin_r,
+          /*dx_y=*/-scale_y * sin_r,
+          /*dy_y=*/scale_y * cos_r};
+}
+
+// An input image with interleaved 8-bit channels.
+struct InputPlane {
+  const uint8_t* data;
+  int width;
+  int height;
+  int step;
+  int channels;
+};
+
+// Converts a sample to the output element type. Integers are rounded and
+// saturated as in cv::Mat::convertTo.
+template <typename T>
+inline T ToOutput(float value);
+
+template <>
+inline float ToOutput<float>(float value) {
+  return value;
+}
+
+template <>
+inline uint8_t ToOutput<uint8_t>(float value) {
+  return static_cast<uint8_t>(std::clamp<long>(std::lrintf(value), 0, 255));
+}
+
+template <>
+inline int8_t ToOutput<int8_t>(float value) {
+  return static_cast<int8_t>(std::clamp<long>(std::lrintf(value), -128, 127));
+}
+
+// Returns the input pixel at (x, y), or nullptr for a zero border pixel.
+template <BorderMode kBorderMode>
+inline const uint8_t* GetPixel(const InputPlane& input, int x, int y) {
+  if (kBorderMode == BorderMode::kReplicate) {
+    x = std::clamp(x, 0, input.width - 1);
+    y = std::clamp(y, 0, input.height - 1);
+  } else if (x < 0 || y < 0 || x >= input.width || y >= input.height) {
+    return nullptr;
+  }
+  return input.data + y * input.step + x * input.channels;
+}
+
+// Sub-pixel positions are rounded to 1 / kInterTabSize of a pixel, as in
+// cv::warpAffine, so that results match the OpenCV converter.
+constexpr int kInterBits = 5;
+constexpr int kInterTabSize = 1 << kInterBits;
+
+// Bilinearly samples the first kChannels channels of @input at each output
+// pixel, transforms the samples as scale * x + offset and stores them, all in
+// one pass over @output. Output pixels whose four taps are inside the input
+// take a branch-free path; only pixels near the border look up each tap.
+template <typename T, int kChannels, BorderMode kBorderMode>
+void WarpAndNormalize(const InputPlane& input, const AffineMap& map,
+                      int output_width, int output_height, float scale,
+                      float offset, T* output) {
+  const int last_x = input.width - 1;
+  const int last_y = input.height - 1;
+  for (int y = 0; y < output_height; ++y) {
+    const float row_x = map.x0 + y * map.dx_y;
+    const float row_y = map.y0 + y * map.dy_y;
+    for (int x = 0; x < output_width; ++x, output += kChannels) {
+      const float src_x = row_x + x * map.dx_x;
+      const float src_y = row_y + x * map.dy_x;
+      const int qx = static_cast<int>(std::lrintf(src_x * kInterTabSize));
+      const int qy = static_cast<int>(std::lrintf(src_y * kInterTabSize));
+      const int x0 = qx >> kInterBits;
+      const int y0 = qy >> kInterBits;
+      const float fx = (qx & (kInterTabSize - 1)) * (1.0f / kInterTabSize);
+      const float fy = (qy & (kInterTabSize - 1)) * (1.0f / kInterTabSize);
+      // Folds the value range transformation into the tap weights.
+      const float w00 = (1.0f - fx) * (1.0f - fy) * scale;
+      const float w01 = fx * (1.0f - fy) * scale;
+      const float w10 = (1.0f - fx) * fy * scale;
+      const float w11 = fx * fy * scale;
+      if (x0 >= 0 && y0 >= 0 && x0 < last_x && y0 < last_y) {
+        const uint8_t* p00 = input.data + y0 * input.step + x0 * input.channels;
+        const uint8_t* p01 = p00 + input.channels;
+        const uint8_t* p10 = p00 + input.step;
+        const uint8_t* p11 = p10 + input.channels;
+        for (int c = 0; c < kChannels; ++c) {
+          output[c] = ToOutput<T>(w00 * p00[c] + w01 * p01[c] + w10 * p10[c] +
+                                  w11 * p11[c] + offset);
+        }
+      } else {
+        const uint8_t* taps[4] = {
+            GetPixel<kBorderMode>(input, x0, y0),
+            GetPixel<kBorderMode>(input, x0 + 1, y0),
+            GetPixel<kBorderMode>(input, x0, y0 + 1),
+            GetPixel<kBorderMode>(input, x0 + 1, y0 + 1)};
+        const float weights[4] = {w00, w01, w10, w11};
+        for (int c = 0; c < kChannels; ++c) {
+          float value = offset;
+          for (int i = 0; i < 4; ++i) {
+            if (taps[i] != nullptr) value += weights[i] * taps[i][c];
+          }
+          output[c] = ToOutput<T>(value);
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void WarpAndNormalize(const InputPlane& input, const AffineMap& map,
+                      int output_width, int output_height, int output_channels,
+                      BorderMode border_mode, float scale, float offset,
+                      T* output) {
+  if (output_channels == 1) {
+    if (border_mode == BorderMode::kZero) {
+      WarpAndNormalize<T, 1, BorderMode::kZero>(
+          input, map, output_width, output_height, scale, offset, output);
+    } else {
+      WarpAndNormalize<T, 1, BorderMode::kReplicate>(
+          input, map, output_width, output_height, scale, offset, output);
+    }
+  } else {
+    if (border_mode == BorderMode::kZero) {
+      WarpAndNormalize<T, 3, BorderMode::kZero>(
+          input, map, output_width, output_height, scale, offset, output);
+    } else {
+      WarpAndNormalize<T, 3, BorderMode::kReplicate>(
+          input, map, output_width, output_height, scale, offset, output);
+    }
+  }
+}
+
+// Bilinearly samples the first channel of @plane at (x, y). Sets @coverage to
+// the total weight of the taps that are not zero border pixels.
+template <BorderMode kBorderMode>
+inline float SamplePlane(const InputPlane& plane, float x, float y,
+                         float* coverage) {
+  const int qx = static_cast<int>(std::lrintf(x * kInterTabSize));
+  const int qy = static_cast<int>(std::lrintf(y * kInterTabSize));
+  const int x0 = qx >> kInterBits;
+  const int y0 = qy >> kInterBits;
+  const float fx = (qx & (kInterTabSize - 1)) * (1.0f / kInterTabSize);
+  const float fy = (qy & (kInterTabSize - 1)) * (1.0f / kInterTabSize);
+  const float weights[4] = {(1.0f - fx) * (1.0f - fy), fx * (1.0f - fy),
+                            (1.0f - fx) * fy, fx * fy};
+  if (x0 >= 0 && y0 >= 0 && x0 < plane.width - 1 && y0 < plane.height - 1) {
+    const uint8_t* p00 = plane.data + y0 * plane.step + x0 * plane.channels;
+    const uint8_t* p10 = p00 + plane.step;
+    *coverage = 1.0f;
+    return weights[0] * p00[0] + weights[1] * p00[plane.channels] +
+           weights[2] * p10[0] + weights[3] * p10[plane.channels];
+  }
+  const uint8_t* taps[4] = {GetPixel<kBorderMode>(plane, x0, y0),
+                            GetPixel<kBorderMode>(plane, x0 + 1, y0),
+                            GetPixel<kBorderMode>(plane, x0, y0 + 1),
+                            GetPixel<kBorderMode>(plane, x0 + 1, y0 + 1)};
+  float value = 0.0f;
+  *coverage = 0.0f;
+  for (int i = 0; i < 4; ++i) {
+    if (taps[i] != nullptr) {
+      value += weights[i] * taps[i][0];
+      *coverage += weights[i];
+    }
+  }
+  return value;
+}
+
+// The planes of a YUV 4:2:0 image. The chroma planes may be interleaved, in
+// which case their channels is 2.
+struct YuvPlanes {
+  InputPlane y;
+  InputPlane u;
+  InputPlane v;
+};
+
+// Same as WarpAndNormalize, but samples a YUV 4:2:0 image and converts only
+// the sampled pixels to RGB, with the full-range JFIF coefficients used by
+// the frame_buffer YUV to RGB conversion. Single-channel output is the luma.
+// Chroma samples sit between luma samples, and are replicated at the border;
+// with a zero border, chroma is attenuated along with luma, so that the
+// border is black.
+template <typename T, int kChannels, BorderMode kBorderMode>
+void WarpYuvAndNormalize(const YuvPlanes& input, const AffineMap& map,
+                         int output_width, int output_height, float scale,
+                         float offset, T* output) {
+  for (int y = 0; y < output_height; ++y) {
+    const float row_x = map.x0 + y * map.dx_y;
+    const float row_y = map.y0 + y * map.dy_y;
+    for (int x = 0; x < output_width; ++x, output += kChannels) {
+      const float src_x = row_x + x * map.dx_x;
+      const float src_y = row_y + x * map.dy_x;
+      float coverage;
+      const float luma =
+          SamplePlane<kBorderMode>(input.y, src_x, src_y, &coverage);
+      if (kChannels == 1) {
+        output[0] = ToOutput<T>(luma * scale + offset);
+        continue;
+      }
+      const float chroma_x = 0.5f * src_x - 0.25f;
+      const float chroma_y = 0.5f * src_y - 0.25f;
+      float chroma_coverage;
+      const float u = (SamplePlane<BorderMode::kReplicate>(
+                           input.u, chroma_x, chroma_y, &chroma_coverage) -
+                       128.0f) *
+                      coverage;
+      const float v = (SamplePlane<BorderMode::kReplicate>(
+                           input.v, chroma_x, chroma_y, &chroma_coverage) -
+                       128.0f) *
+                      coverage;
+      const float rgb[3] = {luma + 1.402f * v,
+                            luma - 0.344136f * u - 0.714136f * v,
+                            luma + 1.772f * u};
+      for (int c = 0; c < kChannels; ++c) {
+        output[c] =
+            ToOutput<T>(std::clamp(rgb[c], 0.0f, 255.0f) * scale + offset);
+      }
+    }
+  }
+}
+
+template <typename T>
+void WarpYuvAndNormalize(const YuvPlanes& input, const AffineMap& map,
+                         int output_width, int output_height,
+                         int output_channels, BorderMode border_mode,
+                         float scale, float offset, T* output) {
+  if (output_channels == 1) {
+    if (border_mode == BorderMode::kZero) {
+      WarpYuvAndNormalize<T, 1, BorderMode::kZero>(
+          input, map, output_width, output_height, scale, offset, output);
+    } else {
+      WarpYuvAndNormalize<T, 1, BorderMode::kReplicate>(
+          input, map, output_width, output_height, scale, offset, output);
+    }
+  } else {
+    if (border_mode == BorderMode::kZero) {
+      WarpYuvAndNormalize<T, 3, BorderMode::kZero>(
+          input, map, output_width, output_height, scale, offset, output);
+    } else {
+      WarpYuvAndNormalize<T, 3, BorderMode::kReplicate>(
+          input, map, output_width, output_height, scale, offset, output);
+    }
+  }
+}
+
+// Returns the planes of a YUV image held in CPU memory.
+absl::StatusOr<YuvPlanes> GetYuvPlanes(const mediapipe::Image& input) {
+  auto frame_buffer =
+      input.GetGpuBuffer(/*upload_to_gpu=*/false).GetReadView<FrameBuffer>();
+  RET_CHECK(frame_buffer != nullptr);
+  ASSIGN_OR_RETURN(FrameBuffer::YuvData yuv_data,
+                   FrameBuffer::GetYuvDataFromFrameBuffer(*frame_buffer));
+  const int width = frame_buffer->dimension().width;
+  const int height = frame_buffer->dimension().height;
+  const int chroma_width = (width + 1) / 2;
+  const int chroma_height = (height + 1) / 2;
+  return YuvPlanes{
+      {yuv_data.y_buffer, width, height, yuv_data.y_row_stride,
+       /*channels=*/1},
+      {yuv_data.u_buffer, chroma_width, chroma_height, yuv_data.uv_row_stride,
+       yuv_data.uv_pixel_stride},
+      {yuv_data.v_buffer, chroma_width, chroma_height, yuv_data.uv_row_stride,
+       yuv_data.uv_pixel_stride}};
+}
+
+class CpuProcessor : public ImageToTensorConverter {
+ public:
+  CpuProcessor(BorderMode border_mode, Tensor::ElementType tensor_type)
+      : border_mode_(border_mode), tensor_type_(tensor_type) {}
+
+  absl::Status Convert(const mediapipe::Image& input, const RotatedRect& roi,
+                       float range_min, float range_max,
+                       int tensor_buffer_offset,
+                       Tensor& output_tensor) override {
+    const bool is_yuv = IsCpuYuvImage(input);
+    const bool is_supported_format =
+        is_yuv || input.image_format() == mediapipe::ImageFormat::FORMAT_SRGB ||
+        input.image_format() == mediapipe::ImageFormat::FORMAT_SRGBA ||
+        input.image_format() == mediapipe::ImageFormat::FORMAT_GRAY8;
+    if (!is_supported_format) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Unsupported format: ", static_cast<uint32_t>(input.image_format())));
+    }
+
+    RET_CHECK_GE(tensor_buffer_offset, 0)
+        << "The input tensor_buffer_offset needs to be non-negative.";
+    const auto& output_shape = output_tensor.shape();
+    MP_RETURN_IF_ERROR(ValidateTensorShape(output_shape));
+    RET_CHECK_EQ(output_tensor.element_type(), tensor_type_);
+
+    const int output_height = output_shape.dims[1];
+    const int output_width = output_shape.dims[2];
+    const int output_channels = output_shape.dims[3];
+    if (!is_yuv) {
+      RET_CHECK_LE(output_channels, input.channels())
+          << "Cannot produce " << output_channels << " channels from "
+          << input.channels();
+    }
+    const int num_elements_per_img =
+        output_height * output_width * output_channels;
+    RET_CHECK_EQ(tensor_buffer_offset % output_tensor.element_size(), 0);
+    RET_CHECK_LE(tensor_buffer_offset +
+                     num_elements_per_img * output_tensor.element_size(),
+                 output_tensor.bytes())
+        << "The buffer offset + the input image size is larger than the "
+           "allocated tensor buffer.";
+
+    constexpr float kInputImageRangeMin = 0.0f;
+    constexpr float kInputImageRangeMax = 255.0f;
+    ASSIGN_OR_RETURN(
+        auto transform,
+        GetValueRangeTransformation(kInputImageRangeMin, kInputImageRangeMax,
+                                    range_min, range_max));
+
+    const AffineMap map = GetAffineMap(roi, output_width, output_height);
+    auto buffer_view = output_tensor.GetCpuWriteView();
+    uint8_t* output = buffer_view.buffer<uint8_t>() + tensor_buffer_offset;
+    if (is_yuv) {
+      // Samples the YUV planes directly, without converting the whole image
+      // to RGB first.
+      ASSIGN_OR_RETURN(const YuvPlanes planes, GetYuvPlanes(input));
+      switch (tensor_type_) {
+        case Tensor::ElementType::kFloat32:
+          WarpYuvAndNormalize(planes, map, output_width, output_height,
+                              output_channels, border_mode_, transform.scale,
+                              transform.offset,
+                              reinterpret_cast<float*>(output));
+          break;
+        case Tensor::ElementType::kUInt8:
+          WarpYuvAndNormalize(planes, map, output_width, output_height,
+                              output_channels, border_mode_, transform.scale,
+                              transform.offset, output);
+          break;
+        case Tensor::ElementType::kInt8:
+          WarpYuvAndNormalize(planes, map, output_width, output_height,
+                              output_channels, border_mode_, transform.scale,
+                              transform.offset,
+                              reinterpret_cast<int8_t*>(output));
+          break;
+        default:
+          return absl::InvalidArgumentError(
+              absl::StrCat("Unsupported tensor type: ", tensor_type_));
+      }
+      return absl::OkStatus();
+    }
+
+    ImageFrameSharedPtr frame = input.GetImageFrameSharedPtr();
+    RET_CHECK(frame != nullptr);
+    const InputPlane plane = {frame->PixelData(), frame->Width(),
+                              frame->Height(), frame->WidthStep(),
+                              frame->NumberOfChannels()};
+    switch (tensor_type_) {
+      case Tensor::ElementType::kFloat32:
+        WarpAndNormalize(plane, map, output_width, output_height,
+                         output_channels, border_mode_, transform.scale,
+                         transform.offset, reinterpret_cast<float*>(output));
+        break;
+      case Tensor::ElementType::kUInt8:
+        WarpAndNormalize(plane, map, output_width, output_height,
+                         output_channels, border_mode_, transform.scale,
+                         transform.offset, output);
+        break;
+      case Tensor::ElementType::kInt8:
+        WarpAndNormalize(plane, map, output_width, output_height,
+                         output_channels, border_mode_, transform.scale,
+                         transform.offset, reinterpret_cast<int8_t*>(output));
+        break;
+      default:
+        return absl::InvalidArgumentError(
+            absl::StrCat("Unsupported tensor type: ", tensor_type_));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  absl::Status ValidateTensorShape(const Tensor::Shape& output_shape) {
+    RET_CHECK_EQ(output_shape.dims.size(), 4)
+        << "Wrong output dims size: " << output_shape.dims.size();
+    RET_CHECK_GE(output_shape.dims[0], 1)
+        << "The batch dimension needs to be equal or larger than 1.";
+    RET_CHECK(output_shape.dims[3] == 3 || output_shape.dims[3] == 1)
+        << "Wrong output channel: " << output_shape.dims[3];
+    return absl::OkStatus();
+  }
+
+  BorderMode border_mode_;
+  Tensor::ElementType tensor_type_;
+};
+
+}  // namespace
+
+bool IsCpuYuvImage(const mediapipe::Image& image) {
+  return image.GetGpuBuffer(/*upload_to_gpu=*/false)
+             .internal_storage<GpuBufferStorageYuvImage>() != nullptr;
+}
+
+absl::StatusOr<std::unique_ptr<ImageToTensorConverter>> CreateCpuConverter(
+    CalculatorContext* cc, BorderMode border_mode,
+    Tensor::ElementType tensor_type) {
+  if (tensor_type != Tensor::ElementType::kInt8 &&
+      tensor_type != Tensor::ElementType::kFloat32 &&
+      tensor_type != Tensor::ElementType::kUInt8) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Tensor type is currently not supported by CpuProcessor, type: ",
+        tensor_type));
+  }
+  return std::make_unique<CpuProcessor>(border_mode, tensor_type);
+}
+
+}  // namespace mediapipe
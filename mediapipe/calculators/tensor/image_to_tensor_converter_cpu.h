@@ -0,0 +1,45 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CONVERTER_CPU_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CONVERTER_CPU_H_
+
+#include <memory>
+
+#include "mediapipe/calculators/tensor/image_to_tensor_converter.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/port/statusor.h"
+
+namespace mediapipe {
+
+// Creates a CPU image-to-tensor converter which samples, normalizes and
+// stores each output element in a single pass over the output tensor, without
+// intermediate images. Supports SRGB, SRGBA and GRAY8 input, YUV input held in
+// CPU memory (see IsCpuYuvImage), and float32, int8 and uint8 output. Does not
+// depend on OpenCV.
+absl::StatusOr<std::unique_ptr<ImageToTensorConverter>> CreateCpuConverter(
+    CalculatorContext* cc, BorderMode border_mode,
+    Tensor::ElementType tensor_type);
+
+// Returns true if @image holds an NV12, NV21, YV12 or I420 image in CPU
+// memory. The CPU converter samples such images directly and converts only the
+// sampled pixels to RGB. They are held in a GpuBuffer, so they report
+// UsesGpu(), but must be processed on CPU.
+bool IsCpuYuvImage(const mediapipe::Image& image);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_IMAGE_TO_TENSOR_CONVERTER_CPU_H_
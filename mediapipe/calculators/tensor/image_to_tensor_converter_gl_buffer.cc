@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_converter.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_converter_gl_utils.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
@@ -268,6 +269,37 @@ class GlProcessor : public ImageToTensorConverter {
                        float range_min, float range_max,
                        int tensor_buffer_offset,
                        Tensor& output_tensor) override {
+    return ConvertRois(input, absl::MakeConstSpan(&roi, 1), range_min,
+                       range_max, tensor_buffer_offset, output_tensor);
+  }
+
+  absl::Status ConvertBatch(const mediapipe::Image& input,
+                            absl::Span<const RotatedRect> rois,
+                            float range_min, float range_max,
+                            Tensor& output_tensor) override {
+    RET_CHECK(!rois.empty());
+    RET_CHECK_EQ(output_tensor.shape().dims[0], static_cast<int>(rois.size()))
+        << "The batch dimension needs to match the number of regions.";
+    return ConvertRois(input, rois, range_min, range_max,
+                       /*tensor_buffer_offset=*/0, output_tensor);
+  }
+
+  ~GlProcessor() override {
+    gl_helper_.RunInGlContext([this]() {
+      // Release OpenGL resources.
+      extractor_ = nullptr;
+      command_queue_ = nullptr;
+    });
+  }
+
+ private:
+  // Extracts @rois into consecutive batch entries of @output_tensor, starting
+  // at @tensor_buffer_offset, sharing the source texture and the output
+  // buffer view among the regions.
+  absl::Status ConvertRois(const mediapipe::Image& input,
+                           absl::Span<const RotatedRect> rois, float range_min,
+                           float range_max, int tensor_buffer_offset,
+                           Tensor& output_tensor) {
     if (input.format() != mediapipe::GpuBufferFormat::kBGRA32 &&
         input.format() != mediapipe::GpuBufferFormat::kRGBAHalf64 &&
         input.format() != mediapipe::GpuBufferFormat::kRGBAFloat128 &&
@@ -279,7 +311,7 @@ class GlProcessor : public ImageToTensorConverter {
     MP_RETURN_IF_ERROR(ValidateTensorShape(output_shape));
 
     MP_RETURN_IF_ERROR(gl_helper_.RunInGlContext(
-        [this, &output_tensor, &input, &roi, &output_shape, range_min,
+        [this, &output_tensor, &input, rois, &output_shape, range_min,
          range_max, tensor_buffer_offset]() -> absl::Status {
           const int input_num_channels = input.channels();
           auto source_texture = gl_helper_.CreateSourceTexture(input);
@@ -300,17 +332,20 @@ class GlProcessor : public ImageToTensorConverter {
 
           const int output_size = output_tensor.bytes() / output_shape.dims[0];
           auto buffer_view = output_tensor.GetOpenGlBufferWriteView();
-          tflite::gpu::gl::GlBuffer output(GL_SHADER_STORAGE_BUFFER,
-                                           buffer_view.name(), output_size,
-                                           /*offset=*/tensor_buffer_offset,
-                                           /*has_ownership=*/false);
-          MP_RETURN_IF_ERROR(extractor_->ExtractSubRectToBuffer(
-              input_texture,
-              tflite::gpu::HW(source_texture.height(), source_texture.width()),
-              roi,
-              /*flip_horizontaly=*/false, transform.scale, transform.offset,
-              tflite::gpu::HW(output_shape.dims[1], output_shape.dims[2]),
-              command_queue_.get(), &output));
+          for (int i = 0; i < static_cast<int>(rois.size()); ++i) {
+            tflite::gpu::gl::GlBuffer output(
+                GL_SHADER_STORAGE_BUFFER, buffer_view.name(), output_size,
+                /*offset=*/tensor_buffer_offset + i * output_size,
+                /*has_ownership=*/false);
+            MP_RETURN_IF_ERROR(extractor_->ExtractSubRectToBuffer(
+                input_texture,
+                tflite::gpu::HW(source_texture.height(),
+                                source_texture.width()),
+                rois[i],
+                /*flip_horizontaly=*/false, transform.scale, transform.offset,
+                tflite::gpu::HW(output_shape.dims[1], output_shape.dims[2]),
+                command_queue_.get(), &output));
+          }
 
           return absl::OkStatus();
         }));
@@ -318,15 +353,6 @@ class GlProcessor : public ImageToTensorConverter {
     return absl::OkStatus();
   }
 
-  ~GlProcessor() override {
-    gl_helper_.RunInGlContext([this]() {
-      // Release OpenGL resources.
-      extractor_ = nullptr;
-      command_queue_ = nullptr;
-    });
-  }
-
- private:
   absl::Status ValidateTensorShape(const Tensor::Shape& output_shape) {
     RET_CHECK_EQ(output_shape.dims.size(), 4)
         << "Wrong output dims size: " << output_shape.dims.size();
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_converter.h"
 #include "mediapipe/calculators/tensor/image_to_tensor_utils.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -183,8 +184,10 @@ class SubRectExtractorMetal {
                        float alpha, float beta,
                        const tflite::gpu::HW& destination_size,
                        id<MTLCommandBuffer> command_buffer,
-                       id<MTLBuffer> destination) {
-    auto output_texture = MTLTextureWithBuffer(destination_size, destination);
+                       id<MTLBuffer> destination,
+                       NSUInteger destination_offset) {
+    auto output_texture =
+        MTLTextureWithBuffer(destination_size, destination, destination_offset);
     return InternalExecute(input_texture, sub_rect, flip_horizontaly, alpha,
                            beta, destination_size, command_buffer,
                            output_texture);
@@ -192,7 +195,7 @@ class SubRectExtractorMetal {
 
  private:
   id<MTLTexture> MTLTextureWithBuffer(const tflite::gpu::HW& size,
-                                      id<MTLBuffer> buffer) {
+                                      id<MTLBuffer> buffer, NSUInteger offset) {
     MTLTextureDescriptor* texture_desc = [MTLTextureDescriptor
         texture2DDescriptorWithPixelFormat:GetPixelFormat(output_format_)
                                      width:size.w
@@ -204,7 +207,7 @@ class SubRectExtractorMetal {
 
     id<MTLTexture> texture =
         [buffer newTextureWithDescriptor:texture_desc
-                                  offset:0
+                                  offset:offset
                              bytesPerRow:output_bytes_per_row];
     return texture;
   }
@@ -355,6 +358,28 @@ class MetalProcessor : public ImageToTensorConverter {
                        float range_min, float range_max,
                        int tensor_buffer_offset,
                        Tensor& output_tensor) override {
+    return ConvertRois(input, absl::MakeConstSpan(&roi, 1), range_min,
+                       range_max, tensor_buffer_offset, output_tensor);
+  }
+
+  absl::Status ConvertBatch(const mediapipe::Image& input,
+                            absl::Span<const RotatedRect> rois,
+                            float range_min, float range_max,
+                            Tensor& output_tensor) override {
+    RET_CHECK(!rois.empty());
+    RET_CHECK_EQ(output_tensor.shape().dims[0], static_cast<int>(rois.size()))
+        << "The batch dimension needs to match the number of regions.";
+    return ConvertRois(input, rois, range_min, range_max,
+                       /*tensor_buffer_offset=*/0, output_tensor);
+  }
+
+ private:
+  // Extracts @rois into consecutive batch entries of @output_tensor, starting
+  // at @tensor_buffer_offset, in a single command buffer.
+  absl::Status ConvertRois(const mediapipe::Image& input,
+                           absl::Span<const RotatedRect> rois, float range_min,
+                           float range_max, int tensor_buffer_offset,
+                           Tensor& output_tensor) {
     if (input.format() != mediapipe::GpuBufferFormat::kBGRA32 &&
         input.format() != mediapipe::GpuBufferFormat::kRGBAHalf64 &&
         input.format() != mediapipe::GpuBufferFormat::kRGBAFloat128) {
@@ -362,10 +387,17 @@ class MetalProcessor : public ImageToTensorConverter {
           "Only 4-channel texture input formats are supported, passed format: ",
           static_cast<uint32_t>(input.format())));
     }
-    RET_CHECK_EQ(tensor_buffer_offset, 0)
-        << "The non-zero tensor_buffer_offset input is not supported yet.";
     const auto& output_shape = output_tensor.shape();
     MP_RETURN_IF_ERROR(ValidateTensorShape(output_shape));
+    // Textures created from a buffer must start at an aligned offset.
+    const int output_size = output_tensor.bytes() / output_shape.dims[0];
+    const NSUInteger alignment = [metal_helper_.mtlDevice
+        minimumLinearTextureAlignmentForPixelFormat:GetPixelFormat(
+                                                        OutputFormat::kF32C4)];
+    RET_CHECK_EQ(tensor_buffer_offset % alignment, 0)
+        << "The tensor_buffer_offset must be a multiple of " << alignment;
+    RET_CHECK(rois.size() == 1 || output_size % alignment == 0)
+        << "The batch entry size must be a multiple of " << alignment;
 
     @autoreleasepool {
       id<MTLTexture> texture =
@@ -381,23 +413,24 @@ class MetalProcessor : public ImageToTensorConverter {
       id<MTLCommandBuffer> command_buffer = [metal_helper_ commandBuffer];
       const auto& buffer_view =
           MtlBufferView::GetWriteView(output_tensor, command_buffer);
-      MP_RETURN_IF_ERROR(extractor_->Execute(
-          texture, roi,
-          /*flip_horizontaly=*/false, transform.scale, transform.offset,
-          tflite::gpu::HW(output_shape.dims[1], output_shape.dims[2]),
-          command_buffer, buffer_view.buffer()));
+      for (int i = 0; i < static_cast<int>(rois.size()); ++i) {
+        MP_RETURN_IF_ERROR(extractor_->Execute(
+            texture, rois[i],
+            /*flip_horizontaly=*/false, transform.scale, transform.offset,
+            tflite::gpu::HW(output_shape.dims[1], output_shape.dims[2]),
+            command_buffer, buffer_view.buffer(),
+            tensor_buffer_offset + i * output_size));
+      }
       [command_buffer commit];
       return absl::OkStatus();
     }
   }
 
- private:
   absl::Status ValidateTensorShape(const Tensor::Shape& output_shape) {
     RET_CHECK_EQ(output_shape.dims.size(), 4)
         << "Wrong output dims size: " << output_shape.dims.size();
-    RET_CHECK_EQ(output_shape.dims[0], 1)
-        << "Handling batch dimension not equal to 1 is not implemented in this "
-           "converter.";
+    RET_CHECK_GE(output_shape.dims[0], 1)
+        << "The batch dimension needs to be greater or equal to 1.";
     RET_CHECK_EQ(output_shape.dims[3], 4)
         << "Wrong output channel: " << output_shape.dims[3];
     return absl::OkStatus();
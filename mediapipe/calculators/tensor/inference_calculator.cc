@@ -14,17 +14,21 @@
 
 #include "mediapipe/calculators/tensor/inference_calculator.h"
 
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/framework/tool/subgraph_expansion.h"
+#include "mediapipe/framework/port/ret_check.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
 
 namespace mediapipe {
 namespace api2 {
@@ -98,5 +102,47 @@ InferenceCalculator::GetOpResolverAsPacket(CalculatorContext* cc) {
           tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates>());
 }
 
+absl::StatusOr<std::vector<Tensor>>
+InferenceCalculator::CreateWarmupInputTensors(
+    const tflite::FlatBufferModel& model) {
+  const tflite::Model* flatbuffer = model.GetModel();
+  RET_CHECK(flatbuffer->subgraphs() && flatbuffer->subgraphs()->size() > 0)
+      << "The model has no subgraphs.";
+  const tflite::SubGraph* subgraph = flatbuffer->subgraphs()->Get(0);
+  std::vector<Tensor> input_tensors;
+  if (!subgraph->inputs()) return input_tensors;
+  for (const int32_t tensor_index : *subgraph->inputs()) {
+    const tflite::Tensor* tensor = subgraph->tensors()->Get(tensor_index);
+    Tensor::ElementType element_type;
+    switch (tensor->type()) {
+      case tflite::TensorType_FLOAT16:
+      case tflite::TensorType_FLOAT32:
+        element_type = Tensor::ElementType::kFloat32;
+        break;
+      case tflite::TensorType_UINT8:
+        element_type = Tensor::ElementType::kUInt8;
+        break;
+      case tflite::TensorType_INT8:
+        element_type = Tensor::ElementType::kInt8;
+        break;
+      case tflite::TensorType_INT32:
+        element_type = Tensor::ElementType::kInt32;
+        break;
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Unsupported input tensor type for warm-up: ",
+            tflite::EnumNameTensorType(tensor->type())));
+    }
+    std::vector<int> dims;
+    if (tensor->shape()) {
+      dims.assign(tensor->shape()->begin(), tensor->shape()->end());
+    }
+    input_tensors.emplace_back(element_type, Tensor::Shape(dims));
+    auto view = input_tensors.back().GetCpuWriteView();
+    std::memset(view.buffer<void>(), 0, input_tensors.back().bytes());
+  }
+  return input_tensors;
+}
+
 }  // namespace api2
 }  // namespace mediapipe
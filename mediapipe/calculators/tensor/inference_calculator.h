@@ -46,6 +46,13 @@ namespace api2 {
 //
 // Input:
 //  TENSORS - Vector of Tensors
+//  MODEL_UPDATE (optional) - A TfLite model that replaces the current one,
+//                            without restarting the graph. CPU and XNNPACK
+//                            only. The interpreters of the new model are
+//                            created and warmed up in the background, and
+//                            are used from the first input tensors that
+//                            arrive after they are ready. The previous
+//                            model keeps running until then.
 //
 // Output:
 //  TENSORS - Vector of Tensors
@@ -102,13 +109,15 @@ class InferenceCalculator : public NodeIntf {
   static constexpr SideInput<tflite::OpResolver>::Optional kSideInOpResolver{
       "OP_RESOLVER"};
   static constexpr SideInput<TfLiteModelPtr>::Optional kSideInModel{"MODEL"};
+  static constexpr Input<TfLiteModelPtr>::Optional kInModelUpdate{
+      "MODEL_UPDATE"};
   static constexpr Output<std::vector<Tensor>> kOutTensors{"TENSORS"};
   static constexpr SideInput<
       mediapipe::InferenceCalculatorOptions::Delegate>::Optional kDelegate{
       "DELEGATE"};
   MEDIAPIPE_NODE_CONTRACT(kInTensors, kSideInCustomOpResolver,
-                          kSideInOpResolver, kSideInModel, kOutTensors,
-                          kDelegate);
+                          kSideInOpResolver, kSideInModel, kInModelUpdate,
+                          kOutTensors, kDelegate);
 
  protected:
   using TfLiteDelegatePtr =
@@ -120,6 +129,11 @@ class InferenceCalculator : public NodeIntf {
 
   static absl::StatusOr<Packet<tflite::OpResolver>> GetOpResolverAsPacket(
       CalculatorContext* cc);
+
+  // Returns zero-filled CPU tensors shaped like the inputs of `model`, for the
+  // warm-up runs in Open(). Dynamic dimensions are 1.
+  static absl::StatusOr<std::vector<Tensor>> CreateWarmupInputTensors(
+      const tflite::FlatBufferModel& model);
 };
 
 struct InferenceCalculatorSelector : public InferenceCalculator {
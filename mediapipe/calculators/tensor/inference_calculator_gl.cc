@@ -92,9 +92,18 @@ absl::Status InferenceCalculatorGlImpl::GpuInferenceRunner::Init(
     const mediapipe::InferenceCalculatorOptions::Delegate& delegate_options) {
   MP_RETURN_IF_ERROR(LoadModel(cc));
   MP_RETURN_IF_ERROR(gpu_helper_.Open(cc));
+  const int num_warmup_runs =
+      cc->Options<mediapipe::InferenceCalculatorOptions>().num_warmup_runs();
   return gpu_helper_.RunInGlContext(
-      [this, &cc, &delegate_options]() -> absl::Status {
-        return LoadDelegateAndAllocateTensors(cc, delegate_options);
+      [this, &cc, &delegate_options, num_warmup_runs]() -> absl::Status {
+        MP_RETURN_IF_ERROR(
+            LoadDelegateAndAllocateTensors(cc, delegate_options));
+        // The input buffers are bound already, and their contents don't
+        // matter to the warm-up runs.
+        for (int i = 0; i < num_warmup_runs; ++i) {
+          RET_CHECK_EQ(interpreter_->Invoke(), kTfLiteOk);
+        }
+        return absl::OkStatus();
       });
 }
 
@@ -239,6 +248,8 @@ absl::Status InferenceCalculatorGlImpl::UpdateContract(CalculatorContract* cc) {
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   RET_CHECK(!options.model_path().empty() ^ kSideInModel(cc).IsConnected())
       << "Either model as side packet or model path in options is required.";
+  RET_CHECK(!kInModelUpdate(cc).IsConnected())
+      << "MODEL_UPDATE is only supported by the CPU and XNNPACK calculators.";
 
   return mediapipe::GlCalculatorHelper::UpdateContract(cc);
 }
@@ -126,9 +126,30 @@ absl::Status InferenceCalculatorGlAdvancedImpl::GpuInferenceRunner::Init(
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   MP_RETURN_IF_ERROR(on_disk_cache_helper_.Init(options, delegate.gpu()));
 
-  return gpu_helper_.RunInGlContext([this, &cc, &delegate]() -> absl::Status {
-    return InitTFLiteGPURunner(cc, delegate);
-  });
+  MP_RETURN_IF_ERROR(
+      gpu_helper_.RunInGlContext([this, &cc, &delegate]() -> absl::Status {
+        return InitTFLiteGPURunner(cc, delegate);
+      }));
+
+  if (options.num_warmup_runs() > 0) {
+    std::vector<Tensor> input_tensors;
+    MP_RETURN_IF_ERROR(
+        gpu_helper_.RunInGlContext([this, &input_tensors]() -> absl::Status {
+          for (const auto& shape : tflite_gpu_runner_->GetInputShapes()) {
+            input_tensors.emplace_back(
+                Tensor::ElementType::kFloat32,
+                Tensor::Shape{shape.b, shape.h, shape.w, shape.c});
+            // Allocates the buffer, whose contents don't matter to the
+            // warm-up runs.
+            input_tensors.back().GetOpenGlBufferWriteView();
+          }
+          return absl::OkStatus();
+        }));
+    for (int i = 0; i < options.num_warmup_runs(); ++i) {
+      MP_RETURN_IF_ERROR(Process(cc, input_tensors).status());
+    }
+  }
+  return absl::OkStatus();
 }
 
 absl::StatusOr<std::vector<Tensor>>
@@ -379,6 +400,8 @@ absl::Status InferenceCalculatorGlAdvancedImpl::UpdateContract(
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   RET_CHECK(!options.model_path().empty() ^ kSideInModel(cc).IsConnected())
       << "Either model as side packet or model path in options is required.";
+  RET_CHECK(!kInModelUpdate(cc).IsConnected())
+      << "MODEL_UPDATE is only supported by the CPU and XNNPACK calculators.";
 
   MP_RETURN_IF_ERROR(mediapipe::GlCalculatorHelper::UpdateContract(cc));
   return absl::OkStatus();
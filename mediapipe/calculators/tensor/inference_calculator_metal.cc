@@ -125,6 +125,8 @@ absl::Status InferenceCalculatorMetalImpl::UpdateContract(
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   RET_CHECK(!options.model_path().empty() ^ kSideInModel(cc).IsConnected())
       << "Either model as side packet or model path in options is required.";
+  RET_CHECK(!kInModelUpdate(cc).IsConnected())
+      << "MODEL_UPDATE is only supported by the CPU and XNNPACK calculators.";
 
   MP_RETURN_IF_ERROR([MPPMetalHelper updateContract:cc]);
   return absl::OkStatus();
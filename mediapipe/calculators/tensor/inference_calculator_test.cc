@@ -33,6 +33,7 @@
 #include "mediapipe/framework/port/parse_text_proto.h"
 #include "mediapipe/framework/port/status_matchers.h"  // NOLINT
 #include "mediapipe/framework/tool/validate_type.h"
+#include "mediapipe/util/tflite/tflite_model_loader.h"
 #include "tensorflow/lite/error_reporter.h"
 #include "tensorflow/lite/kernels/register.h"
 #include "tensorflow/lite/model.h"
@@ -180,6 +181,105 @@ TEST(InferenceCalculatorTest, ModelAsInputSidePacketSmokeTest) {
   DoSmokeTest(kGraphWithModelAsInputSidePacket);
 }
 
+// Tests that a node with several interpreters runs timestamps concurrently
+// and sends the outputs in timestamp order.
+TEST(InferenceCalculatorTest, InterpreterPoolKeepsOrder) {
+  constexpr int kNumPackets = 20;
+  for (absl::string_view delegate : {"tflite {}", "xnnpack {}"}) {
+    CalculatorGraphConfig graph_config =
+        ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrReplaceAll(
+            R"(
+              input_stream: "tensor_in"
+              node {
+                calculator: "InferenceCalculator"
+                input_stream: "TENSORS:tensor_in"
+                output_stream: "TENSORS:tensor_out"
+                max_in_flight: 4
+                options {
+                  [mediapipe.InferenceCalculatorOptions.ext] {
+                    model_path: "mediapipe/calculators/tensor/testdata/add.bin"
+                    num_interpreters: 4
+                    delegate { $delegate }
+                  }
+                }
+              }
+            )",
+            {{"$delegate", delegate}}));
+    std::vector<Packet> output_packets;
+    tool::AddVectorSink("tensor_out", &graph_config, &output_packets);
+    CalculatorGraph graph(graph_config);
+    MP_ASSERT_OK(graph.StartRun({}));
+    for (int i = 0; i < kNumPackets; ++i) {
+      MP_ASSERT_OK(graph.AddPacketToInputStream(
+          "tensor_in",
+          MakePacket<std::vector<Tensor>>(CreateInputs()).At(Timestamp(i))));
+    }
+    MP_ASSERT_OK(graph.CloseInputStream("tensor_in"));
+    MP_ASSERT_OK(graph.WaitUntilDone());
+
+    ASSERT_EQ(output_packets.size(), kNumPackets);
+    for (int i = 0; i < kNumPackets; ++i) {
+      EXPECT_EQ(output_packets[i].Timestamp(), Timestamp(i));
+      const Tensor& result =
+          output_packets[i].Get<std::vector<Tensor>>().front();
+      auto view = result.GetCpuReadView();
+      EXPECT_EQ(view.buffer<float>()[0], 3);
+    }
+  }
+}
+
+// Tests that a model update replaces the model of a running graph without
+// dropping inputs.
+TEST(InferenceCalculatorTest, SwapsModelWhileRunning) {
+  constexpr int kNumPackets = 10;
+  for (absl::string_view delegate : {"tflite {}", "xnnpack {}"}) {
+    CalculatorGraphConfig graph_config =
+        ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrReplaceAll(
+            R"(
+              input_stream: "tensor_in"
+              input_stream: "model_update"
+              node {
+                calculator: "InferenceCalculator"
+                input_stream: "TENSORS:tensor_in"
+                input_stream: "MODEL_UPDATE:model_update"
+                output_stream: "TENSORS:tensor_out"
+                options {
+                  [mediapipe.InferenceCalculatorOptions.ext] {
+                    model_path: "mediapipe/calculators/tensor/testdata/add.bin"
+                    delegate { $delegate }
+                  }
+                }
+              }
+            )",
+            {{"$delegate", delegate}}));
+    std::vector<Packet> output_packets;
+    tool::AddVectorSink("tensor_out", &graph_config, &output_packets);
+    CalculatorGraph graph(graph_config);
+    MP_ASSERT_OK(graph.StartRun({}));
+    for (int i = 0; i < kNumPackets; ++i) {
+      if (i == 3) {
+        MP_ASSERT_OK_AND_ASSIGN(
+            auto model, TfLiteModelLoader::LoadFromPath(
+                            "mediapipe/calculators/tensor/testdata/add.bin"));
+        MP_ASSERT_OK(graph.AddPacketToInputStream(
+            "model_update", api2::ToOldPacket(model).At(Timestamp(i))));
+      }
+      MP_ASSERT_OK(graph.AddPacketToInputStream(
+          "tensor_in",
+          MakePacket<std::vector<Tensor>>(CreateInputs()).At(Timestamp(i))));
+    }
+    MP_ASSERT_OK(graph.CloseAllInputStreams());
+    MP_ASSERT_OK(graph.WaitUntilDone());
+
+    ASSERT_EQ(output_packets.size(), kNumPackets);
+    for (int i = 0; i < kNumPackets; ++i) {
+      const Tensor& result =
+          output_packets[i].Get<std::vector<Tensor>>().front();
+      EXPECT_EQ(result.GetCpuReadView().buffer<float>()[0], 3);
+    }
+  }
+}
+
 void BM_InitializeCalculator(benchmark::State& state) {
   mediapipe::InferenceCalculatorOptions::Delegate delegate;
   delegate.mutable_tflite();
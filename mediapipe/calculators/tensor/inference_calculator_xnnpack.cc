@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -20,10 +21,15 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/batching_inference_runner.h"
 #include "mediapipe/calculators/tensor/inference_calculator.h"
 #include "mediapipe/calculators/tensor/inference_calculator_utils.h"
 #include "mediapipe/calculators/tensor/inference_interpreter_delegate_runner.h"
 #include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/calculators/tensor/inference_runner_pool.h"
+#include "mediapipe/calculators/tensor/swappable_inference_runner.h"
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
 #include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
 #include "tensorflow/lite/interpreter.h"
 
@@ -42,10 +48,20 @@ class InferenceCalculatorXnnpackImpl
 
  private:
   absl::StatusOr<std::unique_ptr<InferenceRunner>> CreateInferenceRunner(
-      CalculatorContext* cc);
-  absl::StatusOr<TfLiteDelegatePtr> CreateDelegate(CalculatorContext* cc);
-
+      CalculatorContext* cc, Packet<TfLiteModelPtr> model_packet,
+      int num_warmup_runs,
+      std::shared_ptr<XnnpackWeightsCache>* weights_cache);
+  absl::StatusOr<TfLiteDelegatePtr> CreateDelegate(
+      CalculatorContext* cc, const tflite::FlatBufferModel& model,
+      std::shared_ptr<XnnpackWeightsCache>* weights_cache);
+  // Starts loading the model of a MODEL_UPDATE packet.
+  void StartModelUpdate(CalculatorContext* cc);
+
+  // Shares the packed weights among the XNNPACK delegates of the interpreters.
+  std::shared_ptr<XnnpackWeightsCache> weights_cache_;
   std::unique_ptr<InferenceRunner> inference_runner_;
+  // Wraps inference_runner_ if MODEL_UPDATE is connected.
+  SwappableInferenceRunner* swappable_runner_ = nullptr;
 };
 
 absl::Status InferenceCalculatorXnnpackImpl::UpdateContract(
@@ -53,16 +69,34 @@ absl::Status InferenceCalculatorXnnpackImpl::UpdateContract(
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   RET_CHECK(!options.model_path().empty() ^ kSideInModel(cc).IsConnected())
       << "Either model as side packet or model path in options is required.";
+  RET_CHECK_GE(options.num_interpreters(), 1);
+  RET_CHECK_GE(options.batching().max_batch_size(), 1);
 
   return absl::OkStatus();
 }
 
 absl::Status InferenceCalculatorXnnpackImpl::Open(CalculatorContext* cc) {
-  ASSIGN_OR_RETURN(inference_runner_, CreateInferenceRunner(cc));
+  ASSIGN_OR_RETURN(auto model_packet, GetModelAsPacket(cc));
+  ASSIGN_OR_RETURN(
+      inference_runner_,
+      CreateInferenceRunner(
+          cc, model_packet,
+          cc->Options<mediapipe::InferenceCalculatorOptions>()
+              .num_warmup_runs(),
+          &weights_cache_));
+  if (kInModelUpdate(cc).IsConnected()) {
+    auto swappable_runner = std::make_unique<SwappableInferenceRunner>(
+        std::move(inference_runner_));
+    swappable_runner_ = swappable_runner.get();
+    inference_runner_ = std::move(swappable_runner);
+  }
   return absl::OkStatus();
 }
 
 absl::Status InferenceCalculatorXnnpackImpl::Process(CalculatorContext* cc) {
+  if (!kInModelUpdate(cc).IsEmpty()) {
+    StartModelUpdate(cc);
+  }
   if (kInTensors(cc).IsEmpty()) {
     return absl::OkStatus();
   }
@@ -77,23 +111,80 @@ absl::Status InferenceCalculatorXnnpackImpl::Process(CalculatorContext* cc) {
 
 absl::Status InferenceCalculatorXnnpackImpl::Close(CalculatorContext* cc) {
   inference_runner_ = nullptr;
+  swappable_runner_ = nullptr;
+  weights_cache_ = nullptr;
   return absl::OkStatus();
 }
 
+void InferenceCalculatorXnnpackImpl::StartModelUpdate(CalculatorContext* cc) {
+  Packet<TfLiteModelPtr> model_packet = kInModelUpdate(cc);
+  // The new interpreters are warmed up before they replace the current ones.
+  const int num_warmup_runs = std::max(
+      cc->Options<mediapipe::InferenceCalculatorOptions>().num_warmup_runs(),
+      1);
+  swappable_runner_->StartLoad(
+      [this, cc, model_packet,
+       num_warmup_runs]() -> absl::StatusOr<std::shared_ptr<InferenceRunner>> {
+        std::shared_ptr<XnnpackWeightsCache> weights_cache;
+        ASSIGN_OR_RETURN(std::unique_ptr<InferenceRunner> runner,
+                         CreateInferenceRunner(cc, model_packet,
+                                               num_warmup_runs,
+                                               &weights_cache));
+        // The weights cache must outlive the delegates of the runner.
+        return std::shared_ptr<InferenceRunner>(
+            runner.release(),
+            [weights_cache](InferenceRunner* released) { delete released; });
+      });
+}
+
 absl::StatusOr<std::unique_ptr<InferenceRunner>>
-InferenceCalculatorXnnpackImpl::CreateInferenceRunner(CalculatorContext* cc) {
-  ASSIGN_OR_RETURN(auto model_packet, GetModelAsPacket(cc));
+InferenceCalculatorXnnpackImpl::CreateInferenceRunner(
+    CalculatorContext* cc, Packet<TfLiteModelPtr> model_packet,
+    int num_warmup_runs, std::shared_ptr<XnnpackWeightsCache>* weights_cache) {
   ASSIGN_OR_RETURN(auto op_resolver_packet, GetOpResolverAsPacket(cc));
-  const int interpreter_num_threads =
-      cc->Options<mediapipe::InferenceCalculatorOptions>().cpu_num_thread();
-  ASSIGN_OR_RETURN(TfLiteDelegatePtr delegate, CreateDelegate(cc));
-  return CreateInferenceInterpreterDelegateRunner(
-      std::move(model_packet), std::move(op_resolver_packet),
-      std::move(delegate), interpreter_num_threads);
+  const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
+  std::vector<std::unique_ptr<InferenceRunner>> runners;
+  for (int i = 0; i < options.num_interpreters(); ++i) {
+    ASSIGN_OR_RETURN(TfLiteDelegatePtr delegate,
+                     CreateDelegate(cc, *model_packet.Get(), weights_cache));
+    ASSIGN_OR_RETURN(auto runner, CreateInferenceInterpreterDelegateRunner(
+                                      model_packet, op_resolver_packet,
+                                      std::move(delegate),
+                                      options.cpu_num_thread()));
+    runners.push_back(std::move(runner));
+  }
+  if (*weights_cache) {
+    MP_RETURN_IF_ERROR((*weights_cache)->Finalize());
+  }
+  if (num_warmup_runs > 0) {
+    ASSIGN_OR_RETURN(std::vector<Tensor> warmup_tensors,
+                     CreateWarmupInputTensors(*model_packet.Get()));
+    // Each interpreter plans its memory and touches its buffers on first run.
+    for (auto& runner : runners) {
+      for (int i = 0; i < num_warmup_runs; ++i) {
+        MP_RETURN_IF_ERROR(runner->Run(cc, warmup_tensors).status());
+      }
+    }
+  }
+  const int max_batch_size = options.batching().max_batch_size();
+  if (runners.size() == 1 && max_batch_size == 1) {
+    return std::move(runners.front());
+  }
+  // A pool also serializes the batches of a single interpreter.
+  std::unique_ptr<InferenceRunner> runner =
+      CreateInferenceRunnerPool(std::move(runners));
+  if (max_batch_size > 1) {
+    return CreateBatchingInferenceRunner(
+        std::move(runner), max_batch_size,
+        absl::Microseconds(options.batching().max_wait_us()));
+  }
+  return runner;
 }
 
 absl::StatusOr<TfLiteDelegatePtr>
-InferenceCalculatorXnnpackImpl::CreateDelegate(CalculatorContext* cc) {
+InferenceCalculatorXnnpackImpl::CreateDelegate(
+    CalculatorContext* cc, const tflite::FlatBufferModel& model,
+    std::shared_ptr<XnnpackWeightsCache>* weights_cache) {
   const auto& calculator_opts =
       cc->Options<mediapipe::InferenceCalculatorOptions>();
   auto opts_delegate = calculator_opts.delegate();
@@ -114,6 +205,17 @@ InferenceCalculatorXnnpackImpl::CreateDelegate(CalculatorContext* cc) {
   auto xnnpack_opts = TfLiteXNNPackDelegateOptionsDefault();
   xnnpack_opts.num_threads =
       GetXnnpackNumThreads(opts_has_delegate, opts_delegate);
+  const bool share_weights_cache =
+      opts_delegate.xnnpack().share_weights_cache();
+  if (calculator_opts.num_interpreters() > 1 || share_weights_cache) {
+    if (!*weights_cache) {
+      ASSIGN_OR_RETURN(*weights_cache,
+                       share_weights_cache
+                           ? XnnpackWeightsCache::GetShared(model)
+                           : XnnpackWeightsCache::Create());
+    }
+    xnnpack_opts.weights_cache = (*weights_cache)->get();
+  }
   return TfLiteDelegatePtr(TfLiteXNNPackDelegateCreate(&xnnpack_opts),
                            &TfLiteXNNPackDelegateDelete);
 }
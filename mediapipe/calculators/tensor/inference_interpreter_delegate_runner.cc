@@ -14,18 +14,27 @@
 
 #include "mediapipe/calculators/tensor/inference_interpreter_delegate_runner.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/mediapipe_profiling.h"
+#include "mediapipe/framework/port/aligned_malloc_and_free.h"
 #include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
 #include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/interpreter_builder.h"
 #include "tensorflow/lite/string_util.h"
+#include "tensorflow/lite/util.h"
 
 #define PERFETTO_TRACK_EVENT_NAMESPACE mediapipe
 
@@ -72,6 +81,42 @@ void CopyTensorBufferFromInterpreter(Interpreter* interpreter,
               output_tensor->bytes());
 }
 
+// Returns the Tensor element type with the same memory layout as a TfLite
+// type, or kNone if there is none.
+Tensor::ElementType BindableElementType(TfLiteType type) {
+  switch (type) {
+    case TfLiteType::kTfLiteFloat32:
+      return Tensor::ElementType::kFloat32;
+    case TfLiteType::kTfLiteUInt8:
+      return Tensor::ElementType::kUInt8;
+    case TfLiteType::kTfLiteInt8:
+      return Tensor::ElementType::kInt8;
+    case TfLiteType::kTfLiteInt32:
+      return Tensor::ElementType::kInt32;
+    case TfLiteType::kTfLiteBool:
+      return Tensor::ElementType::kBool;
+    default:
+      return Tensor::ElementType::kNone;
+  }
+}
+
+// Returns true if the interpreter can use a custom allocation for a tensor,
+// which is the case for input and output tensors allocated in the arena.
+bool IsBindable(const TfLiteTensor& tensor) {
+  return (tensor.allocation_type == kTfLiteArenaRw ||
+          tensor.allocation_type == kTfLiteCustom) &&
+         BindableElementType(tensor.type) != Tensor::ElementType::kNone;
+}
+
+// Returns true if the shape of a model tensor cannot be changed by resizing.
+bool HasStaticShape(const TfLiteTensor& tensor) {
+  if (tensor.dims_signature == nullptr) return true;
+  for (int i = 0; i < tensor.dims_signature->size; ++i) {
+    if (tensor.dims_signature->data[i] == -1) return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 class InferenceInterpreterDelegateRunner : public InferenceRunner {
@@ -81,17 +126,71 @@ class InferenceInterpreterDelegateRunner : public InferenceRunner {
                                      TfLiteDelegatePtr delegate)
       : model_(std::move(model)),
         interpreter_(std::move(interpreter)),
-        delegate_(std::move(delegate)) {}
+        delegate_(std::move(delegate)),
+        output_buffer_pool_(std::make_shared<Tensor::CpuBufferPool>()) {
+    // Tensor buffers stay valid for a custom allocation only as long as the
+    // model tensor sizes cannot change, so models with dynamic input shapes
+    // always copy.
+    bind_tensors_ = true;
+    for (int index : interpreter_->inputs()) {
+      bind_tensors_ &= HasStaticShape(*interpreter_->tensor(index));
+    }
+  }
 
   absl::StatusOr<std::vector<Tensor>> Run(
       CalculatorContext* cc, const std::vector<Tensor>& input_tensors) override;
 
  private:
+  // Binds a model tensor to a buffer, so that the interpreter reads or writes
+  // the buffer in place.
+  absl::Status BindTensor(int tensor_index, void* buffer, size_t bytes);
+  // Binds a model tensor that was bound to a Tensor buffer to a buffer owned
+  // by the runner, so that it can be copied into or from.
+  absl::Status UnbindTensor(int tensor_index);
+
   api2::Packet<TfLiteModelPtr> model_;
   std::unique_ptr<Interpreter> interpreter_;
   TfLiteDelegatePtr delegate_;
+  // Input and output tensors are bound to Tensor CPU buffers if true.
+  bool bind_tensors_;
+  // Tensors were newly bound since the interpreter allocated tensors.
+  bool needs_allocate_tensors_ = false;
+  // Provides the CPU buffers of output Tensors.
+  std::shared_ptr<Tensor::CpuBufferPool> output_buffer_pool_;
+  // Buffers for model tensors that are unbound from Tensor buffers.
+  absl::flat_hash_map<int, std::unique_ptr<void, void (*)(void*)>>
+      unbound_buffers_;
 };
 
+absl::Status InferenceInterpreterDelegateRunner::BindTensor(int tensor_index,
+                                                            void* buffer,
+                                                            size_t bytes) {
+  TfLiteTensor* tensor = interpreter_->tensor(tensor_index);
+  if (tensor->allocation_type != kTfLiteCustom) {
+    needs_allocate_tensors_ = true;
+  } else if (tensor->data.raw == buffer) {
+    return absl::OkStatus();
+  }
+  RET_CHECK_EQ(interpreter_->SetCustomAllocationForTensor(
+                   tensor_index, TfLiteCustomAllocation{buffer, bytes}),
+               kTfLiteOk);
+  return absl::OkStatus();
+}
+
+absl::Status InferenceInterpreterDelegateRunner::UnbindTensor(
+    int tensor_index) {
+  TfLiteTensor* tensor = interpreter_->tensor(tensor_index);
+  if (tensor->allocation_type != kTfLiteCustom) return absl::OkStatus();
+  auto& buffer =
+      unbound_buffers_.try_emplace(tensor_index, nullptr, &aligned_free)
+          .first->second;
+  if (!buffer) {
+    buffer.reset(
+        aligned_malloc(tensor->bytes, tflite::kDefaultTensorAlignment));
+  }
+  return BindTensor(tensor_index, buffer.get(), tensor->bytes);
+}
+
 absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
     CalculatorContext* cc, const std::vector<Tensor>& input_tensors) {
   // Read CPU input into tensors.
@@ -102,14 +201,78 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
   bool resized_tensor_shapes = false;
   for (int i = 0; i < input_tensors.size(); ++i) {
     if (input_tensors[i].shape().is_dynamic) {
-      interpreter_->ResizeInputTensorStrict(i, input_tensors[i].shape().dims);
+      const int tensor_index = interpreter_->inputs()[i];
+      RET_CHECK_EQ(interpreter_->ResizeInputTensorStrict(
+                       tensor_index, input_tensors[i].shape().dims),
+                   kTfLiteOk)
+          << "Input tensor " << i << " cannot be resized.";
       resized_tensor_shapes = true;
     }
   }
   // Reallocation is needed for memory sanity.
-  if (resized_tensor_shapes) interpreter_->AllocateTensors();
+  if (resized_tensor_shapes) {
+    RET_CHECK_EQ(interpreter_->AllocateTensors(), kTfLiteOk);
+  }
+
+  // Inputs are bound to the CPU buffers of input Tensors, and outputs to the
+  // CPU buffers of new output Tensors, where the types and sizes match. The
+  // views keep the buffers mapped until inference is done.
+  std::vector<std::optional<Tensor>> bound_output_tensors(
+      interpreter_->outputs().size());
+  std::vector<Tensor::CpuReadView> input_views;
+  std::vector<Tensor::CpuWriteView> output_views;
+  std::vector<bool> input_is_bound(input_tensors.size(), false);
+  for (int i = 0; i < input_tensors.size(); ++i) {
+    const int tensor_index = interpreter_->inputs()[i];
+    const TfLiteTensor* tensor = interpreter_->tensor(tensor_index);
+    if (bind_tensors_ && IsBindable(*tensor) &&
+        BindableElementType(tensor->type) ==
+            input_tensors[i].element_type() &&
+        tensor->bytes == input_tensors[i].bytes()) {
+      auto view = input_tensors[i].GetCpuReadView();
+      // The interpreter does not write to input tensors.
+      void* buffer = const_cast<void*>(view.buffer<void>());
+      if (reinterpret_cast<uintptr_t>(buffer) %
+              tflite::kDefaultTensorAlignment ==
+          0) {
+        MP_RETURN_IF_ERROR(BindTensor(tensor_index, buffer, tensor->bytes));
+        input_views.push_back(std::move(view));
+        input_is_bound[i] = true;
+        continue;
+      }
+    }
+    MP_RETURN_IF_ERROR(UnbindTensor(tensor_index));
+  }
+  for (int i = 0; i < interpreter_->outputs().size(); ++i) {
+    const int tensor_index = interpreter_->outputs()[i];
+    const TfLiteTensor* tensor = interpreter_->tensor(tensor_index);
+    if (bind_tensors_ && IsBindable(*tensor) &&
+        !absl::c_linear_search(interpreter_->inputs(), tensor_index)) {
+      Tensor::Shape shape{std::vector<int>{
+          tensor->dims->data, tensor->dims->data + tensor->dims->size}};
+      Tensor::QuantizationParameters quantization_parameters;
+      if (tensor->type == kTfLiteUInt8 || tensor->type == kTfLiteInt8) {
+        quantization_parameters = Tensor::QuantizationParameters{
+            tensor->params.scale, tensor->params.zero_point};
+      }
+      Tensor& output_tensor = bound_output_tensors[i].emplace(
+          BindableElementType(tensor->type), shape, quantization_parameters,
+          output_buffer_pool_);
+      output_views.push_back(output_tensor.GetCpuWriteView());
+      MP_RETURN_IF_ERROR(BindTensor(
+          tensor_index, output_views.back().buffer<void>(), tensor->bytes));
+    } else {
+      MP_RETURN_IF_ERROR(UnbindTensor(tensor_index));
+    }
+  }
+  // Newly bound tensors are validated by the next allocation.
+  if (needs_allocate_tensors_) {
+    RET_CHECK_EQ(interpreter_->AllocateTensors(), kTfLiteOk);
+    needs_allocate_tensors_ = false;
+  }
 
   for (int i = 0; i < input_tensors.size(); ++i) {
+    if (input_is_bound[i]) continue;
     const TfLiteType input_tensor_type =
         interpreter_->tensor(interpreter_->inputs()[i])->type;
     switch (input_tensor_type) {
@@ -153,18 +316,26 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
     MEDIAPIPE_PROFILING(CPU_TASK_INVOKE, cc);
     RET_CHECK_EQ(interpreter_->Invoke(), kTfLiteOk);
   }
+  input_views.clear();
+  output_views.clear();
   // Output result tensors (CPU).
   const auto& tensor_indexes = interpreter_->outputs();
   std::vector<Tensor> output_tensors;
   output_tensors.reserve(tensor_indexes.size());
   for (int i = 0; i < tensor_indexes.size(); ++i) {
+    if (bound_output_tensors[i]) {
+      output_tensors.push_back(std::move(*bound_output_tensors[i]));
+      continue;
+    }
     TfLiteTensor* tensor = interpreter_->tensor(tensor_indexes[i]);
     Tensor::Shape shape{std::vector<int>{
         tensor->dims->data, tensor->dims->data + tensor->dims->size}};
     switch (tensor->type) {
       case TfLiteType::kTfLiteFloat16:
       case TfLiteType::kTfLiteFloat32:
-        output_tensors.emplace_back(Tensor::ElementType::kFloat32, shape);
+        output_tensors.emplace_back(Tensor::ElementType::kFloat32, shape,
+                                    Tensor::QuantizationParameters(),
+                                    output_buffer_pool_);
         CopyTensorBufferFromInterpreter<float>(interpreter_.get(), i,
                                                &output_tensors.back());
         break;
@@ -172,7 +343,8 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
         output_tensors.emplace_back(
             Tensor::ElementType::kUInt8, shape,
             Tensor::QuantizationParameters{tensor->params.scale,
-                                           tensor->params.zero_point});
+                                           tensor->params.zero_point},
+            output_buffer_pool_);
         CopyTensorBufferFromInterpreter<uint8_t>(interpreter_.get(), i,
                                                  &output_tensors.back());
         break;
@@ -180,18 +352,22 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
         output_tensors.emplace_back(
             Tensor::ElementType::kInt8, shape,
             Tensor::QuantizationParameters{tensor->params.scale,
-                                           tensor->params.zero_point});
+                                           tensor->params.zero_point},
+            output_buffer_pool_);
         CopyTensorBufferFromInterpreter<int8_t>(interpreter_.get(), i,
                                                 &output_tensors.back());
         break;
       case TfLiteType::kTfLiteInt32:
-        output_tensors.emplace_back(Tensor::ElementType::kInt32, shape);
+        output_tensors.emplace_back(Tensor::ElementType::kInt32, shape,
+                                    Tensor::QuantizationParameters(),
+                                    output_buffer_pool_);
         CopyTensorBufferFromInterpreter<int32_t>(interpreter_.get(), i,
                                                  &output_tensors.back());
         break;
       case TfLiteType::kTfLiteBool:
         output_tensors.emplace_back(Tensor::ElementType::kBool, shape,
-                                    Tensor::QuantizationParameters{1.0f, 0});
+                                    Tensor::QuantizationParameters{1.0f, 0},
+                                    output_buffer_pool_);
         CopyTensorBufferFromInterpreter<bool>(interpreter_.get(), i,
                                               &output_tensors.back());
         break;
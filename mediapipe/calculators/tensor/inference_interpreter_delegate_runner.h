@@ -33,6 +33,10 @@ namespace mediapipe {
 //
 // `delegate` can be nullptr, in that case newly initialized interpreter will
 // use what is available by default.
+//
+// For models with static input shapes, the interpreter reads the CPU buffers
+// of input Tensors and writes the CPU buffers of output Tensors in place,
+// instead of copying them.
 absl::StatusOr<std::unique_ptr<InferenceRunner>>
 CreateInferenceInterpreterDelegateRunner(
     api2::Packet<TfLiteModelPtr> model,
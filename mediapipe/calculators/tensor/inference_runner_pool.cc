@@ -0,0 +1,73 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/inference_runner_pool.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/calculator_context.h"
+#include "mediapipe/framework/formats/tensor.h"
+
+namespace mediapipe {
+
+namespace {
+
+class InferenceRunnerPool : public InferenceRunner {
+ public:
+  explicit InferenceRunnerPool(
+      std::vector<std::unique_ptr<InferenceRunner>> runners)
+      : runners_(std::move(runners)) {
+    for (const auto& runner : runners_) {
+      free_runners_.push_back(runner.get());
+    }
+  }
+
+  absl::StatusOr<std::vector<Tensor>> Run(
+      CalculatorContext* cc, const std::vector<Tensor>& inputs) override {
+    InferenceRunner* runner;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(this, &InferenceRunnerPool::HasFreeRunner));
+      runner = free_runners_.back();
+      free_runners_.pop_back();
+    }
+    absl::StatusOr<std::vector<Tensor>> result = runner->Run(cc, inputs);
+    absl::MutexLock lock(&mutex_);
+    free_runners_.push_back(runner);
+    return result;
+  }
+
+ private:
+  bool HasFreeRunner() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !free_runners_.empty();
+  }
+
+  const std::vector<std::unique_ptr<InferenceRunner>> runners_;
+  absl::Mutex mutex_;
+  std::vector<InferenceRunner*> free_runners_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+std::unique_ptr<InferenceRunner> CreateInferenceRunnerPool(
+    std::vector<std::unique_ptr<InferenceRunner>> runners) {
+  return std::make_unique<InferenceRunnerPool>(std::move(runners));
+}
+
+}  // namespace mediapipe
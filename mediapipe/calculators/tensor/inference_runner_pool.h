@@ -0,0 +1,33 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_RUNNER_POOL_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_RUNNER_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "mediapipe/calculators/tensor/inference_runner.h"
+
+namespace mediapipe {
+
+// Creates an inference runner that runs each inference on one of `runners`
+// that is not busy, so that up to runners.size() inferences can run
+// concurrently. Run() blocks while all of the runners are busy.
+std::unique_ptr<InferenceRunner> CreateInferenceRunnerPool(
+    std::vector<std::unique_ptr<InferenceRunner>> runners);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_RUNNER_POOL_H_
@@ -12,14 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstdint>
-#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/regex_preprocessor_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/api2/port.h"
@@ -55,7 +56,8 @@ using ::mediapipe::tasks::metadata::ModelMetadataExtractor;
 //     be the ids of the tokens of the input text. Any out-of-vocab tokens will
 //     have the id of the <UNKNOWN> token. The tensor will be padded with the
 //     <PAD> token id to have size equal to the max sequence length for the text
-//     model.
+//     model, or if the model's input tensor is dynamic, to the number of tokens
+//     rounded up to a multiple of `seq_len_bucket_size`, if set.
 //
 // Example:
 // node {
@@ -84,14 +86,28 @@ class RegexPreprocessorCalculator : public Node {
 
  private:
   std::unique_ptr<tasks::text::tokenizers::RegexTokenizer> tokenizer_;
-  // The max sequence length accepted by the text model.
+  // The max sequence length accepted by the text model if its input tensor is
+  // static.
   int max_seq_len_ = 0;
+  // Whether the model's input tensor shape is dynamic.
+  bool has_dynamic_input_tensors_ = false;
+  // The multiple that the size of a dynamic input tensor is rounded up to.
+  int seq_len_bucket_size_ = 0;
+  int pad_token_id_ = 0;
+  int start_token_id_ = 0;
+  bool has_start_token_ = false;
+  // Ids of the tokens of the input text if the input tensor is dynamic,
+  // reused across Process calls.
+  std::vector<int32_t> dynamic_input_ids_;
 };
 
 absl::Status RegexPreprocessorCalculator::UpdateContract(
     CalculatorContract* cc) {
   const auto& options =
       cc->Options<mediapipe::RegexPreprocessorCalculatorOptions>();
+  if (options.has_dynamic_input_tensors()) {
+    return absl::OkStatus();
+  }
   RET_CHECK(options.has_max_seq_len()) << "max_seq_len is required";
   RET_CHECK_GT(options.max_seq_len(), 0) << "max_seq_len must be positive";
   return absl::OkStatus();
@@ -122,35 +138,33 @@ absl::Status RegexPreprocessorCalculator::Open(CalculatorContext* cc) {
   const auto& options =
       cc->Options<mediapipe::RegexPreprocessorCalculatorOptions>();
   max_seq_len_ = options.max_seq_len();
+  has_dynamic_input_tensors_ = options.has_dynamic_input_tensors();
+  seq_len_bucket_size_ = options.seq_len_bucket_size();
+  tokenizer_->GetPadToken(&pad_token_id_);
+  has_start_token_ = tokenizer_->GetStartToken(&start_token_id_);
   return absl::OkStatus();
 }
 
 absl::Status RegexPreprocessorCalculator::Process(CalculatorContext* cc) {
-  tasks::text::tokenizers::TokenizerResult tokenizer_result =
-      tokenizer_->Tokenize(kTextIn(cc).Get());
-
-  int unknown_token_id = 0;
-  tokenizer_->GetUnknownToken(&unknown_token_id);
-  int pad_token_id = 0;
-  tokenizer_->GetPadToken(&pad_token_id);
-
-  std::vector<int> input_tokens(max_seq_len_, pad_token_id);
-  int start_token_id = 0;
-  int input_token_index = 0;
-  if (tokenizer_->GetStartToken(&start_token_id)) {
-    input_tokens[0] = start_token_id;
-    input_token_index = 1;
-  }
-
-  for (int i = 0; (i < tokenizer_result.subwords.size()) &&
-                  (input_token_index < max_seq_len_);
-       ++i, ++input_token_index) {
-    const std::string& token = tokenizer_result.subwords[i];
-    int token_id = 0;
-    if (tokenizer_->LookupId(token, &token_id)) {
-      input_tokens[input_token_index] = token_id;
-    } else {
-      input_tokens[input_token_index] = unknown_token_id;
+  const std::string& text = kTextIn(cc).Get();
+  const int first_token_index = has_start_token_ ? 1 : 0;
+  int tensor_size = max_seq_len_;
+  int num_tokens = 0;
+  if (has_dynamic_input_tensors_) {
+    // Tokens are separated by delimiters, so a single pass is usually enough.
+    dynamic_input_ids_.resize(text.size() / 2 + 1);
+    num_tokens = tokenizer_->TokenizeIntoIds(
+        text, absl::MakeSpan(dynamic_input_ids_));
+    if (num_tokens > dynamic_input_ids_.size()) {
+      dynamic_input_ids_.resize(num_tokens);
+      num_tokens = tokenizer_->TokenizeIntoIds(
+          text, absl::MakeSpan(dynamic_input_ids_));
+    }
+    // Empty inputs are padded to a single token.
+    tensor_size = std::max(num_tokens + first_token_index, 1);
+    if (seq_len_bucket_size_ > 0) {
+      tensor_size = (tensor_size + seq_len_bucket_size_ - 1) /
+                    seq_len_bucket_size_ * seq_len_bucket_size_;
     }
   }
 
@@ -160,9 +174,24 @@ absl::Status RegexPreprocessorCalculator::Process(CalculatorContext* cc) {
   // not found in the tokenizer vocab.
   std::vector<Tensor> result;
   result.push_back(
-      {Tensor::ElementType::kInt32, Tensor::Shape({1, max_seq_len_})});
-  std::memcpy(result[0].GetCpuWriteView().buffer<int32_t>(),
-              input_tokens.data(), input_tokens.size() * sizeof(int32_t));
+      {Tensor::ElementType::kInt32,
+       Tensor::Shape({1, tensor_size}, has_dynamic_input_tensors_)});
+  {
+    auto view = result[0].GetCpuWriteView();
+    int32_t* input_tokens = view.buffer<int32_t>();
+    std::fill_n(input_tokens, tensor_size, pad_token_id_);
+    if (has_start_token_) {
+      input_tokens[0] = start_token_id_;
+    }
+    if (has_dynamic_input_tensors_) {
+      std::copy_n(dynamic_input_ids_.data(), num_tokens,
+                  input_tokens + first_token_index);
+    } else if (tensor_size > first_token_index) {
+      tokenizer_->TokenizeIntoIds(
+          text, absl::MakeSpan(input_tokens + first_token_index,
+                               tensor_size - first_token_index));
+    }
+  }
   kTensorsOut(cc).Send(std::move(result));
   return absl::OkStatus();
 }
@@ -44,7 +44,8 @@ constexpr char kTestModelPath[] =
     "test_model_text_classifier_with_regex_tokenizer.tflite";
 
 absl::StatusOr<std::vector<int>> RunRegexPreprocessorCalculator(
-    absl::string_view text) {
+    absl::string_view text, bool has_dynamic_input_tensors = false,
+    int tensor_size = kMaxSeqLen, int seq_len_bucket_size = 0) {
   auto graph_config =
       ParseTextProtoOrDie<CalculatorGraphConfig>(absl::Substitute(
           R"pb(
@@ -58,11 +59,13 @@ absl::StatusOr<std::vector<int>> RunRegexPreprocessorCalculator(
               options {
                 [mediapipe.RegexPreprocessorCalculatorOptions.ext] {
                   max_seq_len: $0
+                  has_dynamic_input_tensors: $1
+                  seq_len_bucket_size: $2
                 }
               }
             }
           )pb",
-          kMaxSeqLen));
+          kMaxSeqLen, has_dynamic_input_tensors, seq_len_bucket_size));
   std::vector<Packet> output_packets;
   tool::AddVectorSink("tensors", &graph_config, &output_packets);
 
@@ -94,8 +97,13 @@ absl::StatusOr<std::vector<int>> RunRegexPreprocessorCalculator(
   if (tensor_vec[0].element_type() != Tensor::ElementType::kInt32) {
     return absl::InvalidArgumentError("Expected tensor element type kInt32");
   }
+  if (tensor_vec[0].shape().num_elements() != tensor_size) {
+    return absl::InvalidArgumentError(
+        absl::Substitute("Tensor has $0 elements, expected $1",
+                         tensor_vec[0].shape().num_elements(), tensor_size));
+  }
   auto* buffer = tensor_vec[0].GetCpuReadView().buffer<int>();
-  std::vector<int> result(buffer, buffer + kMaxSeqLen);
+  std::vector<int> result(buffer, buffer + tensor_size);
   MP_RETURN_IF_ERROR(graph.CloseAllPacketSources());
   MP_RETURN_IF_ERROR(graph.WaitUntilDone());
   return result;
@@ -111,6 +119,20 @@ TEST(RegexPreprocessorCalculatorTest, TextClassifierModel) {
   EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
 }
 
+TEST(RegexPreprocessorCalculatorTest, DynamicInputTensorsWithBuckets) {
+  constexpr int kBucketSize = 16;
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::vector<int> processed_tensor_values,
+      RunRegexPreprocessorCalculator("This is the best movie I’ve seen in "
+                                     "recent years. Strongly recommend it!",
+                                     /*has_dynamic_input_tensors=*/true,
+                                     /*tensor_size=*/kBucketSize,
+                                     /*seq_len_bucket_size=*/kBucketSize));
+  static const int expected_result[kBucketSize] = {
+      1, 2, 9, 4, 118, 20, 2, 2, 110, 11, 1136, 153, 2, 386, 12};
+  EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
+}
+
 TEST(RegexPreprocessorCalculatorTest, LongInput) {
   std::stringstream long_input;
   long_input << "This is the best";
@@ -0,0 +1,67 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/swappable_inference_runner.h"
+
+#include <utility>
+
+namespace mediapipe {
+
+SwappableInferenceRunner::SwappableInferenceRunner(
+    std::unique_ptr<InferenceRunner> runner)
+    : runner_(std::move(runner)) {}
+
+SwappableInferenceRunner::~SwappableInferenceRunner() {
+  std::thread load_thread;
+  {
+    absl::MutexLock lock(&mutex_);
+    load_thread = std::move(load_thread_);
+  }
+  if (load_thread.joinable()) load_thread.join();
+}
+
+void SwappableInferenceRunner::StartLoad(LoadFunction load) {
+  std::thread previous_load_thread;
+  {
+    absl::MutexLock lock(&mutex_);
+    previous_load_thread = std::move(load_thread_);
+    const int load_index = ++load_count_;
+    load_thread_ = std::thread([this, load = std::move(load), load_index]() {
+      absl::StatusOr<std::shared_ptr<InferenceRunner>> runner = load();
+      absl::MutexLock lock(&mutex_);
+      if (load_index == load_count_) loaded_ = std::move(runner);
+    });
+  }
+  // The previous load is discarded when it finishes.
+  if (previous_load_thread.joinable()) previous_load_thread.join();
+}
+
+absl::StatusOr<std::vector<Tensor>> SwappableInferenceRunner::Run(
+    CalculatorContext* cc, const std::vector<Tensor>& inputs) {
+  std::shared_ptr<InferenceRunner> runner;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (loaded_.has_value()) {
+      absl::StatusOr<std::shared_ptr<InferenceRunner>> loaded =
+          *std::move(loaded_);
+      loaded_.reset();
+      if (!loaded.ok()) return loaded.status();
+      runner_ = *std::move(loaded);
+    }
+    runner = runner_;
+  }
+  return runner->Run(cc, inputs);
+}
+
+}  // namespace mediapipe
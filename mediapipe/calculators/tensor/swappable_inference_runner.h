@@ -0,0 +1,69 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_SWAPPABLE_INFERENCE_RUNNER_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_SWAPPABLE_INFERENCE_RUNNER_H_
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/framework/calculator_context.h"
+#include "mediapipe/framework/formats/tensor.h"
+
+namespace mediapipe {
+
+// Runs inferences with a runner that can be replaced while inferences are
+// running, such as with the runner of a new model. The new runner is created
+// and warmed up on a background thread, and replaces the current one at the
+// start of the first Run() after it is ready. Inferences that are already
+// running finish with the previous runner, which is released after the last
+// of them.
+class SwappableInferenceRunner : public InferenceRunner {
+ public:
+  using LoadFunction =
+      std::function<absl::StatusOr<std::shared_ptr<InferenceRunner>>()>;
+
+  explicit SwappableInferenceRunner(std::unique_ptr<InferenceRunner> runner);
+  // Waits for the running load to finish.
+  ~SwappableInferenceRunner() override;
+
+  // Starts creating a runner with `load` on a background thread. If another
+  // load has not been swapped in yet, the runner of this one replaces it.
+  void StartLoad(LoadFunction load);
+
+  // Runs an inference, first swapping in the runner of a finished load. If
+  // the load failed, returns its error once, and keeps the current runner.
+  absl::StatusOr<std::vector<Tensor>> Run(
+      CalculatorContext* cc, const std::vector<Tensor>& inputs) override;
+
+ private:
+  absl::Mutex mutex_;
+  std::shared_ptr<InferenceRunner> runner_ ABSL_GUARDED_BY(mutex_);
+  std::thread load_thread_ ABSL_GUARDED_BY(mutex_);
+  // Counts the loads, so that only the last one is swapped in.
+  int load_count_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::optional<absl::StatusOr<std::shared_ptr<InferenceRunner>>> loaded_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_SWAPPABLE_INFERENCE_RUNNER_H_
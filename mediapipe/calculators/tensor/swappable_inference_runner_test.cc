@@ -0,0 +1,98 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/swappable_inference_runner.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+// Outputs a tensor holding its id.
+class IdRunner : public InferenceRunner {
+ public:
+  explicit IdRunner(int id) : id_(id) {}
+
+  absl::StatusOr<std::vector<Tensor>> Run(
+      CalculatorContext* cc, const std::vector<Tensor>& inputs) override {
+    std::vector<Tensor> outputs;
+    outputs.emplace_back(Tensor::ElementType::kInt32, Tensor::Shape{1});
+    outputs[0].GetCpuWriteView().buffer<int>()[0] = id_;
+    return outputs;
+  }
+
+ private:
+  const int id_;
+};
+
+absl::StatusOr<int> RunId(InferenceRunner& runner) {
+  ASSIGN_OR_RETURN(std::vector<Tensor> outputs,
+                   runner.Run(/*cc=*/nullptr, std::vector<Tensor>()));
+  return outputs[0].GetCpuReadView().buffer<int>()[0];
+}
+
+TEST(SwappableInferenceRunnerTest, SwapsInLoadedRunner) {
+  SwappableInferenceRunner runner(std::make_unique<IdRunner>(1));
+  absl::Notification release_load;
+  runner.StartLoad(
+      [&release_load]() -> absl::StatusOr<std::shared_ptr<InferenceRunner>> {
+        release_load.WaitForNotification();
+        return std::make_shared<IdRunner>(2);
+      });
+  // The current runner keeps running while the new one loads.
+  MP_ASSERT_OK_AND_ASSIGN(int id, RunId(runner));
+  EXPECT_EQ(id, 1);
+
+  release_load.Notify();
+  while (id == 1) {
+    absl::SleepFor(absl::Milliseconds(1));
+    MP_ASSERT_OK_AND_ASSIGN(id, RunId(runner));
+  }
+  EXPECT_EQ(id, 2);
+  MP_ASSERT_OK_AND_ASSIGN(id, RunId(runner));
+  EXPECT_EQ(id, 2);
+}
+
+TEST(SwappableInferenceRunnerTest, ReturnsLoadErrorOnce) {
+  SwappableInferenceRunner runner(std::make_unique<IdRunner>(1));
+  absl::Notification loaded;
+  runner.StartLoad(
+      [&loaded]() -> absl::StatusOr<std::shared_ptr<InferenceRunner>> {
+        loaded.Notify();
+        return absl::InvalidArgumentError("bad model");
+      });
+  loaded.WaitForNotification();
+  absl::StatusOr<int> id = RunId(runner);
+  while (id.ok()) {
+    absl::SleepFor(absl::Milliseconds(1));
+    id = RunId(runner);
+  }
+  EXPECT_EQ(id.status().code(), absl::StatusCode::kInvalidArgument);
+  MP_ASSERT_OK_AND_ASSIGN(int next_id, RunId(runner));
+  EXPECT_EQ(next_id, 1);
+}
+
+}  // namespace
+}  // namespace mediapipe
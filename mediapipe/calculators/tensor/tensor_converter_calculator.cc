@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "Eigen/Core"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
@@ -26,6 +27,7 @@
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/gpu/gpu_buffer_format.h"
@@ -160,6 +162,7 @@ class TensorConverterCalculator : public CalculatorBase {
   absl::Status NormalizeImage(const ImageFrame& image_frame,
                               bool flip_vertically, float* tensor_ptr);
   absl::Status CopyMatrixToTensor(const Matrix& matrix, float* tensor_ptr);
+  Tensor CreateCpuTensor(const Tensor::Shape& shape);
   absl::Status ProcessCPU(CalculatorContext* cc);
   absl::Status ProcessGPU(CalculatorContext* cc);
 
@@ -183,6 +186,8 @@ class TensorConverterCalculator : public CalculatorBase {
   bool flip_vertically_ = false;
   bool row_major_matrix_ = false;
   int max_num_channels_ = 3;
+  // Provides the CPU buffers of the output tensors, if available.
+  ServiceBinding<TensorPool> tensor_pool_;
 };
 REGISTER_CALCULATOR(TensorConverterCalculator);
 
@@ -214,6 +219,7 @@ absl::Status TensorConverterCalculator::GetContract(CalculatorContract* cc) {
 
   RET_CHECK(cc->Outputs().HasTag(kTensorsTag));
   cc->Outputs().Tag(kTensorsTag).Set<std::vector<Tensor>>();
+  cc->UseService(kTensorPoolService).Optional();
   return absl::OkStatus();
 }
 
@@ -233,6 +239,7 @@ absl::Status TensorConverterCalculator::Open(CalculatorContext* cc) {
 #endif  // !MEDIAPIPE_DISABLE_GPU
 
   MP_RETURN_IF_ERROR(LoadOptions(cc, use_gpu_));
+  tensor_pool_ = cc->Service(kTensorPoolService);
 
   return absl::OkStatus();
 }
@@ -291,9 +298,8 @@ absl::Status TensorConverterCalculator::ProcessCPU(CalculatorContext* cc) {
           format == mediapipe::ImageFormat::FORMAT_VEC32F1))
       RET_CHECK_FAIL() << "Unsupported CPU input format.";
 
-    output_tensors->emplace_back(
-        Tensor::ElementType::kFloat32,
-        Tensor::Shape{1, height, width, channels_preserved});
+    output_tensors->push_back(
+        CreateCpuTensor({1, height, width, channels_preserved}));
     auto cpu_view = output_tensors->back().GetCpuWriteView();
 
     // Copy image data into tensor.
@@ -315,8 +321,7 @@ absl::Status TensorConverterCalculator::ProcessCPU(CalculatorContext* cc) {
     const int height = matrix.rows();
     const int width = matrix.cols();
     const int channels = 1;
-    output_tensors->emplace_back(Tensor::ElementType::kFloat32,
-                                 Tensor::Shape{1, height, width, channels});
+    output_tensors->push_back(CreateCpuTensor({1, height, width, channels}));
     MP_RETURN_IF_ERROR(CopyMatrixToTensor(
         matrix, output_tensors->back().GetCpuWriteView().buffer<float>()));
   } else {
@@ -675,47 +680,61 @@ absl::Status TensorConverterCalculator::NormalizeImage(
   const int width = image_frame.Width();
   const int channels = image_frame.NumberOfChannels();
   const int channels_preserved = std::min(channels, max_num_channels_);
-  const int channels_ignored = channels - channels_preserved;
 
+  // [0,1], scale only (bias == 0)
+  // Verified that there are no precision issues with 1.0f / 255.0f expression
+  float scale = 1.0f / 255.0f;
+  float bias = 0.0f;
   if (output_range_.has_value()) {
     // If the output float range is set and we are not using custom
     // normalization, normalize the pixel values from [0, 255] to the specified
     // output range.
     RET_CHECK_NE(output_range_->first, output_range_->second);
-    const float scale = (output_range_->second - output_range_->first) / 255.0f;
-    const float bias = output_range_->first;
-
-    for (int i = 0; i < height; ++i) {
-      const T* image_ptr = reinterpret_cast<const T*>(
-          image_frame.PixelData() +
-          (flip_vertically ? height - 1 - i : i) * image_frame.WidthStep());
-      for (int j = 0; j < width; ++j) {
-        for (int c = 0; c < channels_preserved; ++c) {
-          *tensor_ptr++ = *image_ptr++ * scale + bias;
-        }
-        image_ptr += channels_ignored;
-      }
-    }
-  } else {
-    // [0,1], scale only (bias == 0)
-    // Verified that there are no precision issues with 1.0f / 255.0f expression
-    const float scale = 1.0f / 255.0f;
-    for (int i = 0; i < height; ++i) {
-      const T* image_ptr = reinterpret_cast<const T*>(
-          image_frame.PixelData() +
-          (flip_vertically ? height - 1 - i : i) * image_frame.WidthStep());
-      for (int j = 0; j < width; ++j) {
-        for (int c = 0; c < channels_preserved; ++c) {
-          *tensor_ptr++ = *image_ptr++ * scale;
-        }
-        image_ptr += channels_ignored;
-      }
+    scale = (output_range_->second - output_range_->first) / 255.0f;
+    bias = output_range_->first;
+  }
+
+  // Each row is converted and normalized in one vectorized pass. Ignored
+  // channels are skipped through the stride of the row.
+  using ImageRow =
+      Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using TensorRow =
+      Eigen::Array<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  const int row_size = width * channels_preserved;
+  for (int i = 0; i < height; ++i) {
+    const T* image_ptr = reinterpret_cast<const T*>(
+        image_frame.PixelData() +
+        (flip_vertically ? height - 1 - i : i) * image_frame.WidthStep());
+    if (channels_preserved == channels) {
+      Eigen::Map<Eigen::ArrayXf>(tensor_ptr, row_size) =
+          Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(image_ptr,
+                                                               row_size)
+                  .template cast<float>() *
+              scale +
+          bias;
+    } else {
+      Eigen::Map<TensorRow>(tensor_ptr, width, channels_preserved) =
+          Eigen::Map<const ImageRow, Eigen::Unaligned, Eigen::OuterStride<>>(
+              image_ptr, width, channels_preserved,
+              Eigen::OuterStride<>(channels))
+                  .template cast<float>() *
+              scale +
+          bias;
     }
+    tensor_ptr += row_size;
   }
 
   return absl::OkStatus();
 }
 
+Tensor TensorConverterCalculator::CreateCpuTensor(const Tensor::Shape& shape) {
+  if (tensor_pool_.IsAvailable()) {
+    return tensor_pool_.GetObject().GetTensor(Tensor::ElementType::kFloat32,
+                                              shape);
+  }
+  return Tensor(Tensor::ElementType::kFloat32, shape);
+}
+
 absl::Status TensorConverterCalculator::CopyMatrixToTensor(const Matrix& matrix,
                                                            float* tensor_ptr) {
   if (row_major_matrix_) {
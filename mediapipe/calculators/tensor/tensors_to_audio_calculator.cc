@@ -12,7 +12,6 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <new>
@@ -46,20 +45,25 @@ std::vector<float> HannWindow(int window_size, bool sqrt_hann) {
   return hann_window;
 }
 
-// Note that the InvHannWindow function may only work for 50% overlapping case.
-std::vector<float> InvHannWindow(int window_size, bool sqrt_hann) {
+// Returns the synthesis window that inverts the Hann analysis window when the
+// windowed frames are overlap-added every `step_size` samples. Note that the
+// sqrt Hann window is only an inverse for the 50% overlapping case.
+std::vector<float> InvHannWindow(int window_size, int step_size,
+                                 bool sqrt_hann) {
   std::vector<float> window = HannWindow(window_size, sqrt_hann);
   std::vector<float> inv_window(window.size());
   if (sqrt_hann) {
     absl::c_copy(window, inv_window.begin());
   } else {
-    const int kHalfWindowSize = window.size() / 2;
-    absl::c_transform(window, inv_window.begin(),
-                      [](double x) { return x * x; });
-    for (int i = 0; i < kHalfWindowSize; ++i) {
-      double sum = inv_window[i] + inv_window[kHalfWindowSize + i];
-      inv_window[i] = window[i] / sum;
-      inv_window[kHalfWindowSize + i] = window[kHalfWindowSize + i] / sum;
+    // Every output sample sums the frames whose window positions are equal
+    // modulo the step size.
+    std::vector<double> sums(step_size, 0.0);
+    for (int i = 0; i < window_size; ++i) {
+      sums[i % step_size] += window[i] * window[i];
+    }
+    for (int i = 0; i < window_size; ++i) {
+      const double sum = sums[i % step_size];
+      inv_window[i] = sum > 0 ? window[i] / sum : 0;
     }
   }
   return inv_window;
@@ -91,6 +95,13 @@ bool IsValidFftSize(int size) {
 // have the DFT real parts in its first row and the DFT imagery parts in its
 // second row. A valid "fft_size" must be set in the CalculatorOptions.
 //
+// When "num_overlapping_samples" is set, the calculator streams the audio:
+// each window is overlap-added into a preallocated buffer of "fft_size"
+// samples, and the first "num_samples - num_overlapping_samples" samples of
+// the buffer, which no later window overlaps, are output as soon as the
+// window arrives. Any overlap is supported, so the output latency is a single
+// hop rather than a full window.
+//
 // Inputs:
 //   TENSORS - std::vector<Tensor>
 //     Vector containing a single Tensor that represents the audio's complex DFT
@@ -137,7 +148,8 @@ class TensorsToAudioCalculator : public Node {
   // pffft requires memory to work with to avoid using the stack.
   std::vector<float, Eigen::aligned_allocator<float>> fft_workplace_;
   std::vector<float, Eigen::aligned_allocator<float>> fft_output_;
-  std::vector<float, Eigen::aligned_allocator<float>> prev_fft_output_;
+  // The overlap-added windows whose samples are not yet output.
+  std::vector<float, Eigen::aligned_allocator<float>> overlap_add_buffer_;
   int overlapping_samples_ = -1;
   int step_samples_ = -1;
   Options::DftTensorFormat dft_tensor_format_;
@@ -159,7 +171,6 @@ absl::Status TensorsToAudioCalculator::Open(CalculatorContext* cc) {
   inverse_fft_size_ = 1.0f / fft_size_;
   fft_state_ = pffft_new_setup(fft_size_, PFFFT_REAL);
   input_dft_.resize(fft_size_);
-  inv_fft_window_ = InvHannWindow(fft_size_, /* sqrt_hann = */ false);
   fft_input_buffer_.resize(fft_size_);
   fft_workplace_.resize(fft_size_);
   fft_output_.resize(fft_size_);
@@ -177,8 +188,12 @@ absl::Status TensorsToAudioCalculator::Open(CalculatorContext* cc) {
            "`num_samples.`";
     overlapping_samples_ = options.num_overlapping_samples();
     step_samples_ = options.num_samples() - options.num_overlapping_samples();
-    prev_fft_output_.resize(fft_size_);
+    overlap_add_buffer_.assign(fft_size_, 0.0f);
   }
+  // Without overlap, the window is the inverse for 50% overlapping windows.
+  inv_fft_window_ = InvHannWindow(
+      fft_size_, step_samples_ > 0 ? step_samples_ : fft_size_ / 2,
+      /* sqrt_hann = */ false);
   if (options.has_volume_gain_db()) {
     gain_ = pow(10, options.volume_gain_db() / 20.0);
   }
@@ -224,21 +239,33 @@ absl::Status TensorsToAudioCalculator::Process(CalculatorContext* cc) {
     default:
       return absl::InvalidArgumentError("Unsupported dft tensor format.");
   }
-  pffft_transform_ordered(fft_state_, input_dft_.data(), fft_output_.data(),
-                          fft_workplace_.data(), PFFFT_BACKWARD);
-  // Applies the inverse window function.
-  std::transform(
-      fft_output_.begin(), fft_output_.end(), inv_fft_window_.begin(),
-      fft_output_.begin(),
-      [this](float a, float b) { return a * b * inverse_fft_size_; });
+  const Eigen::Map<const Eigen::RowVectorXf> inv_fft_window(
+      inv_fft_window_.data(), fft_size_);
   Matrix matrix;
   if (step_samples_ > 0) {
-    matrix = Eigen::Map<Matrix>(fft_output_.data(), 1, step_samples_);
-    matrix.leftCols(overlapping_samples_) += Eigen::Map<Matrix>(
-        prev_fft_output_.data() + step_samples_, 1, overlapping_samples_);
-    prev_fft_output_.swap(fft_output_);
+    pffft_transform_ordered(fft_state_, input_dft_.data(), fft_output_.data(),
+                            fft_workplace_.data(), PFFFT_BACKWARD);
+    // Overlap-adds the inverse windowed output, then outputs the samples that
+    // no later window overlaps and shifts the rest to the buffer front.
+    Eigen::Map<Eigen::RowVectorXf> overlap_add(overlap_add_buffer_.data(),
+                                               fft_size_);
+    overlap_add.array() +=
+        Eigen::Map<const Eigen::RowVectorXf>(fft_output_.data(), fft_size_)
+            .array() *
+        inv_fft_window.array() * inverse_fft_size_;
+    matrix = overlap_add.head(step_samples_);
+    std::memmove(overlap_add_buffer_.data(),
+                 overlap_add_buffer_.data() + step_samples_,
+                 overlapping_samples_ * sizeof(float));
+    overlap_add.tail(step_samples_).setZero();
   } else {
-    matrix = Eigen::Map<Matrix>(fft_output_.data(), 1, fft_output_.size());
+    // Eigen aligns the heap storage of matrices as pffft requires, so the
+    // inverse FFT writes straight into the output.
+    matrix.resize(1, fft_size_);
+    pffft_transform_ordered(fft_state_, input_dft_.data(), matrix.data(),
+                            fft_workplace_.data(), PFFFT_BACKWARD);
+    matrix.array() =
+        matrix.array() * inv_fft_window.array() * inverse_fft_size_;
   }
   if (gain_ != 1.0) {
     matrix *= gain_;
@@ -43,7 +43,8 @@ class TensorsToAudioCalculatorFftTest : public ::testing::Test {
   }
 
   void ConfigGraph(int num_samples, double sample_rate, int fft_size,
-                   Options::DftTensorFormat dft_tensor_format) {
+                   Options::DftTensorFormat dft_tensor_format,
+                   int num_overlapping_samples = 0) {
     graph_config_ = ParseTextProtoOrDie<CalculatorGraphConfig>(absl::Substitute(
         R"(
         input_stream: "audio_in"
@@ -59,7 +60,7 @@ class TensorsToAudioCalculatorFftTest : public ::testing::Test {
             [mediapipe.AudioToTensorCalculatorOptions.ext] {
               num_channels: 1
               num_samples: $0
-              num_overlapping_samples: 0
+              num_overlapping_samples: $4
               target_sample_rate: $1
               fft_size: $2
               dft_tensor_format: $3
@@ -75,6 +76,7 @@ class TensorsToAudioCalculatorFftTest : public ::testing::Test {
             [mediapipe.TensorsToAudioCalculatorOptions.ext] {
               fft_size: $2
               dft_tensor_format: $3
+              $5
             }
           }
         }
@@ -82,7 +84,12 @@ class TensorsToAudioCalculatorFftTest : public ::testing::Test {
         /*$0=*/num_samples,
         /*$1=*/sample_rate,
         /*$2=*/fft_size,
-        /*$3=*/Options::DftTensorFormat_Name(dft_tensor_format)));
+        /*$3=*/Options::DftTensorFormat_Name(dft_tensor_format),
+        /*$4=*/num_overlapping_samples,
+        /*$5=*/num_overlapping_samples > 0
+            ? absl::Substitute("num_samples: $0 num_overlapping_samples: $1",
+                               num_samples, num_overlapping_samples)
+            : ""));
     tool::AddVectorSink("audio_out", &graph_config_, &audio_out_packets_);
   }
 
@@ -176,5 +183,32 @@ TEST_F(TensorsToAudioCalculatorFftTest, TestDftTensorWithoutDCAndNyquist) {
   EXPECT_EQ(audio_out_packets_[0].Get<Matrix>(), impulse_data);
 }
 
+TEST_F(TensorsToAudioCalculatorFftTest, TestOverlapAddReconstructsSignal) {
+  constexpr int sample_size = 320;
+  constexpr int num_overlapping_samples = 240;
+  constexpr int step_size = sample_size - num_overlapping_samples;
+  constexpr double sample_rate = 16000;
+  ConfigGraph(sample_size, sample_rate, 320, Options::WITH_NYQUIST,
+              num_overlapping_samples);
+  Matrix input_data = Matrix::Random(1, sample_size * 10);
+  RunGraph(input_data, sample_rate);
+  ASSERT_GT(audio_out_packets_.size(), 1);
+
+  // Each window outputs the samples that no later window overlaps.
+  Matrix output_data(1, audio_out_packets_.size() * step_size);
+  for (int i = 0; i < audio_out_packets_.size(); ++i) {
+    MP_ASSERT_OK(audio_out_packets_[i].ValidateAsType<Matrix>());
+    const Matrix& output = audio_out_packets_[i].Get<Matrix>();
+    ASSERT_EQ(output.cols(), step_size);
+    output_data.middleCols(i * step_size, step_size) = output;
+  }
+  // Samples are reconstructed once all the windows that cover them are added,
+  // except within the first window and the zero padded last windows.
+  const int begin = num_overlapping_samples;
+  const int end = input_data.cols() - sample_size;
+  EXPECT_TRUE(output_data.middleCols(begin, end - begin)
+                  .isApprox(input_data.middleCols(begin, end - begin), 1e-4));
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cmath>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -45,14 +47,42 @@ void SetClassificationLabel(const LabelMapItem label_map_item,
   }
 }
 
+// Returns the real value of a raw score.
+template <typename T>
+float Dequantize(T raw_score,
+                 const Tensor::QuantizationParameters& quantization) {
+  if constexpr (std::is_same_v<T, float>) {
+    return raw_score;
+  } else {
+    return quantization.scale *
+           (static_cast<int>(raw_score) - quantization.zero_point);
+  }
+}
+
+// Returns the lowest raw score whose real value reaches threshold. As the
+// quantization scale is positive, raw scores are ordered like their real
+// values, so they are thresholded and sorted without being dequantized.
+template <typename T>
+float RawScoreThreshold(float threshold,
+                        const Tensor::QuantizationParameters& quantization) {
+  if constexpr (std::is_same_v<T, float>) {
+    return threshold;
+  } else {
+    return std::ceil(threshold / quantization.scale + quantization.zero_point);
+  }
+}
+
 }  // namespace
 
 // Convert result tensors from classification models into MediaPipe
 // classifications.
 //
 // Input:
-//  TENSORS - Vector of Tensors of type kFloat32 containing one
-//            tensor, the size of which must be (1, * num_classes).
+//  TENSORS - Vector of Tensors of type kFloat32, kUInt8, kInt8 or kBool
+//            containing one tensor, the size of which must be
+//            (1, * num_classes). Quantized scores are thresholded and sorted
+//            as is, and only the scores of the output classes are
+//            dequantized.
 // Output:
 //  CLASSIFICATIONS - Result MediaPipe ClassificationList. The score and index
 //                    fields of each classification are set, while the label
@@ -98,6 +128,11 @@ class TensorsToClassificationCalculator : public Node {
   // These are used to filter out the output classification results.
   ClassIndexSet class_index_set_;
   bool IsClassIndexAllowed(int class_index);
+  template <typename T>
+  void Classify(const T* raw_scores,
+                const Tensor::QuantizationParameters& quantization,
+                int num_classes, CalculatorContext* cc,
+                ClassificationList* classification_list);
   const proto_ns::Map<int64_t, LabelMapItem>& GetLabelMap(
       CalculatorContext* cc);
 };
@@ -163,77 +198,105 @@ absl::Status TensorsToClassificationCalculator::Open(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
-absl::Status TensorsToClassificationCalculator::Process(CalculatorContext* cc) {
-  const auto& input_tensors = *kInTensors(cc);
-  RET_CHECK_EQ(input_tensors.size(), 1);
-  RET_CHECK(input_tensors[0].element_type() == Tensor::ElementType::kFloat32);
-
-  int num_classes = input_tensors[0].shape().num_elements();
-
-  if (is_binary_classification_) {
-    RET_CHECK_EQ(num_classes, 1);
-    // Number of classes for binary classification.
-    num_classes = 2;
-  }
-  if (label_map_loaded_) {
-    RET_CHECK_EQ(num_classes, GetLabelMap(cc).size());
-  }
-  auto view = input_tensors[0].GetCpuReadView();
-  auto raw_scores = view.buffer<float>();
-
-  auto classification_list = absl::make_unique<ClassificationList>();
+template <typename T>
+void TensorsToClassificationCalculator::Classify(
+    const T* raw_scores, const Tensor::QuantizationParameters& quantization,
+    int num_classes, CalculatorContext* cc,
+    ClassificationList* classification_list) {
   if (is_binary_classification_) {
     Classification* class_first = classification_list->add_classification();
     Classification* class_second = classification_list->add_classification();
     class_first->set_index(0);
     class_second->set_index(1);
-    class_first->set_score(raw_scores[0]);
-    class_second->set_score(1. - raw_scores[0]);
+    const float score = Dequantize(raw_scores[0], quantization);
+    class_first->set_score(score);
+    class_second->set_score(1. - score);
 
     if (label_map_loaded_) {
       SetClassificationLabel(GetLabelMap(cc).at(0), class_first);
       SetClassificationLabel(GetLabelMap(cc).at(1), class_second);
     }
   } else {
+    // Selects the output classes on the raw scores, so that protos are only
+    // created for the classes that are output.
+    const float raw_score_threshold =
+        RawScoreThreshold<T>(min_score_threshold_, quantization);
+    std::vector<int> indices;
     for (int i = 0; i < num_classes; ++i) {
-      if (!IsClassIndexAllowed(i)) {
-        continue;
-      }
-      if (raw_scores[i] < min_score_threshold_) {
-        continue;
+      if (raw_scores[i] >= raw_score_threshold && IsClassIndexAllowed(i)) {
+        indices.push_back(i);
       }
+    }
+    const auto by_descending_score = [raw_scores](int a, int b) {
+      return raw_scores[a] > raw_scores[b] ||
+             (raw_scores[a] == raw_scores[b] && a < b);
+    };
+    if (top_k_ > 0) {
+      const int desired_size = std::min<int>(indices.size(), top_k_);
+      std::partial_sort(indices.begin(), indices.begin() + desired_size,
+                        indices.end(), by_descending_score);
+      indices.resize(desired_size);
+    } else if (sort_by_descending_score_) {
+      std::sort(indices.begin(), indices.end(), by_descending_score);
+    }
+
+    classification_list->mutable_classification()->Reserve(indices.size());
+    for (int i : indices) {
       Classification* classification =
           classification_list->add_classification();
       classification->set_index(i);
-      classification->set_score(raw_scores[i]);
+      classification->set_score(Dequantize(raw_scores[i], quantization));
       if (label_map_loaded_) {
         SetClassificationLabel(GetLabelMap(cc).at(i), classification);
       }
     }
   }
+}
 
-  auto raw_classification_list = classification_list->mutable_classification();
-  if (top_k_ > 0) {
-    int desired_size =
-        std::min(classification_list->classification_size(), top_k_);
-    std::partial_sort(raw_classification_list->begin(),
-                      raw_classification_list->begin() + desired_size,
-                      raw_classification_list->end(),
-                      [](const Classification a, const Classification b) {
-                        return a.score() > b.score();
-                      });
+absl::Status TensorsToClassificationCalculator::Process(CalculatorContext* cc) {
+  const auto& input_tensors = *kInTensors(cc);
+  RET_CHECK_EQ(input_tensors.size(), 1);
 
-    if (desired_size >= top_k_) {
-      // Resizes the underlying list to have only top_k_ classifications.
-      raw_classification_list->DeleteSubrange(
-          top_k_, raw_classification_list->size() - top_k_);
-    }
-  } else if (sort_by_descending_score_) {
-    std::sort(raw_classification_list->begin(), raw_classification_list->end(),
-              [](const Classification a, const Classification b) {
-                return a.score() > b.score();
-              });
+  int num_classes = input_tensors[0].shape().num_elements();
+
+  if (is_binary_classification_) {
+    RET_CHECK_EQ(num_classes, 1);
+    // Number of classes for binary classification.
+    num_classes = 2;
   }
+  if (label_map_loaded_) {
+    RET_CHECK_EQ(num_classes, GetLabelMap(cc).size());
+  }
+  const Tensor& input_tensor = input_tensors[0];
+  const auto& quantization = input_tensor.quantization_parameters();
+  if (input_tensor.element_type() != Tensor::ElementType::kFloat32) {
+    RET_CHECK_GT(quantization.scale, 0.0f);
+  }
+  auto view = input_tensor.GetCpuReadView();
+  auto classification_list = absl::make_unique<ClassificationList>();
+  switch (input_tensor.element_type()) {
+    case Tensor::ElementType::kFloat32:
+      Classify(view.buffer<float>(), quantization, num_classes, cc,
+               classification_list.get());
+      break;
+    case Tensor::ElementType::kUInt8:
+      Classify(view.buffer<uint8_t>(), quantization, num_classes, cc,
+               classification_list.get());
+      break;
+    case Tensor::ElementType::kInt8:
+      Classify(view.buffer<int8_t>(), quantization, num_classes, cc,
+               classification_list.get());
+      break;
+    case Tensor::ElementType::kBool:
+      Classify(view.buffer<bool>(), quantization, num_classes, cc,
+               classification_list.get());
+      break;
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Unsupported input tensor type: %d",
+                          static_cast<int>(input_tensor.element_type())));
+  }
+
   kOutClassificationList(cc).Send(std::move(classification_list));
   return absl::OkStatus();
 }
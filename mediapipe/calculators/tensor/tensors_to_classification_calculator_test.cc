@@ -208,6 +208,44 @@ TEST_F(TensorsToClassificationCalculatorTest, CorrectOutputWithTopK) {
   }
 }
 
+TEST_F(TensorsToClassificationCalculatorTest,
+       CorrectOutputWithTopKAndThresholdOnLargeLabelSet) {
+  mediapipe::CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToClassificationCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "CLASSIFICATIONS:classifications"
+    options {
+      [mediapipe.TensorsToClassificationCalculatorOptions.ext] {
+        top_k: 3
+        min_score_threshold: 0.5
+      }
+    }
+  )pb"));
+
+  std::vector<float> scores(1000, 0.1f);
+  scores[10] = 0.6f;
+  scores[500] = 0.9f;
+  scores[999] = 0.7f;
+  scores[20] = 0.6f;
+  BuildGraph(&runner, scores);
+  MP_ASSERT_OK(runner.Run());
+
+  const auto& output_packets_ = runner.Outputs().Tag("CLASSIFICATIONS").packets;
+
+  EXPECT_EQ(1, output_packets_.size());
+
+  const auto& classification_list =
+      output_packets_[0].Get<ClassificationList>();
+
+  // Verify that the top3 classes are sorted by descending score, with ties
+  // broken by the lower class index.
+  ASSERT_EQ(3, classification_list.classification_size());
+  EXPECT_EQ(500, classification_list.classification(0).index());
+  EXPECT_EQ(999, classification_list.classification(1).index());
+  EXPECT_EQ(10, classification_list.classification(2).index());
+  EXPECT_FLOAT_EQ(0.6f, classification_list.classification(2).score());
+}
+
 TEST_F(TensorsToClassificationCalculatorTest,
        CorrectOutputWithSortByDescendingScore) {
   mediapipe::CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
@@ -323,4 +361,45 @@ TEST_F(TensorsToClassificationCalculatorTest,
   ASSERT_TRUE(classification_list.classification(1).has_label());
 }
 
+TEST_F(TensorsToClassificationCalculatorTest,
+       CorrectOutputWithQuantizedScores) {
+  mediapipe::CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToClassificationCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "CLASSIFICATIONS:classifications"
+    options {
+      [mediapipe.TensorsToClassificationCalculatorOptions.ext] {
+        min_score_threshold: 0.3
+        sort_by_descending_score: true
+      }
+    }
+  )pb"));
+
+  // Real scores are 0.25 * (raw - 2), i.e. {0, 0.25, 0.5, 1}.
+  auto tensors = absl::make_unique<std::vector<Tensor>>();
+  tensors->emplace_back(Tensor::ElementType::kUInt8, Tensor::Shape{1, 4},
+                        Tensor::QuantizationParameters(0.25f, 2));
+  {
+    auto view = tensors->back().GetCpuWriteView();
+    uint8_t* tensor_buffer = view.buffer<uint8_t>();
+    const uint8_t raw_scores[] = {2, 3, 4, 6};
+    std::copy(std::begin(raw_scores), std::end(raw_scores), tensor_buffer);
+  }
+  runner.MutableInputs()->Tag("TENSORS").packets.push_back(
+      mediapipe::Adopt(tensors.release()).At(mediapipe::Timestamp(0)));
+  MP_ASSERT_OK(runner.Run());
+
+  const auto& output_packets_ = runner.Outputs().Tag("CLASSIFICATIONS").packets;
+
+  EXPECT_EQ(1, output_packets_.size());
+
+  const auto& classification_list =
+      output_packets_[0].Get<ClassificationList>();
+  EXPECT_EQ(2, classification_list.classification_size());
+  EXPECT_EQ(3, classification_list.classification(0).index());
+  EXPECT_EQ(1, classification_list.classification(0).score());
+  EXPECT_EQ(2, classification_list.classification(1).index());
+  EXPECT_EQ(0.5, classification_list.classification(1).score());
+}
+
 }  // namespace mediapipe
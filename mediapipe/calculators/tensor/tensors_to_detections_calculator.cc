@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -69,6 +73,19 @@ using BoxFormat = ::mediapipe::TensorsToDetectionsCalculatorOptions::BoxFormat;
 
 namespace {
 
+// Returns whether the tensor holds quantized values, which are only dequantized
+// for the boxes that pass the score threshold.
+bool IsQuantized(const Tensor& tensor) {
+  return tensor.element_type() == Tensor::ElementType::kUInt8 ||
+         tensor.element_type() == Tensor::ElementType::kInt8;
+}
+
+template <typename T>
+float Dequantize(T value, const Tensor::QuantizationParameters& quantization) {
+  return quantization.scale *
+         (static_cast<int>(value) - quantization.zero_point);
+}
+
 void ConvertRawValuesToAnchors(const float* raw_anchors, int num_boxes,
                                std::vector<Anchor>* anchors) {
   anchors->clear();
@@ -152,6 +169,10 @@ BoxFormat GetBoxFormat(const TensorsToDetectionsCalculatorOptions& options) {
 //            for anchors (e.g. for SSD models) depend on the outputs of the
 //            detection model. The size of anchor tensor must be (num_boxes *
 //            4).
+//            The raw box and score tensors may also be quantized kUInt8 or
+//            kInt8 tensors, which are processed on CPU. The top class of each
+//            box is found on the quantized scores, and only the top scores and
+//            the boxes that pass min_score_thresh are dequantized.
 //
 // Input side packet:
 //  ANCHORS (optional) - The anchors used for decoding the bounding boxes, as a
@@ -207,13 +228,26 @@ class TensorsToDetectionsCalculator : public Node {
 
   absl::Status LoadOptions(CalculatorContext* cc);
   absl::Status GpuInit(CalculatorContext* cc);
+  template <typename T>
+  void ScoreBoxes(const T* raw_scores,
+                  const Tensor::QuantizationParameters& quantization,
+                  float* detection_scores, int* detection_classes);
+  template <typename T>
+  void DequantizeBoxes(const T* raw_boxes,
+                       const Tensor::QuantizationParameters& quantization,
+                       const float* detection_scores,
+                       std::vector<float>* boxes);
   absl::Status DecodeBoxes(const float* raw_boxes,
                            const std::vector<Anchor>& anchors,
+                           const float* detection_scores,
                            std::vector<float>* boxes);
   absl::Status ConvertToDetections(const float* detection_boxes,
                                    const float* detection_scores,
                                    const int* detection_classes,
                                    std::vector<Detection>* output_detections);
+  std::vector<int> NonMaxSuppression(const float* detection_boxes,
+                                     const float* detection_scores,
+                                     const std::vector<int>& candidates);
   Detection ConvertToDetection(float box_ymin, float box_xmin, float box_ymax,
                                float box_xmax, float score, int class_id,
                                bool flip_vertically);
@@ -292,8 +326,22 @@ absl::Status TensorsToDetectionsCalculator::Open(CalculatorContext* cc) {
 
 absl::Status TensorsToDetectionsCalculator::Process(CalculatorContext* cc) {
   auto output_detections = absl::make_unique<std::vector<Detection>>();
+  const auto& input_tensors = *kInTensors(cc);
+  const int num_input_tensors = input_tensors.size();
+  bool has_quantized_tensors = false;
+  for (const auto& tensor : input_tensors) {
+    if (IsQuantized(tensor)) {
+      RET_CHECK(num_input_tensors == 2 ||
+                num_input_tensors == kNumInputTensorsWithAnchors)
+          << "Quantized tensors are only supported for raw boxes and scores.";
+      RET_CHECK_GT(tensor.quantization_parameters().scale, 0.0f);
+      has_quantized_tensors = true;
+    } else {
+      RET_CHECK(tensor.element_type() == Tensor::ElementType::kFloat32);
+    }
+  }
   bool gpu_processing = false;
-  if (CanUseGpu() && gpu_has_enough_work_groups_) {
+  if (CanUseGpu() && gpu_has_enough_work_groups_ && !has_quantized_tensors) {
     // Use GPU processing only if at least one input tensor is already on GPU
     // (to avoid CPU->GPU overhead).
     for (const auto& tensor : *kInTensors(cc)) {
@@ -303,11 +351,6 @@ absl::Status TensorsToDetectionsCalculator::Process(CalculatorContext* cc) {
       }
     }
   }
-  const auto& input_tensors = *kInTensors(cc);
-  for (const auto& tensor : input_tensors) {
-    RET_CHECK(tensor.element_type() == Tensor::ElementType::kFloat32);
-  }
-  const int num_input_tensors = input_tensors.size();
   if (!scores_tensor_index_is_set_) {
     if (num_input_tensors == 2 ||
         num_input_tensors == kNumInputTensorsWithAnchors) {
@@ -393,9 +436,7 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
           "The dimensions of score Tensor must be 3 or 4.");
     }
     auto raw_box_view = raw_box_tensor->GetCpuReadView();
-    auto raw_boxes = raw_box_view.buffer<float>();
     auto raw_scores_view = raw_score_tensor->GetCpuReadView();
-    auto raw_scores = raw_scores_view.buffer<float>();
 
     // TODO: Support other options to load anchors.
     if (!anchors_init_) {
@@ -405,6 +446,8 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
         RET_CHECK_EQ(anchor_tensor->shape().dims.size(), 2);
         RET_CHECK_EQ(anchor_tensor->shape().dims[0], num_boxes_);
         RET_CHECK_EQ(anchor_tensor->shape().dims[1], kNumCoordsPerBox);
+        RET_CHECK(anchor_tensor->element_type() ==
+                  Tensor::ElementType::kFloat32);
         auto anchor_view = anchor_tensor->GetCpuReadView();
         auto raw_anchors = anchor_view.buffer<float>();
         ConvertRawValuesToAnchors(raw_anchors, num_boxes_, &anchors_);
@@ -415,41 +458,50 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
       }
       anchors_init_ = true;
     }
-    std::vector<float> boxes(num_boxes_ * num_coords_);
-    MP_RETURN_IF_ERROR(DecodeBoxes(raw_boxes, anchors_, &boxes));
-
+    // Scores are computed first so that only boxes above the score threshold
+    // are decoded.
     std::vector<float> detection_scores(num_boxes_);
     std::vector<int> detection_classes(num_boxes_);
+    const auto& score_quantization =
+        raw_score_tensor->quantization_parameters();
+    switch (raw_score_tensor->element_type()) {
+      case Tensor::ElementType::kUInt8:
+        ScoreBoxes(raw_scores_view.buffer<uint8_t>(), score_quantization,
+                   detection_scores.data(), detection_classes.data());
+        break;
+      case Tensor::ElementType::kInt8:
+        ScoreBoxes(raw_scores_view.buffer<int8_t>(), score_quantization,
+                   detection_scores.data(), detection_classes.data());
+        break;
+      default:
+        ScoreBoxes(raw_scores_view.buffer<float>(), score_quantization,
+                   detection_scores.data(), detection_classes.data());
+        break;
+    }
 
-    // Filter classes by scores.
-    for (int i = 0; i < num_boxes_; ++i) {
-      int class_id = -1;
-      float max_score = -std::numeric_limits<float>::max();
-      // Find the top score for box i.
-      for (int score_idx = 0; score_idx < num_classes_; ++score_idx) {
-        if (IsClassIndexAllowed(score_idx)) {
-          auto score = raw_scores[i * num_classes_ + score_idx];
-          if (options_.sigmoid_score()) {
-            if (options_.has_score_clipping_thresh()) {
-              score = score < -options_.score_clipping_thresh()
-                          ? -options_.score_clipping_thresh()
-                          : score;
-              score = score > options_.score_clipping_thresh()
-                          ? options_.score_clipping_thresh()
-                          : score;
-            }
-            score = 1.0f / (1.0f + std::exp(-score));
-          }
-          if (max_score < score) {
-            max_score = score;
-            class_id = score_idx;
-          }
-        }
-      }
-      detection_scores[i] = max_score;
-      detection_classes[i] = class_id;
+    std::vector<float> dequantized_boxes;
+    const float* raw_boxes = nullptr;
+    const auto& box_quantization = raw_box_tensor->quantization_parameters();
+    switch (raw_box_tensor->element_type()) {
+      case Tensor::ElementType::kUInt8:
+        DequantizeBoxes(raw_box_view.buffer<uint8_t>(), box_quantization,
+                        detection_scores.data(), &dequantized_boxes);
+        raw_boxes = dequantized_boxes.data();
+        break;
+      case Tensor::ElementType::kInt8:
+        DequantizeBoxes(raw_box_view.buffer<int8_t>(), box_quantization,
+                        detection_scores.data(), &dequantized_boxes);
+        raw_boxes = dequantized_boxes.data();
+        break;
+      default:
+        raw_boxes = raw_box_view.buffer<float>();
+        break;
     }
 
+    std::vector<float> boxes(num_boxes_ * num_coords_);
+    MP_RETURN_IF_ERROR(
+        DecodeBoxes(raw_boxes, anchors_, detection_scores.data(), &boxes));
+
     MP_RETURN_IF_ERROR(
         ConvertToDetections(boxes.data(), detection_scores.data(),
                             detection_classes.data(), output_detections));
@@ -618,12 +670,26 @@ absl::Status TensorsToDetectionsCalculator::ProcessGPU(
   command_buffer.label = @"DecodeAndScoreBoxes";
   id<MTLComputeCommandEncoder> command_encoder =
       [command_buffer computeCommandEncoder];
-  [command_encoder setComputePipelineState:decode_program_];
   {
     auto scored_boxes_view =
         MtlBufferView::GetWriteView(*scored_boxes_buffer_, command_buffer);
     auto decoded_boxes_view =
         MtlBufferView::GetWriteView(*decoded_boxes_buffer_, command_buffer);
+
+    // Score boxes first, so that decoding skips the boxes below
+    // min_score_thresh. Dispatches of the encoder run in order.
+    [command_encoder setComputePipelineState:score_program_];
+    [command_encoder setBuffer:scored_boxes_view.buffer() offset:0 atIndex:0];
+    auto input1_view = MtlBufferView::GetReadView(
+        input_tensors[tensor_mapping_.scores_tensor_index()], command_buffer);
+    [command_encoder setBuffer:input1_view.buffer() offset:0 atIndex:1];
+    MTLSize score_threads_per_group = MTLSizeMake(1, num_classes_, 1);
+    MTLSize score_threadgroups = MTLSizeMake(num_boxes_, 1, 1);
+    [command_encoder dispatchThreadgroups:score_threadgroups
+                    threadsPerThreadgroup:score_threads_per_group];
+
+    // Decode boxes.
+    [command_encoder setComputePipelineState:decode_program_];
     [command_encoder setBuffer:decoded_boxes_view.buffer() offset:0 atIndex:0];
     auto input0_view = MtlBufferView::GetReadView(
         input_tensors[tensor_mapping_.detections_tensor_index()],
@@ -632,20 +698,11 @@ absl::Status TensorsToDetectionsCalculator::ProcessGPU(
     auto raw_anchors_view =
         MtlBufferView::GetReadView(*raw_anchors_buffer_, command_buffer);
     [command_encoder setBuffer:raw_anchors_view.buffer() offset:0 atIndex:2];
+    [command_encoder setBuffer:scored_boxes_view.buffer() offset:0 atIndex:3];
     MTLSize decode_threads_per_group = MTLSizeMake(1, 1, 1);
     MTLSize decode_threadgroups = MTLSizeMake(num_boxes_, 1, 1);
     [command_encoder dispatchThreadgroups:decode_threadgroups
                     threadsPerThreadgroup:decode_threads_per_group];
-
-    [command_encoder setComputePipelineState:score_program_];
-    [command_encoder setBuffer:scored_boxes_view.buffer() offset:0 atIndex:0];
-    auto input1_view = MtlBufferView::GetReadView(
-        input_tensors[tensor_mapping_.scores_tensor_index()], command_buffer);
-    [command_encoder setBuffer:input1_view.buffer() offset:0 atIndex:1];
-    MTLSize score_threads_per_group = MTLSizeMake(1, num_classes_, 1);
-    MTLSize score_threadgroups = MTLSizeMake(num_boxes_, 1, 1);
-    [command_encoder dispatchThreadgroups:score_threadgroups
-                    threadsPerThreadgroup:score_threads_per_group];
     [command_encoder endEncoding];
     [command_buffer commit];
   }
@@ -771,10 +828,82 @@ absl::Status TensorsToDetectionsCalculator::LoadOptions(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+template <typename T>
+void TensorsToDetectionsCalculator::ScoreBoxes(
+    const T* raw_scores, const Tensor::QuantizationParameters& quantization,
+    float* detection_scores, int* detection_classes) {
+  // The sigmoid and the clipping are monotonic, so the top class of a box is
+  // found on the raw scores, and the sigmoid is applied to the top score only.
+  // Quantized scores are ordered like their real values, so they are compared
+  // as is and only the top score is dequantized and clipped.
+  // Without class filtering, the inner loop is a plain max reduction.
+  constexpr bool kIsQuantized = !std::is_same_v<T, float>;
+  const bool has_class_filter = !class_index_set_.values.empty();
+  const bool clip_scores =
+      options_.sigmoid_score() && options_.has_score_clipping_thresh();
+  const float clipping_thresh = options_.score_clipping_thresh();
+  for (int i = 0; i < num_boxes_; ++i) {
+    const T* box_scores = raw_scores + i * num_classes_;
+    int class_id = -1;
+    T max_raw_score = std::numeric_limits<T>::lowest();
+    for (int score_idx = 0; score_idx < num_classes_; ++score_idx) {
+      T score = box_scores[score_idx];
+      if constexpr (!kIsQuantized) {
+        if (clip_scores) {
+          score = std::clamp(score, -clipping_thresh, clipping_thresh);
+        }
+      }
+      if ((class_id < 0 || max_raw_score < score) &&
+          (!has_class_filter || IsClassIndexAllowed(score_idx))) {
+        max_raw_score = score;
+        class_id = score_idx;
+      }
+    }
+    float max_score = -std::numeric_limits<float>::max();
+    if (class_id >= 0) {
+      if constexpr (kIsQuantized) {
+        max_score = Dequantize(max_raw_score, quantization);
+        if (clip_scores) {
+          max_score = std::clamp(max_score, -clipping_thresh, clipping_thresh);
+        }
+      } else {
+        max_score = max_raw_score;
+      }
+      if (options_.sigmoid_score()) {
+        max_score = 1.0f / (1.0f + std::exp(-max_score));
+      }
+    }
+    detection_scores[i] = max_score;
+    detection_classes[i] = class_id;
+  }
+}
+
+template <typename T>
+void TensorsToDetectionsCalculator::DequantizeBoxes(
+    const T* raw_boxes, const Tensor::QuantizationParameters& quantization,
+    const float* detection_scores, std::vector<float>* boxes) {
+  boxes->assign(num_boxes_ * num_coords_, 0.0f);
+  for (int i = 0; i < num_boxes_; ++i) {
+    if (options_.has_min_score_thresh() &&
+        detection_scores[i] < options_.min_score_thresh()) {
+      // The box is dropped by DecodeBoxes().
+      continue;
+    }
+    for (int j = i * num_coords_; j < (i + 1) * num_coords_; ++j) {
+      (*boxes)[j] = Dequantize(raw_boxes[j], quantization);
+    }
+  }
+}
+
 absl::Status TensorsToDetectionsCalculator::DecodeBoxes(
     const float* raw_boxes, const std::vector<Anchor>& anchors,
-    std::vector<float>* boxes) {
+    const float* detection_scores, std::vector<float>* boxes) {
   for (int i = 0; i < num_boxes_; ++i) {
+    if (options_.has_min_score_thresh() &&
+        detection_scores[i] < options_.min_score_thresh()) {
+      // The box is dropped by ConvertToDetections().
+      continue;
+    }
     const int box_offset = i * num_coords_ + options_.box_coord_offset();
 
     float y_center = 0.0;
@@ -861,8 +990,11 @@ absl::Status TensorsToDetectionsCalculator::DecodeBoxes(
 absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
     const float* detection_boxes, const float* detection_scores,
     const int* detection_classes, std::vector<Detection>* output_detections) {
+  const bool has_nms = options_.has_non_max_suppression();
+  // Selects the boxes to output before any Detection proto is created.
+  std::vector<int> candidates;
   for (int i = 0; i < num_boxes_; ++i) {
-    if (max_results_ > 0 && output_detections->size() == max_results_) {
+    if (!has_nms && max_results_ > 0 && candidates.size() == max_results_) {
       break;
     }
     if (options_.has_min_score_thresh() &&
@@ -872,6 +1004,26 @@ absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
     if (!IsClassIndexAllowed(detection_classes[i])) {
       continue;
     }
+    const int box_offset = i * num_coords_;
+    const float width = detection_boxes[box_offset + box_indices_[3]] -
+                        detection_boxes[box_offset + box_indices_[1]];
+    const float height = detection_boxes[box_offset + box_indices_[2]] -
+                         detection_boxes[box_offset + box_indices_[0]];
+    if (width < 0 || height < 0 || std::isnan(width) || std::isnan(height)) {
+      // Decoded detection boxes could have negative values for width/height due
+      // to model prediction. Filter out those boxes since some downstream
+      // calculators may assume non-negative values. (b/171391719)
+      continue;
+    }
+    candidates.push_back(i);
+  }
+  if (has_nms) {
+    candidates =
+        NonMaxSuppression(detection_boxes, detection_scores, candidates);
+  }
+
+  output_detections->reserve(output_detections->size() + candidates.size());
+  for (int i : candidates) {
     const int box_offset = i * num_coords_;
     Detection detection = ConvertToDetection(
         /*box_ymin=*/detection_boxes[box_offset + box_indices_[0]],
@@ -879,14 +1031,6 @@ absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
         /*box_ymax=*/detection_boxes[box_offset + box_indices_[2]],
         /*box_xmax=*/detection_boxes[box_offset + box_indices_[3]],
         detection_scores[i], detection_classes[i], options_.flip_vertically());
-    const auto& bbox = detection.location_data().relative_bounding_box();
-    if (bbox.width() < 0 || bbox.height() < 0 || std::isnan(bbox.width()) ||
-        std::isnan(bbox.height())) {
-      // Decoded detection boxes could have negative values for width/height due
-      // to model prediction. Filter out those boxes since some downstream
-      // calculators may assume non-negative values. (b/171391719)
-      continue;
-    }
     // Add keypoints.
     if (options_.num_keypoints() > 0) {
       auto* location_data = detection.mutable_location_data();
@@ -902,11 +1046,65 @@ absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
                             : detection_boxes[keypoint_index + 1]);
       }
     }
-    output_detections->emplace_back(detection);
+    output_detections->push_back(std::move(detection));
   }
   return absl::OkStatus();
 }
 
+std::vector<int> TensorsToDetectionsCalculator::NonMaxSuppression(
+    const float* detection_boxes, const float* detection_scores,
+    const std::vector<int>& candidates) {
+  std::vector<int> sorted = candidates;
+  std::stable_sort(sorted.begin(), sorted.end(), [&](int a, int b) {
+    return detection_scores[a] > detection_scores[b];
+  });
+
+  // Retained boxes are kept as a struct of arrays, so that the overlap of a
+  // candidate with all retained boxes is computed in a flat loop.
+  const int max_retained =
+      max_results_ > 0 ? max_results_ : static_cast<int>(sorted.size());
+  std::vector<float> ymins, xmins, ymaxs, xmaxs, areas;
+  ymins.reserve(max_retained);
+  xmins.reserve(max_retained);
+  ymaxs.reserve(max_retained);
+  xmaxs.reserve(max_retained);
+  areas.reserve(max_retained);
+  const float threshold =
+      options_.non_max_suppression().min_suppression_threshold();
+  std::vector<int> retained;
+  for (int i : sorted) {
+    if (static_cast<int>(retained.size()) >= max_retained) break;
+    const int box_offset = i * num_coords_;
+    const float ymin = detection_boxes[box_offset + box_indices_[0]];
+    const float xmin = detection_boxes[box_offset + box_indices_[1]];
+    const float ymax = detection_boxes[box_offset + box_indices_[2]];
+    const float xmax = detection_boxes[box_offset + box_indices_[3]];
+    const float area = (ymax - ymin) * (xmax - xmin);
+    bool suppressed = false;
+    for (int j = 0; j < static_cast<int>(retained.size()); ++j) {
+      const float intersection_height =
+          std::min(ymax, ymaxs[j]) - std::max(ymin, ymins[j]);
+      const float intersection_width =
+          std::min(xmax, xmaxs[j]) - std::max(xmin, xmins[j]);
+      if (intersection_height <= 0 || intersection_width <= 0) continue;
+      const float intersection = intersection_height * intersection_width;
+      const float normalization = area + areas[j] - intersection;
+      if (normalization > 0 && intersection / normalization > threshold) {
+        suppressed = true;
+        break;
+      }
+    }
+    if (suppressed) continue;
+    retained.push_back(i);
+    ymins.push_back(ymin);
+    xmins.push_back(xmin);
+    ymaxs.push_back(ymax);
+    xmaxs.push_back(xmax);
+    areas.push_back(area);
+  }
+  return retained;
+}
+
 Detection TensorsToDetectionsCalculator::ConvertToDetection(
     float box_ymin, float box_xmin, float box_ymax, float box_xmax, float score,
     int class_id, bool flip_vertically) {
@@ -1200,6 +1398,7 @@ kernel void decodeKernel(
     device float*                   boxes       [[ buffer(0) ]],
     device float*                   raw_boxes   [[ buffer(1) ]],
     device float*                   raw_anchors [[ buffer(2) ]],
+    device float*                   scored_boxes [[ buffer(3) ]],
     uint2                           gid         [[ thread_position_in_grid ]]) {
 
   uint num_coords = uint($0);
@@ -1220,6 +1419,19 @@ kernel void decodeKernel(
 )",
       options_.x_scale(), options_.y_scale(), options_.w_scale(),
       options_.h_scale());
+  // Boxes scoring below min_score_thresh are dropped by ConvertToDetections(),
+  // so they are not decoded. The boxes are scored before they are decoded.
+  decode_src += absl::Substitute(
+      R"(
+  int apply_min_score_thresh = int($0);
+  float min_score_thresh = float($1);
+  if (apply_min_score_thresh == int(1) &&
+      scored_boxes[gid.x * uint(2)] < min_score_thresh) {
+    return;
+  }
+)",
+      options_.has_min_score_thresh() ? 1 : 0,
+      options_.has_min_score_thresh() ? options_.min_score_thresh() : 0);
   decode_src += R"(
   uint g_idx = gid.x;
   uint box_offset = g_idx * num_coords + uint(box_coord_offset);
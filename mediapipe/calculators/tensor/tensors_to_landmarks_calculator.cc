@@ -12,9 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
 #include "mediapipe/calculators/tensor/tensors_to_landmarks_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/flat_landmarks.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -38,6 +44,87 @@ float ApplyActivation(
   }
 }
 
+// A 3x4 row-major affine transform of the x, y and z coordinates.
+using AffineTransform = std::array<float, 12>;
+
+// Returns the transform from raw landmark coordinates to normalized ones,
+// flipped as requested, followed by `projection_matrix` if not null, as done
+// by LandmarkProjectionCalculator.
+AffineTransform GetFlatLandmarksTransform(
+    const ::mediapipe::TensorsToLandmarksCalculatorOptions& options,
+    int num_dimensions, bool flip_horizontally, bool flip_vertically,
+    const std::array<float, 16>* projection_matrix) {
+  const float width = options.input_image_width();
+  const float height = options.input_image_height();
+  // The diagonal and offset of the normalization. Missing coordinates are 0.
+  const float scale[3] = {
+      (flip_horizontally ? -1.0f : 1.0f) / width,
+      num_dimensions > 1 ? (flip_vertically ? -1.0f : 1.0f) / height : 0.0f,
+      num_dimensions > 2 ? 1.0f / width / options.normalize_z() : 0.0f};
+  const float offset[3] = {flip_horizontally ? 1.0f : 0.0f,
+                           num_dimensions > 1 && flip_vertically ? 1.0f : 0.0f,
+                           0.0f};
+
+  AffineTransform projection = {1.0f, 0.0f, 0.0f, 0.0f,  //
+                                0.0f, 1.0f, 0.0f, 0.0f,  //
+                                0.0f, 0.0f, 1.0f, 0.0f};
+  if (projection_matrix != nullptr) {
+    const std::array<float, 16>& m = *projection_matrix;
+    std::copy(m.begin(), m.begin() + 8, projection.begin());
+    // Z is scaled by the length of the projected (0,0) --- (1,0) segment.
+    projection[10] = std::sqrt(m[0] * m[0] + m[4] * m[4]);
+  }
+
+  AffineTransform transform;
+  for (int row = 0; row < 3; ++row) {
+    const float* p = &projection[row * 4];
+    float* t = &transform[row * 4];
+    t[3] = p[3];
+    for (int col = 0; col < 3; ++col) {
+      t[col] = p[col] * scale[col];
+      t[3] += p[col] * offset[col];
+    }
+  }
+  return transform;
+}
+
+// Decodes `num_landmarks` landmarks of `num_dimensions` values each from
+// `raw_landmarks` into `landmarks`, transforming their coordinates with
+// `transform`. The loop has no data-dependent branches so that it can be
+// vectorized.
+void DecodeFlatLandmarks(
+    const float* raw_landmarks, int num_landmarks, int num_dimensions,
+    const AffineTransform& t,
+    const ::mediapipe::TensorsToLandmarksCalculatorOptions& options,
+    FlatLandmarks& landmarks) {
+  using Options = ::mediapipe::TensorsToLandmarksCalculatorOptions;
+  const bool has_visibility = num_dimensions > 3;
+  const bool has_presence = num_dimensions > 4;
+  const bool sigmoid_visibility =
+      options.visibility_activation() == Options::ACTIVATION_SIGMOID;
+  const bool sigmoid_presence =
+      options.presence_activation() == Options::ACTIVATION_SIGMOID;
+  landmarks.resize(num_landmarks);
+  for (int ld = 0; ld < num_landmarks; ++ld) {
+    const float* raw = raw_landmarks + ld * num_dimensions;
+    const float x = raw[0];
+    const float y = num_dimensions > 1 ? raw[1] : 0.0f;
+    const float z = num_dimensions > 2 ? raw[2] : 0.0f;
+    FlatLandmark& landmark = landmarks[ld];
+    landmark.x = t[0] * x + t[1] * y + t[2] * z + t[3];
+    landmark.y = t[4] * x + t[5] * y + t[6] * z + t[7];
+    landmark.z = t[8] * x + t[9] * y + t[10] * z + t[11];
+    landmark.has_visibility = has_visibility;
+    landmark.has_presence = has_presence;
+    if (has_visibility) {
+      landmark.visibility = sigmoid_visibility ? Sigmoid(raw[3]) : raw[3];
+    }
+    if (has_presence) {
+      landmark.presence = sigmoid_presence ? Sigmoid(raw[4]) : raw[4];
+    }
+  }
+}
+
 }  // namespace
 
 // A calculator for converting Tensors from regression models into landmarks.
@@ -57,6 +144,10 @@ float ApplyActivation(
 //  FLIP_VERTICALLY (optional): Whether to flip landmarks vertically or not.
 //  Overrides corresponding side packet and/or field in the calculator options.
 //
+//  PROJECTION_MATRIX (optional): A 4x4 row-major-order matrix that the
+//  FLAT_NORM_LANDMARKS are projected with, as LandmarkProjectionCalculator
+//  does, e.g. to the coordinate system of the image.
+//
 // Input side packet:
 //   FLIP_HORIZONTALLY (optional): Whether to flip landmarks horizontally or
 //   not. Overrides the corresponding field in the calculator options.
@@ -67,6 +158,9 @@ float ApplyActivation(
 // Output:
 //  LANDMARKS(optional) - Result MediaPipe landmarks.
 //  NORM_LANDMARKS(optional) - Result MediaPipe normalized landmarks.
+//  FLAT_NORM_LANDMARKS(optional) - Result normalized landmarks as
+//    FlatLandmarks, projected with PROJECTION_MATRIX if connected. They are
+//    decoded, flipped, normalized and projected in a single pass.
 //
 // Notes:
 //   To output normalized landmarks, user must provide the original input image
@@ -94,11 +188,16 @@ class TensorsToLandmarksCalculator : public Node {
       "FLIP_HORIZONTALLY"};
   static constexpr Input<bool>::SideFallback::Optional kFlipVertically{
       "FLIP_VERTICALLY"};
+  static constexpr Input<std::array<float, 16>>::Optional kInProjectionMatrix{
+      "PROJECTION_MATRIX"};
   static constexpr Output<LandmarkList>::Optional kOutLandmarkList{"LANDMARKS"};
   static constexpr Output<NormalizedLandmarkList>::Optional
       kOutNormalizedLandmarkList{"NORM_LANDMARKS"};
+  static constexpr Output<FlatLandmarks>::Optional kOutFlatLandmarks{
+      "FLAT_NORM_LANDMARKS"};
   MEDIAPIPE_NODE_CONTRACT(kInTensors, kFlipHorizontally, kFlipVertically,
-                          kOutLandmarkList, kOutNormalizedLandmarkList);
+                          kInProjectionMatrix, kOutLandmarkList,
+                          kOutNormalizedLandmarkList, kOutFlatLandmarks);
 
   absl::Status Open(CalculatorContext* cc) override;
   absl::Status Process(CalculatorContext* cc) override;
@@ -113,11 +212,16 @@ MEDIAPIPE_REGISTER_NODE(TensorsToLandmarksCalculator);
 absl::Status TensorsToLandmarksCalculator::Open(CalculatorContext* cc) {
   MP_RETURN_IF_ERROR(LoadOptions(cc));
 
-  if (kOutNormalizedLandmarkList(cc).IsConnected()) {
+  if (kOutNormalizedLandmarkList(cc).IsConnected() ||
+      kOutFlatLandmarks(cc).IsConnected()) {
     RET_CHECK(options_.has_input_image_height() &&
               options_.has_input_image_width())
         << "Must provide input width/height for getting normalized landmarks.";
   }
+  if (kInProjectionMatrix(cc).IsConnected()) {
+    RET_CHECK(kOutFlatLandmarks(cc).IsConnected())
+        << "PROJECTION_MATRIX only applies to FLAT_NORM_LANDMARKS.";
+  }
   if (kOutLandmarkList(cc).IsConnected() &&
       (options_.flip_horizontally() || options_.flip_vertically() ||
        kFlipHorizontally(cc).IsConnected() ||
@@ -147,6 +251,25 @@ absl::Status TensorsToLandmarksCalculator::Process(CalculatorContext* cc) {
   auto view = input_tensors[0].GetCpuReadView();
   auto raw_landmarks = view.buffer<float>();
 
+  if (kOutFlatLandmarks(cc).IsConnected() &&
+      !(kInProjectionMatrix(cc).IsConnected() &&
+        kInProjectionMatrix(cc).IsEmpty())) {
+    const std::array<float, 16>* projection_matrix =
+        kInProjectionMatrix(cc).IsConnected() ? &*kInProjectionMatrix(cc)
+                                              : nullptr;
+    FlatLandmarks flat_landmarks;
+    DecodeFlatLandmarks(raw_landmarks, num_landmarks_, num_dimensions,
+                        GetFlatLandmarksTransform(
+                            options_, num_dimensions, flip_horizontally,
+                            flip_vertically, projection_matrix),
+                        options_, flat_landmarks);
+    kOutFlatLandmarks(cc).Send(std::move(flat_landmarks));
+  }
+  if (!kOutLandmarkList(cc).IsConnected() &&
+      !kOutNormalizedLandmarkList(cc).IsConnected()) {
+    return absl::OkStatus();
+  }
+
   LandmarkList output_landmarks;
 
   for (int ld = 0; ld < num_landmarks_; ++ld) {
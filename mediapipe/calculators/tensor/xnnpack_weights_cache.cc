@@ -0,0 +1,103 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
+
+#include <memory>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/deps/no_destructor.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace mediapipe {
+namespace {
+
+// The shared caches by the address of their model.
+struct SharedCaches {
+  absl::Mutex mutex;
+  absl::flat_hash_map<const void*, std::weak_ptr<XnnpackWeightsCache>> caches
+      ABSL_GUARDED_BY(mutex);
+};
+
+SharedCaches& GetSharedCaches() {
+  static NoDestructor<SharedCaches> shared_caches;
+  return *shared_caches;
+}
+
+}  // namespace
+
+XnnpackWeightsCache::XnnpackWeightsCache(
+    TfLiteXNNPackDelegateWeightsCache* cache, bool shared)
+    : cache_(cache), shared_(shared) {}
+
+XnnpackWeightsCache::~XnnpackWeightsCache() {
+  TfLiteXNNPackDelegateWeightsCacheDelete(cache_);
+}
+
+absl::StatusOr<std::shared_ptr<XnnpackWeightsCache>>
+XnnpackWeightsCache::Create() {
+  TfLiteXNNPackDelegateWeightsCache* cache =
+      TfLiteXNNPackDelegateWeightsCacheCreate();
+  RET_CHECK(cache) << "Failed to create XNNPACK weights cache.";
+  return std::shared_ptr<XnnpackWeightsCache>(
+      new XnnpackWeightsCache(cache, /*shared=*/false));
+}
+
+absl::StatusOr<std::shared_ptr<XnnpackWeightsCache>>
+XnnpackWeightsCache::GetShared(const tflite::FlatBufferModel& model) {
+  SharedCaches& shared_caches = GetSharedCaches();
+  absl::MutexLock lock(&shared_caches.mutex);
+  // A model that was destroyed can't have a cache in use anymore, since each
+  // holder of a cache also holds its model.
+  for (auto it = shared_caches.caches.begin();
+       it != shared_caches.caches.end();) {
+    if (it->second.expired()) {
+      shared_caches.caches.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  std::weak_ptr<XnnpackWeightsCache>& entry =
+      shared_caches.caches[model.GetModel()];
+  if (std::shared_ptr<XnnpackWeightsCache> cache = entry.lock()) {
+    return cache;
+  }
+  TfLiteXNNPackDelegateWeightsCache* cache =
+      TfLiteXNNPackDelegateWeightsCacheCreate();
+  RET_CHECK(cache) << "Failed to create XNNPACK weights cache.";
+  auto shared_cache = std::shared_ptr<XnnpackWeightsCache>(
+      new XnnpackWeightsCache(cache, /*shared=*/true));
+  entry = shared_cache;
+  return shared_cache;
+}
+
+absl::Status XnnpackWeightsCache::Finalize() {
+  absl::MutexLock lock(&mutex_);
+  if (finalized_) return absl::OkStatus();
+  // Soft finalization keeps room for the delegates of later calculators.
+  // Otherwise no more weights are packed once all of the interpreters are
+  // created.
+  RET_CHECK(shared_ ? TfLiteXNNPackDelegateWeightsCacheFinalizeSoft(cache_)
+                    : TfLiteXNNPackDelegateWeightsCacheFinalizeHard(cache_))
+      << "Failed to finalize XNNPACK weights cache.";
+  finalized_ = true;
+  return absl::OkStatus();
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,67 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
+
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace mediapipe {
+
+// A cache of XNNPACK packed weights for the delegates of several interpreters,
+// so that the weights of a model are packed and held in memory once.
+class XnnpackWeightsCache {
+ public:
+  // Returns a new cache for the interpreters of one calculator.
+  static absl::StatusOr<std::shared_ptr<XnnpackWeightsCache>> Create();
+
+  // Returns the cache shared by all interpreters in the process that run
+  // `model`, creating it if needed. The weights are looked up by their address
+  // in the model, so only interpreters of the same loaded model, such as a
+  // model resource or side packet used by several calculators or graphs, can
+  // share it. It lives as long as one of them holds it.
+  static absl::StatusOr<std::shared_ptr<XnnpackWeightsCache>> GetShared(
+      const tflite::FlatBufferModel& model);
+
+  ~XnnpackWeightsCache();
+  XnnpackWeightsCache(const XnnpackWeightsCache&) = delete;
+  XnnpackWeightsCache& operator=(const XnnpackWeightsCache&) = delete;
+
+  TfLiteXNNPackDelegateWeightsCache* get() const { return cache_; }
+
+  // Finalizes the cache once the delegates of a calculator were created, as
+  // required before running them. Later calls do nothing. A shared cache stays
+  // open to the delegates of later calculators, which find their weights
+  // already packed.
+  absl::Status Finalize();
+
+ private:
+  XnnpackWeightsCache(TfLiteXNNPackDelegateWeightsCache* cache, bool shared);
+
+  TfLiteXNNPackDelegateWeightsCache* const cache_;
+  const bool shared_;
+  absl::Mutex mutex_;
+  bool finalized_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <cstring>
+#include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"
@@ -36,6 +39,17 @@ const char kCalculatorOptions[] = "CALCULATOR_OPTIONS";
 
 namespace tf = tensorflow;
 
+namespace {
+
+// The number of tensors the batch storage holds, in multiples of buffer_size.
+constexpr int kBatchStorageCapacityFactor = 4;
+
+char* MutableData(const tf::Tensor& tensor) {
+  return const_cast<char*>(tensor.tensor_data().data());
+}
+
+}  // namespace
+
 // Given an input stream of tensors, concatenates the tensors over timesteps.
 // The concatenated output tensors can be specified to have overlap between
 // output timesteps. The tensors are concatenated along the first dimension, and
@@ -51,6 +65,13 @@ namespace tf = tensorflow;
 // output tensor will have the timestamp of the first input.). This behavior can
 // be adjusted by the timestamp_offset option.
 //
+// Each input tensor is written once into a preallocated batch storage, and the
+// output tensors are slices of it, so an output doesn't copy the buffered
+// tensors. The output is only copied if the slice isn't aligned, i.e. if the
+// byte size of the tensors in the buffer isn't a multiple of the alignment of
+// Eigen. Tensors of types that can't be copied bytewise, such as strings, or of
+// varying shapes are concatenated for each output instead.
+//
 // Example config without padding:
 // node {
 //   calculator: "LappedTensorBufferCalculator"
@@ -94,6 +115,10 @@ class LappedTensorBufferCalculator : public CalculatorBase {
   // Adds a batch dimension to the input tensor if specified in the
   // calculator options.
   absl::Status AddBatchDimension(tf::Tensor* input_tensor);
+  // Adds the tensor to the buffers.
+  void AddToBuffer(const tf::Tensor& tensor, Timestamp timestamp);
+  // Writes the tensor after the previous ones in the batch storage.
+  void AddToBatchStorage(const tf::Tensor& tensor);
   // Sends the current buffer downstream.
   absl::Status ProcessBuffer(CalculatorContext* cc);
 
@@ -106,6 +131,16 @@ class LappedTensorBufferCalculator : public CalculatorBase {
   std::unique_ptr<CircularBuffer<Timestamp>> timestamp_buffer_;
   std::unique_ptr<CircularBuffer<tf::Tensor>> buffer_;
   LappedTensorBufferCalculatorOptions options_;
+
+  // The buffered tensors written one after the other. Once a slice of it has
+  // been output, the storage is never written before the end of the slice, so
+  // that output tensors can share it.
+  tf::Tensor batch_storage_;
+  // The shape of the tensors in the batch storage.
+  tf::TensorShape tensor_shape_;
+  // The first row of the batch storage after the last tensor.
+  int64_t batch_write_row_ = 0;
+  bool batch_storage_enabled_ = true;
 };
 
 REGISTER_CALCULATOR(LappedTensorBufferCalculator);
@@ -175,6 +210,9 @@ absl::Status LappedTensorBufferCalculator::Open(CalculatorContext* cc) {
   buffer_ = absl::make_unique<CircularBuffer<tf::Tensor>>(buffer_size_);
   steps_until_output_ = buffer_size_ - options_.padding();
   initialized_ = false;
+  batch_storage_ = tf::Tensor();
+  batch_write_row_ = 0;
+  batch_storage_enabled_ = true;
   return absl::OkStatus();
 }
 
@@ -188,13 +226,11 @@ absl::Status LappedTensorBufferCalculator::Process(CalculatorContext* cc) {
   // Pad frames at the beginning with the first frame.
   if (!initialized_) {
     for (int i = 0; i < options_.padding(); ++i) {
-      buffer_->push_back(input_tensor);
-      timestamp_buffer_->push_back(cc->InputTimestamp());
+      AddToBuffer(input_tensor, cc->InputTimestamp());
     }
     initialized_ = true;
   }
-  buffer_->push_back(input_tensor);
-  timestamp_buffer_->push_back(cc->InputTimestamp());
+  AddToBuffer(input_tensor, cc->InputTimestamp());
   --steps_until_output_;
   if (steps_until_output_ <= 0) {
     MP_RETURN_IF_ERROR(ProcessBuffer(cc));
@@ -208,10 +244,10 @@ absl::Status LappedTensorBufferCalculator::Close(CalculatorContext* cc) {
     return absl::OkStatus();
   }
   int last_frame = buffer_size_ - steps_until_output_ - 1;
-  const auto& pad_frame = buffer_->Get(last_frame);
+  // Copy the shallow tensor as the buffer overwrites it.
+  const tf::Tensor pad_frame = buffer_->Get(last_frame);
   for (int i = 0; i < steps_until_output_ + options_.padding(); ++i) {
-    buffer_->push_back(pad_frame);
-    timestamp_buffer_->push_back(cc->InputTimestamp());
+    AddToBuffer(pad_frame, cc->InputTimestamp());
   }
   MP_RETURN_IF_ERROR(ProcessBuffer(cc));
 
@@ -232,14 +268,69 @@ absl::Status LappedTensorBufferCalculator::AddBatchDimension(
   return absl::OkStatus();
 }
 
+void LappedTensorBufferCalculator::AddToBuffer(const tf::Tensor& tensor,
+                                               Timestamp timestamp) {
+  buffer_->push_back(tensor);
+  timestamp_buffer_->push_back(timestamp);
+  AddToBatchStorage(tensor);
+}
+
+void LappedTensorBufferCalculator::AddToBatchStorage(const tf::Tensor& tensor) {
+  if (!batch_storage_enabled_) {
+    return;
+  }
+  if (!batch_storage_.IsInitialized()) {
+    if (!tf::DataTypeCanUseMemcpy(tensor.dtype()) || tensor.dims() == 0 ||
+        tensor.dim_size(0) == 0) {
+      batch_storage_enabled_ = false;
+      return;
+    }
+    tensor_shape_ = tensor.shape();
+    tf::TensorShape storage_shape(tensor_shape_);
+    storage_shape.set_dim(0, tensor_shape_.dim_size(0) * buffer_size_ *
+                                 kBatchStorageCapacityFactor);
+    batch_storage_ = tf::Tensor(tensor.dtype(), storage_shape);
+  } else if (tensor.dtype() != batch_storage_.dtype() ||
+             !tensor.shape().IsSameSize(tensor_shape_)) {
+    batch_storage_enabled_ = false;
+    batch_storage_ = tf::Tensor();
+    return;
+  }
+  const int64_t rows = tensor_shape_.dim_size(0);
+  const size_t row_bytes = tensor.tensor_data().size() / rows;
+  if (batch_write_row_ + rows > batch_storage_.dim_size(0)) {
+    // Move the tensors still needed to a new storage rather than to the start
+    // of the current one, which output tensors may share.
+    tf::Tensor storage(batch_storage_.dtype(), batch_storage_.shape());
+    const int64_t kept_rows = rows * (buffer_size_ - 1);
+    std::memcpy(MutableData(storage),
+                batch_storage_.tensor_data().data() +
+                    (batch_write_row_ - kept_rows) * row_bytes,
+                kept_rows * row_bytes);
+    batch_storage_ = std::move(storage);
+    batch_write_row_ = kept_rows;
+  }
+  std::memcpy(MutableData(batch_storage_) + batch_write_row_ * row_bytes,
+              tensor.tensor_data().data(), rows * row_bytes);
+  batch_write_row_ += rows;
+}
+
 // Process buffer
 absl::Status LappedTensorBufferCalculator::ProcessBuffer(
     CalculatorContext* cc) {
   auto concatenated = ::absl::make_unique<tf::Tensor>();
-  const tf::Status concat_status = tf::tensor::Concat(
-      std::vector<tf::Tensor>(buffer_->begin(), buffer_->end()),
-      concatenated.get());
-  RET_CHECK(concat_status.ok()) << concat_status.ToString();
+  if (batch_storage_enabled_) {
+    const int64_t batch_rows = tensor_shape_.dim_size(0) * buffer_size_;
+    tf::Tensor batch =
+        batch_storage_.Slice(batch_write_row_ - batch_rows, batch_write_row_);
+    *concatenated = batch.IsAligned() ? std::move(batch)
+                                      : tf::tensor::DeepCopy(batch);
+  } else {
+    const tf::Status concat_status = tf::tensor::Concat(
+        std::vector<tf::Tensor>(buffer_->begin(), buffer_->end()),
+        concatenated.get());
+    RET_CHECK(concat_status.ok()) << concat_status.ToString();
+  }
   // Output cancatenated tensor.
   cc->Outputs().Index(0).Add(concatenated.release(),
                              timestamp_buffer_->Get(timestamp_offset_));
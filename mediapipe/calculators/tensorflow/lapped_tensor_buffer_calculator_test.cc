@@ -127,6 +127,33 @@ TEST_F(LappedTensorBufferCalculatorTest, OneToThree) {
   }
 }
 
+TEST_F(LappedTensorBufferCalculatorTest, OneToThreeManyTimesteps) {
+  int buffer_size = 3;
+  int overlap = 2;
+  bool add_dim = false;
+  SetUpCalculator(buffer_size, overlap, add_dim, 0, 0, false);
+  // Enough timesteps for the buffered tensors to be moved to new storage.
+  int num_timesteps = 50;
+  for (int i = 0; i < num_timesteps; ++i) {
+    auto input = ::absl::make_unique<tensorflow::Tensor>(
+        tensorflow::DT_FLOAT, tensorflow::TensorShape({1}));
+    input->tensor<float, 1>()(0) = i;
+    runner_->MutableInputs()->Index(0).packets.push_back(
+        Adopt(input.release()).At(Timestamp(i)));
+  }
+  ASSERT_TRUE(runner_->Run().ok());
+
+  const std::vector<Packet>& output_packets =
+      runner_->Outputs().Index(0).packets;
+  ASSERT_EQ(num_timesteps - buffer_size + 1, output_packets.size());
+  for (int i = 0; i < num_timesteps - buffer_size + 1; ++i) {
+    for (int j = 0; j < buffer_size; ++j) {
+      float value = output_packets[i].Get<tf::Tensor>().tensor<float, 1>()(j);
+      ASSERT_NEAR(i + j, value, 0.0001);
+    }
+  }
+}
+
 TEST_F(LappedTensorBufferCalculatorTest, OneToThreeSkip) {
   int buffer_size = 3;
   int overlap = 1;
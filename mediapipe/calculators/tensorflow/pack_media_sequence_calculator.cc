@@ -80,6 +80,10 @@ namespace mpms = mediapipe::mediasequence;
 // prefixed versions of each stream, which allows for multiple image streams to
 // be included. However, the default names are suppored by more tools.
 //
+// The SequenceExample is output when the calculator closes, or, with
+// max_timestamps_per_chunk set, in chunks as the inputs arrive so that long
+// sequences don't have to be held in memory in full.
+//
 // Example config:
 // node {
 //   calculator: "PackMediaSequenceCalculator"
@@ -206,6 +210,14 @@ class PackMediaSequenceCalculator : public CalculatorBase {
           .Tag(kSequenceExampleTag)
           .Set<tf::SequenceExample>();
     }
+    const auto& options = cc->Options<PackMediaSequenceCalculatorOptions>();
+    if (options.max_timestamps_per_chunk() > 0) {
+      RET_CHECK(cc->Outputs().HasTag(kSequenceExampleTag) &&
+                !cc->OutputSidePackets().HasTag(kSequenceExampleTag))
+          << "Chunks are only output on the output stream.";
+      RET_CHECK(!options.output_as_zero_timestamp())
+          << "Chunks can't be output at timestamp 0.";
+    }
     return absl::OkStatus();
   }
 
@@ -340,6 +352,15 @@ class PackMediaSequenceCalculator : public CalculatorBase {
       }
     }
 
+    max_timestamps_per_chunk_ =
+        cc->Options<PackMediaSequenceCalculatorOptions>()
+            .max_timestamps_per_chunk();
+    if (max_timestamps_per_chunk_ > 0) {
+      // Every chunk starts from the sequence as it is before any input.
+      chunk_start_sequence_ =
+          ::absl::make_unique<tf::SequenceExample>(*sequence_);
+    }
+
     return absl::OkStatus();
   }
 
@@ -370,8 +391,10 @@ class PackMediaSequenceCalculator : public CalculatorBase {
     return absl::OkStatus();
   }
 
-  absl::Status Close(CalculatorContext* cc) override {
-    auto& options = cc->Options<PackMediaSequenceCalculatorOptions>();
+  // Reconciles the metadata of the sequence and checks its size, as set in
+  // the options.
+  absl::Status FinalizeSequence(
+      const PackMediaSequenceCalculatorOptions& options) {
     if (options.reconcile_metadata()) {
       RET_CHECK_OK(mpms::ReconcileMetadata(
           options.reconcile_bbox_annotations(),
@@ -381,6 +404,32 @@ class PackMediaSequenceCalculator : public CalculatorBase {
     if (options.skip_large_sequences()) {
       RET_CHECK_OK(VerifySize());
     }
+    return absl::OkStatus();
+  }
+
+  // Outputs the current chunk at `timestamp` and starts the next one.
+  absl::Status OutputChunk(CalculatorContext* cc, Timestamp timestamp) {
+    MP_RETURN_IF_ERROR(
+        FinalizeSequence(cc->Options<PackMediaSequenceCalculatorOptions>()));
+    cc->Outputs()
+        .Tag(kSequenceExampleTag)
+        .Add(sequence_.release(), timestamp);
+    sequence_ =
+        ::absl::make_unique<tf::SequenceExample>(*chunk_start_sequence_);
+    timestamps_in_chunk_ = 0;
+    chunk_has_data_ = false;
+    ++num_chunks_;
+    return absl::OkStatus();
+  }
+
+  absl::Status Close(CalculatorContext* cc) override {
+    auto& options = cc->Options<PackMediaSequenceCalculatorOptions>();
+    // There is no last chunk if the inputs ended right after a chunk.
+    const bool output_sequence =
+        max_timestamps_per_chunk_ == 0 || num_chunks_ == 0 || chunk_has_data_;
+    if (output_sequence) {
+      MP_RETURN_IF_ERROR(FinalizeSequence(options));
+    }
     if (options.output_only_if_all_present()) {
       absl::Status status = VerifySequence();
       if (!status.ok()) {
@@ -388,6 +437,10 @@ class PackMediaSequenceCalculator : public CalculatorBase {
         return status;
       }
     }
+    if (!output_sequence) {
+      sequence_.reset();
+      return absl::OkStatus();
+    }
 
     if (cc->OutputSidePackets().HasTag(kSequenceExampleTag)) {
       cc->OutputSidePackets()
@@ -717,10 +770,24 @@ class PackMediaSequenceCalculator : public CalculatorBase {
     if (clip_media_id_.has_value()) {
       mpms::SetClipMediaId(*clip_media_id_, sequence_.get());
     }
+    chunk_has_data_ = true;
+    if (max_timestamps_per_chunk_ > 0 &&
+        cc->InputTimestamp() != Timestamp::PostStream() &&
+        ++timestamps_in_chunk_ >= max_timestamps_per_chunk_) {
+      MP_RETURN_IF_ERROR(OutputChunk(cc, cc->InputTimestamp()));
+    }
     return absl::OkStatus();
   }
 
   std::unique_ptr<tf::SequenceExample> sequence_;
+  // The sequence that each chunk starts from, if the sequence is output in
+  // chunks.
+  std::unique_ptr<tf::SequenceExample> chunk_start_sequence_;
+  int max_timestamps_per_chunk_ = 0;
+  int timestamps_in_chunk_ = 0;
+  int num_chunks_ = 0;
+  // Whether any input was added to the current chunk.
+  bool chunk_has_data_ = false;
   std::optional<std::string> clip_media_id_ = std::nullopt;
   std::map<std::string, bool> features_present_;
   bool replace_keypoints_;
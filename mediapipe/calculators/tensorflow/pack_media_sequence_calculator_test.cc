@@ -239,6 +239,57 @@ TEST_F(PackMediaSequenceCalculatorTest, PacksTwoFloatLists) {
   }
 }
 
+TEST_F(PackMediaSequenceCalculatorTest, PacksFloatListsInChunks) {
+  CalculatorGraphConfig::Node config;
+  config.set_calculator("PackMediaSequenceCalculator");
+  config.add_input_side_packet("SEQUENCE_EXAMPLE:input_sequence");
+  config.add_input_stream("FLOAT_FEATURE_TEST:test");
+  config.add_output_stream("SEQUENCE_EXAMPLE:output_sequence");
+  auto* options = config.mutable_options()->MutableExtension(
+      PackMediaSequenceCalculatorOptions::ext);
+  options->set_max_timestamps_per_chunk(2);
+  runner_ = ::absl::make_unique<CalculatorRunner>(config);
+  auto input_sequence = ::absl::make_unique<tf::SequenceExample>();
+  std::string test_video_id = "test_video_id";
+  mpms::SetClipMediaId(test_video_id, input_sequence.get());
+
+  int num_timesteps = 5;
+  for (int i = 0; i < num_timesteps; ++i) {
+    auto vf_ptr = ::absl::make_unique<std::vector<float>>(2, i);
+    runner_->MutableInputs()
+        ->Tag(kFloatFeatureTestTag)
+        .packets.push_back(Adopt(vf_ptr.release()).At(Timestamp(i)));
+  }
+
+  runner_->MutableSidePackets()->Tag(kSequenceExampleTag) =
+      Adopt(input_sequence.release());
+
+  MP_ASSERT_OK(runner_->Run());
+
+  const std::vector<Packet>& output_packets =
+      runner_->Outputs().Tag(kSequenceExampleTag).packets;
+  ASSERT_EQ(3, output_packets.size());
+  EXPECT_EQ(Timestamp(1), output_packets[0].Timestamp());
+  EXPECT_EQ(Timestamp(3), output_packets[1].Timestamp());
+  EXPECT_EQ(Timestamp::PostStream(), output_packets[2].Timestamp());
+  int timestep = 0;
+  for (const Packet& packet : output_packets) {
+    const tf::SequenceExample& output_sequence =
+        packet.Get<tf::SequenceExample>();
+    ASSERT_EQ(test_video_id, mpms::GetClipMediaId(output_sequence));
+    const int chunk_size =
+        mpms::GetFeatureTimestampSize("TEST", output_sequence);
+    ASSERT_EQ(chunk_size, mpms::GetFeatureFloatsSize("TEST", output_sequence));
+    for (int i = 0; i < chunk_size; ++i, ++timestep) {
+      ASSERT_EQ(timestep,
+                mpms::GetFeatureTimestampAt("TEST", output_sequence, i));
+      ASSERT_THAT(mpms::GetFeatureFloatsAt("TEST", output_sequence, i),
+                  ::testing::ElementsAreArray(std::vector<float>(2, timestep)));
+    }
+  }
+  ASSERT_EQ(num_timesteps, timestep);
+}
+
 TEST_F(PackMediaSequenceCalculatorTest, PacksTwoIntLists) {
   SetUpCalculator({"INT_FEATURE_TEST:test", "INT_FEATURE_OTHER:test2"}, {},
                   false, true);
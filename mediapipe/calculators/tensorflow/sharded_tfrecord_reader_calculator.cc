@@ -0,0 +1,325 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/calculators/tensorflow/sharded_tfrecord_reader_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/port/threadpool.h"
+#include "mediapipe/framework/tool/status_util.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+
+namespace mediapipe {
+
+namespace {
+
+constexpr char kFilePatternTag[] = "FILE_PATTERN";
+constexpr char kRecordTag[] = "RECORD";
+constexpr char kExampleTag[] = "EXAMPLE";
+constexpr char kSequenceExampleTag[] = "SEQUENCE_EXAMPLE";
+
+}  // namespace
+
+// Reads the records of the tfrecord files matching a pattern, as a stream of
+// serialized records, tensorflow examples or sequence examples, with
+// timestamps counting the records from 0.
+//
+// The files are read in parallel by a thread pool, each up to
+// "readahead_records" records ahead of the output, and the records are
+// decompressed and parsed on the reading threads. By default, the records are
+// output in a deterministic order: the files in the order of their sorted
+// names, and the records of each file in order. With "deterministic" set to
+// false, the records are output as soon as they are read, which keeps the
+// output going when some files are slower to read than others.
+//
+// Example config:
+// node {
+//   calculator: "ShardedTFRecordReaderCalculator"
+//   input_side_packet: "FILE_PATTERN:file_pattern"
+//   output_stream: "SEQUENCE_EXAMPLE:sequence_example"
+//   options {
+//     [mediapipe.ShardedTFRecordReaderCalculatorOptions.ext] {
+//       num_threads: 8
+//       compression_type: "GZIP"
+//     }
+//   }
+// }
+class ShardedTFRecordReaderCalculator : public CalculatorBase {
+ public:
+  ~ShardedTFRecordReaderCalculator() override;
+
+  static absl::Status GetContract(CalculatorContract* cc);
+
+  absl::Status Open(CalculatorContext* cc) override;
+  absl::Status Process(CalculatorContext* cc) override;
+  absl::Status Close(CalculatorContext* cc) override;
+
+ private:
+  // The records read ahead from a file.
+  struct Shard {
+    std::string path;
+    std::deque<Packet> records;
+    // Whether all the records have been read, or reading failed.
+    bool done = false;
+    absl::Status status;
+  };
+
+  // Reads the records of shard `index` on a thread of the pool.
+  void ReadShard(int index);
+  absl::Status ReadRecords(Shard& shard);
+
+  // Returns the packet holding a record in the output type.
+  absl::StatusOr<Packet> MakeRecordPacket(const tensorflow::tstring& record);
+
+  // Takes the next record to output, in the order set by "deterministic".
+  // Returns tool::StatusStop() once all the records have been output.
+  absl::Status NextRecord(Packet* packet) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Stops the reading threads and waits for them.
+  void StopReading();
+
+  ShardedTFRecordReaderCalculatorOptions options_;
+  std::string output_tag_;
+  int64_t num_records_ = 0;
+
+  absl::Mutex mutex_;
+  // Signaled when a record is added to or removed from a shard, when a shard
+  // is done, and on StopReading().
+  absl::CondVar shards_changed_;
+  std::vector<Shard> shards_ ABSL_GUARDED_BY(mutex_);
+  // The shard of the next record if deterministic is set, or the shard that
+  // is looked at first otherwise.
+  int next_shard_ ABSL_GUARDED_BY(mutex_) = 0;
+  int num_done_shards_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Destroyed before the state used by the reading threads.
+  std::unique_ptr<ThreadPool> thread_pool_;
+};
+
+ShardedTFRecordReaderCalculator::~ShardedTFRecordReaderCalculator() {
+  StopReading();
+}
+
+absl::Status ShardedTFRecordReaderCalculator::GetContract(
+    CalculatorContract* cc) {
+  if (cc->InputSidePackets().HasTag(kFilePatternTag)) {
+    cc->InputSidePackets().Tag(kFilePatternTag).Set<std::string>();
+  }
+  RET_CHECK_EQ(cc->Outputs().NumEntries(), 1)
+      << "ShardedTFRecordReaderCalculator must output one of RECORD, EXAMPLE "
+         "or SEQUENCE_EXAMPLE.";
+  if (cc->Outputs().HasTag(kRecordTag)) {
+    cc->Outputs().Tag(kRecordTag).Set<std::string>();
+  } else if (cc->Outputs().HasTag(kExampleTag)) {
+    cc->Outputs().Tag(kExampleTag).Set<tensorflow::Example>();
+  } else {
+    RET_CHECK(cc->Outputs().HasTag(kSequenceExampleTag))
+        << "ShardedTFRecordReaderCalculator must output one of RECORD, "
+           "EXAMPLE or SEQUENCE_EXAMPLE.";
+    cc->Outputs().Tag(kSequenceExampleTag).Set<tensorflow::SequenceExample>();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShardedTFRecordReaderCalculator::Open(CalculatorContext* cc) {
+  options_ = cc->Options<ShardedTFRecordReaderCalculatorOptions>();
+  RET_CHECK_GT(options_.num_threads(), 0);
+  RET_CHECK_GT(options_.readahead_records(), 0);
+  output_tag_ = cc->Outputs().HasTag(kRecordTag)    ? kRecordTag
+                : cc->Outputs().HasTag(kExampleTag) ? kExampleTag
+                                                    : kSequenceExampleTag;
+
+  const std::string& file_pattern =
+      cc->InputSidePackets().HasTag(kFilePatternTag)
+          ? cc->InputSidePackets().Tag(kFilePatternTag).Get<std::string>()
+          : options_.file_pattern();
+  std::vector<std::string> paths;
+  auto tf_status =
+      tensorflow::Env::Default()->GetMatchingPaths(file_pattern, &paths);
+  RET_CHECK(tf_status.ok()) << "Failed to match tfrecord files: "
+                            << tf_status.ToString();
+  RET_CHECK(!paths.empty()) << "No tfrecord file matches " << file_pattern;
+  std::sort(paths.begin(), paths.end());
+
+  {
+    absl::MutexLock lock(&mutex_);
+    shards_.resize(paths.size());
+    for (int i = 0; i < paths.size(); ++i) {
+      shards_[i].path = std::move(paths[i]);
+    }
+  }
+  // Files are started in order, so the file of the next record in
+  // deterministic order is always being read.
+  thread_pool_ = absl::make_unique<ThreadPool>(
+      "tfrecord_reader",
+      std::min<int>(options_.num_threads(), shards_.size()));
+  thread_pool_->StartWorkers();
+  for (int i = 0; i < shards_.size(); ++i) {
+    thread_pool_->Schedule([this, i] { ReadShard(i); });
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShardedTFRecordReaderCalculator::Process(CalculatorContext* cc) {
+  Packet packet;
+  {
+    absl::MutexLock lock(&mutex_);
+    MP_RETURN_IF_ERROR(NextRecord(&packet));
+  }
+  cc->Outputs().Tag(output_tag_).AddPacket(
+      std::move(packet).At(Timestamp(num_records_++)));
+  return absl::OkStatus();
+}
+
+absl::Status ShardedTFRecordReaderCalculator::Close(CalculatorContext* cc) {
+  StopReading();
+  return absl::OkStatus();
+}
+
+absl::Status ShardedTFRecordReaderCalculator::NextRecord(Packet* packet) {
+  const int num_shards = shards_.size();
+  while (true) {
+    if (options_.deterministic()) {
+      if (next_shard_ == num_shards) {
+        return tool::StatusStop();
+      }
+      Shard& shard = shards_[next_shard_];
+      if (!shard.records.empty()) {
+        *packet = std::move(shard.records.front());
+        shard.records.pop_front();
+        shards_changed_.SignalAll();
+        return absl::OkStatus();
+      }
+      if (shard.done) {
+        MP_RETURN_IF_ERROR(shard.status);
+        ++next_shard_;
+        continue;
+      }
+    } else {
+      // Looks at the shards round-robin, so that none of them is starved.
+      for (int i = 0; i < num_shards; ++i) {
+        Shard& shard = shards_[(next_shard_ + i) % num_shards];
+        if (!shard.records.empty()) {
+          *packet = std::move(shard.records.front());
+          shard.records.pop_front();
+          next_shard_ = (next_shard_ + i + 1) % num_shards;
+          shards_changed_.SignalAll();
+          return absl::OkStatus();
+        }
+        if (shard.done) {
+          MP_RETURN_IF_ERROR(shard.status);
+        }
+      }
+      if (num_done_shards_ == num_shards) {
+        return tool::StatusStop();
+      }
+    }
+    shards_changed_.Wait(&mutex_);
+  }
+}
+
+void ShardedTFRecordReaderCalculator::ReadShard(int index) {
+  Shard* shard;
+  {
+    absl::MutexLock lock(&mutex_);
+    shard = &shards_[index];
+  }
+  absl::Status status = ReadRecords(*shard);
+  absl::MutexLock lock(&mutex_);
+  shard->status = std::move(status);
+  shard->done = true;
+  ++num_done_shards_;
+  shards_changed_.SignalAll();
+}
+
+absl::Status ShardedTFRecordReaderCalculator::ReadRecords(Shard& shard) {
+  std::unique_ptr<tensorflow::RandomAccessFile> file;
+  auto tf_status =
+      tensorflow::Env::Default()->NewRandomAccessFile(shard.path, &file);
+  RET_CHECK(tf_status.ok()) << "Failed to open tfrecord file " << shard.path
+                            << ": " << tf_status.ToString();
+  tensorflow::io::SequentialRecordReader reader(
+      file.get(),
+      tensorflow::io::RecordReaderOptions::CreateRecordReaderOptions(
+          options_.compression_type()));
+  tensorflow::tstring record;
+  while (true) {
+    tf_status = reader.ReadRecord(&record);
+    if (tensorflow::errors::IsOutOfRange(tf_status)) {
+      return absl::OkStatus();
+    }
+    RET_CHECK(tf_status.ok()) << "Failed to read tfrecord file " << shard.path
+                              << ": " << tf_status.ToString();
+    ASSIGN_OR_RETURN(Packet packet, MakeRecordPacket(record));
+
+    absl::MutexLock lock(&mutex_);
+    while (!stopped_ && shard.records.size() >= options_.readahead_records()) {
+      shards_changed_.Wait(&mutex_);
+    }
+    if (stopped_) {
+      return absl::OkStatus();
+    }
+    shard.records.push_back(std::move(packet));
+    shards_changed_.SignalAll();
+  }
+}
+
+absl::StatusOr<Packet> ShardedTFRecordReaderCalculator::MakeRecordPacket(
+    const tensorflow::tstring& record) {
+  if (output_tag_ == kRecordTag) {
+    return MakePacket<std::string>(record.data(), record.size());
+  }
+  if (output_tag_ == kExampleTag) {
+    tensorflow::Example example;
+    RET_CHECK(example.ParseFromArray(record.data(), record.size()))
+        << "Failed to parse a tensorflow example.";
+    return MakePacket<tensorflow::Example>(std::move(example));
+  }
+  tensorflow::SequenceExample sequence_example;
+  RET_CHECK(sequence_example.ParseFromArray(record.data(), record.size()))
+      << "Failed to parse a tensorflow sequence example.";
+  return MakePacket<tensorflow::SequenceExample>(std::move(sequence_example));
+}
+
+void ShardedTFRecordReaderCalculator::StopReading() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopped_ = true;
+    shards_changed_.SignalAll();
+  }
+  thread_pool_.reset();
+}
+
+REGISTER_CALCULATOR(ShardedTFRecordReaderCalculator);
+
+}  // namespace mediapipe
@@ -90,6 +90,18 @@ class SimpleSemaphore {
   absl::CondVar cond_;
 };
 
+// Returns true if no input stream has a packet, i.e. if Process() was called
+// for a timestamp bound update.
+bool AllInputsEmpty(CalculatorContext* cc) {
+  for (CollectionItemId id = cc->Inputs().BeginId();
+       id < cc->Inputs().EndId(); ++id) {
+    if (!cc->Inputs().Get(id).IsEmpty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 class InferenceState {
  public:
   InferenceState() : input_tensor_batches_(), batch_timestamps_() {}
@@ -129,6 +141,10 @@ class InferenceState {
 // and the output tensors sent out on the output streams with timestamps
 // corresponding to the input stream packets. Setting the batch_size to 1
 // completely disables batching, but is indepdent of add_batch_dim_to_tensors.
+// For live streams, max_batch_latency_usec also runs a partial batch once the
+// input timestamps have moved that far past its first element, and
+// adaptive_batch_size sizes batches from the observed input rate. Partial
+// batches are padded to batch_size, or to the nearest allowed_batch_sizes.
 //
 // The TensorFlowInferenceCalculator also support feeding states recurrently for
 // RNNs and LSTMs. Simply set the recurrent_tag_pair options to define the
@@ -264,6 +280,10 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
           .Tag(kRecurrentInitTensorsTag)
           .Set<std::unique_ptr<std::map<std::string, tf::Tensor>>>();
     }
+    // Timestamp bounds can flush a partial batch past its deadline.
+    if (options.max_batch_latency_usec() > 0 && !options.batched_input()) {
+      cc->SetProcessTimestampBounds(true);
+    }
     return absl::OkStatus();
   }
 
@@ -339,9 +359,24 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
           << absl::StrJoin(tag_to_tensor_map_, ", ", TagFormatter);
     }
 
+    RET_CHECK(!options_.adaptive_batch_size() ||
+              options_.max_batch_latency_usec() > 0)
+        << "adaptive_batch_size requires max_batch_latency_usec.";
+    int previous_allowed_batch_size = 0;
+    for (int allowed_batch_size : options_.allowed_batch_sizes()) {
+      RET_CHECK_GT(allowed_batch_size, previous_allowed_batch_size)
+          << "allowed_batch_sizes must be positive and increasing.";
+      RET_CHECK_LE(allowed_batch_size, options_.batch_size())
+          << "allowed_batch_sizes must be at most batch_size.";
+      previous_allowed_batch_size = allowed_batch_size;
+    }
+
     {
       absl::WriterMutexLock l(&mutex_);
       inference_state_ = std::unique_ptr<InferenceState>();
+      target_batch_size_ = options_.batch_size();
+      last_input_timestamp_ = Timestamp::Unset();
+      mean_input_interval_usec_ = 0.0;
     }
 
     if (options_.batch_size() == 1 || options_.batched_input()) {
@@ -396,8 +431,75 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
     return absl::OkStatus();
   }
 
+  // Updates the mean interval between input timestamps, and the number of
+  // elements that a batch waits for if adaptive_batch_size is set.
+  void UpdateInputInterval(Timestamp timestamp)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (last_input_timestamp_ != Timestamp::Unset() &&
+        timestamp > last_input_timestamp_) {
+      const double interval_usec = (timestamp - last_input_timestamp_).Value();
+      constexpr double kSmoothing = 0.1;
+      mean_input_interval_usec_ =
+          mean_input_interval_usec_ == 0.0
+              ? interval_usec
+              : mean_input_interval_usec_ +
+                    kSmoothing * (interval_usec - mean_input_interval_usec_);
+      if (options_.adaptive_batch_size()) {
+        const double expected_elements =
+            options_.max_batch_latency_usec() / mean_input_interval_usec_ + 1;
+        target_batch_size_ = expected_elements >= options_.batch_size()
+                                 ? options_.batch_size()
+                                 : static_cast<int>(expected_elements);
+      }
+    }
+    last_input_timestamp_ = timestamp;
+  }
+
+  // Returns true if the batch should be run at the input timestamp.
+  bool IsBatchReady(const InferenceState& inference_state,
+                    Timestamp input_timestamp)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    const auto& batch_timestamps = inference_state.batch_timestamps_;
+    if (batch_timestamps.empty()) {
+      return false;
+    }
+    if (batch_timestamps.size() >= target_batch_size_) {
+      return true;
+    }
+    return options_.max_batch_latency_usec() > 0 &&
+           input_timestamp.IsRangeValue() &&
+           (input_timestamp - batch_timestamps.front()).Value() >=
+               options_.max_batch_latency_usec();
+  }
+
+  // Returns the size that a batch of `num_timestamps` elements is padded to.
+  int PaddedBatchSize(int num_timestamps) const {
+    if (!options_.pad_to_batch_size()) {
+      return num_timestamps;
+    }
+    for (int allowed_batch_size : options_.allowed_batch_sizes()) {
+      if (allowed_batch_size >= num_timestamps) {
+        return allowed_batch_size;
+      }
+    }
+    return options_.batch_size();
+  }
+
   absl::Status Process(CalculatorContext* cc) override {
     std::unique_ptr<InferenceState> inference_state_to_process;
+    if (options_.max_batch_latency_usec() > 0 && !options_.batched_input() &&
+        AllInputsEmpty(cc)) {
+      // A timestamp bound update can only flush a partial batch.
+      {
+        absl::WriterMutexLock l(&mutex_);
+        if (inference_state_ == nullptr ||
+            !IsBatchReady(*inference_state_, cc->InputTimestamp())) {
+          return absl::OkStatus();
+        }
+        inference_state_to_process = std::move(inference_state_);
+      }
+      return OutputBatch(cc, std::move(inference_state_to_process));
+    }
     {
       absl::WriterMutexLock l(&mutex_);
       if (inference_state_ == nullptr) {
@@ -439,6 +541,9 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
       }
       for (const auto& timestamp_and_input_tensors_by_tag :
            input_tensors_by_tag_by_timestamp) {
+        if (!options_.batched_input()) {
+          UpdateInputInterval(timestamp_and_input_tensors_by_tag.first);
+        }
         inference_state_->batch_timestamps_.emplace_back(
             timestamp_and_input_tensors_by_tag.first);
         for (const auto& input_tensor_and_tag :
@@ -447,8 +552,8 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
               .emplace_back(input_tensor_and_tag.second);
         }
       }
-      if (inference_state_->batch_timestamps_.size() == options_.batch_size() ||
-          options_.batched_input()) {
+      if (options_.batched_input() ||
+          IsBatchReady(*inference_state_, cc->InputTimestamp())) {
         inference_state_to_process = std::move(inference_state_);
         inference_state_ = std::unique_ptr<InferenceState>();
       }
@@ -491,6 +596,8 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
                            std::unique_ptr<InferenceState> inference_state) {
     const int64_t start_time = absl::ToUnixMicros(clock_->TimeNow());
     std::vector<std::pair<mediapipe::ProtoString, tf::Tensor>> input_tensors;
+    const int padded_batch_size =
+        PaddedBatchSize(inference_state->batch_timestamps_.size());
 
     for (auto& keyed_tensors : inference_state->input_tensor_batches_) {
       if (options_.batch_size() == 1) {
@@ -508,7 +615,7 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
       } else {
         if (options_.pad_to_batch_size()) {
           // Pad by replicating the first tensor, then ignore the values.
-          keyed_tensors.second.resize(options_.batch_size());
+          keyed_tensors.second.resize(padded_batch_size);
           std::fill(keyed_tensors.second.begin() +
                         inference_state->batch_timestamps_.size(),
                     keyed_tensors.second.end(), keyed_tensors.second[0]);
@@ -579,11 +686,7 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
 
     absl::WriterMutexLock l(&mutex_);
     // Set that we want to split on each index of the 0th dimension.
-    std::vector<tf::int64> split_vector(
-        options_.pad_to_batch_size()
-            ? options_.batch_size()
-            : inference_state->batch_timestamps_.size(),
-        1);
+    std::vector<tf::int64> split_vector(padded_batch_size, 1);
     for (int i = 0; i < output_tensor_names.size(); ++i) {
       if (options_.batch_size() == 1) {
         if (cc->Outputs().HasTag(output_name_in_signature[i])) {
@@ -639,6 +742,14 @@ class TensorFlowInferenceCalculator : public CalculatorBase {
   absl::Mutex mutex_;
   std::unique_ptr<InferenceState> inference_state_ ABSL_GUARDED_BY(mutex_);
 
+  // The number of elements that a batch waits for, which is batch_size unless
+  // adaptive_batch_size is set.
+  int target_batch_size_ ABSL_GUARDED_BY(mutex_) = 0;
+  // The last input timestamp, and the smoothed interval between input
+  // timestamps.
+  Timestamp last_input_timestamp_ ABSL_GUARDED_BY(mutex_);
+  double mean_input_interval_usec_ ABSL_GUARDED_BY(mutex_) = 0.0;
+
   // The options for the calculator.
   TensorFlowInferenceCalculatorOptions options_;
 
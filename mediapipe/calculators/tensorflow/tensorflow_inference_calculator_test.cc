@@ -502,6 +502,85 @@ TEST_F(TensorflowInferenceCalculatorTest, GetCloseBatchComputedNoPadding) {
                    ->Get());
 }
 
+TEST_F(TensorflowInferenceCalculatorTest, GetBatchComputedAfterMaxLatency) {
+  CalculatorGraphConfig::Node config;
+  config.set_calculator("TensorFlowInferenceCalculator");
+  config.add_input_stream("A:tensor_a");
+  config.add_input_stream("B:tensor_b");
+  config.add_output_stream("MULTIPLIED:tensor_o1");
+  config.add_input_side_packet("SESSION:session");
+  CalculatorOptions options;
+  auto* calculator_options =
+      options.MutableExtension(TensorFlowInferenceCalculatorOptions::ext);
+  calculator_options->set_batch_size(4);
+  calculator_options->set_max_batch_latency_usec(10);
+  calculator_options->add_allowed_batch_sizes(2);
+  calculator_options->add_allowed_batch_sizes(4);
+  *config.mutable_options() = options;
+
+  runner_ = absl::make_unique<CalculatorRunner>(config);
+  AddSessionInputSidePacket();
+  // The batch of the first three timestamps is run at timestamp 20, and the
+  // last one, padded to 2, at Close().
+  for (int64_t time : {0, 5, 20, 22}) {
+    const int32_t a = time + 1;
+    AddVectorToInputsAsTensor({a, a, a}, "A", time);
+    AddVectorToInputsAsTensor({3, 4, 5}, "B", time);
+  }
+  MP_ASSERT_OK(runner_->Run());
+
+  const std::vector<Packet>& output_packets_mult =
+      runner_->Outputs().Tag(kMultipliedTag).packets;
+  ASSERT_EQ(4, output_packets_mult.size());
+  for (const Packet& packet : output_packets_mult) {
+    const int32_t a = packet.Timestamp().Value() + 1;
+    tf::test::ExpectTensorEqual<int32_t>(
+        packet.Get<tf::Tensor>(),
+        tf::test::AsTensor<int32_t>({3 * a, 4 * a, 5 * a}));
+  }
+  EXPECT_EQ(2, runner_
+                   ->GetCounter(
+                       "TensorFlowInferenceCalculator-TotalNumSessionRuns")
+                   ->Get());
+}
+
+TEST_F(TensorflowInferenceCalculatorTest, GetAdaptiveBatchComputed) {
+  CalculatorGraphConfig::Node config;
+  config.set_calculator("TensorFlowInferenceCalculator");
+  config.add_input_stream("A:tensor_a");
+  config.add_input_stream("B:tensor_b");
+  config.add_output_stream("MULTIPLIED:tensor_o1");
+  config.add_input_side_packet("SESSION:session");
+  CalculatorOptions options;
+  auto* calculator_options =
+      options.MutableExtension(TensorFlowInferenceCalculatorOptions::ext);
+  calculator_options->set_batch_size(8);
+  calculator_options->set_max_batch_latency_usec(120);
+  calculator_options->set_adaptive_batch_size(true);
+  *config.mutable_options() = options;
+
+  runner_ = absl::make_unique<CalculatorRunner>(config);
+  AddSessionInputSidePacket();
+  // With an input every 50 usec, batches wait for 120 / 50 + 1 = 3 elements.
+  for (int64_t time = 0; time < 500; time += 50) {
+    AddVectorToInputsAsTensor({2, 2, 2}, "A", time);
+    AddVectorToInputsAsTensor({3, 4, 5}, "B", time);
+  }
+  MP_ASSERT_OK(runner_->Run());
+
+  const std::vector<Packet>& output_packets_mult =
+      runner_->Outputs().Tag(kMultipliedTag).packets;
+  ASSERT_EQ(10, output_packets_mult.size());
+  for (const Packet& packet : output_packets_mult) {
+    tf::test::ExpectTensorEqual<int32_t>(
+        packet.Get<tf::Tensor>(), tf::test::AsTensor<int32_t>({6, 8, 10}));
+  }
+  EXPECT_EQ(4, runner_
+                   ->GetCounter(
+                       "TensorFlowInferenceCalculator-TotalNumSessionRuns")
+                   ->Get());
+}
+
 TEST_F(TensorflowInferenceCalculatorTest, GetBatchComputed_MaxInFlight) {
   CalculatorGraphConfig::Node config;
   config.set_calculator("TensorFlowInferenceCalculator");
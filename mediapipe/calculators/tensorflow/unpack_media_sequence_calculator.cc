@@ -106,6 +106,8 @@ namespace mpms = mediapipe::mediasequence;
 // The following output stream tags are supported:
 //   IMAGE: encoded images as strings. (IMAGE_${NAME} is supported.)
 //   FORWARD_FLOW_ENCODED: encoded FORWARD_FLOW prefix images as strings.
+//     With the lazy_unpacking option, these packets share the encoded bytes
+//     of the input SequenceExample instead of copying them.
 //   FLOAT_FEATURE_${NAME}: the feature named ${NAME} as vector<float>.
 //   BBOX: bounding boxes as vector<Location>s. (BBOX_${NAME} is supported.)
 //
@@ -192,6 +194,7 @@ class UnpackMediaSequenceCalculator : public CalculatorBase {
     example_packet_holder_ = cc->InputSidePackets().Tag(kSequenceExampleTag);
     sequence_ = &example_packet_holder_.Get<tf::SequenceExample>();
     const auto& options = cc->Options<UnpackMediaSequenceCalculatorOptions>();
+    lazy_unpacking_ = options.lazy_unpacking();
 
     // Collect the timestamps for all streams keyed by the timestamp feature's
     // key. While creating this data structure we also identify the last
@@ -406,11 +409,10 @@ class UnpackMediaSequenceCalculator : public CalculatorBase {
               possible_tag = absl::StrCat(kImageTag, "_", feature_key);
             }
             if (cc->Outputs().HasTag(possible_tag)) {
-              cc->Outputs()
-                  .Tag(possible_tag)
-                  .Add(new std::string(
-                           mpms::GetImageEncodedAt(feature_key, *sequence_, i)),
-                       current_timestamp);
+              cc->Outputs().Tag(possible_tag).AddPacket(
+                  MakeEncodedPacket(
+                      mpms::GetImageEncodedAt(feature_key, *sequence_, i))
+                      .At(current_timestamp));
             }
           }
 
@@ -418,9 +420,9 @@ class UnpackMediaSequenceCalculator : public CalculatorBase {
               map_kv.first == mpms::GetForwardFlowTimestampKey()) {
             cc->Outputs()
                 .Tag(kForwardFlowImageTag)
-                .Add(new std::string(
-                         mpms::GetForwardFlowEncodedAt(*sequence_, i)),
-                     current_timestamp);
+                .AddPacket(MakeEncodedPacket(
+                               mpms::GetForwardFlowEncodedAt(*sequence_, i))
+                               .At(current_timestamp));
           }
           if (absl::StrContains(map_kv.first, mpms::GetBBoxTimestampKey())) {
             std::vector<std::string> pieces = absl::StrSplit(map_kv.first, '/');
@@ -475,10 +477,22 @@ class UnpackMediaSequenceCalculator : public CalculatorBase {
     }
   }
 
+  // Returns a packet with the encoded bytes, which either owns a copy of them
+  // or, with lazy_unpacking, points into the SequenceExample and holds a copy
+  // of its packet until the returned packet and all its copies are released.
+  Packet MakeEncodedPacket(const std::string& encoded) const {
+    if (!lazy_unpacking_) {
+      return MakePacket<std::string>(encoded);
+    }
+    return PointToForeign(&encoded,
+                          [sequence_packet = example_packet_holder_]() {});
+  }
+
   // Hold a copy of the packet to prevent the shared_ptr from dying and then
   // access the SequenceExample with a handy pointer.
   const tf::SequenceExample* sequence_;
   Packet example_packet_holder_;
+  bool lazy_unpacking_ = false;
 
   // Store a map from the keys for each stream to the timestamps for each
   // key. This allows us to identify which packets to output for each stream
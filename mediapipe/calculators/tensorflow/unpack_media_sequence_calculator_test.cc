@@ -15,6 +15,7 @@
 #include "absl/log/absl_log.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "mediapipe/calculators/core/packet_resampler_calculator.pb.h"
 #include "mediapipe/calculators/tensorflow/unpack_media_sequence_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -138,6 +139,40 @@ TEST_F(UnpackMediaSequenceCalculatorTest, UnpacksOneImage) {
   }
 }
 
+TEST_F(UnpackMediaSequenceCalculatorTest, LazilyUnpacksImages) {
+  CalculatorOptions options;
+  options.MutableExtension(UnpackMediaSequenceCalculatorOptions::ext)
+      ->set_lazy_unpacking(true);
+  SetUpCalculator({"IMAGE:images"}, {}, {}, &options);
+  auto input_sequence = absl::make_unique<tf::SequenceExample>();
+  std::string test_video_id = "test_video_id";
+  mpms::SetClipMediaId(test_video_id, input_sequence.get());
+
+  int num_images = 2;
+  for (int i = 0; i < num_images; ++i) {
+    mpms::AddImageTimestamp(i, input_sequence.get());
+    mpms::AddImageEncoded(absl::StrCat("test_image_string_", i),
+                          input_sequence.get());
+  }
+  const tf::SequenceExample* sequence_ptr = input_sequence.get();
+
+  runner_->MutableSidePackets()->Tag(kSequenceExampleTag) =
+      Adopt(input_sequence.release());
+
+  MP_ASSERT_OK(runner_->Run());
+
+  const std::vector<Packet>& output_packets =
+      runner_->Outputs().Tag(kImageTag).packets;
+  ASSERT_EQ(num_images, output_packets.size());
+
+  for (int i = 0; i < num_images; ++i) {
+    const std::string& output_image = output_packets[i].Get<std::string>();
+    EXPECT_EQ(output_image, absl::StrCat("test_image_string_", i));
+    // The packets share the bytes of the input SequenceExample.
+    EXPECT_EQ(&output_image, &mpms::GetImageEncodedAt(*sequence_ptr, i));
+  }
+}
+
 TEST_F(UnpackMediaSequenceCalculatorTest, UnpacksTwoImages) {
   SetUpCalculator({"IMAGE:images"}, {});
   auto input_sequence = absl::make_unique<tf::SequenceExample>();
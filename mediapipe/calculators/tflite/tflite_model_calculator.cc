@@ -20,6 +20,7 @@
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/util/mapped_file_contents.h"
 #include "tensorflow/lite/allocation.h"
 #include "tensorflow/lite/model.h"
 
@@ -33,7 +34,9 @@ namespace mediapipe {
 //                model blob from file (using whatever APIs you have) and pass
 //                it to the graph as input side packet or you can use some of
 //                calculators like LocalFileContentsCalculator to get model
-//                blob and use it as input here.
+//                blob and use it as input here. A MappedFileContents, e.g.
+//                from LocalFileContentsCalculator with memory_map enabled, is
+//                used without copying the model.
 //   MODEL_FD   - Tflite model file descriptor std::tuple<int, size_t, size_t>
 //                containing (fd, offset, size).
 //
@@ -57,7 +60,9 @@ class TfLiteModelCalculator : public CalculatorBase {
 
   static absl::Status GetContract(CalculatorContract* cc) {
     if (cc->InputSidePackets().HasTag("MODEL_BLOB")) {
-      cc->InputSidePackets().Tag("MODEL_BLOB").Set<std::string>();
+      cc->InputSidePackets()
+          .Tag("MODEL_BLOB")
+          .SetOneOf<std::string, MappedFileContents>();
     }
 
     if (cc->InputSidePackets().HasTag("MODEL_FD")) {
@@ -76,9 +81,15 @@ class TfLiteModelCalculator : public CalculatorBase {
 
     if (cc->InputSidePackets().HasTag("MODEL_BLOB")) {
       model_packet = cc->InputSidePackets().Tag("MODEL_BLOB");
-      const std::string& model_blob = model_packet.Get<std::string>();
-      model = tflite::FlatBufferModel::BuildFromBuffer(model_blob.data(),
-                                                       model_blob.size());
+      if (model_packet.ValidateAsType<MappedFileContents>().ok()) {
+        const auto& model_blob = model_packet.Get<MappedFileContents>();
+        model = tflite::FlatBufferModel::BuildFromBuffer(model_blob.data(),
+                                                         model_blob.size());
+      } else {
+        const std::string& model_blob = model_packet.Get<std::string>();
+        model = tflite::FlatBufferModel::BuildFromBuffer(model_blob.data(),
+                                                         model_blob.size());
+      }
     }
 
     if (cc->InputSidePackets().HasTag("MODEL_FD")) {
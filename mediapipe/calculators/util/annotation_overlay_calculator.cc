@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "absl/log/absl_log.h"
 #include "absl/strings/str_cat.h"
@@ -29,6 +33,7 @@
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/port/vector.h"
+#include "mediapipe/util/annotation_geometry.h"
 #include "mediapipe/util/annotation_renderer.h"
 #include "mediapipe/util/color.pb.h"
 #include "mediapipe/util/render_data.pb.h"
@@ -64,6 +69,27 @@ constexpr uchar kAnnotationBackgroundColor = 2;  // Grayscale value.
 inline bool HasImageTag(mediapipe::CalculatorContext* cc) {
   return cc->Inputs().HasTag(kImageTag);
 }
+
+// Creates the output frame that annotations are rendered into on CPU.
+std::unique_ptr<ImageFrame> CreateOutputFrame(ImageFormat::Format format,
+                                              int width, int height) {
+#if !MEDIAPIPE_DISABLE_GPU
+  return absl::make_unique<ImageFrame>(format, width, height,
+                                       ImageFrame::kGlDefaultAlignmentBoundary);
+#else
+  return absl::make_unique<ImageFrame>(format, width, height,
+                                       ImageFrame::kDefaultAlignmentBoundary);
+#endif  // !MEDIAPIPE_DISABLE_GPU
+}
+
+// Copies the input into the render target, converting grayscale to RGB.
+void CopyToRenderTarget(const cv::Mat& input_mat, cv::Mat& image_mat) {
+  if (input_mat.channels() == 1) {
+    cv::cvtColor(input_mat, image_mat, cv::COLOR_GRAY2RGB);
+  } else {
+    input_mat.copyTo(image_mat);
+  }
+}
 }  // namespace
 
 // A calculator for rendering data on images.
@@ -95,6 +121,10 @@ inline bool HasImageTag(mediapipe::CalculatorContext* cc) {
 // Note: When using GPU, drawing with color kAnnotationBackgroundColor (defined
 // above) is not supported.
 //
+// With gpu_draw_geometry, GPU frames whose annotations are all supported by
+// AnnotationGeometry are drawn as triangles with one draw call, without the
+// CPU canvas and its upload.
+//
 // Example config (CPU):
 // node {
 //   calculator: "AnnotationOverlayCalculator"
@@ -142,22 +172,29 @@ class AnnotationOverlayCalculator : public CalculatorBase {
  private:
   absl::Status CreateRenderTargetCpu(CalculatorContext* cc,
                                      std::unique_ptr<cv::Mat>& image_mat,
-                                     ImageFormat::Format* target_format);
-  absl::Status CreateRenderTargetCpuImage(CalculatorContext* cc,
-                                          std::unique_ptr<cv::Mat>& image_mat,
-                                          ImageFormat::Format* target_format);
+                                     std::unique_ptr<ImageFrame>& output_frame);
+  absl::Status CreateRenderTargetCpuImage(
+      CalculatorContext* cc, std::unique_ptr<cv::Mat>& image_mat,
+      std::unique_ptr<ImageFrame>& output_frame);
   template <typename Type, const char* Tag>
   absl::Status CreateRenderTargetGpu(CalculatorContext* cc,
                                      std::unique_ptr<cv::Mat>& image_mat);
   template <typename Type, const char* Tag>
   absl::Status RenderToGpu(CalculatorContext* cc, uchar* overlay_image);
   absl::Status RenderToCpu(CalculatorContext* cc,
-                           const ImageFormat::Format& target_format,
-                           uchar* data_image);
+                           std::unique_ptr<ImageFrame> output_frame);
+
+  template <typename Type, const char* Tag>
+  absl::Status RenderGeometryToGpu(CalculatorContext* cc);
+
+  // Returns the RenderData of the current timestamp, in drawing order.
+  std::vector<const RenderData*> GetRenderData(CalculatorContext* cc);
 
+  // Draws a full-frame quad with the current program.
   absl::Status GlRender(CalculatorContext* cc);
   template <typename Type, const char* Tag>
   absl::Status GlSetup(CalculatorContext* cc);
+  absl::Status GlSetupGeometry();
 
   // Options for the calculator.
   AnnotationOverlayCalculatorOptions options_;
@@ -178,6 +215,18 @@ class AnnotationOverlayCalculator : public CalculatorBase {
   int height_ = 0;
   int width_canvas_ = 0;  // Size of overlay drawing texture canvas.
   int height_canvas_ = 0;
+  // Overlay drawing image, kept across frames so that only the regions drawn
+  // in the previous and the current frame are cleared and uploaded.
+  cv::Mat overlay_mat_;
+  // Region of overlay_mat_ drawn in the previous frame.
+  cv::Rect overlay_dirty_rect_;
+  // Region of overlay_mat_ that differs from the overlay texture.
+  cv::Rect overlay_upload_rect_;
+  // Programs and vertex buffer of gpu_draw_geometry.
+  GLuint copy_program_ = 0;
+  GLuint geometry_program_ = 0;
+  GLint geometry_viewport_size_unif_ = -1;
+  GLuint geometry_vbo_ = 0;
 #endif  // MEDIAPIPE_DISABLE_GPU
 };
 REGISTER_CALCULATOR(AnnotationOverlayCalculator);
@@ -316,7 +365,7 @@ absl::Status AnnotationOverlayCalculator::Process(CalculatorContext* cc) {
 
   // Initialize render target, drawn with OpenCV.
   std::unique_ptr<cv::Mat> image_mat;
-  ImageFormat::Format target_format;
+  std::unique_ptr<ImageFrame> output_frame;
   if (use_gpu_) {
 #if !MEDIAPIPE_DISABLE_GPU
     if (!gpu_initialized_) {
@@ -329,6 +378,21 @@ absl::Status AnnotationOverlayCalculator::Process(CalculatorContext* cc) {
           }));
       gpu_initialized_ = true;
     }
+    if (options_.gpu_draw_geometry() && image_frame_available_) {
+      const std::vector<const RenderData*> render_data_list =
+          GetRenderData(cc);
+      if (std::all_of(render_data_list.begin(), render_data_list.end(),
+                      [](const RenderData* render_data) {
+                        return AnnotationGeometry::CanTessellate(*render_data);
+                      })) {
+        return gpu_helper_.RunInGlContext([this, cc]() -> absl::Status {
+          if (HasImageTag(cc)) {
+            return RenderGeometryToGpu<mediapipe::Image, kImageTag>(cc);
+          }
+          return RenderGeometryToGpu<mediapipe::GpuBuffer, kGpuBufferTag>(cc);
+        });
+      }
+    }
     if (HasImageTag(cc)) {
       MP_RETURN_IF_ERROR(
           (CreateRenderTargetGpu<mediapipe::Image, kImageTag>(cc, image_mat)));
@@ -342,10 +406,10 @@ absl::Status AnnotationOverlayCalculator::Process(CalculatorContext* cc) {
   } else {
     if (cc->Outputs().HasTag(kImageTag)) {
       MP_RETURN_IF_ERROR(
-          CreateRenderTargetCpuImage(cc, image_mat, &target_format));
+          CreateRenderTargetCpuImage(cc, image_mat, output_frame));
     }
     if (cc->Outputs().HasTag(kImageFrameTag)) {
-      MP_RETURN_IF_ERROR(CreateRenderTargetCpu(cc, image_mat, &target_format));
+      MP_RETURN_IF_ERROR(CreateRenderTargetCpu(cc, image_mat, output_frame));
     }
   }
 
@@ -353,32 +417,20 @@ absl::Status AnnotationOverlayCalculator::Process(CalculatorContext* cc) {
   renderer_->AdoptImage(image_mat.get());
 
   // Render streams onto render target.
-  for (CollectionItemId id = cc->Inputs().BeginId(); id < cc->Inputs().EndId();
-       ++id) {
-    auto tag_and_index = cc->Inputs().TagAndIndexFromId(id);
-    std::string tag = tag_and_index.first;
-    if (!tag.empty() && tag != kVectorTag) {
-      continue;
-    }
-    if (cc->Inputs().Get(id).IsEmpty()) {
-      continue;
-    }
-    if (tag.empty()) {
-      // Empty tag defaults to accepting a single object of RenderData type.
-      const RenderData& render_data = cc->Inputs().Get(id).Get<RenderData>();
-      renderer_->RenderDataOnImage(render_data);
-    } else {
-      RET_CHECK_EQ(kVectorTag, tag);
-      const std::vector<RenderData>& render_data_vec =
-          cc->Inputs().Get(id).Get<std::vector<RenderData>>();
-      for (const RenderData& render_data : render_data_vec) {
-        renderer_->RenderDataOnImage(render_data);
-      }
-    }
+  for (const RenderData* render_data : GetRenderData(cc)) {
+    renderer_->RenderDataOnImage(*render_data);
   }
 
   if (use_gpu_) {
 #if !MEDIAPIPE_DISABLE_GPU
+    // Only the regions cleared or drawn in this frame need to be uploaded.
+    overlay_dirty_rect_ = renderer_->GetDirtyRect();
+    if (overlay_upload_rect_.empty()) {
+      overlay_upload_rect_ = overlay_dirty_rect_;
+    } else if (!overlay_dirty_rect_.empty()) {
+      overlay_upload_rect_ |= overlay_dirty_rect_;
+    }
+
     // Overlay rendered image in OpenGL, onto a copy of input.
     uchar* image_mat_ptr = image_mat->data;
     MP_RETURN_IF_ERROR(
@@ -391,9 +443,8 @@ absl::Status AnnotationOverlayCalculator::Process(CalculatorContext* cc) {
         }));
 #endif  // !MEDIAPIPE_DISABLE_GPU
   } else {
-    // Copy the rendered image to output.
-    uchar* image_mat_ptr = image_mat->data;
-    MP_RETURN_IF_ERROR(RenderToCpu(cc, target_format, image_mat_ptr));
+    // Annotations were rendered straight into the output frame.
+    MP_RETURN_IF_ERROR(RenderToCpu(cc, std::move(output_frame)));
   }
 
   return absl::OkStatus();
@@ -406,28 +457,46 @@ absl::Status AnnotationOverlayCalculator::Close(CalculatorContext* cc) {
     program_ = 0;
     if (image_mat_tex_) glDeleteTextures(1, &image_mat_tex_);
     image_mat_tex_ = 0;
+    if (copy_program_) glDeleteProgram(copy_program_);
+    copy_program_ = 0;
+    if (geometry_program_) glDeleteProgram(geometry_program_);
+    geometry_program_ = 0;
+    if (geometry_vbo_) glDeleteBuffers(1, &geometry_vbo_);
+    geometry_vbo_ = 0;
   });
 #endif  // !MEDIAPIPE_DISABLE_GPU
 
   return absl::OkStatus();
 }
 
-absl::Status AnnotationOverlayCalculator::RenderToCpu(
-    CalculatorContext* cc, const ImageFormat::Format& target_format,
-    uchar* data_image) {
-  auto output_frame = absl::make_unique<ImageFrame>(
-      target_format, renderer_->GetImageWidth(), renderer_->GetImageHeight());
-
-#if !MEDIAPIPE_DISABLE_GPU
-  output_frame->CopyPixelData(target_format, renderer_->GetImageWidth(),
-                              renderer_->GetImageHeight(), data_image,
-                              ImageFrame::kGlDefaultAlignmentBoundary);
-#else
-  output_frame->CopyPixelData(target_format, renderer_->GetImageWidth(),
-                              renderer_->GetImageHeight(), data_image,
-                              ImageFrame::kDefaultAlignmentBoundary);
-#endif  // !MEDIAPIPE_DISABLE_GPU
+std::vector<const RenderData*> AnnotationOverlayCalculator::GetRenderData(
+    CalculatorContext* cc) {
+  std::vector<const RenderData*> render_data_list;
+  for (CollectionItemId id = cc->Inputs().BeginId(); id < cc->Inputs().EndId();
+       ++id) {
+    auto tag_and_index = cc->Inputs().TagAndIndexFromId(id);
+    std::string tag = tag_and_index.first;
+    if (!tag.empty() && tag != kVectorTag) {
+      continue;
+    }
+    if (cc->Inputs().Get(id).IsEmpty()) {
+      continue;
+    }
+    if (tag.empty()) {
+      // Empty tag defaults to accepting a single object of RenderData type.
+      render_data_list.push_back(&cc->Inputs().Get(id).Get<RenderData>());
+    } else {
+      for (const RenderData& render_data :
+           cc->Inputs().Get(id).Get<std::vector<RenderData>>()) {
+        render_data_list.push_back(&render_data);
+      }
+    }
+  }
+  return render_data_list;
+}
 
+absl::Status AnnotationOverlayCalculator::RenderToCpu(
+    CalculatorContext* cc, std::unique_ptr<ImageFrame> output_frame) {
   if (HasImageTag(cc)) {
     auto out = std::make_unique<mediapipe::Image>(std::move(output_frame));
     cc->Outputs().Tag(kImageTag).Add(out.release(), cc->InputTimestamp());
@@ -453,12 +522,16 @@ absl::Status AnnotationOverlayCalculator::RenderToGpu(CalculatorContext* cc,
       input_texture.width(), input_texture.height(),
       mediapipe::GpuBufferFormat::kBGRA32);
 
-  // Upload render target to GPU.
-  {
+  // Upload the changed rows of the render target to GPU. Rows of the canvas
+  // are a multiple of 4 bytes, so they need no unpack alignment.
+  if (!overlay_upload_rect_.empty()) {
+    const int row_size = width_canvas_ * 3;
     glBindTexture(GL_TEXTURE_2D, image_mat_tex_);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_canvas_, height_canvas_,
-                    GL_RGB, GL_UNSIGNED_BYTE, overlay_image);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, overlay_upload_rect_.y, width_canvas_,
+                    overlay_upload_rect_.height, GL_RGB, GL_UNSIGNED_BYTE,
+                    overlay_image + overlay_upload_rect_.y * row_size);
     glBindTexture(GL_TEXTURE_2D, 0);
+    overlay_upload_rect_ = cv::Rect();
   }
 
   // Blend overlay image in GPU shader.
@@ -470,6 +543,7 @@ absl::Status AnnotationOverlayCalculator::RenderToGpu(CalculatorContext* cc,
     glActiveTexture(GL_TEXTURE2);
     glBindTexture(GL_TEXTURE_2D, image_mat_tex_);
 
+    glUseProgram(program_);
     MP_RETURN_IF_ERROR(GlRender(cc));
 
     glActiveTexture(GL_TEXTURE2);
@@ -491,49 +565,112 @@ absl::Status AnnotationOverlayCalculator::RenderToGpu(CalculatorContext* cc,
   return absl::OkStatus();
 }
 
+template <typename Type, const char* Tag>
+absl::Status AnnotationOverlayCalculator::RenderGeometryToGpu(
+    CalculatorContext* cc) {
+#if !MEDIAPIPE_DISABLE_GPU
+  if (!geometry_program_) MP_RETURN_IF_ERROR(GlSetupGeometry());
+
+  const auto& input_frame = cc->Inputs().Tag(Tag).Get<Type>();
+  auto input_texture = gpu_helper_.CreateSourceTexture(input_frame);
+  auto output_texture = gpu_helper_.CreateDestinationTexture(
+      input_texture.width(), input_texture.height(),
+      mediapipe::GpuBufferFormat::kBGRA32);
+
+  AnnotationGeometry geometry(input_texture.width(), input_texture.height());
+  for (const RenderData* render_data : GetRenderData(cc)) {
+    geometry.AddRenderData(*render_data);
+  }
+
+  gpu_helper_.BindFramebuffer(output_texture);
+
+  // Copy the input, then draw all the triangles on top of it at once.
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, input_texture.name());
+  glUseProgram(copy_program_);
+  MP_RETURN_IF_ERROR(GlRender(cc));
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  const std::vector<AnnotationVertex>& vertices = geometry.vertices();
+  if (!vertices.empty()) {
+    glUseProgram(geometry_program_);
+    glUniform2f(geometry_viewport_size_unif_, input_texture.width(),
+                input_texture.height());
+
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, geometry_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(AnnotationVertex),
+                 vertices.data(), GL_STREAM_DRAW);
+    glEnableVertexAttribArray(ATTRIB_VERTEX);
+    glVertexAttribPointer(
+        ATTRIB_VERTEX, 2, GL_FLOAT, GL_FALSE, sizeof(AnnotationVertex),
+        reinterpret_cast<const void*>(offsetof(AnnotationVertex, x)));
+    glEnableVertexAttribArray(ATTRIB_TEXTURE_POSITION);
+    glVertexAttribPointer(
+        ATTRIB_TEXTURE_POSITION, 3, GL_FLOAT, GL_FALSE,
+        sizeof(AnnotationVertex),
+        reinterpret_cast<const void*>(offsetof(AnnotationVertex, r)));
+
+    glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+
+    glDisableVertexAttribArray(ATTRIB_VERTEX);
+    glDisableVertexAttribArray(ATTRIB_TEXTURE_POSITION);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &vao);
+  }
+  glFlush();
+
+  auto output_frame = output_texture.template GetFrame<Type>();
+  cc->Outputs().Tag(Tag).Add(output_frame.release(), cc->InputTimestamp());
+
+  input_texture.Release();
+  output_texture.Release();
+#endif  // !MEDIAPIPE_DISABLE_GPU
+
+  return absl::OkStatus();
+}
+
 absl::Status AnnotationOverlayCalculator::CreateRenderTargetCpu(
     CalculatorContext* cc, std::unique_ptr<cv::Mat>& image_mat,
-    ImageFormat::Format* target_format) {
+    std::unique_ptr<ImageFrame>& output_frame) {
   if (image_frame_available_) {
     const auto& input_frame =
         cc->Inputs().Tag(kImageFrameTag).Get<ImageFrame>();
 
-    int target_mat_type;
+    ImageFormat::Format target_format;
     switch (input_frame.Format()) {
       case ImageFormat::FORMAT_SRGBA:
-        *target_format = ImageFormat::FORMAT_SRGBA;
-        target_mat_type = CV_8UC4;
+        target_format = ImageFormat::FORMAT_SRGBA;
         break;
       case ImageFormat::FORMAT_SRGB:
-        *target_format = ImageFormat::FORMAT_SRGB;
-        target_mat_type = CV_8UC3;
+        target_format = ImageFormat::FORMAT_SRGB;
         break;
       case ImageFormat::FORMAT_GRAY8:
-        *target_format = ImageFormat::FORMAT_SRGB;
-        target_mat_type = CV_8UC3;
+        target_format = ImageFormat::FORMAT_SRGB;
         break;
       default:
         return absl::UnknownError("Unexpected image frame format.");
         break;
     }
 
-    image_mat = absl::make_unique<cv::Mat>(
-        input_frame.Height(), input_frame.Width(), target_mat_type);
-
-    auto input_mat = formats::MatView(&input_frame);
-    if (input_frame.Format() == ImageFormat::FORMAT_GRAY8) {
-      cv::Mat rgb_mat;
-      cv::cvtColor(input_mat, rgb_mat, cv::COLOR_GRAY2RGB);
-      rgb_mat.copyTo(*image_mat);
-    } else {
-      input_mat.copyTo(*image_mat);
-    }
+    // Render into the output frame, so that the input is copied only once.
+    output_frame = CreateOutputFrame(target_format, input_frame.Width(),
+                                     input_frame.Height());
+    image_mat =
+        absl::make_unique<cv::Mat>(formats::MatView(output_frame.get()));
+    CopyToRenderTarget(formats::MatView(&input_frame), *image_mat);
   } else {
-    image_mat = absl::make_unique<cv::Mat>(
-        options_.canvas_height_px(), options_.canvas_width_px(), CV_8UC3,
+    output_frame =
+        CreateOutputFrame(ImageFormat::FORMAT_SRGB, options_.canvas_width_px(),
+                          options_.canvas_height_px());
+    image_mat =
+        absl::make_unique<cv::Mat>(formats::MatView(output_frame.get()));
+    image_mat->setTo(
         cv::Scalar(options_.canvas_color().r(), options_.canvas_color().g(),
                    options_.canvas_color().b()));
-    *target_format = ImageFormat::FORMAT_SRGB;
   }
 
   return absl::OkStatus();
@@ -541,47 +678,42 @@ absl::Status AnnotationOverlayCalculator::CreateRenderTargetCpu(
 
 absl::Status AnnotationOverlayCalculator::CreateRenderTargetCpuImage(
     CalculatorContext* cc, std::unique_ptr<cv::Mat>& image_mat,
-    ImageFormat::Format* target_format) {
+    std::unique_ptr<ImageFrame>& output_frame) {
   if (image_frame_available_) {
     const auto& input_frame =
         cc->Inputs().Tag(kImageTag).Get<mediapipe::Image>();
 
-    int target_mat_type;
+    ImageFormat::Format target_format;
     switch (input_frame.image_format()) {
       case ImageFormat::FORMAT_SRGBA:
-        *target_format = ImageFormat::FORMAT_SRGBA;
-        target_mat_type = CV_8UC4;
+        target_format = ImageFormat::FORMAT_SRGBA;
         break;
       case ImageFormat::FORMAT_SRGB:
-        *target_format = ImageFormat::FORMAT_SRGB;
-        target_mat_type = CV_8UC3;
+        target_format = ImageFormat::FORMAT_SRGB;
         break;
       case ImageFormat::FORMAT_GRAY8:
-        *target_format = ImageFormat::FORMAT_SRGB;
-        target_mat_type = CV_8UC3;
+        target_format = ImageFormat::FORMAT_SRGB;
         break;
       default:
         return absl::UnknownError("Unexpected image frame format.");
         break;
     }
 
-    image_mat = absl::make_unique<cv::Mat>(
-        input_frame.height(), input_frame.width(), target_mat_type);
-
-    auto input_mat = formats::MatView(&input_frame);
-    if (input_frame.image_format() == ImageFormat::FORMAT_GRAY8) {
-      cv::Mat rgb_mat;
-      cv::cvtColor(*input_mat, rgb_mat, cv::COLOR_GRAY2RGB);
-      rgb_mat.copyTo(*image_mat);
-    } else {
-      input_mat->copyTo(*image_mat);
-    }
+    // Render into the output frame, so that the input is copied only once.
+    output_frame = CreateOutputFrame(target_format, input_frame.width(),
+                                     input_frame.height());
+    image_mat =
+        absl::make_unique<cv::Mat>(formats::MatView(output_frame.get()));
+    CopyToRenderTarget(*formats::MatView(&input_frame), *image_mat);
   } else {
-    image_mat = absl::make_unique<cv::Mat>(
-        options_.canvas_height_px(), options_.canvas_width_px(), CV_8UC3,
+    output_frame =
+        CreateOutputFrame(ImageFormat::FORMAT_SRGB, options_.canvas_width_px(),
+                          options_.canvas_height_px());
+    image_mat =
+        absl::make_unique<cv::Mat>(formats::MatView(output_frame.get()));
+    image_mat->setTo(
         cv::Scalar(options_.canvas_color().r(), options_.canvas_color().g(),
                    options_.canvas_color().b()));
-    *target_format = ImageFormat::FORMAT_SRGB;
   }
 
   return absl::OkStatus();
@@ -598,16 +730,23 @@ absl::Status AnnotationOverlayCalculator::CreateRenderTargetGpu(
     if (format != mediapipe::ImageFormat::FORMAT_SRGBA &&
         format != mediapipe::ImageFormat::FORMAT_SRGB)
       RET_CHECK_FAIL() << "Unsupported GPU input format: " << format;
-    image_mat =
-        absl::make_unique<cv::Mat>(height_canvas_, width_canvas_, CV_8UC3);
-    memset(image_mat->data, kAnnotationBackgroundColor,
-           height_canvas_ * width_canvas_ * image_mat->elemSize());
+  }
+  const cv::Scalar background =
+      image_frame_available_
+          ? cv::Scalar::all(kAnnotationBackgroundColor)
+          : cv::Scalar(options_.canvas_color().r(),
+                       options_.canvas_color().g(),
+                       options_.canvas_color().b());
+  if (overlay_mat_.empty()) {
+    overlay_mat_ = cv::Mat(height_canvas_, width_canvas_, CV_8UC3, background);
+    overlay_upload_rect_ = cv::Rect(0, 0, width_canvas_, height_canvas_);
   } else {
-    image_mat = absl::make_unique<cv::Mat>(
-        height_canvas_, width_canvas_, CV_8UC3,
-        cv::Scalar(options_.canvas_color().r(), options_.canvas_color().g(),
-                   options_.canvas_color().b()));
+    // Clear only what was drawn in the previous frame.
+    overlay_mat_(overlay_dirty_rect_).setTo(background);
+    overlay_upload_rect_ = overlay_dirty_rect_;
   }
+  // Annotations are drawn into overlay_mat_. No copy here.
+  image_mat = absl::make_unique<cv::Mat>(overlay_mat_);
 #endif  // !MEDIAPIPE_DISABLE_GPU
 
   return absl::OkStatus();
@@ -628,9 +767,6 @@ absl::Status AnnotationOverlayCalculator::GlRender(CalculatorContext* cc) {
       1.0f, 1.0f,  // top right
   };
 
-  // program
-  glUseProgram(program_);
-
   // vertex storage
   GLuint vbo[2];
   glGenBuffers(2, vbo);
@@ -771,4 +907,79 @@ absl::Status AnnotationOverlayCalculator::GlSetup(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+absl::Status AnnotationOverlayCalculator::GlSetupGeometry() {
+#if !MEDIAPIPE_DISABLE_GPU
+  const GLint attr_location[NUM_ATTRIBUTES] = {
+      ATTRIB_VERTEX,
+      ATTRIB_TEXTURE_POSITION,
+  };
+  const GLchar* copy_attr_name[NUM_ATTRIBUTES] = {
+      "position",
+      "texture_coordinate",
+  };
+  mediapipe::GlhCreateProgram(
+      mediapipe::kBasicVertexShader, mediapipe::kBasicTexturedFragmentShader,
+      NUM_ATTRIBUTES, (const GLchar**)&copy_attr_name[0], attr_location,
+      &copy_program_);
+  RET_CHECK(copy_program_) << "Problem initializing the copy program.";
+  glUseProgram(copy_program_);
+  glUniform1i(glGetUniformLocation(copy_program_, "video_frame"), 1);
+
+  // Triangles with per-vertex colors. Positions are in pixels with top-left
+  // origin, as produced by AnnotationGeometry.
+  constexpr char kVertSrcBody[] = R"(
+    in vec2 position;
+    in vec3 color;
+    uniform vec2 viewport_size;
+    out vec3 vertex_color;
+
+    void main() {
+      vec2 clip_position = position / viewport_size * 2.0 - 1.0;
+  #ifndef INPUT_FRAME_HAS_TOP_LEFT_ORIGIN
+      clip_position.y = -clip_position.y;
+  #endif  // INPUT_FRAME_HAS_TOP_LEFT_ORIGIN
+      gl_Position = vec4(clip_position, 0.0, 1.0);
+      vertex_color = color / 255.0;
+    }
+  )";
+  constexpr char kFragSrcBody[] = R"(
+  DEFAULT_PRECISION(mediump, float)
+  #ifdef GL_ES
+    #define fragColor gl_FragColor
+  #else
+    out vec4 fragColor;
+  #endif  // GL_ES
+
+    in vec3 vertex_color;
+
+    void main() { fragColor = vec4(vertex_color, 1.0); }
+  )";
+
+  std::string defines;
+  if (options_.gpu_uses_top_left_origin()) {
+    defines = R"(
+      #define INPUT_FRAME_HAS_TOP_LEFT_ORIGIN;
+    )";
+  }
+  const std::string vert_src = absl::StrCat(
+      mediapipe::kMediaPipeVertexShaderPreamble, defines, kVertSrcBody);
+  const std::string frag_src = absl::StrCat(
+      mediapipe::kMediaPipeFragmentShaderPreamble, kFragSrcBody);
+  const GLchar* geometry_attr_name[NUM_ATTRIBUTES] = {
+      "position",
+      "color",
+  };
+  mediapipe::GlhCreateProgram(vert_src.c_str(), frag_src.c_str(),
+                              NUM_ATTRIBUTES,
+                              (const GLchar**)&geometry_attr_name[0],
+                              attr_location, &geometry_program_);
+  RET_CHECK(geometry_program_) << "Problem initializing the geometry program.";
+  geometry_viewport_size_unif_ =
+      glGetUniformLocation(geometry_program_, "viewport_size");
+  glGenBuffers(1, &geometry_vbo_);
+#endif  // !MEDIAPIPE_DISABLE_GPU
+
+  return absl::OkStatus();
+}
+
 }  // namespace mediapipe
@@ -15,9 +15,13 @@
 #ifndef MEDIAPIPE_CALCULATORS_UTIL_ASSOCIATION_CALCULATOR_H_
 #define MEDIAPIPE_CALCULATORS_UTIL_ASSOCIATION_CALCULATOR_H_
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
 #include "mediapipe/calculators/util/association_calculator.pb.h"
@@ -31,6 +35,91 @@
 
 namespace mediapipe {
 
+namespace association_internal {
+
+// A uniform grid of square cells over rectangles, to find the rectangles that
+// may intersect a query rectangle without comparing it against all of them.
+// Rectangles spanning too many cells are kept out of the grid and returned by
+// every query.
+class RectangleGrid {
+ public:
+  explicit RectangleGrid(float cell_size) : cell_size_(cell_size) {}
+
+  // Adds the rectangle with index `index`, which must be greater than the
+  // indices of the rectangles already added.
+  void Insert(int index, const Rectangle_f& rect) {
+    CellRange range;
+    if (!GetCellRange(rect, &range)) {
+      oversized_.push_back(index);
+      return;
+    }
+    for (int y = range.ymin; y <= range.ymax; ++y) {
+      for (int x = range.xmin; x <= range.xmax; ++x) {
+        cells_[{x, y}].push_back(index);
+      }
+    }
+  }
+
+  // Sets `indices` to the increasing indices of the rectangles that share a
+  // cell with `rect`, which include all the rectangles intersecting it.
+  // Returns false without setting `indices` if `rect` spans too many cells, in
+  // which case all the rectangles should be considered.
+  bool Query(const Rectangle_f& rect, std::vector<int>* indices) const {
+    CellRange range;
+    if (!GetCellRange(rect, &range)) return false;
+    indices->assign(oversized_.begin(), oversized_.end());
+    for (int y = range.ymin; y <= range.ymax; ++y) {
+      for (int x = range.xmin; x <= range.xmax; ++x) {
+        auto it = cells_.find({x, y});
+        if (it != cells_.end()) {
+          indices->insert(indices->end(), it->second.begin(),
+                          it->second.end());
+        }
+      }
+    }
+    std::sort(indices->begin(), indices->end());
+    indices->erase(std::unique(indices->begin(), indices->end()),
+                   indices->end());
+    return true;
+  }
+
+  void Clear() {
+    cells_.clear();
+    oversized_.clear();
+  }
+
+ private:
+  // The maximum number of cells a rectangle is added to.
+  static constexpr int kMaxCellsPerRectangle = 16;
+
+  struct CellRange {
+    int xmin, ymin, xmax, ymax;
+  };
+
+  // Gets the inclusive range of cells overlapped by `rect`. Returns false if
+  // it spans more than kMaxCellsPerRectangle cells.
+  bool GetCellRange(const Rectangle_f& rect, CellRange* range) const {
+    const float xmin = std::floor(rect.xmin() / cell_size_);
+    const float ymin = std::floor(rect.ymin() / cell_size_);
+    const float xmax = std::floor(rect.xmax() / cell_size_);
+    const float ymax = std::floor(rect.ymax() / cell_size_);
+    // Also rejects NaN coordinates and cells out of the int range.
+    if (!((xmax - xmin + 1) * (ymax - ymin + 1) <= kMaxCellsPerRectangle) ||
+        !(std::fabs(xmin) < 1e6f && std::fabs(ymin) < 1e6f)) {
+      return false;
+    }
+    *range = {static_cast<int>(xmin), static_cast<int>(ymin),
+              static_cast<int>(xmax), static_cast<int>(ymax)};
+    return true;
+  }
+
+  float cell_size_;
+  absl::flat_hash_map<std::pair<int, int>, std::vector<int>> cells_;
+  std::vector<int> oversized_;
+};
+
+}  // namespace association_internal
+
 // AssocationCalculator<T> accepts multiple inputs of vectors of type T that can
 // be converted to Rectangle_f. The output is a vector of type T that contains
 // elements from the input vectors that don't overlap with each other. When
@@ -42,6 +131,9 @@ namespace mediapipe {
 // input stream that don't overlap with other elements are not added to the
 // output. This stream is designed to take detections from previous timestamp,
 // e.g. output of PreviousLoopbackCalculator to provide temporal association.
+// If "spatial_index_cell_size" is set in the options, elements are only
+// compared with the elements that are near them in a grid, which gives the
+// same output but scales better with the number of elements.
 // See AssociationDetectionCalculator and AssociationNormRectCalculator for
 // example uses.
 template <typename T>
@@ -74,16 +166,18 @@ class AssociationCalculator : public CalculatorBase {
     }
     options_ = cc->Options<::mediapipe::AssociationCalculatorOptions>();
     ABSL_CHECK_GE(options_.min_similarity_threshold(), 0);
+    RET_CHECK_GE(options_.spatial_index_cell_size(), 0);
+    if (options_.spatial_index_cell_size() > 0) {
+      index_ = absl::make_unique<association_internal::RectangleGrid>(
+          options_.spatial_index_cell_size());
+    }
 
     return absl::OkStatus();
   }
 
   absl::Status Process(CalculatorContext* cc) override {
-    auto get_non_overlapping_elements = GetNonOverlappingElements(cc);
-    if (!get_non_overlapping_elements.ok()) {
-      return get_non_overlapping_elements.status();
-    }
-    std::list<T> result = get_non_overlapping_elements.value();
+    std::vector<Element> result;
+    MP_RETURN_IF_ERROR(GetNonOverlappingElements(cc, &result));
 
     if (has_prev_input_stream_ &&
         !cc->Inputs().Get(prev_input_stream_id_).IsEmpty()) {
@@ -100,8 +194,10 @@ class AssociationCalculator : public CalculatorBase {
     }
 
     auto output = absl::make_unique<std::vector<T>>();
-    for (auto it = result.begin(); it != result.end(); ++it) {
-      output->push_back(*it);
+    for (Element& element : result) {
+      if (!element.removed) {
+        output->push_back(std::move(element.value));
+      }
     }
     cc->Outputs().Index(0).Add(output.release(), cc->InputTimestamp());
 
@@ -123,51 +219,41 @@ class AssociationCalculator : public CalculatorBase {
   virtual void SetId(T* input, int id) {}
 
  private:
-  // Get a list of non-overlapping elements from all input streams, with
-  // increasing order of priority based on input stream index.
-  absl::StatusOr<std::list<T>> GetNonOverlappingElements(
-      CalculatorContext* cc) {
-    std::list<T> result;
-
-    // Initialize result with the first non-empty input vector.
-    CollectionItemId non_empty_id = cc->Inputs().BeginId();
+  // An element added to the result, with its rectangle.
+  struct Element {
+    T value;
+    Rectangle_f rect;
+    // Whether the element was replaced by an overlapping element.
+    bool removed;
+  };
+
+  // Gets the non-overlapping elements from all input streams, with
+  // increasing order of priority based on input stream index. The elements of
+  // `result` that are not removed are in the order they were added.
+  absl::Status GetNonOverlappingElements(CalculatorContext* cc,
+                                         std::vector<Element>* result) {
+    if (index_) index_->Clear();
+
+    // Compare the input vectors with the result, remove lower-priority
+    // overlapping elements from the result and add the corresponding
+    // higher-priority elements as necessary.
     for (CollectionItemId id = cc->Inputs().BeginId();
          id < cc->Inputs().EndId(); ++id) {
       if (id == prev_input_stream_id_ || cc->Inputs().Get(id).IsEmpty()) {
         continue;
       }
-      const std::vector<T>& input_vec =
-          cc->Inputs().Get(id).Get<std::vector<T>>();
-      if (!input_vec.empty()) {
-        non_empty_id = id;
-        result.push_back(input_vec[0]);
-        for (int j = 1; j < input_vec.size(); ++j) {
-          MP_RETURN_IF_ERROR(AddElementToList(input_vec[j], &result));
-        }
-        break;
-      }
-    }
-
-    // Compare remaining input vectors with the non-empty result vector,
-    // remove lower-priority overlapping elements from the result vector and
-    // had corresponding higher-priority elements as necessary.
-    for (CollectionItemId id = non_empty_id + 1; id < cc->Inputs().EndId();
-         ++id) {
-      if (id == prev_input_stream_id_ || cc->Inputs().Get(id).IsEmpty()) {
-        continue;
-      }
       const std::vector<T>& input_vec =
           cc->Inputs().Get(id).Get<std::vector<T>>();
 
       for (int vi = 0; vi < input_vec.size(); ++vi) {
-        MP_RETURN_IF_ERROR(AddElementToList(input_vec[vi], &result));
+        MP_RETURN_IF_ERROR(AddElementToList(input_vec[vi], result));
       }
     }
 
-    return result;
+    return absl::OkStatus();
   }
 
-  absl::Status AddElementToList(T element, std::list<T>* current) {
+  absl::Status AddElementToList(T element, std::vector<Element>* current) {
     // Compare this element with elements of the input collection. If this
     // element has high overlap with elements of the collection, remove
     // those elements from the collection and add this element.
@@ -176,27 +262,30 @@ class AssociationCalculator : public CalculatorBase {
     bool change_id = false;
     int new_elem_id = -1;
 
-    for (auto uit = current->begin(); uit != current->end();) {
-      ASSIGN_OR_RETURN(auto prev_rect, GetRectangle(*uit));
-      if (CalculateIou(cur_rect, prev_rect) >
+    const bool compare_all = !index_ || !index_->Query(cur_rect, &candidates_);
+    const int num_candidates =
+        compare_all ? current->size() : candidates_.size();
+    for (int ci = 0; ci < num_candidates; ++ci) {
+      Element& prev = (*current)[compare_all ? ci : candidates_[ci]];
+      if (prev.removed) continue;
+      if (CalculateIou(cur_rect, prev.rect) >
           options_.min_similarity_threshold()) {
-        std::pair<bool, int> prev_id = GetId(*uit);
+        std::pair<bool, int> prev_id = GetId(prev.value);
         // If prev_id.first is false when some element doesn't have an ID,
         // change_id and new_elem_id will not be updated.
         if (prev_id.first) {
           change_id = prev_id.first;
           new_elem_id = prev_id.second;
         }
-        uit = current->erase(uit);
-      } else {
-        ++uit;
+        prev.removed = true;
       }
     }
 
     if (change_id) {
       SetId(&element, new_elem_id);
     }
-    current->push_back(element);
+    if (index_) index_->Insert(current->size(), cur_rect);
+    current->push_back({std::move(element), cur_rect, /*removed=*/false});
 
     return absl::OkStatus();
   }
@@ -205,25 +294,32 @@ class AssociationCalculator : public CalculatorBase {
   // of elements from the previous input stream, and propagate IDs from the
   // previous input stream as appropriate.
   absl::Status PropagateIdsFromPreviousToCurrent(
-      const std::vector<T>& prev_input_vec, std::list<T>* current) {
-    for (auto vit = current->begin(); vit != current->end(); ++vit) {
-      auto get_cur_rectangle = GetRectangle(*vit);
-      if (!get_cur_rectangle.ok()) {
-        return get_cur_rectangle.status();
-      }
-      const Rectangle_f& cur_rect = get_cur_rectangle.value();
+      const std::vector<T>& prev_input_vec, std::vector<Element>* current) {
+    if (current->empty()) return absl::OkStatus();
+
+    std::vector<Rectangle_f> prev_rects;
+    prev_rects.reserve(prev_input_vec.size());
+    if (index_) index_->Clear();
+    for (int ui = 0; ui < prev_input_vec.size(); ++ui) {
+      ASSIGN_OR_RETURN(auto prev_rect, GetRectangle(prev_input_vec[ui]));
+      if (index_) index_->Insert(ui, prev_rect);
+      prev_rects.push_back(prev_rect);
+    }
+
+    for (Element& element : *current) {
+      if (element.removed) continue;
+      const Rectangle_f& cur_rect = element.rect;
 
       bool change_id = false;
       int id_for_vi = -1;
 
-      for (int ui = 0; ui < prev_input_vec.size(); ++ui) {
-        auto get_prev_rectangle = GetRectangle(prev_input_vec[ui]);
-        if (!get_prev_rectangle.ok()) {
-          return get_prev_rectangle.status();
-        }
-        const Rectangle_f& prev_rect = get_prev_rectangle.value();
-
-        if (CalculateIou(cur_rect, prev_rect) >
+      const bool compare_all =
+          !index_ || !index_->Query(cur_rect, &candidates_);
+      const int num_candidates =
+          compare_all ? prev_input_vec.size() : candidates_.size();
+      for (int ci = 0; ci < num_candidates; ++ci) {
+        const int ui = compare_all ? ci : candidates_[ci];
+        if (CalculateIou(cur_rect, prev_rects[ui]) >
             options_.min_similarity_threshold()) {
           std::pair<bool, int> prev_id = GetId(prev_input_vec[ui]);
           // If prev_id.first is false when some element doesn't have an ID,
@@ -236,13 +332,16 @@ class AssociationCalculator : public CalculatorBase {
       }
 
       if (change_id) {
-        T element = *vit;
-        SetId(&element, id_for_vi);
-        *vit = element;
+        SetId(&element.value, id_for_vi);
       }
     }
     return absl::OkStatus();
   }
+
+  // The grid of the elements compared with new elements, if enabled.
+  std::unique_ptr<association_internal::RectangleGrid> index_;
+  // The indices of the elements returned by the grid, reused across calls.
+  std::vector<int> candidates_;
 };
 
 }  // namespace mediapipe
@@ -0,0 +1,119 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+// Benchmarks AssociationDetectionCalculator on multi-person frames, where the
+// detections of the current frame are associated with those of the previous
+// frame, with and without the spatial index.
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/substitute.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/location_data.pb.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+
+namespace mediapipe {
+namespace {
+
+// Returns detections with ids and relative bounding boxes of people-sized
+// objects spread over the frame, moved by `offset` in both directions.
+std::vector<Detection> MakeDetections(int num_detections, float offset) {
+  std::mt19937 rng(/*seed=*/0);
+  std::uniform_real_distribution<float> position(0.0f, 0.95f);
+  std::uniform_real_distribution<float> size(0.02f, 0.1f);
+  std::vector<Detection> detections;
+  for (int i = 0; i < num_detections; ++i) {
+    Detection& detection = detections.emplace_back();
+    detection.set_detection_id(i);
+    LocationData* location_data = detection.mutable_location_data();
+    location_data->set_format(LocationData::LOCATION_FORMAT_RELATIVE_BOUNDING_BOX);
+    LocationData::RelativeBoundingBox* box =
+        location_data->mutable_relative_bounding_box();
+    box->set_xmin(position(rng) + offset);
+    box->set_ymin(position(rng) + offset);
+    box->set_width(size(rng));
+    box->set_height(size(rng));
+  }
+  return detections;
+}
+
+// Runs one frame of detections through the calculator in each iteration.
+// The argument is the number of detections per input stream.
+void BM_AssociationDetection(benchmark::State& state, float cell_size) {
+  CalculatorGraph graph;
+  ABSL_CHECK_OK(graph.Initialize(ParseTextProtoOrDie<CalculatorGraphConfig>(
+      absl::Substitute(R"pb(
+                         input_stream: "prev_detections"
+                         input_stream: "tracked_detections"
+                         input_stream: "detections"
+                         num_threads: 1
+                         node {
+                           calculator: "AssociationDetectionCalculator"
+                           input_stream: "PREV:prev_detections"
+                           input_stream: "tracked_detections"
+                           input_stream: "detections"
+                           output_stream: "associated_detections"
+                           options {
+                             [mediapipe.AssociationCalculatorOptions.ext] {
+                               min_similarity_threshold: 0.5
+                               spatial_index_cell_size: $0
+                             }
+                           }
+                         }
+                       )pb",
+                       cell_size))));
+  ABSL_CHECK_OK(graph.StartRun({}));
+  const Packet prev_detections = MakePacket<std::vector<Detection>>(
+      MakeDetections(state.range(0), /*offset=*/0.0f));
+  const Packet tracked_detections = MakePacket<std::vector<Detection>>(
+      MakeDetections(state.range(0), /*offset=*/0.005f));
+  const Packet detections = MakePacket<std::vector<Detection>>(
+      MakeDetections(state.range(0), /*offset=*/0.01f));
+  int64_t timestamp = 0;
+  for (auto _ : state) {
+    const Timestamp input_timestamp(timestamp++);
+    ABSL_CHECK_OK(graph.AddPacketToInputStream(
+        "prev_detections", prev_detections.At(input_timestamp)));
+    ABSL_CHECK_OK(graph.AddPacketToInputStream(
+        "tracked_detections", tracked_detections.At(input_timestamp)));
+    ABSL_CHECK_OK(graph.AddPacketToInputStream(
+        "detections", detections.At(input_timestamp)));
+    ABSL_CHECK_OK(graph.WaitUntilIdle());
+  }
+  ABSL_CHECK_OK(graph.CloseAllInputStreams());
+  ABSL_CHECK_OK(graph.WaitUntilDone());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(BM_AssociationDetection, Exhaustive, 0.0f)
+    ->Arg(4)
+    ->Arg(20)
+    ->Arg(100)
+    ->Arg(500)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_AssociationDetection, SpatialIndex, 0.1f)
+    ->Arg(4)
+    ->Arg(20)
+    ->Arg(100)
+    ->Arg(500)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
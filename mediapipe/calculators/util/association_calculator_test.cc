@@ -12,6 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <random>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/calculators/util/association_calculator.pb.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/calculator_runner.h"
@@ -43,6 +49,61 @@ namespace {
   return detection;
 }
 
+// Returns `num_detections` detections with ids and random relative bounding
+// boxes of up to 0.2 x 0.2 over the frame.
+std::vector<::mediapipe::Detection> RandomDetections(int num_detections,
+                                                     int first_id,
+                                                     std::mt19937* rng) {
+  std::uniform_real_distribution<float> position(-0.1f, 1.0f);
+  std::uniform_real_distribution<float> size(0.01f, 0.2f);
+  std::vector<::mediapipe::Detection> detections;
+  for (int i = 0; i < num_detections; ++i) {
+    detections.push_back(DetectionWithRelativeLocationData(
+        position(*rng), position(*rng), size(*rng), size(*rng)));
+    detections.back().set_detection_id(first_id + i);
+  }
+  return detections;
+}
+
+// Runs AssociationDetectionCalculator on the PREV and regular input streams
+// with the given spatial index cell size, and returns its output.
+std::vector<::mediapipe::Detection> RunDetectionAssociation(
+    const std::vector<std::vector<::mediapipe::Detection>>& inputs,
+    const std::vector<::mediapipe::Detection>& prev_input, float cell_size) {
+  CalculatorGraphConfig::Node config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "AssociationDetectionCalculator"
+        input_stream: "PREV:prev_vec"
+        output_stream: "output_vec"
+        options {
+          [mediapipe.AssociationCalculatorOptions.ext] {
+            min_similarity_threshold: 0.1
+          }
+        }
+      )pb");
+  for (int i = 0; i < inputs.size(); ++i) {
+    config.add_input_stream(absl::StrCat("input_vec_", i));
+  }
+  config.mutable_options()
+      ->MutableExtension(AssociationCalculatorOptions::ext)
+      ->set_spatial_index_cell_size(cell_size);
+  CalculatorRunner runner(config);
+  runner.MutableInputs()->Tag("PREV").packets.push_back(
+      MakePacket<std::vector<::mediapipe::Detection>>(prev_input)
+          .At(Timestamp(1)));
+  for (int i = 0; i < inputs.size(); ++i) {
+    runner.MutableInputs()->Index(i).packets.push_back(
+        MakePacket<std::vector<::mediapipe::Detection>>(inputs[i])
+            .At(Timestamp(1)));
+  }
+  ABSL_CHECK_OK(runner.Run());
+  ABSL_CHECK_EQ(runner.Outputs().Index(0).packets.size(), 1);
+  return runner.Outputs()
+      .Index(0)
+      .packets[0]
+      .Get<std::vector<::mediapipe::Detection>>();
+}
+
 }  // namespace
 
 class AssociationDetectionCalculatorTest : public ::testing::Test {
@@ -207,6 +268,26 @@ TEST_F(AssociationDetectionCalculatorTest, DetectionAssocTestWithPrev) {
   EXPECT_THAT(assoc_rects[0], EqualsProto(det_5));
 }
 
+TEST(AssociationDetectionCalculatorSpatialIndexTest, MatchesExhaustiveSearch) {
+  std::mt19937 rng(/*seed=*/0);
+  const std::vector<std::vector<::mediapipe::Detection>> inputs = {
+      RandomDetections(100, /*first_id=*/0, &rng),
+      RandomDetections(100, /*first_id=*/100, &rng)};
+  const std::vector<::mediapipe::Detection> prev_input =
+      RandomDetections(100, /*first_id=*/1000, &rng);
+
+  const std::vector<::mediapipe::Detection> expected =
+      RunDetectionAssociation(inputs, prev_input, /*cell_size=*/0.0f);
+  for (float cell_size : {0.01f, 0.1f, 1.0f}) {
+    const std::vector<::mediapipe::Detection> actual =
+        RunDetectionAssociation(inputs, prev_input, cell_size);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+      EXPECT_THAT(actual[i], EqualsProto(expected[i]));
+    }
+  }
+}
+
 TEST_F(AssociationDetectionCalculatorTest, DetectionAssocTestReverse) {
   CalculatorRunner runner(ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
     calculator: "AssociationDetectionCalculator"
@@ -95,8 +95,6 @@ class DetectionLetterboxRemovalCalculator : public CalculatorBase {
       return absl::OkStatus();
     }
 
-    const auto& input_detections =
-        cc->Inputs().Tag(kDetectionsTag).Get<std::vector<Detection>>();
     const auto& letterbox_padding =
         cc->Inputs().Tag(kLetterboxPaddingTag).Get<std::array<float, 4>>();
 
@@ -105,47 +103,40 @@ class DetectionLetterboxRemovalCalculator : public CalculatorBase {
     const float left_and_right = letterbox_padding[0] + letterbox_padding[2];
     const float top_and_bottom = letterbox_padding[1] + letterbox_padding[3];
 
-    auto output_detections = absl::make_unique<std::vector<Detection>>();
-    for (const auto& detection : input_detections) {
-      Detection new_detection;
-      new_detection.CopyFrom(detection);
+    // Adjusts the detections in place if this calculator holds the only
+    // reference to them.
+    ASSIGN_OR_RETURN(auto detections,
+                     cc->Inputs()
+                         .Tag(kDetectionsTag)
+                         .Value()
+                         .ConsumeOrCopy<std::vector<Detection>>());
+    for (auto& detection : *detections) {
       LocationData::RelativeBoundingBox* relative_bbox =
-          new_detection.mutable_location_data()
-              ->mutable_relative_bounding_box();
-
-      relative_bbox->set_xmin(
-          (detection.location_data().relative_bounding_box().xmin() - left) /
-          (1.0f - left_and_right));
-      relative_bbox->set_ymin(
-          (detection.location_data().relative_bounding_box().ymin() - top) /
-          (1.0f - top_and_bottom));
+          detection.mutable_location_data()->mutable_relative_bounding_box();
+
+      relative_bbox->set_xmin((relative_bbox->xmin() - left) /
+                              (1.0f - left_and_right));
+      relative_bbox->set_ymin((relative_bbox->ymin() - top) /
+                              (1.0f - top_and_bottom));
       // The size of the bounding box will change as well.
-      relative_bbox->set_width(
-          detection.location_data().relative_bounding_box().width() /
-          (1.0f - left_and_right));
-      relative_bbox->set_height(
-          detection.location_data().relative_bounding_box().height() /
-          (1.0f - top_and_bottom));
+      relative_bbox->set_width(relative_bbox->width() /
+                               (1.0f - left_and_right));
+      relative_bbox->set_height(relative_bbox->height() /
+                                (1.0f - top_and_bottom));
 
       // Adjust keypoints as well.
-      for (int i = 0;
-           i < new_detection.mutable_location_data()->relative_keypoints_size();
-           ++i) {
-        auto* keypoint =
-            new_detection.mutable_location_data()->mutable_relative_keypoints(
-                i);
-        const float new_x = (keypoint->x() - left) / (1.0f - left_and_right);
-        const float new_y = (keypoint->y() - top) / (1.0f - top_and_bottom);
-        keypoint->set_x(new_x);
-        keypoint->set_y(new_y);
+      for (auto& keypoint :
+           *detection.mutable_location_data()->mutable_relative_keypoints()) {
+        const float new_x = (keypoint.x() - left) / (1.0f - left_and_right);
+        const float new_y = (keypoint.y() - top) / (1.0f - top_and_bottom);
+        keypoint.set_x(new_x);
+        keypoint.set_y(new_y);
       }
-
-      output_detections->emplace_back(new_detection);
     }
 
     cc->Outputs()
         .Tag(kDetectionsTag)
-        .Add(output_detections.release(), cc->InputTimestamp());
+        .Add(detections.release(), cc->InputTimestamp());
     return absl::OkStatus();
   }
 };
@@ -156,21 +156,21 @@ absl::Status DetectionProjectionCalculator::Process(CalculatorContext* cc) {
   CollectionItemId output_id = cc->Outputs().BeginId(kDetections);
   // Number of inputs and outpus is the same according to the contract.
   for (; input_id != cc->Inputs().EndId(kDetections); ++input_id, ++output_id) {
-    const auto& input_packet = cc->Inputs().Get(input_id);
+    auto& input_packet = cc->Inputs().Get(input_id).Value();
     if (input_packet.IsEmpty()) {
       continue;
     }
 
-    std::vector<Detection> output_detections;
-    for (const auto& detection : input_packet.Get<std::vector<Detection>>()) {
-      Detection output_detection = detection;
-      MP_RETURN_IF_ERROR(ProjectDetection(project_fn, &output_detection));
-      output_detections.push_back(std::move(output_detection));
+    // Projects the detections in place if this calculator holds the only
+    // reference to them, so that chained transforms don't copy them.
+    ASSIGN_OR_RETURN(auto detections,
+                     input_packet.ConsumeOrCopy<std::vector<Detection>>());
+    for (auto& detection : *detections) {
+      MP_RETURN_IF_ERROR(ProjectDetection(project_fn, &detection));
     }
 
-    cc->Outputs().Get(output_id).AddPacket(
-        MakePacket<std::vector<Detection>>(std::move(output_detections))
-            .At(cc->InputTimestamp()));
+    cc->Outputs().Get(output_id).Add(detections.release(),
+                                     cc->InputTimestamp());
   }
   return absl::OkStatus();
 }
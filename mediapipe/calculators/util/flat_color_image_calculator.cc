@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <memory>
+#include <optional>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "mediapipe/calculators/util/flat_color_image_calculator.pb.h"
@@ -46,7 +48,9 @@ using ::mediapipe::api2::SideOutput;
 // Outputs:
 //   IMAGE (Image)
 //     Image filled with the requested color. Can be either an output_stream
-//     or an output_side_packet.
+//     or an output_side_packet. The same image is sent again while its size
+//     and color do not change, so that it is only filled, and uploaded to GPU
+//     by consumers, once.
 //
 // Example useage:
 // node {
@@ -97,11 +101,13 @@ class FlatColorImageCalculator : public Node {
   absl::Status Process(CalculatorContext* cc) override;
 
  private:
-  std::optional<std::shared_ptr<ImageFrame>> CreateOutputFrame(
-      CalculatorContext* cc);
+  std::optional<Image> CreateOutputImage(CalculatorContext* cc);
 
   bool use_dimension_from_option_ = false;
   bool use_color_from_option_ = false;
+  // The last output image and its color.
+  std::optional<Image> last_image_;
+  Color last_color_;
 };
 MEDIAPIPE_REGISTER_NODE(FlatColorImageCalculator);
 
@@ -110,10 +116,9 @@ absl::Status FlatColorImageCalculator::Open(CalculatorContext* cc) {
   use_color_from_option_ = !kInColor(cc).IsConnected();
 
   if (!kOutImage(cc).IsConnected()) {
-    std::optional<std::shared_ptr<ImageFrame>> output_frame =
-        CreateOutputFrame(cc);
-    if (output_frame.has_value()) {
-      kOutSideImage(cc).Set(Image(output_frame.value()));
+    std::optional<Image> output_image = CreateOutputImage(cc);
+    if (output_image.has_value()) {
+      kOutSideImage(cc).Set(*std::move(output_image));
     }
   }
   return absl::OkStatus();
@@ -121,18 +126,17 @@ absl::Status FlatColorImageCalculator::Open(CalculatorContext* cc) {
 
 absl::Status FlatColorImageCalculator::Process(CalculatorContext* cc) {
   if (kOutImage(cc).IsConnected()) {
-    std::optional<std::shared_ptr<ImageFrame>> output_frame =
-        CreateOutputFrame(cc);
-    if (output_frame.has_value()) {
-      kOutImage(cc).Send(Image(output_frame.value()));
+    std::optional<Image> output_image = CreateOutputImage(cc);
+    if (output_image.has_value()) {
+      kOutImage(cc).Send(*std::move(output_image));
     }
   }
 
   return absl::OkStatus();
 }
 
-std::optional<std::shared_ptr<ImageFrame>>
-FlatColorImageCalculator::CreateOutputFrame(CalculatorContext* cc) {
+std::optional<Image> FlatColorImageCalculator::CreateOutputImage(
+    CalculatorContext* cc) {
   const auto& options = cc->Options<FlatColorImageCalculatorOptions>();
 
   int output_height = -1;
@@ -157,13 +161,23 @@ FlatColorImageCalculator::CreateOutputFrame(CalculatorContext* cc) {
     return std::nullopt;
   }
 
+  // Sent images are immutable, so the last one can be sent again.
+  if (last_image_.has_value() && last_image_->width() == output_width &&
+      last_image_->height() == output_height &&
+      last_color_.r() == color.r() && last_color_.g() == color.g() &&
+      last_color_.b() == color.b()) {
+    return last_image_;
+  }
+
   auto output_frame = std::make_shared<ImageFrame>(ImageFormat::FORMAT_SRGB,
                                                    output_width, output_height);
   cv::Mat output_mat = mediapipe::formats::MatView(output_frame.get());
 
   output_mat.setTo(cv::Scalar(color.r(), color.g(), color.b()));
 
-  return output_frame;
+  last_image_ = Image(std::move(output_frame));
+  last_color_ = color;
+  return last_image_;
 }
 
 }  // namespace mediapipe
@@ -113,6 +113,46 @@ TEST(FlatColorImageCalculatorTest, SpecifyDimensionThroughOptions) {
   }
 }
 
+TEST(FlatColorImageCalculatorTest, ReusesImageUntilSizeChanges) {
+  CalculatorRunner runner(R"pb(
+    calculator: "FlatColorImageCalculator"
+    input_stream: "IMAGE:image"
+    output_stream: "IMAGE:out_image"
+    options {
+      [mediapipe.FlatColorImageCalculatorOptions.ext] {
+        color: {
+          r: 100,
+          g: 200,
+          b: 255,
+        }
+      }
+    }
+  )pb");
+
+  auto image_frame = std::make_shared<ImageFrame>(ImageFormat::FORMAT_SRGB,
+                                                  kImageWidth, kImageHeight);
+  auto larger_image_frame = std::make_shared<ImageFrame>(
+      ImageFormat::FORMAT_SRGB, kImageWidth * 2, kImageHeight);
+  runner.MutableInputs()->Tag(kImageTag).packets.push_back(
+      MakePacket<Image>(image_frame).At(Timestamp(0)));
+  runner.MutableInputs()->Tag(kImageTag).packets.push_back(
+      MakePacket<Image>(image_frame).At(Timestamp(1)));
+  runner.MutableInputs()->Tag(kImageTag).packets.push_back(
+      MakePacket<Image>(larger_image_frame).At(Timestamp(2)));
+  MP_ASSERT_OK(runner.Run());
+
+  const auto& outputs = runner.Outputs().Tag(kImageTag).packets;
+  ASSERT_EQ(outputs.size(), 3);
+  const ImageFrame* first_frame =
+      outputs[0].Get<Image>().GetImageFrameSharedPtr().get();
+  EXPECT_EQ(outputs[1].Get<Image>().GetImageFrameSharedPtr().get(),
+            first_frame);
+  const auto& larger_image = outputs[2].Get<Image>();
+  EXPECT_NE(larger_image.GetImageFrameSharedPtr().get(), first_frame);
+  EXPECT_EQ(larger_image.width(), kImageWidth * 2);
+  EXPECT_EQ(larger_image.GetImageFrameSharedPtr()->PixelData()[0], 100);
+}
+
 TEST(FlatColorImageCalculatorTest, ProducesOutputSidePacket) {
   CalculatorRunner runner(R"pb(
     calculator: "FlatColorImageCalculator"
@@ -0,0 +1,158 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/flat_landmarks.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
+
+// Calculators converting between the landmark and detection protos and their
+// flat counterparts in mediapipe/framework/formats/flat_landmarks.h, at the
+// boundaries of the parts of a graph operating on the latter.
+
+namespace mediapipe {
+namespace api2 {
+
+// Converts a NormalizedLandmarkList into FlatLandmarks.
+//
+// Example config:
+// node {
+//   calculator: "LandmarksToFlatLandmarksCalculator"
+//   input_stream: "landmarks"
+//   output_stream: "flat_landmarks"
+// }
+class LandmarksToFlatLandmarksCalculator : public Node {
+ public:
+  static constexpr Input<NormalizedLandmarkList> kIn{""};
+  static constexpr Output<FlatLandmarks> kOut{""};
+
+  MEDIAPIPE_NODE_CONTRACT(kIn, kOut);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    FlatLandmarks flat_landmarks;
+    ToFlatLandmarks(*kIn(cc), flat_landmarks);
+    kOut(cc).Send(std::move(flat_landmarks));
+    return absl::OkStatus();
+  }
+};
+MEDIAPIPE_REGISTER_NODE(LandmarksToFlatLandmarksCalculator);
+
+// Converts FlatLandmarks into a NormalizedLandmarkList.
+//
+// Example config:
+// node {
+//   calculator: "FlatLandmarksToLandmarksCalculator"
+//   input_stream: "flat_landmarks"
+//   output_stream: "landmarks"
+// }
+class FlatLandmarksToLandmarksCalculator : public Node {
+ public:
+  static constexpr Input<FlatLandmarks> kIn{""};
+  static constexpr Output<NormalizedLandmarkList> kOut{""};
+
+  MEDIAPIPE_NODE_CONTRACT(kIn, kOut);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    NormalizedLandmarkList landmarks;
+    ToNormalizedLandmarkList(*kIn(cc), landmarks);
+    kOut(cc).Send(std::move(landmarks));
+    return absl::OkStatus();
+  }
+};
+MEDIAPIPE_REGISTER_NODE(FlatLandmarksToLandmarksCalculator);
+
+// Converts Detections into FlatDetections, see ToFlatDetection().
+//
+// Example config:
+// node {
+//   calculator: "DetectionsToFlatDetectionsCalculator"
+//   input_stream: "detections"
+//   output_stream: "flat_detections"
+// }
+class DetectionsToFlatDetectionsCalculator : public Node {
+ public:
+  static constexpr Input<std::vector<Detection>> kIn{""};
+  static constexpr Output<FlatDetections> kOut{""};
+
+  MEDIAPIPE_NODE_CONTRACT(kIn, kOut);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    const std::vector<Detection>& detections = *kIn(cc);
+    FlatDetections flat_detections;
+    flat_detections.reserve(detections.size());
+    for (const Detection& detection : detections) {
+      flat_detections.push_back(ToFlatDetection(detection));
+    }
+    kOut(cc).Send(std::move(flat_detections));
+    return absl::OkStatus();
+  }
+};
+MEDIAPIPE_REGISTER_NODE(DetectionsToFlatDetectionsCalculator);
+
+// Converts FlatDetections into Detections with relative bounding boxes.
+//
+// Example config:
+// node {
+//   calculator: "FlatDetectionsToDetectionsCalculator"
+//   input_stream: "flat_detections"
+//   output_stream: "detections"
+// }
+class FlatDetectionsToDetectionsCalculator : public Node {
+ public:
+  static constexpr Input<FlatDetections> kIn{""};
+  static constexpr Output<std::vector<Detection>> kOut{""};
+
+  MEDIAPIPE_NODE_CONTRACT(kIn, kOut);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    const FlatDetections& flat_detections = *kIn(cc);
+    std::vector<Detection> detections;
+    detections.reserve(flat_detections.size());
+    for (const FlatDetection& flat_detection : flat_detections) {
+      detections.push_back(ToDetection(flat_detection));
+    }
+    kOut(cc).Send(std::move(detections));
+    return absl::OkStatus();
+  }
+};
+MEDIAPIPE_REGISTER_NODE(FlatDetectionsToDetectionsCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/flat_landmarks.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/port/ret_check.h"
 
@@ -26,6 +27,39 @@ namespace {
 constexpr char kLandmarksTag[] = "LANDMARKS";
 constexpr char kLetterboxPaddingTag[] = "LETTERBOX_PADDING";
 
+// The letterbox padding as used to adjust the landmark locations.
+struct LetterboxPadding {
+  float left;
+  float top;
+  float left_and_right;
+  float top_and_bottom;
+};
+
+void RemoveLetterbox(const LetterboxPadding& padding,
+                     NormalizedLandmarkList* landmarks) {
+  for (NormalizedLandmark& landmark : *landmarks->mutable_landmark()) {
+    const float new_x =
+        (landmark.x() - padding.left) / (1.0f - padding.left_and_right);
+    const float new_y =
+        (landmark.y() - padding.top) / (1.0f - padding.top_and_bottom);
+    const float new_z = landmark.z() /
+                        (1.0f - padding.left_and_right);  // Scale Z as X.
+    landmark.set_x(new_x);
+    landmark.set_y(new_y);
+    landmark.set_z(new_z);
+  }
+}
+
+void RemoveLetterbox(const LetterboxPadding& padding,
+                     FlatLandmarks* landmarks) {
+  for (FlatLandmark& landmark : *landmarks) {
+    landmark.x = (landmark.x - padding.left) / (1.0f - padding.left_and_right);
+    landmark.y = (landmark.y - padding.top) / (1.0f - padding.top_and_bottom);
+    // Scale Z coordinate as X.
+    landmark.z = landmark.z / (1.0f - padding.left_and_right);
+  }
+}
+
 }  // namespace
 
 // Adjusts landmark locations on a letterboxed image to the corresponding
@@ -62,7 +96,11 @@ constexpr char kLetterboxPaddingTag[] = "LETTERBOX_PADDING";
 //   output_stream: "LANDMARKS:0:adjusted_landmarks_0"
 //   output_stream: "LANDMARKS:1:adjusted_landmarks_1"
 // }
-class LandmarkLetterboxRemovalCalculator : public CalculatorBase {
+//
+// FlatLandmarkLetterboxRemovalCalculator does the same with FlatLandmarks
+// rather than NormalizedLandmarkList protos.
+template <typename LandmarkListT>
+class LandmarkLetterboxRemovalCalculatorImpl : public CalculatorBase {
  public:
   static absl::Status GetContract(CalculatorContract* cc) {
     RET_CHECK(cc->Inputs().HasTag(kLandmarksTag) &&
@@ -75,13 +113,13 @@ class LandmarkLetterboxRemovalCalculator : public CalculatorBase {
 
     for (CollectionItemId id = cc->Inputs().BeginId(kLandmarksTag);
          id != cc->Inputs().EndId(kLandmarksTag); ++id) {
-      cc->Inputs().Get(id).Set<NormalizedLandmarkList>();
+      cc->Inputs().Get(id).template Set<LandmarkListT>();
     }
     cc->Inputs().Tag(kLetterboxPaddingTag).Set<std::array<float, 4>>();
 
     for (CollectionItemId id = cc->Outputs().BeginId(kLandmarksTag);
          id != cc->Outputs().EndId(kLandmarksTag); ++id) {
-      cc->Outputs().Get(id).Set<NormalizedLandmarkList>();
+      cc->Outputs().Get(id).template Set<LandmarkListT>();
     }
 
     return absl::OkStatus();
@@ -99,44 +137,40 @@ class LandmarkLetterboxRemovalCalculator : public CalculatorBase {
     }
     const auto& letterbox_padding =
         cc->Inputs().Tag(kLetterboxPaddingTag).Get<std::array<float, 4>>();
-    const float left = letterbox_padding[0];
-    const float top = letterbox_padding[1];
-    const float left_and_right = letterbox_padding[0] + letterbox_padding[2];
-    const float top_and_bottom = letterbox_padding[1] + letterbox_padding[3];
+    LetterboxPadding padding;
+    padding.left = letterbox_padding[0];
+    padding.top = letterbox_padding[1];
+    padding.left_and_right = letterbox_padding[0] + letterbox_padding[2];
+    padding.top_and_bottom = letterbox_padding[1] + letterbox_padding[3];
 
     CollectionItemId input_id = cc->Inputs().BeginId(kLandmarksTag);
     CollectionItemId output_id = cc->Outputs().BeginId(kLandmarksTag);
     // Number of inputs and outpus is the same according to the contract.
     for (; input_id != cc->Inputs().EndId(kLandmarksTag);
          ++input_id, ++output_id) {
-      const auto& input_packet = cc->Inputs().Get(input_id);
+      auto& input_packet = cc->Inputs().Get(input_id).Value();
       if (input_packet.IsEmpty()) {
         continue;
       }
 
-      const NormalizedLandmarkList& input_landmarks =
-          input_packet.Get<NormalizedLandmarkList>();
-      NormalizedLandmarkList output_landmarks;
-      for (int i = 0; i < input_landmarks.landmark_size(); ++i) {
-        const NormalizedLandmark& landmark = input_landmarks.landmark(i);
-        NormalizedLandmark* new_landmark = output_landmarks.add_landmark();
-        const float new_x = (landmark.x() - left) / (1.0f - left_and_right);
-        const float new_y = (landmark.y() - top) / (1.0f - top_and_bottom);
-        const float new_z =
-            landmark.z() / (1.0f - left_and_right);  // Scale Z coordinate as X.
-        *new_landmark = landmark;
-        new_landmark->set_x(new_x);
-        new_landmark->set_y(new_y);
-        new_landmark->set_z(new_z);
-      }
-
-      cc->Outputs().Get(output_id).AddPacket(
-          MakePacket<NormalizedLandmarkList>(output_landmarks)
-              .At(cc->InputTimestamp()));
+      // Adjusts the landmarks in place if this calculator holds the only
+      // reference to them.
+      ASSIGN_OR_RETURN(auto landmarks,
+                       input_packet.template ConsumeOrCopy<LandmarkListT>());
+      RemoveLetterbox(padding, landmarks.get());
+      cc->Outputs().Get(output_id).Add(landmarks.release(),
+                                       cc->InputTimestamp());
     }
     return absl::OkStatus();
   }
 };
+
+typedef LandmarkLetterboxRemovalCalculatorImpl<NormalizedLandmarkList>
+    LandmarkLetterboxRemovalCalculator;
 REGISTER_CALCULATOR(LandmarkLetterboxRemovalCalculator);
 
+typedef LandmarkLetterboxRemovalCalculatorImpl<FlatLandmarks>
+    FlatLandmarkLetterboxRemovalCalculator;
+REGISTER_CALCULATOR(FlatLandmarkLetterboxRemovalCalculator);
+
 }  // namespace mediapipe
@@ -14,6 +14,7 @@
 
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/flat_landmarks.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
@@ -114,4 +115,49 @@ TEST(LandmarkLetterboxRemovalCalculatorTest, PaddingTopBottom) {
   EXPECT_THAT(output_landmarks.landmark(2).y(), testing::FloatNear(1.0f, 1e-5));
 }
 
+TEST(FlatLandmarkLetterboxRemovalCalculatorTest, PaddingLeftRight) {
+  CalculatorGraphConfig::Node node = GetDefaultNode();
+  node.set_calculator("FlatLandmarkLetterboxRemovalCalculator");
+  CalculatorRunner runner(node);
+
+  FlatLandmarks landmarks(3);
+  landmarks[0].x = 0.5f;
+  landmarks[0].y = 0.5f;
+  landmarks[0].z = 0.1f;
+  landmarks[1].x = 0.2f;
+  landmarks[1].y = 0.2f;
+  landmarks[1].visibility = 0.9f;
+  landmarks[1].has_visibility = true;
+  landmarks[2].x = 0.7f;
+  landmarks[2].y = 0.7f;
+  runner.MutableInputs()
+      ->Tag(kLandmarksTag)
+      .packets.push_back(MakePacket<FlatLandmarks>(std::move(landmarks))
+                             .At(Timestamp::PostStream()));
+
+  auto padding = absl::make_unique<std::array<float, 4>>(
+      std::array<float, 4>{0.2f, 0.f, 0.3f, 0.f});
+  runner.MutableInputs()
+      ->Tag(kLetterboxPaddingTag)
+      .packets.push_back(Adopt(padding.release()).At(Timestamp::PostStream()));
+
+  MP_ASSERT_OK(runner.Run()) << "Calculator execution failed.";
+  const std::vector<Packet>& output =
+      runner.Outputs().Tag(kLandmarksTag).packets;
+  ASSERT_EQ(1, output.size());
+  const auto& output_landmarks = output[0].Get<FlatLandmarks>();
+
+  ASSERT_EQ(output_landmarks.size(), 3);
+
+  EXPECT_THAT(output_landmarks[0].x, testing::FloatNear(0.6f, 1e-5));
+  EXPECT_THAT(output_landmarks[0].y, testing::FloatNear(0.5f, 1e-5));
+  EXPECT_THAT(output_landmarks[0].z, testing::FloatNear(0.2f, 1e-5));
+  EXPECT_THAT(output_landmarks[1].x, testing::FloatNear(0.0f, 1e-5));
+  EXPECT_THAT(output_landmarks[1].y, testing::FloatNear(0.2f, 1e-5));
+  EXPECT_TRUE(output_landmarks[1].has_visibility);
+  EXPECT_EQ(output_landmarks[1].visibility, 0.9f);
+  EXPECT_THAT(output_landmarks[2].x, testing::FloatNear(1.0f, 1e-5));
+  EXPECT_THAT(output_landmarks[2].y, testing::FloatNear(0.7f, 1e-5));
+}
+
 }  // namespace mediapipe
@@ -18,6 +18,7 @@
 
 #include "mediapipe/calculators/util/landmark_projection_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/flat_landmarks.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -32,6 +33,28 @@ constexpr char kLandmarksTag[] = "NORM_LANDMARKS";
 constexpr char kRectTag[] = "NORM_RECT";
 constexpr char kProjectionMatrix[] = "PROJECTION_MATRIX";
 
+// Projects the x, y and z coordinates of a landmark in place.
+using ProjectFn = std::function<void(float& x, float& y, float& z)>;
+
+void ProjectLandmarks(const ProjectFn& project_fn,
+                      NormalizedLandmarkList* landmarks) {
+  for (NormalizedLandmark& landmark : *landmarks->mutable_landmark()) {
+    float x = landmark.x();
+    float y = landmark.y();
+    float z = landmark.z();
+    project_fn(x, y, z);
+    landmark.set_x(x);
+    landmark.set_y(y);
+    landmark.set_z(z);
+  }
+}
+
+void ProjectLandmarks(const ProjectFn& project_fn, FlatLandmarks* landmarks) {
+  for (FlatLandmark& landmark : *landmarks) {
+    project_fn(landmark.x, landmark.y, landmark.z);
+  }
+}
+
 }  // namespace
 
 // Projects normalized landmarks to its original coordinates.
@@ -89,7 +112,11 @@ constexpr char kProjectionMatrix[] = "PROJECTION_MATRIX";
 //   output_stream: "NORM_LANDMARKS:0:projected_landmarks_0"
 //   output_stream: "NORM_LANDMARKS:1:projected_landmarks_1"
 // }
-class LandmarkProjectionCalculator : public CalculatorBase {
+//
+// FlatLandmarkProjectionCalculator does the same with FlatLandmarks rather
+// than NormalizedLandmarkList protos.
+template <typename LandmarkListT>
+class LandmarkProjectionCalculatorImpl : public CalculatorBase {
  public:
   static absl::Status GetContract(CalculatorContract* cc) {
     RET_CHECK(cc->Inputs().HasTag(kLandmarksTag))
@@ -101,7 +128,7 @@ class LandmarkProjectionCalculator : public CalculatorBase {
 
     for (CollectionItemId id = cc->Inputs().BeginId(kLandmarksTag);
          id != cc->Inputs().EndId(kLandmarksTag); ++id) {
-      cc->Inputs().Get(id).Set<NormalizedLandmarkList>();
+      cc->Inputs().Get(id).template Set<LandmarkListT>();
     }
     RET_CHECK(cc->Inputs().HasTag(kRectTag) ^
               cc->Inputs().HasTag(kProjectionMatrix))
@@ -114,7 +141,7 @@ class LandmarkProjectionCalculator : public CalculatorBase {
 
     for (CollectionItemId id = cc->Outputs().BeginId(kLandmarksTag);
          id != cc->Outputs().EndId(kLandmarksTag); ++id) {
-      cc->Outputs().Get(id).Set<NormalizedLandmarkList>();
+      cc->Outputs().Get(id).template Set<LandmarkListT>();
     }
 
     return absl::OkStatus();
@@ -126,13 +153,11 @@ class LandmarkProjectionCalculator : public CalculatorBase {
     return absl::OkStatus();
   }
 
-  static void ProjectXY(const NormalizedLandmark& lm,
-                        const std::array<float, 16>& matrix,
-                        NormalizedLandmark* out) {
-    out->set_x(lm.x() * matrix[0] + lm.y() * matrix[1] + lm.z() * matrix[2] +
-               matrix[3]);
-    out->set_y(lm.x() * matrix[4] + lm.y() * matrix[5] + lm.z() * matrix[6] +
-               matrix[7]);
+  static void ProjectXY(float x, float y, float z,
+                        const std::array<float, 16>& matrix, float* out_x,
+                        float* out_y) {
+    *out_x = x * matrix[0] + y * matrix[1] + z * matrix[2] + matrix[3];
+    *out_y = x * matrix[4] + y * matrix[5] + z * matrix[6] + matrix[7];
   }
 
   /**
@@ -142,23 +167,15 @@ class LandmarkProjectionCalculator : public CalculatorBase {
    * 2. Calculate length of the projected segment.
    */
   static float CalculateZScale(const std::array<float, 16>& matrix) {
-    NormalizedLandmark a;
-    a.set_x(0.0f);
-    a.set_y(0.0f);
-    NormalizedLandmark b;
-    b.set_x(1.0f);
-    b.set_y(0.0f);
-    NormalizedLandmark a_projected;
-    ProjectXY(a, matrix, &a_projected);
-    NormalizedLandmark b_projected;
-    ProjectXY(b, matrix, &b_projected);
-    return std::sqrt(std::pow(b_projected.x() - a_projected.x(), 2) +
-                     std::pow(b_projected.y() - a_projected.y(), 2));
+    float a_x, a_y;
+    ProjectXY(0.0f, 0.0f, 0.0f, matrix, &a_x, &a_y);
+    float b_x, b_y;
+    ProjectXY(1.0f, 0.0f, 0.0f, matrix, &b_x, &b_y);
+    return std::sqrt(std::pow(b_x - a_x, 2) + std::pow(b_y - a_y, 2));
   }
 
   absl::Status Process(CalculatorContext* cc) override {
-    std::function<void(const NormalizedLandmark&, NormalizedLandmark*)>
-        project_fn;
+    ProjectFn project_fn;
     if (cc->Inputs().HasTag(kRectTag)) {
       if (cc->Inputs().Tag(kRectTag).IsEmpty()) {
         return absl::OkStatus();
@@ -166,26 +183,21 @@ class LandmarkProjectionCalculator : public CalculatorBase {
       const auto& input_rect = cc->Inputs().Tag(kRectTag).Get<NormalizedRect>();
       const auto& options =
           cc->Options<mediapipe::LandmarkProjectionCalculatorOptions>();
-      project_fn = [&input_rect, &options](const NormalizedLandmark& landmark,
-                                           NormalizedLandmark* new_landmark) {
+      project_fn = [&input_rect, &options](float& x, float& y, float& z) {
         // TODO: fix projection or deprecate (current projection
         // calculations are incorrect for general case).
-        const float x = landmark.x() - 0.5f;
-        const float y = landmark.y() - 0.5f;
+        const float centered_x = x - 0.5f;
+        const float centered_y = y - 0.5f;
         const float angle =
             options.ignore_rotation() ? 0 : input_rect.rotation();
-        float new_x = std::cos(angle) * x - std::sin(angle) * y;
-        float new_y = std::sin(angle) * x + std::cos(angle) * y;
-
-        new_x = new_x * input_rect.width() + input_rect.x_center();
-        new_y = new_y * input_rect.height() + input_rect.y_center();
-        const float new_z =
-            landmark.z() * input_rect.width();  // Scale Z coordinate as X.
-
-        *new_landmark = landmark;
-        new_landmark->set_x(new_x);
-        new_landmark->set_y(new_y);
-        new_landmark->set_z(new_z);
+        float new_x =
+            std::cos(angle) * centered_x - std::sin(angle) * centered_y;
+        float new_y =
+            std::sin(angle) * centered_x + std::cos(angle) * centered_y;
+
+        x = new_x * input_rect.width() + input_rect.x_center();
+        y = new_y * input_rect.height() + input_rect.y_center();
+        z = z * input_rect.width();  // Scale Z coordinate as X.
       };
     } else if (cc->Inputs().HasTag(kProjectionMatrix)) {
       if (cc->Inputs().Tag(kProjectionMatrix).IsEmpty()) {
@@ -194,11 +206,9 @@ class LandmarkProjectionCalculator : public CalculatorBase {
       const auto& project_mat =
           cc->Inputs().Tag(kProjectionMatrix).Get<std::array<float, 16>>();
       const float z_scale = CalculateZScale(project_mat);
-      project_fn = [&project_mat, z_scale](const NormalizedLandmark& lm,
-                                           NormalizedLandmark* new_landmark) {
-        *new_landmark = lm;
-        ProjectXY(lm, project_mat, new_landmark);
-        new_landmark->set_z(z_scale * lm.z());
+      project_fn = [&project_mat, z_scale](float& x, float& y, float& z) {
+        ProjectXY(x, y, z, project_mat, &x, &y);
+        z = z_scale * z;
       };
     } else {
       return absl::InternalError("Either rect or matrix must be specified.");
@@ -209,26 +219,29 @@ class LandmarkProjectionCalculator : public CalculatorBase {
     // Number of inputs and outpus is the same according to the contract.
     for (; input_id != cc->Inputs().EndId(kLandmarksTag);
          ++input_id, ++output_id) {
-      const auto& input_packet = cc->Inputs().Get(input_id);
+      auto& input_packet = cc->Inputs().Get(input_id).Value();
       if (input_packet.IsEmpty()) {
         continue;
       }
 
-      const auto& input_landmarks = input_packet.Get<NormalizedLandmarkList>();
-      NormalizedLandmarkList output_landmarks;
-      for (int i = 0; i < input_landmarks.landmark_size(); ++i) {
-        const NormalizedLandmark& landmark = input_landmarks.landmark(i);
-        NormalizedLandmark* new_landmark = output_landmarks.add_landmark();
-        project_fn(landmark, new_landmark);
-      }
-
-      cc->Outputs().Get(output_id).AddPacket(
-          MakePacket<NormalizedLandmarkList>(std::move(output_landmarks))
-              .At(cc->InputTimestamp()));
+      // Projects the landmarks in place if this calculator holds the only
+      // reference to them, so that chained transforms don't copy them.
+      ASSIGN_OR_RETURN(auto landmarks,
+                       input_packet.template ConsumeOrCopy<LandmarkListT>());
+      ProjectLandmarks(project_fn, landmarks.get());
+      cc->Outputs().Get(output_id).Add(landmarks.release(),
+                                       cc->InputTimestamp());
     }
     return absl::OkStatus();
   }
 };
+
+typedef LandmarkProjectionCalculatorImpl<NormalizedLandmarkList>
+    LandmarkProjectionCalculator;
 REGISTER_CALCULATOR(LandmarkProjectionCalculator);
 
+typedef LandmarkProjectionCalculatorImpl<FlatLandmarks>
+    FlatLandmarkProjectionCalculator;
+REGISTER_CALCULATOR(FlatLandmarkProjectionCalculator);
+
 }  // namespace mediapipe
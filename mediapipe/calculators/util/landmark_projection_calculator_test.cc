@@ -98,6 +98,41 @@ TEST(LandmarkProjectionCalculatorTest, ProjectingWithCroppedRect) {
               EqualsProto(GetCroppedRectTestExpectedResult()));
 }
 
+TEST(LandmarkProjectionCalculatorTest, LeavesSharedInputUnchanged) {
+  mediapipe::CalculatorRunner runner(
+      ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig::Node>(R"pb(
+        calculator: "LandmarkProjectionCalculator"
+        input_stream: "NORM_LANDMARKS:landmarks"
+        input_stream: "NORM_RECT:rect"
+        output_stream: "NORM_LANDMARKS:projected_landmarks"
+      )pb"));
+  // The runner keeps a reference to the input packet, so the calculator must
+  // project a copy of the landmarks.
+  runner.MutableInputs()
+      ->Tag(kNormLandmarksTag)
+      .packets.push_back(
+          MakePacket<mediapipe::NormalizedLandmarkList>(
+              GetCroppedRectTestInput())
+              .At(Timestamp(1)));
+  runner.MutableInputs()
+      ->Tag(kNormRectTag)
+      .packets.push_back(
+          MakePacket<mediapipe::NormalizedRect>(GetCroppedRect())
+              .At(Timestamp(1)));
+
+  MP_ASSERT_OK(runner.Run());
+
+  const auto& output_packets = runner.Outputs().Tag(kNormLandmarksTag).packets;
+  ASSERT_EQ(output_packets.size(), 1);
+  EXPECT_THAT(output_packets[0].Get<mediapipe::NormalizedLandmarkList>(),
+              EqualsProto(GetCroppedRectTestExpectedResult()));
+  EXPECT_THAT(runner.MutableInputs()
+                  ->Tag(kNormLandmarksTag)
+                  .packets[0]
+                  .Get<mediapipe::NormalizedLandmarkList>(),
+              EqualsProto(GetCroppedRectTestInput()));
+}
+
 absl::StatusOr<mediapipe::NormalizedLandmarkList> RunCalculator(
     mediapipe::NormalizedLandmarkList input, std::array<float, 16> matrix) {
   mediapipe::CalculatorRunner runner(
@@ -15,12 +15,15 @@
 #include "mediapipe/calculators/util/landmarks_smoothing_calculator_utils.h"
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
+#include "absl/types/span.h"
 #include "mediapipe/calculators/util/landmarks_smoothing_calculator.pb.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/port/ret_check.h"
-#include "mediapipe/util/filtering/one_euro_filter.h"
+#include "mediapipe/util/filtering/one_euro_filter_bank.h"
 #include "mediapipe/util/filtering/relative_velocity_filter.h"
 
 namespace mediapipe {
@@ -29,7 +32,7 @@ namespace landmarks_smoothing {
 namespace {
 
 using ::mediapipe::NormalizedRect;
-using ::mediapipe::OneEuroFilter;
+using ::mediapipe::OneEuroFilterBank;
 using ::mediapipe::Rect;
 using ::mediapipe::RelativeVelocityFilter;
 
@@ -156,7 +159,8 @@ class VelocityFilter : public LandmarksFilter {
   std::vector<RelativeVelocityFilter> z_filters_;
 };
 
-// Please check OneEuroFilter documentation for details.
+// Please check OneEuroFilter documentation for details. The filters of all
+// the landmark coordinates are run by a single OneEuroFilterBank.
 class OneEuroFilterImpl : public LandmarksFilter {
  public:
   OneEuroFilterImpl(double frequency, double min_cutoff, double beta,
@@ -170,9 +174,7 @@ class OneEuroFilterImpl : public LandmarksFilter {
         disable_value_scaling_(disable_value_scaling) {}
 
   absl::Status Reset() override {
-    x_filters_.clear();
-    y_filters_.clear();
-    z_filters_.clear();
+    filters_.reset();
     return absl::OkStatus();
   }
 
@@ -197,18 +199,24 @@ class OneEuroFilterImpl : public LandmarksFilter {
       value_scale = 1.0f / object_scale;
     }
 
-    // Filter landmarks. Every axis of every landmark is filtered separately.
-    for (int i = 0; i < in_landmarks.landmark_size(); ++i) {
+    // Filter landmarks. Every axis of every landmark is filtered separately,
+    // all at once by the filter bank.
+    const int n_landmarks = in_landmarks.landmark_size();
+    for (int i = 0; i < n_landmarks; ++i) {
       const auto& in_landmark = in_landmarks.landmark(i);
+      values_[3 * i] = in_landmark.x();
+      values_[3 * i + 1] = in_landmark.y();
+      values_[3 * i + 2] = in_landmark.z();
+    }
+    filters_->Apply(timestamp, value_scale, absl::MakeSpan(values_));
 
+    out_landmarks.mutable_landmark()->Reserve(n_landmarks);
+    for (int i = 0; i < n_landmarks; ++i) {
       auto* out_landmark = out_landmarks.add_landmark();
-      *out_landmark = in_landmark;
-      out_landmark->set_x(
-          x_filters_[i].Apply(timestamp, value_scale, in_landmark.x()));
-      out_landmark->set_y(
-          y_filters_[i].Apply(timestamp, value_scale, in_landmark.y()));
-      out_landmark->set_z(
-          z_filters_[i].Apply(timestamp, value_scale, in_landmark.z()));
+      *out_landmark = in_landmarks.landmark(i);
+      out_landmark->set_x(values_[3 * i]);
+      out_landmark->set_y(values_[3 * i + 1]);
+      out_landmark->set_z(values_[3 * i + 2]);
     }
 
     return absl::OkStatus();
@@ -218,21 +226,14 @@ class OneEuroFilterImpl : public LandmarksFilter {
   // Initializes filters for the first time or after Reset. If initialized then
   // check the size.
   absl::Status InitializeFiltersIfEmpty(const int n_landmarks) {
-    if (!x_filters_.empty()) {
-      RET_CHECK_EQ(x_filters_.size(), n_landmarks);
-      RET_CHECK_EQ(y_filters_.size(), n_landmarks);
-      RET_CHECK_EQ(z_filters_.size(), n_landmarks);
+    if (filters_ != nullptr) {
+      RET_CHECK_EQ(filters_->size(), 3 * n_landmarks);
       return absl::OkStatus();
     }
 
-    for (int i = 0; i < n_landmarks; ++i) {
-      x_filters_.push_back(
-          OneEuroFilter(frequency_, min_cutoff_, beta_, derivate_cutoff_));
-      y_filters_.push_back(
-          OneEuroFilter(frequency_, min_cutoff_, beta_, derivate_cutoff_));
-      z_filters_.push_back(
-          OneEuroFilter(frequency_, min_cutoff_, beta_, derivate_cutoff_));
-    }
+    filters_ = absl::make_unique<OneEuroFilterBank>(
+        3 * n_landmarks, frequency_, min_cutoff_, beta_, derivate_cutoff_);
+    values_.resize(3 * n_landmarks);
 
     return absl::OkStatus();
   }
@@ -244,9 +245,10 @@ class OneEuroFilterImpl : public LandmarksFilter {
   double min_allowed_object_scale_;
   bool disable_value_scaling_;
 
-  std::vector<OneEuroFilter> x_filters_;
-  std::vector<OneEuroFilter> y_filters_;
-  std::vector<OneEuroFilter> z_filters_;
+  // Filters the x, y and z coordinates of each landmark, stored in this order
+  // in `values_`.
+  std::unique_ptr<OneEuroFilterBank> filters_;
+  std::vector<float> values_;
 };
 
 }  // namespace
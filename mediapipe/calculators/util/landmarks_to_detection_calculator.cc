@@ -17,6 +17,7 @@
 #include "mediapipe/calculators/util/landmarks_to_detection_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/flat_landmarks.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/formats/location_data.pb.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -28,7 +29,32 @@ namespace {
 constexpr char kDetectionTag[] = "DETECTION";
 constexpr char kNormalizedLandmarksTag[] = "NORM_LANDMARKS";
 
-Detection ConvertLandmarksToDetection(const NormalizedLandmarkList& landmarks) {
+constexpr char kFlatLandmarksTag[] = "FLAT_LANDMARKS";
+
+int NumLandmarks(const NormalizedLandmarkList& landmarks) {
+  return landmarks.landmark_size();
+}
+
+int NumLandmarks(const FlatLandmarks& landmarks) { return landmarks.size(); }
+
+void GetLandmarkXY(const NormalizedLandmarkList& landmarks, int index,
+                   float* x, float* y) {
+  *x = landmarks.landmark(index).x();
+  *y = landmarks.landmark(index).y();
+}
+
+void GetLandmarkXY(const FlatLandmarks& landmarks, int index, float* x,
+                   float* y) {
+  *x = landmarks[index].x;
+  *y = landmarks[index].y;
+}
+
+// Converts the landmarks of `landmarks` at `indices`, or all of them if
+// `indices` is empty, to a Detection.
+template <typename LandmarkListT>
+Detection ConvertLandmarksToDetection(
+    const LandmarkListT& landmarks,
+    const proto_ns::RepeatedField<int32_t>& indices) {
   Detection detection;
   LocationData* location_data = detection.mutable_location_data();
 
@@ -36,16 +62,19 @@ Detection ConvertLandmarksToDetection(const NormalizedLandmarkList& landmarks) {
   float x_max = std::numeric_limits<float>::min();
   float y_min = std::numeric_limits<float>::max();
   float y_max = std::numeric_limits<float>::min();
-  for (int i = 0; i < landmarks.landmark_size(); ++i) {
-    const NormalizedLandmark& landmark = landmarks.landmark(i);
-    x_min = std::min(x_min, landmark.x());
-    x_max = std::max(x_max, landmark.x());
-    y_min = std::min(y_min, landmark.y());
-    y_max = std::max(y_max, landmark.y());
+  const int num_selected =
+      indices.empty() ? NumLandmarks(landmarks) : indices.size();
+  for (int i = 0; i < num_selected; ++i) {
+    float x, y;
+    GetLandmarkXY(landmarks, indices.empty() ? i : indices.Get(i), &x, &y);
+    x_min = std::min(x_min, x);
+    x_max = std::max(x_max, x);
+    y_min = std::min(y_min, y);
+    y_max = std::max(y_max, y);
 
     auto keypoint = location_data->add_relative_keypoints();
-    keypoint->set_x(landmark.x());
-    keypoint->set_y(landmark.y());
+    keypoint->set_x(x);
+    keypoint->set_y(y);
   }
 
   location_data->set_format(LocationData::LOCATION_FORMAT_RELATIVE_BOUNDING_BOX);
@@ -68,6 +97,7 @@ Detection ConvertLandmarksToDetection(const NormalizedLandmarkList& landmarks) {
 //
 // Input:
 //  NOMR_LANDMARKS: A NormalizedLandmarkList proto.
+//  FLAT_LANDMARKS: FlatLandmarks, instead of NORM_LANDMARKS.
 //
 // Output:
 //   DETECTION: A Detection proto.
@@ -86,16 +116,25 @@ class LandmarksToDetectionCalculator : public CalculatorBase {
   absl::Status Process(CalculatorContext* cc) override;
 
  private:
+  template <typename LandmarkListT>
+  absl::Status ProcessLandmarks(const LandmarkListT& landmarks,
+                                CalculatorContext* cc);
+
   ::mediapipe::LandmarksToDetectionCalculatorOptions options_;
 };
 REGISTER_CALCULATOR(LandmarksToDetectionCalculator);
 
 absl::Status LandmarksToDetectionCalculator::GetContract(
     CalculatorContract* cc) {
-  RET_CHECK(cc->Inputs().HasTag(kNormalizedLandmarksTag));
+  RET_CHECK(cc->Inputs().HasTag(kNormalizedLandmarksTag) ^
+            cc->Inputs().HasTag(kFlatLandmarksTag));
   RET_CHECK(cc->Outputs().HasTag(kDetectionTag));
   // TODO: Also support converting Landmark to Detection.
-  cc->Inputs().Tag(kNormalizedLandmarksTag).Set<NormalizedLandmarkList>();
+  if (cc->Inputs().HasTag(kNormalizedLandmarksTag)) {
+    cc->Inputs().Tag(kNormalizedLandmarksTag).Set<NormalizedLandmarkList>();
+  } else {
+    cc->Inputs().Tag(kFlatLandmarksTag).Set<FlatLandmarks>();
+  }
   cc->Outputs().Tag(kDetectionTag).Set<Detection>();
 
   return absl::OkStatus();
@@ -109,25 +148,27 @@ absl::Status LandmarksToDetectionCalculator::Open(CalculatorContext* cc) {
 }
 
 absl::Status LandmarksToDetectionCalculator::Process(CalculatorContext* cc) {
-  const auto& landmarks =
-      cc->Inputs().Tag(kNormalizedLandmarksTag).Get<NormalizedLandmarkList>();
-  RET_CHECK_GT(landmarks.landmark_size(), 0)
-      << "Input landmark vector is empty.";
-
-  auto detection = absl::make_unique<Detection>();
-  if (options_.selected_landmark_indices_size()) {
-    NormalizedLandmarkList subset_landmarks;
-    for (int i = 0; i < options_.selected_landmark_indices_size(); ++i) {
-      RET_CHECK_LT(options_.selected_landmark_indices(i),
-                   landmarks.landmark_size())
-          << "Index of landmark subset is out of range.";
-      *subset_landmarks.add_landmark() =
-          landmarks.landmark(options_.selected_landmark_indices(i));
-    }
-    *detection = ConvertLandmarksToDetection(subset_landmarks);
-  } else {
-    *detection = ConvertLandmarksToDetection(landmarks);
+  if (cc->Inputs().HasTag(kFlatLandmarksTag)) {
+    return ProcessLandmarks(
+        cc->Inputs().Tag(kFlatLandmarksTag).Get<FlatLandmarks>(), cc);
+  }
+  return ProcessLandmarks(
+      cc->Inputs().Tag(kNormalizedLandmarksTag).Get<NormalizedLandmarkList>(),
+      cc);
+}
+
+template <typename LandmarkListT>
+absl::Status LandmarksToDetectionCalculator::ProcessLandmarks(
+    const LandmarkListT& landmarks, CalculatorContext* cc) {
+  const int num_landmarks = NumLandmarks(landmarks);
+  RET_CHECK_GT(num_landmarks, 0) << "Input landmark vector is empty.";
+
+  for (int i = 0; i < options_.selected_landmark_indices_size(); ++i) {
+    RET_CHECK_LT(options_.selected_landmark_indices(i), num_landmarks)
+        << "Index of landmark subset is out of range.";
   }
+  auto detection = absl::make_unique<Detection>(ConvertLandmarksToDetection(
+      landmarks, options_.selected_landmark_indices()));
   cc->Outputs()
       .Tag(kDetectionTag)
       .Add(detection.release(), cc->InputTimestamp());
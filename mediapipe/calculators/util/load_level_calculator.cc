@@ -0,0 +1,99 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "absl/status/status.h"
+#include "mediapipe/calculators/util/load_level_calculator.pb.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Chooses a processing level from the load of a graph, such as the "LOAD"
+// output of FlowLimiterCalculator, so that expensive processing steps can be
+// replaced by cheaper ones while the graph misses its latency target. The
+// level can drive the "SELECT" input stream of a SwitchContainer.
+//
+// The level starts at 0. It is raised by one when the load exceeds
+// `raise_load`, and lowered by one when the load falls under `lower_load`,
+// but only after `min_frames_per_level` frames at the current level.
+//
+// Inputs:
+//   LOAD - double
+//     The load for each frame, where 1 is the load at the latency target.
+//
+// Outputs:
+//   LEVEL - int
+//     The processing level for each frame.
+//
+// Example config:
+// node {
+//   calculator: "LoadLevelCalculator"
+//   input_stream: "LOAD:load"
+//   output_stream: "LEVEL:level"
+//   options {
+//     [mediapipe.LoadLevelCalculatorOptions.ext] {
+//       raise_load: 1.0
+//       lower_load: 0.5
+//     }
+//   }
+// }
+class LoadLevelCalculator : public Node {
+ public:
+  static constexpr Input<double> kInLoad{"LOAD"};
+  static constexpr Output<int> kOutLevel{"LEVEL"};
+
+  MEDIAPIPE_NODE_CONTRACT(kInLoad, kOutLevel);
+
+  absl::Status Open(CalculatorContext* cc) final {
+    options_ = cc->Options<LoadLevelCalculatorOptions>();
+    RET_CHECK_GE(options_.num_levels(), 1);
+    RET_CHECK_LT(options_.lower_load(), options_.raise_load())
+        << "lower_load must be less than raise_load.";
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) final {
+    if (kInLoad(cc).IsEmpty()) {
+      return absl::OkStatus();
+    }
+    const double load = *kInLoad(cc);
+    frames_at_level_ = std::min(frames_at_level_ + 1,
+                                options_.min_frames_per_level());
+    if (frames_at_level_ >= options_.min_frames_per_level()) {
+      if (load > options_.raise_load() &&
+          level_ < options_.num_levels() - 1) {
+        ++level_;
+        frames_at_level_ = 0;
+      } else if (load < options_.lower_load() && level_ > 0) {
+        --level_;
+        frames_at_level_ = 0;
+      }
+    }
+    kOutLevel(cc).Send(level_);
+    return absl::OkStatus();
+  }
+
+ private:
+  LoadLevelCalculatorOptions options_;
+  int level_ = 0;
+  int frames_at_level_ = 0;
+};
+MEDIAPIPE_REGISTER_NODE(LoadLevelCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
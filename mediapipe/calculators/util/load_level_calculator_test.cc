@@ -0,0 +1,99 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+std::vector<int> RunLevels(CalculatorRunner& runner,
+                           const std::vector<double>& loads) {
+  for (int i = 0; i < loads.size(); ++i) {
+    runner.MutableInputs()->Tag("LOAD").packets.push_back(
+        MakePacket<double>(loads[i]).At(Timestamp(i)));
+  }
+  MP_EXPECT_OK(runner.Run());
+  std::vector<int> levels;
+  for (const Packet& packet : runner.Outputs().Tag("LEVEL").packets) {
+    levels.push_back(packet.Get<int>());
+  }
+  return levels;
+}
+
+TEST(LoadLevelCalculatorTest, RaisesAndLowersLevelWithHysteresis) {
+  CalculatorRunner runner(R"pb(
+    calculator: "LoadLevelCalculator"
+    input_stream: "LOAD:load"
+    output_stream: "LEVEL:level"
+    options {
+      [mediapipe.LoadLevelCalculatorOptions.ext] {
+        num_levels: 2
+        raise_load: 1.0
+        lower_load: 0.5
+        min_frames_per_level: 1
+      }
+    }
+  )pb");
+  EXPECT_THAT(RunLevels(runner, {0.0, 1.2, 0.8, 1.5, 0.6, 0.4, 0.9}),
+              ElementsAre(0, 1, 1, 1, 1, 0, 0));
+}
+
+TEST(LoadLevelCalculatorTest, WaitsForMinFramesPerLevel) {
+  CalculatorRunner runner(R"pb(
+    calculator: "LoadLevelCalculator"
+    input_stream: "LOAD:load"
+    output_stream: "LEVEL:level"
+    options {
+      [mediapipe.LoadLevelCalculatorOptions.ext] {
+        num_levels: 3
+        min_frames_per_level: 2
+      }
+    }
+  )pb");
+  EXPECT_THAT(RunLevels(runner, {2.0, 2.0, 2.0, 2.0, 2.0, 0.1, 0.1}),
+              ElementsAre(0, 1, 1, 2, 2, 1, 1));
+}
+
+TEST(LoadLevelCalculatorTest, RejectsInvalidThresholds) {
+  CalculatorRunner runner(R"pb(
+    calculator: "LoadLevelCalculator"
+    input_stream: "LOAD:load"
+    output_stream: "LEVEL:level"
+    options {
+      [mediapipe.LoadLevelCalculatorOptions.ext] {
+        raise_load: 0.5
+        lower_load: 0.5
+      }
+    }
+  )pb");
+  runner.MutableInputs()->Tag("LOAD").packets.push_back(
+      MakePacket<double>(1.0).At(Timestamp(0)));
+  absl::Status status = runner.Run();
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(),
+              HasSubstr("lower_load must be less than raise_load"));
+}
+
+}  // namespace
+}  // namespace mediapipe
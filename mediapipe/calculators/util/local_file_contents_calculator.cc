@@ -18,6 +18,7 @@
 #include "mediapipe/calculators/util/local_file_contents_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/mapped_file_contents.h"
 #include "mediapipe/util/resource_util.h"
 
 namespace mediapipe {
@@ -35,6 +36,10 @@ constexpr char kContentsTag[] = "CONTENTS";
 // NOTE: file loading can be batched by providing multiple input/output side
 // packets.
 //
+// With the memory_map option, the contents are a read-only MappedFileContents
+// instead of a std::string. The file is mapped rather than read, so its pages
+// are shared with other mappings of the file and only loaded when accessed.
+//
 // Example config:
 // node {
 //   calculator: "LocalFileContentsCalculator"
@@ -68,9 +73,17 @@ class LocalFileContentsCalculator : public CalculatorBase {
       cc->InputSidePackets().Get(id).Set<std::string>();
     }
 
+    const auto& options =
+        cc->Options<mediapipe::LocalFileContentsCalculatorOptions>();
+    RET_CHECK(!(options.memory_map() && options.text_mode()))
+        << "memory_map can't be combined with text_mode.";
     for (CollectionItemId id = cc->OutputSidePackets().BeginId(kContentsTag);
          id != cc->OutputSidePackets().EndId(kContentsTag); ++id) {
-      cc->OutputSidePackets().Get(id).Set<std::string>();
+      if (options.memory_map()) {
+        cc->OutputSidePackets().Get(id).Set<MappedFileContents>();
+      } else {
+        cc->OutputSidePackets().Get(id).Set<std::string>();
+      }
     }
 
     return absl::OkStatus();
@@ -88,6 +101,12 @@ class LocalFileContentsCalculator : public CalculatorBase {
           cc->InputSidePackets().Get(input_id).Get<std::string>();
       ASSIGN_OR_RETURN(file_path, PathToResourceAsFile(file_path));
 
+      if (options.memory_map()) {
+        ASSIGN_OR_RETURN(std::unique_ptr<MappedFileContents> contents,
+                         MappedFileContents::Open(file_path));
+        cc->OutputSidePackets().Get(output_id).Set(Adopt(contents.release()));
+        continue;
+      }
       std::string contents;
       MP_RETURN_IF_ERROR(GetResourceContents(
           file_path, &contents, /*read_as_binary=*/!options.text_mode()));
@@ -16,9 +16,11 @@
 #include <string>
 
 #include "absl/log/absl_log.h"
+#include "mediapipe/calculators/util/local_file_pattern_contents_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/port/file_helpers.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/mapped_file_contents.h"
 
 namespace mediapipe {
 
@@ -31,6 +33,9 @@ constexpr char kFileDirectoryTag[] = "FILE_DIRECTORY";
 // match the pattern. Those matched files will be sent sequentially through the
 // output stream with incremental timestamp difference by 1.
 //
+// With the memory_map option, the contents are read-only MappedFileContents
+// instead of std::string, which map the files rather than reading them.
+//
 // Example config:
 // node {
 //   calculator: "LocalFilePatternContentsCalculator"
@@ -43,7 +48,11 @@ class LocalFilePatternContentsCalculator : public CalculatorBase {
   static absl::Status GetContract(CalculatorContract* cc) {
     cc->InputSidePackets().Tag(kFileDirectoryTag).Set<std::string>();
     cc->InputSidePackets().Tag(kFileSuffixTag).Set<std::string>();
-    cc->Outputs().Tag(kContentsTag).Set<std::string>();
+    if (cc->Options<LocalFilePatternContentsCalculatorOptions>().memory_map()) {
+      cc->Outputs().Tag(kContentsTag).Set<MappedFileContents>();
+    } else {
+      cc->Outputs().Tag(kContentsTag).Set<std::string>();
+    }
     return absl::OkStatus();
   }
 
@@ -53,13 +62,24 @@ class LocalFilePatternContentsCalculator : public CalculatorBase {
         cc->InputSidePackets().Tag(kFileSuffixTag).Get<std::string>(),
         &filenames_));
     std::sort(filenames_.begin(), filenames_.end());
+    memory_map_ =
+        cc->Options<LocalFilePatternContentsCalculatorOptions>().memory_map();
     return absl::OkStatus();
   }
 
   absl::Status Process(CalculatorContext* cc) override {
     if (current_output_ < filenames_.size()) {
-      auto contents = absl::make_unique<std::string>();
       ABSL_LOG(INFO) << filenames_[current_output_];
+      if (memory_map_) {
+        ASSIGN_OR_RETURN(std::unique_ptr<MappedFileContents> contents,
+                         MappedFileContents::Open(filenames_[current_output_]));
+        ++current_output_;
+        cc->Outputs()
+            .Tag(kContentsTag)
+            .Add(contents.release(), Timestamp(current_output_));
+        return absl::OkStatus();
+      }
+      auto contents = absl::make_unique<std::string>();
       MP_RETURN_IF_ERROR(mediapipe::file::GetContents(
           filenames_[current_output_], contents.get()));
       ++current_output_;
@@ -75,6 +95,7 @@ class LocalFilePatternContentsCalculator : public CalculatorBase {
  private:
   std::vector<std::string> filenames_;
   int current_output_ = 0;
+  bool memory_map_ = false;
 };
 
 REGISTER_CALCULATOR(LocalFilePatternContentsCalculator);
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -98,28 +101,126 @@ float OverlapSimilarity(
   return normalization > 0.0f ? intersection_area / normalization : 0.0f;
 }
 
-// Computes an overlap similarity between two locations by first extracting the
-// relative box (dimension normalized by frame width/height) from the location.
-float OverlapSimilarity(
-    const int frame_width, const int frame_height,
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Location& location1, const Location& location2) {
-  const auto rect1 = location1.ConvertToRelativeBBox(frame_width, frame_height);
-  const auto rect2 = location2.ConvertToRelativeBBox(frame_width, frame_height);
-  return OverlapSimilarity(overlap_type, rect1, rect2);
-}
+// Indexes rectangles by the cells of a uniform grid over their bounds, so that
+// the rectangles that may intersect a query rectangle are found without
+// visiting all of them. Since non-intersecting rectangles have zero overlap
+// similarity, this finds all rectangles whose similarity to the query can
+// exceed a non-negative threshold.
+//
+// When `use_grid` is false, or when some rectangle has non-finite bounds, all
+// rectangles are placed in a single cell and every query visits all of them.
+class RectangleGrid {
+ public:
+  // `rects` must outlive the grid.
+  RectangleGrid(const std::vector<Rectangle_f>& rects, bool use_grid)
+      : rects_(rects), visit_stamps_(rects.size(), 0) {
+    float xmin = std::numeric_limits<float>::max();
+    float ymin = std::numeric_limits<float>::max();
+    float xmax = std::numeric_limits<float>::lowest();
+    float ymax = std::numeric_limits<float>::lowest();
+    for (const auto& rect : rects) {
+      if (!std::isfinite(rect.xmin()) || !std::isfinite(rect.ymin()) ||
+          !std::isfinite(rect.xmax()) || !std::isfinite(rect.ymax())) {
+        use_grid = false;
+        break;
+      }
+      if (rect.IsEmpty()) continue;
+      xmin = std::min(xmin, rect.xmin());
+      ymin = std::min(ymin, rect.ymin());
+      xmax = std::max(xmax, rect.xmax());
+      ymax = std::max(ymax, rect.ymax());
+    }
+    if (use_grid && xmin < xmax && ymin < ymax) {
+      // About one rectangle per cell for rectangles spread evenly.
+      const int cells_per_side =
+          std::clamp(static_cast<int>(std::sqrt(rects.size())), 1,
+                     kMaxCellsPerSide);
+      use_grid_ = true;
+      origin_x_ = xmin;
+      origin_y_ = ymin;
+      num_columns_ = cells_per_side;
+      num_rows_ = cells_per_side;
+      inverse_cell_width_ = cells_per_side / (xmax - xmin);
+      inverse_cell_height_ = cells_per_side / (ymax - ymin);
+    }
+    cells_.resize(num_columns_ * num_rows_);
+  }
 
-// Computes an overlap similarity between two locations by first extracting the
-// relative box from the location. It assumes that a relative-box representation
-// is already available in the location, and therefore frame width and height
-// are not needed for further normalization.
-float OverlapSimilarity(
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Location& location1, const Location& location2) {
-  const auto rect1 = location1.GetRelativeBBox();
-  const auto rect2 = location2.GetRelativeBBox();
-  return OverlapSimilarity(overlap_type, rect1, rect2);
-}
+  // Adds the rectangle at `index` to the grid.
+  void Insert(int index) {
+    const Rectangle_f& rect = rects_[index];
+    if (use_grid_ && rect.IsEmpty()) return;
+    ForEachCell(rect, [&](std::vector<int>& cell) { cell.push_back(index); });
+  }
+
+  // Calls `visit(index)` once for each inserted rectangle that may intersect
+  // `rect`, until `visit` returns false.
+  template <typename Visit>
+  void ForEachNear(const Rectangle_f& rect, Visit visit) {
+    if (use_grid_ && rect.IsEmpty()) return;
+    ++visit_stamp_;
+    bool done = false;
+    ForEachCell(rect, [&](std::vector<int>& cell) {
+      for (int i = 0; i < static_cast<int>(cell.size()) && !done; ++i) {
+        const int index = cell[i];
+        if (visit_stamps_[index] == visit_stamp_) continue;
+        visit_stamps_[index] = visit_stamp_;
+        done = !visit(index);
+      }
+    });
+  }
+
+  // Removes the rectangle at `index` from the cells that contain it.
+  void Remove(int index) {
+    const Rectangle_f& rect = rects_[index];
+    if (use_grid_ && rect.IsEmpty()) return;
+    ForEachCell(rect, [&](std::vector<int>& cell) {
+      cell.erase(std::find(cell.begin(), cell.end(), index));
+    });
+  }
+
+ private:
+  static constexpr int kMaxCellsPerSide = 32;
+
+  int Column(float x) const {
+    return std::clamp(static_cast<int>((x - origin_x_) * inverse_cell_width_),
+                      0, num_columns_ - 1);
+  }
+
+  int Row(float y) const {
+    return std::clamp(static_cast<int>((y - origin_y_) * inverse_cell_height_),
+                      0, num_rows_ - 1);
+  }
+
+  template <typename Fn>
+  void ForEachCell(const Rectangle_f& rect, Fn fn) {
+    if (!use_grid_) {
+      fn(cells_[0]);
+      return;
+    }
+    const int column_end = Column(rect.xmax());
+    const int row_end = Row(rect.ymax());
+    for (int row = Row(rect.ymin()); row <= row_end; ++row) {
+      for (int column = Column(rect.xmin()); column <= column_end; ++column) {
+        fn(cells_[row * num_columns_ + column]);
+      }
+    }
+  }
+
+  const std::vector<Rectangle_f>& rects_;
+  bool use_grid_ = false;
+  float origin_x_ = 0.0f;
+  float origin_y_ = 0.0f;
+  float inverse_cell_width_ = 0.0f;
+  float inverse_cell_height_ = 0.0f;
+  int num_columns_ = 1;
+  int num_rows_ = 1;
+  std::vector<std::vector<int>> cells_;
+  // The last query that visited each rectangle, to visit each rectangle once
+  // per query when it spans several cells.
+  std::vector<uint32_t> visit_stamps_;
+  uint32_t visit_stamp_ = 0;
+};
 
 }  // namespace
 
@@ -253,8 +354,22 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
   void NonMaxSuppression(const IndexedScores& indexed_scores,
                          const Detections& detections, int max_num_detections,
                          CalculatorContext* cc, Detections* output_detections) {
-    std::vector<Location> retained_locations;
-    retained_locations.reserve(max_num_detections);
+    std::vector<Rectangle_f> rects;
+    rects.reserve(detections.size());
+    for (const auto& detection : detections) {
+      const Location location(detection.location_data());
+      if (cc->Inputs().HasTag(kImageTag)) {
+        const auto& frame = cc->Inputs().Tag(kImageTag).Get<ImageFrame>();
+        rects.push_back(
+            location.ConvertToRelativeBBox(frame.Width(), frame.Height()));
+      } else {
+        rects.push_back(location.GetRelativeBBox());
+      }
+    }
+    // Only retained detections that overlap the current detection can
+    // suppress it, so retained detections are looked up in a grid.
+    RectangleGrid retained_grid(rects,
+                                options_.min_suppression_threshold() >= 0);
     // We traverse the detections by decreasing score.
     for (const auto& indexed_score : indexed_scores) {
       const auto& detection = detections[indexed_score.first];
@@ -262,30 +377,20 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
           detection.score(0) < options_.min_score_threshold()) {
         break;
       }
-      const Location location(detection.location_data());
+      const Rectangle_f& rect = rects[indexed_score.first];
       bool suppressed = false;
       // The current detection is suppressed iff there exists a retained
       // detection, whose location overlaps more than the specified
       // threshold with the location of the current detection.
-      for (const auto& retained_location : retained_locations) {
-        float similarity;
-        if (cc->Inputs().HasTag(kImageTag)) {
-          const auto& frame = cc->Inputs().Tag(kImageTag).Get<ImageFrame>();
-          similarity = OverlapSimilarity(frame.Width(), frame.Height(),
-                                         options_.overlap_type(),
-                                         retained_location, location);
-        } else {
-          similarity = OverlapSimilarity(options_.overlap_type(),
-                                         retained_location, location);
-        }
-        if (similarity > options_.min_suppression_threshold()) {
-          suppressed = true;
-          break;
-        }
-      }
+      retained_grid.ForEachNear(rect, [&](int retained_index) {
+        const float similarity = OverlapSimilarity(
+            options_.overlap_type(), rects[retained_index], rect);
+        suppressed = similarity > options_.min_suppression_threshold();
+        return !suppressed;
+      });
       if (!suppressed) {
         output_detections->push_back(detection);
-        retained_locations.push_back(location);
+        retained_grid.Insert(indexed_score.first);
       }
       if (output_detections->size() >= max_num_detections) {
         break;
@@ -301,6 +406,20 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
     remained_indexed_scores.assign(indexed_scores.begin(),
                                    indexed_scores.end());
 
+    std::vector<Rectangle_f> rects;
+    rects.reserve(detections.size());
+    for (const auto& detection : detections) {
+      rects.push_back(Location(detection.location_data()).GetRelativeBBox());
+    }
+    // Only remaining detections that overlap the current detection can be
+    // merged into it, so remaining detections are looked up in a grid.
+    RectangleGrid remained_grid(rects,
+                                options_.min_suppression_threshold() >= 0);
+    for (const auto& indexed_score : remained_indexed_scores) {
+      remained_grid.Insert(indexed_score.first);
+    }
+    std::vector<bool> is_candidate(detections.size(), false);
+
     IndexedScores remained;
     IndexedScores candidates;
     output_detections->clear();
@@ -313,14 +432,20 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
       }
       remained.clear();
       candidates.clear();
-      const Location location(detection.location_data());
+      const Rectangle_f& rect = rects[remained_indexed_scores[0].first];
       // This includes the first box.
+      remained_grid.ForEachNear(rect, [&](int rest_index) {
+        const float similarity =
+            OverlapSimilarity(options_.overlap_type(), rects[rest_index], rect);
+        is_candidate[rest_index] =
+            similarity > options_.min_suppression_threshold();
+        return true;
+      });
       for (const auto& indexed_score : remained_indexed_scores) {
-        Location rest_location(detections[indexed_score.first].location_data());
-        float similarity =
-            OverlapSimilarity(options_.overlap_type(), rest_location, location);
-        if (similarity > options_.min_suppression_threshold()) {
+        if (is_candidate[indexed_score.first]) {
           candidates.push_back(indexed_score);
+          remained_grid.Remove(indexed_score.first);
+          is_candidate[indexed_score.first] = false;
         } else {
           remained.push_back(indexed_score);
         }
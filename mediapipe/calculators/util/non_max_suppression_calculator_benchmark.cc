@@ -0,0 +1,118 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//
+// Benchmarks NonMaxSuppressionCalculator on crowded scenes, where detections
+// are clustered around many objects, for both NMS algorithms.
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/substitute.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/location_data.pb.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+
+namespace mediapipe {
+namespace {
+
+// The number of detections around each object.
+constexpr int kDetectionsPerObject = 10;
+
+// Returns detections with jittered relative bounding boxes around objects
+// spread over the frame.
+std::vector<Detection> MakeCrowdedDetections(int num_detections) {
+  std::mt19937 rng(/*seed=*/0);
+  std::uniform_real_distribution<float> position(0.0f, 0.9f);
+  std::uniform_real_distribution<float> size(0.02f, 0.1f);
+  std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+  std::uniform_real_distribution<float> score(0.0f, 1.0f);
+  std::vector<Detection> detections;
+  float xmin = 0, ymin = 0, width = 0, height = 0;
+  for (int i = 0; i < num_detections; ++i) {
+    if (i % kDetectionsPerObject == 0) {
+      xmin = position(rng);
+      ymin = position(rng);
+      width = size(rng);
+      height = size(rng);
+    }
+    Detection& detection = detections.emplace_back();
+    detection.add_label_id(0);
+    detection.add_score(score(rng));
+    LocationData* location_data = detection.mutable_location_data();
+    location_data->set_format(LocationData::LOCATION_FORMAT_RELATIVE_BOUNDING_BOX);
+    LocationData::RelativeBoundingBox* box =
+        location_data->mutable_relative_bounding_box();
+    box->set_xmin(xmin + jitter(rng));
+    box->set_ymin(ymin + jitter(rng));
+    box->set_width(width + jitter(rng));
+    box->set_height(height + jitter(rng));
+  }
+  return detections;
+}
+
+// Runs one frame of detections through the calculator in each iteration.
+// The argument is the number of detections per frame.
+void BM_NonMaxSuppression(benchmark::State& state, const char* algorithm) {
+  CalculatorGraph graph;
+  ABSL_CHECK_OK(graph.Initialize(ParseTextProtoOrDie<CalculatorGraphConfig>(
+      absl::Substitute(R"pb(
+                         input_stream: "detections"
+                         num_threads: 1
+                         node {
+                           calculator: "NonMaxSuppressionCalculator"
+                           input_stream: "detections"
+                           output_stream: "retained_detections"
+                           options {
+                             [mediapipe.NonMaxSuppressionCalculatorOptions
+                                  .ext] {
+                               min_suppression_threshold: 0.3
+                               overlap_type: INTERSECTION_OVER_UNION
+                               algorithm: $0
+                             }
+                           }
+                         }
+                       )pb",
+                       algorithm))));
+  ABSL_CHECK_OK(graph.StartRun({}));
+  const Packet detections =
+      MakePacket<std::vector<Detection>>(MakeCrowdedDetections(state.range(0)));
+  int64_t timestamp = 0;
+  for (auto _ : state) {
+    ABSL_CHECK_OK(graph.AddPacketToInputStream(
+        "detections", detections.At(Timestamp(timestamp++))));
+    ABSL_CHECK_OK(graph.WaitUntilIdle());
+  }
+  ABSL_CHECK_OK(graph.CloseAllInputStreams());
+  ABSL_CHECK_OK(graph.WaitUntilDone());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_CAPTURE(BM_NonMaxSuppression, Default, "NMS_ALGO_DEFAULT")
+    ->Arg(100)
+    ->Arg(500)
+    ->Arg(2000)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_NonMaxSuppression, Weighted, "NMS_ALGO_WEIGHTED")
+    ->Arg(100)
+    ->Arg(500)
+    ->Arg(2000)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
@@ -0,0 +1,95 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/util/packet_dump_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/packet_dump_file.h"
+
+namespace mediapipe {
+
+constexpr char kFilePathTag[] = "FILE_PATH";
+
+// Writes the packets of all input streams to a packet dump file, which
+// PacketReplayCalculator can send into a graph again. Each packet is recorded
+// with its stream name, its timestamp and the time it arrived. Supports
+// ImageFrame, Tensor, std::string, std::vector<float>, std::vector<int> and
+// protobuf message packets.
+//
+// Example config:
+// node {
+//   calculator: "PacketDumpCalculator"
+//   input_stream: "input_video"
+//   input_stream: "detections"
+//   input_side_packet: "FILE_PATH:dump_path"
+// }
+class PacketDumpCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    for (CollectionItemId id = cc->Inputs().BeginId();
+         id < cc->Inputs().EndId(); ++id) {
+      cc->Inputs().Get(id).SetAny();
+    }
+    cc->InputSidePackets().Tag(kFilePathTag).Set<std::string>().Optional();
+    // Packets are recorded as they arrive rather than once per timestamp.
+    cc->SetInputStreamHandler("ImmediateInputStreamHandler");
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    std::string file_path =
+        cc->Options<PacketDumpCalculatorOptions>().file_path();
+    if (cc->InputSidePackets().HasTag(kFilePathTag)) {
+      file_path = cc->InputSidePackets().Tag(kFilePathTag).Get<std::string>();
+    }
+    RET_CHECK(!file_path.empty()) << "A packet dump file path is required.";
+    ASSIGN_OR_RETURN(writer_, PacketDumpWriter::Create(file_path));
+    start_time_ = absl::Now();
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    int64_t send_time_usec =
+        absl::ToInt64Microseconds(absl::Now() - start_time_);
+    for (CollectionItemId id = cc->Inputs().BeginId();
+         id < cc->Inputs().EndId(); ++id) {
+      const Packet& packet = cc->Inputs().Get(id).Value();
+      if (packet.IsEmpty()) continue;
+      MP_RETURN_IF_ERROR(
+          writer_->Write(cc->Inputs().TagMap()->Names()[id.value()], packet,
+                         send_time_usec));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Close(CalculatorContext* cc) override {
+    if (writer_ == nullptr) return absl::OkStatus();
+    absl::Status status = writer_->Close();
+    writer_ = nullptr;
+    return status;
+  }
+
+ private:
+  std::unique_ptr<PacketDumpWriter> writer_;
+  absl::Time start_time_;
+};
+REGISTER_CALCULATOR(PacketDumpCalculator);
+
+}  // namespace mediapipe
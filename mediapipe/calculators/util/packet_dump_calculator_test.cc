@@ -0,0 +1,144 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/sink.h"
+
+namespace mediapipe {
+namespace {
+
+// Runs a graph that records the packets of its input streams to a file.
+void WriteDump(const std::string& path) {
+  auto config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "frames"
+    input_stream: "tensors"
+    input_stream: "scores"
+    input_stream: "labels"
+    input_side_packet: "dump_path"
+    node {
+      calculator: "PacketDumpCalculator"
+      input_stream: "frames"
+      input_stream: "tensors"
+      input_stream: "scores"
+      input_stream: "labels"
+      input_side_packet: "FILE_PATH:dump_path"
+    }
+  )pb");
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({{"dump_path", MakePacket<std::string>(path)}}));
+  for (int i = 0; i < 3; ++i) {
+    Timestamp timestamp(i * 10);
+    auto frame = std::make_unique<ImageFrame>(ImageFormat::FORMAT_GRAY8, 5, 3);
+    frame->SetToZero();
+    frame->MutablePixelData()[0] = i;
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "frames", Adopt(frame.release()).At(timestamp)));
+    Tensor tensor(Tensor::ElementType::kFloat32, Tensor::Shape{2, 2});
+    std::vector<float> values = {1.0f * i, 2, 3, 4};
+    std::copy(values.begin(), values.end(),
+              tensor.GetCpuWriteView().buffer<float>());
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "tensors", MakePacket<Tensor>(std::move(tensor)).At(timestamp)));
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "scores", MakePacket<std::vector<float>>(values).At(timestamp)));
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "labels",
+        MakePacket<std::string>(absl::StrCat("label", i)).At(timestamp)));
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
+TEST(PacketDumpCalculatorTest, ReplaysRecordedPackets) {
+  std::string path = absl::StrCat(getenv("TEST_TMPDIR"), "/packet_dump");
+  WriteDump(path);
+
+  auto config = ParseTextProtoOrDie<CalculatorGraphConfig>(absl::StrCat(R"pb(
+    node {
+      calculator: "PacketReplayCalculator"
+      output_stream: "frames"
+      output_stream: "tensors"
+      output_stream: "labels"
+      options {
+        [mediapipe.PacketReplayCalculatorOptions.ext] {
+          replay_speed: 0
+          file_path: ")pb", path, R"pb("
+        }
+      }
+    }
+  )pb"));
+  std::vector<Packet> frames, tensors, labels;
+  tool::AddVectorSink("frames", &config, &frames);
+  tool::AddVectorSink("tensors", &config, &tensors);
+  tool::AddVectorSink("labels", &config, &labels);
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.Run());
+
+  ASSERT_EQ(frames.size(), 3);
+  ASSERT_EQ(tensors.size(), 3);
+  ASSERT_EQ(labels.size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    const auto& frame = frames[i].Get<ImageFrame>();
+    EXPECT_EQ(frames[i].Timestamp(), Timestamp(i * 10));
+    EXPECT_EQ(frame.Format(), ImageFormat::FORMAT_GRAY8);
+    EXPECT_EQ(frame.Width(), 5);
+    EXPECT_EQ(frame.Height(), 3);
+    EXPECT_EQ(frame.PixelData()[0], i);
+
+    const auto& tensor = tensors[i].Get<Tensor>();
+    EXPECT_EQ(tensors[i].Timestamp(), Timestamp(i * 10));
+    EXPECT_EQ(tensor.shape().dims, std::vector<int>({2, 2}));
+    auto view = tensor.GetCpuReadView();
+    EXPECT_EQ(view.buffer<float>()[0], i);
+    EXPECT_EQ(view.buffer<float>()[3], 4);
+
+    EXPECT_EQ(labels[i].Timestamp(), Timestamp(i * 10));
+    EXPECT_EQ(labels[i].Get<std::string>(), absl::StrCat("label", i));
+  }
+}
+
+TEST(PacketDumpCalculatorTest, FailsOnUnsupportedType) {
+  std::string path = absl::StrCat(getenv("TEST_TMPDIR"), "/unsupported_dump");
+  auto config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "in"
+    input_side_packet: "dump_path"
+    node {
+      calculator: "PacketDumpCalculator"
+      input_stream: "in"
+      input_side_packet: "FILE_PATH:dump_path"
+    }
+  )pb");
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({{"dump_path", MakePacket<std::string>(path)}}));
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "in", MakePacket<double>(1.0).At(Timestamp(0))));
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  EXPECT_FALSE(graph.WaitUntilDone().ok());
+}
+
+}  // namespace
+}  // namespace mediapipe
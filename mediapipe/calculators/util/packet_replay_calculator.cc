@@ -0,0 +1,109 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/util/packet_replay_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/packet_dump_file.h"
+
+namespace mediapipe {
+
+constexpr char kFilePathTag[] = "FILE_PATH";
+
+// Sends the packets of a packet dump file written by PacketDumpCalculator.
+// Each output stream receives the recorded packets of the stream with the same
+// name, at their recorded timestamps. Recorded streams without an output
+// stream are skipped. By default the packets are sent at the pace at which
+// they were recorded; replay_speed scales that pace, and 0 sends the packets
+// as fast as possible.
+//
+// The file is memory-mapped and ImageFrame packets view its pixels without a
+// copy, so replay measures the graph rather than file I/O.
+//
+// Example config:
+// node {
+//   calculator: "PacketReplayCalculator"
+//   output_stream: "input_video"
+//   output_stream: "detections"
+//   input_side_packet: "FILE_PATH:dump_path"
+//   options {
+//     [mediapipe.PacketReplayCalculatorOptions.ext] { replay_speed: 2 }
+//   }
+// }
+class PacketReplayCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    for (CollectionItemId id = cc->Outputs().BeginId();
+         id < cc->Outputs().EndId(); ++id) {
+      cc->Outputs().Get(id).SetAny();
+    }
+    cc->InputSidePackets().Tag(kFilePathTag).Set<std::string>().Optional();
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    const auto& options = cc->Options<PacketReplayCalculatorOptions>();
+    std::string file_path = options.file_path();
+    if (cc->InputSidePackets().HasTag(kFilePathTag)) {
+      file_path = cc->InputSidePackets().Tag(kFilePathTag).Get<std::string>();
+    }
+    RET_CHECK(!file_path.empty()) << "A packet dump file path is required.";
+    RET_CHECK_GE(options.replay_speed(), 0);
+    replay_speed_ = options.replay_speed();
+    ASSIGN_OR_RETURN(reader_, PacketDumpReader::Open(file_path));
+    for (CollectionItemId id = cc->Outputs().BeginId();
+         id < cc->Outputs().EndId(); ++id) {
+      output_ids_[cc->Outputs().TagMap()->Names()[id.value()]] = id;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    for (; next_packet_ < reader_->num_packets(); ++next_packet_) {
+      auto it = output_ids_.find(reader_->stream(next_packet_));
+      if (it == output_ids_.end()) continue;
+      if (replay_speed_ > 0) {
+        absl::Duration send_time =
+            absl::Microseconds(reader_->send_time_usec(next_packet_)) /
+            replay_speed_;
+        // The first packet is sent right away.
+        if (start_time_ == absl::InfinitePast()) {
+          start_time_ = absl::Now() - send_time;
+        }
+        absl::SleepFor(start_time_ + send_time - absl::Now());
+      }
+      ASSIGN_OR_RETURN(Packet packet, reader_->ReadPacket(next_packet_++));
+      cc->Outputs().Get(it->second).AddPacket(std::move(packet));
+      return absl::OkStatus();
+    }
+    return tool::StatusStop();
+  }
+
+ private:
+  std::unique_ptr<PacketDumpReader> reader_;
+  std::map<std::string, CollectionItemId> output_ids_;
+  double replay_speed_ = 1;
+  absl::Time start_time_ = absl::InfinitePast();
+  int next_packet_ = 0;
+};
+REGISTER_CALCULATOR(PacketReplayCalculator);
+
+}  // namespace mediapipe
@@ -116,46 +116,48 @@ absl::Status RectTransformationCalculator::Open(CalculatorContext* cc) {
 }
 
 absl::Status RectTransformationCalculator::Process(CalculatorContext* cc) {
+  // The rects are transformed in place if this calculator holds the only
+  // reference to them, so that chained transforms don't copy them.
   if (cc->Inputs().HasTag(kRectTag) && !cc->Inputs().Tag(kRectTag).IsEmpty()) {
-    auto rect = cc->Inputs().Tag(kRectTag).Get<Rect>();
-    TransformRect(&rect);
-    cc->Outputs().Index(0).AddPacket(
-        MakePacket<Rect>(rect).At(cc->InputTimestamp()));
+    ASSIGN_OR_RETURN(auto rect,
+                     cc->Inputs().Tag(kRectTag).Value().ConsumeOrCopy<Rect>());
+    TransformRect(rect.get());
+    cc->Outputs().Index(0).Add(rect.release(), cc->InputTimestamp());
   }
   if (cc->Inputs().HasTag(kRectsTag) &&
       !cc->Inputs().Tag(kRectsTag).IsEmpty()) {
-    auto rects = cc->Inputs().Tag(kRectsTag).Get<std::vector<Rect>>();
-    auto output_rects = absl::make_unique<std::vector<Rect>>(rects.size());
-    for (int i = 0; i < rects.size(); ++i) {
-      output_rects->at(i) = rects[i];
-      auto it = output_rects->begin() + i;
-      TransformRect(&(*it));
+    ASSIGN_OR_RETURN(
+        auto rects,
+        cc->Inputs().Tag(kRectsTag).Value().ConsumeOrCopy<std::vector<Rect>>());
+    for (auto& rect : *rects) {
+      TransformRect(&rect);
     }
-    cc->Outputs().Index(0).Add(output_rects.release(), cc->InputTimestamp());
+    cc->Outputs().Index(0).Add(rects.release(), cc->InputTimestamp());
   }
   if (HasTagValue(cc->Inputs(), kNormRectTag) &&
       HasTagValue(cc->Inputs(), kImageSizeTag)) {
-    auto rect = cc->Inputs().Tag(kNormRectTag).Get<NormalizedRect>();
+    ASSIGN_OR_RETURN(auto rect, cc->Inputs()
+                                    .Tag(kNormRectTag)
+                                    .Value()
+                                    .ConsumeOrCopy<NormalizedRect>());
     const auto& image_size =
         cc->Inputs().Tag(kImageSizeTag).Get<std::pair<int, int>>();
-    TransformNormalizedRect(&rect, image_size.first, image_size.second);
-    cc->Outputs().Index(0).AddPacket(
-        MakePacket<NormalizedRect>(rect).At(cc->InputTimestamp()));
+    TransformNormalizedRect(rect.get(), image_size.first, image_size.second);
+    cc->Outputs().Index(0).Add(rect.release(), cc->InputTimestamp());
   }
   if (HasTagValue(cc->Inputs(), kNormRectsTag) &&
       HasTagValue(cc->Inputs(), kImageSizeTag)) {
-    auto rects =
-        cc->Inputs().Tag(kNormRectsTag).Get<std::vector<NormalizedRect>>();
+    ASSIGN_OR_RETURN(auto rects,
+                     cc->Inputs()
+                         .Tag(kNormRectsTag)
+                         .Value()
+                         .ConsumeOrCopy<std::vector<NormalizedRect>>());
     const auto& image_size =
         cc->Inputs().Tag(kImageSizeTag).Get<std::pair<int, int>>();
-    auto output_rects =
-        absl::make_unique<std::vector<NormalizedRect>>(rects.size());
-    for (int i = 0; i < rects.size(); ++i) {
-      output_rects->at(i) = rects[i];
-      auto it = output_rects->begin() + i;
-      TransformNormalizedRect(&(*it), image_size.first, image_size.second);
+    for (auto& rect : *rects) {
+      TransformNormalizedRect(&rect, image_size.first, image_size.second);
     }
-    cc->Outputs().Index(0).Add(output_rects.release(), cc->InputTimestamp());
+    cc->Outputs().Index(0).Add(rects.release(), cc->InputTimestamp());
   }
 
   return absl::OkStatus();
@@ -14,15 +14,134 @@
 
 #include "mediapipe/calculators/util/refine_landmarks_from_heatmap_calculator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "mediapipe/calculators/util/refine_landmarks_from_heatmap_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace mediapipe {
 
 namespace {
 
 inline float Sigmoid(float value) { return 1.0f / (1.0f + std::exp(-value)); }
 
+// Constants of the Cephes approximation of expf() used by the vector loops,
+// which is accurate to about 1 ulp.
+constexpr float kExpMax = 88.3762626647949f;
+constexpr float kLog2e = 1.44269504088896341f;
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+// Values below which std::exp(-value) overflows and Sigmoid() returns 0.
+constexpr float kSigmoidZeroBelow = -88.7228391f;
+
+// Replaces `values` with their sigmoids.
+void SigmoidInPlace(float* values, int size) {
+  int i = 0;
+#if defined(__AVX2__)
+  for (; i + 8 <= size; i += 8) {
+    const __m256 value = _mm256_loadu_ps(values + i);
+    __m256 x = _mm256_max_ps(
+        _mm256_min_ps(_mm256_sub_ps(_mm256_setzero_ps(), value),
+                      _mm256_set1_ps(kExpMax)),
+        _mm256_set1_ps(-kExpMax));
+    const __m256 n = _mm256_floor_ps(_mm256_add_ps(
+        _mm256_mul_ps(x, _mm256_set1_ps(kLog2e)), _mm256_set1_ps(0.5f)));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(kLn2Hi)));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(kLn2Lo)));
+    __m256 y = _mm256_set1_ps(kExpP0);
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(kExpP1));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(kExpP2));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(kExpP3));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(kExpP4));
+    y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(kExpP5));
+    y = _mm256_add_ps(_mm256_mul_ps(y, _mm256_mul_ps(x, x)),
+                      _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+    const __m256 pow2n = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)),
+        23));
+    const __m256 sigmoid = _mm256_div_ps(
+        _mm256_set1_ps(1.0f),
+        _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(y, pow2n)));
+    const __m256 is_zero = _mm256_cmp_ps(
+        value, _mm256_set1_ps(kSigmoidZeroBelow), _CMP_LT_OQ);
+    _mm256_storeu_ps(values + i, _mm256_andnot_ps(is_zero, sigmoid));
+  }
+#elif defined(__SSE2__)
+  for (; i + 4 <= size; i += 4) {
+    const __m128 value = _mm_loadu_ps(values + i);
+    __m128 x = _mm_max_ps(_mm_min_ps(_mm_sub_ps(_mm_setzero_ps(), value),
+                                     _mm_set1_ps(kExpMax)),
+                          _mm_set1_ps(-kExpMax));
+    // Rounds down by truncating, then subtracting 1 from values that were
+    // rounded up, as SSE2 has no floor instruction.
+    const __m128 fx =
+        _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(kLog2e)), _mm_set1_ps(0.5f));
+    __m128 n = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+    n = _mm_sub_ps(n, _mm_and_ps(_mm_cmpgt_ps(n, fx), _mm_set1_ps(1.0f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(kLn2Hi)));
+    x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(kLn2Lo)));
+    __m128 y = _mm_set1_ps(kExpP0);
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP1));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP2));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP3));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP4));
+    y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(kExpP5));
+    y = _mm_add_ps(_mm_mul_ps(y, _mm_mul_ps(x, x)),
+                   _mm_add_ps(x, _mm_set1_ps(1.0f)));
+    const __m128 pow2n = _mm_castsi128_ps(_mm_slli_epi32(
+        _mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23));
+    const __m128 sigmoid =
+        _mm_div_ps(_mm_set1_ps(1.0f),
+                   _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(y, pow2n)));
+    const __m128 is_zero = _mm_cmplt_ps(value, _mm_set1_ps(kSigmoidZeroBelow));
+    _mm_storeu_ps(values + i, _mm_andnot_ps(is_zero, sigmoid));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 4 <= size; i += 4) {
+    const float32x4_t value = vld1q_f32(values + i);
+    float32x4_t x = vmaxq_f32(vminq_f32(vnegq_f32(value), vdupq_n_f32(kExpMax)),
+                              vdupq_n_f32(-kExpMax));
+    const float32x4_t n =
+        vrndmq_f32(vmlaq_n_f32(vdupq_n_f32(0.5f), x, kLog2e));
+    x = vmlsq_n_f32(x, n, kLn2Hi);
+    x = vmlsq_n_f32(x, n, kLn2Lo);
+    float32x4_t y = vdupq_n_f32(kExpP0);
+    y = vmlaq_f32(vdupq_n_f32(kExpP1), y, x);
+    y = vmlaq_f32(vdupq_n_f32(kExpP2), y, x);
+    y = vmlaq_f32(vdupq_n_f32(kExpP3), y, x);
+    y = vmlaq_f32(vdupq_n_f32(kExpP4), y, x);
+    y = vmlaq_f32(vdupq_n_f32(kExpP5), y, x);
+    y = vmlaq_f32(vaddq_f32(x, vdupq_n_f32(1.0f)), y, vmulq_f32(x, x));
+    const float32x4_t pow2n = vreinterpretq_f32_s32(vshlq_n_s32(
+        vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23));
+    const float32x4_t sigmoid =
+        vdivq_f32(vdupq_n_f32(1.0f), vmlaq_f32(vdupq_n_f32(1.0f), y, pow2n));
+    const uint32x4_t is_zero = vcltq_f32(value, vdupq_n_f32(kSigmoidZeroBelow));
+    vst1q_f32(values + i, vreinterpretq_f32_u32(vbicq_u32(
+                              vreinterpretq_u32_f32(sigmoid), is_zero)));
+  }
+#endif
+  for (; i < size; ++i) {
+    values[i] = Sigmoid(values[i]);
+  }
+}
+
 absl::StatusOr<std::tuple<int, int, int>> GetHwcFromDims(
     const std::vector<int>& dims) {
   if (dims.size() == 3) {
@@ -118,6 +237,10 @@ absl::StatusOr<mediapipe::NormalizedLandmarkList> RefineLandmarksFromHeatMap(
   int hm_row_size = hm_width * hm_channels;
   int hm_pixel_size = hm_channels;
 
+  // The heatmap values of the kernel of a landmark, gathered contiguously so
+  // that their sigmoids are computed in vector loops.
+  std::vector<float> confidences(std::max(kernel_size * kernel_size, 0));
+
   mediapipe::NormalizedLandmarkList out_lms = in_lms;
   for (int lm_index = 0; lm_index < out_lms.landmark_size(); ++lm_index) {
     int center_col = out_lms.landmark(lm_index).x() * hm_width;
@@ -136,6 +259,21 @@ absl::StatusOr<mediapipe::NormalizedLandmarkList> RefineLandmarksFromHeatMap(
     int begin_row = std::max(0, center_row - offset);
     int end_row = std::min(hm_height, center_row + offset + 1);
 
+    // Gather the kernel in row-major order.
+    int num_confidences = 0;
+    for (int row = begin_row; row < end_row; ++row) {
+      for (int col = begin_col; col < end_col; ++col) {
+        // We expect memory to be in HWC layout without padding.
+        int idx = hm_row_size * row + hm_pixel_size * col + lm_index;
+        confidences[num_confidences++] = heatmap_raw_data[idx];
+      }
+    }
+    // Right now we hardcode sigmoid activation as it will be wasteful to
+    // calculate sigmoid for each value of heatmap in the model itself.  If
+    // we ever have other activations it should be trivial to expand via
+    // options.
+    SigmoidInPlace(confidences.data(), num_confidences);
+
     float sum = 0;
     float weighted_col = 0;
     float weighted_row = 0;
@@ -143,19 +281,13 @@ absl::StatusOr<mediapipe::NormalizedLandmarkList> RefineLandmarksFromHeatMap(
 
     // Main loop. Go over kernel and calculate weighted sum of coordinates,
     // sum of weights and max weights.
+    const float* confidence = confidences.data();
     for (int row = begin_row; row < end_row; ++row) {
-      for (int col = begin_col; col < end_col; ++col) {
-        // We expect memory to be in HWC layout without padding.
-        int idx = hm_row_size * row + hm_pixel_size * col + lm_index;
-        // Right now we hardcode sigmoid activation as it will be wasteful to
-        // calculate sigmoid for each value of heatmap in the model itself.  If
-        // we ever have other activations it should be trivial to expand via
-        // options.
-        float confidence = Sigmoid(heatmap_raw_data[idx]);
-        sum += confidence;
-        max_confidence_value = std::max(max_confidence_value, confidence);
-        weighted_col += col * confidence;
-        weighted_row += row * confidence;
+      for (int col = begin_col; col < end_col; ++col, ++confidence) {
+        sum += *confidence;
+        max_confidence_value = std::max(max_confidence_value, *confidence);
+        weighted_col += col * *confidence;
+        weighted_row += row * *confidence;
       }
     }
     if (max_confidence_value >= min_confidence_to_refine && sum > 0) {
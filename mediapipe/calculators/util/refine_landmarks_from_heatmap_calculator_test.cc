@@ -14,6 +14,9 @@
 
 #include "mediapipe/calculators/util/refine_landmarks_from_heatmap_calculator.h"
 
+#include <cmath>
+#include <vector>
+
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/status_matchers.h"
@@ -59,6 +62,7 @@ std::vector<float> CHW_to_HWC(std::vector<float> inp, int height, int width,
 
 using testing::ElementsAre;
 using testing::FloatEq;
+using testing::FloatNear;
 using testing::Pair;
 
 TEST(RefineLandmarksFromHeatmapTest, Smoke) {
@@ -149,5 +153,33 @@ TEST(RefineLandmarksFromHeatmapTest, Border) {
                           Pair(FloatEq(2 / 3.), FloatEq(1 / 6. + 2 / 6.))));
 }
 
+TEST(RefineLandmarksFromHeatmapTest, LargeKernel) {
+  // Covers the vector loops and the remaining values of a 7x7 kernel.
+  constexpr int kSize = 9;
+  std::vector<float> hm(kSize * kSize);
+  for (int i = 0; i < hm.size(); ++i) {
+    hm[i] = (i % 7) - 3.5f;
+  }
+  float sum = 0;
+  float weighted_col = 0;
+  float weighted_row = 0;
+  for (int row = 1; row < 8; ++row) {
+    for (int col = 1; col < 8; ++col) {
+      const float confidence = 1.0f / (1.0f + std::exp(-hm[row * kSize + col]));
+      sum += confidence;
+      weighted_col += col * confidence;
+      weighted_row += row * confidence;
+    }
+  }
+
+  auto ret_or_error =
+      RefineLandmarksFromHeatMap(vec_to_lms({{0.5, 0.5}}), hm.data(),
+                                 {kSize, kSize, 1}, 7, 0.1, true, true);
+  MP_EXPECT_OK(ret_or_error);
+  EXPECT_THAT(lms_to_vec(*ret_or_error),
+              ElementsAre(Pair(FloatNear(weighted_col / kSize / sum, 1e-6),
+                               FloatNear(weighted_row / kSize / sum, 1e-6))));
+}
+
 }  // namespace
 }  // namespace mediapipe
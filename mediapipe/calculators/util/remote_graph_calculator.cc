@@ -0,0 +1,204 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "mediapipe/calculators/util/remote_graph_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/remote_graph.h"
+
+namespace mediapipe {
+
+// Runs part of a pipeline in a graph on a RemoteGraphServer, such as a heavy
+// model on a GPU server fed by a camera client. The packets and timestamp
+// bounds of the input streams are sent to the remote graph input streams, and
+// those of the remote graph output streams are sent to the output streams.
+// The input and output streams must be untagged, and are matched by index
+// with the remote streams named in the options. The payloads must be of a
+// type supported by packet_payload.h.
+//
+// Up to max_in_flight input timestamps are sent before the outputs of the
+// earliest of them have arrived, so that the network latency overlaps with
+// the remote computation. The outputs of a timestamp are therefore emitted
+// while processing a later one, or when the input streams close.
+//
+// Example config:
+// node {
+//   calculator: "RemoteGraphCalculator"
+//   input_stream: "input_video"
+//   output_stream: "detections"
+//   options {
+//     [mediapipe.RemoteGraphCalculatorOptions.ext] {
+//       transport: "grpc"
+//       address: "gpu-server:50051"
+//       remote_input_stream: "image"
+//       remote_output_stream: "detections"
+//       max_in_flight: 3
+//     }
+//   }
+// }
+class RemoteGraphCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    const auto& options = cc->Options<RemoteGraphCalculatorOptions>();
+    RET_CHECK_EQ(cc->Inputs().NumEntries(""), cc->Inputs().NumEntries())
+        << "The input streams must be untagged.";
+    RET_CHECK_EQ(cc->Outputs().NumEntries(""), cc->Outputs().NumEntries())
+        << "The output streams must be untagged.";
+    RET_CHECK_EQ(cc->Inputs().NumEntries(), options.remote_input_stream_size());
+    RET_CHECK_EQ(cc->Outputs().NumEntries(),
+                 options.remote_output_stream_size());
+    for (int i = 0; i < cc->Inputs().NumEntries(); ++i) {
+      cc->Inputs().Index(i).SetAny();
+    }
+    for (int i = 0; i < cc->Outputs().NumEntries(); ++i) {
+      cc->Outputs().Index(i).SetAny();
+    }
+    cc->SetProcessTimestampBounds(true);
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    options_ = cc->Options<RemoteGraphCalculatorOptions>();
+    RET_CHECK_GT(options_.max_in_flight(), 0);
+    timeout_ = absl::Milliseconds(options_.timeout_ms());
+    for (int i = 0; i < options_.remote_output_stream_size(); ++i) {
+      output_index_[options_.remote_output_stream(i)] = i;
+    }
+    output_bounds_.assign(options_.remote_output_stream_size(),
+                          Timestamp::Unstarted());
+    ASSIGN_OR_RETURN(connection_, ConnectRemoteGraph(options_.transport(),
+                                                     options_.address()));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    for (int i = 0; i < cc->Inputs().NumEntries(); ++i) {
+      const Packet& packet = cc->Inputs().Index(i).Value();
+      RemoteGraphMessage message;
+      if (packet.IsEmpty()) {
+        message.set_kind(RemoteGraphMessage::TIMESTAMP_BOUND);
+        message.set_stream(options_.remote_input_stream(i));
+        message.set_timestamp(
+            cc->InputTimestamp().NextAllowedInStream().Value());
+      } else {
+        ASSIGN_OR_RETURN(message, MakeRemotePacketMessage(
+                                      options_.remote_input_stream(i), packet));
+      }
+      MP_RETURN_IF_ERROR(connection_->Send(std::move(message)));
+    }
+    if (!output_bounds_.empty()) in_flight_.push_back(cc->InputTimestamp());
+
+    MP_RETURN_IF_ERROR(ReceiveMessages(cc, absl::ZeroDuration()));
+    while (static_cast<int>(in_flight_.size()) > options_.max_in_flight()) {
+      MP_RETURN_IF_ERROR(ReceiveMessages(cc, timeout_));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Close(CalculatorContext* cc) override {
+    if (!connection_) return absl::OkStatus();
+    RemoteGraphMessage message;
+    message.set_kind(RemoteGraphMessage::CLOSE);
+    MP_RETURN_IF_ERROR(connection_->Send(std::move(message)));
+    while (!remote_done_) {
+      MP_RETURN_IF_ERROR(ReceiveMessages(cc, timeout_));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  // Handles the messages that arrive within `timeout`, followed by those that
+  // are available without waiting.
+  absl::Status ReceiveMessages(CalculatorContext* cc, absl::Duration timeout) {
+    while (!remote_done_) {
+      absl::StatusOr<RemoteGraphMessage> message =
+          connection_->Receive(timeout);
+      if (absl::IsDeadlineExceeded(message.status()) &&
+          timeout == absl::ZeroDuration()) {
+        break;
+      }
+      MP_RETURN_IF_ERROR(message.status())
+          << " from the remote graph at " << options_.address();
+      MP_RETURN_IF_ERROR(HandleMessage(cc, *std::move(message)));
+      timeout = absl::ZeroDuration();
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status HandleMessage(CalculatorContext* cc,
+                             RemoteGraphMessage message) {
+    switch (message.kind()) {
+      case RemoteGraphMessage::PACKET: {
+        ASSIGN_OR_RETURN(int index, OutputIndex(message.stream()));
+        ASSIGN_OR_RETURN(Packet packet, GetRemotePacket(std::move(message)));
+        output_bounds_[index] = packet.Timestamp().NextAllowedInStream();
+        cc->Outputs().Index(index).AddPacket(std::move(packet));
+        break;
+      }
+      case RemoteGraphMessage::TIMESTAMP_BOUND: {
+        ASSIGN_OR_RETURN(int index, OutputIndex(message.stream()));
+        output_bounds_[index] = Timestamp(message.timestamp());
+        cc->Outputs().Index(index).SetNextTimestampBound(output_bounds_[index]);
+        break;
+      }
+      case RemoteGraphMessage::CLOSE:
+        remote_done_ = true;
+        in_flight_.clear();
+        return absl::OkStatus();
+      case RemoteGraphMessage::ERROR:
+        return absl::Status(
+            static_cast<absl::StatusCode>(message.error_code()),
+            absl::StrCat("The remote graph at ", options_.address(),
+                         " failed: ", message.error_message()));
+    }
+    // An input timestamp is done once every output stream has passed it.
+    const Timestamp done =
+        *std::min_element(output_bounds_.begin(), output_bounds_.end());
+    while (!in_flight_.empty() && in_flight_.front() < done) {
+      in_flight_.pop_front();
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<int> OutputIndex(const std::string& stream) const {
+    auto it = output_index_.find(stream);
+    RET_CHECK(it != output_index_.end())
+        << "Unexpected remote output stream: " << stream;
+    return it->second;
+  }
+
+  RemoteGraphCalculatorOptions options_;
+  absl::Duration timeout_;
+  std::unique_ptr<RemoteGraphConnection> connection_;
+  absl::flat_hash_map<std::string, int> output_index_;
+  // The next timestamp bound of each remote output stream.
+  std::vector<Timestamp> output_bounds_;
+  // The input timestamps whose outputs have not all been received.
+  std::deque<Timestamp> in_flight_;
+  bool remote_done_ = false;
+};
+REGISTER_CALCULATOR(RemoteGraphCalculator);
+
+}  // namespace mediapipe
@@ -0,0 +1,123 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/substitute.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/sink.h"
+#include "mediapipe/util/remote_graph.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+CalculatorGraphConfig ClientConfig(const std::string& address) {
+  return ParseTextProtoOrDie<CalculatorGraphConfig>(absl::Substitute(
+      R"pb(
+        input_stream: "frames"
+        input_stream: "scores"
+        node {
+          calculator: "RemoteGraphCalculator"
+          input_stream: "frames"
+          input_stream: "scores"
+          output_stream: "remote_frames"
+          output_stream: "remote_scores"
+          options {
+            [mediapipe.RemoteGraphCalculatorOptions.ext] {
+              address: "$0"
+              remote_input_stream: "in_frames"
+              remote_input_stream: "in_scores"
+              remote_output_stream: "out_frames"
+              remote_output_stream: "out_scores"
+              max_in_flight: 2
+            }
+          }
+        }
+      )pb",
+      address));
+}
+
+TEST(RemoteGraphCalculatorTest, RunsGraphOnServer) {
+  RemoteGraphServer server(ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "in_frames"
+    input_stream: "in_scores"
+    output_stream: "out_frames"
+    output_stream: "out_scores"
+    node {
+      calculator: "PassThroughCalculator"
+      input_stream: "in_frames"
+      input_stream: "in_scores"
+      output_stream: "out_frames"
+      output_stream: "out_scores"
+    }
+  )pb"));
+  MP_ASSERT_OK(server.ServeLoopback("remote_graph_test"));
+
+  CalculatorGraphConfig config = ClientConfig("remote_graph_test");
+  std::vector<Packet> frames;
+  std::vector<Packet> scores;
+  tool::AddVectorSink("remote_frames", &config, &frames);
+  tool::AddVectorSink("remote_scores", &config, &scores);
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 5; ++i) {
+    Timestamp timestamp(i * 10);
+    auto frame = std::make_unique<ImageFrame>(ImageFormat::FORMAT_GRAY8, 4, 2);
+    frame->SetToZero();
+    frame->MutablePixelData()[0] = i;
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "frames", Adopt(frame.release()).At(timestamp)));
+    // The scores skip a timestamp, which the remote graph learns from the
+    // timestamp bound.
+    if (i != 2) {
+      std::vector<float> values = {0.5f * i};
+      MP_ASSERT_OK(graph.AddPacketToInputStream(
+          "scores", MakePacket<std::vector<float>>(values).At(timestamp)));
+    }
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  ASSERT_EQ(frames.size(), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(frames[i].Timestamp(), Timestamp(i * 10));
+    EXPECT_EQ(frames[i].Get<ImageFrame>().Width(), 4);
+    EXPECT_EQ(frames[i].Get<ImageFrame>().PixelData()[0], i);
+  }
+  ASSERT_EQ(scores.size(), 4);
+  EXPECT_EQ(scores[2].Timestamp(), Timestamp(30));
+  EXPECT_THAT(scores[2].Get<std::vector<float>>(), ElementsAre(1.5f));
+}
+
+TEST(RemoteGraphCalculatorTest, FailsWithoutServer) {
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(ClientConfig("no_such_server")));
+  absl::Status status = graph.Run();
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(), HasSubstr("no_such_server"));
+}
+
+}  // namespace
+}  // namespace mediapipe
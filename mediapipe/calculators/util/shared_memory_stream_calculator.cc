@@ -0,0 +1,168 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+
+#include "absl/time/time.h"
+#include "mediapipe/calculators/util/shared_memory_stream_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/shared_memory_channel.h"
+
+namespace mediapipe {
+
+namespace {
+
+constexpr char kChannelNameTag[] = "CHANNEL_NAME";
+
+// How long the source waits for a message before Process() returns, so that
+// the graph can be closed.
+constexpr absl::Duration kReadTimeout = absl::Milliseconds(100);
+
+absl::Status UpdateContract(CalculatorContract* cc) {
+  cc->InputSidePackets().Tag(kChannelNameTag).Set<std::string>().Optional();
+  return absl::OkStatus();
+}
+
+// Opens the channel named by the options or the CHANNEL_NAME side packet.
+absl::StatusOr<std::unique_ptr<SharedMemoryChannel>> OpenChannel(
+    CalculatorContext* cc, std::string* channel_name) {
+  const auto& options = cc->Options<SharedMemoryStreamCalculatorOptions>();
+  *channel_name = options.channel_name();
+  if (cc->InputSidePackets().HasTag(kChannelNameTag)) {
+    *channel_name =
+        cc->InputSidePackets().Tag(kChannelNameTag).Get<std::string>();
+  }
+  RET_CHECK(!channel_name->empty()) << "A channel name is required.";
+  RET_CHECK_GT(options.capacity_bytes(), 0);
+  return SharedMemoryChannel::Open(*channel_name, options.capacity_bytes(),
+                                   absl::Milliseconds(options.timeout_ms()));
+}
+
+}  // namespace
+
+// Sends the packets and timestamp bounds of its input stream through a shared
+// memory channel to a SharedMemorySourceCalculator, typically in a graph in
+// another process. This lets a pipeline be split across processes, such as
+// capture and rendering in an app and inference in a separate service. The
+// packets must be of a type supported by SharedMemoryChannel, and are copied
+// into the channel. Closing the input stream closes the source's output
+// stream.
+//
+// Example config:
+// node {
+//   calculator: "SharedMemorySinkCalculator"
+//   input_stream: "input_video"
+//   options {
+//     [mediapipe.SharedMemoryStreamCalculatorOptions.ext] {
+//       channel_name: "camera_frames"
+//     }
+//   }
+// }
+class SharedMemorySinkCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).SetAny();
+    cc->SetProcessTimestampBounds(true);
+    return UpdateContract(cc);
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    std::string channel_name;
+    ASSIGN_OR_RETURN(channel_, OpenChannel(cc, &channel_name));
+    timeout_ = absl::Milliseconds(
+        cc->Options<SharedMemoryStreamCalculatorOptions>().timeout_ms());
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    const Packet& packet = cc->Inputs().Index(0).Value();
+    if (!packet.IsEmpty()) {
+      return channel_->WritePacket(packet, timeout_);
+    }
+    // Only the timestamp bound has advanced.
+    return channel_->WriteTimestampBound(
+        cc->InputTimestamp().NextAllowedInStream(), timeout_);
+  }
+
+  absl::Status Close(CalculatorContext* cc) override {
+    return channel_ ? channel_->WriteClose(timeout_) : absl::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<SharedMemoryChannel> channel_;
+  absl::Duration timeout_;
+};
+REGISTER_CALCULATOR(SharedMemorySinkCalculator);
+
+// Outputs the packets and timestamp bounds sent by a
+// SharedMemorySinkCalculator through a shared memory channel, and closes its
+// output stream when the sink closes. Removes the name of the channel when it
+// closes, so that the next run creates a new channel.
+//
+// Example config:
+// node {
+//   calculator: "SharedMemorySourceCalculator"
+//   output_stream: "input_video"
+//   options {
+//     [mediapipe.SharedMemoryStreamCalculatorOptions.ext] {
+//       channel_name: "camera_frames"
+//     }
+//   }
+// }
+class SharedMemorySourceCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Outputs().Index(0).SetAny();
+    return UpdateContract(cc);
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    ASSIGN_OR_RETURN(channel_, OpenChannel(cc, &channel_name_));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    auto message = channel_->Read(kReadTimeout);
+    if (absl::IsDeadlineExceeded(message.status())) {
+      return absl::OkStatus();
+    }
+    MP_RETURN_IF_ERROR(message.status());
+    switch (message->kind) {
+      case SharedMemoryChannel::Message::Kind::kPacket:
+        cc->Outputs().Index(0).AddPacket(std::move(message->packet));
+        break;
+      case SharedMemoryChannel::Message::Kind::kTimestampBound:
+        cc->Outputs().Index(0).SetNextTimestampBound(message->bound);
+        break;
+      case SharedMemoryChannel::Message::Kind::kClose:
+        return tool::StatusStop();
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Close(CalculatorContext* cc) override {
+    return channel_ ? SharedMemoryChannel::Unlink(channel_name_)
+                    : absl::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<SharedMemoryChannel> channel_;
+  std::string channel_name_;
+};
+REGISTER_CALCULATOR(SharedMemorySourceCalculator);
+
+}  // namespace mediapipe
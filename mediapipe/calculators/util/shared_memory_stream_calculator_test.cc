@@ -0,0 +1,104 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <unistd.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(SharedMemoryStreamCalculatorTest, ForwardsPacketsAndBounds) {
+  // The two graphs would normally run in separate processes.
+  auto source_config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_side_packet: "channel_name"
+    node {
+      calculator: "SharedMemorySourceCalculator"
+      output_stream: "frames"
+      input_side_packet: "CHANNEL_NAME:channel_name"
+    }
+  )pb");
+  auto sink_config = ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "frames"
+    input_side_packet: "channel_name"
+    node {
+      calculator: "SharedMemorySinkCalculator"
+      input_stream: "frames"
+      input_side_packet: "CHANNEL_NAME:channel_name"
+    }
+  )pb");
+  std::map<std::string, Packet> side_packets = {
+      {"channel_name",
+       MakePacket<std::string>(absl::StrCat("/mediapipe_test_", getpid()))}};
+
+  CalculatorGraph source_graph;
+  MP_ASSERT_OK(source_graph.Initialize(source_config));
+  std::vector<Packet> received;
+  MP_ASSERT_OK(source_graph.ObserveOutputStream(
+      "frames",
+      [&received](const Packet& packet) {
+        received.push_back(packet);
+        return absl::OkStatus();
+      },
+      /*observe_timestamp_bounds=*/true));
+  MP_ASSERT_OK(source_graph.StartRun(side_packets));
+
+  CalculatorGraph sink_graph;
+  MP_ASSERT_OK(sink_graph.Initialize(sink_config));
+  MP_ASSERT_OK(sink_graph.StartRun(side_packets));
+  for (int i = 0; i < 3; ++i) {
+    auto frame = std::make_unique<ImageFrame>(ImageFormat::FORMAT_GRAY8, 5, 3);
+    frame->SetToZero();
+    frame->MutablePixelData()[0] = i;
+    MP_ASSERT_OK(sink_graph.AddPacketToInputStream(
+        "frames", Adopt(frame.release()).At(Timestamp(i * 10))));
+  }
+  MP_ASSERT_OK(
+      sink_graph.SetInputStreamTimestampBound("frames", Timestamp(50)));
+  MP_ASSERT_OK(sink_graph.CloseAllInputStreams());
+  MP_ASSERT_OK(sink_graph.WaitUntilDone());
+  MP_ASSERT_OK(source_graph.WaitUntilDone());
+
+  std::vector<Packet> packets;
+  bool has_bound = false;
+  for (const Packet& packet : received) {
+    if (packet.IsEmpty()) {
+      has_bound |= packet.Timestamp() == Timestamp(49);
+    } else {
+      packets.push_back(packet);
+    }
+  }
+  EXPECT_TRUE(has_bound);
+  ASSERT_EQ(packets.size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(packets[i].Timestamp(), Timestamp(i * 10));
+    const auto& frame = packets[i].Get<ImageFrame>();
+    EXPECT_EQ(frame.Width(), 5);
+    EXPECT_EQ(frame.Height(), 3);
+    EXPECT_EQ(frame.PixelData()[0], i);
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -18,6 +18,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
@@ -36,6 +37,7 @@
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/tool/options_util.h"
 #include "mediapipe/util/tracking/box_tracker.h"
+#include "mediapipe/util/tracking/parallel_invoker.h"
 #include "mediapipe/util/tracking/tracking.h"
 #include "mediapipe/util/tracking/tracking_visualization_utilities.h"
 
@@ -220,6 +222,10 @@ class BoxTrackerCalculator : public CalculatorBase {
   bool tracking_issued_ = false;
   std::unique_ptr<BoxTracker> box_tracker_;
 
+  // Graph executor for tracking, or nullptr to use the BoxTracker's own
+  // threads and the parallel invoker.
+  Executor* tracking_executor_ = nullptr;
+
   // If set, renders tracking data into VIZ stream.
   bool visualize_tracking_data_ = false;
 
@@ -521,10 +527,18 @@ absl::Status BoxTrackerCalculator::Open(CalculatorContext* cc) {
     options_.mutable_tracker_options()->set_record_path_states(true);
   }
 
+  if (options_.has_tracking_executor()) {
+    tracking_executor_ = cc->GetExecutor(options_.tracking_executor());
+    RET_CHECK(tracking_executor_ != nullptr)
+        << "No executor named \"" << options_.tracking_executor()
+        << "\" in the graph.";
+  }
+
   if (cc->InputSidePackets().HasTag(kCacheDirTag)) {
     cache_dir_ = cc->InputSidePackets().Tag(kCacheDirTag).Get<std::string>();
     RET_CHECK(!cache_dir_.empty());
-    box_tracker_.reset(new BoxTracker(cache_dir_, options_.tracker_options()));
+    box_tracker_.reset(new BoxTracker(cache_dir_, options_.tracker_options(),
+                                      tracking_executor_));
   } else {
     // Check that all boxes have a unique id.
     RET_CHECK(initial_pos_.box_size() == batch_track_ids_.size())
@@ -1196,9 +1210,25 @@ void BoxTrackerCalculator::StreamTrack(const TrackingData& data,
   const int from_frame = data_frame_num - (forward ? 1 : 0);
   const int to_frame = forward ? from_frame + 1 : from_frame - 1;
 
+  // Track all boxes in parallel against the shared motion vectors.
+  std::vector<MotionBox*> boxes;
+  boxes.reserve(box_map->size());
+  for (auto& motion_box : *box_map) {
+    boxes.push_back(&motion_box.second.box);
+  }
+  std::vector<char> tracked;
+  {
+    std::unique_ptr<ScopedParallelInvokerExecutor> executor_scope;
+    if (tracking_executor_ != nullptr) {
+      executor_scope = std::make_unique<ScopedParallelInvokerExecutor>(
+          tracking_executor_, /*max_concurrency=*/0);
+    }
+    tracked = MotionBox::TrackStepBatch(from_frame, mvf, forward, boxes);
+  }
+
+  int box_idx = 0;
   for (auto& motion_box : *box_map) {
-    if (!motion_box.second.box.TrackStep(from_frame,  // from frame.
-                                         mvf, forward)) {
+    if (!tracked[box_idx++]) {
       failed_ids->push_back(motion_box.first);
       ABSL_LOG(INFO) << "lost track. pushed failed id: " << motion_box.first;
     } else {
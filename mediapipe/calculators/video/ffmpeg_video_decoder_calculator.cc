@@ -0,0 +1,500 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>  // required by avutil.h
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "libyuv/video_common.h"
+#include "mediapipe/calculators/video/ffmpeg_video_decoder_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/video_stream_header.h"
+#include "mediapipe/framework/formats/yuv_image.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/tool/options_util.h"
+#include "mediapipe/framework/tool/status_util.h"
+#include "mediapipe/gpu/gpu_buffer.h"
+#include "mediapipe/gpu/gpu_buffer_storage_yuv_image.h"
+#include "mediapipe/util/image_frame_util.h"
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libavutil/avutil.h"
+#include "libavutil/hwcontext.h"
+#include "libavutil/pixdesc.h"
+}
+
+namespace mediapipe {
+
+namespace {
+
+constexpr char kInputFilePathTag[] = "INPUT_FILE_PATH";
+constexpr char kOptionsTag[] = "OPTIONS";
+constexpr char kVideoTag[] = "VIDEO";
+constexpr char kYuvImageTag[] = "YUV_IMAGE";
+constexpr char kGpuBufferTag[] = "GPU_BUFFER";
+constexpr char kVideoPrestreamTag[] = "VIDEO_PRESTREAM";
+
+constexpr AVRational kMicrosecondsTimeBase = {1, 1000000};
+
+std::string AvErrorToString(int error) {
+  char buf[AV_ERROR_MAX_STRING_SIZE];
+  if (av_strerror(error, buf, sizeof(buf)) == 0) {
+    return absl::StrCat("AVERROR(", error, ") - ", buf);
+  }
+  return absl::StrCat("Unknown AVERROR number ", error);
+}
+
+// Selects the hardware pixel format that the decoder was set up for, which is
+// pointed to by the codec context's opaque field, or falls back to software
+// decoding if the decoder doesn't offer it for the stream.
+AVPixelFormat GetHwPixelFormat(AVCodecContext* codec_ctx,
+                               const AVPixelFormat* pixel_formats) {
+  const AVPixelFormat hw_pixel_format =
+      *static_cast<const AVPixelFormat*>(codec_ctx->opaque);
+  for (const AVPixelFormat* p = pixel_formats; *p != AV_PIX_FMT_NONE; ++p) {
+    if (*p == hw_pixel_format) {
+      return *p;
+    }
+  }
+  ABSL_LOG(WARNING) << "Hardware decoding is not available for the video, "
+                       "decoding in software.";
+  return avcodec_default_get_format(codec_ctx, pixel_formats);
+}
+
+// Wraps the planes of a decoded frame in a YUVImage without copying them. The
+// YUVImage holds a reference to the frame buffers.
+absl::StatusOr<std::unique_ptr<YUVImage>> WrapYuvImage(const AVFrame& frame) {
+  libyuv::FourCC fourcc;
+  switch (frame.format) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+      fourcc = libyuv::FOURCC_I420;
+      break;
+    case AV_PIX_FMT_NV12:
+      fourcc = libyuv::FOURCC_NV12;
+      break;
+    default:
+      return absl::UnimplementedError(absl::StrCat(
+          "Unsupported pixel format of the decoded video: ",
+          av_get_pix_fmt_name(static_cast<AVPixelFormat>(frame.format))));
+  }
+  AVFrame* frame_ref = av_frame_clone(&frame);
+  RET_CHECK(frame_ref != nullptr) << "Fail to reference the decoded frame.";
+  auto yuv_image = std::make_unique<YUVImage>();
+  yuv_image->Initialize(
+      fourcc, [frame_ref]() mutable { av_frame_free(&frame_ref); },
+      frame_ref->data[0], frame_ref->linesize[0],  //
+      frame_ref->data[1], frame_ref->linesize[1],  //
+      frame_ref->data[2], frame_ref->linesize[2],  //
+      frame_ref->width, frame_ref->height);
+  return yuv_image;
+}
+
+}  // namespace
+
+// Decodes the video stream of a file with FFmpeg. Compared to
+// OpenCvVideoDecoderCalculator, it can decode on hardware, decode with
+// several threads, seek to a time range of the file, and skip the conversion
+// of frames that are not needed.
+//
+// Decoding runs in software unless hw_device_type is set in the options, in
+// which case the frames are decoded on the device and transferred back to
+// memory. The decoded 8-bit 4:2:0 frames are output without copying as
+// YUVImage or as GpuBuffer, or converted to SRGB ImageFrame. At least one of
+// the video output streams must be connected.
+//
+// Output Streams:
+//   VIDEO: Optional output video frames (ImageFrame in SRGB format).
+//   YUV_IMAGE: Optional output video frames (YUVImage in I420 or NV12 format,
+//       as decoded).
+//   GPU_BUFFER: Optional output video frames (GpuBuffer backed by the YUVImage
+//       of the frame).
+//   VIDEO_PRESTREAM:
+//       Optional video header information output at
+//       Timestamp::PreStream() for the corresponding stream. The frame rate
+//       is divided by frame_stride.
+// Input Side Packets:
+//   INPUT_FILE_PATH: The input file path.
+//   OPTIONS: Optional FfmpegVideoDecoderCalculatorOptions that are merged
+//       into the node options, e.g. to set the time range per file.
+//
+// Example config:
+// node {
+//   calculator: "FfmpegVideoDecoderCalculator"
+//   input_side_packet: "INPUT_FILE_PATH:input_file_path"
+//   output_stream: "VIDEO:video_frames"
+//   output_stream: "VIDEO_PRESTREAM:video_header"
+//   options {
+//     [mediapipe.FfmpegVideoDecoderCalculatorOptions.ext] {
+//       hw_device_type: "vaapi"
+//       start_time: 10
+//       end_time: 20
+//       frame_stride: 5
+//     }
+//   }
+// }
+class FfmpegVideoDecoderCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->InputSidePackets().Tag(kInputFilePathTag).Set<std::string>();
+    if (cc->InputSidePackets().HasTag(kOptionsTag)) {
+      cc->InputSidePackets()
+          .Tag(kOptionsTag)
+          .Set<FfmpegVideoDecoderCalculatorOptions>();
+    }
+    RET_CHECK(cc->Outputs().HasTag(kVideoTag) ||
+              cc->Outputs().HasTag(kYuvImageTag) ||
+              cc->Outputs().HasTag(kGpuBufferTag))
+        << "At least one of VIDEO, YUV_IMAGE and GPU_BUFFER must be output.";
+    if (cc->Outputs().HasTag(kVideoTag)) {
+      cc->Outputs().Tag(kVideoTag).Set<ImageFrame>();
+    }
+    if (cc->Outputs().HasTag(kYuvImageTag)) {
+      cc->Outputs().Tag(kYuvImageTag).Set<YUVImage>();
+    }
+    if (cc->Outputs().HasTag(kGpuBufferTag)) {
+      cc->Outputs().Tag(kGpuBufferTag).Set<GpuBuffer>();
+    }
+    if (cc->Outputs().HasTag(kVideoPrestreamTag)) {
+      cc->Outputs().Tag(kVideoPrestreamTag).Set<VideoHeader>();
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    const std::string& input_file_path =
+        cc->InputSidePackets().Tag(kInputFilePathTag).Get<std::string>();
+    const auto options = tool::RetrieveOptions(
+        cc->Options<FfmpegVideoDecoderCalculatorOptions>(),
+        cc->InputSidePackets(), kOptionsTag);
+    RET_CHECK_GT(options.frame_stride(), 0);
+    frame_stride_ = options.frame_stride();
+
+    int error =
+        avformat_open_input(&format_ctx_, input_file_path.c_str(),
+                            /*fmt=*/nullptr, /*options=*/nullptr);
+    if (error < 0) {
+      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+             << "Fail to open video file at " << input_file_path << ": "
+             << AvErrorToString(error);
+    }
+    error = avformat_find_stream_info(format_ctx_, /*options=*/nullptr);
+    if (error < 0) {
+      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+             << "Fail to read the streams of the video file at "
+             << input_file_path << ": " << AvErrorToString(error);
+    }
+    stream_index_ = av_find_best_stream(format_ctx_, AVMEDIA_TYPE_VIDEO,
+                                        /*wanted_stream_nb=*/-1,
+                                        /*related_stream=*/-1,
+                                        /*decoder_ret=*/nullptr, /*flags=*/0);
+    if (stream_index_ < 0) {
+      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+             << "Fail to find a video stream in the video file at "
+             << input_file_path << ": " << AvErrorToString(stream_index_);
+    }
+    const AVStream* stream = format_ctx_->streams[stream_index_];
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (codec == nullptr) {
+      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+             << "No decoder for the video stream of the video file at "
+             << input_file_path;
+    }
+    time_base_ = stream->time_base;
+    stream_start_pts_ =
+        stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+
+    codec_ctx_ = avcodec_alloc_context3(codec);
+    RET_CHECK(codec_ctx_ != nullptr);
+    error = avcodec_parameters_to_context(codec_ctx_, stream->codecpar);
+    RET_CHECK_GE(error, 0) << AvErrorToString(error);
+    codec_ctx_->thread_count = options.num_threads();
+    codec_ctx_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    if (options.skip_non_reference_frames()) {
+      codec_ctx_->skip_frame = AVDISCARD_NONREF;
+    }
+    if (options.has_hw_device_type()) {
+      MP_RETURN_IF_ERROR(SetUpHwDecoding(*codec, options));
+    }
+    error = avcodec_open2(codec_ctx_, codec, /*options=*/nullptr);
+    if (error < 0) {
+      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+             << "Fail to open the " << codec->name << " decoder: "
+             << AvErrorToString(error);
+    }
+
+    packet_ = av_packet_alloc();
+    frame_ = av_frame_alloc();
+    sw_frame_ = av_frame_alloc();
+    RET_CHECK(packet_ != nullptr && frame_ != nullptr && sw_frame_ != nullptr);
+
+    if (options.has_start_time() && options.start_time() > 0) {
+      start_time_ = Timestamp::FromSeconds(options.start_time());
+      // Seeks to the keyframe at or before the start time. The frames between
+      // the keyframe and the start time are decoded but not output.
+      error = av_seek_frame(
+          format_ctx_, stream_index_,
+          stream_start_pts_ + av_rescale_q(start_time_.Value(),
+                                           kMicrosecondsTimeBase, time_base_),
+          AVSEEK_FLAG_BACKWARD);
+      if (error < 0) {
+        ABSL_LOG(WARNING) << "Fail to seek the video file at "
+                          << input_file_path << ", decoding it from the "
+                          << "beginning: " << AvErrorToString(error);
+      }
+    }
+    if (options.has_end_time()) {
+      end_time_ = Timestamp::FromSeconds(options.end_time());
+    }
+
+    if (cc->Outputs().HasTag(kVideoPrestreamTag)) {
+      const double fps = av_q2d(stream->avg_frame_rate);
+      if (fps <= 0 || codec_ctx_->width <= 0 || codec_ctx_->height <= 0) {
+        return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+               << "Fail to make video header due to the incorrect metadata "
+                  "from the video file at "
+               << input_file_path;
+      }
+      auto header = std::make_unique<VideoHeader>();
+      header->format = cc->Outputs().HasTag(kVideoTag)
+                           ? ImageFormat::FORMAT_SRGB
+                           : ImageFormat::FORMAT_YCBCR420P;
+      header->width = codec_ctx_->width;
+      header->height = codec_ctx_->height;
+      header->frame_rate = fps / frame_stride_;
+      header->duration = stream->duration != AV_NOPTS_VALUE
+                             ? stream->duration * av_q2d(time_base_)
+                             : format_ctx_->duration /
+                                   static_cast<double>(AV_TIME_BASE);
+      cc->Outputs()
+          .Tag(kVideoPrestreamTag)
+          .Add(header.release(), Timestamp::PreStream());
+      cc->Outputs().Tag(kVideoPrestreamTag).Close();
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    // Receives decoded frames until one is output, and sends the decoder a
+    // packet whenever it needs more input.
+    while (true) {
+      const int error = avcodec_receive_frame(codec_ctx_, frame_);
+      if (error == AVERROR_EOF) {
+        return tool::StatusStop();
+      }
+      if (error == AVERROR(EAGAIN)) {
+        MP_RETURN_IF_ERROR(SendNextPacket());
+        continue;
+      }
+      if (error < 0) {
+        return absl::UnknownError(absl::StrCat("Fail to decode a frame: ",
+                                               AvErrorToString(error)));
+      }
+      bool end_reached = false;
+      bool output = false;
+      const absl::Status status = ProcessFrame(cc, &end_reached, &output);
+      av_frame_unref(frame_);
+      MP_RETURN_IF_ERROR(status);
+      if (end_reached) {
+        return tool::StatusStop();
+      }
+      if (output) {
+        return absl::OkStatus();
+      }
+    }
+  }
+
+  absl::Status Close(CalculatorContext* cc) override {
+    av_frame_free(&sw_frame_);
+    av_frame_free(&frame_);
+    av_packet_free(&packet_);
+    avcodec_free_context(&codec_ctx_);
+    av_buffer_unref(&hw_device_ctx_);
+    avformat_close_input(&format_ctx_);
+    return absl::OkStatus();
+  }
+
+ private:
+  // Sets the decoder up to decode on the hardware device of the options.
+  // Falls back to software decoding if the device can't be opened, or if the
+  // codec can't decode on the device type.
+  absl::Status SetUpHwDecoding(
+      const AVCodec& codec,
+      const FfmpegVideoDecoderCalculatorOptions& options) {
+    const AVHWDeviceType device_type =
+        av_hwdevice_find_type_by_name(options.hw_device_type().c_str());
+    if (device_type == AV_HWDEVICE_TYPE_NONE) {
+      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+             << "Unknown hardware device type: " << options.hw_device_type();
+    }
+    for (int i = 0;; ++i) {
+      const AVCodecHWConfig* config = avcodec_get_hw_config(&codec, i);
+      if (config == nullptr) {
+        ABSL_LOG(WARNING) << "The " << codec.name << " decoder doesn't "
+                          << "support " << options.hw_device_type()
+                          << ", decoding in software.";
+        return absl::OkStatus();
+      }
+      if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) &&
+          config->device_type == device_type) {
+        hw_pixel_format_ = config->pix_fmt;
+        break;
+      }
+    }
+    const int error = av_hwdevice_ctx_create(
+        &hw_device_ctx_, device_type,
+        options.has_hw_device() ? options.hw_device().c_str() : nullptr,
+        /*opts=*/nullptr, /*flags=*/0);
+    if (error < 0) {
+      ABSL_LOG(WARNING) << "Fail to open the " << options.hw_device_type()
+                        << " device, decoding in software: "
+                        << AvErrorToString(error);
+      hw_pixel_format_ = AV_PIX_FMT_NONE;
+      return absl::OkStatus();
+    }
+    codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx_);
+    codec_ctx_->opaque = &hw_pixel_format_;
+    codec_ctx_->get_format = GetHwPixelFormat;
+    return absl::OkStatus();
+  }
+
+  // Sends the next packet of the video stream to the decoder, or the flush
+  // packet at the end of the file.
+  absl::Status SendNextPacket() {
+    while (true) {
+      const int error = av_read_frame(format_ctx_, packet_);
+      if (error == AVERROR_EOF) {
+        avcodec_send_packet(codec_ctx_, /*avpkt=*/nullptr);
+        return absl::OkStatus();
+      }
+      if (error < 0) {
+        return absl::UnknownError(absl::StrCat("Fail to read a packet: ",
+                                               AvErrorToString(error)));
+      }
+      if (packet_->stream_index != stream_index_) {
+        av_packet_unref(packet_);
+        continue;
+      }
+      const int send_error = avcodec_send_packet(codec_ctx_, packet_);
+      av_packet_unref(packet_);
+      if (send_error < 0) {
+        return absl::UnknownError(absl::StrCat("Fail to send a packet: ",
+                                               AvErrorToString(send_error)));
+      }
+      return absl::OkStatus();
+    }
+  }
+
+  // Outputs the decoded frame if it is in the time range, on the frame
+  // stride, and after the previous frame. Sets `end_reached` once a frame is
+  // after the time range.
+  absl::Status ProcessFrame(CalculatorContext* cc, bool* end_reached,
+                            bool* output) {
+    const int64_t pts = frame_->best_effort_timestamp;
+    if (pts == AV_NOPTS_VALUE) {
+      ABSL_LOG(WARNING) << "Skipping a decoded frame without a timestamp.";
+      return absl::OkStatus();
+    }
+    // Use microsecond as the unit of time.
+    const Timestamp timestamp(
+        av_rescale_q(pts - stream_start_pts_, time_base_,
+                     kMicrosecondsTimeBase));
+    if (timestamp < start_time_) {
+      return absl::OkStatus();
+    }
+    if (end_time_ != Timestamp::Unset() && timestamp > end_time_) {
+      *end_reached = true;
+      return absl::OkStatus();
+    }
+    // If the timestamp of the current frame is not greater than the one of the
+    // previous frame, the new frame will be discarded.
+    if (timestamp <= prev_timestamp_) {
+      return absl::OkStatus();
+    }
+    if (num_frames_in_range_++ % frame_stride_ != 0) {
+      return absl::OkStatus();
+    }
+
+    const AVFrame* decoded_frame = frame_;
+    if (hw_pixel_format_ != AV_PIX_FMT_NONE &&
+        frame_->format == hw_pixel_format_) {
+      av_frame_unref(sw_frame_);
+      const int error =
+          av_hwframe_transfer_data(sw_frame_, frame_, /*flags=*/0);
+      if (error < 0) {
+        return absl::UnknownError(
+            absl::StrCat("Fail to transfer a frame from the hardware device: ",
+                         AvErrorToString(error)));
+      }
+      decoded_frame = sw_frame_;
+    }
+
+    if (cc->Outputs().HasTag(kVideoTag)) {
+      ASSIGN_OR_RETURN(std::unique_ptr<YUVImage> yuv_image,
+                       WrapYuvImage(*decoded_frame));
+      auto image_frame = std::make_unique<ImageFrame>();
+      image_frame_util::YUVImageToImageFrameFromFormat(*yuv_image,
+                                                       image_frame.get());
+      cc->Outputs().Tag(kVideoTag).Add(image_frame.release(), timestamp);
+    }
+    if (cc->Outputs().HasTag(kYuvImageTag)) {
+      ASSIGN_OR_RETURN(std::unique_ptr<YUVImage> yuv_image,
+                       WrapYuvImage(*decoded_frame));
+      cc->Outputs().Tag(kYuvImageTag).Add(yuv_image.release(), timestamp);
+    }
+    if (cc->Outputs().HasTag(kGpuBufferTag)) {
+      ASSIGN_OR_RETURN(std::unique_ptr<YUVImage> yuv_image,
+                       WrapYuvImage(*decoded_frame));
+      auto gpu_buffer = std::make_unique<GpuBuffer>(
+          std::make_shared<GpuBufferStorageYuvImage>(
+              std::shared_ptr<YUVImage>(std::move(yuv_image))));
+      cc->Outputs().Tag(kGpuBufferTag).Add(gpu_buffer.release(), timestamp);
+    }
+    prev_timestamp_ = timestamp;
+    *output = true;
+    return absl::OkStatus();
+  }
+
+  AVFormatContext* format_ctx_ = nullptr;
+  AVCodecContext* codec_ctx_ = nullptr;
+  AVBufferRef* hw_device_ctx_ = nullptr;
+  AVPacket* packet_ = nullptr;
+  AVFrame* frame_ = nullptr;
+  // The frame transferred from the hardware device.
+  AVFrame* sw_frame_ = nullptr;
+  AVPixelFormat hw_pixel_format_ = AV_PIX_FMT_NONE;
+  int stream_index_ = -1;
+  AVRational time_base_ = {0, 1};
+  int64_t stream_start_pts_ = 0;
+  Timestamp start_time_ = Timestamp::Min();
+  Timestamp end_time_ = Timestamp::Unset();
+  int frame_stride_ = 1;
+  int64_t num_frames_in_range_ = 0;
+  Timestamp prev_timestamp_ = Timestamp::Unset();
+};
+
+REGISTER_CALCULATOR(FfmpegVideoDecoderCalculator);
+}  // namespace mediapipe
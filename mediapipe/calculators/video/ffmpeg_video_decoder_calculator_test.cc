@@ -0,0 +1,160 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+
+#include "libyuv/video_common.h"
+#include "mediapipe/calculators/video/ffmpeg_video_decoder_calculator.pb.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_opencv.h"
+#include "mediapipe/framework/formats/video_stream_header.h"
+#include "mediapipe/framework/formats/yuv_image.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/test_util.h"
+
+namespace mediapipe {
+
+namespace {
+
+constexpr char kVideoTag[] = "VIDEO";
+constexpr char kYuvImageTag[] = "YUV_IMAGE";
+constexpr char kVideoPrestreamTag[] = "VIDEO_PRESTREAM";
+constexpr char kInputFilePathTag[] = "INPUT_FILE_PATH";
+constexpr char kTestPackageRoot[] = "mediapipe/calculators/video";
+
+std::string TestVideoPath() {
+  return file::JoinPath(GetTestDataDir(kTestPackageRoot),
+                        "format_MP4_AVC720P_AAC.video");
+}
+
+TEST(FfmpegVideoDecoderCalculatorTest, TestMp4Avc720pVideo) {
+  CalculatorGraphConfig::Node node_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "FfmpegVideoDecoderCalculator"
+        input_side_packet: "INPUT_FILE_PATH:input_file_path"
+        output_stream: "VIDEO:video"
+        output_stream: "VIDEO_PRESTREAM:video_prestream")pb");
+  CalculatorRunner runner(node_config);
+  runner.MutableSidePackets()->Tag(kInputFilePathTag) =
+      MakePacket<std::string>(TestVideoPath());
+  MP_EXPECT_OK(runner.Run());
+
+  ASSERT_EQ(runner.Outputs().Tag(kVideoPrestreamTag).packets.size(), 1);
+  const VideoHeader& header =
+      runner.Outputs().Tag(kVideoPrestreamTag).packets[0].Get<VideoHeader>();
+  EXPECT_EQ(ImageFormat::FORMAT_SRGB, header.format);
+  EXPECT_EQ(1280, header.width);
+  EXPECT_EQ(640, header.height);
+  EXPECT_FLOAT_EQ(30.0f, header.frame_rate);
+  const auto& packets = runner.Outputs().Tag(kVideoTag).packets;
+  EXPECT_EQ(180, packets.size());
+  for (int i = 0; i < packets.size(); ++i) {
+    cv::Mat output_mat = formats::MatView(&(packets[i].Get<ImageFrame>()));
+    EXPECT_EQ(1280, output_mat.size().width);
+    EXPECT_EQ(640, output_mat.size().height);
+    EXPECT_EQ(3, output_mat.channels());
+    cv::Scalar s = cv::mean(output_mat);
+    for (int c = 0; c < 3; ++c) {
+      EXPECT_GT(s[c], 0);
+      EXPECT_LT(s[c], 255);
+    }
+    if (i > 0) {
+      EXPECT_GT(packets[i].Timestamp(), packets[i - 1].Timestamp());
+    }
+  }
+}
+
+TEST(FfmpegVideoDecoderCalculatorTest, OutputsYuvImages) {
+  CalculatorGraphConfig::Node node_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "FfmpegVideoDecoderCalculator"
+        input_side_packet: "INPUT_FILE_PATH:input_file_path"
+        output_stream: "YUV_IMAGE:yuv_image")pb");
+  CalculatorRunner runner(node_config);
+  runner.MutableSidePackets()->Tag(kInputFilePathTag) =
+      MakePacket<std::string>(TestVideoPath());
+  MP_EXPECT_OK(runner.Run());
+
+  const auto& packets = runner.Outputs().Tag(kYuvImageTag).packets;
+  EXPECT_EQ(180, packets.size());
+  for (const Packet& packet : packets) {
+    const YUVImage& yuv_image = packet.Get<YUVImage>();
+    EXPECT_EQ(libyuv::FOURCC_I420, yuv_image.fourcc());
+    EXPECT_EQ(1280, yuv_image.width());
+    EXPECT_EQ(640, yuv_image.height());
+  }
+}
+
+TEST(FfmpegVideoDecoderCalculatorTest, DecodesTimeRangeWithFrameStride) {
+  CalculatorGraphConfig::Node node_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "FfmpegVideoDecoderCalculator"
+        input_side_packet: "INPUT_FILE_PATH:input_file_path"
+        output_stream: "VIDEO:video"
+        output_stream: "VIDEO_PRESTREAM:video_prestream"
+        options {
+          [mediapipe.FfmpegVideoDecoderCalculatorOptions.ext] {
+            start_time: 2
+            end_time: 4
+            frame_stride: 3
+          }
+        })pb");
+  CalculatorRunner runner(node_config);
+  runner.MutableSidePackets()->Tag(kInputFilePathTag) =
+      MakePacket<std::string>(TestVideoPath());
+  MP_EXPECT_OK(runner.Run());
+
+  const VideoHeader& header =
+      runner.Outputs().Tag(kVideoPrestreamTag).packets[0].Get<VideoHeader>();
+  EXPECT_FLOAT_EQ(10.0f, header.frame_rate);
+  // The 61 frames from 2 to 4 seconds at 30 fps, every 3rd of them.
+  const auto& packets = runner.Outputs().Tag(kVideoTag).packets;
+  EXPECT_EQ(21, packets.size());
+  for (const Packet& packet : packets) {
+    EXPECT_GE(packet.Timestamp(), Timestamp::FromSeconds(2));
+    EXPECT_LE(packet.Timestamp(), Timestamp::FromSeconds(4));
+  }
+}
+
+TEST(FfmpegVideoDecoderCalculatorTest, TimeRangeFromSidePacket) {
+  CalculatorGraphConfig::Node node_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig::Node>(R"pb(
+        calculator: "FfmpegVideoDecoderCalculator"
+        input_side_packet: "INPUT_FILE_PATH:input_file_path"
+        input_side_packet: "OPTIONS:options"
+        output_stream: "VIDEO:video")pb");
+  CalculatorRunner runner(node_config);
+  runner.MutableSidePackets()->Tag(kInputFilePathTag) =
+      MakePacket<std::string>(TestVideoPath());
+  runner.MutableSidePackets()->Tag("OPTIONS") =
+      MakePacket<FfmpegVideoDecoderCalculatorOptions>(
+          ParseTextProtoOrDie<FfmpegVideoDecoderCalculatorOptions>(
+              "start_time: 5"));
+  MP_EXPECT_OK(runner.Run());
+
+  const auto& packets = runner.Outputs().Tag(kVideoTag).packets;
+  ASSERT_FALSE(packets.empty());
+  EXPECT_GE(packets.front().Timestamp(), Timestamp::FromSeconds(5));
+  EXPECT_LE(packets.size(), 30);
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -25,6 +25,7 @@
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/util/tracking/camera_motion.pb.h"
+#include "mediapipe/util/tracking/compact_tracking_data.h"
 #include "mediapipe/util/tracking/flow_packager.h"
 #include "mediapipe/util/tracking/region_flow.pb.h"
 
@@ -249,7 +250,12 @@ void FlowPackagerCalculator::WriteChunk(const TrackingDataChunk& chunk) const {
   }
 
   std::string data;
-  chunk.SerializeToString(&data);
+  if (options_.compact_cache_files()) {
+    EncodeCompactTrackingDataChunk(chunk, options_.compact_cache_vector_step(),
+                                   &data);
+  } else {
+    chunk.SerializeToString(&data);
+  }
 
   const char* temp_filename = tempnam(cache_dir_.c_str(), nullptr);
   std::ofstream out_file(temp_filename);
@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "mediapipe/calculators/video/flow_to_image_calculator.pb.h"
@@ -32,14 +33,55 @@
 #include "mediapipe/framework/formats/motion/optical_flow_field.h"
 #include "mediapipe/framework/port/opencv_core_inc.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/ret_check.h"
+
+#if !MEDIAPIPE_DISABLE_GPU
+#include "mediapipe/gpu/gl_calculator_helper.h"
+#include "mediapipe/gpu/gl_simple_shaders.h"
+#include "mediapipe/gpu/gpu_buffer.h"
+#include "mediapipe/gpu/shader_util.h"
+#endif  // !MEDIAPIPE_DISABLE_GPU
 
 namespace mediapipe {
 
+namespace {
+
+constexpr char kFlowGpuTag[] = "FLOW_GPU";
+constexpr char kImageGpuTag[] = "IMAGE_GPU";
+
+#if !MEDIAPIPE_DISABLE_GPU
+enum { ATTRIB_VERTEX, ATTRIB_TEXTURE_POSITION, NUM_ATTRIBUTES };
+
+// Quantizes the flow like FlowQuantizerModel::Apply, which truncates.
+constexpr char kFlowToImageShaderSource[] = R"(
+  DEFAULT_PRECISION(highp, float)
+  DEFAULT_PRECISION(highp, sampler2D)
+
+  in vec2 sample_coordinate;
+  uniform sampler2D flow;
+  uniform vec2 min_value;
+  uniform vec2 inv_range;
+
+  void main() {
+    vec2 value = texture2D(flow, sample_coordinate).xy;
+    vec2 normalized = clamp((value - min_value) * inv_range, 0.0, 1.0);
+    gl_FragColor = vec4(floor(normalized * 255.0) / 255.0, 0.0, 1.0);
+  }
+)";
+#endif  // !MEDIAPIPE_DISABLE_GPU
+
+}  // namespace
+
 // Reads optical flow fields defined in
 // mediapipe/framework/formats/motion/optical_flow_field.h,
 // returns a VideoFrame with 2 channels (v_x and v_y), each channel is quantized
 // to 0-255.
 //
+// Alternatively, reads the flow on the GPU from a FLOW_GPU GpuBuffer in
+// kTwoComponentFloat32 format, e.g. from Tvl1OpticalFlowGpuCalculator, and
+// outputs the quantized flow as an IMAGE_GPU GpuBuffer in the R and G
+// channels, without reading the flow back to the CPU.
+//
 // Example config:
 // node {
 //   calculator: "FlowToImageCalculator"
@@ -59,14 +101,37 @@ class FlowToImageCalculator : public CalculatorBase {
   static absl::Status GetContract(CalculatorContract* cc);
   absl::Status Open(CalculatorContext* cc) override;
   absl::Status Process(CalculatorContext* cc) override;
+  absl::Status Close(CalculatorContext* cc) override;
 
  private:
+  absl::Status RenderGpu(CalculatorContext* cc);
+  absl::Status GlSetup(CalculatorContext* cc);
+
   FlowQuantizerModel model_;
+  bool use_gpu_ = false;
+#if !MEDIAPIPE_DISABLE_GPU
+  GlCalculatorHelper gpu_helper_;
+  GLuint program_ = 0;
+  GLuint vao_ = 0;
+  GLuint vbo_[2] = {0, 0};
+#endif  // !MEDIAPIPE_DISABLE_GPU
 };
 
 absl::Status FlowToImageCalculator::GetContract(CalculatorContract* cc) {
-  cc->Inputs().Index(0).Set<OpticalFlowField>();
-  cc->Outputs().Index(0).Set<ImageFrame>();
+  if (cc->Inputs().HasTag(kFlowGpuTag)) {
+#if !MEDIAPIPE_DISABLE_GPU
+    RET_CHECK(cc->Outputs().HasTag(kImageGpuTag))
+        << "FLOW_GPU input requires IMAGE_GPU output.";
+    cc->Inputs().Tag(kFlowGpuTag).Set<GpuBuffer>();
+    cc->Outputs().Tag(kImageGpuTag).Set<GpuBuffer>();
+    MP_RETURN_IF_ERROR(GlCalculatorHelper::UpdateContract(cc));
+#else
+    return absl::InternalError("GPU processing is disabled.");
+#endif  // !MEDIAPIPE_DISABLE_GPU
+  } else {
+    cc->Inputs().Index(0).Set<OpticalFlowField>();
+    cc->Outputs().Index(0).Set<ImageFrame>();
+  }
 
   // Model sanity check
   const auto& options = cc->Options<FlowToImageCalculatorOptions>();
@@ -86,10 +151,20 @@ absl::Status FlowToImageCalculator::Open(CalculatorContext* cc) {
                           options.min_value(), options.min_value(),
                           options.max_value(), options.max_value()));
   model_.LoadFromProto(model_data);
+
+  use_gpu_ = cc->Inputs().HasTag(kFlowGpuTag);
+#if !MEDIAPIPE_DISABLE_GPU
+  if (use_gpu_) {
+    MP_RETURN_IF_ERROR(gpu_helper_.Open(cc));
+  }
+#endif  // !MEDIAPIPE_DISABLE_GPU
   return absl::OkStatus();
 }
 
 absl::Status FlowToImageCalculator::Process(CalculatorContext* cc) {
+  if (use_gpu_) {
+    return RenderGpu(cc);
+  }
   const auto& input = cc->Inputs().Index(0).Get<OpticalFlowField>();
   // Input flow is 2-channel with x-dim flow and y-dim flow.
   // Convert it to a ImageFrame in SRGB space, the 3rd channel is not used (0).
@@ -109,6 +184,100 @@ absl::Status FlowToImageCalculator::Process(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+absl::Status FlowToImageCalculator::Close(CalculatorContext* cc) {
+#if !MEDIAPIPE_DISABLE_GPU
+  if (use_gpu_) {
+    gpu_helper_.RunInGlContext([this] {
+      if (program_) glDeleteProgram(program_);
+      if (vao_) glDeleteVertexArrays(1, &vao_);
+      if (vbo_[0]) glDeleteBuffers(2, vbo_);
+      program_ = 0;
+      vao_ = 0;
+      vbo_[0] = vbo_[1] = 0;
+    });
+  }
+#endif  // !MEDIAPIPE_DISABLE_GPU
+  return absl::OkStatus();
+}
+
+absl::Status FlowToImageCalculator::RenderGpu(CalculatorContext* cc) {
+#if !MEDIAPIPE_DISABLE_GPU
+  return gpu_helper_.RunInGlContext([this, cc]() -> absl::Status {
+    if (!program_) {
+      MP_RETURN_IF_ERROR(GlSetup(cc));
+    }
+    const auto& input = cc->Inputs().Tag(kFlowGpuTag).Get<GpuBuffer>();
+    RET_CHECK(input.format() == GpuBufferFormat::kTwoComponentFloat32)
+        << "FLOW_GPU must be in kTwoComponentFloat32 format.";
+    auto flow_texture = gpu_helper_.CreateSourceTexture(input);
+    auto output_texture =
+        gpu_helper_.CreateDestinationTexture(input.width(), input.height());
+
+    gpu_helper_.BindFramebuffer(output_texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(flow_texture.target(), flow_texture.name());
+    glUseProgram(program_);
+    glBindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(flow_texture.target(), 0);
+    glFlush();
+
+    cc->Outputs()
+        .Tag(kImageGpuTag)
+        .Add(output_texture.GetFrame<GpuBuffer>().release(),
+             cc->InputTimestamp());
+    return absl::OkStatus();
+  });
+#else
+  return absl::InternalError("GPU processing is disabled.");
+#endif  // !MEDIAPIPE_DISABLE_GPU
+}
+
+absl::Status FlowToImageCalculator::GlSetup(CalculatorContext* cc) {
+#if !MEDIAPIPE_DISABLE_GPU
+  const GLint attr_location[NUM_ATTRIBUTES] = {
+      ATTRIB_VERTEX,
+      ATTRIB_TEXTURE_POSITION,
+  };
+  const GLchar* attr_name[NUM_ATTRIBUTES] = {
+      "position",
+      "texture_coordinate",
+  };
+  const std::string frag_src = absl::StrCat(
+      kMediaPipeFragmentShaderPreamble, kFlowToImageShaderSource);
+  GlhCreateProgram(kBasicVertexShader, frag_src.c_str(), NUM_ATTRIBUTES,
+                   &attr_name[0], attr_location, &program_);
+  RET_CHECK(program_) << "Problem initializing the program.";
+
+  const auto& options = cc->Options<FlowToImageCalculatorOptions>();
+  const float inv_range = 1.0f / (options.max_value() - options.min_value());
+  glUseProgram(program_);
+  glUniform1i(glGetUniformLocation(program_, "flow"), 1);
+  glUniform2f(glGetUniformLocation(program_, "min_value"), options.min_value(),
+              options.min_value());
+  glUniform2f(glGetUniformLocation(program_, "inv_range"), inv_range,
+              inv_range);
+
+  glGenVertexArrays(1, &vao_);
+  glBindVertexArray(vao_);
+  glGenBuffers(2, vbo_);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(kBasicSquareVertices),
+               kBasicSquareVertices, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(ATTRIB_VERTEX);
+  glVertexAttribPointer(ATTRIB_VERTEX, 2, GL_FLOAT, 0, 0, nullptr);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_[1]);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(kBasicTextureVertices),
+               kBasicTextureVertices, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(ATTRIB_TEXTURE_POSITION);
+  glVertexAttribPointer(ATTRIB_TEXTURE_POSITION, 2, GL_FLOAT, 0, 0, nullptr);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+#endif  // !MEDIAPIPE_DISABLE_GPU
+  return absl::OkStatus();
+}
+
 REGISTER_CALCULATOR(FlowToImageCalculator);
 
 }  // namespace mediapipe
@@ -37,6 +37,7 @@
 #include "mediapipe/util/tracking/motion_analysis.h"
 #include "mediapipe/util/tracking/motion_estimation.h"
 #include "mediapipe/util/tracking/motion_models.h"
+#include "mediapipe/util/tracking/parallel_invoker.h"
 #include "mediapipe/util/tracking/region_flow.pb.h"
 
 namespace mediapipe {
@@ -121,6 +122,11 @@ class MotionAnalysisCalculator : public CalculatorBase {
   // Otherwise no-op. Set flush to true to force output of all buffered data.
   void OutputMotionAnalyzedFrames(bool flush, CalculatorContext* cc);
 
+  // Returns a scope running the parallel loops of the analysis on
+  // parallel_executor_, or nullptr if none is set.
+  std::unique_ptr<ScopedParallelInvokerExecutor> MakeParallelExecutorScope()
+      const;
+
   // Lazy init function to be called on Process.
   absl::Status InitOnProcess(InputStream* video_stream,
                              InputStream* selection_stream);
@@ -200,6 +206,10 @@ class MotionAnalysisCalculator : public CalculatorBase {
   std::unique_ptr<MotionAnalysis> motion_analysis_;
 
   std::unique_ptr<MixtureRowWeights> row_weights_;
+
+  // Graph executor running the parallel loops of the analysis, or nullptr to
+  // use the parallel invoker thread pool.
+  Executor* parallel_executor_ = nullptr;
 };
 
 REGISTER_CALCULATOR(MotionAnalysisCalculator);
@@ -323,6 +333,12 @@ absl::Status MotionAnalysisCalculator::Open(CalculatorContext* cc) {
     }
   }
 
+  if (options_.analysis_options().parallel_flow_segments() > 1) {
+    RET_CHECK(!grayscale_output_ && !hybrid_meta_analysis_)
+        << "GRAY_VIDEO_OUT and hybrid meta analysis are not supported with "
+        << "parallel flow segments.";
+  }
+
   if (csv_file_input_) {
     // Read from file and parse.
     const std::string filename =
@@ -370,6 +386,13 @@ absl::Status MotionAnalysisCalculator::Open(CalculatorContext* cc) {
     cc->SetOffset(TimestampDiff(0));
   }
 
+  if (options_.has_parallel_executor()) {
+    parallel_executor_ = cc->GetExecutor(options_.parallel_executor());
+    RET_CHECK(parallel_executor_ != nullptr)
+        << "No executor named \"" << options_.parallel_executor()
+        << "\" in the graph.";
+  }
+
   if (cc->InputSidePackets().HasTag(kDownsampleTag)) {
     options_.mutable_analysis_options()
         ->mutable_flow_options()
@@ -432,6 +455,9 @@ absl::Status MotionAnalysisCalculator::Process(CalculatorContext* cc) {
   // Checked on Open.
   ABSL_CHECK(video_stream || selection_stream);
 
+  std::unique_ptr<ScopedParallelInvokerExecutor> executor_scope =
+      MakeParallelExecutorScope();
+
   // Lazy init.
   if (frame_width_ < 0 || frame_height_ < 0) {
     MP_RETURN_IF_ERROR(InitOnProcess(video_stream, selection_stream));
@@ -601,6 +627,8 @@ absl::Status MotionAnalysisCalculator::Process(CalculatorContext* cc) {
 absl::Status MotionAnalysisCalculator::Close(CalculatorContext* cc) {
   // Guard against empty videos.
   if (motion_analysis_) {
+    std::unique_ptr<ScopedParallelInvokerExecutor> executor_scope =
+        MakeParallelExecutorScope();
     OutputMotionAnalyzedFrames(true, cc);
   }
   if (csv_file_input_) {
@@ -709,6 +737,15 @@ void MotionAnalysisCalculator::OutputMotionAnalyzedFrames(
   }
 }
 
+std::unique_ptr<ScopedParallelInvokerExecutor>
+MotionAnalysisCalculator::MakeParallelExecutorScope() const {
+  if (parallel_executor_ == nullptr) {
+    return nullptr;
+  }
+  return std::make_unique<ScopedParallelInvokerExecutor>(
+      parallel_executor_, options_.parallel_executor_max_concurrency());
+}
+
 absl::Status MotionAnalysisCalculator::InitOnProcess(
     InputStream* video_stream, InputStream* selection_stream) {
   if (video_stream) {
@@ -14,17 +14,27 @@
 
 #include <stdlib.h>
 
+#include <deque>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_log.h"
+#include "absl/status/status.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
+#include "libyuv/convert_argb.h"
+#include "libyuv/convert_from.h"
+#include "libyuv/video_common.h"
 #include "mediapipe/calculators/video/opencv_video_encoder_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 #include "mediapipe/framework/formats/video_stream_header.h"
+#include "mediapipe/framework/formats/yuv_image.h"
 #include "mediapipe/framework/port/file_helpers.h"
 #include "mediapipe/framework/port/opencv_highgui_inc.h"
 #include "mediapipe/framework/port/opencv_imgproc_inc.h"
@@ -41,11 +51,19 @@ constexpr char kAudioFilePathTag[] = "AUDIO_FILE_PATH";
 constexpr char kOutputFilePathTag[] = "OUTPUT_FILE_PATH";
 constexpr char kVideoPrestreamTag[] = "VIDEO_PRESTREAM";
 constexpr char kVideoTag[] = "VIDEO";
+constexpr char kYuvImageTag[] = "YUV_IMAGE";
 
 // Encodes the input video stream and produces a media file.
 // The media file can be output to the output_file_path specified as a side
-// packet. Currently, the calculator only supports one video stream (in
-// mediapipe::ImageFrame).
+// packet. Currently, the calculator only supports one video stream, either in
+// mediapipe::ImageFrame with tag "VIDEO", or in mediapipe::YUVImage (I420 or
+// NV12) with tag "YUV_IMAGE". YUV frames are converted to the BGR frames that
+// OpenCV encodes in a single pass, so producers of YUV frames don't need to
+// convert them to RGB first.
+//
+// If max_queued_frames is set in the options, the frames are converted and
+// encoded on a dedicated thread, and Process() blocks only while the queue of
+// frames is full. Set use_hw_acceleration to encode on a hardware encoder.
 //
 // Example config:
 // node {
@@ -57,6 +75,7 @@ constexpr char kVideoTag[] = "VIDEO";
 //     [type.googleapis.com/mediapipe.OpenCvVideoEncoderCalculatorOptions]: {
 //        codec: "avc1"
 //        video_format: "mp4"
+//        max_queued_frames: 8
 //     }
 //   }
 // }
@@ -89,15 +108,44 @@ class OpenCvVideoEncoderCalculator : public CalculatorBase {
 
  private:
   absl::Status SetUpVideoWriter(float frame_rate, int width, int height);
+  // Converts the frame of the packet to BGR and writes it.
+  absl::Status WriteFrame(const Packet& packet);
+  // Writes the queued frames until the queue is closed.
+  void EncodeQueuedFrames();
+  bool HasQueuedFramesOrClosed() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !frame_queue_.empty() || queue_closed_;
+  }
+  bool HasQueueRoomOrError() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return frame_queue_.size() < static_cast<size_t>(max_queued_frames_) ||
+           !encoder_status_.ok();
+  }
 
   std::string output_file_path_;
   int four_cc_;
+  bool use_hw_acceleration_ = false;
+  bool yuv_input_ = false;
   std::unique_ptr<cv::VideoWriter> writer_;
+  // The BGR frame passed to the writer, which is reused across frames.
+  cv::Mat bgr_frame_;
+
+  // The encoding thread, if max_queued_frames is positive.
+  int max_queued_frames_ = 0;
+  std::unique_ptr<std::thread> encoder_thread_;
+  absl::Mutex mutex_;
+  std::deque<Packet> frame_queue_ ABSL_GUARDED_BY(mutex_);
+  bool queue_closed_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status encoder_status_ ABSL_GUARDED_BY(mutex_);
 };
 
 absl::Status OpenCvVideoEncoderCalculator::GetContract(CalculatorContract* cc) {
-  RET_CHECK(cc->Inputs().HasTag(kVideoTag));
-  cc->Inputs().Tag(kVideoTag).Set<ImageFrame>();
+  RET_CHECK(cc->Inputs().HasTag(kVideoTag) !=
+            cc->Inputs().HasTag(kYuvImageTag))
+      << "Exactly one of VIDEO and YUV_IMAGE must be specified.";
+  if (cc->Inputs().HasTag(kVideoTag)) {
+    cc->Inputs().Tag(kVideoTag).Set<ImageFrame>();
+  } else {
+    cc->Inputs().Tag(kYuvImageTag).Set<YUVImage>();
+  }
   if (cc->Inputs().HasTag(kVideoPrestreamTag)) {
     cc->Inputs().Tag(kVideoPrestreamTag).Set<VideoHeader>();
   }
@@ -129,6 +177,10 @@ absl::Status OpenCvVideoEncoderCalculator::Open(CalculatorContext* cc) {
             splited_file_path[splited_file_path.size() - 1] ==
                 options.video_format())
       << "The output file path is invalid.";
+  RET_CHECK_GE(options.max_queued_frames(), 0);
+  max_queued_frames_ = options.max_queued_frames();
+  use_hw_acceleration_ = options.use_hw_acceleration();
+  yuv_input_ = cc->Inputs().HasTag(kYuvImageTag);
   // If the video header will be available, the video metadata will be fetched
   // from the video header directly. The calculator will receive the video
   // header packet at timestamp prestream.
@@ -146,40 +198,111 @@ absl::Status OpenCvVideoEncoderCalculator::Process(CalculatorContext* cc) {
                             video_header.height);
   }
 
-  const ImageFrame& image_frame =
-      cc->Inputs().Tag(kVideoTag).Value().Get<ImageFrame>();
+  const Packet& packet = yuv_input_ ? cc->Inputs().Tag(kYuvImageTag).Value()
+                                    : cc->Inputs().Tag(kVideoTag).Value();
+  if (!encoder_thread_) {
+    return WriteFrame(packet);
+  }
+  // Queues the packet, which keeps the frame alive without copying it.
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(
+      this, &OpenCvVideoEncoderCalculator::HasQueueRoomOrError));
+  MP_RETURN_IF_ERROR(encoder_status_);
+  frame_queue_.push_back(packet);
+  return absl::OkStatus();
+}
+
+absl::Status OpenCvVideoEncoderCalculator::WriteFrame(const Packet& packet) {
+  if (yuv_input_) {
+    const YUVImage& yuv_image = packet.Get<YUVImage>();
+    bgr_frame_.create(yuv_image.height(), yuv_image.width(), CV_8UC3);
+    const int bgr_stride = static_cast<int>(bgr_frame_.step);
+    // libyuv's RGB24 is BGR in memory.
+    int result;
+    switch (yuv_image.fourcc()) {
+      case libyuv::FOURCC_I420:
+        result = libyuv::I420ToRGB24(
+            yuv_image.data(0), yuv_image.stride(0), yuv_image.data(1),
+            yuv_image.stride(1), yuv_image.data(2), yuv_image.stride(2),
+            bgr_frame_.data, bgr_stride, yuv_image.width(), yuv_image.height());
+        break;
+      case libyuv::FOURCC_NV12:
+        result = libyuv::NV12ToRGB24(yuv_image.data(0), yuv_image.stride(0),
+                                     yuv_image.data(1), yuv_image.stride(1),
+                                     bgr_frame_.data, bgr_stride,
+                                     yuv_image.width(), yuv_image.height());
+        break;
+      default:
+        return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+               << "Unsupported YUVImage format: " << yuv_image.fourcc();
+    }
+    RET_CHECK_EQ(result, 0) << "Fail to convert the YUVImage at timestamp "
+                            << packet.Timestamp();
+    writer_->write(bgr_frame_);
+    return absl::OkStatus();
+  }
+
+  const ImageFrame& image_frame = packet.Get<ImageFrame>();
   ImageFormat::Format format = image_frame.Format();
-  cv::Mat frame;
+  cv::Mat frame = formats::MatView(&image_frame);
+  if (frame.empty()) {
+    return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+           << "Receive empty frame at timestamp " << packet.Timestamp()
+           << " in OpenCvVideoEncoderCalculator::Process()";
+  }
   if (format == ImageFormat::FORMAT_GRAY8) {
-    frame = formats::MatView(&image_frame);
-    if (frame.empty()) {
-      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
-             << "Receive empty frame at timestamp "
-             << cc->Inputs().Tag(kVideoTag).Value().Timestamp()
-             << " in OpenCvVideoEncoderCalculator::Process()";
-    }
+    writer_->write(frame);
+    return absl::OkStatus();
+  }
+  if (format == ImageFormat::FORMAT_SRGB) {
+    cv::cvtColor(frame, bgr_frame_, cv::COLOR_RGB2BGR);
+  } else if (format == ImageFormat::FORMAT_SRGBA) {
+    cv::cvtColor(frame, bgr_frame_, cv::COLOR_RGBA2BGR);
   } else {
-    cv::Mat tmp_frame = formats::MatView(&image_frame);
-    if (tmp_frame.empty()) {
-      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
-             << "Receive empty frame at timestamp "
-             << cc->Inputs().Tag(kVideoTag).Value().Timestamp()
-             << " in OpenCvVideoEncoderCalculator::Process()";
+    return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
+           << "Unsupported image format: " << format;
+  }
+  writer_->write(bgr_frame_);
+  return absl::OkStatus();
+}
+
+void OpenCvVideoEncoderCalculator::EncodeQueuedFrames() {
+  while (true) {
+    Packet packet;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          this, &OpenCvVideoEncoderCalculator::HasQueuedFramesOrClosed));
+      if (frame_queue_.empty()) {
+        return;
+      }
+      packet = std::move(frame_queue_.front());
+      frame_queue_.pop_front();
     }
-    if (format == ImageFormat::FORMAT_SRGB) {
-      cv::cvtColor(tmp_frame, frame, cv::COLOR_RGB2BGR);
-    } else if (format == ImageFormat::FORMAT_SRGBA) {
-      cv::cvtColor(tmp_frame, frame, cv::COLOR_RGBA2BGR);
-    } else {
-      return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
-             << "Unsupported image format: " << format;
+    absl::Status status = WriteFrame(packet);
+    if (!status.ok()) {
+      // Fails the next Process() or Close(), and drops the queued frames.
+      absl::MutexLock lock(&mutex_);
+      encoder_status_ = std::move(status);
+      frame_queue_.clear();
+      return;
     }
   }
-  writer_->write(frame);
-  return absl::OkStatus();
 }
 
 absl::Status OpenCvVideoEncoderCalculator::Close(CalculatorContext* cc) {
+  absl::Status encoder_status;
+  if (encoder_thread_) {
+    {
+      absl::MutexLock lock(&mutex_);
+      queue_closed_ = true;
+    }
+    // Waits for the queued frames to be written.
+    encoder_thread_->join();
+    encoder_thread_.reset();
+    absl::MutexLock lock(&mutex_);
+    encoder_status = encoder_status_;
+  }
   if (writer_ && writer_->isOpened()) {
     writer_->release();
   }
@@ -211,7 +334,7 @@ absl::Status OpenCvVideoEncoderCalculator::Close(CalculatorContext* cc) {
               "config.";
 #endif
   }
-  return absl::OkStatus();
+  return encoder_status;
 }
 
 absl::Status OpenCvVideoEncoderCalculator::SetUpVideoWriter(float frame_rate,
@@ -220,12 +343,31 @@ absl::Status OpenCvVideoEncoderCalculator::SetUpVideoWriter(float frame_rate,
   RET_CHECK(frame_rate > 0 && width > 0 && height > 0)
       << "Invalid video metadata: frame_rate=" << frame_rate
       << ", width=" << width << ", height=" << height;
-  writer_ = absl::make_unique<cv::VideoWriter>(
-      output_file_path_, four_cc_, frame_rate, cv::Size(width, height));
+  if (use_hw_acceleration_) {
+#if CV_VERSION_MAJOR * 10000 + CV_VERSION_MINOR * 100 + CV_VERSION_REVISION >= \
+    40502
+    writer_ = absl::make_unique<cv::VideoWriter>(
+        output_file_path_, cv::CAP_ANY, four_cc_, frame_rate,
+        cv::Size(width, height),
+        std::vector<int>{cv::VIDEOWRITER_PROP_HW_ACCELERATION,
+                         cv::VIDEO_ACCELERATION_ANY});
+#else
+    ABSL_LOG(WARNING) << "Hardware accelerated encoding requires OpenCV 4.5.2 "
+                         "or later, encoding in software.";
+#endif
+  }
+  if (!writer_) {
+    writer_ = absl::make_unique<cv::VideoWriter>(
+        output_file_path_, four_cc_, frame_rate, cv::Size(width, height));
+  }
   if (!writer_->isOpened()) {
     return mediapipe::InvalidArgumentErrorBuilder(MEDIAPIPE_LOC)
            << "Fail to open file at " << output_file_path_;
   }
+  if (max_queued_frames_ > 0) {
+    encoder_thread_ =
+        absl::make_unique<std::thread>([this] { EncodeQueuedFrames(); });
+  }
   return absl::OkStatus();
 }
 
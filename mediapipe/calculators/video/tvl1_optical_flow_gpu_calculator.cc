@@ -0,0 +1,667 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/calculators/video/tvl1_optical_flow_gpu_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/motion/optical_flow_field.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/gpu/gl_calculator_helper.h"
+#include "mediapipe/gpu/gl_simple_shaders.h"
+#include "mediapipe/gpu/gpu_buffer.h"
+#include "mediapipe/gpu/shader_util.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr char kFirstFrameTag[] = "FIRST_FRAME";
+constexpr char kSecondFrameTag[] = "SECOND_FRAME";
+constexpr char kForwardFlowTag[] = "FORWARD_FLOW";
+constexpr char kBackwardFlowTag[] = "BACKWARD_FLOW";
+constexpr char kForwardFlowGpuTag[] = "FORWARD_FLOW_GPU";
+constexpr char kBackwardFlowGpuTag[] = "BACKWARD_FLOW_GPU";
+
+// Pyramid levels with a smaller width or height are not used.
+constexpr int kMinPyramidSize = 16;
+
+enum { ATTRIB_VERTEX, ATTRIB_TEXTURE_POSITION, NUM_ATTRIBUTES };
+const GLint kAttribLocations[NUM_ATTRIBUTES] = {
+    ATTRIB_VERTEX,
+    ATTRIB_TEXTURE_POSITION,
+};
+const GLchar* kAttribNames[NUM_ATTRIBUTES] = {
+    "position",
+    "texture_coordinate",
+};
+
+// The shaders use texelFetch and textureSize, which need GLSL ES 3.0. On
+// desktop GL, kMediaPipeFragmentShaderPreamble declares GLSL 3.3.
+#ifdef GL_ES_VERSION_2_0
+constexpr char kVersionHeader[] = "#version 300 es\n";
+#else
+constexpr char kVersionHeader[] = "";
+#endif  // GL_ES_VERSION_2_0
+
+// Common declarations of all fragment shaders. The shaders address texels by
+// gl_FragCoord, so a texel of the render target corresponds to the texel at
+// the same position of a source texture of the same size. All textures store
+// float32 values and are sampled without hardware filtering.
+constexpr char kCommonShaderSource[] = R"(
+DEFAULT_PRECISION(highp, float)
+DEFAULT_PRECISION(highp, int)
+DEFAULT_PRECISION(highp, sampler2D)
+
+#ifdef GL_ES
+out vec4 frag_out;
+#endif  // defined(GL_ES)
+
+// Returns the texel at p, clamped to the texture.
+vec4 Fetch(sampler2D image, ivec2 p) {
+  return texelFetch(image, clamp(p, ivec2(0), textureSize(image, 0) - 1), 0);
+}
+
+// Bilinearly interpolates the texels around the (fractional) texel position
+// p, clamped to the texture.
+vec4 SampleBilinear(sampler2D image, vec2 p) {
+  ivec2 size = textureSize(image, 0);
+  vec2 c = clamp(p, vec2(0.0), vec2(size - 1));
+  ivec2 p0 = ivec2(floor(c));
+  ivec2 p1 = min(p0 + 1, size - 1);
+  vec2 f = c - vec2(p0);
+  return mix(mix(texelFetch(image, p0, 0),
+                 texelFetch(image, ivec2(p1.x, p0.y), 0), f.x),
+             mix(texelFetch(image, ivec2(p0.x, p1.y), 0),
+                 texelFetch(image, p1, 0), f.x),
+             f.y);
+}
+)";
+
+// Converts the input frame to grayscale intensities in [0, 255], resampled to
+// the processing resolution.
+constexpr char kGrayShaderSource[] = R"(
+uniform sampler2D input_frame;
+uniform vec2 scale;  // Input texels per output texel.
+uniform int single_channel;
+
+void main() {
+  vec4 pixel = SampleBilinear(input_frame, gl_FragCoord.xy * scale - 0.5);
+  float gray = single_channel != 0 ? pixel.r
+                                   : dot(pixel.rgb, vec3(0.299, 0.587, 0.114));
+  frag_out = vec4(255.0 * gray, 0.0, 0.0, 1.0);
+}
+)";
+
+// Halves the size of a pyramid level by averaging 2x2 texels.
+constexpr char kReduceShaderSource[] = R"(
+uniform sampler2D image;
+
+void main() {
+  ivec2 p = 2 * ivec2(gl_FragCoord.xy);
+  frag_out = 0.25 * (Fetch(image, p) + Fetch(image, p + ivec2(1, 0)) +
+                     Fetch(image, p + ivec2(0, 1)) +
+                     Fetch(image, p + ivec2(1, 1)));
+}
+)";
+
+// Bilinearly resamples source to the render target and scales the values,
+// used to upsample the flow and dual variables.
+constexpr char kResampleShaderSource[] = R"(
+uniform sampler2D source;
+uniform vec2 scale;  // Source texels per output texel.
+uniform vec4 value_scale;
+
+void main() {
+  frag_out = value_scale * SampleBilinear(source, gl_FragCoord.xy * scale - 0.5);
+}
+)";
+
+// Warps the second frame by the current flow and linearizes the brightness
+// constancy around it. Outputs the warped gradient (I1wx, I1wy), its squared
+// norm and the constant part of the residual
+// rho_c = I1w - I1wx * u1 - I1wy * u2 - I0.
+constexpr char kWarpShaderSource[] = R"(
+uniform sampler2D first;
+uniform sampler2D second;
+uniform sampler2D flow;
+
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+  vec2 u = texelFetch(flow, p, 0).xy;
+  vec2 q = vec2(p) + u;
+  float warped = SampleBilinear(second, q).r;
+  float gx = 0.5 * (SampleBilinear(second, q + vec2(1.0, 0.0)).r -
+                    SampleBilinear(second, q - vec2(1.0, 0.0)).r);
+  float gy = 0.5 * (SampleBilinear(second, q + vec2(0.0, 1.0)).r -
+                    SampleBilinear(second, q - vec2(0.0, 1.0)).r);
+  float rho_c = warped - gx * u.x - gy * u.y - texelFetch(first, p, 0).r;
+  frag_out = vec4(gx, gy, gx * gx + gy * gy, rho_c);
+}
+)";
+
+// Updates the flow (u1, u2): thresholds the data term and adds the divergence
+// of the dual variables (p11, p12, p21, p22), using backward differences with
+// zero dual variables outside of the image.
+constexpr char kFlowShaderSource[] = R"(
+uniform sampler2D flow;
+uniform sampler2D dual;
+uniform sampler2D warp;
+uniform float lambda_theta;
+uniform float theta;
+
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+  vec2 u = texelFetch(flow, p, 0).xy;
+  vec4 w = texelFetch(warp, p, 0);
+  float rho = w.w + dot(w.xy, u);
+  vec2 d = vec2(0.0);
+  if (rho < -lambda_theta * w.z) {
+    d = lambda_theta * w.xy;
+  } else if (rho > lambda_theta * w.z) {
+    d = -lambda_theta * w.xy;
+  } else if (w.z > 1e-10) {
+    d = -rho / w.z * w.xy;
+  }
+  vec4 dual_c = texelFetch(dual, p, 0);
+  vec4 dual_l = p.x > 0 ? texelFetch(dual, p - ivec2(1, 0), 0) : vec4(0.0);
+  vec4 dual_t = p.y > 0 ? texelFetch(dual, p - ivec2(0, 1), 0) : vec4(0.0);
+  vec2 div = vec2(dual_c.x - dual_l.x + dual_c.y - dual_t.y,
+                  dual_c.z - dual_l.z + dual_c.w - dual_t.w);
+  frag_out = vec4(u + d + theta * div, 0.0, 1.0);
+}
+)";
+
+// Updates the dual variables from the forward differences of the flow.
+constexpr char kDualShaderSource[] = R"(
+uniform sampler2D flow;
+uniform sampler2D dual;
+uniform float tau_theta;
+
+void main() {
+  ivec2 p = ivec2(gl_FragCoord.xy);
+  ivec2 size = textureSize(flow, 0);
+  vec2 u = texelFetch(flow, p, 0).xy;
+  vec2 ux = p.x < size.x - 1 ? texelFetch(flow, p + ivec2(1, 0), 0).xy - u
+                             : vec2(0.0);
+  vec2 uy = p.y < size.y - 1 ? texelFetch(flow, p + ivec2(0, 1), 0).xy - u
+                             : vec2(0.0);
+  vec2 grad_u1 = vec2(ux.x, uy.x);
+  vec2 grad_u2 = vec2(ux.y, uy.y);
+  vec4 dual_c = texelFetch(dual, p, 0);
+  frag_out = vec4(
+      (dual_c.xy + tau_theta * grad_u1) / (1.0 + tau_theta * length(grad_u1)),
+      (dual_c.zw + tau_theta * grad_u2) / (1.0 + tau_theta * length(grad_u2)));
+}
+)";
+
+struct GlProgram {
+  GLuint program = 0;
+  absl::flat_hash_map<std::string, GLint> uniforms;
+};
+
+}  // namespace
+
+// Computes the TV-L1 optical flow between a pair of GPU frames with OpenGL ES
+// 3.0 fragment shaders. This is a GPU version of Tvl1OpticalFlowCalculator,
+// implementing the same duality based scheme as OpenCV's DualTVL1OpticalFlow
+// on a pyramid with a scale factor of 0.5.
+//
+// The flow can be output as OpticalFlowField, which reads it back to the CPU,
+// or kept on the GPU as a GpuBuffer in kTwoComponentFloat32 format holding the
+// (x, y) flow in pixels, e.g. for FlowToImageCalculator. Either way the flow
+// has the resolution of the input frames. Requires float32 color buffers.
+//
+// Inputs:
+//   FIRST_FRAME: A GpuBuffer in an RGB(A) or one-channel format.
+//   SECOND_FRAME: A GpuBuffer of the same size.
+// Outputs:
+//   FORWARD_FLOW: The OpticalFlowField from the first frame to the second
+//                 frame, output at the input timestamp.
+//   BACKWARD_FLOW: The OpticalFlowField from the second frame to the first
+//                  frame, output at the input timestamp.
+//   FORWARD_FLOW_GPU: FORWARD_FLOW as a GpuBuffer.
+//   BACKWARD_FLOW_GPU: BACKWARD_FLOW as a GpuBuffer.
+// Example config:
+//   node {
+//     calculator: "Tvl1OpticalFlowGpuCalculator"
+//     input_stream: "FIRST_FRAME:first_frames"
+//     input_stream: "SECOND_FRAME:second_frames"
+//     output_stream: "FORWARD_FLOW_GPU:forward_flow"
+//     options: {
+//       [mediapipe.Tvl1OpticalFlowGpuCalculatorOptions.ext] {
+//         processing_scale: 0.5
+//       }
+//     }
+//   }
+class Tvl1OpticalFlowGpuCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc);
+  absl::Status Open(CalculatorContext* cc) override;
+  absl::Status Process(CalculatorContext* cc) override;
+  absl::Status Close(CalculatorContext* cc) override;
+
+ private:
+  absl::Status GlSetup();
+  absl::Status CreateProgram(const char* source,
+                             const std::vector<std::string>& uniform_names,
+                             GlProgram* program);
+
+  // Renders the current program to the bound framebuffer.
+  void Render();
+
+  // Returns the grayscale pyramid of frame, finest level first.
+  std::vector<GlTexture> BuildPyramid(const GlTexture& frame,
+                                      GpuBufferFormat format);
+
+  // Computes the flow from the first to the second pyramid, upsampled to the
+  // input resolution.
+  GlTexture ComputeFlow(const std::vector<GlTexture>& first,
+                        const std::vector<GlTexture>& second);
+
+  // Bilinearly resamples source to a new texture of the given size and
+  // format, multiplying the values by value_scale.
+  GlTexture Resample(const GlTexture& source, int width, int height,
+                     GpuBufferFormat format, const float value_scale[4]);
+
+  absl::Status OutputFlow(const GlTexture& flow, const std::string& cpu_tag,
+                          const std::string& gpu_tag, CalculatorContext* cc);
+
+  Tvl1OpticalFlowGpuCalculatorOptions options_;
+  GlCalculatorHelper gpu_helper_;
+  bool initialized_ = false;
+
+  int input_width_ = 0;
+  int input_height_ = 0;
+  int processing_width_ = 0;
+  int processing_height_ = 0;
+
+  GlProgram gray_program_;
+  GlProgram reduce_program_;
+  GlProgram resample_program_;
+  GlProgram warp_program_;
+  GlProgram flow_program_;
+  GlProgram dual_program_;
+  GLuint vao_ = 0;
+  GLuint vbo_[2] = {0, 0};
+};
+REGISTER_CALCULATOR(Tvl1OpticalFlowGpuCalculator);
+
+absl::Status Tvl1OpticalFlowGpuCalculator::GetContract(
+    CalculatorContract* cc) {
+  RET_CHECK(cc->Inputs().HasTag(kFirstFrameTag) &&
+            cc->Inputs().HasTag(kSecondFrameTag))
+      << "Both FIRST_FRAME and SECOND_FRAME must be specified.";
+  cc->Inputs().Tag(kFirstFrameTag).Set<GpuBuffer>();
+  cc->Inputs().Tag(kSecondFrameTag).Set<GpuBuffer>();
+  if (cc->Outputs().HasTag(kForwardFlowTag)) {
+    cc->Outputs().Tag(kForwardFlowTag).Set<OpticalFlowField>();
+  }
+  if (cc->Outputs().HasTag(kBackwardFlowTag)) {
+    cc->Outputs().Tag(kBackwardFlowTag).Set<OpticalFlowField>();
+  }
+  if (cc->Outputs().HasTag(kForwardFlowGpuTag)) {
+    cc->Outputs().Tag(kForwardFlowGpuTag).Set<GpuBuffer>();
+  }
+  if (cc->Outputs().HasTag(kBackwardFlowGpuTag)) {
+    cc->Outputs().Tag(kBackwardFlowGpuTag).Set<GpuBuffer>();
+  }
+  return GlCalculatorHelper::UpdateContract(cc);
+}
+
+absl::Status Tvl1OpticalFlowGpuCalculator::Open(CalculatorContext* cc) {
+  cc->SetOffset(TimestampDiff(0));
+  options_ = cc->Options<Tvl1OpticalFlowGpuCalculatorOptions>();
+  RET_CHECK(options_.processing_scale() > 0 &&
+            options_.processing_scale() <= 1)
+      << "processing_scale must be in (0, 1].";
+  RET_CHECK_GT(options_.num_scales(), 0);
+  RET_CHECK_GT(options_.num_warps(), 0);
+  RET_CHECK_GT(options_.num_iterations(), 0);
+  RET_CHECK_GT(options_.theta(), 0);
+  return gpu_helper_.Open(cc);
+}
+
+absl::Status Tvl1OpticalFlowGpuCalculator::Process(CalculatorContext* cc) {
+  const auto& first_frame = cc->Inputs().Tag(kFirstFrameTag).Get<GpuBuffer>();
+  const auto& second_frame =
+      cc->Inputs().Tag(kSecondFrameTag).Get<GpuBuffer>();
+  RET_CHECK(first_frame.width() == second_frame.width() &&
+            first_frame.height() == second_frame.height())
+      << "Images are different sizes.";
+
+  return gpu_helper_.RunInGlContext([&]() -> absl::Status {
+    if (!initialized_) {
+      MP_RETURN_IF_ERROR(GlSetup());
+      initialized_ = true;
+    }
+    input_width_ = first_frame.width();
+    input_height_ = first_frame.height();
+    processing_width_ = std::max(
+        1, static_cast<int>(
+               std::lround(input_width_ * options_.processing_scale())));
+    processing_height_ = std::max(
+        1, static_cast<int>(
+               std::lround(input_height_ * options_.processing_scale())));
+
+    glDisable(GL_BLEND);
+    glBindVertexArray(vao_);
+
+    // Both directions share the pyramids.
+    std::vector<GlTexture> first_pyramid;
+    std::vector<GlTexture> second_pyramid;
+    {
+      auto first_texture = gpu_helper_.CreateSourceTexture(first_frame);
+      first_pyramid = BuildPyramid(first_texture, first_frame.format());
+      auto second_texture = gpu_helper_.CreateSourceTexture(second_frame);
+      second_pyramid = BuildPyramid(second_texture, second_frame.format());
+    }
+
+    if (cc->Outputs().HasTag(kForwardFlowTag) ||
+        cc->Outputs().HasTag(kForwardFlowGpuTag)) {
+      GlTexture flow = ComputeFlow(first_pyramid, second_pyramid);
+      MP_RETURN_IF_ERROR(
+          OutputFlow(flow, kForwardFlowTag, kForwardFlowGpuTag, cc));
+    }
+    if (cc->Outputs().HasTag(kBackwardFlowTag) ||
+        cc->Outputs().HasTag(kBackwardFlowGpuTag)) {
+      GlTexture flow = ComputeFlow(second_pyramid, first_pyramid);
+      MP_RETURN_IF_ERROR(
+          OutputFlow(flow, kBackwardFlowTag, kBackwardFlowGpuTag, cc));
+    }
+
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glFlush();
+    return absl::OkStatus();
+  });
+}
+
+absl::Status Tvl1OpticalFlowGpuCalculator::Close(CalculatorContext* cc) {
+  return gpu_helper_.RunInGlContext([this] {
+    for (GlProgram* program :
+         {&gray_program_, &reduce_program_, &resample_program_, &warp_program_,
+          &flow_program_, &dual_program_}) {
+      if (program->program) glDeleteProgram(program->program);
+      program->program = 0;
+    }
+    if (vao_) glDeleteVertexArrays(1, &vao_);
+    if (vbo_[0]) glDeleteBuffers(2, vbo_);
+    vao_ = 0;
+    vbo_[0] = vbo_[1] = 0;
+    return absl::OkStatus();
+  });
+}
+
+absl::Status Tvl1OpticalFlowGpuCalculator::CreateProgram(
+    const char* source, const std::vector<std::string>& uniform_names,
+    GlProgram* program) {
+  const std::string vertex_source =
+      absl::StrCat(kVersionHeader, kBasicVertexShader);
+  const std::string fragment_source =
+      absl::StrCat(kVersionHeader, kMediaPipeFragmentShaderPreamble,
+                   kCommonShaderSource, source);
+  GlhCreateProgram(vertex_source.c_str(), fragment_source.c_str(),
+                   NUM_ATTRIBUTES, &kAttribNames[0], kAttribLocations,
+                   &program->program, /*force_log_errors=*/true);
+  RET_CHECK(program->program) << "Problem initializing the program.";
+  for (const std::string& name : uniform_names) {
+    const GLint location = glGetUniformLocation(program->program, name.c_str());
+    RET_CHECK_NE(location, -1) << "Uniform " << name << " not found.";
+    program->uniforms[name] = location;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Tvl1OpticalFlowGpuCalculator::GlSetup() {
+  const GlContext& context = gpu_helper_.GetGlContext();
+  RET_CHECK(context.GetGlVersion() != GlVersion::kGLES2)
+      << "Tvl1OpticalFlowGpuCalculator requires OpenGL ES 3.0.";
+#ifdef GL_ES_VERSION_2_0
+#ifdef __EMSCRIPTEN__
+  RET_CHECK(context.HasGlExtension("EXT_color_buffer_float"))
+#else
+  RET_CHECK(context.HasGlExtension("GL_EXT_color_buffer_float"))
+#endif  // __EMSCRIPTEN__
+      << "Tvl1OpticalFlowGpuCalculator requires float32 color buffers.";
+#endif  // GL_ES_VERSION_2_0
+
+  MP_RETURN_IF_ERROR(CreateProgram(
+      kGrayShaderSource, {"input_frame", "scale", "single_channel"},
+      &gray_program_));
+  MP_RETURN_IF_ERROR(
+      CreateProgram(kReduceShaderSource, {"image"}, &reduce_program_));
+  MP_RETURN_IF_ERROR(CreateProgram(kResampleShaderSource,
+                                   {"source", "scale", "value_scale"},
+                                   &resample_program_));
+  MP_RETURN_IF_ERROR(CreateProgram(
+      kWarpShaderSource, {"first", "second", "flow"}, &warp_program_));
+  MP_RETURN_IF_ERROR(CreateProgram(
+      kFlowShaderSource, {"flow", "dual", "warp", "lambda_theta", "theta"},
+      &flow_program_));
+  MP_RETURN_IF_ERROR(CreateProgram(
+      kDualShaderSource, {"flow", "dual", "tau_theta"}, &dual_program_));
+
+  // Source textures are bound to units 1 to 3 in the order of the sampler
+  // uniforms of each program.
+  glUseProgram(gray_program_.program);
+  glUniform1i(gray_program_.uniforms["input_frame"], 1);
+  glUseProgram(reduce_program_.program);
+  glUniform1i(reduce_program_.uniforms["image"], 1);
+  glUseProgram(resample_program_.program);
+  glUniform1i(resample_program_.uniforms["source"], 1);
+  glUseProgram(warp_program_.program);
+  glUniform1i(warp_program_.uniforms["first"], 1);
+  glUniform1i(warp_program_.uniforms["second"], 2);
+  glUniform1i(warp_program_.uniforms["flow"], 3);
+  glUseProgram(flow_program_.program);
+  glUniform1i(flow_program_.uniforms["flow"], 1);
+  glUniform1i(flow_program_.uniforms["dual"], 2);
+  glUniform1i(flow_program_.uniforms["warp"], 3);
+  glUniform1f(flow_program_.uniforms["lambda_theta"],
+              options_.lambda() * options_.theta());
+  glUniform1f(flow_program_.uniforms["theta"], options_.theta());
+  glUseProgram(dual_program_.program);
+  glUniform1i(dual_program_.uniforms["flow"], 1);
+  glUniform1i(dual_program_.uniforms["dual"], 2);
+  glUniform1f(dual_program_.uniforms["tau_theta"],
+              options_.tau() / options_.theta());
+  glUseProgram(0);
+
+  glGenVertexArrays(1, &vao_);
+  glBindVertexArray(vao_);
+  glGenBuffers(2, vbo_);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_[0]);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(kBasicSquareVertices),
+               kBasicSquareVertices, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(ATTRIB_VERTEX);
+  glVertexAttribPointer(ATTRIB_VERTEX, 2, GL_FLOAT, 0, 0, nullptr);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo_[1]);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(kBasicTextureVertices),
+               kBasicTextureVertices, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(ATTRIB_TEXTURE_POSITION);
+  glVertexAttribPointer(ATTRIB_TEXTURE_POSITION, 2, GL_FLOAT, 0, 0, nullptr);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+  return absl::OkStatus();
+}
+
+void Tvl1OpticalFlowGpuCalculator::Render() {
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+std::vector<GlTexture> Tvl1OpticalFlowGpuCalculator::BuildPyramid(
+    const GlTexture& frame, GpuBufferFormat format) {
+  std::vector<GlTexture> pyramid;
+  pyramid.push_back(gpu_helper_.CreateDestinationTexture(
+      processing_width_, processing_height_, GpuBufferFormat::kGrayFloat32));
+  gpu_helper_.BindFramebuffer(pyramid.back());
+  glUseProgram(gray_program_.program);
+  glUniform2f(gray_program_.uniforms["scale"],
+              static_cast<float>(input_width_) / processing_width_,
+              static_cast<float>(input_height_) / processing_height_);
+  const bool single_channel = format == GpuBufferFormat::kOneComponent8 ||
+                              format == GpuBufferFormat::kGrayHalf16 ||
+                              format == GpuBufferFormat::kGrayFloat32;
+  glUniform1i(gray_program_.uniforms["single_channel"], single_channel);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(frame.target(), frame.name());
+  Render();
+
+  glUseProgram(reduce_program_.program);
+  while (static_cast<int>(pyramid.size()) < options_.num_scales()) {
+    const int width = (pyramid.back().width() + 1) / 2;
+    const int height = (pyramid.back().height() + 1) / 2;
+    if (std::min(width, height) < kMinPyramidSize) break;
+    GlTexture level = gpu_helper_.CreateDestinationTexture(
+        width, height, GpuBufferFormat::kGrayFloat32);
+    gpu_helper_.BindFramebuffer(level);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, pyramid.back().name());
+    Render();
+    pyramid.push_back(std::move(level));
+  }
+  return pyramid;
+}
+
+GlTexture Tvl1OpticalFlowGpuCalculator::Resample(const GlTexture& source,
+                                                 int width, int height,
+                                                 GpuBufferFormat format,
+                                                 const float value_scale[4]) {
+  GlTexture dst = gpu_helper_.CreateDestinationTexture(width, height, format);
+  gpu_helper_.BindFramebuffer(dst);
+  glUseProgram(resample_program_.program);
+  glUniform2f(resample_program_.uniforms["scale"],
+              static_cast<float>(source.width()) / width,
+              static_cast<float>(source.height()) / height);
+  glUniform4fv(resample_program_.uniforms["value_scale"], 1, value_scale);
+  glActiveTexture(GL_TEXTURE1);
+  glBindTexture(GL_TEXTURE_2D, source.name());
+  Render();
+  return dst;
+}
+
+GlTexture Tvl1OpticalFlowGpuCalculator::ComputeFlow(
+    const std::vector<GlTexture>& first, const std::vector<GlTexture>& second) {
+  const int num_levels = first.size();
+  GlTexture flow;
+  GlTexture dual;
+  for (int l = num_levels - 1; l >= 0; --l) {
+    const int width = first[l].width();
+    const int height = first[l].height();
+    if (l == num_levels - 1) {
+      // The flow and dual variables start at zero on the coarsest level.
+      flow = gpu_helper_.CreateDestinationTexture(
+          width, height, GpuBufferFormat::kTwoComponentFloat32);
+      dual = gpu_helper_.CreateDestinationTexture(
+          width, height, GpuBufferFormat::kRGBAFloat128);
+      glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+      for (const GlTexture* texture : {&flow, &dual}) {
+        gpu_helper_.BindFramebuffer(*texture);
+        glClear(GL_COLOR_BUFFER_BIT);
+      }
+    } else {
+      // The pyramid levels halve the resolution, so the flow doubles.
+      static constexpr float kFlowScale[4] = {2.0f, 2.0f, 0.0f, 0.0f};
+      static constexpr float kDualScale[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+      flow = Resample(flow, width, height,
+                      GpuBufferFormat::kTwoComponentFloat32, kFlowScale);
+      dual = Resample(dual, width, height, GpuBufferFormat::kRGBAFloat128,
+                      kDualScale);
+    }
+
+    for (int w = 0; w < options_.num_warps(); ++w) {
+      GlTexture warp = gpu_helper_.CreateDestinationTexture(
+          width, height, GpuBufferFormat::kRGBAFloat128);
+      gpu_helper_.BindFramebuffer(warp);
+      glUseProgram(warp_program_.program);
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, first[l].name());
+      glActiveTexture(GL_TEXTURE2);
+      glBindTexture(GL_TEXTURE_2D, second[l].name());
+      glActiveTexture(GL_TEXTURE3);
+      glBindTexture(GL_TEXTURE_2D, flow.name());
+      Render();
+
+      for (int i = 0; i < options_.num_iterations(); ++i) {
+        GlTexture next_flow = gpu_helper_.CreateDestinationTexture(
+            width, height, GpuBufferFormat::kTwoComponentFloat32);
+        gpu_helper_.BindFramebuffer(next_flow);
+        glUseProgram(flow_program_.program);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, flow.name());
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, dual.name());
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, warp.name());
+        Render();
+        flow = std::move(next_flow);
+
+        GlTexture next_dual = gpu_helper_.CreateDestinationTexture(
+            width, height, GpuBufferFormat::kRGBAFloat128);
+        gpu_helper_.BindFramebuffer(next_dual);
+        glUseProgram(dual_program_.program);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, flow.name());
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, dual.name());
+        Render();
+        dual = std::move(next_dual);
+      }
+    }
+  }
+
+  // Upsamples the flow of the finest level to the input resolution.
+  const float flow_scale[4] = {
+      static_cast<float>(input_width_) / processing_width_,
+      static_cast<float>(input_height_) / processing_height_, 0.0f, 0.0f};
+  return Resample(flow, input_width_, input_height_,
+                  GpuBufferFormat::kTwoComponentFloat32, flow_scale);
+}
+
+absl::Status Tvl1OpticalFlowGpuCalculator::OutputFlow(
+    const GlTexture& flow, const std::string& cpu_tag,
+    const std::string& gpu_tag, CalculatorContext* cc) {
+  std::unique_ptr<GpuBuffer> buffer = flow.GetFrame<GpuBuffer>();
+  if (cc->Outputs().HasTag(cpu_tag)) {
+    std::shared_ptr<const ImageFrame> view = buffer->GetReadView<ImageFrame>();
+    RET_CHECK(view->Format() == ImageFormat::FORMAT_VEC32F2);
+    auto field = std::make_unique<OpticalFlowField>();
+    field->Allocate(view->Width(), view->Height());
+    cv::Mat& flow_data = field->mutable_flow_data();
+    for (int y = 0; y < view->Height(); ++y) {
+      std::memcpy(flow_data.ptr(y), view->PixelData() + y * view->WidthStep(),
+                  view->Width() * 2 * sizeof(float));
+    }
+    cc->Outputs().Tag(cpu_tag).Add(field.release(), cc->InputTimestamp());
+  }
+  if (cc->Outputs().HasTag(gpu_tag)) {
+    cc->Outputs().Tag(gpu_tag).Add(buffer.release(), cc->InputTimestamp());
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace mediapipe
@@ -1,9 +1,37 @@
 #include "mediapipe/framework/api2/node.h"
 
+#include <utility>
+
+#include "absl/synchronization/notification.h"
+
 namespace mediapipe {
 namespace api2 {
 
 Node::~Node() {}
 
+namespace internal {
+
+absl::Status ProcessAsync(
+    CalculatorContext* cc,
+    const std::function<void(CalculatorContext*,
+                             CalculatorContext::ProcessCompletion)>&
+        process_async) {
+  CalculatorContext::ProcessCompletion done = cc->DeferProcessCompletion();
+  if (done) {
+    process_async(cc, std::move(done));
+    return absl::OkStatus();
+  }
+  absl::Notification completed;
+  absl::Status status;
+  process_async(cc, [&completed, &status](absl::Status result) {
+    status = std::move(result);
+    completed.Notify();
+  });
+  completed.WaitForNotification();
+  return status;
+}
+
+}  // namespace internal
+
 }  // namespace api2
 }  // namespace mediapipe
@@ -24,6 +24,54 @@ class Node : public CalculatorBase {
   virtual ~Node();
 };
 
+namespace internal {
+
+// Calls process_async, and returns once it calls done if the completion of
+// the Process() call cannot be deferred.
+absl::Status ProcessAsync(
+    CalculatorContext* cc,
+    const std::function<void(CalculatorContext*,
+                             CalculatorContext::ProcessCompletion)>&
+        process_async);
+
+}  // namespace internal
+
+// A node whose Process() completes asynchronously, for calculators that wait
+// on I/O, a remote call, or a GPU readback. ProcessAsync() starts processing
+// the inputs and returns without waiting, releasing the executor thread. It
+// must call done exactly once, from any thread, after all the outputs for
+// the inputs are sent. cc and its inputs stay valid until then, and the
+// outputs and timestamp bounds are propagated in order as if Process()
+// returned at that point. See CalculatorContext::DeferProcessCompletion().
+//
+// Where the completion cannot be deferred, such as in a source node or for a
+// batch of input sets, Process() blocks until done is called, so done must
+// not depend on the calling thread returning.
+//
+//   class ReadRecordImpl : public AsyncNodeImpl<ReadRecord, ReadRecordImpl> {
+//    public:
+//     void ProcessAsync(CalculatorContext* cc,
+//                       ProcessCompletion done) override {
+//       reader_->Read(*kKey(cc), [cc, done](Record record) {
+//         kOut(cc).Send(std::move(record));
+//         done(absl::OkStatus());
+//       });
+//     }
+//   };
+class AsyncNode : public Node {
+ public:
+  using ProcessCompletion = CalculatorContext::ProcessCompletion;
+
+  virtual void ProcessAsync(CalculatorContext* cc, ProcessCompletion done) = 0;
+
+  absl::Status Process(CalculatorContext* cc) final {
+    return internal::ProcessAsync(
+        cc, [this](CalculatorContext* cc, ProcessCompletion done) {
+          ProcessAsync(cc, std::move(done));
+        });
+  }
+};
+
 }  // namespace api2
 
 namespace internal {
@@ -141,6 +189,22 @@ class NodeImpl : public RegisteredNode<Impl>, public Intf {
   }
 };
 
+// A NodeImpl whose Process() completes asynchronously. See AsyncNode.
+template <class Intf, class Impl = void>
+class AsyncNodeImpl : public NodeImpl<Intf, Impl> {
+ public:
+  using ProcessCompletion = CalculatorContext::ProcessCompletion;
+
+  virtual void ProcessAsync(CalculatorContext* cc, ProcessCompletion done) = 0;
+
+  absl::Status Process(CalculatorContext* cc) final {
+    return internal::ProcessAsync(
+        cc, [this](CalculatorContext* cc, ProcessCompletion done) {
+          ProcessAsync(cc, std::move(done));
+        });
+  }
+};
+
 // This macro is used to define the contract, without also giving the
 // node a type name. It can be used directly in pure interfaces.
 #define MEDIAPIPE_NODE_CONTRACT(...)                                          \
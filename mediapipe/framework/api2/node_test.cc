@@ -1,9 +1,11 @@
 #include "mediapipe/framework/api2/node.h"
 
+#include <memory>
 #include <tuple>
 #include <utility>
 
 #include "absl/log/absl_log.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/api2/test_contracts.h"
@@ -15,6 +17,7 @@
 #include "mediapipe/framework/port/parse_text_proto.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/port/threadpool.h"
 
 namespace mediapipe {
 namespace api2 {
@@ -577,6 +580,114 @@ struct LogSinkNode : public Node {
 };
 MEDIAPIPE_REGISTER_NODE(LogSinkNode);
 
+// Forwards each input packet from a worker thread, after all the nodes
+// sharing the optional BARRIER have started processing.
+struct AsyncForwarder : public AsyncNode {
+  static constexpr Input<int> kIn{"IN"};
+  static constexpr SideInput<absl::BlockingCounter*>::Optional kBarrier{
+      "BARRIER"};
+  static constexpr Output<int> kOut{"OUT"};
+
+  MEDIAPIPE_NODE_CONTRACT(kIn, kBarrier, kOut);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    worker_ = std::make_unique<ThreadPool>("async_forwarder", 1);
+    worker_->StartWorkers();
+    return {};
+  }
+
+  void ProcessAsync(CalculatorContext* cc, ProcessCompletion done) override {
+    absl::BlockingCounter* barrier =
+        kBarrier(cc).IsConnected() ? *kBarrier(cc) : nullptr;
+    worker_->Schedule([cc, barrier, done = std::move(done)] {
+      if (barrier) {
+        barrier->DecrementCount();
+        barrier->Wait();
+      }
+      kOut(cc).Send(*kIn(cc));
+      done(absl::OkStatus());
+    });
+  }
+
+  absl::Status Close(CalculatorContext* cc) override {
+    worker_.reset();
+    return {};
+  }
+
+  std::unique_ptr<ThreadPool> worker_;
+};
+MEDIAPIPE_REGISTER_NODE(AsyncForwarder);
+
+TEST(NodeTest, AsyncNodeKeepsOrder) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "AsyncForwarder"
+          input_stream: "IN:in"
+          output_stream: "OUT:out"
+        }
+      )pb");
+  std::vector<mediapipe::Packet> out_packets;
+  tool::AddVectorSink("out", &config, &out_packets);
+  mediapipe::CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config, {}));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 5; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "in", mediapipe::MakePacket<int>(i).At(Timestamp(i))));
+  }
+  MP_ASSERT_OK(graph.WaitUntilIdle());
+  EXPECT_THAT(PacketValues<int>(out_packets),
+              testing::ElementsAre(0, 1, 2, 3, 4));
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
+// Both nodes wait for each other on a single executor thread, which only
+// completes if AsyncNode releases the thread.
+TEST(NodeTest, AsyncNodeReleasesExecutorThread) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        num_threads: 1
+        input_stream: "in1"
+        input_stream: "in2"
+        input_side_packet: "barrier"
+        output_stream: "out1"
+        output_stream: "out2"
+        node {
+          calculator: "AsyncForwarder"
+          input_stream: "IN:in1"
+          input_side_packet: "BARRIER:barrier"
+          output_stream: "OUT:out1"
+        }
+        node {
+          calculator: "AsyncForwarder"
+          input_stream: "IN:in2"
+          input_side_packet: "BARRIER:barrier"
+          output_stream: "OUT:out2"
+        }
+      )pb");
+  std::vector<mediapipe::Packet> out1_packets;
+  std::vector<mediapipe::Packet> out2_packets;
+  tool::AddVectorSink("out1", &config, &out1_packets);
+  tool::AddVectorSink("out2", &config, &out2_packets);
+  absl::BlockingCounter barrier(2);
+  mediapipe::CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config, {}));
+  MP_ASSERT_OK(graph.StartRun(
+      {{"barrier", mediapipe::MakePacket<absl::BlockingCounter*>(&barrier)}}));
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "in1", mediapipe::MakePacket<int>(1).At(Timestamp(0))));
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "in2", mediapipe::MakePacket<int>(2).At(Timestamp(0))));
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  EXPECT_THAT(PacketValues<int>(out1_packets), testing::ElementsAre(1));
+  EXPECT_THAT(PacketValues<int>(out2_packets), testing::ElementsAre(2));
+}
+
 }  // namespace test
 }  // namespace api2
 }  // namespace mediapipe
@@ -68,8 +68,8 @@ class PacketBase {
   operator mediapipe::Packet() && { return ToOldPacket(std::move(*this)); }
 
   // Note: Consume is included for compatibility with the old Packet; however,
-  // it relies on shared_ptr.unique(), which is deprecated and is not guaranteed
-  // to give exact results.
+  // it relies on the reference count of the payload, which is not guaranteed
+  // to be exact while other threads copy or destroy the packet.
   template <typename T>
   absl::StatusOr<std::unique_ptr<T>> Consume() {
     // Using the implementation in the old Packet for now.
@@ -82,10 +82,10 @@ class PacketBase {
   }
 
  protected:
-  explicit PacketBase(std::shared_ptr<HolderBase> payload)
+  explicit PacketBase(packet_internal::HolderPtr payload)
       : payload_(std::move(payload)) {}
 
-  std::shared_ptr<HolderBase> payload_;
+  packet_internal::HolderPtr payload_;
   Timestamp timestamp_;
 
   template <typename T>
@@ -194,7 +194,7 @@ class Packet<internal::Generic> : public PacketBase {
   Packet<internal::Generic> At(Timestamp timestamp) &&;
 
  protected:
-  explicit Packet(std::shared_ptr<HolderBase> payload)
+  explicit Packet(packet_internal::HolderPtr payload)
       : PacketBase(std::move(payload)) {}
 
   friend PacketBase;
@@ -226,14 +226,14 @@ class Packet : public Packet<internal::Generic> {
   }
 
   // Note: Consume is included for compatibility with the old Packet; however,
-  // it relies on shared_ptr.unique(), which is deprecated and is not guaranteed
-  // to give exact results.
+  // it relies on the reference count of the payload, which is not guaranteed
+  // to be exact while other threads copy or destroy the packet.
   absl::StatusOr<std::unique_ptr<T>> Consume() {
     return PacketBase::Consume<T>();
   }
 
  private:
-  explicit Packet(std::shared_ptr<HolderBase> payload)
+  explicit Packet(packet_internal::HolderPtr payload)
       : Packet<internal::Generic>(std::move(payload)) {}
 
   friend PacketBase;
@@ -356,8 +356,8 @@ class Packet<OneOf<T...>> : public PacketBase {
   }
 
   // Note: Consume is included for compatibility with the old Packet; however,
-  // it relies on shared_ptr.unique(), which is deprecated and is not guaranteed
-  // to give exact results.
+  // it relies on the reference count of the payload, which is not guaranteed
+  // to be exact while other threads copy or destroy the packet.
   template <class U, class = AllowedType<U>>
   absl::StatusOr<std::unique_ptr<U>> Consume() {
     return PacketBase::Consume<U>();
@@ -380,7 +380,7 @@ class Packet<OneOf<T...>> : public PacketBase {
   }
 
  protected:
-  explicit Packet(std::shared_ptr<HolderBase> payload)
+  explicit Packet(packet_internal::HolderPtr payload)
       : PacketBase(std::move(payload)) {}
 
   friend PacketBase;
@@ -451,18 +451,25 @@ inline Packet<internal::Generic> Packet<internal::Generic>::At(
 
 template <typename T, typename... Args>
 Packet<T> MakePacket(Args&&... args) {
-  return Packet<T>(std::make_shared<packet_internal::Holder<T>>(
-      new T(std::forward<Args>(args)...)));
+  if constexpr (std::is_nothrow_move_constructible<T>::value) {
+    return Packet<T>(packet_internal::HolderPtr(
+        new packet_internal::InlineHolder<T>(std::forward<Args>(args)...)));
+  } else {
+    return Packet<T>(packet_internal::HolderPtr(
+        new packet_internal::Holder<T>(new T(std::forward<Args>(args)...))));
+  }
 }
 
 template <typename T>
 Packet<T> PacketAdopting(const T* ptr) {
-  return Packet<T>(std::make_shared<packet_internal::Holder<T>>(ptr));
+  return Packet<T>(
+      packet_internal::HolderPtr(new packet_internal::Holder<T>(ptr)));
 }
 
 template <typename T>
 Packet<T> PacketAdopting(std::unique_ptr<T> ptr) {
-  return Packet<T>(std::make_shared<packet_internal::Holder<T>>(ptr.release()));
+  return Packet<T>(packet_internal::HolderPtr(
+      new packet_internal::Holder<T>(ptr.release())));
 }
 
 }  // namespace api2
@@ -66,6 +66,35 @@ const OutputStreamShardSet& CalculatorContext::Outputs() const {
   return outputs_;
 }
 
+CalculatorContext::ProcessCompletion
+CalculatorContext::DeferProcessCompletion() {
+  if (deferred_process_handler_ == nullptr) {
+    return nullptr;
+  }
+  ABSL_CHECK(!ProcessDeferred())
+      << "The Process() call is already deferred for node: " << NodeName();
+  deferred_process_refs_.store(2, std::memory_order_relaxed);
+  return [this, handler = deferred_process_handler_](absl::Status status) {
+    deferred_completion_status_ = std::move(status);
+    absl::Status result;
+    if (ReleaseDeferredProcess(&result)) {
+      (*handler)(this, std::move(result));
+    }
+  };
+}
+
+bool CalculatorContext::ReleaseDeferredProcess(absl::Status* status) {
+  if (deferred_process_refs_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return false;
+  }
+  *status = deferred_process_status_.ok()
+                ? std::move(deferred_completion_status_)
+                : std::move(deferred_process_status_);
+  deferred_process_status_ = absl::OkStatus();
+  deferred_completion_status_ = absl::OkStatus();
+  return true;
+}
+
 void CalculatorContext::SetOffset(TimestampDiff offset) {
   for (auto& stream : outputs_) {
     stream.SetOffset(offset);
@@ -15,8 +15,10 @@
 #ifndef MEDIAPIPE_FRAMEWORK_CALCULATOR_CONTEXT_H_
 #define MEDIAPIPE_FRAMEWORK_CALCULATOR_CONTEXT_H_
 
+#include <atomic>
 #include <memory>
-#include <queue>
+#include <deque>
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -84,6 +86,35 @@ class CalculatorContext {
   // No prefix is added to counters created in this way.
   CounterFactory* GetCounterFactory();
 
+  // Returns the graph's packet arena, or nullptr if the graph has none. Use
+  // with MakePacketInArena, which falls back to MakePacket for nullptr.
+  PacketArena* GetPacketArena() const {
+    return calculator_state_->GetPacketArena();
+  }
+
+  // Returns the graph's executor with the given name, or nullptr if the graph
+  // has none. The empty name refers to the default executor. Calculators can
+  // use it to run their own parallel work alongside the graph instead of
+  // starting more threads, but must not block on the work they schedule.
+  Executor* GetExecutor(const std::string& name) const {
+    return calculator_state_->GetExecutor(name);
+  }
+
+  // Cancels the work for a timestamp in the whole graph, like
+  // CalculatorGraph::CancelTimestamp(). Used for example to abandon a frame
+  // whose results are no longer awaited.
+  void CancelTimestamp(Timestamp timestamp) {
+    calculator_state_->CancelTimestamp(timestamp);
+  }
+
+  // Returns true if the current input timestamp has been cancelled since the
+  // Process() call started. Calculators can check this before expensive work
+  // and then return without outputs.
+  bool IsCancelled() const {
+    return HasInputTimestamp() &&
+           calculator_state_->IsCancelled(InputTimestamp());
+  }
+
   // Returns the current input timestamp, or Timestamp::Unset if there are
   // no input packets.
   Timestamp InputTimestamp() const {
@@ -91,6 +122,20 @@ class CalculatorContext {
                                      : input_timestamps_.front();
   }
 
+  // Returns the number of input sets presented to the current Process() call.
+  // This is greater than one only for calculators that call
+  // CalculatorContract::SetProcessInputBatches() and whose input stream
+  // handler collects batches. The input sets of a batch are read through
+  // InputStreamShard::BatchValue().
+  int InputBatchSize() const { return input_batch_size_; }
+
+  // Returns the input timestamp of the input set at index in the current
+  // batch. InputBatchTimestamp(0) equals InputTimestamp().
+  Timestamp InputBatchTimestamp(int index) const {
+    return index < input_batch_size_ ? input_timestamps_[index]
+                                     : Timestamp::Unset();
+  }
+
   // Returns a reference to the input side packet set.
   const PacketSet& InputSidePackets() const;
   // Returns a reference to the output side packet collection.
@@ -105,6 +150,24 @@ class CalculatorContext {
   // Returns a const reference to the output stream collection.
   const OutputStreamShardSet& Outputs() const;
 
+  // Completes a Process() call deferred by DeferProcessCompletion(), with the
+  // status of the call.
+  using ProcessCompletion = std::function<void(absl::Status)>;
+
+  // Defers the completion of the current Process() call, so that a calculator
+  // waiting on I/O or on the GPU can return from Process() and release its
+  // executor thread. The returned callback must be invoked exactly once, from
+  // any thread, after all the outputs of the call are added to Outputs(). The
+  // status it receives replaces the status returned by Process(), unless that
+  // is an error. This context and its inputs stay valid until then, and the
+  // outputs and timestamp bounds are propagated in order as if Process()
+  // returned at that point.
+  //
+  // Returns nullptr if the completion cannot be deferred, in which case the
+  // call must complete before Process() returns. Only calls that process a
+  // single input set of a non-source node can be deferred.
+  ProcessCompletion DeferProcessCompletion();
+
   // Sets this packet timestamp offset for Packets going to all outputs.
   // If you only want to set the offset for a single output stream then
   // use OutputStream::SetOffset() directly.
@@ -144,16 +207,30 @@ class CalculatorContext {
 
   // Adds a new input timestamp by the friend class CalculatorContextManager.
   void PushInputTimestamp(Timestamp input_timestamp) {
-    input_timestamps_.push(input_timestamp);
+    input_timestamps_.push_back(input_timestamp);
   }
 
   void PopInputTimestamp() {
     ABSL_CHECK(!input_timestamps_.empty());
-    input_timestamps_.pop();
+    input_timestamps_.pop_front();
   }
 
   void SetGraphStatus(const absl::Status& status) { graph_status_ = status; }
 
+  void SetInputBatchSize(int input_batch_size) {
+    input_batch_size_ = input_batch_size;
+  }
+
+  // Interface for the friend class CalculatorNode, which sets
+  // deferred_process_handler_ while a Process() call can be deferred.
+  bool ProcessDeferred() const {
+    return deferred_process_refs_.load(std::memory_order_relaxed) != 0;
+  }
+
+  // Releases a deferred Process() call, for the framework or the calculator.
+  // Returns true for the last release, with the status of the call in *status.
+  bool ReleaseDeferredProcess(absl::Status* status);
+
   // Interface for the friend class Calculator.
   const InputStreamSet& InputStreams() const;
   const OutputStreamSet& OutputStreams() const;
@@ -170,13 +247,28 @@ class CalculatorContext {
   mutable std::unique_ptr<InputStreamSet> input_streams_;
   mutable std::unique_ptr<OutputStreamSet> output_streams_;
   // The queue of timestamp values to Process() in this calculator context.
-  std::queue<Timestamp> input_timestamps_;
+  std::deque<Timestamp> input_timestamps_;
+  // The number of input sets presented to the current Process() call.
+  int input_batch_size_ = 1;
 
   // The status of the graph run. Only used when Close() is called.
   absl::Status graph_status_;
 
+  // Finishes a deferred Process() call that completes after Process()
+  // returns. Not owned.
+  const std::function<void(CalculatorContext*, absl::Status)>*
+      deferred_process_handler_ = nullptr;
+  // The number of releases left of a deferred Process() call: one by the
+  // framework when Process() returns, and one by the ProcessCompletion.
+  std::atomic<int> deferred_process_refs_{0};
+  // The statuses of a deferred Process() call, written before the release.
+  absl::Status deferred_process_status_;
+  absl::Status deferred_completion_status_;
+
   // Accesses CalculatorContext for setting input timestamp.
   friend class CalculatorContextManager;
+  // Accesses CalculatorContext for deferring Process() calls.
+  friend class CalculatorNode;
 };
 
 }  // namespace mediapipe
@@ -107,6 +107,19 @@ class CalculatorContextManager {
     calculator_context->PopInputTimestamp();
   }
 
+  // Returns the input timestamp at index in the queue of input timestamps of
+  // the calculator context.
+  Timestamp ContextInputTimestamp(const CalculatorContext& calculator_context,
+                                  int index) const {
+    return calculator_context.input_timestamps_[index];
+  }
+
+  void SetInputBatchSizeInContext(CalculatorContext* calculator_context,
+                                  int input_batch_size) {
+    ABSL_CHECK(calculator_context);
+    calculator_context->SetInputBatchSize(input_batch_size);
+  }
+
   void SetGraphStatusInContext(CalculatorContext* calculator_context,
                                const absl::Status& status) {
     ABSL_CHECK(calculator_context);
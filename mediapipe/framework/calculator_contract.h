@@ -131,6 +131,15 @@ class CalculatorContract {
   }
   bool GetProcessTimestampBounds() const { return process_timestamps_; }
 
+  // When true, and the input stream handler collects batches of input sets
+  // (see BatchingInputStreamHandler), Process is called once for each batch
+  // instead of once for each input set of the batch. See
+  // CalculatorContext::InputBatchSize() and InputStreamShard::BatchValue().
+  void SetProcessInputBatches(bool process_input_batches) {
+    process_input_batches_ = process_input_batches;
+  }
+  bool GetProcessInputBatches() const { return process_input_batches_; }
+
   // Specifies the maximum difference between input and output timestamps.
   // When specified, the mediapipe framework automatically computes output
   // timestamp bounds based on input timestamps.  The special value
@@ -209,6 +218,7 @@ class CalculatorContract {
   std::string node_name_;
   ServiceReqMap service_requests_;
   bool process_timestamps_ = false;
+  bool process_input_batches_ = false;
   TimestampDiff timestamp_offset_ = TimestampDiff::Unset();
 
   friend class CalculatorNode;
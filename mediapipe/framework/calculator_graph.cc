@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -51,6 +52,7 @@
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/packet_generator.h"
 #include "mediapipe/framework/packet_generator.pb.h"
+#include "mediapipe/framework/packet_generator_cache.h"
 #include "mediapipe/framework/packet_set.h"
 #include "mediapipe/framework/packet_type.h"
 #include "mediapipe/framework/port.h"
@@ -63,6 +65,7 @@
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/port/status_builder.h"
 #include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/profiler/stream_memory_gauge.h"
 #include "mediapipe/framework/scheduler.h"
 #include "mediapipe/framework/status_handler.h"
 #include "mediapipe/framework/status_handler.pb.h"
@@ -177,6 +180,8 @@ absl::Status CalculatorGraph::InitializePacketGeneratorGraph(
   }
   // If default_executor is nullptr, then packet_generator_graph_ will create
   // its own DelegatingExecutor to use the application thread.
+  packet_generator_graph_.SetCache(
+      service_manager_.GetServiceObject(kPacketGeneratorCacheService));
   return packet_generator_graph_.Initialize(validated_graph_.get(),
                                             default_executor, side_packets);
 }
@@ -192,6 +197,16 @@ absl::Status CalculatorGraph::InitializeStreams() {
     const EdgeInfo& edge_info = validated_graph_->InputStreamInfos()[index];
     MP_RETURN_IF_ERROR(input_stream_managers_[index].Initialize(
         edge_info.name, edge_info.packet_type, edge_info.back_edge));
+    // Packets reach input streams only through their upstream output stream,
+    // which validates them. When the types were resolved to match while
+    // validating the graph config, as with the typed ports of the api2 graph
+    // builder, validating each packet again is redundant.
+    if (edge_info.upstream >= 0 &&
+        edge_info.packet_type->AcceptsAllOf(
+            *validated_graph_->OutputStreamInfos()[edge_info.upstream]
+                 .packet_type)) {
+      input_stream_managers_[index].DisablePacketTypeValidation();
+    }
     input_stream_to_index_[&input_stream_managers_[index]] = index;
   }
 
@@ -245,7 +260,10 @@ absl::Status CalculatorGraph::InitializeStreams() {
 // be retired yet?
 static void MaybeFixupLegacyGpuNodeContract(CalculatorNode& node) {
 #if !MEDIAPIPE_DISABLE_GPU
-  if (node.Contract().InputSidePackets().HasTag(kGpuSharedTagName)) {
+  // The contract may be shared with other graphs through their
+  // ValidatedGraphConfig, so it is only modified once.
+  if (node.Contract().InputSidePackets().HasTag(kGpuSharedTagName) &&
+      !node.Contract().ServiceRequests().contains(kGpuService.key)) {
     const_cast<CalculatorContract&>(node.Contract()).UseService(kGpuService);
   }
 #endif  // !MEDIAPIPE_DISABLE_GPU
@@ -328,6 +346,37 @@ absl::Status CalculatorGraph::InitializeProfiler() {
   return absl::OkStatus();
 }
 
+void CalculatorGraph::InitializeQueueBytes() {
+  max_queue_bytes_ = validated_graph_->Config().max_queue_bytes();
+  for (int index = 0; index < validated_graph_->InputStreamInfos().size();
+       ++index) {
+    StreamMemoryGauge* gauge = profiler_->GetStreamMemoryGauge(index);
+    if (!gauge && max_queue_bytes_ <= 0) {
+      continue;
+    }
+    input_stream_managers_[index].SetQueueBytesCallback(
+        [this, gauge](int64_t delta) {
+          if (gauge) {
+            gauge->Add(delta);
+          }
+          UpdateQueueBytes(delta);
+        });
+  }
+}
+
+void CalculatorGraph::InitializeStreamLatency() {
+  for (int index = 0; index < validated_graph_->OutputStreamInfos().size();
+       ++index) {
+    if (!profiler_->IsStreamLatencyMeasured(index)) {
+      continue;
+    }
+    output_stream_managers_[index].SetPacketsCallback(
+        [this, index](const std::list<Packet>& packets) {
+          profiler_->RecordStreamPackets(index, packets);
+        });
+  }
+}
+
 absl::Status CalculatorGraph::InitializeExecutors() {
   // If the ExecutorConfig for the default executor leaves the executor type
   // unspecified, default_executor_options points to the
@@ -391,9 +440,11 @@ absl::Status CalculatorGraph::InitializeExecutors() {
 absl::Status CalculatorGraph::InitializeDefaultExecutor(
     const ThreadPoolExecutorOptions* default_executor_options,
     bool use_application_thread) {
-#ifdef __EMSCRIPTEN__
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  // Without pthreads there are no other threads to run calculators on. With
+  // pthreads, the default thread pool runs on web workers.
   use_application_thread = true;
-#endif  // __EMSCRIPTEN__
+#endif  // __EMSCRIPTEN__ && !__EMSCRIPTEN_PTHREADS__
   // If specified, run synchronously on the calling thread.
   if (use_application_thread) {
     use_application_thread_ = true;
@@ -427,8 +478,10 @@ absl::Status CalculatorGraph::InitializeDefaultExecutor(
 }
 
 absl::Status CalculatorGraph::Initialize(
-    std::unique_ptr<ValidatedGraphConfig> validated_graph,
+    std::shared_ptr<const ValidatedGraphConfig> validated_graph,
     const std::map<std::string, Packet>& side_packets) {
+  RET_CHECK(validated_graph).SetNoLogging()
+      << "validated_graph must not be null.";
   RET_CHECK(!initialized_).SetNoLogging()
       << "CalculatorGraph can be initialized only once.";
   RET_CHECK(validated_graph->Initialized()).SetNoLogging()
@@ -436,12 +489,19 @@ absl::Status CalculatorGraph::Initialize(
   validated_graph_ = std::move(validated_graph);
 
   MP_RETURN_IF_ERROR(InitializeExecutors());
+  scheduler_.SetDeadlineBudget(validated_graph_->Config().deadline_budget_us());
+  if (validated_graph_->Config().packet_arena_block_size() > 0) {
+    packet_arena_ = std::make_unique<PacketArena>(
+        validated_graph_->Config().packet_arena_block_size());
+  }
   MP_RETURN_IF_ERROR(InitializePacketGeneratorGraph(side_packets));
   MP_RETURN_IF_ERROR(InitializeStreams());
   MP_RETURN_IF_ERROR(InitializeCalculatorNodes());
 #ifdef MEDIAPIPE_PROFILER_AVAILABLE
   MP_RETURN_IF_ERROR(InitializeProfiler());
 #endif
+  InitializeQueueBytes();
+  InitializeStreamLatency();
 
   initialized_ = true;
   return absl::OkStatus();
@@ -543,9 +603,22 @@ absl::StatusOr<Packet> CalculatorGraph::GetOutputSidePacket(
                !current_run_side_packet_iter->second.IsEmpty()) {
       output_packet = current_run_side_packet_iter->second;
     } else {
-      return mediapipe::UnavailableErrorBuilder(MEDIAPIPE_LOC)
-             << "The output side packet \"" << packet_name
-             << "\" is unavailable.";
+      // Generators whose outputs are unused in the graph run on demand.
+      absl::StatusOr<Packet> deferred_packet =
+          packet_generator_graph_.GenerateDeferredSidePacket(
+              packet_name, current_run_side_packets_.empty()
+                               ? base_packets
+                               : current_run_side_packets_);
+      if (!deferred_packet.ok() &&
+          !absl::IsUnavailable(deferred_packet.status())) {
+        return deferred_packet.status();
+      }
+      if (!deferred_packet.ok()) {
+        return mediapipe::UnavailableErrorBuilder(MEDIAPIPE_LOC)
+               << "The output side packet \"" << packet_name
+               << "\" is unavailable.";
+      }
+      output_packet = *deferred_packet;
     }
   }
   return output_packet;
@@ -690,6 +763,7 @@ absl::Status CalculatorGraph::PrepareForRun(
     has_error_ = false;
   }
   num_closed_graph_input_streams_ = 0;
+  cancelled_timestamps_.Clear();
 
   std::map<std::string, Packet> additional_side_packets;
 #if !MEDIAPIPE_DISABLE_GPU
@@ -761,6 +835,11 @@ absl::Status CalculatorGraph::PrepareForRun(
     full_input_streams_.clear();
     full_input_streams_.resize(validated_graph_->CalculatorInfos().size() +
                                graph_input_streams_.size());
+    // The byte budget raised by UnthrottleSources() in the previous run is
+    // restored. The streams release their remaining bytes as they are
+    // prepared below.
+    max_queue_bytes_ = validated_graph_->Config().max_queue_bytes();
+    queue_bytes_exceeded_ = false;
   }
 
   for (auto& item : graph_input_streams_) {
@@ -789,7 +868,8 @@ absl::Status CalculatorGraph::PrepareForRun(
         std::bind(&internal::Scheduler::ScheduleNodeIfNotThrottled, &scheduler_,
                   node.get(), std::placeholders::_1),
         std::bind(&CalculatorGraph::RecordError, this, std::placeholders::_1),
-        counter_factory_.get());
+        counter_factory_.get(), packet_arena_.get(), &executors_,
+        &cancelled_timestamps_);
     if (!result.ok()) {
       // Collect as many errors as we can before failing.
       RecordError(result);
@@ -912,79 +992,155 @@ absl::Status CalculatorGraph::SetInputStreamTimestampBound(
   return absl::OkStatus();
 }
 
-// We avoid having two copies of this code for AddPacketToInputStream(
-// const Packet&) and AddPacketToInputStream(Packet &&) by having this
-// internal-only templated version.  T&& is a forwarding reference here, so
-// std::forward will deduce the correct type as we pass along packet.
-template <typename T>
-absl::Status CalculatorGraph::AddPacketToInputStreamInternal(
-    const std::string& stream_name, T&& packet) {
+absl::Status CalculatorGraph::AddPacketsToInputStream(
+    const std::string& stream_name, absl::Span<const Packet> packets) {
+  return AddPacketsToInputStreamInternal(stream_name, packets);
+}
+
+absl::Status CalculatorGraph::AddPacketsToInputStream(
+    const std::string& stream_name, std::vector<Packet>&& packets) {
+  return AddPacketsToInputStreamInternal(stream_name, std::move(packets));
+}
+
+absl::Status CalculatorGraph::AddPacketsToInputStreams(
+    const std::map<std::string, Packet>& stream_packets) {
+  std::vector<GraphInputStream*> streams;
+  std::vector<int> node_ids;
+  streams.reserve(stream_packets.size());
+  node_ids.reserve(stream_packets.size());
+  for (const auto& [stream_name, packet] : stream_packets) {
+    ASSIGN_OR_RETURN(GraphInputStream * stream,
+                     GetGraphInputStream(stream_name, "AddPacketsToInputStreams"));
+    streams.push_back(stream);
+    node_ids.push_back(
+        mediapipe::FindOrDie(graph_input_stream_node_ids_, stream_name));
+  }
+  MP_RETURN_IF_ERROR(WaitUntilGraphInputStreamsNotFull(node_ids));
+
+  int i = 0;
+  for (const auto& [stream_name, packet] : stream_packets) {
+    LogGraphInputPacket(streams[i], packet);
+    streams[i]->AddPacket(packet);
+    ++i;
+  }
+  if (has_error_) {
+    absl::Status error_status;
+    GetCombinedErrors("Graph has errors: ", &error_status);
+    return error_status;
+  }
+  for (GraphInputStream* stream : streams) {
+    stream->PropagateUpdatesToMirrors();
+  }
+  VLOG(2) << "Packets added directly to " << streams.size() << " streams.";
+  scheduler_.AddedPacketToGraphInputStream();
+  return absl::OkStatus();
+}
+
+absl::StatusOr<CalculatorGraph::GraphInputStream*>
+CalculatorGraph::GetGraphInputStream(const std::string& stream_name,
+                                     absl::string_view method_name) {
   std::unique_ptr<GraphInputStream>* stream =
       mediapipe::FindOrNull(graph_input_streams_, stream_name);
   RET_CHECK(stream).SetNoLogging() << absl::Substitute(
-      "AddPacketToInputStream called on input stream \"$0\" which is not a "
-      "graph input stream.",
-      stream_name);
-  int node_id = mediapipe::FindOrDie(graph_input_stream_node_ids_, stream_name);
-  ABSL_CHECK_GE(node_id, validated_graph_->CalculatorInfos().size());
-  {
-    absl::MutexLock lock(&full_input_streams_mutex_);
-    if (full_input_streams_.empty()) {
-      return mediapipe::FailedPreconditionErrorBuilder(MEDIAPIPE_LOC)
-             << "CalculatorGraph::AddPacketToInputStream() is called before "
-                "StartRun()";
+      "$0 called on input stream \"$1\" which is not a graph input stream.",
+      method_name, stream_name);
+  return stream->get();
+}
+
+absl::Status CalculatorGraph::WaitUntilGraphInputStreamsNotFull(
+    absl::Span<const int> node_ids) {
+  for (int node_id : node_ids) {
+    ABSL_CHECK_GE(node_id, validated_graph_->CalculatorInfos().size());
+  }
+  absl::MutexLock lock(&full_input_streams_mutex_);
+  if (full_input_streams_.empty()) {
+    return mediapipe::FailedPreconditionErrorBuilder(MEDIAPIPE_LOC)
+           << "CalculatorGraph::AddPacketToInputStream() is called before "
+              "StartRun()";
+  }
+  auto any_stream_full = [this, node_ids]()
+                             ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+                                 full_input_streams_mutex_) {
+                               if (queue_bytes_exceeded_) {
+                                 return true;
+                               }
+                               for (int node_id : node_ids) {
+                                 if (!full_input_streams_[node_id].empty()) {
+                                   return true;
+                                 }
+                               }
+                               return false;
+                             };
+  if (graph_input_stream_add_mode_ ==
+      GraphInputStreamAddMode::ADD_IF_NOT_FULL) {
+    if (has_error_) {
+      absl::Status error_status;
+      GetCombinedErrors("Graph has errors: ", &error_status);
+      return error_status;
     }
-    if (graph_input_stream_add_mode_ ==
-        GraphInputStreamAddMode::ADD_IF_NOT_FULL) {
-      if (has_error_) {
-        absl::Status error_status;
-        GetCombinedErrors("Graph has errors: ", &error_status);
-        return error_status;
-      }
-      // Return with StatusUnavailable if this stream is being throttled.
-      if (!full_input_streams_[node_id].empty()) {
-        return mediapipe::UnavailableErrorBuilder(MEDIAPIPE_LOC)
-               << "Graph is throttled.";
-      }
-    } else if (graph_input_stream_add_mode_ ==
-               GraphInputStreamAddMode::WAIT_TILL_NOT_FULL) {
-      // Wait until this stream is not being throttled.
-      // TODO: instead of checking has_error_, we could just check
-      // if the graph is done. That could also be indicated by returning an
-      // error from WaitUntilGraphInputStreamUnthrottled.
-      while (!has_error_ && !full_input_streams_[node_id].empty()) {
-        // TODO: allow waiting for a specific stream?
-        scheduler_.WaitUntilGraphInputStreamUnthrottled(
-            &full_input_streams_mutex_);
-      }
-      if (has_error_) {
-        absl::Status error_status;
-        GetCombinedErrors("Graph has errors: ", &error_status);
-        return error_status;
-      }
+    // Return with StatusUnavailable if this stream is being throttled.
+    if (any_stream_full()) {
+      return mediapipe::UnavailableErrorBuilder(MEDIAPIPE_LOC)
+             << "Graph is throttled.";
+    }
+  } else if (graph_input_stream_add_mode_ ==
+             GraphInputStreamAddMode::WAIT_TILL_NOT_FULL) {
+    // Wait until this stream is not being throttled.
+    // TODO: instead of checking has_error_, we could just check
+    // if the graph is done. That could also be indicated by returning an
+    // error from WaitUntilGraphInputStreamUnthrottled.
+    while (!has_error_ && any_stream_full()) {
+      // TODO: allow waiting for a specific stream?
+      scheduler_.WaitUntilGraphInputStreamUnthrottled(
+          &full_input_streams_mutex_);
+    }
+    if (has_error_) {
+      absl::Status error_status;
+      GetCombinedErrors("Graph has errors: ", &error_status);
+      return error_status;
     }
   }
+  return absl::OkStatus();
+}
 
+void CalculatorGraph::LogGraphInputPacket(GraphInputStream* stream,
+                                          const Packet& packet) {
   // Adding profiling info for a new packet entering the graph.
-  const std::string* stream_id = &(*stream)->GetManager()->Name();
+  const std::string* stream_id = &stream->GetManager()->Name();
   profiler_->LogEvent(TraceEvent(TraceEvent::PROCESS)
                           .set_is_finish(true)
                           .set_input_ts(packet.Timestamp())
                           .set_stream_id(stream_id)
                           .set_packet_ts(packet.Timestamp())
                           .set_packet_data_id(&packet));
+  scheduler_.AddedGraphInputTimestamp(packet.Timestamp());
+}
+
+// We avoid having two copies of this code for AddPacketToInputStream(
+// const Packet&) and AddPacketToInputStream(Packet &&) by having this
+// internal-only templated version.  T&& is a forwarding reference here, so
+// std::forward will deduce the correct type as we pass along packet.
+template <typename T>
+absl::Status CalculatorGraph::AddPacketToInputStreamInternal(
+    const std::string& stream_name, T&& packet) {
+  ASSIGN_OR_RETURN(GraphInputStream * stream,
+                   GetGraphInputStream(stream_name, "AddPacketToInputStream"));
+  int node_id = mediapipe::FindOrDie(graph_input_stream_node_ids_, stream_name);
+  MP_RETURN_IF_ERROR(WaitUntilGraphInputStreamsNotFull({node_id}));
+
+  LogGraphInputPacket(stream, packet);
 
   // InputStreamManager is thread safe. GraphInputStream is not, so this method
   // should not be called by multiple threads concurrently. Note that this could
   // potentially lead to the max queue size being exceeded by one packet at most
   // because we don't have the lock over the input stream.
-  (*stream)->AddPacket(std::forward<T>(packet));
+  stream->AddPacket(std::forward<T>(packet));
   if (has_error_) {
     absl::Status error_status;
     GetCombinedErrors("Graph has errors: ", &error_status);
     return error_status;
   }
-  (*stream)->PropagateUpdatesToMirrors();
+  stream->PropagateUpdatesToMirrors();
 
   VLOG(2) << "Packet added directly to: " << stream_name;
   // Note: one reason why we need to call the scheduler here is that we have
@@ -995,6 +1151,36 @@ absl::Status CalculatorGraph::AddPacketToInputStreamInternal(
   return absl::OkStatus();
 }
 
+// Same as AddPacketToInputStreamInternal, for a batch of packets. T is a
+// container of packets, and its packets are moved if T is an r-value.
+template <typename T>
+absl::Status CalculatorGraph::AddPacketsToInputStreamInternal(
+    const std::string& stream_name, T&& packets) {
+  ASSIGN_OR_RETURN(GraphInputStream * stream,
+                   GetGraphInputStream(stream_name, "AddPacketsToInputStream"));
+  int node_id = mediapipe::FindOrDie(graph_input_stream_node_ids_, stream_name);
+  MP_RETURN_IF_ERROR(WaitUntilGraphInputStreamsNotFull({node_id}));
+
+  for (auto& packet : packets) {
+    LogGraphInputPacket(stream, packet);
+    if constexpr (std::is_rvalue_reference<T&&>::value) {
+      stream->AddPacket(std::move(packet));
+    } else {
+      stream->AddPacket(packet);
+    }
+  }
+  if (has_error_) {
+    absl::Status error_status;
+    GetCombinedErrors("Graph has errors: ", &error_status);
+    return error_status;
+  }
+  stream->PropagateUpdatesToMirrors();
+
+  VLOG(2) << packets.size() << " packets added directly to: " << stream_name;
+  scheduler_.AddedPacketToGraphInputStream();
+  return absl::OkStatus();
+}
+
 absl::Status CalculatorGraph::SetInputStreamMaxQueueSize(
     const std::string& stream_name, int max_queue_size) {
   // graph_input_streams_ has not been filled in yet, so we'll check this when
@@ -1216,8 +1402,59 @@ void CalculatorGraph::UpdateThrottledNodes(InputStreamManager* stream,
   }
 }
 
+void CalculatorGraph::UpdateQueueBytes(int64_t delta) {
+  const int64_t queue_bytes = queue_bytes_.fetch_add(delta) + delta;
+  const int64_t max_queue_bytes = max_queue_bytes_;
+  if (max_queue_bytes <= 0 ||
+      (queue_bytes > max_queue_bytes) == queue_bytes_exceeded_) {
+    return;
+  }
+  std::vector<CalculatorNode*> nodes_to_schedule;
+  {
+    absl::MutexLock lock(&full_input_streams_mutex_);
+    // The limit is rechecked within the MutexLock in order to avoid
+    // interference between callbacks arriving out of order.
+    const bool exceeded = queue_bytes_ > max_queue_bytes_;
+    if (exceeded == queue_bytes_exceeded_ || full_input_streams_.empty()) {
+      return;
+    }
+    queue_bytes_exceeded_ = exceeded;
+    VLOG(2) << "Queued payload bytes " << queue_bytes_ << " are "
+            << (exceeded ? "throttling" : "no longer throttling")
+            << " the graph with max_queue_bytes " << max_queue_bytes_;
+    if (!graph_input_streams_.empty()) {
+      // All graph input streams are throttled together, and are counted by
+      // the scheduler as a single throttled graph input stream.
+      if (exceeded) {
+        scheduler_.ThrottledGraphInputStream();
+      } else {
+        scheduler_.UnthrottledGraphInputStream();
+      }
+    }
+    if (!exceeded) {
+      for (int node_id = 0;
+           node_id < validated_graph_->CalculatorInfos().size(); ++node_id) {
+        CalculatorNode& node = *nodes_[node_id];
+        if (node.IsSource() && node.Active() && !node.Closed() &&
+            full_input_streams_[node_id].empty()) {
+          nodes_to_schedule.emplace_back(&node);
+        }
+      }
+    }
+  }
+
+  if (!nodes_to_schedule.empty()) {
+    scheduler_.ScheduleUnthrottledReadyNodes(nodes_to_schedule);
+  }
+}
+
 bool CalculatorGraph::IsNodeThrottled(int node_id) {
   absl::MutexLock lock(&full_input_streams_mutex_);
+  if (queue_bytes_exceeded_ &&
+      node_id < validated_graph_->CalculatorInfos().size() &&
+      nodes_[node_id]->IsSource()) {
+    return true;
+  }
   return max_queue_size_ != -1 && !full_input_streams_[node_id].empty();
 }
 
@@ -1242,8 +1479,10 @@ bool CalculatorGraph::UnthrottleSources() {
   // stream during each call to UnthrottleSources will eventually resolve
   // each deadlock.
   absl::flat_hash_set<InputStreamManager*> full_streams;
+  bool queue_bytes_exceeded;
   {
     absl::MutexLock lock(&full_input_streams_mutex_);
+    queue_bytes_exceeded = queue_bytes_exceeded_;
     for (absl::flat_hash_set<InputStreamManager*>& s : full_input_streams_) {
       for (auto& stream : s) {
         // The queue size of a graph output stream shouldn't change. Throttling
@@ -1273,7 +1512,27 @@ bool CalculatorGraph::UnthrottleSources() {
         "\" to ", new_size,
         ". Consider increasing max_queue_size for better performance.");
   }
-  return !full_streams.empty();
+  if (queue_bytes_exceeded) {
+    if (Config().report_deadlock()) {
+      RecordError(absl::UnavailableError(absl::StrCat(
+          "Detected a deadlock due to input throttling: ", queue_bytes_.load(),
+          " payload bytes are queued in input streams, exceeding "
+          "\"max_queue_bytes\" of ",
+          max_queue_bytes_.load(),
+          ". All calculators are idle while packet sources remain active "
+          "and throttled.  Consider adjusting \"max_queue_bytes\" or "
+          "\"report_deadlock\".")));
+    } else {
+      const int64_t new_max_queue_bytes = queue_bytes_ + 1;
+      max_queue_bytes_ = new_max_queue_bytes;
+      UpdateQueueBytes(0);
+      ABSL_LOG_EVERY_N(WARNING, 100) << absl::StrCat(
+          "Resolved a deadlock by increasing max_queue_bytes to ",
+          new_max_queue_bytes,
+          ". Consider increasing max_queue_bytes for better performance.");
+    }
+  }
+  return !full_streams.empty() || queue_bytes_exceeded;
 }
 
 CalculatorGraph::GraphInputStreamAddMode
@@ -1292,6 +1551,10 @@ void CalculatorGraph::Cancel() {
   scheduler_.Cancel();
 }
 
+void CalculatorGraph::CancelTimestamp(Timestamp timestamp) {
+  cancelled_timestamps_.Cancel(timestamp);
+}
+
 void CalculatorGraph::Pause() { scheduler_.Pause(); }
 
 void CalculatorGraph::Resume() { scheduler_.Resume(); }
@@ -1459,4 +1722,16 @@ absl::Status CalculatorGraph::GetCalculatorProfiles(
   return profiler_->GetCalculatorProfiles(profiles);
 }
 
+std::map<std::string, absl::Duration> CalculatorGraph::GetNodeOpenDurations()
+    const {
+  std::map<std::string, absl::Duration> open_durations;
+  for (const auto& node : nodes_) {
+    const absl::Duration open_duration = node->OpenDuration();
+    if (open_duration > absl::ZeroDuration()) {
+      open_durations[node->GetCalculatorState().NodeName()] = open_duration;
+    }
+  }
+  return open_durations;
+}
+
 }  // namespace mediapipe
@@ -32,10 +32,14 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_base.h"
 #include "mediapipe/framework/calculator_node.h"
+#include "mediapipe/framework/cancelled_timestamps.h"
 #include "mediapipe/framework/counter_factory.h"
 #include "mediapipe/framework/executor.h"
 #include "mediapipe/framework/graph_output_stream.h"
@@ -47,6 +51,7 @@
 #include "mediapipe/framework/output_stream_poller.h"
 #include "mediapipe/framework/output_stream_shard.h"
 #include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/packet_arena.h"
 #include "mediapipe/framework/packet_generator_graph.h"
 #include "mediapipe/framework/scheduler.h"
 #include "mediapipe/framework/scheduler_shared.h"
@@ -145,6 +150,12 @@ class CalculatorGraph {
       const std::string& graph_type = "",
       const Subgraph::SubgraphOptions* options = nullptr);
 
+  // Initializes the graph from an initialized ValidatedGraphConfig, which may
+  // be shared with other graphs, e.g. through a ValidatedGraphConfigCache.
+  absl::Status Initialize(
+      std::shared_ptr<const ValidatedGraphConfig> validated_graph,
+      const std::map<std::string, Packet>& side_packets = {});
+
   // Returns the canonicalized CalculatorGraphConfig for this graph.
   const CalculatorGraphConfig& Config() const {
     return validated_graph_->Config();
@@ -268,6 +279,25 @@ class CalculatorGraph {
   absl::Status AddPacketToInputStream(const std::string& stream_name,
                                       Packet&& packet);
 
+  // Adds several packets, in increasing timestamp order, to a graph input
+  // stream. This is equivalent to calling AddPacketToInputStream for each
+  // packet, except that the graph input stream add mode is applied once for
+  // the whole batch, and the packets are delivered to the downstream nodes
+  // and the scheduler is notified once. On error, nothing is added.
+  absl::Status AddPacketsToInputStream(const std::string& stream_name,
+                                       absl::Span<const Packet> packets);
+
+  // Same as the above, but moves the packets into the stream.
+  absl::Status AddPacketsToInputStream(const std::string& stream_name,
+                                       std::vector<Packet>&& packets);
+
+  // Adds one packet to each of several graph input streams, such as the
+  // packets of all graph inputs at one timestamp. The graph input stream add
+  // mode is applied once, taking all of the streams into account, and the
+  // scheduler is notified once. On error, nothing is added.
+  absl::Status AddPacketsToInputStreams(
+      const std::map<std::string, Packet>& stream_packets);
+
   // Indicates that input will arrive no earlier than a certain timestamp.
   absl::Status SetInputStreamTimestampBound(const std::string& stream_name,
                                             Timestamp timestamp);
@@ -307,6 +337,11 @@ class CalculatorGraph {
   ABSL_DEPRECATED("Use profiler()->GetCalculatorProfiles() instead")
   absl::Status GetCalculatorProfiles(std::vector<CalculatorProfile>*) const;
 
+  // Returns the wall time spent in Open() by each calculator opened in the
+  // current or last graph run, keyed by node name. Calculators are opened
+  // concurrently if CalculatorGraphConfig::open_nodes_concurrently is set.
+  std::map<std::string, absl::Duration> GetNodeOpenDurations() const;
+
   // Set the type of counter used in this graph.
   void SetCounterFactory(CounterFactory* factory) {
     counter_factory_.reset(factory);
@@ -341,6 +376,14 @@ class CalculatorGraph {
   // completed.
   void Cancel();
 
+  // Abandons the work for a timestamp in the current run, for example a frame
+  // whose results are no longer needed. Nodes skip Process() for input sets
+  // at the timestamp that are not yet processing, and propagate only its
+  // timestamp bound; calculators already processing it can stop early by
+  // checking CalculatorContext::IsCancelled(). Only the latest cancelled
+  // timestamps are remembered. Thread-safe.
+  void CancelTimestamp(Timestamp timestamp);
+
   // Pauses the scheduler. Only used by calculator graph testing.
   ABSL_DEPRECATED(
       "CalculatorGraph will not allow external callers to explictly pause and "
@@ -367,14 +410,16 @@ class CalculatorGraph {
   }
 
   // Returns true if this node or graph input stream is connected to
-  // any input stream whose queue has hit maximum capacity.
+  // any input stream whose queue has hit maximum capacity, or if this is a
+  // source node and the queued payload bytes exceed max_queue_bytes.
   bool IsNodeThrottled(int node_id)
       ABSL_LOCKS_EXCLUDED(full_input_streams_mutex_);
 
   // If any active source node or graph input stream is throttled and not yet
   // closed, increases the max_queue_size for each full input stream in the
-  // graph.
-  // Returns true if at least one max_queue_size has been grown.
+  // graph, and increases max_queue_bytes if it is exceeded.
+  // Returns true if at least one max_queue_size or max_queue_bytes has been
+  // grown.
   bool UnthrottleSources() ABSL_LOCKS_EXCLUDED(full_input_streams_mutex_);
 
   // Returns the scheduler's runtime measures for overhead measurement.
@@ -501,13 +546,27 @@ class CalculatorGraph {
     OutputStreamShard shard_;
   };
 
-  // Initializes the graph from a ValidatedGraphConfig object.
-  absl::Status Initialize(std::unique_ptr<ValidatedGraphConfig> validated_graph,
-                          const std::map<std::string, Packet>& side_packets);
-
   // AddPacketToInputStreamInternal template is called by either
   // AddPacketToInputStream(Packet&& packet) or
   // AddPacketToInputStream(const Packet& packet).
+  template <typename T>
+  absl::Status AddPacketsToInputStreamInternal(const std::string& stream_name,
+                                               T&& packets);
+
+  // Returns the GraphInputStream for "stream_name", or an error mentioning
+  // "method_name" if it is not a graph input stream.
+  absl::StatusOr<GraphInputStream*> GetGraphInputStream(
+      const std::string& stream_name, absl::string_view method_name);
+
+  // Applies the graph input stream add mode before packets are added to the
+  // graph input streams of the given virtual node ids. Returns an error if
+  // the packets should not be added.
+  absl::Status WaitUntilGraphInputStreamsNotFull(
+      absl::Span<const int> node_ids);
+
+  // Records a packet entering the graph with the profiler and the scheduler.
+  void LogGraphInputPacket(GraphInputStream* stream, const Packet& packet);
+
   template <typename T>
   absl::Status AddPacketToInputStreamInternal(const std::string& stream_name,
                                               T&& packet);
@@ -543,6 +602,8 @@ class CalculatorGraph {
       const std::map<std::string, Packet>& side_packets);
   absl::Status InitializeStreams();
   absl::Status InitializeProfiler();
+  void InitializeQueueBytes();
+  void InitializeStreamLatency();
   absl::Status InitializeCalculatorNodes();
   absl::Status InitializePacketGeneratorNodes(
       const std::vector<int>& non_scheduled_generators);
@@ -598,6 +659,12 @@ class CalculatorGraph {
   // status before taking any action.
   void UpdateThrottledNodes(InputStreamManager* stream, bool* stream_was_full);
 
+  // Updates queue_bytes_, and throttles or unthrottles the source nodes and
+  // graph input streams when queue_bytes_ crosses max_queue_bytes_. Invoked
+  // from each input stream with the change in its queued payload bytes.
+  void UpdateQueueBytes(int64_t delta)
+      ABSL_LOCKS_EXCLUDED(full_input_streams_mutex_);
+
   // Returns a comma-separated list of source nodes.
   std::string ListSourceNodes() const;
 
@@ -616,8 +683,9 @@ class CalculatorGraph {
   // A packet type that has SetAny() called on it.
   PacketType any_packet_type_;
 
-  // The ValidatedGraphConfig object defining this CalculatorGraph.
-  std::unique_ptr<ValidatedGraphConfig> validated_graph_;
+  // The ValidatedGraphConfig object defining this CalculatorGraph. It may be
+  // shared with other graphs and is not modified.
+  std::shared_ptr<const ValidatedGraphConfig> validated_graph_;
 
   // The PacketGeneratorGraph to use to generate all the input side packets.
   PacketGeneratorGraph packet_generator_graph_;
@@ -659,6 +727,19 @@ class CalculatorGraph {
   std::vector<absl::flat_hash_set<InputStreamManager*>> full_input_streams_
       ABSL_GUARDED_BY(full_input_streams_mutex_);
 
+  // The payload bytes queued in all calculator input streams. Counted only
+  // if memory accounting or max_queue_bytes is enabled.
+  std::atomic<int64_t> queue_bytes_{0};
+
+  // The limit on queue_bytes_ from CalculatorGraphConfig::max_queue_bytes,
+  // which is raised to resolve a deadlock. Zero indicates no limit.
+  std::atomic<int64_t> max_queue_bytes_{0};
+
+  // True if queue_bytes_ exceeds max_queue_bytes_, in which case all source
+  // nodes and graph input streams are throttled. Written only while holding
+  // full_input_streams_mutex_.
+  std::atomic<bool> queue_bytes_exceeded_{false};
+
   // Input stream to index within `input_stream_managers_` mapping.
   absl::flat_hash_map<InputStreamManager*, int> input_stream_to_index_;
 
@@ -675,6 +756,12 @@ class CalculatorGraph {
   // The factory for making counters associated with this graph.
   std::unique_ptr<CounterFactory> counter_factory_;
 
+  // The arena for packet payloads, if enabled by the graph config.
+  std::unique_ptr<PacketArena> packet_arena_;
+
+  // The timestamps cancelled in the current run.
+  CancelledTimestamps cancelled_timestamps_;
+
   // Executors for the scheduler, keyed by the executor's name. The default
   // executor's name is the empty string.
   std::map<std::string, std::shared_ptr<Executor>> executors_;
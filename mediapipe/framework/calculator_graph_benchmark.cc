@@ -0,0 +1,175 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmarks for the framework core: graph startup, adding packets to graph
+// input streams, and running packets through chains of pass-through nodes
+// with each input stream handler. Benchmarks that run packets through nodes
+// report the wall time per Process call in the "time_per_process" counter,
+// which approximates the scheduler overhead per Process.
+#include <cstdint>
+#include <string>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+
+namespace mediapipe {
+namespace {
+
+// The number of packets sent into a graph per benchmark iteration.
+constexpr int kPacketsPerIteration = 100;
+
+// Returns a graph with a chain of pass-through nodes from "in" to "out".
+CalculatorGraphConfig PassThroughChainConfig(int num_nodes, int num_threads) {
+  CalculatorGraphConfig config;
+  config.add_input_stream("in");
+  config.set_num_threads(num_threads);
+  for (int i = 0; i < num_nodes; ++i) {
+    CalculatorGraphConfig::Node* node = config.add_node();
+    node->set_calculator("PassThroughCalculator");
+    node->add_input_stream(i == 0 ? "in" : absl::StrCat("s", i));
+    node->add_output_stream(i == num_nodes - 1 ? "out"
+                                               : absl::StrCat("s", i + 1));
+  }
+  return config;
+}
+
+// Reports the wall time per Process call over all benchmark iterations.
+void SetTimePerProcess(benchmark::State& state, int64_t num_processes) {
+  state.counters["time_per_process"] = benchmark::Counter(
+      static_cast<double>(num_processes),
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+void BM_GraphStartup(benchmark::State& state) {
+  CalculatorGraphConfig config =
+      PassThroughChainConfig(state.range(0), /*num_threads=*/1);
+  for (auto _ : state) {
+    CalculatorGraph graph;
+    ABSL_CHECK_OK(graph.Initialize(config));
+    ABSL_CHECK_OK(graph.StartRun({}));
+    ABSL_CHECK_OK(graph.CloseAllInputStreams());
+    ABSL_CHECK_OK(graph.WaitUntilDone());
+  }
+}
+BENCHMARK(BM_GraphStartup)->Arg(1)->Arg(10)->Arg(100);
+
+void BM_AddPacketToInputStream(benchmark::State& state) {
+  CalculatorGraph graph;
+  ABSL_CHECK_OK(
+      graph.Initialize(PassThroughChainConfig(/*num_nodes=*/1,
+                                              /*num_threads=*/1)));
+  ABSL_CHECK_OK(graph.StartRun({}));
+  int64_t timestamp = 0;
+  for (auto _ : state) {
+    ABSL_CHECK_OK(graph.AddPacketToInputStream(
+        "in", MakePacket<int>(1).At(Timestamp(timestamp))));
+    if (++timestamp % kPacketsPerIteration == 0) {
+      // Keeps the input stream queue short without timing the graph.
+      state.PauseTiming();
+      ABSL_CHECK_OK(graph.WaitUntilIdle());
+      state.ResumeTiming();
+    }
+  }
+  ABSL_CHECK_OK(graph.CloseAllInputStreams());
+  ABSL_CHECK_OK(graph.WaitUntilDone());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddPacketToInputStream);
+
+// Runs kPacketsPerIteration packets through a chain of pass-through nodes in
+// each iteration. Arguments are the number of nodes and of threads.
+void BM_PassThroughChain(benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  CalculatorGraph graph;
+  ABSL_CHECK_OK(
+      graph.Initialize(PassThroughChainConfig(num_nodes, state.range(1))));
+  ABSL_CHECK_OK(graph.StartRun({}));
+  int64_t timestamp = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < kPacketsPerIteration; ++i) {
+      ABSL_CHECK_OK(graph.AddPacketToInputStream(
+          "in", MakePacket<int>(1).At(Timestamp(timestamp++))));
+    }
+    ABSL_CHECK_OK(graph.WaitUntilIdle());
+  }
+  ABSL_CHECK_OK(graph.CloseAllInputStreams());
+  ABSL_CHECK_OK(graph.WaitUntilDone());
+  state.SetItemsProcessed(state.iterations() * kPacketsPerIteration);
+  SetTimePerProcess(state, timestamp * num_nodes);
+}
+BENCHMARK(BM_PassThroughChain)
+    ->Args({1, 1})
+    ->Args({10, 1})
+    ->Args({100, 1})
+    ->Args({10, 4})
+    ->Args({100, 4})
+    ->UseRealTime();
+
+// Runs kPacketsPerIteration packets on each of two streams through a chain
+// of pass-through nodes using an input stream handler in each iteration.
+void BM_InputStreamHandler(benchmark::State& state,
+                           const std::string& handler) {
+  constexpr int kNumNodes = 10;
+  CalculatorGraphConfig config;
+  config.add_input_stream("a0");
+  config.add_input_stream("b0");
+  config.set_num_threads(1);
+  for (int i = 0; i < kNumNodes; ++i) {
+    CalculatorGraphConfig::Node* node = config.add_node();
+    node->set_calculator("PassThroughCalculator");
+    node->add_input_stream(absl::StrCat("a", i));
+    node->add_input_stream(absl::StrCat("b", i));
+    node->add_output_stream(absl::StrCat("a", i + 1));
+    node->add_output_stream(absl::StrCat("b", i + 1));
+    node->mutable_input_stream_handler()->set_input_stream_handler(handler);
+  }
+  CalculatorGraph graph;
+  ABSL_CHECK_OK(graph.Initialize(config));
+  ABSL_CHECK_OK(graph.StartRun({}));
+  int64_t timestamp = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < kPacketsPerIteration; ++i) {
+      ABSL_CHECK_OK(graph.AddPacketToInputStream(
+          "a0", MakePacket<int>(1).At(Timestamp(timestamp))));
+      ABSL_CHECK_OK(graph.AddPacketToInputStream(
+          "b0", MakePacket<int>(1).At(Timestamp(timestamp++))));
+    }
+    ABSL_CHECK_OK(graph.WaitUntilIdle());
+  }
+  ABSL_CHECK_OK(graph.CloseAllInputStreams());
+  ABSL_CHECK_OK(graph.WaitUntilDone());
+  state.SetItemsProcessed(state.iterations() * kPacketsPerIteration);
+}
+BENCHMARK_CAPTURE(BM_InputStreamHandler, Default, "DefaultInputStreamHandler")
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_InputStreamHandler, Immediate,
+                  "ImmediateInputStreamHandler")
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_InputStreamHandler, SyncSet, "SyncSetInputStreamHandler")
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_InputStreamHandler, FixedSize,
+                  "FixedSizeInputStreamHandler")
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_InputStreamHandler, Barrier, "BarrierInputStreamHandler")
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_InputStreamHandler, EarlyClose,
+                  "EarlyCloseInputStreamHandler")
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
@@ -1777,5 +1777,85 @@ TEST(CalculatorGraphBoundsTest, TimestampBoundsForInfrequentInput) {
   MP_ASSERT_OK(graph.WaitUntilDone());
 }
 
+// A Calculator that cancels the timestamps of odd input values, and reports
+// whether each input timestamp is cancelled.
+class CancelOddCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).Set<int>();
+    cc->Outputs().Index(0).SetSameAs(&cc->Inputs().Index(0));
+    cc->Outputs().Index(1).Set<bool>();
+    return absl::OkStatus();
+  }
+  absl::Status Process(CalculatorContext* cc) final {
+    if (cc->Inputs().Index(0).Get<int>() % 2 == 1) {
+      cc->CancelTimestamp(cc->InputTimestamp());
+    }
+    cc->Outputs().Index(0).AddPacket(cc->Inputs().Index(0).Value());
+    cc->Outputs().Index(1).AddPacket(
+        MakePacket<bool>(cc->IsCancelled()).At(cc->InputTimestamp()));
+    return absl::OkStatus();
+  }
+};
+REGISTER_CALCULATOR(CancelOddCalculator);
+
+// Shows that nodes skip the input sets at cancelled timestamps, whether the
+// timestamps are cancelled by the application or by a calculator.
+TEST(CalculatorGraphBoundsTest, CancelledTimestamps) {
+  std::string config_str = R"(
+            input_stream: "input_0"
+            node {
+              calculator: "CancelOddCalculator"
+              input_stream: "input_0"
+              output_stream: "output_0"
+              output_stream: "cancelled"
+            }
+            node {
+              calculator: "PassThroughCalculator"
+              input_stream: "output_0"
+              output_stream: "output_1"
+            }
+          )";
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(config_str);
+  CalculatorGraph graph;
+  std::vector<Packet> cancelled_packets;
+  std::vector<Packet> output_1_packets;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.ObserveOutputStream("cancelled", [&](const Packet& p) {
+    cancelled_packets.push_back(p);
+    return absl::OkStatus();
+  }));
+  MP_ASSERT_OK(graph.ObserveOutputStream("output_1", [&](const Packet& p) {
+    output_1_packets.push_back(p);
+    return absl::OkStatus();
+  }));
+  MP_ASSERT_OK(graph.StartRun({}));
+  graph.CancelTimestamp(Timestamp(30));
+
+  for (int i = 0; i < 6; ++i) {
+    const int ts = 10 + i * 10;
+    Packet p = MakePacket<int>(i).At(Timestamp(ts));
+    MP_ASSERT_OK(graph.AddPacketToInputStream("input_0", p));
+  }
+  MP_ASSERT_OK(graph.WaitUntilIdle());
+
+  // Timestamp 30 is skipped by both nodes, and the odd values by the
+  // PassThroughCalculator.
+  std::vector<Timestamp> cancelled_timestamps;
+  for (const Packet& p : cancelled_packets) {
+    cancelled_timestamps.push_back(p.Timestamp());
+  }
+  EXPECT_EQ(cancelled_timestamps,
+            (std::vector<Timestamp>{Timestamp(10), Timestamp(20), Timestamp(40),
+                                    Timestamp(50), Timestamp(60)}));
+  EXPECT_EQ(GetContents<bool>(cancelled_packets),
+            (std::vector<bool>{false, true, true, false, true}));
+  EXPECT_EQ(GetContents<int>(output_1_packets), (std::vector<int>{0, 4}));
+
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
 }  // namespace
 }  // namespace mediapipe
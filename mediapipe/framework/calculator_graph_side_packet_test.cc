@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -22,6 +23,7 @@
 #include "absl/time/time.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/packet_generator_cache.h"
 #include "mediapipe/framework/port/canonical_errors.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
@@ -272,6 +274,30 @@ class PassThroughGenerator : public PacketGenerator {
 };
 REGISTER_PACKET_GENERATOR(PassThroughGenerator);
 
+// Appends "!" to a string input side packet, and counts its runs.
+class CountingStringGenerator : public PacketGenerator {
+ public:
+  static absl::Status FillExpectations(
+      const PacketGeneratorOptions& extendable_options, PacketTypeSet* inputs,
+      PacketTypeSet* outputs) {
+    inputs->Index(0).Set<std::string>();
+    outputs->Index(0).Set<std::string>();
+    return absl::OkStatus();
+  }
+
+  static absl::Status Generate(const PacketGeneratorOptions& extendable_options,
+                               const PacketSet& input_side_packets,
+                               PacketSet* output_side_packets) {
+    ++num_runs;
+    output_side_packets->Index(0) = MakePacket<std::string>(
+        input_side_packets.Index(0).Get<std::string>() + "!");
+    return absl::OkStatus();
+  }
+
+  static inline std::atomic<int> num_runs = 0;
+};
+REGISTER_PACKET_GENERATOR(CountingStringGenerator);
+
 TEST(CalculatorGraph, SharePacketGeneratorGraph) {
   CalculatorGraphConfig config =
       mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
@@ -915,5 +941,87 @@ TEST(CalculatorGraph, GetOutputSidePacketAfterCalculatorIsOpened) {
   EXPECT_EQ(1, status_or_packet.value().Get<int>());
 }
 
+TEST(CalculatorGraph, PacketGeneratorCacheSharesOutputs) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "out"
+          input_side_packet: "greeting"
+          output_side_packet: "out_greeting"
+        }
+        packet_generator {
+          packet_generator: "CountingStringGenerator"
+          input_side_packet: "name"
+          output_side_packet: "greeting"
+        }
+      )pb");
+  CountingStringGenerator::num_runs = 0;
+  auto cache = std::make_shared<PacketGeneratorCache>();
+  auto run_graph = [&](const std::string& name) -> std::string {
+    CalculatorGraph graph;
+    MP_EXPECT_OK(graph.SetServiceObject(kPacketGeneratorCacheService, cache));
+    MP_EXPECT_OK(graph.Initialize(config));
+    for (int run = 0; run < 2; ++run) {
+      // Each run gets a new packet holding an equal string.
+      MP_EXPECT_OK(graph.StartRun({{"name", MakePacket<std::string>(name)}}));
+      MP_EXPECT_OK(graph.CloseAllInputStreams());
+      MP_EXPECT_OK(graph.WaitUntilDone());
+    }
+    absl::StatusOr<Packet> packet = graph.GetOutputSidePacket("out_greeting");
+    MP_EXPECT_OK(packet);
+    return packet.ok() ? packet->Get<std::string>() : "";
+  };
+
+  // Two runs of two graphs generate the greeting once.
+  EXPECT_EQ(run_graph("world"), "world!");
+  EXPECT_EQ(run_graph("world"), "world!");
+  EXPECT_EQ(CountingStringGenerator::num_runs, 1);
+  EXPECT_EQ(cache->size(), 1);
+
+  // Other input side packets generate it again.
+  EXPECT_EQ(run_graph("there"), "there!");
+  EXPECT_EQ(CountingStringGenerator::num_runs, 2);
+  EXPECT_EQ(cache->size(), 2);
+}
+
+TEST(CalculatorGraph, PacketGeneratorCacheDefersUnusedGenerators) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "out"
+        }
+        packet_generator {
+          packet_generator: "CountingStringGenerator"
+          input_side_packet: "name"
+          output_side_packet: "greeting"
+        }
+      )pb");
+  CountingStringGenerator::num_runs = 0;
+  CalculatorGraph graph;
+  auto cache = std::make_shared<PacketGeneratorCache>();
+  MP_ASSERT_OK(graph.SetServiceObject(kPacketGeneratorCacheService, cache));
+  MP_ASSERT_OK(
+      graph.Initialize(config, {{"name", MakePacket<std::string>("world")}}));
+  MP_ASSERT_OK(graph.StartRun({}));
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  // Nothing in the graph consumes the greeting.
+  EXPECT_EQ(CountingStringGenerator::num_runs, 0);
+
+  // The greeting is generated on request, once.
+  for (int i = 0; i < 2; ++i) {
+    absl::StatusOr<Packet> packet = graph.GetOutputSidePacket("greeting");
+    MP_ASSERT_OK(packet);
+    EXPECT_EQ(packet->Get<std::string>(), "world!");
+  }
+  EXPECT_EQ(CountingStringGenerator::num_runs, 1);
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -718,6 +718,27 @@ class AssertEmptyInputInOpenCalculator : public CalculatorBase {
 };
 REGISTER_CALCULATOR(AssertEmptyInputInOpenCalculator);
 
+// A calculator that checks in Open() that the graph's executor "second" is the
+// one in its input side packet, and that the default executor is available.
+class ExecutorLookupCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->InputSidePackets().Index(0).Set<Executor*>();
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) final {
+    RET_CHECK_EQ(cc->GetExecutor("second"),
+                 cc->InputSidePackets().Index(0).Get<Executor*>());
+    RET_CHECK(cc->GetExecutor("") != nullptr);
+    RET_CHECK(cc->GetExecutor("missing") == nullptr);
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) final { return absl::OkStatus(); }
+};
+REGISTER_CALCULATOR(ExecutorLookupCalculator);
+
 // A slow sink calculator that expects 10 input integers with the values
 // 0, 1, ..., 9.
 class SlowCountingSinkCalculator : public CalculatorBase {
@@ -1545,6 +1566,24 @@ TEST(CalculatorGraph, RunsCorrectlyWithNonDefaultExecutors) {
   RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
 }
 
+TEST(CalculatorGraph, CalculatorsCanLookUpExecutors) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_side_packet: "executor"
+        executor { name: "second" }
+        node {
+          calculator: "ExecutorLookupCalculator"
+          input_side_packet: "executor"
+        }
+      )pb");
+  auto executor = std::make_shared<ThreadPoolExecutor>(1);
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.SetExecutor("second", executor));
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.Run(
+      {{"executor", MakePacket<Executor*>(executor.get())}}));
+}
+
 TEST(CalculatorGraph, RunsCorrectlyWithMultipleExecutors) {
   CalculatorGraph graph;
   // Add executors "second" and "third".
@@ -1578,6 +1617,198 @@ TEST(CalculatorGraph, RunsCorrectlyWithMultipleExecutors) {
   RunComprehensiveTest(&graph, proto, /*define_node_5=*/true);
 }
 
+// An executor that queues tasks until RunAllTasks() is called.
+class ManualExecutor : public Executor {
+ public:
+  void Schedule(std::function<void()> task) override {
+    absl::MutexLock lock(&mutex_);
+    tasks_.push_back(std::move(task));
+  }
+
+  // Runs the queued tasks, including tasks queued while running, on the
+  // calling thread.
+  void RunAllTasks() {
+    while (true) {
+      std::function<void()> task;
+      {
+        absl::MutexLock lock(&mutex_);
+        if (tasks_.empty()) return;
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Appends the input timestamp of every Process() call to the vector given in
+// the input side packet.
+class TimestampRecorderCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).SetAny();
+    cc->InputSidePackets().Index(0).Set<std::vector<Timestamp>*>();
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) final {
+    cc->InputSidePackets().Index(0).Get<std::vector<Timestamp>*>()->push_back(
+        cc->InputTimestamp());
+    return absl::OkStatus();
+  }
+};
+REGISTER_CALCULATOR(TimestampRecorderCalculator);
+
+// Returns the order in which two independent nodes process a packet at
+// timestamp 1, added first, and a packet at timestamp 2, added later.
+std::vector<Timestamp> RunTwoIndependentNodes(int64_t deadline_budget_us) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in_1"
+        input_stream: "in_2"
+        node {
+          calculator: "TimestampRecorderCalculator"
+          input_stream: "in_1"
+          input_side_packet: "timestamps"
+        }
+        node {
+          calculator: "TimestampRecorderCalculator"
+          input_stream: "in_2"
+          input_side_packet: "timestamps"
+        }
+      )pb");
+  config.set_deadline_budget_us(deadline_budget_us);
+  std::vector<Timestamp> timestamps;
+  auto executor = std::make_shared<ManualExecutor>();
+  CalculatorGraph graph;
+  MP_EXPECT_OK(graph.SetExecutor("", executor));
+  MP_EXPECT_OK(graph.Initialize(config));
+  MP_EXPECT_OK(graph.StartRun(
+      {{"timestamps", MakePacket<std::vector<Timestamp>*>(&timestamps)}}));
+  executor->RunAllTasks();
+  MP_EXPECT_OK(
+      graph.AddPacketToInputStream("in_1", MakePacket<int>(1).At(Timestamp(1))));
+  absl::SleepFor(absl::Milliseconds(2));
+  MP_EXPECT_OK(
+      graph.AddPacketToInputStream("in_2", MakePacket<int>(2).At(Timestamp(2))));
+  executor->RunAllTasks();
+  MP_EXPECT_OK(graph.CloseAllInputStreams());
+  executor->RunAllTasks();
+  MP_EXPECT_OK(graph.WaitUntilDone());
+  return timestamps;
+}
+
+TEST(CalculatorGraph, DeadlineSchedulingRunsEarlierDeadlinesFirst) {
+  // Without deadlines, the node with the higher id runs first.
+  EXPECT_THAT(RunTwoIndependentNodes(/*deadline_budget_us=*/0),
+              testing::ElementsAre(Timestamp(2), Timestamp(1)));
+  // With deadlines, the timestamp that arrived first runs first.
+  EXPECT_THAT(RunTwoIndependentNodes(/*deadline_budget_us=*/10000000),
+              testing::ElementsAre(Timestamp(1), Timestamp(2)));
+}
+
+TEST(CalculatorGraph, AddPacketsToInputStream) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "out"
+        }
+      )pb");
+  std::vector<Packet> out_packets;
+  tool::AddVectorSink("out", &config, &out_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  std::vector<Packet> packets;
+  for (int i = 0; i < 5; ++i) {
+    packets.push_back(MakePacket<int>(i).At(Timestamp(i)));
+  }
+  MP_ASSERT_OK(graph.AddPacketsToInputStream("in", packets));
+  std::vector<Packet> more_packets;
+  for (int i = 5; i < 10; ++i) {
+    more_packets.push_back(MakePacket<int>(i).At(Timestamp(i)));
+  }
+  MP_ASSERT_OK(graph.AddPacketsToInputStream("in", std::move(more_packets)));
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  ASSERT_EQ(10, out_packets.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, out_packets[i].Get<int>());
+    EXPECT_EQ(Timestamp(i), out_packets[i].Timestamp());
+  }
+}
+
+TEST(CalculatorGraph, AddPacketsToInputStreamRejectsUnknownStream) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "out"
+        }
+      )pb");
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  std::vector<Packet> packets = {MakePacket<int>(0).At(Timestamp(0))};
+  EXPECT_FALSE(graph.AddPacketsToInputStream("unknown", packets).ok());
+  // No packet is added to any stream if one of the streams is unknown.
+  EXPECT_FALSE(graph
+                   .AddPacketsToInputStreams(
+                       {{"in", MakePacket<int>(1).At(Timestamp(1))},
+                        {"unknown", MakePacket<int>(1).At(Timestamp(1))}})
+                   .ok());
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
+TEST(CalculatorGraph, AddPacketsToInputStreams) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in_a"
+        input_stream: "in_b"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in_a"
+          input_stream: "in_b"
+          output_stream: "out_a"
+          output_stream: "out_b"
+        }
+      )pb");
+  std::vector<Packet> out_a_packets;
+  std::vector<Packet> out_b_packets;
+  tool::AddVectorSink("out_a", &config, &out_a_packets);
+  tool::AddVectorSink("out_b", &config, &out_b_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 5; ++i) {
+    MP_ASSERT_OK(graph.AddPacketsToInputStreams(
+        {{"in_a", MakePacket<int>(i).At(Timestamp(i))},
+         {"in_b", MakePacket<int>(i * 10).At(Timestamp(i))}}));
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  ASSERT_EQ(5, out_a_packets.size());
+  ASSERT_EQ(5, out_b_packets.size());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(i, out_a_packets[i].Get<int>());
+    EXPECT_EQ(i * 10, out_b_packets[i].Get<int>());
+  }
+}
+
 // Packet generator for an arbitrary unit64 packet.
 class Uint64PacketGenerator : public PacketGenerator {
  public:
@@ -4573,6 +4804,80 @@ TEST(CalculatorGraph, TestPollPacket) {
   EXPECT_EQ(kDefaultMaxCount, num_packets);
 }
 
+TEST(CalculatorGraph, TestPollPacketBatches) {
+  CalculatorGraphConfig config;
+  CalculatorGraphConfig::Node* node = config.add_node();
+  node->set_calculator("CountingSourceCalculator");
+  node->add_output_stream("output");
+  node->add_input_side_packet("MAX_COUNT:max_count");
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  auto status_or_poller = graph.AddOutputStreamPoller("output");
+  ASSERT_TRUE(status_or_poller.ok());
+  OutputStreamPoller poller = std::move(status_or_poller.value());
+  MP_ASSERT_OK(
+      graph.StartRun({{"max_count", MakePacket<int>(kDefaultMaxCount)}}));
+  std::vector<Packet> packets;
+  int num_batches = 0;
+  while (poller.NextBatch(&packets, 64)) {
+    ++num_batches;
+    ASSERT_LE(packets.size(), num_batches * 64);
+  }
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  std::vector<Packet> more_packets;
+  EXPECT_FALSE(poller.NextBatch(&more_packets, 64));
+  EXPECT_FALSE(poller.TryNextBatch(&more_packets, 64));
+  EXPECT_TRUE(more_packets.empty());
+  ASSERT_EQ(kDefaultMaxCount, packets.size());
+  for (int i = 0; i < packets.size(); ++i) {
+    EXPECT_EQ(i, packets[i].Get<int>());
+  }
+}
+
+TEST(CalculatorGraph, TestTryPollPacketBatches) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "input"
+          output_stream: "output"
+        }
+      )pb");
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  auto status_or_poller = graph.AddOutputStreamPoller("output");
+  ASSERT_TRUE(status_or_poller.ok());
+  OutputStreamPoller poller = std::move(status_or_poller.value());
+  MP_ASSERT_OK(graph.StartRun({}));
+
+  // Nothing is queued, so TryNextBatch returns without packets.
+  std::vector<Packet> packets;
+  EXPECT_TRUE(poller.TryNextBatch(&packets, 10));
+  EXPECT_TRUE(packets.empty());
+
+  for (int i = 0; i < 5; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "input", MakePacket<int>(i).At(Timestamp(i))));
+  }
+  MP_ASSERT_OK(graph.WaitUntilIdle());
+  EXPECT_TRUE(poller.TryNextBatch(&packets, 3));
+  ASSERT_EQ(packets.size(), 3);
+  EXPECT_TRUE(poller.TryNextBatch(&packets, 3));
+  ASSERT_EQ(packets.size(), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(i, packets[i].Get<int>());
+  }
+
+  MP_ASSERT_OK(graph.CloseAllPacketSources());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  EXPECT_FALSE(poller.TryNextBatch(&packets, 3));
+  EXPECT_EQ(packets.size(), 5);
+}
+
 TEST(CalculatorGraph, TestOutputStreamPollerDesiredQueueSize) {
   CalculatorGraphConfig config;
   CalculatorGraphConfig::Node* node = config.add_node();
@@ -28,6 +28,8 @@
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_base.h"
 #include "mediapipe/framework/counter_factory.h"
@@ -152,6 +154,7 @@ absl::Status CalculatorNode::Initialize(
   if (!node_config->executor().empty()) {
     executor_ = node_config->executor();
   }
+  core_class_ = node_config->core_class();
   source_layer_ = node_config->source_layer();
 
   const CalculatorContract& contract = node_type_info_->Contract();
@@ -379,7 +382,10 @@ absl::Status CalculatorNode::PrepareForRun(
     std::function<void()> source_node_opened_callback,
     std::function<void(CalculatorContext*)> schedule_callback,
     std::function<void(absl::Status)> error_callback,
-    CounterFactory* counter_factory) {
+    CounterFactory* counter_factory, PacketArena* packet_arena,
+    const std::map<std::string, std::shared_ptr<mediapipe::Executor>>*
+        executors,
+    CancelledTimestamps* cancelled_timestamps) {
   RET_CHECK(ready_for_open_callback) << "ready_for_open_callback is NULL";
   RET_CHECK(schedule_callback) << "schedule_callback is NULL";
   RET_CHECK(error_callback) << "error_callback is NULL";
@@ -404,6 +410,9 @@ absl::Status CalculatorNode::PrepareForRun(
       &input_side_packet_handler_.InputSidePackets());
   calculator_state_->SetOutputSidePackets(output_side_packets_.get());
   calculator_state_->SetCounterFactory(counter_factory);
+  calculator_state_->SetPacketArena(packet_arena);
+  calculator_state_->SetExecutors(executors);
+  calculator_state_->SetCancelledTimestamps(cancelled_timestamps);
 
   for (const auto& svc_req : contract.ServiceRequests()) {
     const auto& req = svc_req.second;
@@ -436,8 +445,12 @@ absl::Status CalculatorNode::PrepareForRun(
     current_in_flight_ = 0;
     input_stream_headers_ready_called_ = false;
     input_side_packets_ready_called_ = false;
+    open_before_stream_headers_ =
+        validated_graph_->Config().open_nodes_concurrently();
     input_stream_headers_ready_ =
+        open_before_stream_headers_ ||
         (input_stream_handler_->UnsetHeaderCount() == 0);
+    open_duration_ = absl::ZeroDuration();
     input_side_packets_ready_ =
         (input_side_packet_handler_.MissingInputSidePacketCount() == 0);
   }
@@ -476,16 +489,30 @@ bool CalculatorNode::OutputsAreConstant(CalculatorContext* cc) {
   return true;
 }
 
+bool CalculatorNode::InputsAreCancelled(CalculatorContext* cc,
+                                        int input_batch_size) {
+  for (int i = 0; i < input_batch_size; ++i) {
+    if (!calculator_state_->IsCancelled(cc->InputBatchTimestamp(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 absl::Status CalculatorNode::OpenNode() {
   VLOG(2) << "CalculatorNode::OpenNode() for " << DebugName();
+  const absl::Time start_time = absl::Now();
 
   CalculatorContext* default_context =
       calculator_context_manager_.GetDefaultCalculatorContext();
   InputStreamShardSet* inputs = &default_context->Inputs();
   // The upstream calculators may set the headers in the output streams during
   // Calculator::Open(), needs to update the header packets in input stream
-  // shards.
-  input_stream_handler_->UpdateInputShardHeaders(inputs);
+  // shards. If the node is opened before all the headers are set, they may
+  // still be written by the upstream calculators and are not read.
+  if (input_stream_handler_->UnsetHeaderCount() == 0) {
+    input_stream_handler_->UpdateInputShardHeaders(inputs);
+  }
   OutputStreamShardSet* outputs = &default_context->Outputs();
   output_stream_handler_->PrepareOutputs(Timestamp::Unstarted(), outputs);
   calculator_context_manager_.PushInputTimestampToContext(
@@ -531,9 +558,12 @@ absl::Status CalculatorNode::OpenNode() {
 
   output_stream_handler_->Open(outputs);
 
+  const absl::Duration open_duration = absl::Now() - start_time;
+  VLOG(1) << "Opened " << DebugName() << " in " << open_duration;
   {
     absl::MutexLock status_lock(&status_mutex_);
     status_ = kStateOpened;
+    open_duration_ = open_duration;
   }
 
   return absl::OkStatus();
@@ -692,7 +722,16 @@ bool CalculatorNode::ReadyForOpen() const {
   return input_stream_headers_ready_ && input_side_packets_ready_;
 }
 
+absl::Duration CalculatorNode::OpenDuration() const {
+  absl::MutexLock lock(&status_mutex_);
+  return open_duration_;
+}
+
 void CalculatorNode::InputStreamHeadersReady() {
+  if (open_before_stream_headers_) {
+    // The node was considered ready for OpenNode() without the headers.
+    return;
+  }
   bool ready_for_open = false;
   {
     absl::MutexLock lock(&status_mutex_);
@@ -799,6 +838,51 @@ std::string CalculatorNode::DebugName() const {
 // TODO: Split this function.
 absl::Status CalculatorNode::ProcessNode(
     CalculatorContext* calculator_context) {
+  return ProcessNode(calculator_context, /*deferred=*/nullptr);
+}
+
+void CalculatorNode::SetDeferredProcessCallback(
+    std::function<void(absl::Status)> callback) {
+  deferred_process_callback_ = std::move(callback);
+  deferred_process_handler_ = [this](CalculatorContext* calculator_context,
+                                     absl::Status result) {
+    // Only calls with a single input set are deferred.
+    const Timestamp input_timestamp = calculator_context->InputTimestamp();
+    result = EndProcess(calculator_context, input_timestamp,
+                        /*input_batch_size=*/1, std::move(result));
+    deferred_process_callback_(std::move(result));
+  };
+}
+
+absl::Status CalculatorNode::EndProcess(CalculatorContext* calculator_context,
+                                        Timestamp last_input_timestamp,
+                                        int input_batch_size,
+                                        absl::Status result) {
+  // Removes one packet from each shard and progresses to the next input
+  // timestamp, for each input set of the batch.
+  for (int j = 0; j < input_batch_size; ++j) {
+    input_stream_handler_->ClearCurrentInputs(calculator_context);
+  }
+  calculator_context_manager_.SetInputBatchSizeInContext(calculator_context, 1);
+
+  // Nodes are allowed to return StatusStop() to cause the termination
+  // of the graph. This is different from an error in that it will
+  // ensure that all sources will be closed and that packets in input
+  // streams will be processed before the graph is terminated.
+  if (!result.ok() && result != tool::StatusStop()) {
+    return mediapipe::StatusBuilder(result, MEDIAPIPE_LOC).SetPrepend()
+           << absl::Substitute(
+                  "Calculator::Process() for node \"$0\" failed: ", DebugName());
+  }
+  output_stream_handler_->PostProcess(last_input_timestamp);
+  return result;
+}
+
+absl::Status CalculatorNode::ProcessNode(CalculatorContext* calculator_context,
+                                         bool* deferred) {
+  if (deferred) {
+    *deferred = false;
+  }
   if (IsSource()) {
     // This is a source Calculator.
     if (Closed()) {
@@ -849,10 +933,27 @@ absl::Status CalculatorNode::ProcessNode(
     RET_CHECK(num_invocations <= 1 || max_in_flight_ <= 1)
         << "num_invocations:" << num_invocations
         << ", max_in_flight_:" << max_in_flight_;
+    const bool process_input_batches = Contract().GetProcessInputBatches();
     for (int i = 0; i < num_invocations; ++i) {
       const Timestamp input_timestamp = calculator_context->InputTimestamp();
       // The node is ready for Process().
       if (input_timestamp.IsAllowedInStream()) {
+        // A calculator that processes input batches gets all the consecutive
+        // input sets for Process() at once.
+        int input_batch_size = 1;
+        if (process_input_batches) {
+          while (i + input_batch_size < num_invocations &&
+                 calculator_context_manager_
+                     .ContextInputTimestamp(*calculator_context,
+                                            input_batch_size)
+                     .IsAllowedInStream()) {
+            ++input_batch_size;
+          }
+        }
+        calculator_context_manager_.SetInputBatchSizeInContext(
+            calculator_context, input_batch_size);
+        const Timestamp last_input_timestamp =
+            calculator_context->InputBatchTimestamp(input_batch_size - 1);
         input_stream_handler_->FinalizeInputSet(input_timestamp, inputs);
         output_stream_handler_->PrepareOutputs(input_timestamp, outputs);
 
@@ -862,32 +963,40 @@ absl::Status CalculatorNode::ProcessNode(
         if (OutputsAreConstant(calculator_context)) {
           // Do nothing.
           result = absl::OkStatus();
+        } else if (InputsAreCancelled(calculator_context, input_batch_size)) {
+          // Drops the input packets, and only the timestamp bound is
+          // propagated.
+          VLOG(2) << "Skipping cancelled timestamp for node: " << DebugName();
+          result = absl::OkStatus();
         } else {
           MEDIAPIPE_PROFILING(PROCESS, calculator_context);
           LegacyCalculatorSupport::Scoped<CalculatorContext> s(
               calculator_context);
+          if (deferred && deferred_process_callback_ && num_invocations == 1 &&
+              input_batch_size == 1) {
+            calculator_context->deferred_process_handler_ =
+                &deferred_process_handler_;
+          }
           result = calculator_->Process(calculator_context);
+          calculator_context->deferred_process_handler_ = nullptr;
         }
 
         VLOG(2) << "Called Calculator::Process() for node: " << DebugName()
                 << " timestamp: " << input_timestamp;
 
-        // Removes one packet from each shard and progresses to the next input
-        // timestamp.
-        input_stream_handler_->ClearCurrentInputs(calculator_context);
-
-        // Nodes are allowed to return StatusStop() to cause the termination
-        // of the graph. This is different from an error in that it will
-        // ensure that all sources will be closed and that packets in input
-        // streams will be processed before the graph is terminated.
-        if (!result.ok() && result != tool::StatusStop()) {
-          return mediapipe::StatusBuilder(result, MEDIAPIPE_LOC).SetPrepend()
-                 << absl::Substitute(
-                        "Calculator::Process() for node \"$0\" failed: ",
-                        DebugName());
+        if (calculator_context->ProcessDeferred()) {
+          // The call is finished here if it has already completed, and
+          // otherwise by deferred_process_handler_ when it completes.
+          calculator_context->deferred_process_status_ = std::move(result);
+          if (!calculator_context->ReleaseDeferredProcess(&result)) {
+            *deferred = true;
+            return absl::OkStatus();
+          }
         }
-        output_stream_handler_->PostProcess(input_timestamp);
-        if (result == tool::StatusStop()) {
+        result = EndProcess(calculator_context, last_input_timestamp,
+                            input_batch_size, std::move(result));
+        i += input_batch_size - 1;
+        if (!result.ok()) {
           return result;
         }
       } else if (input_timestamp == Timestamp::Done()) {
@@ -29,11 +29,14 @@
 
 #include "absl/base/macros.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_base.h"
 #include "mediapipe/framework/calculator_context.h"
 #include "mediapipe/framework/calculator_context_manager.h"
 #include "mediapipe/framework/calculator_state.h"
+#include "mediapipe/framework/cancelled_timestamps.h"
+#include "mediapipe/framework/executor.h"
 #include "mediapipe/framework/input_side_packet_handler.h"
 #include "mediapipe/framework/input_stream_handler.h"
 #include "mediapipe/framework/legacy_calculator_support.h"
@@ -53,6 +56,7 @@
 namespace mediapipe {
 
 class CounterFactory;
+class PacketArena;
 class InputStreamManager;
 class OutputStreamManager;
 
@@ -95,9 +99,27 @@ class CalculatorNode {
   // Changes the executor a node is assigned to.
   void SetExecutor(const std::string& executor);
 
+  // The class of CPU cores preferred for running the node.
+  CalculatorGraphConfig::Node::CoreClass PreferredCoreClass() const {
+    return core_class_;
+  }
+
   // Calls Process() on the Calculator corresponding to this node.
   absl::Status ProcessNode(CalculatorContext* calculator_context);
 
+  // Like ProcessNode(), but lets the calculator defer the completion of the
+  // call with CalculatorContext::DeferProcessCompletion(), if a deferred
+  // process callback is set. If the call is still pending when Process()
+  // returns, sets *deferred to true and returns OK without finishing the
+  // call. The deferred process callback then receives the status of
+  // ProcessNode() on the thread that completes the call.
+  absl::Status ProcessNode(CalculatorContext* calculator_context,
+                           bool* deferred);
+
+  // Sets the callback that receives the status of deferred ProcessNode()
+  // calls.
+  void SetDeferredProcessCallback(std::function<void(absl::Status)> callback);
+
   // Initializes the node.  The buffer_size_hint argument is
   // set to the value specified in the graph proto for this field.
   // input_stream_managers/output_stream_managers is expected to point to
@@ -130,7 +152,11 @@ class CalculatorNode {
       std::function<void()> source_node_opened_callback,
       std::function<void(CalculatorContext*)> schedule_callback,
       std::function<void(absl::Status)> error_callback,
-      CounterFactory* counter_factory) ABSL_LOCKS_EXCLUDED(status_mutex_);
+      CounterFactory* counter_factory, PacketArena* packet_arena,
+      const std::map<std::string, std::shared_ptr<mediapipe::Executor>>*
+          executors,
+      CancelledTimestamps* cancelled_timestamps)
+      ABSL_LOCKS_EXCLUDED(status_mutex_);
   // Opens the node.
   absl::Status OpenNode() ABSL_LOCKS_EXCLUDED(status_mutex_);
   // Called when a source node's layer becomes active.
@@ -180,6 +206,10 @@ class CalculatorNode {
   // Returns true if OpenNode() can be scheduled.
   bool ReadyForOpen() const ABSL_LOCKS_EXCLUDED(status_mutex_);
 
+  // Returns the wall time spent in the last successful OpenNode() call, or
+  // zero if the node hasn't been opened in the current run.
+  absl::Duration OpenDuration() const ABSL_LOCKS_EXCLUDED(status_mutex_);
+
   // Called by the InputStreamHandler when all the input stream headers
   // become available.
   void InputStreamHeadersReady() ABSL_LOCKS_EXCLUDED(status_mutex_);
@@ -286,6 +316,16 @@ class CalculatorNode {
   // Returns true if all outputs will be identical to the previous graph run.
   bool OutputsAreConstant(CalculatorContext* cc);
 
+  // Returns true if the timestamps of all the input sets of the next
+  // Process() call have been cancelled, so that the call can be skipped.
+  bool InputsAreCancelled(CalculatorContext* cc, int input_batch_size);
+
+  // Finishes a Process() call of a non-source node with the given result,
+  // releasing its input sets and propagating its outputs.
+  absl::Status EndProcess(CalculatorContext* calculator_context,
+                          Timestamp last_input_timestamp, int input_batch_size,
+                          absl::Status result);
+
   // The calculator.
   std::unique_ptr<CalculatorBase> calculator_;
   // Keeps data which a Calculator subclass needs access to.
@@ -295,6 +335,9 @@ class CalculatorNode {
   // Name of the executor which the node will execute on. If empty, the node
   // will execute on the default executor.
   std::string executor_;
+  // The class of CPU cores preferred for running the node.
+  CalculatorGraphConfig::Node::CoreClass core_class_ =
+      CalculatorGraphConfig::Node::CORE_CLASS_ANY;
   // The layer a source calculator operates on.
   int source_layer_ = 0;
   // The status of the current Calculator that this CalculatorNode
@@ -344,6 +387,9 @@ class CalculatorNode {
   bool input_side_packets_ready_called_ ABSL_GUARDED_BY(status_mutex_) = false;
   bool input_stream_headers_ready_ ABSL_GUARDED_BY(status_mutex_) = false;
   bool input_side_packets_ready_ ABSL_GUARDED_BY(status_mutex_) = false;
+  // True if OpenNode() doesn't wait for the input stream headers.
+  bool open_before_stream_headers_ = false;
+  absl::Duration open_duration_ ABSL_GUARDED_BY(status_mutex_);
 
   // Owns and manages all CalculatorContext objects.
   CalculatorContextManager calculator_context_manager_;
@@ -371,6 +417,13 @@ class CalculatorNode {
 
   internal::SchedulerQueue* scheduler_queue_ = nullptr;
 
+  // Finishes the deferred Process() calls that complete after Process()
+  // returns. Set in the CalculatorContext of each call that can be deferred.
+  std::function<void(CalculatorContext*, absl::Status)>
+      deferred_process_handler_;
+  // Receives the status of the deferred ProcessNode() calls.
+  std::function<void(absl::Status)> deferred_process_callback_;
+
   const ValidatedGraphConfig* validated_graph_ = nullptr;
 
   const NodeTypeInfo* node_type_info_ = nullptr;
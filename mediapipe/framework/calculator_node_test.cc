@@ -179,6 +179,9 @@ class CalculatorNodeTest : public ::testing::Test {
                   this, std::placeholders::_1,        //
                   &schedule_count_),                  //
         CheckFail,                                    //
+        nullptr,                                      //
+        nullptr,                                      //
+        nullptr,                                      //
         nullptr);
   }
 
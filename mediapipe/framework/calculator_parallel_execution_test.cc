@@ -19,6 +19,8 @@
 //
 // TODO: Add more tests to verify the correctness of parallel execution.
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <random>
 #include <string>
@@ -77,6 +79,52 @@ class SlowPlusOneCalculator : public CalculatorBase {
 
 REGISTER_CALCULATOR(SlowPlusOneCalculator);
 
+// Counts the calculators that are in Open() at the same time.
+struct OpenTracker {
+  absl::Mutex mutex;
+  int num_opening ABSL_GUARDED_BY(mutex) = 0;
+  int max_num_opening ABSL_GUARDED_BY(mutex) = 0;
+};
+
+// Waits in Open() until as many calculators as given by the "NUM_OPENING"
+// side packet are in Open() as well, or until a timeout expires.
+class ConcurrentOpenCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->InputSidePackets().Tag("TRACKER").Set<OpenTracker*>();
+    cc->InputSidePackets().Tag("NUM_OPENING").Set<int>();
+    cc->Inputs().Index(0).SetAny();
+    cc->Outputs().Index(0).SetSameAs(&cc->Inputs().Index(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    OpenTracker* tracker = cc->InputSidePackets().Tag("TRACKER").Get<
+        OpenTracker*>();
+    const int num_opening = cc->InputSidePackets().Tag("NUM_OPENING").Get<int>();
+    absl::MutexLock lock(&tracker->mutex);
+    ++tracker->num_opening;
+    tracker->max_num_opening =
+        std::max(tracker->max_num_opening, tracker->num_opening);
+    auto all_opening = [tracker, num_opening]()
+                           ABSL_EXCLUSIVE_LOCKS_REQUIRED(tracker->mutex) {
+                             return tracker->max_num_opening >= num_opening;
+                           };
+    tracker->mutex.AwaitWithTimeout(absl::Condition(&all_opening),
+                                    absl::Seconds(1));
+    --tracker->num_opening;
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    cc->Outputs().Index(0).AddPacket(cc->Inputs().Index(0).Value());
+    return absl::OkStatus();
+  }
+};
+
+REGISTER_CALCULATOR(ConcurrentOpenCalculator);
+
 class ParallelExecutionTest : public testing::Test {
  public:
   void AddThreadSafeVectorSink(const Packet& packet) {
@@ -153,5 +201,100 @@ TEST_F(ParallelExecutionTest, SlowPlusOneCalculatorsTest) {
   }
 }
 
+// Tests that a chain of calculators is opened concurrently if the graph
+// doesn't wait for input stream headers.
+TEST_F(ParallelExecutionTest, OpensNodesConcurrently) {
+  CalculatorGraphConfig graph_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input"
+        output_stream: "output"
+        open_nodes_concurrently: true
+        num_threads: 3
+        node {
+          name: "first"
+          calculator: "ConcurrentOpenCalculator"
+          input_stream: "input"
+          output_stream: "first_output"
+          input_side_packet: "TRACKER:tracker"
+          input_side_packet: "NUM_OPENING:num_opening"
+        }
+        node {
+          name: "second"
+          calculator: "ConcurrentOpenCalculator"
+          input_stream: "first_output"
+          output_stream: "second_output"
+          input_side_packet: "TRACKER:tracker"
+          input_side_packet: "NUM_OPENING:num_opening"
+        }
+        node {
+          name: "third"
+          calculator: "ConcurrentOpenCalculator"
+          input_stream: "second_output"
+          output_stream: "output"
+          input_side_packet: "TRACKER:tracker"
+          input_side_packet: "NUM_OPENING:num_opening"
+        }
+      )pb");
+  OpenTracker tracker;
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  auto poller_status = graph.AddOutputStreamPoller("output");
+  MP_ASSERT_OK(poller_status);
+  OutputStreamPoller poller = std::move(poller_status.value());
+  MP_ASSERT_OK(graph.StartRun({{"tracker", MakePacket<OpenTracker*>(&tracker)},
+                              {"num_opening", MakePacket<int>(3)}}));
+  MP_ASSERT_OK(
+      graph.AddPacketToInputStream("input", MakePacket<int>(7).At(Timestamp(0))));
+  MP_ASSERT_OK(graph.CloseInputStream("input"));
+  Packet packet;
+  ASSERT_TRUE(poller.Next(&packet));
+  EXPECT_EQ(7, packet.Get<int>());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  {
+    absl::MutexLock lock(&tracker.mutex);
+    EXPECT_EQ(3, tracker.max_num_opening);
+  }
+  std::map<std::string, absl::Duration> open_durations =
+      graph.GetNodeOpenDurations();
+  EXPECT_EQ(3, open_durations.size());
+  EXPECT_EQ(1, open_durations.count("first"));
+  EXPECT_EQ(1, open_durations.count("second"));
+  EXPECT_EQ(1, open_durations.count("third"));
+}
+
+// Tests that calculators are opened one after another by default.
+TEST_F(ParallelExecutionTest, OpensNodesAfterUpstreamNodesByDefault) {
+  CalculatorGraphConfig graph_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input"
+        num_threads: 2
+        node {
+          calculator: "ConcurrentOpenCalculator"
+          input_stream: "input"
+          output_stream: "first_output"
+          input_side_packet: "TRACKER:tracker"
+          input_side_packet: "NUM_OPENING:num_opening"
+        }
+        node {
+          calculator: "ConcurrentOpenCalculator"
+          input_stream: "first_output"
+          output_stream: "output"
+          input_side_packet: "TRACKER:tracker"
+          input_side_packet: "NUM_OPENING:num_opening"
+        }
+      )pb");
+  OpenTracker tracker;
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  // Each calculator waits for the other one until the timeout expires.
+  MP_ASSERT_OK(graph.StartRun({{"tracker", MakePacket<OpenTracker*>(&tracker)},
+                              {"num_opening", MakePacket<int>(2)}}));
+  MP_ASSERT_OK(graph.CloseInputStream("input"));
+  MP_ASSERT_OK(graph.WaitUntilDone());
+  absl::MutexLock lock(&tracker.mutex);
+  EXPECT_EQ(1, tracker.max_num_opening);
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -34,7 +34,10 @@ CalculatorState::CalculatorState(
       calculator_type_(calculator_type),
       node_config_(node_config),
       profiling_context_(profiling_context),
-      counter_factory_(nullptr) {
+      counter_factory_(nullptr),
+      packet_arena_(nullptr),
+      executors_(nullptr),
+      cancelled_timestamps_(nullptr) {
   options_.Initialize(node_config);
   ResetBetweenRuns();
 }
@@ -44,6 +47,9 @@ CalculatorState::~CalculatorState() {}
 void CalculatorState::ResetBetweenRuns() {
   input_side_packets_ = nullptr;
   counter_factory_ = nullptr;
+  packet_arena_ = nullptr;
+  executors_ = nullptr;
+  cancelled_timestamps_ = nullptr;
 }
 
 void CalculatorState::SetInputSidePackets(const PacketSet* input_side_packets) {
@@ -67,4 +73,18 @@ CounterFactory* CalculatorState::GetCounterFactory() {
   return counter_factory_;
 }
 
+Executor* CalculatorState::GetExecutor(const std::string& name) const {
+  if (executors_ == nullptr) {
+    return nullptr;
+  }
+  auto it = executors_->find(name);
+  return it == executors_->end() ? nullptr : it->second.get();
+}
+
+void CalculatorState::CancelTimestamp(Timestamp timestamp) {
+  if (cancelled_timestamps_ != nullptr) {
+    cancelled_timestamps_->Cancel(timestamp);
+  }
+}
+
 }  // namespace mediapipe
@@ -24,11 +24,14 @@
 // TODO: Move protos in another CL after the C++ code migration.
 #include "absl/base/macros.h"
 #include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/cancelled_timestamps.h"
 #include "mediapipe/framework/counter.h"
 #include "mediapipe/framework/counter_factory.h"
+#include "mediapipe/framework/executor.h"
 #include "mediapipe/framework/graph_service.h"
 #include "mediapipe/framework/graph_service_manager.h"
 #include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/packet_arena.h"
 #include "mediapipe/framework/packet_set.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/any_proto.h"
@@ -88,6 +91,22 @@ class CalculatorState {
   // created by this counter set do not have the NodeName prefix.
   CounterFactory* GetCounterFactory();
 
+  // Returns the graph's packet arena, or nullptr if it has none.
+  PacketArena* GetPacketArena() const { return packet_arena_; }
+
+  // Returns the graph's executor with the given name, or nullptr if there is
+  // none. The empty name refers to the default executor.
+  Executor* GetExecutor(const std::string& name) const;
+
+  // Cancels the timestamp in the graph, if the graph supports cancellation.
+  void CancelTimestamp(Timestamp timestamp);
+
+  // Returns true if the timestamp has been cancelled in the graph.
+  bool IsCancelled(Timestamp timestamp) const {
+    return cancelled_timestamps_ != nullptr &&
+           cancelled_timestamps_->IsCancelled(timestamp);
+  }
+
   std::shared_ptr<ProfilingContext> GetSharedProfilingContext() const {
     return profiling_context_;
   }
@@ -103,6 +122,19 @@ class CalculatorState {
   void SetCounterFactory(CounterFactory* counter_factory) {
     counter_factory_ = counter_factory;
   }
+  // Sets the packet arena, which may be nullptr.
+  void SetPacketArena(PacketArena* packet_arena) {
+    packet_arena_ = packet_arena;
+  }
+  // Sets the graph's executors, keyed by name. May be nullptr.
+  void SetExecutors(
+      const std::map<std::string, std::shared_ptr<Executor>>* executors) {
+    executors_ = executors;
+  }
+  // Sets the graph's cancelled timestamps, which may be nullptr.
+  void SetCancelledTimestamps(CancelledTimestamps* cancelled_timestamps) {
+    cancelled_timestamps_ = cancelled_timestamps;
+  }
 
   absl::Status SetServicePacket(const GraphServiceBase& service,
                                 Packet packet) {
@@ -144,6 +176,12 @@ class CalculatorState {
   OutputSidePacketSet* output_side_packets_;
 
   CounterFactory* counter_factory_;
+
+  PacketArena* packet_arena_;
+
+  const std::map<std::string, std::shared_ptr<Executor>>* executors_;
+
+  CancelledTimestamps* cancelled_timestamps_;
 };
 
 }  // namespace mediapipe
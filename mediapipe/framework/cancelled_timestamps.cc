@@ -0,0 +1,42 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/cancelled_timestamps.h"
+
+namespace mediapipe {
+
+void CancelledTimestamps::Cancel(Timestamp timestamp) {
+  absl::MutexLock lock(&mutex_);
+  timestamps_.insert(timestamp);
+  while (static_cast<int>(timestamps_.size()) > max_size_) {
+    timestamps_.erase(timestamps_.begin());
+  }
+  size_.store(timestamps_.size(), std::memory_order_release);
+}
+
+bool CancelledTimestamps::IsCancelled(Timestamp timestamp) const {
+  if (size_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  absl::MutexLock lock(&mutex_);
+  return timestamps_.count(timestamp) > 0;
+}
+
+void CancelledTimestamps::Clear() {
+  absl::MutexLock lock(&mutex_);
+  timestamps_.clear();
+  size_.store(0, std::memory_order_release);
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,62 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_CANCELLED_TIMESTAMPS_H_
+#define MEDIAPIPE_FRAMEWORK_CANCELLED_TIMESTAMPS_H_
+
+#include <atomic>
+#include <set>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+
+// The timestamps abandoned during a graph run, for example frames that a
+// FlowLimiterCalculator has stopped waiting for. Nodes skip Process() for
+// input sets at a cancelled timestamp, and calculators can query whether the
+// timestamp they are processing has been cancelled meanwhile.
+//
+// Only the latest cancelled timestamps are kept, which suffices because
+// cancelled work is normally just behind the newest inputs. IsCancelled() is
+// a single atomic load while nothing is cancelled. This class is thread-safe.
+class CancelledTimestamps {
+ public:
+  static constexpr int kDefaultMaxSize = 64;
+
+  explicit CancelledTimestamps(int max_size = kDefaultMaxSize)
+      : max_size_(max_size) {}
+
+  // Marks a timestamp as cancelled, forgetting the earliest cancelled
+  // timestamp if there are more than max_size.
+  void Cancel(Timestamp timestamp) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns true if the timestamp has been cancelled.
+  bool IsCancelled(Timestamp timestamp) const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Forgets all cancelled timestamps.
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  const int max_size_;
+  // The size of timestamps_, readable without the mutex.
+  std::atomic<int> size_{0};
+  mutable absl::Mutex mutex_;
+  std::set<Timestamp> timestamps_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_CANCELLED_TIMESTAMPS_H_
@@ -0,0 +1,49 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/cancelled_timestamps.h"
+
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(CancelledTimestampsTest, CancelsTimestamps) {
+  CancelledTimestamps cancelled;
+  EXPECT_FALSE(cancelled.IsCancelled(Timestamp(10)));
+  cancelled.Cancel(Timestamp(10));
+  EXPECT_TRUE(cancelled.IsCancelled(Timestamp(10)));
+  EXPECT_FALSE(cancelled.IsCancelled(Timestamp(20)));
+
+  cancelled.Clear();
+  EXPECT_FALSE(cancelled.IsCancelled(Timestamp(10)));
+}
+
+TEST(CancelledTimestampsTest, ForgetsEarliestTimestamps) {
+  CancelledTimestamps cancelled(/*max_size=*/2);
+  cancelled.Cancel(Timestamp(20));
+  cancelled.Cancel(Timestamp(30));
+  cancelled.Cancel(Timestamp(10));
+  EXPECT_FALSE(cancelled.IsCancelled(Timestamp(10)));
+  EXPECT_TRUE(cancelled.IsCancelled(Timestamp(20)));
+  EXPECT_TRUE(cancelled.IsCancelled(Timestamp(30)));
+
+  cancelled.Cancel(Timestamp(40));
+  EXPECT_FALSE(cancelled.IsCancelled(Timestamp(20)));
+  EXPECT_TRUE(cancelled.IsCancelled(Timestamp(40)));
+}
+
+}  // namespace
+}  // namespace mediapipe
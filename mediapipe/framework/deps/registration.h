@@ -16,13 +16,16 @@
 #define MEDIAPIPE_DEPS_REGISTRATION_H_
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "absl/base/macros.h"
 #include "absl/base/thread_annotations.h"
@@ -31,6 +34,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/meta/type_traits.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
@@ -189,6 +193,7 @@ class FunctionRegistry {
     }
     if (functions_.insert(std::make_pair(normalized_name, std::move(func)))
             .second) {
+      RetireSnapshot();
       return RegistrationToken(
           [this, normalized_name]() { Unregister(normalized_name); });
     }
@@ -211,17 +216,13 @@ class FunctionRegistry {
                               int> = 0>
   ReturnType Invoke(absl::string_view name, Args2&&... args)
       ABSL_LOCKS_EXCLUDED(lock_) {
-    Function function;
-    {
-      absl::ReaderMutexLock lock(&lock_);
-      auto it = functions_.find(name);
-      if (it == functions_.end()) {
-        return absl::NotFoundError(
-            absl::StrCat("No registered object with name: ", name));
-      }
-      function = it->second;
+    const Functions& functions = GetSnapshot();
+    auto it = functions.find(name);
+    if (it == functions.end()) {
+      return absl::NotFoundError(
+          absl::StrCat("No registered object with name: ", name));
     }
-    return function(std::forward<Args2>(args)...);
+    return it->second(std::forward<Args2>(args)...);
   }
 
   // Invokes the specified factory function and returns the result.
@@ -236,8 +237,7 @@ class FunctionRegistry {
   // unregistered, though this will never happen with registrations made via
   // MEDIAPIPE_REGISTER_FACTORY_FUNCTION.
   bool IsRegistered(absl::string_view name) const ABSL_LOCKS_EXCLUDED(lock_) {
-    absl::ReaderMutexLock lock(&lock_);
-    return functions_.count(name) != 0;
+    return GetSnapshot().contains(name);
   }
 
   // Returns true if the specified factory function is available.
@@ -267,15 +267,13 @@ class FunctionRegistry {
   // The leading "::" in a fully qualified name is stripped.
   std::string GetNormalizedName(absl::string_view name) {
     using ::mediapipe::registration_internal::kCxxSep;
-    std::vector<std::string> names = absl::StrSplit(name, kCxxSep);
-    if (names[0].empty()) {
-      names.erase(names.begin());
-    } else {
-      ABSL_CHECK_EQ(1u, names.size())
-          << "A registered class name must be either fully qualified "
-          << "with a leading :: or unqualified, got: " << name << ".";
+    if (absl::ConsumePrefix(&name, kCxxSep)) {
+      return std::string(name);
     }
-    return absl::StrJoin(names, kCxxSep);
+    ABSL_CHECK(!absl::StrContains(name, kCxxSep))
+        << "A registered class name must be either fully qualified "
+        << "with a leading :: or unqualified, got: " << name << ".";
+    return std::string(name);
   }
 
   // Returns the registry key for a name specified within a namespace.
@@ -294,11 +292,11 @@ class FunctionRegistry {
       return cxx_name;
     }
     std::vector<std::string> spaces = absl::StrSplit(ns, kNameSep);
-    absl::ReaderMutexLock lock(&lock_);
+    const Functions& functions = GetSnapshot();
     while (!spaces.empty()) {
       std::string cxx_ns = absl::StrJoin(spaces, kCxxSep);
       std::string qualified_name = absl::StrCat(cxx_ns, kCxxSep, cxx_name);
-      if (functions_.count(qualified_name)) {
+      if (functions.contains(qualified_name)) {
         return qualified_name;
       }
       spaces.pop_back();
@@ -319,18 +317,52 @@ class FunctionRegistry {
   }
 
  private:
+  using Functions = absl::flat_hash_map<std::string, Function>;
+
   mutable absl::Mutex lock_;
-  absl::flat_hash_map<std::string, Function> functions_ ABSL_GUARDED_BY(lock_);
+  Functions functions_ ABSL_GUARDED_BY(lock_);
+  // An immutable copy of functions_ for lookups without locking, or null if
+  // functions_ changed since the last one was taken. Registration happens
+  // mostly during static initialization, before any lookup, so a snapshot is
+  // usually taken once, by the first lookup.
+  mutable std::atomic<const Functions*> snapshot_{nullptr};
+  // All snapshots taken. A retired snapshot is kept alive with the registry,
+  // since lookups that started before a change may still be reading it.
+  mutable std::vector<std::unique_ptr<const Functions>> snapshots_
+      ABSL_GUARDED_BY(lock_);
+
+  // Returns the current snapshot of functions_, taking it if needed.
+  const Functions& GetSnapshot() const ABSL_LOCKS_EXCLUDED(lock_) {
+    const Functions* snapshot = snapshot_.load(std::memory_order_acquire);
+    if (snapshot != nullptr) {
+      return *snapshot;
+    }
+    absl::WriterMutexLock lock(&lock_);
+    snapshot = snapshot_.load(std::memory_order_relaxed);
+    if (snapshot == nullptr) {
+      snapshots_.push_back(std::make_unique<const Functions>(functions_));
+      snapshot = snapshots_.back().get();
+      snapshot_.store(snapshot, std::memory_order_release);
+    }
+    return *snapshot;
+  }
+
+  // Makes the next lookup take a new snapshot after functions_ changed.
+  void RetireSnapshot() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    snapshot_.store(nullptr, std::memory_order_release);
+  }
 
   // For names included in NamespaceAllowlist, strips the namespace.
   std::string GetAdjustedName(absl::string_view name) {
     using ::mediapipe::registration_internal::kCxxSep;
-    std::vector<std::string> names = absl::StrSplit(name, kCxxSep);
-    std::string base_name = names.back();
-    names.pop_back();
-    std::string ns = absl::StrJoin(names, kCxxSep);
-    if (NamespaceAllowlist::TopNamespaces().count(ns)) {
-      return base_name;
+    const size_t sep = name.rfind(kCxxSep);
+    if (sep == absl::string_view::npos) {
+      // The namespace is empty, which NamespaceAllowlist never includes.
+      return std::string(name);
+    }
+    if (NamespaceAllowlist::TopNamespaces().contains(name.substr(0, sep))) {
+      return std::string(
+          name.substr(sep + absl::string_view(kCxxSep).size()));
     }
     return std::string(name);
   }
@@ -342,6 +374,7 @@ class FunctionRegistry {
       functions_.erase(adjusted_name);
     }
     functions_.erase(name);
+    RetireSnapshot();
   }
 };
 
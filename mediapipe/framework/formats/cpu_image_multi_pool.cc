@@ -0,0 +1,35 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/framework/formats/cpu_image_multi_pool.h"
+
+#include <memory>
+#include <utility>
+
+namespace mediapipe {
+
+std::unique_ptr<ImageFrame> CpuImageMultiPool::GetImageFrame(
+    ImageFormat::Format format, int width, int height,
+    uint32_t alignment_boundary) {
+  ImageFrameSharedPtr pooled_frame =
+      GetBuffer(format, width, height, alignment_boundary);
+  const int width_step = pooled_frame->WidthStep();
+  uint8* pixel_data = pooled_frame->MutablePixelData();
+  return std::make_unique<ImageFrame>(
+      format, width, height, width_step, pixel_data,
+      [pooled_frame = std::move(pooled_frame)](uint8*) {});
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,71 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_FRAMEWORK_FORMATS_CPU_IMAGE_MULTI_POOL_H_
+#define MEDIAPIPE_FRAMEWORK_FORMATS_CPU_IMAGE_MULTI_POOL_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/image_frame_pool.h"
+#include "mediapipe/framework/graph_service.h"
+#include "mediapipe/gpu/multi_pool.h"
+
+namespace mediapipe {
+
+// Lets calculators allocate ImageFrames of various dimensions, formats and
+// alignments, reusing the pixel memory of released frames. It keeps an
+// ImageFramePool for each recently requested spec.
+//
+// Calculators that produce ImageFrames share the pool of a graph through
+// kCpuImageMultiPoolService:
+//
+//   cc->UseService(kCpuImageMultiPoolService).Optional();  // In GetContract.
+//   ...
+//   std::unique_ptr<ImageFrame> frame =
+//       cc->Service(kCpuImageMultiPoolService).GetObject().GetImageFrame(
+//           ImageFormat::FORMAT_SRGB, width, height);
+class CpuImageMultiPool
+    : public MultiPool<ImageFramePool, internal::ImageFrameSpec,
+                       ImageFrameSharedPtr> {
+ public:
+  using MultiPool::MultiPool;
+
+  // Returns a frame, which goes back to its pool when released.
+  ImageFrameSharedPtr GetBuffer(
+      ImageFormat::Format format, int width, int height,
+      uint32_t alignment_boundary = ImageFrame::kDefaultAlignmentBoundary) {
+    return Get(internal::ImageFrameSpec(width, height, format,
+                                        alignment_boundary));
+  }
+
+  // Same as above, but returns a frame that can be moved into a packet with
+  // Adopt. The frame borrows the pixels of a pooled frame, which goes back
+  // to its pool when the returned frame is destroyed.
+  std::unique_ptr<ImageFrame> GetImageFrame(
+      ImageFormat::Format format, int width, int height,
+      uint32_t alignment_boundary = ImageFrame::kDefaultAlignmentBoundary);
+};
+
+// The CpuImageMultiPool shared by the calculators of a graph. It is created
+// on demand unless the graph disallows service default initialization.
+inline constexpr GraphService<CpuImageMultiPool> kCpuImageMultiPoolService(
+    "CpuImageMultiPool", GraphServiceBase::kAllowDefaultInitialization);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_FORMATS_CPU_IMAGE_MULTI_POOL_H_
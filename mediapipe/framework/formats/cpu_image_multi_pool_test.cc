@@ -0,0 +1,88 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/framework/formats/cpu_image_multi_pool.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(CpuImageMultiPoolTest, ReusesReleasedFrames) {
+  CpuImageMultiPool pool({.min_requests_before_pool = 1});
+  const uint8* pixels;
+  {
+    ImageFrameSharedPtr frame = pool.GetBuffer(ImageFormat::FORMAT_SRGB, 10, 8);
+    pixels = frame->PixelData();
+  }
+  // A frame of the same spec reuses the released pixels.
+  ImageFrameSharedPtr frame = pool.GetBuffer(ImageFormat::FORMAT_SRGB, 10, 8);
+  EXPECT_EQ(frame->PixelData(), pixels);
+  // A frame that is alive keeps its pixels.
+  ImageFrameSharedPtr other = pool.GetBuffer(ImageFormat::FORMAT_SRGB, 10, 8);
+  EXPECT_NE(other->PixelData(), pixels);
+  EXPECT_EQ(pool.GetStats().hits, 2);
+  EXPECT_EQ(pool.GetStats().pool_count, 1);
+}
+
+TEST(CpuImageMultiPoolTest, KeysByFormatAndAlignment) {
+  CpuImageMultiPool pool({.min_requests_before_pool = 1});
+  ImageFrameSharedPtr frame = pool.GetBuffer(ImageFormat::FORMAT_SRGB, 10, 8,
+                                             /*alignment_boundary=*/1);
+  EXPECT_EQ(frame->Format(), ImageFormat::FORMAT_SRGB);
+  EXPECT_EQ(frame->WidthStep(), 30);
+  frame = pool.GetBuffer(ImageFormat::FORMAT_SRGB, 10, 8, /*alignment_boundary=*/16);
+  EXPECT_EQ(frame->WidthStep(), 32);
+  frame = pool.GetBuffer(ImageFormat::FORMAT_GRAY8, 10, 8, /*alignment_boundary=*/16);
+  EXPECT_EQ(frame->Format(), ImageFormat::FORMAT_GRAY8);
+  EXPECT_EQ(frame->WidthStep(), 16);
+  EXPECT_EQ(pool.GetStats().pool_count, 3);
+  EXPECT_EQ(pool.GetStats().bytes_held,
+            2 * (30 * 8 + 32 * 8 + 16 * 8));  // keep_count frames per pool.
+}
+
+TEST(CpuImageMultiPoolTest, ImageFrameBorrowsPooledPixels) {
+  auto pool = std::make_unique<CpuImageMultiPool>(
+      MultiPoolOptions{.keep_count = 1, .min_requests_before_pool = 1});
+  const uint8* pixels;
+  {
+    std::unique_ptr<ImageFrame> frame =
+        pool->GetImageFrame(ImageFormat::FORMAT_SRGBA, 4, 4);
+    pixels = frame->PixelData();
+  }
+  {
+    std::unique_ptr<ImageFrame> frame =
+        pool->GetImageFrame(ImageFormat::FORMAT_SRGBA, 4, 4);
+    EXPECT_EQ(frame->PixelData(), pixels);
+  }
+  // The frame stays valid after the pool is destroyed.
+  std::unique_ptr<ImageFrame> frame =
+      pool->GetImageFrame(ImageFormat::FORMAT_SRGBA, 4, 4);
+  pool.reset();
+  frame->MutablePixelData()[0] = 1;
+  EXPECT_EQ(frame->PixelData()[0], 1);
+}
+
+TEST(CpuImageMultiPoolTest, ServiceSupportsDefaultInitialization) {
+  MP_EXPECT_OK(kCpuImageMultiPoolService.CreateDefaultObject());
+}
+
+}  // namespace
+}  // namespace mediapipe
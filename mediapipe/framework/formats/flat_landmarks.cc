@@ -0,0 +1,92 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/formats/flat_landmarks.h"
+
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
+#include "mediapipe/framework/formats/location_data.pb.h"
+
+namespace mediapipe {
+
+void ToFlatLandmarks(const NormalizedLandmarkList& landmarks,
+                     FlatLandmarks& flat_landmarks) {
+  flat_landmarks.resize(landmarks.landmark_size());
+  for (int i = 0; i < landmarks.landmark_size(); ++i) {
+    const NormalizedLandmark& landmark = landmarks.landmark(i);
+    FlatLandmark& flat_landmark = flat_landmarks[i];
+    flat_landmark.x = landmark.x();
+    flat_landmark.y = landmark.y();
+    flat_landmark.z = landmark.z();
+    flat_landmark.visibility = landmark.visibility();
+    flat_landmark.presence = landmark.presence();
+    flat_landmark.has_visibility = landmark.has_visibility();
+    flat_landmark.has_presence = landmark.has_presence();
+  }
+}
+
+void ToNormalizedLandmarkList(const FlatLandmarks& flat_landmarks,
+                              NormalizedLandmarkList& landmarks) {
+  landmarks.clear_landmark();
+  landmarks.mutable_landmark()->Reserve(flat_landmarks.size());
+  for (const FlatLandmark& flat_landmark : flat_landmarks) {
+    NormalizedLandmark* landmark = landmarks.add_landmark();
+    landmark->set_x(flat_landmark.x);
+    landmark->set_y(flat_landmark.y);
+    landmark->set_z(flat_landmark.z);
+    if (flat_landmark.has_visibility) {
+      landmark->set_visibility(flat_landmark.visibility);
+    }
+    if (flat_landmark.has_presence) {
+      landmark->set_presence(flat_landmark.presence);
+    }
+  }
+}
+
+FlatDetection ToFlatDetection(const Detection& detection) {
+  FlatDetection flat_detection;
+  if (detection.label_id_size() > 0) {
+    flat_detection.label_id = detection.label_id(0);
+  }
+  if (detection.score_size() > 0) {
+    flat_detection.score = detection.score(0);
+  }
+  const LocationData& location_data = detection.location_data();
+  if (location_data.format() ==
+      LocationData::LOCATION_FORMAT_RELATIVE_BOUNDING_BOX) {
+    const auto& box = location_data.relative_bounding_box();
+    flat_detection.xmin = box.xmin();
+    flat_detection.ymin = box.ymin();
+    flat_detection.width = box.width();
+    flat_detection.height = box.height();
+  }
+  return flat_detection;
+}
+
+Detection ToDetection(const FlatDetection& flat_detection) {
+  Detection detection;
+  detection.add_label_id(flat_detection.label_id);
+  detection.add_score(flat_detection.score);
+  LocationData* location_data = detection.mutable_location_data();
+  location_data->set_format(
+      LocationData::LOCATION_FORMAT_RELATIVE_BOUNDING_BOX);
+  auto* box = location_data->mutable_relative_bounding_box();
+  box->set_xmin(flat_detection.xmin);
+  box->set_ymin(flat_detection.ymin);
+  box->set_width(flat_detection.width);
+  box->set_height(flat_detection.height);
+  return detection;
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,82 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Flat, trivially copyable counterparts of the NormalizedLandmark and
+// Detection protos for the calculators between landmark inference and
+// rendering. A list of them is a single contiguous allocation that can be
+// copied with memcpy, rather than a repeated field of individually allocated
+// messages. Graphs convert from and to the protos at their boundaries, see
+// mediapipe/calculators/util/flat_landmarks_conversion_calculator.cc.
+
+#ifndef MEDIAPIPE_FRAMEWORK_FORMATS_FLAT_LANDMARKS_H_
+#define MEDIAPIPE_FRAMEWORK_FORMATS_FLAT_LANDMARKS_H_
+
+#include <type_traits>
+#include <vector>
+
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
+
+namespace mediapipe {
+
+// A NormalizedLandmark without its name.
+struct FlatLandmark {
+  float x = 0.0f;
+  float y = 0.0f;
+  float z = 0.0f;
+  // Only meaningful if the corresponding has_* flag is set.
+  float visibility = 0.0f;
+  float presence = 0.0f;
+  bool has_visibility = false;
+  bool has_presence = false;
+};
+
+// A Detection with a single label and score, and a relative bounding box. The
+// keypoints and other location data of the proto are not kept.
+struct FlatDetection {
+  int label_id = 0;
+  float score = 0.0f;
+  float xmin = 0.0f;
+  float ymin = 0.0f;
+  float width = 0.0f;
+  float height = 0.0f;
+};
+
+static_assert(std::is_trivially_copyable<FlatLandmark>::value,
+              "FlatLandmark must be trivially copyable");
+static_assert(std::is_trivially_copyable<FlatDetection>::value,
+              "FlatDetection must be trivially copyable");
+
+using FlatLandmarks = std::vector<FlatLandmark>;
+using FlatDetections = std::vector<FlatDetection>;
+
+// Converts `landmarks` into `flat_landmarks`, reusing its storage.
+void ToFlatLandmarks(const NormalizedLandmarkList& landmarks,
+                     FlatLandmarks& flat_landmarks);
+
+// Converts `flat_landmarks` into `landmarks`, replacing its landmarks.
+void ToNormalizedLandmarkList(const FlatLandmarks& flat_landmarks,
+                              NormalizedLandmarkList& landmarks);
+
+// Converts `detection` into a FlatDetection with its first label id and score.
+// The bounding box is only set if the location data of `detection` has the
+// RELATIVE_BOUNDING_BOX format.
+FlatDetection ToFlatDetection(const Detection& detection);
+
+// Converts `flat_detection` into a Detection with a relative bounding box.
+Detection ToDetection(const FlatDetection& flat_detection);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_FORMATS_FLAT_LANDMARKS_H_
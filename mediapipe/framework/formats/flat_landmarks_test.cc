@@ -0,0 +1,77 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/formats/flat_landmarks.h"
+
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
+#include "mediapipe/framework/formats/location_data.pb.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(FlatLandmarksTest, ConvertsLandmarks) {
+  const auto landmarks = ParseTextProtoOrDie<NormalizedLandmarkList>(R"pb(
+    landmark { x: 0.1 y: 0.2 z: 0.3 visibility: 0.4 }
+    landmark { x: 0.5 y: 0.6 z: 0.7 presence: 0.8 }
+  )pb");
+
+  FlatLandmarks flat_landmarks(5);
+  ToFlatLandmarks(landmarks, flat_landmarks);
+
+  ASSERT_EQ(flat_landmarks.size(), 2);
+  EXPECT_FLOAT_EQ(flat_landmarks[0].x, 0.1f);
+  EXPECT_FLOAT_EQ(flat_landmarks[0].y, 0.2f);
+  EXPECT_FLOAT_EQ(flat_landmarks[0].z, 0.3f);
+  EXPECT_TRUE(flat_landmarks[0].has_visibility);
+  EXPECT_FLOAT_EQ(flat_landmarks[0].visibility, 0.4f);
+  EXPECT_FALSE(flat_landmarks[0].has_presence);
+  EXPECT_FALSE(flat_landmarks[1].has_visibility);
+  EXPECT_TRUE(flat_landmarks[1].has_presence);
+  EXPECT_FLOAT_EQ(flat_landmarks[1].presence, 0.8f);
+
+  NormalizedLandmarkList converted_landmarks;
+  *converted_landmarks.add_landmark() = landmarks.landmark(0);
+  ToNormalizedLandmarkList(flat_landmarks, converted_landmarks);
+
+  EXPECT_EQ(converted_landmarks.SerializeAsString(),
+            landmarks.SerializeAsString());
+}
+
+TEST(FlatLandmarksTest, ConvertsDetection) {
+  const auto detection = ParseTextProtoOrDie<Detection>(R"pb(
+    label_id: 3
+    score: 0.9
+    location_data {
+      format: LOCATION_FORMAT_RELATIVE_BOUNDING_BOX
+      relative_bounding_box { xmin: 0.1 ymin: 0.2 width: 0.3 height: 0.4 }
+    }
+  )pb");
+
+  const FlatDetection flat_detection = ToFlatDetection(detection);
+
+  EXPECT_EQ(flat_detection.label_id, 3);
+  EXPECT_FLOAT_EQ(flat_detection.score, 0.9f);
+  EXPECT_FLOAT_EQ(flat_detection.xmin, 0.1f);
+  EXPECT_FLOAT_EQ(flat_detection.ymin, 0.2f);
+  EXPECT_FLOAT_EQ(flat_detection.width, 0.3f);
+  EXPECT_FLOAT_EQ(flat_detection.height, 0.4f);
+  EXPECT_EQ(ToDetection(flat_detection).SerializeAsString(),
+            detection.SerializeAsString());
+}
+
+}  // namespace
+}  // namespace mediapipe
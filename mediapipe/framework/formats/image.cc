@@ -30,6 +30,11 @@ bool Image::ConvertToCpu() const {
   return true;
 }
 
+Image Image::SubRectView(int x, int y, int width, int height) const {
+  return Image(ImageFrameSharedPtr(CreateImageFrameSubRectView(
+      gpu_buffer_.GetReadView<ImageFrame>(), x, y, width, height)));
+}
+
 // TODO Refactor common code from ImageFrameToGpuBufferCalculator
 bool Image::ConvertToGpu() const {
 #if MEDIAPIPE_DISABLE_GPU
@@ -82,6 +82,14 @@ class Image {
     return gpu_buffer_.GetWriteView<ImageFrame>();
   }
 
+  // Creates an Image representing the same image content as the input GPU
+  // buffer. Available without GPU support too, since a GpuBuffer may also
+  // hold CPU storage such as a YUVImage.
+  explicit Image(mediapipe::GpuBuffer gpu_buffer) {
+    use_gpu_ = true;
+    gpu_buffer_ = gpu_buffer;
+  }
+
   // Creates an Image representing the same image content as the input GPU
   // buffer in platform-specific representations.
 #if !MEDIAPIPE_DISABLE_GPU
@@ -94,10 +102,6 @@ class Image {
   explicit Image(mediapipe::GlTextureBufferSharedPtr texture_buffer)
       : Image(mediapipe::GpuBuffer(std::move(texture_buffer))) {}
 #endif  // MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
-  explicit Image(mediapipe::GpuBuffer gpu_buffer) {
-    use_gpu_ = true;
-    gpu_buffer_ = gpu_buffer;
-  }
 
   // GPU getters.
 #if MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
@@ -148,6 +152,13 @@ class Image {
   void LockPixels() const ABSL_EXCLUSIVE_LOCK_FUNCTION();
   void UnlockPixels() const ABSL_UNLOCK_FUNCTION();
 
+  // Returns an Image that references the sub-rectangle of this image with its
+  // top left corner at (x, y), without copying the pixels. Only CPU storage
+  // supports views, so GPU content is downloaded first. The view keeps the
+  // pixels alive, and writes to them through either image are visible in
+  // both. See CreateImageFrameSubRectView.
+  Image SubRectView(int x, int y, int width, int height) const;
+
   // Helper utility for GPU->CPU data transfer.
   bool ConvertToCpu() const;
   // Helper utility for CPU->GPU data transfer.
@@ -426,4 +426,27 @@ void ImageFrame::CopyToBuffer(float* buffer, int buffer_size) const {
                          reinterpret_cast<char*>(buffer));
   }
 }
+
+std::unique_ptr<ImageFrame> CreateImageFrameSubRectView(
+    std::shared_ptr<const ImageFrame> parent, int x, int y, int width,
+    int height) {
+  ABSL_CHECK(parent);
+  ABSL_CHECK(!parent->IsEmpty());
+  ABSL_CHECK_GE(x, 0);
+  ABSL_CHECK_GE(y, 0);
+  ABSL_CHECK_GT(width, 0);
+  ABSL_CHECK_GT(height, 0);
+  ABSL_CHECK_LE(x + width, parent->Width());
+  ABSL_CHECK_LE(y + height, parent->Height());
+  const ImageFormat::Format format = parent->Format();
+  const int width_step = parent->WidthStep();
+  const int pixel_bytes = parent->NumberOfChannels() * parent->ByteDepth();
+  // The view never frees the pixels, it only releases parent.
+  uint8_t* pixel_data = const_cast<uint8_t*>(parent->PixelData()) +
+                        y * width_step + x * pixel_bytes;
+  return std::make_unique<ImageFrame>(
+      format, width, height, width_step, pixel_data,
+      [parent = std::move(parent)](uint8_t*) {});
+}
+
 }  // namespace mediapipe
@@ -40,6 +40,7 @@
 #include <string>
 
 #include "mediapipe/framework/formats/image_format.pb.h"
+#include "mediapipe/framework/payload_size.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/tool/type_util.h"
@@ -252,6 +253,23 @@ class ImageFrame {
   std::unique_ptr<uint8[], Deleter> pixel_data_;
 };
 
+// Returns an ImageFrame that references the pixels of the sub-rectangle of
+// parent with its top left corner at (x, y), without copying them. The view
+// has the WidthStep of parent, so it is not contiguous unless it spans whole
+// rows, and it keeps parent alive until it is destroyed. Writing to the view
+// writes to parent. The sub-rectangle must lie within parent.
+std::unique_ptr<ImageFrame> CreateImageFrameSubRectView(
+    std::shared_ptr<const ImageFrame> parent, int x, int y, int width,
+    int height);
+
+// Counts the pixel data of an ImageFrame, for memory accounting.
+template <>
+struct PayloadSize<ImageFrame> {
+  static size_t Get(const ImageFrame& frame) {
+    return sizeof(ImageFrame) + (frame.IsEmpty() ? 0 : frame.PixelDataSize());
+  }
+};
+
 }  // namespace mediapipe
 
 #endif  // MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_FRAME_H_
@@ -14,6 +14,8 @@
 
 #include "mediapipe/framework/formats/image_frame_opencv.h"
 
+#include <memory>
+
 #include "mediapipe/framework/formats/image_format.pb.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/port/gtest.h"
@@ -134,5 +136,28 @@ TEST(ImageFrameOpencvTest, ImageFormats) {
   EXPECT_EQ(mat_c4.type(), CV_8UC4);
 }
 
+TEST(ImageFrameOpencvTest, SubRectViewSharesPixels) {
+  auto parent = std::make_shared<ImageFrame>(ImageFormat::FORMAT_SRGB, 40, 30);
+  cv::Mat parent_mat = formats::MatView(parent.get());
+  parent_mat.setTo(cv::Scalar(1, 2, 3));
+  parent_mat(cv::Rect(5, 7, 10, 8)).setTo(cv::Scalar(4, 5, 6));
+
+  std::unique_ptr<ImageFrame> view =
+      CreateImageFrameSubRectView(parent, 5, 7, 10, 8);
+  EXPECT_EQ(view->Width(), 10);
+  EXPECT_EQ(view->Height(), 8);
+  EXPECT_EQ(view->WidthStep(), parent->WidthStep());
+  EXPECT_FALSE(view->IsContiguous());
+  cv::Mat view_mat = formats::MatView(view.get());
+  EXPECT_EQ(cv::sum(view_mat), cv::Scalar(4 * 80, 5 * 80, 6 * 80));
+
+  // The view writes to the parent's pixels, and keeps them alive.
+  view_mat.setTo(cv::Scalar(7, 8, 9));
+  EXPECT_EQ(parent_mat.at<cv::Vec3b>(7, 5), cv::Vec3b(7, 8, 9));
+  EXPECT_EQ(parent_mat.at<cv::Vec3b>(6, 5), cv::Vec3b(1, 2, 3));
+  parent.reset();
+  EXPECT_EQ(view_mat.at<cv::Vec3b>(7, 9), cv::Vec3b(7, 8, 9));
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -18,12 +18,9 @@
 
 namespace mediapipe {
 
-ImageFramePool::ImageFramePool(int width, int height,
-                               ImageFormat::Format format, int keep_count)
-    : width_(width),
-      height_(height),
-      format_(format),
-      keep_count_(keep_count) {}
+ImageFramePool::ImageFramePool(const internal::ImageFrameSpec& spec,
+                               int keep_count)
+    : spec_(spec), keep_count_(keep_count) {}
 
 ImageFrameSharedPtr ImageFramePool::GetBuffer() {
   std::unique_ptr<ImageFrame> buffer;
@@ -31,9 +28,8 @@ ImageFrameSharedPtr ImageFramePool::GetBuffer() {
   {
     absl::MutexLock lock(&mutex_);
     if (available_.empty()) {
-      // Fix alignment at 4 for best compatability with OpenGL.
       buffer = std::make_unique<ImageFrame>(
-          format_, width_, height_, ImageFrame::kGlDefaultAlignmentBoundary);
+          spec_.format, spec_.width, spec_.height, spec_.alignment_boundary);
       if (!buffer) return nullptr;
     } else {
       buffer = std::move(available_.back());
@@ -18,16 +18,61 @@
 #ifndef MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_FRAME_POOL_H_
 #define MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_FRAME_POOL_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/gpu/multi_pool.h"
 
 namespace mediapipe {
 
 using ImageFrameSharedPtr = std::shared_ptr<ImageFrame>;
 
+namespace internal {
+
+// The dimensions, format and row alignment of the ImageFrames of a pool.
+struct ImageFrameSpec {
+  ImageFrameSpec(int w, int h, ImageFormat::Format f,
+                 uint32_t a = ImageFrame::kGlDefaultAlignmentBoundary)
+      : width(w), height(h), format(f), alignment_boundary(a) {}
+
+  // Returns the number of bytes of pixel data in a frame with this spec.
+  size_t byte_size() const {
+    const size_t row_bytes = static_cast<size_t>(width) *
+                             ImageFrame::NumberOfChannelsForFormat(format) *
+                             ImageFrame::ChannelSizeForFormat(format);
+    const size_t width_step = (row_bytes + alignment_boundary - 1) /
+                              alignment_boundary * alignment_boundary;
+    return width_step * height;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const ImageFrameSpec& spec) {
+    return H::combine(std::move(h), spec.width, spec.height,
+                      static_cast<uint32_t>(spec.format),
+                      spec.alignment_boundary);
+  }
+
+  int width;
+  int height;
+  ImageFormat::Format format;
+  uint32_t alignment_boundary;
+};
+
+inline bool operator==(const ImageFrameSpec& lhs, const ImageFrameSpec& rhs) {
+  return lhs.width == rhs.width && lhs.height == rhs.height &&
+         lhs.format == rhs.format &&
+         lhs.alignment_boundary == rhs.alignment_boundary;
+}
+inline bool operator!=(const ImageFrameSpec& lhs, const ImageFrameSpec& rhs) {
+  return !operator==(lhs, rhs);
+}
+
+}  // namespace internal
+
 class ImageFramePool : public std::enable_shared_from_this<ImageFramePool> {
  public:
   // Creates a pool. This pool will manage buffers of the specified dimensions,
@@ -37,23 +82,34 @@ class ImageFramePool : public std::enable_shared_from_this<ImageFramePool> {
   static std::shared_ptr<ImageFramePool> Create(int width, int height,
                                                 ImageFormat::Format format,
                                                 int keep_count) {
+    return Create({width, height, format}, {.keep_count = keep_count});
+  }
+
+  static std::shared_ptr<ImageFramePool> Create(
+      const internal::ImageFrameSpec& spec, const MultiPoolOptions& options) {
     return std::shared_ptr<ImageFramePool>(
-        new ImageFramePool(width, height, format, keep_count));
+        new ImageFramePool(spec, options.keep_count));
+  }
+
+  static ImageFrameSharedPtr CreateBufferWithoutPool(
+      const internal::ImageFrameSpec& spec) {
+    return std::make_shared<ImageFrame>(spec.format, spec.width, spec.height,
+                                        spec.alignment_boundary);
   }
 
   // Obtains a buffers. May either be reused or created anew.
   ImageFrameSharedPtr GetBuffer();
 
-  int width() const { return width_; }
-  int height() const { return height_; }
-  ImageFormat::Format format() const { return format_; }
+  int width() const { return spec_.width; }
+  int height() const { return spec_.height; }
+  ImageFormat::Format format() const { return spec_.format; }
+  uint32_t alignment_boundary() const { return spec_.alignment_boundary; }
 
   // This method is meant for testing.
   std::pair<int, int> GetInUseAndAvailableCounts();
 
  private:
-  ImageFramePool(int width, int height, ImageFormat::Format format,
-                 int keep_count);
+  ImageFramePool(const internal::ImageFrameSpec& spec, int keep_count);
 
   // Return a buffer to the pool.
   void Return(ImageFrame* buf);
@@ -63,9 +119,7 @@ class ImageFramePool : public std::enable_shared_from_this<ImageFramePool> {
   void TrimAvailable(std::vector<std::unique_ptr<ImageFrame>>* trimmed)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
-  const int width_;
-  const int height_;
-  const ImageFormat::Format format_;
+  const internal::ImageFrameSpec spec_;
   const int keep_count_;
 
   absl::Mutex mutex_;
@@ -14,6 +14,8 @@
 
 #include "mediapipe/framework/formats/image_multi_pool.h"
 
+#include <cstdint>
+#include <deque>
 #include <tuple>
 
 #include "absl/log/absl_check.h"
@@ -36,6 +38,35 @@ static constexpr int kKeepCount = 2;
 // oldest IBufferSpec will be dropped.
 static constexpr int kMaxPoolCount = 20;
 
+namespace {
+
+// Returns the bytes kept by a pool for the spec.
+int64_t PoolBytes(const ImageMultiPool::IBufferSpec& spec) {
+  return static_cast<int64_t>(spec.width) * spec.height *
+         ImageFrame::ByteDepthForFormat(spec.format) *
+         ImageFrame::NumberOfChannelsForFormat(spec.format) * kKeepCount;
+}
+
+// Drops the least recently used pools, except the most recently used one,
+// until the pools keep at most max_pool_bytes. `specs` lists the specs of
+// `pools` from the least to the most recently used.
+template <typename Pools>
+void EvictPoolsOverBudget(int64_t max_pool_bytes, Pools& pools,
+                          std::deque<ImageMultiPool::IBufferSpec>& specs,
+                          ImageMultiPool::Stats& stats) {
+  stats.bytes_held = 0;
+  for (const auto& spec : specs) stats.bytes_held += PoolBytes(spec);
+  while (max_pool_bytes > 0 && stats.bytes_held > max_pool_bytes &&
+         specs.size() > 1) {
+    stats.bytes_held -= PoolBytes(specs.front());
+    pools.erase(specs.front());
+    specs.pop_front();
+  }
+  stats.pool_count = pools.size();
+}
+
+}  // namespace
+
 #if !MEDIAPIPE_DISABLE_GPU
 
 #if MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
@@ -130,6 +161,7 @@ Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
     IBufferSpec key(width, height, format);
     auto pool_it = pools_gpu_.find(key);
     if (pool_it == pools_gpu_.end()) {
+      ++stats_gpu_.misses;
       // Discard the least recently used pool in LRU cache.
       if (pools_gpu_.size() >= kMaxPoolCount) {
         auto old_spec = buffer_specs_gpu_.front();  // Front has LRU.
@@ -141,6 +173,7 @@ Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
           std::piecewise_construct, std::forward_as_tuple(key),
           std::forward_as_tuple(MakeSimplePoolGpu(key)));
     } else {
+      ++stats_gpu_.hits;
       // Find and move current 'key' spec to back, keeping others in same order.
       auto specs_it = buffer_specs_gpu_.begin();
       while (specs_it != buffer_specs_gpu_.end()) {
@@ -152,6 +185,8 @@ Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
       }
       buffer_specs_gpu_.push_back(key);
     }
+    EvictPoolsOverBudget(options_.max_pool_bytes, pools_gpu_,
+                         buffer_specs_gpu_, stats_gpu_);
     return GetBufferFromSimplePool(pool_it->first, pool_it->second);
   } else  // NOLINT(readability/braces)
 #endif    // !MEDIAPIPE_DISABLE_GPU
@@ -160,6 +195,7 @@ Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
     IBufferSpec key(width, height, format);
     auto pool_it = pools_cpu_.find(key);
     if (pool_it == pools_cpu_.end()) {
+      ++stats_cpu_.misses;
       // Discard the least recently used pool in LRU cache.
       if (pools_cpu_.size() >= kMaxPoolCount) {
         auto old_spec = buffer_specs_cpu_.front();  // Front has LRU.
@@ -171,6 +207,7 @@ Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
           std::piecewise_construct, std::forward_as_tuple(key),
           std::forward_as_tuple(MakeSimplePoolCpu(key)));
     } else {
+      ++stats_cpu_.hits;
       // Find and move current 'key' spec to back, keeping others in same order.
       auto specs_it = buffer_specs_cpu_.begin();
       while (specs_it != buffer_specs_cpu_.end()) {
@@ -182,10 +219,23 @@ Image ImageMultiPool::GetBuffer(int width, int height, bool use_gpu,
       }
       buffer_specs_cpu_.push_back(key);
     }
+    EvictPoolsOverBudget(options_.max_pool_bytes, pools_cpu_,
+                         buffer_specs_cpu_, stats_cpu_);
     return GetBufferFromSimplePool(pool_it->first, pool_it->second);
   }
 }
 
+ImageMultiPool::Stats ImageMultiPool::GetStats(bool use_gpu) {
+#if !MEDIAPIPE_DISABLE_GPU
+  if (use_gpu) {
+    absl::MutexLock lock(&mutex_gpu_);
+    return stats_gpu_;
+  }
+#endif  // !MEDIAPIPE_DISABLE_GPU
+  absl::MutexLock lock(&mutex_cpu_);
+  return stats_cpu_;
+}
+
 ImageMultiPool::~ImageMultiPool() {
 #if !MEDIAPIPE_DISABLE_GPU
 #ifdef __APPLE__
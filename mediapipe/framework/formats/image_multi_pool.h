@@ -22,6 +22,7 @@
 #ifndef MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_MULTI_POOL_H_
 #define MEDIAPIPE_FRAMEWORK_FORMATS_IMAGE_MULTI_POOL_H_
 
+#include <cstdint>
 #include <deque>
 #include <limits>
 #include <unordered_map>
@@ -49,14 +50,38 @@ using ImageFrameSharedPtr = std::shared_ptr<ImageFrame>;
 // TODO: Update to use new pool eviction policy.
 class ImageMultiPool {
  public:
+  struct Options {
+    // The maximum number of bytes kept by the CPU pools, and separately by the
+    // GPU pools, counting the buffers each pool keeps for reuse. When the limit
+    // is exceeded, the least recently used pools are dropped; the pool in use
+    // is kept even if it exceeds the limit by itself. 0 means no limit.
+    int64_t max_pool_bytes = 0;
+  };
+
+  struct Stats {
+    // The number of requests served by an existing pool.
+    int64_t hits = 0;
+    // The number of requests that created a pool.
+    int64_t misses = 0;
+    // The number of bytes kept by the current pools.
+    int64_t bytes_held = 0;
+    // The number of current pools.
+    int pool_count = 0;
+  };
+
   ImageMultiPool() {}
   explicit ImageMultiPool(void* ignored) {}
+  explicit ImageMultiPool(const Options& options) : options_(options) {}
   ~ImageMultiPool();
 
   // Obtains a buffer. May either be reused or created anew.
   Image GetBuffer(int width, int height, bool use_gpu,
                   ImageFormat::Format format /*= ImageFormat::FORMAT_SRGBA*/);
 
+  // Returns the request counters since construction, and the current pools,
+  // for the GPU or the CPU pools.
+  Stats GetStats(bool use_gpu);
+
 #if !MEDIAPIPE_DISABLE_GPU
 #ifdef __APPLE__
   // TODO: add tests for the texture cache registration.
@@ -116,6 +141,7 @@ class ImageMultiPool {
   // A queue of IBufferSpecs to keep track of the age of each IBufferSpec added
   // to the pool.
   std::deque<IBufferSpec> buffer_specs_gpu_;
+  Stats stats_gpu_ ABSL_GUARDED_BY(mutex_gpu_);
 #endif  // !MEDIAPIPE_DISABLE_GPU
 
   typedef std::shared_ptr<ImageFramePool> SimplePoolCpu;
@@ -128,6 +154,9 @@ class ImageMultiPool {
   // A queue of IBufferSpecs to keep track of the age of each IBufferSpec added
   // to the pool.
   std::deque<IBufferSpec> buffer_specs_cpu_;
+  Stats stats_cpu_ ABSL_GUARDED_BY(mutex_cpu_);
+
+  const Options options_;
 
 #if !MEDIAPIPE_DISABLE_GPU
 #ifdef __APPLE__
@@ -14,13 +14,18 @@
 
 #include "mediapipe/framework/formats/tensor.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/port.h"
+#include "mediapipe/framework/port/aligned_malloc_and_free.h"
 #if MEDIAPIPE_OPENGL_ES_VERSION >= MEDIAPIPE_OPENGL_ES_30
 #include "mediapipe/gpu/gl_base.h"
 #endif  // MEDIAPIPE_OPENGL_ES_VERSION >= MEDIAPIPE_OPENGL_ES_30
@@ -37,6 +42,75 @@
 
 namespace mediapipe {
 
+namespace {
+
+uint32_t FloatBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+float HalfToFloat(uint16_t half) {
+  constexpr uint32_t kShiftedExponent = 0x7c00 << 13;
+  uint32_t bits = (half & 0x7fff) << 13;
+  const uint32_t exponent = bits & kShiftedExponent;
+  // Rebiases the exponent from 15 to 127.
+  bits += (127 - 15) << 23;
+  if (exponent == kShiftedExponent) {
+    // Infinity or NaN.
+    bits += (128 - 16) << 23;
+  } else if (exponent == 0) {
+    // Zero or subnormal, renormalized by a float subtraction.
+    bits += 1 << 23;
+    bits = FloatBits(BitsToFloat(bits) - BitsToFloat(113 << 23));
+  }
+  bits |= static_cast<uint32_t>(half & 0x8000) << 16;
+  return BitsToFloat(bits);
+}
+
+uint16_t FloatToHalf(float value) {
+  uint32_t bits = FloatBits(value);
+  const uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+  uint16_t half;
+  if (bits >= (127 + 16) << 23) {
+    // Out of the half range, infinity or NaN.
+    half = bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+  } else if (bits < (127 - 14) << 23) {
+    // Subnormal or zero, rounded by a float addition that aligns the
+    // mantissa with the half subnormal precision.
+    constexpr uint32_t kDenormalMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+    half = FloatBits(BitsToFloat(bits) + BitsToFloat(kDenormalMagic)) -
+           kDenormalMagic;
+  } else {
+    // Rebiases the exponent from 127 to 15 and rounds to nearest even.
+    const uint32_t mantissa_odd = (bits >> 13) & 1;
+    bits += ((15 - 127) << 23) + 0xfff + mantissa_odd;
+    half = bits >> 13;
+  }
+  return half | (sign >> 16);
+}
+
+}  // namespace
+
+void Float16ToFloat32(const uint16_t* src, float* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = HalfToFloat(src[i]);
+  }
+}
+
+void Float32ToFloat16(const float* src, uint16_t* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = FloatToHalf(src[i]);
+  }
+}
+
 // Zero and negative values are not checked here.
 bool IsPowerOfTwo(int v) { return (v & (v - 1)) == 0; }
 
@@ -170,22 +244,38 @@ Tensor::OpenGlTexture2dView Tensor::GetOpenGlTexture2dReadView() const {
   auto lock = absl::make_unique<absl::MutexLock>(&view_mutex_);
   AllocateOpenGlTexture2d();
   if (!(valid_ & kValidOpenGlTexture2d)) {
+    // A kFloat16 tensor is uploaded as half floats into its half float
+    // texture, or widened to floats on OpenGL ES 2.0.
+    const bool widen_half_floats =
+        element_type_ == ElementType::kFloat16 &&
+        gl_context_->GetGlVersion() == mediapipe::GlVersion::kGLES2;
+    const int texel_element_size =
+        widen_half_floats ? sizeof(float) : element_size();
     const int padded_size =
-        texture_height_ * texture_width_ * 4 * element_size();
+        texture_height_ * texture_width_ * 4 * texel_element_size;
     auto temp_buffer = absl::make_unique<uint8_t[]>(padded_size);
     uint8_t* dest_buffer = temp_buffer.get();
     uint8_t* src_buffer = reinterpret_cast<uint8_t*>(cpu_buffer_);
     const int num_elements = BhwcWidthFromShape(shape_) *
                              BhwcHeightFromShape(shape_) *
                              BhwcBatchFromShape(shape_);
-    const int actual_depth_size = BhwcDepthFromShape(shape_) * element_size();
-    const int padded_depth_size =
-        (BhwcDepthFromShape(shape_) + 3) / 4 * 4 * element_size();
+    const int depth = BhwcDepthFromShape(shape_);
+    const int actual_depth_size = depth * element_size();
+    const int padded_depth_size = (depth + 3) / 4 * 4 * texel_element_size;
     for (int e = 0; e < num_elements; e++) {
-      std::memcpy(dest_buffer, src_buffer, actual_depth_size);
+      if (widen_half_floats) {
+        Float16ToFloat32(reinterpret_cast<const uint16_t*>(src_buffer),
+                         reinterpret_cast<float*>(dest_buffer), depth);
+      } else {
+        std::memcpy(dest_buffer, src_buffer, actual_depth_size);
+      }
       src_buffer += actual_depth_size;
       dest_buffer += padded_depth_size;
     }
+    const GLenum type =
+        element_type_ == ElementType::kFloat16 && !widen_half_floats
+            ? GL_HALF_FLOAT
+            : GL_FLOAT;
     // Transfer from CPU memory into GPU memory.
     glBindTexture(GL_TEXTURE_2D, opengl_texture2d_);
     // Set alignment for the proper value (default) to avoid address sanitizer
@@ -207,7 +297,7 @@ Tensor::OpenGlTexture2dView Tensor::GetOpenGlTexture2dReadView() const {
 #endif  // __EMSCRIPTEN__
     {
       glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture_width_, texture_height_,
-                      GL_RGBA, GL_FLOAT, temp_buffer.get());
+                      GL_RGBA, type, temp_buffer.get());
     }
     glBindTexture(GL_TEXTURE_2D, 0);
     valid_ |= kValidOpenGlTexture2d;
@@ -290,8 +380,10 @@ void Tensor::AllocateOpenGlTexture2d() const {
     if (gl_context_->GetGlVersion() != mediapipe::GlVersion::kGLES2) {
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
-      glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, texture_width_,
-                     texture_height_);
+      glTexStorage2D(
+          GL_TEXTURE_2D, 1,
+          element_type_ == ElementType::kFloat16 ? GL_RGBA16F : GL_RGBA32F,
+          texture_width_, texture_height_);
     } else {
       // GLES2.0 supports only clamp addressing mode for NPOT textures.
       // If any of dimensions is NPOT then both addressing modes are clamp.
@@ -406,6 +498,7 @@ void Tensor::Move(Tensor* src) {
   src->element_type_ = ElementType::kNone;  // Mark as invalidated.
   cpu_buffer_ = src->cpu_buffer_;
   src->cpu_buffer_ = nullptr;
+  cpu_buffer_pool_ = std::move(src->cpu_buffer_pool_);
   ahwb_tracking_key_ = src->ahwb_tracking_key_;
   mtl_resources_ = std::move(src->mtl_resources_);
   MoveAhwbStuff(src);
@@ -435,6 +528,47 @@ Tensor::Tensor(ElementType element_type, const Shape& shape,
       shape_(shape),
       quantization_parameters_(quantization_parameters),
       mtl_resources_(std::make_unique<MtlResources>()) {}
+Tensor::Tensor(ElementType element_type, const Shape& shape,
+               const QuantizationParameters& quantization_parameters,
+               std::shared_ptr<CpuBufferPool> cpu_buffer_pool)
+    : element_type_(element_type),
+      shape_(shape),
+      quantization_parameters_(quantization_parameters),
+      cpu_buffer_pool_(std::move(cpu_buffer_pool)),
+      mtl_resources_(std::make_unique<MtlResources>()) {}
+
+Tensor::CpuBufferPool::~CpuBufferPool() {
+  for (auto& [size, buffers] : free_buffers_) {
+    for (void* buffer : buffers) {
+      aligned_free(buffer);
+    }
+  }
+}
+
+void* Tensor::CpuBufferPool::Acquire(size_t size) {
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = free_buffers_.find(size);
+    if (it != free_buffers_.end() && !it->second.empty()) {
+      void* buffer = it->second.back();
+      it->second.pop_back();
+      return buffer;
+    }
+  }
+  return aligned_malloc(size, kCpuBufferAlignment);
+}
+
+void Tensor::CpuBufferPool::Release(void* buffer, size_t size) {
+  {
+    absl::MutexLock lock(&mutex_);
+    std::vector<void*>& buffers = free_buffers_[size];
+    if (static_cast<int>(buffers.size()) < max_free_buffers_) {
+      buffers.push_back(buffer);
+      return;
+    }
+  }
+  aligned_free(buffer);
+}
 
 #if MEDIAPIPE_METAL_ENABLED
 void Tensor::Invalidate() {
@@ -520,14 +654,26 @@ void Tensor::Invalidate() {
   }
 #endif  // MEDIAPIPE_OPENGL_ES_VERSION >= MEDIAPIPE_OPENGL_ES_31
 
-  if (cpu_buffer_) {
-    free(cpu_buffer_);
-  }
-  cpu_buffer_ = nullptr;
+  ReleaseCpuBuffer();
 }
 #endif  // MEDIAPIPE_METAL_ENABLED
 
 Tensor::CpuReadView Tensor::GetCpuReadView() const {
+  {
+    // Concurrent readers share the view mutex when the CPU buffer is already
+    // up to date, so that branches reading the same tensor run in parallel.
+    auto reader_lock = absl::make_unique<absl::ReaderMutexLock>(&view_mutex_);
+    bool is_cpu_buffer_valid = cpu_buffer_ && (valid_ & kValidCpu);
+#ifdef MEDIAPIPE_TENSOR_USE_AHWB
+    // Reading from an AHardwareBuffer locks and unlocks it for every view.
+    is_cpu_buffer_valid = is_cpu_buffer_valid && !ahwb_;
+#endif  // MEDIAPIPE_TENSOR_USE_AHWB
+    if (is_cpu_buffer_valid) {
+      return {cpu_buffer_, std::move(reader_lock)};
+    }
+  }
+  // Otherwise the CPU buffer is allocated or synchronized under the exclusive
+  // lock.
   auto lock = absl::make_unique<absl::MutexLock>(&view_mutex_);
   ABSL_LOG_IF(FATAL, valid_ == kValidNone)
       << "Tensor must be written prior to read from.";
@@ -577,8 +723,14 @@ Tensor::CpuReadView Tensor::GetCpuReadView() const {
       // yet.
       if (valid_ & kValidOpenGlTexture2d) {
         gl_context_->Run([this]() {
+          // Texels are always read as floats, and narrowed for a kFloat16
+          // tensor.
+          const bool narrow_to_half_floats =
+              element_type_ == ElementType::kFloat16;
+          const int texel_element_size =
+              narrow_to_half_floats ? sizeof(float) : element_size();
           const int padded_size =
-              texture_height_ * texture_width_ * 4 * element_size();
+              texture_height_ * texture_width_ * 4 * texel_element_size;
           auto temp_buffer = absl::make_unique<uint8_t[]>(padded_size);
           uint8_t* buffer = temp_buffer.get();
 
@@ -589,15 +741,21 @@ Tensor::CpuReadView Tensor::GetCpuReadView() const {
           glReadPixels(0, 0, texture_width_, texture_height_, GL_RGBA, GL_FLOAT,
                        buffer);
           uint8_t* dest_buffer = reinterpret_cast<uint8_t*>(cpu_buffer_);
-          const int actual_depth_size =
-              BhwcDepthFromShape(shape_) * element_size();
-          const int num_slices = (BhwcDepthFromShape(shape_) + 3) / 4;
-          const int padded_depth_size = num_slices * 4 * element_size();
+          const int depth = BhwcDepthFromShape(shape_);
+          const int actual_depth_size = depth * element_size();
+          const int num_slices = (depth + 3) / 4;
+          const int padded_depth_size = num_slices * 4 * texel_element_size;
           const int num_elements = BhwcWidthFromShape(shape_) *
                                    BhwcHeightFromShape(shape_) *
                                    BhwcBatchFromShape(shape_);
           for (int e = 0; e < num_elements; e++) {
-            std::memcpy(dest_buffer, buffer, actual_depth_size);
+            if (narrow_to_half_floats) {
+              Float32ToFloat16(reinterpret_cast<const float*>(buffer),
+                               reinterpret_cast<uint16_t*>(dest_buffer),
+                               depth);
+            } else {
+              std::memcpy(dest_buffer, buffer, actual_depth_size);
+            }
             dest_buffer += actual_depth_size;
             buffer += padded_depth_size;
           }
@@ -610,6 +768,22 @@ Tensor::CpuReadView Tensor::GetCpuReadView() const {
   return {cpu_buffer_, std::move(lock)};
 }
 
+Tensor::CpuFloatReadView Tensor::GetCpuFloatReadView() const {
+  ABSL_CHECK(element_type_ == ElementType::kFloat32 ||
+             element_type_ == ElementType::kFloat16)
+      << "Only kFloat32 and kFloat16 tensors can be viewed as float values.";
+  if (element_type_ == ElementType::kFloat32) {
+    return CpuFloatReadView(GetCpuReadView());
+  }
+  const int num_elements = shape_.num_elements();
+  auto converted = absl::make_unique<float[]>(num_elements);
+  {
+    auto view = GetCpuReadView();
+    Float16ToFloat32(view.buffer<uint16_t>(), converted.get(), num_elements);
+  }
+  return CpuFloatReadView(std::move(converted));
+}
+
 Tensor::CpuWriteView Tensor::GetCpuWriteView(
     uint64_t source_location_hash) const {
   auto lock = absl::make_unique<absl::MutexLock>(&view_mutex_);
@@ -638,9 +812,24 @@ void Tensor::AllocateCpuBuffer() const {
 #if MEDIAPIPE_METAL_ENABLED
     cpu_buffer_ = AllocateVirtualMemory(bytes());
 #else
-    cpu_buffer_ = malloc(bytes());
+    cpu_buffer_ = cpu_buffer_pool_
+                      ? cpu_buffer_pool_->Acquire(bytes())
+                      : aligned_malloc(bytes(), kCpuBufferAlignment);
 #endif  // MEDIAPIPE_METAL_ENABLED
   }
 }
 
+#if !MEDIAPIPE_METAL_ENABLED
+void Tensor::ReleaseCpuBuffer() const {
+  if (cpu_buffer_) {
+    if (cpu_buffer_pool_) {
+      cpu_buffer_pool_->Release(cpu_buffer_, bytes());
+    } else {
+      aligned_free(cpu_buffer_);
+    }
+  }
+  cpu_buffer_ = nullptr;
+}
+#endif  // !MEDIAPIPE_METAL_ENABLED
+
 }  // namespace mediapipe
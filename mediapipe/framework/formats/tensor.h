@@ -16,9 +16,13 @@
 #define MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_H_
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
+#include <memory>
 #include <numeric>
+#include <optional>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -28,6 +32,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/formats/tensor/internal.h"
+#include "mediapipe/framework/payload_size.h"
 #include "mediapipe/framework/port.h"
 
 // Supported use cases for tensor_ahwb:
@@ -68,12 +73,21 @@
 #endif
 
 namespace mediapipe {
+
+// Converts count IEEE 754 half precision values to single precision.
+void Float16ToFloat32(const uint16_t* src, float* dst, size_t count);
+// Converts count single precision values to IEEE 754 half precision, rounding
+// to the nearest even value. Values beyond the half range become infinities.
+void Float32ToFloat16(const float* src, uint16_t* dst, size_t count);
+
 // Tensor is a container of multi-dimensional data that supports sharing the
 // content across different backends and APIs, currently: CPU / Metal / OpenGL.
 // Texture2DView is limited to 4 dimensions.
 // The content is accessible through requesting device specific views.
 // Acquiring a view guarantees that the content is not changed by another thread
-// until the view is released.
+// until the view is released. CPU read views of a tensor whose CPU content is
+// up to date can be held by several threads at once; all other views are
+// exclusive.
 //
 // Tensor::MtlBufferView view = tensor.GetMtlBufferWriteView(mtl_device);
 // mtl_device is used to create MTLBuffer
@@ -103,13 +117,18 @@ class Tensor {
 
    protected:
     View(std::unique_ptr<absl::MutexLock>&& lock) : lock_(std::move(lock)) {}
+    View(std::unique_ptr<absl::ReaderMutexLock>&& reader_lock)
+        : reader_lock_(std::move(reader_lock)) {}
+    // Exactly one of the locks is held by a view.
     std::unique_ptr<absl::MutexLock> lock_;
+    std::unique_ptr<absl::ReaderMutexLock> reader_lock_;
   };
 
  public:
   // No resources are allocated here.
   enum class ElementType {
     kNone,
+    // IEEE 754 half precision, stored as uint16_t.
     kFloat16,
     kFloat32,
     kUInt8,
@@ -145,9 +164,43 @@ class Tensor {
     int zero_point = 0;
   };
 
+  // A pool of CPU buffers for Tensors that are created repeatedly with the
+  // same size, such as inference outputs. A buffer released by a Tensor is kept
+  // for the next Tensor of the same size, up to max_free_buffers per size, so
+  // that large buffers are not allocated and page-faulted in for every Tensor.
+  // The pool is shared by its Tensors, and is destroyed after the last of them.
+  class CpuBufferPool {
+   public:
+    explicit CpuBufferPool(int max_free_buffers = 2)
+        : max_free_buffers_(max_free_buffers) {}
+    ~CpuBufferPool();
+    CpuBufferPool(const CpuBufferPool&) = delete;
+    CpuBufferPool& operator=(const CpuBufferPool&) = delete;
+
+    // Returns a buffer of the given size, aligned to kCpuBufferAlignment.
+    void* Acquire(size_t size);
+    // Keeps a buffer from Acquire for reuse, or frees it.
+    void Release(void* buffer, size_t size);
+
+   private:
+    const int max_free_buffers_;
+    absl::Mutex mutex_;
+    absl::flat_hash_map<size_t, std::vector<void*>> free_buffers_
+        ABSL_GUARDED_BY(mutex_);
+  };
+
+  // The alignment of CPU buffers, which allows binding them to TFLite tensors
+  // without a copy.
+  static constexpr int kCpuBufferAlignment = 64;
+
   Tensor(ElementType element_type, const Shape& shape);
   Tensor(ElementType element_type, const Shape& shape,
          const QuantizationParameters& quantization_parameters);
+  // Creates a Tensor that takes its CPU buffer from a pool, and returns the
+  // buffer to the pool when it is destroyed.
+  Tensor(ElementType element_type, const Shape& shape,
+         const QuantizationParameters& quantization_parameters,
+         std::shared_ptr<CpuBufferPool> cpu_buffer_pool);
 
   // Non-copyable.
   Tensor(const Tensor&) = delete;
@@ -181,6 +234,8 @@ class Tensor {
         : View(std::move(lock)),
           buffer_(buffer),
           release_callback_(release_callback) {}
+    CpuView(T* buffer, std::unique_ptr<absl::ReaderMutexLock>&& reader_lock)
+        : View(std::move(reader_lock)), buffer_(buffer) {}
     T* buffer_;
     std::function<void()> release_callback_;
   };
@@ -191,6 +246,27 @@ class Tensor {
       uint64_t source_location_hash =
           tensor_internal::FnvHash64(builtin_FILE(), builtin_LINE())) const;
 
+  // A CPU read view of a kFloat32 or kFloat16 tensor as float values. A
+  // kFloat32 tensor is viewed in place. A kFloat16 tensor is converted when
+  // the view is requested, into a buffer owned by the view, so that code
+  // reading float values accepts half precision tensors too.
+  class CpuFloatReadView {
+   public:
+    const float* buffer() const { return buffer_; }
+    CpuFloatReadView(CpuFloatReadView&& src) = default;
+
+   private:
+    friend class Tensor;
+    explicit CpuFloatReadView(CpuReadView view)
+        : view_(std::move(view)), buffer_(view_->buffer<float>()) {}
+    explicit CpuFloatReadView(std::unique_ptr<float[]> converted)
+        : converted_(std::move(converted)), buffer_(converted_.get()) {}
+    std::optional<CpuReadView> view_;
+    std::unique_ptr<float[]> converted_;
+    const float* buffer_;
+  };
+  CpuFloatReadView GetCpuFloatReadView() const;
+
 #ifdef MEDIAPIPE_TENSOR_USE_AHWB
   using FinishingFunc = std::function<bool(bool)>;
   class AHardwareBufferView : public View {
@@ -245,11 +321,19 @@ class Tensor {
   // size_alignment must be power of 2, i.e. 2, 4, 8, 16, 64, etc.
   // If size_alignment is 0, then the buffer will not be padded.
   AHardwareBufferView GetAHardwareBufferWriteView(int size_alignment = 0) const;
+  // Backs the CPU and OpenGL buffer views of this tensor by an
+  // AHardwareBuffer, so that a later AHardwareBuffer view needs no copy.
+  // Otherwise the storage is chosen from the views requested for earlier
+  // tensors, and the first tensors are copied. Has no effect after the first
+  // view is requested.
+  void SetPreferAHardwareBuffer() { use_ahwb_ = true; }
 #endif  // MEDIAPIPE_TENSOR_USE_AHWB
 
 #if MEDIAPIPE_OPENGL_ES_VERSION >= MEDIAPIPE_OPENGL_ES_30
   // TODO: Use GlTextureView instead.
-  // Only float32 textures are supported with 1/2/3/4 depths.
+  // Only float32 and float16 textures are supported with 1/2/3/4 depths.
+  // A kFloat16 tensor is backed by a half float texture, except on
+  // OpenGL ES 2.0.
   // OpenGlTexture2dView currently only supports BHWC memory layout.
   class OpenGlTexture2dView : public View {
    public:
@@ -378,7 +462,10 @@ class Tensor {
   mutable absl::Mutex view_mutex_;
 
   mutable void* cpu_buffer_ = nullptr;
+  // The pool that provides cpu_buffer_, if any.
+  std::shared_ptr<CpuBufferPool> cpu_buffer_pool_;
   void AllocateCpuBuffer() const;
+  void ReleaseCpuBuffer() const;
   // Forward declaration of the MtlResources provides compile-time verification
   // of ODR if this header includes any actual code that uses MtlResources.
   mutable std::unique_ptr<MtlResources> mtl_resources_;
@@ -444,6 +531,16 @@ int BhwcHeightFromShape(const Tensor::Shape& shape);
 int BhwcWidthFromShape(const Tensor::Shape& shape);
 int BhwcDepthFromShape(const Tensor::Shape& shape);
 
+// Counts the elements of a Tensor, for memory accounting. A Tensor holds at
+// most one copy of its elements in each of its CPU and GPU views, and only the
+// size of one copy is counted.
+template <>
+struct PayloadSize<Tensor> {
+  static size_t Get(const Tensor& tensor) {
+    return sizeof(Tensor) + tensor.bytes();
+  }
+};
+
 }  // namespace mediapipe
 
 #endif  // MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_H_
@@ -45,6 +45,26 @@ TEST(TensorAhwbTest, TestAhwbAlignment) {
   }
 }
 
+TEST(TensorAhwbTest, TestPreferAhwbThenCpu) {
+  Tensor tensor(Tensor::ElementType::kFloat32, Tensor::Shape{1});
+  tensor.SetPreferAHardwareBuffer();
+  {
+    auto ptr = tensor.GetCpuWriteView().buffer<float>();
+    ASSERT_NE(ptr, nullptr);
+    *ptr = 42.0f;
+  }
+  {
+    auto view = tensor.GetAHardwareBufferReadView();
+    EXPECT_NE(view.handle(), nullptr);
+    view.SetReadingFinishedFunc([](bool) { return true; });
+  }
+  {
+    auto ptr = tensor.GetCpuReadView().buffer<float>();
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(*ptr, 42.0f);
+  }
+}
+
 // Tensor::GetCpuView uses source location mechanism that gives source file name
 // and line from where the method is called. The function is intended just to
 // have two calls providing the same source file name and line.
@@ -0,0 +1,71 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_H_
+#define MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_H_
+
+#include <memory>
+
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/graph_service.h"
+
+namespace mediapipe {
+
+// A pool of CPU storage for Tensors. A Tensor from the pool returns its CPU
+// buffer to the pool when it is destroyed, and the next Tensor of the same
+// element type and shape reuses the buffer instead of allocating a new one.
+//
+// Calculators that produce Tensors share the pool of a graph through
+// kTensorPoolService:
+//
+//   cc->UseService(kTensorPoolService).Optional();  // In GetContract.
+//   ...
+//   Tensor tensor = cc->Service(kTensorPoolService).GetObject().GetTensor(
+//       Tensor::ElementType::kFloat32, {1, height, width, 3});
+//
+// Buffers are keyed by their size in bytes, so Tensors of other element types
+// and shapes with the same size share them as well.
+class TensorPool {
+ public:
+  // Keeps up to max_free_buffers released buffers of each size for reuse.
+  explicit TensorPool(int max_free_buffers = kDefaultMaxFreeBuffers)
+      : cpu_buffer_pool_(
+            std::make_shared<Tensor::CpuBufferPool>(max_free_buffers)) {}
+
+  // Returns a Tensor whose CPU buffer is taken from the pool. The buffer is
+  // only acquired when the first CPU view of the Tensor is requested.
+  Tensor GetTensor(Tensor::ElementType element_type,
+                   const Tensor::Shape& shape,
+                   const Tensor::QuantizationParameters&
+                       quantization_parameters = {}) {
+    return Tensor(element_type, shape, quantization_parameters,
+                  cpu_buffer_pool_);
+  }
+
+ private:
+  static constexpr int kDefaultMaxFreeBuffers = 4;
+
+  // Shared with the Tensors, so that the pool may be destroyed before them.
+  std::shared_ptr<Tensor::CpuBufferPool> cpu_buffer_pool_;
+};
+
+// The TensorPool shared by the calculators of a graph. It is created on
+// demand unless the graph disallows service default initialization.
+inline constexpr GraphService<TensorPool> kTensorPoolService(
+    "TensorPool", GraphServiceBase::kAllowDefaultInitialization);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_H_
@@ -0,0 +1,69 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/framework/formats/tensor_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(TensorPoolTest, ReusesReleasedBuffers) {
+  TensorPool pool;
+  const void* buffer;
+  {
+    Tensor tensor = pool.GetTensor(Tensor::ElementType::kFloat32, {1, 4, 4, 3});
+    buffer = tensor.GetCpuWriteView().buffer<float>();
+  }
+  // A Tensor of the same type and shape reuses the released buffer.
+  Tensor tensor = pool.GetTensor(Tensor::ElementType::kFloat32, {1, 4, 4, 3});
+  EXPECT_EQ(tensor.GetCpuWriteView().buffer<float>(), buffer);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer) % Tensor::kCpuBufferAlignment,
+            0);
+  // A Tensor that is alive keeps its buffer.
+  Tensor other = pool.GetTensor(Tensor::ElementType::kFloat32, {1, 4, 4, 3});
+  EXPECT_NE(other.GetCpuWriteView().buffer<float>(), buffer);
+}
+
+TEST(TensorPoolTest, KeepsQuantizationParameters) {
+  TensorPool pool;
+  Tensor tensor = pool.GetTensor(Tensor::ElementType::kUInt8, {2, 3},
+                                 Tensor::QuantizationParameters(0.5f, 10));
+  EXPECT_EQ(tensor.element_type(), Tensor::ElementType::kUInt8);
+  EXPECT_EQ(tensor.shape().dims, std::vector<int>({2, 3}));
+  EXPECT_EQ(tensor.quantization_parameters().scale, 0.5f);
+  EXPECT_EQ(tensor.quantization_parameters().zero_point, 10);
+}
+
+TEST(TensorPoolTest, OutlivesPool) {
+  auto pool = std::make_unique<TensorPool>();
+  Tensor tensor = pool->GetTensor(Tensor::ElementType::kInt32, {16});
+  tensor.GetCpuWriteView().buffer<int32_t>()[0] = 1;
+  pool.reset();
+  EXPECT_EQ(tensor.GetCpuReadView().buffer<int32_t>()[0], 1);
+}
+
+TEST(TensorPoolTest, ServiceSupportsDefaultInitialization) {
+  MP_EXPECT_OK(kTensorPoolService.CreateDefaultObject());
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -1,9 +1,17 @@
 #include "mediapipe/framework/formats/tensor.h"
 
+#include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <limits>
+#include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
 #include <vector>
 
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #if !MEDIAPIPE_DISABLE_GPU
@@ -80,6 +88,89 @@ TEST(Cpu, TestViewMove) {
   EXPECT_EQ(v1.buffer<float>(), nullptr);  // NOLINT
 }
 
+TEST(Cpu, TestConcurrentReadViews) {
+  Tensor t(Tensor::ElementType::kFloat32, Tensor::Shape{4, 3, 2, 3});
+  t.GetCpuWriteView().buffer<float>()[0] = 1.0f;
+  auto v1 = t.GetCpuReadView();
+  // Another thread can read the tensor while the view is held.
+  absl::Notification read;
+  std::thread reader([&t, &read] {
+    auto v2 = t.GetCpuReadView();
+    EXPECT_EQ(v2.buffer<float>()[0], 1.0f);
+    read.Notify();
+  });
+  EXPECT_TRUE(read.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  EXPECT_EQ(v1.buffer<float>()[0], 1.0f);
+  {
+    // Release the view before joining in case the reader is blocked.
+    auto released = std::move(v1);
+  }
+  reader.join();
+}
+
+TEST(Cpu, TestCpuBufferPool) {
+  auto pool = std::make_shared<Tensor::CpuBufferPool>();
+  void* p1;
+  {
+    Tensor t1(Tensor::ElementType::kFloat32, Tensor::Shape{4, 3, 2, 3},
+              Tensor::QuantizationParameters(), pool);
+    p1 = t1.GetCpuWriteView().buffer<float>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p1) % Tensor::kCpuBufferAlignment,
+              0);
+  }
+  // A Tensor of the same size reuses the released buffer.
+  Tensor t2(Tensor::ElementType::kInt32, Tensor::Shape{4, 3, 2, 3},
+            Tensor::QuantizationParameters(), pool);
+  EXPECT_EQ(t2.GetCpuWriteView().buffer<int32_t>(), p1);
+  // A Tensor of another size does not.
+  Tensor t3(Tensor::ElementType::kFloat32, Tensor::Shape{4, 3, 2, 4},
+            Tensor::QuantizationParameters(), pool);
+  EXPECT_NE(t3.GetCpuWriteView().buffer<float>(), p1);
+  // The pool may be released before its Tensors.
+  pool.reset();
+}
+
+TEST(Cpu, TestFloat16Conversion) {
+  // Pairs of values and their half precision roundings: the smallest normal
+  // and subnormal halves, the largest half, an overflow, and ties rounded to
+  // even.
+  const std::vector<std::pair<float, float>> cases = {
+      {0.0f, 0.0f},
+      {-2.5f, -2.5f},
+      {std::ldexp(1.0f, -14), std::ldexp(1.0f, -14)},
+      {std::ldexp(1.0f, -24), std::ldexp(1.0f, -24)},
+      {std::ldexp(1.0f, -26), 0.0f},
+      {65504.0f, 65504.0f},
+      {1e6f, std::numeric_limits<float>::infinity()},
+      {1.0f + std::ldexp(1.0f, -11), 1.0f},
+      {1.0f + 3 * std::ldexp(1.0f, -11), 1.0f + std::ldexp(1.0f, -9)},
+  };
+  for (const auto& [value, expected] : cases) {
+    uint16_t half;
+    Float32ToFloat16(&value, &half, 1);
+    float result;
+    Float16ToFloat32(&half, &result, 1);
+    EXPECT_EQ(result, expected) << value;
+  }
+}
+
+TEST(Cpu, TestCpuFloatReadView) {
+  Tensor t1(Tensor::ElementType::kFloat16, Tensor::Shape{1, 3});
+  {
+    auto view = t1.GetCpuWriteView();
+    const float values[] = {0.5f, -1.0f, 3.0f};
+    Float32ToFloat16(values, view.buffer<uint16_t>(), 3);
+  }
+  auto float_view = t1.GetCpuFloatReadView();
+  EXPECT_THAT(std::vector<float>(float_view.buffer(), float_view.buffer() + 3),
+              testing::ElementsAre(0.5f, -1.0f, 3.0f));
+
+  // A kFloat32 tensor is viewed without a copy.
+  Tensor t2(Tensor::ElementType::kFloat32, Tensor::Shape{1, 3});
+  float* buffer = t2.GetCpuWriteView().buffer<float>();
+  EXPECT_EQ(t2.GetCpuFloatReadView().buffer(), buffer);
+}
+
 }  // namespace mediapipe
 
 int main(int argc, char** argv) {
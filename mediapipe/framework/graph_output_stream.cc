@@ -222,5 +222,61 @@ bool OutputStreamPollerImpl::Next(Packet* packet) {
   return true;
 }
 
+bool OutputStreamPollerImpl::NextBatch(std::vector<Packet>* packets,
+                                       int max_packets, bool block) {
+  ABSL_CHECK(packets);
+  ABSL_CHECK_GT(max_packets, 0);
+  bool empty_queue = true;
+  bool timestamp_bound_changed = false;
+  Timestamp min_timestamp = Timestamp::Unset();
+  {
+    absl::MutexLock lock(&mutex_);
+    while (true) {
+      min_timestamp = input_stream_->MinTimestampOrBound(&empty_queue);
+      if (empty_queue) {
+        timestamp_bound_changed =
+            input_stream_handler_->ProcessTimestampBounds() &&
+            output_timestamp_ < min_timestamp.PreviousAllowedInStream();
+      }
+      if (!block || graph_has_error_ || !empty_queue ||
+          timestamp_bound_changed || min_timestamp == Timestamp::Done()) {
+        break;
+      }
+      handler_condvar_.Wait(&mutex_);
+    }
+    if (graph_has_error_ && empty_queue) {
+      return false;
+    }
+    if (empty_queue) {
+      if (min_timestamp == Timestamp::Done()) {
+        output_timestamp_ = min_timestamp.PreviousAllowedInStream();
+        return false;
+      }
+      if (timestamp_bound_changed) {
+        output_timestamp_ = min_timestamp.PreviousAllowedInStream();
+        packets->push_back(Packet().At(output_timestamp_));
+      }
+      return true;
+    }
+  }
+
+  // Pops the queued packets without taking mutex_ for each one.
+  Timestamp last_timestamp = min_timestamp;
+  for (int i = 0; i < max_packets && !empty_queue; ++i) {
+    int num_packets_dropped = 0;
+    bool stream_is_done = false;
+    packets->push_back(input_stream_->PopPacketAtTimestamp(
+        min_timestamp, &num_packets_dropped, &stream_is_done));
+    ABSL_CHECK_EQ(num_packets_dropped, 0)
+        << absl::Substitute("Dropped $0 packet(s) on input stream \"$1\".",
+                            num_packets_dropped, input_stream_->Name());
+    last_timestamp = min_timestamp;
+    min_timestamp = input_stream_->MinTimestampOrBound(&empty_queue);
+  }
+  absl::MutexLock lock(&mutex_);
+  output_timestamp_ = last_timestamp;
+  return true;
+}
+
 }  // namespace internal
 }  // namespace mediapipe
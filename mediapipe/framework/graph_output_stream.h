@@ -167,6 +167,13 @@ class OutputStreamPollerImpl : public GraphOutputStream {
   // done).  Returns true if successful.
   ABSL_MUST_USE_RESULT bool Next(Packet* packet);
 
+  // Appends up to max_packets of the queued packets to packets.  If block is
+  // true, waits until at least one packet is available or the stream is done.
+  // Returns false if the stream is done or the graph has an error, and no
+  // packets remain.
+  ABSL_MUST_USE_RESULT bool NextBatch(std::vector<Packet>* packets,
+                                      int max_packets, bool block);
+
  private:
   absl::Mutex mutex_;
   absl::CondVar handler_condvar_ ABSL_GUARDED_BY(mutex_);
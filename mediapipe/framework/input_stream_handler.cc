@@ -14,6 +14,9 @@
 
 #include "mediapipe/framework/input_stream_handler.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/substitute.h"
@@ -24,6 +27,40 @@
 namespace mediapipe {
 using SyncSet = InputStreamHandler::SyncSet;
 
+namespace {
+
+// The innermost NotificationBatch on the current thread.
+thread_local InputStreamHandler::NotificationBatch* current_notification_batch =
+    nullptr;
+
+}  // namespace
+
+InputStreamHandler::NotificationBatch::NotificationBatch()
+    : saved_(current_notification_batch) {
+  current_notification_batch = this;
+}
+
+InputStreamHandler::NotificationBatch::~NotificationBatch() {
+  // Notifications can schedule nodes and propagate their outputs on this
+  // thread, which must not be deferred to this batch.
+  current_notification_batch = saved_;
+  for (InputStreamHandler* handler : handlers_) {
+    handler->notification_();
+  }
+}
+
+void InputStreamHandler::Notify() {
+  NotificationBatch* batch = current_notification_batch;
+  if (batch == nullptr) {
+    notification_();
+    return;
+  }
+  if (std::find(batch->handlers_.begin(), batch->handlers_.end(), this) ==
+      batch->handlers_.end()) {
+    batch->handlers_.push_back(this);
+  }
+}
+
 absl::Status InputStreamHandler::InitializeInputStreamManagers(
     InputStreamManager* flat_input_stream_managers) {
   for (CollectionItemId id = input_stream_managers_.BeginId();
@@ -156,27 +193,33 @@ bool InputStreamHandler::ScheduleInvocations(int max_allowance,
     schedule_callback_(default_context);
     return true;
   }
+  // Pairs with the fence in SetNextTimestampBound().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
   int invocations_scheduled = 0;
   while (invocations_scheduled < max_allowance) {
     NodeReadiness node_readiness = GetNodeReadiness(&min_stream_timestamp);
     // Sets *input_bound iff the latest node readiness is kNotReady before the
     // function returns regardless of how many invocations have been scheduled.
     if (node_readiness == NodeReadiness::kNotReady) {
+      CalculatorContext* default_context =
+          calculator_context_manager_->GetDefaultCalculatorContext();
       if (batch_size_ > 1 &&
           calculator_context_manager_->ContextHasInputTimestamp(
-              *calculator_context_manager_->GetDefaultCalculatorContext())) {
+              *default_context)) {
         // When batching is in progress, input_bound stays equal to the first
         // timestamp in the calculator context. This allows timestamp
         // propagation to be performed only for the first timestamp, and
         // prevents propagation for the subsequent inputs.
-        *input_bound =
-            calculator_context_manager_->GetDefaultCalculatorContext()
-                ->InputTimestamp();
+        *input_bound = default_context->InputTimestamp();
+        if (ScheduleIncompleteBatch(
+                calculator_context_manager_->NumberOfContextTimestamps(
+                    *default_context))) {
+          schedule_callback_(default_context);
+          ++invocations_scheduled;
+        }
       } else {
         *input_bound = min_stream_timestamp;
       }
-      CalculatorContext* default_context =
-          calculator_context_manager_->GetDefaultCalculatorContext();
       mediapipe::LogEvent(default_context->GetProfilingContext(),
                           TraceEvent(TraceEvent::NOT_READY)
                               .set_node_id(default_context->NodeId()));
@@ -259,46 +302,61 @@ void LogQueuedPackets(CalculatorContext* context, InputStreamManager* stream,
 }
 
 void InputStreamHandler::AddPackets(CollectionItemId id,
-                                    const std::list<Packet>& packets) {
+                                    const std::list<Packet>& packets,
+                                    Timestamp next_timestamp_bound) {
   LogQueuedPackets(GetCalculatorContext(calculator_context_manager_),
                    input_stream_managers_.Get(id), packets.back());
   bool notify = false;
-  absl::Status result =
-      input_stream_managers_.Get(id)->AddPackets(packets, &notify);
+  absl::Status result = input_stream_managers_.Get(id)->AddPackets(
+      packets, next_timestamp_bound, &notify);
   if (!result.ok()) {
     error_callback_(result);
   }
   if (notify) {
-    notification_();
+    Notify();
   }
 }
 
 void InputStreamHandler::MovePackets(CollectionItemId id,
-                                     std::list<Packet>* packets) {
+                                     std::list<Packet>* packets,
+                                     Timestamp next_timestamp_bound) {
   LogQueuedPackets(GetCalculatorContext(calculator_context_manager_),
                    input_stream_managers_.Get(id), packets->back());
   bool notify = false;
-  absl::Status result =
-      input_stream_managers_.Get(id)->MovePackets(packets, &notify);
+  absl::Status result = input_stream_managers_.Get(id)->MovePackets(
+      packets, next_timestamp_bound, &notify);
   if (!result.ok()) {
     error_callback_(result);
   }
   if (notify) {
-    notification_();
+    Notify();
   }
 }
 
 void InputStreamHandler::SetNextTimestampBound(CollectionItemId id,
                                                Timestamp bound) {
+  InputStreamManager* stream = input_stream_managers_.Get(id);
+  bool empty = false;
+  Timestamp previous_bound = stream->MinTimestampOrBound(&empty);
   bool notify = false;
-  absl::Status result =
-      input_stream_managers_.Get(id)->SetNextTimestampBound(bound, &notify);
+  absl::Status result = stream->SetNextTimestampBound(bound, &notify);
   if (!result.ok()) {
     error_callback_(result);
   }
-  if (notify) {
-    notification_();
+  if (!notify) {
+    return;
+  }
+  if (empty) {
+    // Orders the new bound before reading the other streams. The stream
+    // updates that could make the node ready are ordered likewise, before
+    // ScheduleInvocations() reads this stream, so that a skipped bound is
+    // always seen by a later readiness check.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!BoundCanChangeReadiness(id, previous_bound)) {
+      return;
+    }
   }
+  Notify();
 }
 
 void InputStreamHandler::ClearCurrentInputs(
@@ -390,6 +448,23 @@ NodeReadiness SyncSet::GetReadiness(Timestamp* min_stream_timestamp) {
   return NodeReadiness::kNotReady;
 }
 
+bool SyncSet::HasOtherEmptyStreamAtOrBelow(CollectionItemId id,
+                                           Timestamp timestamp) const {
+  for (CollectionItemId other_id : stream_ids_) {
+    if (other_id == id) {
+      continue;
+    }
+    const auto& stream =
+        input_stream_handler_->input_stream_managers_.Get(other_id);
+    bool empty;
+    Timestamp stream_timestamp = stream->MinTimestampOrBound(&empty);
+    if (empty && stream_timestamp <= timestamp) {
+      return true;
+    }
+  }
+  return false;
+}
+
 Timestamp SyncSet::LastProcessed() const { return last_processed_ts_; }
 
 Timestamp SyncSet::MinPacketTimestamp() const {
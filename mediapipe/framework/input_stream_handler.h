@@ -132,15 +132,53 @@ class InputStreamHandler {
       InputStreamManager::QueueSizeCallback becomes_not_full_callback);
 
   // Add packets into a particular stream.
-  virtual void AddPackets(CollectionItemId id,
-                          const std::list<Packet>& packets);
+  void AddPackets(CollectionItemId id, const std::list<Packet>& packets) {
+    AddPackets(id, packets, Timestamp::Unset());
+  }
+
+  // Adds packets into a particular stream, and then sets its next timestamp
+  // bound unless next_timestamp_bound is Timestamp::Unset(). The stream is
+  // locked once for both updates, which matters for streams with many
+  // mirrors. "packets" must not be empty.
+  virtual void AddPackets(CollectionItemId id, const std::list<Packet>& packets,
+                          Timestamp next_timestamp_bound);
 
   // Moves packets into a particular stream.
-  virtual void MovePackets(CollectionItemId id, std::list<Packet>* packets);
+  void MovePackets(CollectionItemId id, std::list<Packet>* packets) {
+    MovePackets(id, packets, Timestamp::Unset());
+  }
+
+  // Moves packets into a particular stream, and then sets its next timestamp
+  // bound, like AddPackets() above.
+  virtual void MovePackets(CollectionItemId id, std::list<Packet>* packets,
+                           Timestamp next_timestamp_bound);
 
-  // Sets next timestamp bound in a particular stream.
+  // Sets next timestamp bound in a particular stream. The node is not
+  // notified if BoundCanChangeReadiness() returns false.
   void SetNextTimestampBound(CollectionItemId id, Timestamp bound);
 
+  // Defers the notifications of all input stream handlers on the current
+  // thread while in scope, and then delivers at most one notification to each
+  // handler. Output stream handlers propagate each pass of packets and
+  // timestamp bounds within a NotificationBatch, so that a downstream node fed
+  // by several of the streams is woken once per pass. Batches can be nested;
+  // each delivers its own notifications.
+  class NotificationBatch {
+   public:
+    NotificationBatch();
+    ~NotificationBatch();
+    NotificationBatch(const NotificationBatch&) = delete;
+    NotificationBatch& operator=(const NotificationBatch&) = delete;
+
+   private:
+    friend class InputStreamHandler;
+
+    // The enclosing batch, restored by the destructor.
+    NotificationBatch* saved_;
+    // The handlers to notify, without duplicates.
+    std::vector<InputStreamHandler*> handlers_;
+  };
+
   // Clears the current packet of every stream shard and removes the current
   // timestamp from the calculator context.
   void ClearCurrentInputs(CalculatorContext* calculator_context);
@@ -166,9 +204,10 @@ class InputStreamHandler {
   void FinalizeInputSet(Timestamp timestamp, InputStreamShardSet* input_set);
 
   // Returns the number of input stream headers (excluding headers of back
-  // edges) that are not set.
+  // edges) that are not set. Once it returns zero, the headers can be read
+  // without synchronization.
   int UnsetHeaderCount() const {
-    return unset_header_count_.load(std::memory_order_relaxed);
+    return unset_header_count_.load(std::memory_order_acquire);
   }
 
   // When true, Calculator::Process is called for any increase in the
@@ -222,6 +261,12 @@ class InputStreamHandler {
     // Copies timestamp bounds from all input streams to the input_set.
     void FillInputBounds(InputStreamShardSet* input_set);
 
+    // Returns true if an empty stream other than |id| has a bound at or below
+    // |timestamp|. While this holds, raising the bound of stream |id| from
+    // |timestamp| cannot change the readiness of the sync set.
+    bool HasOtherEmptyStreamAtOrBelow(CollectionItemId id,
+                                      Timestamp timestamp) const;
+
    private:
     InputStreamHandler* input_stream_handler_;
     std::vector<CollectionItemId> stream_ids_;
@@ -237,6 +282,12 @@ class InputStreamHandler {
   // Batching cannot be combined with late_preparation_ behavior.
   void SetBatchSize(int batch_size);
 
+  // Called when the node is not ready for another input set while an
+  // incomplete batch of input sets is in the calculator context. If it returns
+  // true, the incomplete batch is scheduled for processing. Otherwise, the
+  // batch waits for more input sets, or until the node is ready for Close().
+  virtual bool ScheduleIncompleteBatch(int num_input_sets) { return false; }
+
   // Subclasses can enable late preparation; however it cannot be used along
   // with batching.
   void SetLatePreparation(bool late_preparation);
@@ -264,6 +315,16 @@ class InputStreamHandler {
   //   Timestamp::Done() is returned in *min_stream_timestamp.
   virtual NodeReadiness GetNodeReadiness(Timestamp* min_stream_timestamp) = 0;
 
+  // Returns false if raising the bound of the empty input stream |id| from
+  // |previous_bound| cannot change the result of GetNodeReadiness(), in which
+  // case the node is not notified of the new bound. Any later change that can
+  // make the node ready notifies it, and the new bound is seen then.
+  // The default implementation returns true.
+  virtual bool BoundCanChangeReadiness(CollectionItemId id,
+                                       Timestamp previous_bound) {
+    return true;
+  }
+
   // Moves input packets from the input streams into the input set for the given
   // input timestamp.
   virtual void FillInputSet(Timestamp input_timestamp,
@@ -296,6 +357,9 @@ class InputStreamHandler {
   // be filled in ProcessNode().
   bool late_preparation_ = false;
 
+  // Invokes notification_, or defers it to the current NotificationBatch.
+  void Notify();
+
   // Determines how many sets of input packets are collected before a
   // CalculatorNode is scheduled.
   int batch_size_ = 1;
@@ -17,6 +17,7 @@
 #include <type_traits>
 #include <utility>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
@@ -24,6 +25,7 @@
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/framework/port/source_location.h"
 #include "mediapipe/framework/port/status_builder.h"
+#include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/framework/tool/status_util.h"
 
 namespace mediapipe {
@@ -47,20 +49,70 @@ void InputStreamManager::SetQueueSizeCallbacks(
   becomes_not_full_callback_ = becomes_not_full_callback;
 }
 
+void InputStreamManager::SetQueueBytesCallback(
+    QueueBytesCallback queue_bytes_callback) {
+  queue_bytes_callback_ = std::move(queue_bytes_callback);
+}
+
 void InputStreamManager::PrepareForRun() {
-  absl::MutexLock stream_lock(&stream_mutex_);
-  queue_.clear();
-  last_reported_stream_full_ = false;
-  num_packets_added_ = 0;
-  next_timestamp_bound_ = Timestamp::PreStream();
-  last_select_timestamp_ = Timestamp::Unstarted();
-  closed_ = false;
-  header_ = Packet();
+  int64_t bytes_removed;
+  {
+    absl::MutexLock stream_lock(&stream_mutex_);
+    queue_.clear();
+    bytes_removed = queue_bytes_;
+    queue_bytes_ = 0;
+    last_reported_stream_full_ = false;
+    num_packets_added_ = 0;
+    next_timestamp_bound_ = Timestamp::PreStream();
+    last_select_timestamp_ = Timestamp::Unstarted();
+    closed_ = false;
+    header_ = Packet();
+    PublishQueueState();
+  }
+  if (bytes_removed != 0 && queue_bytes_callback_) {
+    queue_bytes_callback_(-bytes_removed);
+  }
+}
+
+void InputStreamManager::PublishQueueState() {
+  // Sequence lock writer. Readers retry if they observe an odd version, or if
+  // the version changes while they read.
+  const uint32_t version = published_version_.load(std::memory_order_relaxed);
+  published_version_.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  published_queue_size_.store(static_cast<int>(queue_.size()),
+                              std::memory_order_relaxed);
+  published_min_timestamp_or_bound_.store(MinTimestampOrBoundHelper().Value(),
+                                          std::memory_order_relaxed);
+  published_num_packets_added_.store(num_packets_added_,
+                                     std::memory_order_relaxed);
+  published_version_.store(version + 2, std::memory_order_release);
+}
+
+void InputStreamManager::ReadQueueState(
+    int* queue_size, Timestamp* min_timestamp_or_bound) const {
+  while (true) {
+    const uint32_t version =
+        published_version_.load(std::memory_order_acquire);
+    if (version & 1) {
+      continue;
+    }
+    const int size = published_queue_size_.load(std::memory_order_relaxed);
+    const int64_t timestamp =
+        published_min_timestamp_or_bound_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (published_version_.load(std::memory_order_relaxed) == version) {
+      if (queue_size) *queue_size = size;
+      if (min_timestamp_or_bound) {
+        *min_timestamp_or_bound = Timestamp::CreateNoErrorChecking(timestamp);
+      }
+      return;
+    }
+  }
 }
 
 bool InputStreamManager::IsEmpty() const {
-  absl::MutexLock stream_lock(&stream_mutex_);
-  return queue_.empty();
+  return published_queue_size_.load(std::memory_order_acquire) == 0;
 }
 
 Packet InputStreamManager::QueueHead() const {
@@ -83,39 +135,68 @@ absl::Status InputStreamManager::SetHeader(const Packet& header) {
 
 absl::Status InputStreamManager::AddPackets(const std::list<Packet>& container,
                                             bool* notify) {
-  return AddOrMovePacketsInternal<const std::list<Packet>&>(container, notify);
+  return AddPackets(container, Timestamp::Unset(), notify);
+}
+
+absl::Status InputStreamManager::AddPackets(const std::list<Packet>& container,
+                                            Timestamp bound, bool* notify) {
+  return AddOrMovePacketsInternal<const std::list<Packet>&>(container, bound,
+                                                            notify);
 }
 
 absl::Status InputStreamManager::MovePackets(std::list<Packet>* container,
                                              bool* notify) {
-  return AddOrMovePacketsInternal<std::list<Packet>&>(*container, notify);
+  return MovePackets(container, Timestamp::Unset(), notify);
+}
+
+absl::Status InputStreamManager::MovePackets(std::list<Packet>* container,
+                                             Timestamp bound, bool* notify) {
+  return AddOrMovePacketsInternal<std::list<Packet>&>(*container, bound,
+                                                      notify);
 }
 
 template <typename Container>
 absl::Status InputStreamManager::AddOrMovePacketsInternal(Container container,
+                                                          Timestamp bound,
                                                           bool* notify) {
   *notify = false;
   bool queue_became_non_empty = false;
+  bool bound_advanced = false;
   bool queue_became_full = false;
+  // Packets added before an error remain in the queue, so their bytes are
+  // reported on every return path, after stream_mutex_ is released.
+  int64_t bytes_added = 0;
+  absl::Cleanup report_bytes_added = [this, &bytes_added]() {
+    if (bytes_added != 0) {
+      queue_bytes_callback_(bytes_added);
+    }
+  };
   {
     // Scope to prevent locking the stream when notification is called.
     absl::MutexLock stream_lock(&stream_mutex_);
     if (closed_) {
       return absl::OkStatus();
     }
+    // Packets added before an error remain in the queue, so the queue state
+    // is published on every return path.
+    absl::Cleanup publish_queue_state = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+      PublishQueueState();
+    };
     // Check if the queue was full before packets came in.
     bool was_queue_full =
         (max_queue_size_ != -1 && queue_.size() >= max_queue_size_);
     // Check if the queue becomes non-empty.
     queue_became_non_empty = queue_.empty() && !container.empty();
     for (auto& packet : container) {
-      absl::Status result = packet_type_->Validate(packet);
-      if (!result.ok()) {
-        return tool::AddStatusPrefix(
-            absl::StrCat(
-                "Packet type mismatch on a calculator receiving from stream \"",
-                name_, "\": "),
-            result);
+      if (validate_packet_types_) {
+        absl::Status result = packet_type_->Validate(packet);
+        if (!result.ok()) {
+          return tool::AddStatusPrefix(
+              absl::StrCat("Packet type mismatch on a calculator receiving "
+                           "from stream \"",
+                           name_, "\": "),
+              result);
+        }
       }
 
       const Timestamp timestamp = packet.Timestamp();
@@ -156,6 +237,9 @@ absl::Status InputStreamManager::AddOrMovePacketsInternal(Container container,
       ++num_packets_added_;
       VLOG(3) << "Input stream:" << name_
               << " has added packet at time: " << packet.Timestamp();
+      const int64_t bytes = PacketBytes(packet);
+      queue_bytes_ += bytes;
+      bytes_added += bytes;
       if (std::is_const<
               typename std::remove_reference<Container>::type>::value) {
         queue_.emplace_back(packet);
@@ -163,6 +247,9 @@ absl::Status InputStreamManager::AddOrMovePacketsInternal(Container container,
         queue_.emplace_back(std::move(packet));
       }
     }
+    if (bound != Timestamp::Unset()) {
+      MP_RETURN_IF_ERROR(RaiseNextTimestampBound(bound, &bound_advanced));
+    }
     queue_became_full = (!was_queue_full && max_queue_size_ != -1 &&
                          queue_.size() >= max_queue_size_);
     if (queue_.size() > 1) {
@@ -177,7 +264,9 @@ absl::Status InputStreamManager::AddOrMovePacketsInternal(Container container,
     VLOG(3) << "Queue became full: " << Name();
     becomes_full_callback_(this, &last_reported_stream_full_);
   }
-  *notify = queue_became_non_empty;
+  // As in SetNextTimestampBound(), a new bound is only detectable by the
+  // consumer if the queue is empty, i.e. if no packets were added.
+  *notify = queue_became_non_empty || (bound_advanced && container.empty());
   return absl::OkStatus();
 }
 
@@ -190,29 +279,38 @@ absl::Status InputStreamManager::SetNextTimestampBound(const Timestamp bound,
     if (closed_) {
       return absl::OkStatus();
     }
-
-    if (enable_timestamps_ && bound < next_timestamp_bound_) {
-      return mediapipe::UnknownErrorBuilder(MEDIAPIPE_LOC)
-             << "SetNextTimestampBound must be called with a timestamp greater "
-                "than or equal to the current bound. In stream \""
-             << name_ << "\". Current minimum expected timestamp is "
-             << next_timestamp_bound_.DebugString() << " but received "
-             << bound.DebugString();
+    bool advanced = false;
+    MP_RETURN_IF_ERROR(RaiseNextTimestampBound(bound, &advanced));
+    if (advanced) {
+      // If the queue was not empty then a change to the next_timestamp_bound_
+      // is not detectable by the consumer.
+      *notify = queue_.empty();
+      PublishQueueState();
     }
+  }
+  return absl::OkStatus();
+}
 
-    // Even if enable_timestamps_ is false, Timestamp::Done() is used to
-    // indicate the end of stream. So this code is common to both timed and
-    // untimed scheduling policies.
-    if (bound > next_timestamp_bound_) {
-      next_timestamp_bound_ = bound;
-      VLOG(3) << "Next timestamp bound for input " << name_ << " is "
-              << next_timestamp_bound_;
-      if (queue_.empty()) {
-        // If the queue was not empty then a change to the next_timestamp_bound_
-        // is not detectable by the consumer.
-        *notify = true;
-      }
-    }
+absl::Status InputStreamManager::RaiseNextTimestampBound(Timestamp bound,
+                                                         bool* advanced) {
+  *advanced = false;
+  if (enable_timestamps_ && bound < next_timestamp_bound_) {
+    return mediapipe::UnknownErrorBuilder(MEDIAPIPE_LOC)
+           << "SetNextTimestampBound must be called with a timestamp greater "
+              "than or equal to the current bound. In stream \""
+           << name_ << "\". Current minimum expected timestamp is "
+           << next_timestamp_bound_.DebugString() << " but received "
+           << bound.DebugString();
+  }
+
+  // Even if enable_timestamps_ is false, Timestamp::Done() is used to
+  // indicate the end of stream. So this code is common to both timed and
+  // untimed scheduling policies.
+  if (bound > next_timestamp_bound_) {
+    next_timestamp_bound_ = bound;
+    VLOG(3) << "Next timestamp bound for input " << name_ << " is "
+            << next_timestamp_bound_;
+    *advanced = true;
   }
   return absl::OkStatus();
 }
@@ -227,14 +325,17 @@ void InputStreamManager::Close() {
   next_timestamp_bound_ = Timestamp::Done();
   last_select_timestamp_ = Timestamp::Done();
   closed_ = true;
+  PublishQueueState();
 }
 
 Timestamp InputStreamManager::MinTimestampOrBound(bool* is_empty) const {
-  absl::MutexLock stream_lock(&stream_mutex_);
+  int queue_size;
+  Timestamp min_timestamp_or_bound;
+  ReadQueueState(&queue_size, &min_timestamp_or_bound);
   if (is_empty) {
-    *is_empty = queue_.empty();
+    *is_empty = queue_size == 0;
   }
-  return MinTimestampOrBoundHelper();
+  return min_timestamp_or_bound;
 }
 
 Timestamp InputStreamManager::MinTimestampOrBoundHelper() const
@@ -249,6 +350,7 @@ Packet InputStreamManager::PopPacketAtTimestamp(Timestamp timestamp,
   *num_packets_dropped = -1;
   *stream_is_done = false;
   bool queue_became_non_full = false;
+  int64_t bytes_removed = 0;
   Packet packet;
   {
     absl::MutexLock stream_lock(&stream_mutex_);
@@ -276,9 +378,11 @@ Packet InputStreamManager::PopPacketAtTimestamp(Timestamp timestamp,
     while (!queue_.empty() && queue_.front().Timestamp() <= timestamp) {
       packet = std::move(queue_.front());
       queue_.pop_front();
+      bytes_removed += PacketBytes(packet);
       current_timestamp = packet.Timestamp();
       ++(*num_packets_dropped);
     }
+    queue_bytes_ -= bytes_removed;
     // Clear value_ if it doesn't have exactly the right timestamp.
     if (current_timestamp != timestamp) {
       // The timestamp bound reported when no packet is sent.
@@ -291,6 +395,10 @@ Packet InputStreamManager::PopPacketAtTimestamp(Timestamp timestamp,
             << " Size:" << queue_.size();
     queue_became_non_full = (was_queue_full && queue_.size() < max_queue_size_);
     *stream_is_done = IsDone();
+    PublishQueueState();
+  }
+  if (bytes_removed != 0) {
+    queue_bytes_callback_(-bytes_removed);
   }
   if (queue_became_non_full) {
     VLOG(3) << "Queue became non-full: " << Name();
@@ -303,6 +411,7 @@ Packet InputStreamManager::PopQueueHead(bool* stream_is_done) {
   ABSL_CHECK(!enable_timestamps_);
   *stream_is_done = false;
   bool queue_became_non_full = false;
+  int64_t bytes_removed = 0;
   Packet packet;
   {
     absl::MutexLock stream_lock(&stream_mutex_);
@@ -316,6 +425,8 @@ Packet InputStreamManager::PopQueueHead(bool* stream_is_done) {
     if (!queue_.empty()) {
       packet = std::move(queue_.front());
       queue_.pop_front();
+      bytes_removed = PacketBytes(packet);
+      queue_bytes_ -= bytes_removed;
     } else {
       packet = Packet();
     }
@@ -324,6 +435,10 @@ Packet InputStreamManager::PopQueueHead(bool* stream_is_done) {
             << " Size:" << queue_.size();
     queue_became_non_full = (was_queue_full && queue_.size() < max_queue_size_);
     *stream_is_done = IsDone();
+    PublishQueueState();
+  }
+  if (bytes_removed != 0) {
+    queue_bytes_callback_(-bytes_removed);
   }
   if (queue_became_non_full) {
     VLOG(3) << "Queue became non-full: " << Name();
@@ -333,18 +448,16 @@ Packet InputStreamManager::PopQueueHead(bool* stream_is_done) {
 }
 
 int InputStreamManager::NumPacketsAdded() const {
-  absl::MutexLock lock(&stream_mutex_);
-  return num_packets_added_;
+  return static_cast<int>(
+      published_num_packets_added_.load(std::memory_order_acquire));
 }
 
 int InputStreamManager::QueueSize() const {
-  absl::MutexLock lock(&stream_mutex_);
-  return static_cast<int>(queue_.size());
+  return published_queue_size_.load(std::memory_order_acquire);
 }
 
 int InputStreamManager::MaxQueueSize() const {
-  absl::MutexLock lock(&stream_mutex_);
-  return max_queue_size_;
+  return published_max_queue_size_.load(std::memory_order_acquire);
 }
 
 void InputStreamManager::SetMaxQueueSize(int max_queue_size) {
@@ -354,6 +467,7 @@ void InputStreamManager::SetMaxQueueSize(int max_queue_size) {
     absl::MutexLock lock(&stream_mutex_);
     was_full = (max_queue_size_ != -1 && queue_.size() >= max_queue_size_);
     max_queue_size_ = max_queue_size;
+    published_max_queue_size_.store(max_queue_size, std::memory_order_release);
     is_full = (max_queue_size_ != -1 && queue_.size() >= max_queue_size_);
   }
 
@@ -368,8 +482,8 @@ void InputStreamManager::SetMaxQueueSize(int max_queue_size) {
 }
 
 bool InputStreamManager::IsFull() const {
-  absl::MutexLock lock(&stream_mutex_);
-  return max_queue_size_ != -1 && queue_.size() >= max_queue_size_;
+  const int max_queue_size = MaxQueueSize();
+  return max_queue_size != -1 && QueueSize() >= max_queue_size;
 }
 
 Timestamp InputStreamManager::GetMinTimestampAmongNLatest(int n) const {
@@ -382,6 +496,7 @@ Timestamp InputStreamManager::GetMinTimestampAmongNLatest(int n) const {
 
 void InputStreamManager::ErasePacketsEarlierThan(Timestamp timestamp) {
   bool queue_became_non_full = false;
+  int64_t bytes_removed = 0;
   {
     absl::MutexLock lock(&stream_mutex_);
     // Checks if queue is full.
@@ -389,19 +504,29 @@ void InputStreamManager::ErasePacketsEarlierThan(Timestamp timestamp) {
         (max_queue_size_ != -1 && queue_.size() >= max_queue_size_);
 
     while (!queue_.empty() && queue_.front().Timestamp() < timestamp) {
+      bytes_removed += PacketBytes(queue_.front());
       queue_.pop_front();
     }
+    queue_bytes_ -= bytes_removed;
+    PublishQueueState();
 
     VLOG(3) << "Input stream removed packets:" << name_
             << " Size:" << queue_.size();
     queue_became_non_full = (was_queue_full && queue_.size() < max_queue_size_);
   }
+  if (bytes_removed != 0) {
+    queue_bytes_callback_(-bytes_removed);
+  }
   if (queue_became_non_full) {
     VLOG(3) << "Queue became non-full: " << Name();
     becomes_not_full_callback_(this, &last_reported_stream_full_);
   }
 }
 
+int64_t InputStreamManager::PacketBytes(const Packet& packet) const {
+  return queue_bytes_callback_ ? packet.GetPayloadSize() : 0;
+}
+
 bool InputStreamManager::IsDone() const {
   return queue_.empty() && next_timestamp_bound_ == Timestamp::Done();
 }
@@ -15,6 +15,7 @@
 #ifndef MEDIAPIPE_FRAMEWORK_INPUT_STREAM_MANAGER_H_
 #define MEDIAPIPE_FRAMEWORK_INPUT_STREAM_MANAGER_H_
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <list>
@@ -43,6 +44,11 @@ namespace mediapipe {
 // An input stream is written to by exactly one output stream and is read by a
 // single node. None of its methods should hold a lock when they invoke a
 // callback in the scheduler.
+//
+// The queries used by input stream handlers to check readiness (IsEmpty,
+// QueueSize, IsFull, MinTimestampOrBound) are called much more often than the
+// queue changes. They read a snapshot that is published after every change,
+// and do not take stream_mutex_.
 class InputStreamManager {
  public:
   // Function type for becomes_full_callback and becomes_not_full_callback.
@@ -51,6 +57,10 @@ class InputStreamManager {
   // maintained by the callback.
   typedef std::function<void(InputStreamManager*, bool*)> QueueSizeCallback;
 
+  // Function type for queue_bytes_callback. The argument is the change in the
+  // payload bytes held by the queue.
+  typedef std::function<void(int64_t)> QueueBytesCallback;
+
   InputStreamManager(const InputStreamManager&) = delete;
   InputStreamManager& operator=(const InputStreamManager&) = delete;
 
@@ -66,6 +76,11 @@ class InputStreamManager {
   // Returns true if the input stream is a back edge.
   bool BackEdge() const { return back_edge_; }
 
+  // Skips validating the type of added packets. Used when all packets come
+  // from an output stream that has validated them for a type that this stream
+  // accepts entirely, see PacketType::AcceptsAllOf().
+  void DisablePacketTypeValidation() { validate_packet_types_ = false; }
+
   // Sets the header Packet.
   absl::Status SetHeader(const Packet& header);
 
@@ -90,12 +105,23 @@ class InputStreamManager {
   absl::Status AddPackets(const std::list<Packet>& container, bool* notify)
       ABSL_LOCKS_EXCLUDED(stream_mutex_);
 
+  // Adds a list of timestamped packets and then raises the next timestamp
+  // bound to "bound", as SetNextTimestampBound() does, while holding
+  // stream_mutex_ once. "bound" is ignored if it is Timestamp::Unset().
+  absl::Status AddPackets(const std::list<Packet>& container, Timestamp bound,
+                          bool* notify) ABSL_LOCKS_EXCLUDED(stream_mutex_);
+
   // Move a list of timestamped packets. Sets "notify" to true if the queue
   // becomes non-empty. Does nothing if the input stream is closed. After the
   // move, all packets in the container must be empty.
   absl::Status MovePackets(std::list<Packet>* container, bool* notify)
       ABSL_LOCKS_EXCLUDED(stream_mutex_);
 
+  // Moves a list of timestamped packets and then raises the next timestamp
+  // bound, like the AddPackets() overload above.
+  absl::Status MovePackets(std::list<Packet>* container, Timestamp bound,
+                           bool* notify) ABSL_LOCKS_EXCLUDED(stream_mutex_);
+
   // Closes the input stream.  This function can be called multiple times.
   void Close() ABSL_LOCKS_EXCLUDED(stream_mutex_);
 
@@ -178,23 +204,49 @@ class InputStreamManager {
   void SetQueueSizeCallbacks(QueueSizeCallback becomes_full_callback,
                              QueueSizeCallback becomes_not_full_callback);
 
+  // Sets a callback that is invoked with the change in the payload bytes held
+  // by the queue, as estimated by Packet::GetPayloadSize(), whenever packets
+  // are added or removed. Payload sizes are only computed while a callback is
+  // set. Must be set while the queue is empty.
+  void SetQueueBytesCallback(QueueBytesCallback queue_bytes_callback);
+
  private:
-  // Adds or moves a list of timestamped packets. Sets "notify" to true if the
-  // queue becomes non-empty. Returns an error if the packets have errors. Does
-  // nothing if the input stream is closed.
+  // Adds or moves a list of timestamped packets, and then raises the next
+  // timestamp bound to "bound" unless it is Timestamp::Unset(). Sets "notify"
+  // to true if the queue becomes non-empty. Returns an error if the packets or
+  // the bound have errors. Does nothing if the input stream is closed.
   // If the caller is AddPackets(), Container must be const reference.
   // Otherwise, the caller must be MovePackets() and Container should be
   // non-const reference.
   template <typename Container>
-  absl::Status AddOrMovePacketsInternal(Container container, bool* notify)
+  absl::Status AddOrMovePacketsInternal(Container container, Timestamp bound,
+                                        bool* notify)
       ABSL_LOCKS_EXCLUDED(stream_mutex_);
 
+  // Raises next_timestamp_bound_ to "bound". Returns an error if this
+  // decreases the bound, unless DisableTimestamps() is called. Returns true
+  // in "advanced" if the bound is raised.
+  absl::Status RaiseNextTimestampBound(Timestamp bound, bool* advanced)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(stream_mutex_);
+
+  // Returns the payload bytes of a packet, or 0 if queue_bytes_callback_ is
+  // not set.
+  int64_t PacketBytes(const Packet& packet) const;
+
   // Returns true if the next timestamp bound reaches Timestamp::Done().
   bool IsDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(stream_mutex_);
 
   // Returns the smallest timestamp at which this stream might see an input.
   Timestamp MinTimestampOrBoundHelper() const;
 
+  // Publishes the queue size and MinTimestampOrBoundHelper() for the lock-free
+  // queries. Must be called after every change to queue_ or
+  // next_timestamp_bound_.
+  void PublishQueueState() ABSL_EXCLUSIVE_LOCKS_REQUIRED(stream_mutex_);
+
+  // Reads a consistent snapshot of the state published by PublishQueueState().
+  void ReadQueueState(int* queue_size, Timestamp* min_timestamp_or_bound) const;
+
   mutable absl::Mutex stream_mutex_;
   std::deque<Packet> queue_ ABSL_GUARDED_BY(stream_mutex_);
   // The number of packets added to queue_.  Used to verify a packet at
@@ -209,6 +261,7 @@ class InputStreamManager {
   bool enable_timestamps_ = true;
   std::string name_;
   const PacketType* packet_type_;
+  bool validate_packet_types_ = true;
   bool back_edge_;
   // The header packet of the input stream.
   Packet header_;
@@ -216,6 +269,18 @@ class InputStreamManager {
   // The maximum queue size for this stream if set.
   int max_queue_size_ ABSL_GUARDED_BY(stream_mutex_) = -1;
 
+  // The payload bytes held by queue_, if queue_bytes_callback_ is set.
+  int64_t queue_bytes_ ABSL_GUARDED_BY(stream_mutex_) = 0;
+
+  // The state published by PublishQueueState(), protected by a sequence lock.
+  // The version is odd while the state is being written. The writer holds
+  // stream_mutex_, so there is at most one writer at a time.
+  std::atomic<uint32_t> published_version_{0};
+  std::atomic<int> published_queue_size_{0};
+  std::atomic<int64_t> published_min_timestamp_or_bound_{0};
+  std::atomic<int64_t> published_num_packets_added_{0};
+  std::atomic<int> published_max_queue_size_{-1};
+
   // Callback to notify the framework that we have hit the maximum queue size.
   QueueSizeCallback becomes_full_callback_;
 
@@ -223,6 +288,9 @@ class InputStreamManager {
   // the maximum specified.
   QueueSizeCallback becomes_not_full_callback_;
 
+  // Callback to report changes in queue_bytes_.
+  QueueBytesCallback queue_bytes_callback_;
+
   // This variable is used by the QueueSizeCallback to record the queue
   // fullness reported in the last completed QueueSizeCallback.
   // This variable is only accessed during the QueueSizeCallback.
@@ -17,12 +17,14 @@
 #include <memory>
 
 #include "absl/memory/memory.h"
+#include "absl/synchronization/notification.h"
 #include "mediapipe/framework/input_stream_shard.h"
 #include "mediapipe/framework/lifetime_tracker.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/port/threadpool.h"
 
 namespace mediapipe {
 namespace {
@@ -125,6 +127,39 @@ TEST_F(InputStreamManagerTest, MovePackets) {
   }
 }
 
+TEST_F(InputStreamManagerTest, AddPacketsWithTimestampBound) {
+  std::list<Packet> packets;
+  packets.push_back(MakePacket<std::string>("packet 1").At(Timestamp(10)));
+  packets.push_back(MakePacket<std::string>("packet 2").At(Timestamp(20)));
+
+  MP_ASSERT_OK(input_stream_manager_->AddPackets(packets, Timestamp(50),
+                                                 &notify_));  // Notification
+  EXPECT_TRUE(notify_);
+  // A bound below the current one is rejected.
+  EXPECT_FALSE(
+      input_stream_manager_->AddPackets({}, Timestamp(40), &notify_).ok());
+
+  bool is_empty = false;
+  popped_packet_ = input_stream_manager_->PopPacketAtTimestamp(
+      Timestamp(10), &num_packets_dropped_, &stream_is_done_);
+  popped_packet_ = input_stream_manager_->PopPacketAtTimestamp(
+      Timestamp(20), &num_packets_dropped_, &stream_is_done_);
+  EXPECT_EQ(Timestamp(50),
+            input_stream_manager_->MinTimestampOrBound(&is_empty));
+  EXPECT_TRUE(is_empty);
+
+  packets.clear();
+  packets.push_back(MakePacket<std::string>("packet 3").At(Timestamp(60)));
+  MP_ASSERT_OK(input_stream_manager_->MovePackets(&packets, Timestamp(80),
+                                                  &notify_));  // Notification
+  EXPECT_TRUE(notify_);
+  EXPECT_TRUE(packets.front().IsEmpty());
+  popped_packet_ = input_stream_manager_->PopPacketAtTimestamp(
+      Timestamp(60), &num_packets_dropped_, &stream_is_done_);
+  EXPECT_EQ(Timestamp(80),
+            input_stream_manager_->MinTimestampOrBound(&is_empty));
+}
+
 // InputStreamManager should reject the four timestamps that are not allowed in
 // a stream: Timestamp::Unset(), Timestamp::Unstarted(),
 // Timestamp::OneOverPostStream(), and Timestamp::Done().
@@ -427,6 +462,31 @@ TEST_F(InputStreamManagerTest, Close) {
   EXPECT_TRUE(input_stream_manager_->IsEmpty());
 }
 
+TEST_F(InputStreamManagerTest, QueueBytesCallback) {
+  int64_t queue_bytes = 0;
+  input_stream_manager_->SetQueueBytesCallback(
+      [&queue_bytes](int64_t delta) { queue_bytes += delta; });
+  std::string payload(1000, 'a');
+  std::list<Packet> packets;
+  packets.push_back(MakePacket<std::string>(payload).At(Timestamp(10)));
+  packets.push_back(MakePacket<std::string>(payload).At(Timestamp(20)));
+  packets.push_back(MakePacket<std::string>(payload).At(Timestamp(30)));
+  const int64_t packet_bytes = packets.front().GetPayloadSize();
+  EXPECT_GE(packet_bytes, 1000);
+
+  MP_ASSERT_OK(input_stream_manager_->AddPackets(packets, &notify_));
+  EXPECT_EQ(queue_bytes, 3 * packet_bytes);
+
+  popped_packet_ = input_stream_manager_->PopPacketAtTimestamp(
+      Timestamp(20), &num_packets_dropped_, &stream_is_done_);
+  EXPECT_EQ(num_packets_dropped_, 1);
+  EXPECT_EQ(queue_bytes, packet_bytes);
+
+  // Clearing the queue releases the remaining bytes.
+  input_stream_manager_->PrepareForRun();
+  EXPECT_EQ(queue_bytes, 0);
+}
+
 TEST_F(InputStreamManagerTest, ReuseInputStreamManager) {
   std::list<Packet> packets;
   packets.push_back(MakePacket<std::string>("packet 1").At(Timestamp(10)));
@@ -924,5 +984,45 @@ TEST_F(InputStreamManagerTest, BackwardsInTimeUntimed) {
   EXPECT_TRUE(notify_);
 }
 
+// Verifies that MinTimestampOrBound(), which does not lock the stream, never
+// reports a torn state while packets are added and popped concurrently.
+TEST_F(InputStreamManagerTest, MinTimestampOrBoundIsConsistent) {
+  constexpr int kNumPackets = 10000;
+  absl::Notification done;
+  bool consistent = true;
+  {
+    ThreadPool thread_pool("reader", 1);
+    thread_pool.StartWorkers();
+    thread_pool.Schedule([this, &done, &consistent] {
+      while (!done.HasBeenNotified()) {
+        bool is_empty;
+        Timestamp timestamp =
+            input_stream_manager_->MinTimestampOrBound(&is_empty);
+        if (timestamp == Timestamp::PreStream() ||
+            timestamp == Timestamp::Done()) {
+          continue;
+        }
+        // Packets have even timestamps, and the bound after each packet is
+        // odd.
+        if (is_empty != (timestamp.Value() % 2 == 1)) {
+          consistent = false;
+        }
+      }
+    });
+    for (int i = 0; i < kNumPackets; ++i) {
+      std::list<Packet> packets;
+      packets.push_back(
+          MakePacket<std::string>("packet").At(Timestamp(2 * i)));
+      MP_ASSERT_OK(input_stream_manager_->AddPackets(packets, &notify_));
+      popped_packet_ = input_stream_manager_->PopPacketAtTimestamp(
+          Timestamp(2 * i), &num_packets_dropped_, &stream_is_done_);
+      EXPECT_FALSE(popped_packet_.IsEmpty());
+    }
+    done.Notify();
+  }
+  EXPECT_TRUE(consistent);
+  EXPECT_EQ(kNumPackets, input_stream_manager_->NumPacketsAdded());
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -17,6 +17,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/collection_item_id.h"
+#include "mediapipe/framework/input_stream_handler.h"
 #include "mediapipe/framework/output_stream_shard.h"
 
 namespace mediapipe {
@@ -128,6 +129,7 @@ void OutputStreamHandler::TryPropagateTimestampBound(Timestamp input_bound) {
     return;
   }
   OutputStreamShard empty_output;
+  InputStreamHandler::NotificationBatch notification_batch;
   for (OutputStreamManager* manager : output_stream_managers_) {
     if (manager->OffsetEnabled() && !manager->IsClosed() &&
         input_bound + manager->Offset() > manager->NextTimestampBound()) {
@@ -138,6 +140,7 @@ void OutputStreamHandler::TryPropagateTimestampBound(Timestamp input_bound) {
 }
 
 void OutputStreamHandler::Close(OutputStreamShardSet* output_shards) {
+  InputStreamHandler::NotificationBatch notification_batch;
   for (CollectionItemId id = output_stream_managers_.BeginId();
        id < output_stream_managers_.EndId(); ++id) {
     if (output_shards) {
@@ -151,6 +154,7 @@ void OutputStreamHandler::Close(OutputStreamShardSet* output_shards) {
 void OutputStreamHandler::PropagateOutputPackets(
     Timestamp input_timestamp, OutputStreamShardSet* output_shards) {
   ABSL_CHECK(output_shards);
+  InputStreamHandler::NotificationBatch notification_batch;
   for (CollectionItemId id = output_stream_managers_.BeginId();
        id < output_stream_managers_.EndId(); ++id) {
     OutputStreamManager* manager = output_stream_managers_.Get(id);
@@ -14,6 +14,8 @@
 
 #include "mediapipe/framework/output_stream_manager.h"
 
+#include <utility>
+
 #include "absl/log/absl_check.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/input_stream_handler.h"
@@ -161,6 +163,11 @@ Timestamp OutputStreamManager::ComputeOutputTimestampBound(
   return new_bound;
 }
 
+void OutputStreamManager::SetPacketsCallback(
+    PacketsCallback packets_callback) {
+  packets_callback_ = std::move(packets_callback);
+}
+
 // TODO Consider moving the propagation logic to OutputStreamHandler.
 void OutputStreamManager::PropagateUpdatesToMirrors(
     Timestamp next_timestamp_bound, OutputStreamShard* output_stream_shard) {
@@ -179,11 +186,19 @@ void OutputStreamManager::PropagateUpdatesToMirrors(
   VLOG(3) << "Output stream: " << Name()
           << " next timestamp: " << next_timestamp_bound;
   bool add_packets = !packets_to_propagate->empty();
+  if (add_packets && packets_callback_) {
+    packets_callback_(*packets_to_propagate);
+  }
   bool set_bound =
       (next_timestamp_bound != Timestamp::Unset()) &&
       (!add_packets ||
        packets_to_propagate->back().Timestamp().NextAllowedInStream() !=
            next_timestamp_bound);
+  // The packets and the bound are added to each mirror under one lock of the
+  // mirror stream. The caller's NotificationBatch wakes the downstream nodes
+  // once the whole fan-out is done.
+  const Timestamp mirror_bound =
+      set_bound ? next_timestamp_bound : Timestamp::Unset();
   int mirror_count = mirrors_.size();
   for (int idx = 0; idx < mirror_count; ++idx) {
     const Mirror& mirror = mirrors_[idx];
@@ -191,14 +206,13 @@ void OutputStreamManager::PropagateUpdatesToMirrors(
       // If the stream is the last element in mirrors_, moves packets from
       // output_queue_. Otherwise, copies the packets.
       if (idx == mirror_count - 1) {
-        mirror.input_stream_handler->MovePackets(mirror.id,
-                                                 packets_to_propagate);
+        mirror.input_stream_handler->MovePackets(
+            mirror.id, packets_to_propagate, mirror_bound);
       } else {
-        mirror.input_stream_handler->AddPackets(mirror.id,
-                                                *packets_to_propagate);
+        mirror.input_stream_handler->AddPackets(
+            mirror.id, *packets_to_propagate, mirror_bound);
       }
-    }
-    if (set_bound) {
+    } else if (set_bound) {
       mirror.input_stream_handler->SetNextTimestampBound(mirror.id,
                                                          next_timestamp_bound);
     }
@@ -16,6 +16,7 @@
 #define MEDIAPIPE_FRAMEWORK_OUTPUT_STREAM_MANAGER_H_
 
 #include <functional>
+#include <list>
 #include <string>
 #include <vector>
 
@@ -99,6 +100,11 @@ class OutputStreamManager {
 
   void ResetShard(OutputStreamShard* output_stream_shard);
 
+  // Sets a callback invoked with the packets added to the stream, before they
+  // are propagated to the mirrors. Must be set before the graph runs.
+  using PacketsCallback = std::function<void(const std::list<Packet>&)>;
+  void SetPacketsCallback(PacketsCallback packets_callback);
+
   OutputStreamSpec* Spec() { return &output_stream_spec_; }
 
  private:
@@ -115,6 +121,7 @@ class OutputStreamManager {
   // output stream manager.
   OutputStreamSpec output_stream_spec_;
   std::vector<Mirror> mirrors_;
+  PacketsCallback packets_callback_;
 
   mutable absl::Mutex stream_mutex_;
   Timestamp next_timestamp_bound_ ABSL_GUARDED_BY(stream_mutex_);
@@ -16,6 +16,7 @@
 #define MEDIAPIPE_FRAMEWORK_OUTPUT_STREAM_POLLER_H_
 
 #include <memory>
+#include <vector>
 
 #include "absl/log/absl_check.h"
 #include "mediapipe/framework/graph_output_stream.h"
@@ -49,6 +50,31 @@ class OutputStreamPoller {
     return poller->Next(packet);
   }
 
+  // Appends all queued packets to packets, up to max_packets, blocking until
+  // at least one packet is available or the stream is done.  A timestamp
+  // bound change is reported as in Next().  Returns false if the stream is
+  // done and no packets remain.  Unlike repeated calls to Next(), the poller
+  // is locked and woken once per batch.
+  ABSL_MUST_USE_RESULT bool NextBatch(std::vector<Packet>* packets,
+                                      int max_packets) {
+    auto poller = internal_poller_impl_.lock();
+    if (!poller) {
+      return false;
+    }
+    return poller->NextBatch(packets, max_packets, /*block=*/true);
+  }
+
+  // Like NextBatch(), but returns immediately, possibly without appending any
+  // packets.  Returns false if the stream is done and no packets remain.
+  ABSL_MUST_USE_RESULT bool TryNextBatch(std::vector<Packet>* packets,
+                                         int max_packets) {
+    auto poller = internal_poller_impl_.lock();
+    if (!poller) {
+      return false;
+    }
+    return poller->NextBatch(packets, max_packets, /*block=*/false);
+  }
+
   void SetMaxQueueSize(int queue_size) {
     auto poller = internal_poller_impl_.lock();
     ABSL_CHECK(poller) << "OutputStreamPollerImpl is already destroyed.";
@@ -17,14 +17,17 @@
 #ifndef MEDIAPIPE_FRAMEWORK_PACKET_H_
 #define MEDIAPIPE_FRAMEWORK_PACKET_H_
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <ostream>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 #include "absl/base/macros.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/memory/memory.h"
@@ -33,6 +36,7 @@
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/deps/no_destructor.h"
 #include "mediapipe/framework/deps/registration.h"
+#include "mediapipe/framework/payload_size.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/canonical_errors.h"
 #include "mediapipe/framework/port/logging.h"
@@ -51,13 +55,57 @@ class Packet;
 
 namespace packet_internal {
 class HolderBase;
+template <typename T>
+class InlineHolder;
+
+// An intrusive reference-counted pointer to a HolderBase. The reference count
+// is stored in the holder itself, so unlike std::shared_ptr no separate control
+// block is allocated for each packet.
+class HolderPtr {
+ public:
+  HolderPtr() = default;
+  HolderPtr(std::nullptr_t) {}  // NOLINT(runtime/explicit)
+  // Adds a reference to holder, which must have been allocated with new and
+  // is deleted when its last reference goes away.
+  explicit HolderPtr(HolderBase* holder);
+  HolderPtr(const HolderPtr& other);
+  HolderPtr(HolderPtr&& other) noexcept : holder_(other.holder_) {
+    other.holder_ = nullptr;
+  }
+  HolderPtr& operator=(const HolderPtr& other);
+  HolderPtr& operator=(HolderPtr&& other) noexcept;
+  ~HolderPtr();
+
+  HolderBase* get() const { return holder_; }
+  HolderBase* operator->() const { return holder_; }
+  HolderBase& operator*() const { return *holder_; }
+  explicit operator bool() const { return holder_ != nullptr; }
+
+  void reset(HolderBase* holder = nullptr);
+
+  // Returns true if this is the only reference to a non-null holder.
+  bool unique() const;
+
+  friend bool operator==(const HolderPtr& p, std::nullptr_t) {
+    return p.holder_ == nullptr;
+  }
+  friend bool operator!=(const HolderPtr& p, std::nullptr_t) {
+    return p.holder_ != nullptr;
+  }
+
+ private:
+  static void Ref(HolderBase* holder);
+  static void Unref(HolderBase* holder);
+
+  HolderBase* holder_ = nullptr;
+};
 
 Packet Create(HolderBase* holder);
 Packet Create(HolderBase* holder, Timestamp timestamp);
-Packet Create(std::shared_ptr<HolderBase> holder, Timestamp timestamp);
+Packet Create(HolderPtr holder, Timestamp timestamp);
 const HolderBase* GetHolder(const Packet& packet);
-const std::shared_ptr<HolderBase>& GetHolderShared(const Packet& packet);
-std::shared_ptr<HolderBase> GetHolderShared(Packet&& packet);
+const HolderPtr& GetHolderShared(const Packet& packet);
+HolderPtr GetHolderShared(Packet&& packet);
 absl::StatusOr<Packet> PacketFromDynamicProto(const std::string& type_name,
                                               const std::string& serialized);
 }  // namespace packet_internal
@@ -65,8 +113,8 @@ absl::StatusOr<Packet> PacketFromDynamicProto(const std::string& type_name,
 // A generic container class which can hold data of any type.  The type of
 // the data is specified when accessing the data (using Packet::Get<T>()).
 //
-// The Packet is implemented as a reference-counted pointer.  This means
-// that copying Packets creates a fast, shallow copy.  Packets are
+// The Packet is implemented as an intrusive reference-counted pointer.  This
+// means that copying Packets creates a fast, shallow copy.  Packets are
 // copyable, movable, and assignable.  Packets can be stored in STL
 // containers.  A Packet may optionally contain a timestamp.
 //
@@ -215,6 +263,10 @@ class Packet {
   // Crashes if IsEmpty() == true.
   TypeId GetTypeId() const;
 
+  // Returns an estimate of the bytes of memory held by the payload, or 0 if
+  // the packet is empty. See PayloadSize in payload_size.h.
+  size_t GetPayloadSize() const;
+
   // Returns the timestamp.
   class Timestamp Timestamp() const;
 
@@ -234,20 +286,19 @@ class Packet {
   friend Packet packet_internal::Create(packet_internal::HolderBase* holder);
   friend Packet packet_internal::Create(packet_internal::HolderBase* holder,
                                         class Timestamp timestamp);
-  friend Packet packet_internal::Create(
-      std::shared_ptr<packet_internal::HolderBase> holder,
-      class Timestamp timestamp);
+  friend Packet packet_internal::Create(packet_internal::HolderPtr holder,
+                                        class Timestamp timestamp);
   friend const packet_internal::HolderBase* packet_internal::GetHolder(
       const Packet& packet);
-  friend const std::shared_ptr<packet_internal::HolderBase>&
-  packet_internal::GetHolderShared(const Packet& packet);
-  friend std::shared_ptr<packet_internal::HolderBase>
-  packet_internal::GetHolderShared(Packet&& packet);
+  friend const packet_internal::HolderPtr& packet_internal::GetHolderShared(
+      const Packet& packet);
+  friend packet_internal::HolderPtr packet_internal::GetHolderShared(
+      Packet&& packet);
 
   friend class PacketType;
   absl::Status ValidateAsType(TypeId type_id) const;
 
-  std::shared_ptr<packet_internal::HolderBase> holder_;
+  packet_internal::HolderPtr holder_;
   class Timestamp timestamp_;
 };
 
@@ -267,8 +318,14 @@ Packet Adopt(const T* ptr);
 // returned Packet but also all of its copies. The timestamp of the returned
 // Packet is Timestamp::Unset(). To set the timestamp, the caller should do
 // PointToForeign(...).At(...).
+//
+// If `cleanup` is set, it is called when the last copy of the returned Packet
+// is destroyed. This allows a Packet to point into data owned by another
+// object, e.g. a field of a proto held by another Packet, and to keep that
+// object alive by capturing it in `cleanup`.
 template <typename T>
-Packet PointToForeign(const T* ptr);
+Packet PointToForeign(const T* ptr,
+                      absl::AnyInvocable<void()> cleanup = nullptr);
 
 // Adopts the data but places it in a std::unique_ptr inside the
 // resulting Packet, leaving the timestamp unset. This allows the
@@ -328,12 +385,18 @@ Packet AdoptAsSyncedPacket(const T* ptr) {
 // provided arguments. Similar to MakeUnique. Especially convenient for arrays,
 // since it ensures the packet gets the right type (see below).
 //
-// Version for scalars.
+// Version for scalars. If T is nothrow move constructible, the object is
+// stored in the same allocation as the packet's holder and reference count.
 template <typename T,
           typename std::enable_if<!std::is_array<T>::value>::type* = nullptr,
           typename... Args>
 Packet MakePacket(Args&&... args) {  // NOLINT(build/c++11)
-  return Adopt(new T(std::forward<Args>(args)...));
+  if constexpr (std::is_nothrow_move_constructible<T>::value) {
+    return packet_internal::Create(
+        new packet_internal::InlineHolder<T>(std::forward<Args>(args)...));
+  } else {
+    return Adopt(new T(std::forward<Args>(args)...));
+  }
 }
 
 // Version for arrays. We have to use reinterpret_cast because new T[N]
@@ -421,6 +484,20 @@ class HolderBase {
   GetVectorOfProtoMessageLite() const = 0;
 
   virtual bool HasForeignOwner() const { return false; }
+
+  // Returns true if the data is stored in memory that belongs to the holder,
+  // such as inside the holder itself or on an arena, rather than in its own
+  // heap allocation.
+  virtual bool StoresDataInPlace() const { return false; }
+
+  // Returns an estimate of the bytes of memory held by the data.
+  virtual size_t GetPayloadSize() const { return 0; }
+
+ private:
+  friend class HolderPtr;
+
+  // The number of HolderPtrs referring to this holder.
+  std::atomic<int> ref_count_{0};
 };
 
 // Two helper functions to get the proto base pointers.
@@ -523,6 +600,14 @@ class Holder : public HolderBase, private HolderPayloadRegistrator<T> {
       return InternalError(
           "Foreign holder can't release data ptr without ownership.");
     }
+    if (StoresDataInPlace()) {
+      // The data can't outlive the holder, so it is moved to a new object.
+      if constexpr (std::is_move_constructible<T>::value) {
+        return absl::make_unique<T>(std::move(*const_cast<T*>(ptr_)));
+      } else {
+        return InternalError("Can't release immovable data stored in place.");
+      }
+    }
     // Casts away constness to make the data mutable after the release.
     std::unique_ptr<T> data_ptr(const_cast<T*>(ptr_));
     ptr_ = nullptr;
@@ -547,6 +632,9 @@ class Holder : public HolderBase, private HolderPayloadRegistrator<T> {
     }
     return "";
   }
+  size_t GetPayloadSize() const final {
+    return ptr_ ? PayloadSize<T>::Get(*ptr_) : 0;
+  }
 
  protected:
   // The pointer that uniquely owns the data. However, the ownership of the
@@ -589,14 +677,42 @@ class Holder : public HolderBase, private HolderPayloadRegistrator<T> {
 template <typename T>
 class ForeignHolder : public Holder<T> {
  public:
-  using Holder<T>::Holder;
+  explicit ForeignHolder(const T* ptr,
+                         absl::AnyInvocable<void()> cleanup = nullptr)
+      : Holder<T>(ptr), cleanup_(std::move(cleanup)) {}
   ~ForeignHolder() override {
     // Null out ptr_ so it doesn't get deleted by ~Holder.
     // Note that ~Holder cannot call HasForeignOwner because the subclass's
     // destructor runs first.
     this->ptr_ = nullptr;
+    if (cleanup_) {
+      std::move(cleanup_)();
+    }
   }
   bool HasForeignOwner() const final { return true; }
+
+ private:
+  absl::AnyInvocable<void()> cleanup_;
+};
+
+// A Holder that stores its data inline, so that the data, the holder and its
+// reference count take a single allocation. Used by MakePacket.
+template <typename T>
+class InlineHolder : public Holder<T> {
+ public:
+  template <typename... Args>
+  explicit InlineHolder(Args&&... args)
+      : Holder<T>(nullptr), data_(std::forward<Args>(args)...) {
+    this->ptr_ = &data_;
+  }
+  ~InlineHolder() override {
+    // Null out ptr_ so it doesn't get deleted by ~Holder.
+    this->ptr_ = nullptr;
+  }
+  bool StoresDataInPlace() const final { return true; }
+
+ private:
+  T data_;
 };
 
 template <typename T>
@@ -617,6 +733,55 @@ const Holder<T>* HolderBase::As() const {
   return nullptr;
 }
 
+inline void HolderPtr::Ref(HolderBase* holder) {
+  if (holder) holder->ref_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void HolderPtr::Unref(HolderBase* holder) {
+  if (holder &&
+      holder->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete holder;
+  }
+}
+
+inline HolderPtr::HolderPtr(HolderBase* holder) : holder_(holder) {
+  Ref(holder_);
+}
+
+inline HolderPtr::HolderPtr(const HolderPtr& other) : holder_(other.holder_) {
+  Ref(holder_);
+}
+
+inline HolderPtr& HolderPtr::operator=(const HolderPtr& other) {
+  reset(other.holder_);
+  return *this;
+}
+
+inline HolderPtr& HolderPtr::operator=(HolderPtr&& other) noexcept {
+  if (this != &other) {
+    HolderBase* old_holder = holder_;
+    holder_ = other.holder_;
+    other.holder_ = nullptr;
+    Unref(old_holder);
+  }
+  return *this;
+}
+
+inline HolderPtr::~HolderPtr() { Unref(holder_); }
+
+inline void HolderPtr::reset(HolderBase* holder) {
+  // Referencing the new holder first makes self-assignment safe.
+  Ref(holder);
+  HolderBase* old_holder = holder_;
+  holder_ = holder;
+  Unref(old_holder);
+}
+
+inline bool HolderPtr::unique() const {
+  return holder_ &&
+         holder_->ref_count_.load(std::memory_order_acquire) == 1;
+}
+
 }  // namespace packet_internal
 
 inline Packet::Packet(const Packet& packet)
@@ -752,6 +917,10 @@ inline TypeId Packet::GetTypeId() const {
   return holder_->GetTypeId();
 }
 
+inline size_t Packet::GetPayloadSize() const {
+  return holder_ ? holder_->GetPayloadSize() : 0;
+}
+
 template <typename T>
 inline const T& Packet::Get() const {
   packet_internal::Holder<T>* holder = IsEmpty() ? nullptr : holder_->As<T>();
@@ -772,9 +941,10 @@ Packet Adopt(const T* ptr) {
 }
 
 template <typename T>
-Packet PointToForeign(const T* ptr) {
+Packet PointToForeign(const T* ptr, absl::AnyInvocable<void()> cleanup) {
   ABSL_CHECK(ptr != nullptr);
-  return packet_internal::Create(new packet_internal::ForeignHolder<T>(ptr));
+  return packet_internal::Create(
+      new packet_internal::ForeignHolder<T>(ptr, std::move(cleanup)));
 }
 
 // Equal Packets refer to the same memory contents, like equal pointers.
@@ -787,12 +957,11 @@ inline bool operator!=(const Packet& p1, const Packet& p2) {
 
 namespace packet_internal {
 
-inline const std::shared_ptr<HolderBase>& GetHolderShared(
-    const Packet& packet) {
+inline const HolderPtr& GetHolderShared(const Packet& packet) {
   return packet.holder_;
 }
 
-inline std::shared_ptr<HolderBase> GetHolderShared(Packet&& packet) {
+inline HolderPtr GetHolderShared(Packet&& packet) {
   return std::move(packet.holder_);
 }
 
@@ -0,0 +1,168 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/packet_arena.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace mediapipe {
+
+namespace {
+
+constexpr size_t kAlignment = alignof(std::max_align_t);
+
+// Every allocation is preceded by a header pointing to its block.
+constexpr size_t kHeaderSize = kAlignment;
+
+// The maximum number of unused blocks kept for reuse.
+constexpr int kMaxFreeBlocks = 16;
+
+size_t RoundUp(size_t size) {
+  return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+}  // namespace
+
+struct PacketArena::Block {
+  explicit Block(size_t size)
+      : size(size), data(new std::max_align_t[size / kAlignment]) {}
+
+  // Returns memory for an allocation of "size" bytes, including the header.
+  // Must be called by the arena that uses the block, with its mutex held.
+  void* Allocate(size_t size) {
+    char* memory = reinterpret_cast<char*>(data.get()) + used;
+    used += size;
+    ref_count.fetch_add(1, std::memory_order_relaxed);
+    *reinterpret_cast<Block**>(memory) = this;
+    return memory + kHeaderSize;
+  }
+
+  const size_t size;
+  std::unique_ptr<std::max_align_t[]> data;
+  // The number of bytes allocated from data.
+  size_t used = 0;
+  // The number of live allocations, plus one while this is the current block
+  // of its arena.
+  std::atomic<int> ref_count{0};
+  // The pool the block returns to. Null while the block is in the pool.
+  std::shared_ptr<BlockPool> pool;
+  proto_ns::Arena proto_arena;
+};
+
+// Keeps the unused blocks of a PacketArena. Blocks in use keep the pool
+// alive, so that they can be returned to it after the arena is destroyed.
+struct PacketArena::BlockPool {
+  explicit BlockPool(size_t block_size) : block_size(block_size) {}
+  ~BlockPool() {
+    for (Block* block : free_blocks) {
+      delete block;
+    }
+  }
+
+  const size_t block_size;
+  absl::Mutex mutex;
+  std::vector<Block*> free_blocks ABSL_GUARDED_BY(mutex);
+  // Set when the arena is destroyed. Released blocks are then freed.
+  bool closed ABSL_GUARDED_BY(mutex) = false;
+};
+
+PacketArena::PacketArena(size_t block_size)
+    : block_size_(RoundUp(std::max(block_size, 2 * kHeaderSize))),
+      pool_(std::make_shared<BlockPool>(block_size_)) {}
+
+PacketArena::~PacketArena() {
+  {
+    absl::MutexLock lock(&pool_->mutex);
+    pool_->closed = true;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (current_block_ != nullptr) {
+    Unref(current_block_);
+    current_block_ = nullptr;
+  }
+}
+
+void* PacketArena::Allocate(size_t size, proto_ns::Arena** proto_arena) {
+  const size_t needed = kHeaderSize + RoundUp(size);
+  absl::MutexLock lock(&mutex_);
+  Block* block;
+  if (needed > block_size_) {
+    // Oversized allocations get a block of their own, which is freed with the
+    // allocation.
+    block = NewBlock(needed);
+  } else {
+    if (current_block_ == nullptr ||
+        current_block_->used + needed > current_block_->size) {
+      Block* full_block = current_block_;
+      current_block_ = NewBlock(block_size_);
+      current_block_->ref_count.fetch_add(1, std::memory_order_relaxed);
+      if (full_block != nullptr) {
+        Unref(full_block);
+      }
+    }
+    block = current_block_;
+  }
+  if (proto_arena != nullptr) {
+    *proto_arena = &block->proto_arena;
+  }
+  return block->Allocate(needed);
+}
+
+// static
+void PacketArena::Deallocate(void* ptr) {
+  Block* block = *reinterpret_cast<Block**>(static_cast<char*>(ptr) -
+                                            kHeaderSize);
+  Unref(block);
+}
+
+PacketArena::Block* PacketArena::NewBlock(size_t size) {
+  Block* block = nullptr;
+  if (size == block_size_) {
+    absl::MutexLock lock(&pool_->mutex);
+    if (!pool_->free_blocks.empty()) {
+      block = pool_->free_blocks.back();
+      pool_->free_blocks.pop_back();
+    }
+  }
+  if (block == nullptr) {
+    block = new Block(size);
+    num_allocated_blocks_.fetch_add(1, std::memory_order_relaxed);
+  }
+  block->pool = pool_;
+  return block;
+}
+
+// static
+void PacketArena::Unref(Block* block) {
+  if (block->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  // The last reference to the pool may be held by this block, so it is only
+  // released after the pool's mutex.
+  std::shared_ptr<BlockPool> pool = std::move(block->pool);
+  {
+    absl::MutexLock lock(&pool->mutex);
+    if (!pool->closed && block->size == pool->block_size &&
+        pool->free_blocks.size() < kMaxFreeBlocks) {
+      block->used = 0;
+      block->proto_arena.Reset();
+      pool->free_blocks.push_back(block);
+      return;
+    }
+  }
+  delete block;
+}
+
+}  // namespace mediapipe
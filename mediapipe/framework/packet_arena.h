@@ -0,0 +1,188 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Defines PacketArena, an allocator for the payloads of short-lived packets.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PACKET_ARENA_H_
+#define MEDIAPIPE_FRAMEWORK_PACKET_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/arena.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/proto_ns.h"
+
+namespace mediapipe {
+
+class PacketArena;
+
+namespace packet_internal {
+
+// Base class of the holders that are allocated from a PacketArena. Deleting
+// such a holder returns its memory to the arena block it came from.
+class ArenaAllocated {
+ public:
+  static void operator delete(void* ptr);
+};
+
+// A holder allocated from a PacketArena that stores its data inline.
+template <typename T>
+class ArenaInlineHolder : public InlineHolder<T>, public ArenaAllocated {
+ public:
+  using InlineHolder<T>::InlineHolder;
+};
+
+// A holder allocated from a PacketArena whose protobuf message is created on
+// the protobuf arena of the same arena block.
+template <typename T>
+class ArenaMessageHolder : public Holder<T>, public ArenaAllocated {
+ public:
+  template <typename... Args>
+  explicit ArenaMessageHolder(proto_ns::Arena* proto_arena, Args&&... args)
+      : Holder<T>(nullptr) {
+    T* message = proto_ns::Arena::CreateMessage<T>(proto_arena);
+    if constexpr (sizeof...(Args) > 0) {
+      *message = T(std::forward<Args>(args)...);
+    }
+    this->ptr_ = message;
+  }
+  ~ArenaMessageHolder() override {
+    // The message is owned by the protobuf arena.
+    this->ptr_ = nullptr;
+  }
+  bool StoresDataInPlace() const final { return true; }
+};
+
+}  // namespace packet_internal
+
+// An allocator for the payloads of short-lived packets.
+//
+// Packet holders and payloads are carved out of large blocks. A block is
+// recycled as a whole once every packet allocated from it has been released,
+// so packets that are created and released together, such as the packets of
+// one timestamp, cause no calls to the system allocator in the steady state.
+// Protocol buffer messages are created on a proto_ns::Arena that belongs to
+// the block, so their sub-messages and repeated fields come from the block
+// as well.
+//
+// Packets may outlive the PacketArena that allocated them; the blocks they
+// use are then freed when they are released.
+//
+// Calculators can use the graph's arena through
+// CalculatorContext::GetPacketArena(), which returns nullptr unless the graph
+// sets CalculatorGraphConfig::packet_arena_block_size:
+//
+//   Packet packet = MakePacketInArena<NormalizedRect>(cc->GetPacketArena());
+//
+// This class is thread safe.
+class PacketArena {
+ public:
+  // Creates an arena that allocates blocks of block_size bytes. Payloads that
+  // don't fit into a block get a block of their own.
+  explicit PacketArena(size_t block_size);
+  ~PacketArena();
+  PacketArena(const PacketArena&) = delete;
+  PacketArena& operator=(const PacketArena&) = delete;
+
+  // Returns a Packet holding a T constructed from args, with the holder and
+  // the payload allocated from this arena. Falls back to MakePacket<T> for
+  // types that can't be stored in an arena block.
+  template <typename T, typename... Args>
+  Packet MakePacket(Args&&... args);
+
+  // Returns the number of blocks allocated from the system so far.
+  int64_t NumAllocatedBlocks() const {
+    return num_allocated_blocks_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class packet_internal::ArenaAllocated;
+  struct Block;
+  struct BlockPool;
+
+  // Returns size bytes aligned to alignof(std::max_align_t). If proto_arena
+  // is not null, it is set to the protobuf arena of the returned memory's
+  // block.
+  void* Allocate(size_t size, proto_ns::Arena** proto_arena);
+  // Returns memory obtained from Allocate to its block.
+  static void Deallocate(void* ptr);
+
+  // Returns a block from the pool, or a new one with at least size bytes.
+  Block* NewBlock(size_t size) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Drops a reference to block, recycling it when it becomes unused.
+  static void Unref(Block* block);
+
+  const size_t block_size_;
+  std::shared_ptr<BlockPool> pool_;
+  std::atomic<int64_t> num_allocated_blocks_{0};
+
+  absl::Mutex mutex_;
+  // The block new allocations are made from.
+  Block* current_block_ ABSL_GUARDED_BY(mutex_) = nullptr;
+};
+
+template <typename T, typename... Args>
+Packet PacketArena::MakePacket(Args&&... args) {
+  static_assert(!std::is_array<T>::value,
+                "PacketArena doesn't support arrays.");
+  if constexpr (std::is_base_of<proto_ns::MessageLite, T>::value &&
+                proto_ns::Arena::is_arena_constructable<T>::value) {
+    proto_ns::Arena* proto_arena;
+    void* memory = Allocate(sizeof(packet_internal::ArenaMessageHolder<T>),
+                            &proto_arena);
+    return packet_internal::Create(new (memory)
+                                       packet_internal::ArenaMessageHolder<T>(
+                                           proto_arena,
+                                           std::forward<Args>(args)...));
+  } else if constexpr (std::is_nothrow_move_constructible<T>::value &&
+                       alignof(T) <= alignof(std::max_align_t)) {
+    void* memory =
+        Allocate(sizeof(packet_internal::ArenaInlineHolder<T>), nullptr);
+    return packet_internal::Create(
+        new (memory)
+            packet_internal::ArenaInlineHolder<T>(std::forward<Args>(args)...));
+  } else {
+    return mediapipe::MakePacket<T>(std::forward<Args>(args)...);
+  }
+}
+
+// Returns arena->MakePacket<T>(args...), or MakePacket<T>(args...) if arena
+// is nullptr.
+template <typename T, typename... Args>
+Packet MakePacketInArena(PacketArena* arena, Args&&... args) {
+  if (arena == nullptr) {
+    return MakePacket<T>(std::forward<Args>(args)...);
+  }
+  return arena->MakePacket<T>(std::forward<Args>(args)...);
+}
+
+namespace packet_internal {
+
+inline void ArenaAllocated::operator delete(void* ptr) {
+  PacketArena::Deallocate(ptr);
+}
+
+}  // namespace packet_internal
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PACKET_ARENA_H_
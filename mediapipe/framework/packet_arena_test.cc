@@ -0,0 +1,162 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/packet_arena.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/packet_test.pb.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/sink.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(PacketArenaTest, MakesPackets) {
+  PacketArena arena(1024);
+  Packet int_packet = arena.MakePacket<int>(42).At(Timestamp(1));
+  Packet string_packet = arena.MakePacket<std::string>("abc");
+  Packet vector_packet = arena.MakePacket<std::vector<int>>(3, 7);
+  EXPECT_EQ(42, int_packet.Get<int>());
+  EXPECT_EQ(Timestamp(1), int_packet.Timestamp());
+  EXPECT_EQ("abc", string_packet.Get<std::string>());
+  EXPECT_EQ(std::vector<int>({7, 7, 7}), vector_packet.Get<std::vector<int>>());
+  EXPECT_EQ(1, arena.NumAllocatedBlocks());
+}
+
+TEST(PacketArenaTest, MakesProtoPackets) {
+  PacketArena arena(1024);
+  PacketTestProto proto;
+  proto.add_x(5);
+  Packet empty_packet = arena.MakePacket<PacketTestProto>();
+  Packet copy_packet = arena.MakePacket<PacketTestProto>(proto);
+  EXPECT_EQ(0, empty_packet.Get<PacketTestProto>().x_size());
+  ASSERT_EQ(1, copy_packet.Get<PacketTestProto>().x_size());
+  EXPECT_EQ(5, copy_packet.Get<PacketTestProto>().x(0));
+  MP_EXPECT_OK(copy_packet.ValidateAsProtoMessageLite());
+}
+
+TEST(PacketArenaTest, RecyclesReleasedBlocks) {
+  PacketArena arena(256);
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<Packet> packets;
+    for (int j = 0; j < 10; ++j) {
+      packets.push_back(arena.MakePacket<int>(j));
+    }
+  }
+  // Blocks are reused once the packets of an iteration are released.
+  EXPECT_LE(arena.NumAllocatedBlocks(), 2);
+}
+
+TEST(PacketArenaTest, AllocatesOversizedPayloads) {
+  using Buffer = std::array<char, 1000>;
+  PacketArena arena(64);
+  Packet packet = arena.MakePacket<Buffer>();
+  EXPECT_EQ(1000, packet.Get<Buffer>().size());
+}
+
+TEST(PacketArenaTest, PacketsOutliveArena) {
+  Packet int_packet;
+  Packet proto_packet;
+  {
+    PacketArena arena(1024);
+    int_packet = arena.MakePacket<int>(3);
+    PacketTestProto proto;
+    proto.add_x(4);
+    proto_packet = arena.MakePacket<PacketTestProto>(proto);
+  }
+  EXPECT_EQ(3, int_packet.Get<int>());
+  EXPECT_EQ(4, proto_packet.Get<PacketTestProto>().x(0));
+}
+
+TEST(PacketArenaTest, ConsumeMovesDataOutOfArena) {
+  PacketArena arena(1024);
+  Packet packet = arena.MakePacket<std::string>("abc");
+  auto result = packet.Consume<std::string>();
+  MP_ASSERT_OK(result);
+  EXPECT_EQ("abc", *result.value());
+  EXPECT_TRUE(packet.IsEmpty());
+
+  PacketTestProto proto;
+  proto.add_x(6);
+  Packet proto_packet = arena.MakePacket<PacketTestProto>(proto);
+  auto proto_result = proto_packet.Consume<PacketTestProto>();
+  MP_ASSERT_OK(proto_result);
+  EXPECT_EQ(6, proto_result.value()->x(0));
+}
+
+TEST(PacketArenaTest, MakePacketInArenaWithoutArena) {
+  Packet packet = MakePacketInArena<int>(nullptr, 5);
+  EXPECT_EQ(5, packet.Get<int>());
+}
+
+// Outputs its input packets' values as arena packets.
+class ArenaPacketCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).Set<int>();
+    cc->Outputs().Index(0).Set<int>();
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) final {
+    RET_CHECK(cc->GetPacketArena() != nullptr);
+    cc->Outputs().Index(0).AddPacket(
+        MakePacketInArena<int>(cc->GetPacketArena(),
+                               cc->Inputs().Index(0).Get<int>())
+            .At(cc->InputTimestamp()));
+    return absl::OkStatus();
+  }
+};
+REGISTER_CALCULATOR(ArenaPacketCalculator);
+
+TEST(PacketArenaTest, CalculatorsUseGraphArena) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        packet_arena_block_size: 4096
+        node {
+          calculator: "ArenaPacketCalculator"
+          input_stream: "in"
+          output_stream: "out"
+        }
+      )pb");
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("out", &config, &output_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 10; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "in", MakePacket<int>(i).At(Timestamp(i))));
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  ASSERT_EQ(10, output_packets.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, output_packets[i].Get<int>());
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
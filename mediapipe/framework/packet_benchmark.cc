@@ -0,0 +1,111 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmarks for creating, copying and moving Packets. Each benchmark reports the
+// number of heap allocations per packet in the "allocs_per_packet" counter.
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace {
+
+std::atomic<int64_t> num_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace mediapipe {
+namespace {
+
+// Reports the allocations made since "start" per benchmark iteration.
+void SetAllocationsPerPacket(benchmark::State& state, int64_t start) {
+  state.counters["allocs_per_packet"] = benchmark::Counter(
+      static_cast<double>(num_allocations.load() - start) /
+      state.iterations());
+}
+
+void BM_MakePacket(benchmark::State& state) {
+  const int64_t start = num_allocations.load();
+  for (auto _ : state) {
+    Packet packet = MakePacket<int>(1).At(Timestamp(0));
+    benchmark::DoNotOptimize(packet);
+  }
+  SetAllocationsPerPacket(state, start);
+}
+BENCHMARK(BM_MakePacket);
+
+void BM_AdoptPacket(benchmark::State& state) {
+  const int64_t start = num_allocations.load();
+  for (auto _ : state) {
+    Packet packet = Adopt(new int(1)).At(Timestamp(0));
+    benchmark::DoNotOptimize(packet);
+  }
+  SetAllocationsPerPacket(state, start);
+}
+BENCHMARK(BM_AdoptPacket);
+
+void BM_CopyPacket(benchmark::State& state) {
+  Packet packet = MakePacket<int>(1);
+  const int64_t start = num_allocations.load();
+  for (auto _ : state) {
+    Packet copy = packet.At(Timestamp(0));
+    benchmark::DoNotOptimize(copy);
+  }
+  SetAllocationsPerPacket(state, start);
+}
+BENCHMARK(BM_CopyPacket);
+
+void BM_MovePacket(benchmark::State& state) {
+  Packet packet = MakePacket<int>(1);
+  Packet other;
+  const int64_t start = num_allocations.load();
+  for (auto _ : state) {
+    other = std::move(packet);
+    packet = std::move(other);
+    benchmark::DoNotOptimize(packet);
+  }
+  SetAllocationsPerPacket(state, start);
+}
+BENCHMARK(BM_MovePacket);
+
+void BM_CopyPacketConcurrently(benchmark::State& state) {
+  static Packet* packet = new Packet(MakePacket<int>(1));
+  for (auto _ : state) {
+    Packet copy = *packet;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+BENCHMARK(BM_CopyPacketConcurrently)->ThreadRange(1, 8);
+
+}  // namespace
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
@@ -0,0 +1,154 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/packet_generator_cache.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/port/proto_ns.h"
+
+namespace mediapipe {
+
+namespace {
+
+// Returns true if a packet holds a protobuf message.
+bool HoldsProtoMessage(const Packet& packet) {
+  return packet.ValidateAsProtoMessageLite().ok();
+}
+
+// Returns a hash of the value of a packet that is equal for matching packets.
+uint64_t HashPacket(const Packet& packet) {
+  if (packet.ValidateAsType<std::string>().ok()) {
+    return absl::HashOf(packet.Get<std::string>());
+  }
+  if (HoldsProtoMessage(packet)) {
+    return absl::HashOf(packet.GetProtoMessageLite().GetTypeName(),
+                        packet.GetProtoMessageLite().SerializeAsString());
+  }
+  return absl::HashOf(packet_internal::GetHolder(packet));
+}
+
+// Returns true if two input side packets hold the same object or equal values.
+bool SamePacket(const Packet& a, const Packet& b) {
+  if (packet_internal::GetHolder(a) == packet_internal::GetHolder(b)) {
+    return true;
+  }
+  if (a.ValidateAsType<std::string>().ok() &&
+      b.ValidateAsType<std::string>().ok()) {
+    return a.Get<std::string>() == b.Get<std::string>();
+  }
+  if (HoldsProtoMessage(a) && HoldsProtoMessage(b)) {
+    const proto_ns::MessageLite& message_a = a.GetProtoMessageLite();
+    const proto_ns::MessageLite& message_b = b.GetProtoMessageLite();
+    return message_a.GetTypeName() == message_b.GetTypeName() &&
+           message_a.SerializeAsString() == message_b.SerializeAsString();
+  }
+  return false;
+}
+
+// Appends the tags and indexes of a PacketSet to a cache key, and the hashes
+// of its packets if with_values is true.
+void AppendPacketSet(const PacketSet& packets, bool with_values,
+                     std::string* key) {
+  for (const auto& [tag, data] : packets.TagMap()->Mapping()) {
+    for (int index = 0; index < data.count; ++index) {
+      absl::StrAppend(key, tag, ":", index);
+      if (with_values) {
+        absl::StrAppend(key, "=", HashPacket(packets.Get(data.id + index)));
+      }
+      absl::StrAppend(key, ",");
+    }
+  }
+  absl::StrAppend(key, ";");
+}
+
+std::string CacheKey(const std::string& generator,
+                     const PacketGeneratorOptions& options,
+                     const PacketSet& inputs, const PacketSet& outputs) {
+  std::string key = absl::StrCat(generator, ";");
+  AppendPacketSet(inputs, /*with_values=*/true, &key);
+  AppendPacketSet(outputs, /*with_values=*/false, &key);
+  absl::StrAppend(&key, options.SerializeAsString());
+  return key;
+}
+
+}  // namespace
+
+bool PacketGeneratorCache::Lookup(const std::string& generator,
+                                  const PacketGeneratorOptions& options,
+                                  const PacketSet& inputs,
+                                  PacketSet* outputs) {
+  const std::string key = CacheKey(generator, options, inputs, *outputs);
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  Entry& entry = it->second;
+  for (CollectionItemId id = inputs.BeginId(); id < inputs.EndId(); ++id) {
+    if (!SamePacket(entry.inputs[id.value()], inputs.Get(id))) {
+      return false;
+    }
+  }
+  for (CollectionItemId id = outputs->BeginId(); id < outputs->EndId(); ++id) {
+    outputs->Get(id) = entry.outputs[id.value()];
+  }
+  lru_.splice(lru_.begin(), lru_, entry.lru_position);
+  return true;
+}
+
+void PacketGeneratorCache::Insert(const std::string& generator,
+                                  const PacketGeneratorOptions& options,
+                                  const PacketSet& inputs,
+                                  const PacketSet& outputs) {
+  const std::string key = CacheKey(generator, options, inputs, outputs);
+  Entry entry;
+  for (CollectionItemId id = inputs.BeginId(); id < inputs.EndId(); ++id) {
+    entry.inputs.push_back(inputs.Get(id));
+  }
+  for (CollectionItemId id = outputs.BeginId(); id < outputs.EndId(); ++id) {
+    entry.outputs.push_back(outputs.Get(id));
+  }
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.erase(it->second.lru_position);
+    entries_.erase(it);
+  }
+  lru_.push_front(key);
+  entry.lru_position = lru_.begin();
+  entries_.emplace(key, std::move(entry));
+  while (entries_.size() > max_entries_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+int PacketGeneratorCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+void PacketGeneratorCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,109 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PACKET_GENERATOR_CACHE_H_
+#define MEDIAPIPE_FRAMEWORK_PACKET_GENERATOR_CACHE_H_
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/graph_service.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/packet_generator.pb.h"
+#include "mediapipe/framework/packet_set.h"
+
+namespace mediapipe {
+
+// Caches the output side packets of PacketGenerators, so that graph runs and
+// graphs that run a generator with the same options on the same input side
+// packets reuse its outputs instead of generating them again. This makes
+// restarting or recreating graphs with expensive generators, such as ones
+// loading models, much faster.
+//
+// Input side packets match if they hold the same object, or if both hold
+// equal std::strings or equal protobuf messages of the same type. Generators
+// are assumed to be deterministic: a generator whose outputs must differ
+// between runs with the same inputs should not be used with a cache.
+//
+// A cache is attached to graphs through kPacketGeneratorCacheService, before
+// CalculatorGraph::Initialize:
+//
+//   auto cache = std::make_shared<PacketGeneratorCache>();
+//   MP_RETURN_IF_ERROR(
+//       graph.SetServiceObject(kPacketGeneratorCacheService, cache));
+//   MP_RETURN_IF_ERROR(graph.Initialize(config));
+//
+// Graphs with a cache also generate side packets lazily: generators whose
+// outputs are not consumed by any calculator, status handler or other
+// generator of the graph are only run when one of their outputs is requested
+// through CalculatorGraph::GetOutputSidePacket.
+//
+// This class is thread safe.
+class PacketGeneratorCache {
+ public:
+  // Keeps the outputs of up to max_entries generator runs, dropping the
+  // least recently used ones.
+  explicit PacketGeneratorCache(int max_entries = kDefaultMaxEntries)
+      : max_entries_(max_entries) {}
+
+  // Copies the cached outputs of the generator into outputs, and returns
+  // true, if the generator was run with the same options, input side packets
+  // and output tags.
+  bool Lookup(const std::string& generator,
+              const PacketGeneratorOptions& options, const PacketSet& inputs,
+              PacketSet* outputs) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Stores the outputs of a generator run.
+  void Insert(const std::string& generator,
+              const PacketGeneratorOptions& options, const PacketSet& inputs,
+              const PacketSet& outputs) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the number of cached generator runs.
+  int size() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops all cached outputs.
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  static constexpr int kDefaultMaxEntries = 32;
+
+  struct Entry {
+    // Kept to compare input side packets, and so that the objects they hold
+    // are not replaced by others at the same address.
+    std::vector<Packet> inputs;
+    std::vector<Packet> outputs;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  const int max_entries_;
+  mutable absl::Mutex mutex_;
+  std::map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // Keys of entries_, the most recently used first.
+  std::list<std::string> lru_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Shares a PacketGeneratorCache between graphs. Graphs without it do not
+// cache generator outputs.
+inline constexpr GraphService<PacketGeneratorCache>
+    kPacketGeneratorCacheService(
+        "PacketGeneratorCache",
+        GraphServiceBase::kDisallowDefaultInitialization);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PACKET_GENERATOR_CACHE_H_
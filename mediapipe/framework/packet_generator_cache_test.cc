@@ -0,0 +1,110 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/packet_generator_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/packet_generator.pb.h"
+#include "mediapipe/framework/packet_set.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/tool/tag_map_helper.h"
+
+namespace mediapipe {
+namespace {
+
+class PacketGeneratorCacheTest : public ::testing::Test {
+ protected:
+  // PacketSets can't be copied, so they are returned on the heap.
+  std::unique_ptr<PacketSet> Inputs(Packet name) {
+    auto inputs = std::make_unique<PacketSet>(
+        tool::CreateTagMap({"NAME:name"}).value());
+    inputs->Tag("NAME") = std::move(name);
+    return inputs;
+  }
+
+  std::unique_ptr<PacketSet> Outputs() {
+    return std::make_unique<PacketSet>(
+        tool::CreateTagMap({"GREETING:greeting"}).value());
+  }
+
+  PacketGeneratorOptions options_;
+};
+
+TEST_F(PacketGeneratorCacheTest, MatchesEqualStrings) {
+  PacketGeneratorCache cache;
+  std::unique_ptr<PacketSet> outputs = Outputs();
+  EXPECT_FALSE(cache.Lookup("Generator", options_,
+                            *Inputs(MakePacket<std::string>("world")),
+                            outputs.get()));
+  outputs->Tag("GREETING") = MakePacket<std::string>("hello world");
+  cache.Insert("Generator", options_, *Inputs(MakePacket<std::string>("world")),
+               *outputs);
+
+  std::unique_ptr<PacketSet> cached = Outputs();
+  EXPECT_TRUE(cache.Lookup("Generator", options_,
+                           *Inputs(MakePacket<std::string>("world")),
+                           cached.get()));
+  EXPECT_EQ(cached->Tag("GREETING").Get<std::string>(), "hello world");
+  EXPECT_FALSE(cache.Lookup("Generator", options_,
+                            *Inputs(MakePacket<std::string>("there")),
+                            cached.get()));
+  EXPECT_FALSE(cache.Lookup("OtherGenerator", options_,
+                            *Inputs(MakePacket<std::string>("world")),
+                            cached.get()));
+}
+
+TEST_F(PacketGeneratorCacheTest, MatchesOtherTypesByObject) {
+  PacketGeneratorCache cache;
+  Packet name = MakePacket<int>(1);
+  std::unique_ptr<PacketSet> outputs = Outputs();
+  outputs->Tag("GREETING") = MakePacket<std::string>("hello 1");
+  cache.Insert("Generator", options_, *Inputs(name), *outputs);
+
+  std::unique_ptr<PacketSet> cached = Outputs();
+  EXPECT_TRUE(cache.Lookup("Generator", options_, *Inputs(name), cached.get()));
+  EXPECT_FALSE(cache.Lookup("Generator", options_,
+                            *Inputs(MakePacket<int>(1)), cached.get()));
+}
+
+TEST_F(PacketGeneratorCacheTest, DropsLeastRecentlyUsedEntries) {
+  PacketGeneratorCache cache(/*max_entries=*/2);
+  std::unique_ptr<PacketSet> outputs = Outputs();
+  outputs->Tag("GREETING") = MakePacket<std::string>("hello");
+  for (const char* name : {"a", "b"}) {
+    cache.Insert("Generator", options_, *Inputs(MakePacket<std::string>(name)),
+                 *outputs);
+  }
+  std::unique_ptr<PacketSet> cached = Outputs();
+  EXPECT_TRUE(cache.Lookup("Generator", options_,
+                           *Inputs(MakePacket<std::string>("a")),
+                           cached.get()));
+  cache.Insert("Generator", options_, *Inputs(MakePacket<std::string>("c")),
+               *outputs);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_TRUE(cache.Lookup("Generator", options_,
+                           *Inputs(MakePacket<std::string>("a")),
+                           cached.get()));
+  EXPECT_FALSE(cache.Lookup("Generator", options_,
+                            *Inputs(MakePacket<std::string>("b")),
+                            cached.get()));
+
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0);
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -14,9 +14,12 @@
 
 #include "mediapipe/framework/packet_generator_graph.h"
 
+#include <algorithm>
 #include <deque>
 #include <functional>
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
 
 #include "absl/strings/str_cat.h"
@@ -25,6 +28,7 @@
 #include "mediapipe/framework/delegating_executor.h"
 #include "mediapipe/framework/executor.h"
 #include "mediapipe/framework/packet_generator.h"
+#include "mediapipe/framework/packet_generator_cache.h"
 #include "mediapipe/framework/packet_type.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/canonical_errors.h"
@@ -86,16 +90,27 @@ absl::Status CreateInputsForGenerator(
 }
 
 // Generate the packets from a PacketGenerator, place them in
-// output_side_packet_set, and validate their types.
+// output_side_packet_set, and validate their types.  If cache is not null,
+// the packets are taken from the cache when possible, and added to it
+// otherwise.
 absl::Status Generate(const ValidatedGraphConfig& validated_graph,
                       int generator_index,
                       const PacketSet& input_side_packet_set,
+                      PacketGeneratorCache* cache,
                       PacketSet* output_side_packet_set) {
   const NodeTypeInfo& node_type_info =
       validated_graph.GeneratorInfos()[generator_index];
   const PacketGeneratorConfig& generator_config =
       validated_graph.Config().packet_generator(generator_index);
   const auto& generator_name = generator_config.packet_generator();
+  const std::string cache_name =
+      cache ? absl::StrCat(validated_graph.Package(), "::", generator_name)
+            : "";
+  if (cache && cache->Lookup(cache_name, generator_config.options(),
+                             input_side_packet_set, output_side_packet_set)) {
+    VLOG(1) << "Reusing cached outputs of " << generator_name;
+    return absl::OkStatus();
+  }
 
   ASSIGN_OR_RETURN(
       auto static_access,
@@ -113,6 +128,10 @@ absl::Status Generate(const ValidatedGraphConfig& validated_graph,
           .SetPrepend()
       << generator_name
       << "::Generate() output packets were of incorrect type: ";
+  if (cache) {
+    cache->Insert(cache_name, generator_config.options(),
+                  input_side_packet_set, *output_side_packet_set);
+  }
   return absl::OkStatus();
 }
 
@@ -124,10 +143,13 @@ class GeneratorScheduler {
   // "initial" must be set to true for the first pass and false for subsequent
   // passes. If "initial" is false, non_base_generators contains the non-base
   // PacketGenerators (those not run at initialize time due to missing
-  // dependencies).
+  // dependencies).  Deferred generators are never scheduled.  If "cache" is
+  // not null, generator outputs are taken from it when possible.
   GeneratorScheduler(const ValidatedGraphConfig* validated_graph,
                      mediapipe::Executor* executor,
-                     const std::vector<int>& non_base_generators, bool initial);
+                     const std::vector<int>& non_base_generators,
+                     const std::vector<bool>& deferred_generators,
+                     PacketGeneratorCache* cache, bool initial);
 
   // Run a PacketGenerator on a given executor on the provided input
   // side packets.  After running the generator, schedule any generators
@@ -162,6 +184,7 @@ class GeneratorScheduler {
 
   const ValidatedGraphConfig* const validated_graph_;
   mediapipe::Executor* executor_;
+  PacketGeneratorCache* const cache_;
 
   mutable absl::Mutex mutex_;
   // The number of pending tasks.
@@ -183,9 +206,12 @@ class GeneratorScheduler {
 
 GeneratorScheduler::GeneratorScheduler(
     const ValidatedGraphConfig* validated_graph, mediapipe::Executor* executor,
-    const std::vector<int>& non_base_generators, bool initial)
+    const std::vector<int>& non_base_generators,
+    const std::vector<bool>& deferred_generators, PacketGeneratorCache* cache,
+    bool initial)
     : validated_graph_(validated_graph),
       executor_(executor),
+      cache_(cache),
       scheduled_generators_(validated_graph_->Config().packet_generator_size(),
                             !initial) {
   if (!executor_) {
@@ -201,6 +227,13 @@ GeneratorScheduler::GeneratorScheduler(
     for (int generator_index : non_base_generators) {
       scheduled_generators_[generator_index] = false;
     }
+  } else {
+    // Deferred generators are neither base nor non-base generators.
+    for (int i = 0; i < deferred_generators.size(); ++i) {
+      if (deferred_generators[i]) {
+        scheduled_generators_[i] = true;
+      }
+    }
   }
 }
 
@@ -221,7 +254,7 @@ void GeneratorScheduler::GenerateAndScheduleNext(
   VLOG(1) << "Running generator " << generator_index;
   absl::Status status =
       Generate(*validated_graph_, generator_index, *input_side_packet_set,
-               &output_side_packet_set);
+               cache_, &output_side_packet_set);
 
   {
     absl::MutexLock lock(&mutex_);
@@ -364,6 +397,9 @@ absl::Status PacketGeneratorGraph::Initialize(
   base_packets_ = input_side_packets;
   MP_RETURN_IF_ERROR(
       validated_graph_->CanAcceptSidePackets(input_side_packets));
+  if (cache_) {
+    FindDeferredGenerators();
+  }
   return ExecuteGenerators(&base_packets_, &non_base_generators_,
                            /*initial=*/true);
 }
@@ -407,7 +443,8 @@ absl::Status PacketGeneratorGraph::ExecuteGenerators(
   // The ValidatedGraphConfig object is expected to already have sorted
   // generators in topological order.
   GeneratorScheduler scheduler(validated_graph_, executor_,
-                               non_base_generators_, initial);
+                               non_base_generators_, deferred_generators_,
+                               cache_.get(), initial);
   scheduler.ScheduleAllRunnableGenerators(output_side_packets);
   // Do not return early if scheduler encountered an error.  The lambdas
   // in the executor must run in order to free resources.
@@ -418,4 +455,96 @@ absl::Status PacketGeneratorGraph::ExecuteGenerators(
   return scheduler.GetNonScheduledGenerators(non_scheduled_generators);
 }
 
+void PacketGeneratorGraph::FindDeferredGenerators() {
+  const auto& generators = validated_graph_->GeneratorInfos();
+  // The side packets consumed by calculators and status handlers, to which
+  // the inputs of each generator that is not deferred are added.
+  std::set<std::string> consumed;
+  std::vector<std::vector<std::string>> generator_inputs(generators.size());
+  for (const EdgeInfo& edge : validated_graph_->InputSidePacketInfos()) {
+    if (edge.parent_node.type == NodeTypeInfo::NodeType::PACKET_GENERATOR) {
+      generator_inputs[edge.parent_node.index].push_back(edge.name);
+    } else {
+      consumed.insert(edge.name);
+    }
+  }
+  // Generators depending on calculator outputs run as graph nodes instead.
+  std::set<std::string> calculator_outputs;
+  for (const EdgeInfo& edge : validated_graph_->OutputSidePacketInfos()) {
+    if (edge.parent_node.type == NodeTypeInfo::NodeType::CALCULATOR) {
+      calculator_outputs.insert(edge.name);
+    }
+  }
+  deferred_generators_.assign(generators.size(), true);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int i = 0; i < generators.size(); ++i) {
+      if (!deferred_generators_[i]) continue;
+      // Generators without outputs run for their side effects.
+      bool needed =
+          generators[i].OutputSidePacketTypes().TagMap()->Names().empty();
+      for (const std::string& name :
+           generators[i].OutputSidePacketTypes().TagMap()->Names()) {
+        needed = needed || consumed.count(name) > 0;
+      }
+      for (const std::string& name : generator_inputs[i]) {
+        needed = needed || calculator_outputs.count(name) > 0;
+      }
+      if (needed) {
+        deferred_generators_[i] = false;
+        consumed.insert(generator_inputs[i].begin(), generator_inputs[i].end());
+        changed = true;
+      }
+    }
+  }
+}
+
+absl::StatusOr<Packet> PacketGeneratorGraph::GenerateDeferredSidePacket(
+    const std::string& name,
+    const std::map<std::string, Packet>& side_packets) const {
+  const auto& generators = validated_graph_->GeneratorInfos();
+  std::map<std::string, Packet> packets = side_packets;
+  // Runs the deferred generator of a missing side packet after producing its
+  // inputs.
+  std::function<absl::Status(const std::string&)> produce =
+      [&](const std::string& packet_name) -> absl::Status {
+    if (packets.count(packet_name) > 0) {
+      return absl::OkStatus();
+    }
+    int index = -1;
+    for (int i = 0; i < deferred_generators_.size() && index < 0; ++i) {
+      const auto& names = generators[i].OutputSidePacketTypes().TagMap();
+      if (deferred_generators_[i] &&
+          std::find(names->Names().begin(), names->Names().end(),
+                    packet_name) != names->Names().end()) {
+        index = i;
+      }
+    }
+    if (index < 0) {
+      return absl::UnavailableError(absl::StrCat(
+          "The side packet \"", packet_name, "\" is unavailable."));
+    }
+    const NodeTypeInfo& info = generators[index];
+    for (const std::string& input :
+         info.InputSidePacketTypes().TagMap()->Names()) {
+      MP_RETURN_IF_ERROR(produce(input));
+    }
+    PacketSet inputs(info.InputSidePacketTypes().TagMap());
+    bool unrunnable = false;
+    MP_RETURN_IF_ERROR(CreateInputsForGenerator(*validated_graph_, index,
+                                                packets, &inputs, &unrunnable));
+    RET_CHECK(!unrunnable);
+    PacketSet outputs(info.OutputSidePacketTypes().TagMap());
+    MP_RETURN_IF_ERROR(Generate(*validated_graph_, index, inputs, cache_.get(),
+                                &outputs));
+    for (CollectionItemId id = outputs.BeginId(); id < outputs.EndId(); ++id) {
+      packets.emplace(outputs.TagMap()->Names()[id.value()], outputs.Get(id));
+    }
+    return absl::OkStatus();
+  };
+  MP_RETURN_IF_ERROR(produce(name));
+  return packets[name];
+}
+
 }  // namespace mediapipe
@@ -18,13 +18,16 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/macros.h"
+#include "absl/status/statusor.h"
 #include "mediapipe/framework/executor.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/packet_generator.pb.h"
+#include "mediapipe/framework/packet_generator_cache.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/proto_ns.h"
 #include "mediapipe/framework/port/status.h"
@@ -43,6 +46,10 @@ namespace mediapipe {
 // output side packets.  Initialize should only be called once.
 // RunGraphSetup may be called any number of times.
 //
+// With a PacketGeneratorCache, generator outputs are reused from the cache
+// when possible, and generators whose outputs are not consumed within the
+// graph are deferred until GenerateDeferredSidePacket requests their outputs.
+//
 // This class is thread compatible.
 class PacketGeneratorGraph {
  public:
@@ -57,6 +64,11 @@ class PacketGeneratorGraph {
   // See b/17412838.
   virtual ~PacketGeneratorGraph();
 
+  // Sets the cache of generator outputs.  Must be called before Initialize.
+  void SetCache(std::shared_ptr<PacketGeneratorCache> cache) {
+    cache_ = std::move(cache);
+  }
+
   // Initialize the PacketGeneratorGraph with the validated graph config
   // and executor to use.  If executor is nullptr, then the application
   // thread is used.
@@ -80,6 +92,13 @@ class PacketGeneratorGraph {
       std::map<std::string, Packet>* output_side_packets,
       std::vector<int>* non_scheduled_generators = nullptr) const;
 
+  // Runs the deferred generators needed to produce the named side packet from
+  // side_packets, and returns it.  Returns an unavailable error if it is not
+  // produced by a deferred generator, or if an input side packet is missing.
+  absl::StatusOr<Packet> GenerateDeferredSidePacket(
+      const std::string& name,
+      const std::map<std::string, Packet>& side_packets) const;
+
   // Get the base packets: the packets which are produced when Initialize
   // is called.
   virtual const std::map<std::string, Packet>& BasePackets() const {
@@ -102,6 +121,10 @@ class PacketGeneratorGraph {
       std::map<std::string, Packet>* output_side_packets,
       std::vector<int>* non_scheduled_generators, bool initial) const;
 
+  // Marks the generators whose outputs are not consumed within the graph as
+  // deferred.
+  void FindDeferredGenerators();
+
   // The validated graph configuration.  We do not own this but it must
   // outlive this object.
   const ValidatedGraphConfig* validated_graph_ = nullptr;
@@ -121,6 +144,12 @@ class PacketGeneratorGraph {
   // executed in Initialize.  We store the indexes into their positions
   // in the ValidatedGraphConfig object.
   std::vector<int> non_base_generators_;
+
+  // The cache of generator outputs, or null.
+  std::shared_ptr<PacketGeneratorCache> cache_;
+  // deferred_generators_[i] is true if the generator with index i only runs
+  // in GenerateDeferredSidePacket.  Empty without a cache.
+  std::vector<bool> deferred_generators_;
 };
 
 }  // namespace mediapipe
@@ -328,6 +328,36 @@ TEST(PacketTest, TestPacketConsume) {
   EXPECT_TRUE(packet3.IsEmpty());
 }
 
+TEST(PacketTest, TestConsumeInlinePayload) {
+  Packet packet = MakePacket<std::vector<int>>(100, 7);
+  const int* data = packet.Get<std::vector<int>>().data();
+  absl::StatusOr<std::unique_ptr<std::vector<int>>> result =
+      packet.Consume<std::vector<int>>();
+  MP_ASSERT_OK(result);
+  // The vector is moved out of the holder, so its buffer is not copied.
+  EXPECT_EQ(data, result.value()->data());
+  EXPECT_EQ(100, result.value()->size());
+  EXPECT_TRUE(packet.IsEmpty());
+}
+
+struct Immovable {
+  explicit Immovable(int value) : value(value) {}
+  Immovable(const Immovable&) = delete;
+  Immovable& operator=(const Immovable&) = delete;
+  int value;
+};
+
+TEST(PacketTest, TestConsumeImmovablePayload) {
+  Packet packet = MakePacket<Immovable>(5);
+  const Immovable* data = &packet.Get<Immovable>();
+  absl::StatusOr<std::unique_ptr<Immovable>> result =
+      packet.Consume<Immovable>();
+  MP_ASSERT_OK(result);
+  EXPECT_EQ(data, result.value().get());
+  EXPECT_EQ(5, result.value()->value);
+  EXPECT_TRUE(packet.IsEmpty());
+}
+
 TEST(PacketTest, TestPacketConsumeOrCopy) {
   Packet packet1 = MakePacket<int>(33);
   Packet packet_copy = packet1;
@@ -412,6 +442,19 @@ TEST(PacketTest, TestForeignHolderConsumeOrCopy) {
   EXPECT_EQ(33, *result2.value());
 }
 
+TEST(PacketTest, TestForeignHolderCleanup) {
+  std::unique_ptr<int> data(new int(42));
+  int num_cleanups = 0;
+  Packet packet =
+      PointToForeign(data.get(), [&num_cleanups]() { ++num_cleanups; });
+  Packet packet_copy = packet;
+  packet = Packet();
+  EXPECT_EQ(num_cleanups, 0);
+  EXPECT_EQ(42, packet_copy.Get<int>());
+  packet_copy = Packet();
+  EXPECT_EQ(num_cleanups, 1);
+}
+
 TEST(PacketTest, TestConsumeBoundedArray) {
   Packet packet1 = MakePacket<int[3]>(10, 20, 30);
   Packet packet_copy = packet1;
@@ -517,5 +560,20 @@ TEST(PacketTest, SharedPtrWithPacketOwnership) {
   EXPECT_EQ(exist, false);
 }
 
+TEST(PacketTest, GetPayloadSize) {
+  EXPECT_EQ(Packet().GetPayloadSize(), 0);
+  EXPECT_EQ(MakePacket<int64_t>(5).GetPayloadSize(), sizeof(int64_t));
+
+  std::vector<float> floats;
+  floats.reserve(100);
+  EXPECT_EQ(MakePacket<std::vector<float>>(floats).GetPayloadSize(),
+            sizeof(floats) + 100 * sizeof(float));
+
+  std::vector<std::string> strings(2);
+  strings[0].reserve(1000);
+  EXPECT_GE(MakePacket<std::vector<std::string>>(strings).GetPayloadSize(),
+            sizeof(strings) + 2 * sizeof(std::string) + 1000);
+}
+
 }  // namespace
 }  // namespace mediapipe
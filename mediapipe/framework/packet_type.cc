@@ -203,6 +203,20 @@ static bool HaveCommonType(absl::Span<const TypeId> types1,
   return false;
 }
 
+bool PacketType::AcceptsAllOf(const PacketType& other) const {
+  if (!IsInitialized() || !other.IsInitialized()) {
+    return false;
+  }
+  const PacketType* type = GetSameAs();
+  const PacketType* other_type = other.GetSameAs();
+  if (type->IsAny()) {
+    return true;
+  }
+  auto* type_id = absl::get_if<TypeId>(&type->type_spec_);
+  auto* other_type_id = absl::get_if<TypeId>(&other_type->type_spec_);
+  return type_id && other_type_id && *type_id == *other_type_id;
+}
+
 absl::Status PacketType::Validate(const Packet& packet) const {
   if (!IsInitialized()) {
     return absl::InvalidArgumentError(
@@ -109,6 +109,12 @@ class PacketType {
   // Returns OK if the packet contains an object of the appropriate type.
   absl::Status Validate(const Packet& packet) const;
 
+  // Returns true if every packet that passes Validate() for `other` also
+  // passes Validate() for this type, so that packets already validated for
+  // `other` need not be validated again. This holds when this type is Any, or
+  // when both types resolve to the same exact type.
+  bool AcceptsAllOf(const PacketType& other) const;
+
   // Returns a pointer to the Registered type name, or nullptr if the type
   // is not registered.  Do not use this for validation, use Validate()
   // instead.
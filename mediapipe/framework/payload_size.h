@@ -0,0 +1,81 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PAYLOAD_SIZE_H_
+#define MEDIAPIPE_FRAMEWORK_PAYLOAD_SIZE_H_
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mediapipe {
+
+// Estimates the number of bytes of memory held by a packet payload of type T,
+// for memory accounting of packet queues. See Packet::GetPayloadSize().
+//
+// The default estimate is sizeof(T), which misses any heap memory owned by
+// the payload. Types that own large buffers specialize PayloadSize in their
+// own header, which must be included wherever packets of the type are made:
+//
+//   template <>
+//   struct PayloadSize<MyImage> {
+//     static size_t Get(const MyImage& image) {
+//       return sizeof(MyImage) + image.data_size();
+//     }
+//   };
+//
+// The estimate should be cheap to compute, since it is computed for every
+// queued packet when memory accounting is enabled.
+template <typename T, typename Enable = void>
+struct PayloadSize {
+  static size_t Get(const T& value) {
+    if constexpr (std::is_array<T>::value && std::extent<T>::value == 0) {
+      // The size of an unbounded array is unknown.
+      return 0;
+    } else {
+      return sizeof(T);
+    }
+  }
+};
+
+template <typename T>
+struct PayloadSize<const T> : PayloadSize<T> {};
+
+template <typename CharT, typename Traits, typename Allocator>
+struct PayloadSize<std::basic_string<CharT, Traits, Allocator>> {
+  static size_t Get(const std::basic_string<CharT, Traits, Allocator>& value) {
+    return sizeof(value) + value.capacity() * sizeof(CharT);
+  }
+};
+
+// Counts the capacity of a vector, and the memory owned by each element.
+// Elements of trivially copyable types are not visited, so that the size of
+// a large vector of numbers is computed in constant time.
+template <typename T, typename Allocator>
+struct PayloadSize<std::vector<T, Allocator>> {
+  static size_t Get(const std::vector<T, Allocator>& value) {
+    size_t result = sizeof(value) + value.capacity() * sizeof(T);
+    if constexpr (!std::is_trivially_copyable<T>::value) {
+      for (const auto& element : value) {
+        result += PayloadSize<T>::Get(element) - sizeof(T);
+      }
+    }
+    return result;
+  }
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PAYLOAD_SIZE_H_
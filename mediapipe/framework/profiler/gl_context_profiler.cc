@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -21,5 +23,148 @@
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "mediapipe/framework/profiler/graph_profiler.h"
+#include "mediapipe/gpu/gl_base.h"
+#include "mediapipe/gpu/gl_timer_query.h"
 
-namespace mediapipe {}  // namespace mediapipe
+namespace mediapipe {
+
+void GlContextProfiler::MarkTimestamp(int node_id, Timestamp input_timestamp,
+                                      bool is_finish) {
+  if (!checked_timing_supported_) {
+    timing_measurement_supported_ = Initialize();
+    checked_timing_supported_ = true;
+  }
+  if (!timing_measurement_supported_) return;
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+  RetireReadyGlTimings();
+  auto info = absl::make_unique<GlTimingInfo>();
+  const GlTimerQueryFunctions* gl = GetGlTimerQueryFunctions();
+  gl->glGenQueriesEXT(1, &info->query);
+  gl->glQueryCounterEXT(info->query, GL_TIMESTAMP_EXT);
+  info->trace_event = TraceEvent(TraceEvent::GPU_TASK)
+                          .set_node_id(node_id)
+                          .set_input_ts(input_timestamp)
+                          .set_is_finish(is_finish);
+  pending_gl_times_.push_back(std::move(info));
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+}
+
+void GlContextProfiler::LogAllTimestamps() {
+  if (!timing_measurement_supported_) return;
+  RetireReadyGlTimings(/*wait=*/true);
+}
+
+bool GlContextProfiler::Initialize() {
+  if (!HasGlTimerQuery()) {
+    ABSL_LOG(INFO) << "GPU timing is not supported: "
+                      "GL_EXT_disjoint_timer_query is unavailable.";
+    return false;
+  }
+  timing_measurement_supported_ = true;
+  CalibrateTimer();
+  return timing_measurement_supported_;
+}
+
+absl::Time GlContextProfiler::TimeNow() {
+  return profiling_context_->GetClock()->TimeNow();
+}
+
+void GlContextProfiler::CalibrateTimer() {
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+  const GlTimerQueryFunctions* gl = GetGlTimerQueryFunctions();
+  absl::Time start_time = TimeNow();
+  LogCalibrationEvent(/*started=*/true, start_time);
+  GLint64 gpu_time = 0;
+  absl::Time cpu_time;
+  if (gl->glGetInteger64vEXT) {
+    gl->glGetInteger64vEXT(GL_TIMESTAMP_EXT, &gpu_time);
+    cpu_time = TimeNow();
+  }
+  if (gpu_time == 0) {
+    // Some drivers cannot read the GPU clock synchronously. Time a query on an
+    // idle GPU instead.
+    GLuint query = 0;
+    gl->glGenQueriesEXT(1, &query);
+    gl->glQueryCounterEXT(query, GL_TIMESTAMP_EXT);
+    glFinish();
+    cpu_time = TimeNow();
+    GLuint64 query_time = 0;
+    gl->glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT_EXT, &query_time);
+    gl->glDeleteQueriesEXT(1, &query);
+    gpu_time = static_cast<GLint64>(query_time);
+  }
+  // Reading the disjoint flag resets it, so that only later disjoint
+  // operations invalidate the calibration.
+  GLint disjoint = 0;
+  glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+  if (gpu_time == 0 || disjoint) {
+    ABSL_LOG(WARNING) << "Failed to calibrate the GPU timer.";
+    timing_measurement_supported_ = false;
+  }
+  gpu_time_offset_ =
+      absl::Nanoseconds(gpu_time) - (cpu_time - absl::UnixEpoch());
+  LogCalibrationEvent(/*started=*/false, cpu_time);
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+}
+
+void GlContextProfiler::LogCalibrationEvent(bool started, absl::Time time) {
+  profiling_context_->LogEvent(TraceEvent(TraceEvent::GPU_CALIBRATION)
+                                   .set_event_time(time)
+                                   .set_is_finish(!started));
+}
+
+void GlContextProfiler::RetireReadyGlTimings(bool wait) {
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+  if (pending_gl_times_.empty()) return;
+  // A disjoint operation, such as a GPU frequency change, makes the pending
+  // timestamps meaningless.
+  GLint disjoint = 0;
+  glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+  if (disjoint) {
+    DiscardPendingGlTimings();
+    CalibrateTimer();
+    return;
+  }
+  while (!pending_gl_times_.empty()) {
+    absl::optional<TraceEvent> event =
+        GetTimeFromQuery(*pending_gl_times_.front(), wait);
+    if (!event) break;
+    profiling_context_->LogEvent(*event);
+    GetGlTimerQueryFunctions()->glDeleteQueriesEXT(
+        1, &pending_gl_times_.front()->query);
+    pending_gl_times_.pop_front();
+  }
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+}
+
+absl::optional<TraceEvent> GlContextProfiler::GetTimeFromQuery(
+    const GlTimingInfo& info, bool wait) {
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+  const GlTimerQueryFunctions* gl = GetGlTimerQueryFunctions();
+  if (!wait) {
+    GLuint available = GL_FALSE;
+    gl->glGetQueryObjectuivEXT(info.query, GL_QUERY_RESULT_AVAILABLE_EXT,
+                               &available);
+    if (!available) return absl::nullopt;
+  }
+  GLuint64 gpu_time = 0;
+  gl->glGetQueryObjectui64vEXT(info.query, GL_QUERY_RESULT_EXT, &gpu_time);
+  return TraceEvent(info.trace_event)
+      .set_event_time(absl::UnixEpoch() +
+                      absl::Nanoseconds(static_cast<int64_t>(gpu_time)) -
+                      gpu_time_offset_);
+#else
+  return absl::nullopt;
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+}
+
+void GlContextProfiler::DiscardPendingGlTimings() {
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+  for (auto& info : pending_gl_times_) {
+    GetGlTimerQueryFunctions()->glDeleteQueriesEXT(1, &info->query);
+  }
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+  pending_gl_times_.clear();
+}
+
+}  // namespace mediapipe
@@ -16,6 +16,9 @@
 
 #include <fstream>
 #include <list>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -120,6 +123,25 @@ PacketInfo* GetPacketInfo(PacketInfoMap* map, const PacketId& packet_id) {
   return nullptr;
 }
 
+// Returns the StorageConversionProfile of a calculator for a pair of storage
+// types, adding it if needed.
+StorageConversionProfile* FindStorageConversion(
+    absl::string_view source, absl::string_view target,
+    CalculatorProfile* calculator_profile) {
+  for (StorageConversionProfile& conversion :
+       *calculator_profile->mutable_storage_conversions()) {
+    if (conversion.source_storage() == source &&
+        conversion.target_storage() == target) {
+      return &conversion;
+    }
+  }
+  StorageConversionProfile* conversion =
+      calculator_profile->add_storage_conversions();
+  conversion->set_source_storage(std::string(source));
+  conversion->set_target_storage(std::string(target));
+  return conversion;
+}
+
 }  // namespace
 
 // Builds GraphProfile records from profiler timing data.
@@ -177,6 +199,10 @@ void GraphProfiler::Initialize(
     profile.set_name(node_name);
     InitializeTimeHistogram(interval_size_usec, num_intervals,
                             profile.mutable_process_runtime());
+    if (profiler_config_.enable_thread_cpu_time()) {
+      InitializeTimeHistogram(interval_size_usec, num_intervals,
+                              profile.mutable_process_cpu_time());
+    }
     if (profiler_config_.enable_stream_latency()) {
       InitializeTimeHistogram(interval_size_usec, num_intervals,
                               profile.mutable_process_input_latency());
@@ -193,6 +219,30 @@ void GraphProfiler::Initialize(
     auto iter = calculator_profiles_.insert({node_name, profile});
     ABSL_CHECK(iter.second) << absl::Substitute(
         "Calculator \"$0\" has already been added.", node_name);
+    profile_indexes_[node_name] = initial_profiles_.size();
+    initial_profiles_.push_back(std::move(profile));
+  }
+  if (profiler_config_.enable_memory_accounting()) {
+    for (int i = 0; i < validated_graph_config.InputStreamInfos().size(); ++i) {
+      stream_memory_gauges_.push_back(std::make_unique<StreamMemoryGauge>());
+    }
+  }
+  InitializeLatencyMeasurements(validated_graph_config, interval_size_usec,
+                                num_intervals);
+  allowed_storage_conversion_nodes_.insert(
+      profiler_config_.allowed_storage_conversion_node().begin(),
+      profiler_config_.allowed_storage_conversion_node().end());
+  if (packet_tracer_ && !profiler_config_.trace_perfetto_path().empty()) {
+    std::vector<std::string> calculator_names;
+    for (int node_id = 0;
+         node_id < validated_graph_config.CalculatorInfos().size(); ++node_id) {
+      calculator_names.push_back(
+          tool::CanonicalNodeName(validated_graph_config.Config(), node_id));
+    }
+    perfetto_writer_ =
+        std::make_unique<PerfettoTraceWriter>(std::move(calculator_names));
+    std::ofstream(profiler_config_.trace_perfetto_path(),
+                  std::ofstream::out | std::ofstream::trunc);
   }
   profile_builder_ = std::make_unique<GraphProfileBuilder>(this);
   graph_id_ = ++next_instance_id_;
@@ -228,15 +278,22 @@ void GraphProfiler::Reset() {
   absl::WriterMutexLock lock(&profiler_mutex_);
   for (auto iter = calculator_profiles_.begin();
        iter != calculator_profiles_.end(); ++iter) {
-    CalculatorProfile* calculator_profile = &iter->second;
-    ResetTimeHistogram(calculator_profile->mutable_process_runtime());
-    ResetTimeHistogram(calculator_profile->mutable_process_input_latency());
-    ResetTimeHistogram(calculator_profile->mutable_process_output_latency());
-    for (auto& input_stream_profile :
-         *(calculator_profile->mutable_input_stream_profiles())) {
-      ResetTimeHistogram(input_stream_profile.mutable_latency());
+    ResetCalculatorProfile(&iter->second);
+  }
+  absl::MutexLock threads_lock(&thread_profiles_mutex_);
+  for (auto& entry : thread_profiles_) {
+    ThreadProfiles* thread_profiles = entry.second.get();
+    absl::MutexLock thread_lock(&thread_profiles->mutex);
+    for (CalculatorProfile& calculator_profile : thread_profiles->profiles) {
+      ResetCalculatorProfile(&calculator_profile);
     }
   }
+  for (auto& gauge : stream_memory_gauges_) {
+    gauge->ResetPeak();
+  }
+  for (auto& measurement : latency_measurements_) {
+    measurement.histogram->Reset();
+  }
 }
 
 // Begins profiling for a single graph run.
@@ -304,7 +361,6 @@ void GraphProfiler::LogEvent(const TraceEvent& event) {
 }
 
 void GraphProfiler::AddPacketInfo(const TraceEvent& packet_info) {
-  absl::ReaderMutexLock lock(&profiler_mutex_);
   if (!is_profiling_) {
     return;
   }
@@ -336,12 +392,181 @@ absl::Status GraphProfiler::GetCalculatorProfiles(
   absl::ReaderMutexLock lock(&profiler_mutex_);
   RET_CHECK(is_initialized_)
       << "GetCalculatorProfiles can only be called after Initialize()";
+  absl::MutexLock threads_lock(&thread_profiles_mutex_);
   for (auto& entry : calculator_profiles_) {
-    profiles->push_back(entry.second);
+    CalculatorProfile profile = entry.second;
+    int index = profile_indexes_.at(entry.first);
+    for (auto& thread_entry : thread_profiles_) {
+      ThreadProfiles* thread_profiles = thread_entry.second.get();
+      absl::MutexLock thread_lock(&thread_profiles->mutex);
+      MergeCalculatorProfile(thread_profiles->profiles[index], &profile);
+    }
+    profiles->push_back(std::move(profile));
+  }
+  return absl::OkStatus();
+}
+
+StreamMemoryGauge* GraphProfiler::GetStreamMemoryGauge(int input_stream_index) {
+  return input_stream_index < stream_memory_gauges_.size()
+             ? stream_memory_gauges_[input_stream_index].get()
+             : nullptr;
+}
+
+absl::Status GraphProfiler::GetStreamMemoryProfiles(
+    std::vector<StreamMemoryProfile>* profiles) const {
+  absl::ReaderMutexLock lock(&profiler_mutex_);
+  RET_CHECK(is_initialized_)
+      << "GetStreamMemoryProfiles can only be called after Initialize()";
+  for (int i = 0; i < stream_memory_gauges_.size(); ++i) {
+    const EdgeInfo& edge_info = validated_graph_->InputStreamInfos()[i];
+    StreamMemoryProfile profile;
+    profile.set_calculator_name(tool::CanonicalNodeName(
+        validated_graph_->Config(), edge_info.parent_node.index));
+    profile.set_stream_name(edge_info.name);
+    profile.set_bytes_in_flight(stream_memory_gauges_[i]->bytes());
+    profile.set_peak_bytes_in_flight(stream_memory_gauges_[i]->peak_bytes());
+    profiles->push_back(std::move(profile));
+  }
+  return absl::OkStatus();
+}
+
+void GraphProfiler::InitializeLatencyMeasurements(
+    const ValidatedGraphConfig& validated_graph_config,
+    int64 interval_size_usec, int64 num_intervals) {
+  if (profiler_config_.latency_measurement().empty()) {
+    return;
+  }
+  stream_latency_probes_.resize(
+      validated_graph_config.OutputStreamInfos().size());
+  for (const auto& config : profiler_config_.latency_measurement()) {
+    const int stream_index =
+        validated_graph_config.OutputStreamIndex(config.stream());
+    if (stream_index < 0) {
+      ABSL_LOG(ERROR) << "Ignoring the latency measurement of unknown stream \""
+                      << config.stream() << "\".";
+      continue;
+    }
+    LatencyMeasurement measurement;
+    if (!config.reference_stream().empty()) {
+      const int reference_index =
+          validated_graph_config.OutputStreamIndex(config.reference_stream());
+      if (reference_index < 0) {
+        ABSL_LOG(ERROR) << "Ignoring the latency measurement of stream \""
+                        << config.stream() << "\" with unknown reference \""
+                        << config.reference_stream() << "\".";
+        continue;
+      }
+      auto& arrival_times =
+          stream_latency_probes_[reference_index].arrival_times;
+      if (!arrival_times) {
+        arrival_times = std::make_unique<StreamArrivalTimes>();
+      }
+      measurement.reference_times = arrival_times.get();
+    }
+    measurement.name = config.name().empty() ? config.stream() : config.name();
+    measurement.stream_name = config.stream();
+    measurement.reference_stream_name = config.reference_stream();
+    measurement.histogram = std::make_unique<StreamLatencyHistogram>(
+        config.interval_size_usec() > 0 ? config.interval_size_usec()
+                                        : interval_size_usec,
+        config.num_intervals() > 0 ? config.num_intervals() : num_intervals);
+    stream_latency_probes_[stream_index].measurements.push_back(
+        latency_measurements_.size());
+    latency_measurements_.push_back(std::move(measurement));
+  }
+}
+
+bool GraphProfiler::IsStreamLatencyMeasured(int output_stream_index) const {
+  if (output_stream_index >= stream_latency_probes_.size()) {
+    return false;
+  }
+  const StreamLatencyProbe& probe = stream_latency_probes_[output_stream_index];
+  return probe.arrival_times || !probe.measurements.empty();
+}
+
+void GraphProfiler::RecordStreamPackets(int output_stream_index,
+                                        const std::list<Packet>& packets) {
+  if (packets.empty() || !IsStreamLatencyMeasured(output_stream_index)) {
+    return;
+  }
+  const StreamLatencyProbe& probe = stream_latency_probes_[output_stream_index];
+  const int64 time_usec = TimeNowUsec();
+  for (const Packet& packet : packets) {
+    const int64 timestamp = packet.Timestamp().Value();
+    if (probe.arrival_times) {
+      probe.arrival_times->Add(timestamp, time_usec);
+    }
+    for (int index : probe.measurements) {
+      LatencyMeasurement& measurement = latency_measurements_[index];
+      int64_t reference_time_usec = timestamp;
+      if (measurement.reference_times &&
+          !measurement.reference_times->Find(timestamp,
+                                             &reference_time_usec)) {
+        measurement.histogram->AddUnmatched();
+        continue;
+      }
+      measurement.histogram->Add(time_usec - reference_time_usec);
+    }
+  }
+}
+
+absl::Status GraphProfiler::GetStreamLatencyProfiles(
+    std::vector<StreamLatencyProfile>* profiles) const {
+  absl::ReaderMutexLock lock(&profiler_mutex_);
+  RET_CHECK(is_initialized_)
+      << "GetStreamLatencyProfiles can only be called after Initialize()";
+  for (const LatencyMeasurement& measurement : latency_measurements_) {
+    const StreamLatencyHistogram& histogram = *measurement.histogram;
+    StreamLatencyProfile profile;
+    profile.set_name(measurement.name);
+    profile.set_stream_name(measurement.stream_name);
+    if (!measurement.reference_stream_name.empty()) {
+      profile.set_reference_stream_name(measurement.reference_stream_name);
+    }
+    TimeHistogram* latency = profile.mutable_latency();
+    latency->set_total(histogram.total_usec());
+    latency->set_interval_size_usec(histogram.interval_size_usec());
+    latency->set_num_intervals(histogram.num_intervals());
+    for (int64 i = 0; i < histogram.num_intervals(); ++i) {
+      latency->add_count(histogram.count(i));
+    }
+    profile.set_unmatched_count(histogram.unmatched_count());
+    profiles->push_back(std::move(profile));
   }
   return absl::OkStatus();
 }
 
+GraphProfiler::ThreadProfiles* GraphProfiler::GetThreadProfiles() {
+  // The ThreadProfiles last used by this thread, and the graph_id_ of the
+  // GraphProfiler owning it. A graph_id_ is never reused within a process.
+  thread_local uint64_t cached_graph_id = 0;
+  thread_local ThreadProfiles* cached_profiles = nullptr;
+  if (cached_graph_id == graph_id_ && cached_profiles != nullptr) {
+    return cached_profiles;
+  }
+  absl::MutexLock lock(&thread_profiles_mutex_);
+  std::unique_ptr<ThreadProfiles>& thread_profiles =
+      thread_profiles_[std::this_thread::get_id()];
+  if (!thread_profiles) {
+    thread_profiles = std::make_unique<ThreadProfiles>();
+    absl::MutexLock thread_lock(&thread_profiles->mutex);
+    thread_profiles->profiles = initial_profiles_;
+  }
+  cached_graph_id = graph_id_;
+  cached_profiles = thread_profiles.get();
+  return cached_profiles;
+}
+
+CalculatorProfile* GraphProfiler::GetThreadProfile(
+    ThreadProfiles* thread_profiles,
+    const CalculatorContext& calculator_context) {
+  auto index_iter = profile_indexes_.find(calculator_context.NodeName());
+  ABSL_CHECK(index_iter != profile_indexes_.end()) << absl::Substitute(
+      "Calculator \"$0\" has not been added during initialization.",
+      calculator_context.NodeName());
+  return &thread_profiles->profiles[index_iter->second];
+}
+
 void GraphProfiler::InitializeTimeHistogram(int64 interval_size_usec,
                                             int64 num_intervals,
                                             TimeHistogram* histogram) {
@@ -404,6 +629,76 @@ void GraphProfiler::ResetTimeHistogram(TimeHistogram* histogram) {
   }
 }
 
+void GraphProfiler::ResetCalculatorProfile(
+    CalculatorProfile* calculator_profile) {
+  ResetTimeHistogram(calculator_profile->mutable_process_runtime());
+  ResetTimeHistogram(calculator_profile->mutable_process_input_latency());
+  ResetTimeHistogram(calculator_profile->mutable_process_output_latency());
+  for (auto& input_stream_profile :
+       *(calculator_profile->mutable_input_stream_profiles())) {
+    ResetTimeHistogram(input_stream_profile.mutable_latency());
+  }
+  calculator_profile->clear_storage_conversions();
+  if (calculator_profile->has_process_cpu_time()) {
+    ResetTimeHistogram(calculator_profile->mutable_process_cpu_time());
+  }
+  calculator_profile->clear_process_hardware_counters();
+}
+
+void GraphProfiler::MergeTimeHistogram(const TimeHistogram& from,
+                                       TimeHistogram* to) {
+  to->set_total(to->total() + from.total());
+  for (int i = 0; i < from.count_size() && i < to->count_size(); ++i) {
+    to->set_count(i, to->count(i) + from.count(i));
+  }
+}
+
+void GraphProfiler::MergeCalculatorProfile(const CalculatorProfile& from,
+                                           CalculatorProfile* to) {
+  if (from.has_open_runtime()) {
+    to->set_open_runtime(from.open_runtime());
+  }
+  if (from.has_close_runtime()) {
+    to->set_close_runtime(from.close_runtime());
+  }
+  MergeTimeHistogram(from.process_runtime(), to->mutable_process_runtime());
+  if (from.has_process_input_latency()) {
+    MergeTimeHistogram(from.process_input_latency(),
+                       to->mutable_process_input_latency());
+    MergeTimeHistogram(from.process_output_latency(),
+                       to->mutable_process_output_latency());
+  }
+  for (int i = 0; i < from.input_stream_profiles_size() &&
+                  i < to->input_stream_profiles_size();
+       ++i) {
+    MergeTimeHistogram(from.input_stream_profiles(i).latency(),
+                       to->mutable_input_stream_profiles(i)->mutable_latency());
+  }
+  if (from.has_process_cpu_time()) {
+    MergeTimeHistogram(from.process_cpu_time(),
+                       to->mutable_process_cpu_time());
+  }
+  if (from.has_process_hardware_counters()) {
+    const HardwareCounters& from_counters = from.process_hardware_counters();
+    HardwareCounters* to_counters = to->mutable_process_hardware_counters();
+    to_counters->set_count(to_counters->count() + from_counters.count());
+    to_counters->set_cycles(to_counters->cycles() + from_counters.cycles());
+    to_counters->set_instructions(to_counters->instructions() +
+                                  from_counters.instructions());
+    to_counters->set_cache_misses(to_counters->cache_misses() +
+                                  from_counters.cache_misses());
+  }
+  for (const StorageConversionProfile& from_conversion :
+       from.storage_conversions()) {
+    StorageConversionProfile* to_conversion =
+        FindStorageConversion(from_conversion.source_storage(),
+                              from_conversion.target_storage(), to);
+    to_conversion->set_count(to_conversion->count() + from_conversion.count());
+    to_conversion->set_total_time_usec(to_conversion->total_time_usec() +
+                                       from_conversion.total_time_usec());
+  }
+}
+
 void GraphProfiler::AddPacketInfoInternal(const PacketId& packet_id,
                                           int64 production_time_usec,
                                           int64 source_process_start_usec) {
@@ -438,18 +733,15 @@ int64 GraphProfiler::AddStreamLatencies(
 
 void GraphProfiler::SetOpenRuntime(const CalculatorContext& calculator_context,
                                    int64 start_time_usec, int64 end_time_usec) {
-  absl::ReaderMutexLock lock(&profiler_mutex_);
   if (!is_profiling_) {
     return;
   }
 
-  const std::string& node_name = calculator_context.NodeName();
   int64 time_usec = end_time_usec - start_time_usec;
-  auto profile_iter = calculator_profiles_.find(node_name);
-  ABSL_CHECK(profile_iter != calculator_profiles_.end()) << absl::Substitute(
-      "Calculator \"$0\" has not been added during initialization.",
-      calculator_context.NodeName());
-  CalculatorProfile* calculator_profile = &profile_iter->second;
+  ThreadProfiles* thread_profiles = GetThreadProfiles();
+  absl::MutexLock lock(&thread_profiles->mutex);
+  CalculatorProfile* calculator_profile =
+      GetThreadProfile(thread_profiles, calculator_context);
   calculator_profile->set_open_runtime(time_usec);
 
   if (profiler_config_.enable_stream_latency()) {
@@ -461,17 +753,14 @@ void GraphProfiler::SetOpenRuntime(const CalculatorContext& calculator_context,
 void GraphProfiler::SetCloseRuntime(const CalculatorContext& calculator_context,
                                     int64 start_time_usec,
                                     int64 end_time_usec) {
-  absl::ReaderMutexLock lock(&profiler_mutex_);
   if (!is_profiling_) {
     return;
   }
-  const std::string& node_name = calculator_context.NodeName();
   int64 time_usec = end_time_usec - start_time_usec;
-  auto profile_iter = calculator_profiles_.find(node_name);
-  ABSL_CHECK(profile_iter != calculator_profiles_.end()) << absl::Substitute(
-      "Calculator \"$0\" has not been added during initialization.",
-      calculator_context.NodeName());
-  CalculatorProfile* calculator_profile = &profile_iter->second;
+  ThreadProfiles* thread_profiles = GetThreadProfiles();
+  absl::MutexLock lock(&thread_profiles->mutex);
+  CalculatorProfile* calculator_profile =
+      GetThreadProfile(thread_profiles, calculator_context);
   calculator_profile->set_close_runtime(time_usec);
 
   if (profiler_config_.enable_stream_latency()) {
@@ -539,17 +828,14 @@ int64 GraphProfiler::AddInputStreamTimeSamples(
 void GraphProfiler::AddProcessSample(
     const CalculatorContext& calculator_context, int64 start_time_usec,
     int64 end_time_usec) {
-  absl::ReaderMutexLock lock(&profiler_mutex_);
   if (!is_profiling_) {
     return;
   }
 
-  const std::string& node_name = calculator_context.NodeName();
-  auto profile_iter = calculator_profiles_.find(node_name);
-  ABSL_CHECK(profile_iter != calculator_profiles_.end()) << absl::Substitute(
-      "Calculator \"$0\" has not been added during initialization.",
-      calculator_context.NodeName());
-  CalculatorProfile* calculator_profile = &profile_iter->second;
+  ThreadProfiles* thread_profiles = GetThreadProfiles();
+  absl::MutexLock lock(&thread_profiles->mutex);
+  CalculatorProfile* calculator_profile =
+      GetThreadProfile(thread_profiles, calculator_context);
 
   // Update Process() runtime.
   AddTimeSample(start_time_usec, end_time_usec,
@@ -566,6 +852,63 @@ void GraphProfiler::AddProcessSample(
   }
 }
 
+void GraphProfiler::AddProcessCounters(
+    const CalculatorContext& calculator_context,
+    const ThreadCounterSample& start, const ThreadCounterSample& end) {
+  const bool has_cpu_time = start.cpu_time_nsec >= 0 && end.cpu_time_nsec >= 0;
+  const bool has_hardware_counters = start.cycles >= 0 && end.cycles >= 0;
+  if (!is_profiling_ || (!has_cpu_time && !has_hardware_counters)) {
+    return;
+  }
+
+  ThreadProfiles* thread_profiles = GetThreadProfiles();
+  absl::MutexLock lock(&thread_profiles->mutex);
+  CalculatorProfile* calculator_profile =
+      GetThreadProfile(thread_profiles, calculator_context);
+  if (has_cpu_time) {
+    AddTimeSample(start.cpu_time_nsec / 1000, end.cpu_time_nsec / 1000,
+                  calculator_profile->mutable_process_cpu_time());
+  }
+  if (has_hardware_counters) {
+    HardwareCounters* counters =
+        calculator_profile->mutable_process_hardware_counters();
+    counters->set_count(counters->count() + 1);
+    counters->set_cycles(counters->cycles() + end.cycles - start.cycles);
+    counters->set_instructions(counters->instructions() + end.instructions -
+                               start.instructions);
+    counters->set_cache_misses(counters->cache_misses() + end.cache_misses -
+                               start.cache_misses);
+  }
+}
+
+void GraphProfiler::AddStorageConversion(
+    const CalculatorContext& calculator_context, absl::string_view source,
+    absl::string_view target, absl::Duration duration) {
+  if (profiler_config_.strict_storage_conversions() &&
+      !allowed_storage_conversion_nodes_.contains(
+          calculator_context.NodeName())) {
+    ABSL_LOG(FATAL) << absl::Substitute(
+        "Calculator \"$0\" converted a $1 storage into a $2 storage, which "
+        "ProfilerConfig.strict_storage_conversions forbids. Convert the "
+        "buffer explicitly, or add the node to "
+        "allowed_storage_conversion_node.",
+        calculator_context.NodeName(), source, target);
+  }
+  if (!is_profiling_) {
+    return;
+  }
+
+  ThreadProfiles* thread_profiles = GetThreadProfiles();
+  absl::MutexLock lock(&thread_profiles->mutex);
+  CalculatorProfile* calculator_profile =
+      GetThreadProfile(thread_profiles, calculator_context);
+  StorageConversionProfile* conversion =
+      FindStorageConversion(source, target, calculator_profile);
+  conversion->set_count(conversion->count() + 1);
+  conversion->set_total_time_usec(conversion->total_time_usec() +
+                                  absl::ToInt64Microseconds(duration));
+}
+
 std::unique_ptr<GlProfilingHelper> GraphProfiler::CreateGlProfilingHelper() {
   if (!IsTracerEnabled(profiler_config_)) {
     return nullptr;
@@ -691,6 +1034,16 @@ absl::Status GraphProfiler::CaptureProfile(
       *result->mutable_calculator_profiles()->Add() = std::move(p);
     }
   }
+  std::vector<StreamMemoryProfile> memory_profiles;
+  status.Update(GetStreamMemoryProfiles(&memory_profiles));
+  for (StreamMemoryProfile& p : memory_profiles) {
+    *result->add_stream_memory_profiles() = std::move(p);
+  }
+  std::vector<StreamLatencyProfile> latency_profiles;
+  status.Update(GetStreamLatencyProfiles(&latency_profiles));
+  for (StreamLatencyProfile& p : latency_profiles) {
+    *result->add_stream_latency_profiles() = std::move(p);
+  }
   this->Reset();
   CleanCalculatorProfiles(result);
   if (populate_config == PopulateGraphConfig::kFull) {
@@ -700,6 +1053,17 @@ absl::Status GraphProfiler::CaptureProfile(
   return status;
 }
 
+absl::Status GraphProfiler::WritePerfettoTrace(const GraphTrace& trace) {
+  std::string packets;
+  perfetto_writer_->WriteTrace(trace, &packets);
+  const std::string& path = profiler_config_.trace_perfetto_path();
+  std::ofstream ofs(path, std::ofstream::out | std::ofstream::app |
+                              std::ofstream::binary);
+  ofs.write(packets.data(), packets.size());
+  RET_CHECK(ofs.good()) << "Could not write Perfetto trace to: " << path;
+  return absl::OkStatus();
+}
+
 absl::Status GraphProfiler::WriteProfile() {
   if (profiler_config_.trace_log_disabled()) {
     // Logging is disabled, so we can exit writing without error.
@@ -716,6 +1080,9 @@ absl::Status GraphProfiler::WriteProfile() {
   if (is_tracing_ && trace.calculator_trace().empty()) {
     return absl::OkStatus();
   }
+  if (perfetto_writer_) {
+    MP_RETURN_IF_ERROR(WritePerfettoTrace(trace));
+  }
 
   // Record the CalculatorGraphConfig, once per log file.
   ++previous_log_index_;
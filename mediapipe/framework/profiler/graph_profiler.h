@@ -17,21 +17,36 @@
 
 #include <atomic>
 #include <cstddef>
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_context.h"
 #include "mediapipe/framework/calculator_profile.pb.h"
 #include "mediapipe/framework/deps/clock.h"
 #include "mediapipe/framework/deps/monotonic_clock.h"
 #include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/profiler/graph_tracer.h"
+#include "mediapipe/framework/profiler/perfetto_trace_writer.h"
 #include "mediapipe/framework/profiler/sharded_map.h"
+#include "mediapipe/framework/profiler/storage_conversion_observer.h"
+#include "mediapipe/framework/profiler/stream_latency_histogram.h"
+#include "mediapipe/framework/profiler/stream_memory_gauge.h"
+#include "mediapipe/framework/profiler/thread_counters.h"
 #include "mediapipe/framework/validated_graph_config.h"
 
 namespace mediapipe {
@@ -98,6 +113,10 @@ enum class PopulateGraphConfig { kNo, kFull };
 //
 // The profiler uses the synchronized monotonic clock by default.
 // The client can overwrite this by calling SetClock().
+//
+// Each thread records Open(), Process(), and Close() samples into its own
+// copy of the calculator profiles, so that concurrent calculators do not
+// contend for a lock. GetCalculatorProfiles() merges the per-thread copies.
 class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
  public:
   GraphProfiler();
@@ -146,6 +165,35 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
   absl::Status GetCalculatorProfiles(std::vector<CalculatorProfile>*) const
       ABSL_LOCKS_EXCLUDED(profiler_mutex_);
 
+  // Returns the gauge of the payload bytes queued in a calculator input stream,
+  // indexed like ValidatedGraphConfig::InputStreamInfos(), or nullptr if
+  // ProfilerConfig.enable_memory_accounting is not set.
+  StreamMemoryGauge* GetStreamMemoryGauge(int input_stream_index);
+
+  // Collects the payload bytes queued in each calculator input stream, and
+  // their peak since the previous Reset(). Nothing is collected unless
+  // ProfilerConfig.enable_memory_accounting is set. The bytes queued for a
+  // calculator are the sum over its input streams. Packets sent to several
+  // calculators are counted once for each of them.
+  absl::Status GetStreamMemoryProfiles(std::vector<StreamMemoryProfile>*) const
+      ABSL_LOCKS_EXCLUDED(profiler_mutex_);
+
+  // Returns true if the packets of an output stream, indexed like
+  // ValidatedGraphConfig::OutputStreamInfos(), are measured or referenced by
+  // a ProfilerConfig.latency_measurement.
+  bool IsStreamLatencyMeasured(int output_stream_index) const;
+
+  // Records the latency of packets added to an output stream, or their
+  // arrival time if the stream is a reference stream. Lock-free.
+  void RecordStreamPackets(int output_stream_index,
+                           const std::list<Packet>& packets);
+
+  // Collects the latencies recorded for each ProfilerConfig.latency_measurement
+  // since the previous Reset().
+  absl::Status GetStreamLatencyProfiles(
+      std::vector<StreamLatencyProfile>*) const
+      ABSL_LOCKS_EXCLUDED(profiler_mutex_);
+
   // Records recent profiling and tracing data.  Includes events since the
   // previous call to CaptureProfile.
   //
@@ -170,7 +218,8 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
   // Convenience temporary object to record scoped entry and exit.
   // Gets start_time_usec_ on construction and records process runtime on
   // destruction. The |calculator_context| and |profiler| must not be null.
-  class Scope {
+  // Also records the storage conversions requested within the scope.
+  class Scope : public StorageConversionObserver {
    public:
     // Constructs a scope.
     //
@@ -181,7 +230,12 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
                           GraphProfiler* profiler)
         : calculator_method_(event_type),
           calculator_context_(*calculator_context),
-          profiler_(profiler) {
+          profiler_(profiler),
+          observer_scope_(this) {
+      if (calculator_method_ == GraphTrace::EVENT_TYPE_PROCESS &&
+          profiler_->is_profiling_) {
+        start_counters_ = profiler_->ReadThreadCounters();
+      }
       start_time_usec_ = profiler_->TimeNowUsec();
       if (profiler_->is_tracing_) {
         absl::Time time_now = absl::FromUnixMicros(start_time_usec_);
@@ -190,7 +244,7 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
       }
     }
 
-    inline ~Scope() {
+    inline ~Scope() override {
       int64 end_time_usec;
       if (profiler_->is_profiling_ || profiler_->is_tracing_) {
         end_time_usec = profiler_->TimeNowUsec();
@@ -204,6 +258,8 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
             break;
 
           case GraphTrace::EVENT_TYPE_PROCESS:
+            profiler_->AddProcessCounters(calculator_context_, start_counters_,
+                                          profiler_->ReadThreadCounters());
             profiler_->AddProcessSample(calculator_context_, start_time_usec_,
                                         end_time_usec);
             break;
@@ -223,11 +279,20 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
       }
     }
 
+    void OnStorageConversion(absl::string_view source,
+                             absl::string_view target,
+                             absl::Duration duration) override {
+      profiler_->AddStorageConversion(calculator_context_, source, target,
+                                      duration);
+    }
+
    private:
     const GraphTrace::EventType calculator_method_;
     const CalculatorContext& calculator_context_;
     GraphProfiler* profiler_;
     int64 start_time_usec_;
+    ThreadCounterSample start_counters_;
+    StorageConversionObserver::Scope observer_scope_;
   };
 
   const ProfilerConfig& profiler_config() { return profiler_config_; }
@@ -253,10 +318,22 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
                                       int64 num_intervals,
                                       TimeHistogram* histogram);
   static void ResetTimeHistogram(TimeHistogram* histogram);
+  // Resets the histograms of a calculator profile.
+  static void ResetCalculatorProfile(CalculatorProfile* calculator_profile);
+  // Adds the samples of one time histogram to another.
+  static void MergeTimeHistogram(const TimeHistogram& from, TimeHistogram* to);
+  // Adds the samples and runtimes of one calculator profile to another.
+  static void MergeCalculatorProfile(const CalculatorProfile& from,
+                                     CalculatorProfile* to);
   // Add a sample to a time histogram.
   static void AddTimeSample(int64 start_time_usec, int64 end_time_usec,
                             TimeHistogram* histogram);
 
+  // Creates the histograms of the ProfilerConfig.latency_measurement.
+  void InitializeLatencyMeasurements(
+      const ValidatedGraphConfig& validated_graph_config,
+      int64 interval_size_usec, int64 num_intervals);
+
   // Add output streams to the stream consumer count map.
   // This is neeeded in case an output stream is not consumed by any calculator.
   void InitializeOutputStreams(const CalculatorGraphConfig::Node& node_config);
@@ -299,12 +376,55 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
                                   int64 start_time_usec,
                                   CalculatorProfile* calculator_profile);
 
-  // Updates the Process() data for calculator.
-  // Requires ReaderLock for is_profiling_.
+  // Updates the Process() data for calculator in the calling thread's
+  // ThreadProfiles.
   void AddProcessSample(const CalculatorContext& calculator_context,
                         int64 start_time_usec, int64 end_time_usec)
       ABSL_LOCKS_EXCLUDED(profiler_mutex_);
 
+  // Reads the thread counters enabled by the ProfilerConfig.
+  ThreadCounterSample ReadThreadCounters() {
+    return profiler_config_.enable_thread_cpu_time() ||
+                   profiler_config_.enable_hardware_counters()
+               ? mediapipe::ReadThreadCounters(
+                     profiler_config_.enable_thread_cpu_time(),
+                     profiler_config_.enable_hardware_counters())
+               : ThreadCounterSample();
+  }
+
+  // Adds the difference between the thread counters read before and after a
+  // Process() call to the calculator in the calling thread's ThreadProfiles.
+  void AddProcessCounters(const CalculatorContext& calculator_context,
+                          const ThreadCounterSample& start,
+                          const ThreadCounterSample& end);
+
+  // Counts a storage conversion requested by a calculator in the calling
+  // thread's ThreadProfiles. Fails if ProfilerConfig.strict_storage_conversions
+  // forbids the conversion.
+  void AddStorageConversion(const CalculatorContext& calculator_context,
+                            absl::string_view source, absl::string_view target,
+                            absl::Duration duration);
+
+  // The calculator profiles recorded by a single thread.
+  struct ThreadProfiles {
+    absl::Mutex mutex;
+    // One profile for each calculator, indexed by profile_indexes_.
+    std::vector<CalculatorProfile> profiles ABSL_GUARDED_BY(mutex);
+  };
+
+  // Returns the ThreadProfiles of the calling thread, creating it if needed.
+  ThreadProfiles* GetThreadProfiles()
+      ABSL_LOCKS_EXCLUDED(thread_profiles_mutex_);
+
+  // Returns the profile of a calculator within a ThreadProfiles.
+  CalculatorProfile* GetThreadProfile(
+      ThreadProfiles* thread_profiles,
+      const CalculatorContext& calculator_context)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(thread_profiles->mutex);
+
+  // Appends the events of a GraphTrace to the trace_perfetto_path.
+  absl::Status WritePerfettoTrace(const GraphTrace& trace);
+
   // Helper method to get trace_log_path.  If the trace_log_path is empty and
   // tracing is enabled, this function returns a default platform dependent
   // trace_log_path.
@@ -335,12 +455,58 @@ class GraphProfiler : public std::enable_shared_from_this<ProfilingContext> {
       ShardedMap<std::string, std::list<std::pair<int64, PacketInfo>>>;
   PacketInfoMap packets_info_;
 
+  // The index of each calculator profile by calculator name, and the profile
+  // each ThreadProfiles starts with. Both are fixed by Initialize().
+  absl::flat_hash_map<std::string, int> profile_indexes_;
+  std::vector<CalculatorProfile> initial_profiles_;
+
+  // The nodes that may convert storages when strict_storage_conversions is
+  // set. Fixed by Initialize().
+  absl::flat_hash_set<std::string> allowed_storage_conversion_nodes_;
+
+  // The samples recorded by each thread, merged into calculator_profiles_ by
+  // GetCalculatorProfiles().
+  mutable absl::Mutex thread_profiles_mutex_;
+  std::map<std::thread::id, std::unique_ptr<ThreadProfiles>> thread_profiles_
+      ABSL_GUARDED_BY(thread_profiles_mutex_);
+
+  // The gauge of each calculator input stream, if enable_memory_accounting is
+  // set. Fixed by Initialize().
+  std::vector<std::unique_ptr<StreamMemoryGauge>> stream_memory_gauges_;
+
+  // The histogram of a ProfilerConfig.latency_measurement.
+  struct LatencyMeasurement {
+    std::string name;
+    std::string stream_name;
+    std::string reference_stream_name;
+    std::unique_ptr<StreamLatencyHistogram> histogram;
+    // The arrival times in the reference stream, or nullptr if the packet
+    // timestamps are used instead.
+    const StreamArrivalTimes* reference_times = nullptr;
+  };
+
+  // The measurements involving an output stream.
+  struct StreamLatencyProbe {
+    // Set if the stream is a reference stream.
+    std::unique_ptr<StreamArrivalTimes> arrival_times;
+    // The indexes in latency_measurements_ of the measurements of the stream.
+    std::vector<int> measurements;
+  };
+
+  // Fixed by Initialize(). The probes are indexed like OutputStreamInfos(),
+  // and empty if there are no latency measurements.
+  std::vector<LatencyMeasurement> latency_measurements_;
+  std::vector<StreamLatencyProbe> stream_latency_probes_;
+
   // Global mutex for the profiler.
   mutable absl::Mutex profiler_mutex_;
 
   // Buffer of recent profile trace events.
   std::unique_ptr<GraphTracer> packet_tracer_;
 
+  // Converts trace events for the trace_perfetto_path, if specified.
+  std::unique_ptr<PerfettoTraceWriter> perfetto_writer_;
+
   // The clock for time measurement, which must be a monotonic real time clock.
   std::shared_ptr<mediapipe::Clock> clock_;
 
@@ -378,17 +544,23 @@ class ProfilingContext : public GraphProfiler {
   using GraphProfiler::GraphProfiler;
 };
 
-// For now, OSS always uses GlContextProfilerStub.
-// TODO: Switch to GlContextProfiler when GlContext is moved to OSS.
+// GPU timing is unavailable when the GPU is disabled.
+#if defined(MEDIAPIPE_DISABLE_GPU)
 #define MEDIAPIPE_DISABLE_GPU_PROFILER 1
+#else
+#define MEDIAPIPE_DISABLE_GPU_PROFILER 0
+#endif  // defined(MEDIAPIPE_DISABLE_GPU)
 
 // GlContextProfiler keeps track of all timestamp queries within a specific
-// GlContext object. When created, the GlContextProfiler must be initialized
-// before marking timestamps. Finally, when GlContext is no longer interested
-// in marking timestamps or is about to be destroyed, Finish() must be called
-// to complete all pending time queries and detach the timer from the GlContext.
-// Note that the GlContextProfiler must be created and initialized within a
-// valid GlContext object.
+// GlContext object. It marks GPU timestamps around the GL tasks of each
+// calculator, and logs them as GPU_TASK events once the GPU has executed the
+// tasks, so that traces show GPU time beside CPU time. When GlContext is no
+// longer interested in marking timestamps or is about to be destroyed,
+// LogAllTimestamps() must be called to complete all pending time queries.
+// Note that the GlContextProfiler must be used within its GlContext.
+//
+// Timestamps require the GL_EXT_disjoint_timer_query extension. Without it,
+// MarkTimestamp does nothing.
 #if !MEDIAPIPE_DISABLE_GPU_PROFILER
 class GlContextProfiler {
  public:
@@ -400,34 +572,31 @@ class GlContextProfiler {
   GlContextProfiler(const GlContextProfiler&) = delete;
   GlContextProfiler& operator=(const GlContextProfiler&) = delete;
 
-  // Add a GlTimingInfo object to the collection of pending timestamp queries
-  // associated with a specific graph node_id, packet input_timestamp and mark
-  // if it is a start or stop event. When a stop event is marked, this function
-  // blocks on the corresponding start event to complete.
+  // Adds a timestamp query for a graph node_id and packet input_timestamp,
+  // marking a start or a finish event. The query is logged asynchronously, by
+  // a later call that finds it complete.
   void MarkTimestamp(int node_id, Timestamp input_timestamp, bool is_finish);
 
-  // Complete all pending timing queries and detach the timer from the
-  // GlContext.
+  // Completes all pending timing queries.
   void LogAllTimestamps();
 
  private:
-  // Store GlTimeQuery and the corresponding TraceEvent object that should be
-  // populated when the query completes together.
+  // Store a timestamp query and the corresponding TraceEvent object that should
+  // be populated when the query completes together.
   struct GlTimingInfo {
-    GlTimeQuery time_query;
+    uint32_t query = 0;
     TraceEvent trace_event;
   };
 
-  // Setup the timer for marking GPU timestamps. If successful in setup, return
-  // true otherwise return false to indicate that timing measurment is not
-  // supported.
+  // Checks whether timestamp queries are supported, and calibrates the GPU
+  // clock. Returns false if timing measurement is not supported.
   bool Initialize();
 
   absl::Time TimeNow();
 
-  // Calibrate the GPU timer w.r.t. the CPU clock. If calibration is fails,
+  // Calibrate the GPU timer w.r.t. the CPU clock. If calibration fails,
   // timing_measurement_supported_ is set to false.
-  void CalibrateTimer(bool recalibrate);
+  void CalibrateTimer();
 
   // Log a TraceEvent object to represent if the GPU calibration period has
   // started or just ended.
@@ -440,15 +609,18 @@ class GlContextProfiler {
   // Get the TraceEvent object containing the timestamp recorded by the GPU if
   // the provided query was fulfilled. If it is still pending and wait is false,
   // return absl::nullopt.
-  absl::optional<TraceEvent> GetTimeFromQuery(
-      std::unique_ptr<GlTimingInfo>& query, bool wait);
+  absl::optional<TraceEvent> GetTimeFromQuery(const GlTimingInfo& info,
+                                              bool wait);
+
+  // Deletes all pending time queries without logging them.
+  void DiscardPendingGlTimings();
 
   std::shared_ptr<ProfilingContext> profiling_context_;
-  GlSimpleTimer gl_timer_;
   bool checked_timing_supported_ = false;
   bool timing_measurement_supported_ = false;
+  // The GPU clock time minus the CPU clock time.
+  absl::Duration gpu_time_offset_;
   std::deque<std::unique_ptr<GlTimingInfo>> pending_gl_times_;
-  std::unique_ptr<GlTimingInfo> gl_start_query_;
 };
 
 // The API class used to access the preferred GlContext profiler, such as
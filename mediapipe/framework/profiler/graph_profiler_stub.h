@@ -15,6 +15,8 @@
 #ifndef MEDIAPIPE_FRAMEWORK_PROFILER_MEDIAPIPE_PROFILER_STUB_H_
 #define MEDIAPIPE_FRAMEWORK_PROFILER_MEDIAPIPE_PROFILER_STUB_H_
 
+#include <list>
+
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/timestamp.h"
 
@@ -22,6 +24,8 @@ namespace mediapipe {
 class CalculatorProfile;
 class GraphTrace;
 class GraphProfile;
+class StreamLatencyProfile;
+class StreamMemoryProfile;
 }  // namespace mediapipe
 
 namespace mediapipe {
@@ -35,6 +39,7 @@ class Packet;
 class Clock;
 class GraphTracer;
 class GlProfilingHelper;
+class StreamMemoryGauge;
 
 class TraceEvent {
  public:
@@ -88,6 +93,22 @@ class GraphProfilerStub {
       std::vector<CalculatorProfile>*) const {
     return absl::OkStatus();
   }
+  inline StreamMemoryGauge* GetStreamMemoryGauge(int input_stream_index) {
+    return nullptr;
+  }
+  inline absl::Status GetStreamMemoryProfiles(
+      std::vector<StreamMemoryProfile>*) const {
+    return absl::OkStatus();
+  }
+  inline bool IsStreamLatencyMeasured(int output_stream_index) const {
+    return false;
+  }
+  inline void RecordStreamPackets(int output_stream_index,
+                                  const std::list<Packet>& packets) {}
+  inline absl::Status GetStreamLatencyProfiles(
+      std::vector<StreamLatencyProfile>*) const {
+    return absl::OkStatus();
+  }
   absl::Status CaptureProfile(
       GraphProfile* result,
       PopulateGraphConfig populate_config = PopulateGraphConfig::kNo) {
@@ -14,6 +14,9 @@
 
 #include "mediapipe/framework/profiler/graph_profiler.h"
 
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
 #include "absl/log/absl_log.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
@@ -29,6 +32,7 @@
 #include "mediapipe/framework/tool/simulation_clock.h"
 #include "mediapipe/framework/tool/tag_map_helper.h"
 
+using ::testing::ElementsAre;
 using ::testing::proto::Partially;
 
 namespace mediapipe {
@@ -185,6 +189,12 @@ class GraphProfilerTestPeer : public testing::Test {
                                end_time_usec);
   }
 
+  void AddProcessCounters(const CalculatorContext& calculator_context,
+                          const ThreadCounterSample& start,
+                          const ThreadCounterSample& end) {
+    profiler_.AddProcessCounters(calculator_context, start, end);
+  }
+
   OutputStreamSpec CreateOutputStreamSpec(const std::string& name) {
     OutputStreamSpec output_stream_spec;
     output_stream_spec.name = name;
@@ -540,6 +550,62 @@ TEST_F(GraphProfilerTestPeer, PauseResumeReset) {
   simulation_clock->ThreadFinish();
 }
 
+// Tests that latency measurements record the time from the reference stream.
+TEST_F(GraphProfilerTestPeer, RecordStreamPacketsWithReferenceStream) {
+  InitializeProfilerWithGraphConfig(R"(
+    profiler_config {
+      latency_measurement {
+        name: "end_to_end"
+        stream: "output_stream"
+        reference_stream: "input_stream"
+        interval_size_usec: 100
+        num_intervals: 3
+      }
+    }
+    input_stream: "input_stream"
+    node {
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+      output_stream: "output_stream"
+    })");
+  std::shared_ptr<mediapipe::SimulationClock> simulation_clock(
+      new SimulationClock());
+  simulation_clock->ThreadStart();
+  profiler_.SetClock(simulation_clock);
+  // The graph input stream is output stream 0.
+  ASSERT_TRUE(profiler_.IsStreamLatencyMeasured(0));
+  ASSERT_TRUE(profiler_.IsStreamLatencyMeasured(1));
+
+  profiler_.RecordStreamPackets(0, {MakePacket<int>(1).At(Timestamp(100))});
+  simulation_clock->Sleep(absl::Microseconds(150));
+  profiler_.RecordStreamPackets(1, {MakePacket<int>(1).At(Timestamp(100)),
+                                    MakePacket<int>(2).At(Timestamp(200))});
+
+  std::vector<StreamLatencyProfile> profiles;
+  MP_ASSERT_OK(profiler_.GetStreamLatencyProfiles(&profiles));
+  ASSERT_EQ(profiles.size(), 1);
+  EXPECT_THAT(profiles[0], EqualsProto(R"pb(
+                name: "end_to_end"
+                stream_name: "output_stream"
+                reference_stream_name: "input_stream"
+                latency {
+                  total: 150
+                  interval_size_usec: 100
+                  num_intervals: 3
+                  count: [ 0, 1, 0 ]
+                }
+                unmatched_count: 1
+              )pb"));
+
+  profiler_.Reset();
+  profiles.clear();
+  MP_ASSERT_OK(profiler_.GetStreamLatencyProfiles(&profiles));
+  EXPECT_THAT(profiles[0].latency().count(), ElementsAre(0, 0, 0));
+  EXPECT_EQ(profiles[0].unmatched_count(), 0);
+
+  simulation_clock->ThreadFinish();
+}
+
 // Tests that AddPacketInfo() uses packet timestamp when
 // use_packet_timestamp_for_added_packet is true.
 TEST_F(GraphProfilerTestPeer, AddPacketInfoUsingPacketTimestamp) {
@@ -1045,6 +1111,192 @@ TEST_F(GraphProfilerTestPeer, AddProcessSample) {
   ASSERT_EQ(GetPacketsInfoMap()->size(), 0);
 }
 
+// Tests that samples added by several threads are merged by
+// GetCalculatorProfiles() and cleared by Reset().
+TEST_F(GraphProfilerTestPeer, AddProcessSampleFromMultipleThreads) {
+  InitializeProfilerWithGraphConfig(R"(
+    profiler_config {
+      enable_profiler: true
+    }
+    input_stream: "input_stream"
+    node {
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+      output_stream: "output_stream"
+    })");
+
+  TestContextBuilder context(kDummyTestCalculatorName, /*node_id=*/0,
+                             {"input_stream"}, {"output_stream"});
+  context.AddInputs({MakePacket<std::string>("5").At(Timestamp(100))});
+  const int kNumThreads = 4;
+  const int kNumSamples = 100;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < kNumSamples; ++i) {
+        AddProcessSample(*context.get(), /*start_time_usec=*/1000,
+                         /*end_time_usec=*/1010);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<CalculatorProfile> profiles = Profiles();
+  ASSERT_EQ(profiles.size(), 1);
+  EXPECT_THAT(profiles[0].process_runtime(),
+              Partially(EqualsProto(CreateTimeHistogram(
+                  /*total=*/10 * kNumThreads * kNumSamples,
+                  {kNumThreads * kNumSamples}))));
+
+  profiler_.Reset();
+  EXPECT_THAT(Profiles()[0].process_runtime(),
+              Partially(EqualsProto(CreateTimeHistogram(/*total=*/0, {0}))));
+}
+
+// Tests that the thread counters are aggregated per calculator, and that
+// counters which were not read are skipped.
+TEST_F(GraphProfilerTestPeer, AddProcessCounters) {
+  InitializeProfilerWithGraphConfig(R"(
+    profiler_config {
+      enable_profiler: true
+      enable_thread_cpu_time: true
+      enable_hardware_counters: true
+    }
+    input_stream: "input_stream"
+    node {
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+      output_stream: "output_stream"
+    })");
+
+  TestContextBuilder context(kDummyTestCalculatorName, /*node_id=*/0,
+                             {"input_stream"}, {"output_stream"});
+  AddProcessCounters(*context.get(), {1000000, 100, 50, 5},
+                     {1250000, 400, 650, 8});
+  AddProcessCounters(*context.get(), {2000000, -1, -1, -1},
+                     {2050000, -1, -1, -1});
+  AddProcessCounters(*context.get(), {}, {});
+
+  std::vector<CalculatorProfile> profiles = Profiles();
+  ASSERT_EQ(profiles.size(), 1);
+  EXPECT_THAT(profiles[0].process_cpu_time(),
+              Partially(EqualsProto(CreateTimeHistogram(/*total=*/300, {2}))));
+  EXPECT_THAT(profiles[0].process_hardware_counters(), EqualsProto(R"pb(
+                count: 1 cycles: 300 instructions: 600 cache_misses: 3
+              )pb"));
+
+  // The counters of a Scope are read from the running thread.
+  {
+    GraphProfiler::Scope profiler_scope(GraphTrace::EVENT_TYPE_PROCESS,
+                                        context.get(), &profiler_);
+  }
+  EXPECT_EQ(Profiles()[0].process_cpu_time().count(0), 3);
+
+  profiler_.Reset();
+  EXPECT_THAT(Profiles()[0].process_cpu_time(),
+              Partially(EqualsProto(CreateTimeHistogram(/*total=*/0, {0}))));
+  EXPECT_FALSE(Profiles()[0].has_process_hardware_counters());
+}
+
+// Tests that storage conversions within a Scope are counted for the calculator,
+// also when they are reported from another thread, and cleared by Reset().
+TEST_F(GraphProfilerTestPeer, AddStorageConversion) {
+  InitializeProfilerWithGraphConfig(R"(
+    profiler_config {
+      enable_profiler: true
+    }
+    input_stream: "input_stream"
+    node {
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+      output_stream: "output_stream"
+    })");
+
+  TestContextBuilder context(kDummyTestCalculatorName, /*node_id=*/0,
+                             {"input_stream"}, {"output_stream"});
+  context.AddInputs({MakePacket<std::string>("5").At(Timestamp(100))});
+  ASSERT_EQ(StorageConversionObserver::Current(), nullptr);
+  {
+    GraphProfiler::Scope profiler_scope(GraphTrace::EVENT_TYPE_PROCESS,
+                                        context.get(), &profiler_);
+    StorageConversionObserver* observer = StorageConversionObserver::Current();
+    ASSERT_NE(observer, nullptr);
+    observer->OnStorageConversion("GlTextureBuffer", "ImageFrame",
+                                  absl::Microseconds(300));
+    std::thread([observer] {
+      StorageConversionObserver::Scope observer_scope(observer);
+      StorageConversionObserver::Current()->OnStorageConversion(
+          "GlTextureBuffer", "ImageFrame", absl::Microseconds(200));
+      StorageConversionObserver::Current()->OnStorageConversion(
+          "ImageFrame", "GlTextureBuffer", absl::Microseconds(50));
+    }).join();
+  }
+  EXPECT_EQ(StorageConversionObserver::Current(), nullptr);
+
+  std::vector<CalculatorProfile> profiles = Profiles();
+  ASSERT_EQ(profiles.size(), 1);
+  EXPECT_THAT(profiles[0].storage_conversions(),
+              testing::UnorderedElementsAre(EqualsProto(R"pb(
+                                              source_storage: "GlTextureBuffer"
+                                              target_storage: "ImageFrame"
+                                              count: 2
+                                              total_time_usec: 500
+                                            )pb"),
+                                            EqualsProto(R"pb(
+                                              source_storage: "ImageFrame"
+                                              target_storage: "GlTextureBuffer"
+                                              count: 1
+                                              total_time_usec: 50
+                                            )pb")));
+
+  profiler_.Reset();
+  EXPECT_TRUE(Profiles()[0].storage_conversions().empty());
+}
+
+// Tests that strict_storage_conversions fails on a conversion by a node that is
+// not listed in allowed_storage_conversion_node.
+TEST_F(GraphProfilerTestPeer, StrictStorageConversions) {
+  InitializeProfilerWithGraphConfig(R"(
+    profiler_config {
+      strict_storage_conversions: true
+      allowed_storage_conversion_node: "Allowed"
+    }
+    input_stream: "input_stream"
+    node {
+      name: "Allowed"
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+      output_stream: "allowed_output"
+    }
+    node {
+      calculator: "DummyTestCalculator"
+      input_stream: "input_stream"
+      output_stream: "output_stream"
+    })");
+
+  TestContextBuilder allowed_context("Allowed", /*node_id=*/0,
+                                     {"input_stream"}, {"allowed_output"});
+  {
+    GraphProfiler::Scope profiler_scope(GraphTrace::EVENT_TYPE_PROCESS,
+                                        allowed_context.get(), &profiler_);
+    StorageConversionObserver::Current()->OnStorageConversion(
+        "GlTextureBuffer", "ImageFrame", absl::Microseconds(300));
+  }
+
+  TestContextBuilder context(kDummyTestCalculatorName, /*node_id=*/1,
+                             {"input_stream"}, {"output_stream"});
+  EXPECT_DEATH(
+      {
+        GraphProfiler::Scope profiler_scope(GraphTrace::EVENT_TYPE_PROCESS,
+                                            context.get(), &profiler_);
+        StorageConversionObserver::Current()->OnStorageConversion(
+            "GlTextureBuffer", "ImageFrame", absl::Microseconds(300));
+      },
+      "DummyTestCalculator.*GlTextureBuffer.*ImageFrame");
+}
+
 // Tests that AddProcessSample() updates |process_runtime| and also updates the
 // packet info map when stream latency is enabled.
 TEST_F(GraphProfilerTestPeer, AddProcessSampleWithStreamLatency) {
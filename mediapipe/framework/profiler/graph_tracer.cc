@@ -14,6 +14,8 @@
 
 #include "mediapipe/framework/profiler/graph_tracer.h"
 
+#include <vector>
+
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "mediapipe/framework/calculator_context.h"
@@ -23,6 +25,11 @@
 #include "mediapipe/framework/profiler/trace_builder.h"
 #include "mediapipe/framework/timestamp.h"
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
 namespace mediapipe {
 
 namespace {
@@ -30,10 +37,32 @@ using EventType = GraphTrace::EventType;
 
 const absl::Duration kDefaultTraceLogInterval = absl::Milliseconds(500);
 
+// The mutex to guard the system thread ids.
+absl::Mutex* system_thread_ids_mutex() {
+  static absl::Mutex system_thread_ids_mutex(absl::kConstInit);
+  return &system_thread_ids_mutex;
+}
+
+// The system thread id for each identifier returned by GetCurrentThreadId.
+std::vector<int64>* system_thread_ids() {
+  static std::vector<int64>* system_thread_ids = new std::vector<int64>();
+  return system_thread_ids;
+}
+
+// Assigns the next thread identifier to the current thread.
+int RegisterCurrentThread() {
+  absl::MutexLock lock(system_thread_ids_mutex());
+#if defined(__linux__)
+  system_thread_ids()->push_back(syscall(SYS_gettid));
+#else
+  system_thread_ids()->push_back(-1);
+#endif  // defined(__linux__)
+  return system_thread_ids()->size() - 1;
+}
+
 // Returns a unique identifier for the current thread.
 inline int GetCurrentThreadId() {
-  static int next_thread_id = 0;
-  static thread_local int thread_id = next_thread_id++;
+  static thread_local int thread_id = RegisterCurrentThread();
   return thread_id;
 }
 
@@ -57,6 +86,14 @@ GraphTracer::GraphTracer(const ProfilerConfig& profiler_config)
     EventType event_type = static_cast<EventType>(disabled);
     (*trace_event_registry())[event_type].set_enabled(false);
   }
+  int sample_interval = profiler_config_.trace_sample_interval();
+  absl::Duration latency_threshold =
+      absl::Microseconds(profiler_config_.trace_latency_threshold_usec());
+  if (latency_threshold > absl::ZeroDuration()) {
+    trace_builder_.SetSampling(sample_interval, latency_threshold);
+  } else {
+    record_sample_interval_ = sample_interval;
+  }
 }
 
 TraceEventRegistry* GraphTracer::trace_event_registry() {
@@ -64,7 +101,8 @@ TraceEventRegistry* GraphTracer::trace_event_registry() {
 }
 
 void GraphTracer::LogEvent(TraceEvent event) {
-  if (!(*trace_event_registry())[event.event_type].enabled()) {
+  if (!(*trace_event_registry())[event.event_type].enabled() ||
+      !IsRecorded(event.input_ts)) {
     return;
   }
   event.set_thread_id(GetCurrentThreadId());
@@ -75,6 +113,9 @@ void GraphTracer::LogInputEvents(GraphTrace::EventType event_type,
                                  const CalculatorContext* context,
                                  absl::Time event_time) {
   Timestamp input_ts = context->InputTimestamp();
+  if (!IsRecorded(input_ts)) {
+    return;
+  }
   for (const InputStreamShard& in_stream : context->Inputs()) {
     const Packet& packet = in_stream.Value();
     if (!packet.IsEmpty()) {
@@ -98,6 +139,9 @@ void GraphTracer::LogOutputEvents(GraphTrace::EventType event_type,
   Timestamp input_ts = (context->Inputs().NumEntries() > 0)
                            ? context->InputTimestamp()
                            : GetOutputTimestamp(context);
+  if (!IsRecorded(input_ts)) {
+    return;
+  }
   for (const OutputStreamShard& out_stream : context->Outputs()) {
     const std::string* stream_id = &out_stream.Name();
     for (const Packet& packet : *out_stream.OutputQueue()) {
@@ -139,6 +183,14 @@ void GraphTracer::GetLog(absl::Time begin_time, absl::Time end_time,
 
 const TraceBuffer& GraphTracer::GetTraceBuffer() { return trace_buffer_; }
 
+int64 GraphTracer::GetSystemThreadId(int thread_id) {
+  absl::MutexLock lock(system_thread_ids_mutex());
+  if (thread_id < 0 || thread_id >= system_thread_ids()->size()) {
+    return -1;
+  }
+  return (*system_thread_ids())[thread_id];
+}
+
 Timestamp GraphTracer::GetOutputTimestamp(const CalculatorContext* context) {
   for (const OutputStreamShard& out_stream : context->Outputs()) {
     for (const Packet& packet : *out_stream.OutputQueue()) {
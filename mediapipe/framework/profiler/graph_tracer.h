@@ -44,6 +44,10 @@ namespace mediapipe {
 //
 //   end_time = current_time - max_packet_latency
 //
+// With ProfilerConfig::trace_sample_interval, only a subset of the input
+// timestamps is traced. With trace_latency_threshold_usec, slow timestamps
+// are also included in the trace output.
+//
 class GraphTracer {
  public:
   // Returns the interval between trace log output.
@@ -81,13 +85,28 @@ class GraphTracer {
   // Returns the logged TraceEvents.
   const TraceBuffer& GetTraceBuffer();
 
+  // Returns the system thread id for a TraceEvent thread_id, or -1 if the
+  // system thread id is not available on this platform.
+  static int64 GetSystemThreadId(int thread_id);
+
  private:
   // Returns the timestamp of the first output packet.
   Timestamp GetOutputTimestamp(const CalculatorContext* context);
 
+  // Returns true if events for input_ts are appended to the TraceBuffer.
+  bool IsRecorded(Timestamp input_ts) const {
+    return record_sample_interval_ <= 1 ||
+           TraceBuilder::IsTimestampSampled(input_ts, record_sample_interval_);
+  }
+
   // The settings for this tracer.
   ProfilerConfig profiler_config_;
 
+  // One in record_sample_interval_ timestamps is appended to the TraceBuffer.
+  // This is 1 when sampling is deferred to trace output by
+  // trace_latency_threshold_usec.
+  int record_sample_interval_ = 1;
+
   // The circular buffer of TraceEvents.
   TraceBuffer trace_buffer_;
 
@@ -18,6 +18,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -68,12 +69,44 @@ class GraphTracerTest : public ::testing::Test {
   }
 
   // Initializes the GraphTracer.
-  void SetUpGraphTracer() {
-    ProfilerConfig profiler_config;
+  void SetUpGraphTracer() { SetUpGraphTracer(ProfilerConfig()); }
+
+  // Initializes the GraphTracer with additional profiler settings.
+  void SetUpGraphTracer(ProfilerConfig profiler_config) {
     profiler_config.set_trace_enabled(true);
     tracer_ = absl::make_unique<GraphTracer>(profiler_config);
   }
 
+  // Logs one Process() call for each timestamp, taking process_time for each
+  // timestamp listed in slow_timestamps and 100 usec for the others.
+  void LogProcessCalls(int num_timestamps,
+                       const std::set<int>& slow_timestamps,
+                       absl::Duration process_time) {
+    SetUpCalculatorContext("PCalculator_1", /*node_id=*/0, {"input_stream"},
+                           {"output_stream"});
+    absl::Time curr_time = start_time_;
+    for (int i = 0; i < num_timestamps; ++i) {
+      Timestamp ts = start_timestamp_ + i;
+      ClearCalculatorContext("PCalculator_1");
+      LogInputPackets("PCalculator_1", GraphTrace::EVENT_TYPE_PROCESS,
+                      curr_time, {MakePacket<int>(i).At(ts)});
+      curr_time += slow_timestamps.count(i) ? process_time
+                                            : absl::Microseconds(100);
+      LogOutputPackets("PCalculator_1", GraphTrace::EVENT_TYPE_PROCESS,
+                       curr_time, {{MakePacket<int>(i).At(ts)}});
+    }
+  }
+
+  // Returns the input timestamps in a GraphTrace.
+  static std::set<int64> TracedTimestamps(const GraphTrace& trace) {
+    std::set<int64> result;
+    for (const auto& calculator_trace : trace.calculator_trace()) {
+      result.insert(trace.base_timestamp() +
+                    calculator_trace.input_timestamp());
+    }
+    return result;
+  }
+
   // Initializes the input and output stream specs for a calculator node.
   void SetUpCalculatorContext(const std::string& node_name, int node_id,
                               const std::vector<std::string>& inputs,
@@ -169,6 +202,39 @@ TEST_F(GraphTracerTest, CalculatorTrace) {
       )pb")));
 }
 
+// Tests that trace_sample_interval traces a subset of the timestamps.
+TEST_F(GraphTracerTest, SampledTrace) {
+  ProfilerConfig profiler_config;
+  profiler_config.set_trace_sample_interval(4);
+  SetUpGraphTracer(profiler_config);
+  LogProcessCalls(/*num_timestamps=*/100, {}, absl::ZeroDuration());
+
+  std::set<int64> expected;
+  for (int i = 0; i < 100; ++i) {
+    Timestamp ts = start_timestamp_ + i;
+    if (TraceBuilder::IsTimestampSampled(ts, 4)) {
+      expected.insert(ts.Value());
+    }
+  }
+  EXPECT_GT(expected.size(), 10);
+  EXPECT_LT(expected.size(), 50);
+  EXPECT_EQ(TracedTimestamps(GetTrace()), expected);
+}
+
+// Tests that trace_latency_threshold_usec also traces slow timestamps.
+TEST_F(GraphTracerTest, LatencyThresholdTrace) {
+  ProfilerConfig profiler_config;
+  profiler_config.set_trace_sample_interval(1000000);
+  profiler_config.set_trace_latency_threshold_usec(5000);
+  SetUpGraphTracer(profiler_config);
+  LogProcessCalls(/*num_timestamps=*/100, {17, 42}, absl::Milliseconds(10));
+
+  std::set<int64> traced = TracedTimestamps(GetTrace());
+  EXPECT_EQ(traced.count((start_timestamp_ + 17).Value()), 1);
+  EXPECT_EQ(traced.count((start_timestamp_ + 42).Value()), 1);
+  EXPECT_LE(traced.size(), 3);
+}
+
 TEST_F(GraphTracerTest, GraphTrace) {
   // Define the GraphTracer, the CalculatorState, and the stream specs.
   SetUpGraphTracer();
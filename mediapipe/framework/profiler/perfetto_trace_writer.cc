@@ -0,0 +1,330 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/profiler/perfetto_trace_writer.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/profiler/graph_tracer.h"
+
+#if defined(__linux__)
+#include <time.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+namespace mediapipe {
+
+namespace {
+
+// Field numbers of the Perfetto trace protos, see
+// perfetto/protos/perfetto/trace/trace_packet.proto and its dependencies.
+constexpr int kTracePacket = 1;
+
+constexpr int kPacketClockSnapshot = 6;
+constexpr int kPacketTimestamp = 8;
+constexpr int kPacketSequenceId = 10;
+constexpr int kPacketTrackEvent = 11;
+constexpr int kPacketSequenceFlags = 13;
+constexpr int kPacketTimestampClockId = 58;
+constexpr int kPacketTrackDescriptor = 60;
+
+constexpr int kClockSnapshotClocks = 1;
+constexpr int kClockId = 1;
+constexpr int kClockTimestamp = 2;
+
+constexpr int kTrackUuid = 1;
+constexpr int kTrackName = 2;
+constexpr int kTrackProcess = 3;
+constexpr int kTrackThread = 4;
+constexpr int kTrackParentUuid = 5;
+
+constexpr int kProcessPid = 1;
+constexpr int kProcessName = 6;
+
+constexpr int kThreadPid = 1;
+constexpr int kThreadTid = 2;
+constexpr int kThreadName = 5;
+
+constexpr int kEventDebugAnnotations = 4;
+constexpr int kEventType = 9;
+constexpr int kEventTrackUuid = 11;
+constexpr int kEventCategories = 22;
+constexpr int kEventName = 23;
+
+constexpr int kAnnotationIntValue = 4;
+constexpr int kAnnotationName = 10;
+
+// Values of TrackEvent.Type.
+constexpr int kSliceBegin = 1;
+constexpr int kSliceEnd = 2;
+constexpr int kInstant = 3;
+
+// Values of BuiltinClock.
+constexpr int kClockRealtime = 1;
+constexpr int kClockMonotonic = 3;
+constexpr int kClockBoottime = 6;
+
+// Value of TracePacket.SequenceFlags.
+constexpr int kSequenceIncrementalStateCleared = 1;
+
+// The packet sequence used for all packets of this process.
+constexpr uint64 kSequenceId = 0x6d707065;
+
+// The kinds of tracks, used to form track uuids.
+enum TrackKind { kProcessTrack = 1, kThreadTrack, kCalculatorTrack, kGpuTrack };
+
+// Appends fields to a serialized protobuf message.
+class ProtoBuilder {
+ public:
+  ProtoBuilder& Varint(int field, uint64 value) {
+    AppendVarint(static_cast<uint64>(field) << 3);
+    AppendVarint(value);
+    return *this;
+  }
+
+  ProtoBuilder& Bytes(int field, absl::string_view value) {
+    AppendVarint((static_cast<uint64>(field) << 3) | 2);
+    AppendVarint(value.size());
+    data_.append(value.data(), value.size());
+    return *this;
+  }
+
+  ProtoBuilder& Message(int field, const ProtoBuilder& message) {
+    return Bytes(field, message.data());
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  void AppendVarint(uint64 value) {
+    while (value >= 0x80) {
+      data_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+  }
+
+  std::string data_;
+};
+
+// Appends a TracePacket to a serialized Perfetto Trace.
+void AppendPacket(ProtoBuilder packet, std::string* output) {
+  packet.Varint(kPacketSequenceId, kSequenceId);
+  output->append(ProtoBuilder().Message(kTracePacket, packet).data());
+}
+
+int64 CurrentProcessId() {
+#if defined(__linux__)
+  return getpid();
+#else
+  return 1;
+#endif  // defined(__linux__)
+}
+
+uint64 TrackUuid(int64 pid, TrackKind kind, int64 id) {
+  return (static_cast<uint64>(pid) << 36) ^
+         (static_cast<uint64>(kind) << 32) ^ static_cast<uint32>(id);
+}
+
+// Returns the time of a GraphTrace event in nanoseconds.
+uint64 EventTimeNanos(const GraphTrace& trace, int64 time) {
+  return static_cast<uint64>(trace.base_time() + time) * 1000;
+}
+
+// Returns an event type name without the "EVENT_TYPE_" prefix.
+std::string EventTypeName(GraphTrace::EventType event_type) {
+  return std::string(absl::StripPrefix(GraphTrace::EventType_Name(event_type),
+                                       "EVENT_TYPE_"));
+}
+
+}  // namespace
+
+PerfettoTraceWriter::PerfettoTraceWriter(
+    std::vector<std::string> calculator_names)
+    : calculator_names_(std::move(calculator_names)),
+      pid_(CurrentProcessId()),
+      process_uuid_(TrackUuid(pid_, kProcessTrack, 0)) {}
+
+void PerfettoTraceWriter::WriteTrace(const GraphTrace& trace,
+                                     std::string* output) {
+  if (!wrote_clock_snapshot_) {
+    WriteClockSnapshot(output);
+    wrote_clock_snapshot_ = true;
+  }
+  WriteProcessTrack(output);
+  for (const GraphTrace::CalculatorTrace& event : trace.calculator_trace()) {
+    WriteCalculatorTrace(trace, event, output);
+  }
+}
+
+void PerfettoTraceWriter::WriteClockSnapshot(std::string* output) {
+  // Relates the realtime clock of the events to the clocks of a system trace,
+  // such as the boottime clock of ftrace events.
+  ProtoBuilder snapshot;
+  auto add_clock = [&snapshot](int clock_id, uint64 timestamp) {
+    snapshot.Message(kClockSnapshotClocks, ProtoBuilder()
+                                               .Varint(kClockId, clock_id)
+                                               .Varint(kClockTimestamp,
+                                                       timestamp));
+  };
+  add_clock(kClockRealtime, absl::ToUnixNanos(absl::Now()));
+#if defined(__linux__)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_BOOTTIME, &ts) == 0) {
+    add_clock(kClockBoottime, ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+  }
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+    add_clock(kClockMonotonic, ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+  }
+#endif  // defined(__linux__)
+  AppendPacket(
+      ProtoBuilder()
+          .Message(kPacketClockSnapshot, snapshot)
+          .Varint(kPacketSequenceFlags, kSequenceIncrementalStateCleared),
+      output);
+}
+
+void PerfettoTraceWriter::WriteProcessTrack(std::string* output) {
+  if (!written_tracks_.insert(process_uuid_).second) {
+    return;
+  }
+  ProtoBuilder process;
+  process.Varint(kProcessPid, pid_).Bytes(kProcessName, "mediapipe");
+  AppendPacket(ProtoBuilder().Message(kPacketTrackDescriptor,
+                                      ProtoBuilder()
+                                          .Varint(kTrackUuid, process_uuid_)
+                                          .Message(kTrackProcess, process)),
+               output);
+}
+
+uint64 PerfettoTraceWriter::WriteThreadTrack(int thread_id,
+                                             std::string* output) {
+  uint64 uuid = TrackUuid(pid_, kThreadTrack, thread_id);
+  if (!written_tracks_.insert(uuid).second) {
+    return uuid;
+  }
+  int64 tid = GraphTracer::GetSystemThreadId(thread_id);
+  ProtoBuilder thread;
+  thread.Varint(kThreadPid, pid_)
+      .Varint(kThreadTid, tid >= 0 ? tid : thread_id + 1)
+      .Bytes(kThreadName, absl::StrCat("mediapipe_", thread_id));
+  AppendPacket(ProtoBuilder().Message(kPacketTrackDescriptor,
+                                      ProtoBuilder()
+                                          .Varint(kTrackUuid, uuid)
+                                          .Varint(kTrackParentUuid,
+                                                  process_uuid_)
+                                          .Message(kTrackThread, thread)),
+               output);
+  return uuid;
+}
+
+uint64 PerfettoTraceWriter::WriteCalculatorTrack(int node_id,
+                                                 std::string* output) {
+  uint64 uuid = TrackUuid(pid_, kCalculatorTrack, node_id);
+  if (!written_tracks_.insert(uuid).second) {
+    return uuid;
+  }
+  AppendPacket(ProtoBuilder().Message(
+                   kPacketTrackDescriptor,
+                   ProtoBuilder()
+                       .Varint(kTrackUuid, uuid)
+                       .Varint(kTrackParentUuid, process_uuid_)
+                       .Bytes(kTrackName, CalculatorName(node_id))),
+               output);
+  return uuid;
+}
+
+uint64 PerfettoTraceWriter::WriteGpuTrack(int thread_id, std::string* output) {
+  uint64 uuid = TrackUuid(pid_, kGpuTrack, thread_id);
+  if (!written_tracks_.insert(uuid).second) {
+    return uuid;
+  }
+  AppendPacket(
+      ProtoBuilder().Message(
+          kPacketTrackDescriptor,
+          ProtoBuilder()
+              .Varint(kTrackUuid, uuid)
+              .Varint(kTrackParentUuid, process_uuid_)
+              .Bytes(kTrackName, absl::StrCat("GPU (mediapipe_", thread_id,
+                                              ")"))),
+      output);
+  return uuid;
+}
+
+void PerfettoTraceWriter::WriteCalculatorTrace(
+    const GraphTrace& trace, const GraphTrace::CalculatorTrace& event,
+    std::string* output) {
+  // GPU timings are measured separately from the CPU work of their thread.
+  std::vector<uint64> tracks;
+  if (event.event_type() == GraphTrace::EVENT_TYPE_GPU_TASK ||
+      event.event_type() == GraphTrace::EVENT_TYPE_GPU_CALIBRATION) {
+    tracks.push_back(WriteGpuTrack(event.thread_id(), output));
+  } else {
+    tracks.push_back(WriteThreadTrack(event.thread_id(), output));
+    tracks.push_back(WriteCalculatorTrack(event.node_id(), output));
+  }
+
+  ProtoBuilder begin_event;
+  begin_event.Bytes(kEventName, CalculatorName(event.node_id()))
+      .Bytes(kEventCategories, EventTypeName(event.event_type()));
+  if (event.has_input_timestamp()) {
+    begin_event.Message(
+        kEventDebugAnnotations,
+        ProtoBuilder()
+            .Bytes(kAnnotationName, "input_timestamp")
+            .Varint(kAnnotationIntValue,
+                    trace.base_timestamp() + event.input_timestamp()));
+  }
+  const bool is_slice = event.has_start_time() && event.has_finish_time();
+  const int64 begin_time =
+      event.has_start_time() ? event.start_time() : event.finish_time();
+  for (uint64 track : tracks) {
+    AppendPacket(
+        ProtoBuilder()
+            .Varint(kPacketTimestamp, EventTimeNanos(trace, begin_time))
+            .Varint(kPacketTimestampClockId, kClockRealtime)
+            .Message(kPacketTrackEvent,
+                     ProtoBuilder(begin_event)
+                         .Varint(kEventType, is_slice ? kSliceBegin : kInstant)
+                         .Varint(kEventTrackUuid, track)),
+        output);
+    if (is_slice) {
+      AppendPacket(
+          ProtoBuilder()
+              .Varint(kPacketTimestamp,
+                      EventTimeNanos(trace, event.finish_time()))
+              .Varint(kPacketTimestampClockId, kClockRealtime)
+              .Message(kPacketTrackEvent, ProtoBuilder()
+                                              .Varint(kEventType, kSliceEnd)
+                                              .Varint(kEventTrackUuid, track)),
+          output);
+    }
+  }
+}
+
+std::string PerfettoTraceWriter::CalculatorName(int node_id) const {
+  if (node_id >= 0 && node_id < calculator_names_.size()) {
+    return calculator_names_[node_id];
+  }
+  return node_id < 0 ? "graph_input" : absl::StrCat("node_", node_id);
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,83 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PROFILER_PERFETTO_TRACE_WRITER_H_
+#define MEDIAPIPE_FRAMEWORK_PROFILER_PERFETTO_TRACE_WRITER_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/calculator_profile.pb.h"
+#include "mediapipe/framework/port/integral_types.h"
+
+namespace mediapipe {
+
+// Converts GraphTrace records into the Perfetto trace format.
+//
+// The output of successive WriteTrace calls can be concatenated into a
+// single Perfetto trace file, which can be opened in ui.perfetto.dev or
+// trace_processor. Each calculator task becomes a slice on two tracks: the
+// track of the thread that ran it, and the track of its calculator. GPU
+// timings are placed on a separate track for each GL context thread.
+//
+// Threads are described with their system thread ids where available, and
+// event times are recorded against the realtime clock along with a clock
+// snapshot, so that the trace can be merged with a system trace of kernel
+// scheduling and GPU activity recorded at the same time.
+//
+// Only calculator traces with both a start_time and a finish_time become
+// slices. Other events, such as those written with trace_log_instant_events,
+// become instant events.
+class PerfettoTraceWriter {
+ public:
+  // Creates a writer for a graph with the given calculator names, indexed by
+  // node id.
+  explicit PerfettoTraceWriter(std::vector<std::string> calculator_names);
+
+  // Appends the events of a GraphTrace to output, as serialized Perfetto
+  // TracePackets. Track descriptors are written once per writer.
+  void WriteTrace(const GraphTrace& trace, std::string* output);
+
+ private:
+  // Writes a ClockSnapshot relating the event clock to the system clocks.
+  void WriteClockSnapshot(std::string* output);
+
+  // Writes the TrackDescriptor of a track, unless it is already written.
+  void WriteProcessTrack(std::string* output);
+  uint64 WriteThreadTrack(int thread_id, std::string* output);
+  uint64 WriteCalculatorTrack(int node_id, std::string* output);
+  uint64 WriteGpuTrack(int thread_id, std::string* output);
+
+  // Writes a TrackEvent for each CalculatorTrace.
+  void WriteCalculatorTrace(const GraphTrace& trace,
+                            const GraphTrace::CalculatorTrace& event,
+                            std::string* output);
+
+  // Returns the name of a calculator by node id.
+  std::string CalculatorName(int node_id) const;
+
+  std::vector<std::string> calculator_names_;
+  // The process id, and the uuid of the process track.
+  int64 pid_;
+  uint64 process_uuid_;
+  // The uuids of the tracks with a written TrackDescriptor.
+  std::set<uint64> written_tracks_;
+  // Indicates that the clock snapshot has been written.
+  bool wrote_clock_snapshot_ = false;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PROFILER_PERFETTO_TRACE_WRITER_H_
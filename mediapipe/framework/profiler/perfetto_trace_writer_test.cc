@@ -0,0 +1,172 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/profiler/perfetto_trace_writer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/calculator_profile.pb.h"
+#include "mediapipe/framework/port/advanced_proto_lite_inc.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+
+namespace mediapipe {
+namespace {
+
+// A field of a serialized protobuf message.
+struct Field {
+  int number;
+  uint64_t varint = 0;
+  std::string bytes;
+};
+
+// Returns the varint and length-delimited fields of a serialized message.
+std::vector<Field> ParseFields(const std::string& data) {
+  std::vector<Field> result;
+  proto_ns::io::CodedInputStream in(
+      reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  while (uint32_t tag = in.ReadTag()) {
+    Field field{static_cast<int>(tag >> 3)};
+    if ((tag & 7) == 0) {
+      EXPECT_TRUE(in.ReadVarint64(&field.varint));
+    } else if ((tag & 7) == 2) {
+      uint32_t size;
+      EXPECT_TRUE(in.ReadVarint32(&size));
+      EXPECT_TRUE(in.ReadString(&field.bytes, size));
+    } else {
+      ADD_FAILURE() << "Unexpected wire type in tag: " << tag;
+      break;
+    }
+    result.push_back(field);
+  }
+  return result;
+}
+
+// Returns the first field with a field number, or an empty field.
+Field GetField(const std::vector<Field>& fields, int number) {
+  for (const Field& field : fields) {
+    if (field.number == number) {
+      return field;
+    }
+  }
+  return Field{0};
+}
+
+// A TrackEvent summarized for testing.
+struct TrackEvent {
+  uint64_t timestamp;
+  uint64_t type;
+  uint64_t track_uuid;
+  std::string name;
+};
+
+// Summarizes the packets of a serialized Perfetto Trace.
+void ParseTrace(const std::string& data, int* num_clock_snapshots,
+                std::vector<std::string>* track_names,
+                std::vector<TrackEvent>* events) {
+  for (const Field& packet_field : ParseFields(data)) {
+    ASSERT_EQ(packet_field.number, 1);
+    std::vector<Field> packet = ParseFields(packet_field.bytes);
+    if (GetField(packet, 6).number) {
+      ++*num_clock_snapshots;
+    }
+    Field descriptor = GetField(packet, 60);
+    if (descriptor.number) {
+      std::vector<Field> fields = ParseFields(descriptor.bytes);
+      Field thread = GetField(fields, 4);
+      track_names->push_back(
+          thread.number ? GetField(ParseFields(thread.bytes), 5).bytes
+                        : GetField(fields, 2).bytes);
+    }
+    Field event = GetField(packet, 11);
+    if (event.number) {
+      std::vector<Field> fields = ParseFields(event.bytes);
+      events->push_back({GetField(packet, 8).varint, GetField(fields, 9).varint,
+                         GetField(fields, 11).varint,
+                         GetField(fields, 23).bytes});
+    }
+  }
+}
+
+TEST(PerfettoTraceWriterTest, WritesTracksAndSlices) {
+  GraphTrace trace = ParseTextProtoOrDie<GraphTrace>(R"pb(
+    base_time: 1000
+    base_timestamp: 0
+    calculator_trace {
+      node_id: 0
+      input_timestamp: 100
+      event_type: EVENT_TYPE_PROCESS
+      start_time: 10
+      finish_time: 20
+      thread_id: 0
+    }
+    calculator_trace {
+      node_id: 1
+      input_timestamp: 100
+      event_type: EVENT_TYPE_PROCESS
+      start_time: 30
+      finish_time: 50
+      thread_id: 0
+    }
+    calculator_trace {
+      node_id: 1
+      event_type: EVENT_TYPE_NOT_READY
+      start_time: 60
+      thread_id: 0
+    }
+  )pb");
+  PerfettoTraceWriter writer({"calc_a", "calc_b"});
+  std::string output;
+  writer.WriteTrace(trace, &output);
+
+  int num_clock_snapshots = 0;
+  std::vector<std::string> track_names;
+  std::vector<TrackEvent> events;
+  ParseTrace(output, &num_clock_snapshots, &track_names, &events);
+  EXPECT_EQ(num_clock_snapshots, 1);
+  EXPECT_THAT(track_names,
+              testing::ElementsAre("", "mediapipe_0", "calc_a", "calc_b"));
+
+  // Each slice is written to the thread track and to the calculator track.
+  ASSERT_EQ(events.size(), 10);
+  EXPECT_EQ(events[0].type, 1);
+  EXPECT_EQ(events[0].name, "calc_a");
+  EXPECT_EQ(events[0].timestamp, 1010000);
+  EXPECT_EQ(events[1].type, 2);
+  EXPECT_EQ(events[1].timestamp, 1020000);
+  EXPECT_EQ(events[0].track_uuid, events[1].track_uuid);
+  EXPECT_NE(events[0].track_uuid, events[2].track_uuid);
+  EXPECT_EQ(events[4].name, "calc_b");
+  EXPECT_EQ(events[4].track_uuid, events[0].track_uuid);
+  // An event without a finish_time becomes an instant event.
+  EXPECT_EQ(events[8].type, 3);
+  EXPECT_EQ(events[8].timestamp, 1060000);
+
+  // Track descriptors are written only once.
+  output.clear();
+  writer.WriteTrace(trace, &output);
+  num_clock_snapshots = 0;
+  track_names.clear();
+  events.clear();
+  ParseTrace(output, &num_clock_snapshots, &track_names, &events);
+  EXPECT_EQ(num_clock_snapshots, 0);
+  EXPECT_TRUE(track_names.empty());
+  EXPECT_EQ(events.size(), 10);
+}
+
+}  // namespace
+}  // namespace mediapipe
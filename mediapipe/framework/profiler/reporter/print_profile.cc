@@ -35,6 +35,9 @@ ABSL_FLAG(std::vector<std::string>, cols, {"*"},
           "allowed.");
 ABSL_FLAG(bool, compact, false,
           "if true, then don't print unnecessary whitespace.");
+ABSL_FLAG(double, speedup_percent, 10,
+          "hypothetical speedup of each calculator, in percent of its "
+          "process time, reported in the speedup_gain_mean column.");
 
 using mediapipe::reporter::Reporter;
 
@@ -46,6 +49,7 @@ int main(int argc, char** argv) {
 
   Reporter reporter;
   reporter.set_compact(absl::GetFlag(FLAGS_compact));
+  reporter.set_speedup_percent(absl::GetFlag(FLAGS_speedup_percent));
   const auto result = reporter.set_columns(absl::GetFlag(FLAGS_cols));
   if (result.message().length()) {
     std::cout << "WARNING" << std::endl << result.message();
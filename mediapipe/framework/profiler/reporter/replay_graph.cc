@@ -0,0 +1,324 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This program replays a recorded PacketDump into a MediaPipe graph, either as
+// fast as possible or at the recorded pace, and reports the throughput and
+// latency percentiles of each calculator node and graph output stream. It is
+// meant for comparing the performance of a graph before and after a change.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_profile.pb.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/profiler/reporter/packet_dump.pb.h"
+#include "mediapipe/framework/tool/validate_name.h"
+
+ABSL_FLAG(std::string, calculator_graph_config_file, "",
+          "Name of file containing text format CalculatorGraphConfig proto.");
+ABSL_FLAG(std::string, input_side_packets, "",
+          "Comma-separated list of key=value pairs specifying side packets "
+          "for the CalculatorGraph. All values will be treated as the "
+          "string type.");
+ABSL_FLAG(std::string, packet_dump_file, "",
+          "Name of file containing the PacketDump proto to replay, in text "
+          "format if the name ends with .pbtxt and in binary format "
+          "otherwise.");
+ABSL_FLAG(double, replay_speed, 0,
+          "Speed relative to the recorded send times at which packets are "
+          "sent, e.g. 1 for the recorded pace and 2 for twice as fast. 0 "
+          "sends packets as fast as the graph accepts them.");
+ABSL_FLAG(int, num_runs, 1,
+          "Number of times the packet dump is replayed. Statistics are "
+          "accumulated over all runs.");
+ABSL_FLAG(int64_t, histogram_interval_usec, 100,
+          "Resolution of the calculator runtime percentiles, in "
+          "microseconds.");
+ABSL_FLAG(int64_t, num_histogram_intervals, 10000,
+          "Number of calculator runtime histogram intervals. Runtimes beyond "
+          "num_histogram_intervals * histogram_interval_usec are counted in "
+          "the last interval.");
+
+namespace mediapipe {
+namespace {
+
+constexpr double kPercentiles[] = {50, 90, 99};
+
+// Packets sent into the graph, with their payloads decoded.
+struct ReplayPacket {
+  std::string stream;
+  Packet packet;
+  absl::Duration send_time;
+};
+
+// The end-to-end latency and count of packets on a graph output stream.
+struct StreamStats {
+  std::vector<int64_t> latencies_usec;
+};
+
+// Per-node statistics accumulated over runs.
+struct NodeStats {
+  TimeHistogram process_runtime;
+};
+
+// Returns the nearest-rank percentile of sorted values.
+int64_t SortedPercentile(const std::vector<int64_t>& sorted,
+                         double percentile) {
+  if (sorted.empty()) return 0;
+  size_t rank =
+      static_cast<size_t>(std::ceil(percentile / 100 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+// Returns the upper end of the histogram interval holding a percentile.
+int64_t HistogramPercentile(const TimeHistogram& histogram,
+                            double percentile) {
+  int64_t total_count = 0;
+  for (int64_t count : histogram.count()) total_count += count;
+  if (total_count == 0) return 0;
+  int64_t rank =
+      static_cast<int64_t>(std::ceil(percentile / 100 * total_count));
+  int64_t seen = 0;
+  for (int i = 0; i < histogram.count_size(); ++i) {
+    seen += histogram.count(i);
+    if (seen >= std::max<int64_t>(rank, 1)) {
+      return (i + 1) * histogram.interval_size_usec();
+    }
+  }
+  return histogram.count_size() * histogram.interval_size_usec();
+}
+
+// Adds the counts of one histogram to another with the same intervals.
+void AccumulateHistogram(const TimeHistogram& from, TimeHistogram* to) {
+  if (to->count_size() == 0) {
+    *to = from;
+    return;
+  }
+  to->set_total(to->total() + from.total());
+  for (int i = 0; i < from.count_size() && i < to->count_size(); ++i) {
+    to->set_count(i, to->count(i) + from.count(i));
+  }
+}
+
+absl::StatusOr<std::vector<ReplayPacket>> ReadPacketDump(
+    const std::string& file_name) {
+  std::string contents;
+  MP_RETURN_IF_ERROR(file::GetContents(file_name, &contents));
+  PacketDump dump;
+  if (absl::EndsWith(file_name, ".pbtxt")) {
+    RET_CHECK(ParseTextProto(contents, &dump))
+        << "Failed to parse " << file_name;
+  } else {
+    RET_CHECK(dump.ParseFromString(contents))
+        << "Failed to parse " << file_name;
+  }
+  std::vector<ReplayPacket> result;
+  for (const auto& stream_packet : dump.packet()) {
+    const std::string& type_url = stream_packet.payload().type_url();
+    std::string type_name = type_url.substr(type_url.rfind('/') + 1);
+    ASSIGN_OR_RETURN(Packet packet,
+                     packet_internal::PacketFromDynamicProto(
+                         type_name, stream_packet.payload().value()));
+    result.push_back(
+        {stream_packet.stream(),
+         packet.At(Timestamp(stream_packet.timestamp())),
+         absl::Microseconds(stream_packet.send_time_usec())});
+  }
+  return result;
+}
+
+absl::StatusOr<std::map<std::string, Packet>> ParseSidePackets() {
+  std::map<std::string, Packet> result;
+  if (absl::GetFlag(FLAGS_input_side_packets).empty()) return result;
+  std::vector<std::string> kv_pairs =
+      absl::StrSplit(absl::GetFlag(FLAGS_input_side_packets), ',');
+  for (const std::string& kv_pair : kv_pairs) {
+    std::vector<std::string> name_and_value = absl::StrSplit(kv_pair, '=');
+    RET_CHECK(name_and_value.size() == 2);
+    RET_CHECK(result.count(name_and_value[0]) == 0);
+    result[name_and_value[0]] = MakePacket<std::string>(name_and_value[1]);
+  }
+  return result;
+}
+
+// Replays the packets into a new graph once, adding to the statistics.
+absl::Status ReplayOnce(const CalculatorGraphConfig& config,
+                        const std::map<std::string, Packet>& side_packets,
+                        const std::vector<ReplayPacket>& packets,
+                        std::map<std::string, StreamStats>* stream_stats,
+                        std::map<std::string, NodeStats>* node_stats,
+                        absl::Duration* wall_time) {
+  CalculatorGraph graph;
+  MP_RETURN_IF_ERROR(graph.Initialize(config, side_packets));
+
+  // The wall time at which the first packet of each timestamp was sent.
+  absl::Mutex mutex;
+  std::map<Timestamp, absl::Time> send_times;
+  for (const std::string& stream : config.output_stream()) {
+    std::string tag, name;
+    int index;
+    MP_RETURN_IF_ERROR(tool::ParseTagIndexName(stream, &tag, &index, &name));
+    StreamStats* stats = &(*stream_stats)[name];
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream(
+        name, [&mutex, &send_times, stats](const Packet& packet) {
+          absl::Time now = absl::Now();
+          absl::MutexLock lock(&mutex);
+          auto it = send_times.find(packet.Timestamp());
+          if (it != send_times.end()) {
+            stats->latencies_usec.push_back(
+                absl::ToInt64Microseconds(now - it->second));
+          }
+          return absl::OkStatus();
+        }));
+  }
+
+  MP_RETURN_IF_ERROR(graph.StartRun({}));
+  const double speed = absl::GetFlag(FLAGS_replay_speed);
+  const absl::Time start_time = absl::Now();
+  for (const ReplayPacket& replay_packet : packets) {
+    if (speed > 0) {
+      absl::SleepFor(start_time + replay_packet.send_time / speed -
+                     absl::Now());
+    }
+    {
+      absl::MutexLock lock(&mutex);
+      send_times.emplace(replay_packet.packet.Timestamp(), absl::Now());
+    }
+    MP_RETURN_IF_ERROR(graph.AddPacketToInputStream(replay_packet.stream,
+                                                    replay_packet.packet));
+  }
+  MP_RETURN_IF_ERROR(graph.CloseAllPacketSources());
+  MP_RETURN_IF_ERROR(graph.WaitUntilDone());
+  *wall_time += absl::Now() - start_time;
+
+  std::vector<CalculatorProfile> profiles;
+  MP_RETURN_IF_ERROR(graph.profiler()->GetCalculatorProfiles(&profiles));
+  for (const CalculatorProfile& profile : profiles) {
+    AccumulateHistogram(profile.process_runtime(),
+                        &(*node_stats)[profile.name()].process_runtime);
+  }
+  return absl::OkStatus();
+}
+
+void PrintRow(const std::string& name, int64_t count, double rate,
+              const std::vector<int64_t>& percentiles) {
+  std::cout << absl::StrFormat("%-48s %10d %12.1f", name, count, rate);
+  for (int64_t value : percentiles) {
+    std::cout << absl::StrFormat(" %10d", value);
+  }
+  std::cout << "\n";
+}
+
+void PrintHeader(const std::string& name, const std::string& count,
+                 const std::string& rate) {
+  std::cout << absl::StrFormat("%-48s %10s %12s", name, count, rate);
+  for (double percentile : kPercentiles) {
+    std::cout << absl::StrFormat(" %10s", absl::StrCat("p", percentile, "_us"));
+  }
+  std::cout << "\n";
+}
+
+absl::Status RunReplay() {
+  std::string config_contents;
+  MP_RETURN_IF_ERROR(file::GetContents(
+      absl::GetFlag(FLAGS_calculator_graph_config_file), &config_contents));
+  CalculatorGraphConfig config;
+  RET_CHECK(ParseTextProto(config_contents, &config))
+      << "Failed to parse the graph config.";
+  ProfilerConfig* profiler_config = config.mutable_profiler_config();
+  profiler_config->set_enable_profiler(true);
+  profiler_config->set_histogram_interval_size_usec(
+      absl::GetFlag(FLAGS_histogram_interval_usec));
+  profiler_config->set_num_histogram_intervals(
+      absl::GetFlag(FLAGS_num_histogram_intervals));
+
+  ASSIGN_OR_RETURN(auto side_packets, ParseSidePackets());
+  ASSIGN_OR_RETURN(auto packets,
+                   ReadPacketDump(absl::GetFlag(FLAGS_packet_dump_file)));
+  RET_CHECK(!packets.empty()) << "The packet dump is empty.";
+
+  std::map<std::string, StreamStats> stream_stats;
+  std::map<std::string, NodeStats> node_stats;
+  absl::Duration wall_time;
+  for (int run = 0; run < absl::GetFlag(FLAGS_num_runs); ++run) {
+    MP_RETURN_IF_ERROR(ReplayOnce(config, side_packets, packets, &stream_stats,
+                                  &node_stats, &wall_time));
+  }
+  const double seconds = absl::ToDoubleSeconds(wall_time);
+
+  std::cout << absl::StrFormat("Replayed %d packets %d times in %.3f s.\n\n",
+                               packets.size(), absl::GetFlag(FLAGS_num_runs),
+                               seconds);
+  PrintHeader("calculator", "calls", "calls_per_s");
+  for (const auto& [name, stats] : node_stats) {
+    int64_t calls = 0;
+    for (int64_t count : stats.process_runtime.count()) calls += count;
+    std::vector<int64_t> percentiles;
+    for (double percentile : kPercentiles) {
+      percentiles.push_back(
+          HistogramPercentile(stats.process_runtime, percentile));
+    }
+    PrintRow(name, calls, calls / seconds, percentiles);
+  }
+  std::cout << "\n";
+  PrintHeader("output_stream", "packets", "packets_per_s");
+  for (auto& [name, stats] : stream_stats) {
+    std::sort(stats.latencies_usec.begin(), stats.latencies_usec.end());
+    std::vector<int64_t> percentiles;
+    for (double percentile : kPercentiles) {
+      percentiles.push_back(SortedPercentile(stats.latencies_usec, percentile));
+    }
+    PrintRow(name, stats.latencies_usec.size(),
+             stats.latencies_usec.size() / seconds, percentiles);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace mediapipe
+
+int main(int argc, char** argv) {
+  absl::SetProgramUsageMessage(
+      "Replays a packet dump into a MediaPipe graph and reports throughput "
+      "and latency percentiles.");
+  absl::ParseCommandLine(argc, argv);
+  absl::Status status = mediapipe::RunReplay();
+  if (!status.ok()) {
+    ABSL_LOG(ERROR) << "Failed to replay the graph: " << status.message();
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -2,10 +2,13 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <ostream>
+#include <set>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/container/btree_map.h"
@@ -91,6 +94,30 @@ absl::btree_map<std::string,
         {"input_latency_total",
          [](const CalculatorData& d) -> const std::string {
            return ToString(d.input_latency_stat.total());
+         }},
+        {"queue_time_mean",
+         [](const CalculatorData& d) -> const std::string {
+           return ToStringF(d.queue_time_stat.mean());
+         }},
+        {"queue_time_total",
+         [](const CalculatorData& d) -> const std::string {
+           return ToString(d.queue_time_stat.total());
+         }},
+        {"input_wait_mean",
+         [](const CalculatorData& d) -> const std::string {
+           return ToStringF(d.input_wait_stat.mean());
+         }},
+        {"input_wait_total",
+         [](const CalculatorData& d) -> const std::string {
+           return ToString(d.input_wait_stat.total());
+         }},
+        {"critical_path_percent",
+         [](const CalculatorData& d) -> const std::string {
+           return ToStringF(d.critical_path_percent);
+         }},
+        {"speedup_gain_mean",
+         [](const CalculatorData& d) -> const std::string {
+           return ToStringF(d.speedup_gain_mean);
          }}};
 
 // Holds calculator traces that have an output trace with a provided stream ID
@@ -211,6 +238,211 @@ void CompleteCalculatorData(
                                     ? 0
                                     : 1.0 / calc_data.time_stat.mean() * 1.0E+6;
     calc_data.thread_count = calc_data.threads.size();
+
+    const int timestamp_count = graph_data.latency_stat.data_count();
+    calc_data.critical_path_percent =
+        timestamp_count == 0
+            ? 0
+            : 100.0 * calc_data.critical_path_count / timestamp_count;
+    calc_data.speedup_gain_mean =
+        timestamp_count == 0 ? 0
+                             : calc_data.speedup_gain_total / timestamp_count;
+  }
+}
+
+// A PROCESS call reconstructed from its trace events, with absolute times.
+struct TaskTrace {
+  int32_t node_id;
+  int64_t start_time;
+  int64_t finish_time;
+  // The arrival time of each input packet, and the index of the task that
+  // produced it within the same input timestamp, or -1 if it is unknown.
+  std::vector<std::pair<int64_t, int>> inputs;
+};
+
+// The PROCESS calls of one input timestamp, ordered by start time, so that
+// each producer precedes its consumers.
+typedef std::vector<TaskTrace> TaskGraph;
+
+// Returns the time at which the input packets of a task are all available.
+int64_t ReadyTime(const TaskTrace& task,
+                  const std::vector<int64_t>& finish_deltas) {
+  if (task.inputs.empty()) {
+    return task.start_time;
+  }
+  int64_t result = std::numeric_limits<int64_t>::min();
+  for (const auto& input : task.inputs) {
+    const int64_t delta = input.second < 0 ? 0 : finish_deltas[input.second];
+    result = std::max(result, input.first + delta);
+  }
+  return result;
+}
+
+// Returns the time at which the first input packet of a task graph arrives.
+int64_t OriginTime(const TaskGraph& tasks) {
+  int64_t result = std::numeric_limits<int64_t>::max();
+  for (const auto& task : tasks) {
+    result = std::min(result, task.start_time);
+    for (const auto& input : task.inputs) {
+      result = std::min(result, input.first);
+    }
+  }
+  return result;
+}
+
+// Returns the latest finish time of a task graph, if the PROCESS time of the
+// calculator node_id is scaled by scale. The queueing time of each task, and
+// the arrival time of packets from outside the task graph, are held fixed.
+int64_t ModelFinishTime(const TaskGraph& tasks, int32_t node_id,
+                        double scale) {
+  const std::vector<int64_t> no_deltas(tasks.size(), 0);
+  std::vector<int64_t> finish_deltas(tasks.size(), 0);
+  int64_t result = std::numeric_limits<int64_t>::min();
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    const TaskTrace& task = tasks[i];
+    const int64_t queue_time = task.start_time - ReadyTime(task, no_deltas);
+    const int64_t start_time = ReadyTime(task, finish_deltas) + queue_time;
+    int64_t process_time = task.finish_time - task.start_time;
+    if (task.node_id == node_id) {
+      process_time = static_cast<int64_t>(process_time * scale);
+    }
+    finish_deltas[i] = start_time + process_time - task.finish_time;
+    result = std::max(result, start_time + process_time);
+  }
+  return result;
+}
+
+// Returns the node ids on the critical path of a task graph: the chain of
+// tasks leading to the latest finish, following the last input packet to
+// arrive at each task.
+std::set<int32_t> CriticalPath(const TaskGraph& tasks) {
+  std::set<int32_t> result;
+  int index = -1;
+  for (int i = 0; i < static_cast<int>(tasks.size()); ++i) {
+    if (index < 0 || tasks[i].finish_time > tasks[index].finish_time) {
+      index = i;
+    }
+  }
+  while (index >= 0) {
+    const TaskTrace& task = tasks[index];
+    result.insert(task.node_id);
+    int next_index = -1;
+    int64_t last_arrival = std::numeric_limits<int64_t>::min();
+    for (const auto& input : task.inputs) {
+      if (input.first > last_arrival) {
+        last_arrival = input.first;
+        next_index = input.second;
+      }
+    }
+    // Producers always precede their consumers, which rules out cycles.
+    index = next_index < index ? next_index : -1;
+  }
+  return result;
+}
+
+// Collects the PROCESS calls of each input timestamp of a graph trace.
+std::map<int64_t, TaskGraph> BuildTaskGraphs(
+    const mediapipe::GraphTrace& graph_trace) {
+  typedef std::pair<int64_t, std::pair<int32_t, int32_t>> TaskKey;
+  typedef std::pair<int64_t, int32_t> PacketKey;
+  const int64_t base_time = graph_trace.base_time();
+
+  // Pair up start events and finish events that were logged separately.
+  std::map<TaskKey, const mediapipe::GraphTrace::CalculatorTrace*> starts;
+  std::vector<std::pair<const mediapipe::GraphTrace::CalculatorTrace*,
+                        const mediapipe::GraphTrace::CalculatorTrace*>>
+      events;
+  for (const auto& calc_trace : graph_trace.calculator_trace()) {
+    if (calc_trace.event_type() !=
+        mediapipe::GraphTrace_EventType_EVENT_TYPE_PROCESS) {
+      continue;
+    }
+    const TaskKey key(calc_trace.input_timestamp(),
+                      std::make_pair(calc_trace.node_id(),
+                                     calc_trace.thread_id()));
+    if (calc_trace.has_start_time() && calc_trace.has_finish_time()) {
+      events.emplace_back(&calc_trace, &calc_trace);
+    } else if (calc_trace.has_start_time()) {
+      starts[key] = &calc_trace;
+    } else if (calc_trace.has_finish_time()) {
+      const auto it = starts.find(key);
+      if (it != starts.end()) {
+        events.emplace_back(it->second, &calc_trace);
+        starts.erase(it);
+      }
+    }
+  }
+  std::sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+    return a.first->start_time() < b.first->start_time();
+  });
+
+  std::map<int64_t, TaskGraph> result;
+  std::map<PacketKey, std::pair<int64_t, int>> producers;
+  for (const auto& event : events) {
+    const auto& start = *event.first;
+    const auto& finish = *event.second;
+    TaskGraph& tasks = result[start.input_timestamp()];
+    TaskTrace task;
+    task.node_id = start.node_id();
+    task.start_time = start.start_time() + base_time;
+    task.finish_time = finish.finish_time() + base_time;
+    for (const auto& input : start.input_trace()) {
+      const auto it = producers.find(
+          PacketKey(input.packet_timestamp(), input.stream_id()));
+      const bool same_timestamp =
+          it != producers.end() && it->second.first == start.input_timestamp();
+      const int64_t arrival = input.has_start_time()
+                                  ? input.start_time() + base_time
+                                  : task.start_time;
+      task.inputs.emplace_back(arrival,
+                               same_timestamp ? it->second.second : -1);
+    }
+    const int index = tasks.size();
+    for (const auto& output : finish.output_trace()) {
+      producers[PacketKey(output.packet_timestamp(), output.stream_id())] =
+          std::make_pair(start.input_timestamp(), index);
+    }
+    tasks.push_back(std::move(task));
+  }
+  return result;
+}
+
+void Reporter::AccumulateCriticalPaths(const mediapipe::GraphProfile& profile) {
+  NameLookup name_lookup;
+  CacheNodeNameLookup(profile, &name_lookup);
+  const double scale = std::max(0.0, 1.0 - speedup_percent_ / 100);
+
+  for (const auto& graph_trace : profile.graph_trace()) {
+    for (const auto& entry : BuildTaskGraphs(graph_trace)) {
+      const TaskGraph& tasks = entry.second;
+      std::set<int32_t> node_ids;
+      for (const auto& task : tasks) {
+        node_ids.insert(task.node_id);
+        auto& calc_data = calculator_data_[name_lookup[task.node_id]];
+        int64_t first_arrival = task.start_time;
+        int64_t last_arrival = std::numeric_limits<int64_t>::min();
+        for (const auto& input : task.inputs) {
+          first_arrival = std::min(first_arrival, input.first);
+          last_arrival = std::max(last_arrival, input.first);
+        }
+        if (!task.inputs.empty()) {
+          calc_data.input_wait_stat.Push(last_arrival - first_arrival);
+          calc_data.queue_time_stat.Push(task.start_time - last_arrival);
+        }
+      }
+
+      const int64_t origin_time = OriginTime(tasks);
+      const int64_t finish_time =
+          ModelFinishTime(tasks, /*node_id=*/-1, /*scale=*/1);
+      graph_data_.latency_stat.Push(finish_time - origin_time);
+      for (int32_t node_id : CriticalPath(tasks)) {
+        ++calculator_data_[name_lookup[node_id]].critical_path_count;
+      }
+      for (int32_t node_id : node_ids) {
+        calculator_data_[name_lookup[node_id]].speedup_gain_total +=
+            finish_time - ModelFinishTime(tasks, node_id, scale);
+      }
+    }
   }
 }
 
@@ -295,6 +527,8 @@ void Reporter::Accumulate(const mediapipe::GraphProfile& profile) {
       }
     }
   }
+
+  AccumulateCriticalPaths(profile);
 }
 
 absl::Status Reporter::set_columns(const std::vector<std::string>& columns) {
@@ -20,6 +20,11 @@ struct GraphData {
   int64_t max_time = std::numeric_limits<int64_t>::min();
 
   int64_t total_time = 0;
+
+  // Records the end-to-end latency of each input timestamp (microseconds),
+  // from the arrival of its first input packet to the finish of its last
+  // PROCESS call.
+  Statistic latency_stat;
 };
 
 // Holds all of the measured data for a calculator.
@@ -61,6 +66,27 @@ struct CalculatorData {
   // from their origin.
   Statistic input_latency_stat;
 
+  // Records the queueing time (microseconds). This is the time from the
+  // arrival of the last input packet of a PROCESS call to its start, spent
+  // waiting for the scheduler and for a free thread.
+  Statistic queue_time_stat;
+
+  // Records the input wait time (microseconds). This is the time from the
+  // arrival of the first input packet of a PROCESS call to the arrival of its
+  // last input packet, spent waiting for the input stream handler to
+  // assemble a complete input set.
+  Statistic input_wait_stat;
+
+  // The number of input timestamps whose critical path runs through this
+  // calculator, and the percentage of all input timestamps.
+  int critical_path_count;
+  double critical_path_percent;
+
+  // The total and mean reduction of end-to-end latency per input timestamp
+  // (microseconds) if this calculator ran speedup_percent faster.
+  double speedup_gain_total;
+  double speedup_gain_mean;
+
   // The threads on which this calculator ran.
   std::set<int> threads;
 };
@@ -114,8 +140,19 @@ class Reporter {
   // Set to true to remove decorative whitespace from the output.
   void set_compact(bool value) { compact_flag_ = value; }
 
+  // Sets the hypothetical speedup of a calculator, in percent of its PROCESS
+  // time, used to compute "speedup_gain_mean". Applies to profiles
+  // accumulated afterwards.
+  void set_speedup_percent(double value) { speedup_percent_ = value; }
+
  private:
+  // Rebuilds the dependency graph of PROCESS calls for each input timestamp,
+  // and records critical paths, queueing and input wait times, and the
+  // latency gained by speeding up each calculator.
+  void AccumulateCriticalPaths(const mediapipe::GraphProfile& profile);
+
   bool compact_flag_ = false;
+  double speedup_percent_ = 10;
 
   std::vector<std::string> columns_;
 
@@ -29,6 +29,7 @@
 #include "mediapipe/framework/port/advanced_proto_inc.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
 #include "mediapipe/framework/port/proto_ns.h"
 #include "mediapipe/framework/port/status_matchers.h"
 #include "mediapipe/framework/profiler/reporter/statistic.h"
@@ -98,7 +99,9 @@ TEST(Reporter, ReportColumnsWithWildcards) {
   auto reporter = loadReporter({"profile_opencv_0.binarypb"});
   MEDIAPIPE_CHECK_OK(reporter->set_columns({"*_m??n", "*l?t*cy*"}));
   EXPECT_THAT(reporter->Report()->headers(),
-              ElementsAre("calculator", "input_latency_mean", "time_mean",
+              ElementsAre("calculator", "input_latency_mean",
+                          "input_wait_mean", "queue_time_mean",
+                          "speedup_gain_mean", "time_mean",
                           "input_latency_stddev", "input_latency_total"));
 }
 
@@ -229,4 +232,92 @@ TEST(Reporter, LatencyCalculatedCorrectly) {
       testing::DoubleEq(1500));
 }
 
+// Tests the critical path analysis on a fabricated diamond-shaped graph, where
+// "Source" feeds "Fast" and "Slow", which both feed "Sink".
+TEST(Reporter, CriticalPathCalculatedCorrectly) {
+  GraphProfile profile = ParseTextProtoOrDie<GraphProfile>(R"pb(
+    graph_trace {
+      base_time: 1000
+      base_timestamp: 0
+      calculator_name: [ "Source", "Fast", "Slow", "Sink" ]
+      calculator_trace {
+        node_id: 0
+        input_timestamp: 10
+        event_type: EVENT_TYPE_PROCESS
+        start_time: 0
+        finish_time: 100
+        output_trace { packet_timestamp: 10 stream_id: 1 }
+        output_trace { packet_timestamp: 10 stream_id: 2 }
+      }
+      calculator_trace {
+        node_id: 1
+        input_timestamp: 10
+        event_type: EVENT_TYPE_PROCESS
+        start_time: 110
+        finish_time: 150
+        input_trace {
+          start_time: 100
+          finish_time: 110
+          packet_timestamp: 10
+          stream_id: 1
+        }
+        output_trace { packet_timestamp: 10 stream_id: 3 }
+      }
+      calculator_trace {
+        node_id: 2
+        input_timestamp: 10
+        event_type: EVENT_TYPE_PROCESS
+        start_time: 120
+        finish_time: 320
+        input_trace {
+          start_time: 100
+          finish_time: 120
+          packet_timestamp: 10
+          stream_id: 2
+        }
+        output_trace { packet_timestamp: 10 stream_id: 4 }
+      }
+      calculator_trace {
+        node_id: 3
+        input_timestamp: 10
+        event_type: EVENT_TYPE_PROCESS
+        start_time: 330
+        finish_time: 400
+        input_trace {
+          start_time: 150
+          finish_time: 330
+          packet_timestamp: 10
+          stream_id: 3
+        }
+        input_trace {
+          start_time: 320
+          finish_time: 330
+          packet_timestamp: 10
+          stream_id: 4
+        }
+      }
+    }
+  )pb");
+  Reporter reporter;
+  reporter.set_speedup_percent(50);
+  reporter.Accumulate(profile);
+  auto report = reporter.Report();
+  const auto& data = report->calculator_data();
+
+  EXPECT_THAT(report->graph_data().latency_stat.mean(), testing::DoubleEq(400));
+  EXPECT_THAT(data.at("Source").critical_path_percent, testing::DoubleEq(100));
+  EXPECT_THAT(data.at("Fast").critical_path_percent, testing::DoubleEq(0));
+  EXPECT_THAT(data.at("Slow").critical_path_percent, testing::DoubleEq(100));
+  EXPECT_THAT(data.at("Sink").critical_path_percent, testing::DoubleEq(100));
+
+  EXPECT_THAT(data.at("Slow").queue_time_stat.mean(), testing::DoubleEq(20));
+  EXPECT_THAT(data.at("Sink").queue_time_stat.mean(), testing::DoubleEq(10));
+  EXPECT_THAT(data.at("Sink").input_wait_stat.mean(), testing::DoubleEq(170));
+
+  // Speeding up a calculator off the critical path gains nothing.
+  EXPECT_THAT(data.at("Fast").speedup_gain_mean, testing::DoubleEq(0));
+  EXPECT_THAT(data.at("Slow").speedup_gain_mean, testing::DoubleEq(100));
+  EXPECT_THAT(data.at("Sink").speedup_gain_mean, testing::DoubleEq(35));
+}
+
 }  // namespace mediapipe
@@ -0,0 +1,38 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/profiler/storage_conversion_observer.h"
+
+#include "absl/base/attributes.h"
+
+namespace mediapipe {
+namespace {
+
+ABSL_CONST_INIT thread_local StorageConversionObserver* current_observer =
+    nullptr;
+
+}  // namespace
+
+StorageConversionObserver* StorageConversionObserver::Current() {
+  return current_observer;
+}
+
+StorageConversionObserver::Scope::Scope(StorageConversionObserver* observer)
+    : saved_(current_observer) {
+  current_observer = observer;
+}
+
+StorageConversionObserver::Scope::~Scope() { current_observer = saved_; }
+
+}  // namespace mediapipe
@@ -0,0 +1,61 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PROFILER_STORAGE_CONVERSION_OBSERVER_H_
+#define MEDIAPIPE_FRAMEWORK_PROFILER_STORAGE_CONVERSION_OBSERVER_H_
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+
+namespace mediapipe {
+
+// Observes the storage conversions that GpuBuffer, and therefore Image,
+// perform implicitly when a view is requested that none of their current
+// storages provides, such as a readback of a GL texture into an ImageFrame.
+//
+// An observer is installed per thread. The GraphProfiler installs one while
+// a calculator runs Open(), Process() or Close(), so that each conversion is
+// attributed to the calculator that requested the view. GlContext::Run()
+// carries the observer of the calling thread over to the GL thread.
+class StorageConversionObserver {
+ public:
+  virtual ~StorageConversionObserver() = default;
+
+  // Called after a storage of type `source` has been converted into a new
+  // storage of type `target`, which took `duration`.
+  virtual void OnStorageConversion(absl::string_view source,
+                                   absl::string_view target,
+                                   absl::Duration duration) = 0;
+
+  // Returns the observer installed on the calling thread, or nullptr.
+  static StorageConversionObserver* Current();
+
+  // Installs an observer on the calling thread until the scope is left, and
+  // then restores the previous one. The observer may be nullptr.
+  class Scope {
+   public:
+    explicit Scope(StorageConversionObserver* observer);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    StorageConversionObserver* saved_;
+  };
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PROFILER_STORAGE_CONVERSION_OBSERVER_H_
@@ -0,0 +1,142 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PROFILER_STREAM_LATENCY_HISTOGRAM_H_
+#define MEDIAPIPE_FRAMEWORK_PROFILER_STREAM_LATENCY_HISTOGRAM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace mediapipe {
+
+// Counts latencies in fixed-size intervals, the last of which extends to
+// +inf. Updated by the measured stream on every packet, so updates are
+// lock-free.
+class StreamLatencyHistogram {
+ public:
+  StreamLatencyHistogram(int64_t interval_size_usec, int64_t num_intervals)
+      : interval_size_usec_(interval_size_usec),
+        num_intervals_(num_intervals),
+        counts_(new std::atomic<int64_t>[num_intervals]) {
+    Reset();
+  }
+
+  // Records a latency. Negative latencies count in the first interval.
+  void Add(int64_t latency_usec) {
+    const int64_t interval = std::clamp<int64_t>(
+        latency_usec / interval_size_usec_, 0, num_intervals_ - 1);
+    counts_[interval].fetch_add(1, std::memory_order_relaxed);
+    total_usec_.fetch_add(latency_usec, std::memory_order_relaxed);
+  }
+
+  // Records a packet without a latency.
+  void AddUnmatched() { unmatched_.fetch_add(1, std::memory_order_relaxed); }
+
+  int64_t interval_size_usec() const { return interval_size_usec_; }
+  int64_t num_intervals() const { return num_intervals_; }
+
+  // Returns the number of latencies in an interval.
+  int64_t count(int64_t interval) const {
+    return counts_[interval].load(std::memory_order_relaxed);
+  }
+
+  // Returns the sum of the latencies.
+  int64_t total_usec() const {
+    return total_usec_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of packets without a latency.
+  int64_t unmatched_count() const {
+    return unmatched_.load(std::memory_order_relaxed);
+  }
+
+  // Clears the recorded latencies.
+  void Reset() {
+    for (int64_t i = 0; i < num_intervals_; ++i) {
+      counts_[i].store(0, std::memory_order_relaxed);
+    }
+    total_usec_.store(0, std::memory_order_relaxed);
+    unmatched_.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  const int64_t interval_size_usec_;
+  const int64_t num_intervals_;
+  std::unique_ptr<std::atomic<int64_t>[]> counts_;
+  std::atomic<int64_t> total_usec_{0};
+  std::atomic<int64_t> unmatched_{0};
+};
+
+// Remembers the arrival time of the packets of a reference stream for the
+// most recent timestamps. Each timestamp is stored in a slot selected by its
+// value, and the slot is guarded by a sequence number, so that a reader never
+// pairs a timestamp with the time of another one.
+class StreamArrivalTimes {
+ public:
+  static constexpr int kNumSlots = 256;
+
+  // Records the arrival time of the packet at timestamp value `timestamp`.
+  void Add(int64_t timestamp, int64_t time_usec) {
+    Slot& slot = slots_[SlotIndex(timestamp)];
+    // Concurrent writers of the same slot wait for each other.
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    while (sequence % 2 != 0 ||
+           !slot.sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                std::memory_order_relaxed)) {
+      sequence = slot.sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp.store(timestamp, std::memory_order_relaxed);
+    slot.time_usec.store(time_usec, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Returns true and sets `time_usec` if the arrival time of `timestamp` is
+  // remembered.
+  bool Find(int64_t timestamp, int64_t* time_usec) const {
+    const Slot& slot = slots_[SlotIndex(timestamp)];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 != 0 ||
+        slot.timestamp.load(std::memory_order_relaxed) != timestamp) {
+      return false;
+    }
+    const int64_t time = slot.time_usec.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      return false;
+    }
+    *time_usec = time;
+    return true;
+  }
+
+ private:
+  struct Slot {
+    // Odd while the slot is written.
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<int64_t> timestamp{INT64_MIN};
+    std::atomic<int64_t> time_usec{0};
+  };
+
+  static int SlotIndex(int64_t timestamp) {
+    return static_cast<uint64_t>(timestamp) % kNumSlots;
+  }
+
+  Slot slots_[kNumSlots];
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PROFILER_STREAM_LATENCY_HISTOGRAM_H_
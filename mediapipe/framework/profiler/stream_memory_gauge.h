@@ -0,0 +1,58 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PROFILER_STREAM_MEMORY_GAUGE_H_
+#define MEDIAPIPE_FRAMEWORK_PROFILER_STREAM_MEMORY_GAUGE_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace mediapipe {
+
+// Counts the payload bytes queued in an input stream, and their peak.
+// Updated by the stream on every change, so updates are lock-free.
+class StreamMemoryGauge {
+ public:
+  // Records a change in the queued bytes.
+  void Add(int64_t delta) {
+    const int64_t bytes =
+        bytes_.fetch_add(delta, std::memory_order_relaxed) + delta;
+    int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+    while (bytes > peak && !peak_bytes_.compare_exchange_weak(
+                               peak, bytes, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Returns the queued bytes.
+  int64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  // Returns the most queued bytes since construction or ResetPeak().
+  int64_t peak_bytes() const {
+    return peak_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Restarts the peak from the currently queued bytes.
+  void ResetPeak() {
+    peak_bytes_.store(bytes_.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<int64_t> bytes_{0};
+  std::atomic<int64_t> peak_bytes_{0};
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PROFILER_STREAM_MEMORY_GAUGE_H_
@@ -0,0 +1,114 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/profiler/thread_counters.h"
+
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif  // __linux__
+
+namespace mediapipe {
+
+namespace {
+
+#ifdef __linux__
+// The hardware counters of one thread, opened as a group so that they are
+// read together.
+class PerfEventGroup {
+ public:
+  PerfEventGroup() {
+    const uint64_t configs[] = {PERF_COUNT_HW_CPU_CYCLES,
+                                PERF_COUNT_HW_INSTRUCTIONS,
+                                PERF_COUNT_HW_CACHE_MISSES};
+    for (int i = 0; i < kNumCounters; ++i) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                        /*group_fd=*/i == 0 ? -1 : fds_[0], /*flags=*/0);
+      if (fds_[i] < 0) {
+        Close();
+        return;
+      }
+    }
+  }
+
+  ~PerfEventGroup() { Close(); }
+
+  // Reads the counters into `sample`, unless they could not be opened.
+  void Read(ThreadCounterSample* sample) const {
+    if (fds_[0] < 0) {
+      return;
+    }
+    // The number of counters, followed by their values.
+    uint64_t values[1 + kNumCounters];
+    if (read(fds_[0], values, sizeof(values)) != sizeof(values) ||
+        values[0] != kNumCounters) {
+      return;
+    }
+    sample->cycles = values[1];
+    sample->instructions = values[2];
+    sample->cache_misses = values[3];
+  }
+
+ private:
+  static constexpr int kNumCounters = 3;
+
+  void Close() {
+    for (int& fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      fd = -1;
+    }
+  }
+
+  int fds_[kNumCounters] = {-1, -1, -1};
+};
+#endif  // __linux__
+
+}  // namespace
+
+ThreadCounterSample ReadThreadCounters(bool cpu_time, bool hardware_counters) {
+  ThreadCounterSample sample;
+#ifdef __linux__
+  if (hardware_counters) {
+    static thread_local PerfEventGroup perf_events;
+    perf_events.Read(&sample);
+  }
+#endif  // __linux__
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  if (cpu_time) {
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0) {
+      sample.cpu_time_nsec =
+          static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+  }
+#endif  // CLOCK_THREAD_CPUTIME_ID
+  return sample;
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,40 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_PROFILER_THREAD_COUNTERS_H_
+#define MEDIAPIPE_FRAMEWORK_PROFILER_THREAD_COUNTERS_H_
+
+#include <cstdint>
+
+namespace mediapipe {
+
+// The CPU time and hardware counters of a thread at some point. Each field is
+// -1 if it was not read or is unavailable on the platform.
+struct ThreadCounterSample {
+  int64_t cpu_time_nsec = -1;
+  int64_t cycles = -1;
+  int64_t instructions = -1;
+  int64_t cache_misses = -1;
+};
+
+// Reads the counters of the calling thread. The CPU time is read from
+// CLOCK_THREAD_CPUTIME_ID if `cpu_time` is set. The hardware counters are
+// read from perf_event_open on Linux if `hardware_counters` is set, and are
+// opened on the first call in each thread; they are unavailable if the
+// kernel does not permit perf events to the process.
+ThreadCounterSample ReadThreadCounters(bool cpu_time, bool hardware_counters);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_PROFILER_THREAD_COUNTERS_H_
@@ -24,7 +24,9 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/calculator_profile.pb.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/integral_types.h"
@@ -201,6 +203,7 @@ class TraceBuilder::Impl {
         snapshot.push_back(event);
       }
     }
+    FilterSampledTimestamps(&snapshot);
     SetBaseTime(snapshot);
 
     // Index TraceEvents by task-id and stream-hop-id.
@@ -252,6 +255,7 @@ class TraceBuilder::Impl {
         snapshot.push_back(event);
       }
     }
+    FilterSampledTimestamps(&snapshot);
     SetBaseTime(snapshot);
 
     // Log each TraceEvent.
@@ -271,7 +275,44 @@ class TraceBuilder::Impl {
     hop_events_.clear();
   }
 
+  void SetSampling(int sample_interval, absl::Duration latency_threshold) {
+    sample_interval_ = sample_interval;
+    latency_threshold_ = latency_threshold;
+  }
+
  private:
+  // Removes the events of timestamps that are neither sampled nor slower
+  // than latency_threshold_.
+  void FilterSampledTimestamps(std::vector<TraceEvent>* snapshot) {
+    if (latency_threshold_ <= absl::ZeroDuration()) {
+      return;
+    }
+    // The earliest and latest event time for each input timestamp.
+    absl::flat_hash_map<int64, std::pair<absl::Time, absl::Time>> spans;
+    for (const TraceEvent& event : *snapshot) {
+      if (!event.input_ts.IsRangeValue()) {
+        continue;
+      }
+      auto iter = spans.find(event.input_ts.Value());
+      if (iter == spans.end()) {
+        spans[event.input_ts.Value()] = {event.event_time, event.event_time};
+      } else {
+        iter->second.first = std::min(iter->second.first, event.event_time);
+        iter->second.second = std::max(iter->second.second, event.event_time);
+      }
+    }
+    auto is_dropped = [&](const TraceEvent& event) {
+      if (TraceBuilder::IsTimestampSampled(event.input_ts, sample_interval_)) {
+        return false;
+      }
+      const auto& span = spans[event.input_ts.Value()];
+      return span.second - span.first < latency_threshold_;
+    };
+    snapshot->erase(
+        std::remove_if(snapshot->begin(), snapshot->end(), is_dropped),
+        snapshot->end());
+  }
+
   // Calculate the base timestamp and time.
   void SetBaseTime(const std::vector<TraceEvent>& snapshot) {
     if (base_time_ == std::numeric_limits<int64>::max()) {
@@ -399,6 +440,10 @@ class TraceBuilder::Impl {
   int64 base_time_ = std::numeric_limits<int64>::max();
   // Indicates traits of each event type.
   TraceEventRegistry trace_event_registry_;
+  // One in sample_interval_ timestamps is always included in the trace.
+  int sample_interval_ = 1;
+  // Other timestamps are included if their events span this long.
+  absl::Duration latency_threshold_ = absl::ZeroDuration();
 };
 
 TraceBuilder::TraceBuilder() : impl_(new Impl) {}
@@ -422,6 +467,21 @@ void TraceBuilder::CreateLog(const TraceBuffer& buffer, absl::Time begin_time,
 }
 void TraceBuilder::Clear() { impl_->Clear(); }
 
+bool TraceBuilder::IsTimestampSampled(Timestamp timestamp,
+                                      int sample_interval) {
+  if (sample_interval <= 1 || !timestamp.IsRangeValue()) {
+    return true;
+  }
+  // Scatters consecutive and evenly spaced timestamps across the intervals.
+  uint64 hash = static_cast<uint64>(timestamp.Value()) * 0x9E3779B97F4A7C15ULL;
+  return (hash >> 32) % sample_interval == 0;
+}
+
+void TraceBuilder::SetSampling(int sample_interval,
+                               absl::Duration latency_threshold) {
+  impl_->SetSampling(sample_interval, latency_threshold);
+}
+
 // Defined here since constexpr requires out-of-class definition until C++17.
 const TraceEvent::EventType         //
     TraceEvent::UNKNOWN,            //
@@ -35,6 +35,15 @@ class TraceBuilder {
   static Timestamp TimestampAfter(const TraceBuffer& buffer,
                                   absl::Time begin_time);
 
+  // Returns true if a timestamp is traced when tracing one in sample_interval
+  // timestamps. Timestamps that are not range values are always traced.
+  static bool IsTimestampSampled(Timestamp timestamp, int sample_interval);
+
+  // Limits CreateTrace and CreateLog to the timestamps selected by
+  // sample_interval and to the timestamps whose events span at least
+  // latency_threshold. A zero latency_threshold disables this filtering.
+  void SetSampling(int sample_interval, absl::Duration latency_threshold);
+
   // Returns the graph of traces between begin_time and end_time exclusive.
   void CreateTrace(const TraceBuffer& buffer, absl::Time begin_time,
                    absl::Time end_time, GraphTrace* result);
@@ -73,6 +73,7 @@ void Scheduler::Reset() {
   }
   shared_.stopping = false;
   shared_.has_error = false;
+  shared_.deadlines.Reset();
 }
 
 void Scheduler::CloseAllSourceNodes() { shared_.stopping = true; }
@@ -446,6 +447,9 @@ void Scheduler::AssignNodeToSchedulerQueue(CalculatorNode* node) {
     queue = &default_queue_;
   }
   node->SetSchedulerQueue(queue);
+  node->SetDeferredProcessCallback([queue, node](absl::Status result) {
+    queue->FinishDeferredCalculatorNode(node, std::move(result));
+  });
 }
 
 void Scheduler::QueueIdleStateChanged(bool idle) {
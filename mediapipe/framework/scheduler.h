@@ -157,6 +157,19 @@ class Scheduler {
 
   void SetHasError(bool error) { shared_.has_error = error; }
 
+  // Sets the deadline budget for earliest-deadline-first scheduling, in
+  // microseconds. A value that is not positive disables deadline scheduling.
+  // Must be called before the scheduler is started.
+  void SetDeadlineBudget(int64 budget_us) {
+    shared_.deadlines.SetBudget(budget_us);
+  }
+
+  // Records the arrival of a packet at "timestamp" in a graph input stream,
+  // which starts the deadline for that timestamp.
+  void AddedGraphInputTimestamp(Timestamp timestamp) {
+    shared_.deadlines.AddInputTimestamp(timestamp);
+  }
+
   // Notifies the scheduler that a packet was added to a graph input stream.
   // The scheduler needs to check whether it is still deadlocked, and
   // unthrottle again if so.
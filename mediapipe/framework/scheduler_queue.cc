@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <queue>
+#include <set>
 #include <utility>
 
 #include "absl/log/absl_check.h"
@@ -25,6 +26,7 @@
 #include "mediapipe/framework/port/canonical_errors.h"
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/cpu_util.h"
 
 #ifdef __APPLE__
 #define AUTORELEASEPOOL @autoreleasepool
@@ -34,6 +36,39 @@
 
 namespace mediapipe {
 namespace internal {
+namespace {
+
+using CoreClass = CalculatorGraphConfig::Node::CoreClass;
+
+// The core class that the calling thread was last moved to.
+thread_local CoreClass thread_core_class =
+    CalculatorGraphConfig::Node::CORE_CLASS_ANY;
+
+// Moves the calling thread to the cores of `core_class`, unless the class has
+// no preference or the thread is already there. Threads that run nodes of
+// the same class in a row only change their affinity once.
+void MoveToPreferredCores(CoreClass core_class) {
+  if (core_class == CalculatorGraphConfig::Node::CORE_CLASS_ANY ||
+      core_class == thread_core_class) {
+    return;
+  }
+  static const std::set<int>* const higher_core_ids =
+      new std::set<int>(InferHigherCoreIds());
+  static const std::set<int>* const lower_core_ids =
+      new std::set<int>(InferLowerCoreIds());
+  const std::set<int>& core_ids =
+      core_class == CalculatorGraphConfig::Node::CORE_CLASS_PERFORMANCE
+          ? *higher_core_ids
+          : *lower_core_ids;
+  thread_core_class = core_class;
+  if (core_ids.empty()) return;
+  if (!SetCurrentThreadCpuIds(core_ids)) {
+    VLOG(1) << "Failed to move the thread to the cores of class "
+            << CalculatorGraphConfig::Node::CoreClass_Name(core_class);
+  }
+}
+
+}  // namespace
 
 SchedulerQueue::Item::Item(CalculatorNode* node, CalculatorContext* cc)
     : node_(node), cc_(cc) {
@@ -82,6 +117,12 @@ bool SchedulerQueue::Item::operator<(const SchedulerQueue::Item& that) const {
   } else {
     // Non-sources run before sources.
     if (that.is_source_) return false;
+    // Late non-sources run after non-sources that can meet their deadline.
+    if (is_late_ != that.is_late_) return is_late_;
+    // Later deadlines run after earlier deadlines.
+    if (deadline_us_ != that.deadline_us_) {
+      return deadline_us_ > that.deadline_us_;
+    }
     // For non-sources, higher ids run before lower ids.
     return id_ < that.id_;
   }
@@ -91,6 +132,7 @@ void SchedulerQueue::Reset() {
   absl::MutexLock lock(&mutex_);
   num_pending_tasks_ = 0;
   num_tasks_to_add_ = 0;
+  num_deferred_tasks_ = 0;
   running_count_ = 0;
 }
 
@@ -98,8 +140,9 @@ void SchedulerQueue::SetExecutor(Executor* executor) { executor_ = executor; }
 
 bool SchedulerQueue::IsIdle() {
   VLOG(3) << "Scheduler queue empty: " << queue_.empty()
-          << ", # of pending tasks: " << num_pending_tasks_;
-  return queue_.empty() && num_pending_tasks_ == 0;
+          << ", # of pending tasks: " << num_pending_tasks_
+          << ", # of deferred tasks: " << num_deferred_tasks_;
+  return queue_.empty() && num_pending_tasks_ == 0 && num_deferred_tasks_ == 0;
 }
 
 void SchedulerQueue::SetRunning(bool running) {
@@ -121,7 +164,12 @@ void SchedulerQueue::AddNode(CalculatorNode* node, CalculatorContext* cc) {
     ABSL_CHECK(node->IsSource()) << node->DebugName();
     return;
   }
-  AddItemToQueue(Item(node, cc));
+  Item item(node, cc);
+  if (shared_->deadlines.enabled() && !node->IsSource()) {
+    const int64 deadline = shared_->deadlines.GetDeadline(cc->InputTimestamp());
+    item.SetDeadline(deadline, deadline < shared_->deadlines.NowUs());
+  }
+  AddItemToQueue(std::move(item));
 }
 
 void SchedulerQueue::AddNodeForOpen(CalculatorNode* node) {
@@ -206,6 +254,8 @@ void SchedulerQueue::RunNextTask() {
         << "Scheduled a node that was closed. This should not happen.";
   }
 
+  MoveToPreferredCores(node->PreferredCoreClass());
+
   // On iOS, calculators may rely on the existence of an autorelease pool
   // (either directly, or because system code they call does). We do not
   // want to rely on executors setting up an autorelease pool for us (e.g.
@@ -259,23 +309,39 @@ void SchedulerQueue::RunCalculatorNode(CalculatorNode* node,
     // Note that we don't need a lock because only one thread can execute this
     // due to the lock on running_nodes.
     int64_t start_time = shared_->timer.StartNode();
-    const absl::Status result = node->ProcessNode(cc);
+    bool deferred = false;
+    const absl::Status result = node->ProcessNode(cc, &deferred);
     shared_->timer.EndNode(start_time);
+    if (deferred) {
+      // The count may briefly go negative if the call completes first, while
+      // num_pending_tasks_ still keeps the queue from becoming idle.
+      absl::MutexLock lock(&mutex_);
+      ++num_deferred_tasks_;
+      return;
+    }
+    FinishCalculatorNode(node, result);
+    return;
+  }
 
-    if (!result.ok()) {
-      if (result == tool::StatusStop()) {
-        // Check if StatusStop was returned by a non-source node. This means
-        // that all sources will be closed and no further sources should be
-        // scheduled. The graph will be terminated as soon as its scheduler
-        // queue becomes empty.
-        ABSL_CHECK(!node->IsSource());  // ProcessNode takes care of
-                                        // StatusStop() from sources.
-        shared_->stopping = true;
-      } else {
-        // If we have an error in this calculator.
-        VLOG(3) << node->DebugName() << " had an error!";
-        shared_->error_callback(result);
-      }
+  VLOG(4) << "Done running " << node->DebugName();
+  node->EndScheduling();
+}
+
+void SchedulerQueue::FinishCalculatorNode(CalculatorNode* node,
+                                          const absl::Status& result) {
+  if (!result.ok()) {
+    if (result == tool::StatusStop()) {
+      // Check if StatusStop was returned by a non-source node. This means
+      // that all sources will be closed and no further sources should be
+      // scheduled. The graph will be terminated as soon as its scheduler
+      // queue becomes empty.
+      ABSL_CHECK(!node->IsSource());  // ProcessNode takes care of
+                                      // StatusStop() from sources.
+      shared_->stopping = true;
+    } else {
+      // If we have an error in this calculator.
+      VLOG(3) << node->DebugName() << " had an error!";
+      shared_->error_callback(result);
     }
   }
 
@@ -283,6 +349,21 @@ void SchedulerQueue::RunCalculatorNode(CalculatorNode* node,
   node->EndScheduling();
 }
 
+void SchedulerQueue::FinishDeferredCalculatorNode(CalculatorNode* node,
+                                                  absl::Status result) {
+  FinishCalculatorNode(node, result);
+  bool is_idle;
+  {
+    absl::MutexLock lock(&mutex_);
+    --num_deferred_tasks_;
+    is_idle = IsIdle();
+  }
+  if (is_idle && idle_callback_) {
+    // Became idle.
+    idle_callback_(true);
+  }
+}
+
 void SchedulerQueue::OpenCalculatorNode(CalculatorNode* node) {
   VLOG(3) << "Opening " << node->DebugName();
   int64_t start_time = shared_->timer.StartNode();
@@ -302,6 +383,7 @@ void SchedulerQueue::CleanupAfterRun() {
     absl::MutexLock lock(&mutex_);
     was_idle = IsIdle();
     ABSL_CHECK_EQ(num_pending_tasks_, 0);
+    ABSL_CHECK_EQ(num_deferred_tasks_, 0);
     ABSL_CHECK_EQ(num_tasks_to_add_, queue_.size());
     num_tasks_to_add_ = 0;
     while (!queue_.empty()) {
@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "absl/base/macros.h"
+#include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/calculator_context.h"
 #include "mediapipe/framework/executor.h"
@@ -64,16 +65,28 @@ class SchedulerQueue : public TaskQueue {
     //   node id: smaller ids run first, since they come earlier in the config.
     // - Non-sources are sorted by node id: larger ids run first, because they
     //   are closer to the leaves.
+    // With deadline scheduling, non-sources that can still meet their deadline
+    // run before late ones, and are sorted by deadline (earlier deadlines run
+    // first) before node id.
     bool operator<(const Item& that) const;
 
+    // Sets the deadline of a non-source item, in microseconds. "is_late"
+    // indicates that the deadline had already passed when the item was added.
+    void SetDeadline(int64 deadline_us, bool is_late) {
+      deadline_us_ = deadline_us;
+      is_late_ = is_late;
+    }
+
    private:
     int64 source_process_order_ = 0;
+    int64 deadline_us_ = kint64max;
     CalculatorNode* node_;
     CalculatorContext* cc_;
     int id_ = 0;
     int layer_ = 0;
     bool is_source_ = false;
     bool is_open_node_ = false;  // True if the task should run OpenNode().
+    bool is_late_ = false;
   };
 
   explicit SchedulerQueue(SchedulerShared* shared) : shared_(shared) {}
@@ -132,12 +145,23 @@ class SchedulerQueue : public TaskQueue {
 
   void CleanupAfterRun() ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Finishes a ProcessNode() call whose completion was deferred by the
+  // calculator, on the thread that completes it. The queue is not idle while
+  // such calls are pending.
+  void FinishDeferredCalculatorNode(CalculatorNode* node, absl::Status result)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
  private:
   // Used internally by RunNextTask. Invokes ProcessNode or CloseNode, followed
-  // by EndScheduling.
+  // by EndScheduling, unless the calculator defers the completion of
+  // ProcessNode.
   void RunCalculatorNode(CalculatorNode* node, CalculatorContext* cc)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Handles the result of ProcessNode, followed by EndScheduling.
+  void FinishCalculatorNode(CalculatorNode* node, const absl::Status& result)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Used internally by RunNextTask. Invokes OpenNode, followed by
   // CheckIfBecameReady.
   void OpenCalculatorNode(CalculatorNode* node) ABSL_LOCKS_EXCLUDED(mutex_);
@@ -162,6 +186,10 @@ class SchedulerQueue : public TaskQueue {
   // Number of tasks that need to be added to the Executor.
   int num_tasks_to_add_ ABSL_GUARDED_BY(mutex_);
 
+  // Number of ProcessNode calls deferred by their calculators and not yet
+  // finished.
+  int num_deferred_tasks_ ABSL_GUARDED_BY(mutex_) = 0;
+
   // Queue of nodes that need to be run.
   std::priority_queue<Item> queue_ ABSL_GUARDED_BY(mutex_);
 
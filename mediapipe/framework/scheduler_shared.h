@@ -17,6 +17,7 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <queue>
 #include <utility>
@@ -27,6 +28,7 @@
 #include "mediapipe/framework/deps/monotonic_clock.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/timestamp.h"
 
 namespace mediapipe {
 namespace internal {
@@ -97,6 +99,65 @@ class SchedulerTimer {
   int64 total_run_time_;
 };
 
+// Tracks the deadlines of graph input timestamps for earliest-deadline-first
+// scheduling. Every timestamp added to a graph input stream gets a deadline of
+// its arrival time plus the deadline budget. A calculator invocation inherits
+// the deadline of the latest graph input timestamp not after its input
+// timestamp. Deadline scheduling is disabled if the budget is not positive.
+class DeadlineTracker {
+ public:
+  DeadlineTracker() {
+    clock_ = std::unique_ptr<mediapipe::Clock>(
+        mediapipe::MonotonicClock::CreateSynchronizedMonotonicClock());
+  }
+
+  // Sets the deadline budget, in microseconds.
+  void SetBudget(int64 budget_us) { budget_us_ = budget_us; }
+  bool enabled() const { return budget_us_ > 0; }
+
+  // Forgets the deadlines of the previous graph run.
+  void Reset() {
+    absl::MutexLock lock(&mutex_);
+    deadlines_.clear();
+  }
+
+  // Returns the current time, in microseconds.
+  int64 NowUs() { return absl::ToUnixMicros(clock_->TimeNow()); }
+
+  // Records the deadline of a graph input timestamp. Only the first arrival
+  // of a timestamp sets its deadline.
+  void AddInputTimestamp(Timestamp timestamp) {
+    if (!enabled()) return;
+    const int64 deadline = NowUs() + budget_us_;
+    absl::MutexLock lock(&mutex_);
+    deadlines_.emplace(timestamp.Value(), deadline);
+    // Deadlines are only needed for timestamps that are still in flight.
+    while (deadlines_.size() > kMaxTrackedTimestamps) {
+      deadlines_.erase(deadlines_.begin());
+    }
+  }
+
+  // Returns the deadline for an invocation at "timestamp", in microseconds,
+  // or kint64max if there is no graph input at or before "timestamp".
+  int64 GetDeadline(Timestamp timestamp) {
+    absl::MutexLock lock(&mutex_);
+    auto iter = deadlines_.upper_bound(timestamp.Value());
+    if (iter == deadlines_.begin()) {
+      return kint64max;
+    }
+    return std::prev(iter)->second;
+  }
+
+ private:
+  static constexpr int kMaxTrackedTimestamps = 1024;
+
+  std::unique_ptr<mediapipe::Clock> clock_;
+  int64 budget_us_ = 0;
+  absl::Mutex mutex_;
+  // Maps graph input timestamp values to deadlines.
+  std::map<int64, int64> deadlines_ ABSL_GUARDED_BY(mutex_);
+};
+
 struct SchedulerShared {
   // When a non-source node returns StatusStop() or
   // CalculatorGraph::CloseAllPacketSources is called, the graph starts to
@@ -108,6 +169,8 @@ struct SchedulerShared {
   std::function<void(const absl::Status& error)> error_callback;
   // Collects timing information for measuring overhead.
   internal::SchedulerTimer timer;
+  // Deadlines for earliest-deadline-first scheduling.
+  internal::DeadlineTracker deadlines;
 };
 
 }  // namespace internal
@@ -0,0 +1,148 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/shared_executor_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/deps/no_destructor.h"
+#include "mediapipe/framework/port/logging.h"
+#include "mediapipe/util/cpu_util.h"
+
+namespace mediapipe {
+
+// An executor that hands its tasks to the queue of its client in the pool.
+class SharedExecutorPool::ClientExecutor : public Executor {
+ public:
+  ClientExecutor(SharedExecutorPool* pool, std::shared_ptr<Client> client)
+      : pool_(pool), client_(std::move(client)) {}
+
+  void Schedule(std::function<void()> task) override {
+    pool_->Schedule(client_, std::move(task));
+  }
+
+ private:
+  SharedExecutorPool* const pool_;
+  const std::shared_ptr<Client> client_;
+};
+
+SharedExecutorPool::SharedExecutorPool(int num_threads)
+    : SharedExecutorPool(ThreadOptions(), num_threads) {}
+
+SharedExecutorPool::SharedExecutorPool(const ThreadOptions& thread_options,
+                                       int num_threads)
+    : thread_pool_(thread_options,
+                   thread_options.name_prefix().empty()
+                       ? "mediapipe_shared"
+                       : thread_options.name_prefix(),
+                   num_threads) {
+  thread_pool_.StartWorkers();
+  // Each worker thread of the pool runs one worker loop for the lifetime of
+  // the pool.
+  for (int i = 0; i < thread_pool_.num_threads(); ++i) {
+    thread_pool_.Schedule([this] { RunWorker(); });
+  }
+  VLOG(2) << "Started shared executor pool with " << thread_pool_.num_threads()
+          << " threads.";
+}
+
+SharedExecutorPool::~SharedExecutorPool() {
+  VLOG(2) << "Terminating shared executor pool.";
+  absl::MutexLock lock(&mutex_);
+  stopped_ = true;
+  ready_condition_.SignalAll();
+}
+
+// static
+SharedExecutorPool& SharedExecutorPool::GetDefault() {
+  static NoDestructor<SharedExecutorPool> pool(NumCPUCores());
+  return *pool;
+}
+
+absl::StatusOr<std::shared_ptr<Executor>> SharedExecutorPool::CreateExecutor(
+    const ClientOptions& options) {
+  if (options.weight <= 0) {
+    return absl::InvalidArgumentError(
+        "The weight of a shared executor must be positive.");
+  }
+  if (options.max_concurrency < 0) {
+    return absl::InvalidArgumentError(
+        "The max_concurrency of a shared executor must not be negative.");
+  }
+  int64_t id;
+  {
+    absl::MutexLock lock(&mutex_);
+    id = next_client_id_++;
+  }
+  auto client = std::make_shared<Client>(
+      Client{id, options.weight, options.max_concurrency});
+  return std::make_shared<ClientExecutor>(this, std::move(client));
+}
+
+void SharedExecutorPool::Schedule(const std::shared_ptr<Client>& client,
+                                  std::function<void()> task) {
+  absl::MutexLock lock(&mutex_);
+  client->tasks.push_back(std::move(task));
+  UpdateReadiness(client);
+}
+
+void SharedExecutorPool::UpdateReadiness(
+    const std::shared_ptr<Client>& client) {
+  if (client->ready || client->tasks.empty() ||
+      (client->max_concurrency > 0 &&
+       client->num_running >= client->max_concurrency)) {
+    return;
+  }
+  client->virtual_time = std::max(client->virtual_time, virtual_time_);
+  client->ready = true;
+  ready_clients_.insert(client);
+  ready_condition_.Signal();
+}
+
+void SharedExecutorPool::RunWorker() {
+  std::function<void()> task;
+  absl::MutexLock lock(&mutex_);
+  while (true) {
+    while (ready_clients_.empty() && !stopped_) {
+      ready_condition_.Wait(&mutex_);
+    }
+    // Pending tasks are drained before the worker exits. A client held back
+    // by its concurrency limit becomes ready again when one of its running
+    // tasks, which keeps a worker alive, finishes.
+    if (ready_clients_.empty()) {
+      break;
+    }
+    std::shared_ptr<Client> client =
+        std::move(ready_clients_.extract(ready_clients_.begin()).value());
+    client->ready = false;
+    task = std::move(client->tasks.front());
+    client->tasks.pop_front();
+    ++client->num_running;
+    virtual_time_ = client->virtual_time;
+    client->virtual_time += 1.0 / client->weight;
+    UpdateReadiness(client);
+
+    mutex_.Unlock();
+    task();
+    task = nullptr;
+    mutex_.Lock();
+
+    --client->num_running;
+    UpdateReadiness(client);
+  }
+}
+
+}  // namespace mediapipe
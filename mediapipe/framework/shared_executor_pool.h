@@ -0,0 +1,138 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_SHARED_EXECUTOR_POOL_H_
+#define MEDIAPIPE_FRAMEWORK_SHARED_EXECUTOR_POOL_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <set>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/deps/thread_options.h"
+#include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/port/statusor.h"
+#include "mediapipe/framework/port/threadpool.h"
+
+namespace mediapipe {
+
+// A pool of worker threads shared by the executors of many CalculatorGraphs.
+//
+// Every CalculatorGraph normally creates its own default ThreadPoolExecutor,
+// so a process running many graphs runs many more threads than it has cores.
+// Instead, each graph can be given its own client executor of a shared pool:
+//
+//   ASSIGN_OR_RETURN(std::shared_ptr<Executor> executor,
+//                    SharedExecutorPool::GetDefault().CreateExecutor(
+//                        {/*weight=*/2, /*max_concurrency=*/4}));
+//   MP_RETURN_IF_ERROR(graph.SetExecutor("", executor));
+//
+// Each client executor keeps its own FIFO queue of tasks, so the tasks of a
+// graph still run in the order its SchedulerQueue requests them. The pool
+// threads pick the next task among the clients by weighted fair queuing: over
+// time, a backlogged client runs a share of the tasks proportional to its
+// weight, and a client that was idle does not get to catch up on the share it
+// did not use. A client never runs more than max_concurrency tasks at a time.
+//
+// The pool must outlive the executors created from it. Tasks already
+// scheduled when the pool is destroyed are run before its threads exit.
+class SharedExecutorPool {
+ public:
+  struct ClientOptions {
+    // The relative share of the pool threads given to the client when the
+    // pool is busy. Must be positive.
+    int weight = 1;
+    // The maximum number of tasks of the client running at the same time, or
+    // 0 for no limit other than the number of pool threads.
+    int max_concurrency = 0;
+  };
+
+  explicit SharedExecutorPool(int num_threads);
+  SharedExecutorPool(const ThreadOptions& thread_options, int num_threads);
+  ~SharedExecutorPool();
+
+  // Returns the process-wide pool, which has one thread per CPU core. It is
+  // created on first use and never destroyed.
+  static SharedExecutorPool& GetDefault();
+
+  // Creates an executor whose tasks are run by the threads of this pool.
+  absl::StatusOr<std::shared_ptr<Executor>> CreateExecutor(
+      const ClientOptions& options);
+
+  int num_threads() const { return thread_pool_.num_threads(); }
+
+ private:
+  class ClientExecutor;
+
+  // The scheduling state of one client executor. It is shared with the pool,
+  // so that tasks scheduled by an executor still run after it is destroyed.
+  struct Client {
+    const int64_t id;
+    const int weight;
+    const int max_concurrency;
+    std::deque<std::function<void()>> tasks;
+    // The number of tasks of this client currently running.
+    int num_running = 0;
+    // The virtual time at which the next task of the client starts. Running a
+    // task advances it by 1 / weight.
+    double virtual_time = 0;
+    // Whether the client is in ready_clients_.
+    bool ready = false;
+  };
+
+  // Orders ready clients by virtual time, then by creation order. The virtual
+  // time of a client is only changed while it is not in ready_clients_.
+  struct ClientOrder {
+    bool operator()(const std::shared_ptr<Client>& a,
+                    const std::shared_ptr<Client>& b) const {
+      if (a->virtual_time != b->virtual_time) {
+        return a->virtual_time < b->virtual_time;
+      }
+      return a->id < b->id;
+    }
+  };
+
+  void Schedule(const std::shared_ptr<Client>& client,
+                std::function<void()> task) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Adds the client to ready_clients_ if it has a task it may run now.
+  void UpdateReadiness(const std::shared_ptr<Client>& client)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Runs tasks until the pool is destroyed and no task is left.
+  void RunWorker() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  absl::Mutex mutex_;
+  absl::CondVar ready_condition_;
+  // Clients that have pending tasks and are below their concurrency limit.
+  std::set<std::shared_ptr<Client>, ClientOrder> ready_clients_
+      ABSL_GUARDED_BY(mutex_);
+  // The virtual time of the most recently started task. A client that becomes
+  // ready starts no earlier than this, which keeps an idle client from
+  // accumulating credit.
+  double virtual_time_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t next_client_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+
+  // Hosts the worker loops. Declared last so that it is destroyed, and the
+  // worker threads are joined, before the clients are destroyed.
+  mediapipe::ThreadPool thread_pool_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_SHARED_EXECUTOR_POOL_H_
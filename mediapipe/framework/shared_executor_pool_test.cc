@@ -0,0 +1,176 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/shared_executor_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/sink.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(SharedExecutorPoolTest, RejectsInvalidOptions) {
+  SharedExecutorPool pool(1);
+  EXPECT_FALSE(pool.CreateExecutor({/*weight=*/0}).ok());
+  EXPECT_FALSE(
+      pool.CreateExecutor({/*weight=*/1, /*max_concurrency=*/-1}).ok());
+}
+
+TEST(SharedExecutorPoolTest, RunsTasksOfEachClientInOrder) {
+  absl::Mutex mu;
+  std::vector<int> order_a;
+  std::vector<int> order_b;
+  {
+    SharedExecutorPool pool(1);
+    MP_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Executor> a,
+                            pool.CreateExecutor({}));
+    MP_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Executor> b,
+                            pool.CreateExecutor({}));
+    for (int i = 0; i < 100; ++i) {
+      a->Schedule([&order_a, &mu, i] {
+        absl::MutexLock l(&mu);
+        order_a.push_back(i);
+      });
+      b->Schedule([&order_b, &mu, i] {
+        absl::MutexLock l(&mu);
+        order_b.push_back(i);
+      });
+    }
+  }
+  ASSERT_EQ(100, order_a.size());
+  ASSERT_EQ(100, order_b.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, order_a[i]);
+    EXPECT_EQ(i, order_b[i]);
+  }
+}
+
+TEST(SharedExecutorPoolTest, SharesThreadsByWeight) {
+  absl::Mutex mu;
+  std::vector<int> clients;
+  {
+    SharedExecutorPool pool(1);
+    MP_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Executor> light,
+                            pool.CreateExecutor({/*weight=*/1}));
+    MP_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Executor> heavy,
+                            pool.CreateExecutor({/*weight=*/3}));
+    // Keep the only thread busy until both clients are backlogged.
+    absl::Notification start;
+    light->Schedule([&start] { start.WaitForNotification(); });
+    for (int i = 0; i < 40; ++i) {
+      light->Schedule([&clients, &mu] {
+        absl::MutexLock l(&mu);
+        clients.push_back(0);
+      });
+      heavy->Schedule([&clients, &mu] {
+        absl::MutexLock l(&mu);
+        clients.push_back(1);
+      });
+    }
+    start.Notify();
+  }
+  ASSERT_EQ(80, clients.size());
+  // While both clients are backlogged, the heavy one runs three tasks for
+  // every task of the light one.
+  int num_heavy = 0;
+  for (int i = 0; i < 40; ++i) {
+    num_heavy += clients[i];
+  }
+  EXPECT_GE(num_heavy, 29);
+  EXPECT_LE(num_heavy, 31);
+}
+
+TEST(SharedExecutorPoolTest, LimitsConcurrencyOfClient) {
+  absl::Mutex mu;
+  int num_running = 0;
+  int max_running = 0;
+  {
+    SharedExecutorPool pool(8);
+    MP_ASSERT_OK_AND_ASSIGN(
+        std::shared_ptr<Executor> executor,
+        pool.CreateExecutor({/*weight=*/1, /*max_concurrency=*/2}));
+    for (int i = 0; i < 100; ++i) {
+      executor->Schedule([&num_running, &max_running, &mu] {
+        {
+          absl::MutexLock l(&mu);
+          max_running = std::max(max_running, ++num_running);
+        }
+        absl::SleepFor(absl::Microseconds(100));
+        absl::MutexLock l(&mu);
+        --num_running;
+      });
+    }
+  }
+  EXPECT_EQ(0, num_running);
+  EXPECT_LE(max_running, 2);
+}
+
+TEST(SharedExecutorPoolTest, RunsGraphsAsDefaultExecutor) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "mid"
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "mid"
+          output_stream: "out"
+        }
+      )pb");
+  // The pool must outlive the executors held by the graphs.
+  SharedExecutorPool pool(2);
+  std::vector<Packet> output_packets[2];
+  CalculatorGraph graphs[2];
+  for (int g = 0; g < 2; ++g) {
+    CalculatorGraphConfig graph_config = config;
+    tool::AddVectorSink("out", &graph_config, &output_packets[g]);
+    MP_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Executor> executor,
+                            pool.CreateExecutor({}));
+    MP_ASSERT_OK(graphs[g].SetExecutor("", executor));
+    MP_ASSERT_OK(graphs[g].Initialize(graph_config));
+    MP_ASSERT_OK(graphs[g].StartRun({}));
+  }
+  for (int i = 0; i < 100; ++i) {
+    for (CalculatorGraph& graph : graphs) {
+      MP_ASSERT_OK(graph.AddPacketToInputStream(
+          "in", MakePacket<int>(i).At(Timestamp(i))));
+    }
+  }
+  for (int g = 0; g < 2; ++g) {
+    MP_ASSERT_OK(graphs[g].CloseAllInputStreams());
+    MP_ASSERT_OK(graphs[g].WaitUntilDone());
+    ASSERT_EQ(100, output_packets[g].size());
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(i, output_packets[g][i].Get<int>());
+    }
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,51 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/stream_handler/batching_input_stream_handler.h"
+
+#include <utility>
+
+#include "absl/time/clock.h"
+#include "mediapipe/framework/stream_handler/batching_input_stream_handler.pb.h"
+
+namespace mediapipe {
+
+REGISTER_INPUT_STREAM_HANDLER(BatchingInputStreamHandler);
+
+BatchingInputStreamHandler::BatchingInputStreamHandler(
+    std::shared_ptr<tool::TagMap> tag_map, CalculatorContextManager* cc_manager,
+    const MediaPipeOptions& options, bool calculator_run_in_parallel)
+    : DefaultInputStreamHandler(std::move(tag_map), cc_manager, options,
+                                calculator_run_in_parallel) {
+  const auto& ext =
+      this->options().GetExtension(BatchingInputStreamHandlerOptions::ext);
+  SetBatchSize(ext.max_batch_size());
+  max_wait_ = absl::Microseconds(ext.max_wait_us());
+}
+
+void BatchingInputStreamHandler::FillInputSet(Timestamp input_timestamp,
+                                              InputStreamShardSet* input_set) {
+  DefaultInputStreamHandler::FillInputSet(input_timestamp, input_set);
+  if (calculator_context_manager_->NumberOfContextTimestamps(
+          *calculator_context_manager_->GetDefaultCalculatorContext()) == 1) {
+    batch_start_time_ = absl::Now();
+  }
+}
+
+bool BatchingInputStreamHandler::ScheduleIncompleteBatch(int num_input_sets) {
+  return max_wait_ <= absl::ZeroDuration() ||
+         absl::Now() - batch_start_time_ >= max_wait_;
+}
+
+}  // namespace mediapipe
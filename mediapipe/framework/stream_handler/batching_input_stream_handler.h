@@ -0,0 +1,96 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_STREAM_HANDLER_BATCHING_INPUT_STREAM_HANDLER_H_
+#define MEDIAPIPE_FRAMEWORK_STREAM_HANDLER_BATCHING_INPUT_STREAM_HANDLER_H_
+
+#include <memory>
+
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator_context_manager.h"
+#include "mediapipe/framework/input_stream_handler.h"
+#include "mediapipe/framework/mediapipe_options.pb.h"
+#include "mediapipe/framework/stream_handler/default_input_stream_handler.h"
+#include "mediapipe/framework/tool/tag_map.h"
+
+namespace mediapipe {
+
+// Input stream handler that collects up to max_batch_size consecutive input
+// sets, aligned as in DefaultInputStreamHandler, into one batch for the
+// calculator. Calculators that call CalculatorContract::SetProcessInputBatches
+// get a whole batch in a single Process() call:
+//
+//   absl::Status Process(CalculatorContext* cc) override {
+//     for (int i = 0; i < cc->InputBatchSize(); ++i) {
+//       Timestamp timestamp = cc->InputBatchTimestamp(i);
+//       const Packet& packet = cc->Inputs().Index(0).BatchValue(i);
+//       ...
+//     }
+//   }
+//
+// Other calculators get one Process() call per input set, back to back.
+//
+// A batch is processed as soon as it is full. An incomplete batch is
+// processed once no further input set is ready and its first input set has
+// waited for max_wait_us, which is checked whenever the input streams change,
+// or when the node is ready for Close(). Timestamp bounds are propagated for
+// the first input set of a batch until the batch is processed.
+//
+// node {
+//   calculator: "InferenceCalculator"
+//   input_stream: "TENSORS:input_tensors"
+//   output_stream: "TENSORS:output_tensors"
+//   input_stream_handler {
+//     input_stream_handler: "BatchingInputStreamHandler"
+//     options {
+//       [mediapipe.BatchingInputStreamHandlerOptions.ext] {
+//         max_batch_size: 4
+//       }
+//     }
+//   }
+// }
+//
+// Batching cannot be combined with max_in_flight greater than 1 and is not
+// supported for source nodes.
+class BatchingInputStreamHandler : public DefaultInputStreamHandler {
+ public:
+  BatchingInputStreamHandler() = delete;
+  BatchingInputStreamHandler(std::shared_ptr<tool::TagMap> tag_map,
+                             CalculatorContextManager* cc_manager,
+                             const MediaPipeOptions& options,
+                             bool calculator_run_in_parallel);
+
+ protected:
+  // Records the arrival of the first input set of each batch.
+  void FillInputSet(Timestamp input_timestamp,
+                    InputStreamShardSet* input_set) override;
+
+  bool ScheduleIncompleteBatch(int num_input_sets) override;
+
+  // Every change to the input streams rechecks the wait of an incomplete
+  // batch, so no notification is skipped.
+  bool BoundCanChangeReadiness(CollectionItemId id,
+                               Timestamp previous_bound) override {
+    return true;
+  }
+
+ private:
+  absl::Duration max_wait_;
+  // The time the first input set of the current batch was filled.
+  absl::Time batch_start_time_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_STREAM_HANDLER_BATCHING_INPUT_STREAM_HANDLER_H_
@@ -0,0 +1,177 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/stream_handler/batching_input_stream_handler.pb.h"
+
+namespace mediapipe {
+namespace {
+
+// Sums up the values of each batch of its "VALUE" and "OFFSET" input streams
+// and outputs the batch size and the sums at the last timestamp of the batch.
+class BatchSumCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Tag("VALUE").Set<int>();
+    cc->Inputs().Tag("OFFSET").Set<int>();
+    cc->Outputs().Tag("SIZE").Set<int>();
+    cc->Outputs().Tag("SUM").Set<int>();
+    cc->SetProcessInputBatches(true);
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    int sum = 0;
+    for (int i = 0; i < cc->InputBatchSize(); ++i) {
+      RET_CHECK_EQ(cc->InputBatchTimestamp(i),
+                   cc->Inputs().Tag("VALUE").BatchValue(i).Timestamp());
+      sum += cc->Inputs().Tag("VALUE").BatchValue(i).Get<int>();
+      if (!cc->Inputs().Tag("OFFSET").BatchValue(i).IsEmpty()) {
+        sum += cc->Inputs().Tag("OFFSET").BatchValue(i).Get<int>();
+      }
+    }
+    const Timestamp last = cc->InputBatchTimestamp(cc->InputBatchSize() - 1);
+    cc->Outputs().Tag("SIZE").AddPacket(
+        MakePacket<int>(cc->InputBatchSize()).At(last));
+    cc->Outputs().Tag("SUM").AddPacket(MakePacket<int>(sum).At(last));
+    return absl::OkStatus();
+  }
+};
+REGISTER_CALCULATOR(BatchSumCalculator);
+
+CalculatorGraphConfig BatchingConfig(int max_batch_size, int64_t max_wait_us) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "value"
+        input_stream: "offset"
+        node {
+          calculator: "BatchSumCalculator"
+          input_stream: "VALUE:value"
+          input_stream: "OFFSET:offset"
+          output_stream: "SIZE:size"
+          output_stream: "SUM:sum"
+          input_stream_handler {
+            input_stream_handler: "BatchingInputStreamHandler"
+          }
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "value"
+          output_stream: "passed_value"
+          input_stream_handler {
+            input_stream_handler: "BatchingInputStreamHandler"
+          }
+        }
+      )pb");
+  for (auto& node : *config.mutable_node()) {
+    auto* options = node.mutable_input_stream_handler()
+                        ->mutable_options()
+                        ->MutableExtension(BatchingInputStreamHandlerOptions::ext);
+    options->set_max_batch_size(max_batch_size);
+    options->set_max_wait_us(max_wait_us);
+  }
+  return config;
+}
+
+struct Outputs {
+  std::vector<Packet> sizes;
+  std::vector<Packet> sums;
+  std::vector<Packet> passed_values;
+};
+
+// Runs the graph on 10 input sets. Every second input set has an offset.
+void RunGraph(const CalculatorGraphConfig& config, Outputs* outputs) {
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  auto observe = [&graph](const std::string& stream,
+                          std::vector<Packet>* packets) {
+    MP_ASSERT_OK(graph.ObserveOutputStream(stream, [packets](const Packet& p) {
+      packets->push_back(p);
+      return absl::OkStatus();
+    }));
+  };
+  observe("size", &outputs->sizes);
+  observe("sum", &outputs->sums);
+  observe("passed_value", &outputs->passed_values);
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 10; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "value", MakePacket<int>(i).At(Timestamp(i))));
+    if (i % 2 == 0) {
+      MP_ASSERT_OK(graph.AddPacketToInputStream(
+          "offset", MakePacket<int>(100).At(Timestamp(i))));
+    }
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
+// Tests that batches wait until they are full, and that the last incomplete
+// batch is processed when the input streams are closed.
+TEST(BatchingInputStreamHandlerTest, ProcessesFullBatches) {
+  Outputs outputs;
+  RunGraph(BatchingConfig(/*max_batch_size=*/4,
+                          /*max_wait_us=*/absl::ToInt64Microseconds(
+                              absl::Hours(1))),
+           &outputs);
+
+  std::vector<int> sizes;
+  std::vector<int> sums;
+  std::vector<Timestamp> timestamps;
+  for (int i = 0; i < outputs.sizes.size(); ++i) {
+    sizes.push_back(outputs.sizes[i].Get<int>());
+    sums.push_back(outputs.sums[i].Get<int>());
+    timestamps.push_back(outputs.sums[i].Timestamp());
+  }
+  EXPECT_THAT(sizes, testing::ElementsAre(4, 4, 2));
+  EXPECT_THAT(sums, testing::ElementsAre(0 + 1 + 2 + 3 + 200,
+                                         4 + 5 + 6 + 7 + 200, 8 + 9 + 100));
+  EXPECT_THAT(timestamps,
+              testing::ElementsAre(Timestamp(3), Timestamp(7), Timestamp(9)));
+
+  // Calculators that don't process batches still see every input set.
+  ASSERT_EQ(10, outputs.passed_values.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, outputs.passed_values[i].Get<int>());
+    EXPECT_EQ(Timestamp(i), outputs.passed_values[i].Timestamp());
+  }
+}
+
+// Tests that without a wait, batches are limited to the ready input sets.
+TEST(BatchingInputStreamHandlerTest, ProcessesReadyInputSetsWithoutWaiting) {
+  Outputs outputs;
+  RunGraph(BatchingConfig(/*max_batch_size=*/4, /*max_wait_us=*/0), &outputs);
+
+  int total_size = 0;
+  int total_sum = 0;
+  for (int i = 0; i < outputs.sizes.size(); ++i) {
+    EXPECT_LE(outputs.sizes[i].Get<int>(), 4);
+    total_size += outputs.sizes[i].Get<int>();
+    total_sum += outputs.sums[i].Get<int>();
+  }
+  EXPECT_EQ(10, total_size);
+  EXPECT_EQ(45 + 500, total_sum);
+  EXPECT_EQ(10, outputs.passed_values.size());
+}
+
+}  // namespace
+}  // namespace mediapipe
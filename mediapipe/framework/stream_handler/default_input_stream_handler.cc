@@ -61,6 +61,11 @@ NodeReadiness DefaultInputStreamHandler::GetNodeReadiness(
   return sync_set_.GetReadiness(min_stream_timestamp);
 }
 
+bool DefaultInputStreamHandler::BoundCanChangeReadiness(
+    CollectionItemId id, Timestamp previous_bound) {
+  return !sync_set_.HasOtherEmptyStreamAtOrBelow(id, previous_bound);
+}
+
 void DefaultInputStreamHandler::FillInputSet(Timestamp input_timestamp,
                                              InputStreamShardSet* input_set) {
   sync_set_.FillInputSet(input_timestamp, input_set);
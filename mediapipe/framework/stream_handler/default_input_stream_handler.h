@@ -48,6 +48,11 @@ class DefaultInputStreamHandler : public InputStreamHandler {
   //   that will be available at the next timestamp.
   NodeReadiness GetNodeReadiness(Timestamp* min_stream_timestamp) override;
 
+  // Returns false while another empty stream holds the minimum bound at or
+  // below |previous_bound|, since the minimum bound does not change.
+  bool BoundCanChangeReadiness(CollectionItemId id,
+                               Timestamp previous_bound) override;
+
   // Only invoked when associated GetNodeReadiness() returned kReadyForProcess.
   void FillInputSet(Timestamp input_timestamp,
                     InputStreamShardSet* input_set) override;
@@ -12,13 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <vector>
 
+#include "mediapipe/framework/calculator_context_manager.h"
 #include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/input_stream_handler.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
 #include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/tag_map_helper.h"
 
 namespace mediapipe {
 
@@ -279,5 +283,59 @@ TEST(DefaultInputStreamHandlerTest, DoesntPropagateTimestampWhenBatching) {
   EXPECT_EQ(4, sink.size());
 }
 
+// Bound updates that cannot change the minimum bound of the input streams do
+// not notify the node, and the notifications within a NotificationBatch are
+// delivered once per node.
+TEST(DefaultInputStreamHandlerTest, SkipsAndCoalescesBoundNotifications) {
+  std::shared_ptr<tool::TagMap> tag_map =
+      tool::CreateTagMap({"input_a", "input_b"}).value();
+  PacketType packet_type;
+  packet_type.Set<int>();
+  auto managers = std::make_unique<InputStreamManager[]>(2);
+  MP_ASSERT_OK(managers[0].Initialize("input_a", &packet_type,
+                                      /*back_edge=*/false));
+  MP_ASSERT_OK(managers[1].Initialize("input_b", &packet_type,
+                                      /*back_edge=*/false));
+  CalculatorState calculator_state("Node", /*node_id=*/0, "Calculator",
+                                   CalculatorGraphConfig::Node(), nullptr);
+  CalculatorContextManager cc_manager;
+  cc_manager.Initialize(&calculator_state, tag_map,
+                        /*output_tag_map=*/tool::CreateTagMap({}).value(),
+                        /*calculator_run_in_parallel=*/false);
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<InputStreamHandler> handler,
+      InputStreamHandlerRegistry::CreateByName(
+          "DefaultInputStreamHandler", tag_map, &cc_manager,
+          MediaPipeOptions(), /*calculator_run_in_parallel=*/false));
+  MP_ASSERT_OK(handler->InitializeInputStreamManagers(managers.get()));
+  MP_ASSERT_OK(cc_manager.PrepareForRun(
+      [](CalculatorContext*) { return absl::OkStatus(); }));
+  int notifications = 0;
+  handler->PrepareForRun(
+      [] {}, [&notifications] { ++notifications; }, [](CalculatorContext*) {},
+      [](absl::Status status) { MP_EXPECT_OK(status); });
+  const CollectionItemId input_a = tag_map->GetId("", 0);
+  const CollectionItemId input_b = tag_map->GetId("", 1);
+
+  // input_b holds the minimum bound, so raising input_a changes nothing.
+  handler->SetNextTimestampBound(input_a, Timestamp(10));
+  handler->SetNextTimestampBound(input_a, Timestamp(20));
+  EXPECT_EQ(notifications, 0);
+
+  // Raising the minimum bound notifies the node.
+  handler->SetNextTimestampBound(input_b, Timestamp(5));
+  EXPECT_EQ(notifications, 1);
+  handler->SetNextTimestampBound(input_b, Timestamp(30));
+  EXPECT_EQ(notifications, 2);
+
+  {
+    InputStreamHandler::NotificationBatch batch;
+    handler->SetNextTimestampBound(input_a, Timestamp(40));
+    handler->SetNextTimestampBound(input_b, Timestamp(50));
+    EXPECT_EQ(notifications, 2);
+  }
+  EXPECT_EQ(notifications, 3);
+}
+
 }  // namespace
 }  // namespace mediapipe
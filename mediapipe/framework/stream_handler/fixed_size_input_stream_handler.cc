@@ -160,8 +160,9 @@ NodeReadiness FixedSizeInputStreamHandler::GetNodeReadiness(
 }
 
 void FixedSizeInputStreamHandler::AddPackets(CollectionItemId id,
-                                             const std::list<Packet>& packets) {
-  InputStreamHandler::AddPackets(id, packets);
+                                             const std::list<Packet>& packets,
+                                             Timestamp next_timestamp_bound) {
+  InputStreamHandler::AddPackets(id, packets, next_timestamp_bound);
   absl::MutexLock lock(&erase_mutex_);
   if (!pending_) {
     EraseSurplusPackets(false);
@@ -169,8 +170,9 @@ void FixedSizeInputStreamHandler::AddPackets(CollectionItemId id,
 }
 
 void FixedSizeInputStreamHandler::MovePackets(CollectionItemId id,
-                                              std::list<Packet>* packets) {
-  InputStreamHandler::MovePackets(id, packets);
+                                              std::list<Packet>* packets,
+                                              Timestamp next_timestamp_bound) {
+  InputStreamHandler::MovePackets(id, packets, next_timestamp_bound);
   absl::MutexLock lock(&erase_mutex_);
   if (!pending_) {
     EraseSurplusPackets(false);
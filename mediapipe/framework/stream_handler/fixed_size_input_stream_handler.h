@@ -83,10 +83,13 @@ class FixedSizeInputStreamHandler : public DefaultInputStreamHandler {
 
   NodeReadiness GetNodeReadiness(Timestamp* min_stream_timestamp) override;
 
-  void AddPackets(CollectionItemId id,
-                  const std::list<Packet>& packets) override;
+  using InputStreamHandler::AddPackets;
+  void AddPackets(CollectionItemId id, const std::list<Packet>& packets,
+                  Timestamp next_timestamp_bound) override;
 
-  void MovePackets(CollectionItemId id, std::list<Packet>* packets) override;
+  using InputStreamHandler::MovePackets;
+  void MovePackets(CollectionItemId id, std::list<Packet>* packets,
+                   Timestamp next_timestamp_bound) override;
 
   void FillInputSet(Timestamp input_timestamp,
                     InputStreamShardSet* input_set) override;
@@ -20,6 +20,7 @@
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/framework/port/status_builder.h"
 #include "mediapipe/framework/thread_pool_executor.pb.h"
+#include "mediapipe/framework/work_stealing_executor.h"
 #include "mediapipe/util/cpu_util.h"
 
 namespace mediapipe {
@@ -71,6 +72,10 @@ absl::StatusOr<Executor*> ThreadPoolExecutor::Create(
       break;
   }
 #endif
+  if (options.scheduling_policy() ==
+      ThreadPoolExecutorOptions::SCHEDULING_POLICY_WORK_STEALING) {
+    return new WorkStealingExecutor(thread_options, options.num_threads());
+  }
   return new ThreadPoolExecutor(thread_options, options.num_threads());
 }
 
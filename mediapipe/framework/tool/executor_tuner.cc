@@ -0,0 +1,168 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/tool/executor_tuner.h"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "mediapipe/framework/mediapipe_options.pb.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/thread_pool_executor.pb.h"
+#include "mediapipe/framework/tool/name_util.h"
+#include "mediapipe/util/cpu_util.h"
+
+namespace mediapipe {
+namespace tool {
+namespace {
+
+constexpr char kThreadPoolExecutorType[] = "ThreadPoolExecutor";
+
+// The Process() calls of a node across its profiles.
+struct ProcessTime {
+  int64_t total_usec = 0;
+  int64_t num_calls = 0;
+};
+
+// Returns the index of the executor named `name`, or -1 if there is none.
+int FindExecutor(const CalculatorGraphConfig& config, const std::string& name) {
+  for (int i = 0; i < config.executor_size(); ++i) {
+    if (config.executor(i).name() == name) return i;
+  }
+  return -1;
+}
+
+}  // namespace
+
+absl::StatusOr<CalculatorGraphConfig> TuneExecutorAssignment(
+    const CalculatorGraphConfig& config,
+    const std::vector<CalculatorProfile>& profiles,
+    const ExecutorTuningOptions& options) {
+  RET_CHECK(!options.heavy_executor_name.empty())
+      << "The heavy executor must be named.";
+  // A node may have several profiles, such as from several trace log entries.
+  absl::flat_hash_map<std::string, ProcessTime> process_times;
+  for (const CalculatorProfile& profile : profiles) {
+    ProcessTime& process_time = process_times[profile.name()];
+    process_time.total_usec += profile.process_runtime().total();
+    for (int64_t count : profile.process_runtime().count()) {
+      process_time.num_calls += count;
+    }
+  }
+
+  // Split the nodes between the heavy and the default executors.
+  CalculatorGraphConfig result = config;
+  int num_heavy_nodes = 0;
+  int num_light_nodes = 0;
+  for (int i = 0; i < result.node_size(); ++i) {
+    CalculatorGraphConfig::Node* node = result.mutable_node(i);
+    if (!node->executor().empty() &&
+        node->executor() != options.heavy_executor_name) {
+      continue;
+    }
+    auto it = process_times.find(CanonicalNodeName(result, i));
+    if (it != process_times.end() && it->second.num_calls > 0) {
+      if (it->second.total_usec / it->second.num_calls >=
+          options.heavy_process_time_usec) {
+        node->set_executor(options.heavy_executor_name);
+      } else {
+        node->clear_executor();
+      }
+    }
+    if (node->executor().empty()) {
+      ++num_light_nodes;
+    } else {
+      ++num_heavy_nodes;
+    }
+  }
+
+  // Size the heavy executor by the number of heavy nodes, which is the most
+  // that can run at once, up to the number of cores it may use.
+  int num_heavy_threads = 0;
+  int heavy_executor_index = FindExecutor(result, options.heavy_executor_name);
+  if (num_heavy_nodes == 0) {
+    if (heavy_executor_index >= 0) {
+      result.mutable_executor()->DeleteSubrange(heavy_executor_index, 1);
+    }
+  } else {
+    if (heavy_executor_index < 0) {
+      heavy_executor_index = result.executor_size();
+      result.add_executor()->set_name(options.heavy_executor_name);
+    }
+    ExecutorConfig* heavy_executor =
+        result.mutable_executor(heavy_executor_index);
+    if (heavy_executor->type().empty()) {
+      heavy_executor->set_type(kThreadPoolExecutorType);
+    }
+    RET_CHECK_EQ(heavy_executor->type(), kThreadPoolExecutorType)
+        << "The executor \"" << options.heavy_executor_name
+        << "\" exists with another type.";
+    const std::set<int> higher_core_ids = InferHigherCoreIds();
+    int max_heavy_threads = options.max_heavy_threads;
+    if (max_heavy_threads <= 0) {
+      max_heavy_threads = higher_core_ids.empty()
+                              ? std::max(1, NumCPUCores() / 2)
+                              : static_cast<int>(higher_core_ids.size());
+    }
+    num_heavy_threads = std::min(num_heavy_nodes, max_heavy_threads);
+    ThreadPoolExecutorOptions* heavy_options =
+        heavy_executor->mutable_options()->MutableExtension(
+            ThreadPoolExecutorOptions::ext);
+    heavy_options->set_num_threads(num_heavy_threads);
+    if (options.use_higher_cores && !higher_core_ids.empty()) {
+      heavy_options->set_require_processor_performance(
+          ThreadPoolExecutorOptions::PROCESSOR_PERFORMANCE_HIGH);
+    } else {
+      heavy_options->clear_require_processor_performance();
+    }
+  }
+
+  // Give the default executor the cores left, unless it is already sized.
+  if (options.tune_default_threads && num_light_nodes > 0 &&
+      result.num_threads() == 0) {
+    int default_executor_index = FindExecutor(result, "");
+    if (default_executor_index < 0) {
+      default_executor_index = result.executor_size();
+      result.add_executor();
+    }
+    ExecutorConfig* default_executor =
+        result.mutable_executor(default_executor_index);
+    if (default_executor->type().empty() ||
+        default_executor->type() == kThreadPoolExecutorType) {
+      ThreadPoolExecutorOptions* default_options =
+          default_executor->mutable_options()->MutableExtension(
+              ThreadPoolExecutorOptions::ext);
+      if (default_options->num_threads() <= 0) {
+        default_options->set_num_threads(std::min(
+            num_light_nodes, std::max(1, NumCPUCores() - num_heavy_threads)));
+      }
+    }
+  }
+  return result;
+}
+
+absl::StatusOr<CalculatorGraphConfig> TuneExecutorAssignment(
+    CalculatorGraph* graph, const ExecutorTuningOptions& options) {
+  RET_CHECK(graph->profiler()) << "The graph has no profiler.";
+  std::vector<CalculatorProfile> profiles;
+  MP_RETURN_IF_ERROR(graph->profiler()->GetCalculatorProfiles(&profiles));
+  return TuneExecutorAssignment(graph->Config(), profiles, options);
+}
+
+}  // namespace tool
+}  // namespace mediapipe
@@ -0,0 +1,69 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_TOOL_EXECUTOR_TUNER_H_
+#define MEDIAPIPE_FRAMEWORK_TOOL_EXECUTOR_TUNER_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/calculator_graph.h"
+#include "mediapipe/framework/calculator_profile.pb.h"
+
+namespace mediapipe {
+namespace tool {
+
+// Options for TuneExecutorAssignment.
+struct ExecutorTuningOptions {
+  // Nodes whose mean Process() time is at least this long, in microseconds,
+  // run on the heavy executor. The rest run on the default executor.
+  int64_t heavy_process_time_usec = 5000;
+  // The name of the executor created for the heavy nodes.
+  std::string heavy_executor_name = "heavy";
+  // The most threads given to the heavy executor. If not positive, the number
+  // of inferred higher cores is used.
+  int max_heavy_threads = 0;
+  // Whether to bind the heavy executor threads to the higher cores.
+  bool use_higher_cores = true;
+  // Whether to also size the default executor, if its thread count is not
+  // already set in the config.
+  bool tune_default_threads = true;
+};
+
+// Proposes an executor assignment for the nodes of `config` from their
+// profiles. Nodes with long Process() calls, such as inference, move to a
+// dedicated ThreadPoolExecutor, optionally bound to the higher cores, so that
+// short bookkeeping nodes on the default executor don't queue behind them.
+//
+// `config` must be the expanded config, such as CalculatorGraph::Config(),
+// whose canonical node names match the profile names. Only nodes that are
+// unassigned or on the heavy executor are reassigned, and nodes without a
+// profile or without any Process() calls are left as they are.
+absl::StatusOr<CalculatorGraphConfig> TuneExecutorAssignment(
+    const CalculatorGraphConfig& config,
+    const std::vector<CalculatorProfile>& profiles,
+    const ExecutorTuningOptions& options = {});
+
+// Proposes an executor assignment for a running or finished `graph` from the
+// profiles collected by its profiler. The returned config can be used to
+// initialize the graph the next time it is run.
+absl::StatusOr<CalculatorGraphConfig> TuneExecutorAssignment(
+    CalculatorGraph* graph, const ExecutorTuningOptions& options = {});
+
+}  // namespace tool
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_TOOL_EXECUTOR_TUNER_H_
@@ -0,0 +1,116 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A command line utility that proposes an executor assignment for a graph
+// from the calculator profiles in one of its trace logs.
+//
+// Example:
+//   executor_tuner_main \
+//     --trace_log=/tmp/mediapipe_trace_0.binarypb \
+//     --output_graph_config=/tmp/tuned_graph.pbtxt
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/log/absl_log.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/calculator_profile.pb.h"
+#include "mediapipe/framework/port/advanced_proto_inc.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/tool/executor_tuner.h"
+
+ABSL_FLAG(std::string, trace_log, "",
+          "A trace log file of binary GraphProfile records, as written by the "
+          "profiler with trace_log_path set.");
+ABSL_FLAG(std::string, graph_config, "",
+          "An optional file with the expanded CalculatorGraphConfig in text "
+          "form. If empty, the config recorded in the trace log is used.");
+ABSL_FLAG(std::string, output_graph_config, "",
+          "The file to write the tuned CalculatorGraphConfig to in text form. "
+          "If empty, it is printed.");
+ABSL_FLAG(int64_t, heavy_process_time_usec, 5000,
+          "The mean Process() time at which a node moves to the heavy "
+          "executor.");
+ABSL_FLAG(int, max_heavy_threads, 0,
+          "The most threads for the heavy executor. If not positive, the "
+          "number of higher cores of this device is used.");
+ABSL_FLAG(bool, use_higher_cores, true,
+          "Whether to bind the heavy executor threads to the higher cores.");
+
+namespace mediapipe {
+
+absl::Status RunExecutorTuner() {
+  RET_CHECK(!absl::GetFlag(FLAGS_trace_log).empty())
+      << "--trace_log must be specified";
+  std::ifstream trace_ifs(absl::GetFlag(FLAGS_trace_log),
+                          std::ios_base::in | std::ios_base::binary);
+  proto_ns::io::IstreamInputStream trace_in(&trace_ifs);
+  // The trace log holds a sequence of GraphProfile records, which merge into
+  // one.
+  GraphProfile profile;
+  RET_CHECK(profile.ParseFromZeroCopyStream(&trace_in))
+      << "could not parse binary proto: " << absl::GetFlag(FLAGS_trace_log);
+
+  CalculatorGraphConfig config = profile.config();
+  if (!absl::GetFlag(FLAGS_graph_config).empty()) {
+    std::ifstream config_ifs(absl::GetFlag(FLAGS_graph_config));
+    proto_ns::io::IstreamInputStream config_in(&config_ifs);
+    RET_CHECK(proto_ns::TextFormat::Parse(&config_in, &config))
+        << "could not parse text proto: " << absl::GetFlag(FLAGS_graph_config);
+  }
+
+  tool::ExecutorTuningOptions options;
+  options.heavy_process_time_usec =
+      absl::GetFlag(FLAGS_heavy_process_time_usec);
+  options.max_heavy_threads = absl::GetFlag(FLAGS_max_heavy_threads);
+  options.use_higher_cores = absl::GetFlag(FLAGS_use_higher_cores);
+  std::vector<CalculatorProfile> profiles(
+      profile.calculator_profiles().begin(),
+      profile.calculator_profiles().end());
+  ASSIGN_OR_RETURN(CalculatorGraphConfig tuned_config,
+                   tool::TuneExecutorAssignment(config, profiles, options));
+
+  std::string text;
+  RET_CHECK(proto_ns::TextFormat::PrintToString(tuned_config, &text));
+  if (absl::GetFlag(FLAGS_output_graph_config).empty()) {
+    std::cout << text;
+  } else {
+    std::ofstream ofs(absl::GetFlag(FLAGS_output_graph_config),
+                      std::ios_base::out | std::ios_base::trunc);
+    ofs << text;
+    RET_CHECK(ofs.good()) << "could not write text proto to: "
+                          << absl::GetFlag(FLAGS_output_graph_config);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace mediapipe
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  absl::Status status = mediapipe::RunExecutorTuner();
+  if (!status.ok()) {
+    ABSL_LOG(ERROR) << status;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/tool/executor_tuner.h"
+
+#include <vector>
+
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/calculator_profile.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/thread_pool_executor.pb.h"
+
+namespace mediapipe {
+namespace tool {
+namespace {
+
+CalculatorProfile MakeProfile(const std::string& name, int64_t total_usec,
+                              int64_t num_calls) {
+  CalculatorProfile profile;
+  profile.set_name(name);
+  profile.mutable_process_runtime()->set_total(total_usec);
+  profile.mutable_process_runtime()->add_count(num_calls);
+  return profile;
+}
+
+ExecutorTuningOptions FixedOptions() {
+  ExecutorTuningOptions options;
+  options.heavy_process_time_usec = 1000;
+  options.max_heavy_threads = 2;
+  options.use_higher_cores = false;
+  options.tune_default_threads = false;
+  return options;
+}
+
+TEST(ExecutorTunerTest, MovesHeavyNodesToHeavyExecutor) {
+  CalculatorGraphConfig config = ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        node { calculator: "ImageTransformationCalculator" }
+        node { name: "inference" calculator: "InferenceCalculator" }
+        node { name: "other_inference" calculator: "InferenceCalculator" }
+        node { name: "detections" calculator: "TensorsToDetectionsCalculator" }
+        node { name: "inference_3" calculator: "InferenceCalculator" }
+      )pb");
+  std::vector<CalculatorProfile> profiles = {
+      MakeProfile("ImageTransformationCalculator", 900, 3),
+      MakeProfile("inference", 30000, 3),
+      MakeProfile("other_inference", 6000, 3),
+      MakeProfile("detections", 600, 3),
+      MakeProfile("inference_3", 9000, 3),
+  };
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      CalculatorGraphConfig tuned,
+      TuneExecutorAssignment(config, profiles, FixedOptions()));
+
+  CalculatorGraphConfig expected = ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        node { calculator: "ImageTransformationCalculator" }
+        node {
+          name: "inference"
+          calculator: "InferenceCalculator"
+          executor: "heavy"
+        }
+        node {
+          name: "other_inference"
+          calculator: "InferenceCalculator"
+          executor: "heavy"
+        }
+        node { name: "detections" calculator: "TensorsToDetectionsCalculator" }
+        node {
+          name: "inference_3"
+          calculator: "InferenceCalculator"
+          executor: "heavy"
+        }
+        executor {
+          name: "heavy"
+          type: "ThreadPoolExecutor"
+          options {
+            [mediapipe.ThreadPoolExecutorOptions.ext] { num_threads: 2 }
+          }
+        }
+      )pb");
+  EXPECT_THAT(tuned, EqualsProto(expected));
+}
+
+TEST(ExecutorTunerTest, KeepsExplicitAssignmentsAndUnprofiledNodes) {
+  CalculatorGraphConfig config = ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        node { name: "a" calculator: "ACalculator" executor: "custom" }
+        node { name: "b" calculator: "BCalculator" }
+        node { name: "c" calculator: "CCalculator" executor: "heavy" }
+        executor { name: "custom" type: "ThreadPoolExecutor" }
+        executor {
+          name: "heavy"
+          type: "ThreadPoolExecutor"
+          options {
+            [mediapipe.ThreadPoolExecutorOptions.ext] { num_threads: 4 }
+          }
+        }
+      )pb");
+  std::vector<CalculatorProfile> profiles = {
+      MakeProfile("a", 30000, 3),
+      MakeProfile("c", 300, 3),
+  };
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      CalculatorGraphConfig tuned,
+      TuneExecutorAssignment(config, profiles, FixedOptions()));
+
+  CalculatorGraphConfig expected = ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        node { name: "a" calculator: "ACalculator" executor: "custom" }
+        node { name: "b" calculator: "BCalculator" }
+        node { name: "c" calculator: "CCalculator" }
+        executor { name: "custom" type: "ThreadPoolExecutor" }
+      )pb");
+  EXPECT_THAT(tuned, EqualsProto(expected));
+}
+
+TEST(ExecutorTunerTest, SizesDefaultExecutor) {
+  CalculatorGraphConfig config = ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        node { name: "a" calculator: "ACalculator" }
+        node { name: "b" calculator: "BCalculator" }
+      )pb");
+  std::vector<CalculatorProfile> profiles = {
+      MakeProfile("a", 30000, 3),
+      MakeProfile("b", 300, 3),
+  };
+  ExecutorTuningOptions options = FixedOptions();
+  options.tune_default_threads = true;
+
+  MP_ASSERT_OK_AND_ASSIGN(CalculatorGraphConfig tuned,
+                          TuneExecutorAssignment(config, profiles, options));
+
+  ASSERT_EQ(tuned.executor_size(), 2);
+  EXPECT_EQ(tuned.executor(1).name(), "");
+  EXPECT_EQ(tuned.executor(1)
+                .options()
+                .GetExtension(ThreadPoolExecutorOptions::ext)
+                .num_threads(),
+            1);
+}
+
+}  // namespace
+}  // namespace tool
+}  // namespace mediapipe
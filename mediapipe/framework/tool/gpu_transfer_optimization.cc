@@ -0,0 +1,216 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/tool/gpu_transfer_optimization.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/tool/subgraph_expansion.h"
+#include "mediapipe/framework/tool/validate_name.h"
+
+namespace mediapipe {
+
+namespace tool {
+
+namespace {
+
+constexpr char kUploadCalculator[] = "ImageFrameToGpuBufferCalculator";
+constexpr char kDownloadCalculator[] = "GpuBufferToImageFrameCalculator";
+
+// Returns the name of the stream in a "TAG:index:name" specification.
+absl::StatusOr<std::string> StreamName(const std::string& tag_index_name) {
+  std::string tag, name;
+  int index;
+  MP_RETURN_IF_ERROR(ParseTagIndexName(tag_index_name, &tag, &index, &name));
+  return name;
+}
+
+// Returns the calculator that undoes the conversion of a converter node.
+absl::string_view OppositeConverter(absl::string_view calculator) {
+  return calculator == kUploadCalculator ? kDownloadCalculator
+                                         : kUploadCalculator;
+}
+
+// Returns true if the node is a converter that can be removed without
+// affecting anything but the streams it connects.
+bool IsRemovableConverterNode(const CalculatorGraphConfig& config,
+                              const CalculatorGraphConfig::Node& node) {
+  if ((node.calculator() != kUploadCalculator &&
+       node.calculator() != kDownloadCalculator) ||
+      node.input_stream_size() != 1 || node.output_stream_size() != 1 ||
+      node.input_side_packet_size() != 0 ||
+      node.output_side_packet_size() != 0 ||
+      node.input_stream_info_size() != 0 || node.has_options() ||
+      node.node_options_size() != 0 || node.has_output_stream_handler()) {
+    return false;
+  }
+  const std::string& input_handler =
+      node.has_input_stream_handler()
+          ? node.input_stream_handler().input_stream_handler()
+          : config.input_stream_handler().input_stream_handler();
+  return input_handler.empty() || input_handler == "DefaultInputStreamHandler";
+}
+
+}  // namespace
+
+absl::Status OptimizeGpuTransfers(
+    CalculatorGraphConfig* config,
+    std::map<std::string, std::string>* stream_aliases) {
+  std::set<std::string> graph_output_streams;
+  for (const auto& stream : config->output_stream()) {
+    ASSIGN_OR_RETURN(std::string name, StreamName(stream));
+    graph_output_streams.insert(name);
+  }
+  std::set<std::string> consumed_streams;
+  for (const auto& node : config->node()) {
+    for (const auto& stream : node.input_stream()) {
+      ASSIGN_OR_RETURN(std::string name, StreamName(stream));
+      consumed_streams.insert(name);
+    }
+  }
+
+  // Maps each replaced output stream to the stream that replaces it.
+  std::map<std::string, std::string> renames;
+  auto resolve = [&renames](absl::string_view name) {
+    std::string result(name);
+    for (int i = 0; i <= renames.size(); ++i) {
+      auto iter = renames.find(result);
+      if (iter == renames.end()) {
+        break;
+      }
+      result = iter->second;
+    }
+    return result;
+  };
+
+  std::vector<bool> removed(config->node_size(), false);
+  for (bool changed = true; changed;) {
+    changed = false;
+    // The converter nodes producing each stream, and the first output of each
+    // conversion of an input stream.
+    std::map<std::string, int> producers;
+    std::map<std::pair<std::string, std::string>, std::string> conversions;
+    for (int i = 0; i < config->node_size(); ++i) {
+      const CalculatorGraphConfig::Node& node = config->node(i);
+      if (removed[i] || !IsRemovableConverterNode(*config, node)) {
+        continue;
+      }
+      ASSIGN_OR_RETURN(std::string input_name,
+                       StreamName(node.input_stream(0)));
+      ASSIGN_OR_RETURN(std::string output_name,
+                       StreamName(node.output_stream(0)));
+      producers[output_name] = i;
+      conversions.insert({{node.calculator(), input_name}, output_name});
+    }
+
+    for (int i = 0; i < config->node_size(); ++i) {
+      const CalculatorGraphConfig::Node& node = config->node(i);
+      if (removed[i] || !IsRemovableConverterNode(*config, node)) {
+        continue;
+      }
+      ASSIGN_OR_RETURN(std::string input_name,
+                       StreamName(node.input_stream(0)));
+      ASSIGN_OR_RETURN(std::string output_name,
+                       StreamName(node.output_stream(0)));
+      if (graph_output_streams.count(output_name) > 0) {
+        continue;
+      }
+      std::string replacement;
+      auto producer = producers.find(input_name);
+      if (producer != producers.end() &&
+          config->node(producer->second).calculator() ==
+              OppositeConverter(node.calculator())) {
+        ASSIGN_OR_RETURN(
+            replacement,
+            StreamName(config->node(producer->second).input_stream(0)));
+      } else {
+        replacement = conversions.at({node.calculator(), input_name});
+      }
+      if (replacement == output_name) {
+        continue;
+      }
+      renames[output_name] = replacement;
+      removed[i] = true;
+      changed = true;
+    }
+
+    for (int i = 0; i < config->node_size(); ++i) {
+      if (!removed[i]) {
+        MP_RETURN_IF_ERROR(TransformStreamNames(
+            config->mutable_node(i)->mutable_input_stream(), resolve));
+      }
+    }
+  }
+
+  // Removes the converters left without consumers, which were only needed by
+  // the replaced ones.
+  for (bool changed = true; changed;) {
+    changed = false;
+    std::set<std::string> consumers;
+    for (int i = 0; i < config->node_size(); ++i) {
+      if (removed[i]) {
+        continue;
+      }
+      for (const auto& stream : config->node(i).input_stream()) {
+        ASSIGN_OR_RETURN(std::string name, StreamName(stream));
+        consumers.insert(name);
+      }
+    }
+    for (int i = 0; i < config->node_size(); ++i) {
+      const CalculatorGraphConfig::Node& node = config->node(i);
+      if (removed[i] || !IsRemovableConverterNode(*config, node)) {
+        continue;
+      }
+      ASSIGN_OR_RETURN(std::string output_name,
+                       StreamName(node.output_stream(0)));
+      if (consumed_streams.count(output_name) > 0 &&
+          consumers.count(output_name) == 0 &&
+          graph_output_streams.count(output_name) == 0) {
+        removed[i] = true;
+        changed = true;
+      }
+    }
+  }
+
+  for (const auto& [output_name, replacement] : renames) {
+    std::string target = resolve(output_name);
+    RET_CHECK(renames.count(target) == 0)
+        << "Cycle of converter nodes through stream \"" << output_name
+        << "\".";
+  }
+  for (auto& [alias, name] : *stream_aliases) {
+    name = resolve(name);
+  }
+  for (const auto& [output_name, replacement] : renames) {
+    (*stream_aliases)[output_name] = resolve(output_name);
+  }
+
+  auto* nodes = config->mutable_node();
+  int kept = 0;
+  for (int i = 0; i < nodes->size(); ++i) {
+    if (!removed[i]) {
+      nodes->SwapElements(i, kept++);
+    }
+  }
+  nodes->DeleteSubrange(kept, nodes->size() - kept);
+  return absl::OkStatus();
+}
+
+}  // namespace tool
+}  // namespace mediapipe
@@ -0,0 +1,57 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_TOOL_GPU_TRANSFER_OPTIMIZATION_H_
+#define MEDIAPIPE_FRAMEWORK_TOOL_GPU_TRANSFER_OPTIMIZATION_H_
+
+#include <map>
+#include <string>
+
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/port/status.h"
+
+namespace mediapipe {
+
+namespace tool {
+
+// Removes the ImageFrameToGpuBufferCalculator and
+// GpuBufferToImageFrameCalculator nodes that move a frame to a device where
+// it is already available, and connects their consumers to the existing copy:
+//
+// - A converter whose input is produced by the opposite converter, such as a
+//   download of a frame that was just uploaded, is replaced by the input of
+//   that converter. The round trip is assumed to preserve the pixels.
+// - A converter that converts the same input stream as another node of the
+//   same calculator is replaced by the output of that node.
+// - A converter that no longer has any consumer after these replacements is
+//   removed.
+//
+// Only converters with exactly one input stream and one output stream, no
+// side packets, no options and the default stream handlers are considered,
+// and converters whose output stream is a graph output stream are kept, so
+// that the graph's interface does not change. The input of a
+// GpuBufferToImageFrameCalculator is assumed to be a GpuBuffer.
+//
+// For each replaced output stream, an entry mapping its name to the name of
+// the stream that now carries equivalent packets is added to stream_aliases,
+// and existing entries are updated. The output streams of converters removed
+// for lack of consumers cannot be observed anymore.
+absl::Status OptimizeGpuTransfers(
+    CalculatorGraphConfig* config,
+    std::map<std::string, std::string>* stream_aliases);
+
+}  // namespace tool
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_TOOL_GPU_TRANSFER_OPTIMIZATION_H_
@@ -0,0 +1,160 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/tool/gpu_transfer_optimization.h"
+
+#include <map>
+#include <string>
+
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(GpuTransferOptimizationTest, RemovesRoundTrip) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "ImageFrameToGpuBufferCalculator"
+          input_stream: "in"
+          output_stream: "in_gpu"
+        }
+        node {
+          calculator: "GpuBufferToImageFrameCalculator"
+          input_stream: "in_gpu"
+          output_stream: "in_cpu"
+        }
+        node {
+          calculator: "CpuCalculator"
+          input_stream: "IMAGE:in_cpu"
+          output_stream: "out"
+        }
+      )pb");
+  CalculatorGraphConfig expected_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "CpuCalculator"
+          input_stream: "IMAGE:in"
+          output_stream: "out"
+        }
+      )pb");
+  std::map<std::string, std::string> aliases;
+  MP_ASSERT_OK(tool::OptimizeGpuTransfers(&config, &aliases));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+  EXPECT_EQ(aliases, (std::map<std::string, std::string>{{"in_cpu", "in"}}));
+}
+
+TEST(GpuTransferOptimizationTest, ReusesExistingConversions) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in_gpu"
+        output_stream: "out"
+        output_stream: "out2"
+        node {
+          calculator: "GpuBufferToImageFrameCalculator"
+          input_stream: "in_gpu"
+          output_stream: "in_cpu"
+        }
+        node {
+          calculator: "CpuCalculator"
+          input_stream: "in_cpu"
+          output_stream: "out"
+        }
+        node {
+          calculator: "ImageFrameToGpuBufferCalculator"
+          input_stream: "in_cpu"
+          output_stream: "back_gpu"
+        }
+        node {
+          calculator: "GpuBufferToImageFrameCalculator"
+          input_stream: "in_gpu"
+          output_stream: "in_cpu2"
+        }
+        node {
+          calculator: "GpuCalculator"
+          input_stream: "back_gpu"
+          input_stream: "in_cpu2"
+          output_stream: "out2"
+        }
+      )pb");
+  CalculatorGraphConfig expected_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in_gpu"
+        output_stream: "out"
+        output_stream: "out2"
+        node {
+          calculator: "GpuBufferToImageFrameCalculator"
+          input_stream: "in_gpu"
+          output_stream: "in_cpu"
+        }
+        node {
+          calculator: "CpuCalculator"
+          input_stream: "in_cpu"
+          output_stream: "out"
+        }
+        node {
+          calculator: "GpuCalculator"
+          input_stream: "in_gpu"
+          input_stream: "in_cpu"
+          output_stream: "out2"
+        }
+      )pb");
+  std::map<std::string, std::string> aliases = {{"old", "in_cpu2"}};
+  MP_ASSERT_OK(tool::OptimizeGpuTransfers(&config, &aliases));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+  EXPECT_EQ(aliases, (std::map<std::string, std::string>{
+                         {"back_gpu", "in_gpu"},
+                         {"in_cpu2", "in_cpu"},
+                         {"old", "in_cpu"}}));
+}
+
+TEST(GpuTransferOptimizationTest, KeepsConvertersThatChangeTheGraph) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "in_cpu"
+        node {
+          calculator: "ImageFrameToGpuBufferCalculator"
+          input_stream: "in"
+          output_stream: "in_gpu"
+        }
+        node {
+          calculator: "GpuBufferToImageFrameCalculator"
+          input_stream: "in_gpu"
+          output_stream: "in_cpu"
+        }
+        node {
+          calculator: "GpuBufferToImageFrameCalculator"
+          input_stream: "in_gpu"
+          output_stream: "in_cpu2"
+          input_side_packet: "GPU_SHARED:gpu_shared"
+        }
+      )pb");
+  CalculatorGraphConfig expected_config = config;
+  std::map<std::string, std::string> aliases;
+  MP_ASSERT_OK(tool::OptimizeGpuTransfers(&config, &aliases));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+  EXPECT_TRUE(aliases.empty());
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,140 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/tool/pass_through_elimination.h"
+
+#include <set>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/tool/subgraph_expansion.h"
+#include "mediapipe/framework/tool/validate_name.h"
+
+namespace mediapipe {
+
+namespace tool {
+
+namespace {
+
+// Returns the name of the stream in a "TAG:index:name" specification.
+absl::StatusOr<std::string> StreamName(const std::string& tag_index_name) {
+  std::string tag, name;
+  int index;
+  MP_RETURN_IF_ERROR(ParseTagIndexName(tag_index_name, &tag, &index, &name));
+  return name;
+}
+
+// Returns true if the input stream handler forwards every packet of a single
+// input stream as soon as it arrives.
+bool ForwardsAllPackets(const InputStreamHandlerConfig& handler) {
+  const std::string& name = handler.input_stream_handler();
+  return name.empty() || name == "DefaultInputStreamHandler" ||
+         name == "ImmediateInputStreamHandler";
+}
+
+// Returns true if the node can be removed by connecting the consumers of its
+// output stream to its input stream.
+bool IsRemovablePassThroughNode(const CalculatorGraphConfig& config,
+                                const CalculatorGraphConfig::Node& node) {
+  if (node.calculator() != "PassThroughCalculator" ||
+      node.input_stream_size() != 1 || node.output_stream_size() != 1 ||
+      node.input_side_packet_size() != 0 ||
+      node.output_side_packet_size() != 0 ||
+      node.input_stream_info_size() != 0 || node.has_options() ||
+      node.node_options_size() != 0) {
+    return false;
+  }
+  const std::string& output_handler =
+      node.output_stream_handler().output_stream_handler();
+  if (!output_handler.empty() &&
+      output_handler != "InOrderOutputStreamHandler") {
+    return false;
+  }
+  return node.has_input_stream_handler()
+             ? ForwardsAllPackets(node.input_stream_handler())
+             : ForwardsAllPackets(config.input_stream_handler());
+}
+
+}  // namespace
+
+absl::Status EliminatePassThroughNodes(
+    CalculatorGraphConfig* config,
+    std::map<std::string, std::string>* stream_aliases) {
+  std::set<std::string> graph_output_streams;
+  for (const auto& stream : config->output_stream()) {
+    ASSIGN_OR_RETURN(std::string name, StreamName(stream));
+    graph_output_streams.insert(name);
+  }
+
+  // Maps each removed output stream to the input stream of its node.
+  std::map<std::string, std::string> renames;
+  std::vector<bool> removed(config->node_size(), false);
+  for (int i = 0; i < config->node_size(); ++i) {
+    const CalculatorGraphConfig::Node& node = config->node(i);
+    if (!IsRemovablePassThroughNode(*config, node)) {
+      continue;
+    }
+    ASSIGN_OR_RETURN(std::string input_name, StreamName(node.input_stream(0)));
+    ASSIGN_OR_RETURN(std::string output_name,
+                     StreamName(node.output_stream(0)));
+    if (graph_output_streams.count(output_name) > 0 ||
+        input_name == output_name) {
+      continue;
+    }
+    renames[output_name] = input_name;
+    removed[i] = true;
+  }
+  if (renames.empty()) {
+    return absl::OkStatus();
+  }
+
+  // Follows chains of removed nodes to the stream that remains.
+  auto resolve = [&renames](absl::string_view name) {
+    std::string result(name);
+    for (int i = 0; i <= renames.size(); ++i) {
+      auto iter = renames.find(result);
+      if (iter == renames.end()) {
+        break;
+      }
+      result = iter->second;
+    }
+    return result;
+  };
+  for (const auto& [output_name, input_name] : renames) {
+    std::string target = resolve(output_name);
+    RET_CHECK(renames.count(target) == 0)
+        << "Cycle of PassThroughCalculator nodes through stream \""
+        << output_name << "\".";
+    (*stream_aliases)[output_name] = target;
+  }
+
+  auto* nodes = config->mutable_node();
+  int kept = 0;
+  for (int i = 0; i < nodes->size(); ++i) {
+    if (!removed[i]) {
+      nodes->SwapElements(i, kept++);
+    }
+  }
+  nodes->DeleteSubrange(kept, nodes->size() - kept);
+  for (auto& node : *nodes) {
+    MP_RETURN_IF_ERROR(
+        TransformStreamNames(node.mutable_input_stream(), resolve));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace tool
+}  // namespace mediapipe
@@ -0,0 +1,49 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_TOOL_PASS_THROUGH_ELIMINATION_H_
+#define MEDIAPIPE_FRAMEWORK_TOOL_PASS_THROUGH_ELIMINATION_H_
+
+#include <map>
+#include <string>
+
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/port/status.h"
+
+namespace mediapipe {
+
+namespace tool {
+
+// Removes the calculator nodes that forward a single input stream unchanged
+// to a single output stream, and connects the consumers of the output stream
+// to the input stream instead. Such nodes are typically left behind by
+// subgraph expansion, and each one costs a scheduler round trip per packet.
+//
+// A node is removed only if the result is indistinguishable to the rest of
+// the graph: it must be a PassThroughCalculator with exactly one input stream
+// and one output stream, no side packets, no back edge, no options, and an
+// input stream handler that forwards every packet. Nodes whose output stream
+// is a graph output stream are kept, so that the graph's interface does not
+// change.
+//
+// For each removed output stream, an entry mapping its name to the name of
+// the stream that now carries its packets is added to stream_aliases.
+absl::Status EliminatePassThroughNodes(
+    CalculatorGraphConfig* config,
+    std::map<std::string, std::string>* stream_aliases);
+
+}  // namespace tool
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_TOOL_PASS_THROUGH_ELIMINATION_H_
@@ -0,0 +1,158 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/tool/pass_through_elimination.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/sink.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(PassThroughEliminationTest, RemovesChainOfPassThroughNodes) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "a"
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "a"
+          output_stream: "b"
+        }
+        node {
+          calculator: "SomeCalculator"
+          input_stream: "TAG:0:b"
+          output_stream: "out"
+        }
+      )pb");
+  CalculatorGraphConfig expected_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "SomeCalculator"
+          input_stream: "TAG:0:in"
+          output_stream: "out"
+        }
+      )pb");
+  std::map<std::string, std::string> aliases;
+  MP_ASSERT_OK(tool::EliminatePassThroughNodes(&config, &aliases));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+  EXPECT_EQ(aliases, (std::map<std::string, std::string>{{"a", "in"},
+                                                          {"b", "in"}}));
+}
+
+TEST(PassThroughEliminationTest, KeepsNodesThatChangeTheGraph) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        input_stream: "in2"
+        output_stream: "out"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "out"
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          input_stream: "in2"
+          output_stream: "a"
+          output_stream: "b"
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "c"
+          input_stream_handler {
+            input_stream_handler: "FixedSizeInputStreamHandler"
+          }
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          input_side_packet: "side"
+          output_stream: "d"
+        }
+      )pb");
+  CalculatorGraphConfig expected_config = config;
+  std::map<std::string, std::string> aliases;
+  MP_ASSERT_OK(tool::EliminatePassThroughNodes(&config, &aliases));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+  EXPECT_TRUE(aliases.empty());
+}
+
+TEST(PassThroughEliminationTest, GraphOutputsMatchAndAliasesAreObservable) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        eliminate_pass_through_nodes: true
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "a"
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "a"
+          output_stream: "b"
+        }
+      )pb");
+  std::vector<Packet> out_packets;
+  tool::AddVectorSink("b", &config, &out_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  // Only the nodes of the vector sink remain.
+  for (const auto& node : graph.Config().node()) {
+    EXPECT_NE("PassThroughCalculator", node.calculator());
+  }
+  std::vector<Packet> observed_packets;
+  MP_ASSERT_OK(graph.ObserveOutputStream("a", [&](const Packet& packet) {
+    observed_packets.push_back(packet);
+    return absl::OkStatus();
+  }));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 3; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "in", MakePacket<int>(i).At(Timestamp(i))));
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  ASSERT_EQ(3, out_packets.size());
+  ASSERT_EQ(3, observed_packets.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i, out_packets[i].Get<int>());
+    EXPECT_EQ(Timestamp(i), out_packets[i].Timestamp());
+    EXPECT_EQ(i, observed_packets[i].Get<int>());
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,174 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/framework/tool/shader_fusion.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/deps/no_destructor.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/port/statusor.h"
+#include "mediapipe/framework/tool/shader_fusion.pb.h"
+#include "mediapipe/framework/tool/validate_name.h"
+
+namespace mediapipe {
+
+namespace tool {
+
+namespace {
+
+struct ShaderRegistry {
+  absl::Mutex mutex;
+  // Snippets are never removed, so pointers to them stay valid.
+  absl::flat_hash_map<std::string, std::unique_ptr<std::string>> snippets
+      ABSL_GUARDED_BY(mutex);
+};
+
+ShaderRegistry& GetShaderRegistry() {
+  static NoDestructor<ShaderRegistry> registry;
+  return *registry;
+}
+
+// Returns the name of the stream in a "TAG:index:name" specification.
+absl::StatusOr<std::string> StreamName(const std::string& tag_index_name) {
+  std::string tag, name;
+  int index;
+  MP_RETURN_IF_ERROR(ParseTagIndexName(tag_index_name, &tag, &index, &name));
+  return name;
+}
+
+// Returns true if the input stream handler forwards every packet of a single
+// input stream as soon as it arrives.
+bool ForwardsAllPackets(const InputStreamHandlerConfig& handler) {
+  const std::string& name = handler.input_stream_handler();
+  return name.empty() || name == "DefaultInputStreamHandler" ||
+         name == "ImmediateInputStreamHandler";
+}
+
+// Returns true if the node can be part of a fused chain.
+bool IsFusableNode(const CalculatorGraphConfig::Node& node) {
+  return FindFusableShader(node.calculator()) != nullptr &&
+         node.input_stream_size() == 1 && node.output_stream_size() == 1 &&
+         node.input_side_packet_size() == 0 &&
+         node.output_side_packet_size() == 0 &&
+         node.input_stream_info_size() == 0 && !node.has_options() &&
+         node.node_options_size() == 0 &&
+         (!node.has_input_stream_handler() ||
+          ForwardsAllPackets(node.input_stream_handler())) &&
+         !node.has_output_stream_handler();
+}
+
+}  // namespace
+
+void RegisterFusableShader(absl::string_view calculator,
+                           absl::string_view snippet) {
+  ShaderRegistry& registry = GetShaderRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.snippets[calculator] = std::make_unique<std::string>(snippet);
+}
+
+const std::string* FindFusableShader(absl::string_view calculator) {
+  ShaderRegistry& registry = GetShaderRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  auto iter = registry.snippets.find(calculator);
+  return iter == registry.snippets.end() ? nullptr : iter->second.get();
+}
+
+absl::Status FuseShaderNodes(CalculatorGraphConfig* config) {
+  std::set<std::string> graph_output_streams;
+  for (const auto& stream : config->output_stream()) {
+    ASSIGN_OR_RETURN(std::string name, StreamName(stream));
+    graph_output_streams.insert(name);
+  }
+  // Maps each stream to the nodes reading it.
+  std::map<std::string, std::vector<int>> consumers;
+  for (int i = 0; i < config->node_size(); ++i) {
+    for (const auto& stream : config->node(i).input_stream()) {
+      ASSIGN_OR_RETURN(std::string name, StreamName(stream));
+      consumers[name].push_back(i);
+    }
+  }
+
+  // Links each fusable node to the fusable node reading its output, if that
+  // node is the only reader.
+  const int num_nodes = config->node_size();
+  std::vector<int> next(num_nodes, -1);
+  std::vector<bool> has_prev(num_nodes, false);
+  for (int i = 0; i < num_nodes; ++i) {
+    const CalculatorGraphConfig::Node& node = config->node(i);
+    if (!IsFusableNode(node)) continue;
+    ASSIGN_OR_RETURN(std::string output_name,
+                     StreamName(node.output_stream(0)));
+    const std::vector<int>& readers = consumers[output_name];
+    if (graph_output_streams.count(output_name) > 0 || readers.size() != 1 ||
+        readers[0] == i) {
+      continue;
+    }
+    const CalculatorGraphConfig::Node& reader = config->node(readers[0]);
+    if (!IsFusableNode(reader) || reader.executor() != node.executor()) {
+      continue;
+    }
+    next[i] = readers[0];
+    has_prev[readers[0]] = true;
+  }
+
+  // Replaces each chain by a fused node at the position of its first node.
+  std::vector<bool> removed(num_nodes, false);
+  bool fused_any = false;
+  for (int i = 0; i < num_nodes; ++i) {
+    if (has_prev[i] || next[i] < 0) continue;
+    FusedShaderCalculatorOptions options;
+    int last = i;
+    // Each node has at most one predecessor, and the first has none, so the
+    // chain ends.
+    for (int j = i; j >= 0; j = next[j]) {
+      options.add_calculator(config->node(j).calculator());
+      removed[j] = j != i;
+      last = j;
+    }
+    CalculatorGraphConfig::Node fused;
+    fused.set_calculator(std::string(kFusedShaderCalculator));
+    fused.set_name(config->node(i).name());
+    fused.add_input_stream(config->node(i).input_stream(0));
+    fused.add_output_stream(config->node(last).output_stream(0));
+    fused.set_executor(config->node(i).executor());
+    *fused.mutable_options()->MutableExtension(
+        FusedShaderCalculatorOptions::ext) = options;
+    *config->mutable_node(i) = std::move(fused);
+    fused_any = true;
+  }
+  if (!fused_any) {
+    return absl::OkStatus();
+  }
+
+  auto* nodes = config->mutable_node();
+  int kept = 0;
+  for (int i = 0; i < nodes->size(); ++i) {
+    if (!removed[i]) {
+      nodes->SwapElements(i, kept++);
+    }
+  }
+  nodes->DeleteSubrange(kept, nodes->size() - kept);
+  return absl::OkStatus();
+}
+
+}  // namespace tool
+}  // namespace mediapipe
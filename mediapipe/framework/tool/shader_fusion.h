@@ -0,0 +1,74 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_FRAMEWORK_TOOL_SHADER_FUSION_H_
+#define MEDIAPIPE_FRAMEWORK_TOOL_SHADER_FUSION_H_
+
+#include <string>
+
+#include "absl/base/attributes.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/port/status.h"
+
+namespace mediapipe {
+
+namespace tool {
+
+// The calculator that replaces a chain of fused nodes. It is a GPU calculator
+// defined in gpu/gl_fused_shader_calculator.cc.
+inline constexpr absl::string_view kFusedShaderCalculator =
+    "GlFusedShaderCalculator";
+
+// Registers the fragment shader snippet of a GL calculator that maps each
+// pixel of a single GpuBuffer input stream to the same pixel of a single
+// GpuBuffer output stream of the same size, like GlSimpleCalculators that
+// only recolor. The snippet is the body of a GLSL function
+//
+//   vec4 f(vec4 color)
+//
+// which returns the output color of a pixel given its input color.
+void RegisterFusableShader(absl::string_view calculator,
+                           absl::string_view snippet);
+
+// Returns the snippet registered for a calculator, or nullptr if there is
+// none.
+const std::string* FindFusableShader(absl::string_view calculator);
+
+// Replaces each chain of two or more nodes with registered fragment shader
+// snippets by a single kFusedShaderCalculator node, which draws their
+// composed snippets in one pass. This saves the intermediate textures and a
+// full-screen pass per fused node.
+//
+// A node is fused only if it has one input and one output stream, no side
+// packets, no options, no back edge, and a default input stream handler.
+// Two nodes are chained if the output stream of the first is read only by
+// the second and is not a graph output stream; the intermediate streams are
+// removed from the graph.
+absl::Status FuseShaderNodes(CalculatorGraphConfig* config);
+
+}  // namespace tool
+}  // namespace mediapipe
+
+// Registers a fragment shader snippet for a calculator, at namespace scope.
+// See RegisterFusableShader.
+#define REGISTER_FUSABLE_SHADER(calculator, snippet)             \
+  static const bool mediapipe_fusable_shader_##calculator        \
+      ABSL_ATTRIBUTE_UNUSED =                                    \
+          (::mediapipe::tool::RegisterFusableShader(#calculator, \
+                                                    snippet),    \
+           true)
+
+#endif  // MEDIAPIPE_FRAMEWORK_TOOL_SHADER_FUSION_H_
@@ -0,0 +1,154 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/framework/tool/shader_fusion.h"
+
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/tool/shader_fusion.pb.h"
+
+namespace mediapipe {
+namespace {
+
+REGISTER_FUSABLE_SHADER(FakeInvertCalculator,
+                        "return vec4(1.0 - color.rgb, color.a);");
+REGISTER_FUSABLE_SHADER(FakeOpaqueCalculator,
+                        "return vec4(color.rgb, 1.0);");
+
+TEST(ShaderFusionTest, FindsRegisteredShaders) {
+  ASSERT_NE(tool::FindFusableShader("FakeOpaqueCalculator"), nullptr);
+  EXPECT_EQ(*tool::FindFusableShader("FakeOpaqueCalculator"),
+            "return vec4(color.rgb, 1.0);");
+  EXPECT_EQ(tool::FindFusableShader("PassThroughCalculator"), nullptr);
+}
+
+TEST(ShaderFusionTest, FusesChainOfShaderNodes) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          name: "invert"
+          calculator: "FakeInvertCalculator"
+          input_stream: "VIDEO:in"
+          output_stream: "VIDEO:a"
+        }
+        node {
+          calculator: "FakeOpaqueCalculator"
+          input_stream: "VIDEO:a"
+          output_stream: "VIDEO:b"
+        }
+        node {
+          calculator: "FakeInvertCalculator"
+          input_stream: "VIDEO:b"
+          output_stream: "VIDEO:c"
+        }
+        node {
+          calculator: "SomeCalculator"
+          input_stream: "c"
+          output_stream: "out"
+        }
+      )pb");
+  CalculatorGraphConfig expected_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          name: "invert"
+          calculator: "GlFusedShaderCalculator"
+          input_stream: "VIDEO:in"
+          output_stream: "VIDEO:c"
+          options {
+            [mediapipe.FusedShaderCalculatorOptions.ext] {
+              calculator: "FakeInvertCalculator"
+              calculator: "FakeOpaqueCalculator"
+              calculator: "FakeInvertCalculator"
+            }
+          }
+        }
+        node {
+          calculator: "SomeCalculator"
+          input_stream: "c"
+          output_stream: "out"
+        }
+      )pb");
+  MP_ASSERT_OK(tool::FuseShaderNodes(&config));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+}
+
+TEST(ShaderFusionTest, KeepsStreamsReadElsewhere) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "a"
+        output_stream: "out"
+        output_stream: "out2"
+        node {
+          calculator: "FakeInvertCalculator"
+          input_stream: "in"
+          output_stream: "a"
+        }
+        node {
+          calculator: "FakeOpaqueCalculator"
+          input_stream: "a"
+          output_stream: "b"
+        }
+        node {
+          calculator: "FakeInvertCalculator"
+          input_stream: "b"
+          output_stream: "out"
+        }
+        node {
+          calculator: "SomeCalculator"
+          input_stream: "b"
+          output_stream: "out2"
+        }
+      )pb");
+  CalculatorGraphConfig expected_config = config;
+  // "a" is a graph output stream, and "b" is read by two nodes.
+  MP_ASSERT_OK(tool::FuseShaderNodes(&config));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+}
+
+TEST(ShaderFusionTest, KeepsNodesWithOptions) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "FakeInvertCalculator"
+          input_stream: "in"
+          output_stream: "a"
+          input_side_packet: "side"
+        }
+        node {
+          calculator: "FakeOpaqueCalculator"
+          input_stream: "a"
+          output_stream: "out"
+          input_stream_handler {
+            input_stream_handler: "FixedSizeInputStreamHandler"
+          }
+        }
+      )pb");
+  CalculatorGraphConfig expected_config = config;
+  MP_ASSERT_OK(tool::FuseShaderNodes(&config));
+  EXPECT_THAT(config, mediapipe::EqualsProto(expected_config));
+}
+
+}  // namespace
+}  // namespace mediapipe
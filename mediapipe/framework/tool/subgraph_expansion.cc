@@ -181,8 +181,9 @@ absl::Status FindCorrespondingStreams(
 
 // The following fields can be used in a Node message for a subgraph:
 //   name, calculator, input_stream, output_stream, input_side_packet,
-//   output_side_packet, options.
-// All other fields are only applicable to calculators.
+//   output_side_packet, options, max_in_flight.
+// All other fields are only applicable to calculators. The max_in_flight field
+// of a subgraph node applies to the nodes of the subgraph that don't set it.
 // TODO: Check whether executor is not set in the subgraph node
 // after this issues is properly solved.
 absl::Status ValidateSubgraphFields(
@@ -303,6 +304,15 @@ absl::Status ExpandSubgraphs(CalculatorGraphConfig* config,
                                           config->package(), node.calculator(),
                                           &subgraph_context));
       MP_RETURN_IF_ERROR(mediapipe::tool::DefineGraphOptions(node, &subgraph));
+      // Runs the whole subgraph in parallel, e.g. as the body of a loop. The
+      // nested subgraphs pass it on when they are expanded in turn.
+      if (node.max_in_flight() > 0) {
+        for (auto& subgraph_node : *subgraph.mutable_node()) {
+          if (subgraph_node.max_in_flight() == 0) {
+            subgraph_node.set_max_in_flight(node.max_in_flight());
+          }
+        }
+      }
       MP_RETURN_IF_ERROR(PrefixNames(node_name, &subgraph));
       MP_RETURN_IF_ERROR(ConnectSubgraphStreams(node, &subgraph));
       subgraphs.push_back(subgraph);
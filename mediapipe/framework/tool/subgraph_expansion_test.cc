@@ -529,6 +529,35 @@ TEST(SubgraphExpansionTest, ExecutorFieldOfNodeInSubgraphPreserved) {
   EXPECT_THAT(supergraph, mediapipe::EqualsProto(expected_graph));
 }
 
+// The "max_in_flight" field of a subgraph node applies to the nodes of the
+// subgraph and of its nested subgraphs.
+TEST(SubgraphExpansionTest, MaxInFlightFieldOfSubgraphNodePropagated) {
+  CalculatorGraphConfig supergraph =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input"
+        node {
+          calculator: "EnclosingSubgraph"
+          input_stream: "IN:input"
+          output_stream: "OUT:output"
+          max_in_flight: 4
+        }
+      )pb");
+  CalculatorGraphConfig expected_graph = mediapipe::ParseTextProtoOrDie<
+      CalculatorGraphConfig>(R"pb(
+    input_stream: "input"
+    node {
+      calculator: "PassThroughCalculator"
+      name: "enclosingsubgraph__nodewithexecutorsubgraph__PassThroughCalculator"
+      input_stream: "input"
+      output_stream: "output"
+      executor: "custom_thread_pool"
+      max_in_flight: 4
+    }
+  )pb");
+  MP_EXPECT_OK(tool::ExpandSubgraphs(&supergraph));
+  EXPECT_THAT(supergraph, mediapipe::EqualsProto(expected_graph));
+}
+
 const mediapipe::GraphService<std::string> kStringTestService{
     "mediapipe::StringTestService"};
 class GraphServicesClientTestSubgraph : public Subgraph {
@@ -232,6 +232,36 @@ absl::Status ValidateContract(
   return absl::OkStatus();
 }
 
+// Replaces a contained node with a SwitchLazyNodeCalculator, which runs the
+// contained node only while its channel is selected.
+absl::Status WrapLazyNode(int channel, const std::string& select_stream,
+                          const std::string& enable_stream,
+                          const SwitchContainerOptions& switch_options,
+                          CalculatorGraphConfig::Node* node) {
+  if (node->output_side_packet_size() > 0) {
+    return absl::InvalidArgumentError(
+        "SwitchContainer option 'lazy_open' does not support contained nodes "
+        "with output side packets");
+  }
+  SwitchContainerOptions options = switch_options;
+  ClearContainerOptions(&options);
+  *options.add_contained_node() = *node;
+  options.set_contained_channel(channel);
+
+  CalculatorGraphConfig::Node wrapper;
+  *wrapper.mutable_calculator() = "SwitchLazyNodeCalculator";
+  *wrapper.mutable_input_stream() = node->input_stream();
+  *wrapper.mutable_output_stream() = node->output_stream();
+  *wrapper.mutable_input_side_packet() = node->input_side_packet();
+  wrapper.add_input_stream(select_stream);
+  wrapper.add_input_stream(enable_stream);
+  wrapper.add_input_side_packet("SELECT:gate_select");
+  wrapper.add_input_side_packet("ENABLE:gate_enable");
+  wrapper.add_node_options()->PackFrom(options);
+  *node = std::move(wrapper);
+  return absl::OkStatus();
+}
+
 // Returns true if a set of streams references a certain tag name.
 bool HasTag(const proto_ns::RepeatedPtrField<std::string>& streams,
             std::string tag) {
@@ -409,6 +439,11 @@ absl::StatusOr<CalculatorGraphConfig> SwitchContainer::GetConfig(
       subnodes[channel]->add_output_side_packet(CatStream(tag_index, name));
       mux->add_input_side_packet(CatStream({tag, tag_index.second}, name));
     }
+
+    if (switch_options.lazy_open()) {
+      MP_RETURN_IF_ERROR(WrapLazyNode(channel, select_stream, enable_stream,
+                                      switch_options, subnodes[channel]));
+    }
   }
 
   return config;
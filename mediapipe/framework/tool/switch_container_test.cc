@@ -315,6 +315,22 @@ TEST(SwitchContainerTest, RunsWithSubnodes) {
   RunTestContainer(supergraph);
 }
 
+// Shows the SwitchContainer runs with subnodes opened on first selection.
+TEST(SwitchContainerTest, RunsWithLazySubnodes) {
+  CalculatorGraphConfig supergraph =
+      SubnodeContainerExample("async_selection: true lazy_open: true");
+  MP_EXPECT_OK(tool::ExpandSubgraphs(&supergraph));
+  RunTestContainer(supergraph);
+}
+
+// Shows the SwitchContainer reopens lazy subnodes closed while deselected.
+TEST(SwitchContainerTest, RunsWithClosedInactiveSubnodes) {
+  CalculatorGraphConfig supergraph = SubnodeContainerExample(
+      "lazy_open: true close_inactive_after_ms: 1");
+  MP_EXPECT_OK(tool::ExpandSubgraphs(&supergraph));
+  RunTestContainer(supergraph, true);
+}
+
 // Shows the SwitchContainer  does not allow input_stream_handler overwrite.
 TEST(SwitchContainerTest, ValidateInputStreamHandler) {
   EXPECT_TRUE(SubgraphRegistry::IsRegistered("SwitchContainer"));
@@ -0,0 +1,289 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/collection_item_id.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/tool/container_util.h"
+#include "mediapipe/framework/tool/switch_container.pb.h"
+#include "mediapipe/framework/tool/tag_map.h"
+
+namespace mediapipe {
+
+// A calculator that runs one contained node of a SwitchContainer in a nested
+// CalculatorGraph, which is only created once the channel of the contained
+// node is selected. For example:
+//
+//         node {
+//           calculator: "SwitchLazyNodeCalculator"
+//           input_stream: "ENABLE:enable"
+//           input_stream: "FUNC_INPUT:foo_1"
+//           output_stream: "FUNC_OUTPUT:bar_1"
+//           node_options {
+//             [type.googleapis.com/mediapipe.SwitchContainerOptions] {
+//               contained_node {
+//                 calculator: "AdvancedSubgraph"
+//                 input_stream: "FUNC_INPUT:foo_1"
+//                 output_stream: "FUNC_OUTPUT:bar_1"
+//               }
+//               contained_channel: 1
+//             }
+//           }
+//         }
+//
+// Input packets are forwarded to the nested graph, which is run until idle
+// before the output packets and timestamp bounds it produced are sent.
+// With close_inactive_after_ms, the nested graph is closed once the channel
+// has been deselected for that long, and recreated when the channel is next
+// selected or receives a packet.
+//
+// SwitchLazyNodeCalculator is used by SwitchContainer with option lazy_open.
+class SwitchLazyNodeCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc);
+
+  absl::Status Open(CalculatorContext* cc) override;
+  absl::Status Process(CalculatorContext* cc) override;
+  absl::Status Close(CalculatorContext* cc) override;
+
+ private:
+  // Creates and starts the nested graph.
+  absl::Status StartGraph();
+  // Closes the nested graph and waits for it to finish.
+  absl::Status StopGraph();
+  // Sends the packets and timestamp bounds received from the nested graph.
+  void SendOutputs(CalculatorContext* cc);
+
+ private:
+  CalculatorGraphConfig graph_config_;
+  std::map<std::string, Packet> side_packets_;
+  std::map<CollectionItemId, std::string> input_names_;
+  std::map<std::string, CollectionItemId> output_ids_;
+  int channel_ = 0;
+  int channel_index_ = 0;
+  absl::Duration close_inactive_after_;
+  absl::Time deselected_time_;
+  std::unique_ptr<CalculatorGraph> graph_;
+  absl::Mutex outputs_mutex_;
+  std::vector<std::pair<CollectionItemId, Packet>> outputs_
+      ABSL_GUARDED_BY(outputs_mutex_);
+};
+REGISTER_CALCULATOR(SwitchLazyNodeCalculator);
+
+namespace {
+static constexpr char kSelectTag[] = "SELECT";
+static constexpr char kEnableTag[] = "ENABLE";
+
+// Returns true for the tags used for channel selection.
+bool IsSelectionTag(const std::string& tag) {
+  return tag == kSelectTag || tag == kEnableTag;
+}
+}  // namespace
+
+absl::Status SwitchLazyNodeCalculator::GetContract(CalculatorContract* cc) {
+  // Allow any one of kSelectTag, kEnableTag.
+  cc->Inputs().Tag(kSelectTag).Set<int>().Optional();
+  cc->Inputs().Tag(kEnableTag).Set<bool>().Optional();
+  cc->InputSidePackets().Tag(kSelectTag).Set<int>().Optional();
+  cc->InputSidePackets().Tag(kEnableTag).Set<bool>().Optional();
+
+  // The contained node checks the types of all other streams.
+  for (CollectionItemId id = cc->Inputs().BeginId();
+       id < cc->Inputs().EndId(); ++id) {
+    if (!IsSelectionTag(cc->Inputs().TagMap()->TagAndIndexFromId(id).first)) {
+      cc->Inputs().Get(id).SetAny();
+    }
+  }
+  for (CollectionItemId id = cc->InputSidePackets().BeginId();
+       id < cc->InputSidePackets().EndId(); ++id) {
+    const std::string& tag =
+        cc->InputSidePackets().TagMap()->TagAndIndexFromId(id).first;
+    if (!IsSelectionTag(tag)) {
+      cc->InputSidePackets().Get(id).SetAny();
+    }
+  }
+  for (CollectionItemId id = cc->Outputs().BeginId();
+       id < cc->Outputs().EndId(); ++id) {
+    cc->Outputs().Get(id).SetAny();
+  }
+  RET_CHECK_EQ(cc->OutputSidePackets().NumEntries(), 0)
+      << "SwitchContainer lazy_open does not support output side packets.";
+  cc->SetInputStreamHandler("ImmediateInputStreamHandler");
+  return absl::OkStatus();
+}
+
+absl::Status SwitchLazyNodeCalculator::Open(CalculatorContext* cc) {
+  const auto& options = cc->Options<mediapipe::SwitchContainerOptions>();
+  RET_CHECK_EQ(options.contained_node_size(), 1);
+  const CalculatorGraphConfig::Node& node = options.contained_node(0);
+  channel_ = options.contained_channel();
+  channel_index_ = tool::GetChannelIndex(*cc, channel_index_);
+  close_inactive_after_ = absl::Milliseconds(options.close_inactive_after_ms());
+
+  // The nested graph exposes the streams of the contained node by name.
+  *graph_config_.add_node() = node;
+  graph_config_.set_num_threads(1);
+  ASSIGN_OR_RETURN(auto input_map, tool::TagMap::Create(node.input_stream()));
+  ASSIGN_OR_RETURN(auto output_map,
+                   tool::TagMap::Create(node.output_stream()));
+  ASSIGN_OR_RETURN(auto side_map,
+                   tool::TagMap::Create(node.input_side_packet()));
+  for (const std::string& name : input_map->Names()) {
+    graph_config_.add_input_stream(name);
+  }
+  for (const std::string& name : output_map->Names()) {
+    graph_config_.add_output_stream(name);
+  }
+  for (const std::string& name : side_map->Names()) {
+    graph_config_.add_input_side_packet(name);
+  }
+
+  // Match the streams of this node with those of the contained node.
+  for (CollectionItemId id = cc->Inputs().BeginId();
+       id < cc->Inputs().EndId(); ++id) {
+    auto tag_index = cc->Inputs().TagMap()->TagAndIndexFromId(id);
+    if (IsSelectionTag(tag_index.first)) continue;
+    CollectionItemId input_id =
+        input_map->GetId(tag_index.first, tag_index.second);
+    RET_CHECK(input_id.IsValid());
+    input_names_[id] = input_map->Names()[input_id.value()];
+  }
+  for (CollectionItemId id = cc->Outputs().BeginId();
+       id < cc->Outputs().EndId(); ++id) {
+    auto tag_index = cc->Outputs().TagMap()->TagAndIndexFromId(id);
+    CollectionItemId output_id =
+        output_map->GetId(tag_index.first, tag_index.second);
+    RET_CHECK(output_id.IsValid());
+    output_ids_[output_map->Names()[output_id.value()]] = id;
+  }
+  for (CollectionItemId id = cc->InputSidePackets().BeginId();
+       id < cc->InputSidePackets().EndId(); ++id) {
+    auto tag_index = cc->InputSidePackets().TagMap()->TagAndIndexFromId(id);
+    if (IsSelectionTag(tag_index.first)) continue;
+    CollectionItemId side_id =
+        side_map->GetId(tag_index.first, tag_index.second);
+    RET_CHECK(side_id.IsValid());
+    side_packets_[side_map->Names()[side_id.value()]] =
+        cc->InputSidePackets().Get(id);
+  }
+
+  // Only the initially selected contained node is opened with the graph.
+  if (channel_index_ == channel_) {
+    MP_RETURN_IF_ERROR(StartGraph());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SwitchLazyNodeCalculator::Process(CalculatorContext* cc) {
+  int channel_index = tool::GetChannelIndex(*cc, channel_index_);
+  if (channel_index != channel_index_) {
+    if (channel_index_ == channel_) {
+      deselected_time_ = absl::Now();
+    }
+    channel_index_ = channel_index;
+  }
+  if (channel_index_ == channel_ && graph_ == nullptr) {
+    MP_RETURN_IF_ERROR(StartGraph());
+  }
+
+  // Packets timestamped before a channel change can still arrive after it.
+  for (const auto& [id, name] : input_names_) {
+    const Packet& packet = cc->Inputs().Get(id).Value();
+    if (packet.IsEmpty()) continue;
+    if (graph_ == nullptr) {
+      MP_RETURN_IF_ERROR(StartGraph());
+    }
+    MP_RETURN_IF_ERROR(graph_->AddPacketToInputStream(name, packet));
+  }
+  if (graph_ != nullptr) {
+    MP_RETURN_IF_ERROR(graph_->WaitUntilIdle());
+  }
+
+  if (graph_ != nullptr && channel_index_ != channel_ &&
+      close_inactive_after_ > absl::ZeroDuration() &&
+      absl::Now() - deselected_time_ >= close_inactive_after_) {
+    MP_RETURN_IF_ERROR(StopGraph());
+  }
+  SendOutputs(cc);
+  return absl::OkStatus();
+}
+
+absl::Status SwitchLazyNodeCalculator::Close(CalculatorContext* cc) {
+  if (graph_ != nullptr) {
+    MP_RETURN_IF_ERROR(StopGraph());
+  }
+  SendOutputs(cc);
+  return absl::OkStatus();
+}
+
+absl::Status SwitchLazyNodeCalculator::StartGraph() {
+  auto graph = std::make_unique<CalculatorGraph>();
+  MP_RETURN_IF_ERROR(graph->Initialize(graph_config_, side_packets_));
+  for (const auto& [name, id] : output_ids_) {
+    MP_RETURN_IF_ERROR(graph->ObserveOutputStream(
+        name,
+        [this, id = id](const Packet& packet) {
+          absl::MutexLock lock(&outputs_mutex_);
+          outputs_.push_back({id, packet});
+          return absl::OkStatus();
+        },
+        /*observe_timestamp_bounds=*/true));
+  }
+  MP_RETURN_IF_ERROR(graph->StartRun({}));
+  graph_ = std::move(graph);
+  return absl::OkStatus();
+}
+
+absl::Status SwitchLazyNodeCalculator::StopGraph() {
+  MP_RETURN_IF_ERROR(graph_->CloseAllPacketSources());
+  MP_RETURN_IF_ERROR(graph_->WaitUntilDone());
+  graph_ = nullptr;
+  return absl::OkStatus();
+}
+
+void SwitchLazyNodeCalculator::SendOutputs(CalculatorContext* cc) {
+  std::vector<std::pair<CollectionItemId, Packet>> outputs;
+  {
+    absl::MutexLock lock(&outputs_mutex_);
+    outputs.swap(outputs_);
+  }
+  for (auto& [id, packet] : outputs) {
+    OutputStreamShard& output = cc->Outputs().Get(id);
+    if (!packet.IsEmpty()) {
+      output.AddPacket(std::move(packet));
+      continue;
+    }
+    // Bounds at the end of a nested run do not end this node's outputs.
+    Timestamp bound = packet.Timestamp().NextAllowedInStream();
+    if (packet.Timestamp() < Timestamp::PostStream() &&
+        bound > output.NextTimestampBound()) {
+      output.SetNextTimestampBound(bound);
+    }
+  }
+}
+
+}  // namespace mediapipe
@@ -47,6 +47,9 @@
 #include "mediapipe/framework/thread_pool_executor.pb.h"
 #include "mediapipe/framework/tool/name_util.h"
 #include "mediapipe/framework/tool/status_util.h"
+#include "mediapipe/framework/tool/gpu_transfer_optimization.h"
+#include "mediapipe/framework/tool/pass_through_elimination.h"
+#include "mediapipe/framework/tool/shader_fusion.h"
 #include "mediapipe/framework/tool/subgraph_expansion.h"
 #include "mediapipe/framework/tool/validate.h"
 #include "mediapipe/framework/tool/validate_name.h"
@@ -388,6 +391,14 @@ absl::Status ValidatedGraphConfig::Initialize(
   // created.
   MP_RETURN_IF_ERROR(FillUpstreamFieldForBackEdges());
 
+  // Let the streams of eliminated nodes be looked up by their original names.
+  for (const auto& [alias, name] : stream_aliases_) {
+    auto iter = stream_to_producer_.find(name);
+    if (iter != stream_to_producer_.end()) {
+      stream_to_producer_.emplace(alias, iter->second);
+    }
+  }
+
   // Set Any types based on what they connect to.
   MP_RETURN_IF_ERROR(ResolveAnyTypes(&input_streams_, &output_streams_));
   MP_RETURN_IF_ERROR(ResolveOneOfTypes(&input_streams_, &output_streams_));
@@ -454,6 +465,16 @@ absl::Status ValidatedGraphConfig::PerformBasicTransforms(
     const GraphServiceManager* service_manager) {
   MP_RETURN_IF_ERROR(tool::ExpandSubgraphs(&config_, graph_registry,
                                            graph_options, service_manager));
+  if (config_.eliminate_pass_through_nodes()) {
+    MP_RETURN_IF_ERROR(
+        tool::EliminatePassThroughNodes(&config_, &stream_aliases_));
+  }
+  if (config_.optimize_gpu_transfers()) {
+    MP_RETURN_IF_ERROR(tool::OptimizeGpuTransfers(&config_, &stream_aliases_));
+  }
+  if (config_.fuse_shader_nodes()) {
+    MP_RETURN_IF_ERROR(tool::FuseShaderNodes(&config_));
+  }
 
   MP_RETURN_IF_ERROR(AddPredefinedExecutorConfigs(&config_));
 
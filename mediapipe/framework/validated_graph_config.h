@@ -434,7 +434,11 @@ class ValidatedGraphConfig {
   std::vector<NodeTypeInfo*> sorted_nodes_;
 
   // Mapping from stream name to the output_streams_ index which produces it.
+  // Includes the aliases in stream_aliases_.
   std::map<std::string, int> stream_to_producer_;
+  // Maps the output streams of eliminated pass-through nodes to the streams
+  // that carry their packets.
+  std::map<std::string, std::string> stream_aliases_;
 
   // Mapping from output streams to consumer node ids. Used for profiling.
   std::map<int, std::vector<int>> output_streams_to_consumer_nodes_;
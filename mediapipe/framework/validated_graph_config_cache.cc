@@ -0,0 +1,62 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/validated_graph_config_cache.h"
+
+#include <utility>
+
+#include "mediapipe/framework/port/status_macros.h"
+
+namespace mediapipe {
+
+absl::StatusOr<std::shared_ptr<const ValidatedGraphConfig>>
+ValidatedGraphConfigCache::GetOrCreate(
+    const CalculatorGraphConfig& input_config) {
+  // Serializing a config is much cheaper than expanding and validating it.
+  // Equal configs that serialize differently only cause cache misses.
+  std::string key = input_config.SerializeAsString();
+  {
+    absl::MutexLock lock(&mutex_);
+    auto iter = configs_.find(key);
+    if (iter != configs_.end()) {
+      return iter->second;
+    }
+  }
+
+  // The config is validated without holding the mutex, so that other configs
+  // can be looked up meanwhile. Concurrent misses for the same config may
+  // validate it more than once; the first result is kept.
+  auto validated_graph = std::make_shared<ValidatedGraphConfig>();
+  MP_RETURN_IF_ERROR(validated_graph->Initialize(input_config));
+
+  absl::MutexLock lock(&mutex_);
+  if (max_size_ > 0 && configs_.size() >= max_size_ &&
+      !configs_.contains(key)) {
+    configs_.clear();
+  }
+  return configs_.emplace(std::move(key), std::move(validated_graph))
+      .first->second;
+}
+
+int ValidatedGraphConfigCache::Size() const {
+  absl::MutexLock lock(&mutex_);
+  return configs_.size();
+}
+
+void ValidatedGraphConfigCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  configs_.clear();
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,75 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_VALIDATED_GRAPH_CONFIG_CACHE_H_
+#define MEDIAPIPE_FRAMEWORK_VALIDATED_GRAPH_CONFIG_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/validated_graph_config.h"
+
+namespace mediapipe {
+
+// Caches ValidatedGraphConfigs by the contents of their input configs, so that
+// graphs created from the same config share a single expanded and validated
+// config instead of repeating subgraph expansion and type validation.
+//
+// Configs are expanded with the global graph registry and without graph
+// services, so subgraphs that depend on a graph service should not be cached.
+//
+// Example:
+//   static ValidatedGraphConfigCache* cache = new ValidatedGraphConfigCache;
+//   ASSIGN_OR_RETURN(auto validated_graph, cache->GetOrCreate(config));
+//   CalculatorGraph graph;
+//   MP_RETURN_IF_ERROR(graph.Initialize(std::move(validated_graph)));
+//
+// This class is thread safe.
+class ValidatedGraphConfigCache {
+ public:
+  // Creates a cache that keeps up to max_size configs, and is cleared when a
+  // config is added beyond that. If max_size is zero, the number of configs is
+  // not limited.
+  explicit ValidatedGraphConfigCache(int max_size = 0) : max_size_(max_size) {}
+  ValidatedGraphConfigCache(const ValidatedGraphConfigCache&) = delete;
+  ValidatedGraphConfigCache& operator=(const ValidatedGraphConfigCache&) =
+      delete;
+
+  // Returns the cached ValidatedGraphConfig for input_config, initializing
+  // and caching it if needed. Configs that fail validation are not cached.
+  absl::StatusOr<std::shared_ptr<const ValidatedGraphConfig>> GetOrCreate(
+      const CalculatorGraphConfig& input_config) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the number of cached configs.
+  int Size() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Removes all cached configs. Configs in use remain valid.
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  const int max_size_;
+  mutable absl::Mutex mutex_;
+  // Maps serialized input configs to their validated configs.
+  absl::flat_hash_map<std::string, std::shared_ptr<const ValidatedGraphConfig>>
+      configs_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_VALIDATED_GRAPH_CONFIG_CACHE_H_
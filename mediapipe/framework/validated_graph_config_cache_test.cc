@@ -0,0 +1,130 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/validated_graph_config_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+// The number of times CountingSubgraph has been expanded.
+int num_subgraph_expansions = 0;
+
+// A subgraph that counts its expansions.
+class CountingSubgraph : public Subgraph {
+ public:
+  absl::StatusOr<CalculatorGraphConfig> GetConfig(
+      const SubgraphOptions& options) override {
+    ++num_subgraph_expansions;
+    return mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+      input_stream: "in"
+      output_stream: "out"
+      node {
+        calculator: "PassThroughCalculator"
+        input_stream: "in"
+        output_stream: "out"
+      }
+    )pb");
+  }
+};
+REGISTER_MEDIAPIPE_GRAPH(CountingSubgraph);
+
+CalculatorGraphConfig SubgraphConfig() {
+  return mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+    input_stream: "in"
+    node {
+      calculator: "CountingSubgraph"
+      input_stream: "in"
+      output_stream: "out"
+    }
+  )pb");
+}
+
+TEST(ValidatedGraphConfigCacheTest, ReusesValidatedConfigs) {
+  ValidatedGraphConfigCache cache;
+  num_subgraph_expansions = 0;
+  auto first = cache.GetOrCreate(SubgraphConfig());
+  MP_ASSERT_OK(first);
+  auto second = cache.GetOrCreate(SubgraphConfig());
+  MP_ASSERT_OK(second);
+  EXPECT_EQ(first.value().get(), second.value().get());
+  EXPECT_EQ(1, num_subgraph_expansions);
+  EXPECT_EQ(1, cache.Size());
+
+  CalculatorGraphConfig other_config = SubgraphConfig();
+  other_config.set_max_queue_size(10);
+  auto third = cache.GetOrCreate(other_config);
+  MP_ASSERT_OK(third);
+  EXPECT_NE(first.value().get(), third.value().get());
+  EXPECT_EQ(2, num_subgraph_expansions);
+  EXPECT_EQ(2, cache.Size());
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.Size());
+  // Configs in use outlive the cache entries.
+  EXPECT_EQ(1, first.value()->Config().node_size());
+}
+
+TEST(ValidatedGraphConfigCacheTest, DoesNotCacheInvalidConfigs) {
+  ValidatedGraphConfigCache cache;
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        node { calculator: "NonExistentCalculator" output_stream: "out" }
+      )pb");
+  EXPECT_FALSE(cache.GetOrCreate(config).ok());
+  EXPECT_EQ(0, cache.Size());
+}
+
+TEST(ValidatedGraphConfigCacheTest, LimitsSize) {
+  ValidatedGraphConfigCache cache(/*max_size=*/2);
+  for (int i = 1; i <= 3; ++i) {
+    CalculatorGraphConfig config = SubgraphConfig();
+    config.set_max_queue_size(i);
+    MP_ASSERT_OK(cache.GetOrCreate(config));
+  }
+  EXPECT_EQ(1, cache.Size());
+}
+
+TEST(ValidatedGraphConfigCacheTest, GraphsShareValidatedConfig) {
+  ValidatedGraphConfigCache cache;
+  auto validated_graph = cache.GetOrCreate(SubgraphConfig());
+  MP_ASSERT_OK(validated_graph);
+
+  for (int run = 0; run < 2; ++run) {
+    CalculatorGraph graph;
+    MP_ASSERT_OK(graph.Initialize(validated_graph.value()));
+    std::vector<Packet> output_packets;
+    MP_ASSERT_OK(graph.ObserveOutputStream("out", [&](const Packet& packet) {
+      output_packets.push_back(packet);
+      return absl::OkStatus();
+    }));
+    MP_ASSERT_OK(graph.StartRun({}));
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "in", MakePacket<int>(run).At(Timestamp(0))));
+    MP_ASSERT_OK(graph.CloseAllInputStreams());
+    MP_ASSERT_OK(graph.WaitUntilDone());
+    ASSERT_EQ(1, output_packets.size());
+    EXPECT_EQ(run, output_packets[0].Get<int>());
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,155 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/work_stealing_executor.h"
+
+#include <utility>
+
+#include "mediapipe/framework/port/logging.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+#include "mediapipe/framework/thread_pool_executor.pb.h"
+
+namespace mediapipe {
+
+namespace {
+
+// The executor and worker index of the current thread, if it is a worker
+// thread of a WorkStealingExecutor.
+thread_local const void* current_executor = nullptr;
+thread_local int current_worker_index = -1;
+
+}  // namespace
+
+// static
+absl::StatusOr<Executor*> WorkStealingExecutor::Create(
+    const MediaPipeOptions& extendable_options) {
+  // Reuse the option validation of ThreadPoolExecutor, which creates a
+  // WorkStealingExecutor for the work-stealing scheduling policy.
+  MediaPipeOptions options = extendable_options;
+  options.MutableExtension(ThreadPoolExecutorOptions::ext)
+      ->set_scheduling_policy(
+          ThreadPoolExecutorOptions::SCHEDULING_POLICY_WORK_STEALING);
+  return ThreadPoolExecutor::Create(options);
+}
+
+WorkStealingExecutor::WorkStealingExecutor(int num_threads)
+    : WorkStealingExecutor(ThreadOptions(), num_threads) {}
+
+WorkStealingExecutor::WorkStealingExecutor(const ThreadOptions& thread_options,
+                                           int num_threads)
+    : thread_pool_(thread_options,
+                   thread_options.name_prefix().empty()
+                       ? "mediapipe"
+                       : thread_options.name_prefix(),
+                   num_threads) {
+  for (int i = 0; i < thread_pool_.num_threads(); ++i) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  thread_pool_.StartWorkers();
+  // Each worker thread of the pool runs one worker loop for the lifetime of
+  // the executor.
+  for (int i = 0; i < thread_pool_.num_threads(); ++i) {
+    thread_pool_.Schedule([this, i] { RunWorker(i); });
+  }
+  VLOG(2) << "Started work-stealing executor with "
+          << thread_pool_.num_threads() << " threads.";
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  VLOG(2) << "Terminating work-stealing executor.";
+  absl::MutexLock lock(&idle_mutex_);
+  stopped_ = true;
+  idle_condition_.SignalAll();
+}
+
+void WorkStealingExecutor::Schedule(std::function<void()> task) {
+  int index;
+  if (current_executor == this) {
+    index = current_worker_index;
+  } else {
+    index = next_queue_.fetch_add(1, std::memory_order_relaxed) %
+            queues_.size();
+  }
+  WorkerQueue& queue = *queues_[index];
+  {
+    absl::MutexLock lock(&queue.mutex);
+    queue.tasks.push_back(std::move(task));
+    ++num_pending_tasks_;
+  }
+  WakeUpWorker();
+}
+
+void WorkStealingExecutor::WakeUpWorker() {
+  // A worker increments num_sleeping_workers_ before it checks
+  // num_pending_tasks_, and Schedule() increments num_pending_tasks_ before it
+  // checks num_sleeping_workers_, so a wake-up cannot be missed.
+  if (num_sleeping_workers_.load() > 0) {
+    absl::MutexLock lock(&idle_mutex_);
+    idle_condition_.Signal();
+  }
+}
+
+bool WorkStealingExecutor::TakeTask(int index, std::function<void()>* task) {
+  {
+    WorkerQueue& queue = *queues_[index];
+    absl::MutexLock lock(&queue.mutex);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      --num_pending_tasks_;
+      return true;
+    }
+  }
+  const int num_queues = queues_.size();
+  for (int i = 1; i < num_queues; ++i) {
+    WorkerQueue& victim = *queues_[(index + i) % num_queues];
+    absl::MutexLock lock(&victim.mutex);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      --num_pending_tasks_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingExecutor::RunWorker(int index) {
+  current_executor = this;
+  current_worker_index = index;
+  std::function<void()> task;
+  while (true) {
+    if (TakeTask(index, &task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    absl::MutexLock lock(&idle_mutex_);
+    ++num_sleeping_workers_;
+    while (num_pending_tasks_.load() == 0 && !stopped_) {
+      idle_condition_.Wait(&idle_mutex_);
+    }
+    --num_sleeping_workers_;
+    // Pending tasks are drained before the worker exits.
+    if (stopped_ && num_pending_tasks_.load() == 0) {
+      break;
+    }
+  }
+  current_executor = nullptr;
+  current_worker_index = -1;
+}
+
+REGISTER_EXECUTOR(WorkStealingExecutor);
+
+}  // namespace mediapipe
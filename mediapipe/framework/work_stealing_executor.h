@@ -0,0 +1,100 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_WORK_STEALING_EXECUTOR_H_
+#define MEDIAPIPE_FRAMEWORK_WORK_STEALING_EXECUTOR_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/deps/thread_options.h"
+#include "mediapipe/framework/executor.h"
+#include "mediapipe/framework/port/statusor.h"
+#include "mediapipe/framework/port/threadpool.h"
+
+namespace mediapipe {
+
+// A multithreaded executor in which every worker thread owns a task deque.
+//
+// A task scheduled from one of the executor's own worker threads is pushed
+// onto that thread's deque and is normally run by the same thread, which
+// keeps a node's work close to the data produced by its upstream node. Tasks
+// scheduled from other threads are distributed round robin over the deques.
+// A worker runs tasks from the front of its own deque and, when that deque is
+// empty, steals from the back of the other deques. With a single thread the
+// tasks are run in FIFO order, as with ThreadPoolExecutor.
+//
+// Since each deque has its own lock, workers only contend with each other
+// while stealing, instead of on every task as with the single shared queue
+// used by ThreadPoolExecutor.
+//
+// WorkStealingExecutor accepts the same ThreadPoolExecutorOptions as
+// ThreadPoolExecutor. It is also created by ThreadPoolExecutor::Create when
+// the scheduling_policy option is SCHEDULING_POLICY_WORK_STEALING.
+class WorkStealingExecutor : public Executor {
+ public:
+  static absl::StatusOr<Executor*> Create(
+      const MediaPipeOptions& extendable_options);
+
+  explicit WorkStealingExecutor(int num_threads);
+  WorkStealingExecutor(const ThreadOptions& thread_options, int num_threads);
+  ~WorkStealingExecutor() override;
+  void Schedule(std::function<void()> task) override;
+
+  // For testing.
+  int num_threads() const { return thread_pool_.num_threads(); }
+
+ private:
+  // A task deque owned by one worker thread.
+  struct WorkerQueue {
+    absl::Mutex mutex;
+    std::deque<std::function<void()>> tasks ABSL_GUARDED_BY(mutex);
+  };
+
+  // Runs tasks on worker thread "index" until the executor is destroyed.
+  void RunWorker(int index);
+
+  // Removes a task from the front of queue "index", or steals one from the
+  // back of another queue. Returns false if no task was found.
+  bool TakeTask(int index, std::function<void()>* task);
+
+  // Wakes up one sleeping worker thread, if there is any.
+  void WakeUpWorker();
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+  // The number of tasks that are scheduled but not yet taken by a worker.
+  std::atomic<int> num_pending_tasks_{0};
+  // The number of worker threads waiting for new tasks.
+  std::atomic<int> num_sleeping_workers_{0};
+  // Used to distribute tasks scheduled from outside the worker threads.
+  std::atomic<unsigned int> next_queue_{0};
+
+  absl::Mutex idle_mutex_;
+  absl::CondVar idle_condition_;
+  bool stopped_ ABSL_GUARDED_BY(idle_mutex_) = false;
+
+  // Hosts the worker loops. Declared last so that it is destroyed, and the
+  // worker threads are joined, before the queues are destroyed.
+  mediapipe::ThreadPool thread_pool_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_WORK_STEALING_EXECUTOR_H_
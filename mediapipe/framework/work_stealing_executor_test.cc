@@ -0,0 +1,145 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/work_stealing_executor.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/thread_pool_executor.h"
+#include "mediapipe/framework/thread_pool_executor.pb.h"
+#include "mediapipe/framework/tool/sink.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(WorkStealingExecutorTest, SingleThreadRunsTasksInOrder) {
+  absl::Mutex mu;
+  std::vector<int> order;
+  {
+    WorkStealingExecutor executor(1);
+    ASSERT_EQ(1, executor.num_threads());
+    for (int i = 0; i < 100; ++i) {
+      executor.Schedule([&order, &mu, i] {
+        absl::MutexLock l(&mu);
+        order.push_back(i);
+      });
+    }
+  }
+  ASSERT_EQ(100, order.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, order[i]);
+  }
+}
+
+TEST(WorkStealingExecutorTest, MultiThreadsRunAllTasks) {
+  absl::Mutex mu;
+  int n = 1000;
+  {
+    WorkStealingExecutor executor(8);
+    ASSERT_EQ(8, executor.num_threads());
+    for (int i = 0; i < 1000; ++i) {
+      executor.Schedule([&n, &mu] {
+        absl::MutexLock l(&mu);
+        --n;
+      });
+    }
+  }
+  EXPECT_EQ(0, n);
+}
+
+TEST(WorkStealingExecutorTest, RunsTasksScheduledFromWorkerThreads) {
+  absl::Mutex mu;
+  int n = 0;
+  {
+    WorkStealingExecutor executor(4);
+    for (int i = 0; i < 10; ++i) {
+      executor.Schedule([&executor, &n, &mu] {
+        for (int j = 0; j < 100; ++j) {
+          executor.Schedule([&n, &mu] {
+            absl::MutexLock l(&mu);
+            ++n;
+          });
+        }
+      });
+    }
+  }
+  EXPECT_EQ(1000, n);
+}
+
+TEST(WorkStealingExecutorTest, CreatedFromThreadPoolExecutorOptions) {
+  MediaPipeOptions extendable_options;
+  ThreadPoolExecutorOptions* options =
+      extendable_options.MutableExtension(ThreadPoolExecutorOptions::ext);
+  options->set_num_threads(3);
+  options->set_scheduling_policy(
+      ThreadPoolExecutorOptions::SCHEDULING_POLICY_WORK_STEALING);
+  MP_ASSERT_OK_AND_ASSIGN(Executor * executor,
+                          ThreadPoolExecutor::Create(extendable_options));
+  std::unique_ptr<Executor> owned_executor(executor);
+  auto* work_stealing_executor = dynamic_cast<WorkStealingExecutor*>(executor);
+  ASSERT_NE(work_stealing_executor, nullptr);
+  EXPECT_EQ(3, work_stealing_executor->num_threads());
+}
+
+TEST(WorkStealingExecutorTest, RunsGraphAsDefaultExecutor) {
+  CalculatorGraphConfig config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        executor {
+          options {
+            [mediapipe.ThreadPoolExecutorOptions.ext] {
+              num_threads: 4
+              scheduling_policy: SCHEDULING_POLICY_WORK_STEALING
+            }
+          }
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "mid"
+        }
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "mid"
+          output_stream: "out"
+        }
+      )pb");
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("out", &config, &output_packets);
+
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  for (int i = 0; i < 100; ++i) {
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "in", MakePacket<int>(i).At(Timestamp(i))));
+  }
+  MP_ASSERT_OK(graph.CloseAllInputStreams());
+  MP_ASSERT_OK(graph.WaitUntilDone());
+
+  ASSERT_EQ(100, output_packets.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, output_packets[i].Get<int>());
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,82 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/gpu/cv_pixel_buffer_pool_registry.h"
+
+#include <memory>
+#include <vector>
+
+#include "CoreFoundation/CFBase.h"
+#include "mediapipe/framework/deps/no_destructor.h"
+#include "mediapipe/objc/CFHolder.h"
+#include "mediapipe/objc/util.h"
+
+#if TARGET_OS_IPHONE
+#include <Foundation/Foundation.h>
+#endif  // TARGET_OS_IPHONE
+
+namespace mediapipe {
+
+CvPixelBufferPoolRegistry& CvPixelBufferPoolRegistry::GetInstance() {
+  static NoDestructor<CvPixelBufferPoolRegistry> registry;
+  return *registry;
+}
+
+CvPixelBufferPoolRegistry::CvPixelBufferPoolRegistry()
+    : texture_caches_(std::make_shared<CvTextureCacheManager>()) {
+#if TARGET_OS_IPHONE
+  // The notification is named by its string, so that this does not need to
+  // link UIKit.
+  [[NSNotificationCenter defaultCenter]
+      addObserverForName:@"UIApplicationDidReceiveMemoryWarningNotification"
+                  object:nil
+                   queue:nil
+              usingBlock:^(NSNotification* note) {
+                Flush();
+              }];
+#endif  // TARGET_OS_IPHONE
+}
+
+std::shared_ptr<CvPixelBufferPoolWrapper> CvPixelBufferPoolRegistry::GetPool(
+    const internal::GpuBufferSpec& spec, const MultiPoolOptions& options) {
+  absl::MutexLock lock(&mutex_);
+  std::shared_ptr<CvPixelBufferPoolWrapper>& pool = pools_[spec];
+  if (!pool) {
+    pool =
+        CvPixelBufferPoolWrapper::Create(spec, options, texture_caches_.get());
+  }
+  return pool;
+}
+
+void CvPixelBufferPoolRegistry::Prewarm(const internal::GpuBufferSpec& spec,
+                                        int count,
+                                        const MultiPoolOptions& options) {
+  std::shared_ptr<CvPixelBufferPoolWrapper> pool = GetPool(spec, options);
+  std::vector<CFHolder<CVPixelBufferRef>> buffers;
+  buffers.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    buffers.push_back(pool->GetBuffer());
+  }
+}
+
+void CvPixelBufferPoolRegistry::Flush() {
+  texture_caches_->FlushTextureCaches();
+  absl::MutexLock lock(&mutex_);
+  for (auto& [spec, pool] : pools_) {
+    pool->Flush(kCVPixelBufferPoolFlushExcessBuffers);
+  }
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,79 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_GPU_CV_PIXEL_BUFFER_POOL_REGISTRY_H_
+#define MEDIAPIPE_GPU_CV_PIXEL_BUFFER_POOL_REGISTRY_H_
+
+#include <memory>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/gpu/cv_pixel_buffer_pool_wrapper.h"
+#include "mediapipe/gpu/cv_texture_cache_manager.h"
+#include "mediapipe/gpu/gpu_buffer_format.h"
+#include "mediapipe/gpu/multi_pool.h"
+
+namespace mediapipe {
+
+// Shares CVPixelBuffer pools among all graphs in the process, so that graphs
+// working on frames of the same size and format reuse the same IOSurfaces
+// instead of each keeping their own. GpuResources takes its pools from here.
+//
+// Pools are keyed by GpuBufferSpec and kept for the life of the process; an
+// idle pool holds no buffers once they age past max_inactive_buffer_age. The
+// options of the first request for a spec apply to its pool.
+class CvPixelBufferPoolRegistry {
+ public:
+  // Returns the process-wide registry.
+  static CvPixelBufferPoolRegistry& GetInstance();
+
+  CvPixelBufferPoolRegistry(const CvPixelBufferPoolRegistry&) = delete;
+  CvPixelBufferPoolRegistry& operator=(const CvPixelBufferPoolRegistry&) =
+      delete;
+
+  // The texture caches to flush when a pool runs out of reusable buffers,
+  // since they may hold buffers from any graph. GpuResources registers the
+  // texture caches of its GL contexts here.
+  const std::shared_ptr<CvTextureCacheManager>& texture_caches() const {
+    return texture_caches_;
+  }
+
+  // Returns the pool for `spec`, creating it with `options` if needed.
+  std::shared_ptr<CvPixelBufferPoolWrapper> GetPool(
+      const internal::GpuBufferSpec& spec,
+      const MultiPoolOptions& options = kDefaultMultiPoolOptions);
+
+  // Allocates `count` buffers in the pool for `spec` and returns them to it,
+  // so that the first frames of a graph do not wait for IOSurface allocation.
+  void Prewarm(const internal::GpuBufferSpec& spec, int count,
+               const MultiPoolOptions& options = kDefaultMultiPoolOptions);
+
+  // Releases the idle buffers of all pools after flushing the texture caches.
+  // On iOS, this is called on every memory warning.
+  void Flush();
+
+ private:
+  CvPixelBufferPoolRegistry();
+
+  const std::shared_ptr<CvTextureCacheManager> texture_caches_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<internal::GpuBufferSpec,
+                      std::shared_ptr<CvPixelBufferPoolWrapper>>
+      pools_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_GPU_CV_PIXEL_BUFFER_POOL_REGISTRY_H_
@@ -69,7 +69,9 @@ std::string CvPixelBufferPoolWrapper::GetDebugString() const {
   return [(__bridge NSString*)*description UTF8String];
 }
 
-void CvPixelBufferPoolWrapper::Flush() { CVPixelBufferPoolFlush(*pool_, 0); }
+void CvPixelBufferPoolWrapper::Flush(CVPixelBufferPoolFlushFlags flags) {
+  CVPixelBufferPoolFlush(*pool_, flags);
+}
 
 CFHolder<CVPixelBufferRef> CvPixelBufferPoolWrapper::CreateBufferWithoutPool(
     const internal::GpuBufferSpec& spec) {
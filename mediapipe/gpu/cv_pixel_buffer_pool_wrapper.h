@@ -50,7 +50,9 @@ class CvPixelBufferPoolWrapper {
   int GetBufferCount() const { return count_; }
   std::string GetDebugString() const;
 
-  void Flush();
+  // Releases the idle buffers older than the maximum age, or all idle
+  // buffers with kCVPixelBufferPoolFlushExcessBuffers.
+  void Flush(CVPixelBufferPoolFlushFlags flags = 0);
 
   static CFHolder<CVPixelBufferRef> CreateBufferWithoutPool(
       const internal::GpuBufferSpec& spec);
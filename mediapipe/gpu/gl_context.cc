@@ -27,10 +27,14 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/framework/port/status.h"
 #include "mediapipe/framework/port/status_builder.h"
+#include "mediapipe/framework/profiler/storage_conversion_observer.h"
 #include "mediapipe/gpu/gl_context_internal.h"
+#include "mediapipe/gpu/gl_timer_query.h"
 #include "mediapipe/gpu/gpu_buffer_format.h"
 
 #ifndef __EMSCRIPTEN__
@@ -443,7 +447,10 @@ absl::Status GlContext::Run(GlStatusFunction gl_func, int node_id,
   }
   if (thread_) {
     bool had_gl_errors = false;
-    status = thread_->Run([this, gl_func, &had_gl_errors] {
+    // Conversions on the GL thread are attributed to the calling calculator.
+    StorageConversionObserver* observer = StorageConversionObserver::Current();
+    status = thread_->Run([this, gl_func, observer, &had_gl_errors] {
+      StorageConversionObserver::Scope observer_scope(observer);
       auto status = gl_func();
       had_gl_errors = CheckForGlErrors();
       return status;
@@ -555,6 +562,11 @@ std::shared_ptr<GlContext> GlContext::GetCurrent() {
   return CurrentContext().lock();
 }
 
+void GlContext::StallPipeline() {
+  glFinish();
+  ++pipeline_stall_count_;
+}
+
 void GlContext::GlFinishCalled() {
   absl::MutexLock lock(&mutex_);
   ++gl_finish_count_;
@@ -580,6 +592,54 @@ class GlFinishSyncPoint : public GlSyncPoint {
   int64_t gl_finish_count_ = -1;
 };
 
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+// Emulates a fence with a timestamp query, for contexts without fence syncs.
+// The query result becomes available once the GPU has executed all commands
+// issued before it, so waiting on it does not drain the pipeline like
+// glFinish does.
+class GlQueryFenceSyncPoint : public GlSyncPoint {
+ public:
+  // Must be called on the context.
+  explicit GlQueryFenceSyncPoint(const std::shared_ptr<GlContext>& gl_context)
+      : GlSyncPoint(gl_context), functions_(GetGlTimerQueryFunctions()) {
+    functions_->glGenQueriesEXT(1, &query_);
+    functions_->glQueryCounterEXT(query_, GL_TIMESTAMP_EXT);
+    glFlush();
+  }
+
+  ~GlQueryFenceSyncPoint() override {
+    if (!query_) return;
+    gl_context_->RunWithoutWaiting(
+        [functions = functions_, query = query_]() mutable {
+          functions->glDeleteQueriesEXT(1, &query);
+        });
+  }
+
+  void Wait() override {
+    // There is no blocking wait on a query, so poll it.
+    while (!IsReady()) {
+      absl::SleepFor(absl::Microseconds(100));
+    }
+  }
+
+  bool IsReady() override {
+    if (ready_) return true;
+    GLuint available = GL_FALSE;
+    gl_context_->Run([this, &available] {
+      functions_->glGetQueryObjectuivEXT(query_, GL_QUERY_RESULT_AVAILABLE_EXT,
+                                         &available);
+    });
+    ready_ = available == GL_TRUE;
+    return ready_;
+  }
+
+ private:
+  const GlTimerQueryFunctions* functions_;
+  GLuint query_ = 0;
+  std::atomic<bool> ready_ = false;
+};
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+
 // Just handles a GLsync. No context management.
 class GlSyncWrapper {
  public:
@@ -823,6 +883,15 @@ bool GlContext::ShouldUseFenceSync() const {
 #endif  // __EMSCRIPTEN__
 }
 
+bool GlContext::ShouldUseQueryFenceSync() const {
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+  return HasGlExtension("GL_EXT_disjoint_timer_query") &&
+         GetGlTimerQueryFunctions() != nullptr;
+#else
+  return false;
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+}
+
 std::shared_ptr<GlSyncPoint> GlContext::CreateSyncToken() {
   std::shared_ptr<GlSyncPoint> token;
 #if MEDIAPIPE_DISABLE_GL_SYNC_FOR_DEBUG
@@ -830,6 +899,10 @@ std::shared_ptr<GlSyncPoint> GlContext::CreateSyncToken() {
 #else
   if (ShouldUseFenceSync()) {
     token.reset(new GlFenceSyncPoint(shared_from_this()));
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+  } else if (avoid_gl_finish_ && ShouldUseQueryFenceSync()) {
+    token.reset(new GlQueryFenceSyncPoint(shared_from_this()));
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
   } else {
     token.reset(new GlFinishSyncPoint(shared_from_this()));
   }
@@ -856,7 +929,12 @@ GlContext::CreateSyncTokenForCurrentExternalContext(
     return std::shared_ptr<GlSyncPoint>(
         new GlExternalFenceSyncPoint(delegate_graph_context));
   } else {
-    glFinish();
+    if (delegate_graph_context->avoid_gl_finish_) {
+      ABSL_LOG_FIRST_N(WARNING, 1)
+          << "No fence sync available; syncing with an external context "
+             "calls glFinish.";
+    }
+    delegate_graph_context->StallPipeline();
     return nullptr;
   }
 }
@@ -903,7 +981,7 @@ void GlContext::WaitForGlFinishCountPast(int64_t count_to_pass) {
     // is used for documentation and sanity-checking purposes.
     ABSL_DCHECK(gl_finish_count_ >= count_to_pass);
     if (gl_finish_count_ == count_to_pass) {
-      glFinish();
+      StallPipeline();
       GlFinishCalled();
     }
   };
@@ -945,7 +1023,7 @@ void GlContext::WaitForGlFinishCountPast(int64_t count_to_pass) {
         // time.
         mutex_.Unlock();
         {
-          glFinish();
+          other->StallPipeline();
           other->GlFinishCalled();
         }
         mutex_.Lock();
@@ -71,6 +71,7 @@ typedef std::function<void()> GlVoidFunction;
 typedef std::function<absl::Status()> GlStatusFunction;
 
 class GlContext;
+class GlProgramBinaryCache;
 
 // Generic interface for synchronizing access to a shared resource from a
 // different context. This is an abstract class to keep users from
@@ -182,6 +183,17 @@ class GlContext : public std::enable_shared_from_this<GlContext> {
   void SetProfilingContext(
       std::shared_ptr<mediapipe::ProfilingContext> profiling_context);
 
+  // Sets the cache used by GlhCreateProgram for programs created in this
+  // context. Must be called before the context is used to create programs.
+  void SetProgramBinaryCache(std::shared_ptr<GlProgramBinaryCache> cache) {
+    program_binary_cache_ = std::move(cache);
+  }
+
+  // Returns the program binary cache, or nullptr if there is none.
+  GlProgramBinaryCache* program_binary_cache() const {
+    return program_binary_cache_.get();
+  }
+
   // Executes a function in the GL context. Waits for the
   // function's execution to be complete before returning to the caller.
   absl::Status Run(GlStatusFunction gl_func, int node_id = -1,
@@ -257,6 +269,17 @@ class GlContext : public std::enable_shared_from_this<GlContext> {
 
   int64_t gl_finish_count() { return gl_finish_count_; }
 
+  // If true, sync tokens of this context do not call glFinish when the context
+  // lacks fence syncs (e.g. OpenGL ES 2 or WebGL 1). They poll a timestamp
+  // query from EXT_disjoint_timer_query instead, which keeps the GL pipeline
+  // running while a consumer waits. Without the extension, glFinish is still
+  // used.
+  void SetAvoidGlFinish(bool avoid) { avoid_gl_finish_ = avoid; }
+
+  // Returns the number of glFinish calls that the framework made to
+  // synchronize with this context. Each one drains the whole GL pipeline.
+  int64_t pipeline_stall_count() const { return pipeline_stall_count_; }
+
   // Used by GlFinishSyncPoint. The count_to_pass cannot exceed the current
   // gl_finish_count_ (but it can be equal).
   void WaitForGlFinishCountPast(int64_t count_to_pass);
@@ -334,6 +357,13 @@ class GlContext : public std::enable_shared_from_this<GlContext> {
 
   bool ShouldUseFenceSync() const;
 
+  // Returns whether sync tokens can use timestamp queries instead of glFinish.
+  bool ShouldUseQueryFenceSync() const;
+
+  // Calls glFinish and counts it as a pipeline stall. Must be called on this
+  // context.
+  void StallPipeline();
+
 #if defined(__EMSCRIPTEN__)
   absl::Status CreateContext(EMSCRIPTEN_WEBGL_CONTEXT_HANDLE share_context);
   absl::Status CreateContextInternal(
@@ -458,6 +488,9 @@ class GlContext : public std::enable_shared_from_this<GlContext> {
   std::atomic<int64_t> gl_finish_count_ = 0;
   std::atomic<int64_t> gl_finish_count_target_ = 0;
 
+  std::atomic<bool> avoid_gl_finish_ = false;
+  std::atomic<int64_t> pipeline_stall_count_ = 0;
+
   GlContext* context_waiting_on_ ABSL_GUARDED_BY(mutex_) = nullptr;
 
   // This mutex is held by a thread while this GL context is current on that
@@ -472,6 +505,8 @@ class GlContext : public std::enable_shared_from_this<GlContext> {
 
   std::unique_ptr<mediapipe::GlProfilingHelper> profiling_helper_ = nullptr;
 
+  std::shared_ptr<GlProgramBinaryCache> program_binary_cache_;
+
   bool destructing_ = false;
 };
 
@@ -0,0 +1,95 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/tool/shader_fusion.h"
+#include "mediapipe/framework/tool/shader_fusion.pb.h"
+#include "mediapipe/gpu/gl_quad_renderer.h"
+#include "mediapipe/gpu/gl_simple_calculator.h"
+#include "mediapipe/gpu/gl_simple_shaders.h"
+
+namespace mediapipe {
+
+// Runs the fragment shader snippets of a chain of calculators in a single
+// pass. Nodes of this calculator are created by tool::FuseShaderNodes when the
+// graph config sets fuse_shader_nodes; see tool/shader_fusion.h.
+// See GlSimpleCalculator for inputs and outputs.
+class GlFusedShaderCalculator : public GlSimpleCalculator {
+ public:
+  absl::Status Open(CalculatorContext* cc) override;
+  absl::Status GlSetup() override;
+  absl::Status GlRender(const GlTexture& src, const GlTexture& dst) override;
+  absl::Status GlTeardown() override;
+
+ private:
+  // The fragment shader applying the snippets in order.
+  std::string frag_src_;
+  QuadRenderer renderer_;
+};
+REGISTER_CALCULATOR(GlFusedShaderCalculator);
+
+absl::Status GlFusedShaderCalculator::Open(CalculatorContext* cc) {
+  const auto& options = cc->Options<FusedShaderCalculatorOptions>();
+  RET_CHECK_GT(options.calculator_size(), 0);
+  frag_src_ = absl::StrCat(kMediaPipeFragmentShaderPreamble, R"(
+DEFAULT_PRECISION(highp, float)
+
+in highp vec2 sample_coordinate;
+uniform sampler2D video_frame;
+)");
+  std::string main_body;
+  for (int i = 0; i < options.calculator_size(); ++i) {
+    const std::string* snippet =
+        tool::FindFusableShader(options.calculator(i));
+    RET_CHECK(snippet) << "No fragment shader snippet is registered for "
+                       << options.calculator(i);
+    absl::StrAppend(&frag_src_, "\nvec4 fused_", i, "(vec4 color) {\n",
+                    *snippet, "\n}\n");
+    absl::StrAppend(&main_body, "  color = fused_", i, "(color);\n");
+  }
+  absl::StrAppend(&frag_src_, R"(
+void main() {
+  vec4 color = texture2D(video_frame, sample_coordinate);
+)",
+                  main_body, R"(  gl_FragColor = color;
+}
+)");
+  return GlSimpleCalculator::Open(cc);
+}
+
+absl::Status GlFusedShaderCalculator::GlSetup() {
+  return renderer_.GlSetup(frag_src_.c_str(), {"video_frame"});
+}
+
+absl::Status GlFusedShaderCalculator::GlRender(const GlTexture& src,
+                                               const GlTexture& dst) {
+  return renderer_.GlRender(src.width(), src.height(), dst.width(),
+                            dst.height(), FrameScaleMode::kStretch,
+                            FrameRotation::kNone, /*flip_horizontal=*/false,
+                            /*flip_vertical=*/false, /*flip_texture=*/false);
+}
+
+absl::Status GlFusedShaderCalculator::GlTeardown() {
+  renderer_.GlTeardown();
+  return absl::OkStatus();
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,197 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/gpu/gl_program_binary_cache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/logging.h"
+
+// WebGL has no program binaries, and neither has legacy desktop OpenGL.
+#if !defined(__EMSCRIPTEN__) && defined(GL_PROGRAM_BINARY_LENGTH)
+#define MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE 1
+#else
+#define MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE 0
+#endif
+
+namespace mediapipe {
+
+namespace {
+
+// Identifies the format of the cache files; change it when the format changes.
+constexpr absl::string_view kFileMagic = "MPGLPROG1";
+
+// Returns a hash of `data` that is stable across runs and builds, unlike
+// absl::Hash, so it can name the cache files.
+uint64_t Fnv1aHash(absl::string_view data) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+void AppendUint32(uint32_t value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Reads a uint32 from the front of `in`, and removes it.
+bool ConsumeUint32(absl::string_view* in, uint32_t* value) {
+  if (in->size() < sizeof(*value)) return false;
+  std::memcpy(value, in->data(), sizeof(*value));
+  in->remove_prefix(sizeof(*value));
+  return true;
+}
+
+const char* GlString(GLenum name) {
+  const GLubyte* value = glGetString(name);
+  return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+}  // namespace
+
+GlProgramBinaryCache::GlProgramBinaryCache(std::string directory)
+    : directory_(std::move(directory)) {
+  absl::Status status = file::RecursivelyCreateDir(directory_);
+  if (!status.ok()) {
+    ABSL_LOG(WARNING) << "Cannot create GL program cache directory "
+                      << directory_ << ": " << status;
+  }
+}
+
+bool GlProgramBinaryCache::IsSupported() {
+#if MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE
+  if (!SymbolAvailable(&glProgramBinary) ||
+      !SymbolAvailable(&glGetProgramBinary)) {
+    return false;
+  }
+  GLint format_count = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+  // Clear the error left by drivers which do not know the query.
+  while (glGetError() != GL_NO_ERROR) {
+  }
+  return format_count > 0;
+#else
+  return false;
+#endif  // MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE
+}
+
+std::string GlProgramBinaryCache::ProgramKey(
+    const GLchar* vert_src, const GLchar* frag_src, GLsizei attr_count,
+    const GLchar* const* attr_names, const GLint* attr_locations) const {
+  std::string key =
+      absl::StrCat(GlString(GL_VENDOR), "\n", GlString(GL_RENDERER), "\n",
+                   GlString(GL_VERSION), "\n", vert_src, "\n", frag_src);
+  for (int i = 0; i < attr_count; ++i) {
+    absl::StrAppend(&key, "\n", attr_locations[i], " ", attr_names[i]);
+  }
+  return key;
+}
+
+std::string GlProgramBinaryCache::PathForKey(const std::string& key) const {
+  return file::JoinPath(directory_,
+                        absl::StrFormat("%016x.glprog", Fnv1aHash(key)));
+}
+
+bool GlProgramBinaryCache::LoadProgram(const std::string& key,
+                                       GLuint program) const {
+#if MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE
+  // Lets the driver keep the binary if the program is linked after a miss.
+  glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+  const std::string path = PathForKey(key);
+  std::string contents;
+  if (!file::GetContents(path, &contents).ok()) return false;
+
+  // The file holds the magic, the key, the binary format and the binary.
+  absl::string_view in = contents;
+  uint32_t key_size;
+  uint32_t format;
+  if (!absl::ConsumePrefix(&in, kFileMagic) || !ConsumeUint32(&in, &key_size) ||
+      in.size() < key_size || in.substr(0, key_size) != key) {
+    // An older format, or a hash collision.
+    return false;
+  }
+  in.remove_prefix(key_size);
+  if (!ConsumeUint32(&in, &format)) return false;
+
+  glProgramBinary(program, format, in.data(),
+                  static_cast<GLsizei>(in.size()));
+  GLint status = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    // The driver may reject binaries it wrote, e.g. after an update which
+    // kept its version string. Drop the file so that it is written again.
+    VLOG(1) << "GL driver rejected the program binary in " << path;
+    std::remove(path.c_str());
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif  // MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE
+}
+
+void GlProgramBinaryCache::StoreProgram(const std::string& key,
+                                        GLuint program) const {
+#if MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  std::string contents(kFileMagic);
+  AppendUint32(key.size(), &contents);
+  contents.append(key);
+  const size_t format_offset = contents.size();
+  AppendUint32(0, &contents);
+  const size_t binary_offset = contents.size();
+  contents.resize(binary_offset + length);
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &length, &format,
+                     &contents[binary_offset]);
+  if (length <= 0) return;
+  contents.resize(binary_offset + length);
+  const uint32_t format_value = format;
+  std::memcpy(&contents[format_offset], &format_value, sizeof(format_value));
+
+  // Write to a temporary file first, so that concurrent processes never read
+  // a partial file.
+  const std::string path = PathForKey(key);
+  const std::string temp_path = absl::StrCat(path, ".tmp");
+  absl::Status status = file::SetContents(temp_path, contents);
+  if (status.ok() && std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    status = absl::UnknownError(absl::StrCat("Cannot rename ", temp_path));
+  }
+  if (!status.ok()) {
+    ABSL_LOG(WARNING) << "Cannot store GL program binary: " << status;
+  }
+#endif  // MEDIAPIPE_GL_PROGRAM_BINARY_AVAILABLE
+}
+
+}  // namespace mediapipe
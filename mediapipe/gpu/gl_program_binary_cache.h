@@ -0,0 +1,65 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_GPU_GL_PROGRAM_BINARY_CACHE_H_
+#define MEDIAPIPE_GPU_GL_PROGRAM_BINARY_CACHE_H_
+
+#include <string>
+
+#include "mediapipe/gpu/gl_base.h"
+
+namespace mediapipe {
+
+// Stores linked GL programs on disk with glGetProgramBinary, so that later
+// runs can load them with glProgramBinary instead of compiling their shaders.
+// Programs are keyed by their shader sources, their attribute bindings, and
+// the GL driver, so that a driver update invalidates the stored programs.
+//
+// Program binaries require OpenGL ES 3.0 or OpenGL 4.1. Where they are not
+// supported, loads fail and stores do nothing.
+//
+// Enable it for a graph with GpuResources::EnableProgramBinaryCache; then
+// GlhCreateProgram uses it for every program it creates.
+class GlProgramBinaryCache {
+ public:
+  // Stores programs in files in `directory`, which is created if needed.
+  explicit GlProgramBinaryCache(std::string directory);
+
+  // Returns the key of the program with the given shaders and attributes.
+  // Must be called with a GL context current.
+  std::string ProgramKey(const GLchar* vert_src, const GLchar* frag_src,
+                         GLsizei attr_count, const GLchar* const* attr_names,
+                         const GLint* attr_locations) const;
+
+  // Loads the binary stored for `key` into `program`. Returns false if there
+  // is none, or if the driver rejects it; `program` can then be linked from
+  // its shaders as usual, and passed to StoreProgram.
+  bool LoadProgram(const std::string& key, GLuint program) const;
+
+  // Stores the binary of the linked `program` for `key`.
+  void StoreProgram(const std::string& key, GLuint program) const;
+
+  // Returns whether the current GL context supports program binaries.
+  static bool IsSupported();
+
+ private:
+  std::string PathForKey(const std::string& key) const;
+
+  const std::string directory_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_GPU_GL_PROGRAM_BINARY_CACHE_H_
@@ -18,6 +18,7 @@
 #include "absl/log/absl_log.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/gpu/gl_context.h"
+#include "mediapipe/gpu/gl_texture_readback.h"
 #include "mediapipe/gpu/gl_texture_view.h"
 #include "mediapipe/gpu/gpu_buffer_storage_image_frame.h"
 
@@ -340,43 +341,28 @@ void GlTextureBuffer::ViewDoneWriting(const GlTextureView& view) {
 #endif  // __ANDROID__
 }
 
-static void ReadTexture(GlContext& ctx, const GlTextureView& view,
-                        GpuBufferFormat format, void* output, size_t size) {
-  // TODO: check buffer size? We could use glReadnPixels where available
-  // (OpenGL ES 3.2, i.e. nowhere). Note that, to fully check that the read
-  // won't overflow the buffer with glReadPixels, we'd also need to check or
-  // reset several glPixelStore parameters (e.g. what if someone had the
-  // ill-advised idea of setting GL_PACK_SKIP_PIXELS?).
-  ABSL_CHECK(view.gl_context());
-  GlTextureInfo info = GlTextureInfoForGpuBufferFormat(
-      format, view.plane(), view.gl_context()->GetGlVersion());
-
-  GLuint fbo = kUtilityFramebuffer.Get(ctx);
-  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, view.target(),
-                         view.name(), 0);
-  glReadPixels(0, 0, view.width(), view.height(), info.gl_format, info.gl_type,
-               output);
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0,
-                         0);
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
 static std::shared_ptr<GpuBufferStorageImageFrame> ConvertToImageFrame(
     std::shared_ptr<GlTextureBuffer> buf) {
   ImageFormat::Format image_format =
       ImageFormatForGpuBufferFormat(buf->format());
   auto output =
-      absl::make_unique<ImageFrame>(image_format, buf->width(), buf->height(),
-                                    ImageFrame::kGlDefaultAlignmentBoundary);
+      std::make_shared<ImageFrame>(image_format, buf->width(), buf->height(),
+                                   ImageFrame::kGlDefaultAlignmentBoundary);
   auto ctx = GlContext::GetCurrent();
   if (!ctx) ctx = buf->GetProducerContext();
-  ctx->Run([buf, &output, &ctx] {
+  // Only starts the readback here. The pixels are copied to the ImageFrame
+  // when it is first accessed, which lets the transfer overlap other GPU work.
+  std::shared_ptr<GlTextureReadback> readback;
+  ctx->Run([buf, &output, &ctx, &readback] {
     auto view = buf->GetReadView(internal::types<GlTextureView>{}, /*plane=*/0);
-    ReadTexture(*ctx, view, buf->format(), output->MutablePixelData(),
-                output->PixelDataSize());
+    const GlTextureInfo info = GlTextureInfoForGpuBufferFormat(
+        buf->format(), view.plane(), ctx->GetGlVersion());
+    readback = std::make_shared<GlTextureReadback>(
+        ctx, view.target(), view.name(), view.width(), view.height(), info,
+        output->MutablePixelData(), output->PixelDataSize());
   });
-  return std::make_shared<GpuBufferStorageImageFrame>(std::move(output));
+  return std::make_shared<GpuBufferStorageImageFrame>(
+      std::move(output), [readback](ImageFrame&) { readback->Finish(); });
 }
 
 static std::shared_ptr<GlTextureBuffer> ConvertFromImageFrame(
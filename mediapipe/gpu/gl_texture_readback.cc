@@ -0,0 +1,108 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/gpu/gl_texture_readback.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "absl/log/absl_check.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace mediapipe {
+
+namespace {
+
+// The interval between checks of the transfer fence off the GL context.
+constexpr absl::Duration kPollInterval = absl::Microseconds(200);
+
+bool SupportsPixelPackBuffer(const GlContext& gl_context) {
+#if defined(__EMSCRIPTEN__)
+  // WebGL cannot map buffers into CPU memory.
+  return false;
+#else
+  return gl_context.GetGlVersion() != GlVersion::kGLES2;
+#endif  // defined(__EMSCRIPTEN__)
+}
+
+}  // namespace
+
+GlTextureReadback::GlTextureReadback(std::shared_ptr<GlContext> gl_context,
+                                     GLenum target, GLuint name, int width,
+                                     int height, const GlTextureInfo& info,
+                                     void* output, size_t size)
+    : gl_context_(std::move(gl_context)), output_(output), size_(size) {
+  ABSL_CHECK(gl_context_->IsCurrent());
+  const bool use_buffer = SupportsPixelPackBuffer(*gl_context_);
+  GLuint fbo = kUtilityFramebuffer.Get(*gl_context_);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target, name,
+                         0);
+#if !defined(__EMSCRIPTEN__)
+  if (use_buffer) {
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer_);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size_, nullptr, GL_STREAM_READ);
+    // With a bound pixel pack buffer, the last argument is an offset into it.
+    glReadPixels(0, 0, width, height, info.gl_format, info.gl_type, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+#endif  // !defined(__EMSCRIPTEN__)
+  if (!use_buffer) {
+    glReadPixels(0, 0, width, height, info.gl_format, info.gl_type, output_);
+  }
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0,
+                         0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (buffer_) {
+    // Marks the end of the transfer, and flushes it to the GPU.
+    sync_ = gl_context_->CreateSyncToken();
+  }
+}
+
+GlTextureReadback::~GlTextureReadback() {
+  if (buffer_) {
+    gl_context_->RunWithoutWaiting(
+        [buffer = buffer_] { glDeleteBuffers(1, &buffer); });
+  }
+}
+
+void GlTextureReadback::Finish() {
+  if (!sync_) return;
+  if (!gl_context_->IsCurrent()) {
+    // Polls rather than waits on the fence, which would block the GL context
+    // until the transfer completes.
+    while (!sync_->IsReady()) {
+      absl::SleepFor(kPollInterval);
+    }
+  }
+  gl_context_->Run([this] {
+    sync_->Wait();
+#if !defined(__EMSCRIPTEN__)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer_);
+    const void* pixels =
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size_, GL_MAP_READ_BIT);
+    ABSL_CHECK(pixels) << "glMapBufferRange failed: " << glGetError();
+    std::memcpy(output_, pixels, size_);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif  // !defined(__EMSCRIPTEN__)
+  });
+  sync_ = nullptr;
+}
+
+}  // namespace mediapipe
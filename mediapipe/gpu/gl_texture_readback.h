@@ -0,0 +1,69 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_GPU_GL_TEXTURE_READBACK_H_
+#define MEDIAPIPE_GPU_GL_TEXTURE_READBACK_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "mediapipe/gpu/gl_base.h"
+#include "mediapipe/gpu/gl_context.h"
+#include "mediapipe/gpu/gpu_buffer_format.h"
+
+namespace mediapipe {
+
+// Reads the pixels of a texture back to CPU memory. Where pixel pack buffers
+// (PBOs) are available, the transfer is only started on the GL context, and
+// the pixels are copied out once the GPU has completed it, so that the GL
+// context is not stalled until its pipeline drains. Otherwise, the pixels are
+// read synchronously.
+//
+//   // On the GL context:
+//   auto readback = std::make_unique<GlTextureReadback>(
+//       gl_context, texture.target(), texture.name(), width, height, info,
+//       frame->MutablePixelData(), frame->PixelDataSize());
+//   // Later, on any thread:
+//   readback->Finish();  // The frame now holds the pixels.
+class GlTextureReadback {
+ public:
+  // Starts reading the texture into `output`, which holds `size` bytes and
+  // must stay valid until Finish() returns. Rows are aligned to 4 bytes, as
+  // for ImageFrame::kGlDefaultAlignmentBoundary. Must be called on gl_context.
+  GlTextureReadback(std::shared_ptr<GlContext> gl_context, GLenum target,
+                    GLuint name, int width, int height,
+                    const GlTextureInfo& info, void* output, size_t size);
+  ~GlTextureReadback();
+
+  GlTextureReadback(const GlTextureReadback&) = delete;
+  GlTextureReadback& operator=(const GlTextureReadback&) = delete;
+
+  // Waits until the transfer has completed and copies the pixels to the
+  // output. May be called on any thread; when called off the GL context, the
+  // context keeps running other work while the transfer completes.
+  void Finish();
+
+ private:
+  std::shared_ptr<GlContext> gl_context_;
+  void* output_;
+  size_t size_;
+  // The pixel pack buffer, or 0 if the pixels were read synchronously.
+  GLuint buffer_ = 0;
+  std::shared_ptr<GlSyncPoint> sync_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_GPU_GL_TEXTURE_READBACK_H_
@@ -0,0 +1,71 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/gpu/gl_timer_query.h"
+
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+
+namespace mediapipe {
+
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+const GlTimerQueryFunctions* GetGlTimerQueryFunctions() {
+  static const GlTimerQueryFunctions* functions =
+      []() -> const GlTimerQueryFunctions* {
+    auto* f = new GlTimerQueryFunctions;
+    f->glGenQueriesEXT = reinterpret_cast<PFNGLGENQUERIESEXTPROC>(
+        eglGetProcAddress("glGenQueriesEXT"));
+    f->glDeleteQueriesEXT = reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(
+        eglGetProcAddress("glDeleteQueriesEXT"));
+    f->glQueryCounterEXT = reinterpret_cast<PFNGLQUERYCOUNTEREXTPROC>(
+        eglGetProcAddress("glQueryCounterEXT"));
+    f->glGetQueryObjectuivEXT = reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(
+        eglGetProcAddress("glGetQueryObjectuivEXT"));
+    f->glGetQueryObjectui64vEXT =
+        reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(
+            eglGetProcAddress("glGetQueryObjectui64vEXT"));
+    f->glGetInteger64vEXT =
+        reinterpret_cast<decltype(f->glGetInteger64vEXT)>(
+            eglGetProcAddress("glGetInteger64vEXT"));
+    if (!f->glGetInteger64vEXT) {
+      f->glGetInteger64vEXT = reinterpret_cast<decltype(f->glGetInteger64vEXT)>(
+          eglGetProcAddress("glGetInteger64v"));
+    }
+    if (!f->glGenQueriesEXT || !f->glDeleteQueriesEXT ||
+        !f->glQueryCounterEXT || !f->glGetQueryObjectuivEXT ||
+        !f->glGetQueryObjectui64vEXT) {
+      delete f;
+      return nullptr;
+    }
+    return f;
+  }();
+  return functions;
+}
+
+bool HasGlTimerQuery() {
+  if (!GetGlTimerQueryFunctions()) return false;
+  const char* extensions =
+      reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+  if (!extensions) return false;
+  for (absl::string_view extension : absl::StrSplit(extensions, ' ')) {
+    if (extension == "GL_EXT_disjoint_timer_query") return true;
+  }
+  return false;
+}
+#else
+bool HasGlTimerQuery() { return false; }
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+
+}  // namespace mediapipe
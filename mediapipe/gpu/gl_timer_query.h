@@ -0,0 +1,55 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_GPU_GL_TIMER_QUERY_H_
+#define MEDIAPIPE_GPU_GL_TIMER_QUERY_H_
+
+#include "mediapipe/gpu/gl_base.h"
+
+// Timer queries are available through EXT_disjoint_timer_query, whose entry
+// points are looked up with eglGetProcAddress.
+#if HAS_EGL && !defined(__EMSCRIPTEN__)
+#define MEDIAPIPE_HAS_GL_TIMER_QUERY 1
+#else
+#define MEDIAPIPE_HAS_GL_TIMER_QUERY 0
+#endif  // HAS_EGL && !defined(__EMSCRIPTEN__)
+
+namespace mediapipe {
+
+#if MEDIAPIPE_HAS_GL_TIMER_QUERY
+// The entry points of EXT_disjoint_timer_query.
+struct GlTimerQueryFunctions {
+  PFNGLGENQUERIESEXTPROC glGenQueriesEXT = nullptr;
+  PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXT = nullptr;
+  PFNGLQUERYCOUNTEREXTPROC glQueryCounterEXT = nullptr;
+  PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXT = nullptr;
+  PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vEXT = nullptr;
+  // Reads GL_TIMESTAMP_EXT synchronously. May be null, since it is only
+  // exposed with OpenGL ES 3.0.
+  void(GL_APIENTRYP glGetInteger64vEXT)(GLenum pname, GLint64* data) = nullptr;
+};
+
+// Returns the timer query entry points, or nullptr if the driver lacks any of
+// them. The functions are valid only in contexts that expose the
+// GL_EXT_disjoint_timer_query extension; see HasGlTimerQuery.
+const GlTimerQueryFunctions* GetGlTimerQueryFunctions();
+#endif  // MEDIAPIPE_HAS_GL_TIMER_QUERY
+
+// Returns true if timer queries can be used in the current GL context.
+bool HasGlTimerQuery();
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_GPU_GL_TIMER_QUERY_H_
@@ -7,7 +7,10 @@
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/port/logging.h"
+#include "mediapipe/framework/profiler/storage_conversion_observer.h"
 
 #if MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
 #include "mediapipe/objc/util.h"
@@ -41,6 +44,7 @@ internal::GpuBufferStorage* GpuBuffer::StorageHolder::GetStorageForView(
     TypeId view_provider_type, bool for_writing) const {
   std::shared_ptr<internal::GpuBufferStorage> chosen_storage;
   std::function<std::shared_ptr<internal::GpuBufferStorage>()> conversion;
+  TypeId conversion_source = view_provider_type;
 
   {
     absl::MutexLock lock(&mutex_);
@@ -60,6 +64,7 @@ internal::GpuBufferStorage* GpuBuffer::StorageHolder::GetStorageForView(
                                  .StorageConverterForViewProvider(
                                      view_provider_type, s->storage_type())) {
           conversion = absl::bind_front(converter, s);
+          conversion_source = s->storage_type();
           break;
         }
       }
@@ -77,7 +82,15 @@ internal::GpuBufferStorage* GpuBuffer::StorageHolder::GetStorageForView(
   //    false positive in the deadlock detector.
   //    TODO: we could use Mutex::ForgetDeadlockInfo instead.
   if (conversion) {
+    StorageConversionObserver* observer = StorageConversionObserver::Current();
+    absl::Time start_time;
+    if (observer) start_time = absl::Now();
     auto new_storage = conversion();
+    if (observer && new_storage) {
+      observer->OnStorageConversion(conversion_source.name(),
+                                    new_storage->storage_type().name(),
+                                    absl::Now() - start_time);
+    }
     absl::MutexLock lock(&mutex_);
     // Another reader might have already completed and inserted the same
     // conversion. TODO: prevent this?
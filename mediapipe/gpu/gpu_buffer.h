@@ -23,6 +23,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/payload_size.h"
 #include "mediapipe/gpu/gpu_buffer_format.h"
 #include "mediapipe/gpu/gpu_buffer_storage.h"
 
@@ -218,6 +219,18 @@ inline GpuBuffer& GpuBuffer::operator=(std::nullptr_t other) {
 CVPixelBufferRef GetCVPixelBufferRef(const GpuBuffer& buffer);
 #endif  // MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
 
+// Counts the pixel data of a GpuBuffer, for memory accounting. GpuBuffers
+// that share storage are each counted in full.
+template <>
+struct PayloadSize<GpuBuffer> {
+  static size_t Get(const GpuBuffer& buffer) {
+    return sizeof(GpuBuffer) +
+           (buffer ? GpuBufferFormatDataSize(buffer.format(), buffer.width(),
+                                             buffer.height())
+                   : 0);
+  }
+};
+
 }  // namespace mediapipe
 
 #endif  // MEDIAPIPE_GPU_GPU_BUFFER_H_
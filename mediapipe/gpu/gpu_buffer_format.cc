@@ -264,4 +264,42 @@ GpuBufferFormat GpuBufferFormatForImageFormat(ImageFormat::Format format) {
   }
 }
 
+size_t GpuBufferFormatDataSize(GpuBufferFormat format, int width,
+                               int height) {
+  const size_t pixels = static_cast<size_t>(width) * height;
+  switch (format) {
+    case GpuBufferFormat::kOneComponent8:
+    case GpuBufferFormat::kOneComponent8Alpha:
+    case GpuBufferFormat::kOneComponent8Red:
+      return pixels;
+    case GpuBufferFormat::kTwoComponent8:
+    case GpuBufferFormat::kGrayHalf16:
+      return pixels * 2;
+    case GpuBufferFormat::kRGB24:
+      return pixels * 3;
+    case GpuBufferFormat::kBGRA32:
+    case GpuBufferFormat::kRGBA32:
+    case GpuBufferFormat::kGrayFloat32:
+    case GpuBufferFormat::kTwoComponentHalf16:
+      return pixels * 4;
+    case GpuBufferFormat::kTwoComponentFloat32:
+    case GpuBufferFormat::kRGBAHalf64:
+      return pixels * 8;
+    case GpuBufferFormat::kRGBAFloat128:
+      return pixels * 16;
+    case GpuBufferFormat::kBiPlanar420YpCbCr8VideoRange:
+    case GpuBufferFormat::kBiPlanar420YpCbCr8FullRange:
+    case GpuBufferFormat::kNV12:
+    case GpuBufferFormat::kNV21:
+    case GpuBufferFormat::kI420:
+    case GpuBufferFormat::kYV12:
+      // A full resolution luma plane, and two chroma planes subsampled 2x2.
+      return pixels + 2 * (static_cast<size_t>((width + 1) / 2) *
+                           ((height + 1) / 2));
+    case GpuBufferFormat::kUnknown:
+      return 0;
+  }
+  return 0;
+}
+
 }  // namespace mediapipe
@@ -22,6 +22,8 @@
 #endif  // TARGET_OS_OSX
 #endif  // defined(__APPLE__)
 
+#include <cstddef>
+
 #include "mediapipe/framework/formats/image_format.pb.h"
 #if !MEDIAPIPE_DISABLE_GPU
 #include "mediapipe/gpu/gl_base.h"
@@ -88,6 +90,10 @@ const GlTextureInfo& GlTextureInfoForGpuBufferFormat(GpuBufferFormat format,
 ImageFormat::Format ImageFormatForGpuBufferFormat(GpuBufferFormat format);
 GpuBufferFormat GpuBufferFormatForImageFormat(ImageFormat::Format format);
 
+// Returns the number of bytes of pixel data in a buffer of the given format
+// and dimensions, without row padding. Returns 0 for kUnknown.
+size_t GpuBufferFormatDataSize(GpuBufferFormat format, int width, int height);
+
 #ifdef __APPLE__
 
 inline OSType CVPixelFormatForGpuBufferFormat(GpuBufferFormat format) {
@@ -173,6 +179,11 @@ struct GpuBufferSpec {
   GpuBufferSpec(int w, int h, GpuBufferFormat f)
       : width(w), height(h), format(f) {}
 
+  // Returns the number of bytes of pixel data in a buffer with this spec.
+  size_t byte_size() const {
+    return GpuBufferFormatDataSize(format, width, height);
+  }
+
   template <typename H>
   friend H AbslHashValue(H h, const GpuBufferSpec& spec) {
     return H::combine(std::move(h), spec.width, spec.height,
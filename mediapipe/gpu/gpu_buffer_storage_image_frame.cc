@@ -59,13 +59,24 @@ std::shared_ptr<FrameBuffer> ImageFrameToFrameBuffer(
 
 }  // namespace
 
+void GpuBufferStorageImageFrame::Fill() const {
+  absl::call_once(fill_once_, [this] {
+    if (fill_) {
+      fill_(*image_frame_);
+      fill_ = nullptr;
+    }
+  });
+}
+
 std::shared_ptr<const FrameBuffer> GpuBufferStorageImageFrame::GetReadView(
     internal::types<FrameBuffer>) const {
+  Fill();
   return ImageFrameToFrameBuffer(image_frame_);
 }
 
 std::shared_ptr<FrameBuffer> GpuBufferStorageImageFrame::GetWriteView(
     internal::types<FrameBuffer>) {
+  Fill();
   return ImageFrameToFrameBuffer(image_frame_);
 }
 
@@ -16,8 +16,11 @@ limitations under the License.
 #ifndef MEDIAPIPE_GPU_GPU_BUFFER_STORAGE_IMAGE_FRAME_H_
 #define MEDIAPIPE_GPU_GPU_BUFFER_STORAGE_IMAGE_FRAME_H_
 
+#include <functional>
 #include <memory>
+#include <utility>
 
+#include "absl/base/call_once.h"
 #include "mediapipe/framework/formats/frame_buffer.h"
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/gpu/frame_buffer_view.h"
@@ -39,20 +42,31 @@ class GpuBufferStorageImageFrame
     image_frame_ = std::make_shared<ImageFrame>(
         ImageFormatForGpuBufferFormat(format), width, height);
   }
+  // Creates a storage whose pixels are written by `fill` when they are first
+  // accessed, e.g. once an asynchronous GPU readback has completed.
+  GpuBufferStorageImageFrame(std::shared_ptr<ImageFrame> image_frame,
+                             std::function<void(ImageFrame&)> fill)
+      : image_frame_(std::move(image_frame)), fill_(std::move(fill)) {}
   int width() const override { return image_frame_->Width(); }
   int height() const override { return image_frame_->Height(); }
   GpuBufferFormat format() const override {
     return GpuBufferFormatForImageFormat(image_frame_->Format());
   }
-  std::shared_ptr<const ImageFrame> image_frame() const { return image_frame_; }
-  std::shared_ptr<ImageFrame> image_frame() { return image_frame_; }
+  std::shared_ptr<const ImageFrame> image_frame() const {
+    Fill();
+    return image_frame_;
+  }
+  std::shared_ptr<ImageFrame> image_frame() {
+    Fill();
+    return image_frame_;
+  }
   std::shared_ptr<const ImageFrame> GetReadView(
       internal::types<ImageFrame>) const override {
-    return image_frame_;
+    return image_frame();
   }
   std::shared_ptr<ImageFrame> GetWriteView(
       internal::types<ImageFrame>) override {
-    return image_frame_;
+    return image_frame();
   }
   std::shared_ptr<const FrameBuffer> GetReadView(
       internal::types<FrameBuffer>) const override;
@@ -60,7 +74,12 @@ class GpuBufferStorageImageFrame
       internal::types<FrameBuffer>) override;
 
  private:
+  // Writes the pixels with fill_, if any, the first time they are accessed.
+  void Fill() const;
+
   std::shared_ptr<ImageFrame> image_frame_;
+  mutable absl::once_flag fill_once_;
+  mutable std::function<void(ImageFrame&)> fill_;
 };
 
 }  // namespace mediapipe
@@ -23,6 +23,7 @@
 #endif
 
 #include "mediapipe/gpu/gl_calculator_helper.h"
+#include "mediapipe/gpu/gl_texture_readback.h"
 
 namespace mediapipe {
 
@@ -95,20 +96,25 @@ absl::Status GpuBufferToImageFrameCalculator::Process(CalculatorContext* cc) {
         CreateImageFrameForCVPixelBuffer(GetCVPixelBufferRef(input));
     cc->Outputs().Index(0).Add(frame.release(), cc->InputTimestamp());
 #else
-    helper_.RunInGlContext([this, &input, &cc]() {
+    std::unique_ptr<ImageFrame> frame;
+    std::unique_ptr<GlTextureReadback> readback;
+    helper_.RunInGlContext([this, &input, &frame, &readback]() {
       auto src = helper_.CreateSourceTexture(input);
-      std::unique_ptr<ImageFrame> frame = absl::make_unique<ImageFrame>(
+      frame = absl::make_unique<ImageFrame>(
           ImageFormatForGpuBufferFormat(input.format()), src.width(),
           src.height(), ImageFrame::kGlDefaultAlignmentBoundary);
-      helper_.BindFramebuffer(src);
       const auto info = GlTextureInfoForGpuBufferFormat(input.format(), 0,
                                                         helper_.GetGlVersion());
-      glReadPixels(0, 0, src.width(), src.height(), info.gl_format,
-                   info.gl_type, frame->MutablePixelData());
-      glFlush();
-      cc->Outputs().Index(0).Add(frame.release(), cc->InputTimestamp());
+      readback = absl::make_unique<GlTextureReadback>(
+          GlContext::GetCurrent(), src.target(), src.name(), src.width(),
+          src.height(), info, frame->MutablePixelData(),
+          frame->PixelDataSize());
       src.Release();
     });
+    // Waits for the transfer outside of the GL context, which can run the
+    // work of other calculators in the meantime.
+    readback->Finish();
+    cc->Outputs().Index(0).Add(frame.release(), cc->InputTimestamp());
 #endif  // MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
     return absl::OkStatus();
   }
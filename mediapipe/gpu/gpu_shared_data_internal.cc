@@ -26,6 +26,10 @@
 #include "mediapipe/gpu/metal_shared_resources.h"
 #endif  // __APPLE__
 
+#if MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
+#include "mediapipe/gpu/cv_pixel_buffer_pool_registry.h"
+#endif  // MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
+
 namespace mediapipe {
 
 #if __APPLE__
@@ -84,12 +88,12 @@ GpuResources::StatusOrGpuResources GpuResources::Create(
 
 GpuResources::GpuResources(std::shared_ptr<GlContext> gl_context)
 #if MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
-    : texture_caches_(std::make_shared<CvTextureCacheManager>()),
-      gpu_buffer_pool_(
-          [tc = texture_caches_](const internal::GpuBufferSpec& spec,
-                                 const MultiPoolOptions& options) {
-            return CvPixelBufferPoolWrapper::Create(spec, options, tc.get());
-          })
+    : texture_caches_(
+          CvPixelBufferPoolRegistry::GetInstance().texture_caches()),
+      gpu_buffer_pool_([](const internal::GpuBufferSpec& spec,
+                          const MultiPoolOptions& options) {
+        return CvPixelBufferPoolRegistry::GetInstance().GetPool(spec, options);
+      })
 #endif  // MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
 {
   gl_key_context_[SharedContextKey()] = gl_context;
@@ -137,6 +141,8 @@ absl::Status GpuResources::PrepareGpuNode(CalculatorNode* node) {
       node->GetCalculatorState().Options<mediapipe::GlContextOptions>();
   if (options.has_gl_context_name() && !options.gl_context_name().empty()) {
     context_key = absl::StrCat("user:", options.gl_context_name());
+  } else if (options.gl_context_per_executor() && !node->Executor().empty()) {
+    context_key = absl::StrCat("executor:", node->Executor());
   } else if (gets_own_context) {
     context_key = absl::StrCat("auto:", node_type);
   } else if (kGlCalculatorShareContext) {
@@ -182,6 +188,13 @@ const std::shared_ptr<GlContext>& GpuResources::gl_context(
   return gl_key_context_[SharedContextKey()];
 }
 
+void GpuResources::EnableProgramBinaryCache(const std::string& directory) {
+  program_binary_cache_ = std::make_shared<GlProgramBinaryCache>(directory);
+  for (auto& [key, context] : gl_key_context_) {
+    context->SetProgramBinaryCache(program_binary_cache_);
+  }
+}
+
 GlContext::StatusOrGlContext GpuResources::GetOrCreateGlContext(
     const std::string& key) {
   auto it = gl_key_context_.find(key);
@@ -189,6 +202,7 @@ GlContext::StatusOrGlContext GpuResources::GetOrCreateGlContext(
     ASSIGN_OR_RETURN(std::shared_ptr<GlContext> new_context,
                      GlContext::Create(*gl_key_context_[SharedContextKey()],
                                        kGlContextUseDedicatedThread));
+    new_context->SetProgramBinaryCache(program_binary_cache_);
     it = gl_key_context_.emplace(key, new_context).first;
 #if MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
     texture_caches_->RegisterTextureCache(it->second->cv_texture_cache());
@@ -27,6 +27,7 @@
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/gpu/gl_base.h"
 #include "mediapipe/gpu/gl_context.h"
+#include "mediapipe/gpu/gl_program_binary_cache.h"
 #include "mediapipe/gpu/gpu_buffer_multi_pool.h"
 
 #ifdef __APPLE__
@@ -62,6 +63,12 @@ class GpuResources {
   // Shared buffer pool.
   GpuBufferMultiPool& gpu_buffer_pool() { return gpu_buffer_pool_; }
 
+  // Stores the GL programs created by GlhCreateProgram in `directory`, and
+  // loads them from there instead of compiling their shaders on later runs.
+  // Applies to all GL contexts of these resources. Must be called before the
+  // graph using these resources is started.
+  void EnableProgramBinaryCache(const std::string& directory);
+
 #ifdef __APPLE__
   MetalSharedResources& metal_shared() { return *metal_shared_; }
 #endif  // defined(__APPLE__)§
@@ -84,6 +91,8 @@ class GpuResources {
   std::map<std::string, std::string> node_key_;
   std::map<std::string, std::shared_ptr<GlContext>> gl_key_context_;
 
+  std::shared_ptr<GlProgramBinaryCache> program_binary_cache_;
+
 #ifdef MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
   std::shared_ptr<CvTextureCacheManager> texture_caches_;
 #endif  // MEDIAPIPE_GPU_BUFFER_USE_CV_PIXEL_BUFFER
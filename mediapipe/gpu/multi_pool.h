@@ -15,6 +15,13 @@
 #ifndef MEDIAPIPE_GPU_MULTI_POOL_H_
 #define MEDIAPIPE_GPU_MULTI_POOL_H_
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "mediapipe/util/resource_cache.h"
 
 namespace mediapipe {
@@ -33,10 +40,29 @@ struct MultiPoolOptions {
   int min_requests_before_pool = 2;
   // Do a deeper flush every this many requests.
   int request_count_scrub_interval = 50;
+  // The maximum number of bytes kept by all pools, counting keep_count buffers
+  // per pool. When the limit is exceeded, the least recently used pools are
+  // dropped, and buffers too large for the limit are allocated without a pool.
+  // 0 means no limit.
+  int64_t max_pool_bytes = 0;
 };
 
 static constexpr MultiPoolOptions kDefaultMultiPoolOptions;
 
+struct MultiPoolStats {
+  // The number of requests served by an existing pool.
+  int64_t hits = 0;
+  // The number of requests that created a pool, or were allocated without one.
+  int64_t misses = 0;
+  // The number of bytes kept by the current pools, counting keep_count buffers
+  // per pool.
+  int64_t bytes_held = 0;
+  // The number of pools dropped by the count, size and scrub limits.
+  int64_t evictions = 0;
+  // The number of current pools.
+  int pool_count = 0;
+};
+
 // MultiPool is a generic class for vending reusable resources of type Item,
 // which are assumed to be relatively expensive to create, so that reusing them
 // is beneficial.
@@ -50,6 +76,7 @@ static constexpr MultiPoolOptions kDefaultMultiPoolOptions;
 // Item retention and eviction policies are controlled by options.
 // A concrete example would be a pool of GlTextureBuffer, grouped by dimensions
 // and format.
+// Spec must provide byte_size(), the size of one Item with that Spec.
 template <class SimplePool, class Spec, class Item>
 class MultiPool {
  public:
@@ -65,6 +92,15 @@ class MultiPool {
   // Obtains an item. May either be reused or created anew.
   Item Get(const Spec& spec);
 
+  // Creates pools for the given specs ahead of the first requests, and fills
+  // each with keep_count items, so that the first frames do not pay for the
+  // allocations. Items must be creatable on the calling thread, e.g. for
+  // GlTextureBufferPool, the GL context must be current.
+  void Prewarm(absl::Span<const Spec> specs);
+
+  // Returns the request counters since construction, and the current pools.
+  MultiPoolStats GetStats();
+
  private:
   static std::shared_ptr<SimplePool> DefaultMakeSimplePool(
       const Spec& spec, const MultiPoolOptions& options) {
@@ -76,13 +112,48 @@ class MultiPool {
   // pool, in which case the caller should invoke CreateBufferWithoutPool.
   std::shared_ptr<SimplePool> RequestPool(const Spec& spec);
 
+  // Returns the bytes kept by a pool for the spec.
+  int64_t PoolBytes(const Spec& spec) const {
+    return static_cast<int64_t>(spec.byte_size()) * options_.keep_count;
+  }
+
+  // Returns whether a pool for the spec fits in max_pool_bytes.
+  bool PoolFits(const Spec& spec) const {
+    return options_.max_pool_bytes <= 0 ||
+           PoolBytes(spec) <= options_.max_pool_bytes;
+  }
+
+  // Drops pools beyond max_pool_count and max_pool_bytes. Returns the dropped
+  // pools, to be released by the caller without holding the lock.
+  std::vector<std::shared_ptr<SimplePool>> EvictPools()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   absl::Mutex mutex_;
   mediapipe::ResourceCache<Spec, std::shared_ptr<SimplePool>> cache_
-      ABSL_GUARDED_BY(mutex_);
+      ABSL_GUARDED_BY(mutex_){
+          [this](const Spec& spec, const std::shared_ptr<SimplePool>&) {
+            return PoolBytes(spec);
+          }};
+  int64_t hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t misses_ ABSL_GUARDED_BY(mutex_) = 0;
   SimplePoolFactory create_simple_pool_ = DefaultMakeSimplePool;
   MultiPoolOptions options_;
 };
 
+template <class SimplePool, class Spec, class Item>
+std::vector<std::shared_ptr<SimplePool>>
+MultiPool<SimplePool, Spec, Item>::EvictPools() {
+  std::vector<std::shared_ptr<SimplePool>> evicted = cache_.Evict(
+      options_.max_pool_count, options_.request_count_scrub_interval);
+  if (options_.max_pool_bytes > 0) {
+    std::vector<std::shared_ptr<SimplePool>> evicted_by_size =
+        cache_.EvictToSize(options_.max_pool_bytes);
+    evicted.insert(evicted.end(), evicted_by_size.begin(),
+                   evicted_by_size.end());
+  }
+  return evicted;
+}
+
 template <class SimplePool, class Spec, class Item>
 std::shared_ptr<SimplePool> MultiPool<SimplePool, Spec, Item>::RequestPool(
     const Spec& spec) {
@@ -90,13 +161,22 @@ std::shared_ptr<SimplePool> MultiPool<SimplePool, Spec, Item>::RequestPool(
   std::vector<std::shared_ptr<SimplePool>> evicted;
   {
     absl::MutexLock lock(&mutex_);
-    pool = cache_.Lookup(spec, [this](const Spec& spec, int request_count) {
-      return (request_count >= options_.min_requests_before_pool)
-                 ? create_simple_pool_(spec, options_)
-                 : nullptr;
+    bool created = false;
+    pool = cache_.Lookup(spec, [this, &created](const Spec& spec,
+                                                int request_count) {
+      if (request_count < options_.min_requests_before_pool ||
+          !PoolFits(spec)) {
+        return std::shared_ptr<SimplePool>();
+      }
+      created = true;
+      return create_simple_pool_(spec, options_);
     });
-    evicted = cache_.Evict(options_.max_pool_count,
-                           options_.request_count_scrub_interval);
+    if (pool && !created) {
+      ++hits_;
+    } else {
+      ++misses_;
+    }
+    evicted = EvictPools();
   }
   // Evicted pools, and their buffers, will be released without holding the
   // lock.
@@ -114,6 +194,41 @@ Item MultiPool<SimplePool, Spec, Item>::Get(const Spec& spec) {
   }
 }
 
+template <class SimplePool, class Spec, class Item>
+void MultiPool<SimplePool, Spec, Item>::Prewarm(absl::Span<const Spec> specs) {
+  for (const Spec& spec : specs) {
+    if (!PoolFits(spec)) continue;
+    std::shared_ptr<SimplePool> pool;
+    std::vector<std::shared_ptr<SimplePool>> evicted;
+    {
+      absl::MutexLock lock(&mutex_);
+      pool = cache_.Lookup(spec, [this](const Spec& spec, int) {
+        return create_simple_pool_(spec, options_);
+      });
+      evicted = EvictPools();
+    }
+    // Items return to the pool when released, up to keep_count of them.
+    std::vector<decltype(pool->GetBuffer())> items;
+    items.reserve(options_.keep_count);
+    for (int i = 0; i < options_.keep_count; ++i) {
+      items.push_back(pool->GetBuffer());
+    }
+  }
+}
+
+template <class SimplePool, class Spec, class Item>
+MultiPoolStats MultiPool<SimplePool, Spec, Item>::GetStats() {
+  absl::MutexLock lock(&mutex_);
+  MultiPoolStats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  const ResourceCacheStats& cache_stats = cache_.stats();
+  stats.bytes_held = cache_stats.total_size;
+  stats.evictions = cache_stats.evictions;
+  stats.pool_count = cache_stats.value_count;
+  return stats;
+}
+
 }  // namespace mediapipe
 
 #endif  // MEDIAPIPE_GPU_MULTI_POOL_H_
@@ -17,6 +17,7 @@
 #include <stdlib.h>
 
 #include <cmath>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -26,6 +27,8 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "mediapipe/framework/port/logging.h"
+#include "mediapipe/gpu/gl_context.h"
+#include "mediapipe/gpu/gl_program_binary_cache.h"
 
 #if DEBUG
 #define GL_DEBUG_LOG(type, object, action)                        \
@@ -155,6 +158,20 @@ GLint GlhCreateProgram(const GLchar* vert_src, const GLchar* frag_src,
     return GL_FALSE;
   }
 
+  std::shared_ptr<GlContext> context = GlContext::GetCurrent();
+  GlProgramBinaryCache* cache =
+      context && GlProgramBinaryCache::IsSupported()
+          ? context->program_binary_cache()
+          : nullptr;
+  std::string cache_key;
+  if (cache) {
+    cache_key = cache->ProgramKey(vert_src, frag_src, attr_count, attr_names,
+                                  attr_locations);
+    if (cache->LoadProgram(cache_key, *program)) {
+      return GL_TRUE;
+    }
+  }
+
   ok = ok && GlhCompileShader(GL_VERTEX_SHADER, vert_src, &vert_shader,
                               force_log_errors);
   ok = ok && GlhCompileShader(GL_FRAGMENT_SHADER, frag_src, &frag_shader,
@@ -181,6 +198,8 @@ GLint GlhCreateProgram(const GLchar* vert_src, const GLchar* frag_src,
   if (!ok) {
     glDeleteProgram(*program);
     *program = 0;
+  } else if (cache) {
+    cache->StoreProgram(cache_key, *program);
   }
 
   return ok;
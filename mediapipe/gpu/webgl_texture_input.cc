@@ -0,0 +1,71 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/gpu/webgl_texture_input.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/gpu/gl_base.h"
+#include "mediapipe/gpu/gl_context.h"
+
+namespace mediapipe {
+
+WebGlTextureInput::WebGlTextureInput(
+    std::shared_ptr<GpuResources> gpu_resources)
+    : gpu_resources_(std::move(gpu_resources)) {}
+
+WebGlTextureInput::~WebGlTextureInput() {
+  // The views must be released in the GL context.
+  if (bound_buffers_.empty()) return;
+  gpu_resources_->gl_context()->Run([this] { bound_buffers_.clear(); });
+}
+
+absl::Status WebGlTextureInput::BindTexture(const std::string& stream_name,
+                                            int width, int height) {
+  RET_CHECK_GT(width, 0);
+  RET_CHECK_GT(height, 0);
+  return gpu_resources_->gl_context()->Run([&]() -> absl::Status {
+    auto bound = absl::make_unique<BoundBuffer>();
+    bound->buffer = gpu_resources_->gpu_buffer_pool().GetBuffer(width, height);
+    RET_CHECK(bound->buffer) << "Failed to get a " << width << "x" << height
+                             << " buffer from the pool.";
+    bound->view = bound->buffer.GetWriteView<GlTextureView>(0);
+    glBindTexture(bound->view.target(), bound->view.name());
+    bound_buffers_[stream_name] = std::move(bound);
+    return absl::OkStatus();
+  });
+}
+
+absl::StatusOr<GpuBuffer> WebGlTextureInput::TakeBuffer(
+    const std::string& stream_name) {
+  auto it = bound_buffers_.find(stream_name);
+  RET_CHECK(it != bound_buffers_.end())
+      << "No texture is bound for stream " << stream_name;
+  std::unique_ptr<BoundBuffer> bound = std::move(it->second);
+  bound_buffers_.erase(it);
+  MP_RETURN_IF_ERROR(
+      gpu_resources_->gl_context()->Run([&bound]() -> absl::Status {
+        glBindTexture(bound->view.target(), 0);
+        // Releasing the view marks the texture as written.
+        bound->view = GlTextureView();
+        return absl::OkStatus();
+      }));
+  return std::move(bound->buffer);
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,73 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_GPU_WEBGL_TEXTURE_INPUT_H_
+#define MEDIAPIPE_GPU_WEBGL_TEXTURE_INPUT_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mediapipe/gpu/gl_texture_view.h"
+#include "mediapipe/gpu/gpu_buffer.h"
+#include "mediapipe/gpu/gpu_shared_data_internal.h"
+
+namespace mediapipe {
+
+// Lets the browser upload frames, such as from an HTMLVideoElement, straight
+// into the textures of pooled GpuBuffers owned by the graph's WebGL context.
+// Camera frames then reach the graph without a CPU copy through a canvas or
+// ImageData, and without allocating a texture for every frame.
+//
+// Usage from the web graph runner, for each frame:
+//   MP_RETURN_IF_ERROR(input.BindTexture(stream_name, width, height));
+//   // In JavaScript: gl.texSubImage2D(gl.TEXTURE_2D, 0, 0, 0, gl.RGBA,
+//   //                                 gl.UNSIGNED_BYTE, video);
+//   ASSIGN_OR_RETURN(GpuBuffer frame, input.TakeBuffer(stream_name));
+//   MP_RETURN_IF_ERROR(graph.AddPacketToInputStream(
+//       stream_name, MakePacket<GpuBuffer>(std::move(frame)).At(timestamp)));
+class WebGlTextureInput {
+ public:
+  explicit WebGlTextureInput(std::shared_ptr<GpuResources> gpu_resources);
+  ~WebGlTextureInput();
+
+  // Takes a buffer of the given size from the pool for `stream_name`, and
+  // binds its texture to GL_TEXTURE_2D in the graph's GL context. The texture
+  // already has RGBA storage of this size, so it can be filled with
+  // texSubImage2D. A buffer bound earlier for the stream and not taken is
+  // returned to the pool.
+  absl::Status BindTexture(const std::string& stream_name, int width,
+                           int height);
+
+  // Returns the buffer bound for `stream_name` by BindTexture, once its
+  // texture has been filled.
+  absl::StatusOr<GpuBuffer> TakeBuffer(const std::string& stream_name);
+
+ private:
+  struct BoundBuffer {
+    GpuBuffer buffer;
+    // Marks the texture as written when it is released.
+    GlTextureView view;
+  };
+
+  std::shared_ptr<GpuResources> gpu_resources_;
+  absl::flat_hash_map<std::string, std::unique_ptr<BoundBuffer>>
+      bound_buffers_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_GPU_WEBGL_TEXTURE_INPUT_H_
@@ -193,13 +193,105 @@ public class Graph {
    */
   public synchronized void addMultiStreamCallback(
       List<String> streamNames, PacketListCallback callback, boolean observeTimestampBounds) {
+    addMultiStreamCallback(streamNames, callback, observeTimestampBounds, 1);
+  }
+
+  /**
+   * Adds a {@link PacketListCallback} to the context for callback during graph running, which
+   * receives the packets of several timestamps at once.
+   *
+   * <p>The list passed to the callback holds the packets of each timestamp in turn, in the order of
+   * streamNames. Delivering several timestamps in one callback amortizes the cost of crossing into
+   * Java, for output streams with a high packet rate. The packets of the last timestamps are
+   * delivered when {@link #waitUntilGraphIdle} or {@link #waitUntilGraphDone} returns.
+   *
+   * @param streamNames The output stream names in the graph for callback.
+   * @param callback The callback for handling the call when all output streams listed in
+   *     streamNames get {@link Packet}.
+   * @param observeTimestampBounds Whether to output an empty packet when a timestamp bound change
+   *     is observed with no output data.
+   * @param maxTimestampsPerCallback The number of timestamps whose packets are passed to one call
+   *     of the callback.
+   * @throws MediaPipeException for any error status.
+   */
+  public synchronized void addMultiStreamCallback(
+      List<String> streamNames,
+      PacketListCallback callback,
+      boolean observeTimestampBounds,
+      int maxTimestampsPerCallback) {
     Preconditions.checkState(
         nativeGraphHandle != 0, "Invalid context, tearDown() might have been called already.");
     Preconditions.checkNotNull(streamNames);
     Preconditions.checkNotNull(callback);
+    Preconditions.checkArgument(maxTimestampsPerCallback > 0);
     Preconditions.checkState(!graphRunning && !startRunningGraphCalled);
     callbacks.add(callback);
-    nativeAddMultiStreamCallback(nativeGraphHandle, streamNames, callback, observeTimestampBounds);
+    nativeAddMultiStreamCallback(
+        nativeGraphHandle, streamNames, callback, observeTimestampBounds, maxTimestampsPerCallback);
+  }
+
+  /**
+   * Adds a poller for an output stream, whose packets are then returned in batches by {@link
+   * #pollPackets} or {@link #tryPollPackets}.
+   *
+   * <p>Polling in batches amortizes the cost of crossing into the JNI for each packet, for
+   * output streams with a high packet rate.
+   *
+   * @param streamName The output stream name in the graph.
+   * @throws MediaPipeException for any error status.
+   */
+  public synchronized void addPacketPoller(String streamName) {
+    Preconditions.checkState(
+        nativeGraphHandle != 0, "Invalid context, tearDown() might have been called already.");
+    Preconditions.checkNotNull(streamName);
+    Preconditions.checkState(!graphRunning && !startRunningGraphCalled);
+    nativeAddPacketPoller(nativeGraphHandle, streamName);
+  }
+
+  /**
+   * Waits for packets on a polled output stream, and returns up to maxPackets of them.
+   *
+   * <p>This method is not synchronized, so that packets can be added to the graph while it waits.
+   * The caller owns the returned packets and must release them.
+   *
+   * @param streamName An output stream added with {@link #addPacketPoller}.
+   * @param maxPackets The maximum number of packets to return.
+   * @return the packets in timestamp order, or null once the stream is done.
+   * @throws MediaPipeException for any error status.
+   */
+  public List<Packet> pollPackets(String streamName, int maxPackets) {
+    return pollPackets(streamName, maxPackets, true);
+  }
+
+  /**
+   * Returns up to maxPackets packets already queued on a polled output stream, without waiting.
+   *
+   * <p>The caller owns the returned packets and must release them.
+   *
+   * @param streamName An output stream added with {@link #addPacketPoller}.
+   * @param maxPackets The maximum number of packets to return.
+   * @return the packets in timestamp order, possibly none, or null once the stream is done.
+   * @throws MediaPipeException for any error status.
+   */
+  public List<Packet> tryPollPackets(String streamName, int maxPackets) {
+    return pollPackets(streamName, maxPackets, false);
+  }
+
+  private List<Packet> pollPackets(String streamName, int maxPackets, boolean block) {
+    long graphHandle = nativeGraphHandle;
+    Preconditions.checkState(
+        graphHandle != 0, "Invalid context, tearDown() might have been called already.");
+    Preconditions.checkNotNull(streamName);
+    Preconditions.checkArgument(maxPackets > 0);
+    long[] handles = nativePollPackets(graphHandle, streamName, maxPackets, block);
+    if (handles == null) {
+      return null;
+    }
+    List<Packet> packets = new ArrayList<>(handles.length);
+    for (long handle : handles) {
+      packets.add(Packet.create(handle));
+    }
+    return packets;
   }
 
   /**
@@ -631,10 +723,16 @@ public class Graph {
       long context,
       List<String> streamName,
       PacketListCallback callback,
-      boolean observeTimestampBounds);
+      boolean observeTimestampBounds,
+      int maxTimestampsPerCallback);
 
   private native long nativeAddSurfaceOutput(long context, String streamName);
 
+  private native void nativeAddPacketPoller(long context, String streamName);
+
+  private native long[] nativePollPackets(
+      long context, String streamName, int maxPackets, boolean block);
+
   private native void nativeLoadBinaryGraph(long context, String path);
 
   private native void nativeLoadBinaryGraphBytes(long context, byte[] data);
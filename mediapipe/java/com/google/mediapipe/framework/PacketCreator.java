@@ -18,6 +18,7 @@ import com.google.mediapipe.framework.ProtoUtil.SerializedMessage;
 import com.google.protobuf.MessageLite;
 import java.nio.ByteBuffer;
 import java.nio.FloatBuffer;
+import javax.annotation.Nullable;
 
 // TODO: use Preconditions in this file.
 /**
@@ -374,6 +375,66 @@ public class PacketCreator {
    * <p>For 3 and 4 channel images, the pixel rows should have 4-byte alignment.
    */
   public Packet createImage(ByteBuffer buffer, int width, int height, int numChannels) {
+    int widthStep = checkImageBuffer(buffer, width, height, numChannels);
+    return Packet.create(
+        nativeCreateCpuImage(
+            mediapipeGraph.getNativeHandle(), buffer, width, height, widthStep, numChannels));
+  }
+
+  /**
+   * Creates a 1, 3, or 4 channel 8-bit ImageFrame packet that uses the pixel data of a U8, RGB, or
+   * RGBA byte buffer without copying it.
+   *
+   * <p>Use {@link ByteBuffer#allocateDirect} when allocating the buffer. The buffer must not be
+   * written until {@code releaseCallback} is invoked, once no packet refers to the pixel data
+   * anymore. The callback may be invoked on any thread.
+   *
+   * <p>For 3 and 4 channel images, the pixel rows should have 4-byte alignment.
+   */
+  public Packet createImageFrameWithoutCopy(
+      ByteBuffer buffer,
+      int width,
+      int height,
+      int numChannels,
+      @Nullable BufferReleaseCallback releaseCallback) {
+    int widthStep = checkImageBuffer(buffer, width, height, numChannels);
+    return Packet.create(
+        nativeCreateImageFrameWithoutCopy(
+            mediapipeGraph.getNativeHandle(),
+            buffer,
+            width,
+            height,
+            widthStep,
+            numChannels,
+            releaseCallback));
+  }
+
+  /**
+   * Creates a 1, 3, or 4 channel 8-bit Image packet that uses the pixel data of a U8, RGB, or RGBA
+   * byte buffer without copying it.
+   *
+   * <p>See {@link #createImageFrameWithoutCopy} for the requirements on the buffer.
+   */
+  public Packet createImageWithoutCopy(
+      ByteBuffer buffer,
+      int width,
+      int height,
+      int numChannels,
+      @Nullable BufferReleaseCallback releaseCallback) {
+    int widthStep = checkImageBuffer(buffer, width, height, numChannels);
+    return Packet.create(
+        nativeCreateCpuImageWithoutCopy(
+            mediapipeGraph.getNativeHandle(),
+            buffer,
+            width,
+            height,
+            widthStep,
+            numChannels,
+            releaseCallback));
+  }
+
+  /** Returns the width step of an image buffer, after checking the size of the buffer. */
+  private static int checkImageBuffer(ByteBuffer buffer, int width, int height, int numChannels) {
     int widthStep;
     if (numChannels == 4) {
       widthStep = width * 4;
@@ -389,9 +450,7 @@ public class PacketCreator {
       throw new IllegalArgumentException(
           "The size of the buffer should be: " + expectedSize + " but is " + buffer.capacity());
     }
-    return Packet.create(
-        nativeCreateCpuImage(
-            mediapipeGraph.getNativeHandle(), buffer, width, height, widthStep, numChannels));
+    return widthStep;
   }
 
   /** Helper callback adaptor to create the Java {@link GlSyncToken}. This is called by JNI code. */
@@ -451,6 +510,24 @@ public class PacketCreator {
   private native long nativeCreateCpuImage(
       long context, ByteBuffer buffer, int width, int height, int rowBytes, int numChannels);
 
+  private native long nativeCreateImageFrameWithoutCopy(
+      long context,
+      ByteBuffer buffer,
+      int width,
+      int height,
+      int rowBytes,
+      int numChannels,
+      BufferReleaseCallback releaseCallback);
+
+  private native long nativeCreateCpuImageWithoutCopy(
+      long context,
+      ByteBuffer buffer,
+      int width,
+      int height,
+      int rowBytes,
+      int numChannels,
+      BufferReleaseCallback releaseCallback);
+
   private native long nativeCreateInt32Array(long context, int[] data);
 
   private native long nativeCreateInt32Pair(long context, int first, int second);
@@ -37,6 +37,9 @@ import javax.annotation.Nullable;
 public final class PacketGetter {
   private static final FluentLogger logger = FluentLogger.forEnclosingClass();
 
+  /** The number of floats per landmark returned by {@link #getNormalizedLandmarkArrays}. */
+  public static final int NORMALIZED_LANDMARK_FIELDS = 5;
+
   /** Helper class for a list of exactly two Packets. */
   public static class PacketPair {
     public PacketPair(Packet first, Packet second) {
@@ -180,6 +183,17 @@ public final class PacketGetter {
     return getProtoVector(packet, parser);
   }
 
+  /**
+   * Returns the landmarks of a NormalizedLandmarkList or std::vector<NormalizedLandmarkList>
+   * packet, with one array per landmark list. Each array holds {@link #NORMALIZED_LANDMARK_FIELDS}
+   * floats per landmark: x, y, z, visibility, and presence.
+   *
+   * <p>Unlike {@link #getProtoVector}, this doesn't serialize and parse the landmark lists.
+   */
+  public static float[][] getNormalizedLandmarkArrays(final Packet packet) {
+    return nativeGetNormalizedLandmarkArrays(packet.getNativeHandle());
+  }
+
   public static int getImageWidth(final Packet packet) {
     return nativeGetImageWidth(packet.getNativeHandle());
   }
@@ -413,6 +427,8 @@ public final class PacketGetter {
 
   private static native byte[][] nativeGetProtoVector(long nativePacketHandle);
 
+  private static native float[][] nativeGetNormalizedLandmarkArrays(long nativePacketHandle);
+
   private static native int nativeGetImageWidth(long nativePacketHandle);
 
   private static native int nativeGetImageHeight(long nativePacketHandle);
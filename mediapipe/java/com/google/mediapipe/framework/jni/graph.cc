@@ -69,8 +69,11 @@ class PacketWithContext {
 // execution through Graph.
 class CallbackHandler {
  public:
-  CallbackHandler(Graph* context, jobject callback)
-      : context_(context), java_callback_(callback) {}
+  CallbackHandler(Graph* context, jobject callback,
+                  int max_timestamps_per_callback = 1)
+      : context_(context),
+        java_callback_(callback),
+        max_timestamps_per_callback_(max_timestamps_per_callback) {}
 
   ~CallbackHandler() {
     // The jobject global reference is managed by the Graph directly.
@@ -91,8 +94,24 @@ class CallbackHandler {
   }
 
   void PacketListCallback(const std::vector<Packet>& packets) {
-    context_->CallbackToJava(mediapipe::java::GetJNIEnv(), java_callback_,
-                             packets);
+    if (max_timestamps_per_callback_ <= 1) {
+      context_->CallbackToJava(mediapipe::java::GetJNIEnv(), java_callback_,
+                               packets);
+      return;
+    }
+    absl::MutexLock lock(&pending_mutex_);
+    pending_packets_.insert(pending_packets_.end(), packets.begin(),
+                            packets.end());
+    if (++pending_timestamps_ >= max_timestamps_per_callback_) {
+      FlushPendingPackets(mediapipe::java::GetJNIEnv());
+    }
+  }
+
+  // Invokes the java callback with the packets of the timestamps that were
+  // held back to be delivered together, if any.
+  void Flush(JNIEnv* env) {
+    absl::MutexLock lock(&pending_mutex_);
+    FlushPendingPackets(env);
   }
 
   std::function<void(const Packet&)> CreateCallback() {
@@ -119,14 +138,33 @@ class CallbackHandler {
   }
 
  private:
+  void FlushPendingPackets(JNIEnv* env)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(pending_mutex_) {
+    if (pending_timestamps_ == 0) {
+      return;
+    }
+    context_->CallbackToJava(env, java_callback_, pending_packets_);
+    pending_packets_.clear();
+    pending_timestamps_ = 0;
+  }
+
   Graph* context_;
   // java callback object
   jobject java_callback_;
+  // The number of timestamps whose packets are delivered in one packet list
+  // callback.
+  const int max_timestamps_per_callback_;
+  // The packets of the timestamps not delivered yet.
+  std::vector<Packet> pending_packets_ ABSL_GUARDED_BY(pending_mutex_);
+  int pending_timestamps_ ABSL_GUARDED_BY(pending_mutex_) = 0;
+  absl::Mutex pending_mutex_;
 };
 }  // namespace internal
 
 Graph::Graph()
-    : executor_stack_size_increased_(false), global_java_packet_cls_(nullptr) {}
+    : executor_stack_size_increased_(false),
+      global_java_packet_cls_(nullptr),
+      global_java_array_list_cls_(nullptr) {}
 
 Graph::~Graph() {
   if (running_graph_) {
@@ -147,6 +185,10 @@ Graph::~Graph() {
     env->DeleteGlobalRef(global_java_packet_cls_);
     global_java_packet_cls_ = nullptr;
   }
+  if (global_java_array_list_cls_) {
+    env->DeleteGlobalRef(global_java_array_list_cls_);
+    global_java_array_list_cls_ = nullptr;
+  }
 }
 
 int64_t Graph::WrapPacketIntoContext(const Packet& packet) {
@@ -203,14 +245,45 @@ absl::Status Graph::AddCallbackHandler(std::string output_stream_name,
   return absl::OkStatus();
 }
 
+absl::Status Graph::AddPacketPoller(std::string output_stream_name) {
+  if (!graph_config()) {
+    return absl::InternalError("Graph is not loaded!");
+  }
+  poller_stream_names_.push_back(std::move(output_stream_name));
+  return absl::OkStatus();
+}
+
+absl::Status Graph::PollPackets(const std::string& output_stream_name,
+                                int max_packets, bool block,
+                                std::vector<Packet>* packets,
+                                bool* stream_done) {
+  std::shared_ptr<OutputStreamPoller> poller;
+  {
+    absl::MutexLock lock(&pollers_mutex_);
+    auto it = pollers_.find(output_stream_name);
+    if (it == pollers_.end()) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "No poller for output stream \"", output_stream_name,
+          "\" in the running graph."));
+    }
+    poller = it->second;
+  }
+  if (max_packets <= 0) {
+    return absl::InvalidArgumentError("maxPackets must be positive.");
+  }
+  *stream_done = block ? !poller->NextBatch(packets, max_packets)
+                       : !poller->TryNextBatch(packets, max_packets);
+  return absl::OkStatus();
+}
+
 absl::Status Graph::AddMultiStreamCallbackHandler(
     std::vector<std::string> output_stream_names, jobject java_callback,
-    bool observe_timestamp_bounds) {
+    bool observe_timestamp_bounds, int max_timestamps_per_callback) {
   if (!graph_config()) {
     return absl::InternalError("Graph is not loaded!");
   }
-  auto handler =
-      absl::make_unique<internal::CallbackHandler>(this, java_callback);
+  auto handler = absl::make_unique<internal::CallbackHandler>(
+      this, java_callback, max_timestamps_per_callback);
   tool::AddMultiStreamCallback(
       output_stream_names, handler->CreatePacketListCallback(), graph_config(),
       &side_packets_, observe_timestamp_bounds);
@@ -370,19 +443,17 @@ void Graph::CallbackToJava(JNIEnv* env, jobject java_callback_obj,
   jmethodID processMethod = env->GetMethodID(
       callback_cls, process_method_name.c_str(), "(Ljava/util/List;)V");
 
-  // TODO: move to register natives.
-  jclass list_cls = env->FindClass("java/util/ArrayList");
-  jobject java_list =
-      env->NewObject(list_cls, env->GetMethodID(list_cls, "<init>", "()V"));
-  jmethodID add_method =
-      env->GetMethodID(list_cls, "add", "(Ljava/lang/Object;)Z");
+  jobject java_list = env->NewObject(global_java_array_list_cls_,
+                                     array_list_init_method_,
+                                     static_cast<jint>(packets.size()));
   std::vector<int64_t> packet_handles;
+  packet_handles.reserve(packets.size());
   for (const Packet& packet : packets) {
     int64_t packet_handle = WrapPacketIntoContext(packet);
     packet_handles.push_back(packet_handle);
     jobject java_packet =
         CreateJavaPacket(env, global_java_packet_cls_, packet_handle);
-    env->CallBooleanMethod(java_list, add_method, java_packet);
+    env->CallBooleanMethod(java_list, array_list_add_method_, java_packet);
     env->DeleteLocalRef(java_packet);
   }
 
@@ -393,7 +464,6 @@ void Graph::CallbackToJava(JNIEnv* env, jobject java_callback_obj,
     RemovePacket(packet_handle);
   }
   env->DeleteLocalRef(callback_cls);
-  env->DeleteLocalRef(list_cls);
   env->DeleteLocalRef(java_list);
   VLOG(2) << "Returned from java callback.";
 }
@@ -407,6 +477,21 @@ void Graph::SetPacketJavaClass(JNIEnv* env) {
     global_java_packet_cls_ =
         reinterpret_cast<jclass>(env->NewGlobalRef(packet_cls));
   }
+  if (global_java_array_list_cls_ == nullptr) {
+    jclass list_cls = env->FindClass("java/util/ArrayList");
+    global_java_array_list_cls_ =
+        reinterpret_cast<jclass>(env->NewGlobalRef(list_cls));
+    array_list_init_method_ = env->GetMethodID(list_cls, "<init>", "(I)V");
+    array_list_add_method_ =
+        env->GetMethodID(list_cls, "add", "(Ljava/lang/Object;)Z");
+    env->DeleteLocalRef(list_cls);
+  }
+}
+
+void Graph::FlushCallbacks(JNIEnv* env) {
+  for (const auto& handler : callback_handlers_) {
+    handler->Flush(env);
+  }
 }
 
 absl::Status Graph::RunGraphUntilClose(JNIEnv* env) {
@@ -425,6 +510,7 @@ absl::Status Graph::RunGraphUntilClose(JNIEnv* env) {
   // TODO: gpu & services set up!
   status = calculator_graph.Run(CreateCombinedSidePackets());
   ABSL_LOG(INFO) << "Graph run finished.";
+  FlushCallbacks(env);
 
   return status;
 }
@@ -475,6 +561,22 @@ absl::Status Graph::StartRunningGraph(JNIEnv* env) {
     running_graph_.reset(nullptr);
     return status;
   }
+  {
+    absl::MutexLock lock(&pollers_mutex_);
+    pollers_.clear();
+    for (const std::string& stream_name : poller_stream_names_) {
+      auto status_or_poller =
+          running_graph_->AddOutputStreamPoller(stream_name);
+      if (!status_or_poller.ok()) {
+        ABSL_LOG(ERROR) << status_or_poller.status().message();
+        pollers_.clear();
+        running_graph_.reset(nullptr);
+        return status_or_poller.status();
+      }
+      pollers_[stream_name] = std::make_shared<OutputStreamPoller>(
+          std::move(status_or_poller).value());
+    }
+  }
   ABSL_LOG(INFO) << "Start running the graph, waiting for inputs.";
   status =
       running_graph_->StartRun(CreateCombinedSidePackets(), stream_headers_);
@@ -547,6 +649,7 @@ absl::Status Graph::WaitUntilDone(JNIEnv* env) {
     return absl::FailedPreconditionError("Graph must be running.");
   }
   absl::Status status = running_graph_->WaitUntilDone();
+  FlushCallbacks(env);
   running_graph_.reset(nullptr);
   return status;
 }
@@ -555,7 +658,9 @@ absl::Status Graph::WaitUntilIdle(JNIEnv* env) {
   if (!running_graph_) {
     return absl::FailedPreconditionError("Graph must be running.");
   }
-  return running_graph_->WaitUntilIdle();
+  MP_RETURN_IF_ERROR(running_graph_->WaitUntilIdle());
+  FlushCallbacks(env);
+  return absl::OkStatus();
 }
 
 void Graph::SetInputSidePacket(const std::string& stream_name,
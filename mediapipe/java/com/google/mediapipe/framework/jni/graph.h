@@ -51,10 +51,24 @@ class Graph {
   // Adds a callback for a given stream name.
   absl::Status AddCallbackHandler(std::string output_stream_name,
                                   jobject java_callback);
-  // Adds a callback for multiple output streams.
+  // Adds a callback for multiple output streams. The packets of up to
+  // max_timestamps_per_callback timestamps are delivered in one callback. The
+  // remaining packets are delivered once the graph is idle or done.
   absl::Status AddMultiStreamCallbackHandler(
       std::vector<std::string> output_stream_names, jobject java_callback,
-      bool observe_timestamp_bounds);
+      bool observe_timestamp_bounds, int max_timestamps_per_callback = 1);
+
+  // Adds a poller for a given stream name. The packets of the stream are
+  // returned in batches by PollPackets once the graph is running.
+  absl::Status AddPacketPoller(std::string output_stream_name);
+
+  // Appends up to max_packets of the packets queued in a polled output stream
+  // to packets. If block is true, waits until at least one packet is
+  // available or the stream is done. Sets stream_done if the stream is done
+  // and no packets remain.
+  absl::Status PollPackets(const std::string& output_stream_name,
+                           int max_packets, bool block,
+                           std::vector<Packet>* packets, bool* stream_done);
 
   // Loads a binary graph from a file.
   absl::Status LoadBinaryGraph(std::string path_to_graph);
@@ -176,6 +190,8 @@ class Graph {
   // small for Java's class loader. See bug 72414047.
   void EnsureMinimumExecutorStackSizeForJava();
   void SetPacketJavaClass(JNIEnv* env);
+  // Delivers the packets held back by the packet list callbacks.
+  void FlushCallbacks(JNIEnv* env);
   std::map<std::string, Packet> CreateCombinedSidePackets();
   // Returns the top-level CalculatorGraphConfig, or nullptr if the top-level
   // CalculatorGraphConfig is not yet defined.
@@ -202,6 +218,10 @@ class Graph {
   // used from native attached thread. This is the suggested workaround for
   // jni findclass issue.
   jclass global_java_packet_cls_;
+  // The ArrayList class and methods used to pass packet lists to callbacks.
+  jclass global_java_array_list_cls_;
+  jmethodID array_list_init_method_ = nullptr;
+  jmethodID array_list_add_method_ = nullptr;
   // All mediapipe Packet managed/referenced by the context.
   // The map is used for the Java code to be able to look up the Packet
   // based on the handler(pointer).
@@ -223,6 +243,13 @@ class Graph {
   // surface.
   std::unordered_map<std::string, Packet> output_surface_side_packets_;
 
+  // Output streams to poll, added by AddPacketPoller.
+  std::vector<std::string> poller_stream_names_;
+  // The pollers of the running graph, keyed by output stream name.
+  std::map<std::string, std::shared_ptr<OutputStreamPoller>> pollers_
+      ABSL_GUARDED_BY(pollers_mutex_);
+  absl::Mutex pollers_mutex_;
+
   // Side packets used for callbacks.
   std::map<std::string, Packet> side_packets_callbacks_;
 
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/port/canonical_errors.h"
@@ -191,7 +192,8 @@ GRAPH_METHOD(nativeAddPacketCallback)(JNIEnv* env, jobject thiz, jlong context,
 
 JNIEXPORT void JNICALL GRAPH_METHOD(nativeAddMultiStreamCallback)(
     JNIEnv* env, jobject thiz, jlong context, jobject stream_names,
-    jobject callback, jboolean observe_timestamp_bounds) {
+    jobject callback, jboolean observe_timestamp_bounds,
+    jint max_timestamps_per_callback) {
   mediapipe::android::Graph* mediapipe_graph =
       reinterpret_cast<mediapipe::android::Graph*>(context);
   std::vector<std::string> output_stream_names =
@@ -215,7 +217,7 @@ JNIEXPORT void JNICALL GRAPH_METHOD(nativeAddMultiStreamCallback)(
   }
   ThrowIfError(env, mediapipe_graph->AddMultiStreamCallbackHandler(
                         output_stream_names, global_callback_ref,
-                        observe_timestamp_bounds));
+                        observe_timestamp_bounds, max_timestamps_per_callback));
 }
 
 JNIEXPORT jlong JNICALL GRAPH_METHOD(nativeAddSurfaceOutput)(
@@ -227,6 +229,39 @@ JNIEXPORT jlong JNICALL GRAPH_METHOD(nativeAddSurfaceOutput)(
   return mediapipe_graph->AddSurfaceOutput(output_stream_name);
 }
 
+JNIEXPORT void JNICALL GRAPH_METHOD(nativeAddPacketPoller)(
+    JNIEnv* env, jobject thiz, jlong context, jstring stream_name) {
+  mediapipe::android::Graph* mediapipe_graph =
+      reinterpret_cast<mediapipe::android::Graph*>(context);
+  ThrowIfError(env, mediapipe_graph->AddPacketPoller(
+                        JStringToStdString(env, stream_name)));
+}
+
+JNIEXPORT jlongArray JNICALL GRAPH_METHOD(nativePollPackets)(
+    JNIEnv* env, jobject thiz, jlong context, jstring stream_name,
+    jint max_packets, jboolean block) {
+  mediapipe::android::Graph* mediapipe_graph =
+      reinterpret_cast<mediapipe::android::Graph*>(context);
+  std::vector<mediapipe::Packet> packets;
+  bool stream_done = false;
+  if (ThrowIfError(env, mediapipe_graph->PollPackets(
+                            JStringToStdString(env, stream_name), max_packets,
+                            block, &packets, &stream_done))) {
+    return nullptr;
+  }
+  if (stream_done) {
+    return nullptr;
+  }
+  std::vector<int64_t> handles(packets.size());
+  for (int i = 0; i < packets.size(); ++i) {
+    handles[i] = mediapipe_graph->WrapPacketIntoContext(packets[i]);
+  }
+  jlongArray return_handles = env->NewLongArray(handles.size());
+  env->SetLongArrayRegion(return_handles, 0, handles.size(),
+                          reinterpret_cast<const jlong*>(handles.data()));
+  return return_handles;
+}
+
 JNIEXPORT void JNICALL GRAPH_METHOD(nativeRunGraphUntilClose)(
     JNIEnv* env, jobject thiz, jlong context, jobjectArray stream_names,
     jlongArray packets) {
@@ -64,11 +64,19 @@ JNIEXPORT void JNICALL GRAPH_METHOD(nativeAddPacketCallback)(
 
 JNIEXPORT void JNICALL GRAPH_METHOD(nativeAddMultiStreamCallback)(
     JNIEnv* env, jobject thiz, jlong context, jobject stream_names,
-    jobject callback, jboolean observe_timestamp_bounds);
+    jobject callback, jboolean observe_timestamp_bounds,
+    jint max_timestamps_per_callback);
 
 JNIEXPORT jlong JNICALL GRAPH_METHOD(nativeAddSurfaceOutput)(
     JNIEnv* env, jobject thiz, jlong context, jstring stream_name);
 
+JNIEXPORT void JNICALL GRAPH_METHOD(nativeAddPacketPoller)(
+    JNIEnv* env, jobject thiz, jlong context, jstring stream_name);
+
+JNIEXPORT jlongArray JNICALL GRAPH_METHOD(nativePollPackets)(
+    JNIEnv* env, jobject thiz, jlong context, jstring stream_name,
+    jint max_packets, jboolean block);
+
 JNIEXPORT void JNICALL GRAPH_METHOD(nativeRunGraphUntilClose)(
     JNIEnv* env, jobject thiz, jlong context, jobjectArray stream_names,
     jlongArray packets);
@@ -31,6 +31,7 @@
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/core_proto_inc.h"
 #include "mediapipe/framework/port/logging.h"
+#include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/java/com/google/mediapipe/framework/jni/colorspace.h"
 #include "mediapipe/java/com/google/mediapipe/framework/jni/graph.h"
 #include "mediapipe/java/com/google/mediapipe/framework/jni/jni_util.h"
@@ -141,6 +142,72 @@ CreateImageFrameFromByteBuffer(JNIEnv* env, jobject byte_buffer, jint width,
   return image_frame;
 }
 
+absl::StatusOr<mediapipe::ImageFormat::Format> ImageFormatForNumChannels(
+    jint num_channels) {
+  switch (num_channels) {
+    case 4:
+      return mediapipe::ImageFormat::FORMAT_SRGBA;
+    case 3:
+      return mediapipe::ImageFormat::FORMAT_SRGB;
+    case 1:
+      return mediapipe::ImageFormat::FORMAT_GRAY8;
+    default:
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Channels must be either 1, 3, or 4, but are ", num_channels));
+  }
+}
+
+// Create a 1, 3, or 4 channel 8-bit ImageFrame that uses the data of a Java
+// ByteBuffer without copying it. The ImageFrame keeps a reference to the
+// buffer, and invokes the release callback with it, if any, once it is
+// destroyed.
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>>
+WrapByteBufferInImageFrame(JNIEnv* env, jobject byte_buffer, jint width,
+                           jint height, jint width_step, jint num_channels,
+                           jobject buffer_release_callback) {
+  ASSIGN_OR_RETURN(mediapipe::ImageFormat::Format format,
+                   ImageFormatForNumChannels(num_channels));
+  const int64_t buffer_size = env->GetDirectBufferCapacity(byte_buffer);
+  uint8_t* buffer_data =
+      static_cast<uint8_t*>(env->GetDirectBufferAddress(byte_buffer));
+  if (buffer_data == nullptr || buffer_size < 0) {
+    return absl::InvalidArgumentError(
+        "Cannot get direct access to the input buffer. It should be created "
+        "using allocateDirect.");
+  }
+
+  const int expected_buffer_size = height * width_step;
+  RET_CHECK_EQ(buffer_size, expected_buffer_size)
+      << "Input buffer size should be " << expected_buffer_size
+      << " but is: " << buffer_size;
+
+  jmethodID release_method = nullptr;
+  if (buffer_release_callback) {
+    jclass callback_class = env->GetObjectClass(buffer_release_callback);
+    release_method = env->GetMethodID(callback_class, "release",
+                                      "(Ljava/nio/ByteBuffer;)V");
+    env->DeleteLocalRef(callback_class);
+    RET_CHECK(release_method);
+  }
+
+  jobject java_buffer = env->NewGlobalRef(byte_buffer);
+  jobject java_callback = buffer_release_callback
+                              ? env->NewGlobalRef(buffer_release_callback)
+                              : nullptr;
+  // The deleter may run on any thread that drops the last packet referring to
+  // the image frame.
+  return std::make_unique<mediapipe::ImageFrame>(
+      format, width, height, width_step, buffer_data,
+      [java_buffer, java_callback, release_method](uint8_t*) {
+        JNIEnv* env = mediapipe::java::GetJNIEnv();
+        if (java_callback) {
+          env->CallVoidMethod(java_callback, release_method, java_buffer);
+          env->DeleteGlobalRef(java_callback);
+        }
+        env->DeleteGlobalRef(java_buffer);
+      });
+}
+
 }  // namespace
 
 JNIEXPORT jlong JNICALL PACKET_CREATOR_METHOD(nativeCreateReferencePacket)(
@@ -375,26 +442,40 @@ JNIEXPORT jlong JNICALL PACKET_CREATOR_METHOD(nativeCreateMatrix)(
 JNIEXPORT jlong JNICALL PACKET_CREATOR_METHOD(nativeCreateCpuImage)(
     JNIEnv* env, jobject thiz, jlong context, jobject byte_buffer, jint width,
     jint height, jint width_step, jint num_channels) {
-  mediapipe::ImageFormat::Format format;
-  switch (num_channels) {
-    case 4:
-      format = mediapipe::ImageFormat::FORMAT_SRGBA;
-      break;
-    case 3:
-      format = mediapipe::ImageFormat::FORMAT_SRGB;
-      break;
-    case 1:
-      format = mediapipe::ImageFormat::FORMAT_GRAY8;
-      break;
-    default:
-      ThrowIfError(env, absl::InvalidArgumentError(absl::StrCat(
-                            "Channels must be either 1, 3, or 4, but are ",
-                            num_channels)));
-      return 0L;
-  }
+  auto format_or = ImageFormatForNumChannels(num_channels);
+  if (ThrowIfError(env, format_or.status())) return 0L;
 
   auto image_frame_or = CreateImageFrameFromByteBuffer(
-      env, byte_buffer, width, height, width_step, format);
+      env, byte_buffer, width, height, width_step, *format_or);
+  if (ThrowIfError(env, image_frame_or.status())) return 0L;
+
+  mediapipe::Packet packet =
+      mediapipe::MakePacket<mediapipe::Image>(*std::move(image_frame_or));
+  return CreatePacketWithContext(context, packet);
+}
+
+JNIEXPORT jlong JNICALL
+PACKET_CREATOR_METHOD(nativeCreateImageFrameWithoutCopy)(
+    JNIEnv* env, jobject thiz, jlong context, jobject byte_buffer, jint width,
+    jint height, jint width_step, jint num_channels,
+    jobject buffer_release_callback) {
+  auto image_frame_or =
+      WrapByteBufferInImageFrame(env, byte_buffer, width, height, width_step,
+                                 num_channels, buffer_release_callback);
+  if (ThrowIfError(env, image_frame_or.status())) return 0L;
+
+  mediapipe::Packet packet = mediapipe::Adopt(image_frame_or->release());
+  return CreatePacketWithContext(context, packet);
+}
+
+JNIEXPORT jlong JNICALL
+PACKET_CREATOR_METHOD(nativeCreateCpuImageWithoutCopy)(
+    JNIEnv* env, jobject thiz, jlong context, jobject byte_buffer, jint width,
+    jint height, jint width_step, jint num_channels,
+    jobject buffer_release_callback) {
+  auto image_frame_or =
+      WrapByteBufferInImageFrame(env, byte_buffer, width, height, width_step,
+                                 num_channels, buffer_release_callback);
   if (ThrowIfError(env, image_frame_or.status())) return 0L;
 
   mediapipe::Packet packet =
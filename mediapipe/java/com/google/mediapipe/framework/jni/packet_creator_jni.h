@@ -101,6 +101,18 @@ JNIEXPORT jlong JNICALL PACKET_CREATOR_METHOD(nativeCreateCpuImage)(
     JNIEnv* env, jobject thiz, jlong context, jobject byte_buffer, jint width,
     jint height, jint width_step, jint num_channels);
 
+JNIEXPORT jlong JNICALL
+PACKET_CREATOR_METHOD(nativeCreateImageFrameWithoutCopy)(
+    JNIEnv* env, jobject thiz, jlong context, jobject byte_buffer, jint width,
+    jint height, jint width_step, jint num_channels,
+    jobject buffer_release_callback);
+
+JNIEXPORT jlong JNICALL
+PACKET_CREATOR_METHOD(nativeCreateCpuImageWithoutCopy)(
+    JNIEnv* env, jobject thiz, jlong context, jobject byte_buffer, jint width,
+    jint height, jint width_step, jint num_channels,
+    jobject buffer_release_callback);
+
 JNIEXPORT jlong JNICALL PACKET_CREATOR_METHOD(nativeCreateGpuImage)(
     JNIEnv* env, jobject thiz, jlong context, jint name, jint width,
     jint height, jobject texture_release_callback);
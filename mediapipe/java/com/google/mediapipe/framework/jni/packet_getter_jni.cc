@@ -20,6 +20,7 @@
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/formats/image.h"
 #include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/formats/time_series_header.pb.h"
 #include "mediapipe/framework/formats/video_stream_header.h"
@@ -37,6 +38,10 @@ namespace {
 using mediapipe::android::SerializedMessageIds;
 using mediapipe::android::ThrowIfError;
 
+// The number of floats per landmark, which must match
+// PacketGetter.NORMALIZED_LANDMARK_FIELDS.
+constexpr int kNormalizedLandmarkFields = 5;
+
 template <typename T>
 const T& GetFromNativeHandle(int64_t packet_handle) {
   return mediapipe::android::Graph::GetPacketFromHandle(packet_handle).Get<T>();
@@ -273,6 +278,52 @@ JNIEXPORT jobjectArray JNICALL PACKET_GETTER_METHOD(nativeGetProtoVector)(
   return proto_array;
 }
 
+JNIEXPORT jobjectArray JNICALL
+PACKET_GETTER_METHOD(nativeGetNormalizedLandmarkArrays)(JNIEnv* env,
+                                                        jobject thiz,
+                                                        jlong packet) {
+  mediapipe::Packet mediapipe_packet =
+      mediapipe::android::Graph::GetPacketFromHandle(packet);
+  std::vector<const mediapipe::NormalizedLandmarkList*> landmark_lists;
+  if (mediapipe_packet.ValidateAsType<mediapipe::NormalizedLandmarkList>()
+          .ok()) {
+    landmark_lists.push_back(
+        &mediapipe_packet.Get<mediapipe::NormalizedLandmarkList>());
+  } else {
+    const absl::Status status = mediapipe_packet.ValidateAsType<
+        std::vector<mediapipe::NormalizedLandmarkList>>();
+    if (ThrowIfError(env, status)) return nullptr;
+    for (const auto& landmark_list :
+         mediapipe_packet
+             .Get<std::vector<mediapipe::NormalizedLandmarkList>>()) {
+      landmark_lists.push_back(&landmark_list);
+    }
+  }
+
+  jclass float_array_cls = env->FindClass("[F");
+  jobjectArray result =
+      env->NewObjectArray(landmark_lists.size(), float_array_cls, nullptr);
+  env->DeleteLocalRef(float_array_cls);
+  std::vector<float> values;
+  for (int i = 0; i < landmark_lists.size(); ++i) {
+    values.clear();
+    values.reserve(landmark_lists[i]->landmark_size() *
+                   kNormalizedLandmarkFields);
+    for (const auto& landmark : landmark_lists[i]->landmark()) {
+      values.push_back(landmark.x());
+      values.push_back(landmark.y());
+      values.push_back(landmark.z());
+      values.push_back(landmark.visibility());
+      values.push_back(landmark.presence());
+    }
+    jfloatArray float_array = env->NewFloatArray(values.size());
+    env->SetFloatArrayRegion(float_array, 0, values.size(), values.data());
+    env->SetObjectArrayElement(result, i, float_array);
+    env->DeleteLocalRef(float_array);
+  }
+  return result;
+}
+
 JNIEXPORT jshortArray JNICALL PACKET_GETTER_METHOD(nativeGetInt16Vector)(
     JNIEnv* env, jobject thiz, jlong packet) {
   const std::vector<int16_t>& values =
@@ -116,10 +116,16 @@ void RegisterGraphNatives(JNIEnv *env) {
   std::string packet_list_callback_name = class_registry.GetClassName(
       mediapipe::android::ClassRegistry::kPacketListCallbackClassName);
   std::string native_add_multi_stream_callback_signature =
-      absl::StrFormat("(JLjava/util/List;L%s;Z)V", packet_list_callback_name);
+      absl::StrFormat("(JLjava/util/List;L%s;ZI)V", packet_list_callback_name);
   AddJNINativeMethod(&graph_methods, graph, "nativeAddMultiStreamCallback",
                      native_add_multi_stream_callback_signature.c_str(),
                      (void *)&GRAPH_METHOD(nativeAddMultiStreamCallback));
+  AddJNINativeMethod(&graph_methods, graph, "nativeAddPacketPoller",
+                     "(JLjava/lang/String;)V",
+                     (void *)&GRAPH_METHOD(nativeAddPacketPoller));
+  AddJNINativeMethod(&graph_methods, graph, "nativePollPackets",
+                     "(JLjava/lang/String;IZ)[J",
+                     (void *)&GRAPH_METHOD(nativePollPackets));
   AddJNINativeMethod(&graph_methods, graph, "nativeMovePacketToInputStream",
                      "(JLjava/lang/String;JJ)V",
                      (void *)&GRAPH_METHOD(nativeMovePacketToInputStream));
@@ -281,6 +287,10 @@ void RegisterPacketGetterNatives(JNIEnv *env) {
   AddJNINativeMethod(&packet_getter_methods, packet_getter,
                      "nativeGetProtoVector", "(J)[[B",
                      (void *)&PACKET_GETTER_METHOD(nativeGetProtoVector));
+  AddJNINativeMethod(
+      &packet_getter_methods, packet_getter,
+      "nativeGetNormalizedLandmarkArrays", "(J)[[F",
+      (void *)&PACKET_GETTER_METHOD(nativeGetNormalizedLandmarkArrays));
   AddJNINativeMethod(&packet_getter_methods, packet_getter,
                      "nativeGetRgbaFromRgb", "(JLjava/nio/ByteBuffer;)Z",
                      (void *)&PACKET_GETTER_METHOD(nativeGetRgbaFromRgb));
@@ -0,0 +1,80 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Collects the regions of interest present at a timestamp into one vector, so
+// that ImageToTensorCalculator can crop all of them into a single batched
+// tensor with its NORM_RECTS input. Records the input each region comes from,
+// so that SplitTensorBatchCalculator can route the batch entries back.
+//
+// Inputs:
+//   ROI - NormalizedRect. Multiple streams, each of which may be empty at any
+//     timestamp.
+//
+// Outputs:
+//   NORM_RECTS - std::vector<NormalizedRect>
+//     The present regions, in the order of the ROI streams. Nothing is output
+//     when no region is present.
+//   INDICES - std::vector<int>
+//     The index of the ROI stream of each region.
+//
+// Example:
+// node {
+//   calculator: "RoisToBatchCalculator"
+//   input_stream: "ROI:0:left_hand_roi"
+//   input_stream: "ROI:1:right_hand_roi"
+//   output_stream: "NORM_RECTS:hand_rois"
+//   output_stream: "INDICES:hand_roi_indices"
+// }
+class RoisToBatchCalculator : public Node {
+ public:
+  static constexpr Input<NormalizedRect>::Multiple kInRoi{"ROI"};
+  static constexpr Output<std::vector<NormalizedRect>> kOutRects{"NORM_RECTS"};
+  static constexpr Output<std::vector<int>> kOutIndices{"INDICES"};
+
+  MEDIAPIPE_NODE_CONTRACT(kInRoi, kOutRects, kOutIndices);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    std::vector<NormalizedRect> rects;
+    std::vector<int> indices;
+    for (int i = 0; i < kInRoi(cc).Count(); ++i) {
+      if (kInRoi(cc)[i].IsEmpty()) continue;
+      rects.push_back(kInRoi(cc)[i].Get());
+      indices.push_back(i);
+    }
+    if (rects.empty()) return absl::OkStatus();
+    kOutRects(cc).Send(std::move(rects));
+    kOutIndices(cc).Send(std::move(indices));
+    return absl::OkStatus();
+  }
+};
+MEDIAPIPE_REGISTER_NODE(RoisToBatchCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
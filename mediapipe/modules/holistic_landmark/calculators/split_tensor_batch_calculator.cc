@@ -0,0 +1,141 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/ret_check.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Splits batched tensors, such as those of ImageToTensorCalculator with its
+// NORM_RECTS input, into their batch entries, and sends each entry to the
+// output stream given by INDICES, as output by RoisToBatchCalculator. Output
+// streams without a batch entry at a timestamp stay empty.
+//
+// Inputs:
+//   TENSORS - std::vector<Tensor>
+//     Tensors whose first dimension is the batch dimension, of the size of
+//     INDICES.
+//   INDICES - std::vector<int>
+//     The output stream of each batch entry.
+//   LETTERBOX_PADDINGS - std::vector<std::array<float, 4>> @Optional
+//     The letterbox padding of each batch entry.
+//
+// Outputs:
+//   TENSORS - std::vector<Tensor>. Multiple streams.
+//     The tensors of a batch entry, with a batch dimension of 1.
+//   LETTERBOX_PADDING - std::array<float, 4>. Multiple streams, @Optional.
+//     The letterbox padding of a batch entry.
+//
+// Example:
+// node {
+//   calculator: "SplitTensorBatchCalculator"
+//   input_stream: "TENSORS:hand_input_tensors"
+//   input_stream: "INDICES:hand_roi_indices"
+//   input_stream: "LETTERBOX_PADDINGS:hand_letterbox_paddings"
+//   output_stream: "TENSORS:0:left_hand_input_tensors"
+//   output_stream: "TENSORS:1:right_hand_input_tensors"
+//   output_stream: "LETTERBOX_PADDING:0:left_hand_letterbox_padding"
+//   output_stream: "LETTERBOX_PADDING:1:right_hand_letterbox_padding"
+// }
+class SplitTensorBatchCalculator : public Node {
+ public:
+  static constexpr Input<std::vector<Tensor>> kInTensors{"TENSORS"};
+  static constexpr Input<std::vector<int>> kInIndices{"INDICES"};
+  static constexpr Input<std::vector<std::array<float, 4>>>::Optional
+      kInLetterboxPaddings{"LETTERBOX_PADDINGS"};
+  static constexpr Output<std::vector<Tensor>>::Multiple kOutTensors{
+      "TENSORS"};
+  static constexpr Output<std::array<float, 4>>::Multiple kOutLetterboxPadding{
+      "LETTERBOX_PADDING"};
+
+  MEDIAPIPE_NODE_CONTRACT(kInTensors, kInIndices, kInLetterboxPaddings,
+                          kOutTensors, kOutLetterboxPadding);
+
+  static absl::Status UpdateContract(CalculatorContract* cc) {
+    RET_CHECK(kOutLetterboxPadding(cc).Count() == 0 ||
+              kInLetterboxPaddings(cc).IsConnected())
+        << "LETTERBOX_PADDING outputs require the LETTERBOX_PADDINGS input.";
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    cc->SetOffset(TimestampDiff(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    if (kInTensors(cc).IsEmpty() || kInIndices(cc).IsEmpty()) {
+      return absl::OkStatus();
+    }
+    const std::vector<Tensor>& tensors = *kInTensors(cc);
+    const std::vector<int>& indices = *kInIndices(cc);
+    const int batch_size = indices.size();
+    for (const Tensor& tensor : tensors) {
+      RET_CHECK(!tensor.shape().dims.empty() &&
+                tensor.shape().dims[0] == batch_size)
+          << "The first dimension of the tensors must be the batch size "
+          << batch_size << ".";
+    }
+    const bool has_paddings = kOutLetterboxPadding(cc).Count() > 0 &&
+                              !kInLetterboxPaddings(cc).IsEmpty();
+    if (has_paddings) {
+      RET_CHECK_EQ(kInLetterboxPaddings(cc)->size(), batch_size);
+    }
+
+    for (int entry = 0; entry < batch_size; ++entry) {
+      const int output = indices[entry];
+      RET_CHECK(output >= 0 && output < kOutTensors(cc).Count())
+          << "No TENSORS output for batch entry index " << output << ".";
+      std::vector<Tensor> entry_tensors;
+      entry_tensors.reserve(tensors.size());
+      for (const Tensor& tensor : tensors) {
+        entry_tensors.push_back(SliceBatchEntry(tensor, entry, batch_size));
+      }
+      kOutTensors(cc)[output].Send(std::move(entry_tensors));
+      if (has_paddings && output < kOutLetterboxPadding(cc).Count()) {
+        kOutLetterboxPadding(cc)[output].Send(
+            (*kInLetterboxPaddings(cc))[entry]);
+      }
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  static Tensor SliceBatchEntry(const Tensor& tensor, int entry,
+                                int batch_size) {
+    std::vector<int> dims = tensor.shape().dims;
+    dims[0] = 1;
+    Tensor entry_tensor(tensor.element_type(), Tensor::Shape(dims),
+                        tensor.quantization_parameters());
+    const size_t entry_bytes = tensor.bytes() / batch_size;
+    auto read_view = tensor.GetCpuReadView();
+    auto write_view = entry_tensor.GetCpuWriteView();
+    std::memcpy(write_view.buffer<char>(),
+                read_view.buffer<char>() + entry * entry_bytes, entry_bytes);
+    return entry_tensor;
+  }
+};
+MEDIAPIPE_REGISTER_NODE(SplitTensorBatchCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -14,6 +14,7 @@
 
 #include "mediapipe/modules/objectron/calculators/decoder.h"
 
+#include <array>
 #include <limits>
 #include <vector>
 
@@ -55,8 +56,10 @@ FrameAnnotation Decoder::DecodeBoundingBoxKeypoints(
   const float offset_scale = std::min(offsetmap.cols, offsetmap.rows);
   const std::vector<cv::Point> center_points = ExtractCenterKeypoints(heatmap);
   std::vector<BeliefBox> boxes;
+  boxes.reserve(center_points.size());
   for (const auto& center_point : center_points) {
     BeliefBox box;
+    box.box_2d.reserve(kNumKeypoints);
     box.box_2d.emplace_back(center_point.x, center_point.y);
     const int center_x = static_cast<int>(std::round(center_point.x));
     const int center_y = static_cast<int>(std::round(center_point.y));
@@ -102,11 +105,13 @@ void Decoder::DecodeByPeak(const cv::Mat& offsetmap, int center_x, int center_y,
 void Decoder::DecodeByVoting(const cv::Mat& heatmap, const cv::Mat& offsetmap,
                              int center_x, int center_y, float offset_scale_x,
                              float offset_scale_y, BeliefBox* box) const {
+  constexpr int kNumVertices = kNumOffsetmaps / 2;
+
   // Votes at the center.
   const auto& center_offset = offsetmap.at<cv::Vec<float, kNumOffsetmaps>>(
       /*row*/ center_y, /*col*/ center_x);
-  std::vector<float> center_votes(kNumOffsetmaps, 0.f);
-  for (int i = 0; i < kNumOffsetmaps / 2; ++i) {
+  std::array<float, kNumOffsetmaps> center_votes;
+  for (int i = 0; i < kNumVertices; ++i) {
     center_votes[2 * i] = center_x + center_offset[2 * i] * offset_scale_x;
     center_votes[2 * i + 1] =
         center_y + center_offset[2 * i + 1] * offset_scale_y;
@@ -121,36 +126,37 @@ void Decoder::DecodeByVoting(const cv::Mat& heatmap, const cv::Mat& offsetmap,
   cv::Mat heat = heatmap(rect);
   cv::Mat offset = offsetmap(rect);
 
-  for (int i = 0; i < kNumOffsetmaps / 2; ++i) {
-    float x_sum = 0.f;
-    float y_sum = 0.f;
-    float votes = 0.f;
-    for (int r = 0; r < heat.rows; ++r) {
-      for (int c = 0; c < heat.cols; ++c) {
-        const float belief = heat.at<float>(r, c);
-        if (belief < config_.voting_threshold()) {
-          continue;
-        }
-        float offset_x =
-            offset.at<cv::Vec<float, kNumOffsetmaps>>(r, c)[2 * i] *
-            offset_scale_x;
-        float offset_y =
-            offset.at<cv::Vec<float, kNumOffsetmaps>>(r, c)[2 * i + 1] *
-            offset_scale_y;
-        float vote_x = c + rect.x + offset_x;
-        float vote_y = r + rect.y + offset_y;
+  // Accumulates the votes of all the vertices in a single pass over the
+  // window, so that each belief and offset vector is read once.
+  std::array<float, kNumVertices> x_sums = {};
+  std::array<float, kNumVertices> y_sums = {};
+  std::array<float, kNumVertices> votes = {};
+  for (int r = 0; r < heat.rows; ++r) {
+    const float* heat_row = heat.ptr<float>(r);
+    const auto* offset_row = offset.ptr<cv::Vec<float, kNumOffsetmaps>>(r);
+    for (int c = 0; c < heat.cols; ++c) {
+      const float belief = heat_row[c];
+      if (belief < config_.voting_threshold()) {
+        continue;
+      }
+      const cv::Vec<float, kNumOffsetmaps>& offsets = offset_row[c];
+      for (int i = 0; i < kNumVertices; ++i) {
+        float vote_x = c + rect.x + offsets[2 * i] * offset_scale_x;
+        float vote_y = r + rect.y + offsets[2 * i + 1] * offset_scale_y;
         float x_diff = std::abs(vote_x - center_votes[2 * i]);
         float y_diff = std::abs(vote_y - center_votes[2 * i + 1]);
         if (x_diff > config_.voting_allowance() ||
             y_diff > config_.voting_allowance()) {
           continue;
         }
-        x_sum += vote_x * belief;
-        y_sum += vote_y * belief;
-        votes += belief;
+        x_sums[i] += vote_x * belief;
+        y_sums[i] += vote_y * belief;
+        votes[i] += belief;
       }
     }
-    box->box_2d.emplace_back(x_sum / votes, y_sum / votes);
+  }
+  for (int i = 0; i < kNumVertices; ++i) {
+    box->box_2d.emplace_back(x_sums[i] / votes[i], y_sums[i] / votes[i]);
   }
 }
 
@@ -191,11 +197,19 @@ std::vector<cv::Point> Decoder::ExtractCenterKeypoints(
   const cv::Size morph_size(kernel_size, kernel_size);
   cv::dilate(center_heatmap, max_filtered_heatmap,
              cv::getStructuringElement(cv::MORPH_RECT, morph_size));
-  cv::Mat peak_map;
-  cv::bitwise_and((center_heatmap >= max_filtered_heatmap),
-                  (center_heatmap >= config_.heatmap_threshold()), peak_map);
-  std::vector<cv::Point> locations;  // output, locations of non-zero pixels
-  cv::findNonZero(peak_map, locations);
+  // Collects the local maxima above the threshold in a single pass, in the
+  // same row-major order as cv::findNonZero, without building any mask.
+  const float heatmap_threshold = config_.heatmap_threshold();
+  std::vector<cv::Point> locations;
+  for (int r = 0; r < center_heatmap.rows; ++r) {
+    const float* heat_row = center_heatmap.ptr<float>(r);
+    const float* max_row = max_filtered_heatmap.ptr<float>(r);
+    for (int c = 0; c < center_heatmap.cols; ++c) {
+      if (heat_row[c] >= heatmap_threshold && heat_row[c] >= max_row[c]) {
+        locations.emplace_back(c, r);
+      }
+    }
+  }
   return locations;
 }
 
@@ -204,22 +218,29 @@ absl::Status Decoder::Lift2DTo3D(
     bool portrait, FrameAnnotation* estimated_box) const {
   ABSL_CHECK(estimated_box != nullptr);
 
+  const float focal_x = projection_matrix(0, 0);
+  const float focal_y = projection_matrix(1, 1);
+  const float center_x = projection_matrix(0, 2);
+  const float center_y = projection_matrix(1, 2);
+
+  // The buffers and the box are shared by all the objects of the frame.
+  EpnpPoints2d input_points_2d;
+  EpnpPoints3d output_points_3d;
+  std::vector<Vector3f> box_vertices(kNumKeypoints);
+  Box box("category");
   for (auto& annotation : *estimated_box->mutable_annotations()) {
     ABSL_CHECK_EQ(kNumKeypoints, annotation.keypoints_size());
 
     // Fill input 2D Points;
-    std::vector<Vector2f> input_points_2d;
-    input_points_2d.reserve(kNumKeypoints);
-    for (const auto& keypoint : annotation.keypoints()) {
-      input_points_2d.emplace_back(keypoint.point_2d().x(),
-                                   keypoint.point_2d().y());
+    for (int i = 0; i < kNumKeypoints; ++i) {
+      const auto& point_2d = annotation.keypoints(i).point_2d();
+      input_points_2d(i, 0) = point_2d.x();
+      input_points_2d(i, 1) = point_2d.y();
     }
 
     // Run EPnP.
-    std::vector<Vector3f> output_points_3d;
-    output_points_3d.reserve(kNumKeypoints);
-    auto status = SolveEpnp(projection_matrix, portrait, input_points_2d,
-                            &output_points_3d);
+    auto status = SolveEpnp(focal_x, focal_y, center_x, center_y, portrait,
+                            input_points_2d, &output_points_3d);
     if (!status.ok()) {
       ABSL_LOG(ERROR) << status;
       return status;
@@ -227,13 +248,13 @@ absl::Status Decoder::Lift2DTo3D(
 
     // Fill 3D keypoints;
     for (int i = 0; i < kNumKeypoints; ++i) {
-      SetPoint3d(output_points_3d[i],
+      box_vertices[i] = output_points_3d.row(i).transpose();
+      SetPoint3d(box_vertices[i],
                  annotation.mutable_keypoints(i)->mutable_point_3d());
     }
 
     // Fit a box to the 3D points to get box scale, rotation, translation.
-    Box box("category");
-    box.Fit(output_points_3d);
+    box.Fit(box_vertices);
     const Eigen::Matrix<float, 3, 3, Eigen::RowMajor> rotation =
         box.GetRotation();
     const Eigen::Vector3f translation = box.GetTranslation();
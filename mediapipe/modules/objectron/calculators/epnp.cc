@@ -14,45 +14,22 @@
 
 #include "mediapipe/modules/objectron/calculators/epnp.h"
 
-#include "absl/log/absl_check.h"
+#include "mediapipe/framework/port/status_macros.h"
 
 namespace mediapipe {
 
 namespace {
 
-// NUmber of keypoints.
-constexpr int kNumKeypoints = 9;
-
 using Eigen::Map;
 using Eigen::Matrix;
 using Eigen::Matrix4f;
 using Eigen::Vector2f;
 using Eigen::Vector3f;
 
-}  // namespace
-
-absl::Status SolveEpnp(const float focal_x, const float focal_y,
-                       const float center_x, const float center_y,
-                       const bool portrait,
-                       const std::vector<Vector2f>& input_points_2d,
-                       std::vector<Vector3f>* output_points_3d) {
-  if (input_points_2d.size() != kNumKeypoints) {
-    return absl::InvalidArgumentError(
-        absl::StrFormat("Input must has %d 2D points.", kNumKeypoints));
-  }
-
-  if (output_points_3d == nullptr) {
-    return absl::InvalidArgumentError(
-        "Output pointer output_points_3d is Null.");
-  }
-
-  Matrix<float, (kNumKeypoints - 1) * 2, 12> m =
-      Matrix<float, (kNumKeypoints - 1) * 2, 12>::Zero();
-
-  Matrix<float, kNumKeypoints - 1, 4> epnp_alpha;
-  // The epnp_alpha is the Nx4 weight matrix from the EPnP paper, which is used
-  // to express the N box vertices as the weighted sum of 4 control points. The
-  // value of epnp_alpha is depedent on the set of control points been used.
+// Returns the Nx4 weight matrix of the EPnP paper, which is used to express
+// the N box vertices as the weighted sum of 4 control points.
+const Matrix<float, kEpnpNumKeypoints - 1, 4, Eigen::RowMajor>& EpnpAlpha() {
+  // The value of epnp_alpha is depedent on the set of control points been used.
   // In our case we used the 4 control points as below (coordinates are in world
   // coordinate system):
   //     c0 = (0.0, 0.0, 0.0)  // Box center
@@ -81,21 +58,41 @@ absl::Status SolveEpnp(const float focal_x, const float focal_y,
   //   v3 = c0 - (c1 - c0) + (c2 - c0) - (c3 - c0) = 2*c0 - c1 + c2 - c3;
   //   ...
   // Thus we can determine the value of epnp_alpha as been used below.
-  //
-  // clang-format off
-  epnp_alpha << 4.0f, -1.0f, -1.0f, -1.0f,
-                2.0f, -1.0f, -1.0f,  1.0f,
-                2.0f, -1.0f,  1.0f, -1.0f,
-                0.0f, -1.0f,  1.0f,  1.0f,
-                2.0f,  1.0f, -1.0f, -1.0f,
-                0.0f,  1.0f, -1.0f,  1.0f,
-                0.0f,  1.0f,  1.0f, -1.0f,
-               -2.0f,  1.0f,  1.0f,  1.0f;
-  // clang-format on
-
-  for (int i = 0; i < input_points_2d.size() - 1; ++i) {
+  static const auto* epnp_alpha = [] {
+    auto* alpha = new Matrix<float, kEpnpNumKeypoints - 1, 4, Eigen::RowMajor>;
+    // clang-format off
+    *alpha << 4.0f, -1.0f, -1.0f, -1.0f,
+              2.0f, -1.0f, -1.0f,  1.0f,
+              2.0f, -1.0f,  1.0f, -1.0f,
+              0.0f, -1.0f,  1.0f,  1.0f,
+              2.0f,  1.0f, -1.0f, -1.0f,
+              0.0f,  1.0f, -1.0f,  1.0f,
+              0.0f,  1.0f,  1.0f, -1.0f,
+             -2.0f,  1.0f,  1.0f,  1.0f;
+    // clang-format on
+    return alpha;
+  }();
+  return *epnp_alpha;
+}
+
+}  // namespace
+
+absl::Status SolveEpnp(float focal_x, float focal_y, float center_x,
+                       float center_y, bool portrait,
+                       const EpnpPoints2d& input_points_2d,
+                       EpnpPoints3d* output_points_3d) {
+  if (output_points_3d == nullptr) {
+    return absl::InvalidArgumentError(
+        "Output pointer output_points_3d is Null.");
+  }
+
+  const auto& epnp_alpha = EpnpAlpha();
+  Matrix<float, (kEpnpNumKeypoints - 1) * 2, 12> m =
+      Matrix<float, (kEpnpNumKeypoints - 1) * 2, 12>::Zero();
+
+  for (int i = 0; i < kEpnpNumKeypoints - 1; ++i) {
     // Skip 0th landmark which is object center.
-    const auto& point_2d = input_points_2d[i + 1];
+    const auto point_2d = input_points_2d.row(i + 1);
 
     // Convert 2d point from `pixel coordinates` to `NDC coordinates`([-1, 1])
     // following to the definitions in:
@@ -123,33 +120,57 @@ absl::Status SolveEpnp(const float focal_x, const float focal_y,
   }
   // This is a self adjoint matrix. Use SelfAdjointEigenSolver for a fast
   // and stable solution.
-  Matrix<float, 12, 12> mt_m = m.transpose() * m;
+  Matrix<float, 12, 12> mt_m;
+  mt_m.noalias() = m.transpose() * m;
   Eigen::SelfAdjointEigenSolver<Matrix<float, 12, 12>> eigen_solver(mt_m);
   if (eigen_solver.info() != Eigen::Success) {
     return absl::AbortedError("Eigen decomposition failed.");
   }
-  ABSL_CHECK_EQ(12, eigen_solver.eigenvalues().size());
 
   // Eigenvalues are sorted in increasing order for SelfAdjointEigenSolver
   // only! If you use other Eigen Solvers, it's not guaranteed to be in
   // increasing order. Here, we just take the eigen vector corresponding
   // to first/smallest eigen value, since we used SelfAdjointEigenSolver.
-  Eigen::VectorXf eigen_vec = eigen_solver.eigenvectors().col(0);
+  Matrix<float, 12, 1> eigen_vec = eigen_solver.eigenvectors().col(0);
   Map<Matrix<float, 4, 3, Eigen::RowMajor>> control_matrix(eigen_vec.data());
 
   // All 3D points should be in front of camera (z < 0).
   if (control_matrix(0, 2) > 0) {
     control_matrix = -control_matrix;
   }
-  Matrix<float, kNumKeypoints - 1, 3> vertices = epnp_alpha * control_matrix;
-
-  // Fill 0th 3D points.
-  output_points_3d->emplace_back(control_matrix(0, 0), control_matrix(0, 1),
-                                 control_matrix(0, 2));
-  // Fill the rest 3D points.
-  for (int i = 0; i < kNumKeypoints - 1; ++i) {
-    output_points_3d->emplace_back(vertices(i, 0), vertices(i, 1),
-                                   vertices(i, 2));
+
+  // Fill 0th 3D points, then the box vertices.
+  output_points_3d->row(0) = control_matrix.row(0);
+  output_points_3d->bottomRows<kEpnpNumKeypoints - 1>().noalias() =
+      epnp_alpha * control_matrix;
+  return absl::OkStatus();
+}
+
+absl::Status SolveEpnp(const float focal_x, const float focal_y,
+                       const float center_x, const float center_y,
+                       const bool portrait,
+                       const std::vector<Vector2f>& input_points_2d,
+                       std::vector<Vector3f>* output_points_3d) {
+  if (input_points_2d.size() != kEpnpNumKeypoints) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Input must has %d 2D points.", kEpnpNumKeypoints));
+  }
+
+  if (output_points_3d == nullptr) {
+    return absl::InvalidArgumentError(
+        "Output pointer output_points_3d is Null.");
+  }
+
+  EpnpPoints2d points_2d;
+  for (int i = 0; i < kEpnpNumKeypoints; ++i) {
+    points_2d.row(i) = input_points_2d[i].transpose();
+  }
+  EpnpPoints3d points_3d;
+  MP_RETURN_IF_ERROR(SolveEpnp(focal_x, focal_y, center_x, center_y, portrait,
+                               points_2d, &points_3d));
+
+  for (int i = 0; i < kEpnpNumKeypoints; ++i) {
+    output_points_3d->emplace_back(points_3d.row(i).transpose());
   }
   return absl::OkStatus();
 }
@@ -24,6 +24,36 @@
 
 namespace mediapipe {
 
+// Number of box keypoints lifted by SolveEpnp: the box center followed by the
+// 8 box vertices.
+inline constexpr int kEpnpNumKeypoints = 9;
+
+// 2D keypoints of a box, one per row.
+using EpnpPoints2d =
+    Eigen::Matrix<float, kEpnpNumKeypoints, 2, Eigen::RowMajor>;
+// 3D keypoints of a box, one per row.
+using EpnpPoints3d =
+    Eigen::Matrix<float, kEpnpNumKeypoints, 3, Eigen::RowMajor>;
+
+// This function performs EPnP algorithm, lifting the normalized 2D keypoints
+// of a box in pixel space to 3D points in camera coordinate. It works on
+// fixed-size matrices only and doesn't allocate memory, which makes it suitable
+// for lifting every box of a frame in a loop.
+//
+// Inputs:
+//   focal_x: camera focal length along x.
+//   focal_y: camera focal length along y.
+//   center_x: camera center along x.
+//   center_y: camera center along y.
+//   portrait: a boolen variable indicating whether our images are obtained in
+//     portrait orientation or not.
+//   input_points_2d: input 2D points to be lifted to 3D.
+//   output_points_3d: ouput 3D points in camera coordinate.
+absl::Status SolveEpnp(float focal_x, float focal_y, float center_x,
+                       float center_y, bool portrait,
+                       const EpnpPoints2d& input_points_2d,
+                       EpnpPoints3d* output_points_3d);
+
 // This function performs EPnP algorithm, lifting normalized 2D points in pixel
 // space to 3D points in camera coordinate.
 //
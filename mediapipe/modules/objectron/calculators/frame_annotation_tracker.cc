@@ -14,6 +14,12 @@
 
 #include "mediapipe/modules/objectron/calculators/frame_annotation_tracker.h"
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -22,14 +28,111 @@
 #include "mediapipe/util/tracking/box_tracker.pb.h"
 
 namespace mediapipe {
+namespace {
+
+// Axis-aligned bounds of a box, covering its rotation.
+struct BoxBounds {
+  float left;
+  float top;
+  float right;
+  float bottom;
+
+  bool Overlaps(const BoxBounds& other) const {
+    return left <= other.right && other.left <= right && top <= other.bottom &&
+           other.top <= bottom;
+  }
+};
+
+BoxBounds ComputeBoxBounds(const TimedBoxProto& box) {
+  const float center_x = (box.left() + box.right()) * 0.5f;
+  const float center_y = (box.top() + box.bottom()) * 0.5f;
+  const float half_width = std::abs(box.right() - box.left()) * 0.5f;
+  const float half_height = std::abs(box.bottom() - box.top()) * 0.5f;
+  const float cos_rotation = std::abs(std::cos(box.rotation()));
+  const float sin_rotation = std::abs(std::sin(box.rotation()));
+  const float extent_x = half_width * cos_rotation + half_height * sin_rotation;
+  const float extent_y = half_width * sin_rotation + half_height * cos_rotation;
+  return {center_x - extent_x, center_y - extent_y, center_x + extent_x,
+          center_y + extent_y};
+}
+
+// Buckets boxes in a uniform grid over the normalized image by their bounds,
+// so that finding the boxes which may overlap a box only visits the boxes in
+// the cells that it covers. Boxes beyond the image fall in the border cells.
+class BoxGrid {
+ public:
+  explicit BoxGrid(std::vector<BoxBounds> bounds)
+      : bounds_(std::move(bounds)), visit_stamps_(bounds_.size(), 0) {
+    constexpr int kMaxCellsPerSide = 16;
+    cells_per_side_ = std::clamp(
+        static_cast<int>(std::ceil(std::sqrt(bounds_.size()))), 1,
+        kMaxCellsPerSide);
+    cells_.resize(cells_per_side_ * cells_per_side_);
+    for (int i = 0; i < bounds_.size(); ++i) {
+      ForEachCell(bounds_[i],
+                  [this, i](int cell) { cells_[cell].push_back(i); });
+    }
+  }
+
+  // Calls `fn` once with the index of each box, including `index` itself,
+  // whose bounds overlap the bounds of the box with `index`.
+  template <typename Fn>
+  void ForEachOverlappingBox(int index, Fn fn) {
+    ++visit_stamp_;
+    const BoxBounds& query = bounds_[index];
+    ForEachCell(query, [&](int cell) {
+      for (int i : cells_[cell]) {
+        if (visit_stamps_[i] == visit_stamp_) continue;
+        visit_stamps_[i] = visit_stamp_;
+        if (bounds_[i].Overlaps(query)) fn(i);
+      }
+    });
+  }
+
+ private:
+  int CellCoordinate(float value) const {
+    return std::clamp(static_cast<int>(std::floor(value * cells_per_side_)), 0,
+                      cells_per_side_ - 1);
+  }
+
+  template <typename Fn>
+  void ForEachCell(const BoxBounds& bounds, Fn fn) const {
+    const int x_end = CellCoordinate(bounds.right);
+    const int y_end = CellCoordinate(bounds.bottom);
+    for (int y = CellCoordinate(bounds.top); y <= y_end; ++y) {
+      for (int x = CellCoordinate(bounds.left); x <= x_end; ++x) {
+        fn(y * cells_per_side_ + x);
+      }
+    }
+  }
+
+  std::vector<BoxBounds> bounds_;
+  int cells_per_side_;
+  std::vector<std::vector<int>> cells_;
+  std::vector<int> visit_stamps_;
+  int visit_stamp_ = 0;
+};
+
+}  // namespace
 
 void FrameAnnotationTracker::AddDetectionResult(
     const FrameAnnotation& frame_annotation) {
   const int64_t time_us =
       static_cast<int64_t>(std::round(frame_annotation.timestamp()));
   for (const auto& object_annotation : frame_annotation.annotations()) {
-    detected_objects_[time_us + object_annotation.object_id()] =
-        object_annotation;
+    DetectedObject& detected_obj =
+        detected_objects_[time_us + object_annotation.object_id()];
+    detected_obj.annotation = object_annotation;
+    // The source box of the keypoints doesn't change with tracking, so it is
+    // computed once here rather than on every consolidation.
+    std::vector<cv::Point2f> key_points;
+    key_points.reserve(object_annotation.keypoints_size());
+    for (const auto& keypoint : object_annotation.keypoints()) {
+      key_points.push_back(
+          cv::Point2f(keypoint.point_2d().x(), keypoint.point_2d().y()));
+    }
+    detected_obj.box.Clear();
+    ComputeBoundingRect(key_points, &detected_obj.box);
   }
 }
 
@@ -39,50 +142,67 @@ FrameAnnotation FrameAnnotationTracker::ConsolidateTrackingResult(
   ABSL_CHECK(cancel_object_ids != nullptr);
   FrameAnnotation frame_annotation;
   std::vector<int64_t> keys_to_be_deleted;
+
+  // Index the tracked boxes by ID and by location once for all detections.
+  absl::flat_hash_map<int, int> box_index_by_id;
+  std::vector<BoxBounds> box_bounds;
+  box_bounds.reserve(tracked_boxes.box_size());
+  for (int i = 0; i < tracked_boxes.box_size(); ++i) {
+    box_index_by_id.try_emplace(tracked_boxes.box(i).id(), i);
+    box_bounds.push_back(ComputeBoxBounds(tracked_boxes.box(i)));
+  }
+  BoxGrid box_grid(std::move(box_bounds));
+  // Several detections may track the same object, whose duplicates only need
+  // to be found once.
+  absl::flat_hash_set<int> deduplicated_object_ids;
+
   for (const auto& detected_obj : detected_objects_) {
-    const int object_id = detected_obj.second.object_id();
+    const ObjectAnnotation& annotation = detected_obj.second.annotation;
+    const int object_id = annotation.object_id();
     if (cancel_object_ids->contains(object_id)) {
       // Remember duplicated detections' keys.
       keys_to_be_deleted.push_back(detected_obj.first);
       continue;
     }
-    TimedBoxProto ref_box;
-    for (const auto& box : tracked_boxes.box()) {
-      if (box.id() == object_id) {
-        ref_box = box;
-        break;
-      }
-    }
-    if (!ref_box.has_id() || ref_box.id() < 0) {
+    const auto ref_box_iter = box_index_by_id.find(object_id);
+    if (ref_box_iter == box_index_by_id.end() ||
+        !tracked_boxes.box(ref_box_iter->second).has_id() ||
+        tracked_boxes.box(ref_box_iter->second).id() < 0) {
       ABSL_LOG(ERROR) << "Can't find matching tracked box for object id: "
                       << object_id << ". Likely lost tracking of it.";
       keys_to_be_deleted.push_back(detected_obj.first);
       continue;
     }
+    const int ref_box_index = ref_box_iter->second;
+    const TimedBoxProto& ref_box = tracked_boxes.box(ref_box_index);
 
-    // Find duplicated boxes
-    for (const auto& box : tracked_boxes.box()) {
-      if (box.id() != object_id) {
-        if (ComputeBoxIoU(ref_box, box) > iou_threshold_) {
+    // Find duplicated boxes. Boxes with disjoint bounds have no intersection,
+    // so only the overlapping ones need their IoU computed, unless any IoU
+    // is above the threshold.
+    if (deduplicated_object_ids.insert(object_id).second) {
+      auto cancel_if_duplicate = [&](int box_index) {
+        const TimedBoxProto& box = tracked_boxes.box(box_index);
+        if (box.id() != object_id &&
+            ComputeBoxIoU(ref_box, box) > iou_threshold_) {
           cancel_object_ids->insert(box.id());
         }
+      };
+      if (iou_threshold_ >= 0.0f) {
+        box_grid.ForEachOverlappingBox(ref_box_index, cancel_if_duplicate);
+      } else {
+        for (int i = 0; i < tracked_boxes.box_size(); ++i) {
+          cancel_if_duplicate(i);
+        }
       }
     }
 
-    // Map ObjectAnnotation from detection to tracked time.
-    // First, gather all keypoints from source detection.
-    std::vector<cv::Point2f> key_points;
-    for (const auto& keypoint : detected_obj.second.keypoints()) {
-      key_points.push_back(
-          cv::Point2f(keypoint.point_2d().x(), keypoint.point_2d().y()));
-    }
-    // Second, find source box.
-    TimedBoxProto src_box;
-    ComputeBoundingRect(key_points, &src_box);
+    // Map ObjectAnnotation from detection to tracked time, from the source
+    // box of the detection keypoints.
+    const TimedBoxProto& src_box = detected_obj.second.box;
     ObjectAnnotation* tracked_obj = frame_annotation.add_annotations();
     tracked_obj->set_object_id(ref_box.id());
-    // Finally, map all keypoints in the source detection to tracked location.
-    for (const auto& keypoint : detected_obj.second.keypoints()) {
+    // Map all keypoints in the source detection to tracked location.
+    for (const auto& keypoint : annotation.keypoints()) {
       cv::Point2f dst = MapPoint(
           src_box, ref_box,
           cv::Point2f(keypoint.point_2d().x(), keypoint.point_2d().y()),
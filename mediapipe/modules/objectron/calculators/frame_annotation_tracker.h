@@ -51,9 +51,15 @@ class FrameAnnotationTracker {
   float iou_threshold_;
   float img_width_;
   float img_height_;
+  struct DetectedObject {
+    ObjectAnnotation annotation;
+    // Bounding rect of the 2D keypoints of `annotation`.
+    TimedBoxProto box;
+  };
+
   // Cached detection results over time.
   // Key is timestamp_us + object_id.
-  absl::btree_map<int64, ObjectAnnotation, std::greater<int64>>
+  absl::btree_map<int64, DetectedObject, std::greater<int64>>
       detected_objects_;
 };
 
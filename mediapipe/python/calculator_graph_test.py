@@ -246,6 +246,39 @@ class GraphTest(absltest.TestCase):
       self.assertEqual(out[i].timestamp, i)
       self.assertEqual(packet_getter.get_str(out[i]), 'hello world')
 
+  def test_poll_output_stream_batches(self):
+    text_config = """
+      input_stream: 'in'
+      output_stream: 'out'
+      node {
+        calculator: 'PassThroughCalculator'
+        input_stream: 'in'
+        output_stream: 'out'
+      }
+    """
+    hello_world_packet = packet_creator.create_string('hello world')
+    graph = CalculatorGraph(graph_config=text_config)
+    poller = graph.add_output_stream_poller('out')
+    graph.start_run()
+    self.assertEqual(poller.try_next_batch(max_packets=10), [])
+
+    sequence_size = 10
+    for i in range(sequence_size):
+      graph.add_packet_to_input_stream(
+          stream='in', packet=hello_world_packet, timestamp=i)
+    graph.wait_until_idle()
+    out = poller.try_next_batch(max_packets=4)
+    self.assertLen(out, 4)
+    out.extend(poller.next_batch(max_packets=100))
+    self.assertLen(out, sequence_size)
+    for i in range(sequence_size):
+      self.assertEqual(out[i].timestamp, i)
+      self.assertEqual(packet_getter.get_str(out[i]), 'hello world')
+
+    graph.close()
+    self.assertEqual(poller.next_batch(max_packets=100), [])
+    self.assertIsNone(poller.try_next_batch(max_packets=100))
+
 
 if __name__ == '__main__':
   absltest.main()
@@ -14,6 +14,10 @@
 
 #include "mediapipe/python/pybind/calculator_graph.h"
 
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "mediapipe/framework/calculator.pb.h"
@@ -210,7 +214,9 @@ void CalculatorGraphSubmodule(pybind11::module* module) {
   calculator_graph.def(
       "close_input_stream",
       [](CalculatorGraph* self, const std::string& stream) {
-        RaisePyErrorIfNotOk(self->CloseInputStream(stream));
+        py::gil_scoped_release gil_release;
+        RaisePyErrorIfNotOk(self->CloseInputStream(stream),
+                            /**acquire_gil=*/true);
       },
       R"doc(Close the named graph input stream.
 
@@ -225,7 +231,9 @@ void CalculatorGraphSubmodule(pybind11::module* module) {
   calculator_graph.def(
       "close_all_packet_sources",
       [](CalculatorGraph* self) {
-        RaisePyErrorIfNotOk(self->CloseAllPacketSources());
+        py::gil_scoped_release gil_release;
+        RaisePyErrorIfNotOk(self->CloseAllPacketSources(),
+                            /**acquire_gil=*/true);
       },
       R"doc(Closes all the graph input streams and source calculator nodes.)doc");
 
@@ -238,7 +246,9 @@ void CalculatorGraphSubmodule(pybind11::module* module) {
                              kv_pair.first.cast<std::string>(),
                              kv_pair.second.cast<Packet>());
         }
-        RaisePyErrorIfNotOk(self->StartRun(input_side_packet_map));
+        py::gil_scoped_release gil_release;
+        RaisePyErrorIfNotOk(self->StartRun(input_side_packet_map),
+                            /**acquire_gil=*/true);
       },
 
       R"doc(Start a run of the calculator graph.
@@ -442,11 +452,110 @@ void CalculatorGraphSubmodule(pybind11::module* module) {
       py::arg("stream_name"), py::arg("callback_fn"),
       py::arg("observe_timestamp_bounds") = false);
 
+  // Output Stream Poller
+  py::class_<OutputStreamPoller> output_stream_poller(
+      m, "OutputStreamPoller",
+      R"doc(Polls the packets emitted by a graph output stream.)doc");
+
+  output_stream_poller.def(
+      "next_batch",
+      [](OutputStreamPoller* self, int max_packets) {
+        std::vector<Packet> packets;
+        {
+          py::gil_scoped_release gil_release;
+          if (!self->NextBatch(&packets, max_packets)) {
+            return std::vector<Packet>();
+          }
+        }
+        return packets;
+      },
+      R"doc(Returns the queued packets, waiting until at least one is available.
+
+  The poller lock is taken once per batch rather than once per packet.
+
+  Args:
+    max_packets: The maximum number of packets to return.
+
+  Returns:
+    A list of packets, which is empty if the output stream is done.
+
+  Examples:
+    poller = graph.add_output_stream_poller('out')
+    graph.start_run()
+    while True:
+      packets = poller.next_batch(max_packets=100)
+      if not packets:
+        break
+      output.extend(packets)
+
+)doc",
+      py::arg("max_packets"));
+
+  output_stream_poller.def(
+      "try_next_batch",
+      [](OutputStreamPoller* self,
+         int max_packets) -> std::optional<std::vector<Packet>> {
+        std::vector<Packet> packets;
+        if (!self->TryNextBatch(&packets, max_packets)) {
+          return std::nullopt;
+        }
+        return packets;
+      },
+      R"doc(Returns the queued packets without waiting.
+
+  Args:
+    max_packets: The maximum number of packets to return.
+
+  Returns:
+    A possibly empty list of packets, or None if the output stream is done.
+
+)doc",
+      py::arg("max_packets"));
+
+  output_stream_poller.def(
+      "queue_size",
+      [](OutputStreamPoller* self) { return self->QueueSize(); },
+      R"doc(Returns the number of packets waiting to be polled.)doc");
+
+  calculator_graph.def(
+      "add_output_stream_poller",
+      [](CalculatorGraph* self, const std::string& stream_name,
+         bool observe_timestamp_bounds) {
+        auto status_or_poller =
+            self->AddOutputStreamPoller(stream_name, observe_timestamp_bounds);
+        RaisePyErrorIfNotOk(status_or_poller.status());
+        return std::make_unique<OutputStreamPoller>(
+            std::move(status_or_poller).value());
+      },
+      R"doc(Add a poller for the named output stream.
+
+  The poller returns the packets emitted by the output stream in batches, so
+  that a consumer running at a lower rate than the graph can take all the
+  pending packets at once. This method can only be called before start_run().
+
+  Args:
+    stream_name: The name of the output stream.
+    observe_timestamp_bounds: If true, returns an empty packet at
+      timestamp_bound -1 when timestamp bound changes.
+
+  Raises:
+    RuntimeError: If the calculator graph isn't initialized or the stream
+      doesn't exist.
+
+  Examples:
+    graph = mp.CalculatorGraph(graph_config=graph_config)
+    poller = graph.add_output_stream_poller('out')
+    graph.start_run()
+
+)doc",
+      py::arg("stream_name"), py::arg("observe_timestamp_bounds") = false);
+
   calculator_graph.def(
       "close",
       [](CalculatorGraph* self) {
-        RaisePyErrorIfNotOk(self->CloseAllPacketSources());
         py::gil_scoped_release gil_release;
+        RaisePyErrorIfNotOk(self->CloseAllPacketSources(),
+                            /**acquire_gil=*/true);
         RaisePyErrorIfNotOk(self->WaitUntilDone(), /**acquire_gil=*/true);
       },
       R"doc(Close all the input sources and shutdown the graph.)doc");
@@ -49,11 +49,17 @@ std::unique_ptr<ImageFrame> CreateImageFrame(
                                ImageFrame::kGlDefaultAlignmentBoundary);
     return image_frame_copy;
   }
+  // The image frame shares the data of the numpy array, which it keeps alive
+  // until the last packet holding it is destroyed. That may happen on a graph
+  // thread while the GIL is released, so the deleter acquires it.
   PyObject* data_pyobject = data.ptr();
   auto image_frame = absl::make_unique<ImageFrame>(
       format, /*width=*/cols, /*height=*/rows, width_step,
       static_cast<uint8*>(data.request().ptr),
-      /*deleter=*/[data_pyobject](uint8*) { Py_XDECREF(data_pyobject); });
+      /*deleter=*/[data_pyobject](uint8*) {
+        py::gil_scoped_acquire gil_acquire;
+        Py_XDECREF(data_pyobject);
+      });
   Py_XINCREF(data_pyobject);
   return image_frame;
 }
@@ -15,23 +15,34 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/audio/audio_classifier/audio_classifier.h"
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "audio/dsp/resampler_q.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/tasks/cc/audio/audio_classifier/proto/audio_classifier_graph_options.pb.h"
 #include "mediapipe/tasks/cc/audio/core/audio_task_api_factory.h"
+#include "mediapipe/tasks/cc/audio/utils/audio_tensor_specs.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/calculators/classification_aggregation_calculator.pb.h"
 #include "mediapipe/tasks/cc/components/containers/classification_result.h"
 #include "mediapipe/tasks/cc/components/containers/proto/classifications.pb.h"
 #include "mediapipe/tasks/cc/components/processors/classifier_options.h"
 #include "mediapipe/tasks/cc/components/processors/proto/classifier_options.pb.h"
+#include "mediapipe/tasks/cc/core/model_resources.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
 #include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
 #include "mediapipe/tasks/cc/core/task_runner.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -55,6 +66,7 @@ constexpr char kSampleRateTag[] = "SAMPLE_RATE";
 constexpr char kSubgraphTypeName[] =
     "mediapipe.tasks.audio.audio_classifier.AudioClassifierGraph";
 constexpr int kMicroSecondsPerMilliSecond = 1000;
+constexpr int kMilliSecondsPerSecond = 1000;
 
 // Creates a MediaPipe graph config that only contains a single subgraph node of
 // type "AudioClassifierGraph".
@@ -91,6 +103,24 @@ ConvertAudioClassifierOptionsToProto(AudioClassifierOptions* options) {
               &(options->classifier_options)));
   options_proto->mutable_classifier_options()->Swap(
       classifier_options_proto.get());
+  if (options->min_voice_activity_rms_dbfs.has_value()) {
+    options_proto->set_min_voice_activity_rms_dbfs(
+        *options->min_voice_activity_rms_dbfs);
+  }
+  switch (options->score_pooling) {
+    case ScorePooling::kNone:
+      break;
+    case ScorePooling::kMean:
+      options_proto->set_score_pooling(
+          ClassificationAggregationCalculatorOptions::MEAN_POOLING);
+      break;
+    case ScorePooling::kMax:
+      options_proto->set_score_pooling(
+          ClassificationAggregationCalculatorOptions::MAX_POOLING);
+      break;
+  }
+  options_proto->set_score_pooling_window_size(
+      options->score_pooling_window_size);
   return options_proto;
 }
 
@@ -110,6 +140,38 @@ absl::StatusOr<std::vector<AudioClassifierResult>> ConvertOutputPackets(
   return results;
 }
 
+// Returns the specs of the audio input of a model, which ClassifyStreams needs
+// to frame the streams. A model passed by content is not copied.
+absl::StatusOr<AudioTensorSpecs> GetAudioTensorSpecs(
+    const tasks::core::proto::ExternalFile& model_asset) {
+  auto model_file = std::make_unique<tasks::core::proto::ExternalFile>();
+  if (model_asset.has_file_content()) {
+    auto* file_pointer_meta = model_file->mutable_file_pointer_meta();
+    file_pointer_meta->set_pointer(
+        reinterpret_cast<uint64_t>(model_asset.file_content().data()));
+    file_pointer_meta->set_length(model_asset.file_content().size());
+  } else {
+    *model_file = model_asset;
+  }
+  ASSIGN_OR_RETURN(
+      auto model_resources,
+      tasks::core::ModelResources::Create(/*tag=*/"", std::move(model_file)));
+  const tflite::Model& model = *model_resources->GetTfLiteModel();
+  if (model.subgraphs()->size() != 1 ||
+      (*model.subgraphs())[0]->inputs()->size() != 1) {
+    return absl::InvalidArgumentError(
+        "Audio classification tflite models are assumed to have a single "
+        "subgraph with a single input.");
+  }
+  const auto* primary_subgraph = (*model.subgraphs())[0];
+  const auto* input_tensor =
+      (*primary_subgraph->tensors())[(*primary_subgraph->inputs())[0]];
+  ASSIGN_OR_RETURN(
+      const auto* audio_tensor_metadata,
+      GetAudioTensorMetadataIfAny(*model_resources->GetMetadataExtractor(), 0));
+  return BuildInputAudioTensorSpecs(*input_tensor, audio_tensor_metadata);
+}
+
 absl::StatusOr<AudioClassifierResult> ConvertAsyncOutputPackets(
     absl::StatusOr<tasks::core::PacketMap> status_or_packets) {
   if (!status_or_packets.ok()) {
@@ -121,10 +183,33 @@ absl::StatusOr<AudioClassifierResult> ConvertAsyncOutputPackets(
 }
 }  // namespace
 
+struct AudioClassifier::StreamState {
+  double audio_sample_rate;
+  // Resamples the stream to the model sample rate, if they differ.
+  std::unique_ptr<audio_dsp::QResampler<float>> resampler;
+  // The resampled samples that don't fill a window yet.
+  Matrix samples;
+  // The index of the first buffered sample in the resampled stream.
+  int64_t first_sample_index = 0;
+};
+
+AudioClassifier::~AudioClassifier() = default;
+
 /* static */
 absl::StatusOr<std::unique_ptr<AudioClassifier>> AudioClassifier::Create(
     std::unique_ptr<AudioClassifierOptions> options) {
   auto options_proto = ConvertAudioClassifierOptionsToProto(options.get());
+  // The specs are read before the model moves into the graph config. If they
+  // can't be read, the graph creation below reports what is wrong with the
+  // model, and only ClassifyStreams is unavailable.
+  std::optional<AudioTensorSpecs> audio_tensor_specs;
+  if (options->running_mode == core::RunningMode::AUDIO_CLIPS) {
+    auto status_or_specs =
+        GetAudioTensorSpecs(options_proto->base_options().model_asset());
+    if (status_or_specs.ok()) {
+      audio_tensor_specs = *status_or_specs;
+    }
+  }
   tasks::core::PacketsCallback packets_callback = nullptr;
   if (options->result_callback) {
     auto result_callback = options->result_callback;
@@ -133,11 +218,15 @@ absl::StatusOr<std::unique_ptr<AudioClassifier>> AudioClassifier::Create(
           result_callback(ConvertAsyncOutputPackets(status_or_packets));
         };
   }
-  return core::AudioTaskApiFactory::Create<AudioClassifier,
-                                           proto::AudioClassifierGraphOptions>(
-      CreateGraphConfig(std::move(options_proto)),
-      std::move(options->base_options.op_resolver), options->running_mode,
-      std::move(packets_callback));
+  ASSIGN_OR_RETURN(
+      auto audio_classifier,
+      (core::AudioTaskApiFactory::Create<AudioClassifier,
+                                         proto::AudioClassifierGraphOptions>(
+          CreateGraphConfig(std::move(options_proto)),
+          std::move(options->base_options.op_resolver), options->running_mode,
+          std::move(packets_callback))));
+  audio_classifier->audio_tensor_specs_ = audio_tensor_specs;
+  return audio_classifier;
 }
 
 absl::StatusOr<std::vector<AudioClassifierResult>> AudioClassifier::Classify(
@@ -157,6 +246,112 @@ absl::Status AudioClassifier::ClassifyAsync(Matrix audio_block,
             .At(Timestamp(timestamp_ms * kMicroSecondsPerMilliSecond))}});
 }
 
+absl::StatusOr<std::vector<std::vector<AudioClassifierResult>>>
+AudioClassifier::ClassifyStreams(std::vector<AudioStreamBlock> audio_blocks) {
+  if (!audio_tensor_specs_.has_value()) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kFailedPrecondition,
+        "Classifying audio streams requires the audio clips mode and a model "
+        "with audio tensor metadata.",
+        MediaPipeTasksStatus::kRunnerApiCalledInWrongModeError);
+  }
+  const int num_channels = audio_tensor_specs_->num_channels;
+  const int num_samples = audio_tensor_specs_->num_samples;
+  const double sample_rate = audio_tensor_specs_->sample_rate;
+  // The windows of all the blocks are classified as one clip at the model
+  // sample rate, which the graph splits back into the windows.
+  std::vector<float> batch;
+  // The block index and the stream sample index of each window in the batch.
+  std::vector<std::pair<int, int64_t>> windows;
+  for (int i = 0; i < audio_blocks.size(); ++i) {
+    AudioStreamBlock& block = audio_blocks[i];
+    if (block.audio_block.rows() != num_channels && num_channels != 1) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrFormat("Audio input has %d channel(s) but the model "
+                          "requires %d channel(s).",
+                          block.audio_block.rows(), num_channels),
+          MediaPipeTasksStatus::kInvalidArgumentError);
+    }
+    if (block.audio_block.rows() != num_channels) {
+      // Mono mixdown, as done by the graph.
+      block.audio_block = block.audio_block.colwise().mean().eval();
+    }
+    std::unique_ptr<StreamState>& stream = streams_[block.stream_id];
+    if (stream == nullptr) {
+      stream = std::make_unique<StreamState>();
+      stream->audio_sample_rate = block.audio_sample_rate;
+      if (block.audio_sample_rate != sample_rate) {
+        stream->resampler = std::make_unique<audio_dsp::QResampler<float>>(
+            block.audio_sample_rate, sample_rate, num_channels,
+            audio_dsp::QResamplerParams());
+      }
+      stream->samples.resize(num_channels, 0);
+    } else if (block.audio_sample_rate != stream->audio_sample_rate) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrFormat(
+              "The input audio sample rate: %f of stream %d is inconsistent "
+              "with the previously provided: %f.",
+              block.audio_sample_rate, block.stream_id,
+              stream->audio_sample_rate),
+          MediaPipeTasksStatus::kInvalidArgumentError);
+    }
+    Matrix resampled;
+    if (stream->resampler) {
+      stream->resampler->ProcessSamples(block.audio_block, &resampled);
+    } else {
+      resampled = std::move(block.audio_block);
+    }
+    Matrix& samples = stream->samples;
+    samples.conservativeResize(Eigen::NoChange,
+                               samples.cols() + resampled.cols());
+    samples.rightCols(resampled.cols()) = resampled;
+
+    const int num_windows = samples.cols() / num_samples;
+    for (int window = 0; window < num_windows; ++window) {
+      windows.emplace_back(i, stream->first_sample_index +
+                                  static_cast<int64_t>(window) * num_samples);
+    }
+    // The windows of a column-major matrix are contiguous.
+    const int num_window_samples = num_windows * num_samples;
+    batch.insert(batch.end(), samples.data(),
+                 samples.data() + num_window_samples * num_channels);
+    samples = samples.rightCols(samples.cols() - num_window_samples).eval();
+    stream->first_sample_index += num_window_samples;
+  }
+
+  std::vector<std::vector<AudioClassifierResult>> results(audio_blocks.size());
+  if (windows.empty()) {
+    return results;
+  }
+  Matrix audio_clip = Eigen::Map<const Matrix>(
+      batch.data(), num_channels, windows.size() * num_samples);
+  ASSIGN_OR_RETURN(auto window_results,
+                   ConvertOutputPackets(ProcessAudioClip(
+                       {{kAudioStreamName,
+                         MakePacket<Matrix>(std::move(audio_clip))},
+                        {kSampleRateName, MakePacket<double>(sample_rate)}})));
+  if (window_results.size() != windows.size()) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInternal,
+        absl::StrFormat("Expected %d classification results but got %d.",
+                        windows.size(), window_results.size()),
+        MediaPipeTasksStatus::kError);
+  }
+  for (int i = 0; i < windows.size(); ++i) {
+    const auto& [block_index, first_sample_index] = windows[i];
+    window_results[i].timestamp_ms = static_cast<int64_t>(
+        first_sample_index * kMilliSecondsPerSecond / sample_rate);
+    results[block_index].push_back(std::move(window_results[i]));
+  }
+  return results;
+}
+
+void AudioClassifier::CloseStream(int64_t stream_id) {
+  streams_.erase(stream_id);
+}
+
 }  // namespace audio_classifier
 }  // namespace audio
 }  // namespace tasks
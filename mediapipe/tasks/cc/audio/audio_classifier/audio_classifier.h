@@ -16,14 +16,18 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_AUDIO_AUDIO_CLASSIFIER_AUDIO_CLASSIFIER_H_
 #define MEDIAPIPE_TASKS_CC_AUDIO_AUDIO_CLASSIFIER_AUDIO_CLASSIFIER_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/tasks/cc/audio/core/base_audio_task_api.h"
 #include "mediapipe/tasks/cc/audio/core/running_mode.h"
+#include "mediapipe/tasks/cc/audio/utils/audio_tensor_specs.h"
 #include "mediapipe/tasks/cc/components/containers/classification_result.h"
 #include "mediapipe/tasks/cc/components/processors/classifier_options.h"
 #include "mediapipe/tasks/cc/core/base_options.h"
@@ -37,6 +41,17 @@ namespace audio_classifier {
 using AudioClassifierResult =
     ::mediapipe::tasks::components::containers::ClassificationResult;
 
+// How the scores of each result are pooled with those of the previous results.
+enum class ScorePooling {
+  // Each result has the scores of its own audio window.
+  kNone,
+  // Each category has the mean of its scores over the pooled results, with a
+  // score of 0 in the results where it is missing.
+  kMean,
+  // Each category has the max of its scores over the pooled results.
+  kMax,
+};
+
 // The options for configuring a mediapipe audio classifier task.
 struct AudioClassifierOptions {
   // Base options for configuring Task library, such as specifying the TfLite
@@ -56,6 +71,22 @@ struct AudioClassifierOptions {
   //    be specified to receive the classification results asynchronously.
   core::RunningMode running_mode = core::RunningMode::AUDIO_CLIPS;
 
+  // If set, the audio windows whose root mean square level is below this
+  // level, in dB relative to full scale, are treated as silence and skip the
+  // inference, which saves most of the compute on silent audio. Full scale is
+  // a sample magnitude of 1.0. In the audio clips mode, a skipped window has a
+  // result with no classifications, so the skipped windows can be counted. In the
+  // audio stream mode, a skipped window has no result.
+  std::optional<float> min_voice_activity_rms_dbfs;
+
+  // How the scores of each result are pooled with those of the results of the
+  // `score_pooling_window_size` - 1 previous audio windows. This smooths the
+  // results over a sliding window with a constant amount of memory, however
+  // long the stream. In the audio clips mode, the pooling restarts with each
+  // clip.
+  ScorePooling score_pooling = ScorePooling::kNone;
+  int score_pooling_window_size = 1;
+
   // The user-defined result callback for processing audio stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::AUDIO_STREAM.
@@ -63,6 +94,20 @@ struct AudioClassifierOptions {
       nullptr;
 };
 
+// A block of one of the many audio streams classified at once by
+// AudioClassifier::ClassifyStreams.
+struct AudioStreamBlock {
+  // The user-defined id of the stream that the block continues.
+  int64_t stream_id;
+
+  // The audio block, with one row per channel and one column per sample.
+  mediapipe::Matrix audio_block;
+
+  // The sample rate of the audio block, which must be the same for all the
+  // blocks of a stream.
+  double audio_sample_rate;
+};
+
 // Performs audio classification on audio clips or audio stream.
 //
 // This API expects a TFLite model with mandatory TFLite Model Metadata that
@@ -91,6 +136,7 @@ struct AudioClassifierOptions {
 class AudioClassifier : tasks::audio::core::BaseAudioTaskApi {
  public:
   using BaseAudioTaskApi::BaseAudioTaskApi;
+  ~AudioClassifier() override;
 
   // Creates an AudioClassifier to process either audio clips (e.g., audio
   // files) or audio stream data (e.g., microphone live input). Audio classifier
@@ -167,8 +213,37 @@ class AudioClassifier : tasks::audio::core::BaseAudioTaskApi {
   absl::Status ClassifyAsync(mediapipe::Matrix audio_block,
                              double audio_sample_rate, int64 timestamp_ms);
 
+  // Performs audio classification on blocks of many audio streams at once.
+  // Only use this method when the AudioClassifier is created with the audio
+  // clips running mode.
+  //
+  // Unlike ClassifyAsync, a single AudioClassifier serves any number of
+  // streams: the audio of each stream is resampled and buffered by stream id,
+  // and the model-sized windows completed by all the blocks are classified in
+  // one run of the graph. The result at index i holds the results of the
+  // windows completed by audio_blocks[i], with timestamps (in milliseconds)
+  // relative to the start of its stream. The samples that don't fill a window
+  // yet are kept for the next block of the same stream.
+  //
+  // This method is not thread-safe.
+  absl::StatusOr<std::vector<std::vector<AudioClassifierResult>>>
+  ClassifyStreams(std::vector<AudioStreamBlock> audio_blocks);
+
+  // Drops the buffered audio of a stream passed to ClassifyStreams. The
+  // samples that don't fill a window are not classified.
+  void CloseStream(int64_t stream_id);
+
   // Shuts down the AudioClassifier when all works are done.
   absl::Status Close() { return runner_->Close(); }
+
+ private:
+  // The resampler and the buffered samples of a stream.
+  struct StreamState;
+
+  // The specs of the model input, which are only known in the audio clips
+  // mode.
+  std::optional<AudioTensorSpecs> audio_tensor_specs_;
+  absl::flat_hash_map<int64_t, std::unique_ptr<StreamState>> streams_;
 };
 
 }  // namespace audio_classifier
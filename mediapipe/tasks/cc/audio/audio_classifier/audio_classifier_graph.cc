@@ -23,18 +23,22 @@ limitations under the License.
 #include "absl/types/optional.h"
 #include "flatbuffers/flatbuffers.h"
 #include "mediapipe/calculators/core/constant_side_packet_calculator.pb.h"
+#include "mediapipe/calculators/tensor/audio_activity_calculator.pb.h"
 #include "mediapipe/calculators/tensor/audio_to_tensor_calculator.pb.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
+#include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/tasks/cc/audio/audio_classifier/proto/audio_classifier_graph_options.pb.h"
 #include "mediapipe/tasks/cc/audio/utils/audio_tensor_specs.h"
 #include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/calculators/classification_aggregation_calculator.pb.h"
 #include "mediapipe/tasks/cc/components/containers/proto/classifications.pb.h"
 #include "mediapipe/tasks/cc/components/processors/classification_postprocessing_graph.h"
 #include "mediapipe/tasks/cc/components/processors/proto/classification_postprocessing_graph_options.pb.h"
+#include "mediapipe/tasks/cc/components/utils/gate.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
 #include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
@@ -56,6 +60,7 @@ using ::mediapipe::api2::builder::Graph;
 using ::mediapipe::api2::builder::Source;
 using ::mediapipe::tasks::components::containers::proto::ClassificationResult;
 
+constexpr char kActiveTag[] = "ACTIVE";
 constexpr char kAtPrestreamTag[] = "AT_PRESTREAM";
 constexpr char kAudioTag[] = "AUDIO";
 constexpr char kClassificationsTag[] = "CLASSIFICATIONS";
@@ -231,7 +236,19 @@ class AudioClassifierGraph : public core::ModelTaskGraph {
     // tensors produced by the AudioToTensorCalculator.
     auto& inference = AddInference(
         model_resources, task_options.base_options().acceleration(), graph);
-    audio_to_tensor.Out(kTensorsTag) >> inference.In(kTensorsTag);
+    Source<std::vector<Tensor>> tensors =
+        audio_to_tensor[Output<std::vector<Tensor>>(kTensorsTag)];
+    if (task_options.has_min_voice_activity_rms_dbfs()) {
+      // Skips the inference on the windows without voice activity. The gate
+      // advances the timestamp bound past the skipped windows.
+      auto& audio_activity = graph.AddNode("AudioActivityCalculator");
+      audio_activity.GetOptions<AudioActivityCalculatorOptions>()
+          .set_min_rms_dbfs(task_options.min_voice_activity_rms_dbfs());
+      tensors >> audio_activity.In(kTensorsTag);
+      tensors = components::utils::AllowIf(
+          tensors, audio_activity[Output<bool>(kActiveTag)], graph);
+    }
+    tensors >> inference.In(kTensorsTag);
 
     // Adds postprocessing calculators and connects them to the graph output.
     auto& postprocessing = graph.AddNode(
@@ -243,6 +260,17 @@ class AudioClassifierGraph : public core::ModelTaskGraph {
             &postprocessing
                  .GetOptions<components::processors::proto::
                                  ClassificationPostprocessingGraphOptions>()));
+    if (task_options.score_pooling() !=
+        ClassificationAggregationCalculatorOptions::NO_POOLING) {
+      auto& aggregation_options =
+          *postprocessing
+               .GetOptions<components::processors::proto::
+                               ClassificationPostprocessingGraphOptions>()
+               .mutable_classification_aggregation_options();
+      aggregation_options.set_pooling(task_options.score_pooling());
+      aggregation_options.set_pooling_window_size(
+          task_options.score_pooling_window_size());
+    }
     inference.Out(kTensorsTag) >> postprocessing.In(kTensorsTag);
 
     // Time aggregation is only needed for performing audio classification on
@@ -467,6 +467,36 @@ TEST_F(ClassifyTest, SucceedsWithCategoryDenylist) {
   }
 }
 
+TEST_F(ClassifyTest, SkipsInferenceOnSilence) {
+  // The speech follows two windows of silence.
+  Matrix speech = GetAudioData(k16kTestWavFilename);
+  Matrix audio_buffer = Matrix::Zero(1, 2 * kYamnetNumOfAudioSamples +
+                                            speech.cols());
+  audio_buffer.rightCols(speech.cols()) = speech;
+  auto options = std::make_unique<AudioClassifierOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kModelWithMetadata);
+  options->min_voice_activity_rms_dbfs = -60.0f;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioClassifier> audio_classifier,
+                          AudioClassifier::Create(std::move(options)));
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto result, audio_classifier->Classify(std::move(audio_buffer),
+                                              /*audio_sample_rate=*/16000));
+  MP_ASSERT_OK(audio_classifier->Close());
+  ASSERT_EQ(result.size(), 7);
+  // The skipped windows have results without classifications.
+  EXPECT_EQ(result[0].timestamp_ms, 0);
+  EXPECT_TRUE(result[0].classifications.empty());
+  EXPECT_EQ(result[1].timestamp_ms, 975);
+  EXPECT_TRUE(result[1].classifications.empty());
+  std::vector<AudioClassifierResult> speech_result(result.begin() + 2,
+                                                   result.end());
+  for (auto& speech_window_result : speech_result) {
+    *speech_window_result.timestamp_ms -= 2 * 975;
+  }
+  CheckSpeechResult(speech_result);
+}
+
 class ClassifyAsyncTest : public tflite::testing::Test {};
 
 TEST_F(ClassifyAsyncTest, Succeeds) {
@@ -529,6 +559,84 @@ TEST_F(ClassifyAsyncTest, SucceedsWithNonDeterministicNumAudioSamples) {
   CheckStreamingModeResults(outputs);
 }
 
+class ClassifyStreamsTest : public tflite::testing::Test {};
+
+TEST_F(ClassifyStreamsTest, SucceedsWithInterleavedStreams) {
+  // The same speech at two sample rates, sent as two streams.
+  std::vector<Matrix> audio_buffers = {GetAudioData(k16kTestWavFilename),
+                                       GetAudioData(k48kTestWavFilename)};
+  const std::vector<double> sample_rates = {16000, 48000};
+  auto options = std::make_unique<AudioClassifierOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kModelWithMetadata);
+  options->classifier_options.max_results = 1;
+  options->classifier_options.score_threshold = 0.3f;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioClassifier> audio_classifier,
+                          AudioClassifier::Create(std::move(options)));
+  std::vector<std::vector<AudioClassifierResult>> outputs(2);
+  // Sends 0.5 second blocks, so that windows span several calls.
+  for (int block = 0;; ++block) {
+    std::vector<AudioStreamBlock> audio_blocks;
+    for (int stream = 0; stream < 2; ++stream) {
+      const int block_size = sample_rates[stream] / 2;
+      const int start_col = block * block_size;
+      if (start_col >= audio_buffers[stream].cols()) {
+        continue;
+      }
+      audio_blocks.push_back(
+          {stream,
+           audio_buffers[stream].block(
+               0, start_col, 1,
+               std::min<int>(block_size,
+                             audio_buffers[stream].cols() - start_col)),
+           sample_rates[stream]});
+    }
+    if (audio_blocks.empty()) {
+      break;
+    }
+    MP_ASSERT_OK_AND_ASSIGN(
+        auto results, audio_classifier->ClassifyStreams(audio_blocks));
+    ASSERT_EQ(results.size(), audio_blocks.size());
+    for (int i = 0; i < results.size(); ++i) {
+      for (auto& result : results[i]) {
+        outputs[audio_blocks[i].stream_id].push_back(std::move(result));
+      }
+    }
+  }
+  audio_classifier->CloseStream(0);
+  audio_classifier->CloseStream(1);
+  MP_ASSERT_OK(audio_classifier->Close());
+  for (const auto& stream_outputs : outputs) {
+    // The last chunk, which doesn't fill a window, is not classified.
+    ASSERT_EQ(stream_outputs.size(), 4);
+    std::vector<int64_t> timestamps_ms = {0, 975, 1950, 2925};
+    for (int i = 0; i < stream_outputs.size(); i++) {
+      EXPECT_EQ(stream_outputs[i].timestamp_ms, timestamps_ms[i]);
+      ASSERT_EQ(stream_outputs[i].classifications.size(), 1);
+      ASSERT_EQ(stream_outputs[i].classifications[0].categories.size(), 1);
+      EXPECT_EQ(
+          stream_outputs[i].classifications[0].categories[0].category_name,
+          "Speech");
+      EXPECT_GT(stream_outputs[i].classifications[0].categories[0].score,
+                0.9f);
+    }
+  }
+}
+
+TEST_F(ClassifyStreamsTest, FailsWithAudioStreamMode) {
+  auto options = std::make_unique<AudioClassifierOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kModelWithMetadata);
+  options->running_mode = core::RunningMode::AUDIO_STREAM;
+  options->result_callback = [](absl::StatusOr<AudioClassifierResult>) {};
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AudioClassifier> audio_classifier,
+                          AudioClassifier::Create(std::move(options)));
+  auto results = audio_classifier->ClassifyStreams(
+      {{/*stream_id=*/0, GetAudioData(k16kTestWavFilename), 16000}});
+  EXPECT_EQ(results.status().code(), absl::StatusCode::kFailedPrecondition);
+  MP_ASSERT_OK(audio_classifier->Close());
+}
+
 }  // namespace
 }  // namespace audio_classifier
 }  // namespace audio
@@ -82,6 +82,10 @@ ConvertAudioEmbedderOptionsToProto(AudioEmbedderOptions* options) {
           components::processors::ConvertEmbedderOptionsToProto(
               &(options->embedder_options)));
   options_proto->mutable_embedder_options()->Swap(embedder_options_proto.get());
+  if (options->min_voice_activity_rms_dbfs.has_value()) {
+    options_proto->set_min_voice_activity_rms_dbfs(
+        *options->min_voice_activity_rms_dbfs);
+  }
   return options_proto;
 }
 
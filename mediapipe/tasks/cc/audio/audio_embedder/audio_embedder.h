@@ -17,6 +17,7 @@ limitations under the License.
 #define MEDIAPIPE_TASKS_CC_AUDIO_AUDIO_EMBEDDER_AUDIO_EMBEDDER_H_
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -51,6 +52,14 @@ struct AudioEmbedderOptions {
   //    be specified to receive the embedding results asynchronously.
   core::RunningMode running_mode = core::RunningMode::AUDIO_CLIPS;
 
+  // If set, the audio windows whose root mean square level is below this
+  // level, in dB relative to full scale, are treated as silence and skip the
+  // inference, which saves most of the compute on silent audio. Full scale is
+  // a sample magnitude of 1.0. In the audio clips mode, a skipped window has a
+  // result with no embeddings, so the skipped windows can be counted. In the
+  // audio stream mode, a skipped window has no result.
+  std::optional<float> min_voice_activity_rms_dbfs;
+
   // The user-defined result callback for processing audio stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::AUDIO_STREAM.
@@ -22,18 +22,21 @@ limitations under the License.
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
 #include "mediapipe/calculators/core/constant_side_packet_calculator.pb.h"
+#include "mediapipe/calculators/tensor/audio_activity_calculator.pb.h"
 #include "mediapipe/calculators/tensor/audio_to_tensor_calculator.pb.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
+#include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/tasks/cc/audio/audio_embedder/proto/audio_embedder_graph_options.pb.h"
 #include "mediapipe/tasks/cc/audio/utils/audio_tensor_specs.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/embedding_postprocessing_graph.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedding_postprocessing_graph_options.pb.h"
+#include "mediapipe/tasks/cc/components/utils/gate.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
 #include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
@@ -50,6 +53,7 @@ using ::mediapipe::api2::builder::Graph;
 using ::mediapipe::api2::builder::Source;
 using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
 
+constexpr char kActiveTag[] = "ACTIVE";
 constexpr char kAudioTag[] = "AUDIO";
 constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
 constexpr char kTimestampedEmbeddingsTag[] = "TIMESTAMPED_EMBEDDINGS";
@@ -193,7 +197,19 @@ class AudioEmbedderGraph : public core::ModelTaskGraph {
     // tensors produced by the AudioToTensorCalculator.
     auto& inference = AddInference(
         model_resources, task_options.base_options().acceleration(), graph);
-    audio_to_tensor.Out(kTensorsTag) >> inference.In(kTensorsTag);
+    Source<std::vector<Tensor>> tensors =
+        audio_to_tensor[Output<std::vector<Tensor>>(kTensorsTag)];
+    if (task_options.has_min_voice_activity_rms_dbfs()) {
+      // Skips the inference on the windows without voice activity. The gate
+      // advances the timestamp bound past the skipped windows.
+      auto& audio_activity = graph.AddNode("AudioActivityCalculator");
+      audio_activity.GetOptions<AudioActivityCalculatorOptions>()
+          .set_min_rms_dbfs(task_options.min_voice_activity_rms_dbfs());
+      tensors >> audio_activity.In(kTensorsTag);
+      tensors = components::utils::AllowIf(
+          tensors, audio_activity[Output<bool>(kActiveTag)], graph);
+    }
+    tensors >> inference.In(kTensorsTag);
     // Adds postprocessing calculators and connects its input stream to the
     // inference results.
     auto& postprocessing = graph.AddNode(
@@ -176,6 +176,8 @@ enum class MediaPipeTasksStatus {
   // Task runner's model resources cache service is unavailable or the
   // targeting model resources bundle is not found.
   kRunnerModelResourcesCacheServiceError,
+  // Task runner pool has no idle runner and its request queue is full.
+  kRunnerQueueFullError,
 
   // Task graph error codes.
   kGraphError = 700,
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <deque>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -45,16 +46,27 @@ using ::mediapipe::tasks::components::containers::proto::ClassificationResult;
 //     This stream is optional: if provided then the TIMESTAMPED_CLASSIFICATIONS
 //     output is used for results. Otherwise as no timestamp aggregation is
 //     required the CLASSIFICATIONS output is used for results.
+//     A timestamp without classifications, e.g. because its inference was
+//     skipped, gets a result without classifications.
 //
 // Outputs:
 //   CLASSIFICATIONS - ClassificationResult @Optional
 //     The classification results aggregated by head. Must be connected if the
 //     TIMESTAMPS input is not connected, as it signals that timestamp
-//     aggregation is not required.
+//     aggregation is not required. If the TIMESTAMPS input is connected, the
+//     results are streamed at the timestamps of their classifications, with
+//     timestamp_ms relative to Timestamp(0), rather than buffered until the
+//     TIMESTAMPS packet.
 //   TIMESTAMPED_CLASSIFICATIONS - std::vector<ClassificationResult> @Optional
-//     The classification result aggregated by timestamp, then by head. Must be
-//     connected if the TIMESTAMPS input is connected, as it signals that
-//     timestamp aggregation is required.
+//     The classification result aggregated by timestamp, then by head. Only
+//     available if the TIMESTAMPS input is connected, in which case it or
+//     CLASSIFICATIONS must be connected. Buffers the results of each clip until
+//     its TIMESTAMPS packet.
+//
+// The scores of each result can be pooled over a sliding window of the
+// previous results, see ClassificationAggregationCalculatorOptions. Streaming
+// the pooled results keeps a constant amount of memory however long the
+// stream.
 //
 // Example without timestamp aggregation:
 // node {
@@ -111,10 +123,23 @@ class ClassificationAggregationCalculator : public Node {
  private:
   std::vector<std::string> head_names_;
   bool time_aggregation_enabled_;
+  // Whether the classifications are buffered for the
+  // TIMESTAMPED_CLASSIFICATIONS output.
+  bool buffering_enabled_;
   std::unordered_map<int64_t, std::vector<ClassificationList>>
       cached_classifications_;
+  ClassificationAggregationCalculatorOptions::Pooling pooling_;
+  int pooling_window_size_;
+  // The classification lists of the last results per head, if pooling.
+  std::vector<std::deque<ClassificationList>> pooling_windows_;
 
-  ClassificationResult ConvertToClassificationResult(CalculatorContext* cc);
+  // Adds `classification_lists` to the pooling windows and returns the pooled
+  // classification lists.
+  std::vector<ClassificationList> PoolClassifications(
+      std::vector<ClassificationList> classification_lists);
+  ClassificationResult ConvertToClassificationResult(
+      std::vector<ClassificationList> classification_lists,
+      int64_t timestamp_ms);
   std::vector<ClassificationResult> ConvertToTimestampedClassificationResults(
       CalculatorContext* cc);
 };
@@ -130,55 +155,137 @@ absl::Status ClassificationAggregationCalculator::UpdateContract(
            "size of head names specified in the calculator options";
   }
   if (kTimestampsIn(cc).IsConnected()) {
-    RET_CHECK(kTimestampedClassificationsOut(cc).IsConnected());
+    RET_CHECK(kTimestampedClassificationsOut(cc).IsConnected() ||
+              kClassificationsOut(cc).IsConnected());
   } else {
     RET_CHECK(kClassificationsOut(cc).IsConnected());
   }
+  RET_CHECK_GT(options.pooling_window_size(), 0)
+      << "pooling_window_size must be positive";
   return absl::OkStatus();
 }
 
 absl::Status ClassificationAggregationCalculator::Open(CalculatorContext* cc) {
   time_aggregation_enabled_ = kTimestampsIn(cc).IsConnected();
+  buffering_enabled_ = time_aggregation_enabled_ &&
+                       kTimestampedClassificationsOut(cc).IsConnected();
   const auto& options =
       cc->Options<ClassificationAggregationCalculatorOptions>();
   if (!options.head_names().empty()) {
     head_names_.assign(options.head_names().begin(),
                        options.head_names().end());
   }
+  pooling_ = options.pooling();
+  pooling_window_size_ = options.pooling_window_size();
+  pooling_windows_.resize(kClassificationListIn(cc).Count());
   return absl::OkStatus();
 }
 
 absl::Status ClassificationAggregationCalculator::Process(
     CalculatorContext* cc) {
+  // The classifications are missing at the last timestamp if its inference
+  // was skipped upstream, which leaves its result empty.
   std::vector<ClassificationList> classification_lists;
-  classification_lists.resize(kClassificationListIn(cc).Count());
-  std::transform(
-      kClassificationListIn(cc).begin(), kClassificationListIn(cc).end(),
-      classification_lists.begin(),
-      [](const auto& elem) -> ClassificationList { return elem.Get(); });
-  cached_classifications_[cc->InputTimestamp().Value()] =
-      std::move(classification_lists);
+  if (!kClassificationListIn(cc)[0].IsEmpty()) {
+    classification_lists.resize(kClassificationListIn(cc).Count());
+    std::transform(
+        kClassificationListIn(cc).begin(), kClassificationListIn(cc).end(),
+        classification_lists.begin(),
+        [](const auto& elem) -> ClassificationList { return elem.Get(); });
+    classification_lists = PoolClassifications(std::move(classification_lists));
+  }
   ClassificationResult classification_result;
   if (time_aggregation_enabled_) {
+    if (!classification_lists.empty() &&
+        kClassificationsOut(cc).IsConnected()) {
+      kClassificationsOut(cc).Send(ConvertToClassificationResult(
+          buffering_enabled_ ? classification_lists
+                             : std::move(classification_lists),
+          cc->InputTimestamp().Value() / 1000));
+    }
+    if (buffering_enabled_ && !classification_lists.empty()) {
+      cached_classifications_[cc->InputTimestamp().Value()] =
+          std::move(classification_lists);
+    }
     if (kTimestampsIn(cc).IsEmpty()) {
       return absl::OkStatus();
     }
-    kTimestampedClassificationsOut(cc).Send(
-        ConvertToTimestampedClassificationResults(cc));
+    // The clip ends, so does the pooling.
+    for (auto& window : pooling_windows_) {
+      window.clear();
+    }
+    if (buffering_enabled_) {
+      kTimestampedClassificationsOut(cc).Send(
+          ConvertToTimestampedClassificationResults(cc));
+    }
   } else {
-    kClassificationsOut(cc).Send(ConvertToClassificationResult(cc));
+    kClassificationsOut(cc).Send(ConvertToClassificationResult(
+        std::move(classification_lists), cc->InputTimestamp().Value() / 1000));
   }
   kClassificationResultOut(cc).Send(classification_result);
   RET_CHECK(cached_classifications_.empty());
   return absl::OkStatus();
 }
 
+std::vector<ClassificationList>
+ClassificationAggregationCalculator::PoolClassifications(
+    std::vector<ClassificationList> classification_lists) {
+  if (pooling_ == ClassificationAggregationCalculatorOptions::NO_POOLING) {
+    return classification_lists;
+  }
+  std::vector<ClassificationList> pooled_lists(classification_lists.size());
+  for (int i = 0; i < classification_lists.size(); ++i) {
+    auto& window = pooling_windows_[i];
+    window.push_back(std::move(classification_lists[i]));
+    if (window.size() > pooling_window_size_) {
+      window.pop_front();
+    }
+    // Pools the scores by category index. The categories are visited from the
+    // latest result on, so that they keep their latest labels.
+    std::unordered_map<int, Classification> pooled_by_index;
+    for (auto it = window.rbegin(); it != window.rend(); ++it) {
+      for (const Classification& classification : it->classification()) {
+        auto [pooled_it, inserted] =
+            pooled_by_index.try_emplace(classification.index(), classification);
+        if (inserted) {
+          continue;
+        }
+        Classification& pooled = pooled_it->second;
+        if (pooling_ ==
+            ClassificationAggregationCalculatorOptions::MAX_POOLING) {
+          pooled.set_score(std::max(pooled.score(), classification.score()));
+        } else {
+          pooled.set_score(pooled.score() + classification.score());
+        }
+      }
+    }
+    std::vector<Classification> pooled;
+    pooled.reserve(pooled_by_index.size());
+    for (auto& [index, classification] : pooled_by_index) {
+      if (pooling_ ==
+          ClassificationAggregationCalculatorOptions::MEAN_POOLING) {
+        classification.set_score(classification.score() / window.size());
+      }
+      pooled.push_back(std::move(classification));
+    }
+    // Sorts by decreasing score, like the classifications of each result.
+    std::sort(pooled.begin(), pooled.end(),
+              [](const Classification& a, const Classification& b) {
+                return a.score() > b.score() ||
+                       (a.score() == b.score() && a.index() < b.index());
+              });
+    for (auto& classification : pooled) {
+      *pooled_lists[i].add_classification() = std::move(classification);
+    }
+  }
+  return pooled_lists;
+}
+
 ClassificationResult
 ClassificationAggregationCalculator::ConvertToClassificationResult(
-    CalculatorContext* cc) {
+    std::vector<ClassificationList> classification_lists,
+    int64_t timestamp_ms) {
   ClassificationResult result;
-  auto& classification_lists =
-      cached_classifications_[cc->InputTimestamp().Value()];
   for (int i = 0; i < classification_lists.size(); ++i) {
     auto classifications = result.add_classifications();
     classifications->set_head_index(i);
@@ -188,8 +295,7 @@ ClassificationAggregationCalculator::ConvertToClassificationResult(
     *classifications->mutable_classification_list() =
         std::move(classification_lists[i]);
   }
-  result.set_timestamp_ms(cc->InputTimestamp().Value() / 1000);
-  cached_classifications_.erase(cc->InputTimestamp().Value());
+  result.set_timestamp_ms(timestamp_ms);
   return result;
 }
 
@@ -200,20 +306,10 @@ ClassificationAggregationCalculator::ConvertToTimestampedClassificationResults(
   std::vector<ClassificationResult> results;
   results.reserve(timestamps.size());
   for (const auto& timestamp : timestamps) {
-    ClassificationResult result;
-    result.set_timestamp_ms((timestamp.Value() - timestamps[0].Value()) / 1000);
-    auto& classification_lists = cached_classifications_[timestamp.Value()];
-    for (int i = 0; i < classification_lists.size(); ++i) {
-      auto classifications = result.add_classifications();
-      classifications->set_head_index(i);
-      if (!head_names_.empty()) {
-        classifications->set_head_name(head_names_[i]);
-      }
-      *classifications->mutable_classification_list() =
-          std::move(classification_lists[i]);
-    }
+    results.push_back(ConvertToClassificationResult(
+        std::move(cached_classifications_[timestamp.Value()]),
+        (timestamp.Value() - timestamps[0].Value()) / 1000));
     cached_classifications_.erase(timestamp.Value());
-    results.push_back(std::move(result));
   }
   return results;
 }
@@ -14,11 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -66,17 +69,34 @@ ClassificationList MakeClassificationList(int class_index) {
       class_index));
 }
 
+ClassificationList MakeScoredClassificationList(
+    std::vector<std::pair<int, float>> scores) {
+  ClassificationList list;
+  for (const auto& [index, score] : scores) {
+    auto* classification = list.add_classification();
+    classification->set_index(index);
+    classification->set_score(score);
+  }
+  return list;
+}
+
 class ClassificationAggregationCalculatorTest : public tflite::testing::Test {
  protected:
+  // Builds the graph. If `connect_timestamps` is true, the results are output
+  // on TIMESTAMPED_CLASSIFICATIONS, or streamed on CLASSIFICATIONS if
+  // `stream_results` is true.
   absl::StatusOr<OutputStreamPoller> BuildGraph(
-      bool connect_timestamps = false) {
+      bool connect_timestamps = false, absl::string_view extra_options = "",
+      bool stream_results = false) {
     Graph graph;
     auto& calculator = graph.AddNode("ClassificationAggregationCalculator");
     calculator
         .GetOptions<mediapipe::ClassificationAggregationCalculatorOptions>() =
         ParseTextProtoOrDie<
             mediapipe::ClassificationAggregationCalculatorOptions>(
-            R"pb(head_names: "foo" head_names: "bar")pb");
+            absl::StrCat(R"pb(head_names: "foo" head_names: "bar" )pb",
+                         extra_options));
+    const bool output_timestamped = connect_timestamps && !stream_results;
     graph[Input<ClassificationList>(kClassificationInput0Tag)].SetName(
         kClassificationInput0Name) >>
         calculator.In(absl::StrFormat("%s:%d", kClassificationsTag, 0));
@@ -87,6 +107,8 @@ class ClassificationAggregationCalculatorTest : public tflite::testing::Test {
       graph[Input<std::vector<Timestamp>>(kTimestampsTag)].SetName(
           kTimestampsName) >>
           calculator.In(kTimestampsTag);
+    }
+    if (output_timestamped) {
       calculator.Out(kTimestampedClassificationsTag)
               .SetName(kTimestampedClassificationsName) >>
           graph[Output<std::vector<ClassificationResult>>(
@@ -97,7 +119,7 @@ class ClassificationAggregationCalculatorTest : public tflite::testing::Test {
     }
 
     MP_RETURN_IF_ERROR(calculator_graph_.Initialize(graph.GetConfig()));
-    if (connect_timestamps) {
+    if (output_timestamped) {
       ASSIGN_OR_RETURN(auto poller, calculator_graph_.AddOutputStreamPoller(
                                         kTimestampedClassificationsName));
       MP_RETURN_IF_ERROR(calculator_graph_.StartRun(/*extra_side_packets=*/{}));
@@ -131,6 +153,20 @@ class ClassificationAggregationCalculatorTest : public tflite::testing::Test {
     return absl::OkStatus();
   }
 
+  template <typename T>
+  absl::StatusOr<std::vector<T>> GetResults(OutputStreamPoller& poller) {
+    MP_RETURN_IF_ERROR(calculator_graph_.WaitUntilIdle());
+    MP_RETURN_IF_ERROR(calculator_graph_.CloseAllInputStreams());
+
+    std::vector<T> results;
+    Packet packet;
+    while (poller.Next(&packet)) {
+      results.push_back(packet.Get<T>());
+    }
+    MP_RETURN_IF_ERROR(calculator_graph_.WaitUntilDone());
+    return results;
+  }
+
   template <typename T>
   absl::StatusOr<T> GetResult(OutputStreamPoller& poller) {
     MP_RETURN_IF_ERROR(calculator_graph_.WaitUntilIdle());
@@ -209,5 +245,118 @@ TEST_F(ClassificationAggregationCalculatorTest, SucceedsWithAggregation) {
                          )pb")}));
 }
 
+TEST_F(ClassificationAggregationCalculatorTest, SucceedsWithMeanPooling) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto poller,
+      BuildGraph(/*connect_timestamps=*/false,
+                 /*extra_options=*/"pooling: MEAN_POOLING "
+                                   "pooling_window_size: 2"));
+  MP_ASSERT_OK(Send({MakeScoredClassificationList({{0, 0.75}, {1, 0.25}}),
+                     MakeScoredClassificationList({{2, 0.5}})}));
+  MP_ASSERT_OK(Send({MakeScoredClassificationList({{1, 0.5}}),
+                     MakeScoredClassificationList({{2, 0.25}})},
+                    /*timestamp=*/1000));
+  MP_ASSERT_OK(Send({MakeScoredClassificationList({{1, 0.25}}),
+                     MakeScoredClassificationList({{3, 0.75}})},
+                    /*timestamp=*/2000));
+  MP_ASSERT_OK_AND_ASSIGN(auto results,
+                          GetResults<ClassificationResult>(poller));
+
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_THAT(results[1], EqualsProto(ParseTextProtoOrDie<ClassificationResult>(
+                              R"pb(timestamp_ms: 1,
+                                   classifications {
+                                     head_index: 0
+                                     head_name: "foo"
+                                     classification_list {
+                                       classification { index: 0 score: 0.375 }
+                                       classification { index: 1 score: 0.375 }
+                                     }
+                                   }
+                                   classifications {
+                                     head_index: 1
+                                     head_name: "bar"
+                                     classification_list {
+                                       classification { index: 2 score: 0.375 }
+                                     }
+                                   })pb")));
+  // The first result is out of the window.
+  EXPECT_THAT(results[2], EqualsProto(ParseTextProtoOrDie<ClassificationResult>(
+                              R"pb(timestamp_ms: 2,
+                                   classifications {
+                                     head_index: 0
+                                     head_name: "foo"
+                                     classification_list {
+                                       classification { index: 1 score: 0.375 }
+                                     }
+                                   }
+                                   classifications {
+                                     head_index: 1
+                                     head_name: "bar"
+                                     classification_list {
+                                       classification { index: 3 score: 0.375 }
+                                       classification { index: 2 score: 0.125 }
+                                     }
+                                   })pb")));
+}
+
+TEST_F(ClassificationAggregationCalculatorTest, SucceedsWithMaxPooling) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto poller,
+      BuildGraph(/*connect_timestamps=*/false,
+                 /*extra_options=*/"pooling: MAX_POOLING "
+                                   "pooling_window_size: 3"));
+  MP_ASSERT_OK(Send({MakeScoredClassificationList({{0, 0.75}}),
+                     MakeScoredClassificationList({{2, 0.5}})}));
+  MP_ASSERT_OK(Send({MakeScoredClassificationList({{0, 0.125}, {1, 0.5}}),
+                     MakeScoredClassificationList({{2, 0.75}})},
+                    /*timestamp=*/1000));
+  MP_ASSERT_OK_AND_ASSIGN(auto results,
+                          GetResults<ClassificationResult>(poller));
+
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_THAT(results[1], EqualsProto(ParseTextProtoOrDie<ClassificationResult>(
+                              R"pb(timestamp_ms: 1,
+                                   classifications {
+                                     head_index: 0
+                                     head_name: "foo"
+                                     classification_list {
+                                       classification { index: 0 score: 0.75 }
+                                       classification { index: 1 score: 0.5 }
+                                     }
+                                   }
+                                   classifications {
+                                     head_index: 1
+                                     head_name: "bar"
+                                     classification_list {
+                                       classification { index: 2 score: 0.75 }
+                                     }
+                                   })pb")));
+}
+
+TEST_F(ClassificationAggregationCalculatorTest,
+       StreamsResultsWithAggregationTimestamps) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto poller, BuildGraph(/*connect_timestamps=*/true, /*extra_options=*/"",
+                              /*stream_results=*/true));
+  MP_ASSERT_OK(Send({MakeClassificationList(0), MakeClassificationList(1)}));
+  MP_ASSERT_OK(Send(
+      {MakeClassificationList(2), MakeClassificationList(3)},
+      /*timestamp=*/1000,
+      /*aggregation_timestamps=*/std::optional<std::vector<int>>({0, 1000})));
+  MP_ASSERT_OK_AND_ASSIGN(auto results,
+                          GetResults<ClassificationResult>(poller));
+
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0].timestamp_ms(), 0);
+  EXPECT_EQ(results[0].classifications(0).classification_list()
+                .classification(0).index(),
+            0);
+  EXPECT_EQ(results[1].timestamp_ms(), 1);
+  EXPECT_EQ(results[1].classifications(1).classification_list()
+                .classification(0).index(),
+            3);
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -0,0 +1,136 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/tasks/cc/components/calculators/detector_scheduling_calculator.pb.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Decides whether the detector of a tracking pipeline, e.g. the palm detector
+// of a hand landmarker, can be skipped at the current frame given the object
+// rects tracked from the previous frame. The detector is skipped when
+// `max_num_objects` objects are tracked. While fewer objects are tracked, the
+// detector runs once every `detector_interval` frames, and at the next frame
+// when an object is lost or moves fast. This reduces the average cost per frame
+// of streams where `max_num_objects` objects are rarely visible.
+//
+// Inputs:
+//   RECTS - std::vector<NormalizedRect>
+//     The object rects tracked from the previous frame. An empty packet means
+//     that no object is tracked.
+//
+// Outputs:
+//   SKIP_DETECTOR - bool
+//     Whether to skip the detector at the current frame.
+//
+// Example:
+// node {
+//   calculator: "DetectorSchedulingCalculator"
+//   input_stream: "RECTS:prev_hand_rects"
+//   output_stream: "SKIP_DETECTOR:skip_hand_detector"
+//   options {
+//     [mediapipe.DetectorSchedulingCalculatorOptions.ext] {
+//       max_num_objects: 2
+//       detector_interval: 5
+//     }
+//   }
+// }
+class DetectorSchedulingCalculator : public Node {
+ public:
+  static constexpr Input<std::vector<NormalizedRect>> kRectsIn{"RECTS"};
+  static constexpr Output<bool> kSkipDetectorOut{"SKIP_DETECTOR"};
+  MEDIAPIPE_NODE_CONTRACT(kRectsIn, kSkipDetectorOut);
+
+  static absl::Status UpdateContract(CalculatorContract* cc) {
+    // Runs on empty RECTS packets, which mean that no object is tracked.
+    cc->SetProcessTimestampBounds(true);
+    cc->SetTimestampOffset(0);
+    return absl::OkStatus();
+  }
+
+  absl::Status Open(CalculatorContext* cc) override {
+    options_ = cc->Options<DetectorSchedulingCalculatorOptions>();
+    RET_CHECK_GT(options_.max_num_objects(), 0);
+    RET_CHECK_GT(options_.detector_interval(), 0);
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    std::vector<NormalizedRect> rects;
+    if (!kRectsIn(cc).IsEmpty()) {
+      rects = *kRectsIn(cc);
+    }
+    const int num_rects = rects.size();
+    const int num_prev_rects = prev_rects_.size();
+    bool skip_detector;
+    if (num_rects >= options_.max_num_objects()) {
+      skip_detector = true;
+    } else if (num_rects == 0) {
+      skip_detector = false;
+    } else if (options_.detect_on_tracking_loss() &&
+               num_rects < num_prev_rects) {
+      skip_detector = false;
+    } else if (options_.max_tracked_motion() > 0 && HasFastMotion(rects)) {
+      skip_detector = false;
+    } else {
+      skip_detector = frames_since_detector_ + 1 < options_.detector_interval();
+    }
+    frames_since_detector_ = skip_detector ? frames_since_detector_ + 1 : 0;
+    prev_rects_ = std::move(rects);
+    kSkipDetectorOut(cc).Send(skip_detector);
+    return absl::OkStatus();
+  }
+
+ private:
+  // Returns whether a rect moved by more than max_tracked_motion of its size
+  // from the closest rect of the previous frame.
+  bool HasFastMotion(const std::vector<NormalizedRect>& rects) const {
+    for (const auto& rect : rects) {
+      float min_distance = std::numeric_limits<float>::infinity();
+      for (const auto& prev_rect : prev_rects_) {
+        min_distance =
+            std::min(min_distance,
+                     std::hypot(rect.x_center() - prev_rect.x_center(),
+                                rect.y_center() - prev_rect.y_center()));
+      }
+      const float size = std::max(rect.width(), rect.height());
+      if (min_distance > options_.max_tracked_motion() * size) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  DetectorSchedulingCalculatorOptions options_;
+  std::vector<NormalizedRect> prev_rects_;
+  int frames_since_detector_ = 0;
+};
+
+MEDIAPIPE_REGISTER_NODE(DetectorSchedulingCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -0,0 +1,119 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using ::mediapipe::ParseTextProtoOrDie;
+using ::testing::ElementsAre;
+using Node = ::mediapipe::CalculatorGraphConfig::Node;
+
+NormalizedRect MakeRect(float x_center, float y_center) {
+  NormalizedRect rect;
+  rect.set_x_center(x_center);
+  rect.set_y_center(y_center);
+  rect.set_width(0.2f);
+  rect.set_height(0.2f);
+  return rect;
+}
+
+// Runs the calculator on a sequence of tracked rects and returns the
+// SKIP_DETECTOR outputs.
+std::vector<bool> RunScheduling(
+    const std::string& options,
+    const std::vector<std::vector<NormalizedRect>>& rects_per_frame) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(absl::StrFormat(
+      R"pb(
+        calculator: "DetectorSchedulingCalculator"
+        input_stream: "RECTS:rects"
+        output_stream: "SKIP_DETECTOR:skip_detector"
+        options {
+          [mediapipe.DetectorSchedulingCalculatorOptions.ext] { %s }
+        }
+      )pb",
+      options)));
+  for (int i = 0; i < rects_per_frame.size(); ++i) {
+    runner.MutableInputs()->Tag("RECTS").packets.push_back(
+        MakePacket<std::vector<NormalizedRect>>(rects_per_frame[i])
+            .At(Timestamp(i)));
+  }
+  MP_EXPECT_OK(runner.Run());
+  std::vector<bool> skip_detector;
+  for (const Packet& packet : runner.Outputs().Tag("SKIP_DETECTOR").packets) {
+    skip_detector.push_back(packet.Get<bool>());
+  }
+  return skip_detector;
+}
+
+TEST(DetectorSchedulingCalculatorTest, RunsDetectorUntilEnoughObjects) {
+  EXPECT_THAT(RunScheduling("max_num_objects: 2",
+                            {{},
+                             {MakeRect(0.2f, 0.2f)},
+                             {MakeRect(0.2f, 0.2f), MakeRect(0.8f, 0.8f)}}),
+              ElementsAre(false, false, true));
+}
+
+TEST(DetectorSchedulingCalculatorTest, RunsDetectorEveryInterval) {
+  const NormalizedRect rect = MakeRect(0.5f, 0.5f);
+  EXPECT_THAT(RunScheduling("max_num_objects: 2 detector_interval: 3",
+                            {{}, {rect}, {rect}, {rect}, {rect}, {rect}}),
+              ElementsAre(false, true, true, false, true, true));
+}
+
+TEST(DetectorSchedulingCalculatorTest, RunsDetectorOnTrackingLoss) {
+  EXPECT_THAT(
+      RunScheduling("max_num_objects: 3 detector_interval: 10",
+                    {{},
+                     {MakeRect(0.2f, 0.2f), MakeRect(0.8f, 0.8f)},
+                     {MakeRect(0.2f, 0.2f)},
+                     {MakeRect(0.2f, 0.2f)}}),
+      ElementsAre(false, true, false, true));
+}
+
+TEST(DetectorSchedulingCalculatorTest, IgnoresTrackingLossIfDisabled) {
+  EXPECT_THAT(RunScheduling("max_num_objects: 3 detector_interval: 10 "
+                            "detect_on_tracking_loss: false",
+                            {{},
+                             {MakeRect(0.2f, 0.2f), MakeRect(0.8f, 0.8f)},
+                             {MakeRect(0.2f, 0.2f)}}),
+              ElementsAre(false, true, true));
+}
+
+TEST(DetectorSchedulingCalculatorTest, RunsDetectorOnFastMotion) {
+  // The rect size is 0.2, so a motion of 0.05 is 25% of the size.
+  EXPECT_THAT(RunScheduling("max_num_objects: 2 detector_interval: 10 "
+                            "max_tracked_motion: 0.1",
+                            {{},
+                             {MakeRect(0.5f, 0.5f)},
+                             {MakeRect(0.51f, 0.5f)},
+                             {MakeRect(0.56f, 0.5f)},
+                             {MakeRect(0.57f, 0.5f)}}),
+              ElementsAre(false, true, true, false, true));
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -40,6 +40,8 @@ using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
 //     will contain the aggregated results. Otherwise as no timestamp
 //     aggregation is required the EMBEDDINGS output is used to pass the inputs
 //     EmbeddingResults unchanged.
+//     A timestamp without an EmbeddingResult, e.g. because its inference was
+//     skipped, gets a result without embeddings.
 //
 // Outputs:
 //   EMBEDDINGS: EmbeddingResult @Optional
@@ -103,8 +105,12 @@ absl::Status EmbeddingAggregationCalculator::Open(CalculatorContext* cc) {
 
 absl::Status EmbeddingAggregationCalculator::Process(CalculatorContext* cc) {
   if (time_aggregation_enabled_) {
-    cached_embeddings_[cc->InputTimestamp().Value()] =
-        std::move(*kEmbeddingsIn(cc));
+    // The embeddings are missing at the last timestamp if its inference was
+    // skipped upstream, which leaves its result empty.
+    if (!kEmbeddingsIn(cc).IsEmpty()) {
+      cached_embeddings_[cc->InputTimestamp().Value()] =
+          std::move(*kEmbeddingsIn(cc));
+    }
     if (kTimestampsIn(cc).IsEmpty()) {
       return absl::OkStatus();
     }
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <vector>
 
+#include "mediapipe/framework/formats/detection.pb.h"
 #include "mediapipe/tasks/cc/components/containers/proto/classifications.pb.h"
 
 // Specialized EndLoopCalculator for Tasks specific types.
@@ -27,4 +28,8 @@ typedef EndLoopCalculator<
     EndLoopClassificationResultCalculator;
 REGISTER_CALCULATOR(::mediapipe::tasks::EndLoopClassificationResultCalculator);
 
+typedef EndLoopCalculator<std::vector<std::vector<::mediapipe::Detection>>>
+    EndLoopDetectionVectorCalculator;
+REGISTER_CALCULATOR(::mediapipe::tasks::EndLoopDetectionVectorCalculator);
+
 }  // namespace mediapipe::tasks
@@ -0,0 +1,64 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Concatenates the detections collected by an EndLoopDetectionVectorCalculator,
+// e.g. the detections of each tile of an image, into a single vector.
+//
+// Inputs:
+//   std::vector<std::vector<Detection>>
+//     The vectors of detections to concatenate.
+//
+// Outputs:
+//   std::vector<Detection>
+//     The concatenated detections, in input order.
+//
+// Example:
+// node {
+//   calculator: "FlattenDetectionVectorsCalculator"
+//   input_stream: "detections_per_tile"
+//   output_stream: "detections"
+// }
+class FlattenDetectionVectorsCalculator : public Node {
+ public:
+  static constexpr Input<std::vector<std::vector<Detection>>> kIn{""};
+  static constexpr Output<std::vector<Detection>> kOut{""};
+  MEDIAPIPE_NODE_CONTRACT(kIn, kOut);
+
+  absl::Status Process(CalculatorContext* cc) override {
+    std::vector<Detection> detections;
+    for (const auto& item : *kIn(cc)) {
+      detections.insert(detections.end(), item.begin(), item.end());
+    }
+    kOut(cc).Send(std::move(detections));
+    return absl::OkStatus();
+  }
+};
+
+MEDIAPIPE_REGISTER_NODE(FlattenDetectionVectorsCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -35,6 +37,8 @@ using ::absl::StatusCode;
 using ::mediapipe::tasks::CreateStatusWithPayload;
 using ::mediapipe::tasks::MediaPipeTasksStatus;
 using ::mediapipe::tasks::ScoreCalibrationCalculatorOptions;
+using ScoreTransformation =
+    ::mediapipe::tasks::ScoreCalibrationCalculatorOptions::ScoreTransformation;
 
 namespace {
 // Used to prevent log(<=0.0) in ClampedLog() calls.
@@ -54,6 +58,20 @@ float ClampedLog(float x, float threshold) {
   }
   return std::log(static_cast<double>(x));
 }
+
+// Applies the score transformation of the provided type.
+template <ScoreTransformation kTransformation>
+float TransformScore(float x) {
+  switch (kTransformation) {
+    case ScoreCalibrationCalculatorOptions::LOG:
+      return ClampedLog(x, kLogScoreMinimum);
+    case ScoreCalibrationCalculatorOptions::INVERSE_LOGISTIC:
+      return (ClampedLog(x, kLogScoreMinimum) -
+              ClampedLog(1.0 - x, kLogScoreMinimum));
+    default:
+      return x;
+  }
+}
 }  // namespace
 
 // Applies score calibration to a tensor of score predictions, typically applied
@@ -90,25 +108,50 @@ class ScoreCalibrationCalculator : public Node {
   absl::Status Process(CalculatorContext* cc) override;
 
  private:
-  ScoreCalibrationCalculatorOptions options_;
-  std::function<float(float)> score_transformation_;
+  // The parameters of a sigmoid from the options, unpacked once in Open() so
+  // that the per-score loop reads plain floats instead of proto fields.
+  struct Sigmoid {
+    // Whether scale, slope and offset are all set.
+    bool is_set;
+    float scale;
+    float slope;
+    float offset;
+    // -infinity if the sigmoid has no min_score.
+    float min_score;
+  };
+
+  std::vector<Sigmoid> sigmoids_;
+  float default_score_ = 0.0f;
+  ScoreTransformation score_transformation_;
 
-  // Computes the calibrated score for the provided index. Does not check for
-  // out-of-bounds index.
-  float ComputeCalibratedScore(int index, float score);
-  // Same as above, but does check for out-of-bounds index.
-  absl::StatusOr<float> SafeComputeCalibratedScore(int index, float score);
+  // Calibrates `num_scores` scores, using sigmoid indices[i] for scores[i], or
+  // sigmoid i if `indices` is null, with the transformation resolved at
+  // compile time. Indices must have been checked to be in bounds.
+  template <ScoreTransformation kTransformation>
+  void CalibrateScores(const float* scores, const float* indices,
+                       int num_scores, float* calibrated_scores) const;
+  // Dispatches the above on the score transformation.
+  void CalibrateScores(const float* scores, const float* indices,
+                       int num_scores, float* calibrated_scores) const;
+  // Computes the calibrated score of the already transformed score with the
+  // provided sigmoid.
+  static float ComputeCalibratedScore(const Sigmoid& sigmoid,
+                                      float transformed_score);
+  // Checks that the provided sigmoid index is in bounds.
+  absl::Status CheckSigmoidIndex(int index) const;
 };
 
 absl::Status ScoreCalibrationCalculator::Open(CalculatorContext* cc) {
-  options_ = cc->Options<ScoreCalibrationCalculatorOptions>();
+  const auto& options = cc->Options<ScoreCalibrationCalculatorOptions>();
   // Sanity checks.
-  if (options_.sigmoids_size() == 0) {
+  if (options.sigmoids_size() == 0) {
     return CreateStatusWithPayload(StatusCode::kInvalidArgument,
                                    "Expected at least one sigmoid, found none.",
                                    MediaPipeTasksStatus::kInvalidArgumentError);
   }
-  for (const auto& sigmoid : options_.sigmoids()) {
+  sigmoids_.clear();
+  sigmoids_.reserve(options.sigmoids_size());
+  for (const auto& sigmoid : options.sigmoids()) {
     if (sigmoid.has_scale() && sigmoid.scale() < 0.0) {
       return CreateStatusWithPayload(
           StatusCode::kInvalidArgument,
@@ -117,22 +160,19 @@ absl::Status ScoreCalibrationCalculator::Open(CalculatorContext* cc) {
                           sigmoid.scale()),
           MediaPipeTasksStatus::kInvalidArgumentError);
     }
+    sigmoids_.push_back(
+        {sigmoid.has_scale() && sigmoid.has_offset() && sigmoid.has_slope(),
+         sigmoid.scale(), sigmoid.slope(), sigmoid.offset(),
+         sigmoid.has_min_score() ? sigmoid.min_score()
+                                 : -std::numeric_limits<float>::infinity()});
   }
-  // Set score transformation function once and for all.
-  switch (options_.score_transformation()) {
-    case tasks::ScoreCalibrationCalculatorOptions::IDENTITY:
-      score_transformation_ = [](float x) { return x; };
-      break;
-    case tasks::ScoreCalibrationCalculatorOptions::LOG:
-      score_transformation_ = [](float x) {
-        return ClampedLog(x, kLogScoreMinimum);
-      };
-      break;
-    case tasks::ScoreCalibrationCalculatorOptions::INVERSE_LOGISTIC:
-      score_transformation_ = [](float x) {
-        return (ClampedLog(x, kLogScoreMinimum) -
-                ClampedLog(1.0 - x, kLogScoreMinimum));
-      };
+  default_score_ = options.default_score();
+  // Set score transformation once and for all.
+  score_transformation_ = options.score_transformation();
+  switch (score_transformation_) {
+    case ScoreCalibrationCalculatorOptions::IDENTITY:
+    case ScoreCalibrationCalculatorOptions::LOG:
+    case ScoreCalibrationCalculatorOptions::INVERSE_LOGISTIC:
       break;
     default:
       return CreateStatusWithPayload(
@@ -140,7 +180,7 @@ absl::Status ScoreCalibrationCalculator::Open(CalculatorContext* cc) {
           absl::StrFormat(
               "Unsupported ScoreTransformation type: %s",
               ScoreCalibrationCalculatorOptions::ScoreTransformation_Name(
-                  options_.score_transformation())),
+                  score_transformation_)),
           MediaPipeTasksStatus::kInvalidArgumentError);
   }
   return absl::OkStatus();
@@ -175,82 +215,104 @@ absl::Status ScoreCalibrationCalculator::Process(CalculatorContext* cc) {
     }
     auto indices_view = indices.GetCpuReadView();
     const float* raw_indices = indices_view.buffer<float>();
+    // Check that the externally provided indices are not out-of-bounds before
+    // calibrating.
     for (int i = 0; i < num_scores; ++i) {
-      // Use the "safe" flavor as we need to check that the externally provided
-      // indices are not out-of-bounds.
-      ASSIGN_OR_RETURN(raw_calibrated_scores[i],
-                       SafeComputeCalibratedScore(
-                           static_cast<int>(raw_indices[i]), raw_scores[i]));
+      MP_RETURN_IF_ERROR(CheckSigmoidIndex(static_cast<int>(raw_indices[i])));
     }
+    CalibrateScores(raw_scores, raw_indices, num_scores,
+                    raw_calibrated_scores);
   } else {
-    if (num_scores != options_.sigmoids_size()) {
+    if (num_scores != static_cast<int>(sigmoids_.size())) {
       return CreateStatusWithPayload(
           StatusCode::kInvalidArgument,
           absl::StrFormat("Mismatch between number of sigmoids (%d) and number "
                           "of elements in the input scores tensor (%d).",
-                          options_.sigmoids_size(), num_scores),
+                          sigmoids_.size(), num_scores),
           MediaPipeTasksStatus::kMetadataInconsistencyError);
     }
-    for (int i = 0; i < num_scores; ++i) {
-      // Use the "unsafe" flavor as we have already checked for out-of-bounds
-      // issues.
-      raw_calibrated_scores[i] = ComputeCalibratedScore(i, raw_scores[i]);
-    }
+    CalibrateScores(raw_scores, /*indices=*/nullptr, num_scores,
+                    raw_calibrated_scores);
   }
   kScoresOut(cc).Send(std::move(output_tensors));
   return absl::OkStatus();
 }
 
-float ScoreCalibrationCalculator::ComputeCalibratedScore(int index,
-                                                         float score) {
-  const auto& sigmoid = options_.sigmoids(index);
+template <ScoreTransformation kTransformation>
+void ScoreCalibrationCalculator::CalibrateScores(
+    const float* scores, const float* indices, int num_scores,
+    float* calibrated_scores) const {
+  for (int i = 0; i < num_scores; ++i) {
+    const Sigmoid& sigmoid =
+        sigmoids_[indices ? static_cast<int>(indices[i]) : i];
+    const float score = scores[i];
+    if (!sigmoid.is_set || score < sigmoid.min_score) {
+      calibrated_scores[i] = default_score_;
+      continue;
+    }
+    calibrated_scores[i] = ComputeCalibratedScore(
+        sigmoid, TransformScore<kTransformation>(score));
+  }
+}
 
-  bool is_empty =
-      !sigmoid.has_scale() || !sigmoid.has_offset() || !sigmoid.has_slope();
-  bool is_below_min_score =
-      sigmoid.has_min_score() && score < sigmoid.min_score();
-  if (is_empty || is_below_min_score) {
-    return options_.default_score();
+void ScoreCalibrationCalculator::CalibrateScores(
+    const float* scores, const float* indices, int num_scores,
+    float* calibrated_scores) const {
+  switch (score_transformation_) {
+    case ScoreCalibrationCalculatorOptions::LOG:
+      CalibrateScores<ScoreCalibrationCalculatorOptions::LOG>(
+          scores, indices, num_scores, calibrated_scores);
+      break;
+    case ScoreCalibrationCalculatorOptions::INVERSE_LOGISTIC:
+      CalibrateScores<ScoreCalibrationCalculatorOptions::INVERSE_LOGISTIC>(
+          scores, indices, num_scores, calibrated_scores);
+      break;
+    default:
+      CalibrateScores<ScoreCalibrationCalculatorOptions::IDENTITY>(
+          scores, indices, num_scores, calibrated_scores);
+      break;
   }
+}
 
-  float transformed_score = score_transformation_(score);
+/* static */
+float ScoreCalibrationCalculator::ComputeCalibratedScore(
+    const Sigmoid& sigmoid, float transformed_score) {
   float scale_shifted_score =
-      transformed_score * sigmoid.slope() + sigmoid.offset();
+      transformed_score * sigmoid.slope + sigmoid.offset;
   // For numerical stability use 1 / (1+exp(-x)) when scale_shifted_score >= 0
   // and exp(x) / (1+exp(x)) when scale_shifted_score < 0.
   float calibrated_score;
   if (scale_shifted_score >= 0.0) {
     calibrated_score =
-        sigmoid.scale() /
+        sigmoid.scale /
         (1.0 + std::exp(static_cast<double>(-scale_shifted_score)));
   } else {
     float score_exp = std::exp(static_cast<double>(scale_shifted_score));
-    calibrated_score = sigmoid.scale() * score_exp / (1.0 + score_exp);
+    calibrated_score = sigmoid.scale * score_exp / (1.0 + score_exp);
   }
   // Scale is non-negative (checked in SigmoidFromLabelAndLine),
   // thus calibrated_score should be in the range of [0, scale]. However, due to
   // numberical stability issue, it may fall out of the boundary. Cap the value
   // to [0, scale] instead.
-  return std::max(std::min(calibrated_score, sigmoid.scale()), 0.0f);
+  return std::max(std::min(calibrated_score, sigmoid.scale), 0.0f);
 }
 
-absl::StatusOr<float> ScoreCalibrationCalculator::SafeComputeCalibratedScore(
-    int index, float score) {
+absl::Status ScoreCalibrationCalculator::CheckSigmoidIndex(int index) const {
   if (index < 0) {
     return CreateStatusWithPayload(
         StatusCode::kInvalidArgument,
         absl::StrFormat("Expected positive indices, found %d.", index),
         MediaPipeTasksStatus::kInvalidArgumentError);
   }
-  if (index > options_.sigmoids_size()) {
+  if (index >= static_cast<int>(sigmoids_.size())) {
     return CreateStatusWithPayload(
         StatusCode::kInvalidArgument,
         absl::StrFormat("Unable to get score calibration parameters for index "
                         "%d : only %d sigmoids were provided.",
-                        index, options_.sigmoids_size()),
+                        index, sigmoids_.size()),
         MediaPipeTasksStatus::kMetadataInconsistencyError);
   }
-  return ComputeCalibratedScore(index, score);
+  return absl::OkStatus();
 }
 
 MEDIAPIPE_REGISTER_NODE(ScoreCalibrationCalculator);
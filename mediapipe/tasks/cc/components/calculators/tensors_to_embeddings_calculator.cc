@@ -15,6 +15,8 @@
 #include <math.h>
 
 #include <algorithm>
+#include <cstring>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
@@ -51,6 +53,32 @@ float GetInverseL2Norm(const float* values, int size) {
   return inv_l2_norm;
 }
 
+// Writes the `size` values of `input` multiplied by `scale` to `output`.
+void ScaleValues(const float* input, int size, float scale, float* output) {
+  if (scale == 1.0f) {
+    std::memcpy(output, input, size * sizeof(float));
+    return;
+  }
+  for (int i = 0; i < size; ++i) {
+    output[i] = input[i] * scale;
+  }
+}
+
+// Writes the `size` values of `input` multiplied by `scale` to `output` as
+// scalar-quantized values, in a single pass.
+void ScaleAndQuantizeValues(const float* input, int size, float scale,
+                            char* output) {
+  // Multiplying by 128 is exact, so folding it into the scale doesn't change
+  // the results. Clamping before the conversion keeps the loop branch-free.
+  const float quantization_scale = scale * 128.0f;
+  for (int i = 0; i < size; ++i) {
+    const float quantized =
+        std::min(std::max(roundf(input[i] * quantization_scale), -128.0f),
+                 127.0f);
+    output[i] = static_cast<char>(static_cast<int>(quantized));
+  }
+}
+
 }  // namespace
 
 // Converts tensors into an EmbeddingResult object, performing optional
@@ -123,7 +151,7 @@ absl::Status TensorsToEmbeddingsCalculator::Process(CalculatorContext* cc) {
       FillFloatEmbedding(tensor, embedding);
     }
   }
-  kEmbeddingsOut(cc).Send(result);
+  kEmbeddingsOut(cc).Send(std::move(result));
   return absl::OkStatus();
 }
 
@@ -134,10 +162,9 @@ void TensorsToEmbeddingsCalculator::FillFloatEmbedding(const Tensor& tensor,
   const float* tensor_buffer = tensor_view.buffer<float>();
   float inv_l2_norm =
       l2_normalize_ ? GetInverseL2Norm(tensor_buffer, size) : 1.0f;
-  auto* float_embedding = embedding->mutable_float_embedding();
-  for (int i = 0; i < size; ++i) {
-    float_embedding->add_values(tensor_buffer[i] * inv_l2_norm);
-  }
+  auto* values = embedding->mutable_float_embedding()->mutable_values();
+  values->Resize(size, 0.0f);
+  ScaleValues(tensor_buffer, size, inv_l2_norm, values->mutable_data());
 }
 
 void TensorsToEmbeddingsCalculator::FillQuantizedEmbedding(
@@ -149,15 +176,7 @@ void TensorsToEmbeddingsCalculator::FillQuantizedEmbedding(
       l2_normalize_ ? GetInverseL2Norm(tensor_buffer, size) : 1.0f;
   auto* values = embedding->mutable_quantized_embedding()->mutable_values();
   values->resize(size);
-  for (int i = 0; i < size; ++i) {
-    // Normalize.
-    float normalized = tensor_buffer[i] * inv_l2_norm;
-    // Quantize.
-    int unclamped_value = static_cast<int>(roundf(normalized * 128));
-    // Clamp and assign.
-    (*values)[i] =
-        static_cast<char>(std::max(-128, std::min(unclamped_value, 127)));
-  }
+  ScaleAndQuantizeValues(tensor_buffer, size, inv_l2_norm, values->data());
 }
 
 MEDIAPIPE_REGISTER_NODE(TensorsToEmbeddingsCalculator);
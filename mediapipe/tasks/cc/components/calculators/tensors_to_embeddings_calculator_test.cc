@@ -272,5 +272,33 @@ TEST(TensorsToEmbeddingsCalculatorTest,
                        })pb")));
 }
 
+TEST(TensorsToEmbeddingsCalculatorTest, SucceedsWithQuantizationClamping) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToEmbeddingsCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "EMBEDDINGS:embeddings"
+    options {
+      [mediapipe.TensorsToEmbeddingsCalculatorOptions.ext] {
+        embedder_options { l2_normalize: false quantize: true }
+      }
+    }
+  )pb"));
+
+  BuildGraph(&runner, {{1.0, -1.0, 20.0, -20.0}});
+  MP_ASSERT_OK(runner.Run());
+
+  const EmbeddingResult& result =
+      runner.Outputs().Get("EMBEDDINGS", 0).packets[0].Get<EmbeddingResult>();
+  EXPECT_THAT(
+      result,
+      EqualsProto(ParseTextProtoOrDie<EmbeddingResult>(
+          R"pb(embeddings {
+                 quantized_embedding {
+                   values: "\x7f\x80\x7f\x80"  # 127,-128,127,-128
+                 }
+                 head_index: 0
+               })pb")));
+}
+
 }  // namespace
 }  // namespace mediapipe
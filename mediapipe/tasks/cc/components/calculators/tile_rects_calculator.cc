@@ -0,0 +1,138 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/tasks/cc/components/calculators/tile_rects_calculator.pb.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Splits a region of interest of an image into a grid of overlapping tiles,
+// e.g. to run a detector on each tile of a high resolution image so that
+// small objects keep enough pixels at the model input resolution. The tiles
+// have the rotation of the region, and cover the region in its rotated frame.
+//
+// Inputs:
+//   IMAGE_SIZE - std::pair<int, int>
+//     The size of the image, used to rotate the tiles with the region.
+//   NORM_RECT - NormalizedRect @Optional
+//     The region to split into tiles. The whole image if not connected.
+//
+// Outputs:
+//   TILES - std::vector<NormalizedRect>
+//     The whole region first if include_whole_rect is set, then the tiles in
+//     row-major order.
+//
+// Example:
+// node {
+//   calculator: "TileRectsCalculator"
+//   input_stream: "IMAGE_SIZE:image_size"
+//   input_stream: "NORM_RECT:norm_rect"
+//   output_stream: "TILES:tiles"
+//   options {
+//     [mediapipe.TileRectsCalculatorOptions.ext] {
+//       num_rows: 2
+//       num_columns: 3
+//       overlap: 0.25
+//     }
+//   }
+// }
+class TileRectsCalculator : public Node {
+ public:
+  static constexpr Input<std::pair<int, int>> kImageSizeIn{"IMAGE_SIZE"};
+  static constexpr Input<NormalizedRect>::Optional kNormRectIn{"NORM_RECT"};
+  static constexpr Output<std::vector<NormalizedRect>> kTilesOut{"TILES"};
+  MEDIAPIPE_NODE_CONTRACT(kImageSizeIn, kNormRectIn, kTilesOut);
+
+  absl::Status Open(CalculatorContext* cc) override {
+    options_ = cc->Options<TileRectsCalculatorOptions>();
+    RET_CHECK_GT(options_.num_rows(), 0);
+    RET_CHECK_GT(options_.num_columns(), 0);
+    RET_CHECK(options_.overlap() >= 0 && options_.overlap() < 1)
+        << "overlap must be in [0, 1).";
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    if (kImageSizeIn(cc).IsEmpty()) {
+      return absl::OkStatus();
+    }
+    const auto& [image_width, image_height] = *kImageSizeIn(cc);
+    NormalizedRect region;
+    if (kNormRectIn(cc).IsConnected() && !kNormRectIn(cc).IsEmpty()) {
+      region = *kNormRectIn(cc);
+    } else {
+      region.set_x_center(0.5f);
+      region.set_y_center(0.5f);
+      region.set_width(1.0f);
+      region.set_height(1.0f);
+    }
+
+    std::vector<NormalizedRect> tiles;
+    if (options_.include_whole_rect()) {
+      tiles.push_back(region);
+    }
+    // Tiles of size `tile` with a stride of `tile * (1 - overlap)` span the
+    // region when `tile * (n - (n - 1) * overlap)` equals its size.
+    const float overlap = options_.overlap();
+    const int num_rows = options_.num_rows();
+    const int num_columns = options_.num_columns();
+    const float tile_width =
+        region.width() / (num_columns - (num_columns - 1) * overlap);
+    const float tile_height =
+        region.height() / (num_rows - (num_rows - 1) * overlap);
+    const float cos_r = std::cos(region.rotation());
+    const float sin_r = std::sin(region.rotation());
+    for (int row = 0; row < num_rows; ++row) {
+      for (int column = 0; column < num_columns; ++column) {
+        // The offset of the tile center from the region center in pixels, in
+        // the frame of the region, rotated into the frame of the image.
+        const float dx = (-region.width() / 2 + tile_width / 2 +
+                          column * tile_width * (1 - overlap)) *
+                         image_width;
+        const float dy = (-region.height() / 2 + tile_height / 2 +
+                          row * tile_height * (1 - overlap)) *
+                         image_height;
+        NormalizedRect& tile = tiles.emplace_back();
+        tile.set_x_center(region.x_center() +
+                          (dx * cos_r - dy * sin_r) / image_width);
+        tile.set_y_center(region.y_center() +
+                          (dx * sin_r + dy * cos_r) / image_height);
+        tile.set_width(tile_width);
+        tile.set_height(tile_height);
+        tile.set_rotation(region.rotation());
+      }
+    }
+    kTilesOut(cc).Send(std::move(tiles));
+    return absl::OkStatus();
+  }
+
+ private:
+  TileRectsCalculatorOptions options_;
+};
+
+MEDIAPIPE_REGISTER_NODE(TileRectsCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -0,0 +1,117 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using ::mediapipe::ParseTextProtoOrDie;
+using ::testing::ElementsAre;
+using ::testing::FloatNear;
+using ::testing::Matcher;
+using Node = ::mediapipe::CalculatorGraphConfig::Node;
+
+constexpr float kTolerance = 1e-5;
+
+Matcher<NormalizedRect> RectNear(float x_center, float y_center, float width,
+                                 float height, float rotation = 0) {
+  using ::testing::AllOf;
+  using ::testing::Property;
+  return AllOf(
+      Property(&NormalizedRect::x_center, FloatNear(x_center, kTolerance)),
+      Property(&NormalizedRect::y_center, FloatNear(y_center, kTolerance)),
+      Property(&NormalizedRect::width, FloatNear(width, kTolerance)),
+      Property(&NormalizedRect::height, FloatNear(height, kTolerance)),
+      Property(&NormalizedRect::rotation, FloatNear(rotation, kTolerance)));
+}
+
+std::vector<NormalizedRect> RunTiling(const std::string& options,
+                                      std::pair<int, int> image_size,
+                                      const NormalizedRect* norm_rect) {
+  std::string config = absl::StrFormat(
+      R"pb(
+        calculator: "TileRectsCalculator"
+        input_stream: "IMAGE_SIZE:image_size"
+        %s
+        output_stream: "TILES:tiles"
+        options {
+          [mediapipe.TileRectsCalculatorOptions.ext] { %s }
+        }
+      )pb",
+      norm_rect ? "input_stream: \"NORM_RECT:norm_rect\"" : "", options);
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(config));
+  runner.MutableInputs()->Tag("IMAGE_SIZE").packets.push_back(
+      MakePacket<std::pair<int, int>>(image_size).At(Timestamp(0)));
+  if (norm_rect) {
+    runner.MutableInputs()->Tag("NORM_RECT").packets.push_back(
+        MakePacket<NormalizedRect>(*norm_rect).At(Timestamp(0)));
+  }
+  MP_EXPECT_OK(runner.Run());
+  const auto& packets = runner.Outputs().Tag("TILES").packets;
+  EXPECT_EQ(packets.size(), 1);
+  if (packets.empty()) return {};
+  return packets[0].Get<std::vector<NormalizedRect>>();
+}
+
+TEST(TileRectsCalculatorTest, TilesWholeImage) {
+  EXPECT_THAT(
+      RunTiling("num_rows: 1 num_columns: 2 overlap: 0.5", {100, 50},
+                /*norm_rect=*/nullptr),
+      ElementsAre(RectNear(0.5f, 0.5f, 1.0f, 1.0f),
+                  RectNear(1.0f / 3, 0.5f, 2.0f / 3, 1.0f),
+                  RectNear(2.0f / 3, 0.5f, 2.0f / 3, 1.0f)));
+}
+
+TEST(TileRectsCalculatorTest, TilesWithoutOverlapOrWholeRect) {
+  EXPECT_THAT(RunTiling("num_rows: 2 num_columns: 2 overlap: 0 "
+                        "include_whole_rect: false",
+                        {100, 100}, /*norm_rect=*/nullptr),
+              ElementsAre(RectNear(0.25f, 0.25f, 0.5f, 0.5f),
+                          RectNear(0.75f, 0.25f, 0.5f, 0.5f),
+                          RectNear(0.25f, 0.75f, 0.5f, 0.5f),
+                          RectNear(0.75f, 0.75f, 0.5f, 0.5f)));
+}
+
+TEST(TileRectsCalculatorTest, TilesRotatedRegion) {
+  NormalizedRect region;
+  region.set_x_center(0.5f);
+  region.set_y_center(0.5f);
+  region.set_width(0.8f);
+  region.set_height(0.4f);
+  region.set_rotation(M_PI / 2);
+  // With a 90 degree rotation, the columns of the region are stacked
+  // vertically in the image.
+  EXPECT_THAT(RunTiling("num_rows: 1 num_columns: 2 overlap: 0 "
+                        "include_whole_rect: false",
+                        {100, 100}, &region),
+              ElementsAre(RectNear(0.5f, 0.3f, 0.4f, 0.4f, M_PI / 2),
+                          RectNear(0.5f, 0.7f, 0.4f, 0.4f, M_PI / 2)));
+}
+
+}  // namespace
+}  // namespace mediapipe
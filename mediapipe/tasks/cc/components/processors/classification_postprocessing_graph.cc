@@ -453,9 +453,11 @@ class ClassificationPostprocessingGraph : public mediapipe::Subgraph {
           MediaPipeTasksStatus::kInvalidArgumentError);
     }
 
-    // If output tensors are quantized, they must be dequantized first.
+    // TensorsToClassificationCalculator reads quantized tensors directly, so
+    // quantized output tensors are only dequantized for score calibration.
     TensorsSource dequantized_tensors = tensors_in;
-    if (options.has_quantized_outputs()) {
+    if (options.has_quantized_outputs() &&
+        !options.score_calibration_options().empty()) {
       GenericNode* tensors_dequantization_node =
           &graph.AddNode("TensorsDequantizationCalculator");
       tensors_in >> tensors_dequantization_node->In(kTensorsTag);
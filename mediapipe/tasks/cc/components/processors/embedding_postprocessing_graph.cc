@@ -33,6 +33,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/processors/proto/embedding_postprocessing_graph_options.pb.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/metadata/metadata_extractor.h"
+#include "mediapipe/util/graph_builder_utils.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
 namespace mediapipe {
@@ -188,6 +189,12 @@ absl::Status ConfigureEmbeddingPostprocessingGraph(
 //     The embedding result aggregated by timestamp, then by head. Must be
 //     connected if the TIMESTAMPS input is connected, as it signals that
 //     timestamp aggregation is required.
+//   TENSORS - std::vector<Tensor> @Optional
+//     The float output tensors of the model, dequantized if needed but neither
+//     L2-normalized nor scalar-quantized. For float models these are the input
+//     tensors themselves, so consuming them involves no copy. If neither
+//     EMBEDDINGS nor TIMESTAMPED_EMBEDDINGS is connected, no EmbeddingResult is
+//     computed.
 //
 // The recommended way of using this graph is through the GraphBuilder API using
 // the 'ConfigureEmbeddingPostprocessingGraph()' function. See header file for
@@ -197,11 +204,25 @@ class EmbeddingPostprocessingGraph : public mediapipe::Subgraph {
   absl::StatusOr<mediapipe::CalculatorGraphConfig> GetConfig(
       mediapipe::SubgraphContext* sc) override {
     Graph graph;
+    const auto& options =
+        sc->Options<proto::EmbeddingPostprocessingGraphOptions>();
+    Source<std::vector<Tensor>> float_tensors = BuildDequantization(
+        options, graph[Input<std::vector<Tensor>>(kTensorsTag)], graph);
+    if (HasOutput(sc->OriginalNode(), kTensorsTag)) {
+      // Forwards the packets of float tensors, which shares their buffers.
+      auto& pass_through = graph.AddNode("PassThroughCalculator");
+      float_tensors >> pass_through.In("");
+      pass_through.Out("").Cast<std::vector<Tensor>>() >>
+          graph[Output<std::vector<Tensor>>(kTensorsTag)];
+    }
+    if (!HasOutput(sc->OriginalNode(), kEmbeddingsTag) &&
+        !HasOutput(sc->OriginalNode(), kTimestampedEmbeddingsTag)) {
+      return graph.GetConfig();
+    }
     ASSIGN_OR_RETURN(
         auto output_streams,
         BuildEmbeddingPostprocessing(
-            sc->Options<proto::EmbeddingPostprocessingGraphOptions>(),
-            graph[Input<std::vector<Tensor>>(kTensorsTag)],
+            options, float_tensors,
             graph[Input<std::vector<Timestamp>>(kTimestampsTag)], graph));
     output_streams.embeddings >> graph[Output<EmbeddingResult>(kEmbeddingsTag)];
     output_streams.timestamped_embeddings >>
@@ -210,13 +231,32 @@ class EmbeddingPostprocessingGraph : public mediapipe::Subgraph {
   }
 
  private:
+  // Dequantizes the tensors if the model outputs are quantized. Returns
+  // `tensors_in` otherwise.
+  //
+  // options: the on-device EmbeddingPostprocessingGraphOptions
+  // tensors_in: (std::vector<mediapipe::Tensor>) tensors to dequantize.
+  // graph: the mediapipe builder::Graph instance to be updated.
+  Source<std::vector<Tensor>> BuildDequantization(
+      const proto::EmbeddingPostprocessingGraphOptions& options,
+      Source<std::vector<Tensor>> tensors_in, Graph& graph) {
+    if (!options.has_quantized_outputs()) {
+      return tensors_in;
+    }
+    GenericNode& tensors_dequantization_node =
+        graph.AddNode("TensorsDequantizationCalculator");
+    tensors_in >> tensors_dequantization_node.In(kTensorsTag);
+    return tensors_dequantization_node.Out(kTensorsTag)
+        .Cast<std::vector<Tensor>>();
+  }
+
   // Adds an on-device embedding postprocessing graph into the provided
-  // builder::Graph instance. The embedding postprocessing graph takes tensors
-  // (std::vector<mediapipe::Tensor>) as input and returns one output stream
-  // containing the output embedding results (EmbeddingResult).
+  // builder::Graph instance. The embedding postprocessing graph takes float
+  // tensors (std::vector<mediapipe::Tensor>) as input and returns one output
+  // stream containing the output embedding results (EmbeddingResult).
   //
   // options: the on-device EmbeddingPostprocessingGraphOptions
-  // tensors_in: (std::vector<mediapipe::Tensor>) tensors to postprocess.
+  // tensors_in: (std::vector<mediapipe::Tensor>) float tensors to postprocess.
   // timestamps_in: (std::vector<mediapipe::Timestamp>) optional collection of
   //   timestamps that should be used to aggregate embedding results.
   // graph: the mediapipe builder::Graph instance to be updated.
@@ -225,23 +265,13 @@ class EmbeddingPostprocessingGraph : public mediapipe::Subgraph {
       const proto::EmbeddingPostprocessingGraphOptions options,
       Source<std::vector<Tensor>> tensors_in,
       Source<std::vector<Timestamp>> timestamps_in, Graph& graph) {
-    // If output tensors are quantized, they must be dequantized first.
-    Source<std::vector<Tensor>> dequantized_tensors = tensors_in;
-    if (options.has_quantized_outputs()) {
-      GenericNode& tensors_dequantization_node =
-          graph.AddNode("TensorsDequantizationCalculator");
-      tensors_in >> tensors_dequantization_node.In(kTensorsTag);
-      dequantized_tensors = tensors_dequantization_node.Out(kTensorsTag)
-                                .Cast<std::vector<Tensor>>();
-    }
-
     // Adds TensorsToEmbeddingsCalculator.
     GenericNode& tensors_to_embeddings_node =
         graph.AddNode("TensorsToEmbeddingsCalculator");
     tensors_to_embeddings_node
         .GetOptions<mediapipe::TensorsToEmbeddingsCalculatorOptions>()
         .CopyFrom(options.tensors_to_embeddings_options());
-    dequantized_tensors >> tensors_to_embeddings_node.In(kTensorsTag);
+    tensors_in >> tensors_to_embeddings_node.In(kTensorsTag);
 
     // Adds EmbeddingAggregationCalculator.
     GenericNode& aggregation_node =
@@ -58,6 +58,12 @@ namespace processors {
 //     The embedding result aggregated by timestamp, then by head. Must be
 //     connected if the TIMESTAMPS input is connected, as it signals that
 //     timestamp aggregation is required.
+//   TENSORS - std::vector<Tensor> @Optional
+//     The float output tensors of the model, dequantized if needed but neither
+//     L2-normalized nor scalar-quantized. For float models these are the input
+//     tensors themselves, so consuming them involves no copy. If neither
+//     EMBEDDINGS nor TIMESTAMPED_EMBEDDINGS is connected, no EmbeddingResult is
+//     computed.
 absl::Status ConfigureEmbeddingPostprocessingGraph(
     const tasks::core::ModelResources& model_resources,
     const proto::EmbedderOptions& embedder_options,
@@ -76,6 +76,7 @@ constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
 constexpr char kEmbeddingsName[] = "embeddings";
 constexpr char kTimestampedEmbeddingsTag[] = "TIMESTAMPED_EMBEDDINGS";
 constexpr char kTimestampedEmbeddingsName[] = "timestamped_embeddings";
+constexpr char kFloatTensorsName[] = "float_tensors";
 
 // Helper function to get ModelResources.
 absl::StatusOr<std::unique_ptr<ModelResources>> CreateModelResourcesForModel(
@@ -203,6 +204,37 @@ class PostprocessingTest : public tflite::testing::Test {
     return poller;
   }
 
+  // Builds a graph that only outputs the float tensors.
+  absl::StatusOr<OutputStreamPoller> BuildFloatTensorsGraph(
+      absl::string_view model_name, const proto::EmbedderOptions& options) {
+    ASSIGN_OR_RETURN(auto model_resources,
+                     CreateModelResourcesForModel(model_name));
+
+    Graph graph;
+    auto& postprocessing = graph.AddNode(
+        "mediapipe.tasks.components.processors."
+        "EmbeddingPostprocessingGraph");
+    MP_RETURN_IF_ERROR(ConfigureEmbeddingPostprocessingGraph(
+        *model_resources, options,
+        &postprocessing
+             .GetOptions<proto::EmbeddingPostprocessingGraphOptions>()));
+    graph[Input<std::vector<Tensor>>(kTensorsTag)].SetName(kTensorsName) >>
+        postprocessing.In(kTensorsTag);
+    postprocessing.Out(kTensorsTag).SetName(kFloatTensorsName) >>
+        graph[Output<std::vector<Tensor>>(kTensorsTag)];
+
+    MP_RETURN_IF_ERROR(calculator_graph_.Initialize(graph.GetConfig()));
+    ASSIGN_OR_RETURN(auto poller,
+                     calculator_graph_.AddOutputStreamPoller(kFloatTensorsName));
+    MP_RETURN_IF_ERROR(calculator_graph_.StartRun(/*extra_side_packets=*/{}));
+    return poller;
+  }
+
+  // Returns the CPU buffer of the last tensor added.
+  const float* GetLastTensorBuffer() {
+    return tensors_->back().GetCpuReadView().buffer<float>();
+  }
+
   template <typename T>
   void AddTensor(
       const std::vector<T>& tensor, const Tensor::ElementType& element_type,
@@ -233,6 +265,19 @@ class PostprocessingTest : public tflite::testing::Test {
     return absl::OkStatus();
   }
 
+  // Returns the output packet, which keeps its payload alive after the run.
+  absl::StatusOr<Packet> GetPacket(OutputStreamPoller& poller) {
+    MP_RETURN_IF_ERROR(calculator_graph_.WaitUntilIdle());
+    MP_RETURN_IF_ERROR(calculator_graph_.CloseAllInputStreams());
+
+    Packet packet;
+    if (!poller.Next(&packet)) {
+      return absl::InternalError("Unable to get output packet");
+    }
+    MP_RETURN_IF_ERROR(calculator_graph_.WaitUntilDone());
+    return packet;
+  }
+
   template <typename T>
   absl::StatusOr<T> GetResult(OutputStreamPoller& poller) {
     MP_RETURN_IF_ERROR(calculator_graph_.WaitUntilIdle());
@@ -348,6 +393,30 @@ TEST_F(PostprocessingTest, SucceedsWithAggregation) {
   }
 }
 
+TEST_F(PostprocessingTest, SucceedsWithFloatTensorsOnly) {
+  // Build graph.
+  proto::EmbedderOptions options;
+  options.set_l2_normalize(true);
+  MP_ASSERT_OK_AND_ASSIGN(auto poller,
+                          BuildFloatTensorsGraph(kMobileNetV3Embedder, options));
+  // Build input tensor.
+  std::vector<float> tensor(kMobileNetV3EmbedderEmbeddingSize, 0);
+  tensor[0] = 2.0;
+
+  // Send tensor and get results.
+  AddTensor(tensor, Tensor::ElementType::kFloat32);
+  const float* input_buffer = GetLastTensorBuffer();
+  MP_ASSERT_OK(Run());
+  MP_ASSERT_OK_AND_ASSIGN(Packet packet, GetPacket(poller));
+
+  // Validate results: the tensor is forwarded as is, without normalization.
+  const auto& tensors = packet.Get<std::vector<Tensor>>();
+  ASSERT_EQ(tensors.size(), 1);
+  auto view = tensors[0].GetCpuReadView();
+  EXPECT_EQ(view.buffer<float>(), input_buffer);
+  EXPECT_FLOAT_EQ(view.buffer<float>()[0], 2.0);
+}
+
 }  // namespace
 }  // namespace processors
 }  // namespace components
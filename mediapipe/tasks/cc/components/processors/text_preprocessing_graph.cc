@@ -118,7 +118,8 @@ absl::StatusOr<int> GetMaxSeqLen(const tflite::SubGraph& model_graph) {
 // Determines whether the TFLite model for `model_graph` has input tensors with
 // dynamic shape rather than static shape or returns an error if the input
 // tensors have invalid shape signatures. This util assumes that the model has
-// the correct input tensors type and count for the BertPreprocessorCalculator.
+// the correct input tensors type and count for the BertPreprocessorCalculator
+// or the RegexPreprocessorCalculator.
 absl::StatusOr<bool> HasDynamicInputTensors(
     const tflite::SubGraph& model_graph) {
   const flatbuffers::Vector<int32_t>& input_indices = *model_graph.inputs();
@@ -197,7 +198,8 @@ absl::Status ConfigureTextPreprocessingGraph(
       options.set_max_seq_len(max_seq_len);
     }
   }
-  if (model_type == TextModelType::BERT_MODEL) {
+  if (model_type == TextModelType::BERT_MODEL ||
+      model_type == TextModelType::REGEX_MODEL) {
     ASSIGN_OR_RETURN(bool has_dynamic_input_tensors,
                      HasDynamicInputTensors(model_graph));
     options.set_has_dynamic_input_tensors(has_dynamic_input_tensors);
@@ -260,6 +262,8 @@ class TextPreprocessingGraph : public mediapipe::Subgraph {
             .set_bert_max_seq_len(options.max_seq_len());
         text_preprocessor.GetOptions<BertPreprocessorCalculatorOptions>()
             .set_has_dynamic_input_tensors(options.has_dynamic_input_tensors());
+        text_preprocessor.GetOptions<BertPreprocessorCalculatorOptions>()
+            .set_seq_len_bucket_size(options.seq_len_bucket_size());
         metadata_extractor_in >>
             text_preprocessor.SideIn(kMetadataExtractorTag);
         break;
@@ -267,6 +271,10 @@ class TextPreprocessingGraph : public mediapipe::Subgraph {
       case TextModelType::REGEX_MODEL: {
         text_preprocessor.GetOptions<RegexPreprocessorCalculatorOptions>()
             .set_max_seq_len(options.max_seq_len());
+        text_preprocessor.GetOptions<RegexPreprocessorCalculatorOptions>()
+            .set_has_dynamic_input_tensors(options.has_dynamic_input_tensors());
+        text_preprocessor.GetOptions<RegexPreprocessorCalculatorOptions>()
+            .set_seq_len_bucket_size(options.seq_len_bucket_size());
         metadata_extractor_in >>
             text_preprocessor.SideIn(kMetadataExtractorTag);
         break;
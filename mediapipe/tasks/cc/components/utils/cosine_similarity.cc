@@ -15,14 +15,26 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/components/utils/cosine_similarity.h"
 
+#include <cmath>
 #include <cstdint>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace mediapipe {
 namespace tasks {
 namespace components {
@@ -32,30 +44,222 @@ namespace {
 
 using ::mediapipe::tasks::components::containers::Embedding;
 
-template <typename T>
-absl::StatusOr<double> ComputeCosineSimilarity(const T& u, const T& v,
-                                               int num_elements) {
+// The dot products of two embeddings u and v with each other and themselves.
+struct DotProducts {
+  double uv = 0.0;
+  double uu = 0.0;
+  double vv = 0.0;
+};
+
+// The vector loops accumulate the products in float lanes, which are summed
+// into the double accumulators of the scalar loop handling the remaining
+// values.
+DotProducts ComputeDotProducts(const float* u, const float* v, int size) {
+  DotProducts result;
+  int i = 0;
+#if defined(__AVX2__)
+  __m256 uv = _mm256_setzero_ps();
+  __m256 uu = _mm256_setzero_ps();
+  __m256 vv = _mm256_setzero_ps();
+  for (; i + 8 <= size; i += 8) {
+    const __m256 a = _mm256_loadu_ps(u + i);
+    const __m256 b = _mm256_loadu_ps(v + i);
+    uv = _mm256_add_ps(uv, _mm256_mul_ps(a, b));
+    uu = _mm256_add_ps(uu, _mm256_mul_ps(a, a));
+    vv = _mm256_add_ps(vv, _mm256_mul_ps(b, b));
+  }
+  float lanes[3][8];
+  _mm256_storeu_ps(lanes[0], uv);
+  _mm256_storeu_ps(lanes[1], uu);
+  _mm256_storeu_ps(lanes[2], vv);
+  for (int j = 0; j < 8; ++j) {
+    result.uv += lanes[0][j];
+    result.uu += lanes[1][j];
+    result.vv += lanes[2][j];
+  }
+#elif defined(__SSE2__)
+  __m128 uv = _mm_setzero_ps();
+  __m128 uu = _mm_setzero_ps();
+  __m128 vv = _mm_setzero_ps();
+  for (; i + 4 <= size; i += 4) {
+    const __m128 a = _mm_loadu_ps(u + i);
+    const __m128 b = _mm_loadu_ps(v + i);
+    uv = _mm_add_ps(uv, _mm_mul_ps(a, b));
+    uu = _mm_add_ps(uu, _mm_mul_ps(a, a));
+    vv = _mm_add_ps(vv, _mm_mul_ps(b, b));
+  }
+  float lanes[3][4];
+  _mm_storeu_ps(lanes[0], uv);
+  _mm_storeu_ps(lanes[1], uu);
+  _mm_storeu_ps(lanes[2], vv);
+  for (int j = 0; j < 4; ++j) {
+    result.uv += lanes[0][j];
+    result.uu += lanes[1][j];
+    result.vv += lanes[2][j];
+  }
+#elif defined(__ARM_NEON)
+  float32x4_t uv = vdupq_n_f32(0.0f);
+  float32x4_t uu = vdupq_n_f32(0.0f);
+  float32x4_t vv = vdupq_n_f32(0.0f);
+  for (; i + 4 <= size; i += 4) {
+    const float32x4_t a = vld1q_f32(u + i);
+    const float32x4_t b = vld1q_f32(v + i);
+    uv = vaddq_f32(uv, vmulq_f32(a, b));
+    uu = vaddq_f32(uu, vmulq_f32(a, a));
+    vv = vaddq_f32(vv, vmulq_f32(b, b));
+  }
+  float lanes[3][4];
+  vst1q_f32(lanes[0], uv);
+  vst1q_f32(lanes[1], uu);
+  vst1q_f32(lanes[2], vv);
+  for (int j = 0; j < 4; ++j) {
+    result.uv += lanes[0][j];
+    result.uu += lanes[1][j];
+    result.vv += lanes[2][j];
+  }
+#endif
+  for (; i < size; ++i) {
+    result.uv += u[i] * v[i];
+    result.uu += u[i] * u[i];
+    result.vv += v[i] * v[i];
+  }
+  return result;
+}
+
+// The products of int8 values are summed exactly in int32 lanes, so the result
+// is the same as that of the scalar loop.
+DotProducts ComputeDotProducts(const int8_t* u, const int8_t* v, int size) {
+  int64_t uv_sum = 0;
+  int64_t uu_sum = 0;
+  int64_t vv_sum = 0;
+  int i = 0;
+#if defined(__AVX2__)
+  __m256i uv = _mm256_setzero_si256();
+  __m256i uu = _mm256_setzero_si256();
+  __m256i vv = _mm256_setzero_si256();
+  for (; i + 16 <= size; i += 16) {
+    const __m256i a = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + i)));
+    const __m256i b = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i)));
+    uv = _mm256_add_epi32(uv, _mm256_madd_epi16(a, b));
+    uu = _mm256_add_epi32(uu, _mm256_madd_epi16(a, a));
+    vv = _mm256_add_epi32(vv, _mm256_madd_epi16(b, b));
+  }
+  int32_t lanes[3][8];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[0]), uv);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[1]), uu);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[2]), vv);
+  for (int j = 0; j < 8; ++j) {
+    uv_sum += lanes[0][j];
+    uu_sum += lanes[1][j];
+    vv_sum += lanes[2][j];
+  }
+#elif defined(__SSE2__)
+  __m128i uv = _mm_setzero_si128();
+  __m128i uu = _mm_setzero_si128();
+  __m128i vv = _mm_setzero_si128();
+  for (; i + 8 <= size; i += 8) {
+    // Sign-extends the 8 values to int16 by shifting them down from the high
+    // bytes.
+    const __m128i a8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + i));
+    const __m128i b8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + i));
+    const __m128i a = _mm_srai_epi16(_mm_unpacklo_epi8(a8, a8), 8);
+    const __m128i b = _mm_srai_epi16(_mm_unpacklo_epi8(b8, b8), 8);
+    uv = _mm_add_epi32(uv, _mm_madd_epi16(a, b));
+    uu = _mm_add_epi32(uu, _mm_madd_epi16(a, a));
+    vv = _mm_add_epi32(vv, _mm_madd_epi16(b, b));
+  }
+  int32_t lanes[3][4];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[0]), uv);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[1]), uu);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes[2]), vv);
+  for (int j = 0; j < 4; ++j) {
+    uv_sum += lanes[0][j];
+    uu_sum += lanes[1][j];
+    vv_sum += lanes[2][j];
+  }
+#elif defined(__ARM_NEON)
+  int32x4_t uv = vdupq_n_s32(0);
+  int32x4_t uu = vdupq_n_s32(0);
+  int32x4_t vv = vdupq_n_s32(0);
+  for (; i + 8 <= size; i += 8) {
+    const int8x8_t a = vld1_s8(u + i);
+    const int8x8_t b = vld1_s8(v + i);
+    uv = vpadalq_s16(uv, vmull_s8(a, b));
+    uu = vpadalq_s16(uu, vmull_s8(a, a));
+    vv = vpadalq_s16(vv, vmull_s8(b, b));
+  }
+  int32_t lanes[3][4];
+  vst1q_s32(lanes[0], uv);
+  vst1q_s32(lanes[1], uu);
+  vst1q_s32(lanes[2], vv);
+  for (int j = 0; j < 4; ++j) {
+    uv_sum += lanes[0][j];
+    uu_sum += lanes[1][j];
+    vv_sum += lanes[2][j];
+  }
+#endif
+  for (; i < size; ++i) {
+    uv_sum += u[i] * v[i];
+    uu_sum += u[i] * u[i];
+    vv_sum += v[i] * v[i];
+  }
+  DotProducts result;
+  result.uv = uv_sum;
+  result.uu = uu_sum;
+  result.vv = vv_sum;
+  return result;
+}
+
+absl::Status CheckNonEmpty(int num_elements) {
   if (num_elements <= 0) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument,
         "Cannot compute cosing similarity on empty embeddings",
         MediaPipeTasksStatus::kInvalidArgumentError);
   }
-  double dot_product = 0.0;
-  double norm_u = 0.0;
-  double norm_v = 0.0;
-  for (int i = 0; i < num_elements; ++i) {
-    dot_product += u[i] * v[i];
-    norm_u += u[i] * u[i];
-    norm_v += v[i] * v[i];
-  }
-  if (norm_u <= 0.0 || norm_v <= 0.0) {
+  return absl::OkStatus();
+}
+
+absl::StatusOr<double> ComputeCosineSimilarity(const DotProducts& products) {
+  if (products.uu <= 0.0 || products.vv <= 0.0) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument,
         "Cannot compute cosine similarity on embedding with 0 norm",
         MediaPipeTasksStatus::kInvalidArgumentError);
   }
-  return dot_product / std::sqrt(norm_u * norm_v);
+  return products.uv / std::sqrt(products.uu * products.vv);
+}
+
+template <typename T>
+absl::StatusOr<double> ComputeCosineSimilarity(const T* u, const T* v,
+                                               int num_elements) {
+  MP_RETURN_IF_ERROR(CheckNonEmpty(num_elements));
+  return ComputeCosineSimilarity(ComputeDotProducts(u, v, num_elements));
+}
+
+template <typename T>
+absl::StatusOr<std::vector<double>> ComputeCosineSimilarities(
+    const T* query, int num_elements, absl::Span<const T> matrix) {
+  MP_RETURN_IF_ERROR(CheckNonEmpty(num_elements));
+  if (matrix.size() % num_elements != 0) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Cannot compute cosine similarity between embeddings "
+                        "of different sizes (matrix of %d values is not made "
+                        "of rows of %d values)",
+                        matrix.size(), num_elements),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  std::vector<double> similarities(matrix.size() / num_elements);
+  for (int row = 0; row < similarities.size(); ++row) {
+    ASSIGN_OR_RETURN(
+        similarities[row],
+        ComputeCosineSimilarity(ComputeDotProducts(
+            query, matrix.data() + row * num_elements, num_elements)));
+  }
+  return similarities;
 }
 
 }  // namespace
@@ -102,6 +306,33 @@ absl::StatusOr<double> CosineSimilarity(const Embedding& u,
       MediaPipeTasksStatus::kInvalidArgumentError);
 }
 
+absl::StatusOr<std::vector<double>> CosineSimilarityBatch(
+    const Embedding& query, absl::Span<const float> matrix) {
+  if (query.float_embedding.empty()) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Cannot compute cosine similarity between quantized and float "
+        "embeddings",
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  return ComputeCosineSimilarities(query.float_embedding.data(),
+                                   query.float_embedding.size(), matrix);
+}
+
+absl::StatusOr<std::vector<double>> CosineSimilarityBatch(
+    const Embedding& query, absl::Span<const int8_t> matrix) {
+  if (query.quantized_embedding.empty()) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Cannot compute cosine similarity between quantized and float "
+        "embeddings",
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  return ComputeCosineSimilarities(
+      reinterpret_cast<const int8_t*>(query.quantized_embedding.data()),
+      query.quantized_embedding.size(), matrix);
+}
+
 }  // namespace utils
 }  // namespace components
 }  // namespace tasks
@@ -16,7 +16,11 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_COSINE_SIMILARITY_H_
 #define MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_COSINE_SIMILARITY_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 
 namespace mediapipe {
@@ -32,6 +36,20 @@ namespace utils {
 absl::StatusOr<double> CosineSimilarity(const containers::Embedding& u,
                                         const containers::Embedding& v);
 
+// Computes the cosine similarity between the `query` embedding and each row of
+// `matrix`, a row-major matrix of float embeddings of the same size as the
+// query stored contiguously, such as the embeddings to search for the query.
+// Returns one similarity per row, in order. May return an InvalidArgumentError
+// if e.g. the query is quantized, the matrix size is not a multiple of the
+// query size, or an embedding has an L2-norm of 0.
+absl::StatusOr<std::vector<double>> CosineSimilarityBatch(
+    const containers::Embedding& query, absl::Span<const float> matrix);
+
+// Same as above for a quantized `query` embedding and a matrix of quantized
+// embeddings.
+absl::StatusOr<std::vector<double>> CosineSimilarityBatch(
+    const containers::Embedding& query, absl::Span<const int8_t> matrix);
+
 }  // namespace utils
 }  // namespace components
 }  // namespace tasks
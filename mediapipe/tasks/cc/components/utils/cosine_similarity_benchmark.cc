@@ -0,0 +1,111 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks comparing a query embedding against a matrix of stored
+// embeddings, one pair at a time with CosineSimilarity and in one call with
+// CosineSimilarityBatch. The argument is the number of stored embeddings.
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
+#include "mediapipe/tasks/cc/components/utils/cosine_similarity.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+namespace {
+
+using ::mediapipe::tasks::components::containers::Embedding;
+
+constexpr int kNumElements = 1024;
+
+// Returns the float value at `index` of an arbitrary embedding matrix.
+float FloatValue(int index) { return (index * 7919 % 255 - 127) / 128.0f; }
+
+void BM_CosineSimilarityFloatPairs(benchmark::State& state) {
+  const int num_rows = state.range(0);
+  Embedding query;
+  std::vector<Embedding> rows(num_rows);
+  for (int i = 0; i < kNumElements; ++i) {
+    query.float_embedding.push_back(FloatValue(i + 1));
+  }
+  for (int row = 0; row < num_rows; ++row) {
+    for (int i = 0; i < kNumElements; ++i) {
+      rows[row].float_embedding.push_back(FloatValue(row * kNumElements + i));
+    }
+  }
+  for (auto _ : state) {
+    for (const Embedding& row : rows) {
+      auto similarity = CosineSimilarity(query, row);
+      ABSL_CHECK_OK(similarity);
+      benchmark::DoNotOptimize(*similarity);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+}
+BENCHMARK(BM_CosineSimilarityFloatPairs)->Arg(1000)->Arg(10000);
+
+void BM_CosineSimilarityBatchFloat(benchmark::State& state) {
+  const int num_rows = state.range(0);
+  Embedding query;
+  std::vector<float> matrix;
+  for (int i = 0; i < kNumElements; ++i) {
+    query.float_embedding.push_back(FloatValue(i + 1));
+  }
+  for (int i = 0; i < num_rows * kNumElements; ++i) {
+    matrix.push_back(FloatValue(i));
+  }
+  for (auto _ : state) {
+    auto similarities = CosineSimilarityBatch(query, matrix);
+    ABSL_CHECK_OK(similarities);
+    benchmark::DoNotOptimize(similarities->data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+}
+BENCHMARK(BM_CosineSimilarityBatchFloat)->Arg(1000)->Arg(10000);
+
+void BM_CosineSimilarityBatchQuantized(benchmark::State& state) {
+  const int num_rows = state.range(0);
+  Embedding query;
+  std::vector<int8_t> matrix;
+  for (int i = 0; i < kNumElements; ++i) {
+    query.quantized_embedding.push_back(static_cast<char>(FloatValue(i + 1) *
+                                                          127));
+  }
+  for (int i = 0; i < num_rows * kNumElements; ++i) {
+    matrix.push_back(static_cast<int8_t>(FloatValue(i) * 127));
+  }
+  for (auto _ : state) {
+    auto similarities =
+        CosineSimilarityBatch(query, absl::MakeConstSpan(matrix));
+    ABSL_CHECK_OK(similarities);
+    benchmark::DoNotOptimize(similarities->data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+}
+BENCHMARK(BM_CosineSimilarityBatchQuantized)->Arg(1000)->Arg(10000);
+
+}  // namespace
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
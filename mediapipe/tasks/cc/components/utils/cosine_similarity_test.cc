@@ -15,10 +15,12 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/components/utils/cosine_similarity.h"
 
+#include <cmath>
 #include <cstdint>
 #include <string>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/status_matchers.h"
@@ -31,6 +33,8 @@ namespace utils {
 namespace {
 
 using ::mediapipe::tasks::components::containers::Embedding;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 
 // Helper function to generate float Embedding.
@@ -102,6 +106,127 @@ TEST(CosineSimilarity, SucceedsWithQuantizedEntries) {
   EXPECT_EQ(result, -1);
 }
 
+TEST(CosineSimilarity, SucceedsWithLongFloatEntries) {
+  // Covers the vector loops and the remaining values.
+  std::vector<float> u_values;
+  std::vector<float> v_values;
+  for (int i = 0; i < 37; ++i) {
+    u_values.push_back(i % 5 - 2);
+    v_values.push_back(i % 3 - 1);
+  }
+  double dot_product = 0.0;
+  double norm_u = 0.0;
+  double norm_v = 0.0;
+  for (int i = 0; i < u_values.size(); ++i) {
+    dot_product += u_values[i] * v_values[i];
+    norm_u += u_values[i] * u_values[i];
+    norm_v += v_values[i] * v_values[i];
+  }
+
+  MP_ASSERT_OK_AND_ASSIGN(auto result,
+                          CosineSimilarity(BuildFloatEmbedding(u_values),
+                                           BuildFloatEmbedding(v_values)));
+
+  EXPECT_NEAR(result, dot_product / std::sqrt(norm_u * norm_v), 1e-6);
+}
+
+TEST(CosineSimilarity, SucceedsWithLongQuantizedEntries) {
+  // Covers the vector loops and the remaining values.
+  std::vector<int8_t> u_values;
+  std::vector<int8_t> v_values;
+  for (int i = 0; i < 37; ++i) {
+    u_values.push_back(i % 2 == 0 ? -128 : 127);
+    v_values.push_back(i % 3 == 0 ? 127 : -128);
+  }
+  int64_t dot_product = 0;
+  int64_t norm_u = 0;
+  int64_t norm_v = 0;
+  for (int i = 0; i < u_values.size(); ++i) {
+    dot_product += u_values[i] * v_values[i];
+    norm_u += u_values[i] * u_values[i];
+    norm_v += v_values[i] * v_values[i];
+  }
+
+  MP_ASSERT_OK_AND_ASSIGN(auto result,
+                          CosineSimilarity(BuildQuantizedEmbedding(u_values),
+                                           BuildQuantizedEmbedding(v_values)));
+
+  EXPECT_EQ(result, dot_product / std::sqrt(static_cast<double>(norm_u) *
+                                            static_cast<double>(norm_v)));
+}
+
+TEST(CosineSimilarityBatch, SucceedsWithFloatEntries) {
+  auto query = BuildFloatEmbedding({1.0, 0.0, 0.0, 0.0});
+  std::vector<float> matrix = {0.5, 0.5, 0.5, 0.5,  //
+                               2.0, 0.0, 0.0, 0.0,  //
+                               0.0, 1.0, 0.0, 0.0};
+
+  MP_ASSERT_OK_AND_ASSIGN(auto result, CosineSimilarityBatch(query, matrix));
+
+  EXPECT_THAT(result, ElementsAre(0.5, 1.0, 0.0));
+}
+
+TEST(CosineSimilarityBatch, SucceedsWithQuantizedEntries) {
+  auto query = BuildQuantizedEmbedding({127, 0, 0, 0});
+  std::vector<int8_t> matrix = {-128, 0, 0, 0,  //
+                                64,   0, 0, 0};
+
+  MP_ASSERT_OK_AND_ASSIGN(auto result, CosineSimilarityBatch(
+                                           query, absl::MakeConstSpan(matrix)));
+
+  EXPECT_THAT(result, ElementsAre(-1, 1));
+}
+
+TEST(CosineSimilarityBatch, MatchesPairwiseSimilarity) {
+  constexpr int kNumElements = 21;
+  constexpr int kNumRows = 5;
+  std::vector<float> query_values;
+  for (int i = 0; i < kNumElements; ++i) {
+    query_values.push_back(i % 4 - 1.5f);
+  }
+  std::vector<float> matrix;
+  for (int i = 0; i < kNumRows * kNumElements; ++i) {
+    matrix.push_back(i % 7 - 3.0f);
+  }
+  auto query = BuildFloatEmbedding(query_values);
+
+  MP_ASSERT_OK_AND_ASSIGN(auto result, CosineSimilarityBatch(query, matrix));
+
+  ASSERT_EQ(result.size(), kNumRows);
+  for (int row = 0; row < kNumRows; ++row) {
+    MP_ASSERT_OK_AND_ASSIGN(
+        auto expected,
+        CosineSimilarity(query, BuildFloatEmbedding(std::vector<float>(
+                                    matrix.begin() + row * kNumElements,
+                                    matrix.begin() + (row + 1) * kNumElements))));
+    EXPECT_THAT(result[row], DoubleNear(expected, 1e-9));
+  }
+}
+
+TEST(CosineSimilarityBatch, FailsWithPartialRow) {
+  auto query = BuildFloatEmbedding({0.1, 0.2});
+  std::vector<float> matrix = {0.1, 0.2, 0.3};
+
+  auto status = CosineSimilarityBatch(query, matrix);
+
+  EXPECT_EQ(status.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.status().message(),
+              HasSubstr("Cannot compute cosine similarity between embeddings "
+                        "of different sizes"));
+}
+
+TEST(CosineSimilarityBatch, FailsWithQuantizedQueryAndFloatMatrix) {
+  auto query = BuildQuantizedEmbedding({0, 1});
+  std::vector<float> matrix = {0.1, 0.2};
+
+  auto status = CosineSimilarityBatch(query, matrix);
+
+  EXPECT_EQ(status.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.status().message(),
+              HasSubstr("Cannot compute cosine similarity between quantized "
+                        "and float embeddings"));
+}
+
 }  // namespace
 }  // namespace utils
 }  // namespace components
@@ -0,0 +1,501 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/components/utils/embedding_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
+#include "mediapipe/tasks/cc/components/utils/cosine_similarity.h"
+#include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+
+namespace {
+
+using ::mediapipe::tasks::components::containers::Embedding;
+
+// The header of index files, followed by:
+// - the ids, as int32_t[num_embeddings],
+// - if num_lists > 0, the list offsets, as int32_t[num_lists + 1],
+// - the centroids, as float[num_lists * dimension],
+// - the embeddings, as float or int8_t[num_embeddings * dimension].
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t flags;
+  int32_t dimension;
+  int32_t num_embeddings;
+  int32_t num_lists;
+  uint32_t reserved[2];
+};
+static_assert(sizeof(FileHeader) == 32, "Unexpected FileHeader size");
+
+constexpr char kMagic[4] = {'M', 'P', 'E', 'I'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kQuantizedFlag = 1;
+
+absl::Status InvalidFileError(absl::string_view message) {
+  return CreateStatusWithPayload(
+      absl::StatusCode::kInvalidArgument,
+      absl::StrFormat("Invalid embedding index file: %s", message),
+      MediaPipeTasksStatus::kInvalidArgumentError);
+}
+
+// Normalizes `values` in place to an L2-norm of 1, and returns false if their
+// norm is 0.
+bool Normalize(absl::Span<float> values) {
+  double norm = 0.0;
+  for (float value : values) {
+    norm += static_cast<double>(value) * value;
+  }
+  if (norm <= 0.0) {
+    return false;
+  }
+  const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+  for (float& value : values) {
+    value *= scale;
+  }
+  return true;
+}
+
+float Dot(const float* u, const float* v, int size) {
+  float dot = 0.0f;
+  for (int i = 0; i < size; ++i) {
+    dot += u[i] * v[i];
+  }
+  return dot;
+}
+
+// Returns the index of the centroid most similar to the normalized `row`.
+int NearestCentroid(absl::Span<const float> centroids, const float* row,
+                    int dimension) {
+  const int num_centroids = centroids.size() / dimension;
+  int nearest = 0;
+  float best = Dot(centroids.data(), row, dimension);
+  for (int c = 1; c < num_centroids; ++c) {
+    const float similarity = Dot(&centroids[c * dimension], row, dimension);
+    if (similarity > best) {
+      best = similarity;
+      nearest = c;
+    }
+  }
+  return nearest;
+}
+
+template <typename T>
+void AppendBytes(absl::Span<const T> values, std::string& buffer) {
+  buffer.append(reinterpret_cast<const char*>(values.data()),
+                values.size() * sizeof(T));
+}
+
+}  // namespace
+
+EmbeddingIndex::EmbeddingIndex(EmbeddingIndexOptions options)
+    : options_(std::move(options)) {}
+
+absl::StatusOr<std::unique_ptr<EmbeddingIndex>> EmbeddingIndex::CreateFromFile(
+    const std::string& path, EmbeddingIndexOptions options) {
+  auto external_file = std::make_unique<core::proto::ExternalFile>();
+  external_file->set_file_name(path);
+  ASSIGN_OR_RETURN(
+      auto file_handler,
+      core::ExternalFileHandler::CreateFromExternalFile(external_file.get()));
+  ASSIGN_OR_RETURN(
+      auto index,
+      CreateFromBuffer(file_handler->GetFileContent(), std::move(options)));
+  index->external_file_ = std::move(external_file);
+  index->file_handler_ = std::move(file_handler);
+  return index;
+}
+
+absl::StatusOr<std::unique_ptr<EmbeddingIndex>>
+EmbeddingIndex::CreateFromBuffer(absl::string_view buffer,
+                                 EmbeddingIndexOptions options) {
+  if (buffer.size() < sizeof(FileHeader)) {
+    return InvalidFileError("too small for the header");
+  }
+  if (reinterpret_cast<uintptr_t>(buffer.data()) % alignof(float) != 0) {
+    return InvalidFileError("buffer is not 4-byte aligned");
+  }
+  FileHeader header;
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return InvalidFileError("bad magic number");
+  }
+  if (header.version != kVersion) {
+    return InvalidFileError(
+        absl::StrFormat("unsupported version %d", header.version));
+  }
+  if (header.dimension < 0 || header.num_embeddings < 0 ||
+      header.num_lists < 0 ||
+      (header.dimension == 0 && header.num_embeddings > 0)) {
+    return InvalidFileError("bad sizes");
+  }
+  const bool quantized = header.flags & kQuantizedFlag;
+  const size_t n = header.num_embeddings;
+  const size_t dimension = header.dimension;
+  const size_t num_lists = header.num_lists;
+  const size_t num_offsets = num_lists > 0 ? num_lists + 1 : 0;
+  const size_t expected_size =
+      sizeof(FileHeader) + sizeof(int32_t) * (n + num_offsets) +
+      sizeof(float) * num_lists * dimension +
+      (quantized ? sizeof(int8_t) : sizeof(float)) * n * dimension;
+  if (buffer.size() != expected_size) {
+    return InvalidFileError(absl::StrFormat("expected %d bytes, got %d",
+                                            expected_size, buffer.size()));
+  }
+
+  auto index = std::make_unique<EmbeddingIndex>(std::move(options));
+  index->read_only_ = true;
+  index->quantized_ = quantized;
+  index->dimension_ = dimension;
+  const char* data = buffer.data() + sizeof(FileHeader);
+  index->ids_ = {reinterpret_cast<const int32_t*>(data), n};
+  data += sizeof(int32_t) * n;
+  index->list_offsets_ = {reinterpret_cast<const int32_t*>(data),
+                          num_offsets};
+  data += sizeof(int32_t) * num_offsets;
+  index->centroids_ = {reinterpret_cast<const float*>(data),
+                       num_lists * dimension};
+  data += sizeof(float) * num_lists * dimension;
+  if (quantized) {
+    index->quantized_values_ = {reinterpret_cast<const int8_t*>(data),
+                                n * dimension};
+  } else {
+    index->float_values_ = {reinterpret_cast<const float*>(data),
+                            n * dimension};
+  }
+  // Validates the list offsets, which Search() uses as row indices.
+  for (size_t i = 0; i < num_offsets; ++i) {
+    const int32_t previous = i == 0 ? 0 : index->list_offsets_[i - 1];
+    if (index->list_offsets_[i] < previous || index->list_offsets_[i] > n) {
+      return InvalidFileError("bad list offsets");
+    }
+  }
+  return index;
+}
+
+absl::Status EmbeddingIndex::CheckEmbedding(const Embedding& embedding) const {
+  const bool quantized = !embedding.quantized_embedding.empty();
+  const int size = quantized ? embedding.quantized_embedding.size()
+                             : embedding.float_embedding.size();
+  if (size == 0) {
+    return CreateStatusWithPayload(absl::StatusCode::kInvalidArgument,
+                                   "Embedding is empty",
+                                   MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  if (dimension_ == 0) {
+    return absl::OkStatus();
+  }
+  if (quantized != quantized_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected a %s embedding, as the index only holds %s "
+                        "embeddings",
+                        quantized_ ? "quantized" : "float",
+                        quantized_ ? "quantized" : "float"),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  if (size != dimension_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected an embedding of size %d, got %d", dimension_,
+                        size),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<int> EmbeddingIndex::Add(const Embedding& embedding) {
+  if (read_only_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kFailedPrecondition,
+        "Cannot add embeddings to an index created from a file",
+        MediaPipeTasksStatus::kError);
+  }
+  MP_RETURN_IF_ERROR(CheckEmbedding(embedding));
+  bool non_zero = false;
+  if (!embedding.quantized_embedding.empty()) {
+    for (char value : embedding.quantized_embedding) {
+      non_zero |= value != 0;
+    }
+  } else {
+    for (float value : embedding.float_embedding) {
+      non_zero |= value != 0.0f;
+    }
+  }
+  if (!non_zero) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Cannot add an embedding with 0 norm to the index",
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  if (dimension_ == 0) {
+    quantized_ = !embedding.quantized_embedding.empty();
+    dimension_ = quantized_ ? embedding.quantized_embedding.size()
+                            : embedding.float_embedding.size();
+  }
+  if (quantized_) {
+    for (char value : embedding.quantized_embedding) {
+      owned_quantized_values_.push_back(static_cast<int8_t>(value));
+    }
+  } else {
+    owned_float_values_.insert(owned_float_values_.end(),
+                               embedding.float_embedding.begin(),
+                               embedding.float_embedding.end());
+  }
+  const int id = owned_ids_.size();
+  owned_ids_.push_back(id);
+  UpdateViews();
+  return id;
+}
+
+std::vector<float> EmbeddingIndex::GetFloatRow(int row) const {
+  if (quantized_) {
+    absl::Span<const int8_t> values =
+        quantized_values_.subspan(row * dimension_, dimension_);
+    return std::vector<float>(values.begin(), values.end());
+  }
+  absl::Span<const float> values =
+      float_values_.subspan(row * dimension_, dimension_);
+  return std::vector<float>(values.begin(), values.end());
+}
+
+absl::Status EmbeddingIndex::Build() {
+  if (read_only_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kFailedPrecondition,
+        "Cannot build an index created from a file",
+        MediaPipeTasksStatus::kError);
+  }
+  const int n = size();
+  if (options_.num_lists <= 0 || n == 0) {
+    return absl::OkStatus();
+  }
+  const int num_lists = std::min(options_.num_lists, n);
+
+  // Clusters the normalized embeddings with spherical k-means, starting from
+  // evenly spaced embeddings so that builds are deterministic.
+  std::vector<float> rows(static_cast<size_t>(n) * dimension_);
+  for (int r = 0; r < n; ++r) {
+    std::vector<float> row = GetFloatRow(r);
+    Normalize(absl::MakeSpan(row));
+    std::copy(row.begin(), row.end(), rows.begin() + r * dimension_);
+  }
+  std::vector<float> centroids(static_cast<size_t>(num_lists) * dimension_);
+  for (int c = 0; c < num_lists; ++c) {
+    const int r = static_cast<int64_t>(c) * n / num_lists;
+    std::copy_n(rows.begin() + r * dimension_, dimension_,
+                centroids.begin() + c * dimension_);
+  }
+  std::vector<int> assignments(n);
+  std::vector<float> sums(centroids.size());
+  for (int iteration = 0; iteration < options_.num_training_iterations;
+       ++iteration) {
+    std::fill(sums.begin(), sums.end(), 0.0f);
+    for (int r = 0; r < n; ++r) {
+      const float* row = &rows[r * dimension_];
+      const int c = NearestCentroid(centroids, row, dimension_);
+      assignments[r] = c;
+      for (int i = 0; i < dimension_; ++i) {
+        sums[c * dimension_ + i] += row[i];
+      }
+    }
+    for (int c = 0; c < num_lists; ++c) {
+      // Keeps the previous centroid of empty clusters.
+      absl::Span<float> sum =
+          absl::MakeSpan(&sums[c * dimension_], dimension_);
+      if (Normalize(sum)) {
+        std::copy(sum.begin(), sum.end(), centroids.begin() + c * dimension_);
+      }
+    }
+  }
+  for (int r = 0; r < n; ++r) {
+    assignments[r] = NearestCentroid(centroids, &rows[r * dimension_],
+                                     dimension_);
+  }
+
+  // Stores the embeddings of each list contiguously.
+  std::vector<int32_t> list_offsets(num_lists + 1, 0);
+  for (int c : assignments) {
+    ++list_offsets[c + 1];
+  }
+  for (int c = 0; c < num_lists; ++c) {
+    list_offsets[c + 1] += list_offsets[c];
+  }
+  std::vector<int32_t> next_rows(list_offsets.begin(), list_offsets.end() - 1);
+  std::vector<int32_t> ids(n);
+  std::vector<float> float_values(quantized_ ? 0 : owned_float_values_.size());
+  std::vector<int8_t> quantized_values(
+      quantized_ ? owned_quantized_values_.size() : 0);
+  for (int r = 0; r < n; ++r) {
+    const int new_row = next_rows[assignments[r]]++;
+    ids[new_row] = owned_ids_[r];
+    if (quantized_) {
+      std::copy_n(owned_quantized_values_.begin() + r * dimension_, dimension_,
+                  quantized_values.begin() + new_row * dimension_);
+    } else {
+      std::copy_n(owned_float_values_.begin() + r * dimension_, dimension_,
+                  float_values.begin() + new_row * dimension_);
+    }
+  }
+  owned_ids_ = std::move(ids);
+  owned_list_offsets_ = std::move(list_offsets);
+  owned_centroids_ = std::move(centroids);
+  owned_float_values_ = std::move(float_values);
+  owned_quantized_values_ = std::move(quantized_values);
+  UpdateViews();
+  return absl::OkStatus();
+}
+
+absl::Status EmbeddingIndex::SearchRows(
+    const Embedding& query, int begin, int end,
+    std::vector<EmbeddingSearchResult>& results) const {
+  if (begin >= end) {
+    return absl::OkStatus();
+  }
+  std::vector<double> similarities;
+  if (quantized_) {
+    ASSIGN_OR_RETURN(
+        similarities,
+        CosineSimilarityBatch(
+            query, quantized_values_.subspan(begin * dimension_,
+                                             (end - begin) * dimension_)));
+  } else {
+    ASSIGN_OR_RETURN(
+        similarities,
+        CosineSimilarityBatch(
+            query, float_values_.subspan(begin * dimension_,
+                                         (end - begin) * dimension_)));
+  }
+  for (int r = begin; r < end; ++r) {
+    results.push_back({ids_[r], similarities[r - begin]});
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<EmbeddingSearchResult>> EmbeddingIndex::Search(
+    const Embedding& query, int max_results) const {
+  MP_RETURN_IF_ERROR(CheckEmbedding(query));
+  std::vector<EmbeddingSearchResult> results;
+  if (max_results <= 0 || size() == 0) {
+    return results;
+  }
+  if (list_offsets_.empty()) {
+    MP_RETURN_IF_ERROR(SearchRows(query, 0, size(), results));
+  } else {
+    // Searches the lists whose centroids are the most similar to the query,
+    // and the embeddings added after Build().
+    std::vector<float> query_values = query.float_embedding;
+    if (quantized_) {
+      for (char value : query.quantized_embedding) {
+        query_values.push_back(static_cast<int8_t>(value));
+      }
+    }
+    if (!Normalize(absl::MakeSpan(query_values))) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "Cannot search for an embedding with 0 norm",
+          MediaPipeTasksStatus::kInvalidArgumentError);
+    }
+    const int num_lists = list_offsets_.size() - 1;
+    std::vector<std::pair<float, int>> lists(num_lists);
+    for (int c = 0; c < num_lists; ++c) {
+      lists[c] = {Dot(&centroids_[c * dimension_], query_values.data(),
+                      dimension_),
+                  c};
+    }
+    const int num_probes =
+        std::clamp(options_.num_probes, 1, std::max(num_lists, 1));
+    std::partial_sort(lists.begin(), lists.begin() + num_probes, lists.end(),
+                      [](const auto& a, const auto& b) {
+                        return a.first > b.first ||
+                               (a.first == b.first && a.second < b.second);
+                      });
+    for (int p = 0; p < num_probes; ++p) {
+      const int c = lists[p].second;
+      MP_RETURN_IF_ERROR(
+          SearchRows(query, list_offsets_[c], list_offsets_[c + 1], results));
+    }
+    MP_RETURN_IF_ERROR(
+        SearchRows(query, list_offsets_.back(), size(), results));
+  }
+  const int num_results = std::min<int>(max_results, results.size());
+  std::partial_sort(
+      results.begin(), results.begin() + num_results, results.end(),
+      [](const EmbeddingSearchResult& a, const EmbeddingSearchResult& b) {
+        return a.similarity > b.similarity ||
+               (a.similarity == b.similarity && a.id < b.id);
+      });
+  results.resize(num_results);
+  return results;
+}
+
+std::string EmbeddingIndex::Serialize() const {
+  FileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.flags = quantized_ ? kQuantizedFlag : 0;
+  header.dimension = dimension_;
+  header.num_embeddings = size();
+  header.num_lists = list_offsets_.empty() ? 0 : list_offsets_.size() - 1;
+  std::string buffer(reinterpret_cast<const char*>(&header), sizeof(header));
+  AppendBytes(ids_, buffer);
+  AppendBytes(list_offsets_, buffer);
+  AppendBytes(centroids_, buffer);
+  if (quantized_) {
+    AppendBytes(quantized_values_, buffer);
+  } else {
+    AppendBytes(float_values_, buffer);
+  }
+  return buffer;
+}
+
+absl::Status EmbeddingIndex::WriteToFile(const std::string& path) const {
+  return file::SetContents(path, Serialize());
+}
+
+void EmbeddingIndex::UpdateViews() {
+  ids_ = owned_ids_;
+  list_offsets_ = owned_list_offsets_;
+  centroids_ = owned_centroids_;
+  float_values_ = owned_float_values_;
+  quantized_values_ = owned_quantized_values_;
+}
+
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
@@ -0,0 +1,183 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_EMBEDDING_INDEX_H_
+#define MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_EMBEDDING_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
+#include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+
+// Options for configuring an EmbeddingIndex.
+struct EmbeddingIndexOptions {
+  // The number of inverted lists, i.e. clusters of similar embeddings, that
+  // Build() partitions the embeddings into. Searches then only compare the
+  // query against the embeddings of the `num_probes` lists whose centroids
+  // are the most similar to the query, which is approximate. If 0, searches
+  // compare the query against all the embeddings, which is exact.
+  int num_lists = 0;
+
+  // The number of inverted lists searched per query.
+  int num_probes = 1;
+
+  // The number of k-means iterations run by Build() to cluster the
+  // embeddings.
+  int num_training_iterations = 10;
+};
+
+// A result of EmbeddingIndex::Search().
+struct EmbeddingSearchResult {
+  // The id of the embedding, i.e. the number of embeddings added to the index
+  // before it.
+  int id;
+  // The cosine similarity between the query and the embedding.
+  double similarity;
+};
+
+// An index of embeddings, such as those returned by the ImageEmbedder,
+// TextEmbedder and AudioEmbedder tasks, to search for the embeddings most
+// similar to a query embedding by cosine similarity.
+//
+// The embeddings are stored contiguously, as float values or as the int8
+// values of scalar-quantized embeddings, depending on the type of the first
+// embedding added, i.e. on the `quantize` option of the embedder. All the
+// embeddings of an index must have the same type and size.
+//
+// Searches compare the query against all the embeddings, or with
+// `num_lists` set, against the embeddings of the inverted lists closest to the
+// query (IVF). Embeddings added after Build() are always compared until the
+// next Build().
+//
+// An index can be written to a file and created from it without copying the
+// embeddings, by mapping the file in memory. Such an index is read-only.
+// Files use the native byte order.
+//
+// Example usage:
+//
+//   EmbeddingIndex index({.num_lists = 64, .num_probes = 4});
+//   for (const auto& result : embedder_results) {
+//     ASSIGN_OR_RETURN(int id, index.Add(result.embeddings[0]));
+//   }
+//   MP_RETURN_IF_ERROR(index.Build());
+//   ASSIGN_OR_RETURN(auto neighbors,
+//                    index.Search(query.embeddings[0], /*max_results=*/5));
+//
+// This class is thread-compatible: concurrent Search() calls are safe.
+class EmbeddingIndex {
+ public:
+  explicit EmbeddingIndex(EmbeddingIndexOptions options = {});
+
+  // Creates a read-only index from the file at `path` written by
+  // WriteToFile(), which is mapped in memory for the lifetime of the index.
+  static absl::StatusOr<std::unique_ptr<EmbeddingIndex>> CreateFromFile(
+      const std::string& path, EmbeddingIndexOptions options = {});
+
+  // Creates a read-only index from `buffer`, the contents of a file written by
+  // WriteToFile(), which must be 4-byte aligned and outlive the index. Only
+  // `num_probes` of `options` applies.
+  static absl::StatusOr<std::unique_ptr<EmbeddingIndex>> CreateFromBuffer(
+      absl::string_view buffer, EmbeddingIndexOptions options = {});
+
+  EmbeddingIndex(const EmbeddingIndex&) = delete;
+  EmbeddingIndex& operator=(const EmbeddingIndex&) = delete;
+
+  // Adds `embedding` to the index and returns its id. Returns an error if the
+  // embedding is empty or has an L2-norm of 0, or if its type or size differs
+  // from those of the embeddings already added.
+  absl::StatusOr<int> Add(const containers::Embedding& embedding);
+
+  // Partitions the embeddings into `num_lists` inverted lists with k-means.
+  // Does nothing if `num_lists` is 0.
+  absl::Status Build();
+
+  // Returns the at most `max_results` embeddings most similar to `query`, by
+  // decreasing cosine similarity.
+  absl::StatusOr<std::vector<EmbeddingSearchResult>> Search(
+      const containers::Embedding& query, int max_results) const;
+
+  // Returns the number of embeddings in the index.
+  int size() const { return ids_.size(); }
+
+  // Returns the contents of the index file, see CreateFromBuffer().
+  std::string Serialize() const;
+
+  // Writes the index to the file at `path`, see CreateFromFile().
+  absl::Status WriteToFile(const std::string& path) const;
+
+ private:
+  // Validates the type and size of `embedding` against those of the index.
+  absl::Status CheckEmbedding(const containers::Embedding& embedding) const;
+
+  // Returns row `row` of the embeddings as float values.
+  std::vector<float> GetFloatRow(int row) const;
+
+  // Appends the similarities between `query` and the embeddings of rows
+  // [`begin`, `end`) to `results`.
+  absl::Status SearchRows(const containers::Embedding& query, int begin,
+                          int end,
+                          std::vector<EmbeddingSearchResult>& results) const;
+
+  // Points the views at the owned storage.
+  void UpdateViews();
+
+  EmbeddingIndexOptions options_;
+  int dimension_ = 0;
+  bool quantized_ = false;
+  // Whether the index views a buffer rather than owning its storage.
+  bool read_only_ = false;
+
+  // The storage of an index built in memory.
+  std::vector<int32_t> owned_ids_;
+  std::vector<int32_t> owned_list_offsets_;
+  std::vector<float> owned_centroids_;
+  std::vector<float> owned_float_values_;
+  std::vector<int8_t> owned_quantized_values_;
+
+  // The id of the embedding of each row.
+  absl::Span<const int32_t> ids_;
+  // The first row of each inverted list, and the end of the last list. The
+  // rows from the end of the last list on are not in any list.
+  absl::Span<const int32_t> list_offsets_;
+  // The normalized centroid of each inverted list.
+  absl::Span<const float> centroids_;
+  // The row-major embeddings, as float or quantized values.
+  absl::Span<const float> float_values_;
+  absl::Span<const int8_t> quantized_values_;
+
+  // The file mapped in memory, for an index created from a file.
+  std::unique_ptr<core::proto::ExternalFile> external_file_;
+  std::unique_ptr<core::ExternalFileHandler> file_handler_;
+};
+
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_EMBEDDING_INDEX_H_
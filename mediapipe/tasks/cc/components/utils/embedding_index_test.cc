@@ -0,0 +1,243 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/components/utils/embedding_index.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+namespace {
+
+using ::mediapipe::tasks::components::containers::Embedding;
+using ::testing::DoubleNear;
+using ::testing::HasSubstr;
+
+constexpr int kDimension = 16;
+constexpr int kNumEmbeddings = 200;
+
+// Helper function to generate float Embedding.
+Embedding BuildFloatEmbedding(std::vector<float> values) {
+  Embedding embedding;
+  embedding.float_embedding = values;
+  return embedding;
+}
+
+// Helper function to generate quantized Embedding.
+Embedding BuildQuantizedEmbedding(std::vector<int8_t> values) {
+  Embedding embedding;
+  uint8_t* data = reinterpret_cast<uint8_t*>(values.data());
+  embedding.quantized_embedding = {data, data + values.size()};
+  return embedding;
+}
+
+// Returns the deterministic pseudo-random embedding `i`, with values in
+// [-127, 127].
+std::vector<int8_t> GetValues(int i) {
+  std::vector<int8_t> values(kDimension);
+  uint32_t state = 2654435761u * (i + 1);
+  for (int j = 0; j < kDimension; ++j) {
+    state = state * 1664525u + 1013904223u;
+    values[j] = static_cast<int>(state >> 24) % 255 - 127;
+  }
+  values[i % kDimension] = 127;
+  return values;
+}
+
+Embedding GetFloatEmbedding(int i) {
+  std::vector<int8_t> values = GetValues(i);
+  return BuildFloatEmbedding({values.begin(), values.end()});
+}
+
+Embedding GetQuantizedEmbedding(int i) {
+  return BuildQuantizedEmbedding(GetValues(i));
+}
+
+void ExpectFindsEachEmbedding(const EmbeddingIndex& index, bool quantized) {
+  for (int i = 0; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(
+        auto results,
+        index.Search(quantized ? GetQuantizedEmbedding(i)
+                               : GetFloatEmbedding(i),
+                     /*max_results=*/3));
+    ASSERT_FALSE(results.empty());
+    EXPECT_EQ(results[0].id, i);
+    EXPECT_THAT(results[0].similarity, DoubleNear(1.0, 1e-6));
+  }
+}
+
+TEST(EmbeddingIndex, FlatSearchReturnsSortedResults) {
+  EmbeddingIndex index;
+  MP_ASSERT_OK_AND_ASSIGN(int id0, index.Add(BuildFloatEmbedding({1, 0})));
+  MP_ASSERT_OK_AND_ASSIGN(int id1, index.Add(BuildFloatEmbedding({0, 1})));
+  MP_ASSERT_OK_AND_ASSIGN(int id2, index.Add(BuildFloatEmbedding({1, 1})));
+  EXPECT_EQ(id0, 0);
+  EXPECT_EQ(id1, 1);
+  EXPECT_EQ(id2, 2);
+  EXPECT_EQ(index.size(), 3);
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto results,
+      index.Search(BuildFloatEmbedding({1, 0.1}), /*max_results=*/2));
+
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0].id, 0);
+  EXPECT_THAT(results[0].similarity, DoubleNear(0.995037, 1e-6));
+  EXPECT_EQ(results[1].id, 2);
+  EXPECT_THAT(results[1].similarity, DoubleNear(0.773957, 1e-6));
+}
+
+TEST(EmbeddingIndex, FailsWithMismatchedEmbeddings) {
+  EmbeddingIndex index;
+  MP_ASSERT_OK(index.Add(BuildFloatEmbedding({1, 0})));
+
+  auto status = index.Add(BuildFloatEmbedding({1, 0, 0}));
+  EXPECT_EQ(status.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.status().message(),
+              HasSubstr("Expected an embedding of size 2"));
+
+  status = index.Add(BuildQuantizedEmbedding({1, 0}));
+  EXPECT_EQ(status.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.status().message(),
+              HasSubstr("Expected a float embedding"));
+
+  status = index.Add(BuildFloatEmbedding({0, 0}));
+  EXPECT_EQ(status.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.status().message(), HasSubstr("0 norm"));
+}
+
+TEST(EmbeddingIndex, IvfSearchFindsEachFloatEmbedding) {
+  EmbeddingIndex index({.num_lists = 8, .num_probes = 2});
+  for (int i = 0; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK(index.Add(GetFloatEmbedding(i)));
+  }
+  MP_ASSERT_OK(index.Build());
+
+  ExpectFindsEachEmbedding(index, /*quantized=*/false);
+}
+
+TEST(EmbeddingIndex, IvfSearchFindsEachQuantizedEmbedding) {
+  EmbeddingIndex index({.num_lists = 8, .num_probes = 2});
+  for (int i = 0; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK(index.Add(GetQuantizedEmbedding(i)));
+  }
+  MP_ASSERT_OK(index.Build());
+
+  ExpectFindsEachEmbedding(index, /*quantized=*/true);
+}
+
+TEST(EmbeddingIndex, IvfSearchWithAllListsMatchesFlatSearch) {
+  EmbeddingIndex flat_index;
+  EmbeddingIndex ivf_index({.num_lists = 8, .num_probes = 8});
+  for (int i = 0; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK(flat_index.Add(GetFloatEmbedding(i)));
+    MP_ASSERT_OK(ivf_index.Add(GetFloatEmbedding(i)));
+  }
+  MP_ASSERT_OK(ivf_index.Build());
+
+  for (int i = 0; i < kNumEmbeddings; i += 7) {
+    Embedding query = GetFloatEmbedding(kNumEmbeddings + i);
+    MP_ASSERT_OK_AND_ASSIGN(auto flat_results,
+                            flat_index.Search(query, /*max_results=*/5));
+    MP_ASSERT_OK_AND_ASSIGN(auto ivf_results,
+                            ivf_index.Search(query, /*max_results=*/5));
+    ASSERT_EQ(flat_results.size(), ivf_results.size());
+    for (int j = 0; j < flat_results.size(); ++j) {
+      EXPECT_EQ(flat_results[j].id, ivf_results[j].id);
+    }
+  }
+}
+
+TEST(EmbeddingIndex, SearchesEmbeddingsAddedAfterBuild) {
+  EmbeddingIndex index({.num_lists = 8, .num_probes = 1});
+  for (int i = 0; i < kNumEmbeddings - 10; ++i) {
+    MP_ASSERT_OK(index.Add(GetFloatEmbedding(i)));
+  }
+  MP_ASSERT_OK(index.Build());
+  for (int i = kNumEmbeddings - 10; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK(index.Add(GetFloatEmbedding(i)));
+  }
+
+  for (int i = kNumEmbeddings - 10; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(
+        auto results, index.Search(GetFloatEmbedding(i), /*max_results=*/1));
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].id, i);
+  }
+}
+
+TEST(EmbeddingIndex, CreatesFromBuffer) {
+  EmbeddingIndex index({.num_lists = 8, .num_probes = 2});
+  for (int i = 0; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK(index.Add(GetQuantizedEmbedding(i)));
+  }
+  MP_ASSERT_OK(index.Build());
+  const std::string buffer = index.Serialize();
+
+  MP_ASSERT_OK_AND_ASSIGN(auto loaded_index,
+                          EmbeddingIndex::CreateFromBuffer(
+                              buffer, {.num_lists = 8, .num_probes = 2}));
+
+  EXPECT_EQ(loaded_index->size(), kNumEmbeddings);
+  ExpectFindsEachEmbedding(*loaded_index, /*quantized=*/true);
+  auto status = loaded_index->Add(GetQuantizedEmbedding(0));
+  EXPECT_EQ(status.status().code(), absl::StatusCode::kFailedPrecondition);
+}
+
+TEST(EmbeddingIndex, CreatesFromFile) {
+  EmbeddingIndex index;
+  for (int i = 0; i < kNumEmbeddings; ++i) {
+    MP_ASSERT_OK(index.Add(GetFloatEmbedding(i)));
+  }
+  const std::string path =
+      absl::StrCat(getenv("TEST_TMPDIR"), "/embedding_index");
+  MP_ASSERT_OK(index.WriteToFile(path));
+
+  MP_ASSERT_OK_AND_ASSIGN(auto loaded_index,
+                          EmbeddingIndex::CreateFromFile(path));
+
+  EXPECT_EQ(loaded_index->size(), kNumEmbeddings);
+  ExpectFindsEachEmbedding(*loaded_index, /*quantized=*/false);
+}
+
+TEST(EmbeddingIndex, FailsWithInvalidBuffer) {
+  EmbeddingIndex index;
+  MP_ASSERT_OK(index.Add(BuildFloatEmbedding({1, 0})));
+  std::string buffer = index.Serialize();
+  buffer.resize(buffer.size() - 1);
+
+  auto status = EmbeddingIndex::CreateFromBuffer(buffer);
+
+  EXPECT_EQ(status.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.status().message(),
+              HasSubstr("Invalid embedding index file"));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
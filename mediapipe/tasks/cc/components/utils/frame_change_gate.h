@@ -0,0 +1,75 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_FRAME_CHANGE_GATE_H_
+#define MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_FRAME_CHANGE_GATE_H_
+
+#include "mediapipe/calculators/image/frame_change_gate_calculator.pb.h"
+#include "mediapipe/framework/api2/builder.h"
+#include "mediapipe/framework/formats/image.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+
+// Utility class that skips inference on near-static frames. The inputs of the
+// inference are passed through Gate(), and its outputs through Reuse(), which
+// re-emits the previous outputs at the timestamps of skipped frames:
+//
+//   FrameChangeGate gate(options, image_in, graph);
+//   gate.Gate(input_tensors) >> inference.In("TENSORS");
+//   auto output_tensors = gate.Reuse(inference.Out("TENSORS"));
+class FrameChangeGate {
+ public:
+  FrameChangeGate(const FrameChangeGateCalculatorOptions& options,
+                  api2::builder::Source<Image> image,
+                  api2::builder::Graph& graph)
+      : gate_node_(graph.AddNode("FrameChangeGateCalculator")),
+        cloner_node_(graph.AddNode("PacketClonerCalculator")) {
+    gate_node_.GetOptions<FrameChangeGateCalculatorOptions>() = options;
+    image >> gate_node_.In("IMAGE");
+    image >> cloner_node_.In("TICK");
+  }
+
+  // Move-only
+  FrameChangeGate(FrameChangeGate&& gate) = default;
+  FrameChangeGate& operator=(FrameChangeGate&& gate) = default;
+
+  template <typename T>
+  api2::builder::Source<T> Gate(api2::builder::Source<T> source) {
+    source >> gate_node_.In(gate_index_);
+    return gate_node_.Out(gate_index_++).Cast<T>();
+  }
+
+  template <typename T>
+  api2::builder::Source<T> Reuse(api2::builder::Source<T> source) {
+    source >> cloner_node_.In(reuse_index_);
+    return cloner_node_.Out(reuse_index_++).Cast<T>();
+  }
+
+ private:
+  api2::builder::GenericNode& gate_node_;
+  api2::builder::GenericNode& cloner_node_;
+  int gate_index_ = 0;
+  int reuse_index_ = 0;
+};
+
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_FRAME_CHANGE_GATE_H_
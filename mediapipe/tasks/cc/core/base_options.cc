@@ -97,6 +97,16 @@ proto::BaseOptions ConvertBaseOptionsToProto(BaseOptions* base_options) {
           base_options->model_asset_descriptor_meta.offset);
     }
   }
+  const BaseOptions::MmapOptions& mmap_options =
+      base_options->model_asset_mmap_options;
+  if (mmap_options.will_need || mmap_options.huge_pages ||
+      mmap_options.prefault_async) {
+    auto* mmap_options_proto =
+        base_options_proto.mutable_model_asset()->mutable_mmap_options();
+    mmap_options_proto->set_will_need(mmap_options.will_need);
+    mmap_options_proto->set_huge_pages(mmap_options.huge_pages);
+    mmap_options_proto->set_prefault_async(mmap_options.prefault_async);
+  }
   switch (base_options->delegate) {
     case BaseOptions::Delegate::CPU:
       base_options_proto.mutable_acceleration()->mutable_tflite();
@@ -116,6 +126,9 @@ proto::BaseOptions ConvertBaseOptionsToProto(BaseOptions* base_options) {
           ->set_accelerator_name("google-edgetpu");
       break;
   }
+  if (base_options->share_model_resources) {
+    base_options_proto.set_share_model_resources(true);
+  }
   return base_options_proto;
 }
 }  // namespace core
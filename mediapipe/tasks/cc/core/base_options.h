@@ -91,6 +91,20 @@ struct BaseOptions {
     int offset = -1;
   } model_asset_descriptor_meta;
 
+  // Hints for mapping the model asset into memory when it is given by
+  // `model_asset_path` or `model_asset_descriptor_meta`, to take the page
+  // faults of large models off the first inference.
+  struct MmapOptions {
+    // Advises the kernel to read the whole model ahead (MADV_WILLNEED).
+    bool will_need = false;
+
+    // Advises the kernel to use transparent huge pages (MADV_HUGEPAGE).
+    bool huge_pages = false;
+
+    // Touches every page of the model on a background thread.
+    bool prefault_async = false;
+  } model_asset_mmap_options;
+
   // A non-default OpResolver to support custom Ops or specify a subset of
   // built-in Ops.
   std::unique_ptr<tflite::OpResolver> op_resolver =
@@ -99,6 +113,11 @@ struct BaseOptions {
   // Options for the chosen delegate. If not set, the default delegate options
   // is used.
   std::optional<std::variant<CpuOptions, GpuOptions>> delegate_options;
+
+  // Whether the model resources may be shared with the other tasks of the
+  // process that load the same model file, to avoid loading the model once per
+  // task. The tasks sharing a model use the op resolver of the first of them.
+  bool share_model_resources = false;
 };
 
 // Converts a BaseOptions to a BaseOptionsProto.
@@ -31,6 +31,17 @@ TEST(BaseOptionsTest, ConvertBaseOptionsToProtoWithFile) {
   EXPECT_TRUE(proto.model_asset().has_file_content());
 }
 
+TEST(BaseOptionsTest, ConvertBaseOptionsToProtoWithMmapOptions) {
+  BaseOptions base_options;
+  base_options.model_asset_path = "model.tflite";
+  base_options.model_asset_mmap_options.will_need = true;
+  base_options.model_asset_mmap_options.prefault_async = true;
+  proto::BaseOptions proto = ConvertBaseOptionsToProto(&base_options);
+  EXPECT_TRUE(proto.model_asset().mmap_options().will_need());
+  EXPECT_FALSE(proto.model_asset().mmap_options().huge_pages());
+  EXPECT_TRUE(proto.model_asset().mmap_options().prefault_async());
+}
+
 TEST(BaseOptionsTest, ConvertBaseOptionsToProtoWithAcceleration) {
   BaseOptions base_options;
   proto::BaseOptions proto = ConvertBaseOptionsToProto(&base_options);
@@ -28,18 +28,28 @@ limitations under the License.
 #include <io.h>
 #include <windows.h>
 #else
+#include <sys/stat.h>
 #include <unistd.h>
 #endif  // _WIN32
 
+#ifdef __ANDROID__
+#include <linux/ashmem.h>
+#include <sys/ioctl.h>
+#endif  // __ANDROID__
+
+#include <algorithm>
 #include <memory>
 #include <string>
 
+#include "absl/log/absl_log.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
@@ -77,6 +87,34 @@ int64_t GetPageSizeAlignedOffset(int64_t offset) {
 #endif  // _WIN32
 }
 
+// Returns the size of the file or shared memory region referred to by fd, or
+// -1 if it can't be determined.
+int64_t GetFileSize(int fd) {
+#ifdef _WIN32
+  // Always use 0 as offset to lseek(2) to get the actual file size, as
+  // SEEK_END returns the size of the file *plus* offset.
+  return lseek(fd, /*offset=*/0, SEEK_END);
+#else
+  // Unlike lseek(2), fstat(2) leaves the file offset of the caller's file
+  // descriptor unchanged, and also works for memfd_create(2) regions.
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    return -1;
+  }
+#ifdef __ANDROID__
+  // Android shared memory (ashmem) regions, such as those of
+  // android.os.SharedMemory, report a size of 0 to fstat(2).
+  if (file_stat.st_size == 0) {
+    const int ashmem_size = ioctl(fd, ASHMEM_GET_SIZE, nullptr);
+    if (ashmem_size > 0) {
+      return ashmem_size;
+    }
+  }
+#endif  // __ANDROID__
+  return file_stat.st_size;
+#endif  // _WIN32
+}
+
 }  // namespace
 
 /* static */
@@ -172,9 +210,8 @@ absl::Status ExternalFileHandler::MapExternalFile() {
     buffer_size_ = external_file_.file_descriptor_meta().length();
 #endif  // _WIN32
   }
-  // Get actual file size. Always use 0 as offset to lseek(2) to get the actual
-  // file size, as SEEK_END returns the size of the file *plus* offset.
-  size_t file_size = lseek(fd, /*offset=*/0, SEEK_END);
+  // Get actual file size.
+  const int64_t file_size = GetFileSize(fd);
   if (file_size <= 0) {
     return CreateStatusWithPayload(
         StatusCode::kUnknown,
@@ -232,9 +269,74 @@ absl::Status ExternalFileHandler::MapExternalFile() {
         absl::StrFormat("Unable to map file to memory buffer, errno=%d", errno),
         MediaPipeTasksStatus::kFileMmapError);
   }
+#ifndef _WIN32
+  ApplyMmapOptions();
+#endif  // _WIN32
   return absl::OkStatus();
 }
 
+#ifndef _WIN32
+void ExternalFileHandler::ApplyMmapOptions() {
+  if (!external_file_.has_mmap_options()) {
+    return;
+  }
+  const proto::MmapOptions& options = external_file_.mmap_options();
+  if (options.huge_pages()) {
+#ifdef MADV_HUGEPAGE
+    if (madvise(buffer_, buffer_aligned_size_, MADV_HUGEPAGE) != 0) {
+      ABSL_LOG(WARNING) << "madvise(MADV_HUGEPAGE) failed, errno=" << errno;
+    }
+#else
+    ABSL_LOG(WARNING) << "Huge pages are not supported on this platform.";
+#endif  // MADV_HUGEPAGE
+  }
+  if (options.will_need() &&
+      madvise(buffer_, buffer_aligned_size_, MADV_WILLNEED) != 0) {
+    ABSL_LOG(WARNING) << "madvise(MADV_WILLNEED) failed, errno=" << errno;
+  }
+  // The ranges are relative to the file contents, which start at
+  // buffer_offset_ - buffer_aligned_offset_ in the page aligned buffer.
+  const int64 content_offset = buffer_offset_ - buffer_aligned_offset_;
+  const int64 page_size = sysconf(_SC_PAGE_SIZE);
+  for (const auto& range : options.locked_ranges()) {
+    const int64 offset = std::clamp<int64>(range.offset(), 0, buffer_size_);
+    int64 length = buffer_size_ - offset;
+    if (range.length() > 0) {
+      length = std::min<int64>(range.length(), length);
+    }
+    if (length <= 0) {
+      continue;
+    }
+    const int64 start = content_offset + offset;
+    const int64 aligned_start = start / page_size * page_size;
+    if (mlock(static_cast<char*>(buffer_) + aligned_start,
+              length + start - aligned_start) != 0) {
+      ABSL_LOG(WARNING) << "mlock of " << length << " bytes at offset "
+                        << offset << " failed, errno=" << errno;
+    }
+  }
+  if (options.prefault_async()) {
+    prefault_thread_ = std::thread([this] { PrefaultPages(); });
+  }
+}
+
+void ExternalFileHandler::PrefaultPages() {
+  const absl::Time start_time = absl::Now();
+  const int64 page_size = sysconf(_SC_PAGE_SIZE);
+  const volatile char* pages = static_cast<const volatile char*>(buffer_);
+  int64 offset = 0;
+  for (; offset < buffer_aligned_size_ &&
+         !stop_prefault_.load(std::memory_order_relaxed);
+       offset += page_size) {
+    pages[offset];
+  }
+  ABSL_VLOG(1) << "Prefaulted " << std::min(offset, buffer_aligned_size_)
+               << " bytes of the mapped file in "
+               << absl::ToDoubleMilliseconds(absl::Now() - start_time)
+               << " ms.";
+}
+#endif  // _WIN32
+
 absl::string_view ExternalFileHandler::GetFileContent() {
   if (!external_file_.file_content().empty()) {
     return external_file_.file_content();
@@ -251,6 +353,12 @@ absl::string_view ExternalFileHandler::GetFileContent() {
 }
 
 ExternalFileHandler::~ExternalFileHandler() {
+#ifndef _WIN32
+  if (prefault_thread_.joinable()) {
+    stop_prefault_.store(true, std::memory_order_relaxed);
+    prefault_thread_.join();
+  }
+#endif  // _WIN32
   if (buffer_) {
 #ifdef _WIN32
     free(buffer_);
@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_CORE_EXTERNAL_FILE_HANDLER_H_
 #define MEDIAPIPE_TASKS_CC_CORE_EXTERNAL_FILE_HANDLER_H_
 
+#include <atomic>
 #include <memory>
+#include <thread>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -62,6 +64,15 @@ class ExternalFileHandler {
   // contents are already loaded in memory.
   absl::Status MapExternalFile();
 
+#ifndef _WIN32
+  // Applies the madvise(2) and mlock(2) hints of the ExternalFile mmap options
+  // to the mapped memory buffer, and starts prefaulting it if requested.
+  void ApplyMmapOptions();
+
+  // Touches every page of the mapped memory buffer until done or stopped.
+  void PrefaultPages();
+#endif  // _WIN32
+
   // Reference to the input ExternalFile.
   const proto::ExternalFile& external_file_;
 
@@ -86,6 +97,11 @@ class ExternalFileHandler {
   // The aligned mapped memory buffer size in bytes taking into account the
   // offset shift introduced by buffer_aligned_memory_offset_, if any.
   int64 buffer_aligned_size_{};
+
+  // The thread prefaulting the mapped memory buffer, if any, and the flag
+  // stopping it before the buffer is unmapped.
+  std::thread prefault_thread_;
+  std::atomic<bool> stop_prefault_{false};
 #endif
 };
 
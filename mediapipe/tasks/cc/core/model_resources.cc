@@ -153,8 +153,8 @@ absl::Status ModelResources::BuildModelFromExternalFileProto() {
   model_packet_ = MakePacket<ModelPtr>(
       model.release(), [](tflite::FlatBufferModel* model) { delete model; });
   ASSIGN_OR_RETURN(auto model_metadata_extractor,
-                   metadata::ModelMetadataExtractor::CreateFromModelBuffer(
-                       buffer_data, buffer_size));
+                   metadata::ModelMetadataExtractor::
+                       CreateFromVerifiedModelBuffer(buffer_data, buffer_size));
   metadata_extractor_packet_ = PacketAdopting<metadata::ModelMetadataExtractor>(
       std::move(model_metadata_extractor));
   return absl::OkStatus();
@@ -15,19 +15,29 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/core/model_resources_cache.h"
 
+#include <sys/stat.h>
+
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/api2/packet.h"
+#include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/core/model_asset_bundle_resources.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+#include "mediapipe/util/resource_util.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 
 namespace mediapipe {
@@ -52,6 +62,12 @@ bool ModelResourcesCache::ModelAssetBundleExists(const std::string& tag) const {
 
 absl::Status ModelResourcesCache::AddModelResources(
     std::unique_ptr<ModelResources> model_resources) {
+  return AddModelResources(
+      std::shared_ptr<const ModelResources>(std::move(model_resources)));
+}
+
+absl::Status ModelResourcesCache::AddModelResources(
+    std::shared_ptr<const ModelResources> model_resources) {
   if (model_resources == nullptr) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument, "ModelResources object is null.",
@@ -101,6 +117,14 @@ absl::StatusOr<const ModelResources*> ModelResourcesCache::GetModelResources(
 
 absl::Status ModelResourcesCache::AddModelAssetBundleResources(
     std::unique_ptr<ModelAssetBundleResources> model_asset_bundle_resources) {
+  return AddModelAssetBundleResources(
+      std::shared_ptr<const ModelAssetBundleResources>(
+          std::move(model_asset_bundle_resources)));
+}
+
+absl::Status ModelResourcesCache::AddModelAssetBundleResources(
+    std::shared_ptr<const ModelAssetBundleResources>
+        model_asset_bundle_resources) {
   if (model_asset_bundle_resources == nullptr) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument,
@@ -166,6 +190,155 @@ ModelResourcesCache::GetGraphOpResolverPacket() const {
   return graph_op_resolver_packet_;
 }
 
+namespace {
+
+// Returns the key identifying the contents of the model file, or nullopt if
+// the model file can't be shared.
+std::optional<std::string> ModelFileKey(const proto::ExternalFile& file) {
+  if (!file.file_content().empty()) {
+    return absl::StrCat("content:", file.file_content().size(), ":",
+                        absl::HashOf(absl::string_view(file.file_content())));
+  }
+  if (file.has_file_pointer_meta()) {
+    return std::nullopt;
+  }
+  struct stat file_stat;
+  if (!file.file_name().empty()) {
+    absl::StatusOr<std::string> path = PathToResourceAsFile(file.file_name());
+    if (!path.ok() || stat(path->c_str(), &file_stat) != 0) {
+      return std::nullopt;
+    }
+    return absl::StrCat("name:", *path, ":", file_stat.st_dev, ":",
+                        file_stat.st_ino, ":", file_stat.st_size, ":",
+                        file_stat.st_mtime);
+  }
+  if (file.has_file_descriptor_meta()) {
+    const auto& meta = file.file_descriptor_meta();
+    if (fstat(meta.fd(), &file_stat) != 0) {
+      return std::nullopt;
+    }
+    return absl::StrCat("fd:", file_stat.st_dev, ":", file_stat.st_ino, ":",
+                        file_stat.st_size, ":", file_stat.st_mtime, ":",
+                        meta.offset(), ":", meta.length());
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+SharedModelResourcesCache& SharedModelResourcesCache::GetInstance() {
+  static SharedModelResourcesCache* instance = new SharedModelResourcesCache();
+  return *instance;
+}
+
+template <typename T, typename CreateFn>
+absl::StatusOr<std::shared_ptr<const T>> SharedModelResourcesCache::GetOrCreate(
+    EntryMap<T>* entries, const std::string& key, CreateFn create) {
+  std::shared_ptr<Entry<T>> entry;
+  {
+    absl::MutexLock lock(&mutex_);
+    std::shared_ptr<Entry<T>>& slot = (*entries)[key];
+    if (slot == nullptr) {
+      slot = std::make_shared<Entry<T>>();
+    }
+    entry = slot;
+  }
+  absl::Status status;
+  {
+    absl::MutexLock entry_lock(&entry->mutex);
+    if (std::shared_ptr<const T> resources = entry->resources.lock()) {
+      return resources;
+    }
+    absl::StatusOr<std::unique_ptr<T>> created = create();
+    if (created.ok()) {
+      std::shared_ptr<const T> resources(
+          created->release(), [this, entries, key](const T* resources) {
+            delete resources;
+            Evict(entries, key);
+          });
+      entry->resources = resources;
+      return resources;
+    }
+    status = created.status();
+  }
+  entry.reset();
+  Evict(entries, key);
+  return status;
+}
+
+template <typename T>
+void SharedModelResourcesCache::Evict(EntryMap<T>* entries,
+                                      const std::string& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = entries->find(key);
+  // Entries are only copied while holding mutex_, so a use count of one means
+  // that no other thread is creating or looking up the resources.
+  if (it == entries->end() || it->second.use_count() > 1) {
+    return;
+  }
+  bool expired;
+  {
+    absl::MutexLock entry_lock(&it->second->mutex);
+    expired = it->second->resources.expired();
+  }
+  if (expired) {
+    entries->erase(it);
+  }
+}
+
+absl::StatusOr<std::shared_ptr<const ModelResources>>
+SharedModelResourcesCache::GetOrCreateModelResources(
+    const std::string& tag, std::unique_ptr<proto::ExternalFile> model_file,
+    api2::Packet<tflite::OpResolver> op_resolver_packet) {
+  auto create = [&]() {
+    return ModelResources::Create(tag, std::move(model_file),
+                                  op_resolver_packet);
+  };
+  std::optional<std::string> file_key = ModelFileKey(*model_file);
+  if (!file_key.has_value()) {
+    ASSIGN_OR_RETURN(std::unique_ptr<ModelResources> model_resources,
+                     create());
+    return std::shared_ptr<const ModelResources>(std::move(model_resources));
+  }
+  return GetOrCreate<ModelResources>(
+      &model_resources_, absl::StrCat(tag, "|", *file_key), create);
+}
+
+absl::StatusOr<std::shared_ptr<const ModelAssetBundleResources>>
+SharedModelResourcesCache::GetOrCreateModelAssetBundleResources(
+    const std::string& tag,
+    std::unique_ptr<proto::ExternalFile> model_asset_bundle_file) {
+  auto create = [&]() {
+    return ModelAssetBundleResources::Create(
+        tag, std::move(model_asset_bundle_file));
+  };
+  std::optional<std::string> file_key = ModelFileKey(*model_asset_bundle_file);
+  if (!file_key.has_value()) {
+    ASSIGN_OR_RETURN(
+        std::unique_ptr<ModelAssetBundleResources> model_bundle_resources,
+        create());
+    return std::shared_ptr<const ModelAssetBundleResources>(
+        std::move(model_bundle_resources));
+  }
+  return GetOrCreate<ModelAssetBundleResources>(
+      &model_asset_bundle_resources_, absl::StrCat(tag, "|", *file_key),
+      create);
+}
+
+int SharedModelResourcesCache::NumSharedResources() {
+  absl::MutexLock lock(&mutex_);
+  int num_resources = 0;
+  for (const auto& [key, entry] : model_resources_) {
+    absl::MutexLock entry_lock(&entry->mutex);
+    num_resources += entry->resources.expired() ? 0 : 1;
+  }
+  for (const auto& [key, entry] : model_asset_bundle_resources_) {
+    absl::MutexLock entry_lock(&entry->mutex);
+    num_resources += entry->resources.expired() ? 0 : 1;
+  }
+  return num_resources;
+}
+
 }  // namespace core
 }  // namespace tasks
 }  // namespace mediapipe
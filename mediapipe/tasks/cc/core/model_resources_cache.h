@@ -24,10 +24,12 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/tasks/cc/core/model_asset_bundle_resources.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 
 namespace mediapipe {
@@ -57,6 +59,12 @@ class ModelResourcesCache {
   absl::Status AddModelResources(
       std::unique_ptr<ModelResources> model_resources);
 
+  // Adds a ModelResources object that may be shared with other caches, e.g.
+  // one obtained from SharedModelResourcesCache, into the cache.
+  // The tag of the ModelResources must be unique.
+  absl::Status AddModelResources(
+      std::shared_ptr<const ModelResources> model_resources);
+
   // Adds a collection of the ModelResources objects into the cache.
   // The tag of the each ModelResources must be unique; the ownership of
   // every ModelResource will be transferred into the cache.
@@ -73,6 +81,13 @@ class ModelResourcesCache {
   absl::Status AddModelAssetBundleResources(
       std::unique_ptr<ModelAssetBundleResources> model_asset_bundle_resources);
 
+  // Adds a ModelAssetBundleResources object that may be shared with other
+  // caches into the cache.
+  // The tag of the ModelAssetBundleResources must be unique.
+  absl::Status AddModelAssetBundleResources(
+      std::shared_ptr<const ModelAssetBundleResources>
+          model_asset_bundle_resources);
+
   // Adds a collection of the ModelAssetBundleResources objects into the cache.
   // The tag of the each ModelAssetBundleResources must be unique; the ownership
   // of every ModelAssetBundleResources will be transferred into the cache.
@@ -93,15 +108,84 @@ class ModelResourcesCache {
   api2::Packet<tflite::OpResolver> graph_op_resolver_packet_;
 
   // A collection of ModelResources objects for the models in the graph.
-  absl::flat_hash_map<std::string, std::unique_ptr<ModelResources>>
+  absl::flat_hash_map<std::string, std::shared_ptr<const ModelResources>>
       model_resources_collection_;
 
   // A collection of ModelAssetBundleResources objects for the model bundles in
   // the graph.
-  absl::flat_hash_map<std::string, std::unique_ptr<ModelAssetBundleResources>>
+  absl::flat_hash_map<std::string,
+                      std::shared_ptr<const ModelAssetBundleResources>>
       model_asset_bundle_resources_collection_;
 };
 
+// Process-wide cache that lets task graphs of different CalculatorGraphs, e.g.
+// several TaskRunners running the same model, share a single ModelResources or
+// ModelAssetBundleResources object, and with it a single copy of the model
+// flatbuffer and of its metadata. Task graphs opt in with the
+// `share_model_resources` field of their BaseOptions.
+//
+// Resources are keyed by their tag and by the identity of the model file: the
+// resolved path, device, inode, size and modification time of a file given by
+// name, the device, inode, size, offset and length of a file given by
+// descriptor, or the size and hash of in-memory file contents. Files given by
+// `file_pointer_meta` are never shared, as their memory is owned by the
+// caller. The cache only holds weak references, so resources are released as
+// soon as the last graph using them is destroyed.
+//
+// Shared ModelResources keep the op resolver of the graph that created them.
+// Graphs should only opt in if the op resolvers of all graphs sharing a model
+// support the ops of that model.
+class SharedModelResourcesCache {
+ public:
+  // Returns the process-wide instance.
+  static SharedModelResourcesCache& GetInstance();
+
+  // Returns the shared ModelResources for the tag and the model file, creating
+  // them from `model_file` and `op_resolver_packet` if they don't exist.
+  absl::StatusOr<std::shared_ptr<const ModelResources>>
+  GetOrCreateModelResources(
+      const std::string& tag, std::unique_ptr<proto::ExternalFile> model_file,
+      api2::Packet<tflite::OpResolver> op_resolver_packet);
+
+  // Returns the shared ModelAssetBundleResources for the tag and the model
+  // asset bundle file, creating them from `model_asset_bundle_file` if they
+  // don't exist.
+  absl::StatusOr<std::shared_ptr<const ModelAssetBundleResources>>
+  GetOrCreateModelAssetBundleResources(
+      const std::string& tag,
+      std::unique_ptr<proto::ExternalFile> model_asset_bundle_file);
+
+  // Returns the number of resources objects currently shared.
+  int NumSharedResources();
+
+ private:
+  template <typename T>
+  struct Entry {
+    // Serializes the creation of the resources of the entry.
+    absl::Mutex mutex;
+    std::weak_ptr<const T> resources ABSL_GUARDED_BY(mutex);
+  };
+
+  template <typename T>
+  using EntryMap = absl::flat_hash_map<std::string, std::shared_ptr<Entry<T>>>;
+
+  SharedModelResourcesCache() = default;
+
+  template <typename T, typename CreateFn>
+  absl::StatusOr<std::shared_ptr<const T>> GetOrCreate(
+      EntryMap<T>* entries, const std::string& key, CreateFn create);
+
+  // Removes the entry of the key once its resources were released, unless
+  // another thread is looking the entry up.
+  template <typename T>
+  void Evict(EntryMap<T>* entries, const std::string& key);
+
+  absl::Mutex mutex_;
+  EntryMap<ModelResources> model_resources_ ABSL_GUARDED_BY(mutex_);
+  EntryMap<ModelAssetBundleResources> model_asset_bundle_resources_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 // Global service for mediapipe task model resources cache.
 inline constexpr mediapipe::GraphService<ModelResourcesCache>
     kModelResourcesCacheService("mediapipe::tasks::ModelResourcesCacheService");
@@ -17,6 +17,11 @@ limitations under the License.
 
 #include <fcntl.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // __linux__
+
 #include <cstddef>
 #include <fstream>
 #include <iosfwd>
@@ -148,6 +153,27 @@ TEST_F(ModelResourcesTest, CreateFromFileDescriptor) {
 }
 #endif  // _WIN32
 
+#ifdef __linux__
+TEST_F(ModelResourcesTest, CreateFromSharedMemoryFileDescriptor) {
+  const std::string model_content = LoadBinaryContent(kTestModelPath);
+  const int model_file_descriptor = memfd_create("model", /*flags=*/0);
+  ASSERT_GE(model_file_descriptor, 0);
+  ASSERT_EQ(write(model_file_descriptor, model_content.data(),
+                  model_content.size()),
+            static_cast<ssize_t>(model_content.size()));
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  model_file->mutable_file_descriptor_meta()->set_fd(model_file_descriptor);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  CheckModelResourcesPackets(model_resources.get());
+  // The file offset of the caller's file descriptor is left unchanged.
+  EXPECT_EQ(lseek(model_file_descriptor, 0, SEEK_CUR),
+            static_cast<off_t>(model_content.size()));
+  close(model_file_descriptor);
+}
+#endif  // __linux__
+
 TEST_F(ModelResourcesTest, CreateFromInvalidFile) {
   auto model_file = std::make_unique<proto::ExternalFile>();
   model_file->set_file_name(kInvalidTestModelPath);
@@ -117,7 +117,21 @@ class InferenceSubgraph : public Subgraph {
         inference_node.SideIn(kOpResolverTag);
     graph.In(kTensorsTag) >> inference_node.In(kTensorsTag);
     inference_node.Out(kTensorsTag) >> graph.Out(kTensorsTag);
-    return graph.GetConfig();
+    const int max_batch_size = subgraph_options->batching().max_batch_size();
+    if (max_batch_size <= 1 || inference_delegate.has_gpu()) {
+      return graph.GetConfig();
+    }
+    inference_node.GetOptions<mediapipe::InferenceCalculatorOptions>()
+        .mutable_batching()
+        ->CopyFrom(subgraph_options->batching());
+    // Only the timestamps that are in flight at the same time are batched.
+    CalculatorGraphConfig config = graph.GetConfig();
+    for (auto& node : *config.mutable_node()) {
+      if (node.calculator() == "InferenceCalculator") {
+        node.set_max_in_flight(max_batch_size);
+      }
+    }
+    return config;
   }
 
  private:
@@ -177,6 +191,16 @@ absl::StatusOr<const ModelResources*> ModelTaskGraph::CreateModelResources(
       model_resources_cache_service.GetObject().GetGraphOpResolverPacket());
   const std::string tag =
       absl::StrCat(CreateModelResourcesTag(sc->OriginalNode()), tag_suffix);
+  if (share_model_resources_) {
+    ASSIGN_OR_RETURN(
+        auto model_resources,
+        SharedModelResourcesCache::GetInstance().GetOrCreateModelResources(
+            tag, std::move(external_file), op_resolver_packet));
+    MP_RETURN_IF_ERROR(
+        model_resources_cache_service.GetObject().AddModelResources(
+            std::move(model_resources)));
+    return model_resources_cache_service.GetObject().GetModelResources(tag);
+  }
   ASSIGN_OR_RETURN(auto model_resources,
                    ModelResources::Create(tag, std::move(external_file),
                                           op_resolver_packet));
@@ -226,6 +250,17 @@ ModelTaskGraph::CreateModelAssetBundleResources(
   }
   const std::string tag = absl::StrCat(
       CreateModelAssetBundleResourcesTag(sc->OriginalNode()), tag_suffix);
+  if (share_model_resources_) {
+    ASSIGN_OR_RETURN(auto model_bundle_resources,
+                     SharedModelResourcesCache::GetInstance()
+                         .GetOrCreateModelAssetBundleResources(
+                             tag, std::move(external_file)));
+    MP_RETURN_IF_ERROR(
+        model_resources_cache_service.GetObject().AddModelAssetBundleResources(
+            std::move(model_bundle_resources)));
+    return model_resources_cache_service.GetObject()
+        .GetModelAssetBundleResources(tag);
+  }
   ASSIGN_OR_RETURN(
       auto model_bundle_resources,
       ModelAssetBundleResources::Create(tag, std::move(external_file)));
@@ -61,6 +61,10 @@ class ModelTaskGraph : public Subgraph {
   // authors with the access to the metadata extractor and the tflite model.
   // If more than one model resources are created in a graph, the model
   // resources graph service add the tag_suffix to support multiple resources.
+  // If `share_model_resources` is set in the base options, the model resources
+  // are shared through SharedModelResourcesCache with the graphs of other
+  // CalculatorGraphs loading the same model file, and so are all the
+  // resources created afterwards by this graph.
   template <typename Options>
   absl::StatusOr<const ModelResources*> CreateModelResources(
       SubgraphContext* sc, std::string tag_suffix = "") {
@@ -68,6 +72,8 @@ class ModelTaskGraph : public Subgraph {
     external_file->Swap(sc->MutableOptions<Options>()
                             ->mutable_base_options()
                             ->mutable_model_asset());
+    share_model_resources_ =
+        sc->Options<Options>().base_options().share_model_resources();
     return CreateModelResources(sc, std::move(external_file), tag_suffix);
   }
 
@@ -94,6 +100,8 @@ class ModelTaskGraph : public Subgraph {
     external_file->Swap(sc->MutableOptions<Options>()
                             ->mutable_base_options()
                             ->mutable_model_asset());
+    share_model_resources_ =
+        sc->Options<Options>().base_options().share_model_resources();
     return GetOrCreateModelResources(sc, std::move(external_file), tag_suffix);
   }
 
@@ -115,6 +123,8 @@ class ModelTaskGraph : public Subgraph {
     external_file->Swap(sc->MutableOptions<Options>()
                             ->mutable_base_options()
                             ->mutable_model_asset());
+    share_model_resources_ =
+        sc->Options<Options>().base_options().share_model_resources();
     return CreateModelAssetBundleResources(sc, std::move(external_file));
   }
 
@@ -151,6 +161,11 @@ class ModelTaskGraph : public Subgraph {
       api2::builder::Graph& graph) const;
 
  private:
+  // Whether the resources cached in the model resources graph service are
+  // shared through SharedModelResourcesCache. Set from the base options by the
+  // templated methods above.
+  bool share_model_resources_ = false;
+
   std::vector<std::unique_ptr<ModelResources>> local_model_resources_;
 
   std::vector<std::unique_ptr<ModelAssetBundleResources>>
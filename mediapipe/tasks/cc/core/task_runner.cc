@@ -140,6 +140,9 @@ absl::Status TaskRunner::Initialize(
         [this](const std::vector<Packet>& packets) {
           status_or_output_packets_ =
               GenerateOutputPacketMap(packets, output_stream_names_);
+          if (collect_batch_outputs_) {
+            batch_output_packets_.push_back(status_or_output_packets_);
+          }
           return;
         },
         &config, &input_side_packets, /*observe_timestamp_bounds=*/true);
@@ -250,6 +253,109 @@ absl::StatusOr<PacketMap> TaskRunner::Process(PacketMap inputs) {
   return status_or_output_packets_;
 }
 
+absl::StatusOr<std::vector<PacketMap>> TaskRunner::ProcessBatch(
+    std::vector<PacketMap> batch_inputs) {
+  if (!is_running_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Task runner is currently not running.",
+        MediaPipeTasksStatus::kRunnerNotStartedError);
+  }
+  if (packets_callback_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Calling TaskRunner::ProcessBatch method is illegal when the result "
+        "callback is provided.",
+        MediaPipeTasksStatus::kRunnerApiCalledInWrongModeError);
+  }
+  if (batch_inputs.empty()) {
+    return std::vector<PacketMap>();
+  }
+  std::vector<Timestamp> input_timestamps;
+  input_timestamps.reserve(batch_inputs.size());
+  for (const auto& inputs : batch_inputs) {
+    ASSIGN_OR_RETURN(auto input_timestamp,
+                     ValidateAndGetPacketTimestamp(inputs));
+    input_timestamps.push_back(input_timestamp);
+  }
+  const bool use_synthetic_timestamp =
+      input_timestamps.front() == Timestamp::Unset();
+  // Guarded by the same lock as Process(), see the comments there.
+  absl::MutexLock lock(&mutex_);
+  Timestamp previous_timestamp = last_seen_;
+  for (auto& input_timestamp : input_timestamps) {
+    if ((input_timestamp == Timestamp::Unset()) != use_synthetic_timestamp) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "Either all or none of the batch inputs must have timestamps.",
+          MediaPipeTasksStatus::kRunnerInvalidTimestampError);
+    }
+    if (use_synthetic_timestamp) {
+      input_timestamp =
+          previous_timestamp == Timestamp::Unset()
+              ? Timestamp(0)
+              : previous_timestamp + Timestamp::kTimestampUnitsPerSecond;
+    } else if (input_timestamp <= previous_timestamp) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "Input timestamp must be monotonically increasing.",
+          MediaPipeTasksStatus::kRunnerInvalidTimestampError);
+    }
+    previous_timestamp = input_timestamp;
+  }
+  batch_output_packets_.clear();
+  collect_batch_outputs_ = true;
+  absl::Status status;
+  for (int i = 0; i < batch_inputs.size() && status.ok(); ++i) {
+    for (auto& [stream_name, packet] : batch_inputs[i]) {
+      status = AddPayload(
+          graph_.AddPacketToInputStream(
+              stream_name, std::move(packet).At(input_timestamps[i])),
+          absl::StrCat("Failed to add packet to the graph input stream: ",
+                       stream_name),
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+      if (!status.ok()) {
+        break;
+      }
+    }
+    last_seen_ = input_timestamps[i];
+  }
+  if (status.ok() && !graph_.WaitUntilIdle().ok()) {
+    graph_.GetCombinedErrors(&status);
+  }
+  collect_batch_outputs_ = false;
+  MP_RETURN_IF_ERROR(status);
+  // Assigns the outputs to the last input at or before their timestamp.
+  std::vector<PacketMap> batch_outputs(batch_inputs.size());
+  for (auto& status_or_outputs : batch_output_packets_) {
+    MP_RETURN_IF_ERROR(status_or_outputs.status());
+    Timestamp output_timestamp = Timestamp::Unset();
+    for (const auto& [stream_name, packet] : *status_or_outputs) {
+      if (!packet.IsEmpty()) {
+        output_timestamp = std::max(packet.Timestamp(), output_timestamp);
+      }
+    }
+    auto it = std::upper_bound(input_timestamps.begin(),
+                               input_timestamps.end(), output_timestamp);
+    if (output_timestamp == Timestamp::Unset() ||
+        it == input_timestamps.begin()) {
+      continue;
+    }
+    batch_outputs[it - input_timestamps.begin() - 1] =
+        std::move(*status_or_outputs);
+    if (use_synthetic_timestamp) {
+      last_seen_ = std::max(output_timestamp, last_seen_);
+    }
+  }
+  batch_output_packets_.clear();
+  for (auto& outputs : batch_outputs) {
+    for (const auto& stream_name : output_stream_names_) {
+      outputs.try_emplace(stream_name);
+    }
+  }
+  return batch_outputs;
+}
+
 absl::Status TaskRunner::Send(PacketMap inputs) {
   if (!is_running_) {
     return CreateStatusWithPayload(
@@ -92,6 +92,19 @@ class TaskRunner {
   // timestamps are in order.
   absl::StatusOr<PacketMap> Process(PacketMap inputs);
 
+  // A synchronous method that processes a batch of unrelated inputs, such as
+  // a list of images, and returns the output packets of each input in order.
+  // All inputs are added to the graph before waiting for the outputs, so the
+  // graph pipelines them, e.g. preprocessing the next images while running
+  // inference on the current one, instead of running them one at a time.
+  // Either all or none of the inputs must have timestamps; timestamps must be
+  // increasing and greater than those of the previous invocations. Each input
+  // must produce its outputs at timestamps before the timestamp of the next
+  // input. The outputs of an input without output packets are empty packets.
+  // This method is thread-unsafe, like Process().
+  absl::StatusOr<std::vector<PacketMap>> ProcessBatch(
+      std::vector<PacketMap> batch_inputs);
+
   // An asynchronous method that is designed for handling live streaming data
   // such as live camera and microphone data. A user-defined PacketsCallback
   // function must be provided in the constructor to receive the output packets.
@@ -139,6 +152,10 @@ class TaskRunner {
   std::atomic_bool is_running_ = false;
 
   absl::StatusOr<PacketMap> status_or_output_packets_;
+  // Whether the output packets are also collected in batch_output_packets_,
+  // while running ProcessBatch().
+  bool collect_batch_outputs_ = false;
+  std::vector<absl::StatusOr<PacketMap>> batch_output_packets_;
   Timestamp last_seen_ ABSL_GUARDED_BY(mutex_);
   absl::Mutex mutex_;
 };
@@ -0,0 +1,146 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/core/task_runner_pool.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+
+/* static */
+absl::StatusOr<std::unique_ptr<TaskRunnerPool>> TaskRunnerPool::Create(
+    CalculatorGraphConfig config, int num_runners,
+    OpResolverFactory op_resolver_factory, int max_queue_size) {
+  if (num_runners <= 0) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::Substitute("The number of runners must be positive, got $0.",
+                         num_runners),
+        MediaPipeTasksStatus::kRunnerInitializationError);
+  }
+  std::vector<std::unique_ptr<TaskRunner>> runners;
+  runners.reserve(num_runners);
+  for (int i = 0; i < num_runners; ++i) {
+    ASSIGN_OR_RETURN(
+        auto runner,
+        TaskRunner::Create(
+            config, op_resolver_factory ? op_resolver_factory() : nullptr));
+    runners.push_back(std::move(runner));
+  }
+  // Use absl::WrapUnique() to call private constructor:
+  // https://abseil.io/tips/126.
+  return absl::WrapUnique(
+      new TaskRunnerPool(std::move(runners), max_queue_size));
+}
+
+TaskRunnerPool::TaskRunnerPool(std::vector<std::unique_ptr<TaskRunner>> runners,
+                               int max_queue_size)
+    : runners_(std::move(runners)), max_queue_size_(max_queue_size) {
+  for (const auto& runner : runners_) {
+    idle_runners_.push_back(runner.get());
+  }
+}
+
+absl::StatusOr<TaskRunner*> TaskRunnerPool::AcquireRunner() {
+  absl::MutexLock lock(&mutex_);
+  if (!closed_ && idle_runners_.empty() && max_queue_size_ >= 0 &&
+      num_waiting_ >= max_queue_size_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kResourceExhausted,
+        absl::Substitute("All $0 task runners are busy and $1 calls are "
+                         "already waiting.",
+                         runners_.size(), num_waiting_),
+        MediaPipeTasksStatus::kRunnerQueueFullError);
+  }
+  ++num_waiting_;
+  mutex_.Await(absl::Condition(
+      +[](TaskRunnerPool* pool) ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool->mutex_) {
+        return pool->closed_ || !pool->idle_runners_.empty();
+      },
+      this));
+  --num_waiting_;
+  if (closed_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Task runner pool is currently not running.",
+        MediaPipeTasksStatus::kRunnerNotStartedError);
+  }
+  TaskRunner* runner = idle_runners_.back();
+  idle_runners_.pop_back();
+  return runner;
+}
+
+void TaskRunnerPool::ReleaseRunner(TaskRunner* runner) {
+  absl::MutexLock lock(&mutex_);
+  idle_runners_.push_back(runner);
+}
+
+absl::StatusOr<PacketMap> TaskRunnerPool::Process(PacketMap inputs) {
+  for (const auto& [name, packet] : inputs) {
+    if (packet.Timestamp() != Timestamp::Unset()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "The input packets of a task runner pool must not have timestamps.",
+          MediaPipeTasksStatus::kRunnerInvalidTimestampError);
+    }
+  }
+  ASSIGN_OR_RETURN(TaskRunner * runner, AcquireRunner());
+  absl::StatusOr<PacketMap> status_or_outputs =
+      runner->Process(std::move(inputs));
+  ReleaseRunner(runner);
+  return status_or_outputs;
+}
+
+absl::Status TaskRunnerPool::Close() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (closed_) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kFailedPrecondition,
+          "Task runner pool is already closed.",
+          MediaPipeTasksStatus::kRunnerFailsToCloseError);
+    }
+    closed_ = true;
+    // Waits for the in-flight calls to return their runners.
+    mutex_.Await(absl::Condition(
+        +[](TaskRunnerPool* pool) ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool->mutex_) {
+          return pool->idle_runners_.size() == pool->runners_.size();
+        },
+        this));
+  }
+  absl::Status status;
+  for (const auto& runner : runners_) {
+    status.Update(runner->Close());
+  }
+  return status;
+}
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
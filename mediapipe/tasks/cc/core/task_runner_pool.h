@@ -0,0 +1,103 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_CORE_TASK_RUNNER_POOL_H_
+#define MEDIAPIPE_TASKS_CC_CORE_TASK_RUNNER_POOL_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+
+// Creates the op resolver of one task runner of a TaskRunnerPool.
+using OpResolverFactory = std::function<std::unique_ptr<tflite::OpResolver>()>;
+
+// A pool of synchronous task runners running replicas of the same graph, which
+// lets clients process independent inputs, such as unrelated images, from
+// many threads concurrently. TaskRunner::Process() serializes the invocations
+// of a runner, so a single runner processes one input at a time; the pool
+// dispatches each Process() call to an idle runner instead.
+//
+// Each runner loads its own model resources, unless the task graph opts into
+// sharing them across graphs with `BaseOptions.share_model_resources`, which
+// is recommended to avoid loading one copy of the model per runner.
+//
+// Calls that find no idle runner wait for one, up to `max_queue_size` waiting
+// calls, beyond which Process() fails immediately with a
+// kRunnerQueueFullError payload so that callers can shed load.
+class TaskRunnerPool {
+ public:
+  // Creates a pool of `num_runners` synchronous task runners of the graph
+  // config. If `op_resolver_factory` is provided, it is called once per runner
+  // to create the runner's op resolver. A negative `max_queue_size` does not
+  // bound the number of waiting calls.
+  static absl::StatusOr<std::unique_ptr<TaskRunnerPool>> Create(
+      CalculatorGraphConfig config, int num_runners,
+      OpResolverFactory op_resolver_factory = nullptr,
+      int max_queue_size = -1);
+
+  // TaskRunnerPool is neither copyable nor movable.
+  TaskRunnerPool(const TaskRunnerPool&) = delete;
+  TaskRunnerPool& operator=(const TaskRunnerPool&) = delete;
+
+  // Processes the input packets on an idle runner, waiting for one if all the
+  // runners are busy, and returns the output packets. The input packets must
+  // not have timestamps, since consecutive calls may run on different runners.
+  // This method is thread-safe.
+  absl::StatusOr<PacketMap> Process(PacketMap inputs);
+
+  // Shuts down all the runners, after waiting for the in-flight calls to
+  // finish. Calls to Process() after Close() fail.
+  absl::Status Close();
+
+  // Returns the number of runners in the pool.
+  int NumRunners() const { return runners_.size(); }
+
+ private:
+  TaskRunnerPool(std::vector<std::unique_ptr<TaskRunner>> runners,
+                 int max_queue_size);
+
+  // Waits until a runner is idle and returns it, or returns an error if the
+  // queue is full or the pool is closed.
+  absl::StatusOr<TaskRunner*> AcquireRunner();
+
+  // Returns a runner acquired with AcquireRunner() to the idle runners.
+  void ReleaseRunner(TaskRunner* runner);
+
+  const std::vector<std::unique_ptr<TaskRunner>> runners_;
+  const int max_queue_size_;
+
+  absl::Mutex mutex_;
+  std::vector<TaskRunner*> idle_runners_ ABSL_GUARDED_BY(mutex_);
+  int num_waiting_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool closed_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_CORE_TASK_RUNNER_POOL_H_
@@ -0,0 +1,140 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/core/task_runner_pool.h"
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+namespace {
+
+CalculatorGraphConfig GetPassThroughGraphConfig() {
+  return ParseTextProtoOrDie<CalculatorGraphConfig>(
+      R"pb(
+        input_stream: "in"
+        output_stream: "out"
+        node {
+          calculator: "PassThroughCalculator"
+          input_stream: "in"
+          output_stream: "out"
+        })pb");
+}
+
+absl::Notification blocking_calculator_started;
+absl::Notification blocking_calculator_released;
+
+// A calculator that blocks in Process() until released by the test.
+class BlockingCalculator : public CalculatorBase {
+ public:
+  static absl::Status GetContract(CalculatorContract* cc) {
+    cc->Inputs().Index(0).SetAny();
+    cc->Outputs().Index(0).SetSameAs(&cc->Inputs().Index(0));
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) final {
+    blocking_calculator_started.Notify();
+    blocking_calculator_released.WaitForNotification();
+    cc->Outputs().Index(0).AddPacket(cc->Inputs().Index(0).Value());
+    return absl::OkStatus();
+  }
+};
+REGISTER_CALCULATOR(BlockingCalculator);
+
+TEST(TaskRunnerPoolTest, FailsWithNoRunners) {
+  auto status_or_pool =
+      TaskRunnerPool::Create(GetPassThroughGraphConfig(), /*num_runners=*/0);
+  EXPECT_EQ(status_or_pool.status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+TEST(TaskRunnerPoolTest, FailsWithInputTimestamps) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto pool,
+      TaskRunnerPool::Create(GetPassThroughGraphConfig(), /*num_runners=*/2));
+  auto status_or_result =
+      pool->Process({{"in", MakePacket<int>(0).At(Timestamp(0))}});
+  EXPECT_EQ(status_or_result.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  MP_ASSERT_OK(pool->Close());
+}
+
+TEST(TaskRunnerPoolTest, MultiThreadProcessCalls) {
+  constexpr int kNumThreads = 8;
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto pool,
+      TaskRunnerPool::Create(GetPassThroughGraphConfig(), /*num_runners=*/3));
+  EXPECT_EQ(pool->NumRunners(), 3);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([i, &pool]() {
+      for (int j = 0; j < 30; ++j) {
+        auto status_or_result = pool->Process({{"in", MakePacket<int>(i * j)}});
+        ASSERT_TRUE(status_or_result.ok());
+        EXPECT_EQ(i * j, status_or_result.value()["out"].Get<int>());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  MP_ASSERT_OK(pool->Close());
+  EXPECT_FALSE(pool->Process({{"in", MakePacket<int>(0)}}).ok());
+}
+
+TEST(TaskRunnerPoolTest, FailsWhenQueueIsFull) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto pool, TaskRunnerPool::Create(
+                     ParseTextProtoOrDie<CalculatorGraphConfig>(
+                         R"pb(
+                           input_stream: "in"
+                           output_stream: "out"
+                           node {
+                             calculator: "BlockingCalculator"
+                             input_stream: "in"
+                             output_stream: "out"
+                           })pb"),
+                     /*num_runners=*/1, /*op_resolver_factory=*/nullptr,
+                     /*max_queue_size=*/0));
+  std::thread thread([&pool]() {
+    auto status_or_result = pool->Process({{"in", MakePacket<int>(1)}});
+    ASSERT_TRUE(status_or_result.ok());
+    EXPECT_EQ(1, status_or_result.value()["out"].Get<int>());
+  });
+  blocking_calculator_started.WaitForNotification();
+  auto status_or_result = pool->Process({{"in", MakePacket<int>(2)}});
+  EXPECT_EQ(status_or_result.status().code(),
+            absl::StatusCode::kResourceExhausted);
+  blocking_calculator_released.Notify();
+  thread.join();
+  MP_ASSERT_OK(pool->Close());
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
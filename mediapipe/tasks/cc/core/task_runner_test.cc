@@ -254,6 +254,40 @@ TEST_F(TaskRunnerTest, MultiThreadSyncAPICallsWithoutTimestamp) {
   MP_ASSERT_OK(runner->Close());
 }
 
+TEST_F(TaskRunnerTest, BatchSyncAPICalls) {
+  MP_ASSERT_OK_AND_ASSIGN(auto runner,
+                          TaskRunner::Create(GetPassThroughGraphConfig()));
+  MP_ASSERT_OK(runner->Process({{"in", MakePacket<int>(-1)}}).status());
+  std::vector<PacketMap> batch_inputs;
+  for (int i = 0; i < 10; ++i) {
+    batch_inputs.push_back({{"in", MakePacket<int>(i)}});
+  }
+  MP_ASSERT_OK_AND_ASSIGN(auto batch_outputs,
+                          runner->ProcessBatch(std::move(batch_inputs)));
+  ASSERT_EQ(batch_outputs.size(), 10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, batch_outputs[i]["out"].Get<int>());
+  }
+  auto status_or_result = runner->Process({{"in", MakePacket<int>(10)}});
+  ASSERT_TRUE(status_or_result.ok());
+  EXPECT_EQ(10, status_or_result.value()["out"].Get<int>());
+  MP_ASSERT_OK(runner->Close());
+}
+
+TEST_F(TaskRunnerTest, WrongTimestampOrderInBatchSyncCalls) {
+  MP_ASSERT_OK_AND_ASSIGN(auto runner,
+                          TaskRunner::Create(GetPassThroughGraphConfig()));
+  std::vector<PacketMap> batch_inputs;
+  batch_inputs.push_back({{"in", MakePacket<int>(0).At(Timestamp(1))}});
+  batch_inputs.push_back({{"in", MakePacket<int>(1).At(Timestamp(1))}});
+  auto status = runner->ProcessBatch(std::move(batch_inputs)).status();
+  ASSERT_FALSE(status.ok());
+  ASSERT_THAT(status.message(),
+              testing::HasSubstr("Input timestamp must be monotonically "
+                                 "increasing"));
+  MP_ASSERT_OK(runner->Close());
+}
+
 TEST_F(TaskRunnerTest, AsyncAPICalls) {
   std::function<void(absl::StatusOr<PacketMap>)> callback(
       [](absl::StatusOr<PacketMap> status_or_packets) {
@@ -23,6 +23,7 @@ limitations under the License.
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "flatbuffers/flatbuffers.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
@@ -65,7 +66,19 @@ ModelMetadataExtractor::CreateFromModelBuffer(const char* buffer_data,
   // https://abseil.io/tips/126.
   std::unique_ptr<ModelMetadataExtractor> extractor =
       absl::WrapUnique(new ModelMetadataExtractor());
-  MP_RETURN_IF_ERROR(extractor->InitFromModelBuffer(buffer_data, buffer_size));
+  MP_RETURN_IF_ERROR(extractor->InitFromModelBuffer(buffer_data, buffer_size,
+                                                    /*verify=*/true));
+  return extractor;
+}
+
+/* static */
+absl::StatusOr<std::unique_ptr<ModelMetadataExtractor>>
+ModelMetadataExtractor::CreateFromVerifiedModelBuffer(const char* buffer_data,
+                                                      size_t buffer_size) {
+  std::unique_ptr<ModelMetadataExtractor> extractor =
+      absl::WrapUnique(new ModelMetadataExtractor());
+  MP_RETURN_IF_ERROR(extractor->InitFromModelBuffer(buffer_data, buffer_size,
+                                                    /*verify=*/false));
   return extractor;
 }
 
@@ -114,17 +127,19 @@ std::string ModelMetadataExtractor::FindFirstAssociatedFileName(
 }
 
 absl::Status ModelMetadataExtractor::InitFromModelBuffer(
-    const char* buffer_data, size_t buffer_size) {
+    const char* buffer_data, size_t buffer_size, bool verify) {
   // Rely on the simplest, base flatbuffers verifier. Here is not the place to
   // e.g. use an OpResolver: we just want to make sure the buffer is valid to
   // access the metadata.
-  flatbuffers::Verifier verifier = flatbuffers::Verifier(
-      reinterpret_cast<const uint8_t*>(buffer_data), buffer_size);
-  if (!tflite::VerifyModelBuffer(verifier)) {
-    return CreateStatusWithPayload(
-        StatusCode::kInvalidArgument,
-        "The model is not a valid FlatBuffer buffer.",
-        MediaPipeTasksStatus::kInvalidFlatBufferError);
+  if (verify) {
+    flatbuffers::Verifier verifier = flatbuffers::Verifier(
+        reinterpret_cast<const uint8_t*>(buffer_data), buffer_size);
+    if (!tflite::VerifyModelBuffer(verifier)) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          "The model is not a valid FlatBuffer buffer.",
+          MediaPipeTasksStatus::kInvalidFlatBufferError);
+    }
   }
   model_ = tflite::GetModel(buffer_data);
   if (model_->metadata() == nullptr) {
@@ -178,35 +193,51 @@ absl::Status ModelMetadataExtractor::InitFromModelBuffer(
               kMetadataParserVersion, min_parser_version->c_str()),
           MediaPipeTasksStatus::kMetadataInvalidSchemaVersionError);
     }
-    return ExtractAssociatedFiles(buffer_data, buffer_size);
-    break;
+    // The associated files are read on demand by GetAssociatedFile().
+    buffer_data_ = buffer_data;
+    buffer_size_ = buffer_size;
+    return absl::OkStatus();
   }
   return absl::OkStatus();
 }
 
-absl::Status ModelMetadataExtractor::ExtractAssociatedFiles(
-    const char* buffer_data, size_t buffer_size) {
-  auto status =
-      ExtractFilesfromZipFile(buffer_data, buffer_size, &associated_files_);
+absl::Status ModelMetadataExtractor::IndexAssociatedFiles() const {
+  if (associated_files_indexed_ || buffer_data_ == nullptr) {
+    return absl::OkStatus();
+  }
+  auto status = IndexFilesInZipFile(buffer_data_, buffer_size_,
+                                    &associated_file_locations_);
   if (!status.ok() &&
       absl::StrContains(status.message(), "Unable to open zip archive.")) {
     // It's OK if it fails: this means there are no associated files with this
     // model.
-    return absl::OkStatus();
+    status = absl::OkStatus();
   }
-  return status;
+  MP_RETURN_IF_ERROR(status);
+  associated_files_indexed_ = true;
+  return absl::OkStatus();
 }
 
 absl::StatusOr<absl::string_view> ModelMetadataExtractor::GetAssociatedFile(
     const std::string& filename) const {
+  absl::MutexLock lock(&mutex_);
   auto it = associated_files_.find(filename);
-  if (it == associated_files_.end()) {
+  if (it != associated_files_.end()) {
+    return it->second;
+  }
+  MP_RETURN_IF_ERROR(IndexAssociatedFiles());
+  auto location = associated_file_locations_.find(filename);
+  if (location == associated_file_locations_.end()) {
     return CreateStatusWithPayload(
         StatusCode::kNotFound,
         absl::StrFormat("No associated file with name: %s", filename),
         MediaPipeTasksStatus::kMetadataAssociatedFileNotFoundError);
   }
-  return it->second;
+  ASSIGN_OR_RETURN(
+      absl::string_view file_contents,
+      ExtractFileFromZipFile(buffer_data_, buffer_size_, location->second));
+  associated_files_.emplace(filename, file_contents);
+  return file_contents;
 }
 
 absl::StatusOr<std::string> ModelMetadataExtractor::GetModelVersion() const {
@@ -15,10 +15,13 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_METADATA_METADATA_EXTRACTOR_H_
 #define MEDIAPIPE_TASKS_CC_METADATA_METADATA_EXTRACTOR_H_
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/tasks/cc/metadata/utils/zip_utils.h"
 #include "mediapipe/tasks/metadata/metadata_schema_generated.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
@@ -50,6 +53,13 @@ class ModelMetadataExtractor {
   static absl::StatusOr<std::unique_ptr<ModelMetadataExtractor>>
   CreateFromModelBuffer(const char* buffer_data, size_t buffer_size);
 
+  // Same as CreateFromModelBuffer, for a buffer that the caller has already
+  // verified to be a valid TFLite FlatBuffer, e.g. through
+  // tflite::FlatBufferModel::VerifyAndBuildFromBuffer, so that the whole model
+  // is not verified twice.
+  static absl::StatusOr<std::unique_ptr<ModelMetadataExtractor>>
+  CreateFromVerifiedModelBuffer(const char* buffer_data, size_t buffer_size);
+
   // Returns the pointer to the *first* ProcessUnit with the provided type, or
   // nullptr if none can be found. An error is returned if multiple
   // ProcessUnit-s with the provided type are found.
@@ -75,7 +85,8 @@ class ModelMetadataExtractor {
 
   // Gets the contents of the associated file with the provided name packed into
   // the model metadata. An error is returned if there is no such associated
-  // file.
+  // file. The associated files are indexed on the first call, and each one is
+  // only located in the model buffer when it is first requested.
   absl::StatusOr<absl::string_view> GetAssociatedFile(
       const std::string& filename) const;
 
@@ -153,20 +164,34 @@ class ModelMetadataExtractor {
   static constexpr int kDefaultSubgraphIndex = 0;
   // Private default constructor, called from CreateFromModel().
   ModelMetadataExtractor() = default;
-  // Initializes the ModelMetadataExtractor from the provided Model FlatBuffer.
-  absl::Status InitFromModelBuffer(const char* buffer_data, size_t buffer_size);
-  // Extracts and stores in associated_files_ the associated files (if present)
-  // packed into the model FlatBuffer data.
-  absl::Status ExtractAssociatedFiles(const char* buffer_data,
-                                      size_t buffer_size);
+  // Initializes the ModelMetadataExtractor from the provided Model FlatBuffer,
+  // verifying it first if `verify` is true.
+  absl::Status InitFromModelBuffer(const char* buffer_data, size_t buffer_size,
+                                   bool verify);
+  // Indexes in associated_file_locations_ the associated files (if present)
+  // packed into the model FlatBuffer data, unless already done.
+  absl::Status IndexAssociatedFiles() const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   // Pointer to the TFLite Model object from which to read the ModelMetadata.
   const tflite::Model* model_{nullptr};
   // Pointer to the extracted ModelMetadata, if any.
   const tflite::ModelMetadata* model_metadata_{nullptr};
-  // The files associated with the ModelMetadata, as a map with the filename
-  // (corresponding to a basename, e.g. "labels.txt") as key and a pointer to
-  // the file contents as value.
-  absl::flat_hash_map<std::string, absl::string_view> associated_files_;
+  // The model buffer holding the associated files, if there is metadata.
+  const char* buffer_data_{nullptr};
+  size_t buffer_size_{0};
+
+  mutable absl::Mutex mutex_;
+  // Whether associated_file_locations_ is complete.
+  mutable bool associated_files_indexed_ ABSL_GUARDED_BY(mutex_) = false;
+  // The locations of the files associated with the ModelMetadata in the zip
+  // central directory, by filename (corresponding to a basename, e.g.
+  // "labels.txt").
+  mutable absl::flat_hash_map<std::string, ZipFileLocation>
+      associated_file_locations_ ABSL_GUARDED_BY(mutex_);
+  // The associated files requested so far, as a map with the filename as key
+  // and a pointer to the file contents as value.
+  mutable absl::flat_hash_map<std::string, absl::string_view> associated_files_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace metadata
@@ -22,6 +22,7 @@ limitations under the License.
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "contrib/minizip/ioapi.h"
 #include "contrib/minizip/unzip.h"
 #include "mediapipe/framework/port/status_macros.h"
@@ -110,8 +111,95 @@ absl::StatusOr<ZipFileInfo> GetCurrentZipFileInfo(const unzFile& zf) {
   return result;
 }
 
+// Returns the name of the current file in the provided unzFile object, as read
+// from the central directory.
+absl::StatusOr<std::string> GetCurrentZipFileName(const unzFile& zf) {
+  unz_file_info64 file_info;
+  MP_RETURN_IF_ERROR(UnzipErrorToStatus(unzGetCurrentFileInfo64(
+      zf, &file_info, /*szFileName=*/nullptr, /*szFileNameBufferSize=*/0,
+      /*extraField=*/nullptr, /*extraFieldBufferSize=*/0,
+      /*szComment=*/nullptr, /*szCommentBufferSize=*/0)));
+  std::string file_name(file_info.size_filename, '\0');
+  MP_RETURN_IF_ERROR(UnzipErrorToStatus(unzGetCurrentFileInfo64(
+      zf, &file_info, file_name.data(), file_name.size(),
+      /*extraField=*/nullptr, /*extraFieldBufferSize=*/0,
+      /*szComment=*/nullptr, /*szCommentBufferSize=*/0)));
+  return file_name;
+}
+
 }  // namespace
 
+absl::Status IndexFilesInZipFile(
+    const char* buffer_data, const size_t buffer_size,
+    absl::flat_hash_map<std::string, ZipFileLocation>* files) {
+  // Create in-memory read-only zip file.
+  ZipReadOnlyMemFile mem_file = ZipReadOnlyMemFile(buffer_data, buffer_size);
+  // Open zip.
+  unzFile zf = unzOpen2_64(/*path=*/nullptr, &mem_file.GetFileFunc64Def());
+  if (zf == nullptr) {
+    return CreateStatusWithPayload(StatusCode::kUnknown,
+                                   "Unable to open zip archive.",
+                                   MediaPipeTasksStatus::kFileZipError);
+  }
+  absl::Cleanup unzipper_closer = [zf]() {
+    if (unzClose(zf) != UNZ_OK) {
+      ABSL_LOG(ERROR) << "Unable to close zip archive.";
+    }
+  };
+  // Get number of files.
+  unz_global_info global_info;
+  if (unzGetGlobalInfo(zf, &global_info) != UNZ_OK) {
+    return CreateStatusWithPayload(StatusCode::kUnknown,
+                                   "Unable to get zip archive info.",
+                                   MediaPipeTasksStatus::kFileZipError);
+  }
+
+  // Browse through the central directory, without opening the files.
+  if (global_info.number_entry > 0) {
+    int error = unzGoToFirstFile(zf);
+    while (error == UNZ_OK) {
+      ASSIGN_OR_RETURN(std::string file_name, GetCurrentZipFileName(zf));
+      unz64_file_pos file_pos;
+      MP_RETURN_IF_ERROR(UnzipErrorToStatus(unzGetFilePos64(zf, &file_pos)));
+      (*files)[std::move(file_name)] = ZipFileLocation{
+          file_pos.pos_in_zip_directory, file_pos.num_of_file};
+      error = unzGoToNextFile(zf);
+    }
+    if (error != UNZ_END_OF_LIST_OF_FILE) {
+      return CreateStatusWithPayload(
+          StatusCode::kUnknown,
+          "Unable to read associated file in zip archive.",
+          MediaPipeTasksStatus::kFileZipError);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<absl::string_view> ExtractFileFromZipFile(
+    const char* buffer_data, const size_t buffer_size,
+    const ZipFileLocation& location) {
+  // Create in-memory read-only zip file.
+  ZipReadOnlyMemFile mem_file = ZipReadOnlyMemFile(buffer_data, buffer_size);
+  // Open zip.
+  unzFile zf = unzOpen2_64(/*path=*/nullptr, &mem_file.GetFileFunc64Def());
+  if (zf == nullptr) {
+    return CreateStatusWithPayload(StatusCode::kUnknown,
+                                   "Unable to open zip archive.",
+                                   MediaPipeTasksStatus::kFileZipError);
+  }
+  absl::Cleanup unzipper_closer = [zf]() {
+    if (unzClose(zf) != UNZ_OK) {
+      ABSL_LOG(ERROR) << "Unable to close zip archive.";
+    }
+  };
+  const unz64_file_pos file_pos{location.pos_in_zip_directory,
+                                location.num_of_file};
+  MP_RETURN_IF_ERROR(UnzipErrorToStatus(unzGoToFilePos64(zf, &file_pos)));
+  ASSIGN_OR_RETURN(auto zip_file_info, GetCurrentZipFileInfo(zf));
+  return absl::string_view(buffer_data + zip_file_info.position,
+                           zip_file_info.size);
+}
+
 absl::Status ExtractFilesfromZipFile(
     const char* buffer_data, const size_t buffer_size,
     absl::flat_hash_map<std::string, absl::string_view>* files) {
@@ -16,10 +16,13 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_METADATA_UTILS_ZIP_UTILS_H_
 #define MEDIAPIPE_TASKS_CC_METADATA_UTILS_ZIP_UTILS_H_
 
+#include <cstdint>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
 
 namespace mediapipe {
@@ -35,6 +38,28 @@ absl::Status ExtractFilesfromZipFile(
     const char* buffer_data, const size_t buffer_size,
     absl::flat_hash_map<std::string, absl::string_view>* files);
 
+// The location of a file entry in the central directory of a zip file.
+struct ZipFileLocation {
+  uint64_t pos_in_zip_directory;
+  uint64_t num_of_file;
+};
+
+// Indexes the files of the zip file by reading its central directory only,
+// which is much cheaper than extracting all of them when only a few are used.
+// Input: Pointer and length of the zip file in memory.
+// Outputs: A map with the filename as key and the location of the file in the
+// central directory as value, to be passed to ExtractFileFromZipFile.
+absl::Status IndexFilesInZipFile(
+    const char* buffer_data, const size_t buffer_size,
+    absl::flat_hash_map<std::string, ZipFileLocation>* files);
+
+// Extracts the file at the provided location, as returned by
+// IndexFilesInZipFile, from the zip file. The file contents returned by this
+// function are only guaranteed to stay valid while buffer_data is alive.
+absl::StatusOr<absl::string_view> ExtractFileFromZipFile(
+    const char* buffer_data, const size_t buffer_size,
+    const ZipFileLocation& location);
+
 // Set the ExternalFile object by file_content in memory. By default,
 // `is_copy=false` which means to set `file_pointer_meta` in ExternalFile which
 // is the pointer points to location of a file in memory. Otherwise, if
@@ -16,7 +16,10 @@ limitations under the License.
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/optimized_encoder.h"
 
 #include <algorithm>
+#include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/double_array_trie.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/encoder_config_generated.h"
@@ -27,13 +30,15 @@ namespace {
 
 const char kSpaceSymbol[] = "\xe2\x96\x81";
 
+// Applies `pc` to `input` and writes the result into `result_string` and
+// `result_offsets`, which must not alias the inputs.
 template <typename processing_callback>
-std::tuple<std::string, std::vector<int>> process_string(
-    const std::string& input, const std::vector<int>& offsets,
-    const processing_callback& pc) {
-  std::string result_string;
+void process_string(const std::string& input, const std::vector<int>& offsets,
+                    const processing_callback& pc, std::string& result_string,
+                    std::vector<int>& result_offsets) {
+  result_string.clear();
   result_string.reserve(input.size());
-  std::vector<int> result_offsets;
+  result_offsets.clear();
   result_offsets.reserve(offsets.size());
   for (int i = 0, j = 0; i < input.size();) {
     auto result = pc(input.data() + i, input.size() - i);
@@ -54,7 +59,16 @@ std::tuple<std::string, std::vector<int>> process_string(
     j += consumed;
     i += consumed;
   }
-  return std::make_tuple(result_string, result_offsets);
+}
+
+// Applies `pc` to the normalized string of `buffers` in place.
+template <typename processing_callback>
+void process_normalized_string(const processing_callback& pc,
+                               EncoderBuffers& buffers) {
+  process_string(buffers.normalized_string, buffers.normalized_offsets, pc,
+                 buffers.scratch_string, buffers.scratch_offsets);
+  buffers.normalized_string.swap(buffers.scratch_string);
+  buffers.normalized_offsets.swap(buffers.scratch_offsets);
 }
 
 inline char is_whitespace(char c) {
@@ -89,22 +103,25 @@ std::tuple<int, utils::string_view> find_replacement(
   }
   return std::make_tuple(0, utils::string_view(nullptr, 0));
 }
-}  // namespace
 
-std::tuple<std::string, std::vector<int>> NormalizeString(
-    const std::string& in_string, const EncoderConfig& config) {
-  std::vector<int> output_offsets;
-  std::string result = in_string;
-  output_offsets.reserve(in_string.length());
-  for (int i = 0; i < in_string.length(); ++i) {
-    output_offsets.push_back(i);
-  }
+// Writes the normalized `in_string` and the offset in `in_string` of each of
+// its bytes into `buffers`.
+void NormalizeStringInto(utils::string_view in_string,
+                         const EncoderConfig& config, EncoderBuffers& buffers) {
+  std::string& result = buffers.normalized_string;
+  std::vector<int>& output_offsets = buffers.normalized_offsets;
+  result.clear();
+  output_offsets.clear();
   if (in_string.empty()) {
-    return std::make_tuple(result, output_offsets);
+    return;
   }
   if (config.add_dummy_prefix()) {
-    result.insert(result.begin(), ' ');
-    output_offsets.insert(output_offsets.begin(), 0);
+    result.push_back(' ');
+    output_offsets.push_back(0);
+  }
+  result.append(in_string.data(), in_string.length());
+  for (int i = 0; i < in_string.length(); ++i) {
+    output_offsets.push_back(i);
   }
   // Greedely replace normalized_prefixes with normalized_replacements
   if (config.normalized_prefixes() != nullptr &&
@@ -116,12 +133,10 @@ std::tuple<std::string, std::vector<int>> NormalizeString(
       return find_replacement(data, len, normalized_prefixes_matcher,
                               *config.normalized_replacements());
     };
-    std::tie(result, output_offsets) =
-        process_string(result, output_offsets, norm_replace);
+    process_normalized_string(norm_replace, buffers);
   }
   if (config.remove_extra_whitespaces()) {
-    std::tie(result, output_offsets) =
-        process_string(result, output_offsets, remove_extra_whitespaces);
+    process_normalized_string(remove_extra_whitespaces, buffers);
     if (!result.empty() && is_whitespace(result.back())) {
       result.pop_back();
       output_offsets.pop_back();
@@ -134,31 +149,25 @@ std::tuple<std::string, std::vector<int>> NormalizeString(
       }
       return std::make_tuple(0, utils::string_view(nullptr, 0));
     };
-    std::tie(result, output_offsets) =
-        process_string(result, output_offsets, replace_whitespaces);
+    process_normalized_string(replace_whitespaces, buffers);
   }
-
-  return std::make_tuple(result, output_offsets);
 }
 
-EncoderResult EncodeNormalizedString(const std::string& str,
-                                     const std::vector<int>& offsets,
-                                     const EncoderConfig& config, bool add_bos,
-                                     bool add_eos, bool reverse) {
+// Encodes the normalized string of `buffers` and appends the ids to `codes`
+// and, if not null, the offsets to `offsets`.
+void EncodeNormalizedString(const EncoderConfig& config, bool add_bos,
+                            bool add_eos, bool reverse,
+                            EncoderBuffers& buffers, std::vector<int>& codes,
+                            std::vector<int>* offsets) {
+  using LatticeElement = EncoderBuffers::LatticeElement;
+  const std::string& str = buffers.normalized_string;
   const DoubleArrayTrie piece_matcher(config.pieces()->nodes());
   const flatbuffers::Vector<float>* piece_scores = config.pieces_scores();
   const int unknown_code = config.unknown_code();
   const float unknown_penalty = config.unknown_penalty();
-  struct LatticeElement {
-    float score = 0;
-    int code = -1;
-    int prev_position = -1;
-    LatticeElement(float score_, int code_, int prev_position_)
-        : score(score_), code(code_), prev_position(prev_position_) {}
-    LatticeElement() {}
-  };
   const int length = str.length();
-  std::vector<LatticeElement> lattice(length + 1);
+  std::vector<LatticeElement>& lattice = buffers.lattice;
+  lattice.assign(length + 1, LatticeElement());
   for (int i = 0; i < length; ++i) {
     if (i > 0 && lattice[i].prev_position < 0) {
       // This state is unreachable.
@@ -171,11 +180,11 @@ EncoderResult EncodeNormalizedString(const std::string& str,
       LatticeElement& current_element = lattice[pos];
       if (current_element.prev_position < 0 ||
           current_element.score < penalized_score) {
-        current_element = LatticeElement(
+        current_element = {
             penalized_score, unknown_code,
             // If the current state is already reached by unknown code, merge
             // states.
-            lattice[i].code == unknown_code ? lattice[i].prev_position : i);
+            lattice[i].code == unknown_code ? lattice[i].prev_position : i};
       }
     }
     auto lattice_update = [&lattice, i,
@@ -183,17 +192,20 @@ EncoderResult EncodeNormalizedString(const std::string& str,
       LatticeElement& target_element = lattice[i + m.match_length];
       const float score = lattice[i].score + (*piece_scores)[m.id];
       if (target_element.prev_position < 0 || target_element.score < score) {
-        target_element = LatticeElement(score, m.id, i);
+        target_element = {score, m.id, i};
       }
     };
     piece_matcher.IteratePrefixMatches(
         utils::string_view(str.data() + i, length - i), lattice_update);
   }
 
-  EncoderResult result;
+  // The codes and offsets are found from the end, and reversed unless
+  // `reverse` is set.
+  const int first_code = codes.size();
+  const int first_offset = offsets != nullptr ? offsets->size() : 0;
   if (add_eos) {
-    result.codes.push_back(config.end_code());
-    result.offsets.push_back(length);
+    codes.push_back(config.end_code());
+    if (offsets != nullptr) offsets->push_back(length);
   }
   if (lattice[length].prev_position >= 0) {
     for (int pos = length; pos > 0;) {
@@ -201,36 +213,59 @@ EncoderResult EncodeNormalizedString(const std::string& str,
       if (code != config.unknown_code()) {
         code += config.encoding_offset();
       }
-      result.codes.push_back(code);
+      codes.push_back(code);
       pos = lattice[pos].prev_position;
-      result.offsets.push_back(offsets[pos]);
+      if (offsets != nullptr) {
+        offsets->push_back(buffers.normalized_offsets[pos]);
+      }
     }
   }
   if (add_bos) {
-    result.codes.push_back(config.start_code());
-    result.offsets.push_back(0);
+    codes.push_back(config.start_code());
+    if (offsets != nullptr) offsets->push_back(0);
   }
   if (!reverse) {
-    std::reverse(result.codes.begin(), result.codes.end());
-    std::reverse(result.offsets.begin(), result.offsets.end());
+    std::reverse(codes.begin() + first_code, codes.end());
+    if (offsets != nullptr) {
+      std::reverse(offsets->begin() + first_offset, offsets->end());
+    }
   }
-  return result;
+}
+
+}  // namespace
+
+std::tuple<std::string, std::vector<int>> NormalizeString(
+    const std::string& in_string, const EncoderConfig& config) {
+  EncoderBuffers buffers;
+  NormalizeStringInto(utils::string_view(in_string), config, buffers);
+  return std::make_tuple(std::move(buffers.normalized_string),
+                         std::move(buffers.normalized_offsets));
 }
 
 EncoderResult EncodeString(const std::string& string, const void* config_buffer,
                            bool add_bos, bool add_eos, bool reverse) {
+  EncoderBuffers buffers;
+  EncoderResult result;
+  result.type =
+      EncodeString(utils::string_view(string), config_buffer, add_bos,
+                   add_eos, reverse, buffers, result.codes, &result.offsets);
+  return result;
+}
+
+EncoderResultType EncodeString(utils::string_view string,
+                               const void* config_buffer, bool add_bos,
+                               bool add_eos, bool reverse,
+                               EncoderBuffers& buffers, std::vector<int>& codes,
+                               std::vector<int>* offsets) {
   // Get the config from the buffer.
   const EncoderConfig* config = GetEncoderConfig(config_buffer);
   if (config->version() != EncoderVersion::EncoderVersion_SENTENCE_PIECE) {
-    EncoderResult result;
-    result.type = EncoderResultType::WRONG_CONFIG;
-    return result;
-  }
-  std::string normalized_string;
-  std::vector<int> offsets;
-  std::tie(normalized_string, offsets) = NormalizeString(string, *config);
-  return EncodeNormalizedString(normalized_string, offsets, *config, add_bos,
-                                add_eos, reverse);
+    return EncoderResultType::WRONG_CONFIG;
+  }
+  NormalizeStringInto(string, *config, buffers);
+  EncodeNormalizedString(*config, add_bos, add_eos, reverse, buffers, codes,
+                         offsets);
+  return EncoderResultType::SUCCESS;
 }
 
 }  // namespace mediapipe::tflite_operations::sentencepiece
@@ -23,6 +23,7 @@ limitations under the License.
 #include <vector>
 
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/encoder_config_generated.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/utils.h"
 
 namespace mediapipe::tflite_operations::sentencepiece {
 
@@ -33,6 +34,23 @@ struct EncoderResult {
   std::vector<int> codes;
   std::vector<int> offsets;
 };
+
+// Buffers used by EncodeString() that can be reused across calls to avoid
+// allocating them for each string.
+struct EncoderBuffers {
+  struct LatticeElement {
+    float score = 0;
+    int code = -1;
+    int prev_position = -1;
+  };
+
+  std::string normalized_string;
+  std::vector<int> normalized_offsets;
+  std::string scratch_string;
+  std::vector<int> scratch_offsets;
+  std::vector<LatticeElement> lattice;
+};
+
 std::tuple<std::string, std::vector<int>> NormalizeString(
     const std::string& in_string, const EncoderConfig& config);
 
@@ -41,6 +59,14 @@ std::tuple<std::string, std::vector<int>> NormalizeString(
 EncoderResult EncodeString(const std::string& string, const void* config_buffer,
                            bool add_bos, bool add_eos, bool reverse);
 
+// Same as above, but appends the ids to `codes` and, if not null, the offsets
+// to `offsets`, using `buffers` for the intermediate results.
+EncoderResultType EncodeString(utils::string_view string,
+                               const void* config_buffer, bool add_bos,
+                               bool add_eos, bool reverse,
+                               EncoderBuffers& buffers, std::vector<int>& codes,
+                               std::vector<int>* offsets);
+
 }  // namespace mediapipe::tflite_operations::sentencepiece
 
 #endif  // MEDIAPIPE_TASKS_CC_TEXT_CUSTOM_OPS_SENTENCEPIECE_OPTIMIZED_ENCODER_H_
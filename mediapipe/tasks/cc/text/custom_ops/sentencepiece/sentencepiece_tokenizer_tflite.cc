@@ -15,8 +15,11 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/sentencepiece_tokenizer_tflite.h"
 
+#include <vector>
+
 #include "flatbuffers/flexbuffers.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/optimized_encoder.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/utils.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/context.h"
 #include "tensorflow/lite/kernels/internal/tensor.h"
@@ -39,6 +42,13 @@ constexpr int kReverseInput = 6;
 constexpr int kOutputValuesInd = 0;
 constexpr int kOutputSplitsInd = 1;
 
+// Buffers reused across the invocations of an op.
+struct OpData {
+  EncoderBuffers encoder_buffers;
+  std::vector<int> encoded;
+  std::vector<int32> splits;
+};
+
 TfLiteIntArray* CreateSizeArray(const std::initializer_list<int>& sizes) {
   TfLiteIntArray* array_size = TfLiteIntArrayCreate(sizes.size());
   int index = 0;
@@ -52,9 +62,11 @@ TfLiteIntArray* CreateSizeArray(const std::initializer_list<int>& sizes) {
 // Initializes text encoder object from serialized parameters.
 void* Initialize(TfLiteContext* /*context*/, const char* /*buffer*/,
                  size_t /*length*/) {
-  return nullptr;
+  return new OpData();
+}
+void Free(TfLiteContext* /*context*/, void* buffer) {
+  delete static_cast<OpData*>(buffer);
 }
-void Free(TfLiteContext* /*context*/, void* /*buffer*/) {}
 
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   // TODO: Add checks for input and output tensors.
@@ -85,16 +97,20 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       context->tensors[node->inputs->data[kReverseInput]];
   const bool reverse = reverse_tensor.data.b[0];
 
-  std::vector<int32> encoded;
-  std::vector<int32> splits;
+  OpData* op_data = static_cast<OpData*>(node->user_data);
+  std::vector<int>& encoded = op_data->encoded;
+  std::vector<int32>& splits = op_data->splits;
+  encoded.clear();
+  splits.clear();
   const int num_strings = tflite::GetStringCount(&input_text);
   for (int i = 0; i < num_strings; ++i) {
     const auto strref = tflite::GetString(&input_text, i);
-    const auto res = EncodeString(std::string(strref.str, strref.len),
-                                  model_buffer_data, add_bos, add_eos, reverse);
-    TF_LITE_ENSURE_MSG(context, res.type == EncoderResultType::SUCCESS,
+    const EncoderResultType result_type =
+        EncodeString(utils::string_view(strref.str, strref.len),
+                     model_buffer_data, add_bos, add_eos, reverse,
+                     op_data->encoder_buffers, encoded, /*offsets=*/nullptr);
+    TF_LITE_ENSURE_MSG(context, result_type == EncoderResultType::SUCCESS,
                        "Sentencepiece conversion failed");
-    std::copy(res.codes.begin(), res.codes.end(), std::back_inserter(encoded));
     splits.emplace_back(encoded.size());
   }
 
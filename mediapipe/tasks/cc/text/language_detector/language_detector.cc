@@ -25,6 +25,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/containers/classification_result.h"
 #include "mediapipe/tasks/cc/core/task_api_factory.h"
 #include "mediapipe/tasks/cc/text/text_classifier/proto/text_classifier_graph_options.pb.h"
+#include "mediapipe/tasks/cc/text/utils/text_result_cache.h"
 
 namespace mediapipe::tasks::text::language_detector {
 
@@ -104,14 +105,27 @@ ExtractLanguageDetectorResultFromClassificationResult(
 absl::StatusOr<std::unique_ptr<LanguageDetector>> LanguageDetector::Create(
     std::unique_ptr<LanguageDetectorOptions> options) {
   auto options_proto = ConvertLanguageDetectorOptionsToProto(options.get());
-  return core::TaskApiFactory::Create<LanguageDetector,
-                                      TextClassifierGraphOptions>(
-      CreateGraphConfig(std::move(options_proto)),
-      std::move(options->base_options.op_resolver));
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<LanguageDetector> detector,
+      (core::TaskApiFactory::Create<LanguageDetector,
+                                    TextClassifierGraphOptions>(
+          CreateGraphConfig(std::move(options_proto)),
+          std::move(options->base_options.op_resolver))));
+  if (options->result_cache_options.max_entries > 0) {
+    detector->result_cache_ =
+        std::make_unique<utils::TextResultCache<LanguageDetectorResult>>(
+            options->result_cache_options);
+  }
+  return detector;
 }
 
 absl::StatusOr<LanguageDetectorResult> LanguageDetector::Detect(
     absl::string_view text) {
+  if (result_cache_ != nullptr) {
+    if (auto result = result_cache_->Lookup(text); result.has_value()) {
+      return *std::move(result);
+    }
+  }
   ASSIGN_OR_RETURN(
       auto output_packets,
       runner_->Process(
@@ -119,8 +133,18 @@ absl::StatusOr<LanguageDetectorResult> LanguageDetector::Detect(
   ClassificationResult classification_result =
       ConvertToClassificationResult(output_packets[kClassificationsStreamName]
                                         .Get<ClassificationResultProto>());
-  return ExtractLanguageDetectorResultFromClassificationResult(
-      classification_result);
+  ASSIGN_OR_RETURN(LanguageDetectorResult result,
+                   ExtractLanguageDetectorResultFromClassificationResult(
+                       classification_result));
+  if (result_cache_ != nullptr) {
+    result_cache_->Insert(text, result);
+  }
+  return result;
+}
+
+utils::TextResultCacheStats LanguageDetector::GetResultCacheStats() const {
+  return result_cache_ != nullptr ? result_cache_->GetStats()
+                                  : utils::TextResultCacheStats();
 }
 
 }  // namespace mediapipe::tasks::text::language_detector
@@ -25,6 +25,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/processors/classifier_options.h"
 #include "mediapipe/tasks/cc/core/base_options.h"
 #include "mediapipe/tasks/cc/core/base_task_api.h"
+#include "mediapipe/tasks/cc/text/utils/text_result_cache.h"
 
 namespace mediapipe::tasks::text::language_detector {
 
@@ -49,6 +50,10 @@ struct LanguageDetectorOptions {
   // Options for configuring the classifier behavior, such as score threshold,
   // number of results, etc.
   components::processors::ClassifierOptions classifier_options;
+
+  // Options for caching the results by input text, so that repeated texts skip
+  // inference. Disabled by default.
+  utils::TextResultCacheOptions result_cache_options;
 };
 
 // Predicts the language of an input text.
@@ -75,8 +80,16 @@ class LanguageDetector : core::BaseTaskApi {
   // Predicts the language of the input `text`.
   absl::StatusOr<LanguageDetectorResult> Detect(absl::string_view text);
 
+  // Returns the statistics of the result cache, which are all 0 if result
+  // caching is disabled.
+  utils::TextResultCacheStats GetResultCacheStats() const;
+
   // Shuts down the LanguageDetector instance when all the work is done.
   absl::Status Close() { return runner_->Close(); }
+
+ private:
+  std::unique_ptr<utils::TextResultCache<LanguageDetectorResult>>
+      result_cache_;
 };
 
 }  // namespace mediapipe::tasks::text::language_detector
@@ -133,6 +133,25 @@ TEST_F(LanguageDetectorTest, TestMultiplePredictions) {
       result_mixed, kTolerance));
 }
 
+TEST_F(LanguageDetectorTest, TestResultCache) {
+  auto options = std::make_unique<LanguageDetectorOptions>();
+  options->base_options.model_asset_path = GetFullPath(kLanguageDetector);
+  options->classifier_options.score_threshold = 0.3;
+  options->result_cache_options.max_entries = 1;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<LanguageDetector> language_detector,
+                          LanguageDetector::Create(std::move(options)));
+  for (int i = 0; i < 2; ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(LanguageDetectorResult result_mixed,
+                            language_detector->Detect("分久必合合久必分"));
+    MP_EXPECT_OK(MatchesLanguageDetectorResult(
+        {{.language_code = "zh", .probability = 0.505424},
+         {.language_code = "ja", .probability = 0.481617}},
+        result_mixed, kTolerance));
+  }
+  EXPECT_EQ(language_detector->GetResultCacheStats().hits, 1);
+  EXPECT_EQ(language_detector->GetResultCacheStats().misses, 1);
+}
+
 TEST_F(LanguageDetectorTest, TestAllowList) {
   auto options = std::make_unique<LanguageDetectorOptions>();
   options->base_options.model_asset_path = GetFullPath(kLanguageDetector);
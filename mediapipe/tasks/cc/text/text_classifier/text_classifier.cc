@@ -15,10 +15,12 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/text_classifier/text_classifier.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -28,7 +30,9 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/containers/proto/classifications.pb.h"
 #include "mediapipe/tasks/cc/components/processors/proto/classifier_options.pb.h"
 #include "mediapipe/tasks/cc/core/task_api_factory.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
 #include "mediapipe/tasks/cc/text/text_classifier/proto/text_classifier_graph_options.pb.h"
+#include "mediapipe/tasks/cc/text/utils/text_result_cache.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 
 namespace mediapipe {
@@ -40,6 +44,7 @@ namespace {
 
 using ::mediapipe::tasks::components::containers::ConvertToClassificationResult;
 using ::mediapipe::tasks::components::containers::proto::ClassificationResult;
+using ::mediapipe::tasks::core::PacketMap;
 
 constexpr char kTextStreamName[] = "text_in";
 constexpr char kTextTag[] = "TEXT";
@@ -75,6 +80,8 @@ ConvertTextClassifierOptionsToProto(TextClassifierOptions* options) {
               &(options->classifier_options)));
   options_proto->mutable_classifier_options()->Swap(
       classifier_options_proto.get());
+  options_proto->set_max_batch_size(options->max_batch_size);
+  options_proto->set_seq_len_bucket_size(options->seq_len_bucket_size);
   return options_proto;
 }
 
@@ -83,20 +90,81 @@ ConvertTextClassifierOptionsToProto(TextClassifierOptions* options) {
 absl::StatusOr<std::unique_ptr<TextClassifier>> TextClassifier::Create(
     std::unique_ptr<TextClassifierOptions> options) {
   auto options_proto = ConvertTextClassifierOptionsToProto(options.get());
-  return core::TaskApiFactory::Create<TextClassifier,
-                                      proto::TextClassifierGraphOptions>(
-      CreateGraphConfig(std::move(options_proto)),
-      std::move(options->base_options.op_resolver));
+  ASSIGN_OR_RETURN(
+      std::unique_ptr<TextClassifier> classifier,
+      (core::TaskApiFactory::Create<TextClassifier,
+                                    proto::TextClassifierGraphOptions>(
+          CreateGraphConfig(std::move(options_proto)),
+          std::move(options->base_options.op_resolver))));
+  if (options->result_cache_options.max_entries > 0) {
+    classifier->result_cache_ =
+        std::make_unique<utils::TextResultCache<TextClassifierResult>>(
+            options->result_cache_options);
+  }
+  return classifier;
 }
 
 absl::StatusOr<TextClassifierResult> TextClassifier::Classify(
     absl::string_view text) {
+  if (result_cache_ != nullptr) {
+    if (auto result = result_cache_->Lookup(text); result.has_value()) {
+      return *std::move(result);
+    }
+  }
   ASSIGN_OR_RETURN(
       auto output_packets,
       runner_->Process(
           {{kTextStreamName, MakePacket<std::string>(std::string(text))}}));
-  return ConvertToClassificationResult(
+  TextClassifierResult result = ConvertToClassificationResult(
       output_packets[kClassificationsStreamName].Get<ClassificationResult>());
+  if (result_cache_ != nullptr) {
+    result_cache_->Insert(text, result);
+  }
+  return result;
+}
+
+absl::StatusOr<std::vector<TextClassifierResult>>
+TextClassifier::ClassifyBatch(const std::vector<std::string>& texts) {
+  std::vector<TextClassifierResult> results(texts.size());
+  // Only runs the texts without cached results.
+  std::vector<int> order;
+  order.reserve(texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    if (result_cache_ != nullptr) {
+      if (auto result = result_cache_->Lookup(texts[i]); result.has_value()) {
+        results[i] = *std::move(result);
+        continue;
+      }
+    }
+    order.push_back(i);
+  }
+  // Runs the texts in order of length, so that consecutive texts, which are
+  // batched together, mostly have the same number of tokens.
+  std::stable_sort(order.begin(), order.end(), [&texts](int a, int b) {
+    return texts[a].size() < texts[b].size();
+  });
+  std::vector<PacketMap> batch_inputs;
+  batch_inputs.reserve(order.size());
+  for (int i : order) {
+    batch_inputs.push_back(
+        {{kTextStreamName, MakePacket<std::string>(texts[i])}});
+  }
+  ASSIGN_OR_RETURN(auto batch_outputs,
+                   runner_->ProcessBatch(std::move(batch_inputs)));
+  for (int i = 0; i < order.size(); ++i) {
+    results[order[i]] = ConvertToClassificationResult(
+        batch_outputs[i][kClassificationsStreamName]
+            .Get<ClassificationResult>());
+    if (result_cache_ != nullptr) {
+      result_cache_->Insert(texts[order[i]], results[order[i]]);
+    }
+  }
+  return results;
+}
+
+utils::TextResultCacheStats TextClassifier::GetResultCacheStats() const {
+  return result_cache_ != nullptr ? result_cache_->GetStats()
+                                  : utils::TextResultCacheStats();
 }
 
 }  // namespace text_classifier
@@ -17,6 +17,8 @@ limitations under the License.
 #define MEDIAPIPE_TASKS_CC_TEXT_TEXT_CLASSIFIER_TEXT_CLASSIFIER_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -25,6 +27,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/processors/classifier_options.h"
 #include "mediapipe/tasks/cc/core/base_options.h"
 #include "mediapipe/tasks/cc/core/base_task_api.h"
+#include "mediapipe/tasks/cc/text/utils/text_result_cache.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -44,6 +47,21 @@ struct TextClassifierOptions {
   // Options for configuring the classifier behavior, such as score threshold,
   // number of results, etc.
   components::processors::ClassifierOptions classifier_options;
+
+  // The most texts of ClassifyBatch() whose inference is run as one batched
+  // inference. Batching requires a model with a dynamic batch dimension and
+  // CPU inference. The default runs one inference per text.
+  int max_batch_size = 1;
+
+  // For models with a dynamic sequence length, pads the input to the token
+  // count rounded up to a multiple of this size, if positive, rather than to
+  // the exact token count. Models with a static sequence length are always
+  // padded to it.
+  int seq_len_bucket_size = 0;
+
+  // Options for caching the results by input text, so that repeated texts skip
+  // tokenization and inference. Disabled by default.
+  utils::TextResultCacheOptions result_cache_options;
 };
 
 // Performs classification on text.
@@ -87,8 +105,23 @@ class TextClassifier : core::BaseTaskApi {
   // Performs classification on the input `text`.
   absl::StatusOr<TextClassifierResult> Classify(absl::string_view text);
 
+  // Performs classification on the provided batch of independent `texts`, and
+  // returns the result of each text in order. The texts are pipelined through
+  // the task graph in order of length, so that the tokenization of the next
+  // texts overlaps with the inference on the current one, and texts of similar
+  // length are run in batched inferences of up to `max_batch_size` texts.
+  absl::StatusOr<std::vector<TextClassifierResult>> ClassifyBatch(
+      const std::vector<std::string>& texts);
+
+  // Returns the statistics of the result cache, which are all 0 if result
+  // caching is disabled.
+  utils::TextResultCacheStats GetResultCacheStats() const;
+
   // Shuts down the TextClassifier when all the work is done.
   absl::Status Close() { return runner_->Close(); }
+
+ private:
+  std::unique_ptr<utils::TextResultCache<TextClassifierResult>> result_cache_;
 };
 
 }  // namespace text_classifier
@@ -29,6 +29,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/processors/text_preprocessing_graph.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
+#include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
 #include "mediapipe/tasks/cc/core/proto/model_resources_calculator.pb.h"
 #include "mediapipe/tasks/cc/text/text_classifier/proto/text_classifier_graph_options.pb.h"
 
@@ -121,11 +122,18 @@ class TextClassifierGraph : public core::ModelTaskGraph {
         model_resources,
         preprocessing.GetOptions<
             components::processors::proto::TextPreprocessingGraphOptions>()));
+    preprocessing
+        .GetOptions<
+            components::processors::proto::TextPreprocessingGraphOptions>()
+        .set_seq_len_bucket_size(task_options.seq_len_bucket_size());
     text_in >> preprocessing.In(kTextTag);
 
     // Adds both InferenceCalculator and ModelResourcesCalculator.
     auto& inference = AddInference(
         model_resources, task_options.base_options().acceleration(), graph);
+    inference.GetOptions<core::proto::InferenceSubgraphOptions>()
+        .mutable_batching()
+        ->set_max_batch_size(task_options.max_batch_size());
     // The metadata extractor side-output comes from the
     // ModelResourcesCalculator.
     inference.SideOut(kMetadataExtractorTag) >>
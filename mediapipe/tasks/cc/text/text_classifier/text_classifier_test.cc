@@ -19,6 +19,7 @@ limitations under the License.
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -177,6 +178,55 @@ TEST_F(TextClassifierTest, TextClassifierWithBert) {
   MP_ASSERT_OK(classifier->Close());
 }
 
+TEST_F(TextClassifierTest, TextClassifierWithBertBatch) {
+  auto options = std::make_unique<TextClassifierOptions>();
+  options->base_options.model_asset_path = GetFullPath(kTestBertModelPath);
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextClassifier> classifier,
+                          TextClassifier::Create(std::move(options)));
+  const std::vector<std::string> texts = {
+      "it's a charming and often affecting journey",
+      "unflinchingly bleak and desperate",
+      "it's a charming and often affecting journey"};
+
+  MP_ASSERT_OK_AND_ASSIGN(std::vector<TextClassifierResult> results,
+                          classifier->ClassifyBatch(texts));
+
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(TextClassifierResult expected,
+                            classifier->Classify(texts[i]));
+    ExpectApproximatelyEqual(results[i], expected);
+  }
+  MP_ASSERT_OK(classifier->Close());
+}
+
+TEST_F(TextClassifierTest, TextClassifierWithResultCache) {
+  auto options = std::make_unique<TextClassifierOptions>();
+  options->base_options.model_asset_path = GetFullPath(kTestBertModelPath);
+  options->result_cache_options = {.max_entries = 8,
+                                   .collapse_whitespace = true};
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextClassifier> classifier,
+                          TextClassifier::Create(std::move(options)));
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      TextClassifierResult result,
+      classifier->Classify("it's a charming and often affecting journey"));
+  MP_ASSERT_OK_AND_ASSIGN(
+      TextClassifierResult cached_result,
+      classifier->Classify(" it's a charming  and often affecting journey\n"));
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::vector<TextClassifierResult> batch_results,
+      classifier->ClassifyBatch({"it's a charming and often affecting journey",
+                                 "unflinchingly bleak and desperate"}));
+
+  ExpectApproximatelyEqual(cached_result, result);
+  ExpectApproximatelyEqual(batch_results[0], result);
+  const auto stats = classifier->GetResultCacheStats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 2);
+  MP_ASSERT_OK(classifier->Close());
+}
+
 TEST_F(TextClassifierTest, TextClassifierWithIntInputs) {
   auto options = std::make_unique<TextClassifierOptions>();
   options->base_options.model_asset_path = GetFullPath(kTestRegexModelPath);
@@ -15,7 +15,11 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/text_embedder/text_embedder.h"
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
@@ -29,6 +33,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/core/base_options.h"
 #include "mediapipe/tasks/cc/core/proto/base_options.pb.h"
 #include "mediapipe/tasks/cc/core/task_api_factory.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
 #include "mediapipe/tasks/cc/text/text_embedder/proto/text_embedder_graph_options.pb.h"
 
 namespace mediapipe::tasks::text::text_embedder {
@@ -43,6 +48,7 @@ constexpr char kGraphTypeName[] =
 
 using ::mediapipe::tasks::components::containers::ConvertToEmbeddingResult;
 using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
+using ::mediapipe::tasks::core::PacketMap;
 
 // Creates a MediaPipe graph config that contains a single node of type
 // "mediapipe.tasks.text.text_embedder.TextEmbedderGraph".
@@ -71,6 +77,8 @@ ConvertTextEmbedderOptionsToProto(TextEmbedderOptions* options) {
           components::processors::ConvertEmbedderOptionsToProto(
               &(options->embedder_options)));
   options_proto->mutable_embedder_options()->Swap(embedder_options_proto.get());
+  options_proto->set_max_batch_size(options->max_batch_size);
+  options_proto->set_seq_len_bucket_size(options->seq_len_bucket_size);
   return options_proto;
 }
 
@@ -95,6 +103,31 @@ absl::StatusOr<TextEmbedderResult> TextEmbedder::Embed(absl::string_view text) {
       output_packets[kEmbeddingsStreamName].Get<EmbeddingResult>());
 }
 
+absl::StatusOr<std::vector<TextEmbedderResult>> TextEmbedder::EmbedBatch(
+    const std::vector<std::string>& texts) {
+  // Runs the texts in order of length, so that consecutive texts, which are
+  // batched together, mostly have the same number of tokens.
+  std::vector<int> order(texts.size());
+  for (int i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&texts](int a, int b) {
+    return texts[a].size() < texts[b].size();
+  });
+  std::vector<PacketMap> batch_inputs;
+  batch_inputs.reserve(texts.size());
+  for (int i : order) {
+    batch_inputs.push_back(
+        {{kTextInStreamName, MakePacket<std::string>(texts[i])}});
+  }
+  ASSIGN_OR_RETURN(auto batch_outputs,
+                   runner_->ProcessBatch(std::move(batch_inputs)));
+  std::vector<TextEmbedderResult> results(texts.size());
+  for (int i = 0; i < order.size(); ++i) {
+    results[order[i]] = ConvertToEmbeddingResult(
+        batch_outputs[i][kEmbeddingsStreamName].Get<EmbeddingResult>());
+  }
+  return results;
+}
+
 absl::StatusOr<double> TextEmbedder::CosineSimilarity(
     const components::containers::Embedding& u,
     const components::containers::Embedding& v) {
@@ -17,6 +17,8 @@ limitations under the License.
 #define MEDIAPIPE_TASKS_CC_TEXT_TEXT_EMBEDDER_TEXT_EMBEDDER_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -41,6 +43,17 @@ struct TextEmbedderOptions {
   // Options for configuring the embedder behavior, such as L2-normalization or
   // scalar-quantization.
   components::processors::EmbedderOptions embedder_options;
+
+  // The most texts of EmbedBatch() whose inference is run as one batched
+  // inference. Batching requires a model with a dynamic batch dimension and
+  // CPU inference. The default runs one inference per text.
+  int max_batch_size = 1;
+
+  // For models with a dynamic sequence length, pads the input to the token
+  // count rounded up to a multiple of this size, if positive, rather than to
+  // the exact token count. Models with a static sequence length are always
+  // padded to it.
+  int seq_len_bucket_size = 0;
 };
 
 // Performs embedding extraction on text.
@@ -83,6 +96,15 @@ class TextEmbedder : core::BaseTaskApi {
   // Performs embedding extraction on the input `text`.
   absl::StatusOr<TextEmbedderResult> Embed(absl::string_view text);
 
+  // Performs embedding extraction on the provided batch of independent
+  // `texts`, and returns the result of each text in order. The texts are
+  // pipelined through the task graph in order of length, so that the
+  // tokenization of the next texts overlaps with the inference on the current
+  // one, and texts of similar length are run in batched inferences of up to
+  // `max_batch_size` texts.
+  absl::StatusOr<std::vector<TextEmbedderResult>> EmbedBatch(
+      const std::vector<std::string>& texts);
+
   // Shuts down the TextEmbedder when all the work is done.
   absl::Status Close() { return runner_->Close(); }
 
@@ -16,6 +16,8 @@ limitations under the License.
 #include "mediapipe/tasks/cc/text/text_embedder/text_embedder.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -108,6 +110,31 @@ TEST_F(EmbedderTest, SucceedsWithMobileBert) {
   MP_ASSERT_OK(text_embedder->Close());
 }
 
+TEST_F(EmbedderTest, SucceedsWithMobileBertBatch) {
+  auto options = std::make_unique<TextEmbedderOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kMobileBert);
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextEmbedder> text_embedder,
+                          TextEmbedder::Create(std::move(options)));
+  const std::vector<std::string> texts = {
+      "it's a charming and often affecting journey",
+      "what a great and fantastic trip"};
+
+  MP_ASSERT_OK_AND_ASSIGN(std::vector<TextEmbedderResult> results,
+                          text_embedder->EmbedBatch(texts));
+
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(TextEmbedderResult expected,
+                            text_embedder->Embed(texts[i]));
+    ASSERT_EQ(results[i].embeddings.size(), 1);
+    ASSERT_EQ(results[i].embeddings[0].float_embedding.size(), 512);
+    EXPECT_NEAR(results[i].embeddings[0].float_embedding[0],
+                expected.embeddings[0].float_embedding[0], kEpsilon);
+  }
+  MP_ASSERT_OK(text_embedder->Close());
+}
+
 TEST(EmbedTest, SucceedsWithRegexOneEmbeddingModel) {
   auto options = std::make_unique<TextEmbedderOptions>();
   options->base_options.model_asset_path =
@@ -15,6 +15,11 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/bert_tokenizer.h"
 
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "tensorflow_text/core/kernels/regex_split.h"
 
@@ -24,10 +29,14 @@ namespace text {
 namespace tokenizers {
 
 FlatHashMapBackedWordpiece::FlatHashMapBackedWordpiece(
-    const std::vector<std::string>& vocab)
-    : vocab_{vocab} {
+    const std::vector<std::string>& vocab, absl::string_view suffix_indicator)
+    : vocab_{vocab}, has_suffix_indicator_{!suffix_indicator.empty()} {
   for (int i = 0; i < vocab_.size(); ++i) {
     index_map_[vocab_[i]] = i;
+    absl::string_view word = vocab_[i];
+    if (has_suffix_indicator_ && absl::ConsumePrefix(&word, suffix_indicator)) {
+      suffix_index_map_[word] = i;
+    }
   }
 }
 
@@ -47,6 +56,19 @@ bool FlatHashMapBackedWordpiece::LookupId(const absl::string_view key,
   return true;
 }
 
+bool FlatHashMapBackedWordpiece::LookupSuffixId(const absl::string_view key,
+                                                int* result) const {
+  if (!has_suffix_indicator_) {
+    return LookupId(key, result);
+  }
+  auto it = suffix_index_map_.find(key);
+  if (it == suffix_index_map_.end()) {
+    return false;
+  }
+  *result = it->second;
+  return true;
+}
+
 bool FlatHashMapBackedWordpiece::LookupWord(int vocab_id,
                                             absl::string_view* result) const {
   if (vocab_id >= vocab_.size() || vocab_id < 0) {
@@ -103,6 +125,82 @@ WordpieceTokenizerResult BertTokenizer::TokenizeWordpiece(
   return result;
 }
 
+int BertTokenizer::TokenizeIntoIds(const std::string& input,
+                                   absl::Span<int32_t> ids) {
+  if (options_.split_unknown_chars) {
+    // Rarely used, and only supported by WordpieceTokenize.
+    return Tokenizer::TokenizeIntoIds(input, ids);
+  }
+  split_tokens_.clear();
+  split_begin_offsets_.clear();
+  split_end_offsets_.clear();
+  tensorflow::text::RegexSplit(input, delim_re_, true, include_delim_re_,
+                               &split_tokens_, &split_begin_offsets_,
+                               &split_end_offsets_);
+  int num_ids = 0;
+  for (absl::string_view token : split_tokens_) {
+    num_ids = AppendWordpieceIds(token, ids, num_ids);
+  }
+  return num_ids;
+}
+
+int BertTokenizer::AppendWordpieceIds(absl::string_view token,
+                                      absl::Span<int32_t> ids,
+                                      int num_ids) const {
+  const int unknown_id = options_.use_unknown_token ? unknown_token_id_ : 0;
+  auto append_id = [&ids, &num_ids](int id) {
+    if (num_ids < ids.size()) {
+      ids[num_ids] = id;
+    }
+    ++num_ids;
+  };
+  if (token.size() > options_.max_bytes_per_token) {
+    append_id(unknown_id);
+    return num_ids;
+  }
+  // Greedy longest match first, as in tensorflow::text::WordpieceTokenize.
+  const int token_start_num_ids = num_ids;
+  int byte_start = 0;
+  while (byte_start < token.size()) {
+    // Finds the candidate end after at most max_chars_per_subtoken UTF-8
+    // characters.
+    int byte_end = byte_start;
+    for (int num_chars = 0;
+         byte_end < token.size() &&
+         (options_.max_chars_per_subtoken <= 0 ||
+          num_chars < options_.max_chars_per_subtoken);
+         ++num_chars) {
+      ++byte_end;
+      while (byte_end < token.size() &&
+             (static_cast<uint8_t>(token[byte_end]) & 0xC0) == 0x80) {
+        ++byte_end;
+      }
+    }
+    int id = 0;
+    bool found = false;
+    while (byte_end > byte_start) {
+      absl::string_view candidate =
+          token.substr(byte_start, byte_end - byte_start);
+      found = byte_start == 0 ? vocab_.LookupId(candidate, &id)
+                              : vocab_.LookupSuffixId(candidate, &id);
+      if (found) break;
+      do {
+        --byte_end;
+      } while (byte_end > byte_start &&
+               (static_cast<uint8_t>(token[byte_end]) & 0xC0) == 0x80);
+    }
+    if (!found) {
+      // The whole token is replaced by a single unknown token.
+      num_ids = token_start_num_ids;
+      append_id(unknown_id);
+      return num_ids;
+    }
+    append_id(id);
+    byte_start = byte_end;
+  }
+  return num_ids;
+}
+
 }  // namespace tokenizers
 }  // namespace text
 }  // namespace tasks
@@ -17,12 +17,14 @@ limitations under the License.
 #define MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_BERT_TOKENIZER_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "mediapipe/tasks/cc/text/tokenizers/tokenizer.h"
 #include "mediapipe/tasks/cc/text/utils/vocab_utils.h"
 #include "re2/re2.h"
@@ -72,11 +74,15 @@ struct BertTokenizerOptions {
 // BertTokenizer to invoke tensorflow::text::WordpieceTokenize within.
 class FlatHashMapBackedWordpiece : public tensorflow::text::WordpieceVocab {
  public:
-  explicit FlatHashMapBackedWordpiece(const std::vector<std::string>& vocab);
+  explicit FlatHashMapBackedWordpiece(const std::vector<std::string>& vocab,
+                                      absl::string_view suffix_indicator = "");
 
   tensorflow::text::LookupStatus Contains(absl::string_view key,
                                           bool* value) const override;
   bool LookupId(absl::string_view key, int* result) const;
+  // Finds the id of the suffix wordpiece `suffix_indicator` + `key`, without
+  // concatenating them.
+  bool LookupSuffixId(absl::string_view key, int* result) const;
   bool LookupWord(int vocab_id, absl::string_view* result) const;
   int VocabularySize() const { return vocab_.size(); }
 
@@ -84,6 +90,10 @@ class FlatHashMapBackedWordpiece : public tensorflow::text::WordpieceVocab {
   // All words indexed position in vocabulary file.
   std::vector<std::string> vocab_;
   absl::flat_hash_map<absl::string_view, int> index_map_;
+  // Suffix wordpieces indexed without their suffix indicator. Unused without
+  // a suffix indicator, when suffixes are looked up in index_map_.
+  absl::flat_hash_map<absl::string_view, int> suffix_index_map_;
+  bool has_suffix_indicator_;
 };
 
 // Wordpiece tokenizer for bert models. Initialized with a vocab file or vector.
@@ -92,10 +102,12 @@ class BertTokenizer : public mediapipe::tasks::text::tokenizers::Tokenizer {
   // Initialize the tokenizer from vocab vector and tokenizer configs.
   explicit BertTokenizer(const std::vector<std::string>& vocab,
                          const BertTokenizerOptions& options = {})
-      : vocab_{FlatHashMapBackedWordpiece(vocab)},
+      : vocab_{FlatHashMapBackedWordpiece(vocab, options.suffix_indicator)},
         options_{options},
         delim_re_{options.delim_str},
-        include_delim_re_{options.include_delim_str} {}
+        include_delim_re_{options.include_delim_str} {
+    vocab_.LookupId(options_.unknown_token, &unknown_token_id_);
+  }
 
   // Initialize the tokenizer from file path to vocab and tokenizer configs.
   explicit BertTokenizer(const std::string& path_to_vocab,
@@ -118,6 +130,12 @@ class BertTokenizer : public mediapipe::tasks::text::tokenizers::Tokenizer {
   // subwords and offsets
   WordpieceTokenizerResult TokenizeWordpiece(const std::string& input) const;
 
+  // Perform tokenization, writing the ids of the wordpieces into `ids`. The
+  // wordpieces are looked up as views into `input`, so no memory is allocated
+  // per wordpiece. Same results as TokenizeWordpiece followed by LookupId.
+  int TokenizeIntoIds(const std::string& input,
+                      absl::Span<int32_t> ids) override;
+
   // Check if a certain key is included in the vocab.
   tensorflow::text::LookupStatus Contains(const absl::string_view key,
                                           bool* value) const {
@@ -137,10 +155,21 @@ class BertTokenizer : public mediapipe::tasks::text::tokenizers::Tokenizer {
   int VocabularySize() const { return vocab_.VocabularySize(); }
 
  private:
+  // Writes the ids of the wordpieces of `token` into `ids` from `num_ids` on,
+  // and returns the new number of ids.
+  int AppendWordpieceIds(absl::string_view token, absl::Span<int32_t> ids,
+                         int num_ids) const;
+
   mediapipe::tasks::text::tokenizers::FlatHashMapBackedWordpiece vocab_;
   BertTokenizerOptions options_;
   RE2 delim_re_;
   RE2 include_delim_re_;
+  int unknown_token_id_ = 0;
+
+  // Reused across TokenizeIntoIds calls.
+  std::vector<absl::string_view> split_tokens_;
+  std::vector<long long> split_begin_offsets_;  // NOLINT
+  std::vector<long long> split_end_offsets_;    // NOLINT
 };
 
 }  // namespace tokenizers
@@ -0,0 +1,88 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks the throughput of BertTokenizer on an input of 512 wordpieces,
+// the usual maximum sequence length of BERT models, comparing tokenization
+// into subwords followed by id lookups against direct tokenization into ids.
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/tasks/cc/text/tokenizers/bert_tokenizer.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace text {
+namespace tokenizers {
+namespace {
+
+constexpr char kTestVocabPath[] =
+    "mediapipe/tasks/testdata/text/mobilebert_vocab.txt";
+constexpr int kNumWordpieces = 512;
+constexpr char kSentence[] =
+    "it's a charming and often affecting journey, questionably unbelievable "
+    "but well worth the tokenization. ";
+
+// Returns an input of kSentence repeated to at least kNumWordpieces
+// wordpieces.
+std::string MakeInput(BertTokenizer& tokenizer) {
+  std::string input;
+  while (tokenizer.TokenizeWordpiece(input).subwords.size() < kNumWordpieces) {
+    input += kSentence;
+  }
+  return input;
+}
+
+void BM_TokenizeWordpieceAndLookupIds(benchmark::State& state) {
+  BertTokenizer tokenizer(kTestVocabPath);
+  const std::string input = MakeInput(tokenizer);
+  std::vector<int32_t> ids;
+  for (auto _ : state) {
+    WordpieceTokenizerResult result = tokenizer.TokenizeWordpiece(input);
+    ids.clear();
+    for (const std::string& subword : result.subwords) {
+      int id = 0;
+      tokenizer.LookupId(subword, &id);
+      ids.push_back(id);
+    }
+    benchmark::DoNotOptimize(ids.data());
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_TokenizeWordpieceAndLookupIds);
+
+void BM_TokenizeIntoIds(benchmark::State& state) {
+  BertTokenizer tokenizer(kTestVocabPath);
+  const std::string input = MakeInput(tokenizer);
+  std::vector<int32_t> ids(kNumWordpieces * 2);
+  for (auto _ : state) {
+    int num_ids = tokenizer.TokenizeIntoIds(input, absl::MakeSpan(ids));
+    ABSL_CHECK_LE(num_ids, ids.size());
+    benchmark::DoNotOptimize(ids.data());
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_TokenizeIntoIds);
+
+}  // namespace
+}  // namespace tokenizers
+}  // namespace text
+}  // namespace tasks
+}  // namespace mediapipe
+
+BENCHMARK_MAIN();
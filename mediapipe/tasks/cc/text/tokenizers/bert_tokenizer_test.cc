@@ -15,6 +15,11 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/bert_tokenizer.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/tasks/cc/core/utils.h"
@@ -181,6 +186,67 @@ TEST(TokenizerTest, TestLVocabularySize) {
   ASSERT_EQ(tokenizer->VocabularySize(), 4);
 }
 
+TEST(TokenizerTest, TestTokenizeIntoIdsMatchesTokenizeWordpiece) {
+#ifdef _WIN32
+  // TODO: Investigate why these tests are failing
+  GTEST_SKIP("Unexpected result on Windows");
+#endif  // _WIN32
+  auto tokenizer = absl::make_unique<BertTokenizer>(kTestVocabPath);
+  const std::string input =
+      "i'm questionansweraskask, naïve café 東京 xqzvxqzvxqzv!";
+
+  auto results = tokenizer->TokenizeWordpiece(input);
+  std::vector<int32_t> expected_ids;
+  for (const std::string& subword : results.subwords) {
+    int id = 0;
+    tokenizer->LookupId(subword, &id);
+    expected_ids.push_back(id);
+  }
+
+  std::vector<int32_t> ids(expected_ids.size() + 1, -1);
+  ASSERT_EQ(tokenizer->TokenizeIntoIds(input, absl::MakeSpan(ids)),
+            expected_ids.size());
+  ids.pop_back();
+  EXPECT_EQ(ids, expected_ids);
+}
+
+TEST(TokenizerTest, TestTokenizeIntoIdsTruncates) {
+  std::vector<std::string> vocab;
+  vocab.emplace_back("i");
+  vocab.emplace_back("'");
+  vocab.emplace_back("m");
+  vocab.emplace_back("question");
+  vocab.emplace_back("##ing");
+  auto tokenizer = absl::make_unique<BertTokenizer>(vocab);
+
+  std::vector<int32_t> ids(3);
+  EXPECT_EQ(tokenizer->TokenizeIntoIds("i'm questioning", absl::MakeSpan(ids)),
+            5);
+  EXPECT_THAT(ids, ElementsAre(0, 1, 2));
+
+  ids.resize(5);
+  EXPECT_EQ(tokenizer->TokenizeIntoIds("i'm questioning", absl::MakeSpan(ids)),
+            5);
+  EXPECT_THAT(ids, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(TokenizerTest, TestTokenizeIntoIdsUnknownTokens) {
+  std::vector<std::string> vocab;
+  vocab.emplace_back("[UNK]");
+  vocab.emplace_back("i");
+  vocab.emplace_back("question");
+  vocab.emplace_back("##ing");
+  auto tokenizer = absl::make_unique<BertTokenizer>(vocab);
+
+  // "questionxyz" matches "question" first, but then has no match for "xyz",
+  // so the whole token becomes a single unknown token.
+  std::vector<int32_t> ids(4);
+  EXPECT_EQ(tokenizer->TokenizeIntoIds("i questionxyz questioning",
+                                       absl::MakeSpan(ids)),
+            4);
+  EXPECT_THAT(ids, ElementsAre(1, 0, 2, 3));
+}
+
 }  // namespace tokenizers
 }  // namespace text
 }  // namespace tasks
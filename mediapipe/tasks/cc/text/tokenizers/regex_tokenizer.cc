@@ -15,9 +15,17 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/regex_tokenizer.h"
 
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <string>
 
+#include "absl/functional/function_ref.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/types/span.h"
 #include "mediapipe/tasks/cc/text/utils/vocab_utils.h"
 
 namespace mediapipe {
@@ -42,6 +50,201 @@ void buildIndexTokenMap(
   }
 }
 
+using ByteSet = std::array<bool, 256>;
+
+// Adds the bytes of the Perl character class `\c` (e.g. \s or \W) to `set`,
+// following RE2 which only has ASCII characters in \s, \w and \d. Returns
+// false if `c` is not such a class.
+bool AddPerlClass(char c, ByteSet& set) {
+  ByteSet members = {};
+  switch (c) {
+    case 's':
+    case 'S':
+      for (char member : {'\t', '\n', '\f', '\r', ' '}) {
+        members[member] = true;
+      }
+      break;
+    case 'w':
+    case 'W':
+      for (int b = 0; b < 128; ++b) {
+        members[b] = absl::ascii_isalnum(b) || b == '_';
+      }
+      break;
+    case 'd':
+    case 'D':
+      for (int b = '0'; b <= '9'; ++b) {
+        members[b] = true;
+      }
+      break;
+    default:
+      return false;
+  }
+  const bool negated = absl::ascii_isupper(c);
+  for (int b = 0; b < 256; ++b) {
+    set[b] |= members[b] != negated;
+  }
+  return true;
+}
+
+// Parses the escaped character `\c` standing for a single ASCII character.
+std::optional<uint8_t> ParseEscapedChar(char c) {
+  switch (c) {
+    case 't':
+      return '\t';
+    case 'n':
+      return '\n';
+    case 'r':
+      return '\r';
+    case 'f':
+      return '\f';
+    case 'v':
+      return '\v';
+    default:
+      if (absl::ascii_ispunct(c)) {
+        return c;
+      }
+      return std::nullopt;
+  }
+}
+
+// Returns the bytes matched by `pattern` if it is a single character class
+// with only ASCII literals, e.g. "[^\w\']+", "\s+" or "[,.;]", optionally
+// repeated with '+'. Repetitions don't change the tokens since empty tokens
+// are dropped. Returns nullopt for other patterns.
+std::optional<ByteSet> ParseDelimiterClass(absl::string_view pattern) {
+  if (pattern.size() >= 2 && pattern.front() == '(' && pattern.back() == ')' &&
+      pattern[1] != '?') {
+    pattern = pattern.substr(1, pattern.size() - 2);
+  }
+  if (!pattern.empty() && pattern.back() == '+') {
+    pattern.remove_suffix(1);
+  }
+  ByteSet set = {};
+  if (pattern.size() == 2 && pattern[0] == '\\') {
+    if (AddPerlClass(pattern[1], set)) {
+      return set;
+    }
+    std::optional<uint8_t> c = ParseEscapedChar(pattern[1]);
+    if (!c.has_value()) {
+      return std::nullopt;
+    }
+    set[*c] = true;
+    return set;
+  }
+  if (pattern.size() == 1) {
+    const uint8_t c = pattern[0];
+    if (c >= 0x80 ||
+        absl::string_view(".^$|()[]{}*+?\\").find(c) != absl::string_view::npos) {
+      return std::nullopt;
+    }
+    set[c] = true;
+    return set;
+  }
+  if (pattern.size() < 3 || pattern.front() != '[' || pattern.back() != ']') {
+    return std::nullopt;
+  }
+  absl::string_view items = pattern.substr(1, pattern.size() - 2);
+  const bool negated = !items.empty() && items[0] == '^';
+  if (negated) {
+    items.remove_prefix(1);
+  }
+  // A leading ']' would be a literal, which is rare enough not to handle.
+  if (items.empty() || items[0] == ']') {
+    return std::nullopt;
+  }
+  // Parses the literal of `items` at `i`, and advances `i` past it.
+  auto parse_literal = [&items](size_t& i) -> std::optional<uint8_t> {
+    const uint8_t c = items[i++];
+    if (c == '\\') {
+      if (i == items.size()) {
+        return std::nullopt;
+      }
+      return ParseEscapedChar(items[i++]);
+    }
+    if (c >= 0x80 || c == '[' || c == ']') {
+      return std::nullopt;
+    }
+    return c;
+  };
+  size_t i = 0;
+  while (i < items.size()) {
+    if (items[i] == '\\' && i + 1 < items.size() &&
+        AddPerlClass(items[i + 1], set)) {
+      i += 2;
+      continue;
+    }
+    std::optional<uint8_t> low = parse_literal(i);
+    if (!low.has_value()) {
+      return std::nullopt;
+    }
+    uint8_t high = *low;
+    if (i + 1 < items.size() && items[i] == '-') {
+      ++i;
+      std::optional<uint8_t> range_end = parse_literal(i);
+      if (!range_end.has_value() || *range_end < *low) {
+        return std::nullopt;
+      }
+      high = *range_end;
+    }
+    for (int b = *low; b <= high; ++b) {
+      set[b] = true;
+    }
+  }
+  if (negated) {
+    for (bool& member : set) {
+      member = !member;
+    }
+  }
+  return set;
+}
+
+// Returns whether `text` is valid UTF-8, without overlong encodings or
+// surrogates, which RE2 doesn't match as characters.
+bool IsValidUtf8(absl::string_view text) {
+  size_t i = 0;
+  while (i < text.size()) {
+    const uint8_t lead = text[i];
+    if (lead < 0x80) {
+      ++i;
+      continue;
+    }
+    int length;
+    uint32_t code_point;
+    uint32_t min_code_point;
+    if ((lead & 0xE0) == 0xC0) {
+      length = 2;
+      code_point = lead & 0x1F;
+      min_code_point = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+      length = 3;
+      code_point = lead & 0x0F;
+      min_code_point = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+      length = 4;
+      code_point = lead & 0x07;
+      min_code_point = 0x10000;
+    } else {
+      return false;
+    }
+    if (i + length > text.size()) {
+      return false;
+    }
+    for (int k = 1; k < length; ++k) {
+      const uint8_t continuation = text[i + k];
+      if ((continuation & 0xC0) != 0x80) {
+        return false;
+      }
+      code_point = (code_point << 6) | (continuation & 0x3F);
+    }
+    if (code_point < min_code_point || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      return false;
+    }
+    i += length;
+  }
+  return true;
+}
+
 }  // namespace
 
 // RE2::FindAndConsume requires the delim_re_ to have a matching group in order
@@ -52,7 +255,12 @@ RegexTokenizer::RegexTokenizer(const std::string& regex_pattern,
                                const std::string& path_to_vocab)
     : delim_re_{absl::Substitute("($0)", regex_pattern)},
       token_index_map_{LoadVocabAndIndexFromFile(path_to_vocab)} {
-  buildIndexTokenMap(token_index_map_, &index_token_map_);
+  buildIndexTokenMap(token_index_map_, &index_token_map_);  std::optional<ByteSet> delim_table = ParseDelimiterClass(regex_pattern);
+  has_delim_table_ = delim_table.has_value();
+  if (has_delim_table_) {
+    delim_table_ = *delim_table;
+  }
+  GetUnknownToken(&unknown_token_id_);
 }
 
 RegexTokenizer::RegexTokenizer(const std::string& regex_pattern,
@@ -61,14 +269,38 @@ RegexTokenizer::RegexTokenizer(const std::string& regex_pattern,
     : delim_re_{absl::Substitute("($0)", regex_pattern)},
       token_index_map_{
           LoadVocabAndIndexFromBuffer(vocab_buffer_data, vocab_buffer_size)} {
-  buildIndexTokenMap(token_index_map_, &index_token_map_);
+  buildIndexTokenMap(token_index_map_, &index_token_map_);  std::optional<ByteSet> delim_table = ParseDelimiterClass(regex_pattern);
+  has_delim_table_ = delim_table.has_value();
+  if (has_delim_table_) {
+    delim_table_ = *delim_table;
+  }
+  GetUnknownToken(&unknown_token_id_);
 }
 
-TokenizerResult RegexTokenizer::Tokenize(const std::string& input) {
+void RegexTokenizer::ForEachToken(
+    const std::string& input,
+    absl::FunctionRef<void(absl::string_view)> callback) const {
   absl::string_view leftover(input.data());
-  absl::string_view last_end = leftover;
 
-  TokenizerResult result;
+  // The bytes of invalid UTF-8 are never delimiters for RE2, unlike those of
+  // non-ASCII characters if they are delimiters.
+  if (has_delim_table_ && (!delim_table_[0x80] || IsValidUtf8(leftover))) {
+    size_t token_begin = 0;
+    for (size_t i = 0; i < leftover.size(); ++i) {
+      if (delim_table_[static_cast<uint8_t>(leftover[i])]) {
+        if (i > token_begin) {
+          callback(leftover.substr(token_begin, i - token_begin));
+        }
+        token_begin = i + 1;
+      }
+    }
+    if (leftover.size() > token_begin) {
+      callback(leftover.substr(token_begin));
+    }
+    return;
+  }
+
+  absl::string_view last_end = leftover;
 
   // Keep looking for split points until we have reached the end of the input.
   absl::string_view extracted_delim_token;
@@ -81,18 +313,38 @@ TokenizerResult RegexTokenizer::Tokenize(const std::string& input) {
 
     // Mark the end of the previous token, only if there was something.
     if (has_non_empty_token) {
-      result.subwords.push_back(std::string(token));
+      callback(token);
     }
   }
 
   // Close the last token.
   if (!leftover.empty()) {
-    result.subwords.push_back(std::string(leftover));
+    callback(leftover);
   }
+}
 
+TokenizerResult RegexTokenizer::Tokenize(const std::string& input) {
+  TokenizerResult result;
+  ForEachToken(input, [&result](absl::string_view token) {
+    result.subwords.push_back(std::string(token));
+  });
   return result;
 }
 
+int RegexTokenizer::TokenizeIntoIds(const std::string& input,
+                                    absl::Span<int32_t> ids) {
+  int num_tokens = 0;
+  ForEachToken(input, [&](absl::string_view token) {
+    if (num_tokens < ids.size()) {
+      auto it = token_index_map_.find(token);
+      ids[num_tokens] =
+          it == token_index_map_.end() ? unknown_token_id_ : it->second;
+    }
+    ++num_tokens;
+  });
+  return num_tokens;
+}
+
 bool RegexTokenizer::LookupId(absl::string_view key, int* result) const {
   auto it = token_index_map_.find(key);
   if (it == token_index_map_.end()) {
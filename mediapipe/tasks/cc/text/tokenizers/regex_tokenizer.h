@@ -16,11 +16,15 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_REGEX_TOKENIZER_H_
 #define MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_REGEX_TOKENIZER_H_
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "absl/container/node_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "mediapipe/tasks/cc/text/tokenizers/tokenizer.h"
 #include "re2/re2.h"
 
@@ -30,6 +34,10 @@ namespace text {
 namespace tokenizers {
 
 // Tokenizer to load a vocabulary and split text by regular expressions.
+//
+// Delimiter patterns made of a single character class, such as "[^\w\']+" or
+// "\s+", are matched byte by byte with a lookup table instead of RE2, which
+// yields the same tokens.
 class RegexTokenizer : public Tokenizer {
  public:
   explicit RegexTokenizer(const std::string& regex_pattern,
@@ -41,6 +49,12 @@ class RegexTokenizer : public Tokenizer {
 
   TokenizerResult Tokenize(const std::string& input) override;
 
+  // Performs tokenization and writes the ids of the tokens into `ids`, with the
+  // id of the <UNKNOWN> token, or 0 without one, for tokens missing from the
+  // vocabulary. Returns the total number of tokens.
+  int TokenizeIntoIds(const std::string& input,
+                      absl::Span<int32_t> ids) override;
+
   bool LookupId(absl::string_view key, int* result) const override;
 
   bool LookupWord(int vocab_id, absl::string_view* result) const override;
@@ -50,7 +64,19 @@ class RegexTokenizer : public Tokenizer {
   bool GetUnknownToken(int* unknown_token);
 
  private:
+  // Calls `callback` on each non-empty token of `input`.
+  void ForEachToken(
+      const std::string& input,
+      absl::FunctionRef<void(absl::string_view)> callback) const;
+
   RE2 delim_re_;
+  // Whether the bytes of `delim_table_` tell the delimiters apart, i.e. whether
+  // the delimiter pattern is a single character class.
+  bool has_delim_table_ = false;
+  // Whether each byte is a delimiter. All the bytes from 0x80 on, i.e. of
+  // non-ASCII characters, are delimiters or none are.
+  std::array<bool, 256> delim_table_ = {};
+  int unknown_token_id_ = 0;
   absl::node_hash_map<std::string, int> token_index_map_;
   absl::node_hash_map<int, absl::string_view> index_token_map_;
 };
@@ -15,6 +15,12 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/regex_tokenizer.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/tasks/cc/core/utils.h"
@@ -60,6 +66,48 @@ TEST(RegexTokenizerTest, TestTokenizeFromFileBuffer) {
               ElementsAre("good", "morning", "i'm", "your", "teacher"));
 }
 
+TEST(RegexTokenizerTest, TestTokenizeIntoIds) {
+  auto tokenizer = CreateRegexTokenizer(kRegex, kTestRegexVocabPath);
+  std::vector<int32_t> ids(6, -1);
+  int num_tokens = tokenizer->TokenizeIntoIds(
+      "good    morning, i'm your qwertyuiop teacher.\n", absl::MakeSpan(ids));
+  EXPECT_EQ(num_tokens, 6);
+  // The <UNKNOWN> token has id 2.
+  EXPECT_THAT(ids, ElementsAre(52, 1972, 146, 129, 2, 1750));
+
+  std::vector<int32_t> truncated_ids(2, -1);
+  num_tokens = tokenizer->TokenizeIntoIds("good morning, i'm your teacher.",
+                                          absl::MakeSpan(truncated_ids));
+  EXPECT_EQ(num_tokens, 5);
+  EXPECT_THAT(truncated_ids, ElementsAre(52, 1972));
+}
+
+TEST(RegexTokenizerTest, TestCharacterClassMatchesRegex) {
+  // Patterns that are matched byte by byte, and equivalent patterns that are
+  // matched by RE2.
+  const std::vector<std::string> patterns = {
+      kRegex, "\\s+", "\\W", "([ ,.!?])", "[^a-z0-9]+", "[\\d\\-\\t]+", "x"};
+  const std::vector<std::string> inputs = {
+      "",
+      "good    morning, i'm your teacher.\n",
+      "  leading and trailing  ",
+      "tabs\tand\nnewlines\r\fand-dashes 123-456",
+      "caf\xc3\xa9 na\xc3\xafve \xe2\x80\x94 \xf0\x9f\x98\x80 emoji",
+      "invalid \xff\xfe utf-8 \xc3",
+      "overlong \xc0\xaf and surrogate \xed\xa0\x80",
+      "xxaxxbx"};
+  for (const std::string& pattern : patterns) {
+    auto tokenizer = CreateRegexTokenizer(pattern, kTestRegexVocabPath);
+    auto reference_tokenizer = CreateRegexTokenizer(
+        absl::StrCat(pattern, "|", pattern), kTestRegexVocabPath);
+    for (const std::string& input : inputs) {
+      EXPECT_EQ(tokenizer->Tokenize(input).subwords,
+                reference_tokenizer->Tokenize(input).subwords)
+          << "pattern: " << pattern << ", input: " << input;
+    }
+  }
+}
+
 TEST(RegexTokenizerTest, TestLookupId) {
   std::string buffer = LoadBinaryContent(kTestRegexVocabPath);
   auto tokenizer = CreateRegexTokenizer(kRegex, kTestRegexVocabPath);
@@ -16,13 +16,16 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_SENTENCEPIECE_TOKENIZER_H_
 #define MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_SENTENCEPIECE_TOKENIZER_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
 
 #include "absl/log/absl_check.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/tasks/cc/text/tokenizers/tokenizer.h"
 #include "src/sentencepiece_processor.h"
@@ -61,6 +64,17 @@ class SentencePieceTokenizer : public Tokenizer {
     return result;
   }
 
+  // Performs tokenization into the ids of the pieces, without materializing
+  // the pieces. The ids are encoded into a buffer reused across calls.
+  int TokenizeIntoIds(const std::string& input,
+                      absl::Span<int32_t> ids) override {
+    const auto status = sp_.Encode(input, &ids_buffer_);
+    ABSL_CHECK(status.ok()) << status.ToString();
+    const int num_ids = std::min(ids_buffer_.size(), ids.size());
+    std::copy_n(ids_buffer_.begin(), num_ids, ids.begin());
+    return ids_buffer_.size();
+  }
+
   // Find the id of a string token.
   bool LookupId(absl::string_view key, int* result) const override {
     *result = sp_.PieceToId(key);
@@ -75,6 +89,7 @@ class SentencePieceTokenizer : public Tokenizer {
 
  private:
   sentencepiece::SentencePieceProcessor sp_;
+  std::vector<int> ids_buffer_;
 };
 
 }  // namespace tokenizers
@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/sentencepiece_tokenizer.h"
 
+#include <cstdint>
+#include <vector>
+
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/tasks/cc/core/utils.h"
@@ -55,6 +59,21 @@ TEST(SentencePieceTokenizerTest, TestTokenizeFromFileBuffer) {
                           "▁teacher", "."));
 }
 
+TEST(SentencePieceTokenizerTest, TestTokenizeIntoIds) {
+  auto tokenizer = CreateSentencePieceTokenizer(kTestSPModelPath);
+  std::vector<int32_t> ids(9, -1);
+  EXPECT_EQ(tokenizer->TokenizeIntoIds("good morning, i'm your teacher.\n",
+                                       absl::MakeSpan(ids)),
+            9);
+  EXPECT_THAT(ids, ElementsAre(254, 959, 15, 31, 22, 79, 154, 2197, 9));
+
+  std::vector<int32_t> truncated_ids(2, -1);
+  EXPECT_EQ(tokenizer->TokenizeIntoIds("good morning, i'm your teacher.\n",
+                                       absl::MakeSpan(truncated_ids)),
+            9);
+  EXPECT_THAT(truncated_ids, ElementsAre(254, 959));
+}
+
 TEST(SentencePieceTokenizerTest, TestLookupId) {
   auto tokenizer = CreateSentencePieceTokenizer(kTestSPModelPath);
   std::vector<std::string> subwords = {"▁good", "▁morning", ",", "▁i", "'", "m",
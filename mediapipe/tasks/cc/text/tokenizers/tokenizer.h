@@ -16,11 +16,14 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_TOKENIZER_H_
 #define MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_TOKENIZER_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -43,6 +46,23 @@ class Tokenizer {
   // Find the string token from an id.
   virtual bool LookupWord(int vocab_id, absl::string_view* result) const = 0;
 
+  // Performs tokenization and writes the ids of the tokens into `ids`, with id
+  // 0 for tokens missing from the vocabulary. Returns the total number of
+  // tokens, of which only the first `ids.size()` are written if there are
+  // more. Tokenizers override this to avoid materializing the tokens.
+  virtual int TokenizeIntoIds(const std::string& input,
+                              absl::Span<int32_t> ids) {
+    TokenizerResult result = Tokenize(input);
+    const int num_ids =
+        std::min(result.subwords.size(), static_cast<size_t>(ids.size()));
+    for (int i = 0; i < num_ids; ++i) {
+      int id = 0;
+      LookupId(result.subwords[i], &id);
+      ids[i] = id;
+    }
+    return result.subwords.size();
+  }
+
   // Destructor.
   virtual ~Tokenizer() = default;
 };
@@ -0,0 +1,146 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_TEXT_UTILS_TEXT_RESULT_CACHE_H_
+#define MEDIAPIPE_TASKS_CC_TEXT_UTILS_TEXT_RESULT_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace mediapipe::tasks::text::utils {
+
+// Options for caching the results of a text task.
+struct TextResultCacheOptions {
+  // The most results kept, evicting the least recently used ones. The default
+  // of 0 disables caching.
+  int max_entries = 0;
+
+  // Whether texts that only differ in leading, trailing or repeated ASCII
+  // whitespace share results. Only enable this for models that split their
+  // input on whitespace, such as models with a BERT or a whitespace regex
+  // tokenizer, whose results don't depend on the whitespace.
+  bool collapse_whitespace = false;
+};
+
+// Statistics of the lookups in a TextResultCache.
+struct TextResultCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+
+  // Returns the fraction of the lookups that were hits, or 0 without lookups.
+  double hit_ratio() const {
+    return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses)
+                             : 0.0;
+  }
+};
+
+// A bounded cache of the results of a text task by input text, evicting the
+// least recently used results. The options of the task are fixed, so each task
+// instance owns its cache. This class is thread-safe.
+template <typename Result>
+class TextResultCache {
+ public:
+  explicit TextResultCache(TextResultCacheOptions options)
+      : options_(std::move(options)) {}
+
+  TextResultCache(const TextResultCache&) = delete;
+  TextResultCache& operator=(const TextResultCache&) = delete;
+
+  // Returns the cached result for `text`, if any.
+  std::optional<Result> Lookup(absl::string_view text) {
+    const std::string key = Normalize(text);
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return std::nullopt;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+
+  // Caches `result` for `text`, evicting the least recently used result if the
+  // cache is full.
+  void Insert(absl::string_view text, Result result) {
+    std::string key = Normalize(text);
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      it->second->second = std::move(result);
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+    if (index_.size() >= options_.max_entries) {
+      if (entries_.empty()) return;
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    entries_.emplace_front(std::move(key), std::move(result));
+    index_.emplace(entries_.front().first, entries_.begin());
+  }
+
+  // Returns the statistics of the lookups so far.
+  TextResultCacheStats GetStats() const {
+    absl::MutexLock lock(&mutex_);
+    return stats_;
+  }
+
+ private:
+  using Entry = std::pair<std::string, Result>;
+
+  // Returns the cache key of `text`.
+  std::string Normalize(absl::string_view text) const {
+    if (!options_.collapse_whitespace) {
+      return std::string(text);
+    }
+    std::string key;
+    key.reserve(text.size());
+    bool pending_space = false;
+    for (char c : absl::StripAsciiWhitespace(text)) {
+      if (absl::ascii_isspace(c)) {
+        pending_space = true;
+        continue;
+      }
+      if (pending_space) {
+        key.push_back(' ');
+        pending_space = false;
+      }
+      key.push_back(c);
+    }
+    return key;
+  }
+
+  const TextResultCacheOptions options_;
+  mutable absl::Mutex mutex_;
+  // The entries from the most to the least recently used.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // The entries by key, which views the key stored in the entry.
+  absl::flat_hash_map<absl::string_view, typename std::list<Entry>::iterator>
+      index_ ABSL_GUARDED_BY(mutex_);
+  TextResultCacheStats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace mediapipe::tasks::text::utils
+
+#endif  // MEDIAPIPE_TASKS_CC_TEXT_UTILS_TEXT_RESULT_CACHE_H_
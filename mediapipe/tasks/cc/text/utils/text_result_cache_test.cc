@@ -0,0 +1,78 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/text/utils/text_result_cache.h"
+
+#include <optional>
+#include <string>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe::tasks::text::utils {
+namespace {
+
+using ::testing::DoubleEq;
+using ::testing::Optional;
+
+TEST(TextResultCacheTest, ReturnsInsertedResults) {
+  TextResultCache<std::string> cache({.max_entries = 2});
+
+  EXPECT_EQ(cache.Lookup("hello"), std::nullopt);
+  cache.Insert("hello", "world");
+
+  EXPECT_THAT(cache.Lookup("hello"), Optional(std::string("world")));
+  EXPECT_EQ(cache.Lookup("hello "), std::nullopt);
+  TextResultCacheStats stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_THAT(stats.hit_ratio(), DoubleEq(1.0 / 3));
+}
+
+TEST(TextResultCacheTest, EvictsLeastRecentlyUsedResults) {
+  TextResultCache<int> cache({.max_entries = 2});
+  cache.Insert("a", 1);
+  cache.Insert("b", 2);
+  // Makes "b" the least recently used result.
+  EXPECT_THAT(cache.Lookup("a"), Optional(1));
+
+  cache.Insert("c", 3);
+
+  EXPECT_EQ(cache.Lookup("b"), std::nullopt);
+  EXPECT_THAT(cache.Lookup("a"), Optional(1));
+  EXPECT_THAT(cache.Lookup("c"), Optional(3));
+}
+
+TEST(TextResultCacheTest, ReplacesResultsOfTheSameText) {
+  TextResultCache<int> cache({.max_entries = 2});
+  cache.Insert("a", 1);
+  cache.Insert("a", 2);
+  cache.Insert("b", 3);
+
+  EXPECT_THAT(cache.Lookup("a"), Optional(2));
+  EXPECT_THAT(cache.Lookup("b"), Optional(3));
+}
+
+TEST(TextResultCacheTest, CollapsesWhitespace) {
+  TextResultCache<int> cache({.max_entries = 2, .collapse_whitespace = true});
+  cache.Insert("  good \t morning\n", 1);
+
+  EXPECT_THAT(cache.Lookup("good morning"), Optional(1));
+  EXPECT_THAT(cache.Lookup("good\n\nmorning  "), Optional(1));
+  EXPECT_EQ(cache.Lookup("goodmorning"), std::nullopt);
+}
+
+}  // namespace
+}  // namespace mediapipe::tasks::text::utils
@@ -22,6 +22,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -33,6 +34,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/core/base_task_api.h"
 #include "mediapipe/tasks/cc/core/task_runner.h"
 #include "mediapipe/tasks/cc/vision/core/image_processing_options.h"
+#include "mediapipe/tasks/cc/vision/core/image_result_cache.h"
 #include "mediapipe/tasks/cc/vision/core/running_mode.h"
 #include "mediapipe/tasks/cc/vision/utils/image_tensor_specs.h"
 
@@ -85,6 +87,18 @@ class BaseVisionTaskApi : public tasks::core::BaseTaskApi {
     return image_tensor_specs;
   }
 
+  // Caches the results of up to `max_entries` requests in the image mode, so
+  // that repeating a request with the same image and image processing options
+  // returns the previous result without running the graph, e.g. when an app
+  // re-renders its UI. Only for tasks whose results depend on nothing but
+  // their inputs. Requests with GPU images are not cached. A `max_entries` of
+  // 0 disables the cache.
+  void EnableResultCache(int max_entries) {
+    result_cache_ = max_entries > 0
+                        ? std::make_unique<ImageResultCache>(max_entries)
+                        : nullptr;
+  }
+
  protected:
   // A synchronous method to process single image inputs.
   // The call blocks the current thread until a failure status or a successful
@@ -99,7 +113,37 @@ class BaseVisionTaskApi : public tasks::core::BaseTaskApi {
                        GetRunningModeName(running_mode_)),
           MediaPipeTasksStatus::kRunnerApiCalledInWrongModeError);
     }
-    return runner_->Process(std::move(inputs));
+    std::optional<std::string> cache_key;
+    if (result_cache_ != nullptr) {
+      cache_key = ImageResultCache::MakeKey(inputs);
+    }
+    if (cache_key.has_value()) {
+      std::optional<tasks::core::PacketMap> outputs =
+          result_cache_->Lookup(*cache_key);
+      if (outputs.has_value()) return *std::move(outputs);
+    }
+    absl::StatusOr<tasks::core::PacketMap> outputs =
+        runner_->Process(std::move(inputs));
+    if (cache_key.has_value() && outputs.ok()) {
+      result_cache_->Insert(*cache_key, *outputs);
+    }
+    return outputs;
+  }
+
+  // A synchronous method to process a batch of independent image data. The
+  // images are pipelined through the graph, and the call blocks the current
+  // thread until a failure status or the results of all images are returned.
+  absl::StatusOr<std::vector<tasks::core::PacketMap>> ProcessImageDataBatch(
+      std::vector<tasks::core::PacketMap> batch_inputs) {
+    if (running_mode_ != RunningMode::IMAGE) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrCat("Task is not initialized with the image mode. Current "
+                       "running mode:",
+                       GetRunningModeName(running_mode_)),
+          MediaPipeTasksStatus::kRunnerApiCalledInWrongModeError);
+    }
+    return runner_->ProcessBatch(std::move(batch_inputs));
   }
 
   // A synchronous method to process continuous video frames.
@@ -204,6 +248,7 @@ class BaseVisionTaskApi : public tasks::core::BaseTaskApi {
 
  private:
   RunningMode running_mode_;
+  std::unique_ptr<ImageResultCache> result_cache_;
 };
 
 }  // namespace core
@@ -0,0 +1,102 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/vision/core/image_result_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_frame.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace vision {
+namespace core {
+
+namespace {
+
+// Hashes the pixels of an image frame, without the row padding.
+size_t HashPixels(const ImageFrame& frame) {
+  const size_t row_size =
+      frame.Width() * frame.NumberOfChannels() * frame.ByteDepth();
+  size_t hash = absl::HashOf(frame.Width(), frame.Height());
+  for (int row = 0; row < frame.Height(); ++row) {
+    const char* pixels = reinterpret_cast<const char*>(frame.PixelData()) +
+                         row * frame.WidthStep();
+    hash = absl::HashOf(hash, absl::string_view(pixels, row_size));
+  }
+  return hash;
+}
+
+}  // namespace
+
+std::optional<std::string> ImageResultCache::MakeKey(
+    const tasks::core::PacketMap& inputs) {
+  std::string key;
+  for (const auto& [stream, packet] : inputs) {
+    absl::StrAppend(&key, stream.size(), ":", stream, "=");
+    if (packet.ValidateAsType<Image>().ok()) {
+      const Image& image = packet.Get<Image>();
+      // Hashing a GPU image would read it back to the CPU.
+      if (image.UsesGpu()) return std::nullopt;
+      const ImageFrameSharedPtr frame = image.GetImageFrameSharedPtr();
+      absl::StrAppend(&key, "image:", frame->Format(), ":",
+                      HashPixels(*frame), ";");
+    } else if (packet.ValidateAsProtoMessageLite().ok()) {
+      const auto& message = packet.GetProtoMessageLite();
+      const std::string serialized = message.SerializePartialAsString();
+      absl::StrAppend(&key, "proto:", message.GetTypeName(), ":",
+                      serialized.size(), ":", serialized, ";");
+    } else {
+      return std::nullopt;
+    }
+  }
+  return key;
+}
+
+std::optional<tasks::core::PacketMap> ImageResultCache::Lookup(
+    const std::string& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) return std::nullopt;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->second;
+}
+
+void ImageResultCache::Insert(const std::string& key,
+                              tasks::core::PacketMap outputs) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->second = std::move(outputs);
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  entries_.emplace_front(key, std::move(outputs));
+  index_[key] = entries_.begin();
+  while (static_cast<int>(entries_.size()) > max_entries_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+}
+
+}  // namespace core
+}  // namespace vision
+}  // namespace tasks
+}  // namespace mediapipe
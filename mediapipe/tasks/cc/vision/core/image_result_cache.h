@@ -0,0 +1,74 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_VISION_CORE_IMAGE_RESULT_CACHE_H_
+#define MEDIAPIPE_TASKS_CC_VISION_CORE_IMAGE_RESULT_CACHE_H_
+
+#include <list>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace vision {
+namespace core {
+
+// Caches the outputs of image mode requests, so that a request with the same
+// inputs as a recent one returns its outputs without running the graph.
+//
+// The key of a request is built from the contents of its input packets: the
+// pixels of CPU images, and the serialized protobuf messages, such as the
+// NormalizedRect built from the ImageProcessingOptions. Requests with other
+// inputs, such as GPU images, are not cached. Pixels are compared by a 64-bit
+// hash, so different images collide with a negligible but nonzero probability.
+class ImageResultCache {
+ public:
+  // Keeps the outputs of up to `max_entries` requests, and evicts the least
+  // recently used ones.
+  explicit ImageResultCache(int max_entries) : max_entries_(max_entries) {}
+
+  // Returns the key of a request, or std::nullopt if it can't be cached.
+  static std::optional<std::string> MakeKey(
+      const tasks::core::PacketMap& inputs);
+
+  // Returns the outputs of the request with the given key, if cached.
+  std::optional<tasks::core::PacketMap> Lookup(const std::string& key);
+
+  // Caches the outputs of the request with the given key.
+  void Insert(const std::string& key, tasks::core::PacketMap outputs);
+
+ private:
+  using Entry = std::pair<std::string, tasks::core::PacketMap>;
+
+  const int max_entries_;
+  absl::Mutex mutex_;
+  // The most recently used entry first.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace core
+}  // namespace vision
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_VISION_CORE_IMAGE_RESULT_CACHE_H_
@@ -0,0 +1,89 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/vision/core/image_result_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace vision {
+namespace core {
+namespace {
+
+using ::mediapipe::tasks::core::PacketMap;
+
+Packet MakeImagePacket(int first_pixel) {
+  auto frame = std::make_shared<ImageFrame>(ImageFormat::FORMAT_SRGB, 4, 3);
+  frame->SetToZero();
+  frame->MutablePixelData()[0] = first_pixel;
+  return MakePacket<Image>(std::move(frame));
+}
+
+Packet MakeRectPacket(float rotation) {
+  NormalizedRect rect;
+  rect.set_rotation(rotation);
+  return MakePacket<NormalizedRect>(std::move(rect));
+}
+
+std::optional<std::string> MakeKey(int first_pixel, float rotation) {
+  return ImageResultCache::MakeKey({{"image", MakeImagePacket(first_pixel)},
+                                    {"norm_rect", MakeRectPacket(rotation)}});
+}
+
+TEST(ImageResultCacheTest, KeysDependOnContents) {
+  std::optional<std::string> key = MakeKey(1, 0);
+  ASSERT_TRUE(key.has_value());
+  EXPECT_EQ(MakeKey(1, 0), key);
+  EXPECT_NE(MakeKey(2, 0), key);
+  EXPECT_NE(MakeKey(1, 1), key);
+}
+
+TEST(ImageResultCacheTest, DoesNotCacheOtherInputs) {
+  EXPECT_FALSE(ImageResultCache::MakeKey({{"image", MakeImagePacket(1)},
+                                          {"count", MakePacket<int>(1)}})
+                   .has_value());
+}
+
+TEST(ImageResultCacheTest, EvictsLeastRecentlyUsed) {
+  ImageResultCache cache(/*max_entries=*/2);
+  cache.Insert("a", {{"result", MakePacket<int>(1)}});
+  cache.Insert("b", {{"result", MakePacket<int>(2)}});
+  ASSERT_TRUE(cache.Lookup("a").has_value());
+  cache.Insert("c", {{"result", MakePacket<int>(3)}});
+
+  EXPECT_FALSE(cache.Lookup("b").has_value());
+  std::optional<PacketMap> a = cache.Lookup("a");
+  ASSERT_TRUE(a.has_value());
+  EXPECT_EQ(a->at("result").Get<int>(), 1);
+  std::optional<PacketMap> c = cache.Lookup("c");
+  ASSERT_TRUE(c.has_value());
+  EXPECT_EQ(c->at("result").Get<int>(), 3);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace vision
+}  // namespace tasks
+}  // namespace mediapipe
@@ -71,20 +71,29 @@ struct PerspectiveCameraFrustum {
 
 class ScreenToMetricSpaceConverter {
  public:
+  // Buffers for the intermediate landmarks of a conversion. They are reused
+  // across the faces of a frame, so that converting a face doesn't allocate.
+  struct Workspace {
+    Eigen::Matrix3Xf screen_landmarks;
+    Eigen::Matrix3Xf intermediate_landmarks;
+  };
+
   ScreenToMetricSpaceConverter(
       proto::OriginPointLocation origin_point_location,  //
       proto::InputSource input_source,                   //
       Eigen::Matrix3Xf&& canonical_metric_landmarks,     //
-      Eigen::VectorXf&& landmark_weights,                //
-      std::unique_ptr<ProcrustesSolver> procrustes_solver)
+      std::unique_ptr<FixedSourceProcrustesSolver> procrustes_solver)
       : origin_point_location_(origin_point_location),
         input_source_(input_source),
         canonical_metric_landmarks_(std::move(canonical_metric_landmarks)),
-        landmark_weights_(std::move(landmark_weights)),
         procrustes_solver_(std::move(procrustes_solver)) {}
 
-  // Converts `screen_landmark_list` into `metric_landmark_list` and estimates
-  // the `pose_transform_mat`.
+  // Converts `screen_landmark_list` into `metric_landmarks` and estimates the
+  // `pose_transform_mat`. `metric_landmarks` must have a column per landmark.
+  //
+  // The Procrustes solver is set up once for the canonical metric landmarks
+  // and the landmark weights, so that every solve below only takes a pass
+  // over the runtime landmarks.
   //
   // Here's the algorithm summary:
   //
@@ -123,14 +132,15 @@ class ScreenToMetricSpaceConverter {
   absl::Status Convert(
       const mediapipe::NormalizedLandmarkList& screen_landmark_list,  //
       const PerspectiveCameraFrustum& pcf,                            //
-      mediapipe::LandmarkList& metric_landmark_list,                  //
+      Workspace& workspace,                                           //
+      Eigen::Matrix3Xf& metric_landmarks,                             //
       Eigen::Matrix4f& pose_transform_mat) const {
     RET_CHECK_EQ(screen_landmark_list.landmark_size(),
                  canonical_metric_landmarks_.cols())
         << "The number of landmarks doesn't match the number passed upon "
            "initialization!";
 
-    Eigen::Matrix3Xf screen_landmarks;
+    Eigen::Matrix3Xf& screen_landmarks = workspace.screen_landmarks;
     ConvertLandmarkListToEigenMatrix(screen_landmark_list, screen_landmarks);
 
     ProjectXY(pcf, screen_landmarks);
@@ -140,7 +150,8 @@ class ScreenToMetricSpaceConverter {
     //                the relative nature of the Z coordinate. Instead, run the
     //                first estimation on the projected XY and use that scale to
     //                unproject for the 2nd iteration.
-    Eigen::Matrix3Xf intermediate_landmarks(screen_landmarks);
+    Eigen::Matrix3Xf& intermediate_landmarks = workspace.intermediate_landmarks;
+    intermediate_landmarks = screen_landmarks;
     ChangeHandedness(intermediate_landmarks);
 
     ASSIGN_OR_RETURN(const float first_iteration_scale,
@@ -158,15 +169,12 @@ class ScreenToMetricSpaceConverter {
     // landmarks.
     if (input_source_ == proto::InputSource::FACE_DETECTION_PIPELINE) {
       Eigen::Matrix4f intermediate_pose_transform_mat;
-      MP_RETURN_IF_ERROR(procrustes_solver_->SolveWeightedOrthogonalProblem(
-          canonical_metric_landmarks_, intermediate_landmarks,
-          landmark_weights_, intermediate_pose_transform_mat))
+      MP_RETURN_IF_ERROR(procrustes_solver_->Solve(
+          intermediate_landmarks, intermediate_pose_transform_mat))
           << "Failed to estimate pose transform matrix!";
 
-      intermediate_landmarks.row(2) =
-          (intermediate_pose_transform_mat *
-           canonical_metric_landmarks_.colwise().homogeneous())
-              .row(2);
+      RewriteZFromCanonical(intermediate_pose_transform_mat,
+                            intermediate_landmarks);
     }
     ASSIGN_OR_RETURN(const float second_iteration_scale,
                      EstimateScale(intermediate_landmarks),
@@ -179,35 +187,32 @@ class ScreenToMetricSpaceConverter {
     ChangeHandedness(screen_landmarks);
 
     // At this point, screen landmarks are converted into metric landmarks.
-    Eigen::Matrix3Xf& metric_landmarks = screen_landmarks;
+    const Eigen::Matrix3Xf& runtime_metric_landmarks = screen_landmarks;
 
-    MP_RETURN_IF_ERROR(procrustes_solver_->SolveWeightedOrthogonalProblem(
-        canonical_metric_landmarks_, metric_landmarks, landmark_weights_,
-        pose_transform_mat))
+    MP_RETURN_IF_ERROR(
+        procrustes_solver_->Solve(runtime_metric_landmarks, pose_transform_mat))
         << "Failed to estimate pose transform matrix!";
 
     // For face detection input landmarks, re-write Z-coord from the canonical
     // landmarks and run the pose transform estimation again.
     if (input_source_ == proto::InputSource::FACE_DETECTION_PIPELINE) {
-      metric_landmarks.row(2) =
-          (pose_transform_mat *
-           canonical_metric_landmarks_.colwise().homogeneous())
-              .row(2);
-
-      MP_RETURN_IF_ERROR(procrustes_solver_->SolveWeightedOrthogonalProblem(
-          canonical_metric_landmarks_, metric_landmarks, landmark_weights_,
-          pose_transform_mat))
+      RewriteZFromCanonical(pose_transform_mat, screen_landmarks);
+
+      MP_RETURN_IF_ERROR(procrustes_solver_->Solve(runtime_metric_landmarks,
+                                                   pose_transform_mat))
           << "Failed to estimate pose transform matrix!";
     }
 
     // Multiply each of the metric landmarks by the inverse pose
     // transformation matrix to align the runtime metric face landmarks with
     // the canonical metric face landmarks.
-    metric_landmarks = (pose_transform_mat.inverse() *
-                        metric_landmarks.colwise().homogeneous())
-                           .topRows(3);
-
-    ConvertEigenMatrixToLandmarkList(metric_landmarks, metric_landmark_list);
+    const Eigen::Matrix4f inverse_pose_transform_mat =
+        pose_transform_mat.inverse();
+    metric_landmarks.noalias() =
+        inverse_pose_transform_mat.topLeftCorner<3, 3>() *
+        runtime_metric_landmarks;
+    metric_landmarks.colwise() +=
+        inverse_pose_transform_mat.topRightCorner<3, 1>();
 
     return absl::OkStatus();
   }
@@ -229,16 +234,24 @@ class ScreenToMetricSpaceConverter {
     landmarks.colwise() += Eigen::Vector3f(x_translation, y_translation, 0.f);
   }
 
-  absl::StatusOr<float> EstimateScale(Eigen::Matrix3Xf& landmarks) const {
+  absl::StatusOr<float> EstimateScale(
+      const Eigen::Matrix3Xf& landmarks) const {
     Eigen::Matrix4f transform_mat;
-    MP_RETURN_IF_ERROR(procrustes_solver_->SolveWeightedOrthogonalProblem(
-        canonical_metric_landmarks_, landmarks, landmark_weights_,
-        transform_mat))
+    MP_RETURN_IF_ERROR(procrustes_solver_->Solve(landmarks, transform_mat))
         << "Failed to estimate canonical-to-runtime landmark set transform!";
 
     return transform_mat.col(0).norm();
   }
 
+  // Replaces the Z-coord of `landmarks` with the one of the canonical
+  // landmarks transformed by `transform_mat`.
+  void RewriteZFromCanonical(const Eigen::Matrix4f& transform_mat,
+                             Eigen::Matrix3Xf& landmarks) const {
+    landmarks.row(2).noalias() =
+        transform_mat.block<1, 3>(2, 0) * canonical_metric_landmarks_;
+    landmarks.row(2).array() += transform_mat(2, 3);
+  }
+
   static void MoveAndRescaleZ(const PerspectiveCameraFrustum& pcf,
                               float depth_offset, float scale,
                               Eigen::Matrix3Xf& landmarks) {
@@ -261,7 +274,7 @@ class ScreenToMetricSpaceConverter {
   static void ConvertLandmarkListToEigenMatrix(
       const mediapipe::NormalizedLandmarkList& landmark_list,
       Eigen::Matrix3Xf& eigen_matrix) {
-    eigen_matrix = Eigen::Matrix3Xf(3, landmark_list.landmark_size());
+    eigen_matrix.resize(3, landmark_list.landmark_size());
     for (int i = 0; i < landmark_list.landmark_size(); ++i) {
       const auto& landmark = landmark_list.landmark(i);
       eigen_matrix(0, i) = landmark.x();
@@ -270,25 +283,11 @@ class ScreenToMetricSpaceConverter {
     }
   }
 
-  static void ConvertEigenMatrixToLandmarkList(
-      const Eigen::Matrix3Xf& eigen_matrix,
-      mediapipe::LandmarkList& landmark_list) {
-    landmark_list.Clear();
-
-    for (int i = 0; i < eigen_matrix.cols(); ++i) {
-      auto& landmark = *landmark_list.add_landmark();
-      landmark.set_x(eigen_matrix(0, i));
-      landmark.set_y(eigen_matrix(1, i));
-      landmark.set_z(eigen_matrix(2, i));
-    }
-  }
-
   const proto::OriginPointLocation origin_point_location_;
   const proto::InputSource input_source_;
   Eigen::Matrix3Xf canonical_metric_landmarks_;
-  Eigen::VectorXf landmark_weights_;
 
-  std::unique_ptr<ProcrustesSolver> procrustes_solver_;
+  std::unique_ptr<FixedSourceProcrustesSolver> procrustes_solver_;
 };
 
 class GeometryPipelineImpl : public GeometryPipeline {
@@ -321,6 +320,11 @@ class GeometryPipelineImpl : public GeometryPipeline {
                                  frame_height);
 
     std::vector<proto::FaceGeometry> multi_face_geometry;
+    multi_face_geometry.reserve(multi_face_landmarks.size());
+
+    // The landmark buffers are shared by all the faces of the frame.
+    ScreenToMetricSpaceConverter::Workspace workspace;
+    Eigen::Matrix3Xf metric_face_landmarks(3, canonical_mesh_num_vertices_);
 
     // From this point, the meaning of "face landmarks" is clarified further as
     // "screen face landmarks". This is done do distinguish from "metric face
@@ -335,35 +339,31 @@ class GeometryPipelineImpl : public GeometryPipeline {
 
       // Convert the screen landmarks into the metric landmarks and get the pose
       // transformation matrix.
-      mediapipe::LandmarkList metric_face_landmarks;
       Eigen::Matrix4f pose_transform_mat;
       MP_RETURN_IF_ERROR(space_converter_->Convert(screen_face_landmarks, pcf,
+                                                   workspace,
                                                    metric_face_landmarks,
                                                    pose_transform_mat))
           << "Failed to convert landmarks from the screen to the metric space!";
 
       // Pack geometry data for this face.
-      proto::FaceGeometry face_geometry;
+      proto::FaceGeometry& face_geometry = multi_face_geometry.emplace_back();
       proto::Mesh3d* mutable_mesh = face_geometry.mutable_mesh();
       // Copy the canonical face mesh as the face geometry mesh.
       mutable_mesh->CopyFrom(canonical_mesh_);
-      // Replace XYZ vertex mesh coordinates with the metric landmark positions.
-      for (int i = 0; i < canonical_mesh_num_vertices_; ++i) {
-        uint32_t vertex_buffer_offset = canonical_mesh_vertex_size_ * i +
-                                        canonical_mesh_vertex_position_offset_;
-
-        mutable_mesh->set_vertex_buffer(vertex_buffer_offset,
-                                        metric_face_landmarks.landmark(i).x());
-        mutable_mesh->set_vertex_buffer(vertex_buffer_offset + 1,
-                                        metric_face_landmarks.landmark(i).y());
-        mutable_mesh->set_vertex_buffer(vertex_buffer_offset + 2,
-                                        metric_face_landmarks.landmark(i).z());
-      }
+      // Replace XYZ vertex mesh coordinates with the metric landmark positions,
+      // viewing the interleaved vertex buffer as a strided 3xN matrix.
+      float* vertex_positions_data =
+          mutable_mesh->mutable_vertex_buffer()->mutable_data() +
+          canonical_mesh_vertex_position_offset_;
+      Eigen::Map<Eigen::Matrix3Xf, Eigen::Unaligned, Eigen::OuterStride<>>
+          vertex_positions(vertex_positions_data, 3,
+                           canonical_mesh_num_vertices_,
+                           Eigen::OuterStride<>(canonical_mesh_vertex_size_));
+      vertex_positions = metric_face_landmarks;
       // Populate the face pose transformation matrix.
       mediapipe::MatrixDataProtoFromMatrix(
           pose_transform_mat, face_geometry.mutable_pose_transform_matrix());
-
-      multi_face_geometry.push_back(face_geometry);
     }
 
     return multi_face_geometry;
@@ -451,6 +451,11 @@ absl::StatusOr<std::unique_ptr<GeometryPipeline>> CreateGeometryPipeline(
     landmark_weights(landmark_id) = wlr.weight();
   }
 
+  ASSIGN_OR_RETURN(std::unique_ptr<FixedSourceProcrustesSolver> solver,
+                   CreateFloatPrecisionFixedSourceProcrustesSolver(
+                       canonical_metric_landmarks, landmark_weights),
+                   _ << "Failed to set up the Procrustes solver!");
+
   std::unique_ptr<GeometryPipeline> result =
       absl::make_unique<GeometryPipelineImpl>(
           environment.perspective_camera(), canonical_mesh,
@@ -461,9 +466,7 @@ absl::StatusOr<std::unique_ptr<GeometryPipeline>> CreateGeometryPipeline(
               metadata.input_source() == proto::InputSource::DEFAULT
                   ? proto::InputSource::FACE_LANDMARK_PIPELINE
                   : metadata.input_source(),
-              std::move(canonical_metric_landmarks),
-              std::move(landmark_weights),
-              CreateFloatPrecisionProcrustesSolver()));
+              std::move(canonical_metric_landmarks), std::move(solver)));
 
   return result;
 }
@@ -19,6 +19,7 @@
 
 #include "Eigen/Dense"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/framework/port/statusor.h"
 
 namespace mediapipe::tasks::vision::face_geometry {
 
@@ -65,6 +66,34 @@ class ProcrustesSolver {
 
 std::unique_ptr<ProcrustesSolver> CreateFloatPrecisionProcrustesSolver();
 
+// Solves the WEOP Problem of `ProcrustesSolver` for fixed source points and
+// point weights against any number of target point clouds, e.g. the landmarks
+// of every face in a frame against the canonical face landmarks.
+//
+// The terms that only depend on the source points and the point weights are
+// computed once upon creation, so that a solve only takes a pass over the
+// target points and doesn't allocate memory.
+class FixedSourceProcrustesSolver {
+ public:
+  virtual ~FixedSourceProcrustesSolver() = default;
+
+  // Estimates the transformation from the source points into `target_points`,
+  // which must define as many points as the source points.
+  //
+  // Note: the output `transform_mat` argument is used instead of `StatusOr<>`
+  // return type in order to avoid Eigen memory alignment issues. Details:
+  // https://eigen.tuxfamily.org/dox/group__TopicStructHavingEigenMembers.html
+  virtual absl::Status Solve(const Eigen::Matrix3Xf& target_points,
+                             Eigen::Matrix4f& transform_mat) const = 0;
+};
+
+// Both `source_points` and `point_weights` must satisfy the requirements of
+// `ProcrustesSolver::SolveWeightedOrthogonalProblem`.
+absl::StatusOr<std::unique_ptr<FixedSourceProcrustesSolver>>
+CreateFloatPrecisionFixedSourceProcrustesSolver(
+    const Eigen::Matrix3Xf& source_points,
+    const Eigen::VectorXf& point_weights);
+
 }  // namespace mediapipe::tasks::vision::face_geometry
 
 #endif  // MEDIAPIPE_TASKS_CC_VISION_FACE_GEOMETRY_LIBS_PROCRUSTES_SOLVER_H_
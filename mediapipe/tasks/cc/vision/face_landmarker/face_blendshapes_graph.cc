@@ -27,6 +27,7 @@ limitations under the License.
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
+#include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
 #include "mediapipe/tasks/cc/vision/face_landmarker/proto/face_blendshapes_graph_options.pb.h"
 
 namespace mediapipe {
@@ -303,6 +304,9 @@ class FaceBlendshapesGraph : public core::ModelTaskGraph {
     // Run Blendshapes model.
     auto& inference = AddInference(
         model_resources, subgraph_options.base_options().acceleration(), graph);
+    inference.GetOptions<core::proto::InferenceSubgraphOptions>()
+        .mutable_batching()
+        ->set_max_batch_size(subgraph_options.max_batch_size());
     tensor_in >> inference.In("TENSORS");
     auto tensors_out = inference.Out("TENSORS").Cast<std::vector<Tensor>>();
 
@@ -117,6 +117,10 @@ ConvertFaceLandmarkerGraphOptionsProto(FaceLandmarkerOptions* options) {
       options_proto->mutable_face_landmarks_detector_graph_options();
   face_landmarks_detector_graph_options->set_min_detection_confidence(
       options->min_face_presence_confidence);
+  if (options->batch_faces) {
+    face_landmarks_detector_graph_options->set_max_batch_size(
+        options->num_faces);
+  }
 
   return options_proto;
 }
@@ -74,6 +74,12 @@ struct FaceLandmarkerOptions {
   // detected landmarks.
   bool output_facial_transformation_matrixes = false;
 
+  // Whether to run the face landmarks and face blendshapes inference of all
+  // the faces of a frame, up to num_faces, as one batched inference instead of
+  // one inference per face. Requires a model asset bundle whose models have a
+  // dynamic batch dimension, and CPU inference.
+  bool batch_faces = false;
+
   // The user-defined result callback for processing live stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::LIVE_STREAM.
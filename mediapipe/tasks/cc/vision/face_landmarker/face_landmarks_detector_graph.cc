@@ -42,6 +42,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/utils/gate.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
+#include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
 #include "mediapipe/tasks/cc/core/utils.h"
 #include "mediapipe/tasks/cc/vision/face_landmarker/proto/face_blendshapes_graph_options.pb.h"
 #include "mediapipe/tasks/cc/vision/face_landmarker/proto/face_landmarks_detector_graph_options.pb.h"
@@ -277,6 +278,9 @@ class SingleFaceLandmarksDetectorGraph : public core::ModelTaskGraph {
 
     auto& inference = AddInference(
         model_resources, subgraph_options.base_options().acceleration(), graph);
+    inference.GetOptions<core::proto::InferenceSubgraphOptions>()
+        .mutable_batching()
+        ->set_max_batch_size(subgraph_options.max_batch_size());
     input_tensors >> inference.In(kTensorsTag);
     auto output_tensors = inference.Out(kTensorsTag);
 
@@ -632,10 +636,19 @@ class MultiFaceLandmarksDetectorGraph : public core::ModelTaskGraph {
 
       auto& face_blendshapes_graph = graph.AddNode(
           "mediapipe.tasks.vision.face_landmarker.FaceBlendshapesGraph");
-      face_blendshapes_graph.GetOptions<proto::FaceBlendshapesGraphOptions>()
-          .Swap(face_landmark_subgraph
-                    .GetOptions<proto::FaceLandmarksDetectorGraphOptions>()
-                    .mutable_face_blendshapes_graph_options());
+      auto& face_blendshapes_options =
+          face_blendshapes_graph
+              .GetOptions<proto::FaceBlendshapesGraphOptions>();
+      face_blendshapes_options.Swap(
+          face_landmark_subgraph
+              .GetOptions<proto::FaceLandmarksDetectorGraphOptions>()
+              .mutable_face_blendshapes_graph_options());
+      if (!face_blendshapes_options.has_max_batch_size()) {
+        face_blendshapes_options.set_max_batch_size(
+            face_landmark_subgraph
+                .GetOptions<proto::FaceLandmarksDetectorGraphOptions>()
+                .max_batch_size());
+      }
       landmarks >> face_blendshapes_graph.In(kLandmarksTag);
       image_size >> face_blendshapes_graph.In(kImageSizeTag);
       auto face_blendshapes = face_blendshapes_graph.Out(kBlendshapesTag)
@@ -92,6 +92,12 @@ bool CanUseGpu() {
 
 // Converts a MediaPipe tensor to a MediaPipe Image.
 //
+// With GPU support, a float tensor is converted by a shader that reads the
+// tensor's GPU buffer and writes a GpuBuffer-backed Image, mapping the input
+// tensor range to the output color range on the way. The output of a GPU
+// delegate is thus never read back to the CPU. Without a range in the options,
+// the GPU paths expect tensor values in [0, 1].
+//
 // Input streams:
 //   TENSORS - std::vector<mediapipe::Tensor> that only contains one element.
 //
@@ -115,6 +121,10 @@ class TensorsToImageCalculator : public Node {
   int tensor_position_;
 
 #if !MEDIAPIPE_DISABLE_GPU
+  // Maps the input tensor range to the normalized [0, 1] GPU color range.
+  ValueTransformation gpu_value_transform_ = {/*scale=*/1.0f,
+                                              /*offset=*/0.0f};
+
 #if MEDIAPIPE_METAL_ENABLED
   bool metal_initialized_ = false;
   MPPMetalHelper* gpu_helper_ = nullptr;
@@ -161,6 +171,19 @@ absl::Status TensorsToImageCalculator::Open(CalculatorContext* cc) {
 #else
     MP_RETURN_IF_ERROR(gl_helper_.Open(cc));
 #endif  // MEDIAPIPE_METAL_ENABLED
+    if (options_.has_input_tensor_float_range()) {
+      const auto& input_range = options_.input_tensor_float_range();
+      ASSIGN_OR_RETURN(gpu_value_transform_,
+                       GetValueRangeTransformation(input_range.min(),
+                                                   input_range.max(), 0.0f,
+                                                   1.0f));
+    } else if (options_.has_input_tensor_uint_range()) {
+      const auto& input_range = options_.input_tensor_uint_range();
+      ASSIGN_OR_RETURN(gpu_value_transform_,
+                       GetValueRangeTransformation(input_range.min(),
+                                                   input_range.max(), 0.0f,
+                                                   1.0f));
+    }
 #endif  // !MEDIAPIPE_DISABLE_GPU
   } else {
     ABSL_CHECK(options_.has_input_tensor_float_range() ^
@@ -283,6 +306,9 @@ absl::Status TensorsToImageCalculator::MetalProcess(CalculatorContext* cc) {
   const int tensor_channels = input_tensors[tensor_position_].shape().dims[3];
   // TODO: Add 1 channel support.
   RET_CHECK(tensor_channels == 3);
+  RET_CHECK(input_tensors[tensor_position_].element_type() ==
+            Tensor::ElementType::kFloat32)
+      << "Only float tensors are supported on GPU";
 
   // TODO: Fix unused variable
   [[maybe_unused]] id<MTLDevice> device = gpu_helper_.mtlDevice;
@@ -295,6 +321,9 @@ absl::Status TensorsToImageCalculator::MetalProcess(CalculatorContext* cc) {
   auto input_view = mediapipe::MtlBufferView::GetReadView(
       input_tensors[tensor_position_], command_buffer);
   [compute_encoder setBuffer:input_view.buffer() offset:0 atIndex:0];
+  [compute_encoder setBytes:&gpu_value_transform_
+                     length:sizeof(gpu_value_transform_)
+                    atIndex:2];
 
   mediapipe::GpuBuffer output =
       [gpu_helper_ mediapipeGpuBufferWithWidth:tensor_width
@@ -322,14 +351,21 @@ absl::Status TensorsToImageCalculator::MetalSetup(CalculatorContext* cc) {
 
   using namespace metal;
 
+  struct ValueTransformation {
+    float scale;
+    float offset;
+  };
+
   kernel void convertKernel(
-      device float*                         in_buf   [[ buffer(0) ]],
-      texture2d<float, access::read_write>  out_tex  [[ texture(1) ]],
-      uint2                                 gid      [[ thread_position_in_grid ]]) {
+      device float*                         in_buf    [[ buffer(0) ]],
+      texture2d<float, access::read_write>  out_tex   [[ texture(1) ]],
+      constant ValueTransformation&         transform [[ buffer(2) ]],
+      uint2                                 gid       [[ thread_position_in_grid ]]) {
         if (gid.x >= out_tex.get_width() || gid.y >= out_tex.get_height()) return;
         uint linear_index = 3 * (gid.y * out_tex.get_width() + gid.x);
-        float4 out_value = float4(in_buf[linear_index], in_buf[linear_index + 1], in_buf[linear_index + 2], 1.0);
-        out_tex.write(out_value, gid);
+        float3 color = float3(in_buf[linear_index], in_buf[linear_index + 1], in_buf[linear_index + 2]);
+        color = clamp(color * transform.scale + transform.offset, 0.0, 1.0);
+        out_tex.write(float4(color, 1.0), gid);
       }
   )";
   NSString* library_source =
@@ -371,6 +407,7 @@ absl::Status TensorsToImageCalculator::GlSetup(CalculatorContext* cc) {
     precision highp float;
     layout(rgba8, binding = 0) writeonly uniform highp image2D output_texture;
     uniform ivec3 out_size;
+    uniform vec2 value_transform;  // (scale, offset)
   )");
 
   const std::string shader_body = R"(
@@ -393,15 +430,15 @@ absl::Status TensorsToImageCalculator::GlSetup(CalculatorContext* cc) {
       int y_coord = gid.y;
 #endif  // defined(FLIP_Y_COORD)
 
-      vec4 out_value;
+      vec3 color;
       ivec2 out_coordinate = ivec2(gid.x, y_coord);
       if (out_channels == 3) {
-        out_value = vec4(input_data.elements[linear_index], input_data.elements[linear_index + 1], input_data.elements[linear_index + 2], 1.0);
+        color = vec3(input_data.elements[linear_index], input_data.elements[linear_index + 1], input_data.elements[linear_index + 2]);
       } else {
-        float in_value = input_data.elements[linear_index];
-        out_value = vec4(in_value, in_value, in_value, 1.0);
+        color = vec3(input_data.elements[linear_index]);
       }
-      imageStore(output_texture, out_coordinate, out_value);
+      color = clamp(color * value_transform.x + value_transform.y, 0.0, 1.0);
+      imageStore(output_texture, out_coordinate, vec4(color, 1.0));
     })";
 
   const std::string shader_full =
@@ -434,13 +471,19 @@ absl::Status TensorsToImageCalculator::GlSetup(CalculatorContext* cc) {
       float y_coord = sample_coordinate.y;
 #endif  // defined(FLIP_Y_COORD)
       vec3 color = texture2D(tensor, vec2(sample_coordinate.x, y_coord)).rgb;
+      color = clamp(color * kValueScale + kValueOffset, 0.0, 1.0);
       fragColor = vec4(color, 1.0);
     }
   )";
 
-  const std::string src =
-      absl::StrCat(mediapipe::kMediaPipeFragmentShaderPreamble,
-                   kFragColorOutputDeclaration, maybe_flip_y_define, kBody);
+  // QuadRenderer only binds sampler uniforms, so the range transform is
+  // compiled into the shader.
+  const std::string value_transform_constants = absl::StrCat(
+      "const float kValueScale = float(", gpu_value_transform_.scale, ");\n",
+      "const float kValueOffset = float(", gpu_value_transform_.offset, ");\n");
+  const std::string src = absl::StrCat(
+      mediapipe::kMediaPipeFragmentShaderPreamble, kFragColorOutputDeclaration,
+      maybe_flip_y_define, value_transform_constants, kBody);
   gl_renderer_ = std::make_unique<mediapipe::QuadRenderer>();
   MP_RETURN_IF_ERROR(gl_renderer_->GlSetup(src.c_str(), {"tensor"}));
 
@@ -469,6 +512,8 @@ absl::Status TensorsToImageCalculator::GlProcess(CalculatorContext* cc) {
     const int tensor_height = input_tensor.shape().dims[1];
     const int tensor_in_channels = input_tensor.shape().dims[3];
     RET_CHECK(tensor_in_channels == 3 || tensor_in_channels == 1);
+    RET_CHECK(input_tensor.element_type() == Tensor::ElementType::kFloat32)
+        << "Only float tensors are supported on GPU";
 
 #if MEDIAPIPE_OPENGL_ES_VERSION >= MEDIAPIPE_OPENGL_ES_31
 
@@ -491,6 +536,9 @@ absl::Status TensorsToImageCalculator::GlProcess(CalculatorContext* cc) {
     glUseProgram(gl_compute_program_->id());
     glUniform3i(glGetUniformLocation(gl_compute_program_->id(), "out_size"),
                 tensor_width, tensor_height, tensor_in_channels);
+    glUniform2f(
+        glGetUniformLocation(gl_compute_program_->id(), "value_transform"),
+        gpu_value_transform_.scale, gpu_value_transform_.offset);
 
     MP_RETURN_IF_ERROR(gl_compute_program_->Dispatch(workgroups));
 
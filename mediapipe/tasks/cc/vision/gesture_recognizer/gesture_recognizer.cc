@@ -156,6 +156,10 @@ ConvertGestureRecognizerGraphOptionsProto(GestureRecognizerOptions* options) {
       ->mutable_custom_gesture_classifier_graph_options()
       ->mutable_classifier_options()
       ->Swap(custom_gestures_classifier_options_proto.get());
+  if (options->batch_hands) {
+    hand_gesture_recognizer_graph_options->set_max_batch_size(
+        options->num_hands);
+  }
   return options_proto;
 }
 
@@ -78,6 +78,12 @@ struct GestureRecognizerOptions {
   // threshold, allow list and deny list of gestures.
   components::processors::ClassifierOptions custom_gestures_classifier_options;
 
+  // Whether to run the gesture embedder and classifier inferences of all the
+  // hands of a frame, up to num_hands, as one batched inference per model
+  // instead of one inference per hand. Requires a model asset bundle whose
+  // gesture models have a dynamic batch dimension, and CPU inference.
+  bool batch_hands = false;
+
   // The user-defined result callback for processing live stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::LIVE_STREAM.
@@ -362,6 +362,10 @@ class SingleHandGestureRecognizerGraph : public core::ModelTaskGraph {
                          .base_options()
                          .acceleration(),
                      graph);
+    gesture_embedder_inference
+        .GetOptions<core::proto::InferenceSubgraphOptions>()
+        .mutable_batching()
+        ->set_max_batch_size(graph_options.max_batch_size());
     concatenated_tensors >> gesture_embedder_inference.In(kTensorsTag);
     auto embedding_tensors =
         gesture_embedder_inference.Out(kTensorsTag).Cast<Tensor>();
@@ -379,7 +383,7 @@ class SingleHandGestureRecognizerGraph : public core::ModelTaskGraph {
           GetGestureClassificationList(
               sub_task_model_resources.custom_gesture_classifier_model_resource,
               graph_options.custom_gesture_classifier_graph_options(),
-              embedding_tensors, graph));
+              graph_options.max_batch_size(), embedding_tensors, graph));
       gesture_classification_list >> combine_predictions.In(classifier_nums++);
     }
 
@@ -389,7 +393,7 @@ class SingleHandGestureRecognizerGraph : public core::ModelTaskGraph {
         GetGestureClassificationList(
             sub_task_model_resources.canned_gesture_classifier_model_resource,
             graph_options.canned_gesture_classifier_graph_options(),
-            embedding_tensors, graph));
+            graph_options.max_batch_size(), embedding_tensors, graph));
     gesture_classification_list >> combine_predictions.In(classifier_nums++);
 
     auto combined_classification_list =
@@ -400,10 +404,14 @@ class SingleHandGestureRecognizerGraph : public core::ModelTaskGraph {
 
   absl::StatusOr<Source<ClassificationList>> GetGestureClassificationList(
       const core::ModelResources* model_resources,
-      const proto::GestureClassifierGraphOptions& options,
+      const proto::GestureClassifierGraphOptions& options, int max_batch_size,
       Source<Tensor>& embedding_tensors, Graph& graph) {
     auto& gesture_classifier_inference = AddInference(
         *model_resources, options.base_options().acceleration(), graph);
+    gesture_classifier_inference
+        .GetOptions<core::proto::InferenceSubgraphOptions>()
+        .mutable_batching()
+        ->set_max_batch_size(max_batch_size);
     embedding_tensors >> gesture_classifier_inference.In(kTensorsTag);
     auto gesture_inference_out_tensors =
         gesture_classifier_inference.Out(kTensorsTag);
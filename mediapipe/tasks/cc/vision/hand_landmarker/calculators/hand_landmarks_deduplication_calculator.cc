@@ -23,6 +23,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/status/statusor.h"
@@ -55,19 +56,22 @@ float Distance(const NormalizedLandmark& lm_a, const NormalizedLandmark& lm_b,
                    std::pow((lm_a.y() - lm_b.y()) * height, 2));
 }
 
-absl::StatusOr<std::vector<float>> Distances(const NormalizedLandmarkList& a,
-                                             const NormalizedLandmarkList& b,
-                                             int width, int height) {
+// Returns the number of corresponding landmarks of `a` and `b` closer than
+// `distance_threshold`.
+absl::StatusOr<int> CountMatchedLandmarks(const NormalizedLandmarkList& a,
+                                          const NormalizedLandmarkList& b,
+                                          float distance_threshold, int width,
+                                          int height) {
   const int num = a.landmark_size();
   RET_CHECK_EQ(b.landmark_size(), num);
-  std::vector<float> distances;
-  distances.reserve(num);
+  int num_matched = 0;
   for (int i = 0; i < num; ++i) {
-    const NormalizedLandmark& lm_a = a.landmark(i);
-    const NormalizedLandmark& lm_b = b.landmark(i);
-    distances.push_back(Distance(lm_a, lm_b, width, height));
+    if (Distance(a.landmark(i), b.landmark(i), width, height) <
+        distance_threshold) {
+      ++num_matched;
+    }
   }
-  return distances;
+  return num_matched;
 }
 
 // Calculates a baseline distance of a hand that can be used as a relative
@@ -151,6 +155,76 @@ RectF CalculateBound(const NormalizedLandmarkList& list) {
                /*bottom=*/bounding_box_bottom};
 }
 
+// The retained hands, hashed by the cells of a uniform grid that their bounds
+// overlap. Hands with overlapping bounds share a cell.
+class RetainedHandsGrid {
+ public:
+  // The grid is disabled and all the hands are candidates if `cell_size` is
+  // not positive.
+  explicit RetainedHandsGrid(float cell_size) : cell_size_(cell_size) {}
+
+  void Insert(int index, const RectF& bound) {
+    indices_.push_back(index);
+    if (cell_size_ <= 0.0f) return;
+    ForEachCell(bound, [&](std::pair<int, int> cell) {
+      cells_[cell].push_back(index);
+    });
+  }
+
+  // Returns whether the cells of `bounds` can be indexed with `cell_size`.
+  static bool CanIndex(const std::vector<RectF>& bounds, float cell_size) {
+    // Also false for NaN values.
+    constexpr float kMaxCellIndex = 1e6f;
+    auto is_valid = [&](float value) {
+      return std::fabs(value / cell_size) < kMaxCellIndex;
+    };
+    return cell_size > 0.0f &&
+           absl::c_all_of(bounds, [&](const RectF& bound) {
+             return is_valid(bound.left) && is_valid(bound.top) &&
+                    is_valid(bound.right) && is_valid(bound.bottom);
+           });
+  }
+
+  // Sets `candidates` to the retained hands that may overlap `bound`.
+  void FindCandidates(const RectF& bound, std::vector<int>* candidates) const {
+    if (cell_size_ <= 0.0f) {
+      *candidates = indices_;
+      return;
+    }
+    candidates->clear();
+    ForEachCell(bound, [&](std::pair<int, int> cell) {
+      auto it = cells_.find(cell);
+      if (it != cells_.end()) {
+        candidates->insert(candidates->end(), it->second.begin(),
+                           it->second.end());
+      }
+    });
+    std::sort(candidates->begin(), candidates->end());
+    candidates->erase(std::unique(candidates->begin(), candidates->end()),
+                      candidates->end());
+  }
+
+ private:
+  // Calls `fn` with the cells overlapped by `bound`, which are at most 4 as
+  // the cells are as large as the largest bound.
+  template <typename Fn>
+  void ForEachCell(const RectF& bound, Fn fn) const {
+    const int left = static_cast<int>(std::floor(bound.left / cell_size_));
+    const int top = static_cast<int>(std::floor(bound.top / cell_size_));
+    const int right = static_cast<int>(std::floor(bound.right / cell_size_));
+    const int bottom = static_cast<int>(std::floor(bound.bottom / cell_size_));
+    for (int y = top; y <= bottom; ++y) {
+      for (int x = left; x <= right; ++x) {
+        fn(std::make_pair(x, y));
+      }
+    }
+  }
+
+  const float cell_size_;
+  std::vector<int> indices_;
+  absl::flat_hash_map<std::pair<int, int>, std::vector<int>> cells_;
+};
+
 // Uses IoU and distance of some corresponding hand landmarks to detect
 // duplicate / similar hands. IoU, distance thresholds, number of landmarks to
 // match are found experimentally. Evaluated:
@@ -167,7 +241,6 @@ class HandDuplicatesFinder : public DuplicatesFinder {
   absl::StatusOr<absl::flat_hash_set<int>> FindDuplicates(
       const std::vector<NormalizedLandmarkList>& multi_landmarks,
       int input_width, int input_height) override {
-    absl::flat_hash_set<int> retained_indices;
     absl::flat_hash_set<int> suppressed_indices;
 
     const int num = multi_landmarks.size();
@@ -182,11 +255,28 @@ class HandDuplicatesFinder : public DuplicatesFinder {
       bounds.push_back(CalculateBound(list));
     }
 
+    // Hands are only suppressed by retained hands whose bounds overlap theirs,
+    // which are found in a grid of cells as large as the largest hand.
+    float cell_size = 0.0f;
+    for (const RectF& bound : bounds) {
+      cell_size = std::max(
+          {cell_size, bound.right - bound.left, bound.bottom - bound.top});
+    }
+    RetainedHandsGrid retained_hands(
+        RetainedHandsGrid::CanIndex(bounds, cell_size) ? cell_size : 0.0f);
+    std::vector<int> candidates;
+
     for (int index = 0; index < num; ++index) {
       const int i = start_from_the_end_ ? num - index - 1 : index;
       const float stable_distance_i = baseline_distances[i];
       bool suppressed = false;
-      for (int j : retained_indices) {
+      retained_hands.FindCandidates(bounds[i], &candidates);
+      for (int j : candidates) {
+        // Checked first as it is cheaper than comparing the landmarks.
+        const float iou = CalculateIOU(bounds[i], bounds[j]);
+        constexpr float kMinIouThresholdToSuppressHand = 0.2f;
+        if (iou <= kMinIouThresholdToSuppressHand) continue;
+
         const float stable_distance_j = baseline_distances[j];
 
         constexpr float kAllowedBaselineDistanceRatio = 0.2f;
@@ -194,19 +284,14 @@ class HandDuplicatesFinder : public DuplicatesFinder {
             std::max(stable_distance_i, stable_distance_j) *
             kAllowedBaselineDistanceRatio;
 
-        ASSIGN_OR_RETURN(const std::vector<float> distances,
-                         Distances(multi_landmarks[i], multi_landmarks[j],
-                                   input_width, input_height));
-        const int num_matched_landmarks = absl::c_count_if(
-            distances,
-            [&](float distance) { return distance < distance_threshold; });
-
-        const float iou = CalculateIOU(bounds[i], bounds[j]);
+        ASSIGN_OR_RETURN(
+            const int num_matched_landmarks,
+            CountMatchedLandmarks(multi_landmarks[i], multi_landmarks[j],
+                                  distance_threshold, input_width,
+                                  input_height));
 
         constexpr int kNumMatchedLandmarksToSuppressHand = 10;  // out of 21
-        constexpr float kMinIouThresholdToSuppressHand = 0.2f;
-        if (num_matched_landmarks >= kNumMatchedLandmarksToSuppressHand &&
-            iou > kMinIouThresholdToSuppressHand) {
+        if (num_matched_landmarks >= kNumMatchedLandmarksToSuppressHand) {
           suppressed = true;
           break;
         }
@@ -215,7 +300,7 @@ class HandDuplicatesFinder : public DuplicatesFinder {
       if (suppressed) {
         suppressed_indices.insert(i);
       } else {
-        retained_indices.insert(i);
+        retained_hands.Insert(i, bounds[i]);
       }
     }
     return suppressed_indices;
@@ -112,6 +112,9 @@ ConvertHandLandmarkerGraphOptionsProto(HandLandmarkerOptions* options) {
 
   // Configure hand landmark detector options.
   options_proto->set_min_tracking_confidence(options->min_tracking_confidence);
+  options_proto->set_detector_interval(options->detector_interval);
+  options_proto->set_detector_max_tracked_motion(
+      options->detector_max_tracked_motion);
   auto* hand_landmarks_detector_graph_options =
       options_proto->mutable_hand_landmarks_detector_graph_options();
   hand_landmarks_detector_graph_options->set_min_detection_confidence(
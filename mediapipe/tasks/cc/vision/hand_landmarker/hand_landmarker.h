@@ -67,6 +67,17 @@ struct HandLandmarkerOptions {
   // successful.
   float min_tracking_confidence = 0.5;
 
+  // In video and live stream modes, while fewer than the maximum number of
+  // hands are tracked, runs the hand detector once every
+  // `detector_interval` frames to look for new hands instead of at every
+  // frame. The detector still runs at every frame while no hand is tracked.
+  int detector_interval = 1;
+
+  // In video and live stream modes, if positive, runs the hand detector at
+  // the next frame when a tracked hand moves by more than this fraction of
+  // its size between two frames, regardless of `detector_interval`.
+  float detector_max_tracked_motion = 0;
+
   // The user-defined result callback for processing live stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::LIVE_STREAM.
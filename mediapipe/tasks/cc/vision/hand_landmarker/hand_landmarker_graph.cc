@@ -21,7 +21,6 @@ limitations under the License.
 
 #include "mediapipe/calculators/core/clip_vector_size_calculator.pb.h"
 #include "mediapipe/calculators/core/gate_calculator.pb.h"
-#include "mediapipe/calculators/util/collection_has_min_size_calculator.pb.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/formats/classification.pb.h"
@@ -32,6 +31,7 @@ limitations under the License.
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/calculators/detector_scheduling_calculator.pb.h"
 #include "mediapipe/tasks/cc/components/utils/gate.h"
 #include "mediapipe/tasks/cc/core/model_asset_bundle_resources.h"
 #include "mediapipe/tasks/cc/core/model_resources_cache.h"
@@ -282,12 +282,16 @@ class HandLandmarkerGraph : public core::ModelTaskGraph {
     auto prev_hand_rects_from_landmarks =
         previous_loopback[Output<std::vector<NormalizedRect>>("PREV_LOOP")];
 
-    auto& min_size_node =
-        graph.AddNode("NormalizedRectVectorHasMinSizeCalculator");
-    prev_hand_rects_from_landmarks >> min_size_node.In("ITERABLE");
-    min_size_node.GetOptions<CollectionHasMinSizeCalculatorOptions>()
-        .set_min_size(max_num_hands);
-    auto has_enough_hands = min_size_node.Out("").Cast<bool>();
+    auto& detector_scheduling = graph.AddNode("DetectorSchedulingCalculator");
+    prev_hand_rects_from_landmarks >> detector_scheduling.In("RECTS");
+    auto& scheduling_options =
+        detector_scheduling.GetOptions<DetectorSchedulingCalculatorOptions>();
+    scheduling_options.set_max_num_objects(max_num_hands);
+    scheduling_options.set_detector_interval(tasks_options.detector_interval());
+    scheduling_options.set_max_tracked_motion(
+        tasks_options.detector_max_tracked_motion());
+    auto skip_hand_detector =
+        detector_scheduling.Out("SKIP_DETECTOR").Cast<bool>();
 
     auto& hand_detector =
         graph.AddNode("mediapipe.tasks.vision.hand_detector.HandDetectorGraph");
@@ -300,13 +304,14 @@ class HandLandmarkerGraph : public core::ModelTaskGraph {
 
     if (tasks_options.base_options().use_stream_mode()) {
       // While in stream mode, skip hand detector graph when we successfully
-      // track the hands from the last frame.
+      // track the hands from the last frame, or when the hands tracked from
+      // the last frame are not due for a new detection.
       auto image_for_hand_detector =
-          DisallowIf(image_in, has_enough_hands, graph);
+          DisallowIf(image_in, skip_hand_detector, graph);
       std::optional<Stream<NormalizedRect>> norm_rect_in_for_hand_detector;
       if (norm_rect_in) {
         norm_rect_in_for_hand_detector =
-            DisallowIf(norm_rect_in.value(), has_enough_hands, graph);
+            DisallowIf(norm_rect_in.value(), skip_hand_detector, graph);
       }
       image_for_hand_detector >> hand_detector.In("IMAGE");
       if (norm_rect_in_for_hand_detector) {
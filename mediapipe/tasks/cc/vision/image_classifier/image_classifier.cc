@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -166,6 +167,37 @@ absl::StatusOr<ImageClassifierResult> ImageClassifier::Classify(
       output_packets[kClassificationsStreamName].Get<ClassificationResult>());
 }
 
+absl::StatusOr<std::vector<ImageClassifierResult>>
+ImageClassifier::ClassifyBatch(
+    std::vector<Image> images,
+    std::optional<core::ImageProcessingOptions> image_processing_options) {
+  std::vector<PacketMap> batch_inputs;
+  batch_inputs.reserve(images.size());
+  for (auto& image : images) {
+    if (image.UsesGpu()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "GPU input images are currently not supported.",
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+    }
+    ASSIGN_OR_RETURN(NormalizedRect norm_rect,
+                     ConvertToNormalizedRect(image_processing_options, image));
+    batch_inputs.push_back(
+        {{kImageInStreamName, MakePacket<Image>(std::move(image))},
+         {kNormRectName, MakePacket<NormalizedRect>(std::move(norm_rect))}});
+  }
+  ASSIGN_OR_RETURN(auto batch_outputs,
+                   ProcessImageDataBatch(std::move(batch_inputs)));
+  std::vector<ImageClassifierResult> results;
+  results.reserve(batch_outputs.size());
+  for (auto& output_packets : batch_outputs) {
+    results.push_back(
+        ConvertToClassificationResult(output_packets[kClassificationsStreamName]
+                                          .Get<ClassificationResult>()));
+  }
+  return results;
+}
+
 absl::StatusOr<ImageClassifierResult> ImageClassifier::ClassifyForVideo(
     Image image, int64_t timestamp_ms,
     std::optional<core::ImageProcessingOptions> image_processing_options) {
@@ -16,6 +16,9 @@ limitations under the License.
 #include "mediapipe/tasks/cc/vision/image_embedder/image_embedder.h"
 
 #include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/api2/builder.h"
@@ -162,6 +165,36 @@ absl::StatusOr<ImageEmbedderResult> ImageEmbedder::Embed(
       output_packets[kEmbeddingsStreamName].Get<EmbeddingResult>());
 }
 
+absl::StatusOr<std::vector<ImageEmbedderResult>> ImageEmbedder::EmbedBatch(
+    std::vector<Image> images,
+    std::optional<core::ImageProcessingOptions> image_processing_options) {
+  std::vector<PacketMap> batch_inputs;
+  batch_inputs.reserve(images.size());
+  for (auto& image : images) {
+    if (image.UsesGpu()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "GPU input images are currently not supported.",
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+    }
+    ASSIGN_OR_RETURN(NormalizedRect norm_rect,
+                     ConvertToNormalizedRect(image_processing_options, image));
+    batch_inputs.push_back(
+        {{kImageInStreamName, MakePacket<Image>(std::move(image))},
+         {kNormRectStreamName,
+          MakePacket<NormalizedRect>(std::move(norm_rect))}});
+  }
+  ASSIGN_OR_RETURN(auto batch_outputs,
+                   ProcessImageDataBatch(std::move(batch_inputs)));
+  std::vector<ImageEmbedderResult> results;
+  results.reserve(batch_outputs.size());
+  for (auto& output_packets : batch_outputs) {
+    results.push_back(ConvertToEmbeddingResult(
+        output_packets[kEmbeddingsStreamName].Get<EmbeddingResult>()));
+  }
+  return results;
+}
+
 absl::StatusOr<ImageEmbedderResult> ImageEmbedder::EmbedForVideo(
     Image image, int64_t timestamp_ms,
     std::optional<core::ImageProcessingOptions> image_processing_options) {
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/formats/image.h"
@@ -111,6 +112,20 @@ class ImageEmbedder : core::BaseVisionTaskApi {
       std::optional<core::ImageProcessingOptions> image_processing_options =
           std::nullopt);
 
+  // Performs embedding extraction on the provided batch of independent images,
+  // with the same optional 'image_processing_options' applied to every image,
+  // and returns the result of each image in order. The images are pipelined
+  // through the task graph, so that the preprocessing of the next images
+  // overlaps with the inference on the current one, which makes this method
+  // faster than calling Embed() on each image for offline processing.
+  //
+  // Only use this method when the ImageEmbedder is created with the image
+  // running mode.
+  absl::StatusOr<std::vector<ImageEmbedderResult>> EmbedBatch(
+      std::vector<mediapipe::Image> images,
+      std::optional<core::ImageProcessingOptions> image_processing_options =
+          std::nullopt);
+
   // Performs embedding extraction on the provided video frame.
   //
   // The optional 'image_processing_options' parameter can be used to specify:
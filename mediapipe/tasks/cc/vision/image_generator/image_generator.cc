@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
@@ -230,6 +231,8 @@ ConvertImageGeneratorGraphOptionsProto(
     options_proto.mutable_lora_weights_file()->set_file_name(
         *image_generator_options->lora_weights_file_path);
   }
+  options_proto.set_show_every_n_iteration(
+      image_generator_options->show_every_n_iteration);
 
   // Configure optional condition type options.
   if (condition_options != nullptr) {
@@ -300,6 +303,8 @@ absl::StatusOr<std::unique_ptr<ImageGenerator>> ImageGenerator::Create(
           core::RunningMode::IMAGE,
           /*result_callback=*/nullptr)));
   image_generator->use_condition_image_ = use_condition_image;
+  image_generator->intermediate_result_callback_ =
+      std::move(image_generator_options->intermediate_result_callback);
   if (use_condition_image) {
     image_generator->condition_type_index_ =
         std::move(options_proto_and_condition_index.condition_type_index);
@@ -349,11 +354,19 @@ absl::StatusOr<ImageGeneratorResult> ImageGenerator::Generate(
     return absl::InvalidArgumentError(
         "ImageGenerator is created to use without conditioned image.");
   }
-  ASSIGN_OR_RETURN(auto plugin_model_image,
-                   CreateConditionImage(condition_image, condition_type));
+  // Creating the condition image runs vision models on the source image, so
+  // the result is reused as long as the same source image is passed in.
+  if (!cached_condition_image_.has_value() ||
+      cached_condition_image_->source_condition_image != condition_image ||
+      cached_condition_image_->condition_type != condition_type) {
+    ASSIGN_OR_RETURN(auto plugin_model_image,
+                     CreateConditionImage(condition_image, condition_type));
+    cached_condition_image_ = CachedConditionImage{
+        std::move(condition_image), condition_type, plugin_model_image};
+  }
   return RunIterations(
       prompt, iterations, seed,
-      ConditionInputs{plugin_model_image,
+      ConditionInputs{cached_condition_image_->condition_image,
                       condition_type_index_->at(condition_type)});
 }
 
@@ -381,6 +394,13 @@ absl::StatusOr<ImageGeneratorResult> ImageGenerator::RunIterations(
     input_packets[std::string(kRandSeedName)] =
         MakePacket<int>(rand_seed).At(Timestamp(timestamp));
     ASSIGN_OR_RETURN(output_packets, ProcessImageData(input_packets));
+    if (intermediate_result_callback_ && i < steps - 1) {
+      auto image_packet = output_packets.find(std::string(kImageOutName));
+      if (image_packet != output_packets.end() &&
+          !image_packet->second.IsEmpty()) {
+        intermediate_result_callback_(i, image_packet->second.Get<Image>());
+      }
+    }
     timestamp += 1;
   }
   result.generated_image =
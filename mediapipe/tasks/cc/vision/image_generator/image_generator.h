@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_VISION_IMAGE_GENERATOR_IMAGE_GENERATOR_H_
 #define MEDIAPIPE_TASKS_CC_VISION_IMAGE_GENERATOR_IMAGE_GENERATOR_H_
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -93,6 +94,18 @@ struct ImageGeneratorOptions {
 
   // The path to LoRA weights file.
   std::optional<std::string> lora_weights_file_path;
+
+  // If positive, an intermediate image is decoded every
+  // `show_every_n_iteration` iterations and passed to
+  // `intermediate_result_callback`. Each decode adds latency to the
+  // generation.
+  int show_every_n_iteration = 0;
+
+  // The callback receiving the intermediate images, together with the index
+  // of the iteration they were decoded at. Runs on the thread calling
+  // Generate(), before Generate() returns.
+  std::function<void(int, const Image&)> intermediate_result_callback =
+      nullptr;
 };
 
 class ImageGenerator : tasks::vision::core::BaseVisionTaskApi {
@@ -120,7 +133,9 @@ class ImageGenerator : tasks::vision::core::BaseVisionTaskApi {
                                                 int iterations, int seed = 0);
 
   // Generates an image based on the condition image for iterations and the
-  // given random seed.
+  // given random seed. The condition image created from `condition_image` is
+  // reused by following calls with the same `condition_image` and
+  // `condition_type`, e.g. to try several prompts or seeds on one image.
   // A detailed introduction to the condition image:
   // https://ai.googleblog.com/2023/06/on-device-diffusion-plugins-for.html
   absl::StatusOr<ImageGeneratorResult> Generate(
@@ -134,8 +149,19 @@ class ImageGenerator : tasks::vision::core::BaseVisionTaskApi {
     int select;
   };
 
+  // The condition image created for the last source condition image.
+  struct CachedConditionImage {
+    Image source_condition_image;
+    ConditionOptions::ConditionType condition_type;
+    Image condition_image;
+  };
+
   bool use_condition_image_ = false;
 
+  std::function<void(int, const Image&)> intermediate_result_callback_;
+
+  std::optional<CachedConditionImage> cached_condition_image_;
+
   absl::Time init_timestamp_;
 
   std::unique_ptr<tasks::core::TaskRunner>
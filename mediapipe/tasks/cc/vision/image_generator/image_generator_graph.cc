@@ -329,7 +329,10 @@ class ImageGeneratorGraph : public core::ModelTaskGraph {
       options.set_output_image_height(kPluginsOutputSize);
       options.set_output_image_width(kPluginsOutputSize);
       options.set_file_folder(subgraph_options.text2image_model_directory());
-      options.set_show_every_n_iteration(100);
+      options.set_show_every_n_iteration(
+          subgraph_options.show_every_n_iteration() > 0
+              ? subgraph_options.show_every_n_iteration()
+              : 100);
       options.set_emit_empty_packet(true);
     }
     if (lora_resources.has_value()) {
@@ -20,6 +20,7 @@ limitations under the License.
 #include <memory>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -105,16 +106,33 @@ float BilinearInterpolate(float v00, float v10, float v01, float v11, float t0,
                            LinearInterpolate(v01, v11, t0), t1);
 }
 
-float GetTensorElement(const Shape& input_shape, const float* tensors_buffer,
-                       int x, int y, int c) {
+// Returns the real value of a raw value of a tensor of type T, or of a value
+// interpolated between raw values.
+template <typename T>
+float Dequantize(float raw_value,
+                 const Tensor::QuantizationParameters& quantization) {
+  if constexpr (std::is_same_v<T, float>) {
+    return raw_value;
+  } else {
+    return quantization.scale * (raw_value - quantization.zero_point);
+  }
+}
+
+template <typename T>
+float GetTensorElement(const Shape& input_shape, const T* tensors_buffer, int x,
+                       int y, int c) {
   return tensors_buffer[y * input_shape.channels * input_shape.width +
                         x * input_shape.channels + c];
 }
 
-Image ProcessForCategoryMaskCpu(const Shape& input_shape,
-                                const Shape& output_shape,
-                                const SegmenterOptions& options,
-                                const float* tensors_buffer) {
+// Quantized tensors are interpolated and compared in the quantized domain,
+// which preserves the order of the categories as the scale is positive. Only
+// the value of a single mask is dequantized, to be compared with the cutoff.
+template <typename T>
+Image ProcessForCategoryMaskCpu(
+    const Shape& input_shape, const Shape& output_shape,
+    const SegmenterOptions& options, const T* tensors_buffer,
+    const Tensor::QuantizationParameters& quantization) {
   const float width_scale =
       (input_shape.width - 1) / static_cast<float>(output_shape.width - 1);
   const float height_scale =
@@ -131,9 +149,10 @@ Image ProcessForCategoryMaskCpu(const Shape& input_shape,
   const int input_channels = input_shape.channels;
   category_mask_mat_view.forEach<uint8_t>([&tensors_buffer, &input_shape,
                                            &width_scale, &height_scale,
-                                           &input_channels,
-                                           &options](uint8_t& pixel,
-                                                     const int position[]) {
+                                           &input_channels, &options,
+                                           &quantization](
+                                              uint8_t& pixel,
+                                              const int position[]) {
     std::vector<float> confidence_scores(input_channels);
     int y0 =
         static_cast<int>(std::max(std::floor(position[0] * height_scale), 0.f));
@@ -152,14 +171,19 @@ Image ProcessForCategoryMaskCpu(const Shape& input_shape,
           GetTensorElement(input_shape, tensors_buffer, x1, y0, i),
           GetTensorElement(input_shape, tensors_buffer, x1, y1, i), t0, t1);
     }
+    if (input_channels == 1) {
+      confidence_scores[0] = Dequantize<T>(confidence_scores[0], quantization);
+    }
     absl::Span<float> confidence_scores_span(confidence_scores.data(),
                                              confidence_scores.size());
 
-    // Only process the activation function if it is SIGMOID. If NONE,
-    // we do nothing for activation, If SOFTMAX, it is required
+    // Only process the activation function if it is SIGMOID on a single
+    // mask. If NONE, we do nothing for activation. If SOFTMAX, it is required
     // to have input_channels > 1, and for input_channels > 1, we don't need
-    // activation to find the maximum value.
-    if (options.activation() == SegmenterOptions::SIGMOID) {
+    // activation to find the maximum value, since both SIGMOID and SOFTMAX
+    // preserve the order of the values.
+    if (options.activation() == SegmenterOptions::SIGMOID &&
+        input_channels == 1) {
       Sigmoid(confidence_scores_span, confidence_scores_span);
     }
     if (input_channels == 1) {
@@ -179,10 +203,13 @@ Image ProcessForCategoryMaskCpu(const Shape& input_shape,
   return category_mask;
 }
 
-std::vector<Image> ProcessForConfidenceMaskCpu(const Shape& input_shape,
-                                               const Shape& output_shape,
-                                               const SegmenterOptions& options,
-                                               const float* tensors_buffer) {
+// Quantized tensors are dequantized pixel by pixel, right before the
+// activation function.
+template <typename T>
+std::vector<Image> ProcessForConfidenceMaskCpu(
+    const Shape& input_shape, const Shape& output_shape,
+    const SegmenterOptions& options, const T* tensors_buffer,
+    const Tensor::QuantizationParameters& quantization) {
   std::function<void(absl::Span<const float> values,
                      absl::Span<float> activated_values)>
       activation_fn;
@@ -218,10 +245,21 @@ std::vector<Image> ProcessForConfidenceMaskCpu(const Shape& input_shape,
   const int tensor_size = input_shape.height * input_shape.width;
   std::vector<float> activated_values(input_shape.channels);
   absl::Span<float> activated_values_span(activated_values);
+  std::vector<float> real_values;
+  if constexpr (!std::is_same_v<T, float>) {
+    real_values.resize(input_shape.channels);
+  }
   for (int i = 0; i < tensor_size; ++i) {
-    activation_fn(absl::MakeConstSpan(&tensors_buffer[i * input_shape.channels],
-                                      input_shape.channels),
-                  activated_values_span);
+    const T* raw_values = &tensors_buffer[i * input_shape.channels];
+    if constexpr (std::is_same_v<T, float>) {
+      activation_fn(absl::MakeConstSpan(raw_values, input_shape.channels),
+                    activated_values_span);
+    } else {
+      for (int j = 0; j < input_shape.channels; ++j) {
+        real_values[j] = Dequantize<T>(raw_values[j], quantization);
+      }
+      activation_fn(real_values, activated_values_span);
+    }
     for (int j = 0; j < input_shape.channels; ++j) {
       confidence_mask_mats[j].at<float>(
           i / input_shape.width, i % input_shape.width) = activated_values[j];
@@ -260,7 +298,9 @@ std::vector<Image> ProcessForConfidenceMaskCpu(const Shape& input_shape,
 //
 // Inputs:
 //   TENSORS: Vector containing a single KTfLiteFloat32 Tensor to be converted
-//            to segmentation masks.
+//            to segmentation masks. On CPU, the Tensor may also be a quantized
+//            kUInt8 or kInt8 Tensor, which is only dequantized where real
+//            values are needed.
 //   OUTPUT_SIZE(optional): std::pair<int, int>. Height and Width, if provided,
 //            the size to resize masks to.
 //
@@ -312,9 +352,16 @@ class TensorsToSegmentationCalculator : public Node {
   absl::Status Process(CalculatorContext* cc);
 
  private:
-  std::vector<Image> GetSegmentationResultCpu(const Shape& input_shape,
-                                              const Shape& output_shape,
-                                              const float* tensors_buffer);
+  template <typename T>
+  absl::Status ProcessCpu(CalculatorContext* cc, const Shape& input_shape,
+                          int output_height, int output_width,
+                          const T* tensors_buffer,
+                          const Tensor::QuantizationParameters& quantization);
+  template <typename T>
+  std::vector<Image> GetSegmentationResultCpu(
+      const Shape& input_shape, const Shape& output_shape,
+      const T* tensors_buffer,
+      const Tensor::QuantizationParameters& quantization);
   TensorsToSegmentationCalculatorOptions options_;
 
 #ifdef TASK_SEGMENTATION_USE_GL_POSTPROCESSING
@@ -403,7 +450,8 @@ absl::Status TensorsToSegmentationCalculator::Process(
   Shape output_shape = {/* height= */ output_height,
                         /* width= */ output_width,
                         /* channels= */ input_shape.channels};
-  if (input_tensor.ready_on_gpu()) {
+  if (input_tensor.ready_on_gpu() &&
+      input_tensor.element_type() == Tensor::ElementType::kFloat32) {
     bool produce_category_mask = options_.segmenter_options().output_type() ==
                                      SegmenterOptions::CATEGORY_MASK ||
                                  cc->Outputs().HasTag("CATEGORY_MASK");
@@ -440,8 +488,32 @@ absl::Status TensorsToSegmentationCalculator::Process(
 #endif  // TASK_SEGMENTATION_USE_GL_POSTPROCESSING
 
   // Otherwise, use CPU postprocessing.
-  const float* tensors_buffer = input_tensor.GetCpuReadView().buffer<float>();
+  const auto& quantization = input_tensor.quantization_parameters();
+  auto tensor_view = input_tensor.GetCpuReadView();
+  switch (input_tensor.element_type()) {
+    case Tensor::ElementType::kFloat32:
+      return ProcessCpu(cc, input_shape, output_height, output_width,
+                        tensor_view.buffer<float>(), quantization);
+    case Tensor::ElementType::kUInt8:
+      RET_CHECK_GT(quantization.scale, 0.0f);
+      return ProcessCpu(cc, input_shape, output_height, output_width,
+                        tensor_view.buffer<uint8_t>(), quantization);
+    case Tensor::ElementType::kInt8:
+      RET_CHECK_GT(quantization.scale, 0.0f);
+      return ProcessCpu(cc, input_shape, output_height, output_width,
+                        tensor_view.buffer<int8_t>(), quantization);
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Unsupported input tensor type: %d",
+                          static_cast<int>(input_tensor.element_type())));
+  }
+}
 
+template <typename T>
+absl::Status TensorsToSegmentationCalculator::ProcessCpu(
+    CalculatorContext* cc, const Shape& input_shape, int output_height,
+    int output_width, const T* tensors_buffer,
+    const Tensor::QuantizationParameters& quantization) {
   // TODO: remove deprecated output type support.
   if (options_.segmenter_options().has_output_type()) {
     std::vector<Image> segmented_masks = GetSegmentationResultCpu(
@@ -452,7 +524,7 @@ absl::Status TensorsToSegmentationCalculator::Process(
                  SegmenterOptions::CATEGORY_MASK
              ? 1
              : input_shape.channels},
-        input_tensor.GetCpuReadView().buffer<float>());
+        tensors_buffer, quantization);
     for (int i = 0; i < segmented_masks.size(); ++i) {
       kSegmentationOut(cc)[i].Send(std::move(segmented_masks[i]));
     }
@@ -465,7 +537,7 @@ absl::Status TensorsToSegmentationCalculator::Process(
         {/* height= */ output_height,
          /* width= */ output_width,
          /* channels= */ input_shape.channels},
-        options_.segmenter_options(), tensors_buffer);
+        options_.segmenter_options(), tensors_buffer, quantization);
     for (int i = 0; i < confidence_masks.size(); ++i) {
       kConfidenceMaskOut(cc)[i].Send(std::move(confidence_masks[i]));
     }
@@ -476,23 +548,25 @@ absl::Status TensorsToSegmentationCalculator::Process(
         {/* height= */ output_height,
          /* width= */ output_width,
          /* channels= */ 1},
-        options_.segmenter_options(), tensors_buffer));
+        options_.segmenter_options(), tensors_buffer, quantization));
   }
   return absl::OkStatus();
 }
 
+template <typename T>
 std::vector<Image> TensorsToSegmentationCalculator::GetSegmentationResultCpu(
     const Shape& input_shape, const Shape& output_shape,
-    const float* tensors_buffer) {
+    const T* tensors_buffer,
+    const Tensor::QuantizationParameters& quantization) {
   if (options_.segmenter_options().output_type() ==
       SegmenterOptions::CATEGORY_MASK) {
     return {ProcessForCategoryMaskCpu(input_shape, output_shape,
                                       options_.segmenter_options(),
-                                      tensors_buffer)};
+                                      tensors_buffer, quantization)};
   } else {
     return ProcessForConfidenceMaskCpu(input_shape, output_shape,
                                        options_.segmenter_options(),
-                                       tensors_buffer);
+                                       tensors_buffer, quantization);
   }
 }
 
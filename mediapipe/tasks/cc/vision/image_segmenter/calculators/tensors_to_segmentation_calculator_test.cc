@@ -315,6 +315,36 @@ TEST(TensorsToSegmentationCalculatorTest, SucceedsCategoryMask) {
                                             expected_index, buffer_indices)));
 }
 
+TEST(TensorsToSegmentationCalculatorTest, SucceedsCategoryMaskOnly) {
+  CalculatorRunner runner(
+      mediapipe::ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig::Node>(
+          R"pb(
+            calculator: "mediapipe.tasks.TensorsToSegmentationCalculator"
+            input_stream: "TENSORS:tensors"
+            output_stream: "CATEGORY_MASK:segmentation"
+            options {
+              [mediapipe.tasks.TensorsToSegmentationCalculatorOptions.ext] {
+                segmenter_options { activation: SIGMOID }
+              }
+            }
+          )pb"));
+
+  const int tensor_height = 2;
+  const int tensor_width = 5;
+  PushTensorsToRunner(
+      tensor_height, tensor_width,
+      std::vector<float>(kTestValues.begin(), kTestValues.end()), &runner);
+  MP_ASSERT_OK(runner.Run());
+  ASSERT_EQ(runner.Outputs().NumEntries(), 1);
+  // Largest element index is 3.
+  const int expected_index = 3;
+  const std::vector<int> buffer_indices = {0};
+  std::vector<Packet> packets = runner.Outputs().Tag("CATEGORY_MASK").packets;
+  EXPECT_THAT(packets, testing::ElementsAre(
+                           Uint8ImagePacket(tensor_height, tensor_width,
+                                            expected_index, buffer_indices)));
+}
+
 TEST(TensorsToSegmentationCalculatorTest, SucceedsCategoryMaskResize) {
   CalculatorRunner runner(
       mediapipe::ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig::Node>(
@@ -361,4 +391,61 @@ TEST(TensorsToSegmentationCalculatorTest, SucceedsCategoryMaskResize) {
                                             expected_index, buffer_indices)));
 }
 
+TEST(TensorsToSegmentationCalculatorTest, SucceedsWithQuantizedTensor) {
+  CalculatorRunner runner(
+      mediapipe::ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig::Node>(
+          R"pb(
+            calculator: "mediapipe.tasks.TensorsToSegmentationCalculator"
+            input_stream: "TENSORS:tensors"
+            output_stream: "CONFIDENCE_MASK:0:segmented_mask_0"
+            output_stream: "CONFIDENCE_MASK:1:segmented_mask_1"
+            output_stream: "CONFIDENCE_MASK:2:segmented_mask_2"
+            output_stream: "CONFIDENCE_MASK:3:segmented_mask_3"
+            output_stream: "CATEGORY_MASK:segmentation"
+            options {
+              [mediapipe.tasks.TensorsToSegmentationCalculatorOptions.ext] {
+                segmenter_options { activation: NONE }
+              }
+            }
+          )pb"));
+
+  // Quantizes kTestValues with a scale of 0.1 and a zero point of 100.
+  const int tensor_height = 2;
+  const int tensor_width = 5;
+  const std::array<uint8_t, 4> raw_values = {102, 115, 94, 134};
+  auto tensors = absl::make_unique<std::vector<Tensor>>();
+  tensors->emplace_back(
+      Tensor::ElementType::kUInt8,
+      Tensor::Shape{tensor_height, tensor_width,
+                    static_cast<int>(raw_values.size())},
+      Tensor::QuantizationParameters(0.1f, 100));
+  {
+    auto view = tensors->back().GetCpuWriteView();
+    uint8_t* tensor_buffer = view.buffer<uint8_t>();
+    for (int i = 0; i < tensor_height * tensor_width; ++i) {
+      std::copy(raw_values.begin(), raw_values.end(),
+                tensor_buffer + i * raw_values.size());
+    }
+  }
+  runner.MutableInputs()->Tag("TENSORS").packets.push_back(
+      mediapipe::Adopt(tensors.release()).At(Timestamp(0)));
+  MP_ASSERT_OK(runner.Run());
+  ASSERT_EQ(runner.Outputs().NumEntries(), 5);
+
+  const std::vector<int> buffer_indices = {
+      0, tensor_width - 1, tensor_height * tensor_width - 1};
+  for (int i = 0; i < kTestValues.size(); ++i) {
+    EXPECT_THAT(runner.Outputs().Get("CONFIDENCE_MASK", i).packets,
+                testing::ElementsAre(
+                    FloatImagePacket(tensor_height, tensor_width,
+                                     kTestValues[i], buffer_indices)));
+  }
+  // Largest element index is 3.
+  const int expected_index = 3;
+  EXPECT_THAT(runner.Outputs().Tag("CATEGORY_MASK").packets,
+              testing::ElementsAre(
+                  Uint8ImagePacket(tensor_height, tensor_width,
+                                   expected_index, buffer_indices)));
+}
+
 }  // namespace mediapipe
@@ -89,9 +89,11 @@ CalculatorGraphConfig CreateGraphConfig(
   task_subgraph.Out(kImageTag).SetName(kImageOutStreamName) >>
       graph.Out(kImageTag);
   if (enable_flow_limiting) {
+    // Uses a requested mask output as the back edge, so that confidence masks
+    // are not computed when only the category mask is requested.
     return tasks::core::AddFlowLimiterCalculator(
         graph, task_subgraph, {kImageTag, kNormRectTag, kOutputSizeTag},
-        kConfidenceMasksTag);
+        output_confidence_masks ? kConfidenceMasksTag : kCategoryMaskTag);
   }
   graph.In(kImageTag) >> task_subgraph.In(kImageTag);
   graph.In(kNormRectTag) >> task_subgraph.In(kNormRectTag);
@@ -110,6 +112,8 @@ ConvertImageSegmenterOptionsToProto(ImageSegmenterOptions* options) {
   options_proto->mutable_base_options()->set_use_stream_mode(
       options->running_mode != core::RunningMode::IMAGE);
   options_proto->set_display_names_locale(options->display_names_locale);
+  options_proto->mutable_segmenter_options()->set_output_masks_on_gpu(
+      options->output_masks_on_gpu);
   return options_proto;
 }
 
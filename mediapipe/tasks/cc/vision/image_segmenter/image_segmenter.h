@@ -59,6 +59,11 @@ struct ImageSegmenterOptions {
   // Whether to output category mask.
   bool output_category_mask = false;
 
+  // Whether to keep the output masks as GPU-backed Images. Their pixel data is
+  // only copied to CPU on first CPU access, which saves the read back when the
+  // masks are consumed by GPU rendering. Requires a build with GPU support.
+  bool output_masks_on_gpu = false;
+
   // The user-defined result callback for processing live stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::LIVE_STREAM.
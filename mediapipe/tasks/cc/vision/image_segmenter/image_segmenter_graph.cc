@@ -36,6 +36,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/components/processors/image_preprocessing_graph.h"
 #include "mediapipe/tasks/cc/components/processors/proto/image_preprocessing_graph_options.pb.h"
+#include "mediapipe/tasks/cc/components/utils/frame_change_gate.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
 #include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
@@ -250,6 +251,17 @@ void ConfigureTensorConverterCalculator(
   options.mutable_output_tensor_float_range()->set_max((255.0f - mean) / std);
 }
 
+// Keeps the given mask on GPU. Masks computed on GPU are passed through
+// without a copy, while masks computed on CPU are uploaded to GPU. In both
+// cases the CPU pixel data is only produced on first CPU access.
+Source<Image> KeepMaskOnGpu(Source<Image> mask, Graph& graph) {
+  auto& image_clone = graph.AddNode("ImageCloneCalculator");
+  image_clone.GetOptions<mediapipe::ImageCloneCalculatorOptions>()
+      .set_output_on_gpu(true);
+  mask >> image_clone.In("");
+  return image_clone.Out("").Cast<Image>();
+}
+
 // Image preprocessing step to convert the given image to the input tensors for
 // the tflite model.
 absl::StatusOr<ImageAndTensorsOnDevice> ConvertImageToTensors(
@@ -522,8 +534,19 @@ class ImageSegmenterGraph : public core::ModelTaskGraph {
     // tensors produced by the ImageToTensorCalculator.
     auto& inference = AddInference(
         model_resources, task_options.base_options().acceleration(), graph);
-    image_and_tensors.tensors >> inference.In(kTensorsTag);
-    inference.Out(kTensorsTag) >> tensor_to_images.In(kTensorsTag);
+    Source<std::vector<Tensor>> input_tensors = image_and_tensors.tensors;
+    Source<std::vector<Tensor>> output_tensors =
+        inference.Out(kTensorsTag).Cast<std::vector<Tensor>>();
+    if (task_options.has_frame_change_gate()) {
+      // Skips inference for near-static frames, and reuses the output tensors
+      // of the last inferred frame for them.
+      components::utils::FrameChangeGate frame_change_gate(
+          task_options.frame_change_gate(), image_in, graph);
+      input_tensors = frame_change_gate.Gate(input_tensors);
+      output_tensors = frame_change_gate.Reuse(output_tensors);
+    }
+    input_tensors >> inference.In(kTensorsTag);
+    output_tensors >> tensor_to_images.In(kTensorsTag);
 
     if (output_size.has_value()) {
       *output_size >> tensor_to_images.In(kOutputSizeTag);
@@ -576,6 +599,16 @@ class ImageSegmenterGraph : public core::ModelTaskGraph {
       if (output_category_mask_) {
         category_mask = tensor_to_images[Output<Image>(kCategoryMaskTag)];
       }
+      if (task_options.segmenter_options().output_masks_on_gpu()) {
+        if (confidence_masks) {
+          for (auto& confidence_mask : *confidence_masks) {
+            confidence_mask = KeepMaskOnGpu(confidence_mask, graph);
+          }
+        }
+        if (category_mask) {
+          category_mask = KeepMaskOnGpu(*category_mask, graph);
+        }
+      }
       auto quality_scores =
           tensor_to_images[Output<std::vector<float>>(kQualityScoresTag)];
       return ImageSegmenterOutputs{/*segmented_masks=*/std::nullopt,
@@ -126,7 +126,9 @@ Source<> RoiToAlpha(Source<Image> image, Source<RenderData> roi, bool use_gpu,
   roi >> add_thickness.In(kRenderDataTag);
   auto roi_with_thickness = add_thickness.Out(kRenderDataTag);
 
-  // Generates a blank canvas with same size as input image.
+  // Generates a blank canvas with same size as input image. The canvas is
+  // reused, together with its GPU copy, across prompts on images of the same
+  // size, so repeated prompts only pay for rendering the ROI.
   auto& flat_color = graph.AddNode("FlatColorImageCalculator");
   auto& flat_color_options =
       flat_color.GetOptions<FlatColorImageCalculatorOptions>();
@@ -107,6 +107,12 @@ std::unique_ptr<ObjectDetectorOptionsProto> ConvertObjectDetectorOptionsToProto(
   for (const std::string& category : options->category_denylist) {
     options_proto->add_category_denylist(category);
   }
+  if (options->tiling_num_rows * options->tiling_num_columns > 1) {
+    auto* tiling = options_proto->mutable_tiling();
+    tiling->set_num_rows(options->tiling_num_rows);
+    tiling->set_num_columns(options->tiling_num_columns);
+    tiling->set_overlap(options->tiling_overlap);
+  }
   return options_proto;
 }
 
@@ -180,6 +186,41 @@ absl::StatusOr<ObjectDetectorResult> ObjectDetector::Detect(
       output_packets[kDetectionsOutStreamName].Get<std::vector<Detection>>());
 }
 
+absl::StatusOr<std::vector<ObjectDetectorResult>> ObjectDetector::DetectBatch(
+    std::vector<mediapipe::Image> images,
+    std::optional<core::ImageProcessingOptions> image_processing_options) {
+  std::vector<tasks::core::PacketMap> batch_inputs;
+  batch_inputs.reserve(images.size());
+  for (auto& image : images) {
+    if (image.UsesGpu()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "GPU input images are currently not supported.",
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+    }
+    ASSIGN_OR_RETURN(NormalizedRect norm_rect,
+                     ConvertToNormalizedRect(image_processing_options, image,
+                                             /*roi_allowed=*/false));
+    batch_inputs.push_back(
+        {{kImageInStreamName, MakePacket<Image>(std::move(image))},
+         {kNormRectName, MakePacket<NormalizedRect>(std::move(norm_rect))}});
+  }
+  ASSIGN_OR_RETURN(auto batch_outputs,
+                   ProcessImageDataBatch(std::move(batch_inputs)));
+  std::vector<ObjectDetectorResult> results;
+  results.reserve(batch_outputs.size());
+  for (auto& output_packets : batch_outputs) {
+    if (output_packets[kDetectionsOutStreamName].IsEmpty()) {
+      results.push_back(ConvertToDetectionResult({}));
+      continue;
+    }
+    results.push_back(
+        ConvertToDetectionResult(output_packets[kDetectionsOutStreamName]
+                                     .Get<std::vector<Detection>>()));
+  }
+  return results;
+}
+
 absl::StatusOr<ObjectDetectorResult> ObjectDetector::DetectForVideo(
     mediapipe::Image image, int64_t timestamp_ms,
     std::optional<core::ImageProcessingOptions> image_processing_options) {
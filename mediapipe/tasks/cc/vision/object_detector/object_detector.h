@@ -81,6 +81,16 @@ struct ObjectDetectorOptions {
   // category names are ignored. Mutually exclusive with category_allowlist.
   std::vector<std::string> category_denylist = {};
 
+  // The number of rows and columns of overlapping tiles to run the detector
+  // on, in addition to the whole image, for high resolution images with small
+  // objects. The detections of all tiles are merged. Tiling is off when both
+  // are 1.
+  int tiling_num_rows = 1;
+  int tiling_num_columns = 1;
+
+  // The fraction of a tile that overlaps with each neighbor tile, in [0, 1).
+  float tiling_overlap = 0.2;
+
   // The user-defined result callback for processing live stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::LIVE_STREAM.
@@ -187,6 +197,20 @@ class ObjectDetector : public tasks::vision::core::BaseVisionTaskApi {
       std::optional<core::ImageProcessingOptions> image_processing_options =
           std::nullopt);
 
+  // Performs object detection on the provided batch of independent images,
+  // with the same optional 'image_processing_options' applied to every image,
+  // and returns the result of each image in order. The images are pipelined
+  // through the task graph, so that the preprocessing of the next images
+  // overlaps with the inference on the current one, which makes this method
+  // faster than calling Detect() on each image for offline processing.
+  //
+  // Only use this method when the ObjectDetector is created with the image
+  // running mode.
+  absl::StatusOr<std::vector<ObjectDetectorResult>> DetectBatch(
+      std::vector<mediapipe::Image> images,
+      std::optional<core::ImageProcessingOptions> image_processing_options =
+          std::nullopt);
+
   // Performs object detection on the provided video frame.
   // Only use this method when the ObjectDetector is created with the video
   // running mode.
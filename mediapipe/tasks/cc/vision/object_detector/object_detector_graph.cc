@@ -13,10 +13,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "mediapipe/calculators/util/non_max_suppression_calculator.pb.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/calculator.pb.h"
@@ -25,15 +28,18 @@ limitations under the License.
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/calculators/tile_rects_calculator.pb.h"
 #include "mediapipe/tasks/cc/components/processors/detection_postprocessing_graph.h"
 #include "mediapipe/tasks/cc/components/processors/image_preprocessing_graph.h"
 #include "mediapipe/tasks/cc/components/processors/proto/detection_postprocessing_graph_options.pb.h"
 #include "mediapipe/tasks/cc/components/processors/proto/detector_options.pb.h"
+#include "mediapipe/tasks/cc/components/utils/frame_change_gate.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
 #include "mediapipe/tasks/cc/core/proto/inference_subgraph.pb.h"
 #include "mediapipe/tasks/cc/vision/object_detector/proto/object_detector_options.pb.h"
 #include "mediapipe/tasks/metadata/metadata_schema_generated.h"
+#include "tensorflow/lite/schema/schema_generated.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -41,6 +47,7 @@ namespace vision {
 
 namespace {
 
+using ::mediapipe::NonMaxSuppressionCalculatorOptions;
 using ::mediapipe::NormalizedRect;
 using ::mediapipe::api2::Input;
 using ::mediapipe::api2::Output;
@@ -51,14 +58,20 @@ using ObjectDetectorOptionsProto =
 using TensorsSource =
     mediapipe::api2::builder::Source<std::vector<mediapipe::Tensor>>;
 
+constexpr char kBatchEndTag[] = "BATCH_END";
+constexpr char kCloneTag[] = "CLONE";
 constexpr char kDetectionsTag[] = "DETECTIONS";
 constexpr char kImageSizeTag[] = "IMAGE_SIZE";
 constexpr char kImageTag[] = "IMAGE";
+constexpr char kItemTag[] = "ITEM";
+constexpr char kIterableTag[] = "ITERABLE";
 constexpr char kMatrixTag[] = "MATRIX";
 constexpr char kNormRectTag[] = "NORM_RECT";
 constexpr char kPixelDetectionsTag[] = "PIXEL_DETECTIONS";
 constexpr char kProjectionMatrixTag[] = "PROJECTION_MATRIX";
+constexpr char kSizeTag[] = "SIZE";
 constexpr char kTensorTag[] = "TENSORS";
+constexpr char kTilesTag[] = "TILES";
 
 // Struct holding the different output streams produced by the object detection
 // subgraph.
@@ -85,6 +98,18 @@ absl::Status SanityCheckOptions(const ObjectDetectorOptionsProto& options) {
   return absl::OkStatus();
 }
 
+// Returns true if the first input tensor of the model has a dynamic batch
+// dimension, so that several images can be inferred in one batch.
+bool HasDynamicBatchDimension(const tflite::Model& model) {
+  const tflite::SubGraph& subgraph = *model.subgraphs()->Get(0);
+  if (subgraph.inputs()->size() == 0) return false;
+  const tflite::Tensor& tensor =
+      *subgraph.tensors()->Get(subgraph.inputs()->Get(0));
+  return tensor.shape_signature() != nullptr &&
+         tensor.shape_signature()->size() > 0 &&
+         tensor.shape_signature()->Get(0) == -1;
+}
+
 }  // namespace
 
 // A "mediapipe.tasks.vision.ObjectDetectorGraph" performs object detection.
@@ -184,6 +209,44 @@ class ObjectDetectorGraph : public core::ModelTaskGraph {
           MediaPipeTasksStatus::kMetadataNotFoundError);
     }
 
+    // With tiling, the detection below runs in a loop over the tiles of the
+    // image, which is cloned to the timestamp of each tile.
+    Source<Image> image_to_detect = image_in;
+    Source<NormalizedRect> rect_to_detect = norm_rect_in;
+    std::optional<Source<Timestamp>> tiles_batch_end;
+    std::optional<Source<std::pair<int, int>>> image_size;
+    // With a frame change gate, detection is skipped for near-static frames,
+    // which get the detections of the last detected frame.
+    std::optional<components::utils::FrameChangeGate> frame_change_gate;
+    if (task_options.has_frame_change_gate()) {
+      frame_change_gate.emplace(task_options.frame_change_gate(), image_in,
+                                graph);
+      image_to_detect = frame_change_gate->Gate(image_to_detect);
+      rect_to_detect = frame_change_gate->Gate(rect_to_detect);
+    }
+    int num_tiles = 1;
+    if (task_options.has_tiling()) {
+      const auto& tiling = task_options.tiling();
+      num_tiles = tiling.num_rows() * tiling.num_columns() +
+                  (tiling.include_whole_rect() ? 1 : 0);
+      auto& image_properties = graph.AddNode("ImagePropertiesCalculator");
+      image_to_detect >> image_properties.In(kImageTag);
+      image_size = image_properties.Out(kSizeTag).Cast<std::pair<int, int>>();
+
+      auto& tile_rects = graph.AddNode("TileRectsCalculator");
+      tile_rects.GetOptions<TileRectsCalculatorOptions>().CopyFrom(tiling);
+      *image_size >> tile_rects.In(kImageSizeTag);
+      rect_to_detect >> tile_rects.In(kNormRectTag);
+
+      auto& begin_loop_tiles =
+          graph.AddNode("BeginLoopNormalizedRectCalculator");
+      image_to_detect >> begin_loop_tiles.In(kCloneTag);
+      tile_rects.Out(kTilesTag) >> begin_loop_tiles.In(kIterableTag);
+      image_to_detect = begin_loop_tiles.Out(kCloneTag).Cast<Image>();
+      rect_to_detect = begin_loop_tiles.Out(kItemTag).Cast<NormalizedRect>();
+      tiles_batch_end = begin_loop_tiles.Out(kBatchEndTag).Cast<Timestamp>();
+    }
+
     // Adds preprocessing calculators and connects them to the graph input image
     // stream.
     auto& preprocessing = graph.AddNode(
@@ -195,13 +258,19 @@ class ObjectDetectorGraph : public core::ModelTaskGraph {
         model_resources, use_gpu,
         &preprocessing.GetOptions<tasks::components::processors::proto::
                                       ImagePreprocessingGraphOptions>()));
-    image_in >> preprocessing.In(kImageTag);
-    norm_rect_in >> preprocessing.In(kNormRectTag);
+    image_to_detect >> preprocessing.In(kImageTag);
+    rect_to_detect >> preprocessing.In(kNormRectTag);
 
     // Adds inference subgraph and connects its input stream to the output
     // tensors produced by the ImageToTensorCalculator.
     auto& inference = AddInference(
         model_resources, task_options.base_options().acceleration(), graph);
+    if (num_tiles > 1 && HasDynamicBatchDimension(model)) {
+      // Infers the tiles of an image in one batch.
+      inference.GetOptions<core::proto::InferenceSubgraphOptions>()
+          .mutable_batching()
+          ->set_max_batch_size(num_tiles);
+    }
     preprocessing.Out(kTensorTag) >> inference.In(kTensorTag);
     TensorsSource model_output_tensors =
         inference.Out(kTensorTag).Cast<std::vector<Tensor>>();
@@ -235,15 +304,44 @@ class ObjectDetectorGraph : public core::ModelTaskGraph {
     detections >> detection_projection.In(kDetectionsTag);
     preprocessing.Out(kMatrixTag) >>
         detection_projection.In(kProjectionMatrixTag);
+    auto projected_detections =
+        detection_projection[Output<std::vector<Detection>>(kDetectionsTag)];
+
+    if (task_options.has_tiling()) {
+      // Collects the detections of all tiles at the image timestamp, and
+      // suppresses the duplicates of objects found in several tiles.
+      auto& end_loop_detections =
+          graph.AddNode("EndLoopDetectionVectorCalculator");
+      *tiles_batch_end >> end_loop_detections.In(kBatchEndTag);
+      projected_detections >> end_loop_detections.In(kItemTag);
+      auto& flatten_detections =
+          graph.AddNode("FlattenDetectionVectorsCalculator");
+      end_loop_detections.Out(kIterableTag) >> flatten_detections.In("");
+
+      auto& tiles_nms = graph.AddNode("NonMaxSuppressionCalculator");
+      auto& nms_options =
+          tiles_nms.GetOptions<NonMaxSuppressionCalculatorOptions>();
+      nms_options.set_min_suppression_threshold(
+          detector_options.min_suppression_threshold());
+      nms_options.set_overlap_type(
+          NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION);
+      nms_options.set_max_num_detections(task_options.max_results());
+      nms_options.set_return_empty_detections(true);
+      flatten_detections.Out("") >> tiles_nms.In("");
+      projected_detections = tiles_nms[Output<std::vector<Detection>>("")];
+    }
 
     // Calculator to convert relative detection bounding boxes to pixel
     // detection bounding boxes.
     auto& detection_transformation =
         graph.AddNode("DetectionTransformationCalculator");
-    detection_projection.Out(kDetectionsTag) >>
-        detection_transformation.In(kDetectionsTag);
-    preprocessing.Out(kImageSizeTag) >>
-        detection_transformation.In(kImageSizeTag);
+    projected_detections >> detection_transformation.In(kDetectionsTag);
+    if (image_size) {
+      *image_size >> detection_transformation.In(kImageSizeTag);
+    } else {
+      preprocessing.Out(kImageSizeTag) >>
+          detection_transformation.In(kImageSizeTag);
+    }
     auto detections_in_pixel =
         detection_transformation.Out(kPixelDetectionsTag);
 
@@ -252,12 +350,26 @@ class ObjectDetectorGraph : public core::ModelTaskGraph {
         graph.AddNode("DetectionsDeduplicateCalculator");
     detections_in_pixel >> detections_deduplicate.In("");
 
+    Source<std::vector<Detection>> detections_out =
+        detections_deduplicate[Output<std::vector<Detection>>("")];
+    if (frame_change_gate) {
+      detections_out = frame_change_gate->Reuse(detections_out);
+    }
+
     // Outputs the labeled detections and the processed image as the subgraph
     // output streams.
+    // With tiling, the preprocessed images are at the tile timestamps, and
+    // with a frame change gate they are missing for skipped frames, so the
+    // input image is passed through instead.
+    Source<Image> image_out = preprocessing[Output<Image>(kImageTag)];
+    if (task_options.has_tiling() || frame_change_gate) {
+      auto& pass_through = graph.AddNode("PassThroughCalculator");
+      image_in >> pass_through.In("");
+      image_out = pass_through.Out("").Cast<Image>();
+    }
     return {{
-        /* detections= */
-        detections_deduplicate[Output<std::vector<Detection>>("")],
-        /* image= */ preprocessing[Output<Image>(kImageTag)],
+        /* detections= */ detections_out,
+        /* image= */ image_out,
     }};
   }
 };
@@ -115,6 +115,9 @@ ConvertPoseLandmarkerGraphOptionsProto(PoseLandmarkerOptions* options) {
 
   // Configure pose landmark detector options.
   options_proto->set_min_tracking_confidence(options->min_tracking_confidence);
+  options_proto->set_detector_interval(options->detector_interval);
+  options_proto->set_detector_max_tracked_motion(
+      options->detector_max_tracked_motion);
   auto* pose_landmarks_detector_graph_options =
       options_proto->mutable_pose_landmarks_detector_graph_options();
   pose_landmarks_detector_graph_options->set_min_detection_confidence(
@@ -22,7 +22,6 @@ limitations under the License.
 #include "mediapipe/calculators/core/clip_vector_size_calculator.pb.h"
 #include "mediapipe/calculators/core/gate_calculator.pb.h"
 #include "mediapipe/calculators/util/association_calculator.pb.h"
-#include "mediapipe/calculators/util/collection_has_min_size_calculator.pb.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/formats/detection.pb.h"
@@ -32,6 +31,7 @@ limitations under the License.
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/calculators/detector_scheduling_calculator.pb.h"
 #include "mediapipe/tasks/cc/components/utils/gate.h"
 #include "mediapipe/tasks/cc/core/model_asset_bundle_resources.h"
 #include "mediapipe/tasks/cc/core/model_resources_cache.h"
@@ -77,7 +77,8 @@ constexpr char kDetectionsTag[] = "DETECTIONS";
 constexpr char kLoopTag[] = "LOOP";
 constexpr char kPrevLoopTag[] = "PREV_LOOP";
 constexpr char kMainTag[] = "MAIN";
-constexpr char kIterableTag[] = "ITERABLE";
+constexpr char kRectsTag[] = "RECTS";
+constexpr char kSkipDetectorTag[] = "SKIP_DETECTOR";
 constexpr char kSegmentationMaskTag[] = "SEGMENTATION_MASK";
 
 constexpr char kPoseDetectorTFLiteName[] = "pose_detector.tflite";
@@ -334,19 +335,25 @@ class PoseLandmarkerGraph : public core::ModelTaskGraph {
       auto prev_pose_rects_from_landmarks =
           previous_loopback[Output<std::vector<NormalizedRect>>(kPrevLoopTag)];
 
-      auto& min_size_node =
-          graph.AddNode("NormalizedRectVectorHasMinSizeCalculator");
-      prev_pose_rects_from_landmarks >> min_size_node.In(kIterableTag);
-      min_size_node.GetOptions<CollectionHasMinSizeCalculatorOptions>()
-          .set_min_size(max_num_poses);
-      auto has_enough_poses = min_size_node.Out("").Cast<bool>();
+      auto& detector_scheduling = graph.AddNode("DetectorSchedulingCalculator");
+      prev_pose_rects_from_landmarks >> detector_scheduling.In(kRectsTag);
+      auto& scheduling_options =
+          detector_scheduling.GetOptions<DetectorSchedulingCalculatorOptions>();
+      scheduling_options.set_max_num_objects(max_num_poses);
+      scheduling_options.set_detector_interval(
+          tasks_options.detector_interval());
+      scheduling_options.set_max_tracked_motion(
+          tasks_options.detector_max_tracked_motion());
+      auto skip_pose_detector =
+          detector_scheduling.Out(kSkipDetectorTag).Cast<bool>();
 
       // While in stream mode, skip pose detector graph when we successfully
-      // track the poses from the last frame.
+      // track the poses from the last frame, or when the poses tracked from
+      // the last frame are not due for a new detection.
       auto image_for_pose_detector =
-          DisallowIf(image_in, has_enough_poses, graph);
+          DisallowIf(image_in, skip_pose_detector, graph);
       auto norm_rect_in_for_pose_detector =
-          DisallowIf(norm_rect_in, has_enough_poses, graph);
+          DisallowIf(norm_rect_in, skip_pose_detector, graph);
       image_for_pose_detector >> pose_detector.In(kImageTag);
       norm_rect_in_for_pose_detector >> pose_detector.In(kNormRectTag);
       auto expanded_pose_rects_from_pose_detector =
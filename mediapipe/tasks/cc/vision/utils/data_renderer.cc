@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/types/span.h"
+#include "mediapipe/calculators/util/annotation_overlay_calculator.pb.h"
 #include "mediapipe/calculators/util/landmarks_to_render_data_calculator.pb.h"
 #include "mediapipe/calculators/util/rect_to_render_data_calculator.pb.h"
 #include "mediapipe/calculators/util/rect_to_render_scale_calculator.pb.h"
@@ -38,6 +39,8 @@ Stream<Image> Render(Stream<Image> image,
                      absl::Span<Stream<mediapipe::RenderData>> render_data_list,
                      Graph& graph) {
   auto& annotation_overlay = graph.AddNode("AnnotationOverlayCalculator");
+  annotation_overlay.GetOptions<mediapipe::AnnotationOverlayCalculatorOptions>()
+      .set_gpu_draw_geometry(true);
   image >> annotation_overlay.In("UIMAGE");
   for (int i = 0; i < render_data_list.size(); ++i) {
     render_data_list[i] >> annotation_overlay.In(i);
@@ -31,7 +31,9 @@ limitations under the License.
 namespace mediapipe::tasks::vision::utils {
 
 // Adds a node to the provided graph that renders the render_data_list on the
-// given image, and returns the rendered image.
+// given image, and returns the rendered image. On GPU images, landmarks, rects
+// and other shapes are drawn directly with OpenGL; render data with text falls
+// back to drawing on a CPU canvas.
 api2::builder::Stream<Image> Render(
     api2::builder::Stream<Image> image,
     absl::Span<api2::builder::Stream<mediapipe::RenderData>> render_data_list,
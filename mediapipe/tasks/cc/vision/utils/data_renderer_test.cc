@@ -55,6 +55,11 @@ TEST(DataRenderer, Render) {
           input_stream: "__stream_1"
           input_stream: "UIMAGE:__stream_0"
           output_stream: "UIMAGE:image_out"
+          options {
+            [mediapipe.AnnotationOverlayCalculatorOptions.ext] {
+              gpu_draw_geometry: true
+            }
+          }
         }
         input_stream: "IMAGE:__stream_0"
         input_stream: "RENDER_DATA:__stream_1"
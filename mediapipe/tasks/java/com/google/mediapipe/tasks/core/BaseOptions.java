@@ -14,6 +14,7 @@
 
 package com.google.mediapipe.tasks.core;
 
+import android.os.ParcelFileDescriptor;
 import com.google.auto.value.AutoValue;
 import java.nio.ByteBuffer;
 import java.nio.MappedByteBuffer;
@@ -40,6 +41,18 @@ public abstract class BaseOptions {
      */
     public abstract Builder setModelAssetFileDescriptor(Integer value);
 
+    /**
+     * Sets the {@link ParcelFileDescriptor} of a model asset file (a tflite model or a model asset
+     * bundle file), or of a shared memory region holding one, e.g. received from another process.
+     * The region is mapped read-only and shared, so that processes loading the same model from one
+     * region hold a single copy of its weights. The descriptor must stay open until the task is
+     * created.
+     *
+     * <p>Note: when the model parcel file descriptor is set, the model path, model file descriptor
+     * and model buffer should be empty.
+     */
+    public abstract Builder setModelAssetParcelFileDescriptor(ParcelFileDescriptor value);
+
     /**
      * Sets either the direct {@link ByteBuffer} or the {@link MappedByteBuffer} of a model asset
      * file (a tflite model or a model asset bundle file).
@@ -69,12 +82,18 @@ public abstract class BaseOptions {
       BaseOptions options = autoBuild();
       int modelAssetPathPresent = options.modelAssetPath().isPresent() ? 1 : 0;
       int modelAssetFileDescriptorPresent = options.modelAssetFileDescriptor().isPresent() ? 1 : 0;
+      int modelAssetParcelFileDescriptorPresent =
+          options.modelAssetParcelFileDescriptor().isPresent() ? 1 : 0;
       int modelAssetBufferPresent = options.modelAssetBuffer().isPresent() ? 1 : 0;
 
-      if (modelAssetPathPresent + modelAssetFileDescriptorPresent + modelAssetBufferPresent != 1) {
+      if (modelAssetPathPresent
+              + modelAssetFileDescriptorPresent
+              + modelAssetParcelFileDescriptorPresent
+              + modelAssetBufferPresent
+          != 1) {
         throw new IllegalArgumentException(
-            "Please specify only one of the model asset path, the model asset file descriptor, and"
-                + " the model asset buffer.");
+            "Please specify only one of the model asset path, the model asset file descriptor, the"
+                + " model asset parcel file descriptor, and the model asset buffer.");
       }
       if (options.modelAssetBuffer().isPresent()
           && !(options.modelAssetBuffer().get().isDirect()
@@ -107,6 +126,8 @@ public abstract class BaseOptions {
 
   abstract Optional<Integer> modelAssetFileDescriptor();
 
+  abstract Optional<ParcelFileDescriptor> modelAssetParcelFileDescriptor();
+
   abstract Optional<ByteBuffer> modelAssetBuffer();
 
   abstract Delegate delegate();
@@ -55,6 +55,14 @@ public abstract class TaskOptions {
             fd ->
                 externalFileBuilder.setFileDescriptorMeta(
                     ExternalFileProto.FileDescriptorMeta.newBuilder().setFd(fd).build()));
+    options
+        .modelAssetParcelFileDescriptor()
+        .ifPresent(
+            parcelFd ->
+                externalFileBuilder.setFileDescriptorMeta(
+                    ExternalFileProto.FileDescriptorMeta.newBuilder()
+                        .setFd(parcelFd.getFd())
+                        .build()));
     options
         .modelAssetBuffer()
         .ifPresent(
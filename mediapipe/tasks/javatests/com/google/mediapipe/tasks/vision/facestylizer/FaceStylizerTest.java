@@ -77,8 +77,8 @@ public class FaceStylizerTest {
       assertThat(exception)
           .hasMessageThat()
           .contains(
-              "specify only one of the model asset path, the model asset file descriptor, and the"
-                  + " model asset buffer");
+              "specify only one of the model asset path, the model asset file descriptor, the"
+                  + " model asset parcel file descriptor, and the model asset buffer");
     }
   }
 
@@ -19,6 +19,7 @@
 import {WasmFileset} from './wasm_fileset';
 
 let supportsSimd: boolean|undefined;
+let supportsThreads: boolean|undefined;
 
 /**
  * Simple WASM program to test compatibility with the M91 instruction set.
@@ -46,10 +47,38 @@ async function isSimdSupported(): Promise<boolean> {
   return supportsSimd;
 }
 
+/**
+ * Returns whether the multi-threaded Wasm files can run. They use SIMD and
+ * share their memory with web workers, which requires the page to be
+ * cross-origin isolated.
+ */
+async function isThreadsSupported(): Promise<boolean> {
+  if (supportsThreads === undefined) {
+    supportsThreads = false;
+    if (typeof SharedArrayBuffer !== 'undefined' && self.crossOriginIsolated &&
+        await isSimdSupported()) {
+      try {
+        new WebAssembly.Memory({initial: 1, maximum: 1, shared: true});
+        supportsThreads = true;
+      } catch {
+        supportsThreads = false;
+      }
+    }
+  }
+
+  return supportsThreads;
+}
+
 async function createFileset(
-    taskName: MediapipeTaskCategory, basePath?: string): Promise<WasmFileset> {
-  const suffix =
-      await isSimdSupported() ? 'wasm_internal' : 'wasm_nosimd_internal';
+    taskName: MediapipeTaskCategory, basePath?: string,
+    useThreads = false): Promise<WasmFileset> {
+  let suffix: string;
+  if (useThreads && await isThreadsSupported()) {
+    suffix = 'wasm_threads_internal';
+  } else {
+    suffix =
+        await isSimdSupported() ? 'wasm_internal' : 'wasm_nosimd_internal';
+  }
 
   // For backwards compatiblity, we treat an unset `basePath` as a relative
   // path. FilesetResolver provides an empty path as a default, which is not
@@ -68,10 +97,12 @@ async function createFileset(
  * Resolves the files required for the MediaPipe Task APIs.
  *
  * This class verifies whether SIMD is supported in the current environment and
- * loads the SIMD files only if support is detected. The returned filesets
- * require that the Wasm files are published without renaming. If this is not
- * possible, you can invoke the MediaPipe Tasks APIs using a manually created
- * `WasmFileset`.
+ * loads the SIMD files only if support is detected. If requested, it loads
+ * the multi-threaded SIMD files instead when the page is cross-origin
+ * isolated, and falls back to the single-threaded files otherwise. The
+ * returned filesets require that the Wasm files are published without
+ * renaming. If this is not possible, you can invoke the MediaPipe Tasks APIs
+ * using a manually created `WasmFileset`.
  */
 export class FilesetResolver {
   /**
@@ -88,6 +119,19 @@ export class FilesetResolver {
     return isSimdSupported();
   }
 
+  /**
+   * Returns whether the multi-threaded Wasm files can run in the current
+   * environment, which requires SIMD, shared Wasm memory and cross-origin
+   * isolation.
+   *
+   * @export
+   * @return Whether multi-threading support was detected in the current
+   *    environment.
+   */
+  static isThreadsSupported(): Promise<boolean> {
+    return isThreadsSupported();
+  }
+
   /**
    * Creates a fileset for the MediaPipe Audio tasks.
    *
@@ -95,11 +139,15 @@ export class FilesetResolver {
    * @param basePath An optional base path to specify the directory the Wasm
    *    files should be loaded from. If not specified, the Wasm files are
    *    loaded from the host's root directory.
+   * @param useThreads Whether to load the multi-threaded Wasm files if the
+   *    current environment supports them. They must be published next to the
+   *    single-threaded files, which are loaded otherwise.
    * @return A `WasmFileset` that can be used to initialize MediaPipe Audio
    *    tasks.
    */
-  static forAudioTasks(basePath = ''): Promise<WasmFileset> {
-    return createFileset('audio', basePath);
+  static forAudioTasks(basePath = '', useThreads = false):
+      Promise<WasmFileset> {
+    return createFileset('audio', basePath, useThreads);
   }
 
   /**
@@ -109,11 +157,15 @@ export class FilesetResolver {
    * @param basePath An optional base path to specify the directory the Wasm
    *    files should be loaded from. If not specified, the Wasm files are
    *    loaded from the host's root directory.
+   * @param useThreads Whether to load the multi-threaded Wasm files if the
+   *    current environment supports them. They must be published next to the
+   *    single-threaded files, which are loaded otherwise.
    * @return A `WasmFileset` that can be used to initialize MediaPipe Text
    *    tasks.
    */
-  static forTextTasks(basePath = ''): Promise<WasmFileset> {
-    return createFileset('text', basePath);
+  static forTextTasks(basePath = '', useThreads = false):
+      Promise<WasmFileset> {
+    return createFileset('text', basePath, useThreads);
   }
 
   /**
@@ -123,11 +175,15 @@ export class FilesetResolver {
    * @param basePath An optional base path to specify the directory the Wasm
    *    files should be loaded from. If not specified, the Wasm files are
    *    loaded from the host's root directory.
+   * @param useThreads Whether to load the multi-threaded Wasm files if the
+   *    current environment supports them. They must be published next to the
+   *    single-threaded files, which are loaded otherwise.
    * @return A `WasmFileset` that can be used to initialize MediaPipe Vision
    *    tasks.
    */
-  static forVisionTasks(basePath = ''): Promise<WasmFileset> {
-    return createFileset('vision', basePath);
+  static forVisionTasks(basePath = '', useThreads = false):
+      Promise<WasmFileset> {
+    return createFileset('vision', basePath, useThreads);
   }
 }
 
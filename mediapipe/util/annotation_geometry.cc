@@ -0,0 +1,266 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/annotation_geometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mediapipe/util/color.pb.h"
+#include "mediapipe/util/render_data.pb.h"
+
+namespace mediapipe {
+namespace {
+
+float ClampThickness(double thickness) {
+  return std::max(1.0f, static_cast<float>(std::round(thickness)));
+}
+
+// Returns the number of segments of a circle or ellipse, enough to look round
+// at the given radius in pixels. It is a multiple of 4, so that the extremes
+// of the axes are vertices.
+int NumSegments(float radius) {
+  constexpr int kMinSegments = 8;
+  constexpr int kMaxSegments = 64;
+  const int num_segments = std::clamp(static_cast<int>(std::ceil(radius * 2)),
+                                      kMinSegments, kMaxSegments);
+  return (num_segments + 3) / 4 * 4;
+}
+
+}  // namespace
+
+// static
+bool AnnotationGeometry::CanTessellate(const RenderData& render_data) {
+  for (const auto& annotation : render_data.render_annotations()) {
+    switch (annotation.data_case()) {
+      case RenderAnnotation::kRectangle:
+      case RenderAnnotation::kFilledRectangle:
+      case RenderAnnotation::kOval:
+      case RenderAnnotation::kFilledOval:
+      case RenderAnnotation::kPoint:
+      case RenderAnnotation::kLine:
+      case RenderAnnotation::kGradientLine:
+      case RenderAnnotation::kScribble:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+void AnnotationGeometry::AddRenderData(const RenderData& render_data) {
+  for (const auto& annotation : render_data.render_annotations()) {
+    const Color& color = annotation.color();
+    const float thickness = ClampThickness(annotation.thickness());
+    switch (annotation.data_case()) {
+      case RenderAnnotation::kRectangle:
+        AddRectangle(annotation.rectangle(), thickness, /*filled=*/false,
+                     color);
+        break;
+      case RenderAnnotation::kFilledRectangle:
+        AddRectangle(annotation.filled_rectangle().rectangle(), thickness,
+                     /*filled=*/true, color);
+        break;
+      case RenderAnnotation::kOval:
+      case RenderAnnotation::kFilledOval: {
+        const bool filled =
+            annotation.data_case() == RenderAnnotation::kFilledOval;
+        const auto& rectangle =
+            filled ? annotation.filled_oval().oval().rectangle()
+                   : annotation.oval().rectangle();
+        const Point2 top_left = ToPixels(rectangle.left(), rectangle.top(),
+                                         rectangle.normalized());
+        const Point2 bottom_right = ToPixels(
+            rectangle.right(), rectangle.bottom(), rectangle.normalized());
+        AddEllipse({(top_left.x + bottom_right.x) / 2,
+                    (top_left.y + bottom_right.y) / 2},
+                   std::max(0.0f, (bottom_right.x - top_left.x) / 2),
+                   std::max(0.0f, (bottom_right.y - top_left.y) / 2),
+                   rectangle.rotation(), thickness, filled, color);
+        break;
+      }
+      case RenderAnnotation::kPoint: {
+        const auto& point = annotation.point();
+        AddDisk(ToPixels(point.x(), point.y(), point.normalized()), thickness,
+                color);
+        break;
+      }
+      case RenderAnnotation::kScribble:
+        for (const auto& point : annotation.scribble().point()) {
+          AddDisk(ToPixels(point.x(), point.y(), point.normalized()),
+                  thickness, color);
+        }
+        break;
+      case RenderAnnotation::kLine: {
+        const auto& line = annotation.line();
+        AddLine(ToPixels(line.x_start(), line.y_start(), line.normalized()),
+                ToPixels(line.x_end(), line.y_end(), line.normalized()),
+                thickness, color, color);
+        break;
+      }
+      case RenderAnnotation::kGradientLine: {
+        const auto& line = annotation.gradient_line();
+        AddLine(ToPixels(line.x_start(), line.y_start(), line.normalized()),
+                ToPixels(line.x_end(), line.y_end(), line.normalized()),
+                thickness, line.color1(), line.color2());
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
+AnnotationGeometry::Point2 AnnotationGeometry::ToPixels(double x, double y,
+                                                        bool normalized) const {
+  if (normalized) {
+    return {static_cast<float>(x * image_width_),
+            static_cast<float>(y * image_height_)};
+  }
+  return {static_cast<float>(x), static_cast<float>(y)};
+}
+
+void AnnotationGeometry::AddTriangle(Point2 a, Point2 b, Point2 c,
+                                     const Color& color) {
+  const float red = color.r();
+  const float green = color.g();
+  const float blue = color.b();
+  vertices_.push_back({a.x, a.y, red, green, blue});
+  vertices_.push_back({b.x, b.y, red, green, blue});
+  vertices_.push_back({c.x, c.y, red, green, blue});
+}
+
+void AnnotationGeometry::AddQuad(Point2 a, Point2 b, Point2 c, Point2 d,
+                                 const Color& color) {
+  AddTriangle(a, b, c, color);
+  AddTriangle(a, c, d, color);
+}
+
+void AnnotationGeometry::AddLine(Point2 start, Point2 end, float thickness,
+                                 const Color& start_color,
+                                 const Color& end_color) {
+  const float dx = end.x - start.x;
+  const float dy = end.y - start.y;
+  const float length = std::sqrt(dx * dx + dy * dy);
+  if (length < 1e-3f) {
+    AddDisk(start, thickness / 2, start_color);
+    return;
+  }
+  // Offset of the line edges from its center line.
+  const float nx = -dy / length * thickness / 2;
+  const float ny = dx / length * thickness / 2;
+  const AnnotationVertex a = {start.x + nx, start.y + ny,
+                              static_cast<float>(start_color.r()),
+                              static_cast<float>(start_color.g()),
+                              static_cast<float>(start_color.b())};
+  const AnnotationVertex b = {start.x - nx, start.y - ny, a.r, a.g, a.b};
+  const AnnotationVertex c = {end.x - nx, end.y - ny,
+                              static_cast<float>(end_color.r()),
+                              static_cast<float>(end_color.g()),
+                              static_cast<float>(end_color.b())};
+  const AnnotationVertex d = {end.x + nx, end.y + ny, c.r, c.g, c.b};
+  vertices_.insert(vertices_.end(), {a, b, c, a, c, d});
+}
+
+void AnnotationGeometry::AddDisk(Point2 center, float radius,
+                                 const Color& color) {
+  AddEllipse(center, radius, radius, /*rotation=*/0, /*thickness=*/0,
+             /*filled=*/true, color);
+}
+
+void AnnotationGeometry::AddEllipse(Point2 center, float radius_x,
+                                    float radius_y, float rotation,
+                                    float thickness, bool filled,
+                                    const Color& color) {
+  const float cos_rotation = std::cos(rotation);
+  const float sin_rotation = std::sin(rotation);
+  // Maps a point of the unrotated ellipse, relative to its center, to pixels.
+  auto to_image = [&](float x, float y) -> Point2 {
+    return {center.x + x * cos_rotation - y * sin_rotation,
+            center.y + x * sin_rotation + y * cos_rotation};
+  };
+  const int num_segments = NumSegments(std::max(radius_x, radius_y));
+  const float outer_x = filled ? radius_x : radius_x + thickness / 2;
+  const float outer_y = filled ? radius_y : radius_y + thickness / 2;
+  const float inner_x = std::max(0.0f, radius_x - thickness / 2);
+  const float inner_y = std::max(0.0f, radius_y - thickness / 2);
+  for (int i = 0; i < num_segments; ++i) {
+    const float angle0 = 2 * M_PI * i / num_segments;
+    const float angle1 = 2 * M_PI * (i + 1) / num_segments;
+    const float cos0 = std::cos(angle0);
+    const float sin0 = std::sin(angle0);
+    const float cos1 = std::cos(angle1);
+    const float sin1 = std::sin(angle1);
+    const Point2 outer0 = to_image(outer_x * cos0, outer_y * sin0);
+    const Point2 outer1 = to_image(outer_x * cos1, outer_y * sin1);
+    if (filled) {
+      AddTriangle(center, outer0, outer1, color);
+    } else {
+      AddQuad(outer0, outer1, to_image(inner_x * cos1, inner_y * sin1),
+              to_image(inner_x * cos0, inner_y * sin0), color);
+    }
+  }
+}
+
+void AnnotationGeometry::AddRectangle(
+    const RenderAnnotation::Rectangle& rectangle, float thickness,
+    bool filled, const Color& color) {
+  const Point2 top_left =
+      ToPixels(rectangle.left(), rectangle.top(), rectangle.normalized());
+  const Point2 bottom_right =
+      ToPixels(rectangle.right(), rectangle.bottom(), rectangle.normalized());
+  const Point2 center = {(top_left.x + bottom_right.x) / 2,
+                         (top_left.y + bottom_right.y) / 2};
+  const float half_width = (bottom_right.x - top_left.x) / 2;
+  const float half_height = (bottom_right.y - top_left.y) / 2;
+  const float cos_rotation = std::cos(rectangle.rotation());
+  const float sin_rotation = std::sin(rectangle.rotation());
+  // Maps a point of the unrotated rectangle, relative to its center, to
+  // pixels.
+  auto to_image = [&](float x, float y) -> Point2 {
+    return {center.x + x * cos_rotation - y * sin_rotation,
+            center.y + x * sin_rotation + y * cos_rotation};
+  };
+
+  if (filled) {
+    AddQuad(to_image(-half_width, -half_height),
+            to_image(half_width, -half_height),
+            to_image(half_width, half_height),
+            to_image(-half_width, half_height), color);
+  } else {
+    // A frame of four bands, centered on the rectangle outline.
+    const float outer_x = half_width + thickness / 2;
+    const float outer_y = half_height + thickness / 2;
+    const float inner_x = std::max(0.0f, half_width - thickness / 2);
+    const float inner_y = std::max(0.0f, half_height - thickness / 2);
+    const Point2 outer[4] = {
+        to_image(-outer_x, -outer_y), to_image(outer_x, -outer_y),
+        to_image(outer_x, outer_y), to_image(-outer_x, outer_y)};
+    const Point2 inner[4] = {
+        to_image(-inner_x, -inner_y), to_image(inner_x, -inner_y),
+        to_image(inner_x, inner_y), to_image(-inner_x, inner_y)};
+    for (int i = 0; i < 4; ++i) {
+      const int next = (i + 1) % 4;
+      AddQuad(outer[i], outer[next], inner[next], inner[i], color);
+    }
+  }
+
+  if (rectangle.has_top_left_thickness()) {
+    AddDisk(to_image(-half_width, -half_height),
+            ClampThickness(rectangle.top_left_thickness()), color);
+  }
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,95 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_ANNOTATION_GEOMETRY_H_
+#define MEDIAPIPE_UTIL_ANNOTATION_GEOMETRY_H_
+
+#include <vector>
+
+#include "mediapipe/util/render_data.pb.h"
+
+namespace mediapipe {
+
+// A vertex of the triangles that draw annotations. The position is in pixels
+// of the image, with the origin at its top-left corner, and the color is RGB
+// in [0, 255].
+struct AnnotationVertex {
+  float x;
+  float y;
+  float r;
+  float g;
+  float b;
+};
+
+// Tessellates annotations into a list of triangles, so that a GPU renderer can
+// draw all the annotations of a frame with one draw call instead of drawing
+// them on a CPU canvas. Shapes follow AnnotationRenderer, except that lines
+// have flat ends and gradients are interpolated.
+//
+// Points, scribbles, lines, gradient lines, rectangles, filled rectangles,
+// ovals and filled ovals are supported. Text, arrows and rounded rectangles
+// are not; see CanTessellate().
+//
+// Example usage:
+//
+// AnnotationGeometry geometry(image_width, image_height);
+// for (const RenderData& render_data : render_data_list) {
+//   if (!AnnotationGeometry::CanTessellate(render_data)) <fall back>;
+//   geometry.AddRenderData(render_data);
+// }
+// DrawTriangles(geometry.vertices());
+class AnnotationGeometry {
+ public:
+  AnnotationGeometry(int image_width, int image_height)
+      : image_width_(image_width), image_height_(image_height) {}
+
+  // Returns whether all the annotations of render_data are supported.
+  static bool CanTessellate(const RenderData& render_data);
+
+  // Appends the triangles of the supported annotations of render_data.
+  void AddRenderData(const RenderData& render_data);
+
+  // Returns the vertices of the triangles added so far, three per triangle, in
+  // drawing order.
+  const std::vector<AnnotationVertex>& vertices() const { return vertices_; }
+
+  // Removes all the triangles, keeping the vertex storage for reuse.
+  void Clear() { vertices_.clear(); }
+
+ private:
+  struct Point2 {
+    float x;
+    float y;
+  };
+
+  Point2 ToPixels(double x, double y, bool normalized) const;
+  void AddTriangle(Point2 a, Point2 b, Point2 c, const Color& color);
+  void AddQuad(Point2 a, Point2 b, Point2 c, Point2 d, const Color& color);
+  void AddLine(Point2 start, Point2 end, float thickness,
+               const Color& start_color, const Color& end_color);
+  void AddDisk(Point2 center, float radius, const Color& color);
+  void AddEllipse(Point2 center, float radius_x, float radius_y,
+                  float rotation, float thickness, bool filled,
+                  const Color& color);
+  void AddRectangle(const RenderAnnotation::Rectangle& rectangle,
+                    float thickness, bool filled, const Color& color);
+
+  const int image_width_;
+  const int image_height_;
+  std::vector<AnnotationVertex> vertices_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_ANNOTATION_GEOMETRY_H_
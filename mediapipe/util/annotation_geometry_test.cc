@@ -0,0 +1,146 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/annotation_geometry.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/util/render_data.pb.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FieldsAre;
+
+constexpr int kImageWidth = 200;
+constexpr int kImageHeight = 100;
+
+// Returns the bounding box of the vertices as {min_x, min_y, max_x, max_y}.
+std::vector<float> Bounds(const std::vector<AnnotationVertex>& vertices) {
+  std::vector<float> bounds = {vertices[0].x, vertices[0].y, vertices[0].x,
+                               vertices[0].y};
+  for (const AnnotationVertex& vertex : vertices) {
+    bounds[0] = std::min(bounds[0], vertex.x);
+    bounds[1] = std::min(bounds[1], vertex.y);
+    bounds[2] = std::max(bounds[2], vertex.x);
+    bounds[3] = std::max(bounds[3], vertex.y);
+  }
+  return bounds;
+}
+
+TEST(AnnotationGeometryTest, TessellatesFilledRectangle) {
+  AnnotationGeometry geometry(kImageWidth, kImageHeight);
+  geometry.AddRenderData(ParseTextProtoOrDie<RenderData>(R"pb(
+    render_annotations {
+      color { r: 255 g: 0 b: 10 }
+      filled_rectangle {
+        rectangle { left: 0.25 top: 0.5 right: 0.75 bottom: 1 normalized: true }
+      }
+    }
+  )pb"));
+
+  ASSERT_EQ(geometry.vertices().size(), 6);
+  EXPECT_THAT(Bounds(geometry.vertices()), ElementsAre(50, 50, 150, 100));
+  EXPECT_THAT(geometry.vertices()[0], FieldsAre(50, 50, 255, 0, 10));
+}
+
+TEST(AnnotationGeometryTest, TessellatesRectangleOutlineAroundEdges) {
+  AnnotationGeometry geometry(kImageWidth, kImageHeight);
+  geometry.AddRenderData(ParseTextProtoOrDie<RenderData>(R"pb(
+    render_annotations {
+      thickness: 4
+      rectangle { left: 10 top: 20 right: 110 bottom: 70 }
+    }
+  )pb"));
+
+  // Four bands of two triangles each.
+  ASSERT_EQ(geometry.vertices().size(), 24);
+  EXPECT_THAT(Bounds(geometry.vertices()), ElementsAre(8, 18, 112, 72));
+}
+
+TEST(AnnotationGeometryTest, TessellatesGradientLine) {
+  AnnotationGeometry geometry(kImageWidth, kImageHeight);
+  geometry.AddRenderData(ParseTextProtoOrDie<RenderData>(R"pb(
+    render_annotations {
+      thickness: 2
+      gradient_line {
+        x_start: 10
+        y_start: 10
+        x_end: 30
+        y_end: 10
+        color1 { r: 255 }
+        color2 { b: 255 }
+      }
+    }
+  )pb"));
+
+  ASSERT_EQ(geometry.vertices().size(), 6);
+  EXPECT_THAT(Bounds(geometry.vertices()), ElementsAre(10, 9, 30, 11));
+  for (const AnnotationVertex& vertex : geometry.vertices()) {
+    if (vertex.x == 10) {
+      EXPECT_THAT(vertex, FieldsAre(10, testing::_, 255, 0, 0));
+    } else {
+      EXPECT_THAT(vertex, FieldsAre(30, testing::_, 0, 0, 255));
+    }
+  }
+}
+
+TEST(AnnotationGeometryTest, TessellatesPointAsDiskOfThicknessRadius) {
+  AnnotationGeometry geometry(kImageWidth, kImageHeight);
+  geometry.AddRenderData(ParseTextProtoOrDie<RenderData>(R"pb(
+    render_annotations {
+      thickness: 5
+      point { x: 0.5 y: 0.5 normalized: true }
+    }
+  )pb"));
+
+  ASSERT_FALSE(geometry.vertices().empty());
+  EXPECT_EQ(geometry.vertices().size() % 3, 0);
+  const std::vector<float> bounds = Bounds(geometry.vertices());
+  EXPECT_NEAR(bounds[0], 95, 1e-3);
+  EXPECT_NEAR(bounds[1], 45, 1e-3);
+  EXPECT_NEAR(bounds[2], 105, 1e-3);
+  EXPECT_NEAR(bounds[3], 55, 1e-3);
+}
+
+TEST(AnnotationGeometryTest, ClearKeepsNothing) {
+  AnnotationGeometry geometry(kImageWidth, kImageHeight);
+  geometry.AddRenderData(ParseTextProtoOrDie<RenderData>(R"pb(
+    render_annotations { line { x_start: 0 y_start: 0 x_end: 5 y_end: 5 } }
+  )pb"));
+  EXPECT_FALSE(geometry.vertices().empty());
+  geometry.Clear();
+  EXPECT_TRUE(geometry.vertices().empty());
+}
+
+TEST(AnnotationGeometryTest, CannotTessellateText) {
+  EXPECT_TRUE(AnnotationGeometry::CanTessellate(ParseTextProtoOrDie<RenderData>(
+      R"pb(
+        render_annotations { point { x: 1 y: 1 } }
+        render_annotations { oval { rectangle { left: 1 right: 2 } } }
+      )pb")));
+  EXPECT_FALSE(
+      AnnotationGeometry::CanTessellate(ParseTextProtoOrDie<RenderData>(R"pb(
+        render_annotations { point { x: 1 y: 1 } }
+        render_annotations { text { display_text: "label" } }
+      )pb")));
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -129,6 +130,22 @@ void AnnotationRenderer::AdoptImage(cv::Mat* input_image) {
 
   // No pixel data copy here, only headers are copied.
   mat_image_ = *input_image;
+  dirty_rect_ = cv::Rect();
+}
+
+cv::Rect AnnotationRenderer::GetDirtyRect() const {
+  return dirty_rect_ & cv::Rect(0, 0, mat_image_.cols, mat_image_.rows);
+}
+
+void AnnotationRenderer::ResetDirtyRect() { dirty_rect_ = cv::Rect(); }
+
+void AnnotationRenderer::MarkDirty(const cv::Rect& rect, int margin) {
+  // Lines are drawn centered on their end points and anti-aliased shapes
+  // spill a pixel beyond their outline, hence the extra pixel.
+  const cv::Rect grown(rect.x - margin - 1, rect.y - margin - 1,
+                       rect.width + 2 * margin + 3,
+                       rect.height + 2 * margin + 3);
+  dirty_rect_ = dirty_rect_.empty() ? grown : (dirty_rect_ | grown);
 }
 
 int AnnotationRenderer::GetImageWidth() const { return mat_image_.cols; }
@@ -175,9 +192,12 @@ void AnnotationRenderer::DrawRectangle(const RenderAnnotation& annotation) {
       cv::line(mat_image_, vertices[i], vertices[(i + 1) % kNumVertices], color,
                thickness);
     }
+    MarkDirty(rect.boundingRect(), thickness);
   } else {
     cv::Rect rect(left, top, right - left, bottom - top);
     cv::rectangle(mat_image_, rect, color, thickness);
+    MarkDirty(cv::Rect(cv::Point(left, top), cv::Point(right, bottom)),
+              thickness);
   }
   if (rectangle.has_top_left_thickness()) {
     const auto& rect = RectangleToOpenCVRotatedRect(left, top, right, bottom,
@@ -190,6 +210,8 @@ void AnnotationRenderer::DrawRectangle(const RenderAnnotation& annotation) {
     cv::ellipse(mat_image_, vertices[1],
                 cv::Size(top_left_thickness, top_left_thickness), 0.0, 0, 360,
                 color, -1);
+    const cv::Point corner(vertices[1]);
+    MarkDirty(cv::Rect(corner, corner), top_left_thickness);
   }
 }
 
@@ -227,9 +249,11 @@ void AnnotationRenderer::DrawFilledRectangle(
       vertices[i] = vertices2f[i];
     }
     cv::fillConvexPoly(mat_image_, vertices, kNumVertices, color);
+    MarkDirty(rect.boundingRect(), 0);
   } else {
     cv::Rect rect(left, top, right - left, bottom - top);
     cv::rectangle(mat_image_, rect, color, -1);
+    MarkDirty(cv::Rect(cv::Point(left, top), cv::Point(right, bottom)), 0);
   }
 }
 
@@ -263,6 +287,8 @@ void AnnotationRenderer::DrawRoundedRectangle(
   DrawRoundedRectangle(mat_image_, cv::Point(left, top),
                        cv::Point(right, bottom), color, thickness, line_type,
                        corner_radius);
+  MarkDirty(cv::Rect(cv::Point(left, top), cv::Point(right, bottom)),
+            thickness);
 }
 
 void AnnotationRenderer::DrawFilledRoundedRectangle(
@@ -294,6 +320,7 @@ void AnnotationRenderer::DrawFilledRoundedRectangle(
   DrawRoundedRectangle(mat_image_, cv::Point(left, top),
                        cv::Point(right, bottom), color, -1, line_type,
                        corner_radius);
+  MarkDirty(cv::Rect(cv::Point(left, top), cv::Point(right, bottom)), 0);
 }
 
 void AnnotationRenderer::DrawRoundedRectangle(cv::Mat src, cv::Point top_left,
@@ -366,6 +393,10 @@ void AnnotationRenderer::DrawOval(const RenderAnnotation& annotation) {
   const int thickness =
       ClampThickness(round(annotation.thickness() * scale_factor_));
   cv::ellipse(mat_image_, center, size, rotation, 0, 360, color, thickness);
+  MarkDirty(cv::RotatedRect(center, cv::Size2f(2 * size.width, 2 * size.height),
+                            rotation)
+                .boundingRect(),
+            thickness);
 }
 
 void AnnotationRenderer::DrawFilledOval(const RenderAnnotation& annotation) {
@@ -394,6 +425,10 @@ void AnnotationRenderer::DrawFilledOval(const RenderAnnotation& annotation) {
   const double rotation = enclosing_rectangle.rotation() / M_PI * 180.f;
   const cv::Scalar color = MediapipeColorToOpenCVColor(annotation.color());
   cv::ellipse(mat_image_, center, size, rotation, 0, 360, color, -1);
+  MarkDirty(cv::RotatedRect(center, cv::Size2f(2 * size.width, 2 * size.height),
+                            rotation)
+                .boundingRect(),
+            0);
 }
 
 void AnnotationRenderer::DrawArrow(const RenderAnnotation& annotation) {
@@ -444,6 +479,10 @@ void AnnotationRenderer::DrawArrow(const RenderAnnotation& annotation) {
                                  static_cast<int>(round(arrowtip_right[1])));
   cv::line(mat_image_, arrowtip_left_start, arrow_end, color, thickness);
   cv::line(mat_image_, arrowtip_right_start, arrow_end, color, thickness);
+  MarkDirty(cv::boundingRect(std::vector<cv::Point>{arrow_start, arrow_end,
+                                                    arrowtip_left_start,
+                                                    arrowtip_right_start}),
+            thickness);
 }
 
 void AnnotationRenderer::DrawPoint(const RenderAnnotation& annotation) {
@@ -467,6 +506,7 @@ void AnnotationRenderer::DrawPoint(const RenderAnnotation::Point& point,
   const int thickness =
       ClampThickness(round(annotation.thickness() * scale_factor_));
   cv::circle(mat_image_, point_to_draw, thickness, color, -1);
+  MarkDirty(cv::Rect(point_to_draw, point_to_draw), thickness);
 }
 
 void AnnotationRenderer::DrawScribble(const RenderAnnotation& annotation) {
@@ -502,6 +542,7 @@ void AnnotationRenderer::DrawLine(const RenderAnnotation& annotation) {
   const int thickness =
       ClampThickness(round(annotation.thickness() * scale_factor_));
   cv::line(mat_image_, start, end, color, thickness);
+  MarkDirty(cv::Rect(start, end), thickness);
 }
 
 void AnnotationRenderer::DrawGradientLine(const RenderAnnotation& annotation) {
@@ -532,6 +573,7 @@ void AnnotationRenderer::DrawGradientLine(const RenderAnnotation& annotation) {
   const cv::Scalar color1 = MediapipeColorToOpenCVColor(line.color1());
   const cv::Scalar color2 = MediapipeColorToOpenCVColor(line.color2());
   cv_line2(mat_image_, start, end, color1, color2, thickness);
+  MarkDirty(cv::Rect(start, end), thickness);
 }
 
 void AnnotationRenderer::DrawText(const RenderAnnotation& annotation) {
@@ -569,6 +611,10 @@ void AnnotationRenderer::DrawText(const RenderAnnotation& annotation) {
     origin.y += text_size.height / 2;
   }
 
+  // Text extends text_size.height above the origin and text_baseline below
+  // it, or the other way around when flipped.
+  const int text_extent = text_size.height + text_baseline;
+  int outline_margin = thickness;
   if (text.outline_thickness() > 0.0) {
     const int background_thickness = ClampThickness(
         round((annotation.thickness() + 2.0 * text.outline_thickness()) *
@@ -578,10 +624,14 @@ void AnnotationRenderer::DrawText(const RenderAnnotation& annotation) {
     cv::putText(mat_image_, text.display_text(), origin, font_face, font_scale,
                 outline_color, background_thickness, /*lineType=*/8,
                 /*bottomLeftOrigin=*/flip_text_vertically_);
+    outline_margin = background_thickness;
   }
   cv::putText(mat_image_, text.display_text(), origin, font_face, font_scale,
               color, thickness, /*lineType=*/8,
               /*bottomLeftOrigin=*/flip_text_vertically_);
+  MarkDirty(cv::Rect(origin.x, origin.y - text_extent, text_size.width,
+                     2 * text_extent),
+            outline_margin);
 }
 
 double AnnotationRenderer::ComputeFontScale(int font_face, int font_size,
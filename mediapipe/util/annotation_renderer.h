@@ -78,6 +78,13 @@ class AnnotationRenderer {
   void SetScaleFactor(float scale_factor);
   float GetScaleFactor() { return scale_factor_; }
 
+  // Returns a bounding box, clipped to the image, of the pixels drawn since
+  // the last call to AdoptImage() or ResetDirtyRect(). The box may include
+  // pixels that were not drawn, but never misses a drawn pixel. Lets callers
+  // that keep an overlay across frames clear and upload only what changed.
+  cv::Rect GetDirtyRect() const;
+  void ResetDirtyRect();
+
  private:
   // Draws a rectangle on the image as described in the annotation.
   void DrawRectangle(const RenderAnnotation& annotation);
@@ -130,6 +137,9 @@ class AnnotationRenderer {
   // Computes the font scale from font_face, size and thickness.
   double ComputeFontScale(int font_face, int font_size, int thickness);
 
+  // Adds rect, grown by margin pixels on each side, to the dirty region.
+  void MarkDirty(const cv::Rect& rect, int margin);
+
   // Width and Height of the image (in pixels).
   int image_width_ = -1;
   int image_height_ = -1;
@@ -142,6 +152,9 @@ class AnnotationRenderer {
 
   // See SetScaleFactor(float)
   float scale_factor_ = 1.0;
+
+  // See GetDirtyRect().
+  cv::Rect dirty_rect_;
 };
 }  // namespace mediapipe
 
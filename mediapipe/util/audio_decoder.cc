@@ -559,7 +559,11 @@ absl::Status AudioPacketProcessor::AddAudioDataToBuffer(
   if (options_.output_regressing_timestamps() ||
       last_timestamp_ == Timestamp::Unset() ||
       output_timestamp > last_timestamp_) {
-    buffer_.push_back(Adopt(current_frame.release()).At(output_timestamp));
+    if (options_.output_chunk_samples() > 0) {
+      AddFrameToChunks(*current_frame);
+    } else {
+      buffer_.push_back(Adopt(current_frame.release()).At(output_timestamp));
+    }
     last_timestamp_ = output_timestamp;
     if (last_frame_time_regression_detected_) {
       last_frame_time_regression_detected_ = false;
@@ -578,6 +582,53 @@ absl::Status AudioPacketProcessor::AddAudioDataToBuffer(
   return absl::OkStatus();
 }
 
+void AudioPacketProcessor::AddFrameToChunks(const Matrix& frame) {
+  const int64_t chunk_samples = options_.output_chunk_samples();
+  if (chunk_num_samples_ > 0 &&
+      chunk_first_sample_number_ + chunk_num_samples_ !=
+          expected_sample_number_) {
+    // Don't merge samples across a gap or an overlap in the timestamps.
+    OutputChunk();
+  }
+  int64_t frame_offset = 0;
+  while (frame_offset < frame.cols()) {
+    if (!chunk_) {
+      chunk_ = absl::make_unique<Matrix>(num_channels_, chunk_samples);
+      chunk_num_samples_ = 0;
+      chunk_first_sample_number_ = expected_sample_number_ + frame_offset;
+    }
+    const int64_t num_samples = std::min<int64_t>(
+        chunk_samples - chunk_num_samples_, frame.cols() - frame_offset);
+    chunk_->middleCols(chunk_num_samples_, num_samples) =
+        frame.middleCols(frame_offset, num_samples);
+    chunk_num_samples_ += num_samples;
+    frame_offset += num_samples;
+    if (chunk_num_samples_ == chunk_samples) {
+      OutputChunk();
+    }
+  }
+}
+
+void AudioPacketProcessor::OutputChunk() {
+  if (!chunk_ || chunk_num_samples_ == 0) {
+    return;
+  }
+  if (chunk_num_samples_ < chunk_->cols()) {
+    chunk_->conservativeResize(Eigen::NoChange, chunk_num_samples_);
+  }
+  buffer_.push_back(
+      Adopt(chunk_.release())
+          .At(Timestamp(av_rescale_q(chunk_first_sample_number_,
+                                     sample_time_base_, output_time_base_))));
+  chunk_num_samples_ = 0;
+}
+
+absl::Status AudioPacketProcessor::Flush() {
+  MP_RETURN_IF_ERROR(BasePacketProcessor::Flush());
+  OutputChunk();
+  return absl::OkStatus();
+}
+
 absl::Status AudioPacketProcessor::FillHeader(TimeSeriesHeader* header) const {
   ABSL_CHECK(header);
   header->set_sample_rate(sample_rate_);
@@ -689,6 +740,19 @@ absl::Status AudioDecoder::Initialize(
   if (options.has_end_time()) {
     end_time_ = Timestamp::FromSeconds(options.end_time());
   }
+  if (options.seek_to_start_time() && options.start_time() > 0) {
+    // Timestamps in AV_TIME_BASE units, which are microseconds.
+    const int64_t seek_timestamp = start_time_.Microseconds();
+    int ret = avformat_seek_file(avformat_ctx_, /*stream_index=*/-1,
+                                 INT64_MIN, seek_timestamp, seek_timestamp,
+                                 /*flags=*/0);
+    if (ret < 0) {
+      ABSL_LOG(WARNING) << "Could not seek to start time " << start_time_
+                        << " in file " << input_file << ": "
+                        << AvErrorToString(ret)
+                        << ". Decoding from the beginning.";
+    }
+  }
   is_first_packet_.resize(avformat_ctx_->nb_streams, true);
 
   decoder_closer.release();
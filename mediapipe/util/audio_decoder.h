@@ -17,11 +17,13 @@
 
 #include <cstdint>  // required by avutil.h
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/time/time.h"
+#include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/formats/time_series_header.pb.h"
 #include "mediapipe/framework/packet.h"
 #include "mediapipe/framework/port/integral_types.h"
@@ -65,7 +67,7 @@ class BasePacketProcessor {
 
   // Once no more AVPackets are available in the file, each stream must
   // be flushed to get any remaining frames which the codec is buffering.
-  absl::Status Flush();
+  virtual absl::Status Flush();
 
   // Closes the Processor, this does not close the file.  You may not
   // call ProcessPacket() after calling Close().  Close() may be called
@@ -138,12 +140,23 @@ class AudioPacketProcessor : public BasePacketProcessor {
 
   absl::Status FillHeader(TimeSeriesHeader* header) const;
 
+  // Flushes the codec, and then outputs the partially filled chunk, if any.
+  absl::Status Flush() override;
+
  private:
   // Appends audio in buffer(s) to the output buffer (buffer_).
   absl::Status AddAudioDataToBuffer(const Timestamp output_timestamp,
                                     uint8* const* raw_audio,
                                     int buf_size_bytes);
 
+  // Appends the samples of a decoded frame, which starts at sample number
+  // expected_sample_number_, to the chunks being filled, and outputs each
+  // chunk that is full.
+  void AddFrameToChunks(const Matrix& frame);
+
+  // Outputs the chunk being filled, if it has any samples.
+  void OutputChunk();
+
   // Converts a number of samples into an approximate stream timestamp value.
   int64 SampleNumberToTimestamp(const int64 sample_number);
   int64 TimestampToSampleNumber(const int64 timestamp);
@@ -182,6 +195,12 @@ class AudioPacketProcessor : public BasePacketProcessor {
   // The expected sample number based on counting samples.
   int64 expected_sample_number_ = 0;
 
+  // The chunk being filled when options_.output_chunk_samples() is positive,
+  // its number of samples, and the sample number of its first sample.
+  std::unique_ptr<Matrix> chunk_;
+  int64 chunk_num_samples_ = 0;
+  int64 chunk_first_sample_number_ = 0;
+
   // Options for the processor.
   AudioStreamOptions options_;
 };
@@ -16,6 +16,10 @@
 
 #include <cmath>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #ifdef __ANDROID__
 #include "ndk/sources/android/cpufeatures/cpu-features.h"
 #elif _WIN32
@@ -126,4 +130,17 @@ std::set<int> InferHigherCoreIds() {
   return InferLowerOrHigherCoreIds(/* lower= */ false);
 }
 
+bool SetCurrentThreadCpuIds(const std::set<int>& cpu_ids) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const int cpu : cpu_ids) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  return sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace mediapipe.
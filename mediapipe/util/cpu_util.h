@@ -24,6 +24,10 @@ int NumCPUCores();
 std::set<int> InferLowerCoreIds();
 // Returns a set of inferred CPU ids of higher cores.
 std::set<int> InferHigherCoreIds();
+// Restricts the calling thread to run on the given CPU ids. Returns false if
+// processor affinity isn't supported on the current platform or couldn't be
+// set.
+bool SetCurrentThreadCpuIds(const std::set<int>& cpu_ids);
 }  // namespace mediapipe
 
 #endif  // MEDIAPIPE_UTIL_CPU_UTIL_H_
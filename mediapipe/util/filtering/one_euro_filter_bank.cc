@@ -0,0 +1,206 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/filtering/one_euro_filter_bank.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "absl/log/absl_check.h"
+#include "absl/log/absl_log.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace mediapipe {
+
+namespace {
+
+constexpr double kEpsilon = 0.000001;
+constexpr float kTwoPi = 2.0f * M_PI;
+
+}  // namespace
+
+OneEuroFilterBank::OneEuroFilterBank(int size, double frequency,
+                                     double min_cutoff, double beta,
+                                     double derivate_cutoff)
+    : frequency_(frequency),
+      min_cutoff_(min_cutoff),
+      beta_(beta),
+      derivate_cutoff_(derivate_cutoff),
+      raw_values_(size),
+      filtered_values_(size),
+      filtered_derivates_(size) {
+  if (frequency <= kEpsilon) {
+    ABSL_LOG(ERROR) << "frequency should be > 0";
+  }
+  if (min_cutoff <= kEpsilon) {
+    ABSL_LOG(ERROR) << "min_cutoff should be > 0";
+  }
+  if (derivate_cutoff <= kEpsilon) {
+    ABSL_LOG(ERROR) << "derivate_cutoff should be > 0";
+  }
+}
+
+void OneEuroFilterBank::Apply(absl::Duration timestamp, float value_scale,
+                              absl::Span<float> values) {
+  ABSL_CHECK_EQ(values.size(), raw_values_.size());
+  const int64_t new_timestamp = absl::ToInt64Nanoseconds(timestamp);
+  if (initialized_ && last_time_ >= new_timestamp) {
+    // Results are unpredictable in this case, so nothing to do but
+    // return same values.
+    ABSL_LOG(WARNING) << "New timestamp is equal or less than the last one.";
+    return;
+  }
+
+  if (!initialized_) {
+    // The first values are returned as is, with a derivate of 0.
+    for (int i = 0; i < values.size(); ++i) {
+      raw_values_[i] = values[i];
+      filtered_values_[i] = values[i];
+      filtered_derivates_[i] = 0.0f;
+    }
+    initialized_ = true;
+    last_time_ = new_timestamp;
+    return;
+  }
+
+  // Update the sampling frequency based on timestamps.
+  if (last_time_ != 0 && new_timestamp != 0) {
+    static constexpr double kNanoSecondsToSecond = 1e-9;
+    frequency_ = 1.0 / ((new_timestamp - last_time_) * kNanoSecondsToSecond);
+  }
+  last_time_ = new_timestamp;
+
+  // For a cutoff frequency fc, the smoothing factor of the low pass filters is
+  // 1 / (1 + frequency / (2 * pi * fc)).
+  const float derivate_alpha =
+      1.0 / (1.0 + frequency_ / (2.0 * M_PI * derivate_cutoff_));
+  const float derivate_scale = value_scale * frequency_;
+  const float frequency = frequency_;
+
+  float* raw = raw_values_.data();
+  float* filtered = filtered_values_.data();
+  float* derivates = filtered_derivates_.data();
+  float* out = values.data();
+  const int size = values.size();
+  int i = 0;
+#if defined(__AVX2__)
+  const __m256 a_d = _mm256_set1_ps(derivate_alpha);
+  const __m256 one_minus_a_d = _mm256_set1_ps(1.0f - derivate_alpha);
+  const __m256 d_scale = _mm256_set1_ps(derivate_scale);
+  const __m256 min_cutoff = _mm256_set1_ps(min_cutoff_);
+  const __m256 beta = _mm256_set1_ps(beta_);
+  const __m256 two_pi = _mm256_set1_ps(kTwoPi);
+  const __m256 freq = _mm256_set1_ps(frequency);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+  for (; i + 8 <= size; i += 8) {
+    const __m256 v = _mm256_loadu_ps(out + i);
+    const __m256 dv =
+        _mm256_mul_ps(_mm256_sub_ps(v, _mm256_loadu_ps(raw + i)), d_scale);
+    const __m256 edv = _mm256_add_ps(
+        _mm256_mul_ps(a_d, dv),
+        _mm256_mul_ps(one_minus_a_d, _mm256_loadu_ps(derivates + i)));
+    const __m256 abs_edv = _mm256_andnot_ps(sign_mask, edv);
+    const __m256 cutoff = _mm256_mul_ps(
+        two_pi, _mm256_add_ps(min_cutoff, _mm256_mul_ps(beta, abs_edv)));
+    const __m256 a = _mm256_div_ps(cutoff, _mm256_add_ps(cutoff, freq));
+    const __m256 result =
+        _mm256_add_ps(_mm256_mul_ps(a, v),
+                      _mm256_mul_ps(_mm256_sub_ps(one, a),
+                                    _mm256_loadu_ps(filtered + i)));
+    _mm256_storeu_ps(raw + i, v);
+    _mm256_storeu_ps(derivates + i, edv);
+    _mm256_storeu_ps(filtered + i, result);
+    _mm256_storeu_ps(out + i, result);
+  }
+#elif defined(__SSE2__)
+  const __m128 a_d = _mm_set1_ps(derivate_alpha);
+  const __m128 one_minus_a_d = _mm_set1_ps(1.0f - derivate_alpha);
+  const __m128 d_scale = _mm_set1_ps(derivate_scale);
+  const __m128 min_cutoff = _mm_set1_ps(min_cutoff_);
+  const __m128 beta = _mm_set1_ps(beta_);
+  const __m128 two_pi = _mm_set1_ps(kTwoPi);
+  const __m128 freq = _mm_set1_ps(frequency);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  for (; i + 4 <= size; i += 4) {
+    const __m128 v = _mm_loadu_ps(out + i);
+    const __m128 dv = _mm_mul_ps(_mm_sub_ps(v, _mm_loadu_ps(raw + i)), d_scale);
+    const __m128 edv =
+        _mm_add_ps(_mm_mul_ps(a_d, dv),
+                   _mm_mul_ps(one_minus_a_d, _mm_loadu_ps(derivates + i)));
+    const __m128 abs_edv = _mm_andnot_ps(sign_mask, edv);
+    const __m128 cutoff = _mm_mul_ps(
+        two_pi, _mm_add_ps(min_cutoff, _mm_mul_ps(beta, abs_edv)));
+    const __m128 a = _mm_div_ps(cutoff, _mm_add_ps(cutoff, freq));
+    const __m128 result = _mm_add_ps(
+        _mm_mul_ps(a, v),
+        _mm_mul_ps(_mm_sub_ps(one, a), _mm_loadu_ps(filtered + i)));
+    _mm_storeu_ps(raw + i, v);
+    _mm_storeu_ps(derivates + i, edv);
+    _mm_storeu_ps(filtered + i, result);
+    _mm_storeu_ps(out + i, result);
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const float32x4_t a_d = vdupq_n_f32(derivate_alpha);
+  const float32x4_t one_minus_a_d = vdupq_n_f32(1.0f - derivate_alpha);
+  const float32x4_t d_scale = vdupq_n_f32(derivate_scale);
+  const float32x4_t min_cutoff = vdupq_n_f32(min_cutoff_);
+  const float32x4_t beta = vdupq_n_f32(beta_);
+  const float32x4_t two_pi = vdupq_n_f32(kTwoPi);
+  const float32x4_t freq = vdupq_n_f32(frequency);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  for (; i + 4 <= size; i += 4) {
+    const float32x4_t v = vld1q_f32(out + i);
+    const float32x4_t dv = vmulq_f32(vsubq_f32(v, vld1q_f32(raw + i)), d_scale);
+    const float32x4_t edv =
+        vaddq_f32(vmulq_f32(a_d, dv),
+                  vmulq_f32(one_minus_a_d, vld1q_f32(derivates + i)));
+    const float32x4_t cutoff = vmulq_f32(
+        two_pi, vaddq_f32(min_cutoff, vmulq_f32(beta, vabsq_f32(edv))));
+    const float32x4_t a = vdivq_f32(cutoff, vaddq_f32(cutoff, freq));
+    const float32x4_t result =
+        vaddq_f32(vmulq_f32(a, v),
+                  vmulq_f32(vsubq_f32(one, a), vld1q_f32(filtered + i)));
+    vst1q_f32(raw + i, v);
+    vst1q_f32(derivates + i, edv);
+    vst1q_f32(filtered + i, result);
+    vst1q_f32(out + i, result);
+  }
+#endif
+  for (; i < size; ++i) {
+    const float v = out[i];
+    const float dv = (v - raw[i]) * derivate_scale;
+    const float edv =
+        derivate_alpha * dv + (1.0f - derivate_alpha) * derivates[i];
+    const float cutoff = kTwoPi * (min_cutoff_ + beta_ * std::fabs(edv));
+    const float a = cutoff / (cutoff + frequency);
+    const float result = a * v + (1.0f - a) * filtered[i];
+    raw[i] = v;
+    derivates[i] = edv;
+    filtered[i] = result;
+    out[i] = result;
+  }
+}
+
+}  // namespace mediapipe
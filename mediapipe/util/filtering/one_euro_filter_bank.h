@@ -0,0 +1,61 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_FILTERING_ONE_EURO_FILTER_BANK_H_
+#define MEDIAPIPE_UTIL_FILTERING_ONE_EURO_FILTER_BANK_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+
+namespace mediapipe {
+
+// A bank of OneEuroFilters with the same parameters that filter a fixed number
+// of values sampled at the same timestamps, e.g. all the coordinates of a
+// landmark list.
+//
+// The state of the filters is kept in contiguous arrays, and Apply() updates
+// all of them in a single vectorized pass. The values are filtered in float
+// precision, so the results may differ slightly from those of OneEuroFilter.
+class OneEuroFilterBank {
+ public:
+  OneEuroFilterBank(int size, double frequency, double min_cutoff, double beta,
+                    double derivate_cutoff);
+
+  // Filters `values`, which must have `size()` elements, in place.
+  void Apply(absl::Duration timestamp, float value_scale,
+             absl::Span<float> values);
+
+  // Returns the number of values filtered by the bank.
+  int size() const { return raw_values_.size(); }
+
+ private:
+  double frequency_;
+  float min_cutoff_;
+  float beta_;
+  double derivate_cutoff_;
+  bool initialized_ = false;
+  int64_t last_time_;
+
+  // The last raw value, filtered value and filtered derivate of each filter.
+  std::vector<float> raw_values_;
+  std::vector<float> filtered_values_;
+  std::vector<float> filtered_derivates_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_FILTERING_ONE_EURO_FILTER_BANK_H_
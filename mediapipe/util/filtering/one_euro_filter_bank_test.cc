@@ -0,0 +1,91 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/filtering/one_euro_filter_bank.h"
+
+#include <cmath>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/util/filtering/one_euro_filter.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr double kFrequency = 30.0;
+constexpr double kMinCutoff = 0.05;
+constexpr double kBeta = 80.0;
+constexpr double kDerivateCutoff = 1.0;
+
+TEST(OneEuroFilterBankTest, MatchesOneEuroFilters) {
+  // Covers the vector loops and the remaining values.
+  constexpr int kNumValues = 37;
+  constexpr float kValueScale = 0.5f;
+  OneEuroFilterBank bank(kNumValues, kFrequency, kMinCutoff, kBeta,
+                         kDerivateCutoff);
+  std::vector<OneEuroFilter> filters;
+  for (int i = 0; i < kNumValues; ++i) {
+    filters.emplace_back(kFrequency, kMinCutoff, kBeta, kDerivateCutoff);
+  }
+
+  for (int frame = 0; frame < 20; ++frame) {
+    const absl::Duration timestamp = absl::Milliseconds(33 * frame + frame % 3);
+    std::vector<float> values(kNumValues);
+    std::vector<float> expected(kNumValues);
+    for (int i = 0; i < kNumValues; ++i) {
+      values[i] = std::sin(0.3f * frame + i) * (i % 4 + 1);
+      expected[i] = filters[i].Apply(timestamp, kValueScale, values[i]);
+    }
+
+    bank.Apply(timestamp, kValueScale, absl::MakeSpan(values));
+
+    for (int i = 0; i < kNumValues; ++i) {
+      EXPECT_NEAR(values[i], expected[i], 1e-4) << frame << " " << i;
+    }
+  }
+}
+
+TEST(OneEuroFilterBankTest, ReturnsFirstValuesAsIs) {
+  OneEuroFilterBank bank(3, kFrequency, kMinCutoff, kBeta, kDerivateCutoff);
+  std::vector<float> values = {1.0f, -2.0f, 3.0f};
+
+  bank.Apply(absl::Milliseconds(10), 1.0f, absl::MakeSpan(values));
+
+  EXPECT_EQ(bank.size(), 3);
+  EXPECT_EQ(values, std::vector<float>({1.0f, -2.0f, 3.0f}));
+}
+
+TEST(OneEuroFilterBankTest, IgnoresNonIncreasingTimestamps) {
+  OneEuroFilterBank bank(2, kFrequency, kMinCutoff, kBeta, kDerivateCutoff);
+  std::vector<float> values = {1.0f, 2.0f};
+  bank.Apply(absl::Milliseconds(10), 1.0f, absl::MakeSpan(values));
+
+  values = {5.0f, 6.0f};
+  bank.Apply(absl::Milliseconds(10), 1.0f, absl::MakeSpan(values));
+  EXPECT_EQ(values, std::vector<float>({5.0f, 6.0f}));
+
+  // The filter state is unchanged, so the next values are smoothed with the
+  // first ones.
+  values = {5.0f, 6.0f};
+  bank.Apply(absl::Milliseconds(43), 1.0f, absl::MakeSpan(values));
+  EXPECT_LT(values[0], 5.0f);
+  EXPECT_GT(values[0], 1.0f);
+  EXPECT_LT(values[1], 6.0f);
+  EXPECT_GT(values[1], 2.0f);
+}
+
+}  // namespace
+}  // namespace mediapipe
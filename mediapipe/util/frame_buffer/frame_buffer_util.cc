@@ -14,13 +14,17 @@
 
 #include "mediapipe/util/frame_buffer/frame_buffer_util.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "HalideRuntime.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/formats/frame_buffer.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/status_macros.h"
@@ -525,6 +529,66 @@ absl::Status ConvertYuv(const FrameBuffer& buffer, FrameBuffer* output_buffer) {
              : absl::UnknownError("Halide YUV convert operation failed.");
 }
 
+// Halide parallel loops.
+//------------------------------------------------------------------------------
+
+std::atomic<ThreadPool*> halide_thread_pool{nullptr};
+
+// The state of a parallel loop, shared with the thread pool callbacks. These
+// may start after the loop is done, so they don't refer to the loop itself.
+struct ParallelLoop {
+  void* user_context;
+  halide_task_t task;
+  uint8_t* closure;
+  int end;
+  std::atomic<int> next;
+  absl::Mutex mutex;
+  int remaining ABSL_GUARDED_BY(mutex);
+  int result ABSL_GUARDED_BY(mutex) = 0;
+};
+
+// Runs the iterations of the loop not yet claimed by another thread.
+void RunLoopIterations(ParallelLoop* loop) {
+  for (int i = loop->next++; i < loop->end; i = loop->next++) {
+    const int result = loop->task(loop->user_context, i, loop->closure);
+    absl::MutexLock lock(&loop->mutex);
+    if (result != 0 && loop->result == 0) {
+      loop->result = result;
+    }
+    --loop->remaining;
+  }
+}
+
+// Implements halide_do_par_for on the thread pool set by SetThreadPool. The
+// calling thread only waits for iterations that are already running, so that
+// loops started from threads of the pool itself don't deadlock.
+int DoParallelFor(void* user_context, halide_task_t task, int min, int size,
+                  uint8_t* closure) {
+  ThreadPool* thread_pool = halide_thread_pool.load();
+  if (thread_pool == nullptr) {
+    return halide_default_do_par_for(user_context, task, min, size, closure);
+  }
+  auto loop = std::make_shared<ParallelLoop>();
+  loop->user_context = user_context;
+  loop->task = task;
+  loop->closure = closure;
+  loop->end = min + size;
+  loop->next = min;
+  {
+    absl::MutexLock lock(&loop->mutex);
+    loop->remaining = size;
+  }
+  const int num_helpers = std::min(size, thread_pool->num_threads() + 1) - 1;
+  for (int i = 0; i < num_helpers; ++i) {
+    thread_pool->Schedule([loop]() { RunLoopIterations(loop.get()); });
+  }
+  RunLoopIterations(loop.get());
+  absl::MutexLock lock(&loop->mutex);
+  loop->mutex.Await(absl::Condition(
+      +[](int* remaining) { return *remaining == 0; }, &loop->remaining));
+  return loop->result;
+}
+
 }  // namespace
 
 // Public methods.
@@ -852,5 +916,10 @@ FrameBuffer::Dimension GetCropDimension(int x0, int x1, int y0, int y1) {
   return {x1 - x0 + 1, y1 - y0 + 1};
 }
 
+void SetThreadPool(ThreadPool* thread_pool) {
+  halide_thread_pool.store(thread_pool);
+  halide_set_custom_do_par_for(&DoParallelFor);
+}
+
 }  // namespace frame_buffer
 }  // namespace mediapipe
@@ -22,6 +22,7 @@
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/formats/frame_buffer.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/threadpool.h"
 
 namespace mediapipe {
 namespace frame_buffer {
@@ -107,6 +108,16 @@ absl::Status Convert(const FrameBuffer& buffer, FrameBuffer* output_buffer);
 absl::Status ToFloatTensor(const FrameBuffer& buffer, float scale, float offset,
                            Tensor& tensor);
 
+// Threading.
+//------------------------------------------------------------------------------
+
+// Runs the parallel loops of the operations above on `thread_pool`, instead of
+// the Halide runtime's own thread pool. The calling thread runs part of each
+// loop as well. This applies to the whole process, since the Halide runtime
+// is shared. The pool must outlive any operation in flight, until this is
+// called again with nullptr to go back to the Halide runtime's thread pool.
+void SetThreadPool(ThreadPool* thread_pool);
+
 // Miscellaneous Methods
 // -----------------------------------------------------------------
 
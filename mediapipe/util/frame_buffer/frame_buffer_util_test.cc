@@ -25,6 +25,7 @@
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/framework/port/threadpool.h"
 
 namespace mediapipe {
 namespace frame_buffer {
@@ -719,6 +720,34 @@ TEST(FrameBufferUtil, RgbResize) {
   }
 }
 
+TEST(FrameBufferUtil, RgbResizeOnThreadPool) {
+  // Tall enough for the rows to be resized by several parallel tasks.
+  constexpr FrameBuffer::Dimension kBufferDimension = {.width = 8,
+                                                       .height = 64},
+                                   kResizeDimension = {.width = 5,
+                                                       .height = 100};
+  std::vector<uint8_t> input_data(8 * 64 * 3);
+  for (int i = 0; i < input_data.size(); ++i) {
+    input_data[i] = i % 251;
+  }
+  auto input = CreateFromRgbRawBuffer(input_data.data(), kBufferDimension);
+  std::vector<uint8_t> expected_data(5 * 100 * 3);
+  auto expected =
+      CreateFromRgbRawBuffer(expected_data.data(), kResizeDimension);
+  MP_ASSERT_OK(Resize(*input, expected.get()));
+
+  ThreadPool thread_pool(4);
+  thread_pool.StartWorkers();
+  SetThreadPool(&thread_pool);
+  std::vector<uint8_t> output_data(5 * 100 * 3);
+  auto output = CreateFromRgbRawBuffer(output_data.data(), kResizeDimension);
+  const absl::Status status = Resize(*input, output.get());
+  SetThreadPool(nullptr);
+
+  MP_ASSERT_OK(status);
+  EXPECT_EQ(output_data, expected_data);
+}
+
 TEST(FrameBufferUtil, RgbaRotate) {
   constexpr FrameBuffer::Dimension kBufferDimension = {.width = 3, .height = 2},
                                    kRotatedDimension = {.width = 2,
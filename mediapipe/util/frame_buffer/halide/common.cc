@@ -83,6 +83,12 @@ void rotate(Halide::Func input, Halide::Func result, Halide::Expr width,
              result_270_degrees(x, y, _), input(x, y, _));
 }
 
+void parallelize_rows(Halide::Func result, Halide::Var y, int rows_per_task) {
+  // GuardWithIf rather than ShiftInwards, so that images shorter than a strip
+  // are still supported.
+  result.parallel(y, rows_per_task, Halide::TailStrategy::GuardWithIf);
+}
+
 }  // namespace common
 }  // namespace halide
 }  // namespace frame_buffer
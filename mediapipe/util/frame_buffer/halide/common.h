@@ -53,6 +53,12 @@ void resize_bilinear_int(Halide::Func input, Halide::Func result,
 void rotate(Halide::Func input, Halide::Func result, Halide::Expr width,
             Halide::Expr height, Halide::Expr angle);
 
+// Schedules the rows y of result to be computed in parallel, in strips of
+// rows_per_task rows. Must be called before specializing the schedule, so
+// that every specialization runs in parallel.
+void parallelize_rows(Halide::Func result, Halide::Var y,
+                      int rows_per_task = 16);
+
 }  // namespace common
 }  // namespace halide
 }  // namespace frame_buffer
@@ -18,6 +18,7 @@
 namespace {
 
 using ::Halide::BoundaryConditions::repeat_edge;
+using ::mediapipe::frame_buffer::halide::common::parallelize_rows;
 using ::mediapipe::frame_buffer::halide::common::resize_bilinear_int;
 
 class GrayResize : public Halide::Generator<GrayResize> {
@@ -52,6 +53,7 @@ void GrayResize::schedule() {
   const int vector_size = natural_vector_size<uint8_t>();
   Halide::Expr min_y_width =
       Halide::min(src_y.dim(0).extent(), dst_y_output.dim(0).extent());
+  parallelize_rows(dst_y_func, y);
   dst_y_func.specialize(min_y_width >= vector_size).vectorize(x, vector_size);
 }
 
@@ -13,9 +13,12 @@
 // limitations under the License.
 
 #include "Halide.h"
+#include "mediapipe/util/frame_buffer/halide/common.h"
 
 namespace {
 
+using ::mediapipe::frame_buffer::halide::common::parallelize_rows;
+
 class RgbFloat : public Halide::Generator<RgbFloat> {
  public:
   Var x{"x"}, y{"y"}, c{"c"};
@@ -34,6 +37,10 @@ void RgbFloat::generate() {
 }
 
 void RgbFloat::schedule() {
+  Halide::Func dst_float_func = dst_float;
+  dst_float_func.reorder(c, x, y);
+  parallelize_rows(dst_float_func, y);
+
   Halide::Expr input_rgb_channels = src_rgb.dim(2).extent();
   Halide::Expr output_float_channels = dst_float.dim(2).extent();
 
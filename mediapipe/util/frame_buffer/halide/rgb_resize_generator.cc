@@ -18,6 +18,7 @@
 namespace {
 
 using ::Halide::BoundaryConditions::repeat_edge;
+using ::mediapipe::frame_buffer::halide::common::parallelize_rows;
 using ::mediapipe::frame_buffer::halide::common::resize_bilinear_int;
 
 class RgbResize : public Halide::Generator<RgbResize> {
@@ -57,6 +58,7 @@ void RgbResize::schedule() {
       input_rgb_channels == 4 && output_rgb_channels == 4,
   };
   dst_rgb_func.reorder(c, x, y);
+  parallelize_rows(dst_rgb_func, y);
   for (const Expr& channel_specialization : channel_specializations) {
     dst_rgb_func.specialize(channel_specialization && min_width >= vector_size)
         .unroll(c)
@@ -20,6 +20,7 @@ namespace {
 using ::Halide::BoundaryConditions::repeat_edge;
 using ::mediapipe::frame_buffer::halide::common::is_interleaved;
 using ::mediapipe::frame_buffer::halide::common::is_planar;
+using ::mediapipe::frame_buffer::halide::common::parallelize_rows;
 using ::mediapipe::frame_buffer::halide::common::resize_bilinear_int;
 
 class YuvResize : public Halide::Generator<YuvResize> {
@@ -70,6 +71,7 @@ void YuvResize::schedule() {
   const int vector_size = natural_vector_size<uint8_t>();
   Halide::Expr min_y_width =
       Halide::min(src_y.dim(0).extent(), dst_y_output.dim(0).extent());
+  parallelize_rows(dst_y_func, y);
   dst_y_func.specialize(min_y_width >= vector_size).vectorize(x, vector_size);
 
   // Remove default memory layout constraints and generate specialized
@@ -79,6 +81,7 @@ void YuvResize::schedule() {
   dst_uv_output.dim(0).set_stride(Expr());
 
   Halide::Var c = dst_uv_func.args()[2];
+  parallelize_rows(dst_uv_func, y);
   dst_uv_func
       .specialize(is_interleaved(src_uv) && is_interleaved(dst_uv_output))
       .reorder(c, x, y)
@@ -13,9 +13,12 @@
 // limitations under the License.
 
 #include "Halide.h"
+#include "mediapipe/util/frame_buffer/halide/common.h"
 
 namespace {
 
+using ::mediapipe::frame_buffer::halide::common::parallelize_rows;
+
 class YuvRgb : public Halide::Generator<YuvRgb> {
  public:
   Var x{"x"}, y{"y"}, c{"c"};
@@ -90,6 +93,7 @@ void YuvRgb::schedule() {
   // Specialize the generated code for RGB and RGBA.
   const int vector_size = natural_vector_size<uint8_t>();
   rgb_func.reorder(c, x, y);
+  parallelize_rows(rgb_func, y);
   rgb_func.specialize(rgb_channels == 3).unroll(c).vectorize(x, vector_size);
   rgb_func.specialize(rgb_channels == 4).unroll(c).vectorize(x, vector_size);
 
@@ -0,0 +1,76 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/mapped_file_contents.h"
+
+#include "absl/base/config.h"
+
+#ifdef ABSL_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // ABSL_HAVE_MMAP
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/status_macros.h"
+
+namespace mediapipe {
+
+// static
+absl::StatusOr<std::unique_ptr<MappedFileContents>> MappedFileContents::Open(
+    const std::string& path) {
+  auto contents = absl::WrapUnique(new MappedFileContents());
+#ifdef ABSL_HAVE_MMAP
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::NotFoundError(absl::StrCat("Can't open file: ", path));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return absl::InternalError(absl::StrCat("Can't stat file: ", path));
+  }
+  // mmap fails for empty files, which simply have no contents.
+  if (file_stat.st_size > 0) {
+    void* data = mmap(/*addr=*/nullptr, file_stat.st_size, PROT_READ,
+                      MAP_SHARED, fd, /*offset=*/0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      return absl::InternalError(absl::StrCat("Can't map file: ", path));
+    }
+    contents->data_ = static_cast<const char*>(data);
+    contents->size_ = file_stat.st_size;
+    contents->mapped_ = true;
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+#else
+  MP_RETURN_IF_ERROR(file::GetContents(path, &contents->contents_));
+  contents->data_ = contents->contents_.data();
+  contents->size_ = contents->contents_.size();
+#endif  // ABSL_HAVE_MMAP
+  return contents;
+}
+
+MappedFileContents::~MappedFileContents() {
+#ifdef ABSL_HAVE_MMAP
+  if (mapped_) munmap(const_cast<char*>(data_), size_);
+#endif  // ABSL_HAVE_MMAP
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,60 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_MAPPED_FILE_CONTENTS_H_
+#define MEDIAPIPE_UTIL_MAPPED_FILE_CONTENTS_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace mediapipe {
+
+// The read-only contents of a file, memory-mapped where the platform supports
+// it. Mapped pages are loaded on first access and shared through the page
+// cache with other mappings of the same file, including those in other graphs
+// and processes, so a large model or vocabulary file is neither copied nor
+// held twice in memory.
+//
+// On platforms without mmap, the contents are read into memory.
+class MappedFileContents {
+ public:
+  // Maps the file at path. The file must not be modified while it is mapped.
+  static absl::StatusOr<std::unique_ptr<MappedFileContents>> Open(
+      const std::string& path);
+
+  ~MappedFileContents();
+  MappedFileContents(const MappedFileContents&) = delete;
+  MappedFileContents& operator=(const MappedFileContents&) = delete;
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+  absl::string_view view() const { return absl::string_view(data_, size_); }
+
+ private:
+  MappedFileContents() = default;
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  // Whether data_ is an mmap region, rather than pointing into contents_.
+  bool mapped_ = false;
+  std::string contents_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_MAPPED_FILE_CONTENTS_H_
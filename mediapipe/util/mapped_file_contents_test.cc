@@ -0,0 +1,58 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/mapped_file_contents.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+TEST(MappedFileContentsTest, ViewsFileContents) {
+  std::string path = file::JoinPath(getenv("TEST_TMPDIR"), "mapped_file");
+  std::string contents(10000, '\0');
+  for (int i = 0; i < contents.size(); ++i) contents[i] = i % 251;
+  MP_ASSERT_OK(file::SetContents(path, contents));
+
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<MappedFileContents> mapped,
+                          MappedFileContents::Open(path));
+  EXPECT_EQ(mapped->size(), contents.size());
+  EXPECT_EQ(mapped->view(), contents);
+}
+
+TEST(MappedFileContentsTest, ViewsEmptyFile) {
+  std::string path = file::JoinPath(getenv("TEST_TMPDIR"), "empty_file");
+  MP_ASSERT_OK(file::SetContents(path, ""));
+
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<MappedFileContents> mapped,
+                          MappedFileContents::Open(path));
+  EXPECT_EQ(mapped->size(), 0);
+  EXPECT_TRUE(mapped->view().empty());
+}
+
+TEST(MappedFileContentsTest, FailsForMissingFile) {
+  std::string path = file::JoinPath(getenv("TEST_TMPDIR"), "missing_file");
+  EXPECT_FALSE(MappedFileContents::Open(path).ok());
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,282 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/packet_dump_file.h"
+
+#include "absl/base/config.h"
+
+#ifdef ABSL_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // ABSL_HAVE_MMAP
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "absl/log/absl_log.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/util/packet_payload.h"
+
+namespace mediapipe {
+
+namespace packet_dump_internal {
+
+// The index entry of a packet. The first param of a kProto payload is the
+// name id of the message type.
+struct Record {
+  int64_t timestamp;
+  int64_t send_time_usec;
+  uint64_t offset;
+  uint64_t size;
+  uint32_t stream;
+  PacketPayloadHeader payload;
+};
+
+// The last bytes of the file, locating the index.
+struct Footer {
+  char magic[8];
+  uint64_t records_offset;
+  uint64_t num_records;
+  uint64_t names_offset;
+  uint64_t num_names;
+};
+
+}  // namespace packet_dump_internal
+
+namespace {
+
+using packet_dump_internal::Footer;
+using packet_dump_internal::Record;
+
+constexpr char kMagic[8] = {'M', 'P', 'D', 'U', 'M', 'P', '0', '1'};
+
+// Payloads are aligned to the Tensor CPU buffer alignment.
+constexpr uint64_t kPayloadAlignment = 64;
+
+}  // namespace
+
+// The bytes of a packet dump file, memory-mapped where possible.
+struct PacketDumpReader::Mapping {
+  ~Mapping() {
+#ifdef ABSL_HAVE_MMAP
+    if (data != nullptr) munmap(data, size);
+#endif  // ABSL_HAVE_MMAP
+  }
+
+  uint8_t* data = nullptr;
+  size_t size = 0;
+  // Holds the file contents if it is not mapped.
+  std::string contents;
+};
+
+PacketDumpWriter::PacketDumpWriter(FILE* file, std::string path)
+    : file_(file), path_(std::move(path)) {}
+
+PacketDumpWriter::~PacketDumpWriter() {
+  if (file_ != nullptr) {
+    absl::Status status = Close();
+    ABSL_LOG_IF(ERROR, !status.ok()) << status;
+  }
+}
+
+// static
+absl::StatusOr<std::unique_ptr<PacketDumpWriter>> PacketDumpWriter::Create(
+    const std::string& path) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return absl::InvalidArgumentError(absl::StrCat("Can't open file: ", path));
+  }
+  return absl::WrapUnique(new PacketDumpWriter(file, path));
+}
+
+absl::Status PacketDumpWriter::Align() {
+  static constexpr char kPadding[kPayloadAlignment] = {};
+  size_t padding = (kPayloadAlignment - offset_ % kPayloadAlignment) %
+                   kPayloadAlignment;
+  return WriteBytes(kPadding, padding);
+}
+
+absl::Status PacketDumpWriter::WriteBytes(const void* data, size_t size) {
+  if (size > 0 && fwrite(data, 1, size, file_) != size) {
+    return absl::InternalError(absl::StrCat("Error writing file: ", path_));
+  }
+  offset_ += size;
+  return absl::OkStatus();
+}
+
+uint32_t PacketDumpWriter::NameId(const std::string& name) {
+  auto [it, inserted] = name_ids_.emplace(name, names_.size());
+  if (inserted) names_.push_back(name);
+  return it->second;
+}
+
+absl::Status PacketDumpWriter::Write(const std::string& stream,
+                                     const Packet& packet,
+                                     int64_t send_time_usec) {
+  RET_CHECK(file_ != nullptr) << "The packet dump file is closed.";
+  RET_CHECK(!packet.IsEmpty());
+  Record record = {};
+  record.timestamp = packet.Timestamp().Value();
+  record.send_time_usec = send_time_usec;
+  record.stream = NameId(stream);
+
+  PacketPayload payload;
+  MP_RETURN_IF_ERROR(GetPacketPayload(packet, &payload))
+      << " on stream " << stream;
+  record.payload = payload.header;
+  if (payload.header.kind == PacketPayloadKind::kProto) {
+    record.payload.params[0] = NameId(payload.type_name);
+  }
+  MP_RETURN_IF_ERROR(Align());
+  record.offset = offset_;
+  record.size = payload.size;
+  MP_RETURN_IF_ERROR(WriteBytes(payload.data, payload.size));
+  records_.push_back(record);
+  return absl::OkStatus();
+}
+
+absl::Status PacketDumpWriter::Close() {
+  RET_CHECK(file_ != nullptr) << "The packet dump file is closed.";
+  Footer footer = {};
+  std::memcpy(footer.magic, kMagic, sizeof(kMagic));
+  std::string names;
+  for (const std::string& name : names_) {
+    uint32_t length = name.size();
+    names.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    names.append(name);
+  }
+  absl::Status status = Align();
+  footer.records_offset = offset_;
+  footer.num_records = records_.size();
+  if (status.ok()) {
+    status = WriteBytes(records_.data(), records_.size() * sizeof(Record));
+  }
+  footer.names_offset = offset_;
+  footer.num_names = names_.size();
+  if (status.ok()) status = WriteBytes(names.data(), names.size());
+  if (status.ok()) status = WriteBytes(&footer, sizeof(footer));
+  bool ok = fclose(file_) == 0 && status.ok();
+  file_ = nullptr;
+  if (!ok) {
+    return absl::InternalError(absl::StrCat("Error writing file: ", path_));
+  }
+  return absl::OkStatus();
+}
+
+PacketDumpReader::PacketDumpReader(std::shared_ptr<Mapping> mapping)
+    : mapping_(std::move(mapping)) {}
+
+PacketDumpReader::~PacketDumpReader() = default;
+
+// static
+absl::StatusOr<std::unique_ptr<PacketDumpReader>> PacketDumpReader::Open(
+    const std::string& path) {
+  auto mapping = std::make_shared<Mapping>();
+#ifdef ABSL_HAVE_MMAP
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::InvalidArgumentError(absl::StrCat("Can't open file: ", path));
+  }
+  struct stat file_stat;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    // A private writable mapping lets consumers of the packets modify their
+    // payloads without changing the file.
+    data = mmap(/*addr=*/nullptr, file_stat.st_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE, fd, /*offset=*/0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    return absl::InternalError(absl::StrCat("Can't map file: ", path));
+  }
+  mapping->data = static_cast<uint8_t*>(data);
+  mapping->size = file_stat.st_size;
+#else
+  MP_RETURN_IF_ERROR(file::GetContents(path, &mapping->contents));
+  mapping->size = mapping->contents.size();
+  mapping->data = reinterpret_cast<uint8_t*>(mapping->contents.data());
+#endif  // ABSL_HAVE_MMAP
+  auto reader = absl::WrapUnique(new PacketDumpReader(std::move(mapping)));
+  MP_RETURN_IF_ERROR(reader->ReadIndex()) << " in file " << path;
+  return reader;
+}
+
+absl::Status PacketDumpReader::ReadIndex() {
+  const uint8_t* data = mapping_->data;
+  const size_t size = mapping_->size;
+  Footer footer;
+  RET_CHECK_GE(size, sizeof(footer)) << "Packet dump is truncated";
+  std::memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+  RET_CHECK(std::memcmp(footer.magic, kMagic, sizeof(kMagic)) == 0)
+      << "Not a packet dump";
+  RET_CHECK_EQ(footer.records_offset % alignof(Record), 0);
+  RET_CHECK_LE(footer.records_offset + footer.num_records * sizeof(Record),
+               footer.names_offset);
+  RET_CHECK_LE(footer.names_offset, size - sizeof(footer));
+  records_ = reinterpret_cast<const Record*>(data + footer.records_offset);
+  num_packets_ = footer.num_records;
+
+  const uint8_t* names = data + footer.names_offset;
+  const uint8_t* names_end = data + size - sizeof(footer);
+  for (uint64_t i = 0; i < footer.num_names; ++i) {
+    uint32_t length;
+    RET_CHECK_LE(sizeof(length), names_end - names);
+    std::memcpy(&length, names, sizeof(length));
+    names += sizeof(length);
+    RET_CHECK_LE(length, names_end - names);
+    names_.emplace_back(reinterpret_cast<const char*>(names), length);
+    names += length;
+  }
+  for (int i = 0; i < num_packets_; ++i) {
+    const Record& record = records_[i];
+    RET_CHECK_LT(record.stream, names_.size());
+    RET_CHECK_LE(record.offset + record.size, footer.records_offset);
+  }
+  return absl::OkStatus();
+}
+
+const std::string& PacketDumpReader::stream(int i) const {
+  return names_[records_[i].stream];
+}
+
+int64_t PacketDumpReader::send_time_usec(int i) const {
+  return records_[i].send_time_usec;
+}
+
+absl::StatusOr<Packet> PacketDumpReader::ReadPacket(int i) const {
+  RET_CHECK(i >= 0 && i < num_packets_);
+  const Record& record = records_[i];
+  std::string type_name;
+  if (record.payload.kind == PacketPayloadKind::kProto) {
+    RET_CHECK(record.payload.params[0] >= 0 &&
+              static_cast<size_t>(record.payload.params[0]) < names_.size());
+    type_name = names_[record.payload.params[0]];
+  }
+  // ImageFrames keep the mapping alive instead of owning their pixels.
+  ASSIGN_OR_RETURN(Packet packet,
+                   MakePacketFromPayload(record.payload, type_name,
+                                         mapping_->data + record.offset,
+                                         record.size, mapping_),
+                   _ << " of packet " << i);
+  return packet.At(Timestamp(record.timestamp));
+}
+
+}  // namespace mediapipe
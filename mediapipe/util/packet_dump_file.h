@@ -0,0 +1,117 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_PACKET_DUMP_FILE_H_
+#define MEDIAPIPE_UTIL_PACKET_DUMP_FILE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mediapipe/framework/packet.h"
+
+namespace mediapipe {
+
+namespace packet_dump_internal {
+struct Record;
+}  // namespace packet_dump_internal
+
+// A packet dump file holds packets recorded from named streams, together with
+// their timestamps and the times at which they were recorded. The payloads
+// are stored unencoded and aligned to 64 bytes, followed by an index of all
+// packets, so that a reader can memory-map the file and view any packet
+// without parsing the others.
+//
+// The supported payload types are ImageFrame, Tensor, std::string,
+// std::vector<float>, std::vector<int> and protobuf messages. The file uses
+// the byte order of the host that wrote it.
+
+// Writes packets to a packet dump file.
+class PacketDumpWriter {
+ public:
+  // Creates the file at path, replacing any existing file.
+  static absl::StatusOr<std::unique_ptr<PacketDumpWriter>> Create(
+      const std::string& path);
+  ~PacketDumpWriter();
+
+  // Appends a packet of the named stream, recorded send_time_usec after the
+  // start of the recording.
+  absl::Status Write(const std::string& stream, const Packet& packet,
+                     int64_t send_time_usec);
+
+  // Writes the index and closes the file. The file can only be read after it
+  // has been closed.
+  absl::Status Close();
+
+ private:
+  PacketDumpWriter(FILE* file, std::string path);
+  // Pads the file to the payload alignment.
+  absl::Status Align();
+  absl::Status WriteBytes(const void* data, size_t size);
+  uint32_t NameId(const std::string& name);
+
+  FILE* file_;
+  const std::string path_;
+  uint64_t offset_ = 0;
+  std::vector<packet_dump_internal::Record> records_;
+  std::vector<std::string> names_;
+  std::map<std::string, uint32_t> name_ids_;
+};
+
+// Reads packets from a packet dump file.
+//
+// The file is memory-mapped where the platform supports it. ImageFrame
+// packets view their pixels in the mapping without a copy, and keep the
+// mapping alive after the reader is destroyed. The mapping is private, so
+// writes to these pixels never reach the file, but they are seen by other
+// packets read from the same record.
+class PacketDumpReader {
+ public:
+  static absl::StatusOr<std::unique_ptr<PacketDumpReader>> Open(
+      const std::string& path);
+  ~PacketDumpReader();
+
+  // Returns the number of packets in the file.
+  int num_packets() const { return num_packets_; }
+
+  // Returns the stream of the packet at index i.
+  const std::string& stream(int i) const;
+
+  // Returns the time at which the packet at index i was recorded, in
+  // microseconds after the start of the recording.
+  int64_t send_time_usec(int i) const;
+
+  // Returns the packet at index i, at its recorded timestamp.
+  absl::StatusOr<Packet> ReadPacket(int i) const;
+
+ private:
+  struct Mapping;
+
+  explicit PacketDumpReader(std::shared_ptr<Mapping> mapping);
+  absl::Status ReadIndex();
+
+  std::shared_ptr<Mapping> mapping_;
+  const packet_dump_internal::Record* records_ = nullptr;
+  int num_packets_ = 0;
+  std::vector<std::string> names_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_PACKET_DUMP_FILE_H_
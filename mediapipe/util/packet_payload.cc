@@ -0,0 +1,136 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/packet_payload.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/formats/image_frame.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+
+namespace mediapipe {
+
+absl::Status GetPacketPayload(const Packet& packet, PacketPayload* payload) {
+  RET_CHECK(!packet.IsEmpty());
+  PacketPayloadHeader& header = payload->header;
+  if (packet.ValidateAsType<ImageFrame>().ok()) {
+    const auto& frame = packet.Get<ImageFrame>();
+    header.kind = PacketPayloadKind::kImageFrame;
+    header.params[0] = frame.Format();
+    header.params[1] = frame.Width();
+    header.params[2] = frame.Height();
+    header.params[3] = frame.WidthStep();
+    payload->data = frame.PixelData();
+    payload->size = frame.PixelDataSize();
+  } else if (packet.ValidateAsType<Tensor>().ok()) {
+    const auto& tensor = packet.Get<Tensor>();
+    const auto& dims = tensor.shape().dims;
+    RET_CHECK_LE(dims.size(), kMaxPayloadTensorDims);
+    header.kind = PacketPayloadKind::kTensor;
+    header.params[0] = static_cast<int32_t>(tensor.element_type());
+    header.params[1] = dims.size();
+    std::copy(dims.begin(), dims.end(), &header.params[2]);
+    header.params[2 + kMaxPayloadTensorDims] =
+        tensor.quantization_parameters().zero_point;
+    std::memcpy(&header.params[3 + kMaxPayloadTensorDims],
+                &tensor.quantization_parameters().scale, sizeof(float));
+    auto view = tensor.GetCpuReadView();
+    payload->serialized.assign(view.buffer<char>(), tensor.bytes());
+    payload->data = payload->serialized.data();
+    payload->size = payload->serialized.size();
+  } else if (packet.ValidateAsType<std::string>().ok()) {
+    header.kind = PacketPayloadKind::kString;
+    payload->data = packet.Get<std::string>().data();
+    payload->size = packet.Get<std::string>().size();
+  } else if (packet.ValidateAsType<std::vector<float>>().ok()) {
+    header.kind = PacketPayloadKind::kFloatVector;
+    payload->data = packet.Get<std::vector<float>>().data();
+    payload->size = packet.Get<std::vector<float>>().size() * sizeof(float);
+  } else if (packet.ValidateAsType<std::vector<int>>().ok()) {
+    header.kind = PacketPayloadKind::kIntVector;
+    payload->data = packet.Get<std::vector<int>>().data();
+    payload->size = packet.Get<std::vector<int>>().size() * sizeof(int);
+  } else if (packet.ValidateAsProtoMessageLite().ok()) {
+    const auto& message = packet.GetProtoMessageLite();
+    header.kind = PacketPayloadKind::kProto;
+    payload->type_name = message.GetTypeName();
+    RET_CHECK(message.SerializeToString(&payload->serialized));
+    payload->data = payload->serialized.data();
+    payload->size = payload->serialized.size();
+  } else {
+    return absl::UnimplementedError(
+        absl::StrCat("Unsupported payload type ", packet.DebugTypeName()));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<Packet> MakePacketFromPayload(const PacketPayloadHeader& header,
+                                             const std::string& type_name,
+                                             uint8_t* data, size_t size,
+                                             std::shared_ptr<void> owner) {
+  switch (header.kind) {
+    case PacketPayloadKind::kImageFrame: {
+      auto format = static_cast<ImageFormat::Format>(header.params[0]);
+      int height = header.params[2];
+      int width_step = header.params[3];
+      RET_CHECK_EQ(size, static_cast<uint64_t>(height) * width_step);
+      // The frame keeps the owner alive instead of owning its pixels.
+      return MakePacket<ImageFrame>(format, header.params[1], height,
+                                    width_step, data,
+                                    [owner = std::move(owner)](uint8_t*) {});
+    }
+    case PacketPayloadKind::kTensor: {
+      int num_dims = header.params[1];
+      RET_CHECK(num_dims >= 0 && num_dims <= kMaxPayloadTensorDims);
+      Tensor::Shape shape(std::vector<int>(&header.params[2],
+                                           &header.params[2] + num_dims));
+      Tensor::QuantizationParameters quantization;
+      quantization.zero_point = header.params[2 + kMaxPayloadTensorDims];
+      std::memcpy(&quantization.scale,
+                  &header.params[3 + kMaxPayloadTensorDims], sizeof(float));
+      Tensor tensor(static_cast<Tensor::ElementType>(header.params[0]), shape,
+                    quantization);
+      RET_CHECK_EQ(size, static_cast<uint64_t>(tensor.bytes()));
+      {
+        auto view = tensor.GetCpuWriteView();
+        std::memcpy(view.buffer<uint8_t>(), data, size);
+      }
+      return MakePacket<Tensor>(std::move(tensor));
+    }
+    case PacketPayloadKind::kString:
+      return MakePacket<std::string>(reinterpret_cast<char*>(data), size);
+    case PacketPayloadKind::kFloatVector: {
+      const float* values = reinterpret_cast<const float*>(data);
+      return MakePacket<std::vector<float>>(values,
+                                            values + size / sizeof(float));
+    }
+    case PacketPayloadKind::kIntVector: {
+      const int* values = reinterpret_cast<const int*>(data);
+      return MakePacket<std::vector<int>>(values, values + size / sizeof(int));
+    }
+    case PacketPayloadKind::kProto:
+      return packet_internal::PacketFromDynamicProto(
+          type_name, std::string(reinterpret_cast<char*>(data), size));
+  }
+  return absl::DataLossError(absl::StrCat(
+      "Unknown payload kind ", static_cast<uint32_t>(header.kind)));
+}
+
+}  // namespace mediapipe
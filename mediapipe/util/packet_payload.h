@@ -0,0 +1,78 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_PACKET_PAYLOAD_H_
+#define MEDIAPIPE_UTIL_PACKET_PAYLOAD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mediapipe/framework/packet.h"
+
+namespace mediapipe {
+
+// The payload types that are stored as raw bytes, without an encoding step,
+// by packet dump files and shared memory channels.
+enum class PacketPayloadKind : uint32_t {
+  kImageFrame = 1,
+  kTensor = 2,
+  kString = 3,
+  kFloatVector = 4,
+  kIntVector = 5,
+  kProto = 6,
+};
+
+constexpr int kMaxPayloadTensorDims = 8;
+
+// Describes how to rebuild a packet from its payload bytes. The params depend
+// on the payload kind:
+//   kImageFrame: format, width, height, width_step.
+//   kTensor: element type, number of dims, dims, zero point, scale bits.
+// The message type of a kProto payload is stored separately.
+struct PacketPayloadHeader {
+  PacketPayloadKind kind;
+  int32_t params[4 + kMaxPayloadTensorDims];
+};
+
+// The payload of a packet. The bytes are those of the packet itself or of
+// `serialized`, so the payload must outlive neither, and must not be moved.
+struct PacketPayload {
+  PacketPayloadHeader header = {};
+  // The message type of a kProto payload.
+  std::string type_name;
+  const void* data = nullptr;
+  size_t size = 0;
+  // Holds the bytes of payloads that the packet does not store contiguously.
+  std::string serialized;
+};
+
+// Gets the payload of a packet of a supported type: ImageFrame, Tensor,
+// std::string, std::vector<float>, std::vector<int> or a protobuf message.
+absl::Status GetPacketPayload(const Packet& packet, PacketPayload* payload);
+
+// Rebuilds a packet without a timestamp from the payload bytes `data`. An
+// ImageFrame uses the bytes in place and keeps `owner` alive as long as it
+// exists. The other payloads are copied.
+absl::StatusOr<Packet> MakePacketFromPayload(const PacketPayloadHeader& header,
+                                             const std::string& type_name,
+                                             uint8_t* data, size_t size,
+                                             std::shared_ptr<void> owner);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_PACKET_PAYLOAD_H_
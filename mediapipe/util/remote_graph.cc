@@ -0,0 +1,303 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/remote_graph.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "absl/log/absl_log.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/util/packet_payload.h"
+
+namespace mediapipe {
+
+namespace {
+
+// How often a session checks whether its graph has failed while it waits for
+// the client.
+constexpr absl::Duration kSessionPollInterval = absl::Milliseconds(100);
+
+using SendFunction = std::function<absl::Status(RemoteGraphMessage)>;
+
+// Runs an instance of the graph until the client closes its input streams.
+absl::Status RunRemoteGraph(const CalculatorGraphConfig& config,
+                            RemoteGraphConnection* connection,
+                            const SendFunction& send) {
+  CalculatorGraph graph;
+  MP_RETURN_IF_ERROR(graph.Initialize(config));
+  for (const std::string& stream : config.output_stream()) {
+    MP_RETURN_IF_ERROR(graph.ObserveOutputStream(
+        stream,
+        [stream, &send](const Packet& packet) -> absl::Status {
+          if (packet.IsEmpty()) {
+            RemoteGraphMessage message;
+            message.set_kind(RemoteGraphMessage::TIMESTAMP_BOUND);
+            message.set_stream(stream);
+            message.set_timestamp(
+                packet.Timestamp().NextAllowedInStream().Value());
+            return send(std::move(message));
+          }
+          ASSIGN_OR_RETURN(RemoteGraphMessage message,
+                           MakeRemotePacketMessage(stream, packet));
+          return send(std::move(message));
+        },
+        /*observe_timestamp_bounds=*/true));
+  }
+  MP_RETURN_IF_ERROR(graph.StartRun({}));
+
+  // The graph is running, so errors must not return before it is done.
+  absl::Status status;
+  bool closed = false;
+  while (status.ok() && !closed) {
+    absl::StatusOr<RemoteGraphMessage> message =
+        connection->Receive(kSessionPollInterval);
+    if (absl::IsDeadlineExceeded(message.status())) {
+      if (graph.HasError()) break;
+      continue;
+    }
+    if (!message.ok()) {
+      status = message.status();
+      break;
+    }
+    const std::string stream = message->stream();
+    const Timestamp timestamp(message->timestamp());
+    switch (message->kind()) {
+      case RemoteGraphMessage::PACKET: {
+        absl::StatusOr<Packet> packet = GetRemotePacket(*std::move(message));
+        status = packet.ok() ? graph.AddPacketToInputStream(stream, *packet)
+                             : packet.status();
+        break;
+      }
+      case RemoteGraphMessage::TIMESTAMP_BOUND:
+        status = graph.SetInputStreamTimestampBound(stream, timestamp);
+        break;
+      case RemoteGraphMessage::CLOSE:
+        status = graph.CloseAllInputStreams();
+        closed = true;
+        break;
+      default:
+        status = absl::InvalidArgumentError(absl::StrCat(
+            "Unexpected message from the client: ", message->kind()));
+    }
+  }
+  if (!status.ok() && !graph.HasError()) graph.Cancel();
+  absl::Status graph_status = graph.WaitUntilDone();
+  // The error of the graph explains why it stopped accepting input.
+  return graph.HasError() ? graph_status : status;
+}
+
+// One direction of a loopback connection.
+class MessageQueue {
+ public:
+  void Push(RemoteGraphMessage message) {
+    absl::MutexLock lock(&mutex_);
+    messages_.push_back(std::move(message));
+  }
+
+  void Disconnect() {
+    absl::MutexLock lock(&mutex_);
+    disconnected_ = true;
+  }
+
+  absl::StatusOr<RemoteGraphMessage> Pop(absl::Duration timeout) {
+    absl::MutexLock lock(&mutex_);
+    mutex_.AwaitWithTimeout(absl::Condition(this, &MessageQueue::Ready),
+                            timeout);
+    if (!messages_.empty()) {
+      RemoteGraphMessage message = std::move(messages_.front());
+      messages_.pop_front();
+      return message;
+    }
+    if (disconnected_) {
+      return absl::OutOfRangeError("The peer has disconnected.");
+    }
+    return absl::DeadlineExceededError("No message was received.");
+  }
+
+ private:
+  bool Ready() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return !messages_.empty() || disconnected_;
+  }
+
+  absl::Mutex mutex_;
+  std::deque<RemoteGraphMessage> messages_ ABSL_GUARDED_BY(mutex_);
+  bool disconnected_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+// An end of a connection within the process. Messages are moved to the peer
+// without being serialized.
+class LoopbackConnection : public RemoteGraphConnection {
+ public:
+  LoopbackConnection(std::shared_ptr<MessageQueue> incoming,
+                     std::shared_ptr<MessageQueue> outgoing)
+      : incoming_(std::move(incoming)), outgoing_(std::move(outgoing)) {}
+  ~LoopbackConnection() override { outgoing_->Disconnect(); }
+
+  absl::Status Send(RemoteGraphMessage message) override {
+    outgoing_->Push(std::move(message));
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<RemoteGraphMessage> Receive(absl::Duration timeout) override {
+    return incoming_->Pop(timeout);
+  }
+
+ private:
+  std::shared_ptr<MessageQueue> incoming_;
+  std::shared_ptr<MessageQueue> outgoing_;
+};
+
+ABSL_CONST_INIT absl::Mutex loopback_mutex(absl::kConstInit);
+
+std::map<std::string, RemoteGraphServer*>& LoopbackServers()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(loopback_mutex) {
+  static auto* servers = new std::map<std::string, RemoteGraphServer*>();
+  return *servers;
+}
+
+}  // namespace
+
+class LoopbackTransport {
+ public:
+  static absl::StatusOr<std::unique_ptr<RemoteGraphConnection>> Connect(
+      const std::string& address) {
+    auto to_server = std::make_shared<MessageQueue>();
+    auto to_client = std::make_shared<MessageQueue>();
+    absl::MutexLock lock(&loopback_mutex);
+    auto it = LoopbackServers().find(address);
+    if (it == LoopbackServers().end()) {
+      return absl::UnavailableError(
+          absl::StrCat("No loopback remote graph server at ", address));
+    }
+    it->second->StartLoopbackSession(
+        std::make_unique<LoopbackConnection>(to_server, to_client));
+    return std::make_unique<LoopbackConnection>(to_client, to_server);
+  }
+};
+
+REGISTER_REMOTE_GRAPH_TRANSPORT("loopback", LoopbackTransport::Connect);
+
+absl::StatusOr<std::unique_ptr<RemoteGraphConnection>> ConnectRemoteGraph(
+    const std::string& transport, const std::string& address) {
+  RET_CHECK(RemoteGraphTransportRegistry::IsRegistered(transport))
+      << "Unknown remote graph transport: " << transport;
+  return RemoteGraphTransportRegistry::CreateByName(transport, address);
+}
+
+absl::StatusOr<RemoteGraphMessage> MakeRemotePacketMessage(
+    const std::string& stream, const Packet& packet) {
+  PacketPayload payload;
+  MP_RETURN_IF_ERROR(GetPacketPayload(packet, &payload))
+      << " on stream " << stream;
+  RemoteGraphMessage message;
+  message.set_kind(RemoteGraphMessage::PACKET);
+  message.set_stream(stream);
+  message.set_timestamp(packet.Timestamp().Value());
+  RemoteGraphMessage::Payload* remote_payload = message.mutable_payload();
+  remote_payload->set_kind(static_cast<uint32_t>(payload.header.kind));
+  for (int32_t param : payload.header.params) remote_payload->add_param(param);
+  remote_payload->set_type_name(payload.type_name);
+  if (payload.data == payload.serialized.data()) {
+    remote_payload->set_data(std::move(payload.serialized));
+  } else {
+    remote_payload->set_data(payload.data, payload.size);
+  }
+  return message;
+}
+
+absl::StatusOr<Packet> GetRemotePacket(RemoteGraphMessage message) {
+  RET_CHECK_EQ(message.kind(), RemoteGraphMessage::PACKET);
+  PacketPayloadHeader header = {};
+  header.kind = static_cast<PacketPayloadKind>(message.payload().kind());
+  RET_CHECK_LE(message.payload().param_size(), std::size(header.params));
+  std::copy(message.payload().param().begin(),
+            message.payload().param().end(), header.params);
+  // The packet keeps the message alive if it uses the payload in place.
+  auto owner = std::make_shared<RemoteGraphMessage>(std::move(message));
+  std::string* data = owner->mutable_payload()->mutable_data();
+  ASSIGN_OR_RETURN(
+      Packet packet,
+      MakePacketFromPayload(header, owner->payload().type_name(),
+                            reinterpret_cast<uint8_t*>(data->data()),
+                            data->size(), owner),
+      _ << " on stream " << owner->stream());
+  return packet.At(Timestamp(owner->timestamp()));
+}
+
+RemoteGraphServer::RemoteGraphServer(CalculatorGraphConfig config)
+    : config_(std::move(config)) {}
+
+RemoteGraphServer::~RemoteGraphServer() {
+  if (!loopback_address_.empty()) {
+    absl::MutexLock lock(&loopback_mutex);
+    LoopbackServers().erase(loopback_address_);
+  }
+  std::vector<std::thread> sessions;
+  {
+    absl::MutexLock lock(&mutex_);
+    sessions.swap(sessions_);
+  }
+  for (std::thread& session : sessions) session.join();
+}
+
+absl::Status RemoteGraphServer::ServeSession(
+    RemoteGraphConnection* connection) {
+  // Output streams are observed on the threads of the graph.
+  absl::Mutex send_mutex;
+  SendFunction send = [connection, &send_mutex](RemoteGraphMessage message) {
+    absl::MutexLock lock(&send_mutex);
+    return connection->Send(std::move(message));
+  };
+  absl::Status status = RunRemoteGraph(config_, connection, send);
+  RemoteGraphMessage message;
+  if (status.ok()) {
+    message.set_kind(RemoteGraphMessage::CLOSE);
+  } else {
+    message.set_kind(RemoteGraphMessage::ERROR);
+    message.set_error_code(static_cast<int>(status.code()));
+    message.set_error_message(std::string(status.message()));
+  }
+  // The client may have disconnected already.
+  send(std::move(message)).IgnoreError();
+  return status;
+}
+
+absl::Status RemoteGraphServer::ServeLoopback(const std::string& address) {
+  RET_CHECK(loopback_address_.empty())
+      << "The server is already reachable at " << loopback_address_;
+  absl::MutexLock lock(&loopback_mutex);
+  RET_CHECK(LoopbackServers().emplace(address, this).second)
+      << "Another server is reachable at " << address;
+  loopback_address_ = address;
+  return absl::OkStatus();
+}
+
+void RemoteGraphServer::StartLoopbackSession(
+    std::unique_ptr<RemoteGraphConnection> connection) {
+  absl::MutexLock lock(&mutex_);
+  sessions_.emplace_back([this, connection = std::move(connection)]() {
+    absl::Status status = ServeSession(connection.get());
+    ABSL_LOG_IF(WARNING, !status.ok()) << "Remote graph session failed: "
+                                       << status;
+  });
+}
+
+}  // namespace mediapipe
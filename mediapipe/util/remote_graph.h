@@ -0,0 +1,111 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_REMOTE_GRAPH_H_
+#define MEDIAPIPE_UTIL_REMOTE_GRAPH_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/deps/registration.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/util/remote_graph.pb.h"
+
+namespace mediapipe {
+
+// A bidirectional stream of RemoteGraphMessages between a client and a
+// server. Send and Receive may be called concurrently with each other, but
+// each of them from only one thread at a time.
+class RemoteGraphConnection {
+ public:
+  virtual ~RemoteGraphConnection() = default;
+
+  // Queues a message to the peer.
+  virtual absl::Status Send(RemoteGraphMessage message) = 0;
+
+  // Waits up to `timeout` for the next message from the peer. Returns
+  // DeadlineExceededError if none arrived, and OutOfRangeError if the peer
+  // has disconnected.
+  virtual absl::StatusOr<RemoteGraphMessage> Receive(
+      absl::Duration timeout) = 0;
+};
+
+// Transports connect a client to the server at an address. A transport is a
+// function registered under its name with REGISTER_REMOTE_GRAPH_TRANSPORT.
+// The "loopback" transport connects to the servers of the current process
+// that were made reachable with RemoteGraphServer::ServeLoopback.
+using RemoteGraphTransportRegistry = GlobalFactoryRegistry<
+    absl::StatusOr<std::unique_ptr<RemoteGraphConnection>>,
+    const std::string&>;
+
+#define REGISTER_REMOTE_GRAPH_TRANSPORT(name, connect)                       \
+  MEDIAPIPE_REGISTER_FACTORY_FUNCTION_QUALIFIED(                             \
+      mediapipe::RemoteGraphTransportRegistry, remote_graph_transport, name, \
+      connect)
+
+// Connects to the server at `address` using the named transport.
+absl::StatusOr<std::unique_ptr<RemoteGraphConnection>> ConnectRemoteGraph(
+    const std::string& transport, const std::string& address);
+
+// Makes a message carrying a packet of the named stream. The payload is
+// copied once into the message.
+absl::StatusOr<RemoteGraphMessage> MakeRemotePacketMessage(
+    const std::string& stream, const Packet& packet);
+
+// Rebuilds the packet of a PACKET message. The message is consumed, and an
+// ImageFrame uses its payload bytes in place.
+absl::StatusOr<Packet> GetRemotePacket(RemoteGraphMessage message);
+
+// Runs a separate instance of a graph for each client. The graph input
+// streams are fed by the client, and the packets and timestamp bounds of the
+// graph output streams are sent back to it.
+class RemoteGraphServer {
+ public:
+  explicit RemoteGraphServer(CalculatorGraphConfig config);
+  // Stops serving loopback connections, and waits for their sessions to end.
+  ~RemoteGraphServer();
+
+  // Runs a graph for the client at the other end of `connection`, until the
+  // client closes its input streams and the graph is done, or the client
+  // disconnects. Transports call this from a thread of their own for each
+  // client.
+  absl::Status ServeSession(RemoteGraphConnection* connection);
+
+  // Makes the server reachable at `address` by the "loopback" transport.
+  absl::Status ServeLoopback(const std::string& address);
+
+ private:
+  friend class LoopbackTransport;
+
+  // Starts a session for a loopback connection on a new thread.
+  void StartLoopbackSession(std::unique_ptr<RemoteGraphConnection> connection);
+
+  const CalculatorGraphConfig config_;
+  std::string loopback_address_;
+  absl::Mutex mutex_;
+  std::vector<std::thread> sessions_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_REMOTE_GRAPH_H_
@@ -15,7 +15,13 @@
 #ifndef MEDIAPIPE_UTIL_RESOURCE_CACHE_H_
 #define MEDIAPIPE_UTIL_RESOURCE_CACHE_H_
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
@@ -24,14 +30,39 @@
 
 namespace mediapipe {
 
+// Counters of a ResourceCache.
+struct ResourceCacheStats {
+  // The number of lookups that returned an existing value.
+  int64_t hits = 0;
+  // The number of lookups that called the create function.
+  int64_t misses = 0;
+  // The number of entries evicted with a set value.
+  int64_t evictions = 0;
+  // The total size of the set values, if the cache has a size function.
+  int64_t total_size = 0;
+  // The number of set values.
+  int value_count = 0;
+};
+
 // Maintains a cache for resources of type `Value`, where the type of the
 // resource (e.g., image dimension for an image pool) is described bye the `Key`
 // type. The `Value` type must include an unset value, with implicit conversion
 // to bool reflecting set/unset state.
+//
+// If the cache is given a size function, it keeps the total size of the set
+// values, so that EvictToSize only visits the entries it evicts.
 template <typename Key, typename Value,
           typename KeyHash = typename absl::flat_hash_map<Key, int>::hasher>
 class ResourceCache {
  public:
+  using SizeFunction =
+      std::function<int64_t(const Key& key, const Value& value)>;
+
+  ResourceCache() = default;
+  // `size_of` returns the size of a set value, which must not change while it
+  // is in the cache.
+  explicit ResourceCache(SizeFunction size_of) : size_of_(std::move(size_of)) {}
+
   Value Lookup(
       const Key& key,
       absl::FunctionRef<Value(const Key& key, int request_count)> create) {
@@ -58,9 +89,19 @@ class ResourceCache {
         entry_list_.InsertAfter(entry, larger);
       }
     }
-    if (!entry->value) {
+    if (entry->value) {
+      ++stats_.hits;
+      UnlinkRecent(entry);
+    } else {
+      ++stats_.misses;
       entry->value = create(entry->key, entry->request_count);
+      if (entry->value) {
+        entry->size = size_of_ ? size_of_(entry->key, entry->value) : 0;
+        stats_.total_size += entry->size;
+        ++stats_.value_count;
+      }
     }
+    if (entry->value) LinkMostRecent(entry);
     ++total_request_count_;
     return entry->value;
   }
@@ -70,10 +111,7 @@ class ResourceCache {
 
     // Remove excess entries.
     while (entry_list_.size() > max_count) {
-      Entry* victim = entry_list_.tail();
-      evicted.emplace_back(std::move(victim->value));
-      entry_list_.Remove(victim);
-      map_.erase(victim->key);
+      RemoveEntry(entry_list_.tail(), &evicted);
     }
     // Every request_count_scrub_interval, halve the request counts, and
     // remove entries which have fallen to 0.
@@ -89,9 +127,7 @@ class ResourceCache {
         entry->request_count /= 2;
         Entry* next = entry->next;
         if (entry->request_count == 0) {
-          evicted.emplace_back(std::move(entry->value));
-          entry_list_.Remove(entry);
-          map_.erase(entry->key);
+          RemoveEntry(entry, &evicted);
         }
         entry = next;
       }
@@ -99,16 +135,101 @@ class ResourceCache {
     return evicted;
   }
 
+  // Removes the least recently looked up entries until the total size of the
+  // set values, as given by the size function of the cache, is at most
+  // `max_size`. Requires a size function.
+  std::vector<Value> EvictToSize(int64_t max_size) {
+    ABSL_CHECK(size_of_) << "EvictToSize requires a size function.";
+    std::vector<Value> evicted;
+    while (stats_.total_size > max_size && least_recent_ != nullptr) {
+      RemoveEntry(least_recent_, &evicted);
+    }
+    return evicted;
+  }
+
+  // Removes the least recently looked up entries until the total size of the
+  // set values, as given by `size_of`, is at most `max_size`.
+  std::vector<Value> EvictLeastRecentlyUsed(
+      int64_t max_size,
+      absl::FunctionRef<int64_t(const Key& key, const Value& value)> size_of) {
+    std::vector<Value> evicted;
+    int64_t total_size = 0;
+    for (Entry* entry = least_recent_; entry != nullptr;
+         entry = entry->more_recent) {
+      total_size += size_of(entry->key, entry->value);
+    }
+    while (total_size > max_size && least_recent_ != nullptr) {
+      total_size -= size_of(least_recent_->key, least_recent_->value);
+      RemoveEntry(least_recent_, &evicted);
+    }
+    return evicted;
+  }
+
+  // Calls `fn` for each entry with a set value.
+  void ForEachValue(
+      absl::FunctionRef<void(const Key& key, const Value& value)> fn) const {
+    for (const auto& [key, entry] : map_) {
+      if (entry->value) fn(key, entry->value);
+    }
+  }
+
+  // Returns the counters since construction, and the current values.
+  const ResourceCacheStats& stats() const { return stats_; }
+
  private:
   struct Entry {
     Entry(const Key& key) : key(key) {}
     Entry* prev = nullptr;
     Entry* next = nullptr;
+    // Neighbors in the list of entries with a set value, in lookup order.
+    Entry* less_recent = nullptr;
+    Entry* more_recent = nullptr;
     int request_count = 0;
+    // The size of the set value, as given by the size function.
+    int64_t size = 0;
     Key key;
     Value value;
   };
 
+  void LinkMostRecent(Entry* entry) {
+    entry->less_recent = most_recent_;
+    entry->more_recent = nullptr;
+    if (most_recent_ != nullptr) {
+      most_recent_->more_recent = entry;
+    } else {
+      least_recent_ = entry;
+    }
+    most_recent_ = entry;
+  }
+
+  void UnlinkRecent(Entry* entry) {
+    if (entry->less_recent != nullptr) {
+      entry->less_recent->more_recent = entry->more_recent;
+    } else {
+      least_recent_ = entry->more_recent;
+    }
+    if (entry->more_recent != nullptr) {
+      entry->more_recent->less_recent = entry->less_recent;
+    } else {
+      most_recent_ = entry->less_recent;
+    }
+    entry->less_recent = nullptr;
+    entry->more_recent = nullptr;
+  }
+
+  // Moves the value of the entry, if set, to `evicted`, and deletes the entry.
+  void RemoveEntry(Entry* entry, std::vector<Value>* evicted) {
+    if (entry->value) {
+      UnlinkRecent(entry);
+      stats_.total_size -= entry->size;
+      --stats_.value_count;
+      ++stats_.evictions;
+    }
+    evicted->emplace_back(std::move(entry->value));
+    entry_list_.Remove(entry);
+    map_.erase(entry->key);
+  }
+
   // Unlike std::list, this is an intrusive list, meaning that the prev and next
   // pointers live inside the element. Apart from not requiring an extra
   // allocation, this means that once we look up an entry by key in the pools_
@@ -175,7 +296,13 @@ class ResourceCache {
 
   absl::flat_hash_map<Key, std::unique_ptr<Entry>, KeyHash> map_;
   EntryList entry_list_;
+  // The entries with a set value, from the least to the most recently looked
+  // up.
+  Entry* least_recent_ = nullptr;
+  Entry* most_recent_ = nullptr;
   int total_request_count_ = 0;
+  SizeFunction size_of_;
+  ResourceCacheStats stats_;
 };
 
 }  // namespace mediapipe
@@ -146,5 +146,82 @@ TEST(ResourceCacheTest, EvictWithScrub) {
   EXPECT_EQ(1, *evicted[0]);
 }
 
+TEST(ResourceCacheTest, EvictLeastRecentlyUsedToMaxSize) {
+  IntCache cache;
+  auto create = [](int key, int request_count) {
+    return std::make_shared<int>(key);
+  };
+  auto size_of = [](const int& key, const std::shared_ptr<int>& value) {
+    return static_cast<int64_t>(key) * 10;
+  };
+
+  EXPECT_NE(nullptr, cache.Lookup(1, create));
+  EXPECT_NE(nullptr, cache.Lookup(2, create));
+  EXPECT_NE(nullptr, cache.Lookup(3, create));
+  // Entry 1 has the most requests, but entry 2 is the least recently used.
+  EXPECT_NE(nullptr, cache.Lookup(1, create));
+
+  // Total size 60, so nothing evicted.
+  EXPECT_TRUE(cache.EvictLeastRecentlyUsed(/*max_size=*/60, size_of).empty());
+
+  auto evicted = cache.EvictLeastRecentlyUsed(/*max_size=*/40, size_of);
+  ASSERT_EQ(1, evicted.size());
+  EXPECT_EQ(2, *evicted[0]);
+
+  evicted = cache.EvictLeastRecentlyUsed(/*max_size=*/10, size_of);
+  ASSERT_EQ(1, evicted.size());
+  EXPECT_EQ(3, *evicted[0]);
+
+  int total_size = 0;
+  cache.ForEachValue([&](const int& key, const std::shared_ptr<int>& value) {
+    total_size += size_of(key, value);
+  });
+  EXPECT_EQ(10, total_size);
+}
+
+TEST(ResourceCacheTest, EvictToSizeWithSizeFunction) {
+  IntCache cache([](const int& key, const std::shared_ptr<int>& value) {
+    return static_cast<int64_t>(key) * 10;
+  });
+  auto create = [](int key, int request_count) {
+    return request_count >= 2 || key != 4 ? std::make_shared<int>(key)
+                                          : nullptr;
+  };
+
+  EXPECT_NE(nullptr, cache.Lookup(1, create));
+  EXPECT_NE(nullptr, cache.Lookup(2, create));
+  EXPECT_NE(nullptr, cache.Lookup(3, create));
+  EXPECT_EQ(nullptr, cache.Lookup(4, create));
+  EXPECT_NE(nullptr, cache.Lookup(1, create));
+  EXPECT_EQ(60, cache.stats().total_size);
+  EXPECT_EQ(3, cache.stats().value_count);
+  EXPECT_EQ(1, cache.stats().hits);
+  EXPECT_EQ(4, cache.stats().misses);
+
+  EXPECT_TRUE(cache.EvictToSize(/*max_size=*/60).empty());
+
+  // Entry 2 is the least recently used; entry 4 has no value and no size.
+  auto evicted = cache.EvictToSize(/*max_size=*/45);
+  ASSERT_EQ(1, evicted.size());
+  EXPECT_EQ(2, *evicted[0]);
+  EXPECT_EQ(40, cache.stats().total_size);
+
+  EXPECT_NE(nullptr, cache.Lookup(4, create));
+  EXPECT_EQ(80, cache.stats().total_size);
+  evicted = cache.EvictToSize(/*max_size=*/40);
+  ASSERT_EQ(2, evicted.size());
+  EXPECT_EQ(3, *evicted[0]);
+  EXPECT_EQ(1, *evicted[1]);
+  EXPECT_EQ(40, cache.stats().total_size);
+  EXPECT_EQ(1, cache.stats().value_count);
+  EXPECT_EQ(3, cache.stats().evictions);
+
+  // Values evicted by count are subtracted as well.
+  evicted = cache.Evict(/*max_count=*/0, /*request_count_scrub_interval=*/100);
+  ASSERT_EQ(1, evicted.size());
+  EXPECT_EQ(0, cache.stats().total_size);
+  EXPECT_EQ(0, cache.stats().value_count);
+}
+
 }  // namespace
 }  // namespace mediapipe
@@ -93,9 +93,11 @@
 #include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/strings/string_view.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/port/logging.h"
 #include "mediapipe/framework/port/proto_ns.h"
+#include "mediapipe/util/sequence/media_sequence_view.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
 
@@ -248,6 +250,55 @@ inline const proto_ns::RepeatedPtrField<std::string>& GetBytesAt(
   return fl.feature().Get(index).bytes_list().value();
 }
 
+// Overloads of the accessors above for a SequenceExampleView, which decode the
+// values of a feature only when they are read. Bytes values are views of the
+// serialized SequenceExample.
+inline const bool HasContext(const SequenceExampleView& sequence,
+                             const std::string& key) {
+  return sequence.HasContext(key);
+}
+
+inline const FeatureView& GetContext(const SequenceExampleView& sequence,
+                                     const std::string& key) {
+  return sequence.GetContext(key);
+}
+
+inline const bool HasFeatureList(const SequenceExampleView& sequence,
+                                 const std::string& key) {
+  return sequence.HasFeatureList(key);
+}
+
+inline const int GetFeatureListSize(const SequenceExampleView& sequence,
+                                    const std::string& key) {
+  return sequence.GetFeatureListSize(key);
+}
+
+// Returns the feature of the feature list indicated by key at the provided
+// sequence index.
+inline const FeatureView& GetFeatureAt(const SequenceExampleView& sequence,
+                                       const std::string& key,
+                                       const int index) {
+  return sequence.GetFeatureListAt(key, index);
+}
+
+inline std::vector<float> GetFloatsAt(const SequenceExampleView& sequence,
+                                      const std::string& key,
+                                      const int index) {
+  return GetFeatureAt(sequence, key, index).GetFloats();
+}
+
+inline std::vector<int64> GetInt64sAt(const SequenceExampleView& sequence,
+                                      const std::string& key,
+                                      const int index) {
+  return GetFeatureAt(sequence, key, index).GetInt64s();
+}
+
+inline std::vector<absl::string_view> GetBytesAt(
+    const SequenceExampleView& sequence, const std::string& key,
+    const int index) {
+  return GetFeatureAt(sequence, key, index).GetBytes();
+}
+
 // Adds any iterable (with begin and end) to a FeatureList as a float Feature.
 template <typename TContainer>
 void AddFloatContainer(const std::string& key, const TContainer& float_list,
@@ -283,7 +334,8 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
 // name to use in the functions and the string key used in the SequenceExample
 // proto maps. Macro versions exist for {strings, int64s, and floats} for
 // creating singular or repeated context features and singular or repeated
-// feature_list features.
+// feature_list features. The feature_list macros also create HasX, GetXSize,
+// and GetXAt overloads for a SequenceExampleView.
 
 // Helpers to create functions names in the macros below.
 #define CONCAT_STR2(a, b) a##b
@@ -784,6 +836,20 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       int index) {                                                            \
     return GetBytesAt(sequence, merge_prefix(prefix, key), index).Get(0);     \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has, name)(                                   \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return HasFeatureList(sequence, merge_prefix(prefix, key));               \
+  }                                                                           \
+  inline const int CONCAT_STR3(Get, name, Size)(                              \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return GetFeatureListSize(sequence, merge_prefix(prefix, key));           \
+  }                                                                           \
+  inline absl::string_view CONCAT_STR3(Get, name, At)(                        \
+      const std::string& prefix, const SequenceExampleView& sequence,         \
+      int index) {                                                            \
+    return GetFeatureAt(sequence, merge_prefix(prefix, key), index)           \
+        .GetBytesAt(0);                                                       \
+  }                                                                           \
   inline void CONCAT_STR2(Clear, name)(                                       \
       const std::string& prefix, tensorflow::SequenceExample* sequence) {     \
     sequence->mutable_feature_lists()->mutable_feature_list()->erase(         \
@@ -816,6 +882,18 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       const tensorflow::SequenceExample& sequence, int index) {               \
     return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has,                                          \
+                                name)(const SequenceExampleView& sequence) {  \
+    return CONCAT_STR2(Has, name)(prefix, sequence);                          \
+  }                                                                           \
+  inline const int CONCAT_STR3(                                               \
+      Get, name, Size)(const SequenceExampleView& sequence) {                 \
+    return CONCAT_STR3(Get, name, Size)(prefix, sequence);                    \
+  }                                                                           \
+  inline absl::string_view CONCAT_STR3(Get, name, At)(                        \
+      const SequenceExampleView& sequence, int index) {                       \
+    return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
+  }                                                                           \
   inline void CONCAT_STR2(Clear,                                              \
                           name)(tensorflow::SequenceExample * sequence) {     \
     CONCAT_STR2(Clear, name)(prefix, sequence);                               \
@@ -849,6 +927,20 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       int index) {                                                            \
     return GetInt64sAt(sequence, merge_prefix(prefix, key), index).Get(0);    \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has, name)(                                   \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return HasFeatureList(sequence, merge_prefix(prefix, key));               \
+  }                                                                           \
+  inline const int CONCAT_STR3(Get, name, Size)(                              \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return GetFeatureListSize(sequence, merge_prefix(prefix, key));           \
+  }                                                                           \
+  inline int64 CONCAT_STR3(Get, name, At)(                                    \
+      const std::string& prefix, const SequenceExampleView& sequence,         \
+      int index) {                                                            \
+    return GetFeatureAt(sequence, merge_prefix(prefix, key), index)           \
+        .GetInt64At(0);                                                       \
+  }                                                                           \
   inline void CONCAT_STR2(Clear, name)(                                       \
       const std::string& prefix, tensorflow::SequenceExample* sequence) {     \
     sequence->mutable_feature_lists()->mutable_feature_list()->erase(         \
@@ -881,6 +973,18 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       const tensorflow::SequenceExample& sequence, int index) {               \
     return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has,                                          \
+                                name)(const SequenceExampleView& sequence) {  \
+    return CONCAT_STR2(Has, name)(prefix, sequence);                          \
+  }                                                                           \
+  inline const int CONCAT_STR3(                                               \
+      Get, name, Size)(const SequenceExampleView& sequence) {                 \
+    return CONCAT_STR3(Get, name, Size)(prefix, sequence);                    \
+  }                                                                           \
+  inline int64 CONCAT_STR3(Get, name, At)(                                    \
+      const SequenceExampleView& sequence, int index) {                       \
+    return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
+  }                                                                           \
   inline void CONCAT_STR2(Clear,                                              \
                           name)(tensorflow::SequenceExample * sequence) {     \
     CONCAT_STR2(Clear, name)(prefix, sequence);                               \
@@ -914,6 +1018,20 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       int index) {                                                            \
     return GetFloatsAt(sequence, merge_prefix(prefix, key), index).Get(0);    \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has, name)(                                   \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return HasFeatureList(sequence, merge_prefix(prefix, key));               \
+  }                                                                           \
+  inline const int CONCAT_STR3(Get, name, Size)(                              \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return GetFeatureListSize(sequence, merge_prefix(prefix, key));           \
+  }                                                                           \
+  inline float CONCAT_STR3(Get, name, At)(                                    \
+      const std::string& prefix, const SequenceExampleView& sequence,         \
+      int index) {                                                            \
+    return GetFeatureAt(sequence, merge_prefix(prefix, key), index)           \
+        .GetFloatAt(0);                                                       \
+  }                                                                           \
   inline void CONCAT_STR2(Clear, name)(                                       \
       const std::string& prefix, tensorflow::SequenceExample* sequence) {     \
     sequence->mutable_feature_lists()->mutable_feature_list()->erase(         \
@@ -946,6 +1064,18 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       const tensorflow::SequenceExample& sequence, int index) {               \
     return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has,                                          \
+                                name)(const SequenceExampleView& sequence) {  \
+    return CONCAT_STR2(Has, name)(prefix, sequence);                          \
+  }                                                                           \
+  inline const int CONCAT_STR3(                                               \
+      Get, name, Size)(const SequenceExampleView& sequence) {                 \
+    return CONCAT_STR3(Get, name, Size)(prefix, sequence);                    \
+  }                                                                           \
+  inline float CONCAT_STR3(Get, name, At)(                                    \
+      const SequenceExampleView& sequence, int index) {                       \
+    return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
+  }                                                                           \
   inline void CONCAT_STR2(Clear,                                              \
                           name)(tensorflow::SequenceExample * sequence) {     \
     CONCAT_STR2(Clear, name)(prefix, sequence);                               \
@@ -980,6 +1110,19 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
                      const tensorflow::SequenceExample& sequence, int index) { \
     return GetBytesAt(sequence, merge_prefix(prefix, key), index);             \
   }                                                                            \
+  inline const bool CONCAT_STR2(Has, name)(                                    \
+      const std::string& prefix, const SequenceExampleView& sequence) {        \
+    return HasFeatureList(sequence, merge_prefix(prefix, key));                \
+  }                                                                            \
+  inline const int CONCAT_STR3(Get, name, Size)(                               \
+      const std::string& prefix, const SequenceExampleView& sequence) {        \
+    return GetFeatureListSize(sequence, merge_prefix(prefix, key));            \
+  }                                                                            \
+  inline std::vector<absl::string_view> CONCAT_STR3(Get, name, At)(            \
+      const std::string& prefix, const SequenceExampleView& sequence,          \
+      int index) {                                                             \
+    return GetBytesAt(sequence, merge_prefix(prefix, key), index);             \
+  }                                                                            \
   inline void CONCAT_STR2(Clear, name)(                                        \
       const std::string& prefix, tensorflow::SequenceExample* sequence) {      \
     sequence->mutable_feature_lists()->mutable_feature_list()->erase(          \
@@ -1015,6 +1158,18 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       Get, name, At)(const tensorflow::SequenceExample& sequence, int index) { \
     return CONCAT_STR3(Get, name, At)(prefix, sequence, index);                \
   }                                                                            \
+  inline const bool CONCAT_STR2(Has,                                           \
+                                name)(const SequenceExampleView& sequence) {   \
+    return CONCAT_STR2(Has, name)(prefix, sequence);                           \
+  }                                                                            \
+  inline const int CONCAT_STR3(                                                \
+      Get, name, Size)(const SequenceExampleView& sequence) {                  \
+    return CONCAT_STR3(Get, name, Size)(prefix, sequence);                     \
+  }                                                                            \
+  inline std::vector<absl::string_view> CONCAT_STR3(Get, name, At)(            \
+      const SequenceExampleView& sequence, int index) {                        \
+    return CONCAT_STR3(Get, name, At)(prefix, sequence, index);                \
+  }                                                                            \
   inline void CONCAT_STR2(Clear,                                               \
                           name)(tensorflow::SequenceExample * sequence) {      \
     CONCAT_STR2(Clear, name)(prefix, sequence);                                \
@@ -1054,6 +1209,19 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       int index) {                                                            \
     return GetInt64sAt(sequence, merge_prefix(prefix, key), index);           \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has, name)(                                   \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return HasFeatureList(sequence, merge_prefix(prefix, key));               \
+  }                                                                           \
+  inline const int CONCAT_STR3(Get, name, Size)(                              \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return GetFeatureListSize(sequence, merge_prefix(prefix, key));           \
+  }                                                                           \
+  inline std::vector<int64> CONCAT_STR3(Get, name, At)(                       \
+      const std::string& prefix, const SequenceExampleView& sequence,         \
+      int index) {                                                            \
+    return GetInt64sAt(sequence, merge_prefix(prefix, key), index);           \
+  }                                                                           \
   inline void CONCAT_STR2(Clear, name)(                                       \
       const std::string& prefix, tensorflow::SequenceExample* sequence) {     \
     sequence->mutable_feature_lists()->mutable_feature_list()->erase(         \
@@ -1089,6 +1257,18 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       const tensorflow::SequenceExample& sequence, int index) {               \
     return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has,                                          \
+                                name)(const SequenceExampleView& sequence) {  \
+    return CONCAT_STR2(Has, name)(prefix, sequence);                          \
+  }                                                                           \
+  inline const int CONCAT_STR3(                                               \
+      Get, name, Size)(const SequenceExampleView& sequence) {                 \
+    return CONCAT_STR3(Get, name, Size)(prefix, sequence);                    \
+  }                                                                           \
+  inline std::vector<int64> CONCAT_STR3(Get, name, At)(                       \
+      const SequenceExampleView& sequence, int index) {                       \
+    return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
+  }                                                                           \
   inline void CONCAT_STR2(Clear,                                              \
                           name)(tensorflow::SequenceExample * sequence) {     \
     CONCAT_STR2(Clear, name)(prefix, sequence);                               \
@@ -1128,6 +1308,19 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       int index) {                                                            \
     return GetFloatsAt(sequence, merge_prefix(prefix, key), index);           \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has, name)(                                   \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return HasFeatureList(sequence, merge_prefix(prefix, key));               \
+  }                                                                           \
+  inline const int CONCAT_STR3(Get, name, Size)(                              \
+      const std::string& prefix, const SequenceExampleView& sequence) {       \
+    return GetFeatureListSize(sequence, merge_prefix(prefix, key));           \
+  }                                                                           \
+  inline std::vector<float> CONCAT_STR3(Get, name, At)(                       \
+      const std::string& prefix, const SequenceExampleView& sequence,         \
+      int index) {                                                            \
+    return GetFloatsAt(sequence, merge_prefix(prefix, key), index);           \
+  }                                                                           \
   inline void CONCAT_STR2(Clear, name)(                                       \
       const std::string& prefix, tensorflow::SequenceExample* sequence) {     \
     sequence->mutable_feature_lists()->mutable_feature_list()->erase(         \
@@ -1163,6 +1356,18 @@ void AddBytesContainer(const std::string& key, const TContainer& bytes_list,
       const tensorflow::SequenceExample& sequence, int index) {               \
     return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
   }                                                                           \
+  inline const bool CONCAT_STR2(Has,                                          \
+                                name)(const SequenceExampleView& sequence) {  \
+    return CONCAT_STR2(Has, name)(prefix, sequence);                          \
+  }                                                                           \
+  inline const int CONCAT_STR3(                                               \
+      Get, name, Size)(const SequenceExampleView& sequence) {                 \
+    return CONCAT_STR3(Get, name, Size)(prefix, sequence);                    \
+  }                                                                           \
+  inline std::vector<float> CONCAT_STR3(Get, name, At)(                       \
+      const SequenceExampleView& sequence, int index) {                       \
+    return CONCAT_STR3(Get, name, At)(prefix, sequence, index);               \
+  }                                                                           \
   inline void CONCAT_STR2(Clear,                                              \
                           name)(tensorflow::SequenceExample * sequence) {     \
     CONCAT_STR2(Clear, name)(prefix, sequence);                               \
@@ -0,0 +1,500 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/sequence/media_sequence_view.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/port/status_macros.h"
+
+namespace mediapipe {
+namespace mediasequence {
+namespace {
+
+// Field numbers of tensorflow/core/example/example.proto and feature.proto.
+constexpr int kSequenceExampleContextField = 1;
+constexpr int kSequenceExampleFeatureListsField = 2;
+constexpr int kFeaturesFeatureField = 1;
+constexpr int kFeatureListsFeatureListField = 1;
+constexpr int kFeatureListFeatureField = 1;
+constexpr int kFeatureBytesListField = 1;
+constexpr int kFeatureFloatListField = 2;
+constexpr int kFeatureInt64ListField = 3;
+constexpr int kListValueField = 1;
+constexpr int kMapEntryKeyField = 1;
+constexpr int kMapEntryValueField = 2;
+
+constexpr int kVarintWireType = 0;
+constexpr int kFixed64WireType = 1;
+constexpr int kLengthDelimitedWireType = 2;
+constexpr int kFixed32WireType = 5;
+
+// Reads the protobuf wire format without copying it.
+class WireReader {
+ public:
+  explicit WireReader(absl::string_view data) : data_(data) {}
+
+  bool done() const { return pos_ == data_.size(); }
+  size_t position() const { return pos_; }
+
+  bool ReadVarint(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos_ == data_.size()) return false;
+      const uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+      *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+  }
+
+  bool ReadTag(int* field_number, int* wire_type) {
+    uint64_t tag;
+    if (!ReadVarint(&tag) || tag > UINT32_MAX) return false;
+    *field_number = static_cast<int>(tag >> 3);
+    *wire_type = static_cast<int>(tag & 7);
+    return *field_number > 0;
+  }
+
+  bool ReadLengthDelimited(absl::string_view* value) {
+    uint64_t length;
+    if (!ReadVarint(&length) || length > data_.size() - pos_) return false;
+    *value = data_.substr(pos_, length);
+    pos_ += length;
+    return true;
+  }
+
+  bool ReadFixed32(uint32_t* value) {
+    if (data_.size() - pos_ < 4) return false;
+    // The wire format is little-endian.
+    *value = 0;
+    for (int i = 3; i >= 0; --i) {
+      *value = (*value << 8) | static_cast<uint8_t>(data_[pos_ + i]);
+    }
+    pos_ += 4;
+    return true;
+  }
+
+  bool SkipField(int wire_type) {
+    uint64_t varint;
+    absl::string_view bytes;
+    switch (wire_type) {
+      case kVarintWireType:
+        return ReadVarint(&varint);
+      case kFixed64WireType:
+        if (data_.size() - pos_ < 8) return false;
+        pos_ += 8;
+        return true;
+      case kLengthDelimitedWireType:
+        return ReadLengthDelimited(&bytes);
+      case kFixed32WireType:
+        if (data_.size() - pos_ < 4) return false;
+        pos_ += 4;
+        return true;
+      default:
+        // Groups are not used by the example protos.
+        return false;
+    }
+  }
+
+ private:
+  absl::string_view data_;
+  size_t pos_ = 0;
+};
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+int ListFieldNumber(FeatureView::Kind kind) {
+  switch (kind) {
+    case FeatureView::Kind::kBytesList:
+      return kFeatureBytesListField;
+    case FeatureView::Kind::kFloatList:
+      return kFeatureFloatListField;
+    case FeatureView::Kind::kInt64List:
+      return kFeatureInt64ListField;
+    default:
+      return 0;
+  }
+}
+
+// Calls `fn` on the value field of each list of `kind` in the serialized
+// Feature `values`. Returns false if `values` is malformed.
+template <typename Fn>
+bool ForEachListValueField(FeatureView::Kind kind, absl::string_view values,
+                           Fn&& fn) {
+  const int list_field_number = ListFieldNumber(kind);
+  WireReader reader(values);
+  while (!reader.done()) {
+    int field_number, wire_type;
+    if (!reader.ReadTag(&field_number, &wire_type)) return false;
+    if (field_number != list_field_number) {
+      if (!reader.SkipField(wire_type)) return false;
+      continue;
+    }
+    absl::string_view list;
+    if (wire_type != kLengthDelimitedWireType ||
+        !reader.ReadLengthDelimited(&list)) {
+      return false;
+    }
+    WireReader list_reader(list);
+    while (!list_reader.done()) {
+      if (!list_reader.ReadTag(&field_number, &wire_type)) return false;
+      if (field_number != kListValueField) {
+        if (!list_reader.SkipField(wire_type)) return false;
+        continue;
+      }
+      if (!fn(wire_type, &list_reader)) return false;
+    }
+  }
+  return true;
+}
+
+// Calls `fn` on each bytes value of the serialized Feature `values`.
+template <typename Fn>
+bool ForEachBytes(absl::string_view values, Fn&& fn) {
+  return ForEachListValueField(
+      FeatureView::Kind::kBytesList, values,
+      [&fn](int wire_type, WireReader* reader) {
+        absl::string_view value;
+        if (wire_type != kLengthDelimitedWireType ||
+            !reader->ReadLengthDelimited(&value)) {
+          return false;
+        }
+        fn(value);
+        return true;
+      });
+}
+
+// Calls `fn` on each float value of the serialized Feature `values`, which
+// may be packed or not.
+template <typename Fn>
+bool ForEachFloat(absl::string_view values, Fn&& fn) {
+  return ForEachListValueField(
+      FeatureView::Kind::kFloatList, values,
+      [&fn](int wire_type, WireReader* reader) {
+        uint32_t bits;
+        if (wire_type == kFixed32WireType) {
+          if (!reader->ReadFixed32(&bits)) return false;
+          fn(BitsToFloat(bits));
+          return true;
+        }
+        absl::string_view packed;
+        if (wire_type != kLengthDelimitedWireType ||
+            !reader->ReadLengthDelimited(&packed) || packed.size() % 4 != 0) {
+          return false;
+        }
+        WireReader packed_reader(packed);
+        while (packed_reader.ReadFixed32(&bits)) {
+          fn(BitsToFloat(bits));
+        }
+        return true;
+      });
+}
+
+// Calls `fn` on each int64 value of the serialized Feature `values`, which
+// may be packed or not.
+template <typename Fn>
+bool ForEachInt64(absl::string_view values, Fn&& fn) {
+  return ForEachListValueField(
+      FeatureView::Kind::kInt64List, values,
+      [&fn](int wire_type, WireReader* reader) {
+        uint64_t value;
+        if (wire_type == kVarintWireType) {
+          if (!reader->ReadVarint(&value)) return false;
+          fn(static_cast<int64_t>(value));
+          return true;
+        }
+        absl::string_view packed;
+        if (wire_type != kLengthDelimitedWireType ||
+            !reader->ReadLengthDelimited(&packed)) {
+          return false;
+        }
+        WireReader packed_reader(packed);
+        while (!packed_reader.done()) {
+          if (!packed_reader.ReadVarint(&value)) return false;
+          fn(static_cast<int64_t>(value));
+        }
+        return true;
+      });
+}
+
+// Returns the number of values of the serialized Feature `values`, or -1 if
+// it is malformed.
+int CountValues(FeatureView::Kind kind, absl::string_view values) {
+  int count = 0;
+  auto counter = [&count](auto) { ++count; };
+  bool valid = true;
+  switch (kind) {
+    case FeatureView::Kind::kBytesList:
+      valid = ForEachBytes(values, counter);
+      break;
+    case FeatureView::Kind::kFloatList:
+      valid = ForEachFloat(values, counter);
+      break;
+    case FeatureView::Kind::kInt64List:
+      valid = ForEachInt64(values, counter);
+      break;
+    default:
+      break;
+  }
+  return valid ? count : -1;
+}
+
+absl::Status MalformedError(absl::string_view message) {
+  return absl::InvalidArgumentError(
+      absl::StrCat("Malformed serialized SequenceExample: ", message));
+}
+
+// Reads the key and the value of a serialized map entry.
+absl::Status ReadMapEntry(absl::string_view entry, absl::string_view* key,
+                          absl::string_view* value) {
+  *key = absl::string_view();
+  *value = absl::string_view();
+  WireReader reader(entry);
+  while (!reader.done()) {
+    int field_number, wire_type;
+    if (!reader.ReadTag(&field_number, &wire_type)) {
+      return MalformedError("invalid map entry tag");
+    }
+    if (field_number == kMapEntryKeyField ||
+        field_number == kMapEntryValueField) {
+      if (wire_type != kLengthDelimitedWireType ||
+          !reader.ReadLengthDelimited(field_number == kMapEntryKeyField
+                                          ? key
+                                          : value)) {
+        return MalformedError("invalid map entry field");
+      }
+    } else if (!reader.SkipField(wire_type)) {
+      return MalformedError("invalid map entry field");
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Calls `fn` on each length-delimited field `field_number` of `message`, and
+// skips the other fields.
+template <typename Fn>
+absl::Status ForEachMessageField(absl::string_view message, int field_number,
+                                 Fn&& fn) {
+  WireReader reader(message);
+  while (!reader.done()) {
+    int current_field_number, wire_type;
+    if (!reader.ReadTag(&current_field_number, &wire_type)) {
+      return MalformedError("invalid tag");
+    }
+    if (current_field_number != field_number) {
+      if (!reader.SkipField(wire_type)) {
+        return MalformedError("invalid field");
+      }
+      continue;
+    }
+    absl::string_view field;
+    if (wire_type != kLengthDelimitedWireType ||
+        !reader.ReadLengthDelimited(&field)) {
+      return MalformedError("invalid message field");
+    }
+    MP_RETURN_IF_ERROR(fn(field));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<FeatureView> FeatureView::Create(absl::string_view serialized) {
+  // Feature.kind is a oneof: the last list wins, and merges with the lists of
+  // the same kind right before it.
+  Kind kind = Kind::kNone;
+  size_t values_start = 0;
+  WireReader reader(serialized);
+  while (!reader.done()) {
+    const size_t field_start = reader.position();
+    int field_number, wire_type;
+    if (!reader.ReadTag(&field_number, &wire_type)) {
+      return MalformedError("invalid feature tag");
+    }
+    Kind field_kind = Kind::kNone;
+    if (field_number == kFeatureBytesListField) {
+      field_kind = Kind::kBytesList;
+    } else if (field_number == kFeatureFloatListField) {
+      field_kind = Kind::kFloatList;
+    } else if (field_number == kFeatureInt64ListField) {
+      field_kind = Kind::kInt64List;
+    }
+    if (field_kind != Kind::kNone && field_kind != kind) {
+      kind = field_kind;
+      values_start = field_start;
+    }
+    if (!reader.SkipField(wire_type)) {
+      return MalformedError("invalid feature field");
+    }
+  }
+  FeatureView feature(kind, serialized.substr(values_start));
+  if (CountValues(feature.kind_, feature.values_) < 0) {
+    return MalformedError("invalid feature values");
+  }
+  return feature;
+}
+
+int FeatureView::size() const {
+  const int count = CountValues(kind_, values_);
+  ABSL_DCHECK_GE(count, 0);
+  return count;
+}
+
+std::vector<absl::string_view> FeatureView::GetBytes() const {
+  std::vector<absl::string_view> values;
+  if (kind_ == Kind::kBytesList) {
+    ForEachBytes(values_, [&values](absl::string_view value) {
+      values.push_back(value);
+    });
+  }
+  return values;
+}
+
+std::vector<float> FeatureView::GetFloats() const {
+  std::vector<float> values;
+  if (kind_ == Kind::kFloatList) {
+    ForEachFloat(values_, [&values](float value) { values.push_back(value); });
+  }
+  return values;
+}
+
+std::vector<int64_t> FeatureView::GetInt64s() const {
+  std::vector<int64_t> values;
+  if (kind_ == Kind::kInt64List) {
+    ForEachInt64(values_,
+                 [&values](int64_t value) { values.push_back(value); });
+  }
+  return values;
+}
+
+absl::string_view FeatureView::GetBytesAt(int index) const {
+  ABSL_CHECK_EQ(static_cast<int>(kind_), static_cast<int>(Kind::kBytesList));
+  absl::string_view result;
+  int count = 0;
+  ForEachBytes(values_, [&](absl::string_view value) {
+    if (count++ == index) result = value;
+  });
+  ABSL_CHECK_LT(index, count);
+  return result;
+}
+
+float FeatureView::GetFloatAt(int index) const {
+  ABSL_CHECK_EQ(static_cast<int>(kind_), static_cast<int>(Kind::kFloatList));
+  float result = 0.0f;
+  int count = 0;
+  ForEachFloat(values_, [&](float value) {
+    if (count++ == index) result = value;
+  });
+  ABSL_CHECK_LT(index, count);
+  return result;
+}
+
+int64_t FeatureView::GetInt64At(int index) const {
+  ABSL_CHECK_EQ(static_cast<int>(kind_), static_cast<int>(Kind::kInt64List));
+  int64_t result = 0;
+  int count = 0;
+  ForEachInt64(values_, [&](int64_t value) {
+    if (count++ == index) result = value;
+  });
+  ABSL_CHECK_LT(index, count);
+  return result;
+}
+
+absl::StatusOr<SequenceExampleView> SequenceExampleView::Create(
+    absl::string_view serialized) {
+  SequenceExampleView view;
+  // Repeated occurrences of the context and feature_lists messages merge, so
+  // their map entries are collected across all occurrences, and the last
+  // entry with a given key wins.
+  MP_RETURN_IF_ERROR(ForEachMessageField(
+      serialized, kSequenceExampleContextField,
+      [&view](absl::string_view features) {
+        return ForEachMessageField(
+            features, kFeaturesFeatureField,
+            [&view](absl::string_view entry) -> absl::Status {
+              absl::string_view key, value;
+              MP_RETURN_IF_ERROR(ReadMapEntry(entry, &key, &value));
+              ASSIGN_OR_RETURN(FeatureView feature,
+                               FeatureView::Create(value));
+              view.context_.insert_or_assign(key, feature);
+              return absl::OkStatus();
+            });
+      }));
+  MP_RETURN_IF_ERROR(ForEachMessageField(
+      serialized, kSequenceExampleFeatureListsField,
+      [&view](absl::string_view feature_lists) {
+        return ForEachMessageField(
+            feature_lists, kFeatureListsFeatureListField,
+            [&view](absl::string_view entry) -> absl::Status {
+              absl::string_view key, value;
+              MP_RETURN_IF_ERROR(ReadMapEntry(entry, &key, &value));
+              std::vector<FeatureView> features;
+              MP_RETURN_IF_ERROR(ForEachMessageField(
+                  value, kFeatureListFeatureField,
+                  [&features](absl::string_view feature) -> absl::Status {
+                    ASSIGN_OR_RETURN(FeatureView feature_view,
+                                     FeatureView::Create(feature));
+                    features.push_back(feature_view);
+                    return absl::OkStatus();
+                  }));
+              view.feature_lists_.insert_or_assign(key, std::move(features));
+              return absl::OkStatus();
+            });
+      }));
+  return view;
+}
+
+bool SequenceExampleView::HasContext(absl::string_view key) const {
+  return context_.contains(key);
+}
+
+const FeatureView& SequenceExampleView::GetContext(
+    absl::string_view key) const {
+  const auto it = context_.find(key);
+  ABSL_CHECK(it != context_.end()) << "Could not find context key " << key;
+  return it->second;
+}
+
+bool SequenceExampleView::HasFeatureList(absl::string_view key) const {
+  return feature_lists_.contains(key);
+}
+
+int SequenceExampleView::GetFeatureListSize(absl::string_view key) const {
+  const auto it = feature_lists_.find(key);
+  return it == feature_lists_.end() ? 0 : it->second.size();
+}
+
+const FeatureView& SequenceExampleView::GetFeatureListAt(
+    absl::string_view key, int index) const {
+  const auto it = feature_lists_.find(key);
+  ABSL_CHECK(it != feature_lists_.end())
+      << "Could not find feature list key " << key;
+  ABSL_CHECK_LT(index, it->second.size());
+  return it->second[index];
+}
+
+}  // namespace mediasequence
+}  // namespace mediapipe
@@ -0,0 +1,126 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A read-only, zero-copy view of a serialized tensorflow.SequenceExample.
+//
+// Parsing a SequenceExample copies every feature, including large ones such as
+// encoded images, into the proto. SequenceExampleView instead indexes the
+// context features and the features of each feature list by their byte ranges
+// in the serialized proto, and only decodes the values of a feature when they
+// are read. Bytes values are returned as views of the serialized proto, which
+// must outlive the SequenceExampleView.
+//
+// The accessors in media_sequence_util.h and the feature list accessors
+// created by its macros, e.g. GetImageEncodedAt(), have overloads taking a
+// SequenceExampleView.
+
+#ifndef MEDIAPIPE_UTIL_SEQUENCE_MEDIA_SEQUENCE_VIEW_H_
+#define MEDIAPIPE_UTIL_SEQUENCE_MEDIA_SEQUENCE_VIEW_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace mediapipe {
+namespace mediasequence {
+
+// A view of a serialized tensorflow.Feature, whose values are decoded on each
+// call. The values of a kind other than kind() are empty, as in the proto.
+class FeatureView {
+ public:
+  enum class Kind { kNone, kBytesList, kFloatList, kInt64List };
+
+  FeatureView() = default;
+
+  Kind kind() const { return kind_; }
+
+  // Returns the number of values of the feature.
+  int size() const;
+
+  // Returns all the values of the feature. Bytes values are views of the
+  // serialized proto.
+  std::vector<absl::string_view> GetBytes() const;
+  std::vector<float> GetFloats() const;
+  std::vector<int64_t> GetInt64s() const;
+
+  // Returns the value at `index`, which must be less than size().
+  absl::string_view GetBytesAt(int index) const;
+  float GetFloatAt(int index) const;
+  int64_t GetInt64At(int index) const;
+
+ private:
+  friend class SequenceExampleView;
+
+  FeatureView(Kind kind, absl::string_view values)
+      : kind_(kind), values_(values) {}
+
+  // Creates a view of `serialized` after checking that it is a valid
+  // serialized Feature.
+  static absl::StatusOr<FeatureView> Create(absl::string_view serialized);
+
+  Kind kind_ = Kind::kNone;
+  // The serialized Feature from the first occurrence of the list of values of
+  // kind_ that is not followed by a list of another kind.
+  absl::string_view values_;
+};
+
+// A view of a serialized tensorflow.SequenceExample. Create() checks that the
+// whole proto is well-formed, so the accessors never fail on malformed input.
+//
+// Example usage:
+//   ASSIGN_OR_RETURN(auto view, SequenceExampleView::Create(serialized));
+//   for (int i = 0; i < GetImageEncodedSize(view); ++i) {
+//     absl::string_view encoded_image = GetImageEncodedAt(view, i);
+//     ...
+//   }
+class SequenceExampleView {
+ public:
+  // Creates a view of `serialized`, which must outlive the view. Returns an
+  // error if `serialized` is not a valid serialized SequenceExample.
+  static absl::StatusOr<SequenceExampleView> Create(
+      absl::string_view serialized);
+
+  // Returns true if the key is in the sequence's context.
+  bool HasContext(absl::string_view key) const;
+
+  // Returns the feature in context with the provided key, which must exist.
+  const FeatureView& GetContext(absl::string_view key) const;
+
+  // Returns true if the key is in the sequence's FeatureLists.
+  bool HasFeatureList(absl::string_view key) const;
+
+  // Returns the size of the FeatureList or 0 if the feature list is not
+  // present.
+  int GetFeatureListSize(absl::string_view key) const;
+
+  // Returns the feature of the feature list with the provided key, which must
+  // exist, at the provided sequence index.
+  const FeatureView& GetFeatureListAt(absl::string_view key, int index) const;
+
+ private:
+  SequenceExampleView() = default;
+
+  // The keys view the serialized proto.
+  absl::flat_hash_map<absl::string_view, FeatureView> context_;
+  absl::flat_hash_map<absl::string_view, std::vector<FeatureView>>
+      feature_lists_;
+};
+
+}  // namespace mediasequence
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_SEQUENCE_MEDIA_SEQUENCE_VIEW_H_
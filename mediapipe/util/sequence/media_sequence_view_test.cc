@@ -0,0 +1,162 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/sequence/media_sequence_view.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/util/sequence/media_sequence_util.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/example/feature.pb.h"
+
+namespace mediapipe {
+namespace mediasequence {
+namespace {
+
+using ::testing::ElementsAre;
+
+BYTES_FEATURE_LIST(StringFeatureList, "string_feature_list");
+INT64_FEATURE_LIST(Int64FeatureList, "int64_feature_list");
+FLOAT_FEATURE_LIST(FloatFeatureList, "float_feature_list");
+VECTOR_BYTES_FEATURE_LIST(VectorStringFeatureList,
+                          "vector_string_feature_list");
+VECTOR_INT64_FEATURE_LIST(VectorInt64FeatureList, "vector_int64_feature_list");
+VECTOR_FLOAT_FEATURE_LIST(VectorFloatFeatureList, "vector_float_feature_list");
+FIXED_PREFIX_BYTES_FEATURE_LIST(OneStringFeatureList, "string_feature_list",
+                                "ONE");
+
+// Returns true if `value` points into `buffer`.
+bool IsViewOf(absl::string_view value, absl::string_view buffer) {
+  return value.data() >= buffer.data() &&
+         value.data() + value.size() <= buffer.data() + buffer.size();
+}
+
+// Returns a length-delimited field with the tag byte `tag` and `payload`,
+// which must be shorter than 128 bytes.
+std::string Field(char tag, const std::string& payload) {
+  return std::string(1, tag) +
+         std::string(1, static_cast<char>(payload.size())) + payload;
+}
+
+TEST(MediaSequenceViewTest, ReadsContext) {
+  tensorflow::SequenceExample sequence;
+  SetContextBytes("bytes", "value", &sequence);
+  SetContextInt64List("int64s", std::vector<int64_t>{-3, 47}, &sequence);
+  SetContextFloatList("floats", std::vector<float>{0.5f, -1.5f}, &sequence);
+  const std::string serialized = sequence.SerializeAsString();
+
+  MP_ASSERT_OK_AND_ASSIGN(auto view, SequenceExampleView::Create(serialized));
+
+  EXPECT_FALSE(HasContext(view, "missing"));
+  ASSERT_TRUE(HasContext(view, "bytes"));
+  EXPECT_EQ(GetContext(view, "bytes").kind(), FeatureView::Kind::kBytesList);
+  EXPECT_EQ(GetContext(view, "bytes").GetBytesAt(0), "value");
+  EXPECT_TRUE(IsViewOf(GetContext(view, "bytes").GetBytesAt(0), serialized));
+  EXPECT_THAT(GetContext(view, "int64s").GetInt64s(), ElementsAre(-3, 47));
+  EXPECT_EQ(GetContext(view, "int64s").GetInt64At(1), 47);
+  EXPECT_THAT(GetContext(view, "floats").GetFloats(), ElementsAre(0.5f, -1.5f));
+  EXPECT_EQ(GetContext(view, "floats").size(), 2);
+  // Values of another kind are empty, as in the proto.
+  EXPECT_TRUE(GetContext(view, "floats").GetBytes().empty());
+}
+
+TEST(MediaSequenceViewTest, ReadsFeatureLists) {
+  tensorflow::SequenceExample sequence;
+  AddStringFeatureList("string1", &sequence);
+  AddStringFeatureList("string2", &sequence);
+  AddInt64FeatureList(-47, &sequence);
+  AddFloatFeatureList(0.25f, &sequence);
+  AddVectorStringFeatureList(std::vector<std::string>{"a", "b"}, &sequence);
+  AddVectorInt64FeatureList(std::vector<int64_t>{1, 1LL << 40}, &sequence);
+  AddVectorFloatFeatureList(std::vector<float>{1.0f, 2.0f}, &sequence);
+  AddOneStringFeatureList("one", &sequence);
+  const std::string serialized = sequence.SerializeAsString();
+
+  MP_ASSERT_OK_AND_ASSIGN(auto view, SequenceExampleView::Create(serialized));
+
+  ASSERT_TRUE(HasStringFeatureList(view));
+  ASSERT_EQ(GetStringFeatureListSize(view), 2);
+  EXPECT_EQ(GetStringFeatureListAt(view, 0), "string1");
+  EXPECT_EQ(GetStringFeatureListAt(view, 1), "string2");
+  EXPECT_TRUE(IsViewOf(GetStringFeatureListAt(view, 1), serialized));
+  EXPECT_EQ(GetInt64FeatureListAt(view, 0), -47);
+  EXPECT_EQ(GetFloatFeatureListAt(view, 0), 0.25f);
+  EXPECT_THAT(GetVectorStringFeatureListAt(view, 0), ElementsAre("a", "b"));
+  EXPECT_THAT(GetVectorInt64FeatureListAt(view, 0),
+              ElementsAre(1, 1LL << 40));
+  EXPECT_THAT(GetVectorFloatFeatureListAt(view, 0), ElementsAre(1.0f, 2.0f));
+  ASSERT_TRUE(HasOneStringFeatureList(view));
+  EXPECT_EQ(GetOneStringFeatureListAt(view, 0), "one");
+  EXPECT_EQ(GetStringFeatureListAt("ONE", view, 0), "one");
+}
+
+TEST(MediaSequenceViewTest, MissingFeatureListIsEmpty) {
+  tensorflow::SequenceExample sequence;
+  AddStringFeatureList("string1", &sequence);
+  const std::string serialized = sequence.SerializeAsString();
+
+  MP_ASSERT_OK_AND_ASSIGN(auto view, SequenceExampleView::Create(serialized));
+
+  EXPECT_FALSE(HasInt64FeatureList(view));
+  EXPECT_EQ(GetInt64FeatureListSize(view), 0);
+}
+
+TEST(MediaSequenceViewTest, ReadsUnpackedValuesAndLastListOfOneof) {
+  // The unpacked floats 1.0 and 2.0, and the unpacked int64s 3 and 4.
+  const std::string float_values("\x0d\x00\x00\x80\x3f\x0d\x00\x00\x00\x40",
+                                 10);
+  const std::string int64_values("\x08\x03\x08\x04", 4);
+  // A FeatureList with a float Feature, an int64 Feature, and a Feature with a
+  // BytesList followed by a FloatList, of which only the last one is set.
+  const std::string feature_list =
+      Field('\x0a', Field('\x12', float_values)) +
+      Field('\x0a', Field('\x1a', int64_values)) +
+      Field('\x0a', Field('\x0a', Field('\x0a', "bytes")) +
+                        Field('\x12', float_values));
+  const std::string serialized = Field(
+      '\x12',
+      Field('\x0a', Field('\x0a', "list") + Field('\x12', feature_list)));
+
+  MP_ASSERT_OK_AND_ASSIGN(auto view, SequenceExampleView::Create(serialized));
+
+  ASSERT_EQ(GetFeatureListSize(view, "list"), 3);
+  EXPECT_THAT(GetFloatsAt(view, "list", 0), ElementsAre(1.0f, 2.0f));
+  EXPECT_THAT(GetInt64sAt(view, "list", 1), ElementsAre(3, 4));
+  EXPECT_EQ(GetFeatureAt(view, "list", 2).kind(),
+            FeatureView::Kind::kFloatList);
+  EXPECT_THAT(GetFloatsAt(view, "list", 2), ElementsAre(1.0f, 2.0f));
+  EXPECT_TRUE(GetBytesAt(view, "list", 2).empty());
+}
+
+TEST(MediaSequenceViewTest, FailsOnMalformedInput) {
+  tensorflow::SequenceExample sequence;
+  AddStringFeatureList("string1", &sequence);
+  const std::string serialized = sequence.SerializeAsString();
+
+  auto view = SequenceExampleView::Create(
+      absl::string_view(serialized).substr(0, serialized.size() - 1));
+
+  EXPECT_EQ(view.status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace mediasequence
+}  // namespace mediapipe
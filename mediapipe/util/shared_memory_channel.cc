@@ -0,0 +1,309 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/shared_memory_channel.h"
+
+#if !defined(__ANDROID__) && !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // !defined(__ANDROID__) && !defined(_WIN32)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/util/packet_payload.h"
+
+namespace mediapipe {
+
+namespace shared_memory_channel_internal {
+
+// The start of the shared memory object, followed by the ring buffer.
+struct Header {
+  // Set by the creator of the channel once the capacity is set.
+  std::atomic<uint32_t> initialized;
+  uint64_t capacity;
+  // The numbers of bytes written and read since the channel was created. Only
+  // the writer stores write_position and only the reader stores
+  // read_position. They are kept on separate cache lines.
+  alignas(64) std::atomic<uint64_t> write_position;
+  alignas(64) std::atomic<uint64_t> read_position;
+};
+
+// Precedes each message in the ring buffer, followed by the message type name
+// and the payload bytes of a packet.
+struct MessageHeader {
+  uint32_t kind;
+  uint32_t type_name_size;
+  int64_t timestamp;
+  uint64_t payload_size;
+  PacketPayloadHeader payload;
+};
+
+}  // namespace shared_memory_channel_internal
+
+namespace {
+
+using shared_memory_channel_internal::Header;
+using shared_memory_channel_internal::MessageHeader;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "The ring buffer positions must be lock-free to be shared.");
+
+// The interval at which a waiting writer or reader checks the ring buffer.
+constexpr absl::Duration kPollInterval = absl::Microseconds(50);
+
+// Returns the number of bytes of a message in the ring buffer, which keeps
+// messages 8-byte aligned.
+uint64_t MessageSize(const MessageHeader& message) {
+  uint64_t size =
+      sizeof(message) + message.type_name_size + message.payload_size;
+  return (size + 7) & ~uint64_t{7};
+}
+
+}  // namespace
+
+SharedMemoryChannel::SharedMemoryChannel(void* mapping, size_t mapping_size)
+    : mapping_(mapping),
+      mapping_size_(mapping_size),
+      header_(static_cast<Header*>(mapping)),
+      ring_(static_cast<uint8_t*>(mapping) + sizeof(Header)),
+      capacity_(0) {}
+
+#if !defined(__ANDROID__) && !defined(_WIN32)
+
+// static
+absl::StatusOr<std::unique_ptr<SharedMemoryChannel>> SharedMemoryChannel::Open(
+    const std::string& name, size_t capacity, absl::Duration timeout) {
+  const std::string shm_name = absl::StrCat("/", name);
+  const absl::Time deadline = absl::Now() + timeout;
+  bool created = true;
+  int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0 && errno == EEXIST) {
+    created = false;
+    fd = shm_open(shm_name.c_str(), O_RDWR, 0600);
+  }
+  if (fd < 0) {
+    return absl::InternalError(
+        absl::StrCat("Can't open shared memory channel ", name, ": ",
+                     std::strerror(errno)));
+  }
+  size_t size = sizeof(Header) + capacity;
+  if (created) {
+    if (capacity == 0 || ftruncate(fd, size) != 0) {
+      close(fd);
+      shm_unlink(shm_name.c_str());
+      return absl::InternalError(
+          absl::StrCat("Can't allocate ", capacity,
+                       " bytes for shared memory channel ", name));
+    }
+  } else {
+    // Waits for the creator to allocate the channel.
+    struct stat file_stat;
+    while (fstat(fd, &file_stat) == 0 && file_stat.st_size < sizeof(Header)) {
+      if (absl::Now() >= deadline) {
+        close(fd);
+        return absl::DeadlineExceededError(absl::StrCat(
+            "Shared memory channel ", name, " was not initialized."));
+      }
+      absl::SleepFor(kPollInterval);
+    }
+    size = file_stat.st_size;
+  }
+  void* mapping = mmap(/*addr=*/nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, /*offset=*/0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return absl::InternalError(
+        absl::StrCat("Can't map shared memory channel ", name));
+  }
+  auto channel = absl::WrapUnique(new SharedMemoryChannel(mapping, size));
+  Header* header = channel->header_;
+  if (created) {
+    header->capacity = capacity;
+    header->initialized.store(1, std::memory_order_release);
+  } else {
+    while (header->initialized.load(std::memory_order_acquire) == 0) {
+      if (absl::Now() >= deadline) {
+        return absl::DeadlineExceededError(absl::StrCat(
+            "Shared memory channel ", name, " was not initialized."));
+      }
+      absl::SleepFor(kPollInterval);
+    }
+    RET_CHECK_EQ(sizeof(Header) + header->capacity, size)
+        << "Shared memory channel " << name << " is corrupt.";
+  }
+  channel->capacity_ = header->capacity;
+  return channel;
+}
+
+// static
+absl::Status SharedMemoryChannel::Unlink(const std::string& name) {
+  if (shm_unlink(absl::StrCat("/", name).c_str()) != 0 && errno != ENOENT) {
+    return absl::InternalError(
+        absl::StrCat("Can't unlink shared memory channel ", name, ": ",
+                     std::strerror(errno)));
+  }
+  return absl::OkStatus();
+}
+
+SharedMemoryChannel::~SharedMemoryChannel() { munmap(mapping_, mapping_size_); }
+
+#else
+
+// static
+absl::StatusOr<std::unique_ptr<SharedMemoryChannel>> SharedMemoryChannel::Open(
+    const std::string& name, size_t capacity, absl::Duration timeout) {
+  return absl::UnimplementedError(
+      "Shared memory channels are not available on this platform.");
+}
+
+// static
+absl::Status SharedMemoryChannel::Unlink(const std::string& name) {
+  return absl::UnimplementedError(
+      "Shared memory channels are not available on this platform.");
+}
+
+SharedMemoryChannel::~SharedMemoryChannel() = default;
+
+#endif  // !defined(__ANDROID__) && !defined(_WIN32)
+
+absl::Status SharedMemoryChannel::WritePacket(const Packet& packet,
+                                              absl::Duration timeout) {
+  PacketPayload payload;
+  MP_RETURN_IF_ERROR(GetPacketPayload(packet, &payload));
+  return Write(Message::Kind::kPacket, packet.Timestamp(), &payload, timeout);
+}
+
+absl::Status SharedMemoryChannel::WriteTimestampBound(Timestamp bound,
+                                                      absl::Duration timeout) {
+  return Write(Message::Kind::kTimestampBound, bound, nullptr, timeout);
+}
+
+absl::Status SharedMemoryChannel::WriteClose(absl::Duration timeout) {
+  return Write(Message::Kind::kClose, Timestamp::Unset(), nullptr, timeout);
+}
+
+absl::Status SharedMemoryChannel::Write(Message::Kind kind,
+                                        Timestamp timestamp,
+                                        const PacketPayload* payload,
+                                        absl::Duration timeout) {
+  MessageHeader message = {};
+  message.kind = static_cast<uint32_t>(kind);
+  message.timestamp = timestamp.Value();
+  if (payload != nullptr) {
+    message.type_name_size = payload->type_name.size();
+    message.payload_size = payload->size;
+    message.payload = payload->header;
+  }
+  const uint64_t size = MessageSize(message);
+  RET_CHECK_LE(size, capacity_) << "A message of " << size
+                                << " bytes does not fit into the channel.";
+
+  const uint64_t write_position =
+      header_->write_position.load(std::memory_order_relaxed);
+  const absl::Time deadline = absl::Now() + timeout;
+  while (write_position + size -
+             header_->read_position.load(std::memory_order_acquire) >
+         capacity_) {
+    if (absl::Now() >= deadline) {
+      return absl::DeadlineExceededError("The shared memory channel is full.");
+    }
+    absl::SleepFor(kPollInterval);
+  }
+  uint64_t position = write_position;
+  CopyToRing(position, &message, sizeof(message));
+  position += sizeof(message);
+  if (payload != nullptr) {
+    CopyToRing(position, payload->type_name.data(), message.type_name_size);
+    position += message.type_name_size;
+    CopyToRing(position, payload->data, payload->size);
+  }
+  header_->write_position.store(write_position + size,
+                                std::memory_order_release);
+  return absl::OkStatus();
+}
+
+absl::StatusOr<SharedMemoryChannel::Message> SharedMemoryChannel::Read(
+    absl::Duration timeout) {
+  const uint64_t read_position =
+      header_->read_position.load(std::memory_order_relaxed);
+  const absl::Time deadline = absl::Now() + timeout;
+  while (header_->write_position.load(std::memory_order_acquire) ==
+         read_position) {
+    if (absl::Now() >= deadline) {
+      return absl::DeadlineExceededError(
+          "No message was written to the shared memory channel.");
+    }
+    absl::SleepFor(kPollInterval);
+  }
+  MessageHeader message;
+  CopyFromRing(read_position, &message, sizeof(message));
+  const uint64_t size = MessageSize(message);
+  RET_CHECK_LE(size, capacity_) << "The shared memory channel is corrupt.";
+  RET_CHECK_LE(message.kind, static_cast<uint32_t>(Message::Kind::kClose))
+      << "The shared memory channel is corrupt.";
+
+  Message result;
+  result.kind = static_cast<Message::Kind>(message.kind);
+  if (result.kind == Message::Kind::kPacket) {
+    uint64_t position = read_position + sizeof(message);
+    std::string type_name(message.type_name_size, '\0');
+    CopyFromRing(position, type_name.data(), type_name.size());
+    position += type_name.size();
+    std::shared_ptr<uint8_t[]> data(new uint8_t[message.payload_size]);
+    CopyFromRing(position, data.get(), message.payload_size);
+    ASSIGN_OR_RETURN(
+        Packet packet,
+        MakePacketFromPayload(message.payload, type_name, data.get(),
+                              message.payload_size, data));
+    result.packet =
+        packet.At(Timestamp::CreateNoErrorChecking(message.timestamp));
+  } else if (result.kind == Message::Kind::kTimestampBound) {
+    result.bound = Timestamp::CreateNoErrorChecking(message.timestamp);
+  }
+  header_->read_position.store(read_position + size,
+                               std::memory_order_release);
+  return result;
+}
+
+void SharedMemoryChannel::CopyToRing(uint64_t position, const void* data,
+                                     size_t size) {
+  if (size == 0) return;
+  const uint64_t offset = position % capacity_;
+  const size_t first = std::min<uint64_t>(size, capacity_ - offset);
+  std::memcpy(ring_ + offset, data, first);
+  std::memcpy(ring_, static_cast<const uint8_t*>(data) + first, size - first);
+}
+
+void SharedMemoryChannel::CopyFromRing(uint64_t position, void* data,
+                                       size_t size) const {
+  if (size == 0) return;
+  const uint64_t offset = position % capacity_;
+  const size_t first = std::min<uint64_t>(size, capacity_ - offset);
+  std::memcpy(data, ring_ + offset, first);
+  std::memcpy(static_cast<uint8_t*>(data) + first, ring_, size - first);
+}
+
+}  // namespace mediapipe
@@ -0,0 +1,108 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_SHARED_MEMORY_CHANNEL_H_
+#define MEDIAPIPE_UTIL_SHARED_MEMORY_CHANNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/timestamp.h"
+
+namespace mediapipe {
+
+struct PacketPayload;
+
+namespace shared_memory_channel_internal {
+struct Header;
+}  // namespace shared_memory_channel_internal
+
+// A queue of packets and timestamp bounds in a named POSIX shared memory
+// object, which lets one process send a stream to a graph in another process.
+// The channel has a single writer and a single reader, which share a ring
+// buffer of a fixed capacity without locks. The writer waits while the ring
+// buffer is full, and the reader waits while it is empty.
+//
+// The packets are copied into the ring buffer as raw payload bytes, as
+// described in packet_payload.h, and copied out once by the reader, which
+// wraps ImageFrame pixels without another copy. Both processes must use the
+// same byte order and the same layout of the payload types.
+//
+// Shared memory channels are not available on Android and Windows.
+class SharedMemoryChannel {
+ public:
+  // A message read from the channel.
+  struct Message {
+    enum class Kind { kPacket, kTimestampBound, kClose };
+    Kind kind;
+    // The packet, with its timestamp, if kind is kPacket.
+    Packet packet;
+    // The timestamp bound, if kind is kTimestampBound.
+    Timestamp bound;
+  };
+
+  // Opens the channel with the given name, creating it with a ring buffer of
+  // `capacity` bytes if it does not exist yet. If it exists, its capacity is
+  // kept, and this waits up to `timeout` for its creator to initialize it.
+  static absl::StatusOr<std::unique_ptr<SharedMemoryChannel>> Open(
+      const std::string& name, size_t capacity, absl::Duration timeout);
+
+  // Removes the name of a channel. The processes that opened the channel can
+  // still use it, and the memory is freed when the last one closes it.
+  static absl::Status Unlink(const std::string& name);
+
+  ~SharedMemoryChannel();
+
+  // Writes a packet of a type supported by GetPacketPayload(). Waits up to
+  // `timeout` for room in the ring buffer.
+  absl::Status WritePacket(const Packet& packet, absl::Duration timeout);
+
+  // Announces that the packets written next have timestamps of at least
+  // `bound`.
+  absl::Status WriteTimestampBound(Timestamp bound, absl::Duration timeout);
+
+  // Announces that no more messages will be written.
+  absl::Status WriteClose(absl::Duration timeout);
+
+  // Reads the next message. Returns a DeadlineExceededError if none was
+  // written within `timeout`.
+  absl::StatusOr<Message> Read(absl::Duration timeout);
+
+ private:
+  SharedMemoryChannel(void* mapping, size_t mapping_size);
+
+  // Writes a message of the given kind. The payload must be set for packets.
+  absl::Status Write(Message::Kind kind, Timestamp timestamp,
+                     const PacketPayload* payload,
+                     absl::Duration timeout);
+  // Copies bytes to and from the ring buffer at a position that may wrap.
+  void CopyToRing(uint64_t position, const void* data, size_t size);
+  void CopyFromRing(uint64_t position, void* data, size_t size) const;
+
+  void* mapping_;
+  size_t mapping_size_;
+  shared_memory_channel_internal::Header* header_;
+  uint8_t* ring_;
+  uint64_t capacity_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_SHARED_MEMORY_CHANNEL_H_
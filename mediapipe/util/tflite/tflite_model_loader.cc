@@ -14,7 +14,10 @@
 
 #include "mediapipe/util/tflite/tflite_model_loader.h"
 
+#include <memory>
+
 #include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/util/mapped_file_contents.h"
 #include "mediapipe/util/resource_util.h"
 
 namespace mediapipe {
@@ -25,6 +28,27 @@ absl::StatusOr<api2::Packet<TfLiteModelPtr>> TfLiteModelLoader::LoadFromPath(
     const std::string& path) {
   std::string model_path = path;
 
+  // Models in files are memory-mapped rather than copied into memory, unless
+  // resources come from a custom provider.
+  if (!HasCustomGlobalResourceProvider()) {
+    auto resolved_path = mediapipe::PathToResourceAsFile(model_path);
+    if (resolved_path.ok()) {
+      auto mapping = MappedFileContents::Open(*resolved_path);
+      if (mapping.ok()) {
+        std::shared_ptr<MappedFileContents> model_contents =
+            *std::move(mapping);
+        auto model = FlatBufferModel::VerifyAndBuildFromBuffer(
+            model_contents->data(), model_contents->size());
+        RET_CHECK(model) << "Failed to load model from path " << model_path;
+        return api2::MakePacket<TfLiteModelPtr>(
+            model.release(), [model_contents](FlatBufferModel* model) {
+              // The mapping is released only after the model is deleted.
+              delete model;
+            });
+      }
+    }
+  }
+
   std::string model_blob;
   auto status_or_content =
       mediapipe::GetResourceContents(model_path, &model_blob);
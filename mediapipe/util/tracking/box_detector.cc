@@ -14,6 +14,7 @@
 
 #include "mediapipe/util/tracking/box_detector.h"
 
+#include <memory>
 #include <vector>
 
 #include "absl/log/absl_check.h"
@@ -94,10 +95,43 @@ class BoxDetectorOpencvBfImpl : public BoxDetectorInterface {
   cv::BFMatcher bf_matcher_;
 };
 
+// Using OpenCV FLANN based matcher with a KD-tree index per box to conduct
+// approximate queries. The index of a box is rebuilt on its first query after
+// features were added to the box, so that boxes added by DetectAndAddBox are
+// indexed as they come. Instead of the cross validation of the brute force
+// matcher, each index feature only keeps its closest match among the frame
+// features.
+class BoxDetectorOpencvFlannImpl : public BoxDetectorInterface {
+ public:
+  explicit BoxDetectorOpencvFlannImpl(const BoxDetectorOptions &options);
+
+ private:
+  struct BoxIndex {
+    // The box descriptors the matcher was trained with. Adding features to a
+    // box replaces its descriptors, so a different data pointer means that
+    // the matcher needs to be trained again.
+    cv::Mat descriptors;
+    std::unique_ptr<cv::FlannBasedMatcher> matcher;
+  };
+
+  std::vector<FeatureCorrespondence> MatchFeatureDescriptors(
+      const std::vector<Vector2_f> &features, const cv::Mat &descriptors,
+      int box_idx) override;
+
+  // Returns the matcher for the box with `box_idx`, trained with the current
+  // box descriptors.
+  cv::FlannBasedMatcher &GetBoxMatcher(int box_idx);
+
+  // Box indices by box ID, as box_idx changes when boxes are canceled.
+  absl::flat_hash_map<int, BoxIndex> box_indices_;
+};
+
 std::unique_ptr<BoxDetectorInterface> BoxDetectorInterface::Create(
     const BoxDetectorOptions &options) {
   if (options.index_type() == BoxDetectorOptions::OPENCV_BF) {
     return absl::make_unique<BoxDetectorOpencvBfImpl>(options);
+  } else if (options.index_type() == BoxDetectorOptions::OPENCV_FLANN) {
+    return absl::make_unique<BoxDetectorOpencvFlannImpl>(options);
   } else {
     ABSL_LOG(FATAL) << "index type undefined.";
   }
@@ -749,4 +783,86 @@ BoxDetectorOpencvBfImpl::MatchFeatureDescriptors(
   return correspondence_result;
 }
 
+BoxDetectorOpencvFlannImpl::BoxDetectorOpencvFlannImpl(
+    const BoxDetectorOptions &options)
+    : BoxDetectorInterface(options) {}
+
+cv::FlannBasedMatcher &BoxDetectorOpencvFlannImpl::GetBoxMatcher(int box_idx) {
+  // Drop the indices of canceled boxes.
+  if (box_indices_.size() > box_idx_to_id_.size()) {
+    for (auto iter = box_indices_.begin(); iter != box_indices_.end();) {
+      if (box_id_to_idx_.contains(iter->first)) {
+        ++iter;
+      } else {
+        box_indices_.erase(iter++);
+      }
+    }
+  }
+
+  BoxIndex &box_index = box_indices_[box_idx_to_id_[box_idx]];
+  const cv::Mat &box_descriptors = feature_descriptors_[box_idx];
+  if (box_index.matcher == nullptr ||
+      box_index.descriptors.data != box_descriptors.data ||
+      box_index.descriptors.rows != box_descriptors.rows) {
+    box_index.descriptors = box_descriptors;
+    box_index.matcher = absl::make_unique<cv::FlannBasedMatcher>(
+        cv::makePtr<cv::flann::KDTreeIndexParams>(options_.flann_num_trees()),
+        cv::makePtr<cv::flann::SearchParams>(options_.flann_num_checks()));
+    box_index.matcher->add(std::vector<cv::Mat>{box_index.descriptors});
+    box_index.matcher->train();
+  }
+  return *box_index.matcher;
+}
+
+std::vector<FeatureCorrespondence>
+BoxDetectorOpencvFlannImpl::MatchFeatureDescriptors(
+    const std::vector<Vector2_f> &features, const cv::Mat &descriptors,
+    int box_idx) {
+  ABSL_CHECK_EQ(features.size(), descriptors.rows);
+
+  std::vector<FeatureCorrespondence> correspondence_result(
+      frame_box_[box_idx].size());
+  if (features.empty() || descriptors.rows == 0 || descriptors.cols == 0) {
+    return correspondence_result;
+  }
+
+  // The KD-tree index only supports float descriptors, like the ones stored
+  // in the box index.
+  cv::Mat query_descriptors = descriptors;
+  if (descriptors.type() != CV_32F) {
+    descriptors.convertTo(query_descriptors, CV_32F);
+  }
+
+  std::vector<cv::DMatch> matches;
+  GetBoxMatcher(box_idx).match(query_descriptors, matches);
+
+  // Keep the closest frame feature of each index feature within the max match
+  // distance.
+  std::vector<int> best_match_by_index_feature(
+      feature_descriptors_[box_idx].rows, -1);
+  for (int j = 0; j < matches.size(); ++j) {
+    const cv::DMatch &match = matches[j];
+    if (match.distance > options_.max_match_distance()) continue;
+    int &best_match = best_match_by_index_feature[match.trainIdx];
+    if (best_match < 0 || match.distance < matches[best_match].distance) {
+      best_match = j;
+    }
+  }
+
+  for (int j = 0; j < matches.size(); ++j) {
+    const cv::DMatch &match = matches[j];
+    if (best_match_by_index_feature[match.trainIdx] != j) continue;
+
+    int match_idx = feature_to_frame_[box_idx][match.trainIdx];
+
+    correspondence_result[match_idx].points_frame.push_back(cv::Point2f(
+        features[match.queryIdx].x(), features[match.queryIdx].y()));
+    correspondence_result[match_idx].points_index.push_back(
+        cv::Point2f(feature_keypoints_[box_idx][match.trainIdx].x(),
+                    feature_keypoints_[box_idx][match.trainIdx].y()));
+  }
+
+  return correspondence_result;
+}
+
 }  // namespace mediapipe
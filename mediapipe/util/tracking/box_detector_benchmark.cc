@@ -0,0 +1,106 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks detecting every box of an index in a frame, by the number of
+// boxes in the index, with the brute force and the FLANN based index types.
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/util/tracking/box_detector.h"
+#include "mediapipe/util/tracking/box_detector.pb.h"
+#include "mediapipe/util/tracking/box_tracker.pb.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr int kFeaturesPerBox = 100;
+constexpr int kFrameFeatures = 500;
+constexpr int kDescriptorDims = 40;
+
+// Detects the boxes of an index with arbitrary descriptors. The frame features
+// are the features of the first boxes, moved and with noisy descriptors.
+void BM_DetectBoxes(benchmark::State& state,
+                    BoxDetectorOptions::IndexType index_type) {
+  const int num_boxes = state.range(0);
+  std::mt19937 rng(/*seed=*/1234);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  std::normal_distribution<float> noise(0.0f, 0.01f);
+
+  BoxDetectorIndex index;
+  std::vector<Vector2_f> index_keypoints;
+  std::vector<std::vector<float>> index_descriptors;
+  for (int box = 0; box < num_boxes; ++box) {
+    BoxDetectorIndex::BoxEntry::FrameEntry* frame_entry =
+        index.add_box_entry()->add_frame_entry();
+    TimedBoxProto* timed_box = frame_entry->mutable_box();
+    timed_box->set_id(box);
+    timed_box->set_left(0.1f);
+    timed_box->set_top(0.1f);
+    timed_box->set_right(0.9f);
+    timed_box->set_bottom(0.9f);
+    timed_box->set_reacquisition(true);
+    for (int k = 0; k < kFeaturesPerBox; ++k) {
+      index_keypoints.emplace_back(0.2f + 0.6f * uniform(rng),
+                                   0.2f + 0.6f * uniform(rng));
+      frame_entry->add_keypoints(index_keypoints.back().x());
+      frame_entry->add_keypoints(index_keypoints.back().y());
+      std::vector<float>& descriptor = index_descriptors.emplace_back();
+      for (int d = 0; d < kDescriptorDims; ++d) {
+        descriptor.push_back(uniform(rng));
+      }
+      frame_entry->add_descriptors()->set_data(
+          descriptor.data(), descriptor.size() * sizeof(float));
+    }
+  }
+
+  std::vector<Vector2_f> features;
+  cv::Mat descriptors(kFrameFeatures, kDescriptorDims, CV_32F);
+  for (int j = 0; j < kFrameFeatures; ++j) {
+    const int k = j % index_keypoints.size();
+    features.push_back(index_keypoints[k] + Vector2_f(0.02f, 0.01f));
+    for (int d = 0; d < kDescriptorDims; ++d) {
+      descriptors.at<float>(j, d) = index_descriptors[k][d] + noise(rng);
+    }
+  }
+
+  BoxDetectorOptions options;
+  options.set_index_type(index_type);
+  std::unique_ptr<BoxDetectorInterface> detector =
+      BoxDetectorInterface::Create(options);
+  detector->AddBoxDetectorIndex(index);
+
+  for (auto _ : state) {
+    TimedBoxProtoList detected_boxes;
+    detector->DetectAndAddBoxFromFeatures(
+        features, descriptors, TimedBoxProtoList(), /*timestamp_msec=*/0,
+        /*scale_x=*/1.0f, /*scale_y=*/1.0f, &detected_boxes);
+    benchmark::DoNotOptimize(detected_boxes);
+  }
+  state.SetItemsProcessed(state.iterations() * num_boxes);
+}
+BENCHMARK_CAPTURE(BM_DetectBoxes, OpencvBf, BoxDetectorOptions::OPENCV_BF)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(500);
+BENCHMARK_CAPTURE(BM_DetectBoxes, OpencvFlann,
+                  BoxDetectorOptions::OPENCV_FLANN)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(500);
+
+}  // namespace
+}  // namespace mediapipe
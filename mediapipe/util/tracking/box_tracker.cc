@@ -17,7 +17,9 @@
 #include <sys/stat.h>
 
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -27,6 +29,7 @@
 #include "absl/time/time.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/port/logging.h"
+#include "mediapipe/util/tracking/compact_tracking_data.h"
 #include "mediapipe/util/tracking/measure_time.h"
 #include "mediapipe/util/tracking/tracking.pb.h"
 
@@ -232,19 +235,36 @@ TimedBoxProto TimedBox::ToProto() const {
 }
 
 BoxTracker::BoxTracker(const std::string& cache_dir,
-                       const BoxTrackerOptions& options)
-    : options_(options), cache_dir_(cache_dir) {
-  tracking_workers_.reset(new ThreadPool(options_.num_tracking_workers()));
-  tracking_workers_->StartWorkers();
+                       const BoxTrackerOptions& options, Executor* executor)
+    : options_(options), cache_dir_(cache_dir), executor_(executor) {
+  if (executor_ == nullptr) {
+    tracking_workers_.reset(new ThreadPool(options_.num_tracking_workers()));
+    tracking_workers_->StartWorkers();
+  }
 }
 
 BoxTracker::BoxTracker(
     const std::vector<const TrackingDataChunk*>& tracking_data, bool copy_data,
-    const BoxTrackerOptions& options)
-    : BoxTracker("", options) {
+    const BoxTrackerOptions& options, Executor* executor)
+    : BoxTracker("", options, executor) {
   AddTrackingDataChunks(tracking_data, copy_data);
 }
 
+BoxTracker::~BoxTracker() {
+  // Own workers are joined on destruction, external executors are not.
+  if (executor_ != nullptr) {
+    WaitForAllOngoingTracks();
+  }
+}
+
+void BoxTracker::ScheduleTracking(std::function<void()> task) {
+  if (executor_ != nullptr) {
+    executor_->Schedule(std::move(task));
+  } else {
+    tracking_workers_->Schedule(std::move(task));
+  }
+}
+
 void BoxTracker::AddTrackingDataChunk(const TrackingDataChunk* chunk,
                                       bool copy_data) {
   ABSL_CHECK_GT(chunk->item_size(), 0) << "Empty chunk.";
@@ -289,7 +309,7 @@ void BoxTracker::NewBoxTrack(const TimedBox& initial_pos, int id,
     this->NewBoxTrackAsync(initial_pos, id, min_msec, max_msec);
   };
 
-  tracking_workers_->Schedule(operation);
+  ScheduleTracking(operation);
 }
 
 std::pair<int64_t, int64_t> BoxTracker::TrackInterval(int id) {
@@ -392,7 +412,7 @@ void BoxTracker::NewBoxTrackAsync(const TimedBox& initial_pos, int id,
                                         min_msec, max_msec));
   };
 
-  tracking_workers_->Schedule(forward_operation);
+  ScheduleTracking(forward_operation);
 
   // Track backward.
   auto backward_operation = [this, backward_chunk, start_state, start_frame,
@@ -402,7 +422,7 @@ void BoxTracker::NewBoxTrackAsync(const TimedBox& initial_pos, int id,
                                         false, true, min_msec, max_msec));
   };
 
-  tracking_workers_->Schedule(backward_operation);
+  ScheduleTracking(backward_operation);
 
   DoneSchedulingId(id);
 
@@ -638,7 +658,14 @@ std::unique_ptr<TrackingDataChunk> BoxTracker::ReadChunkFromCache(
   in.read(&data[0], data.size());
   in.close();
 
-  chunk_data->ParseFromString(data);
+  if (IsCompactTrackingDataChunk(data)) {
+    if (!DecodeCompactTrackingDataChunk(data, chunk_data.get())) {
+      ABSL_LOG(ERROR) << "Could not decode chunk file: " << chunk_file;
+      return nullptr;
+    }
+  } else {
+    chunk_data->ParseFromString(data);
+  }
 
   VLOG(1) << "Read success";
   return chunk_data;
@@ -17,12 +17,14 @@
 
 #include <inttypes.h>
 
+#include <functional>
 #include <map>
 #include <unordered_map>
 #include <vector>
 
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/executor.h"
 #include "mediapipe/framework/port/threadpool.h"
 #include "mediapipe/util/tracking/box_tracker.pb.h"
 #include "mediapipe/util/tracking/flow_packager.pb.h"
@@ -131,14 +133,24 @@ class BoxTracker {
  public:
   // Initializes a new BoxTracker to work on cached TrackingData from a chunk
   // directory.
-  BoxTracker(const std::string& cache_dir, const BoxTrackerOptions& options);
+  // Tracking runs on the passed executor if not null, which has to outlive
+  // the BoxTracker, or otherwise on num_tracking_workers own threads. As
+  // tracking requests block while waiting for chunks and for each other, the
+  // executor should be dedicated to tracking, e.g. a named executor of the
+  // calculator graph that is not running the caller.
+  BoxTracker(const std::string& cache_dir, const BoxTrackerOptions& options,
+             Executor* executor = nullptr);
 
   // Initializes a new BoxTracker to work on the passed TrackingDataChunks.
   // If copy_data is true, BoxTracker will retain its own copy of the data;
   // otherwise the passed pointer need to be valid for the lifetime of the
   // BoxTracker.
   BoxTracker(const std::vector<const TrackingDataChunk*>& tracking_data,
-             bool copy_data, const BoxTrackerOptions& options);
+             bool copy_data, const BoxTrackerOptions& options,
+             Executor* executor = nullptr);
+
+  // Waits for all ongoing tracks if tracking runs on an external executor.
+  ~BoxTracker();
 
   // Add single TrackingDataChunk. This chunk must be correctly aligned with
   // existing chunks. If chunk starting timestamp is larger than next valid
@@ -225,6 +237,9 @@ class BoxTracker {
                        int* tracking_data_msec = nullptr);
 
  private:
+  // Runs task on executor_ or on tracking_workers_.
+  void ScheduleTracking(std::function<void()> task);
+
   // Asynchronous implementation function for box tracking. Schedules forward
   // and backward tracking.
   void NewBoxTrackAsync(const TimedBox& initial_pos, int id, int64 min_msec,
@@ -364,8 +379,11 @@ class BoxTracker {
   // Buffer for tracking data in case we retain a deep copy.
   std::vector<std::unique_ptr<TrackingDataChunk>> tracking_data_buffer_;
 
-  // Workers that run the tracking algorithm.
+  // Workers that run the tracking algorithm, unless executor_ is set.
   std::unique_ptr<ThreadPool> tracking_workers_;
+
+  // External executor that runs the tracking algorithm, may be nullptr.
+  Executor* executor_ = nullptr;
 };
 
 }  // namespace mediapipe
@@ -0,0 +1,467 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/util/tracking/compact_tracking_data.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/port/proto_ns.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
+#include "mediapipe/util/tracking/motion_models.pb.h"
+
+namespace mediapipe {
+
+namespace {
+
+// Starts with a zero byte, which is never a valid proto field tag.
+constexpr char kHeader[] = {'\0', 'M', 'T', 'C'};
+constexpr int kHeaderSize = sizeof(kHeader);
+constexpr uint8_t kVersion = 1;
+
+// Vectors are stored losslessly if the quantized value exceeds this bound.
+constexpr double kMaxQuantizedValue = 1 << 30;
+
+// Presence bits of the chunk flags.
+enum ChunkBits : uint8_t {
+  kHasFirstChunk = 1 << 0,
+  kFirstChunk = 1 << 1,
+  kHasLastChunk = 1 << 2,
+  kLastChunk = 1 << 3,
+};
+
+// Presence bits of TrackingDataChunk::Item.
+enum ItemBits : uint8_t {
+  kHasTrackingData = 1 << 0,
+  kHasFrameIdx = 1 << 1,
+  kHasTimestamp = 1 << 2,
+  kHasPrevTimestamp = 1 << 3,
+};
+
+// Presence bits of TrackingData.
+enum TrackingDataBits : uint8_t {
+  kHasFrameFlags = 1 << 0,
+  kHasDomainWidth = 1 << 1,
+  kHasDomainHeight = 1 << 2,
+  kHasFrameAspect = 1 << 3,
+  kHasBackgroundModel = 1 << 4,
+  kHasMotionData = 1 << 5,
+  kHasGlobalFeatureCount = 1 << 6,
+  kHasAverageMotionMagnitude = 1 << 7,
+};
+
+// Presence bits of TrackingData::MotionData.
+enum MotionDataBits : uint8_t {
+  kHasNumElements = 1 << 0,
+};
+
+uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class Writer {
+ public:
+  explicit Writer(std::string* data) : data_(data) {}
+
+  void Byte(uint8_t value) { data_->push_back(static_cast<char>(value)); }
+
+  void Varint(uint64_t value) {
+    while (value >= 0x80) {
+      Byte(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    Byte(static_cast<uint8_t>(value));
+  }
+
+  void Signed(int64_t value) { Varint(ZigZag(value)); }
+
+  // Little endian, independent of the host byte order.
+  void Float(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+      Byte(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+  }
+
+  void Bytes(absl::string_view bytes) {
+    Varint(bytes.size());
+    data_->append(bytes.data(), bytes.size());
+  }
+
+  // Writes the size of values followed by the zigzag encoded difference of
+  // each value to its predecessor.
+  template <class Values>
+  void DeltaArray(const Values& values) {
+    Varint(values.size());
+    int64_t prev = 0;
+    for (const auto value : values) {
+      Signed(static_cast<int64_t>(value) - prev);
+      prev = value;
+    }
+  }
+
+ private:
+  std::string* data_;
+};
+
+// Reads from a string_view without copying it. All reads fail once the end of
+// the data is reached, and the first failure is sticky.
+class Reader {
+ public:
+  explicit Reader(absl::string_view data)
+      : pos_(reinterpret_cast<const uint8_t*>(data.data())),
+        end_(pos_ + data.size()) {}
+
+  bool ok() const { return ok_; }
+  bool AtEnd() const { return pos_ == end_; }
+
+  uint8_t Byte() {
+    if (pos_ == end_) {
+      ok_ = false;
+      return 0;
+    }
+    return *pos_++;
+  }
+
+  uint64_t Varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const uint8_t byte = Byte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  int64_t Signed() { return UnZigZag(Varint()); }
+
+  float Float() {
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+      bits |= static_cast<uint32_t>(Byte()) << (8 * i);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  absl::string_view Bytes() {
+    const uint64_t size = Varint();
+    if (size > Remaining()) {
+      ok_ = false;
+      return absl::string_view();
+    }
+    absl::string_view bytes(reinterpret_cast<const char*>(pos_), size);
+    pos_ += size;
+    return bytes;
+  }
+
+  // Reads an array size, where each element takes at least min_element_bytes.
+  // Fails for sizes that the remaining data cannot hold, so that malformed
+  // data does not cause large allocations.
+  int ArraySize(int min_element_bytes) {
+    const uint64_t size = Varint();
+    if (size > Remaining() / min_element_bytes) {
+      ok_ = false;
+      return 0;
+    }
+    return static_cast<int>(size);
+  }
+
+  // Reads an array written by Writer::DeltaArray.
+  template <class T>
+  void DeltaArray(proto_ns::RepeatedField<T>* values) {
+    const int size = ArraySize(1);
+    values->Resize(size, T());
+    T* out = values->mutable_data();
+    int64_t prev = 0;
+    for (int i = 0; i < size; ++i) {
+      prev += Signed();
+      out[i] = static_cast<T>(prev);
+    }
+  }
+
+ private:
+  uint64_t Remaining() const { return end_ - pos_; }
+
+  const uint8_t* pos_;
+  const uint8_t* end_;
+  bool ok_ = true;
+};
+
+// Returns true if all vectors of chunk can be quantized with step.
+bool CanQuantizeVectors(const TrackingDataChunk& chunk, float step) {
+  for (const auto& item : chunk.item()) {
+    for (const float value : item.tracking_data().motion_data().vector_data()) {
+      if (!std::isfinite(value) ||
+          std::abs(static_cast<double>(value) / step) > kMaxQuantizedValue) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void EncodeMotionData(const TrackingData::MotionData& motion_data, float step,
+                      Writer* writer) {
+  writer->Byte(motion_data.has_num_elements() ? kHasNumElements : 0);
+  if (motion_data.has_num_elements()) {
+    writer->Signed(motion_data.num_elements());
+  }
+
+  // Vectors are interleaved (x, y) pairs; each component is delta encoded
+  // w.r.t. the same component of the previous vector.
+  const auto& vectors = motion_data.vector_data();
+  writer->Varint(vectors.size());
+  if (step > 0) {
+    int64_t prev[2] = {0, 0};
+    for (int i = 0; i < vectors.size(); ++i) {
+      const int64_t quantized = std::llround(vectors[i] / step);
+      writer->Signed(quantized - prev[i % 2]);
+      prev[i % 2] = quantized;
+    }
+  } else {
+    for (const float value : vectors) {
+      writer->Float(value);
+    }
+  }
+
+  writer->DeltaArray(motion_data.track_id());
+  writer->DeltaArray(motion_data.row_indices());
+  writer->DeltaArray(motion_data.col_starts());
+
+  writer->Varint(motion_data.feature_descriptors_size());
+  for (const auto& descriptor : motion_data.feature_descriptors()) {
+    writer->Bytes(descriptor.data());
+  }
+
+  writer->DeltaArray(motion_data.actively_discarded_tracked_ids());
+}
+
+bool DecodeMotionData(float step, Reader* reader,
+                      TrackingData::MotionData* motion_data) {
+  if (reader->Byte() & kHasNumElements) {
+    motion_data->set_num_elements(reader->Signed());
+  }
+
+  const int num_vectors = reader->ArraySize(step > 0 ? 1 : 4);
+  auto* vectors = motion_data->mutable_vector_data();
+  vectors->Resize(num_vectors, 0.0f);
+  float* out = vectors->mutable_data();
+  if (step > 0) {
+    int64_t prev[2] = {0, 0};
+    for (int i = 0; i < num_vectors; ++i) {
+      prev[i % 2] += reader->Signed();
+      out[i] = prev[i % 2] * step;
+    }
+  } else {
+    for (int i = 0; i < num_vectors; ++i) {
+      out[i] = reader->Float();
+    }
+  }
+
+  reader->DeltaArray(motion_data->mutable_track_id());
+  reader->DeltaArray(motion_data->mutable_row_indices());
+  reader->DeltaArray(motion_data->mutable_col_starts());
+
+  const int num_descriptors = reader->ArraySize(1);
+  motion_data->mutable_feature_descriptors()->Reserve(num_descriptors);
+  for (int i = 0; i < num_descriptors && reader->ok(); ++i) {
+    const absl::string_view bytes = reader->Bytes();
+    motion_data->add_feature_descriptors()->set_data(bytes.data(),
+                                                     bytes.size());
+  }
+
+  reader->DeltaArray(motion_data->mutable_actively_discarded_tracked_ids());
+  return reader->ok();
+}
+
+void EncodeTrackingData(const TrackingData& tracking_data, float step,
+                        Writer* writer) {
+  uint8_t bits = 0;
+  if (tracking_data.has_frame_flags()) bits |= kHasFrameFlags;
+  if (tracking_data.has_domain_width()) bits |= kHasDomainWidth;
+  if (tracking_data.has_domain_height()) bits |= kHasDomainHeight;
+  if (tracking_data.has_frame_aspect()) bits |= kHasFrameAspect;
+  if (tracking_data.has_background_model()) bits |= kHasBackgroundModel;
+  if (tracking_data.has_motion_data()) bits |= kHasMotionData;
+  if (tracking_data.has_global_feature_count()) bits |= kHasGlobalFeatureCount;
+  if (tracking_data.has_average_motion_magnitude()) {
+    bits |= kHasAverageMotionMagnitude;
+  }
+  writer->Byte(bits);
+
+  if (bits & kHasFrameFlags) writer->Signed(tracking_data.frame_flags());
+  if (bits & kHasDomainWidth) writer->Signed(tracking_data.domain_width());
+  if (bits & kHasDomainHeight) writer->Signed(tracking_data.domain_height());
+  if (bits & kHasFrameAspect) writer->Float(tracking_data.frame_aspect());
+  if (bits & kHasBackgroundModel) {
+    // Homographies are small and rare enough to be stored as protos.
+    writer->Bytes(tracking_data.background_model().SerializeAsString());
+  }
+  if (bits & kHasMotionData) {
+    EncodeMotionData(tracking_data.motion_data(), step, writer);
+  }
+  if (bits & kHasGlobalFeatureCount) {
+    writer->Varint(tracking_data.global_feature_count());
+  }
+  if (bits & kHasAverageMotionMagnitude) {
+    writer->Float(tracking_data.average_motion_magnitude());
+  }
+}
+
+bool DecodeTrackingData(float step, Reader* reader,
+                        TrackingData* tracking_data) {
+  const uint8_t bits = reader->Byte();
+  if (bits & kHasFrameFlags) tracking_data->set_frame_flags(reader->Signed());
+  if (bits & kHasDomainWidth) tracking_data->set_domain_width(reader->Signed());
+  if (bits & kHasDomainHeight) {
+    tracking_data->set_domain_height(reader->Signed());
+  }
+  if (bits & kHasFrameAspect) tracking_data->set_frame_aspect(reader->Float());
+  if (bits & kHasBackgroundModel) {
+    const absl::string_view bytes = reader->Bytes();
+    if (!tracking_data->mutable_background_model()->ParseFromArray(
+            bytes.data(), bytes.size())) {
+      return false;
+    }
+  }
+  if ((bits & kHasMotionData) &&
+      !DecodeMotionData(step, reader, tracking_data->mutable_motion_data())) {
+    return false;
+  }
+  if (bits & kHasGlobalFeatureCount) {
+    tracking_data->set_global_feature_count(reader->Varint());
+  }
+  if (bits & kHasAverageMotionMagnitude) {
+    tracking_data->set_average_motion_magnitude(reader->Float());
+  }
+  return reader->ok();
+}
+
+}  // namespace
+
+bool IsCompactTrackingDataChunk(absl::string_view data) {
+  return data.size() > kHeaderSize &&
+         std::memcmp(data.data(), kHeader, kHeaderSize) == 0;
+}
+
+void EncodeCompactTrackingDataChunk(const TrackingDataChunk& chunk,
+                                    float vector_quantization_step,
+                                    std::string* data) {
+  data->assign(kHeader, kHeaderSize);
+  Writer writer(data);
+  writer.Byte(kVersion);
+
+  uint8_t chunk_bits = 0;
+  if (chunk.has_first_chunk()) {
+    chunk_bits |= kHasFirstChunk | (chunk.first_chunk() ? kFirstChunk : 0);
+  }
+  if (chunk.has_last_chunk()) {
+    chunk_bits |= kHasLastChunk | (chunk.last_chunk() ? kLastChunk : 0);
+  }
+  writer.Byte(chunk_bits);
+
+  float step = vector_quantization_step > 0 ? vector_quantization_step : 0;
+  if (step > 0 && !CanQuantizeVectors(chunk, step)) {
+    step = 0;
+  }
+  writer.Float(step);
+
+  writer.Varint(chunk.item_size());
+  int64_t prev_timestamp = 0;
+  for (const auto& item : chunk.item()) {
+    uint8_t bits = 0;
+    if (item.has_tracking_data()) bits |= kHasTrackingData;
+    if (item.has_frame_idx()) bits |= kHasFrameIdx;
+    if (item.has_timestamp_usec()) bits |= kHasTimestamp;
+    if (item.has_prev_timestamp_usec()) bits |= kHasPrevTimestamp;
+    writer.Byte(bits);
+
+    if (bits & kHasFrameIdx) writer.Signed(item.frame_idx());
+    // Timestamps increase by about a frame duration between items, and the
+    // previous timestamp usually equals the timestamp of the previous item.
+    if (bits & kHasTimestamp) {
+      writer.Signed(item.timestamp_usec() - prev_timestamp);
+      prev_timestamp = item.timestamp_usec();
+    }
+    if (bits & kHasPrevTimestamp) {
+      writer.Signed(item.timestamp_usec() - item.prev_timestamp_usec());
+    }
+    if (bits & kHasTrackingData) {
+      EncodeTrackingData(item.tracking_data(), step, &writer);
+    }
+  }
+}
+
+bool DecodeCompactTrackingDataChunk(absl::string_view data,
+                                    TrackingDataChunk* chunk) {
+  chunk->Clear();
+  if (!IsCompactTrackingDataChunk(data)) {
+    return false;
+  }
+  Reader reader(data.substr(kHeaderSize));
+  if (reader.Byte() != kVersion) {
+    return false;
+  }
+
+  const uint8_t chunk_bits = reader.Byte();
+  if (chunk_bits & kHasFirstChunk) {
+    chunk->set_first_chunk(chunk_bits & kFirstChunk);
+  }
+  if (chunk_bits & kHasLastChunk) {
+    chunk->set_last_chunk(chunk_bits & kLastChunk);
+  }
+
+  const float step = reader.Float();
+  if (!(step >= 0) || !std::isfinite(step)) {
+    return false;
+  }
+
+  const int num_items = reader.ArraySize(1);
+  chunk->mutable_item()->Reserve(num_items);
+  int64_t prev_timestamp = 0;
+  for (int i = 0; i < num_items && reader.ok(); ++i) {
+    auto* item = chunk->add_item();
+    const uint8_t bits = reader.Byte();
+    if (bits & kHasFrameIdx) item->set_frame_idx(reader.Signed());
+    if (bits & kHasTimestamp) {
+      prev_timestamp += reader.Signed();
+      item->set_timestamp_usec(prev_timestamp);
+    }
+    if (bits & kHasPrevTimestamp) {
+      item->set_prev_timestamp_usec(item->timestamp_usec() - reader.Signed());
+    }
+    if ((bits & kHasTrackingData) &&
+        !DecodeTrackingData(step, &reader, item->mutable_tracking_data())) {
+      return false;
+    }
+  }
+  return reader.ok() && reader.AtEnd();
+}
+
+}  // namespace mediapipe
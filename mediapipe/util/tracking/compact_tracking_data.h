@@ -0,0 +1,68 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MEDIAPIPE_UTIL_TRACKING_COMPACT_TRACKING_DATA_H_
+#define MEDIAPIPE_UTIL_TRACKING_COMPACT_TRACKING_DATA_H_
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
+
+namespace mediapipe {
+
+// Compact binary encoding of TrackingDataChunk used for cached tracking data.
+// Compared to the proto wire format, the encoding stores each repeated field
+// as one flat array, delta encodes positions, track ids and timestamps as
+// zigzag varints and optionally quantizes motion vectors to a fixed step.
+// Decoding writes directly into the repeated fields of the output chunk and
+// does not need an intermediate copy of the input.
+//
+// All fields of TrackingDataChunk are preserved, including track ids and
+// feature descriptors that FlowPackager::EncodeTrackingData drops. Unknown
+// fields are not preserved.
+//
+// Usage:
+//   std::string data;
+//   EncodeCompactTrackingDataChunk(chunk, 1.0f / 256, &data);
+//   ...
+//   TrackingDataChunk decoded;
+//   if (IsCompactTrackingDataChunk(data)) {
+//     ABSL_CHECK(DecodeCompactTrackingDataChunk(data, &decoded));
+//   } else {
+//     decoded.ParseFromString(data);
+//   }
+
+// Returns true if data starts with the header written by
+// EncodeCompactTrackingDataChunk. The header never parses as a valid
+// TrackingDataChunk proto, so both formats can be read from the same files.
+bool IsCompactTrackingDataChunk(absl::string_view data);
+
+// Encodes chunk to data. If vector_quantization_step > 0, motion vectors are
+// rounded to multiples of the step (in units of the tracking data domain),
+// otherwise they are stored losslessly. Chunks with vectors that cannot be
+// quantized (non-finite or too large for the step) are stored losslessly.
+void EncodeCompactTrackingDataChunk(const TrackingDataChunk& chunk,
+                                    float vector_quantization_step,
+                                    std::string* data);
+
+// Decodes data written by EncodeCompactTrackingDataChunk into chunk, which is
+// cleared first. Returns false if data is truncated or malformed.
+bool DecodeCompactTrackingDataChunk(absl::string_view data,
+                                    TrackingDataChunk* chunk);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_TRACKING_COMPACT_TRACKING_DATA_H_
@@ -0,0 +1,146 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mediapipe/util/tracking/compact_tracking_data.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/util/tracking/flow_packager.pb.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr float kStep = 1.0f / 256;
+
+TrackingDataChunk MakeChunk() {
+  TrackingDataChunk chunk;
+  chunk.set_first_chunk(true);
+  for (int f = 0; f < 3; ++f) {
+    auto* item = chunk.add_item();
+    item->set_frame_idx(10 + f);
+    item->set_timestamp_usec(1000000 + 33333 * f);
+    item->set_prev_timestamp_usec(1000000 + 33333 * (f - 1));
+    auto* data = item->mutable_tracking_data();
+    data->set_frame_flags(TrackingData::TRACKING_FLAG_PROFILE_HIGH);
+    data->set_domain_width(4);
+    data->set_domain_height(3);
+    data->set_frame_aspect(16.0f / 9);
+    data->mutable_background_model()->set_h_02(1.5f * f);
+    data->set_global_feature_count(100 + f);
+    data->set_average_motion_magnitude(0.25f * f);
+    auto* motion = data->mutable_motion_data();
+    motion->set_num_elements(3);
+    for (int i = 0; i < 3; ++i) {
+      motion->add_vector_data(0.1f * i - f);
+      motion->add_vector_data(-2.7f * i + f);
+      motion->add_track_id(1000 + i * 7 - f);
+      motion->add_row_indices(2 - i);
+      motion->add_feature_descriptors()->set_data(std::string(i + 1, 'a' + i));
+    }
+    for (const int col_start : {0, 1, 1, 2, 3}) {
+      motion->add_col_starts(col_start);
+    }
+    motion->add_actively_discarded_tracked_ids(-5);
+    motion->add_actively_discarded_tracked_ids(42);
+  }
+  return chunk;
+}
+
+TEST(CompactTrackingDataTest, LosslessRoundTrip) {
+  const TrackingDataChunk chunk = MakeChunk();
+  std::string data;
+  EncodeCompactTrackingDataChunk(chunk, 0, &data);
+  EXPECT_TRUE(IsCompactTrackingDataChunk(data));
+
+  TrackingDataChunk decoded;
+  ASSERT_TRUE(DecodeCompactTrackingDataChunk(data, &decoded));
+  EXPECT_EQ(decoded.SerializeAsString(), chunk.SerializeAsString());
+}
+
+TEST(CompactTrackingDataTest, QuantizedRoundTrip) {
+  const TrackingDataChunk chunk = MakeChunk();
+  std::string data;
+  EncodeCompactTrackingDataChunk(chunk, kStep, &data);
+  EXPECT_LT(data.size(), chunk.ByteSizeLong());
+
+  TrackingDataChunk decoded;
+  ASSERT_TRUE(DecodeCompactTrackingDataChunk(data, &decoded));
+  ASSERT_EQ(decoded.item_size(), chunk.item_size());
+  for (int f = 0; f < chunk.item_size(); ++f) {
+    const auto& expected = chunk.item(f).tracking_data().motion_data();
+    auto* actual =
+        decoded.mutable_item(f)->mutable_tracking_data()->mutable_motion_data();
+    ASSERT_EQ(actual->vector_data_size(), expected.vector_data_size());
+    for (int i = 0; i < expected.vector_data_size(); ++i) {
+      EXPECT_NEAR(actual->vector_data(i), expected.vector_data(i), kStep / 2);
+      actual->set_vector_data(i, expected.vector_data(i));
+    }
+  }
+  // Everything but the vectors is stored losslessly.
+  EXPECT_EQ(decoded.SerializeAsString(), chunk.SerializeAsString());
+}
+
+TEST(CompactTrackingDataTest, PreservesFieldPresence) {
+  TrackingDataChunk chunk;
+  chunk.set_last_chunk(false);
+  chunk.add_item();
+  chunk.add_item()->mutable_tracking_data()->mutable_motion_data();
+  chunk.add_item()->set_prev_timestamp_usec(-7);
+
+  std::string data;
+  EncodeCompactTrackingDataChunk(chunk, kStep, &data);
+  TrackingDataChunk decoded;
+  ASSERT_TRUE(DecodeCompactTrackingDataChunk(data, &decoded));
+  EXPECT_EQ(decoded.SerializeAsString(), chunk.SerializeAsString());
+  EXPECT_TRUE(decoded.has_last_chunk());
+  EXPECT_FALSE(decoded.has_first_chunk());
+}
+
+TEST(CompactTrackingDataTest, StoresUnquantizableVectorsLosslessly) {
+  TrackingDataChunk chunk = MakeChunk();
+  auto* motion =
+      chunk.mutable_item(1)->mutable_tracking_data()->mutable_motion_data();
+  motion->set_vector_data(0, std::numeric_limits<float>::infinity());
+  motion->set_vector_data(1, 1e30f);
+
+  std::string data;
+  EncodeCompactTrackingDataChunk(chunk, kStep, &data);
+  TrackingDataChunk decoded;
+  ASSERT_TRUE(DecodeCompactTrackingDataChunk(data, &decoded));
+  EXPECT_EQ(decoded.SerializeAsString(), chunk.SerializeAsString());
+}
+
+TEST(CompactTrackingDataTest, RejectsProtoAndMalformedData) {
+  const TrackingDataChunk chunk = MakeChunk();
+  const std::string proto_data = chunk.SerializeAsString();
+  EXPECT_FALSE(IsCompactTrackingDataChunk(proto_data));
+  TrackingDataChunk decoded;
+  EXPECT_FALSE(DecodeCompactTrackingDataChunk(proto_data, &decoded));
+
+  std::string data;
+  EncodeCompactTrackingDataChunk(chunk, kStep, &data);
+  for (int size = 0; size < data.size(); ++size) {
+    EXPECT_FALSE(DecodeCompactTrackingDataChunk(data.substr(0, size), &decoded))
+        << size;
+  }
+  EXPECT_FALSE(DecodeCompactTrackingDataChunk(data + "x", &decoded));
+}
+
+}  // namespace
+}  // namespace mediapipe
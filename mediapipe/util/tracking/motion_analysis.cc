@@ -18,11 +18,15 @@
 #include <cmath>
 #include <cstring>
 #include <deque>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <utility>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/framework/port/vector.h"
 #include "mediapipe/util/tracking/camera_motion.h"
@@ -30,6 +34,7 @@
 #include "mediapipe/util/tracking/image_util.h"
 #include "mediapipe/util/tracking/measure_time.h"
 #include "mediapipe/util/tracking/motion_saliency.pb.h"
+#include "mediapipe/util/tracking/parallel_invoker.h"
 #include "mediapipe/util/tracking/region_flow.h"
 #include "mediapipe/util/tracking/region_flow.pb.h"
 #include "mediapipe/util/tracking/region_flow_computation.h"
@@ -48,8 +53,24 @@ MotionAnalysis::MotionAnalysis(const MotionAnalysisOptions& options,
   // Merge back in any overriden options.
   options_.MergeFrom(options);
 
-  region_flow_computation_.reset(new RegionFlowComputation(
-      options_.flow_options(), frame_width_, frame_height_));
+  const int num_flow_segments = options_.parallel_flow_segments();
+  if (num_flow_segments > 1) {
+    ABSL_CHECK_NE(options_.flow_options().tracking_options().tracking_policy(),
+                  TrackingOptions::FLOW_DIRECTION_POLICY_MULTI_FRAME)
+        << "Multi frame tracking is not supported with parallel flow segments.";
+    flow_segments_.resize(num_flow_segments);
+    for (auto& segment : flow_segments_) {
+      segment.computation.reset(new RegionFlowComputation(
+          options_.flow_options(), frame_width_, frame_height_));
+    }
+    // The calling thread runs the first segment.
+    flow_thread_pool_ = std::make_unique<ThreadPool>("MotionAnalysisFlow",
+                                                     num_flow_segments - 1);
+    flow_thread_pool_->StartWorkers();
+  } else {
+    region_flow_computation_.reset(new RegionFlowComputation(
+        options_.flow_options(), frame_width_, frame_height_));
+  }
   motion_estimation_.reset(new MotionEstimation(options_.motion_options(),
                                                 frame_width_, frame_height_));
 
@@ -115,6 +136,12 @@ MotionAnalysis::MotionAnalysis(const MotionAnalysisOptions& options,
   buffer_.reset(new StreamingBuffer(
       options_.compute_motion_saliency() ? data_config_saliency : data_config,
       2 * overlap_size_));
+
+  if (options_.buffer_memory_limit_bytes() > 0 &&
+      !buffer_->SetMemoryLimit(options_.buffer_memory_limit_bytes(),
+                               options_.buffer_scratch_path())) {
+    ABSL_LOG(ERROR) << "Could not bound buffer memory, buffering in memory.";
+  }
 }
 
 void MotionAnalysis::InitPolicyOptions() {
@@ -362,6 +389,34 @@ bool MotionAnalysis::AddFrameGeneric(
   ABSL_CHECK(feature_computation_) << "Calls to AddFrame* can NOT be mixed "
                                    << "with AddFeatures";
 
+  if (!flow_segments_.empty()) {
+    ABSL_CHECK(output_feature_list == nullptr)
+        << "Returning features is not supported with parallel flow segments.";
+    auto flow_frame = std::make_unique<FlowFrame>();
+    frame.copyTo(flow_frame->frame);
+    flow_frame->timestamp_usec = timestamp_usec;
+    flow_frame->initial_transform = initial_transform;
+    if (rejection_transform) {
+      flow_frame->rejection_transform =
+          std::make_unique<Homography>(*rejection_transform);
+    }
+    if (external_features) {
+      flow_frame->external_features =
+          std::make_unique<RegionFlowFeatureList>(*external_features);
+    }
+    if (modify_features) {
+      flow_frame->modify_features = *modify_features;
+    }
+    flow_frames_.push_back(std::move(flow_frame));
+    ++frame_num_;
+
+    if (static_cast<int>(flow_frames_.size()) <
+        options_.estimation_clip_size()) {
+      return true;
+    }
+    return ComputeSegmentedRegionFlow();
+  }
+
   // Compute RegionFlow.
   {
     MEASURE_TIME << "CALL RegionFlowComputation::AddImage";
@@ -403,6 +458,25 @@ bool MotionAnalysis::AddFrameGeneric(
     }
   }
 
+  BufferFeatures(std::move(feature_list), rejection_transform,
+                 external_features, modify_features, output_feature_list);
+
+  // Store frame for next call.
+  if (compute_feature_descriptors_) {
+    frame.copyTo(*prev_frame_);
+  }
+
+  ++frame_num_;
+
+  return true;
+}
+
+void MotionAnalysis::BufferFeatures(
+    std::unique_ptr<RegionFlowFeatureList> feature_list,
+    const Homography* rejection_transform,
+    const RegionFlowFeatureList* external_features,
+    const std::function<void(RegionFlowFeatureList*)>* modify_features,
+    RegionFlowFeatureList* output_feature_list) {
   if (external_features) {
     constexpr int kTrackIdShift = 1 << 20;
     for (const auto& external_feat : external_features->feature()) {
@@ -437,15 +511,143 @@ bool MotionAnalysis::AddFrameGeneric(
   }
 
   buffer_->EmplaceDatum("features", feature_list.release());
+}
+
+bool MotionAnalysis::ComputeSegmentedRegionFlow() {
+  MEASURE_TIME << "ComputeSegmentedRegionFlow";
+  const int num_frames = flow_frames_.size();
+  if (num_frames == 0) {
+    return true;
+  }
+
+  const int num_segments = std::min<int>(flow_segments_.size(), num_frames);
+  const int first_frame_num = frame_num_ - num_frames;
+  auto segment_begin = [num_frames, num_segments](int segment) {
+    return segment * num_frames / num_segments;
+  };
+
+  std::vector<std::unique_ptr<RegionFlowFeatureList>> feature_lists(
+      num_frames);
+  RunSegments(num_segments, [&](int segment) {
+    RegionFlowComputation* computation =
+        flow_segments_[segment].computation.get();
+    const int begin = segment_begin(segment);
+    const int end = segment_begin(segment + 1);
+    // The first segment continues from the previous clip. Other segments
+    // restart tracking at the last frame of the preceding segment.
+    if (segment > 0) {
+      computation->Reset();
+      const FlowFrame& start_frame = *flow_frames_[begin - 1];
+      if (computation->AddImageWithSeed(start_frame.frame,
+                                        start_frame.timestamp_usec,
+                                        start_frame.initial_transform)) {
+        std::unique_ptr<RegionFlowFeatureList> discarded(
+            computation->RetrieveMultiRegionFlowFeatureList(
+                0, compute_feature_descriptors_, false, &start_frame.frame,
+                nullptr));
+      }
+    }
+
+    for (int k = begin; k < end; ++k) {
+      const FlowFrame& flow_frame = *flow_frames_[k];
+      if (!computation->AddImageWithSeed(flow_frame.frame,
+                                         flow_frame.timestamp_usec,
+                                         flow_frame.initial_transform)) {
+        continue;
+      }
+      const bool compute_feature_match_descriptors =
+          compute_feature_descriptors_ && first_frame_num + k > 0;
+      const cv::Mat* prev_frame =
+          k > 0 ? &flow_frames_[k - 1]->frame : prev_frame_.get();
+      feature_lists[k].reset(computation->RetrieveMultiRegionFlowFeatureList(
+          0, compute_feature_descriptors_, compute_feature_match_descriptors,
+          &flow_frame.frame,
+          compute_feature_match_descriptors ? prev_frame : nullptr));
+    }
+  });
+
+  // Renumber tracks in frame order, so that ids of different segments do not
+  // collide. The first segment keeps its shift, as it continues its tracks.
+  for (int segment = 0; segment < num_segments; ++segment) {
+    FlowSegment& flow_segment = flow_segments_[segment];
+    const int begin = segment_begin(segment);
+    const int end = segment_begin(segment + 1);
+    if (segment > 0) {
+      int min_track_id = std::numeric_limits<int>::max();
+      for (int k = begin; k < end; ++k) {
+        if (feature_lists[k] == nullptr) continue;
+        for (const auto& feature : feature_lists[k]->feature()) {
+          if (feature.track_id() >= 0) {
+            min_track_id = std::min(min_track_id, feature.track_id());
+          }
+        }
+      }
+      if (min_track_id != std::numeric_limits<int>::max()) {
+        flow_segment.track_id_shift = next_track_id_ - min_track_id;
+      }
+    }
+
+    for (int k = begin; k < end; ++k) {
+      if (feature_lists[k] == nullptr) continue;
+      for (auto& feature : *feature_lists[k]->mutable_feature()) {
+        if (feature.track_id() >= 0) {
+          feature.set_track_id(feature.track_id() +
+                               flow_segment.track_id_shift);
+          next_track_id_ = std::max(next_track_id_, feature.track_id() + 1);
+        }
+      }
+    }
+  }
+
+  bool success = true;
+  for (int k = 0; k < num_frames; ++k) {
+    if (feature_lists[k] == nullptr) {
+      ABSL_LOG(ERROR) << "Error while computing region flow.";
+      success = false;
+      continue;
+    }
+    const FlowFrame& flow_frame = *flow_frames_[k];
+    BufferFeatures(
+        std::move(feature_lists[k]), flow_frame.rejection_transform.get(),
+        flow_frame.external_features.get(),
+        flow_frame.modify_features ? &flow_frame.modify_features : nullptr,
+        nullptr);
+  }
 
-  // Store frame for next call.
   if (compute_feature_descriptors_) {
-    frame.copyTo(*prev_frame_);
+    flow_frames_.back()->frame.copyTo(*prev_frame_);
   }
 
-  ++frame_num_;
+  // The segment that processed the end of this clip continues with the next.
+  std::rotate(flow_segments_.begin(),
+              flow_segments_.begin() + num_segments - 1,
+              flow_segments_.begin() + num_segments);
+  flow_frames_.clear();
+  return success;
+}
 
-  return true;
+void MotionAnalysis::RunSegments(int num_segments,
+                                 const std::function<void(int)>& fn) {
+  if (CurrentParallelInvokerExecutor() != nullptr) {
+    ParallelFor(0, num_segments, 1, [&fn](const BlockedRange& range) {
+      for (int segment = range.begin(); segment < range.end(); ++segment) {
+        fn(segment);
+      }
+    });
+    return;
+  }
+
+  // Segments do not run on the parallel invoker thread pool, as the region
+  // flow computation runs nested ParallelFor loops on it.
+  absl::BlockingCounter segments_done(num_segments - 1);
+  for (int segment = 1; segment < num_segments; ++segment) {
+    flow_thread_pool_->Schedule([&fn, &segments_done, segment]() {
+      fn(segment);
+      segments_done.DecrementCount();
+    });
+  }
+  fn(0);
+  segments_done.Wait();
 }
 
 void MotionAnalysis::AddFeatures(const RegionFlowFeatureList& features) {
@@ -465,6 +667,8 @@ void MotionAnalysis::EnqueueFeaturesAndMotions(
 }
 
 cv::Mat MotionAnalysis::GetGrayscaleFrameFromResults() {
+  ABSL_CHECK(region_flow_computation_ != nullptr)
+      << "Not available with parallel flow segments.";
   return region_flow_computation_->GetGrayscaleFrameFromResults();
 }
 
@@ -474,6 +678,10 @@ int MotionAnalysis::GetResults(
     std::vector<std::unique_ptr<SalientPointFrame>>* saliency) {
   MEASURE_TIME << "GetResults";
 
+  if (flush && !flow_frames_.empty()) {
+    ComputeSegmentedRegionFlow();
+  }
+
   const int num_features_lists = buffer_->BufferSize("features");
   const int num_new_feature_lists = num_features_lists - overlap_start_;
   ABSL_CHECK_GE(num_new_feature_lists, 0);
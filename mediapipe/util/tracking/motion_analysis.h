@@ -54,11 +54,13 @@
 #ifndef MEDIAPIPE_UTIL_TRACKING_MOTION_ANALYSIS_H_
 #define MEDIAPIPE_UTIL_TRACKING_MOTION_ANALYSIS_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "mediapipe/framework/port/opencv_core_inc.h"
+#include "mediapipe/framework/port/threadpool.h"
 #include "mediapipe/util/tracking/camera_motion.pb.h"
 #include "mediapipe/util/tracking/motion_analysis.pb.h"
 #include "mediapipe/util/tracking/motion_estimation.h"
@@ -105,6 +107,9 @@ class MotionAnalysis {
   // Returns list of features extracted from this frame, *before* any
   // modification is applied. To yield modified features, simply
   // apply modify_features function to returned result.
+  // If MotionAnalysisOptions::parallel_flow_segments > 1, the frame is only
+  // buffered, and region flow is computed once a clip is complete. In that
+  // case, the return value only reflects errors of completed clips.
   bool AddFrameGeneric(
       const cv::Mat& frame, int64 timestamp_usec,
       const Homography& initial_transform,
@@ -144,6 +149,7 @@ class MotionAnalysis {
 
   // Exposes the grayscale image frame from the most recently created region
   // flow tracking data.
+  // Not available if MotionAnalysisOptions::parallel_flow_segments > 1.
   cv::Mat GetGrayscaleFrameFromResults();
 
   // Renders features and saliency to rendered_results based on
@@ -179,6 +185,24 @@ class MotionAnalysis {
  private:
   void InitPolicyOptions();
 
+  // Applies the optional rejection transform, external features and
+  // modification to the features retrieved for a frame, and buffers them.
+  void BufferFeatures(
+      std::unique_ptr<RegionFlowFeatureList> feature_list,
+      const Homography* rejection_transform,
+      const RegionFlowFeatureList* external_features,
+      const std::function<void(RegionFlowFeatureList*)>* modify_features,
+      RegionFlowFeatureList* output_feature_list);
+
+  // Computes region flow for all frames in flow_frames_ in
+  // parallel_flow_segments concurrent segments and buffers the features.
+  // Returns false if region flow could not be computed for any frame.
+  bool ComputeSegmentedRegionFlow();
+
+  // Runs fn(segment) for each segment in [0, num_segments) concurrently and
+  // returns when all are done.
+  void RunSegments(int num_segments, const std::function<void(int)>& fn);
+
   // Compute saliency from buffered features and motions.
   void ComputeSaliency();
 
@@ -215,6 +239,35 @@ class MotionAnalysis {
   // Buffers previous frame.
   std::unique_ptr<cv::Mat> prev_frame_;
 
+  // A frame waiting for region flow computation in a segment, along with the
+  // arguments of AddFrameGeneric.
+  struct FlowFrame {
+    cv::Mat frame;
+    int64 timestamp_usec = 0;
+    Homography initial_transform;
+    std::unique_ptr<Homography> rejection_transform;
+    std::unique_ptr<RegionFlowFeatureList> external_features;
+    std::function<void(RegionFlowFeatureList*)> modify_features;
+  };
+
+  // Region flow state of one segment. Features are renumbered by adding
+  // track_id_shift, so track ids are unique across segments.
+  struct FlowSegment {
+    std::unique_ptr<RegionFlowComputation> computation;
+    int track_id_shift = 0;
+  };
+
+  // Only used if parallel_flow_segments > 1. Frames of the current clip.
+  std::vector<std::unique_ptr<FlowFrame>> flow_frames_;
+  // The segment processing the end of a clip continues with the start of the
+  // next clip, and is moved to the front after each clip.
+  std::vector<FlowSegment> flow_segments_;
+  // Smallest track id not used by any segment so far.
+  int next_track_id_ = 0;
+  // Runs segments if no ParallelFor executor is set, see
+  // ScopedParallelInvokerExecutor.
+  std::unique_ptr<ThreadPool> flow_thread_pool_;
+
   bool compute_feature_descriptors_ = false;
 
   // Amount of overlap between clips. Determined from saliency smoothing
@@ -20,6 +20,61 @@ int flags_parallel_invoker_mode = PARALLEL_INVOKER_MAX_VALUE;
 int flags_parallel_invoker_max_threads = 4;
 
 namespace mediapipe {
+namespace {
+
+thread_local const ParallelInvokerExecutor* current_executor = nullptr;
+
+}  // namespace
+
+ScopedParallelInvokerExecutor::ScopedParallelInvokerExecutor(
+    Executor* executor, int max_concurrency)
+    : previous_(current_executor) {
+  ABSL_CHECK(executor != nullptr);
+  current_.executor = executor;
+  current_.max_concurrency = max_concurrency;
+  current_executor = &current_;
+}
+
+ScopedParallelInvokerExecutor::~ScopedParallelInvokerExecutor() {
+  current_executor = previous_;
+}
+
+const ParallelInvokerExecutor* CurrentParallelInvokerExecutor() {
+  return current_executor;
+}
+
+namespace internal {
+
+bool ParallelInvokerExecutorLoop::Join(int* block) {
+  absl::MutexLock lock(&mutex_);
+  if (next_block_ == num_blocks_) {
+    return false;
+  }
+  ++num_joined_;
+  *block = next_block_++;
+  return true;
+}
+
+bool ParallelInvokerExecutorLoop::Next(int* block) {
+  absl::MutexLock lock(&mutex_);
+  if (next_block_ == num_blocks_) {
+    return false;
+  }
+  *block = next_block_++;
+  return true;
+}
+
+void ParallelInvokerExecutorLoop::Leave() {
+  absl::MutexLock lock(&mutex_);
+  --num_joined_;
+}
+
+void ParallelInvokerExecutorLoop::WaitUntilDone() {
+  absl::MutexLock lock(&mutex_);
+  mutex_.Await(absl::Condition(this, &ParallelInvokerExecutorLoop::Done));
+}
+
+}  // namespace internal
 
 #if defined(PARALLEL_INVOKER_ACTIVE)
 ThreadPool* ParallelInvokerThreadPool() {
@@ -15,6 +15,9 @@
 // Parallel for loop execution.
 // For details adapt parallel_using_* flags defined in parallel_invoker.cc.
 
+// Calls made while a ScopedParallelInvokerExecutor is alive on the calling
+// thread run on the given MediaPipe Executor instead, see below.
+
 // Usage example (for 1D):
 
 // Define Functor or lambda function that implements:
@@ -69,11 +72,14 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <memory>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/executor.h"
 
 #ifdef PARALLEL_INVOKER_ACTIVE
 #include "mediapipe/framework/port/threadpool.h"
@@ -136,6 +142,117 @@ class BlockedRange2D {
   BlockedRange cols_;
 };
 
+// Executor and concurrency limit for ParallelFor and ParallelFor2D, see
+// ScopedParallelInvokerExecutor.
+struct ParallelInvokerExecutor {
+  Executor* executor = nullptr;
+  // Maximum number of loop bodies running at the same time, counting the
+  // calling thread. Values <= 0 do not limit the concurrency.
+  int max_concurrency = 0;
+};
+
+// Runs ParallelFor and ParallelFor2D called on the current thread on a
+// MediaPipe Executor, e.g. an executor of the calculator graph, instead of
+// the parallel invoker thread pool or GCD, for the lifetime of this object.
+// Applies regardless of flags_parallel_invoker_mode and of
+// PARALLEL_INVOKER_ACTIVE. Nested loops started by the loop bodies use the
+// same executor.
+//
+// The calling thread works on the loop as well, and only waits for loop
+// bodies that have already started. So loops complete even when all threads
+// of the executor are busy, e.g. with calculators calling ParallelFor.
+//
+// Usage:
+//   ScopedParallelInvokerExecutor scope(executor, /*max_concurrency=*/4);
+//   ParallelFor(0, num_frames, 1, invoker);
+class ScopedParallelInvokerExecutor {
+ public:
+  ScopedParallelInvokerExecutor(Executor* executor, int max_concurrency);
+  ~ScopedParallelInvokerExecutor();
+  ScopedParallelInvokerExecutor(const ScopedParallelInvokerExecutor&) = delete;
+  ScopedParallelInvokerExecutor& operator=(
+      const ScopedParallelInvokerExecutor&) = delete;
+
+ private:
+  ParallelInvokerExecutor current_;
+  const ParallelInvokerExecutor* previous_;
+};
+
+// Returns the executor set for the current thread, or nullptr if none is set.
+const ParallelInvokerExecutor* CurrentParallelInvokerExecutor();
+
+namespace internal {
+
+// Hands out the blocks of a loop running on a ParallelInvokerExecutor to the
+// calling thread and the executor tasks. Shared with the tasks, which may
+// start after the loop has returned.
+class ParallelInvokerExecutorLoop {
+ public:
+  explicit ParallelInvokerExecutorLoop(int num_blocks)
+      : num_blocks_(num_blocks) {}
+
+  // Claims the first block for a thread joining the loop. Returns false if
+  // all blocks have been claimed, in which case the thread must not access
+  // the loop body, as the loop may have returned already.
+  bool Join(int* block);
+  // Claims the next block for a thread that has joined the loop. Returns
+  // false if all blocks have been claimed.
+  bool Next(int* block);
+  // Called by a joined thread once it is done with the loop body.
+  void Leave();
+  // Waits until all blocks have been claimed and all joined threads left.
+  void WaitUntilDone();
+
+ private:
+  bool Done() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return next_block_ == num_blocks_ && num_joined_ == 0;
+  }
+
+  const int num_blocks_;
+  absl::Mutex mutex_;
+  int next_block_ ABSL_GUARDED_BY(mutex_) = 0;
+  int num_joined_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+// Calls run_block(local_invoker, block) for each block in [0, num_blocks) on
+// the executor and the calling thread. Each thread uses its own copy of the
+// invoker.
+template <class Invoker, class RunBlock>
+void ParallelForOnExecutor(const ParallelInvokerExecutor& context,
+                           int num_blocks, const Invoker& invoker,
+                           const RunBlock& run_block) {
+  auto loop = std::make_shared<ParallelInvokerExecutorLoop>(num_blocks);
+  // invoker and run_block are only accessed after a successful Join(), i.e.
+  // while the loop waits for this thread.
+  auto work = [loop, context, &invoker, &run_block]() {
+    int block;
+    if (!loop->Join(&block)) {
+      return;
+    }
+    {
+      ScopedParallelInvokerExecutor scope(context.executor,
+                                          context.max_concurrency);
+      Invoker local_invoker(invoker);
+      do {
+        run_block(local_invoker, block);
+      } while (loop->Next(&block));
+    }
+    loop->Leave();
+  };
+
+  int num_tasks = num_blocks - 1;
+  if (context.max_concurrency > 0) {
+    num_tasks = std::min(num_tasks, context.max_concurrency - 1);
+  }
+  for (int i = 0; i < num_tasks; ++i) {
+    context.executor->Schedule(work);
+  }
+  work();
+  loop->WaitUntilDone();
+}
+
+}  // namespace internal
+
 #ifdef PARALLEL_INVOKER_ACTIVE
 
 // Singleton ThreadPool for parallel invoker.
@@ -299,6 +416,22 @@ inline void CheckAndSetInvokerOptions() {
 template <class Invoker>
 void ParallelFor(size_t start, size_t end, size_t grain_size,
                  const Invoker& invoker) {
+  if (const ParallelInvokerExecutor* context =
+          CurrentParallelInvokerExecutor()) {
+    const int num_blocks = (end - start + grain_size - 1) / grain_size;
+    if (num_blocks <= 1) {
+      invoker(BlockedRange(start, end, 1));
+      return;
+    }
+    internal::ParallelForOnExecutor(
+        *context, num_blocks, invoker,
+        [start, end, grain_size](const Invoker& local_invoker, int block) {
+          const size_t x = start + block * grain_size;
+          local_invoker(BlockedRange(x, std::min(end, x + grain_size), 1));
+        });
+    return;
+  }
+
 #ifdef PARALLEL_INVOKER_ACTIVE
   CheckAndSetInvokerOptions();
   switch (flags_parallel_invoker_mode) {
@@ -410,6 +543,26 @@ void SerialFor2D(size_t start_row, size_t end_row, size_t start_col,
 template <class Invoker>
 void ParallelFor2D(size_t start_row, size_t end_row, size_t start_col,
                    size_t end_col, size_t grain_size, const Invoker& invoker) {
+  if (const ParallelInvokerExecutor* context =
+          CurrentParallelInvokerExecutor()) {
+    // Partitions across rows, like the GCD implementation.
+    const int num_blocks = (end_row - start_row + grain_size - 1) / grain_size;
+    if (num_blocks <= 1) {
+      SerialFor2D(start_row, end_row, start_col, end_col, grain_size, invoker);
+      return;
+    }
+    internal::ParallelForOnExecutor(
+        *context, num_blocks, invoker,
+        [start_row, end_row, start_col, end_col, grain_size](
+            const Invoker& local_invoker, int block) {
+          const size_t y = start_row + block * grain_size;
+          local_invoker(BlockedRange2D(
+              BlockedRange(y, std::min(end_row, y + grain_size), 1),
+              BlockedRange(start_col, end_col, 1)));
+        });
+    return;
+  }
+
 #ifdef PARALLEL_INVOKER_ACTIVE
   CheckAndSetInvokerOptions();
   switch (flags_parallel_invoker_mode) {
@@ -15,10 +15,14 @@
 #include "mediapipe/util/tracking/parallel_invoker.h"
 
 #include <algorithm>
+#include <functional>
 #include <numeric>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/executor.h"
 #include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/thread_pool_executor.h"
 
 namespace mediapipe {
 namespace {
@@ -56,5 +60,54 @@ TEST(ParallelInvokerTest, ThreadPoolTest) {
   RunParallelTest();
 }
 
+TEST(ParallelInvokerTest, ExecutorTest) {
+  ThreadPoolExecutor executor(4);
+  ScopedParallelInvokerExecutor scope(&executor, /*max_concurrency=*/3);
+
+  RunParallelTest();
+}
+
+// Executor that queues tasks without running them, like an executor whose
+// threads are all busy.
+class QueueingExecutor : public Executor {
+ public:
+  void Schedule(std::function<void()> task) override {
+    tasks_.push_back(std::move(task));
+  }
+
+  std::vector<std::function<void()>> tasks_;
+};
+
+TEST(ParallelInvokerTest, ExecutorLoopCompletesWhenExecutorIsBusy) {
+  QueueingExecutor executor;
+  {
+    ScopedParallelInvokerExecutor scope(&executor, /*max_concurrency=*/4);
+    RunParallelTest();
+  }
+  // One task per additional thread allowed by max_concurrency.
+  EXPECT_EQ(executor.tasks_.size(), 3);
+  // Tasks running after the loop has returned do nothing.
+  for (auto& task : executor.tasks_) {
+    task();
+  }
+}
+
+TEST(ParallelInvokerTest, ExecutorTest2D) {
+  ThreadPoolExecutor executor(4);
+  ScopedParallelInvokerExecutor scope(&executor, /*max_concurrency=*/0);
+
+  const int kRows = 100;
+  const int kCols = 20;
+  std::vector<int> visits(kRows * kCols, 0);
+  ParallelFor2D(0, kRows, 0, kCols, 3, [&visits](const BlockedRange2D& b) {
+    for (int y = b.rows().begin(); y != b.rows().end(); ++y) {
+      for (int x = b.cols().begin(); x != b.cols().end(); ++x) {
+        ++visits[y * kCols + x];
+      }
+    }
+  });
+  EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), kRows * kCols);
+}
+
 }  // namespace
 }  // namespace mediapipe
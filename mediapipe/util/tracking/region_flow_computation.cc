@@ -749,6 +749,7 @@ RegionFlowComputation::RegionFlowComputation(
 
   if (options_.gain_correction()) {
     gain_image_.reset(new cv::Mat(frame_height_, frame_width_, CV_8UC1));
+    gain_pyramid_.reset(new std::vector<cv::Mat>());
   }
 
   // Determine number of levels at which to extract features. If lowest image
@@ -2291,9 +2292,9 @@ void RegionFlowComputation::ExtractFeatures(
         options_.compute_derivative_in_pyramid() ? 2 * i : i;
     const bool index_within_limit =
         (layer_stored_in_pyramid < data->pyramid.size());
-    if (index_within_limit && options_.compute_derivative_in_pyramid() &&
-        i <= data->pyramid_levels) {
-      // Just re-use from already computed pyramid.
+    if (index_within_limit && i <= data->pyramid_levels) {
+      // Just re-use from already computed pyramid. Its levels are computed
+      // by pyrDown of the level above, with or without derivatives.
       data->extraction_pyramid[i] = data->pyramid[layer_stored_in_pyramid];
     } else {
       cv::pyrDown(data->extraction_pyramid[i - 1], data->extraction_pyramid[i],
@@ -2570,10 +2571,16 @@ void RegionFlowComputation::TrackFeatures(FrameTrackingData* from_data_ptr,
   feature_status_.resize(num_features);
 #if CV_MAJOR_VERSION >= 3
   if (gain_correction) {
+    // Build the pyramid of the gain corrected frame like the ones of the
+    // FrameTrackingData, instead of letting both calcOpticalFlowPyrLK calls
+    // below rebuild it from the single image.
+    cv::buildOpticalFlowPyramid(*gain_image_, *gain_pyramid_, cv_window_size,
+                                pyramid_levels_,
+                                options_.compute_derivative_in_pyramid());
     if (!frame1_gain_reference) {
-      input_frame1 = cv::_InputArray(*gain_image_);
+      input_frame1 = cv::_InputArray(*gain_pyramid_);
     } else {
-      input_frame2 = cv::_InputArray(*gain_image_);
+      input_frame2 = cv::_InputArray(*gain_pyramid_);
     }
   }
 
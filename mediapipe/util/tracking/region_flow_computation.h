@@ -415,9 +415,10 @@ class RegionFlowComputation {
   // List of RegionFlow frames of size options_.frames_to_track.
   RegionFlowFeatureListVector region_flow_results_;
 
-  // Gain adapted version.
+  // Gain adapted version, and its tracking pyramid. The pyramid is built once
+  // per TrackFeatures call and shared by tracking and verification.
   std::unique_ptr<cv::Mat> gain_image_;
-  std::unique_ptr<cv::Mat> gain_pyramid_;
+  std::unique_ptr<std::vector<cv::Mat>> gain_pyramid_;
 
   // Temporary buffers.
   std::unique_ptr<cv::Mat> corner_values_;
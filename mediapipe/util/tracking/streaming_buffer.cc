@@ -14,12 +14,75 @@
 
 #include "mediapipe/util/tracking/streaming_buffer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/str_cat.h"
 
 namespace mediapipe {
 
+namespace streaming_buffer_internal {
+
+namespace {
+
+bool Seek(std::FILE* file, int64_t offset) {
+#ifdef _WIN32
+  return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+  return fseeko(file, offset, SEEK_SET) == 0;
+#endif
+}
+
+}  // namespace
+
+std::unique_ptr<SpillFile> SpillFile::Create(const std::string& path) {
+  std::FILE* file =
+      path.empty() ? std::tmpfile() : std::fopen(path.c_str(), "w+b");
+  if (file == nullptr) {
+    return nullptr;
+  }
+  return std::unique_ptr<SpillFile>(new SpillFile(file, path));
+}
+
+SpillFile::~SpillFile() {
+  std::fclose(file_);
+  if (!path_.empty()) {
+    std::remove(path_.c_str());
+  }
+}
+
+int64_t SpillFile::Append(const std::string& data) {
+  const int64_t offset = size_;
+  if (!WriteAt(offset, data)) {
+    return -1;
+  }
+  return offset;
+}
+
+bool SpillFile::WriteAt(int64_t offset, const std::string& data) {
+  ABSL_CHECK_LE(offset, size_);
+  if (!Seek(file_, offset) ||
+      std::fwrite(data.data(), 1, data.size(), file_) != data.size()) {
+    return false;
+  }
+  size_ = std::max<int64_t>(size_, offset + data.size());
+  return true;
+}
+
+bool SpillFile::Read(int64_t offset, int64_t size, std::string* data) {
+  data->resize(size);
+  return Seek(file_, offset) && std::fread(&(*data)[0], 1, size, file_) ==
+                                    static_cast<size_t>(size);
+}
+
+}  // namespace streaming_buffer_internal
+
 StreamingBuffer::StreamingBuffer(
     const std::vector<TaggedType>& data_configuration, int overlap)
     : overlap_(overlap) {
@@ -33,6 +96,127 @@ StreamingBuffer::StreamingBuffer(
   }
 }
 
+bool StreamingBuffer::SetMemoryLimit(int64_t max_memory_bytes,
+                                     const std::string& scratch_path) {
+  ABSL_CHECK_GE(max_memory_bytes, 0);
+  ABSL_CHECK(spill_file_ == nullptr) << "Memory limit is already set.";
+  spill_file_ = streaming_buffer_internal::SpillFile::Create(scratch_path);
+  if (spill_file_ == nullptr) {
+    ABSL_LOG(ERROR) << "Could not create scratch file " << scratch_path;
+    return false;
+  }
+  max_memory_bytes_ = max_memory_bytes;
+  EnforceMemoryLimit();
+  return true;
+}
+
+int64_t StreamingBuffer::MemoryBytes() const {
+  int64_t memory_bytes = 0;
+  for (const auto& entry : data_) {
+    for (const Item& item : entry.second) {
+      if (item.spillable != nullptr) {
+        memory_bytes += item.spillable->memory_bytes();
+      }
+    }
+  }
+  return memory_bytes;
+}
+
+int StreamingBuffer::NumSpilledItems() const {
+  int num_spilled = 0;
+  for (const auto& entry : data_) {
+    for (const Item& item : entry.second) {
+      if (item.spillable != nullptr && item.spillable->spilled()) {
+        ++num_spilled;
+      }
+    }
+  }
+  return num_spilled;
+}
+
+void StreamingBuffer::Restore(const Item& item) const {
+  if (item.spillable == nullptr || !item.spillable->spilled()) {
+    return;
+  }
+  ABSL_CHECK(item.spillable->Restore(spill_file_.get()))
+      << "Could not restore spilled item.";
+}
+
+void StreamingBuffer::EnforceMemoryLimit() {
+  int64_t memory_bytes = MemoryBytes();
+  const int max_buffer_size = MaxBufferSize();
+  for (int k = 0; k < max_buffer_size && memory_bytes > max_memory_bytes_;
+       ++k) {
+    for (auto& entry : data_) {
+      if (k >= static_cast<int>(entry.second.size())) {
+        continue;
+      }
+      streaming_buffer_internal::SpillableDatum* spillable =
+          entry.second[k].spillable.get();
+      if (spillable == nullptr || spillable->memory_bytes() == 0) {
+        continue;
+      }
+      const int64_t datum_bytes = spillable->memory_bytes();
+      if (!spillable->Spill(spill_file_.get())) {
+        ABSL_LOG(ERROR) << "Could not spill item for tag " << entry.first
+                        << " at frame " << k;
+        continue;
+      }
+      memory_bytes -= datum_bytes;
+      if (memory_bytes <= max_memory_bytes_) {
+        break;
+      }
+    }
+  }
+
+  // Reclaim the scratch space of discarded and restored items once it
+  // dominates the file.
+  int64_t spilled_bytes = 0;
+  for (const auto& entry : data_) {
+    for (const Item& item : entry.second) {
+      if (item.spillable != nullptr && item.spillable->spilled()) {
+        spilled_bytes += item.spillable->size();
+      }
+    }
+  }
+  constexpr int64_t kMinCompactionBytes = 1 << 20;
+  if (spill_file_->Size() > 2 * spilled_bytes + kMinCompactionBytes) {
+    CompactSpillFile();
+  }
+}
+
+void StreamingBuffer::CompactSpillFile() {
+  std::vector<streaming_buffer_internal::SpillableDatum*> spilled;
+  for (const auto& entry : data_) {
+    for (const Item& item : entry.second) {
+      if (item.spillable != nullptr && item.spillable->spilled()) {
+        spilled.push_back(item.spillable.get());
+      }
+    }
+  }
+  std::sort(spilled.begin(), spilled.end(),
+            [](const streaming_buffer_internal::SpillableDatum* lhs,
+               const streaming_buffer_internal::SpillableDatum* rhs) {
+              return lhs->offset() < rhs->offset();
+            });
+
+  // Items only move towards the start, so each is read before its old
+  // location is overwritten.
+  int64_t end = 0;
+  std::string data;
+  for (streaming_buffer_internal::SpillableDatum* spillable : spilled) {
+    if (spillable->offset() != end) {
+      ABSL_CHECK(
+          spill_file_->Read(spillable->offset(), spillable->size(), &data) &&
+          spill_file_->WriteAt(end, data))
+          << "Could not compact scratch file.";
+      spillable->set_offset(end);
+    }
+    end += spillable->size();
+  }
+  spill_file_->Truncate(end);
+}
+
 bool StreamingBuffer::HasTag(const std::string& tag) const {
   return data_config_.find(tag) != data_config_.end();
 }
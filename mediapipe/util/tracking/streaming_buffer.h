@@ -15,10 +15,13 @@
 #ifndef MEDIAPIPE_UTIL_TRACKING_STREAMING_BUFFER_H_
 #define MEDIAPIPE_UTIL_TRACKING_STREAMING_BUFFER_H_
 
+#include <cstdint>
+#include <cstdio>
 #include <deque>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -26,6 +29,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/types/any.h"
+#include "mediapipe/framework/port/proto_ns.h"
 #include "mediapipe/framework/tool/type_util.h"
 
 namespace mediapipe {
@@ -118,6 +122,16 @@ namespace mediapipe {
 //
 //    // End chunk boundary processing.
 //  }
+//
+// Memory-bounded mode:
+// Long chunks of large items can take a lot of memory. After
+//
+// streaming_buffer.SetMemoryLimit(256 << 20);
+//
+// the buffer serializes the oldest items to a scratch file whenever the
+// buffered items exceed 256 MB, and restores them transparently when they are
+// accessed. Only items of types supported by StreamingBufferSpill (by default
+// protocol buffers) are spilled.
 
 // Stores pair (tag, TypeId of type).
 typedef std::pair<std::string, size_t> TaggedType;
@@ -130,6 +144,147 @@ TaggedType TaggedPointerType(const std::string& tag);
 template <class T>
 std::unique_ptr<T> MakeUnique(T* ptr);
 
+// Serializes items of type T for the memory-bounded mode of StreamingBuffer.
+// Items of types without specialization stay in memory. Specialize for
+// other types as follows:
+//
+// template <>
+// struct StreamingBufferSpill<MyType> {
+//   static constexpr bool kSpillable = true;
+//   // Estimated bytes held in memory.
+//   static int64_t ByteSize(const MyType& datum);
+//   static bool Serialize(const MyType& datum, std::string* data);
+//   static bool Parse(const std::string& data, MyType* datum);
+// };
+template <class T, class Enable = void>
+struct StreamingBufferSpill {
+  static constexpr bool kSpillable = false;
+};
+
+template <class T>
+struct StreamingBufferSpill<
+    T, typename std::enable_if<
+           std::is_base_of<proto_ns::MessageLite, T>::value>::type> {
+  static constexpr bool kSpillable = true;
+  static int64_t ByteSize(const T& datum) { return datum.ByteSizeLong(); }
+  static bool Serialize(const T& datum, std::string* data) {
+    return datum.SerializeToString(data);
+  }
+  static bool Parse(const std::string& data, T* datum) {
+    return datum->ParseFromString(data);
+  }
+};
+
+namespace streaming_buffer_internal {
+
+// Scratch file holding serialized items of a StreamingBuffer.
+class SpillFile {
+ public:
+  // Creates the file at path, or an anonymous temporary file if path is empty.
+  // Returns nullptr on failure.
+  static std::unique_ptr<SpillFile> Create(const std::string& path);
+  ~SpillFile();
+  SpillFile(const SpillFile&) = delete;
+  SpillFile& operator=(const SpillFile&) = delete;
+
+  // Writes data at the end of the file, returns its offset or -1 on failure.
+  int64_t Append(const std::string& data);
+  // Writes data at offset, which must not exceed Size().
+  bool WriteAt(int64_t offset, const std::string& data);
+  bool Read(int64_t offset, int64_t size, std::string* data);
+  // Discards all data from offset on.
+  void Truncate(int64_t offset) { size_ = offset; }
+  int64_t Size() const { return size_; }
+
+ private:
+  SpillFile(std::FILE* file, const std::string& path)
+      : file_(file), path_(path) {}
+
+  std::FILE* file_ = nullptr;
+  // Removed on destruction, empty for temporary files.
+  std::string path_;
+  int64_t size_ = 0;
+};
+
+// Type-erased spilling of a buffered item.
+class SpillableDatum {
+ public:
+  virtual ~SpillableDatum() = default;
+
+  // Serializes the item to file and frees it. No-op for released items.
+  virtual bool Spill(SpillFile* file) = 0;
+  // Restores a spilled item from file.
+  virtual bool Restore(SpillFile* file) = 0;
+
+  bool spilled() const { return spilled_; }
+  // Estimated bytes held in memory, zero if spilled or released.
+  virtual int64_t memory_bytes() const = 0;
+  // Location in the scratch file, if spilled.
+  int64_t offset() const { return offset_; }
+  int64_t size() const { return size_; }
+  void set_offset(int64_t offset) { offset_ = offset; }
+
+ protected:
+  bool spilled_ = false;
+  int64_t memory_bytes_ = 0;
+  int64_t offset_ = 0;
+  int64_t size_ = 0;
+};
+
+template <class T>
+class TypedSpillableDatum : public SpillableDatum {
+ public:
+  explicit TypedSpillableDatum(std::shared_ptr<std::unique_ptr<T>> pointer)
+      : pointer_(std::move(pointer)) {
+    if (*pointer_ != nullptr) {
+      memory_bytes_ = StreamingBufferSpill<T>::ByteSize(**pointer_);
+    }
+  }
+
+  bool Spill(SpillFile* file) override {
+    if (spilled_ || *pointer_ == nullptr) {
+      return true;
+    }
+    std::string data;
+    if (!StreamingBufferSpill<T>::Serialize(**pointer_, &data)) {
+      return false;
+    }
+    offset_ = file->Append(data);
+    if (offset_ < 0) {
+      return false;
+    }
+    size_ = data.size();
+    pointer_->reset();
+    spilled_ = true;
+    return true;
+  }
+
+  int64_t memory_bytes() const override {
+    return *pointer_ != nullptr ? memory_bytes_ : 0;
+  }
+
+  bool Restore(SpillFile* file) override {
+    if (!spilled_) {
+      return true;
+    }
+    std::string data;
+    auto datum = std::make_unique<T>();
+    if (!file->Read(offset_, size_, &data) ||
+        !StreamingBufferSpill<T>::Parse(data, datum.get())) {
+      return false;
+    }
+    *pointer_ = std::move(datum);
+    spilled_ = false;
+    memory_bytes_ = data.size();
+    return true;
+  }
+
+ private:
+  std::shared_ptr<std::unique_ptr<T>> pointer_;
+};
+
+}  // namespace streaming_buffer_internal
+
 // Note: If any of the function below are called with a tag not registered by
 // the constructor, the function will fail with CHECK.
 // Also, if any of the functions below is called with an existing tag but
@@ -142,6 +297,22 @@ class StreamingBuffer {
   StreamingBuffer(const std::vector<TaggedType>& data_configuration,
                   int overlap);
 
+  // Bounds the estimated memory of spillable items (see StreamingBufferSpill)
+  // to max_memory_bytes. Whenever the bound is exceeded after adding an item,
+  // the oldest items are serialized to a scratch file at scratch_path (or an
+  // anonymous temporary file if empty), and restored when accessed.
+  // Restored items stay in memory until the next call to Add*, so pointers
+  // and references returned by Get* are only valid until then.
+  // Returns false if the scratch file could not be created.
+  bool SetMemoryLimit(int64_t max_memory_bytes,
+                      const std::string& scratch_path = "");
+
+  // Returns the estimated memory of spillable items held in memory.
+  int64_t MemoryBytes() const;
+
+  // Returns the number of items spilled to the scratch file.
+  int NumSpilledItems() const;
+
   // Call will transfer ownership to StreamingBuffer.
   // Returns true if datum was successfully stored, false otherwise.
   template <class T>
@@ -300,10 +471,30 @@ class StreamingBuffer {
     ABSL_CHECK(tags.empty());
   }
 
+  // A buffered item. spillable is set for items of spillable types.
+  struct Item {
+    absl::any packet;
+    std::shared_ptr<streaming_buffer_internal::SpillableDatum> spillable;
+  };
+
+  // Restores item if it has been spilled.
+  void Restore(const Item& item) const;
+
+  // Spills the oldest items until the memory limit is met.
+  void EnforceMemoryLimit();
+
+  // Rewrites spilled items to the start of the scratch file, dropping the
+  // space of discarded and restored items.
+  void CompactSpillFile();
+
  private:
   int overlap_ = 0;
   int first_frame_index_ = 0;
-  absl::node_hash_map<std::string, std::deque<absl::any>> data_;
+  absl::node_hash_map<std::string, std::deque<Item>> data_;
+
+  // Set by SetMemoryLimit.
+  int64_t max_memory_bytes_ = 0;
+  std::unique_ptr<streaming_buffer_internal::SpillFile> spill_file_;
 
   // Stores tag, TypeId of corresponding type.
   absl::node_hash_map<std::string, size_t> data_config_;
@@ -327,8 +518,18 @@ void StreamingBuffer::AddDatum(const std::string& tag,
   ABSL_CHECK(HasTag(tag));
   ABSL_CHECK_EQ(data_config_[tag], kTypeId<PointerType<T>>.hash_code());
   auto& buffer = data_[tag];
-  absl::any packet(PointerType<T>(CreatePointer(pointer.release())));
-  buffer.push_back(packet);
+  Item item;
+  PointerType<T> stored_pointer = CreatePointer(pointer.release());
+  if constexpr (StreamingBufferSpill<T>::kSpillable) {
+    item.spillable =
+        std::make_shared<streaming_buffer_internal::TypedSpillableDatum<T>>(
+            stored_pointer);
+  }
+  item.packet = absl::any(std::move(stored_pointer));
+  buffer.push_back(std::move(item));
+  if (spill_file_ != nullptr) {
+    EnforceMemoryLimit();
+  }
 }
 
 template <class T>
@@ -391,10 +592,11 @@ T* StreamingBuffer::GetMutableDatum(const std::string& tag,
   ABSL_CHECK_GE(frame_index, 0);
   ABSL_CHECK(HasTag(tag));
   auto& buffer = data_.find(tag)->second;
-  if (frame_index > buffer.size()) {
+  if (frame_index >= buffer.size()) {
     return nullptr;
   } else {
-    const absl::any& packet = buffer[frame_index];
+    Restore(buffer[frame_index]);
+    const absl::any& packet = buffer[frame_index].packet;
     if (absl::any_cast<PointerType<T>>(&packet) == nullptr) {
       ABSL_LOG(ERROR) << "Stored item is not of requested type. "
                       << "Check data configuration.";
@@ -445,7 +647,8 @@ bool StreamingBuffer::IsInitialized(const std::string& tag) const {
   const auto& buffer = data_.find(tag)->second;
   int idx = 0;
   for (const auto& item : buffer) {
-    const PointerType<T>* pointer = absl::any_cast<const PointerType<T>>(&item);
+    const PointerType<T>* pointer =
+        absl::any_cast<const PointerType<T>>(&item.packet);
     ABSL_CHECK(pointer != nullptr);
     if (*pointer == nullptr) {
       ABSL_LOG(ERROR) << "Data for " << tag << " at frame " << idx
@@ -462,7 +665,9 @@ std::vector<T*> StreamingBuffer::GetMutableDatumVector(
   ABSL_CHECK(HasTag(tag));
   auto& buffer = data_.find(tag)->second;
   std::vector<T*> result;
-  for (const auto& packet : buffer) {
+  for (const auto& item : buffer) {
+    Restore(item);
+    const absl::any& packet = item.packet;
     if (absl::any_cast<PointerType<T>>(&packet) == nullptr) {
       ABSL_LOG(ERROR) << "Stored item is not of requested type. "
                       << "Check data configuration.";
@@ -495,7 +700,8 @@ std::unique_ptr<T> StreamingBuffer::ReleaseDatum(const std::string& tag,
   if (frame_index >= buffer.size()) {
     return nullptr;
   } else {
-    const absl::any& packet = buffer[frame_index];
+    Restore(buffer[frame_index]);
+    const absl::any& packet = buffer[frame_index].packet;
     if (absl::any_cast<PointerType<T>>(&packet) == nullptr) {
       ABSL_LOG(ERROR) << "Stored item is not of requested type. "
                       << "Check data configuration.";
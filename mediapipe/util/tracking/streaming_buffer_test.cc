@@ -0,0 +1,129 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/tracking/streaming_buffer.h"
+
+#include <memory>
+#include <vector>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/util/tracking/camera_motion.pb.h"
+
+namespace mediapipe {
+namespace {
+
+std::unique_ptr<CameraMotion> MakeMotion(int frame) {
+  auto motion = std::make_unique<CameraMotion>();
+  motion->set_timestamp_usec(frame);
+  motion->set_average_magnitude(frame * 0.5f);
+  return motion;
+}
+
+StreamingBuffer MakeBuffer(int overlap) {
+  return StreamingBuffer({TaggedPointerType<CameraMotion>("motion"),
+                          TaggedPointerType<int>("index")},
+                         overlap);
+}
+
+TEST(StreamingBufferTest, SpillsOldestItemsAndRestoresThem) {
+  StreamingBuffer buffer = MakeBuffer(/*overlap=*/0);
+  const int64_t motion_bytes = MakeMotion(1)->ByteSizeLong();
+  ASSERT_TRUE(buffer.SetMemoryLimit(3 * motion_bytes));
+
+  for (int k = 1; k <= 10; ++k) {
+    buffer.AddDatum("motion", MakeMotion(k));
+    buffer.AddDatum("index", std::make_unique<int>(k));
+    EXPECT_LE(buffer.MemoryBytes(), 3 * motion_bytes);
+  }
+  // Items of types without StreamingBufferSpill stay in memory.
+  EXPECT_EQ(buffer.NumSpilledItems(), 7);
+
+  for (int k = 0; k < 10; ++k) {
+    const CameraMotion* motion = buffer.GetDatum<CameraMotion>("motion", k);
+    ASSERT_NE(motion, nullptr);
+    EXPECT_EQ(motion->timestamp_usec(), k + 1);
+    EXPECT_EQ(motion->average_magnitude(), (k + 1) * 0.5f);
+    EXPECT_EQ(*buffer.GetDatum<int>("index", k), k + 1);
+  }
+  EXPECT_EQ(buffer.NumSpilledItems(), 0);
+
+  // The next addition spills again.
+  buffer.AddDatum("motion", MakeMotion(11));
+  buffer.AddDatum("index", std::make_unique<int>(11));
+  EXPECT_LE(buffer.MemoryBytes(), 3 * motion_bytes);
+  EXPECT_EQ(buffer.NumSpilledItems(), 8);
+}
+
+TEST(StreamingBufferTest, ReleasesAndOutputsSpilledItems) {
+  StreamingBuffer buffer = MakeBuffer(/*overlap=*/2);
+  ASSERT_TRUE(buffer.SetMemoryLimit(0));
+
+  for (int k = 0; k < 6; ++k) {
+    buffer.AddDatum("motion", MakeMotion(k));
+    buffer.AddDatum("index", std::make_unique<int>(k));
+  }
+  EXPECT_EQ(buffer.NumSpilledItems(), 6);
+  EXPECT_EQ(buffer.MemoryBytes(), 0);
+
+  std::unique_ptr<CameraMotion> released =
+      buffer.ReleaseDatum<CameraMotion>("motion", 5);
+  ASSERT_NE(released, nullptr);
+  EXPECT_EQ(released->timestamp_usec(), 5);
+  EXPECT_EQ(buffer.GetDatum<CameraMotion>("motion", 5), nullptr);
+
+  std::vector<int64_t> output_timestamps;
+  buffer.OutputDatum<CameraMotion>(
+      /*flush=*/false, "motion",
+      [&output_timestamps](int frame, std::unique_ptr<CameraMotion> motion) {
+        ASSERT_NE(motion, nullptr);
+        output_timestamps.push_back(motion->timestamp_usec());
+      });
+  EXPECT_THAT(output_timestamps, testing::ElementsAre(0, 1, 2, 3));
+  EXPECT_TRUE(buffer.TruncateBuffer(/*flush=*/false));
+
+  // Remaining overlap is still restored after truncation.
+  EXPECT_EQ(buffer.GetDatum<CameraMotion>("motion", 0)->timestamp_usec(), 4);
+}
+
+TEST(StreamingBufferTest, ReusesScratchSpaceOfDiscardedItems) {
+  StreamingBuffer buffer = MakeBuffer(/*overlap=*/1);
+  ASSERT_TRUE(buffer.SetMemoryLimit(0));
+
+  // Spill far more than the compaction threshold in total, while only a few
+  // items are buffered at any time.
+  for (int k = 0; k < 2000; ++k) {
+    auto motion = MakeMotion(k);
+    motion->mutable_overlay_indices()->Resize(1000, k);
+    buffer.AddDatum("motion", std::move(motion));
+    buffer.AddDatum("index", std::make_unique<int>(k));
+    if (buffer.MaxBufferSize() == 4) {
+      EXPECT_TRUE(buffer.TruncateBuffer(/*flush=*/false));
+    }
+  }
+
+  const CameraMotion* motion = buffer.GetDatum<CameraMotion>("motion", 0);
+  ASSERT_NE(motion, nullptr);
+  EXPECT_EQ(motion->overlay_indices_size(), 1000);
+  EXPECT_EQ(motion->overlay_indices(999),
+            buffer.GetDatumRef<int>("index", 0));
+}
+
+TEST(StreamingBufferTest, FailsForInvalidScratchPath) {
+  StreamingBuffer buffer = MakeBuffer(/*overlap=*/0);
+  EXPECT_FALSE(buffer.SetMemoryLimit(0, "/nonexistent/dir/scratch"));
+}
+
+}  // namespace
+}  // namespace mediapipe
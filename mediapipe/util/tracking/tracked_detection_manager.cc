@@ -14,6 +14,8 @@
 
 #include "mediapipe/util/tracking/tracked_detection_manager.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "mediapipe/framework/formats/rect.pb.h"
@@ -39,10 +41,133 @@ bool AreCornersOutOfView(const TrackedDetection& object) {
   }
   return true;
 }
+
+// Bounds the memory of the spatial index for tiny cell sizes.
+constexpr int kMaxCellsPerSide = 256;
+
 }  // namespace
 
 namespace mediapipe {
 
+TrackedDetectionManager::SpatialIndex::SpatialIndex(float cell_size) {
+  const float cells_per_side = std::ceil(1.0f / cell_size);
+  num_cells_per_side_ =
+      cells_per_side < kMaxCellsPerSide
+          ? std::max(1, static_cast<int>(cells_per_side))
+          : kMaxCellsPerSide;
+  cells_.resize(num_cells_per_side_ * num_cells_per_side_);
+}
+
+int TrackedDetectionManager::SpatialIndex::ToCell(float coordinate) const {
+  // Also maps NaN to the first cell.
+  if (!(coordinate > 0.0f)) {
+    return 0;
+  }
+  if (coordinate >= 1.0f) {
+    return num_cells_per_side_ - 1;
+  }
+  return static_cast<int>(coordinate * num_cells_per_side_);
+}
+
+TrackedDetectionManager::SpatialIndex::CellRange
+TrackedDetectionManager::SpatialIndex::GetCellRange(
+    const TrackedDetection& detection) const {
+  return {ToCell(detection.left()), ToCell(detection.top()),
+          ToCell(detection.right()), ToCell(detection.bottom())};
+}
+
+void TrackedDetectionManager::SpatialIndex::Update(
+    const TrackedDetection& detection) {
+  const int id = detection.unique_id();
+  const CellRange range = GetCellRange(detection);
+  auto range_ptr = cell_ranges_.find(id);
+  if (range_ptr == cell_ranges_.end()) {
+    cell_ranges_.emplace(id, range);
+  } else {
+    if (range_ptr->second == range) {
+      return;
+    }
+    RemoveFromCells(id, range_ptr->second);
+    range_ptr->second = range;
+  }
+  for (int y = range.min_y; y <= range.max_y; ++y) {
+    for (int x = range.min_x; x <= range.max_x; ++x) {
+      cells_[y * num_cells_per_side_ + x].push_back(id);
+    }
+  }
+}
+
+void TrackedDetectionManager::SpatialIndex::Remove(int id) {
+  auto range_ptr = cell_ranges_.find(id);
+  if (range_ptr == cell_ranges_.end()) {
+    return;
+  }
+  RemoveFromCells(id, range_ptr->second);
+  cell_ranges_.erase(range_ptr);
+}
+
+void TrackedDetectionManager::SpatialIndex::RemoveFromCells(
+    int id, const CellRange& range) {
+  for (int y = range.min_y; y <= range.max_y; ++y) {
+    for (int x = range.min_x; x <= range.max_x; ++x) {
+      auto& cell = cells_[y * num_cells_per_side_ + x];
+      cell.erase(std::find(cell.begin(), cell.end(), id));
+    }
+  }
+}
+
+std::vector<int> TrackedDetectionManager::SpatialIndex::FindCandidates(
+    const TrackedDetection& detection) const {
+  const CellRange range = GetCellRange(detection);
+  std::vector<int> ids;
+  for (int y = range.min_y; y <= range.max_y; ++y) {
+    for (int x = range.min_x; x <= range.max_x; ++x) {
+      const auto& cell = cells_[y * num_cells_per_side_ + x];
+      ids.insert(ids.end(), cell.begin(), cell.end());
+    }
+  }
+  // Detections spanning several cells are listed once per cell.
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  return ids;
+}
+
+void TrackedDetectionManager::SetConfig(
+    const mediapipe::TrackedDetectionManagerConfig& config) {
+  config_ = config;
+  spatial_index_.reset();
+  if (config_.spatial_index_cell_size() > 0.0f) {
+    spatial_index_ =
+        std::make_unique<SpatialIndex>(config_.spatial_index_cell_size());
+    for (const auto& detection : detections_) {
+      spatial_index_->Update(*detection.second);
+    }
+  }
+}
+
+std::vector<int> TrackedDetectionManager::FindDuplicateCandidates(
+    const TrackedDetection& detection) const {
+  // Only overlapping detections can be the same, unless a negative overlap
+  // ratio accepts any pair.
+  if (spatial_index_ != nullptr &&
+      config_.is_same_detection_min_overlap_ratio() >= 0.0f) {
+    return spatial_index_->FindCandidates(detection);
+  }
+  std::vector<int> ids;
+  ids.reserve(detections_.size());
+  for (const auto& existing_detection : detections_) {
+    ids.push_back(existing_detection.first);
+  }
+  return ids;
+}
+
+void TrackedDetectionManager::EraseDetection(int id) {
+  detections_.erase(id);
+  if (spatial_index_ != nullptr) {
+    spatial_index_->Remove(id);
+  }
+}
+
 std::vector<int> TrackedDetectionManager::AddDetection(
     std::unique_ptr<TrackedDetection> detection) {
   std::vector<int> ids_to_remove;
@@ -51,8 +176,8 @@ std::vector<int> TrackedDetectionManager::AddDetection(
   // TODO: All detections should be fastforwarded to the current
   // timestamp before adding the detection manager. E.g. only check they are the
   // same if the timestamp are the same.
-  for (auto& existing_detection_ptr : detections_) {
-    const auto& existing_detection = *existing_detection_ptr.second;
+  for (int existing_id : FindDuplicateCandidates(*detection)) {
+    const auto& existing_detection = *detections_.find(existing_id)->second;
     if (detection->IsSameAs(existing_detection,
                             config_.is_same_detection_max_area_ratio(),
                             config_.is_same_detection_min_overlap_ratio())) {
@@ -72,14 +197,17 @@ std::vector<int> TrackedDetectionManager::AddDetection(
           detection->set_previous_id(existing_detection.previous_id());
         }
       }
-      ids_to_remove.push_back(existing_detection_ptr.first);
+      ids_to_remove.push_back(existing_id);
     }
   }
   // Erase old detections.
   for (auto id : ids_to_remove) {
-    detections_.erase(id);
+    EraseDetection(id);
   }
   const int id = detection->unique_id();
+  if (spatial_index_ != nullptr) {
+    spatial_index_->Update(*detection);
+  }
   detections_[id] = std::move(detection);
   return ids_to_remove;
 }
@@ -94,6 +222,9 @@ std::vector<int> TrackedDetectionManager::UpdateDetectionLocation(
   auto& detection = *detection_ptr->second;
   detection.set_bounding_box(bounding_box);
   detection.set_last_updated_timestamp(timestamp);
+  if (spatial_index_ != nullptr) {
+    spatial_index_->Update(detection);
+  }
 
   // It's required to do this here in addition to in AddDetection because during
   // fast motion, two or more detections of the same object could coexist since
@@ -111,7 +242,7 @@ std::vector<int> TrackedDetectionManager::RemoveObsoleteDetections(
     }
   }
   for (auto idx : ids_to_remove) {
-    detections_.erase(idx);
+    EraseDetection(idx);
   }
   return ids_to_remove;
 }
@@ -124,7 +255,7 @@ std::vector<int> TrackedDetectionManager::RemoveOutOfViewDetections() {
     }
   }
   for (auto idx : ids_to_remove) {
-    detections_.erase(idx);
+    EraseDetection(idx);
   }
   return ids_to_remove;
 }
@@ -143,8 +274,9 @@ std::vector<int> TrackedDetectionManager::RemoveDuplicatedDetections(int id) {
   // are multiple duplicated detections at the same timestamp, we will use the
   // one that has the second latest initial timestamp
   const TrackedDetection* previous_detection = nullptr;
-  for (auto& existing_detection : detections_) {
-    auto other = *(existing_detection.second);
+  for (int other_id : FindDuplicateCandidates(detection)) {
+    auto& existing_detection = *detections_.find(other_id);
+    const auto& other = *(existing_detection.second);
     if (detection.unique_id() != other.unique_id()) {
       // Only check if they are updated at the same timestamp. Comparing
       // locations of detections at different timestamp is not correct.
@@ -187,7 +319,7 @@ std::vector<int> TrackedDetectionManager::RemoveDuplicatedDetections(int id) {
   }
 
   for (auto idx : ids_to_remove) {
-    detections_.erase(idx);
+    EraseDetection(idx);
   }
   return ids_to_remove;
 }
@@ -15,6 +15,10 @@
 #ifndef MEDIAPIPE_UTIL_TRACKING_DETECTION_MANAGER_H_
 #define MEDIAPIPE_UTIL_TRACKING_DETECTION_MANAGER_H_
 
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/util/tracking/tracked_detection.h"
@@ -69,11 +73,51 @@ class TrackedDetectionManager {
     return detections_;
   }
 
-  void SetConfig(const mediapipe::TrackedDetectionManagerConfig& config) {
-    config_ = config;
-  }
+  void SetConfig(const mediapipe::TrackedDetectionManagerConfig& config);
 
  private:
+  // Uniform grid over the normalized image, listing for each cell the ids of
+  // the detections whose bounds intersect the cell. Bounds beyond the image
+  // are clamped to the border cells.
+  class SpatialIndex {
+   public:
+    explicit SpatialIndex(float cell_size);
+
+    // Adds the detection, or moves it if its cells changed.
+    void Update(const TrackedDetection& detection);
+    void Remove(int id);
+
+    // Returns the sorted ids of all detections sharing a cell with
+    // |detection|, which includes all detections overlapping it.
+    std::vector<int> FindCandidates(const TrackedDetection& detection) const;
+
+   private:
+    struct CellRange {
+      int min_x, min_y, max_x, max_y;
+      bool operator==(const CellRange& other) const {
+        return min_x == other.min_x && min_y == other.min_y &&
+               max_x == other.max_x && max_y == other.max_y;
+      }
+    };
+
+    CellRange GetCellRange(const TrackedDetection& detection) const;
+    int ToCell(float coordinate) const;
+    void RemoveFromCells(int id, const CellRange& range);
+
+    int num_cells_per_side_;
+    // Ids per cell in row-major order.
+    std::vector<std::vector<int>> cells_;
+    absl::flat_hash_map<int, CellRange> cell_ranges_;
+  };
+
+  // Returns the ids of the detections that may be the same as |detection|,
+  // including |detection| itself if it is managed.
+  std::vector<int> FindDuplicateCandidates(
+      const TrackedDetection& detection) const;
+
+  // Removes the detection from detections_ and the spatial index.
+  void EraseDetection(int id);
+
   // Finds all detections that are duplicated with the one of |id| and remove
   // all detections except the one that is added most recently. Returns the IDs
   // of the detections that are removed.
@@ -82,6 +126,10 @@ class TrackedDetectionManager {
   absl::node_hash_map<int, std::unique_ptr<TrackedDetection>> detections_;
 
   mediapipe::TrackedDetectionManagerConfig config_;
+
+  // Null if config_.spatial_index_cell_size() is not positive.
+  std::unique_ptr<SpatialIndex> spatial_index_ =
+      std::make_unique<SpatialIndex>(config_.spatial_index_cell_size());
 };
 
 }  // namespace mediapipe
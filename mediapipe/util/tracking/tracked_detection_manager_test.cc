@@ -0,0 +1,141 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/tracking/tracked_detection_manager.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/util/tracking/tracked_detection.h"
+#include "mediapipe/util/tracking/tracked_detection_manager_config.pb.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+NormalizedRect MakeBox(float x_center, float y_center, float size) {
+  NormalizedRect box;
+  box.set_x_center(x_center);
+  box.set_y_center(y_center);
+  box.set_width(size);
+  box.set_height(size);
+  return box;
+}
+
+std::unique_ptr<TrackedDetection> MakeDetection(int id, int64_t timestamp,
+                                                const NormalizedRect& box) {
+  return std::make_unique<TrackedDetection>(id, timestamp, box);
+}
+
+TEST(TrackedDetectionManagerTest, AddDetectionRemovesDuplicates) {
+  TrackedDetectionManager manager;
+  EXPECT_THAT(manager.AddDetection(MakeDetection(0, 1, MakeBox(0.2, 0.2, 0.1))),
+              IsEmpty());
+  EXPECT_THAT(manager.AddDetection(MakeDetection(1, 1, MakeBox(0.8, 0.8, 0.1))),
+              IsEmpty());
+  EXPECT_THAT(
+      manager.AddDetection(MakeDetection(2, 2, MakeBox(0.21, 0.21, 0.1))),
+      ElementsAre(0));
+  EXPECT_EQ(manager.GetNumDetections(), 2);
+  EXPECT_EQ(manager.GetTrackedDetection(2)->previous_id(), 0);
+}
+
+TEST(TrackedDetectionManagerTest, FindsDuplicatesAfterMovingAcrossCells) {
+  TrackedDetectionManager manager;
+  manager.AddDetection(MakeDetection(0, 0, MakeBox(0.15, 0.15, 0.1)));
+  manager.AddDetection(MakeDetection(1, 0, MakeBox(0.75, 0.75, 0.1)));
+
+  // Detections are only compared at the same timestamp.
+  EXPECT_THAT(manager.UpdateDetectionLocation(1, MakeBox(0.16, 0.16, 0.1), 1),
+              IsEmpty());
+  EXPECT_THAT(manager.UpdateDetectionLocation(0, MakeBox(0.15, 0.15, 0.1), 1),
+              ElementsAre(1));
+  EXPECT_EQ(manager.GetNumDetections(), 1);
+  EXPECT_NE(manager.GetTrackedDetection(0), nullptr);
+}
+
+TEST(TrackedDetectionManagerTest, FindsDuplicatesBeyondImageBorders) {
+  TrackedDetectionManager manager;
+  manager.AddDetection(MakeDetection(0, 0, MakeBox(-0.2, 1.3, 0.2)));
+  EXPECT_THAT(
+      manager.AddDetection(MakeDetection(1, 1, MakeBox(-0.2, 1.3, 0.2))),
+      ElementsAre(0));
+  EXPECT_THAT(manager.RemoveOutOfViewDetections(), ElementsAre(1));
+  EXPECT_EQ(manager.GetNumDetections(), 0);
+}
+
+// Runs the same random sequence of operations with and without the spatial
+// index, which must give the same results.
+TEST(TrackedDetectionManagerTest, SpatialIndexMatchesFullComparison) {
+  TrackedDetectionManagerConfig full_config;
+  full_config.set_spatial_index_cell_size(0.0f);
+  TrackedDetectionManager indexed_manager;
+  TrackedDetectionManager full_manager;
+  full_manager.SetConfig(full_config);
+
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(-0.1f, 1.1f);
+  std::uniform_real_distribution<float> size(0.01f, 0.3f);
+  int next_id = 0;
+  for (int timestamp = 0; timestamp < 50; ++timestamp) {
+    for (int k = 0; k < 5; ++k) {
+      const NormalizedRect box =
+          MakeBox(position(random), position(random), size(random));
+      std::vector<int> indexed_removed =
+          indexed_manager.AddDetection(MakeDetection(next_id, timestamp, box));
+      std::vector<int> full_removed =
+          full_manager.AddDetection(MakeDetection(next_id, timestamp, box));
+      std::sort(indexed_removed.begin(), indexed_removed.end());
+      std::sort(full_removed.begin(), full_removed.end());
+      EXPECT_EQ(indexed_removed, full_removed);
+      ++next_id;
+    }
+
+    std::vector<int> ids;
+    for (const auto& detection : full_manager.GetAllTrackedDetections()) {
+      ids.push_back(detection.first);
+    }
+    std::sort(ids.begin(), ids.end());
+    for (int id : ids) {
+      if (full_manager.GetTrackedDetection(id) == nullptr) {
+        continue;
+      }
+      const NormalizedRect& old_box =
+          full_manager.GetTrackedDetection(id)->bounding_box();
+      const NormalizedRect box = MakeBox(
+          old_box.x_center() + 0.2f * (position(random) - 0.5f),
+          old_box.y_center() + 0.2f * (position(random) - 0.5f),
+          old_box.width());
+      std::vector<int> indexed_removed =
+          indexed_manager.UpdateDetectionLocation(id, box, timestamp);
+      std::vector<int> full_removed =
+          full_manager.UpdateDetectionLocation(id, box, timestamp);
+      std::sort(indexed_removed.begin(), indexed_removed.end());
+      std::sort(full_removed.begin(), full_removed.end());
+      EXPECT_EQ(indexed_removed, full_removed);
+    }
+    ASSERT_EQ(indexed_manager.GetNumDetections(),
+              full_manager.GetNumDetections());
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
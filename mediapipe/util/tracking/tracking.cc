@@ -35,6 +35,7 @@
 #include "mediapipe/util/tracking/flow_packager.pb.h"
 #include "mediapipe/util/tracking/measure_time.h"
 #include "mediapipe/util/tracking/motion_models.h"
+#include "mediapipe/util/tracking/parallel_invoker.h"
 
 namespace mediapipe {
 
@@ -1005,7 +1006,8 @@ void MotionBox::ResetAtFrame(int frame, const MotionBoxState& state) {
 
 bool MotionBox::TrackStep(int from_frame,
                           const MotionVectorFrame& motion_vectors,
-                          bool forward) {
+                          bool forward,
+                          bool clear_actively_discarded_tracked_ids) {
   if (!TrackableFromFrame(from_frame)) {
     ABSL_LOG(WARNING) << "Tracking requested for initial position that is not "
                       << "trackable.";
@@ -1036,7 +1038,7 @@ bool MotionBox::TrackStep(int from_frame,
     }
 
     TrackStepImpl(from_frame, states_[queue_pos], motion_vectors, history,
-                  &new_state);
+                  clear_actively_discarded_tracked_ids, &new_state);
   }
 
   if (new_state.track_status() < MotionBoxState::BOX_TRACKED) {
@@ -1128,6 +1130,29 @@ bool MotionBox::TrackStep(int from_frame,
   }
 }
 
+std::vector<char> MotionBox::TrackStepBatch(
+    int from_frame, const MotionVectorFrame& motion_vectors, bool forward,
+    const std::vector<MotionBox*>& boxes) {
+  // char instead of bool, so that boxes can store results concurrently.
+  std::vector<char> success(boxes.size(), 0);
+  if (boxes.empty()) {
+    return success;
+  }
+  ParallelFor(0, boxes.size(), 1,
+              [&boxes, &success, &motion_vectors, from_frame,
+               forward](const BlockedRange& range) {
+                for (int k = range.begin(); k < range.end(); ++k) {
+                  success[k] = boxes[k]->TrackStep(
+                      from_frame, motion_vectors, forward,
+                      /*clear_actively_discarded_tracked_ids=*/false);
+                }
+              });
+  if (motion_vectors.actively_discarded_tracked_ids != nullptr) {
+    motion_vectors.actively_discarded_tracked_ids->clear();
+  }
+  return success;
+}
+
 namespace {
 
 Vector2_f SpatialPriorPosition(const Vector2_f& location,
@@ -2581,6 +2606,7 @@ void MotionBox::ApplySpringForce(const Vector2_f& center_of_interest,
 void MotionBox::TrackStepImpl(int from_frame, const MotionBoxState& curr_pos,
                               const MotionVectorFrame& motion_frame,
                               const std::vector<const MotionBoxState*>& history,
+                              bool clear_actively_discarded_tracked_ids,
                               MotionBoxState* next_pos) const {
   // Create new curr pos with velocity scaled to current duration.
   constexpr float kDefaultPeriodMs = 1000.0f / kTrackingDefaultFps;
@@ -2596,7 +2622,8 @@ void MotionBox::TrackStepImpl(int from_frame, const MotionBoxState& curr_pos,
   ScaleStateAspect(motion_frame.aspect_ratio, false, &curr_pos_normalized);
 
   TrackStepImplDeNormalized(from_frame, curr_pos_normalized, motion_frame,
-                            history, next_pos);
+                            history, clear_actively_discarded_tracked_ids,
+                            next_pos);
 
   // Scale back velocity and aspect to normalized domains.
   ScaleStateTemporally(1.0f / temporal_scale, next_pos);
@@ -2656,6 +2683,7 @@ void MotionBox::TrackStepImplDeNormalized(
     int from_frame, const MotionBoxState& curr_pos,
     const MotionVectorFrame& motion_frame,
     const std::vector<const MotionBoxState*>& history,
+    bool clear_actively_discarded_tracked_ids,
     MotionBoxState* next_pos) const {
   ABSL_CHECK(next_pos);
 
@@ -2901,7 +2929,9 @@ void MotionBox::TrackStepImplDeNormalized(
         [&motion_frame](int id) {
           return !motion_frame.actively_discarded_tracked_ids->contains(id);
         });
-    motion_frame.actively_discarded_tracked_ids->clear();
+    if (clear_actively_discarded_tracked_ids) {
+      motion_frame.actively_discarded_tracked_ids->clear();
+    }
   }
   const int num_inliers = next_pos->inlier_ids_size();
   // Must be in [0, 1].
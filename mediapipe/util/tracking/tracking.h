@@ -311,7 +311,19 @@ class MotionBox {
   // via ResetFrame. Otherwise no prior location for the track is present (at
   // from_frame) and TrackStep will fail (return false).
   bool TrackStep(int from_frame, const MotionVectorFrame& motion_vectors,
-                 bool forward);
+                 bool forward) {
+    return TrackStep(from_frame, motion_vectors, forward,
+                     /*clear_actively_discarded_tracked_ids=*/true);
+  }
+
+  // Tracks all boxes by one step against the same MotionVectorFrame, like
+  // calling TrackStep on each of them, but runs the boxes in parallel via
+  // ParallelFor. All boxes see the actively discarded tracked ids of
+  // motion_vectors, which are cleared once after the batch (TrackStep clears
+  // them after the first box). Returns for each box if tracking succeeded.
+  static std::vector<char> TrackStepBatch(
+      int from_frame, const MotionVectorFrame& motion_vectors, bool forward,
+      const std::vector<MotionBox*>& boxes);
 
   MotionBoxState StateAtFrame(int frame) const {
     if (frame < queue_start_ ||
@@ -372,12 +384,19 @@ class MotionBox {
   static bool print_motion_box_warnings_;
 
  private:
+  // Implements TrackStep. Set clear_actively_discarded_tracked_ids to false
+  // to leave the set of motion_vectors unchanged, e.g. when boxes are tracked
+  // concurrently.
+  bool TrackStep(int from_frame, const MotionVectorFrame& motion_vectors,
+                 bool forward, bool clear_actively_discarded_tracked_ids);
+
   // Determines next position from curr_pos based on tracking data in
   // motion_vectors. Also receives history of the last N positions.
   void TrackStepImplDeNormalized(
       int frome_frame, const MotionBoxState& curr_pos,
       const MotionVectorFrame& motion_vectors,
       const std::vector<const MotionBoxState*>& history,
+      bool clear_actively_discarded_tracked_ids,
       MotionBoxState* next_pos) const;
 
   // Pre-normalization wrapper for above function. De-normalizes domain
@@ -385,6 +404,7 @@ class MotionBox {
   void TrackStepImpl(int from_frame, const MotionBoxState& curr_pos,
                      const MotionVectorFrame& motion_frame,
                      const std::vector<const MotionBoxState*>& history,
+                     bool clear_actively_discarded_tracked_ids,
                      MotionBoxState* next_pos) const;
 
   // Implementation functions for above TrackStepImpl.
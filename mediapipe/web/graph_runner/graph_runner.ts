@@ -52,6 +52,24 @@ declare global {
  */
 declare function importScripts(...urls: Array<string|URL>): void;
 
+/** Returns the tuple [width, height] of an image source. */
+function getImageSourceSize(imageSource: ImageSource): [number, number] {
+  if ((imageSource as HTMLVideoElement).videoWidth) {
+    return [
+      (imageSource as HTMLVideoElement).videoWidth,
+      (imageSource as HTMLVideoElement).videoHeight
+    ];
+  } else if ((imageSource as HTMLImageElement).naturalWidth) {
+    // TODO: Ensure this works with SVG images
+    return [
+      (imageSource as HTMLImageElement).naturalWidth,
+      (imageSource as HTMLImageElement).naturalHeight
+    ];
+  } else {
+    return [imageSource.width, imageSource.height];
+  }
+}
+
 /**
  * Simple class to run an arbitrary image-in/image-out MediaPipe graph (i.e.
  * as created by wasm_mediapipe_demo BUILD macro), and either render results
@@ -178,15 +196,7 @@ export class GraphRunner implements GraphRunnerApi {
     } else {
       this.wasmModule._bindTextureToStream(streamNamePtr);
     }
-    const gl =
-        (this.wasmModule.canvas.getContext('webgl2') ||
-         this.wasmModule.canvas.getContext('webgl')) as WebGL2RenderingContext |
-        WebGLRenderingContext | null;
-    if (!gl) {
-      throw new Error(
-          'Failed to obtain WebGL context from the provided canvas. ' +
-          '`getContext()` should only be invoked with `webgl` or `webgl2`.');
-    }
+    const gl = this.getGlContext();
     if (this.wasmModule.gpuOriginForWebTexturesIsBottomLeft) {
       gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, true);
     }
@@ -196,29 +206,63 @@ export class GraphRunner implements GraphRunnerApi {
       gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, false);
     }
 
-    let width, height;
-    if ((imageSource as HTMLVideoElement).videoWidth) {
-      width = (imageSource as HTMLVideoElement).videoWidth;
-      height = (imageSource as HTMLVideoElement).videoHeight;
-    } else if ((imageSource as HTMLImageElement).naturalWidth) {
-      // TODO: Ensure this works with SVG images
-      width = (imageSource as HTMLImageElement).naturalWidth;
-      height = (imageSource as HTMLImageElement).naturalHeight;
-    } else {
-      width = imageSource.width;
-      height = imageSource.height;
+    const [width, height] = getImageSourceSize(imageSource);
+    this.resizeCanvas(width, height);
+    return [width, height];
+  }
+
+  /**
+   * Uploads the image source into a pooled texture of the graph, which
+   * already has storage of the image size, so that the browser can copy the
+   * frame on the GPU without reallocating the texture. Returns tuple [width,
+   * height] of texture. Requires `_bindPooledTextureToStream`. Intended for
+   * internal usage.
+   */
+  bindPooledTextureToStream(imageSource: ImageSource, streamNamePtr: number):
+      [number, number] {
+    if (!this.wasmModule.canvas) {
+      throw new Error('No OpenGL canvas configured.');
     }
 
-    if (this.autoResizeCanvas &&
-        (width !== this.wasmModule.canvas.width ||
-         height !== this.wasmModule.canvas.height)) {
-      this.wasmModule.canvas.width = width;
-      this.wasmModule.canvas.height = height;
+    const [width, height] = getImageSourceSize(imageSource);
+    this.wasmModule._bindPooledTextureToStream!(streamNamePtr, width, height);
+    const gl = this.getGlContext();
+    if (this.wasmModule.gpuOriginForWebTexturesIsBottomLeft) {
+      gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, true);
+    }
+    gl.texSubImage2D(
+        gl.TEXTURE_2D, 0, 0, 0, gl.RGBA, gl.UNSIGNED_BYTE, imageSource);
+    if (this.wasmModule.gpuOriginForWebTexturesIsBottomLeft) {
+      gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, false);
     }
 
+    this.resizeCanvas(width, height);
     return [width, height];
   }
 
+  /** Returns the WebGL context of our internal canvas. */
+  private getGlContext(): WebGL2RenderingContext|WebGLRenderingContext {
+    const canvas = this.wasmModule.canvas!;
+    const gl = (canvas.getContext('webgl2') || canvas.getContext('webgl')) as
+        WebGL2RenderingContext | WebGLRenderingContext | null;
+    if (!gl) {
+      throw new Error(
+          'Failed to obtain WebGL context from the provided canvas. ' +
+          '`getContext()` should only be invoked with `webgl` or `webgl2`.');
+    }
+    return gl;
+  }
+
+  /** Resizes our internal canvas to the input size, if enabled. */
+  private resizeCanvas(width: number, height: number): void {
+    if (this.autoResizeCanvas &&
+        (width !== this.wasmModule.canvas!.width ||
+         height !== this.wasmModule.canvas!.height)) {
+      this.wasmModule.canvas!.width = width;
+      this.wasmModule.canvas!.height = height;
+    }
+  }
+
   /**
    * Takes the raw data from a JS image source, and sends it to C++ to be
    * processed, waiting synchronously for the response. Note that we will resize
@@ -388,6 +432,12 @@ export class GraphRunner implements GraphRunnerApi {
   addGpuBufferToStream(
       imageSource: ImageSource, streamName: string, timestamp: number): void {
     this.wrapStringPtr(streamName, (streamNamePtr: number) => {
+      if (this.wasmModule._bindPooledTextureToStream &&
+          this.wasmModule._addPooledTextureToStream) {
+        this.bindPooledTextureToStream(imageSource, streamNamePtr);
+        this.wasmModule._addPooledTextureToStream(streamNamePtr, timestamp);
+        return;
+      }
       const [width, height] =
           this.bindTextureToStream(imageSource, streamNamePtr);
       this.wasmModule._addBoundTextureToStream(
@@ -40,6 +40,12 @@ export declare interface WasmModule {
   _addBoundTextureToStream:
       (streamNamePtr: number, width: number, height: number,
        timestamp: number) => void;
+  // Optional entrypoints backed by mediapipe/gpu/webgl_texture_input.h, which
+  // bind a pooled texture that already has storage of the given size.
+  _bindPooledTextureToStream?:
+      (streamNamePtr: number, width: number, height: number) => void;
+  _addPooledTextureToStream?:
+      (streamNamePtr: number, timestamp: number) => void;
   _addBoolToInputStream:
       (data: boolean, streamNamePtr: number, timestamp: number) => void;
   _addDoubleToInputStream: